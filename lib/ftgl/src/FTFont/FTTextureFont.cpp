@@ -28,6 +28,7 @@
 
 #include <cassert>
 #include <string> // For memset
+#include <string.h>
 
 #include "FTGL/ftgl.h"
 
@@ -95,7 +96,10 @@ FTTextureFontImpl::FTTextureFontImpl(FTFont *ftFont, const char* fontFilePath)
     textureHeight(0),
     glyphHeight(0),
     glyphWidth(0),
+    distanceFieldScale(0),
+    distanceFieldSpread(0),
     padding(3),
+    stripTop(0),
     xOffset(0),
     yOffset(0)
 {
@@ -113,7 +117,10 @@ FTTextureFontImpl::FTTextureFontImpl(FTFont *ftFont,
     textureHeight(0),
     glyphHeight(0),
     glyphWidth(0),
+    distanceFieldScale(0),
+    distanceFieldSpread(0),
     padding(3),
+    stripTop(0),
     xOffset(0),
     yOffset(0)
 {
@@ -146,21 +153,45 @@ FTGlyph* FTTextureFontImpl::MakeGlyphImpl(FT_GlyphSlot ftGlyph)
         xOffset = yOffset = padding;
     }
 
-    if(xOffset > (textureWidth - glyphWidth))
+    if(xOffset > (textureWidth - CellWidth()))
     {
         xOffset = padding;
-        yOffset += glyphHeight;
+        yOffset += CellHeight();
 
-        if(yOffset > (textureHeight - glyphHeight))
+        if(yOffset > (textureHeight - CellHeight()))
         {
+            // The strip belongs to the full texture.
+            UploadDirtyGlyphs();
             textureIDList.push_back(CreateTexture());
             yOffset = padding;
         }
     }
 
+    // Glyphs fit the cell, but leave room in case one doesn't.
+    int rows = CellHeight() * 2;
+    if(yOffset + rows > textureHeight)
+    {
+        rows = textureHeight - yOffset;
+    }
+
     FTTextureGlyph* tempGlyph = new FTTextureGlyph(ftGlyph, textureIDList[textureIDList.size() - 1],
-                                                    xOffset, yOffset, textureWidth, textureHeight);
-    xOffset += static_cast<int>(tempGlyph->BBox().Upper().X() - tempGlyph->BBox().Lower().X() + padding + 0.5);
+                                                    xOffset, yOffset, textureWidth, textureHeight,
+                                                    distanceFieldScale, distanceFieldSpread,
+                                                    StripPixels(xOffset, yOffset, rows));
+    {
+        FTTextureGlyphImpl* glyphImpl = (FTTextureGlyphImpl*)tempGlyph->GetImpl();
+        MarkDirty(xOffset, yOffset, glyphImpl->atlasWidth, glyphImpl->atlasHeight);
+    }
+
+    if(distanceFieldScale > 0)
+    {
+        FTTextureGlyphImpl* glyphImpl = (FTTextureGlyphImpl*)tempGlyph->GetImpl();
+        xOffset += glyphImpl->atlasWidth + padding;
+    }
+    else
+    {
+        xOffset += static_cast<int>(tempGlyph->BBox().Upper().X() - tempGlyph->BBox().Lower().X() + padding + 0.5);
+    }
 
     --remGlyphs;
 
@@ -168,6 +199,96 @@ FTGlyph* FTTextureFontImpl::MakeGlyphImpl(FT_GlyphSlot ftGlyph)
 }
 
 
+unsigned char* FTTextureFontImpl::StripPixels(int x, int y, int rows)
+{
+    if(dirtyRects.empty())
+    {
+        ClearStrip();
+        stripTop = y;
+    }
+
+    unsigned int size = (y + rows - stripTop) * textureWidth;
+    if(strip.size() < size)
+    {
+        strip.resize(size, 0);
+    }
+    return &strip[(y - stripTop) * textureWidth + x];
+}
+
+
+void FTTextureFontImpl::MarkDirty(int x, int y, int width, int height)
+{
+    // Nothing is written outside the texture or the strip.
+    const int stripBottom = stripTop + (int) strip.size() / textureWidth;
+    width = x + width > textureWidth ? textureWidth - x : width;
+    height = y + height > stripBottom ? stripBottom - y : height;
+    if(width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    if(!dirtyRects.empty() && dirtyRects[dirtyRects.size() - 1].top == y)
+    {
+        DirtyRect& rect = dirtyRects[dirtyRects.size() - 1];
+        rect.right = x + width;
+        rect.bottom = rect.bottom > y + height ? rect.bottom : y + height;
+        return;
+    }
+
+    DirtyRect rect;
+    rect.left = x;
+    rect.top = y;
+    rect.right = x + width;
+    rect.bottom = y + height;
+    dirtyRects.push_back(rect);
+}
+
+
+void FTTextureFontImpl::ClearStrip()
+{
+    dirtyRects.resize(0, DirtyRect());
+    // Kept allocated, the next glyphs will want it.
+    strip.resize(0, 0);
+}
+
+
+unsigned int FTTextureFontImpl::UploadDirtyGlyphs()
+{
+    if(dirtyRects.empty() || textureIDList.empty())
+    {
+        return 0;
+    }
+
+    unsigned int bytes = 0;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_2D, textureIDList[textureIDList.size() - 1]);
+
+    for(unsigned int i = 0; i < dirtyRects.size(); i++)
+    {
+        const DirtyRect& rect = dirtyRects[i];
+        const int width = rect.right - rect.left;
+        const int height = rect.bottom - rect.top;
+
+        // GLES can't skip along rows, so each run is copied out whole.
+        uploadScratch.resize(width * height, 0);
+        for(int y = 0; y < height; y++)
+        {
+            memcpy(&uploadScratch[y * width],
+                   &strip[(rect.top - stripTop + y) * textureWidth + rect.left],
+                   width);
+        }
+
+        glTexSubImage2D(GL_TEXTURE_2D, 0, rect.left, rect.top, width, height,
+                        GL_ALPHA, GL_UNSIGNED_BYTE, &uploadScratch[0]);
+        bytes += width * height;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    ClearStrip();
+    return bytes;
+}
+
+
 void FTTextureFontImpl::CalculateTextureSize()
 {
     if(!maximumGLTextureSize)
@@ -175,14 +296,21 @@ void FTTextureFontImpl::CalculateTextureSize()
         maximumGLTextureSize = 1024;
         glGetIntegerv(GL_MAX_TEXTURE_SIZE, (GLint*)&maximumGLTextureSize);
         assert(maximumGLTextureSize); // If you hit this then you have an invalid OpenGL context.
+
+        // Dinodeck's packed vertices can only address glyphs exactly
+        // in textures up to 8192, keep well inside that.
+        if(maximumGLTextureSize > 4096)
+        {
+            maximumGLTextureSize = 4096;
+        }
     }
 
-    textureWidth = NextPowerOf2((remGlyphs * glyphWidth) + (padding * 2));
+    textureWidth = NextPowerOf2((remGlyphs * CellWidth()) + (padding * 2));
     textureWidth = textureWidth > maximumGLTextureSize ? maximumGLTextureSize : textureWidth;
 
-    int h = static_cast<int>((textureWidth - (padding * 2)) / glyphWidth + 0.5);
+    int h = static_cast<int>((textureWidth - (padding * 2)) / CellWidth() + 0.5);
 
-    textureHeight = NextPowerOf2(((numGlyphs / h) + 1) * glyphHeight);
+    textureHeight = NextPowerOf2(((numGlyphs / h) + 1) * CellHeight());
     textureHeight = textureHeight > maximumGLTextureSize ? maximumGLTextureSize : textureHeight;
 }
 
@@ -219,6 +347,7 @@ bool FTTextureFontImpl::FaceSize(const unsigned int size, const unsigned int res
     {
         glDeleteTextures((GLsizei)textureIDList.size(), (const GLuint*)&textureIDList[0]);
         textureIDList.clear();
+        ClearStrip();
         remGlyphs = numGlyphs = face.GlyphCount();
     }
 
@@ -241,6 +370,10 @@ inline FTPoint FTTextureFontImpl::RenderI(const T* string, const int len,
 
     FTTextureGlyphImpl::ResetActiveTexture();
 
+    // Load every glyph first so they're uploaded before any is drawn.
+    FTFontImpl::Advance(string, len, spacing);
+    UploadDirtyGlyphs();
+
     FTPoint tmp = FTFontImpl::Render(string, len,
                                      position, spacing, renderMode);
 
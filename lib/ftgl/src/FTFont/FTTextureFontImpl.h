@@ -38,6 +38,31 @@ class FTTextureFontImpl : public FTFontImpl
     friend class FTTextureFont;
 
     public: int GetMaxHeight() { return glyphHeight; }
+    public: int GetTextureCount() const { return textureIDList.size(); }
+    public: int GetTextureWidth() const { return textureWidth; }
+    public: int GetTextureHeight() const { return textureHeight; }
+    public: int GetGlyphRowY() const { return yOffset; }
+    public: unsigned int GetGlyphsLoaded() const { return numGlyphs - remGlyphs; }
+    public: int GetCellHeight() const { return CellHeight(); }
+    public: bool IsDistanceField() const { return distanceFieldScale > 0; }
+    public: bool HasDirtyGlyphs() const { return !dirtyRects.empty(); }
+        /**
+         * New glyphs are kept in memory until this uploads them, one
+         * glTexSubImage2D per row of glyphs touched. Call before drawing
+         * anything that uses them.
+         *
+         * @return the number of bytes uploaded.
+         */
+    public: unsigned int UploadDirtyGlyphs();
+        /**
+         * Store glyphs as distance fields, downsampled by scale, that
+         * can be alpha tested at any size. Call before any glyphs load.
+         */
+    public: void SetDistanceField(int scale, int spread)
+        {
+            distanceFieldScale = scale;
+            distanceFieldSpread = spread;
+        }
 
     protected:
         FTTextureFontImpl(FTFont *ftFont, const char* fontFilePath);
@@ -121,12 +146,69 @@ class FTTextureFontImpl : public FTFontImpl
          */
         int glyphWidth;
 
+        /**
+         * Distance field downsample, 0 for coverage glyphs
+         */
+        int distanceFieldScale;
+
+        /**
+         * Distance field range in texels
+         */
+        int distanceFieldSpread;
+
+        /**
+         * The space a glyph takes in the texture
+         */
+        int CellWidth() const
+        {
+            if(distanceFieldScale <= 0) return glyphWidth;
+            return (glyphWidth / distanceFieldScale) + 1 + (distanceFieldSpread * 2);
+        }
+
+        int CellHeight() const
+        {
+            if(distanceFieldScale <= 0) return glyphHeight;
+            return (glyphHeight / distanceFieldScale) + 1 + (distanceFieldSpread * 2);
+        }
+
         /**
          * A value to be added to the height and width to ensure that
          * glyphs don't overlap in the texture
          */
         unsigned int padding;
 
+        /**
+         * A run of new glyphs on one row of the newest texture.
+         */
+        struct DirtyRect
+        {
+            int left;
+            int top;
+            int right;
+            int bottom;
+        };
+
+        FTVector<DirtyRect> dirtyRects;
+
+        /**
+         * The newest texture's rows from stripTop on, where new glyphs
+         * are written until they're uploaded.
+         */
+        FTVector<unsigned char> strip;
+        int stripTop;
+
+        FTVector<unsigned char> uploadScratch;
+
+        /**
+         * Where a glyph at x, y goes in the strip, grown to fit rows
+         * more rows.
+         */
+        unsigned char* StripPixels(int x, int y, int rows);
+
+        void MarkDirty(int x, int y, int width, int height);
+
+        void ClearStrip();
+
         /**
          *
          */
@@ -55,9 +55,17 @@ class FTGL_EXPORT FTTextureGlyph : public FTGlyph
          *                  this glyph
          * @param width     The width of the parent texture
          * @param height    The height (number of rows) of the parent texture
+         * @param distanceFieldScale  If above 0, store a distance field
+         *                  downsampled by this much instead of coverage
+         * @param distanceFieldSpread  Distance field range in texels
+         * @param pixels    If not NULL, the glyph is written here instead
+         *                  of uploaded, its top left texel first and rows
+         *                  width apart. The owner uploads it later.
          */
         FTTextureGlyph(FT_GlyphSlot glyph, int id, int xOffset, int yOffset,
-                       int width, int height);
+                       int width, int height, int distanceFieldScale = 0,
+                       int distanceFieldSpread = 0,
+                       unsigned char* pixels = NULL);
 
         /**
          * Destructor
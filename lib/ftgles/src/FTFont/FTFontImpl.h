@@ -39,6 +39,9 @@ class FTFontImpl
         friend class FTFont;
 
     public:
+        // Hacks to get at the internals, so alignment can be fixed.
+        FTGlyphContainer* GetGlyphList() { return glyphList; }
+
         /**
          * Check that the glyph at <code>chr</code> exist. If not load it.
          *
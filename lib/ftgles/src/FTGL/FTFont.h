@@ -55,6 +55,9 @@ class FTFontImpl;
  */
 class FTGL_EXPORT FTFont
 {
+    public:
+        // Hacks so I can do alignment
+        FTFontImpl* GetImpl() { return impl; }
     protected:
         /**
          * Open and read a font file. Sets Error flag.
@@ -48,6 +48,8 @@ class FTGlyphImpl;
  */
 class FTGL_EXPORT FTGlyph
 {
+    public:
+        FTGlyphImpl* GetImpl() { return impl; }
     protected:
         /**
          * Create a glyph.
@@ -27,6 +27,7 @@
 #include "config.h"
 
 #include <math.h>
+#include <string.h>
 
 #include "FTGL/ftgles.h"
 
@@ -40,8 +41,13 @@
 
 
 FTTextureGlyph::FTTextureGlyph(FT_GlyphSlot glyph, int id, int xOffset,
-                               int yOffset, int width, int height) :
-    FTGlyph(new FTTextureGlyphImpl(glyph, id, xOffset, yOffset, width, height))
+                               int yOffset, int width, int height,
+                               int distanceFieldScale,
+                               int distanceFieldSpread,
+                               unsigned char* pixels) :
+    FTGlyph(new FTTextureGlyphImpl(glyph, id, xOffset, yOffset, width, height,
+                                   distanceFieldScale, distanceFieldSpread,
+                                   pixels))
 {}
 
 
@@ -69,11 +75,17 @@ const FTPoint& FTTextureGlyph::Render(const FTPoint& pen, int renderMode)
 GLint FTTextureGlyphImpl::activeTextureID = 0;
 
 FTTextureGlyphImpl::FTTextureGlyphImpl(FT_GlyphSlot glyph, int id, int xOffset,
-                                       int yOffset, int width, int height)
+                                       int yOffset, int width, int height,
+                                       int distanceFieldScale,
+                                       int distanceFieldSpread,
+                                       unsigned char* pixels)
 :   FTGlyphImpl(glyph),
     destWidth(0),
     destHeight(0),
-    glTextureID(id)
+    glTextureID(id),
+    margin(0),
+    atlasWidth(0),
+    atlasHeight(0)
 {
     /* FIXME: need to propagate the render mode all the way down to
      * here in order to get FT_RENDER_MODE_MONO aliased fonts.
@@ -89,8 +101,53 @@ FTTextureGlyphImpl::FTTextureGlyphImpl(FT_GlyphSlot glyph, int id, int xOffset,
 
     destWidth  = bitmap.width;
     destHeight = bitmap.rows;
+    atlasWidth = destWidth;
+    atlasHeight = destHeight;
 
-    if (destWidth && destHeight)
+    bool isField = distanceFieldScale > 0;
+    if(isField)
+    {
+        margin = distanceFieldSpread * distanceFieldScale;
+
+        if(destWidth && destHeight
+           && !UploadDistanceField(bitmap, xOffset, yOffset, width, height,
+                                   distanceFieldScale, distanceFieldSpread, pixels))
+        {
+            // No room for the field, the glyph stays a plain bitmap.
+            margin = 0;
+            isField = false;
+        }
+    }
+
+    if(isField)
+    {
+        // The field covers the bitmap plus the margin on each side at
+        // 1/scale resolution.
+        float fieldWidth = (destWidth + margin * 2) / static_cast<float>(distanceFieldScale);
+        float fieldHeight = (destHeight + margin * 2) / static_cast<float>(distanceFieldScale);
+        uv[0].X(static_cast<float>(xOffset) / static_cast<float>(width));
+        uv[0].Y(static_cast<float>(yOffset) / static_cast<float>(height));
+        uv[1].X((xOffset + fieldWidth) / static_cast<float>(width));
+        uv[1].Y((yOffset + fieldHeight) / static_cast<float>(height));
+
+        corner = FTPoint(glyph->bitmap_left, glyph->bitmap_top);
+        return;
+    }
+
+    if(destWidth && destHeight && pixels)
+    {
+        // As glTexSubImage2D, a glyph that doesn't fit isn't written.
+        if(xOffset + destWidth <= width && yOffset + destHeight <= height)
+        {
+            for(int y = 0; y < destHeight; y++)
+            {
+                memcpy(pixels + y * width,
+                       bitmap.buffer + y * bitmap.pitch,
+                       destWidth);
+            }
+        }
+    }
+    else if (destWidth && destHeight)
     {
 		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 		glBindTexture(GL_TEXTURE_2D, glTextureID);
@@ -116,6 +173,98 @@ FTTextureGlyphImpl::~FTTextureGlyphImpl()
 {}
 
 
+//
+// Stores, for each texel, the distance to the glyph's outline. 0.5 is on
+// the edge, above is inside, so alpha testing at 0.5 gives a sharp
+// outline whatever size the glyph is drawn at.
+//
+bool FTTextureGlyphImpl::UploadDistanceField(const FT_Bitmap& bitmap,
+                                             int xOffset, int yOffset,
+                                             int width, int height,
+                                             int scale, int spread,
+                                             unsigned char* pixels)
+{
+    const int fieldWidth = (bitmap.width + scale - 1) / scale + spread * 2;
+    const int fieldHeight = (bitmap.rows + scale - 1) / scale + spread * 2;
+    const int radius = (spread + 1) * scale;
+
+    if(xOffset + fieldWidth > width || yOffset + fieldHeight > height)
+    {
+        return false;
+    }
+
+    atlasWidth = fieldWidth;
+    atlasHeight = fieldHeight;
+    unsigned char* field = new unsigned char[fieldWidth * fieldHeight];
+
+    for(int fy = 0; fy < fieldHeight; fy++)
+    {
+        for(int fx = 0; fx < fieldWidth; fx++)
+        {
+            // Source pixel under the centre of this texel
+            int cx = (fx - spread) * scale + scale / 2;
+            int cy = (fy - spread) * scale + scale / 2;
+            bool inside = IsInside(bitmap, cx, cy);
+
+            int nearest = radius * radius;
+            for(int y = cy - radius; y <= cy + radius; y++)
+            {
+                for(int x = cx - radius; x <= cx + radius; x++)
+                {
+                    if(IsInside(bitmap, x, y) != inside)
+                    {
+                        int d = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+                        if(d < nearest)
+                        {
+                            nearest = d;
+                        }
+                    }
+                }
+            }
+
+            float distance = sqrtf(static_cast<float>(nearest)) / scale;
+            if(!inside)
+            {
+                distance = -distance;
+            }
+
+            float value = 0.5f + distance / (spread * 2);
+            value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+            field[fy * fieldWidth + fx] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+        }
+    }
+
+    if(pixels)
+    {
+        for(int y = 0; y < fieldHeight; y++)
+        {
+            memcpy(pixels + y * width,
+                   field + y * fieldWidth,
+                   fieldWidth);
+        }
+    }
+    else
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glBindTexture(GL_TEXTURE_2D, glTextureID);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, xOffset, yOffset, fieldWidth, fieldHeight, GL_ALPHA, GL_UNSIGNED_BYTE, field);
+    }
+
+    delete [] field;
+    return true;
+}
+
+
+bool FTTextureGlyphImpl::IsInside(const FT_Bitmap& bitmap, int x, int y)
+{
+    if(x < 0 || y < 0 || x >= bitmap.width || y >= bitmap.rows)
+    {
+        return false;
+    }
+    return bitmap.buffer[y * bitmap.pitch + x] >= 128;
+}
+
+
 const FTPoint& FTTextureGlyphImpl::RenderImpl(const FTPoint& pen,
                                               int renderMode)
 {
@@ -128,20 +277,20 @@ const FTPoint& FTTextureGlyphImpl::RenderImpl(const FTPoint& pen,
         //activeTextureID = glTextureID;
     }
 
-    dx = floor(pen.Xf() + corner.Xf());
-    dy = floor(pen.Yf() + corner.Yf());
+    dx = floor(pen.Xf() + corner.Xf()) - margin;
+    dy = floor(pen.Yf() + corner.Yf()) + margin;
 
 	ftglTexCoord2f(uv[0].Xf(), uv[0].Yf());
 	ftglVertex2f(dx, dy);
 
 	ftglTexCoord2f(uv[0].Xf(), uv[1].Yf());
-	ftglVertex2f(dx, dy - destHeight);
+	ftglVertex2f(dx, dy - destHeight - margin * 2);
 
 	ftglTexCoord2f(uv[1].Xf(), uv[1].Yf());
-	ftglVertex2f(dx + destWidth, dy - destHeight);
+	ftglVertex2f(dx + destWidth + margin * 2, dy - destHeight - margin * 2);
 
 	ftglTexCoord2f(uv[1].Xf(), uv[0].Yf());
-	ftglVertex2f(dx + destWidth, dy);
+	ftglVertex2f(dx + destWidth + margin * 2, dy);
 
     return advance;
 }
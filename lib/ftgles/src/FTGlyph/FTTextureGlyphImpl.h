@@ -34,9 +34,18 @@ class FTTextureGlyphImpl : public FTGlyphImpl
     friend class FTTextureGlyph;
     friend class FTTextureFontImpl;
 
+    public: int GetWidth() const { return destWidth; }
+    public: int GetHeight() const { return destHeight; }
+    public: FTPoint GetCorner() const { return corner; }
+    public: FTPoint GetUV(int i) const { return uv[i]; }
+    public: int GetTextureId() const { return glTextureID; }
+    public: int GetMargin() const { return margin; }
+
     protected:
         FTTextureGlyphImpl(FT_GlyphSlot glyph, int id, int xOffset,
-                           int yOffset, int width, int height);
+                           int yOffset, int width, int height,
+                           int distanceFieldScale, int distanceFieldSpread,
+                           unsigned char* pixels);
 
         virtual ~FTTextureGlyphImpl();
 
@@ -75,6 +84,28 @@ class FTTextureGlyphImpl : public FTGlyphImpl
          */
         int glTextureID;
 
+        /**
+         * Distance field glyphs extend past the bitmap by this much on
+         * every side, so the field has room to fall off.
+         */
+        int margin;
+
+        /**
+         * Space this glyph takes up in the texture.
+         */
+        int atlasWidth;
+        int atlasHeight;
+
+        /**
+         * @return false if the field doesn't fit the texture, in which
+         *         case nothing is written.
+         */
+        bool UploadDistanceField(const FT_Bitmap& bitmap, int xOffset,
+                                 int yOffset, int width, int height,
+                                 int scale, int spread, unsigned char* pixels);
+
+        static bool IsInside(const FT_Bitmap& bitmap, int x, int y);
+
         /**
          * The texture index of the currently active texture
          *
@@ -0,0 +1,419 @@
+#include "Animation.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Asset.h"
+#include "DDLog.h"
+#include "Dinodeck.h"
+#include "DinodeckLua.h"
+#include "LuaState.h"
+#include "Sprite.h"
+#include "SpriteRecord.h"
+
+Reflect Animation::Meta("Animation", Animation::Bind);
+
+double Animation::mClock = 0;
+
+static const double DEFAULT_FPS = 12;
+
+static const std::string* FindFlag(const std::map<std::string, std::string>& flags,
+                                   const char* key)
+{
+    std::map<std::string, std::string>::const_iterator it = flags.find(key);
+    return it == flags.end() ? NULL : &it->second;
+}
+
+// Numbers split by any of the separators, false on anything else.
+static bool ReadNumbers(const std::string& text, const char* separators, std::vector<double>* out)
+{
+    const char* cursor = text.c_str();
+    while(*cursor)
+    {
+        while(*cursor != '\0' && (*cursor == ' ' || strchr(separators, *cursor)))
+        {
+            cursor++;
+        }
+        if(*cursor == '\0')
+        {
+            break;
+        }
+        char* end = NULL;
+        const double value = strtod(cursor, &end);
+        if(end == cursor)
+        {
+            return false;
+        }
+        out->push_back(value);
+        cursor = end;
+    }
+    return true;
+}
+
+// "1-4,6,3-1" to 0 based cells, ranges can run either way.
+static bool ReadCells(const std::string& text, int cellCount, std::vector<int>* out)
+{
+    const char* cursor = text.c_str();
+    while(*cursor)
+    {
+        while(*cursor == ' ' || *cursor == ',')
+        {
+            cursor++;
+        }
+        if(*cursor == '\0')
+        {
+            break;
+        }
+
+        char* end = NULL;
+        const long first = strtol(cursor, &end, 10);
+        if(end == cursor)
+        {
+            return false;
+        }
+        cursor = end;
+        long last = first;
+        while(*cursor == ' ')
+        {
+            cursor++;
+        }
+        if(*cursor == '-')
+        {
+            cursor++;
+            last = strtol(cursor, &end, 10);
+            if(end == cursor)
+            {
+                return false;
+            }
+            cursor = end;
+        }
+
+        if(first < 1 || last < 1 || first > cellCount || last > cellCount)
+        {
+            return false;
+        }
+        const long step = last >= first ? 1 : -1;
+        for(long cell = first; ; cell += step)
+        {
+            out->push_back((int) cell - 1);
+            if(cell == last)
+            {
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+void Animation::Clear()
+{
+    mFrames.clear();
+    mEnds.clear();
+    mLoop = true;
+}
+
+bool Animation::Read(const std::map<std::string, std::string>& flags, std::string* outError)
+{
+    assert(outError);
+    Clear();
+
+    const std::string* rects = FindFlag(flags, "rects");
+    if(rects)
+    {
+        std::vector<double> values;
+        if(!ReadNumbers(*rects, ",;", &values) || values.empty() || values.size() % 4 != 0)
+        {
+            *outError = "rects must be groups of four numbers, u0,v0,u1,v1;...";
+            return false;
+        }
+        for(unsigned int i = 0; i < values.size(); i += 4)
+        {
+            Frame frame = { values[i], values[i + 1], values[i + 2], values[i + 3] };
+            mFrames.push_back(frame);
+        }
+    }
+    else
+    {
+        const std::string* columnsFlag = FindFlag(flags, "columns");
+        const std::string* rowsFlag = FindFlag(flags, "rows");
+        const int columns = columnsFlag ? atoi(columnsFlag->c_str()) : 1;
+        const int rows = rowsFlag ? atoi(rowsFlag->c_str()) : 1;
+        if(columns < 1 || rows < 1)
+        {
+            *outError = "columns and rows must be 1 or more";
+            return false;
+        }
+
+        std::vector<int> cells;
+        const std::string* framesFlag = FindFlag(flags, "frames");
+        if(framesFlag)
+        {
+            if(!ReadCells(*framesFlag, columns * rows, &cells) || cells.empty())
+            {
+                *outError = "frames must be cells in the grid, e.g. \"1-6\" or \"1,2,3\"";
+                return false;
+            }
+        }
+        else
+        {
+            for(int i = 0; i < columns * rows; i++)
+            {
+                cells.push_back(i);
+            }
+        }
+
+        for(unsigned int i = 0; i < cells.size(); i++)
+        {
+            const int column = cells[i] % columns;
+            const int row = cells[i] / columns;
+            Frame frame =
+            {
+                (double) column / columns,
+                (double) row / rows,
+                (double) (column + 1) / columns,
+                (double) (row + 1) / rows
+            };
+            mFrames.push_back(frame);
+        }
+    }
+
+    std::vector<double> durations;
+    const std::string* durationsFlag = FindFlag(flags, "durations");
+    if(durationsFlag)
+    {
+        if(!ReadNumbers(*durationsFlag, ",", &durations) || durations.empty())
+        {
+            *outError = "durations must be numbers, e.g. \"0.1,0.1,0.4\"";
+            Clear();
+            return false;
+        }
+    }
+    else
+    {
+        const std::string* fpsFlag = FindFlag(flags, "fps");
+        const double fps = fpsFlag ? atof(fpsFlag->c_str()) : DEFAULT_FPS;
+        if(!(fps > 0))
+        {
+            *outError = "fps must be above 0";
+            Clear();
+            return false;
+        }
+        durations.push_back(1 / fps);
+    }
+
+    double end = 0;
+    for(unsigned int i = 0; i < mFrames.size(); i++)
+    {
+        end += std::max(0.0, durations[std::min(i, (unsigned int) durations.size() - 1)]);
+        mEnds.push_back(end);
+    }
+
+    const std::string* loop = FindFlag(flags, "loop");
+    mLoop = !(loop && *loop == "false");
+    return true;
+}
+
+unsigned int Animation::FrameAt(double time, bool* finished) const
+{
+    *finished = false;
+    if(mFrames.empty())
+    {
+        return 0;
+    }
+
+    const double duration = Duration();
+    if(!(duration > 0))
+    {
+        *finished = !mLoop;
+        return mLoop ? 0 : mFrames.size() - 1;
+    }
+
+    if(mLoop)
+    {
+        time = fmod(time, duration);
+        if(time < 0)
+        {
+            time += duration;
+        }
+    }
+    else if(time >= duration)
+    {
+        *finished = true;
+        return mFrames.size() - 1;
+    }
+    else if(time < 0)
+    {
+        time = 0;
+    }
+
+    const unsigned int frame =
+        std::upper_bound(mEnds.begin(), mEnds.end(), time) - mEnds.begin();
+    return std::min(frame, (unsigned int) mFrames.size() - 1);
+}
+
+void Animation::Apply(Sprite* sprite)
+{
+    const Animation* animation = sprite->animation;
+    if(animation == NULL || animation->mFrames.empty())
+    {
+        return;
+    }
+
+    bool finished = false;
+    const Frame& frame = animation->mFrames[animation->FrameAt(sprite->AnimationTime(), &finished)];
+    sprite->topLeftU = frame.topLeftU;
+    sprite->topLeftV = frame.topLeftV;
+    sprite->bottomRightU = frame.bottomRightU;
+    sprite->bottomRightV = frame.bottomRightV;
+}
+
+void Animation::Apply(SpriteRecord* sprite)
+{
+    const Animation* animation = sprite->animation;
+    if(animation == NULL || animation->mFrames.empty())
+    {
+        return;
+    }
+
+    bool finished = false;
+    const Frame& frame = animation->mFrames[animation->FrameAt(sprite->AnimationTime(), &finished)];
+    sprite->topLeftU = (float) frame.topLeftU;
+    sprite->topLeftV = (float) frame.topLeftV;
+    sprite->bottomRightU = (float) frame.bottomRightU;
+    sprite->bottomRightV = (float) frame.bottomRightV;
+}
+
+AnimationStore::~AnimationStore()
+{
+    for(unsigned int i = 0; i < mAnimations.size(); i++)
+    {
+        delete mAnimations[i];
+    }
+}
+
+Animation* AnimationStore::Find(const char* name)
+{
+    Animation** animation = mIndex.Find(name);
+    return animation ? *animation : NULL;
+}
+
+Animation* AnimationStore::Get(const char* name)
+{
+    Animation* animation = Find(name);
+    if(animation == NULL)
+    {
+        animation = new Animation();
+        mAnimations.push_back(animation);
+        mIndex.Set(name, animation);
+    }
+    return animation;
+}
+
+bool AnimationStore::OnAssetReload(Asset& asset)
+{
+    std::string error;
+    if(!Get(asset.Name().c_str())->Read(asset.Flags(), &error))
+    {
+        dsprintf("Animation [%s]: %s.\n", asset.Name().c_str(), error.c_str());
+        return false;
+    }
+    return true;
+}
+
+void AnimationStore::OnAssetDestroyed(Asset& asset)
+{
+    Animation* animation = Find(asset.Name().c_str());
+    if(animation)
+    {
+        animation->Clear();
+    }
+}
+
+// Animation.Create(name, { columns = 4, rows = 2, frames = "1-6", fps = 10 })
+// Takes the same keys as the manifest. An animation with the name already
+// is replaced, sprites playing it carry on with the new frames.
+static int lua_Animation_Create(lua_State* state)
+{
+    const char* name = luaL_checkstring(state, 1);
+    luaL_checktype(state, 2, LUA_TTABLE);
+
+    std::map<std::string, std::string> flags;
+    lua_pushnil(state);
+    while(lua_next(state, 2) != 0)
+    {
+        if(lua_type(state, -2) == LUA_TSTRING)
+        {
+            if(lua_isboolean(state, -1))
+            {
+                flags[lua_tostring(state, -2)] = lua_toboolean(state, -1) ? "true" : "false";
+            }
+            else if(lua_isstring(state, -1))
+            {
+                // Copied, so a number value isn't changed in the table
+                // while it's being walked.
+                lua_pushvalue(state, -1);
+                flags[lua_tostring(state, -3)] = lua_tostring(state, -1);
+                lua_pop(state, 1);
+            }
+        }
+        lua_pop(state, 1);
+    }
+
+    std::string error;
+    AnimationStore* store = Dinodeck::GetInstance()->GetAnimations();
+    if(!store->Get(name)->Read(flags, &error))
+    {
+        return luaL_error(state, "Animation.Create [%s]: %s.", name, error.c_str());
+    }
+    return 0;
+}
+
+static Animation* CheckAnimation(lua_State* state, int index)
+{
+    const char* name = luaL_checkstring(state, index);
+    Animation* animation = Dinodeck::GetInstance()->GetAnimations()->Find(name);
+    if(animation == NULL)
+    {
+        luaL_error(state, "No animation [%s].", name);
+    }
+    return animation;
+}
+
+static int lua_Animation_Exists(lua_State* state)
+{
+    const char* name = luaL_checkstring(state, 1);
+    lua_pushboolean(state, Dinodeck::GetInstance()->GetAnimations()->Find(name) != NULL);
+    return 1;
+}
+
+static int lua_Animation_GetFrameCount(lua_State* state)
+{
+    lua_pushinteger(state, CheckAnimation(state, 1)->FrameCount());
+    return 1;
+}
+
+static int lua_Animation_GetDuration(lua_State* state)
+{
+    lua_pushnumber(state, CheckAnimation(state, 1)->Duration());
+    return 1;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_Animation_Create},
+  {"Exists", lua_Animation_Exists},
+  {"GetFrameCount", lua_Animation_GetFrameCount},
+  {"GetDuration", lua_Animation_GetDuration},
+  {NULL, NULL}  /* sentinel */
+};
+
+void Animation::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        Animation::Meta.Name(),
+        luaBinding
+    );
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "IAssetOwner.h"
+#include "NameTable.h"
+#include "reflect/Reflect.h"
+
+class LuaState;
+class Sprite;
+struct SpriteRecord;
+
+//
+// Frames of a sprite sheet and how long each shows for. A sprite playing
+// an animation has its uvs picked when it's drawn, from a clock the game
+// moves on each update, so scripts don't set them every frame.
+//
+// Animations come from the manifest's animations table or from
+// Animation.Create. Both take the same keys:
+//
+//  columns, rows   the sheet's grid, 1 by 1 if not given
+//  frames          grid cells from 1, row by row, e.g. "1-6" or "1,2,3,2",
+//                  every cell if not given
+//  rects           instead of the grid, "u0,v0,u1,v1;u0,v0,u1,v1..."
+//  fps             frames a second, 12 if not given
+//  durations       seconds for each frame, e.g. "0.1,0.1,0.4", the last
+//                  is used for any frames after it
+//  loop            "false" stops on the last frame
+//
+// In the manifest path is the sheet, so editing it reloads the animation.
+//
+class Animation
+{
+    public: static Reflect Meta;
+    public:
+        struct Frame
+        {
+            double topLeftU;
+            double topLeftV;
+            double bottomRightU;
+            double bottomRightV;
+        };
+
+        static void Bind(LuaState* state);
+        static double Clock() { return mClock; }
+        static void Advance(double deltaTime) { mClock += deltaTime; }
+        // Sets the sprite's uvs to the frame it's showing now.
+        static void Apply(Sprite* sprite);
+        static void Apply(SpriteRecord* sprite);
+
+        Animation() : mLoop(true) {}
+
+        // False, and left empty, if the keys don't make sense.
+        bool Read(const std::map<std::string, std::string>& flags, std::string* outError);
+        void Clear();
+
+        unsigned int FrameCount() const { return mFrames.size(); }
+        const Frame& GetFrame(unsigned int index) const { return mFrames[index]; }
+        double Duration() const { return mEnds.empty() ? 0 : mEnds.back(); }
+        bool Loops() const { return mLoop; }
+        // The frame showing time seconds in. Animations that don't loop
+        // stay on their last frame, finished is set once they reach it.
+        unsigned int FrameAt(double time, bool* finished) const;
+    private:
+        static double mClock;
+        std::vector<Frame> mFrames;
+        std::vector<double> mEnds; // when each frame stops showing
+        bool mLoop;
+};
+
+//
+// Owns every animation by name. They're never deleted while the store is
+// alive since sprites point at them, one removed from the manifest is
+// just left empty.
+//
+class AnimationStore : public IAssetOwner
+{
+    NameIndex<Animation*> mIndex;
+    std::vector<Animation*> mAnimations;
+public:
+    ~AnimationStore();
+    Animation* Find(const char* name);
+    // Made, empty, if there isn't one yet.
+    Animation* Get(const char* name);
+
+    virtual bool OnAssetReload(Asset& asset);
+    virtual void OnAssetDestroyed(Asset& asset);
+};
+
+#endif
\ No newline at end of file
@@ -2,9 +2,12 @@
 #include <assert.h>
 #include <stdio.h>
 
+#include "AssetReport.h"
 #include "DinodeckLua.h"
 #include "Game.h"
 #include "LuaState.h"
+#include "ManifestAssetStore.h"
+#include "TextureManager.h"
 #include "reflect/Reflect.h"
 
 Reflect Asset::Meta("Asset", Asset::Bind);
@@ -17,7 +20,9 @@ const char* Asset::TypeToStr[Asset::Count] =
     "fonts",
     "textures",
     "sounds",
-    "soundstreams"
+    "soundstreams",
+    "animations",
+    "meshes"
 };
 
 bool Asset::OnReload()
@@ -44,6 +49,8 @@ Asset::Asset(const char* name, Asset::eAssetType assetType, const char* path, IA
     mLoader = owner;
     mIsLoaded = false;
     mAssetType = assetType;
+    mContentHash = 0;
+    mHasContentHash = false;
 }
 
 Asset::Asset(const char* name,
@@ -59,6 +66,8 @@ Asset::Asset(const char* name,
     mFlags = flags;
     mIsLoaded = false;
     mAssetType = assetType;
+    mContentHash = 0;
+    mHasContentHash = false;
 }
 
 
@@ -67,6 +76,14 @@ void Asset::SetTimeLastModified(time_t lastModified)
     mLastModified = lastModified;
 }
 
+void Asset::Redefine(const char* path, const std::map<std::string, std::string>& flags)
+{
+    mPath = path;
+    mFlags = flags;
+    mIsLoaded = false;
+    mHasContentHash = false;
+}
+
 Asset::eAssetType Asset::StringToAssetType(const char* assetType)
 {
     std::string id = assetType;
@@ -91,13 +108,21 @@ Asset::eAssetType Asset::StringToAssetType(const char* assetType)
     {
         return Asset::Stream;
     }
+    else if(id == "animations")
+    {
+        return Asset::Animation;
+    }
+    else if(id == "meshes")
+    {
+        return Asset::Mesh;
+    }
     return Asset::Unknown;
 }
 
 
 int Asset::Run(lua_State* state, const char* name)
 {
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     assert(game);
     return game->RunScriptAsset(name);
 }
@@ -114,12 +139,115 @@ static int lua_Run(lua_State* state)
     return Asset::Run(state, firstArg);
 }
 
+// Asset.IsLoading(name) is true while a texture is decoding in the
+// background.
+static int lua_IsLoading(lua_State* state)
+{
+    const char* name = luaL_checkstring(state, 1);
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    lua_pushboolean(state, game->Textures()->IsLoading(name));
+    return 1;
+}
+
+// Asset.OnLoaded(function) calls the function once every asset loading
+// in the background is ready, on the next update if nothing is.
+static int lua_OnLoaded(lua_State* state)
+{
+    luaL_checktype(state, 1, LUA_TFUNCTION);
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    lua_pushvalue(state, 1);
+    game->AddLoadedCallback(luaL_ref(state, LUA_REGISTRYINDEX));
+    return 0;
+}
+
+// Asset.Report() returns a table of where load time went, costliest
+// asset first, as a string to print.
+static int lua_Report(lua_State* state)
+{
+    lua_pushstring(state, AssetReport::Table().c_str());
+    return 1;
+}
+
+// Asset.Preload(group, [priority]) starts loading a group from the
+// manifest in the background, higher priorities first.
+static int lua_Preload(lua_State* state)
+{
+    const char* group = luaL_checkstring(state, 1);
+    int priority = luaL_optint(state, 2, 0);
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    if(!game->GetAssetStore()->Preload(group, priority))
+    {
+        return luaL_error(state, "No assets in group [%s].", group);
+    }
+    return 0;
+}
+
+// Asset.Unload(group) frees a preloaded group.
+static int lua_Unload(lua_State* state)
+{
+    const char* group = luaL_checkstring(state, 1);
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    game->GetAssetStore()->Unload(group);
+    return 0;
+}
+
+// Asset.IsReady(group) is true once every asset in the group has loaded.
+static int lua_IsReady(lua_State* state)
+{
+    const char* group = luaL_checkstring(state, 1);
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    std::vector<Asset*> assets;
+    game->GetAssetStore()->GetGroup(group, &assets);
+
+    bool ready = true;
+    for(std::vector<Asset*>::iterator it = assets.begin(); it != assets.end(); ++it)
+    {
+        if(!(*it)->IsLoaded() || game->Textures()->IsLoading((*it)->Name().c_str()))
+        {
+            ready = false;
+            break;
+        }
+    }
+    lua_pushboolean(state, ready);
+    return 1;
+}
+
+// number, number, number Asset.Progress(group) is the fraction of the
+// group loaded, then how many have and how many there are. Ungrouped
+// assets are in "boot".
+static int lua_Progress(lua_State* state)
+{
+    const char* group = luaL_checkstring(state, 1);
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    std::vector<Asset*> assets;
+    game->GetAssetStore()->GetGroup(group, &assets);
+
+    int loaded = 0;
+    for(std::vector<Asset*>::iterator it = assets.begin(); it != assets.end(); ++it)
+    {
+        if((*it)->IsLoaded() && !game->Textures()->IsLoading((*it)->Name().c_str()))
+        {
+            loaded++;
+        }
+    }
+    lua_pushnumber(state, assets.empty() ? 1 : (double) loaded / assets.size());
+    lua_pushnumber(state, loaded);
+    lua_pushnumber(state, (int) assets.size());
+    return 3;
+}
+
 static const struct luaL_reg luaBinding [] = {
   {"Run", lua_Run},
   // {"Request", lua_Request},
   // {"__gc", lua_gc},
   // {"IsLoaded", lua_IsLoaded},
-  // {"IsLoading", lua_IsLoading},
+  {"IsLoading", lua_IsLoading},
+  {"OnLoaded", lua_OnLoaded},
+  {"Report", lua_Report},
+  {"Preload", lua_Preload},
+  {"Unload", lua_Unload},
+  {"IsReady", lua_IsReady},
+  {"Progress", lua_Progress},
   {NULL, NULL}  /* sentinel */
 };
 
@@ -26,6 +26,8 @@ public:
         Texture,
         Sound,
         Stream,
+        Animation,
+        Mesh,
         Count
     };
     static const char* TypeToStr[Asset::Count];
@@ -36,6 +38,8 @@ private:
 	bool mIsLoaded;
 	IAssetOwner* mLoader;
 	time_t mLastModified;
+	unsigned int mContentHash; // XXHash of the file when it was loaded
+	bool mHasContentHash;
 	eAssetType mAssetType;
 
 	bool mTouch; // used when checking what needs to be reloaded
@@ -61,8 +65,14 @@ public:
     const std::map<std::string, std::string>&  Flags() const { return mFlags; }
 	bool 				IsLoaded() const { return mIsLoaded; }
 	void				SetIsLoaded(bool value) { mIsLoaded = value; }
+	// A new path or flags from the manifest, loaded again on the next reload.
+	void				Redefine(const char* path, const std::map<std::string, std::string>& flags);
 	void 				SetTimeLastModified(time_t lastModified);
 	time_t 				LastModified() const { return mLastModified; }
+	void				SetContentHash(unsigned int hash) { mContentHash = hash; mHasContentHash = true; }
+	void				ClearContentHash() { mHasContentHash = false; }
+	bool				HasContentHash() const { return mHasContentHash; }
+	unsigned int		ContentHash() const { return mContentHash; }
 	void				Touch(bool value) { mTouch = value; }
 	bool				IsTouched() const { return mTouch; }
 	eAssetType			Type() const { return mAssetType; }
@@ -0,0 +1,227 @@
+#include "AssetReport.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <stdio.h>
+#include <vector>
+
+#include "Asset.h"
+#include "DDTime.h"
+#include "Trace.h"
+#include "util/Json.h"
+
+unsigned long long AssetReport::Entry::Cost() const
+{
+    return std::max(loadMicroseconds,
+                    readMicroseconds + decodeMicroseconds + uploadMicroseconds);
+}
+
+AssetReport::EntryMap& AssetReport::Entries()
+{
+    static EntryMap entries;
+    return entries;
+}
+
+std::string& AssetReport::Scoped()
+{
+    static std::string scoped;
+    return scoped;
+}
+
+std::string& AssetReport::JsonSnapshot()
+{
+    static std::string json("[]");
+    return json;
+}
+
+AssetReport::Totals* AssetReport::TotalsSnapshot()
+{
+    static Totals totals[TYPE_COUNT];
+    return totals;
+}
+
+void AssetReport::Snapshot()
+{
+    assert(TYPE_COUNT == Asset::Count);
+    JsonSnapshot() = Json();
+
+    Totals* totals = TotalsSnapshot();
+    std::fill(totals, totals + TYPE_COUNT, Totals());
+    const EntryMap& entries = Entries();
+    for(EntryMap::const_iterator it = entries.begin(); it != entries.end(); ++it)
+    {
+        const Entry& entry = it->second;
+        for(unsigned int type = 0; type < TYPE_COUNT; type++)
+        {
+            if(entry.type == Asset::TypeToStr[type])
+            {
+                totals[type].assets++;
+                totals[type].loads += entry.loads;
+                totals[type].loadMicroseconds += entry.Cost();
+                totals[type].memoryBytes += entry.memoryBytes;
+                break;
+            }
+        }
+    }
+}
+
+const char* AssetReport::Current()
+{
+    const std::string& scoped = Scoped();
+    return scoped.empty() ? NULL : scoped.c_str();
+}
+
+AssetReport::Entry* AssetReport::Find(const char* name)
+{
+    if(name == NULL)
+    {
+        return NULL;
+    }
+    return &Entries()[name];
+}
+
+void AssetReport::AddRead(const char* name, unsigned int bytes, unsigned long long microseconds)
+{
+    Entry* entry = Find(name);
+    if(entry)
+    {
+        entry->readBytes += bytes;
+        entry->readMicroseconds += microseconds;
+    }
+}
+
+void AssetReport::AddDecode(const char* name, unsigned long long microseconds)
+{
+    Entry* entry = Find(name);
+    if(entry)
+    {
+        entry->decodeMicroseconds += microseconds;
+    }
+}
+
+void AssetReport::AddUpload(const char* name, unsigned long long microseconds)
+{
+    Entry* entry = Find(name);
+    if(entry)
+    {
+        entry->uploadMicroseconds += microseconds;
+    }
+}
+
+void AssetReport::SetMemory(const char* name, unsigned int bytes)
+{
+    Entry* entry = Find(name);
+    if(entry)
+    {
+        entry->memoryBytes = bytes;
+    }
+}
+
+void AssetReport::Clear()
+{
+    Entries().clear();
+    Snapshot();
+}
+
+typedef std::pair<std::string, AssetReport::Entry> NamedEntry;
+
+static bool CostlierFirst(const NamedEntry& a, const NamedEntry& b)
+{
+    return a.second.Cost() > b.second.Cost();
+}
+
+static std::vector<NamedEntry> SortedEntries(const std::map<std::string, AssetReport::Entry>& entries)
+{
+    std::vector<NamedEntry> sorted(entries.begin(), entries.end());
+    std::sort(sorted.begin(), sorted.end(), CostlierFirst);
+    return sorted;
+}
+
+static double Ms(unsigned long long microseconds)
+{
+    return microseconds / 1000.0;
+}
+
+std::string AssetReport::Table()
+{
+    std::vector<NamedEntry> sorted = SortedEntries(Entries());
+    std::string out;
+    char line[512];
+
+    sprintf(line, "%-32s %-12s %5s %9s %9s %9s %9s %9s %9s\n",
+             "asset", "type", "loads", "read KB", "read ms", "decode ms",
+             "upload ms", "total ms", "memory KB");
+    out += line;
+
+    for(std::vector<NamedEntry>::iterator it = sorted.begin(); it != sorted.end(); ++it)
+    {
+        const Entry& entry = it->second;
+        sprintf(line, "%-32.200s %-12s %5u %9u %9.2f %9.2f %9.2f %9.2f %9u\n",
+                 it->first.c_str(),
+                 entry.type.c_str(),
+                 entry.loads,
+                 entry.readBytes / 1024,
+                 Ms(entry.readMicroseconds),
+                 Ms(entry.decodeMicroseconds),
+                 Ms(entry.uploadMicroseconds),
+                 Ms(entry.Cost()),
+                 entry.memoryBytes / 1024);
+        out += line;
+    }
+    return out;
+}
+
+std::string AssetReport::Json()
+{
+    std::vector<NamedEntry> sorted = SortedEntries(Entries());
+    std::string out("[");
+    char numbers[512];
+
+    for(std::vector<NamedEntry>::iterator it = sorted.begin(); it != sorted.end(); ++it)
+    {
+        const Entry& entry = it->second;
+        if(it != sorted.begin())
+        {
+            out += ",";
+        }
+        out += "{\"name\":";
+        AppendJsonString(&out, it->first);
+        out += ",\"type\":";
+        AppendJsonString(&out, entry.type);
+        sprintf(numbers,
+                ",\"loads\":%u,\"readBytes\":%u,\"readMs\":%.3f,\"decodeMs\":%.3f,"
+                "\"uploadMs\":%.3f,\"totalMs\":%.3f,\"memoryBytes\":%u}",
+                entry.loads,
+                entry.readBytes,
+                Ms(entry.readMicroseconds),
+                Ms(entry.decodeMicroseconds),
+                Ms(entry.uploadMicroseconds),
+                Ms(entry.Cost()),
+                entry.memoryBytes);
+        out += numbers;
+    }
+    out += "]";
+    return out;
+}
+
+AssetReportScope::AssetReportScope(const Asset& asset) :
+    mPrevious(AssetReport::Scoped()),
+    mName(asset.Name()),
+    mStart(DDTime::Microseconds())
+{
+    AssetReport::Entry& entry = AssetReport::Entries()[mName];
+    entry.type = Asset::TypeToStr[asset.Type()];
+    entry.loads++;
+    AssetReport::Scoped() = mName;
+}
+
+AssetReportScope::~AssetReportScope()
+{
+    const unsigned long long end = DDTime::Microseconds();
+    AssetReport::Entries()[mName].loadMicroseconds += end - mStart;
+    // Paths keep their file name if they're too long for a trace event.
+    const size_t keep = Trace::NAME_LENGTH - 1;
+    Trace::Record(mName.c_str() + (mName.size() > keep ? mName.size() - keep : 0),
+                  mStart, end);
+    AssetReport::Scoped() = mPrevious;
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#ifndef ASSETREPORT_H
+#define ASSETREPORT_H
+
+#include <map>
+#include <string>
+
+class Asset;
+
+//
+// Where asset loading time goes, per asset: bytes read, time spent reading,
+// decoding and uploading to GL or AL, and the memory the result takes.
+//
+// Main thread work is put down to the asset in the current
+// AssetReportScope. Work finished off the main thread, textures decoded
+// by the loader, is added by name when it comes back.
+//
+class AssetReport
+{
+public:
+    struct Entry
+    {
+        std::string type;
+        unsigned int loads;
+        unsigned int readBytes;
+        unsigned long long readMicroseconds;
+        unsigned long long decodeMicroseconds;
+        unsigned long long uploadMicroseconds;
+        // Wall time in the scopes, includes the stages that ran in them and
+        // any nested loads.
+        unsigned long long loadMicroseconds;
+        unsigned int memoryBytes;
+
+        Entry() :
+            type(),
+            loads(0),
+            readBytes(0),
+            readMicroseconds(0),
+            decodeMicroseconds(0),
+            uploadMicroseconds(0),
+            loadMicroseconds(0),
+            memoryBytes(0) {}
+
+        // The larger of the scoped time and the stages, background decodes
+        // happen outside any scope.
+        unsigned long long Cost() const;
+    };
+
+    // Summed over the assets of one type.
+    struct Totals
+    {
+        unsigned int assets;
+        unsigned int loads;
+        unsigned long long loadMicroseconds;
+        unsigned int memoryBytes;
+    };
+    static const unsigned int TYPE_COUNT = 8; // Asset::Count
+
+    // The asset in scope, NULL outside one.
+    static const char* Current();
+
+    // A NULL name is ignored, so callers can pass Current() as it is.
+    static void AddRead(const char* name, unsigned int bytes, unsigned long long microseconds);
+    static void AddDecode(const char* name, unsigned long long microseconds);
+    static void AddUpload(const char* name, unsigned long long microseconds);
+    static void SetMemory(const char* name, unsigned int bytes);
+
+    // Costliest first.
+    static std::string Table();
+    static std::string Json();
+    // Json as of the last Snapshot. Read by the webserver.
+    static const std::string& LastJson() { return JsonSnapshot(); }
+    // Totals by Asset::eAssetType, TYPE_COUNT of them, as of the last Snapshot.
+    static const Totals* LastTotals() { return TotalsSnapshot(); }
+    static void Snapshot();
+    static void Clear();
+private:
+    friend class AssetReportScope;
+    typedef std::map<std::string, Entry> EntryMap;
+    static EntryMap& Entries();
+    static std::string& Scoped();
+    static std::string& JsonSnapshot();
+    static Totals* TotalsSnapshot();
+    static Entry* Find(const char* name);
+};
+
+//
+// Puts main thread load work down to an asset.
+//
+//    AssetReportScope scope(asset);
+//    asset.OnReload();
+//
+class AssetReportScope
+{
+    std::string mPrevious;
+    std::string mName;
+    unsigned long long mStart;
+public:
+    AssetReportScope(const Asset& asset);
+    ~AssetReportScope();
+};
+
+#endif
\ No newline at end of file
@@ -1,22 +1,187 @@
 #include "AssetStore.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <map>
 #include <stdio.h>
 #include <string>
+#include <string.h>
 #include <sys/stat.h>
 #include <time.h>
 #include <list>
+#include <vector>
 
 #include "Asset.h"
+#include "AssetReport.h"
+#include "DDFile.h"
 #include "DDLog.h"
+#include "DDTime.h"
+#include "FileWatcher.h"
 #include "IAssetOwner.h"
+#include "IOScheduler.h"
+#include "IReloadProgress.h"
 #include "LuaState.h"
+#include "PathCache.h"
+#include "XXHash.h"
+#include "Zones.h"
 
 
 bool AssetStore::CleverReloading = true;
+bool AssetStore::ContentHashing = true;
+IReloadProgress* AssetStore::ProgressListener = NULL;
 
-AssetStore::AssetStore()
+FileWatcher& AssetStore::Watcher()
+{
+    static FileWatcher watcher;
+    return watcher;
+}
+
+//
+// Content hashes by path, with the stat they were taken at. While the
+// stat matches the hash is trusted without reading the file.
+//
+struct HashRecord
+{
+    time_t modified;
+    long size;
+    unsigned int hash;
+};
+
+struct HashCache
+{
+    std::map<std::string, HashRecord> records;
+    std::string file;
+    bool dirty;
+
+    HashCache() : records(), file(), dirty(false) {}
+};
+
+static const char* HASH_FILE_HEADER = "dinodeck-hashes 1\n";
+
+static HashCache& Hashes()
+{
+    static HashCache cache;
+    return cache;
+}
+
+void AssetStore::SetHashFile(const std::string& path)
+{
+    HashCache& cache = Hashes();
+    if(cache.file == path)
+    {
+        return;
+    }
+
+    cache.file = path;
+    cache.records.clear();
+    cache.dirty = false;
+
+    FILE* file = path.empty() ? NULL : fopen(path.c_str(), "r");
+    if(file == NULL)
+    {
+        return;
+    }
+
+    char line[1024];
+    if(fgets(line, sizeof(line), file) != NULL
+       && strcmp(line, HASH_FILE_HEADER) == 0)
+    {
+        while(fgets(line, sizeof(line), file) != NULL)
+        {
+            HashRecord record;
+            long modified = 0;
+            int pathStart = 0;
+            if(sscanf(line, "%x %ld %ld %n",
+                      &record.hash, &modified, &record.size, &pathStart) < 3
+               || pathStart == 0)
+            {
+                continue;
+            }
+            record.modified = (time_t) modified;
+
+            std::string recordPath(line + pathStart);
+            recordPath.erase(recordPath.find_last_not_of("\r\n") + 1);
+            cache.records[recordPath] = record;
+        }
+    }
+    fclose(file);
+    dsprintf("Read %d content hashes from [%s].\n",
+             (int) cache.records.size(), path.c_str());
+}
+
+static void SaveHashes()
+{
+    HashCache& cache = Hashes();
+    if(!cache.dirty || cache.file.empty())
+    {
+        return;
+    }
+
+    FILE* file = fopen(cache.file.c_str(), "w");
+    if(file == NULL)
+    {
+        dsprintf("Failed to write content hashes to [%s].\n", cache.file.c_str());
+        return;
+    }
+
+    fputs(HASH_FILE_HEADER, file);
+    for(std::map<std::string, HashRecord>::iterator it = cache.records.begin();
+        it != cache.records.end(); ++it)
+    {
+        fprintf(file, "%08x %ld %ld %s\n",
+                it->second.hash,
+                (long) it->second.modified,
+                it->second.size,
+                it->first.c_str());
+    }
+    fclose(file);
+    cache.dirty = false;
+}
+
+//
+// Pack entries have no stat, pass NULL, and are always hashed. They're
+// already in memory so it's cheap.
+//
+static bool HashContent(const std::string& path,
+                        const struct stat* s,
+                        unsigned int* outHash)
+{
+    HashCache& cache = Hashes();
+    if(s)
+    {
+        std::map<std::string, HashRecord>::iterator
+            it = cache.records.find(path);
+        if(it != cache.records.end()
+           && it->second.modified == s->st_mtime
+           && it->second.size == (long) s->st_size)
+        {
+            *outHash = it->second.hash;
+            return true;
+        }
+    }
+
+    DDFile file(path.c_str());
+    file.LoadFileView();
+    if(file.Buffer() == NULL)
+    {
+        return false;
+    }
+    *outHash = XXHash::Hash32(file.Buffer(), file.Size());
+
+    if(s)
+    {
+        HashRecord record;
+        record.modified = s->st_mtime;
+        record.size = (long) s->st_size;
+        record.hash = *outHash;
+        cache.records[path] = record;
+        cache.dirty = true;
+    }
+    return true;
+}
+
+AssetStore::AssetStore() :
+    mPreloadOrder(0)
 {
 }
 
@@ -36,45 +201,91 @@ Asset* AssetStore::Add
 	mStore.insert(std::pair<std::string, Asset>(
 					std::string(name),
 					Asset(name, assetType, path, flags, callback)));
+	AssetStore::Watcher().Watch(path);
 	// I hate you stl.
+	mIndex.Set(name, &(out.first->second));
 	return &(out.first->second);
 }
 
 bool AssetStore::AssetExists(const char* name)
 {
-	return mStore.find(name) != mStore.end();
+	return mIndex.Find(name) != NULL;
 }
 
 Asset* AssetStore::GetAssetByName(const char* name)
 {
-	std::map<std::string, Asset>::iterator iter = mStore.find(name);
-	if(iter == mStore.end())
+	Asset** asset = mIndex.Find(name);
+	return asset ? *asset : NULL;
+}
+
+bool AssetStore::ReloadAsset(const char* name)
+{
+	Asset* asset = GetAssetByName(name);
+	if(asset == NULL)
 	{
-		return NULL;
+		return false;
 	}
-	return &(iter->second);
+
+	// Grouped assets that aren't in yet pick the change up from Preload.
+	if(!asset->IsLoaded() && IsDeferred(*asset))
+	{
+		return true;
+	}
+
+	// Stamped now, so the next Reload doesn't go back to an older file.
+	return Load(*asset, time(NULL), NULL);
 }
 
 void AssetStore::Clear()
 {
+	mPreloads.clear();
+	mRequestedGroups.clear();
 	for(std::map<std::string, Asset>::iterator it = mStore.begin(); it != mStore.end(); ++it)
 	{
-		Asset& asset = it->second;
-		asset.OnDestroy();
-		mStore.erase( it++ );
+		it->second.OnDestroy();
 	}
+	mStore.clear();
+	mIndex.Clear();
 }
 
 
 bool AssetStore::Reload()
 {
+	DD_PROFILE_ZONE("AssetReload");
 	// Iterate through files,
 	// Load if not loaded
 	// Else get last modified date
 	// If date is later than store date then reload
+	// Watched files skip the stat unless a change event came in for them.
+	FileWatcher& watcher = AssetStore::Watcher();
+	watcher.Poll();
+	PathCache::BeginReload(watcher);
+	unsigned int unchanged = 0;
+	unsigned int deferred = 0;
+
+	// Packed assets are loaded in the order they're stored.
+	std::vector<Asset*> assets;
+	IOScheduler io;
 	for(std::map<std::string, Asset>::iterator it = mStore.begin(); it != mStore.end(); ++it)
 	{
-		Asset& asset = it->second;
+        // Grouped assets wait for Preload.
+        if(!it->second.IsLoaded() && IsDeferred(it->second))
+        {
+            deferred++;
+            continue;
+        }
+		assets.push_back(&it->second);
+		io.Add(it->second.Path().c_str());
+	}
+	io.Plan();
+
+	for(unsigned int i = 0; i < io.Count(); i++)
+	{
+		Asset& asset = *assets[io.Next(i)];
+		if(ProgressListener)
+		{
+			ProgressListener->OnReloadProgress(i, io.Count());
+		}
 
         if(false == AssetStore::CleverReloading)
         {
@@ -82,47 +293,272 @@ bool AssetStore::Reload()
             continue;
         }
 
+        // A change event beats the timestamp, which misses sub-second edits.
+        const bool watched = watcher.IsWatched(asset.Path());
+        if(watched && asset.IsLoaded() && !watcher.IsDirty(asset.Path()))
+        {
+            unchanged++;
+            continue;
+        }
+
 		// Be careful when loading from a package.
 		struct stat s;
+		const struct stat* found = NULL;
 		time_t lastModified = time(NULL);
-		if(stat(asset.Path().c_str(), &s) == 0)
+		if(PathCache::Stat(asset.Path().c_str(), &s))
 		{
 			lastModified = s.st_mtime;
+			found = &s;
 		}
 
-		if(asset.IsLoaded() && lastModified <= asset.LastModified())
+		unsigned int hash = 0;
+		if(!watched && asset.IsLoaded() && lastModified <= asset.LastModified())
 		{
-			dsprintf("[%s] SKIPPED.\n", asset.Name().c_str());
+			DD_LOG_DEBUG("[%s] SKIPPED.\n", asset.Name().c_str());
 		}
-		else
+		else if(AssetStore::ContentHashing
+		        && asset.IsLoaded()
+		        && asset.HasContentHash()
+		        && HashContent(asset.Path(), found, &hash)
+		        && hash == asset.ContentHash())
 		{
-			std::string timeString(ctime(&lastModified));
-			// Remove trailing \n from time string
-			{
-				size_t end = timeString.find_last_of('\n');
-				timeString = timeString.substr(0, end);
-			}
-
-			dsprintf
-			(
-			 	"Loading [%s]\nLast Modified [%s]\n\n",
-				asset.Name().c_str(),
-				timeString.c_str()
-			);
-
-			bool success = asset.OnReload();
-			if(!success)
-			{
-				asset.SetIsLoaded(false);
-				dsprintf("Fail to load [%s]\n", asset.Name().c_str());
-				return false;
-			}
+			// Touched, or a branch switch put the same bytes back.
+			DD_LOG_DEBUG("[%s] SKIPPED, content unchanged.\n", asset.Name().c_str());
 			asset.SetTimeLastModified(lastModified);
+			watcher.ClearDirty(asset.Path());
+		}
+		else if(!Load(asset, lastModified, found))
+		{
+			return false;
 		}
 	}
+
+	SaveHashes();
+	AssetReport::Snapshot();
+
+	if(deferred > 0)
+	{
+		dsprintf("[%u grouped assets] DEFERRED until preloaded.\n", deferred);
+	}
+
+	if(unchanged > 0)
+	{
+		dsprintf("[%u watched assets] SKIPPED.\n", unchanged);
+	}
 	return true;
 }
 
+//
+// Loads the asset and records what it was loaded from, so the next
+// Reload can tell if it changed. found is NULL if it's not a loose file.
+//
+bool AssetStore::Load(Asset& asset, time_t lastModified, const struct stat* found)
+{
+	std::string timeString(ctime(&lastModified));
+	// Remove trailing \n from time string
+	{
+		size_t end = timeString.find_last_of('\n');
+		timeString = timeString.substr(0, end);
+	}
+
+	dsprintf
+	(
+	 	"Loading [%s]\nLast Modified [%s]\n\n",
+		asset.Name().c_str(),
+		timeString.c_str()
+	);
+
+	bool success = false;
+	{
+		AssetReportScope scope(asset);
+		success = asset.OnReload();
+	}
+	if(!success)
+	{
+		asset.SetIsLoaded(false);
+		dsprintf("Fail to load [%s]\n", asset.Name().c_str());
+		return false;
+	}
+	asset.SetTimeLastModified(lastModified);
+	AssetStore::Watcher().ClearDirty(asset.Path());
+
+	unsigned int hash = 0;
+	asset.ClearContentHash();
+	if(AssetStore::ContentHashing
+	   && HashContent(asset.Path(), found, &hash))
+	{
+		asset.SetContentHash(hash);
+	}
+	return true;
+}
+
+const char* AssetStore::BOOT_GROUP = "boot";
+
+const std::string& AssetStore::GroupOf(const Asset& asset)
+{
+	static const std::string boot(AssetStore::BOOT_GROUP);
+
+	// Scripts are run by Asset.Run, there's nothing to load ahead of time.
+	if(asset.Type() == Asset::Script)
+	{
+		return boot;
+	}
+
+	std::map<std::string, std::string>::const_iterator
+		group = asset.Flags().find("group");
+	if(group == asset.Flags().end() || group->second.empty())
+	{
+		return boot;
+	}
+	return group->second;
+}
+
+bool AssetStore::IsDeferred(const Asset& asset) const
+{
+	const std::string& group = GroupOf(asset);
+	return group != AssetStore::BOOT_GROUP
+		&& mRequestedGroups.find(group) == mRequestedGroups.end();
+}
+
+static bool HigherPriorityFirst(const AssetStore::QueuedLoad& a, const AssetStore::QueuedLoad& b)
+{
+	if(a.priority != b.priority)
+	{
+		return a.priority > b.priority;
+	}
+	return a.order < b.order;
+}
+
+bool AssetStore::Preload(const char* group, int priority)
+{
+	assert(group);
+	if(!GroupExists(group))
+	{
+		return false;
+	}
+	mRequestedGroups[group] = priority;
+
+	// A second request for the group changes its priority.
+	for(std::deque<AssetStore::QueuedLoad>::iterator it = mPreloads.begin();
+		it != mPreloads.end(); ++it)
+	{
+		if(it->group == group)
+		{
+			it->priority = priority;
+		}
+	}
+
+	for(std::map<std::string, Asset>::iterator it = mStore.begin(); it != mStore.end(); ++it)
+	{
+		Asset& asset = it->second;
+		if(asset.IsLoaded() || GroupOf(asset) != group)
+		{
+			continue;
+		}
+
+		AssetStore::QueuedLoad preload;
+		preload.name = asset.Name();
+		preload.group = group;
+		preload.priority = priority;
+		preload.order = mPreloadOrder++;
+		mPreloads.push_back(preload);
+	}
+
+	std::sort(mPreloads.begin(), mPreloads.end(), HigherPriorityFirst);
+	return true;
+}
+
+void AssetStore::Unload(const char* group)
+{
+	assert(group);
+	if(AssetStore::BOOT_GROUP == std::string(group))
+	{
+		dsprintf("The [%s] group can't be unloaded.\n", group);
+		return;
+	}
+
+	mRequestedGroups.erase(group);
+
+	for(std::map<std::string, Asset>::iterator it = mStore.begin(); it != mStore.end(); ++it)
+	{
+		Asset& asset = it->second;
+		if(asset.IsLoaded() && GroupOf(asset) == group)
+		{
+			asset.OnDestroy();
+			asset.SetIsLoaded(false);
+		}
+	}
+	// Anything still queued is skipped as it's deferred again.
+}
+
+bool AssetStore::GroupExists(const char* group) const
+{
+	for(std::map<std::string, Asset>::const_iterator it = mStore.begin(); it != mStore.end(); ++it)
+	{
+		if(GroupOf(it->second) == group)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void AssetStore::GetGroup(const char* group, std::vector<Asset*>* out)
+{
+	assert(out);
+	for(std::map<std::string, Asset>::iterator it = mStore.begin(); it != mStore.end(); ++it)
+	{
+		if(GroupOf(it->second) == group)
+		{
+			out->push_back(&it->second);
+		}
+	}
+}
+
+void AssetStore::UpdatePreloads(unsigned int budgetMicroseconds)
+{
+	if(mPreloads.empty())
+	{
+		return;
+	}
+
+	const unsigned long long start = DDTime::Microseconds();
+	while(!mPreloads.empty())
+	{
+		AssetStore::QueuedLoad next = mPreloads.front();
+		mPreloads.pop_front();
+
+		Asset* asset = GetAssetByName(next.name.c_str());
+		if(asset == NULL || asset->IsLoaded() || IsDeferred(*asset))
+		{
+			continue;
+		}
+
+		struct stat s;
+		const struct stat* found = NULL;
+		time_t lastModified = time(NULL);
+		if(PathCache::Stat(asset->Path().c_str(), &s))
+		{
+			lastModified = s.st_mtime;
+			found = &s;
+		}
+
+		// A failure leaves it unloaded, the group just never becomes ready.
+		Load(*asset, lastModified, found);
+
+		if(DDTime::Microseconds() - start >= budgetMicroseconds)
+		{
+			break;
+		}
+	}
+
+	if(mPreloads.empty())
+	{
+		SaveHashes();
+		AssetReport::Snapshot();
+	}
+}
+
 time_t AssetStore::GetModifiedTimeStamp(Asset& asset)
 {
 	struct stat s;
@@ -155,9 +591,21 @@ void AssetStore::Remove(const char* name)
 	}
 	Asset& asset = iter->second;
 	asset.OnDestroy();
+	mIndex.Erase(name);
 	mStore.erase(iter);
 }
 
+void AssetStore::Redefine(Asset& asset,
+                          const char* path,
+                          const std::map<std::string, std::string>& flags)
+{
+	if(asset.Path() != path)
+	{
+		AssetStore::Watcher().Watch(path);
+	}
+	asset.Redefine(path, flags);
+}
+
 void AssetStore::ResetTouchFlag()
 {
     for(std::map<std::string, Asset>::iterator
@@ -200,6 +648,7 @@ void AssetStore::RemoveUntouchedAssets()
         	const char* path = iter->second.Path().c_str();
             printf("Removing [%s] as it's no longer in the manifest.\n", path);
             iter->second.OnDestroy();
+            mIndex.Erase(iter->first.c_str());
             iteratorList.push_back(iter);
         }
     }
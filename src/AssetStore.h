@@ -1,25 +1,72 @@
 #ifndef ASSETSTORE_H
 #define ASSETSTORE_H
 
+#include <deque>
 #include <string>
 #include <map>
+#include <vector>
 
 #include "Asset.h"
+#include "NameTable.h"
 
+class FileWatcher;
 class IAssetOwner;
+class IReloadProgress;
 struct lua_State;
+struct stat;
 
+//
+// Assets flagged with a group other than "boot" in the manifest aren't
+// loaded by Reload. Preload queues a group, and UpdatePreloads loads the
+// queue a little each frame, highest priority first.
+//
 class AssetStore
 {
+public:
+    static const char* BOOT_GROUP;
+
+    struct QueuedLoad
+    {
+        std::string name;
+        std::string group;
+        int priority;
+        unsigned int order; // equal priorities load first come, first served
+    };
 private:
     static bool CleverReloading;
+    static bool ContentHashing;
+    static IReloadProgress* ProgressListener;
+    // Shared by every store, the settings and manifest live outside them.
+    static FileWatcher& Watcher();
 	std::map<std::string, Asset> mStore;
+	NameIndex<Asset*> mIndex; // lookups, the map owns the assets
+	std::map<std::string, int> mRequestedGroups; // to their priority
+	std::deque<QueuedLoad> mPreloads; // highest priority first
+	unsigned int mPreloadOrder;
+
+	static const std::string& GroupOf(const Asset& asset);
+	bool IsDeferred(const Asset& asset) const;
+	bool Load(Asset& asset, time_t lastModified, const struct stat* found);
 
 public:
     static void CleverReloadingFlag(bool value)
     {
         AssetStore::CleverReloading = value;
     }
+    static bool IsCleverReloading() { return AssetStore::CleverReloading; }
+    // Told as each asset in Reload loads, NULL for no one.
+    static void SetProgressListener(IReloadProgress* listener)
+    {
+        AssetStore::ProgressListener = listener;
+    }
+    // A changed timestamp only reloads the asset if its content changed too.
+    static void ContentHashingFlag(bool value)
+    {
+        AssetStore::ContentHashing = value;
+    }
+    // Content hashes are kept here between runs, so a warm start doesn't
+    // read every file again to hash it. Empty keeps them in memory only.
+    static void SetHashFile(const std::string& path);
 	AssetStore();
 	~AssetStore();
 
@@ -34,11 +81,29 @@ public:
     Asset*  GetAssetByName(const char* name);
     bool    AssetExists(const char* name);
     bool    Reload();
+    // Reloads one asset without walking the store, for pushed changes.
+    // False if there's no such asset or it failed to load.
+    bool    ReloadAsset(const char* name);
     void    Clear();
     void    Remove(const char* name);
+    // Changes the asset's path or flags in place, so its owner reloads it
+    // over what's there and handles to it stay good.
+    void    Redefine(Asset& asset,
+                     const char* path,
+                     const std::map<std::string, std::string>& flags);
     void    RemoveUntouchedAssets();
     void    ResetTouchFlag();
     void    SetAsNotLoaded(Asset::eAssetType type);
+
+    // False if no asset is in the group.
+    bool    Preload(const char* group, int priority);
+    // Destroys the group's assets, they wait for another Preload.
+    void    Unload(const char* group);
+    bool    GroupExists(const char* group) const;
+    void    GetGroup(const char* group, std::vector<Asset*>* out);
+    // Loads queued assets until the budget is spent, at least one a call.
+    void    UpdatePreloads(unsigned int budgetMicroseconds);
+    unsigned int PendingPreloads() const { return mPreloads.size(); }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "BakedFont.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
+
+#include "DinodeckGL.h"
+#include "DDLog.h"
+
+//
+// The file, all little endian:
+//   header  "DDBF", version, flags, line height, atlas width, atlas height,
+//           glyph count, kern count. Floats are 32 bit, the rest uint32.
+//   glyphs  code point then the rest of Glyph's fields as floats, in
+//           code point order.
+//   kerns   current, next, amount, in (current, next) order.
+//   atlas   width * height bytes of alpha, top row first.
+//
+static const unsigned int HEADER_BYTES = 32;
+static const unsigned int GLYPH_BYTES = 44;
+static const unsigned int KERN_BYTES = 12;
+
+static unsigned int ReadUInt(const unsigned char* data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((unsigned int) data[3] << 24);
+}
+
+static float ReadFloat(const unsigned char* data)
+{
+    unsigned int bits = ReadUInt(data);
+    float value = 0;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static bool CompareCodePoint(const BakedFont::Glyph& glyph, unsigned int codePoint)
+{
+    return glyph.codePoint < codePoint;
+}
+
+BakedFont::~BakedFont()
+{
+    if(mTextureId != 0)
+    {
+        glDeleteTextures(1, &mTextureId);
+        mTextureId = 0;
+    }
+}
+
+bool BakedFont::Load(const char* name, const unsigned char* data, unsigned int size)
+{
+    assert(data);
+    if(size < HEADER_BYTES || memcmp(data, "DDBF", 4) != 0)
+    {
+        dsprintf("Font [%s] isn't a baked font.\n", name);
+        return false;
+    }
+
+    unsigned int version = ReadUInt(data + 4);
+    if(version != VERSION)
+    {
+        dsprintf("Font [%s] is baked font version %u, expected %u.\n", name, version, VERSION);
+        return false;
+    }
+
+    mFlags = ReadUInt(data + 8);
+    mLineHeight = ReadFloat(data + 12);
+    mTextureWidth = ReadUInt(data + 16);
+    mTextureHeight = ReadUInt(data + 20);
+    unsigned int glyphCount = ReadUInt(data + 24);
+    unsigned int kernCount = ReadUInt(data + 28);
+
+    // Counts are checked one at a time so a bad one can't overflow the sum.
+    const unsigned int available = size - HEADER_BYTES;
+    const unsigned int atlasBytes = mTextureWidth * mTextureHeight;
+    if(glyphCount > available / GLYPH_BYTES ||
+       kernCount > (available - glyphCount * GLYPH_BYTES) / KERN_BYTES ||
+       mTextureWidth > 4096 || mTextureHeight > 4096 ||
+       atlasBytes != available - glyphCount * GLYPH_BYTES - kernCount * KERN_BYTES)
+    {
+        dsprintf("Font [%s] is truncated or its counts are wrong.\n", name);
+        return false;
+    }
+
+    const unsigned char* read = data + HEADER_BYTES;
+    mGlyphs.resize(glyphCount);
+    for(unsigned int i = 0; i < glyphCount; i++)
+    {
+        Glyph& glyph = mGlyphs[i];
+        glyph.codePoint = ReadUInt(read);
+        glyph.advance = ReadFloat(read + 4);
+        glyph.width = ReadFloat(read + 8);
+        glyph.left = ReadFloat(read + 12);
+        glyph.top = ReadFloat(read + 16);
+        glyph.right = ReadFloat(read + 20);
+        glyph.bottom = ReadFloat(read + 24);
+        glyph.u0 = ReadFloat(read + 28);
+        glyph.v0 = ReadFloat(read + 32);
+        glyph.u1 = ReadFloat(read + 36);
+        glyph.v1 = ReadFloat(read + 40);
+        read += GLYPH_BYTES;
+    }
+
+    mKerns.resize(kernCount);
+    for(unsigned int i = 0; i < kernCount; i++)
+    {
+        Kern& kern = mKerns[i];
+        kern.pair = ((unsigned long long) ReadUInt(read) << 32) | ReadUInt(read + 4);
+        kern.amount = ReadFloat(read + 8);
+        read += KERN_BYTES;
+    }
+
+    if(atlasBytes > 0)
+    {
+        glGenTextures(1, &mTextureId);
+        if(mTextureId == 0)
+        {
+            dsprintf("Font [%s] failed to create its glyph texture.\n", name);
+            return false;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, mTextureId);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, mTextureWidth, mTextureHeight, 0,
+                     GL_ALPHA, GL_UNSIGNED_BYTE, read);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    }
+    return true;
+}
+
+const BakedFont::Glyph* BakedFont::Find(int codePoint) const
+{
+    std::vector<Glyph>::const_iterator it =
+        std::lower_bound(mGlyphs.begin(), mGlyphs.end(), (unsigned int) codePoint, CompareCodePoint);
+    if(it == mGlyphs.end() || it->codePoint != (unsigned int) codePoint)
+    {
+        return NULL;
+    }
+    return &(*it);
+}
+
+static bool ComparePair(const BakedFont::Kern& kern, unsigned long long pair)
+{
+    return kern.pair < pair;
+}
+
+float BakedFont::Advance(int current, int next) const
+{
+    const Glyph* glyph = Find(current);
+    if(glyph == NULL)
+    {
+        return 0;
+    }
+
+    unsigned long long pair =
+        ((unsigned long long) (unsigned int) current << 32) | (unsigned int) next;
+    std::vector<Kern>::const_iterator it =
+        std::lower_bound(mKerns.begin(), mKerns.end(), pair, ComparePair);
+    if(it != mKerns.end() && it->pair == pair)
+    {
+        return glyph->advance + it->amount;
+    }
+    return glyph->advance;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef BAKEDFONT_H
+#define BAKEDFONT_H
+
+#include <vector>
+
+#include "DinodeckGL.h"
+
+//
+// A font rasterized offline by bake_font.py, a .ddfont file. It holds
+// the glyph quads, advances and kerning pairs and then the glyph atlas,
+// a byte of alpha a texel like FTGL's glyph textures. Loading is a read
+// and one texture upload, FreeType isn't involved and the font file
+// isn't kept.
+//
+class BakedFont
+{
+public:
+    static const unsigned int VERSION = 1;
+    static const unsigned int FLAG_DISTANCE_FIELD = 1;
+
+    struct Glyph
+    {
+        unsigned int codePoint;
+        float advance;
+        float width; // of the ink, as FTGL's glyph width
+        // The quad from the pen in font space, y up.
+        float left;
+        float top;
+        float right;
+        float bottom;
+        float u0;
+        float v0;
+        float u1;
+        float v1;
+    };
+
+    struct Kern
+    {
+        unsigned long long pair; // current in the high 32 bits, next low
+        float amount;
+    };
+private:
+    std::vector<Glyph> mGlyphs; // by code point
+    std::vector<Kern> mKerns;   // by pair
+    float mLineHeight;
+    unsigned int mFlags;
+    GLuint mTextureId;
+    unsigned int mTextureWidth;
+    unsigned int mTextureHeight;
+public:
+    BakedFont() :
+        mLineHeight(0),
+        mFlags(0),
+        mTextureId(0),
+        mTextureWidth(0),
+        mTextureHeight(0) {}
+    ~BakedFont();
+
+    // Reads the file and uploads the atlas. False if it's not a baked
+    // font this version reads, the reason's logged.
+    bool Load(const char* name, const unsigned char* data, unsigned int size);
+
+    // NULL if the font has no glyph for the code point.
+    const Glyph* Find(int codePoint) const;
+    // From the current glyph's pen to the next's, kerning included.
+    float Advance(int current, int next) const;
+
+    float LineHeight() const { return mLineHeight; }
+    bool IsDistanceField() const { return (mFlags & FLAG_DISTANCE_FIELD) != 0; }
+    unsigned int GlyphCount() const { return mGlyphs.size(); }
+    GLuint TextureId() const { return mTextureId; }
+    unsigned int TextureWidth() const { return mTextureWidth; }
+    unsigned int TextureHeight() const { return mTextureHeight; }
+};
+
+#endif
\ No newline at end of file
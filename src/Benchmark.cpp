@@ -0,0 +1,133 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+#include "DDLog.h"
+#include "MemoryStats.h"
+#include "StartupTimer.h"
+
+const double Benchmark::DEFAULT_TOLERANCE = 0.1;
+
+Benchmark::Benchmark() :
+    mFrames(0),
+    mDrawCallTotal(0),
+    mTolerance(DEFAULT_TOLERANCE),
+    mRegressions(0)
+{
+    std::fill(mSplitTotals, mSplitTotals + FrameHud::SPLIT_COUNT, 0.0);
+}
+
+void Benchmark::Start(unsigned int frames)
+{
+    mFrames = frames;
+    mFrameTimes.clear();
+    mFrameTimes.reserve(frames);
+    std::fill(mSplitTotals, mSplitTotals + FrameHud::SPLIT_COUNT, 0.0);
+    mDrawCallTotal = 0;
+    mRegressions = 0;
+}
+
+void Benchmark::AddFrame(double milliseconds, const FrameHud& hud, unsigned int drawCalls)
+{
+    mFrameTimes.push_back(milliseconds);
+    mDrawCallTotal += drawCalls;
+    for(int i = 0; i < FrameHud::SPLIT_COUNT; i++)
+    {
+        mSplitTotals[i] += hud.LastSplit((FrameHud::eSplit) i);
+    }
+}
+
+bool Benchmark::LoadBaseline(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if(file == NULL)
+    {
+        dsprintf("Benchmark: Couldn't open baseline [%s]\n", path);
+        return false;
+    }
+
+    // Anything that isn't a name value pair is skipped, so a whole
+    // captured log will do.
+    char line[256];
+    while(fgets(line, sizeof(line), file))
+    {
+        char name[128];
+        Baseline baseline;
+        baseline.tolerance = -1;
+        if(sscanf(line, "%127s %lf %lf", name, &baseline.value, &baseline.tolerance) >= 2)
+        {
+            mBaseline[name] = baseline;
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+void Benchmark::Report(const char* name, double value)
+{
+    printf("%s %.3f\n", name, value);
+
+    std::map<std::string, Baseline>::const_iterator it = mBaseline.find(name);
+    if(it == mBaseline.end())
+    {
+        return;
+    }
+
+    // From nothing, anything is a regression.
+    const double baseline = it->second.value;
+    const double tolerance = it->second.tolerance < 0 ? mTolerance : it->second.tolerance;
+    printf("delta_%s %.3f\n", name, baseline > 0 ? (value - baseline) / baseline : 0.0);
+    if(value > baseline * (1 + tolerance) && value - baseline > 0.0005)
+    {
+        printf("regressed_%s %.3f\n", name, baseline);
+        mRegressions++;
+    }
+}
+
+double Benchmark::Percentile(const std::vector<double>& sorted, double fraction) const
+{
+    if(sorted.empty())
+    {
+        return 0;
+    }
+    // Nearest rank.
+    size_t index = (size_t) (fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void Benchmark::PrintReport()
+{
+    std::vector<double> sorted(mFrameTimes);
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0;
+    for(size_t i = 0; i < sorted.size(); i++)
+    {
+        total += sorted[i];
+    }
+
+    // Not a result, a longer run isn't a regression.
+    printf("bench_frames %u\n", (unsigned int) sorted.size());
+    Report("bench_total_ms", total);
+    Report("bench_mean_ms", sorted.empty() ? 0 : total / sorted.size());
+    Report("bench_p50_ms", Percentile(sorted, 0.50));
+    Report("bench_p95_ms", Percentile(sorted, 0.95));
+    Report("bench_p99_ms", Percentile(sorted, 0.99));
+    Report("bench_max_ms", sorted.empty() ? 0 : sorted.back());
+    for(int i = 0; i < FrameHud::SPLIT_COUNT; i++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "bench_%s_total_ms",
+                 FrameHud::SplitName((FrameHud::eSplit) i));
+        Report(name, mSplitTotals[i]);
+    }
+    Report("bench_draw_calls_mean", sorted.empty() ? 0 : mDrawCallTotal / sorted.size());
+    Report("bench_lua_peak_bytes", (double) MemoryStats::Peak(MemoryStats::MEMORY_LUA));
+    Report("bench_startup_ms", StartupTimer::TotalMilliseconds());
+    if(!mBaseline.empty())
+    {
+        printf("bench_regressions %u\n", mRegressions);
+    }
+    fflush(stdout);
+}
\ No newline at end of file
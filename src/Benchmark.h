@@ -0,0 +1,55 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "FrameHud.h"
+
+//
+// For --bench, records frame times and the frame HUD's splits for a set
+// number of frames and prints percentiles and totals at the end, one
+// name value pair a line so runs can be compared against a baseline.
+//
+// With --bench-compare, each result that's in the baseline is followed
+// by its change as a fraction, and one that's grown by more than the
+// tolerance is reported as a regression. A baseline line can carry its
+// own tolerance after the value. Every result is smaller is better.
+//
+class Benchmark
+{
+    struct Baseline
+    {
+        double value;
+        double tolerance; // negative for the default
+    };
+
+    unsigned int mFrames; // to run, 0 when not benchmarking
+    std::vector<double> mFrameTimes; // milliseconds
+    double mSplitTotals[FrameHud::SPLIT_COUNT];
+    double mDrawCallTotal;
+    std::map<std::string, Baseline> mBaseline;
+    double mTolerance;
+    unsigned int mRegressions;
+public:
+    static const double DEFAULT_TOLERANCE;
+
+    Benchmark();
+
+    void Start(unsigned int frames);
+    bool IsRunning() const { return mFrames > 0; }
+    bool IsDone() const { return mFrameTimes.size() >= mFrames; }
+    void AddFrame(double milliseconds, const FrameHud& hud, unsigned int drawCalls);
+    // A previous run's report, PrintReport checks against it.
+    bool LoadBaseline(const char* path);
+    // Growth over the baseline, as a fraction, that's a regression.
+    void SetTolerance(double fraction) { mTolerance = fraction; }
+    void PrintReport();
+    unsigned int Regressions() const { return mRegressions; }
+private:
+    double Percentile(const std::vector<double>& sorted, double fraction) const;
+    void Report(const char* name, double value);
+};
+
+#endif
\ No newline at end of file
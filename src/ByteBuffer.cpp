@@ -0,0 +1,322 @@
+#include "ByteBuffer.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
+#include <new>
+#include <string>
+
+#include "Asset.h"
+#include "DDFile.h"
+#include "DinodeckLua.h"
+#include "Game.h"
+#include "HttpBody.h"
+#include "LuaState.h"
+#include "ManifestAssetStore.h"
+
+Reflect ByteBuffer::Meta("ByteBuffer", ByteBuffer::Bind);
+
+static ByteBuffer* GetBufferParam(lua_State* state, int index)
+{
+    return LuaState::GetFuncParam<ByteBuffer>(state, index);
+}
+
+static unsigned int CheckOffset(lua_State* state, int index)
+{
+    int offset = luaL_checkinteger(state, index);
+    if(offset < 0)
+    {
+        luaL_argerror(state, index, "offset can't be negative");
+    }
+    return (unsigned int) offset;
+}
+
+// ByteBuffer.Create([size]), size bytes of 0.
+static int lua_ByteBuffer_Create(lua_State* state)
+{
+    int size = std::max(0, (int) luaL_optinteger(state, 1, 0));
+    SharedBuffer* buffer = SharedBuffer::Create();
+    buffer->Data().resize(size, 0);
+    ByteBuffer::Push(state, buffer);
+    return 1;
+}
+
+// ByteBuffer.FromString(str)
+static int lua_ByteBuffer_FromString(lua_State* state)
+{
+    size_t length = 0;
+    const unsigned char* str = (const unsigned char*) luaL_checklstring(state, 1, &length);
+    SharedBuffer* buffer = SharedBuffer::Create();
+    buffer->Data().assign(str, str + length);
+    ByteBuffer::Push(state, buffer);
+    return 1;
+}
+
+// ByteBuffer.Load(assetNameOrPath) views the file, nil if it can't be read.
+static int lua_ByteBuffer_Load(lua_State* state)
+{
+    const char* name = luaL_checkstring(state, 1);
+    std::string path(name);
+
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    if(game != NULL && game->GetAssetStore()->AssetExists(name))
+    {
+        path = game->GetAssetStore()->GetAssetByName(name)->Path();
+    }
+
+    DDFile* file = new DDFile(path.c_str());
+    if(!file->LoadFileView())
+    {
+        delete file;
+        lua_pushnil(state);
+        return 1;
+    }
+
+    new (lua_newuserdata(state, sizeof(ByteBuffer))) ByteBuffer(file);
+    luaL_getmetatable(state, ByteBuffer::Meta.Name().c_str());
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_ByteBuffer_gc(lua_State* state)
+{
+    ByteBuffer* buffer = (ByteBuffer*) lua_touserdata(state, 1);
+    assert(buffer);
+    buffer->~ByteBuffer();
+    return 0;
+}
+
+static int lua_ByteBuffer_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "ByteBuffer");
+    return 1;
+}
+
+static int lua_ByteBuffer_GetSize(lua_State* state)
+{
+    lua_pushinteger(state, GetBufferParam(state, 1)->Size());
+    return 1;
+}
+
+// buffer:Resize(size), new bytes are 0.
+static int lua_ByteBuffer_Resize(lua_State* state)
+{
+    ByteBuffer* buffer = GetBufferParam(state, 1);
+    int size = std::max(0, (int) luaL_checkinteger(state, 2));
+    buffer->Writable().resize(size, 0);
+    return 0;
+}
+
+// buffer:ReadU8(offset) and the like.
+template <class T>
+static int lua_ByteBuffer_Read(lua_State* state)
+{
+    ByteBuffer* buffer = GetBufferParam(state, 1);
+    unsigned int offset = CheckOffset(state, 2);
+    if(offset + sizeof(T) > buffer->Size() || offset + sizeof(T) < offset)
+    {
+        return luaL_argerror(state, 2, "read past the end");
+    }
+
+    T value;
+    memcpy(&value, buffer->Data() + offset, sizeof(T));
+    lua_pushnumber(state, (lua_Number) value);
+    return 1;
+}
+
+// buffer:WriteU8(offset, value) and the like. Writing past the end grows
+// the buffer.
+template <class T>
+static int lua_ByteBuffer_Write(lua_State* state)
+{
+    ByteBuffer* buffer = GetBufferParam(state, 1);
+    unsigned int offset = CheckOffset(state, 2);
+    T value = (T) luaL_checknumber(state, 3);
+
+    std::vector<unsigned char>& data = buffer->Writable();
+    if(offset + sizeof(T) > data.size())
+    {
+        data.resize(offset + sizeof(T), 0);
+    }
+    memcpy(&data[offset], &value, sizeof(T));
+    return 0;
+}
+
+// buffer:ReadString(offset, length), stops at the end.
+static int lua_ByteBuffer_ReadString(lua_State* state)
+{
+    ByteBuffer* buffer = GetBufferParam(state, 1);
+    unsigned int offset = CheckOffset(state, 2);
+    unsigned int length = CheckOffset(state, 3);
+    if(offset > buffer->Size())
+    {
+        return luaL_argerror(state, 2, "read past the end");
+    }
+
+    length = std::min(length, buffer->Size() - offset);
+    lua_pushlstring(state, (const char*) buffer->Data() + offset, length);
+    return 1;
+}
+
+// buffer:WriteString(offset, str) grows the buffer as the writes do.
+static int lua_ByteBuffer_WriteString(lua_State* state)
+{
+    ByteBuffer* buffer = GetBufferParam(state, 1);
+    unsigned int offset = CheckOffset(state, 2);
+    size_t length = 0;
+    const char* str = luaL_checklstring(state, 3, &length);
+
+    std::vector<unsigned char>& data = buffer->Writable();
+    if(offset + length > data.size())
+    {
+        data.resize(offset + length, 0);
+    }
+    if(length > 0)
+    {
+        memcpy(&data[offset], str, length);
+    }
+    return 0;
+}
+
+// buffer:ToString(), all of it as one Lua string.
+static int lua_ByteBuffer_ToString(lua_State* state)
+{
+    ByteBuffer* buffer = GetBufferParam(state, 1);
+    lua_pushlstring(state, (const char*) buffer->Data(), buffer->Size());
+    return 1;
+}
+
+static int lua_ByteBuffer_IsView(lua_State* state)
+{
+    lua_pushboolean(state, GetBufferParam(state, 1)->IsView());
+    return 1;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_ByteBuffer_Create},
+  {"FromString", lua_ByteBuffer_FromString},
+  {"Load", lua_ByteBuffer_Load},
+  {"__gc", lua_ByteBuffer_gc},
+  {"__tostring", lua_ByteBuffer_tostring},
+  {"GetSize", lua_ByteBuffer_GetSize},
+  {"Resize", lua_ByteBuffer_Resize},
+  {"IsView", lua_ByteBuffer_IsView},
+  {"ReadU8", lua_ByteBuffer_Read<unsigned char>},
+  {"ReadI8", lua_ByteBuffer_Read<signed char>},
+  {"ReadU16", lua_ByteBuffer_Read<unsigned short>},
+  {"ReadI16", lua_ByteBuffer_Read<short>},
+  {"ReadU32", lua_ByteBuffer_Read<unsigned int>},
+  {"ReadI32", lua_ByteBuffer_Read<int>},
+  {"ReadF32", lua_ByteBuffer_Read<float>},
+  {"ReadF64", lua_ByteBuffer_Read<double>},
+  {"WriteU8", lua_ByteBuffer_Write<unsigned char>},
+  {"WriteI8", lua_ByteBuffer_Write<signed char>},
+  {"WriteU16", lua_ByteBuffer_Write<unsigned short>},
+  {"WriteI16", lua_ByteBuffer_Write<short>},
+  {"WriteU32", lua_ByteBuffer_Write<unsigned int>},
+  {"WriteI32", lua_ByteBuffer_Write<int>},
+  {"WriteF32", lua_ByteBuffer_Write<float>},
+  {"WriteF64", lua_ByteBuffer_Write<double>},
+  {"ReadString", lua_ByteBuffer_ReadString},
+  {"WriteString", lua_ByteBuffer_WriteString},
+  {"ToString", lua_ByteBuffer_ToString},
+  {NULL, NULL}  /* sentinel */
+};
+
+void ByteBuffer::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        ByteBuffer::Meta.Name(),
+        luaBinding
+    );
+}
+
+ByteBuffer* ByteBuffer::Push(lua_State* state, SharedBuffer* buffer)
+{
+    assert(buffer);
+    ByteBuffer* out = new (lua_newuserdata(state, sizeof(ByteBuffer))) ByteBuffer(buffer);
+
+    // Saves and messages make them before a script has named the library.
+    luaL_getmetatable(state, ByteBuffer::Meta.Name().c_str());
+    if(lua_isnil(state, -1))
+    {
+        lua_pop(state, 1);
+        Reflect::Bind(ByteBuffer::Meta.Name(), LuaState::GetWrapper(state));
+        luaL_getmetatable(state, ByteBuffer::Meta.Name().c_str());
+    }
+    lua_setmetatable(state, -2);
+    return out;
+}
+
+ByteBuffer::ByteBuffer(SharedBuffer* buffer) :
+    mBuffer(buffer),
+    mFile(NULL)
+{
+    assert(buffer);
+}
+
+ByteBuffer::ByteBuffer(DDFile* file) :
+    mBuffer(NULL),
+    mFile(file)
+{
+    assert(file);
+}
+
+ByteBuffer::~ByteBuffer()
+{
+    if(mBuffer)
+    {
+        mBuffer->Release();
+    }
+    delete mFile;
+}
+
+const unsigned char* ByteBuffer::Data() const
+{
+    if(mFile)
+    {
+        return (const unsigned char*) mFile->Buffer();
+    }
+    return mBuffer->Data().empty() ? NULL : &mBuffer->Data()[0];
+}
+
+unsigned int ByteBuffer::Size() const
+{
+    if(mFile)
+    {
+        return mFile->Size();
+    }
+    return mBuffer->Data().size();
+}
+
+std::vector<unsigned char>& ByteBuffer::Writable()
+{
+    if(mFile)
+    {
+        SharedBuffer* copy = SharedBuffer::Create();
+        const unsigned char* bytes = (const unsigned char*) mFile->Buffer();
+        copy->Data().assign(bytes, bytes + mFile->Size());
+        delete mFile;
+        mFile = NULL;
+        mBuffer = copy;
+    }
+    else if(mBuffer->IsShared())
+    {
+        SharedBuffer* copy = SharedBuffer::Create();
+        copy->Data() = mBuffer->Data();
+        mBuffer->Release();
+        mBuffer = copy;
+    }
+    return mBuffer->Data();
+}
+
+SharedBuffer* ByteBuffer::Share()
+{
+    if(mFile)
+    {
+        Writable();
+    }
+    mBuffer->AddRef();
+    return mBuffer;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef BYTEBUFFER_H
+#define BYTEBUFFER_H
+
+#include <vector>
+
+#include "reflect/Reflect.h"
+
+class DDFile;
+class LuaState;
+class SharedBuffer;
+struct lua_State;
+
+//
+// Binary data for scripts that never becomes a Lua string. The bytes are
+// a SharedBuffer, so posts and saves take a reference rather than a copy,
+// or a read only view of a file until they're first written to.
+//
+// Writes to bytes that are shared, or viewed, go to a copy first, what was
+// handed over doesn't change under the thread using it.
+//
+// Offsets are in bytes from 0. Values are read and written in the host's
+// byte order, little endian on every platform we ship.
+//
+class ByteBuffer
+{
+    public: static Reflect Meta;
+    public:
+        static void Bind(LuaState* state);
+        // A new ByteBuffer userdata taking over the reference.
+        static ByteBuffer* Push(lua_State* state, SharedBuffer* buffer);
+
+        ByteBuffer(SharedBuffer* buffer); // takes over the reference
+        ByteBuffer(DDFile* file);         // takes over the loaded file
+        ~ByteBuffer();
+
+        const unsigned char* Data() const;
+        unsigned int Size() const;
+        bool IsView() const { return mFile != NULL; }
+        std::vector<unsigned char>& Writable();
+        // A reference for the caller to release. Later writes don't reach it.
+        SharedBuffer* Share();
+    private:
+        SharedBuffer* mBuffer;
+        DDFile* mFile;
+
+        ByteBuffer(const ByteBuffer&);
+        ByteBuffer& operator=(const ByteBuffer&);
+};
+
+#endif
\ No newline at end of file
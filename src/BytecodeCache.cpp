@@ -0,0 +1,131 @@
+#include "BytecodeCache.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "DinodeckLua.h"
+#include "DDLog.h"
+
+// FNV-1a
+unsigned int BytecodeCache::Hash(const char* data, unsigned int size)
+{
+    unsigned int hash = 2166136261u;
+    for(unsigned int i = 0; i < size; i++)
+    {
+        hash ^= (unsigned char) data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+int BytecodeCache::Writer(lua_State* state, const void* data, size_t size, void* userData)
+{
+    std::string* bytecode = (std::string*) userData;
+    bytecode->append((const char*) data, size);
+    return 0;
+}
+
+std::string BytecodeCache::FilePath(const std::string& name) const
+{
+    char file[16];
+    sprintf(file, "%08x.ljbc", Hash(name.c_str(), name.size()));
+    return mDirectory + "/" + file;
+}
+
+//
+// The file is the source hash followed by the bytecode.
+//
+bool BytecodeCache::ReadFile(const std::string& name, Entry* entry) const
+{
+    if(mDirectory.empty())
+    {
+        return false;
+    }
+
+    FILE* file = fopen(FilePath(name).c_str(), "rb");
+    if(file == NULL)
+    {
+        return false;
+    }
+
+    bool success = fread(&entry->hash, sizeof(entry->hash), 1, file) == 1;
+    entry->bytecode.clear();
+    char buffer[4096];
+    size_t read = 0;
+    while(success && (read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        entry->bytecode.append(buffer, read);
+    }
+    fclose(file);
+    return success && !entry->bytecode.empty();
+}
+
+void BytecodeCache::WriteFile(const std::string& name, const Entry& entry) const
+{
+    if(mDirectory.empty())
+    {
+        return;
+    }
+
+    FILE* file = fopen(FilePath(name).c_str(), "wb");
+    if(file == NULL)
+    {
+        dsprintf("Couldn't write bytecode for [%s] to [%s].\n",
+                 name.c_str(), mDirectory.c_str());
+        return;
+    }
+    fwrite(&entry.hash, sizeof(entry.hash), 1, file);
+    fwrite(entry.bytecode.data(), 1, entry.bytecode.size(), file);
+    fclose(file);
+}
+
+int BytecodeCache::Load(lua_State* state, const char* name, const char* source, unsigned int size)
+{
+    assert(name);
+    if(!mEnabled || size == 0 || source[0] == LUA_SIGNATURE[0])
+    {
+        return luaL_loadbuffer(state, source, size, name);
+    }
+
+    const unsigned int hash = Hash(source, size);
+    std::map<std::string, Entry>::iterator it = mEntries.find(name);
+    if(it == mEntries.end() || it->second.hash != hash)
+    {
+        Entry entry;
+        if(ReadFile(name, &entry) && entry.hash == hash)
+        {
+            mEntries[name] = entry;
+            it = mEntries.find(name);
+        }
+        else
+        {
+            it = mEntries.end();
+        }
+    }
+
+    if(it != mEntries.end())
+    {
+        const std::string& bytecode = it->second.bytecode;
+        if(luaL_loadbuffer(state, bytecode.data(), bytecode.size(), name) == 0)
+        {
+            mHits++;
+            return 0;
+        }
+        // Written by a different LuaJIT perhaps, compile it again.
+        lua_pop(state, 1);
+    }
+
+    int result = luaL_loadbuffer(state, source, size, name);
+    if(result != 0)
+    {
+        return result;
+    }
+
+    mCompiles++;
+    Entry& entry = mEntries[name];
+    entry.hash = hash;
+    entry.bytecode.clear();
+    lua_dump(state, BytecodeCache::Writer, &entry.bytecode);
+    WriteFile(name, entry);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef BYTECODECACHE_H
+#define BYTECODECACHE_H
+
+#include <map>
+#include <string>
+
+struct lua_State;
+
+//
+// Keeps the compiled bytecode of each script, keyed on its path and a
+// hash of its source, so reloading a state doesn't parse unchanged
+// scripts again. With a directory set the bytecode is also written to
+// disk and survives restarts.
+//
+// Scripts that are already bytecode (luajit -b) load as they are.
+//
+class BytecodeCache
+{
+public:
+    BytecodeCache() :
+        mEnabled(false),
+        mDirectory(),
+        mEntries(),
+        mHits(0),
+        mCompiles(0) {}
+
+    void SetEnabled(bool value) { mEnabled = value; }
+    bool IsEnabled() const { return mEnabled; }
+    // Empty keeps the cache in memory only.
+    void SetDirectory(const std::string& directory) { mDirectory = directory; }
+
+    // Same contract as luaL_loadbuffer, leaves the chunk or the error on
+    // the stack and returns 0 on success.
+    int Load(lua_State* state, const char* name, const char* source, unsigned int size);
+
+    unsigned int Hits() const { return mHits; }
+    unsigned int Compiles() const { return mCompiles; }
+    void ResetCounts() { mHits = 0; mCompiles = 0; }
+private:
+    struct Entry
+    {
+        unsigned int hash; // of the source
+        std::string bytecode;
+    };
+
+    bool mEnabled;
+    std::string mDirectory;
+    std::map<std::string, Entry> mEntries;
+    unsigned int mHits;
+    unsigned int mCompiles;
+
+    static unsigned int Hash(const char* data, unsigned int size);
+    static int Writer(lua_State* state, const void* data, size_t size, void* userData);
+    std::string FilePath(const std::string& name) const;
+    bool ReadFile(const std::string& name, Entry* entry) const;
+    void WriteFile(const std::string& name, const Entry& entry) const;
+};
+
+#endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <assert.h>
 
 #include "DDLog.h"
+#include "Font.h"
 #include "Game.h"
 #include "GraphicsPipeline.h"
 #include "LuaState.h"
@@ -25,6 +26,22 @@
 
 Reflect Character::Meta("Character", Character::Bind);
 
+// Characters are drawn and measured through FTGL, baked fonts have none.
+static FTTextureFont* FreeTypeFont(GraphicsPipeline* gp)
+{
+    Font* font = gp->GetFont();
+    return font ? font->FreeType() : NULL;
+}
+
+// Characters are used straight away, so glyphs go up as they load rather
+// than waiting for the next batch.
+static bool LoadGlyph(FTTextureFontImpl* impl, unsigned int charCode)
+{
+    bool loaded = impl->CheckGlyph(charCode);
+    impl->UploadDirtyGlyphs();
+    return loaded;
+}
+
 Character::Character()
     : mX(0), mY(0), mGlyph('\0')
 {
@@ -37,7 +54,7 @@ Character::~Character()
 static int lua_Character_Create(lua_State* state)
 {
         // If there's inheritance I think this may causes problems
-    if(lua_isuserdata(state, 1) && luaL_checkudata (state, 1, "Character"))
+    if(LuaState::IsType<Character>(state, 1))
     {
         Character* character = (Character*)lua_touserdata(state, 1);
         Character* pi = new (lua_newuserdata(state, sizeof(Character))) Character();
@@ -80,11 +97,15 @@ static int lua_Character_FaceMaxHeight(lua_State* state)
 
 float Character::GetKern(GraphicsPipeline* gp, unsigned int current, unsigned int next)
 {
-    FTTextureFont* font = gp->GetFont();
+    FTTextureFont* font = FreeTypeFont(gp);
+    if(font == NULL)
+    {
+        return 0;
+    }
     FTTextureFontImpl* impl = (FTTextureFontImpl*) font->GetImpl();
     FTGlyphContainer* glyphList = impl->GetGlyphList();
         // Not sure if necessary.
-    if(!impl->CheckGlyph(current) || !impl->CheckGlyph(next))
+    if(!LoadGlyph(impl, current) || !LoadGlyph(impl, next))
     {
         return 0;
     }
@@ -185,7 +206,11 @@ static int lua_Character_PixelHeight(lua_State* state)
 
 int Character::GetPixelWidth(GraphicsPipeline* gp)
 {
-    FTTextureFont* font = gp->GetFont();
+    FTTextureFont* font = FreeTypeFont(gp);
+    if(font == NULL)
+    {
+        return 0;
+    }
     FTTextureFontImpl* impl = (FTTextureFontImpl*) font->GetImpl();
     FTGlyphContainer* glyphList = impl->GetGlyphList();
     FTCharmap* charMap = glyphList->GetCharmap();
@@ -194,7 +219,7 @@ int Character::GetPixelWidth(GraphicsPipeline* gp)
     unsigned int charCode = (unsigned int) mGlyph;
 
     // This isn't just a check! It's lazy loader
-    if(!impl->CheckGlyph(charCode))
+    if(!LoadGlyph(impl, charCode))
     {
         return 0;
     }
@@ -207,7 +232,11 @@ int Character::GetPixelWidth(GraphicsPipeline* gp)
 
 int Character::GetPixelHeight(GraphicsPipeline* gp)
 {
-    FTTextureFont* font = gp->GetFont();
+    FTTextureFont* font = FreeTypeFont(gp);
+    if(font == NULL)
+    {
+        return 0;
+    }
     FTTextureFontImpl* impl = (FTTextureFontImpl*) font->GetImpl();
     FTGlyphContainer* glyphList = impl->GetGlyphList();
     FTCharmap* charMap = glyphList->GetCharmap();
@@ -216,7 +245,7 @@ int Character::GetPixelHeight(GraphicsPipeline* gp)
     unsigned int charCode = (unsigned int) mGlyph;
 
     // This isn't just a check! It's lazy loader
-    if(!impl->CheckGlyph(charCode))
+    if(!LoadGlyph(impl, charCode))
     {
         return 0;
     }
@@ -229,7 +258,11 @@ int Character::GetPixelHeight(GraphicsPipeline* gp)
 
 FTPoint Character::GetCorner(GraphicsPipeline* gp)
 {
-    FTTextureFont* font = gp->GetFont();
+    FTTextureFont* font = FreeTypeFont(gp);
+    if(font == NULL)
+    {
+        return FTPoint();
+    }
     FTTextureFontImpl* impl = (FTTextureFontImpl*) font->GetImpl();
     FTGlyphContainer* glyphList = impl->GetGlyphList();
     FTCharmap* charMap = glyphList->GetCharmap();
@@ -238,7 +271,7 @@ FTPoint Character::GetCorner(GraphicsPipeline* gp)
     unsigned int charCode = (unsigned int) mGlyph;
 
     // This isn't just a check! It's lazy loader
-    if(!impl->CheckGlyph(charCode))
+    if(!LoadGlyph(impl, charCode))
     {
         return FTPoint();
     }
@@ -253,14 +286,22 @@ FTPoint Character::GetCorner(GraphicsPipeline* gp)
 
 int Character::GetMaxHeight(GraphicsPipeline* gp)
 {
-    FTTextureFont* font = gp->GetFont();
+    FTTextureFont* font = FreeTypeFont(gp);
+    if(font == NULL)
+    {
+        return 0;
+    }
     FTTextureFontImpl* impl = (FTTextureFontImpl*) font->GetImpl();
     return impl->GetMaxHeight();
 }
 
 void Character::DrawGlyph(GraphicsPipeline* gp)
 {
-    FTTextureFont* font = gp->GetFont();
+    FTTextureFont* font = FreeTypeFont(gp);
+    if(font == NULL)
+    {
+        return;
+    }
 
     // FTTextureFont->Render is a virtual function from FTFont
     //
@@ -320,7 +361,7 @@ void Character::DrawGlyph(GraphicsPipeline* gp)
     unsigned int charCode = (unsigned int) mGlyph;
 
     // This isn't just a check! It's lazy loader
-    if(!impl->CheckGlyph(charCode))
+    if(!LoadGlyph(impl, charCode))
     {
         return;
     }
@@ -0,0 +1,130 @@
+#include "CommandList.h"
+
+#include <assert.h>
+
+bool CommandList::AppendDraw(const PackedVertex* verts,
+                             unsigned int count,
+                             GLenum drawMode,
+                             GLuint textureId,
+                             bool alphaTest,
+                             int blend,
+                             const UVBase& uvBase,
+                             int depthPass,
+                             float depth,
+                             ShaderProgram* shader,
+                             const Vector& camPosition,
+                             const Vector& camScale,
+                             float rotation,
+                             const TextureSlots* slots,
+                             const unsigned char* vertSlots)
+{
+    assert(verts);
+    assert(slots == NULL || vertSlots != NULL);
+
+    if(count == 0)
+    {
+        return false;
+    }
+
+    // Lines, triangles and quads are lists, so runs of any can be joined.
+    if(!mCommands.empty())
+    {
+        Command& last = mCommands.back();
+        if(last.type == DRAW
+           && last.drawMode == drawMode
+           && last.textureId == textureId
+           && last.alphaTest == alphaTest
+           && last.blend == blend
+           && last.uvBase == uvBase
+           && last.depthPass == depthPass
+           && last.depth == depth
+           && last.shader == shader
+           && (slots == NULL ? last.slots.count == 0 : last.slots == *slots)
+           && last.camX == (float) camPosition.x
+           && last.camY == (float) camPosition.y
+           && last.camZ == (float) camPosition.z
+           && last.scaleX == (float) camScale.x
+           && last.scaleY == (float) camScale.y
+           && last.scaleZ == (float) camScale.z
+           && last.rotation == rotation)
+        {
+            assert(last.firstVert + last.vertCount == mVerts.size());
+            last.vertCount += count;
+            mVerts.insert(mVerts.end(), verts, verts + count);
+            AppendVertSlots(vertSlots, count);
+            return true;
+        }
+    }
+
+    Command command = Command();
+    command.type = DRAW;
+    command.drawMode = drawMode;
+    command.textureId = textureId;
+    command.alphaTest = alphaTest;
+    command.blend = blend;
+    command.uvBase = uvBase;
+    command.depthPass = depthPass;
+    command.depth = depth;
+    command.shader = shader;
+    if(slots != NULL)
+    {
+        command.slots = *slots;
+    }
+    command.camX = camPosition.x;
+    command.camY = camPosition.y;
+    command.camZ = camPosition.z;
+    command.scaleX = camScale.x;
+    command.scaleY = camScale.y;
+    command.scaleZ = camScale.z;
+    command.rotation = rotation;
+    command.firstVert = mVerts.size();
+    command.vertCount = count;
+    mCommands.push_back(command);
+    mVerts.insert(mVerts.end(), verts, verts + count);
+    AppendVertSlots(vertSlots, count);
+    return false;
+}
+
+//
+// Kept in step with mVerts once there's been a slot draw, verts of other
+// draws get slot 0 as the shader never reads it for them.
+//
+void CommandList::AppendVertSlots(const unsigned char* vertSlots, unsigned int count)
+{
+    if(vertSlots == NULL)
+    {
+        if(!mVertSlots.empty())
+        {
+            mVertSlots.resize(mVerts.size(), 0);
+        }
+        return;
+    }
+
+    mVertSlots.resize(mVerts.size() - count, 0);
+    mVertSlots.insert(mVertSlots.end(), vertSlots, vertSlots + count);
+}
+
+void CommandList::AppendScissor(int x, int y, int width, int height)
+{
+    Command command = Command();
+    command.type = SCISSOR;
+    command.x = x;
+    command.y = y;
+    command.width = width;
+    command.height = height;
+    mCommands.push_back(command);
+}
+
+void CommandList::AppendScissorOff()
+{
+    Command command = Command();
+    command.type = SCISSOR_OFF;
+    mCommands.push_back(command);
+}
+
+void CommandList::AppendDepthClear()
+{
+    Command command = Command();
+    command.type = DEPTH_CLEAR;
+    mCommands.push_back(command);
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#ifndef COMMANDLIST_H
+#define COMMANDLIST_H
+
+#include <vector>
+
+#include "DinodeckGL.h"
+#include "Vector.h"
+#include "Vertex.h"
+
+class ShaderProgram;
+
+//
+// The textures a batch binds to units 0 up, for the default shader's
+// multi-texture mode. Each vert has the index of the one it samples.
+//
+struct TextureSlots
+{
+    static const unsigned int MAX_SLOTS = 8;
+    // A vert's slot when it's untextured.
+    static const unsigned char UNTEXTURED = 255;
+
+    GLuint ids[MAX_SLOTS];
+    unsigned int count;
+
+    TextureSlots() : count(0) {}
+
+    // -1 if the texture isn't in a slot.
+    int Find(GLuint id) const
+    {
+        for(unsigned int i = 0; i < count; i++)
+        {
+            if(ids[i] == id)
+            {
+                return (int) i;
+            }
+        }
+        return -1;
+    }
+
+    // The slot the texture's in, adding it if there's one of limit free.
+    // -1 if they're all taken.
+    int Add(GLuint id, unsigned int limit)
+    {
+        int slot = Find(id);
+        if(slot >= 0)
+        {
+            return slot;
+        }
+        if(count >= limit || count >= MAX_SLOTS)
+        {
+            return -1;
+        }
+        ids[count] = id;
+        return (int) count++;
+    }
+
+    bool operator==(const TextureSlots& other) const
+    {
+        if(count != other.count)
+        {
+            return false;
+        }
+        for(unsigned int i = 0; i < count; i++)
+        {
+            if(ids[i] != other.ids[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+//
+// A frame's draws recorded without touching GL, so all the GL work for
+// the frame is done in one place after the script has run. Every batch's
+// verts go into one array and are uploaded together.
+// It's shared by every renderer, so a batch drawn with the same state as
+// the one before it, from whichever renderer, joins its draw.
+//
+class CommandList
+{
+public:
+    enum Type
+    {
+        DRAW,
+        SCISSOR,
+        SCISSOR_OFF,
+        DEPTH_CLEAR
+    };
+
+    struct Command
+    {
+        Type type;
+
+        // DRAW
+        GLenum drawMode;
+        GLuint textureId; // 0 for untextured
+        bool alphaTest;
+        int blend; // an eBlendMode
+        UVBase uvBase;
+        int depthPass; // an eDepthPass
+        float depth; // 0 near to 1 far, for the opaque pass
+        ShaderProgram* shader; // NULL for the default
+        TextureSlots slots; // textureId's ignored when these are used
+        float camX, camY, camZ;
+        float scaleX, scaleY, scaleZ;
+        float rotation; // degrees
+        unsigned int firstVert;
+        unsigned int vertCount;
+
+        // SCISSOR
+        int x, y, width, height;
+    };
+private:
+    std::vector<PackedVertex> mVerts;
+    std::vector<unsigned char> mVertSlots; // empty until there's a slot draw
+    std::vector<Command> mCommands;
+    void AppendVertSlots(const unsigned char* vertSlots, unsigned int count);
+public:
+    void Clear() { mVerts.clear(); mVertSlots.clear(); mCommands.clear(); }
+    bool IsEmpty() const { return mCommands.empty(); }
+
+    // True if the verts joined the previous draw.
+    bool AppendDraw(const PackedVertex* verts,
+                    unsigned int count,
+                    GLenum drawMode,
+                    GLuint textureId,
+                    bool alphaTest,
+                    int blend,
+                    const UVBase& uvBase,
+                    int depthPass,
+                    float depth,
+                    ShaderProgram* shader,
+                    const Vector& camPosition,
+                    const Vector& camScale,
+                    float rotation,
+                    const TextureSlots* slots = NULL,
+                    const unsigned char* vertSlots = NULL);
+    void AppendScissor(int x, int y, int width, int height);
+    void AppendScissorOff();
+    void AppendDepthClear();
+
+    const std::vector<Command>& Commands() const { return mCommands; }
+    const PackedVertex* Verts() const { return mVerts.empty() ? NULL : &mVerts[0]; }
+    unsigned int VertCount() const { return mVerts.size(); }
+    // Each vert's texture slot, NULL if no draw uses slots.
+    const unsigned char* VertSlots() const { return mVertSlots.empty() ? NULL : &mVertSlots[0]; }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "CompressedImage.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include "DinodeckGL.h"
+#include "DDFile.h"
+#include "DDLog.h"
+
+// Not every GL header defines these.
+static const GLenum DXT1_RGBA = 0x83F1; // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+static const GLenum DXT3_RGBA = 0x83F2; // GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+static const GLenum DXT5_RGBA = 0x83F3; // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+
+static const unsigned int DDS_HEADER_SIZE = 128; // with the magic
+static const unsigned int KTX_HEADER_SIZE = 64;
+static const unsigned char KTX_IDENTIFIER[12] =
+{
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+static const unsigned int KTX_NATIVE_ENDIAN = 0x04030201;
+
+static unsigned int ReadUInt(const unsigned char* data, bool swap)
+{
+    unsigned int value = 0;
+    memcpy(&value, data, sizeof(value));
+    if(swap)
+    {
+        value = ((value & 0xFF) << 24)
+              | ((value & 0xFF00) << 8)
+              | ((value >> 8) & 0xFF00)
+              | (value >> 24);
+    }
+    return value;
+}
+
+static unsigned int MakeFourCC(char a, char b, char c, char d)
+{
+    return (unsigned int) a
+        | ((unsigned int) b << 8)
+        | ((unsigned int) c << 16)
+        | ((unsigned int) d << 24);
+}
+
+bool CompressedImage::IsFormatSupported(GLenum format)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+    if(count <= 0)
+    {
+        return false;
+    }
+
+    std::vector<GLint> formats(count);
+    glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, &formats[0]);
+    return std::find(formats.begin(), formats.end(), (GLint) format) != formats.end();
+}
+
+bool CompressedImage::Load(const char* filename)
+{
+    mFormat = 0;
+    mLevels.clear();
+    mData.clear();
+
+    DDFile file(filename);
+    file.LoadFileView();
+    if(NULL == file.Buffer())
+    {
+        dsprintf("Failed to load [%s]\n", filename);
+        return false;
+    }
+
+    const unsigned char* data = (const unsigned char*) file.Buffer();
+    const unsigned int size = file.Size();
+    bool success = false;
+
+    if(size >= 4 && memcmp(data, "DDS ", 4) == 0)
+    {
+        success = ParseDDS(data, size);
+    }
+    else if(size >= sizeof(KTX_IDENTIFIER)
+            && memcmp(data, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) == 0)
+    {
+        success = ParseKTX(data, size);
+    }
+
+    if(!success)
+    {
+        dsprintf("[%s] isn't a compressed DDS or KTX file.\n", filename);
+    }
+    return success;
+}
+
+void CompressedImage::AddLevel(int width, int height,
+                               const unsigned char* data, unsigned int size)
+{
+    Level level;
+    level.width = width;
+    level.height = height;
+    level.offset = mData.size();
+    level.size = size;
+    mLevels.push_back(level);
+    mData.insert(mData.end(), data, data + size);
+}
+
+bool CompressedImage::ParseDDS(const unsigned char* file, unsigned int size)
+{
+    if(size < DDS_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    const int height = (int) ReadUInt(file + 12, false);
+    const int width = (int) ReadUInt(file + 16, false);
+    const unsigned int mipCount = std::max(ReadUInt(file + 28, false), 1u);
+    const unsigned int fourCC = ReadUInt(file + 84, false);
+
+    unsigned int blockSize = 16;
+    if(fourCC == MakeFourCC('D', 'X', 'T', '1'))
+    {
+        mFormat = DXT1_RGBA;
+        blockSize = 8;
+    }
+    else if(fourCC == MakeFourCC('D', 'X', 'T', '3'))
+    {
+        mFormat = DXT3_RGBA;
+    }
+    else if(fourCC == MakeFourCC('D', 'X', 'T', '5'))
+    {
+        mFormat = DXT5_RGBA;
+    }
+    else
+    {
+        return false; // uncompressed, or a DX10 header
+    }
+
+    unsigned int offset = DDS_HEADER_SIZE;
+    int levelWidth = width;
+    int levelHeight = height;
+    for(unsigned int i = 0; i < mipCount; i++)
+    {
+        const unsigned int levelSize = std::max(1, (levelWidth + 3) / 4)
+                                     * std::max(1, (levelHeight + 3) / 4)
+                                     * blockSize;
+        if(offset + levelSize > size)
+        {
+            break; // truncated, keep the levels read so far
+        }
+
+        AddLevel(levelWidth, levelHeight, file + offset, levelSize);
+        offset += levelSize;
+        levelWidth = std::max(levelWidth / 2, 1);
+        levelHeight = std::max(levelHeight / 2, 1);
+    }
+    return !mLevels.empty();
+}
+
+bool CompressedImage::ParseKTX(const unsigned char* file, unsigned int size)
+{
+    if(size < KTX_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    const bool swap = ReadUInt(file + 12, false) != KTX_NATIVE_ENDIAN;
+    const unsigned int glType = ReadUInt(file + 16, swap);
+    const unsigned int internalFormat = ReadUInt(file + 28, swap);
+    const int width = (int) ReadUInt(file + 36, swap);
+    const int height = (int) ReadUInt(file + 40, swap);
+    const unsigned int faces = ReadUInt(file + 52, swap);
+    const unsigned int mipCount = std::max(ReadUInt(file + 56, swap), 1u);
+    const unsigned int keyValueBytes = ReadUInt(file + 60, swap);
+
+    if(glType != 0 || faces != 1)
+    {
+        return false; // uncompressed or a cube map
+    }
+
+    mFormat = internalFormat;
+    unsigned int offset = KTX_HEADER_SIZE + keyValueBytes;
+    int levelWidth = width;
+    int levelHeight = std::max(height, 1);
+    for(unsigned int i = 0; i < mipCount; i++)
+    {
+        if(offset + 4 > size)
+        {
+            break;
+        }
+
+        const unsigned int levelSize = ReadUInt(file + offset, swap);
+        offset += 4;
+        if(offset + levelSize > size)
+        {
+            break;
+        }
+
+        AddLevel(levelWidth, levelHeight, file + offset, levelSize);
+        offset += (levelSize + 3) & ~3u; // levels are 4 byte aligned
+        levelWidth = std::max(levelWidth / 2, 1);
+        levelHeight = std::max(levelHeight / 2, 1);
+    }
+    return !mLevels.empty();
+}
+
+bool CompressedImage::HasFullMipChain() const
+{
+    if(mLevels.empty())
+    {
+        return false;
+    }
+
+    const Level& last = mLevels.back();
+    return last.width == 1 && last.height == 1;
+}
\ No newline at end of file
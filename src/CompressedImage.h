@@ -0,0 +1,54 @@
+#ifndef COMPRESSEDIMAGE_H
+#define COMPRESSEDIMAGE_H
+
+#include <vector>
+
+#include "DinodeckGL.h"
+
+//
+// A block compressed image read from a DDS or KTX file, ready for
+// glCompressedTexImage2D. DDS files can hold DXT1, DXT3 or DXT5, KTX
+// files any compressed format, such as ETC1, ETC2 or ASTC.
+//
+class CompressedImage
+{
+public:
+    struct Level
+    {
+        int width;
+        int height;
+        unsigned int offset; // into the data
+        unsigned int size;
+    };
+private:
+    GLenum mFormat;
+    std::vector<Level> mLevels;
+    std::vector<unsigned char> mData;
+
+    bool ParseDDS(const unsigned char* file, unsigned int size);
+    bool ParseKTX(const unsigned char* file, unsigned int size);
+    void AddLevel(int width, int height, const unsigned char* data, unsigned int size);
+public:
+    CompressedImage() : mFormat(0) {}
+
+    // False, with a log line, if the file isn't a compressed DDS or KTX.
+    bool Load(const char* filename);
+
+    // Whether the GL lists the format as one it can sample.
+    static bool IsFormatSupported(GLenum format);
+
+    GLenum Format() const { return mFormat; }
+    int Width() const { return mLevels.empty() ? 0 : mLevels[0].width; }
+    int Height() const { return mLevels.empty() ? 0 : mLevels[0].height; }
+    unsigned int LevelCount() const { return mLevels.size(); }
+    const Level& GetLevel(unsigned int index) const { return mLevels[index]; }
+    const unsigned char* LevelData(unsigned int index) const
+    {
+        return &mData[mLevels[index].offset];
+    }
+
+    // True if every level down to 1x1 is present.
+    bool HasFullMipChain() const;
+};
+
+#endif
\ No newline at end of file
@@ -6,33 +6,145 @@
 
 #include "IAssetOwner.h"
 #include "Asset.h"
+#include "NameTable.h"
 
 class DDAudio : public IAssetOwner
 {
+public:
+    // Which playing sound gives up its voice when none are free.
+    enum eSteal
+    {
+        StealLowestPriority,
+        StealOldest,
+        StealQuietest
+    };
+
+    // From a sound's manifest flags e.g.
+    // priority = "10", max_instances = "3", steal = "oldest", load = "ondemand"
+    struct SoundPolicy
+    {
+        int priority; // a sound never steals from a higher priority
+        int maxInstances; // 0 is no cap
+        eSteal steal;
+        int bus; // from the "bus" flag, "sfx" by default
+        // From the "load" flag, "resident" by default. An ondemand sound
+        // isn't read until it's played or preloaded.
+        bool onDemand;
+
+        SoundPolicy() :
+            priority(0), maxInstances(0), steal(StealLowestPriority), bus(0),
+            onDemand(false) {}
+    };
+
+    struct Stats
+    {
+        unsigned int plays;
+        unsigned int dropped; // no voice was free or could be stolen
+        unsigned int steals;
+        unsigned int streamUnderruns; // a stream ran dry and was restarted
+        unsigned int loadMisses; // an ondemand sound was played before it loaded
+        unsigned int unloads; // ondemand sounds unloaded for the budget
+        // From Play to alSourcePlay returning, for the last sound.
+        unsigned long long lastStartMicroseconds;
+        // From Play to OpenAL reading the first samples, seen once a frame.
+        unsigned long long lastConsumeMicroseconds;
+        unsigned long long averageConsumeMicroseconds;
+        unsigned long long maxConsumeMicroseconds;
+        float outputLatency; // seconds more until the samples are heard
+
+        Stats() :
+            plays(0), dropped(0), steals(0), streamUnderruns(0),
+            loadMisses(0), unloads(0),
+            lastStartMicroseconds(0), lastConsumeMicroseconds(0),
+            averageConsumeMicroseconds(0), maxConsumeMicroseconds(0),
+            outputLatency(-1) {}
+    };
 private:
-    std::map<std::string, int> mSoundNameId;
-    std::map<std::string, Asset*> mStreamNameAsset;
+    NameIndex<int> mSounds;
+    NameIndex<SoundPolicy> mPolicies;
+    NameIndex<Asset*> mStreams;
+    bool mShareBuffers;
+    unsigned int mSoundBudget;
+    int PlayLoaded(int sound, unsigned int handle, bool loop);
 public:
 
     DDAudio();
     ~DDAudio();
     void Reset();
+    // Sounds with the same file share one buffer, on by default.
+    void SetShareBuffers(bool value) { mShareBuffers = value; }
+    // Bytes of sound buffers to hold, 0 is no limit. Past it the least
+    // recently played ondemand sounds that aren't playing are unloaded,
+    // resident sounds never are. Android holds every sound.
+    void SetSoundBudget(unsigned int bytes) { mSoundBudget = bytes; }
+    // Frees the voices of sounds that have finished, once a frame.
+    void Update();
 
     int GetSound(const char* name);
     Asset* GetStream(const char* name);
 
+    // A handle Play takes instead of the name, -1 if there's no such sound.
+    // It stays good when the sound is reloaded.
+    int FindSound(const char* name);
+
+    // Unloads every ondemand sound that isn't playing, for low memory.
+    // Returns the bytes freed.
+    unsigned int ReleaseCaches();
+    // Starts an ondemand sound loading so it's ready when it's played.
+    // False if there's no such sound.
+    bool Preload(const char* name);
+
     int Play(const char* name, bool loop);
+    int Play(int handle, bool loop);
     void Stop(int id);
     void Pause(int id);
     void Resume(int id);
     void SetVolume(int id, float volume);
 
     int PlayStream(const char* name, bool loop);
+    // The track plays on the same id once the stream's current one is
+    // done, with no gap when they're in the same format. A looping
+    // stream finishes its pass first. False if there's no such stream.
+    bool QueueStream(int id, const char* name, bool loop);
+    // Starts the track faded out and swaps the volumes of the two over
+    // the seconds, then stops the old stream. Returns the new stream's id.
+    int CrossFadeStream(int id, const char* name, float seconds, bool loop);
     void StopStream(int id);
     void PauseStream(int id);
     void ResumeStream(int id);
     void SetStreamVolume(int id, float volume);
 
+    // Every sound plays on a bus, "sfx" unless its manifest entry has a
+    // bus flag, streams default to "music". "ui" is there to use too.
+    // Volume changes are sent to OpenAL together in Update.
+    void SetBusVolume(const char* bus, float volume);
+    float GetBusVolume(const char* bus);
+    // Fades the bus to the volume, on top of its own.
+    // Duck(bus, 1, seconds) fades it back.
+    void Duck(const char* bus, float volume, float seconds);
+
+    // Mixes a second, higher is lower latency for more CPU.
+    void SetOutputRefresh(int refresh);
+    // Sounds loaded after are converted once, on the decode thread, to the
+    // device's rate if outputRate and to 1 or 2 channels, 0 keeps theirs.
+    // Stereo sounds aren't positioned. Android plays them as they are.
+    void SetConversion(bool outputRate, int channels, bool cubic);
+    // Seconds until a sound played now is heard, -1 if unknown.
+    float GetOutputLatency();
+
+    // Positions are in world units, the same as sprites. The first
+    // SetPosition makes a sound positional, later moves are sent in Update.
+    // Only mono sounds pan.
+    void SetPosition(int id, float x, float y);
+    void SetListener(float x, float y);
+    // Full volume within reference of the listener, silent past max.
+    void SetDistances(float reference, float max);
+    // Changes each time the voice is given to a new sound, 0 once stopped.
+    unsigned int VoiceSerial(int id);
+
+    void GetStats(Stats* out);
+    void ResetStats();
+
     //
     // IAssetOwner implementation.
     //
@@ -2,43 +2,1217 @@
 
 #include <AL/al.h>
 #include <AL/alc.h>
+#include <AL/alext.h>
+#include <algorithm>
 #include <assert.h>
+#include <deque>
+#include <map>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "audio/Wave.h"
+#include "audio/WaveDecoder.h"
+#include "audio/WaveStream.h"
+#include "AssetReport.h"
+#include "AssetStore.h"
+#include "DDFile.h"
 #include "DDLog.h"
+#include "DDTime.h"
+#include "MemoryStats.h"
+#include "Zones.h"
+#include "SDL/SDL_mutex.h"
+#include "SDL/SDL_thread.h"
+#include "SDL/SDL_timer.h"
 
 static const unsigned int MAX_SOUND_CHANNELS = 256;
 std::vector<unsigned int> gChannels;
 
+//
+// Buses scale the volume of every sound played on them. Ducking fades a
+// bus towards a level and back, on top of its volume.
+//
+struct Bus
+{
+    std::string name;
+    float volume;
+    float duck;
+    float duckTarget;
+    float duckRate; // per second
+
+    Bus(const char* name) :
+        name(name), volume(1), duck(1), duckTarget(1), duckRate(0) {}
+};
+std::vector<Bus> gBuses;
+// Volume changes are applied to OpenAL once a frame, in Update.
+bool gBusesChanged = false;
+bool gVoicesChanged = false;
+unsigned long long gLastAudioUpdate = 0;
+
+int FindBus(const char* name)
+{
+    for(unsigned int i = 0; i < gBuses.size(); i++)
+    {
+        if(gBuses[i].name == name)
+        {
+            return (int) i;
+        }
+    }
+    gBuses.push_back(Bus(name));
+    return (int) gBuses.size() - 1;
+}
+
+float BusGain(int bus)
+{
+    return gBuses[bus].volume * gBuses[bus].duck;
+}
+
+// Which channels are free is tracked here rather than asking OpenAL each
+// play. A voice is a channel that's playing or paused, it's freed once it
+// stops.
+struct Voice
+{
+    unsigned int channel;
+    unsigned int sound; // the handle from FindSound
+    int priority;
+    int bus;
+    float gain; // from SetVolume, before the bus
+    bool changed;
+    unsigned int order; // when it started, to find the oldest
+    unsigned long long called; // when Play was called
+    bool consumed; // OpenAL has read its first samples
+    bool positional; // else it plays relative to the listener, unpanned
+    bool moved;
+    float x;
+    float y;
+};
+std::vector<unsigned int> gFreeChannels;
+std::vector<Voice> gVoices;
+unsigned int gVoiceOrder = 0;
+
+DDAudio::Stats gStats;
+unsigned long long gConsumeTotal = 0;
+unsigned int gConsumeCount = 0;
+unsigned long long gPlayCalled = 0;
+unsigned int gStreamUnderruns = 0; // the stream mutex guards it
+
+// Positions are batched like volumes, sent to OpenAL in Update.
+bool gPositionsChanged = false;
+bool gListenerChanged = false;
+float gListenerX = 0;
+float gListenerY = 0;
+float gReferenceDistance = 128;
+float gMaxDistance = 1024;
+
+
+ALCdevice* gDevice = NULL;
+ALCcontext* gContext = NULL;
+// Sounds are converted to it as they're loaded, so the mixer doesn't
+// resample each voice every mix.
+WaveDecoder::Conversion gConversion;
+
+bool IsSoundStopped(unsigned int channel)
+{
+    int value;
+    alGetSourcei(channel, AL_SOURCE_STATE, &value);
+    return value == AL_STOPPED || value == AL_INITIAL;
+}
+
+// Checked each frame until the voice's first samples have been read,
+// so the times are only as fine as the frame rate.
+void MeasureConsumed()
+{
+    const unsigned long long now = DDTime::Microseconds();
+    for(std::vector<Voice>::iterator it = gVoices.begin(); it != gVoices.end(); ++it)
+    {
+        if(it->consumed)
+        {
+            continue;
+        }
+
+        int offset = 0;
+        alGetSourcei(it->channel, AL_SAMPLE_OFFSET, &offset);
+        if(offset == 0 && !IsSoundStopped(it->channel))
+        {
+            continue;
+        }
+
+        it->consumed = true;
+        const unsigned long long elapsed = now - it->called;
+        gStats.lastConsumeMicroseconds = elapsed;
+        gStats.maxConsumeMicroseconds = std::max(gStats.maxConsumeMicroseconds, elapsed);
+        gConsumeTotal += elapsed;
+        gConsumeCount++;
+    }
+}
+
+void ReclaimChannels()
+{
+    unsigned int i = 0;
+    while(i < gVoices.size())
+    {
+        if(IsSoundStopped(gVoices[i].channel))
+        {
+            gFreeChannels.push_back(gVoices[i].channel);
+            gVoices[i] = gVoices.back();
+            gVoices.pop_back();
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+// Is a a better voice to steal than b?
+bool IsBetterVictim(const Voice& a, const Voice& b, DDAudio::eSteal steal)
+{
+    if(steal == DDAudio::StealLowestPriority && a.priority != b.priority)
+    {
+        return a.priority < b.priority;
+    }
+
+    if(steal == DDAudio::StealQuietest)
+    {
+        const float aGain = a.gain * BusGain(a.bus);
+        const float bGain = b.gain * BusGain(b.bus);
+        if(aGain != bGain)
+        {
+            return aGain < bGain;
+        }
+    }
+    return a.order < b.order;
+}
+
+//
+// Picks a playing voice to give to the new sound. With onlySound set only
+// instances of that sound are considered. Returns NULL if nothing can be
+// stolen.
+//
+Voice* FindVictim(const DDAudio::SoundPolicy& policy, unsigned int sound, bool onlySound)
+{
+    Voice* victim = NULL;
+    for(std::vector<Voice>::iterator it = gVoices.begin(); it != gVoices.end(); ++it)
+    {
+        if(onlySound ? it->sound != sound : it->priority > policy.priority)
+        {
+            continue;
+        }
+
+        if(victim == NULL || IsBetterVictim(*it, *victim, policy.steal))
+        {
+            victim = &(*it);
+        }
+    }
+    return victim;
+}
+
+Voice* FindVoice(unsigned int channel)
+{
+    for(std::vector<Voice>::iterator it = gVoices.begin(); it != gVoices.end(); ++it)
+    {
+        if(it->channel == channel)
+        {
+            return &(*it);
+        }
+    }
+    return NULL;
+}
+
+int FindNextFreeChannel(const DDAudio::SoundPolicy& policy, unsigned int sound)
+{
+    Voice* voice = NULL;
+
+    if(policy.maxInstances > 0)
+    {
+        int instances = 0;
+        for(std::vector<Voice>::iterator it = gVoices.begin(); it != gVoices.end(); ++it)
+        {
+            instances += (it->sound == sound) ? 1 : 0;
+        }
+
+        if(instances >= policy.maxInstances)
+        {
+            voice = FindVictim(policy, sound, true);
+        }
+    }
+
+    if(voice == NULL && gFreeChannels.empty())
+    {
+        // Sounds played this frame may have already finished.
+        ReclaimChannels();
+        if(gFreeChannels.empty())
+        {
+            voice = FindVictim(policy, sound, false);
+            if(voice == NULL)
+            {
+                return -1;
+            }
+        }
+    }
+
+    if(voice)
+    {
+        alSourceStop(voice->channel);
+        gStats.steals++;
+    }
+    else
+    {
+        Voice newVoice;
+        newVoice.channel = gFreeChannels.back();
+        gFreeChannels.pop_back();
+        gVoices.push_back(newVoice);
+        voice = &gVoices.back();
+    }
+
+    voice->sound = sound;
+    voice->priority = policy.priority;
+    voice->bus = policy.bus;
+    voice->gain = 1;
+    voice->changed = false;
+    voice->order = gVoiceOrder++;
+    voice->called = gPlayCalled;
+    voice->consumed = false;
+    voice->positional = false;
+    voice->moved = false;
+    return voice->channel;
+}
+
+void FreeAllChannels()
+{
+    gVoices.clear();
+    gFreeChannels.assign(gChannels.rbegin(), gChannels.rend());
+}
+
+//
+// Streams play from a small queue of buffers that a thread keeps topped
+// up, so a track never needs to be in memory all at once. Each stream
+// has a channel of its own, set aside from the sound channels.
+//
+// Tracks started by Queue and CrossFade are opened on the thread, with
+// their first buffer read ahead, so the main thread never waits on the
+// file. A queued track in the same format is queued straight on behind
+// the last buffer of the one before, so there's no gap. Fades are
+// stepped on the thread too, they carry on while the game loop sleeps.
+//
+static const unsigned int MAX_STREAMS = 4;
+static const unsigned int STREAM_BUFFERS = 4;
+static const unsigned int STREAM_BUFFER_SIZE = 32 * 1024;
+static const unsigned int STREAM_SLEEP_MS = 10;
+
+struct Stream
+{
+    unsigned int channel;
+    ALuint buffers[STREAM_BUFFERS];
+    WaveStream* wave; // NULL until the thread's opened it
+    std::vector<char> primed; // read ahead, played before the wave
+    bool loop;
+    bool paused;
+    bool finished; // every sample is queued
+    int bus;
+    float gain;
+    float busGain; // as of the last ApplyVolumes
+    bool changed;
+    std::string pendingPath; // for the thread to open, as the wave or the next
+    WaveStream* next; // plays once the wave is done
+    std::vector<char> nextPrimed;
+    bool nextLoop;
+    float fade;
+    float fadeTarget;
+    float fadeRate; // a second
+    bool stopWhenFaded;
+};
+std::vector<unsigned int> gStreamChannels;
+std::map<int, Stream*> gStreams;
+int gNextStreamId = 1;
+SDL_mutex* gStreamMutex = NULL;
+SDL_Thread* gStreamThread = NULL;
+bool gStreamThreadStopping = false;
+unsigned long long gLastStreamService = 0;
+
+Stream* FindStream(int id)
+{
+    std::map<int, Stream*>::iterator it = gStreams.find(id);
+    return (it == gStreams.end()) ? NULL : it->second;
+}
+
+void ApplyStreamGain(Stream* stream)
+{
+    alSourcef(stream->channel, AL_GAIN, stream->gain * stream->busGain * stream->fade);
+}
+
+unsigned int ReadStream(Stream* stream, char* out)
+{
+    if(!stream->primed.empty())
+    {
+        const unsigned int bytes = stream->primed.size();
+        memcpy(out, &stream->primed[0], bytes);
+        stream->primed.clear();
+        return bytes;
+    }
+
+    unsigned int bytes = stream->wave->Read(out, STREAM_BUFFER_SIZE);
+    if(bytes == 0 && stream->loop)
+    {
+        stream->wave->Rewind();
+        bytes = stream->wave->Read(out, STREAM_BUFFER_SIZE);
+    }
+    return bytes;
+}
+
+void MoveToNext(Stream* stream)
+{
+    delete stream->wave;
+    stream->wave = stream->next;
+    stream->next = NULL;
+    stream->loop = stream->nextLoop;
+    stream->primed.swap(stream->nextPrimed);
+    stream->nextPrimed.clear();
+    stream->finished = false;
+}
+
+// Returns false once the stream has no more to queue.
+bool FillStreamBuffer(Stream* stream, ALuint buffer)
+{
+    static char samples[STREAM_BUFFER_SIZE]; // filled with the stream mutex held
+    unsigned int bytes = ReadStream(stream, samples);
+    if(bytes == 0
+       && stream->next != NULL
+       && stream->next->Format() == stream->wave->Format()
+       && stream->next->Frequency() == stream->wave->Frequency())
+    {
+        // A source's queue has to be all one format, anything else waits
+        // for this to drain and starts again.
+        MoveToNext(stream);
+        bytes = ReadStream(stream, samples);
+    }
+
+    if(bytes == 0)
+    {
+        stream->finished = true;
+        return false;
+    }
+
+    alBufferData(buffer, stream->wave->Format(), samples, bytes, stream->wave->Frequency());
+    alSourceQueueBuffers(stream->channel, 1, &buffer);
+    return true;
+}
+
+// Fills the queue from the wave and plays it.
+void StartStream(Stream* stream)
+{
+    for(unsigned int i = 0; i < STREAM_BUFFERS; i++)
+    {
+        if(!FillStreamBuffer(stream, stream->buffers[i]))
+        {
+            break;
+        }
+    }
+    if(!stream->paused)
+    {
+        alSourcePlay(stream->channel);
+    }
+}
+
+// NULL when every stream channel is taken. Call with the stream mutex held.
+Stream* CreateStream(const Asset& asset, bool loop)
+{
+    if(gStreamChannels.empty())
+    {
+        dsprintf("Couldn't play [%s], %d streams already playing.\n",
+                 asset.Name().c_str(), MAX_STREAMS);
+        return NULL;
+    }
+
+    Stream* stream = new Stream();
+    stream->channel = gStreamChannels.back();
+    gStreamChannels.pop_back();
+    stream->wave = NULL;
+    stream->loop = loop;
+    stream->paused = false;
+    stream->finished = false;
+    stream->gain = 1;
+    stream->changed = false;
+    stream->next = NULL;
+    stream->nextLoop = false;
+    stream->fade = 1;
+    stream->fadeTarget = 1;
+    stream->fadeRate = 0;
+    stream->stopWhenFaded = false;
+
+    std::map<std::string, std::string>::const_iterator bus = asset.Flags().find("bus");
+    stream->bus = FindBus(bus == asset.Flags().end() ? "music" : bus->second.c_str());
+    stream->busGain = BusGain(stream->bus);
+
+    alGenBuffers(STREAM_BUFFERS, stream->buffers);
+    MemoryStats::Add(MemoryStats::MEMORY_SOUNDS, STREAM_BUFFERS * STREAM_BUFFER_SIZE);
+    alSourcef(stream->channel, AL_PITCH, 1);
+    ApplyStreamGain(stream);
+    alSourcei(stream->channel, AL_SOURCE_RELATIVE, AL_TRUE);
+    alSource3f(stream->channel, AL_POSITION, 0, 0, 0);
+    alSource3f(stream->channel, AL_VELOCITY, 0, 0, 0);
+    // Looping is done by rewinding the wave, the queue itself never loops.
+    alSourcei(stream->channel, AL_LOOPING, AL_FALSE);
+    return stream;
+}
+
+void DestroyStream(Stream* stream)
+{
+    alSourceStop(stream->channel);
+    alSourcei(stream->channel, AL_BUFFER, 0);
+    alDeleteBuffers(STREAM_BUFFERS, stream->buffers);
+    MemoryStats::Release(MemoryStats::MEMORY_SOUNDS, STREAM_BUFFERS * STREAM_BUFFER_SIZE);
+    gStreamChannels.push_back(stream->channel);
+    delete stream->wave;
+    delete stream->next;
+    delete stream;
+}
+
+// False when the fade's done and the stream should stop.
+bool StepFade(Stream* stream, float seconds)
+{
+    if(stream->fade == stream->fadeTarget)
+    {
+        return true;
+    }
+
+    const float step = stream->fadeRate * seconds;
+    if(stream->fadeRate <= 0 || fabsf(stream->fadeTarget - stream->fade) <= step)
+    {
+        stream->fade = stream->fadeTarget;
+    }
+    else
+    {
+        stream->fade += (stream->fadeTarget > stream->fade) ? step : -step;
+    }
+    ApplyStreamGain(stream);
+    return !(stream->stopWhenFaded && stream->fade == stream->fadeTarget);
+}
+
+// Call with the stream mutex held.
+void ServiceStreams()
+{
+    const unsigned long long now = DDTime::Microseconds();
+    const float seconds = (gLastStreamService == 0) ? 0 : (now - gLastStreamService) / 1000000.0f;
+    gLastStreamService = now;
+
+    std::map<int, Stream*>::iterator it = gStreams.begin();
+    while(it != gStreams.end())
+    {
+        Stream* stream = it->second;
+        if(stream->wave == NULL)
+        {
+            ++it; // still opening
+            continue;
+        }
+
+        if(!StepFade(stream, seconds))
+        {
+            DestroyStream(stream);
+            gStreams.erase(it++);
+            continue;
+        }
+
+        int processed = 0;
+        alGetSourcei(stream->channel, AL_BUFFERS_PROCESSED, &processed);
+        while(processed-- > 0)
+        {
+            ALuint buffer;
+            alSourceUnqueueBuffers(stream->channel, 1, &buffer);
+            if(!stream->finished)
+            {
+                FillStreamBuffer(stream, buffer);
+            }
+        }
+
+        int queued = 0;
+        alGetSourcei(stream->channel, AL_BUFFERS_QUEUED, &queued);
+        if(queued == 0 && stream->next != NULL)
+        {
+            // In another format, so it couldn't follow on.
+            alSourcei(stream->channel, AL_BUFFER, 0);
+            MoveToNext(stream);
+            StartStream(stream);
+            ++it;
+            continue;
+        }
+
+        if(queued == 0 && stream->pendingPath.empty())
+        {
+            DestroyStream(stream);
+            gStreams.erase(it++);
+            continue;
+        }
+
+        // Starved if the thread fell behind, start it up again.
+        if(queued > 0 && !stream->paused && IsSoundStopped(stream->channel))
+        {
+            gStreamUnderruns++;
+            alSourcePlay(stream->channel);
+        }
+        ++it;
+    }
+}
+
+//
+// Opens one waiting track, with the mutex let go so nothing on the main
+// thread waits on the file. The stream may be gone or queued something
+// else by the time it's open.
+//
+void OpenPendingStream()
+{
+    int id = 0;
+    std::string path;
+    for(std::map<int, Stream*>::iterator it = gStreams.begin(); it != gStreams.end(); ++it)
+    {
+        if(!it->second->pendingPath.empty())
+        {
+            id = it->first;
+            path = it->second->pendingPath;
+            break;
+        }
+    }
+
+    if(id == 0)
+    {
+        return;
+    }
+
+    SDL_UnlockMutex(gStreamMutex);
+    WaveStream* wave = new WaveStream();
+    std::vector<char> primed(STREAM_BUFFER_SIZE);
+    bool opened = wave->Open(path.c_str());
+    if(opened)
+    {
+        primed.resize(wave->Read(&primed[0], STREAM_BUFFER_SIZE));
+    }
+    SDL_LockMutex(gStreamMutex);
+
+    Stream* stream = FindStream(id);
+    if(stream == NULL || stream->pendingPath != path)
+    {
+        delete wave;
+        return;
+    }
+    stream->pendingPath.clear();
+
+    if(!opened)
+    {
+        dsprintf("Couldn't open stream [%s].\n", path.c_str());
+        delete wave;
+        if(stream->wave == NULL)
+        {
+            DestroyStream(stream);
+            gStreams.erase(id);
+        }
+        return;
+    }
+
+    if(stream->wave == NULL)
+    {
+        stream->wave = wave;
+        stream->primed.swap(primed);
+        StartStream(stream);
+        return;
+    }
+
+    stream->next = wave;
+    stream->nextPrimed.swap(primed);
+    if(stream->finished)
+    {
+        // Opened too late to follow on, the queue's draining.
+        stream->finished = false;
+    }
+}
+
+int StreamThreadMain(void*)
+{
+    for(;;)
+    {
+        SDL_LockMutex(gStreamMutex);
+        if(gStreamThreadStopping)
+        {
+            SDL_UnlockMutex(gStreamMutex);
+            return 0;
+        }
+        OpenPendingStream();
+        ServiceStreams();
+        SDL_UnlockMutex(gStreamMutex);
+        SDL_Delay(STREAM_SLEEP_MS);
+    }
+}
+
+// Call with the stream mutex held.
+void StartStreamThread()
+{
+    if(gStreamThread == NULL)
+    {
+        gStreamThreadStopping = false;
+        gStreamThread = SDL_CreateThread(&StreamThreadMain, NULL);
+    }
+}
+
+void StopAllStreams()
+{
+    if(gStreamMutex == NULL)
+    {
+        return;
+    }
+
+    SDL_LockMutex(gStreamMutex);
+    for(std::map<int, Stream*>::iterator it = gStreams.begin(); it != gStreams.end(); ++it)
+    {
+        DestroyStream(it->second);
+    }
+    gStreams.clear();
+    SDL_UnlockMutex(gStreamMutex);
+}
+
+//
+// Compressed sounds are decoded to PCM on a worker thread, then handed
+// back to Update for the OpenAL upload. Sounds are shared by file, so
+// manifest entries with the same path play from one buffer.
+//
+// Ondemand sounds go through the same thread, all of them, the first
+// time they're played or preloaded. Until then their names are set to a
+// -1 buffer, so they're found but don't play. Over the budget the least
+// recently played are unloaded back to that.
+//
+struct SharedSound
+{
+    ALuint buffer;
+    unsigned int bytes; // of PCM in the buffer
+    bool ready;
+    bool loading; // a decode job is out for it
+    bool onDemand; // only if every sound using it is
+    int users;
+    std::string path;
+    std::string name; // of the first sound, for the asset report
+    std::vector<std::string> waiting; // sound names to set once it's ready
+
+    SharedSound() :
+        buffer(0), bytes(0), ready(false), loading(false), onDemand(false), users(0) {}
+
+    void SetBytes(unsigned int value)
+    {
+        MemoryStats::Release(MemoryStats::MEMORY_SOUNDS, bytes);
+        MemoryStats::Add(MemoryStats::MEMORY_SOUNDS, value);
+        bytes = value;
+    }
+};
+
+struct DecodeJob
+{
+    std::string key;
+    std::string name; // for the asset report
+    DDFile* file; // the chunks point into it
+    WaveDecoder::Chunks chunks;
+    WaveDecoder::Conversion conversion; // copied when queued, for the thread
+    std::vector<char> pcm;
+    unsigned int channels; // of the pcm
+    unsigned int bits;
+    unsigned int frequency;
+    bool success;
+    unsigned long long decodeMicroseconds;
+
+    DecodeJob() :
+        file(NULL), channels(0), bits(0), frequency(0),
+        success(false), decodeMicroseconds(0) {}
+    ~DecodeJob() { delete file; }
+};
+
+std::map<std::string, SharedSound> gSharedSounds;
+std::map<std::string, std::string> gSoundKeys; // sound name to shared key
+std::vector<unsigned int> gSoundPlayed; // voice order by sound handle, for the LRU
+std::deque<DecodeJob*> gDecodeJobs;
+std::deque<DecodeJob*> gDecodedJobs;
+SDL_mutex* gDecodeMutex = NULL;
+SDL_cond* gDecodeReady = NULL;
+SDL_Thread* gDecodeThread = NULL;
+bool gDecodeThreadStopping = false;
+
+void Decode(DecodeJob* job)
+{
+    unsigned long long start = DDTime::Microseconds();
+    job->success = WaveDecoder::Decode(job->chunks, &job->pcm);
+    job->channels = job->chunks.channels;
+    job->bits = WaveDecoder::DecodedBits(job->chunks);
+    job->frequency = job->chunks.frequency;
+    if(job->success && job->conversion.Changes(job->chunks))
+    {
+        WaveDecoder::Convert(job->chunks, job->conversion, &job->pcm);
+        job->bits = 16;
+        if(job->conversion.channels != 0)
+        {
+            job->channels = job->conversion.channels;
+        }
+        if(job->conversion.frequency != 0)
+        {
+            job->frequency = job->conversion.frequency;
+        }
+    }
+    job->decodeMicroseconds = DDTime::Microseconds() - start;
+}
+
+int DecodeThreadMain(void*)
+{
+    SDL_LockMutex(gDecodeMutex);
+    for(;;)
+    {
+        while(gDecodeJobs.empty() && !gDecodeThreadStopping)
+        {
+            SDL_CondWait(gDecodeReady, gDecodeMutex);
+        }
+
+        if(gDecodeThreadStopping)
+        {
+            break;
+        }
+
+        DecodeJob* job = gDecodeJobs.front();
+        gDecodeJobs.pop_front();
+        SDL_UnlockMutex(gDecodeMutex);
+
+        Decode(job);
+
+        SDL_LockMutex(gDecodeMutex);
+        gDecodedJobs.push_back(job);
+    }
+    SDL_UnlockMutex(gDecodeMutex);
+    return 0;
+}
+
+void QueueDecode(DecodeJob* job)
+{
+    if(gDecodeMutex == NULL)
+    {
+        gDecodeMutex = SDL_CreateMutex();
+        gDecodeReady = SDL_CreateCond();
+        gDecodeThreadStopping = false;
+        gDecodeThread = SDL_CreateThread(&DecodeThreadMain, NULL);
+    }
+
+    if(gDecodeThread == NULL)
+    {
+        // No thread, so decode now and it's uploaded next update.
+        Decode(job);
+        SDL_LockMutex(gDecodeMutex);
+        gDecodedJobs.push_back(job);
+        SDL_UnlockMutex(gDecodeMutex);
+        return;
+    }
+
+    SDL_LockMutex(gDecodeMutex);
+    gDecodeJobs.push_back(job);
+    SDL_CondSignal(gDecodeReady);
+    SDL_UnlockMutex(gDecodeMutex);
+}
+
+DecodeJob* PopDecoded()
+{
+    if(gDecodeMutex == NULL)
+    {
+        return NULL;
+    }
+
+    DecodeJob* job = NULL;
+    SDL_LockMutex(gDecodeMutex);
+    if(!gDecodedJobs.empty())
+    {
+        job = gDecodedJobs.front();
+        gDecodedJobs.pop_front();
+    }
+    SDL_UnlockMutex(gDecodeMutex);
+    return job;
+}
+
+void StopDecoding()
+{
+    if(gDecodeMutex == NULL)
+    {
+        return;
+    }
+
+    if(gDecodeThread)
+    {
+        SDL_LockMutex(gDecodeMutex);
+        gDecodeThreadStopping = true;
+        SDL_CondSignal(gDecodeReady);
+        SDL_UnlockMutex(gDecodeMutex);
+        SDL_WaitThread(gDecodeThread, NULL);
+        gDecodeThread = NULL;
+    }
+
+    for(std::deque<DecodeJob*>::iterator it = gDecodeJobs.begin(); it != gDecodeJobs.end(); ++it)
+    {
+        delete (*it);
+    }
+    for(std::deque<DecodeJob*>::iterator it = gDecodedJobs.begin(); it != gDecodedJobs.end(); ++it)
+    {
+        delete (*it);
+    }
+    gDecodeJobs.clear();
+    gDecodedJobs.clear();
+    SDL_DestroyCond(gDecodeReady);
+    SDL_DestroyMutex(gDecodeMutex);
+    gDecodeReady = NULL;
+    gDecodeMutex = NULL;
+}
+
+// With deleteBuffer false the last user's buffer is left alone, a source
+// may still be playing it.
+void ReleaseSharedSound(const std::string& name, bool deleteBuffer)
+{
+    std::map<std::string, std::string>::iterator key = gSoundKeys.find(name);
+    if(key == gSoundKeys.end())
+    {
+        return;
+    }
+
+    std::map<std::string, SharedSound>::iterator shared = gSharedSounds.find(key->second);
+    gSoundKeys.erase(key);
+    if(shared == gSharedSounds.end())
+    {
+        return;
+    }
+
+    std::vector<std::string>& waiting = shared->second.waiting;
+    waiting.erase(std::remove(waiting.begin(), waiting.end(), name), waiting.end());
+    shared->second.users--;
+    if(shared->second.users > 0)
+    {
+        return;
+    }
+
+    if(deleteBuffer && shared->second.ready)
+    {
+        alDeleteBuffers(1, &shared->second.buffer);
+    }
+    shared->second.SetBytes(0);
+    gSharedSounds.erase(shared);
+}
+
+// Reads the sound's chunks for a decode job. NULL, with the reason
+// printed, if it isn't there or isn't a wave file.
+DecodeJob* ReadSoundChunks(const std::string& key, const SharedSound& shared)
+{
+    const char* path = shared.path.c_str();
+    DecodeJob* job = new DecodeJob();
+    job->key = key;
+    job->name = shared.name;
+    job->file = new DDFile(path);
+
+    unsigned long long start = DDTime::Microseconds();
+    if(!DDFile::FileExists(path)
+       || !job->file->LoadFileView()
+       || !WaveDecoder::FindChunks(job->file->Buffer(), job->file->Size(), path, &job->chunks))
+    {
+        delete job;
+        return NULL;
+    }
+    job->conversion = gConversion;
+
+    AssetReport::AddRead(shared.name.c_str(), job->file->Size(), DDTime::Microseconds() - start);
+    return job;
+}
+
+// A sound that can't be read stays marked loading, so it isn't tried
+// again each play.
+bool QueueSoundLoad(const std::string& key, SharedSound& shared)
+{
+    shared.loading = true;
+    DecodeJob* job = ReadSoundChunks(key, shared);
+    if(job == NULL)
+    {
+        dsprintf("ERROR: Couldn't read sound [%s].\n", shared.name.c_str());
+        return false;
+    }
+    QueueDecode(job);
+    return true;
+}
+
+void MarkPlayed(unsigned int handle)
+{
+    if(handle == NameTable::INVALID_ID)
+    {
+        return;
+    }
+
+    if(handle >= gSoundPlayed.size())
+    {
+        gSoundPlayed.resize(handle + 1, 0);
+    }
+    gSoundPlayed[handle] = gVoiceOrder;
+}
+
+// True if the sound is ondemand and is still loading.
+bool LoadOnDemand(const std::string& name)
+{
+    std::map<std::string, std::string>::iterator key = gSoundKeys.find(name);
+    if(key == gSoundKeys.end())
+    {
+        return false;
+    }
+
+    std::map<std::string, SharedSound>::iterator found = gSharedSounds.find(key->second);
+    if(found == gSharedSounds.end() || !found->second.onDemand)
+    {
+        return false;
+    }
+
+    SharedSound& shared = found->second;
+
+    MarkPlayed(NameTable::Find(name.c_str()));
+    if(shared.ready || shared.loading)
+    {
+        return !shared.ready;
+    }
+
+    return QueueSoundLoad(key->second, shared);
+}
+
+void UnloadSharedSound(const std::string& key, SharedSound& shared, NameIndex<int>* sounds)
+{
+    alDeleteBuffers(1, &shared.buffer);
+    shared.buffer = 0;
+    shared.ready = false;
+    shared.SetBytes(0);
+    AssetReport::SetMemory(shared.name.c_str(), 0);
+
+    for(std::map<std::string, std::string>::iterator it = gSoundKeys.begin();
+        it != gSoundKeys.end(); ++it)
+    {
+        if(it->second == key)
+        {
+            sounds->Set(it->first.c_str(), -1);
+            shared.waiting.push_back(it->first);
+        }
+    }
+    gStats.unloads++;
+}
+
+//
+// Unloads the least recently played ondemand sounds until the buffers fit
+// the budget. Ones playing, or just loaded, are kept. They may not fit
+// after all, which the next load tries again.
+//
+void TrimSounds(unsigned int budget, NameIndex<int>* sounds, const std::vector<std::string>& fresh)
+{
+    unsigned int total = 0;
+    for(std::map<std::string, SharedSound>::iterator it = gSharedSounds.begin();
+        it != gSharedSounds.end(); ++it)
+    {
+        total += it->second.bytes;
+    }
+
+    if(total <= budget)
+    {
+        return;
+    }
+
+    // By any of the names sharing the buffer.
+    std::map<std::string, unsigned int> played;
+    for(std::map<std::string, std::string>::iterator it = gSoundKeys.begin();
+        it != gSoundKeys.end(); ++it)
+    {
+        unsigned int id = NameTable::Find(it->first.c_str());
+        unsigned int order = (id < gSoundPlayed.size()) ? gSoundPlayed[id] : 0;
+        unsigned int& last = played[it->second];
+        last = std::max(last, order);
+    }
+
+    std::vector<ALint> playing;
+    for(std::vector<Voice>::iterator it = gVoices.begin(); it != gVoices.end(); ++it)
+    {
+        ALint buffer = 0;
+        alGetSourcei(it->channel, AL_BUFFER, &buffer);
+        playing.push_back(buffer);
+    }
+
+    while(total > budget)
+    {
+        std::map<std::string, SharedSound>::iterator victim = gSharedSounds.end();
+        for(std::map<std::string, SharedSound>::iterator it = gSharedSounds.begin();
+            it != gSharedSounds.end(); ++it)
+        {
+            const SharedSound& shared = it->second;
+            if(!shared.onDemand || !shared.ready
+               || std::find(playing.begin(), playing.end(), (ALint) shared.buffer) != playing.end()
+               || std::find(fresh.begin(), fresh.end(), it->first) != fresh.end())
+            {
+                continue;
+            }
+
+            if(victim == gSharedSounds.end() || played[it->first] < played[victim->first])
+            {
+                victim = it;
+            }
+        }
+
+        if(victim == gSharedSounds.end())
+        {
+            return;
+        }
+
+        total -= victim->second.bytes;
+        UnloadSharedSound(victim->first, victim->second, sounds);
+    }
+}
+
+// Steps the ducks along and sends any volume changes since the last
+// frame to OpenAL.
+void ApplyVolumes()
+{
+    const unsigned long long now = DDTime::Microseconds();
+    const float seconds = (gLastAudioUpdate == 0) ? 0 : (now - gLastAudioUpdate) / 1000000.0f;
+    gLastAudioUpdate = now;
+
+    for(std::vector<Bus>::iterator bus = gBuses.begin(); bus != gBuses.end(); ++bus)
+    {
+        if(bus->duck == bus->duckTarget)
+        {
+            continue;
+        }
+
+        const float step = bus->duckRate * seconds;
+        if(bus->duckRate <= 0 || fabsf(bus->duckTarget - bus->duck) <= step)
+        {
+            bus->duck = bus->duckTarget;
+        }
+        else
+        {
+            bus->duck += (bus->duckTarget > bus->duck) ? step : -step;
+        }
+        gBusesChanged = true;
+    }
+
+    if(!gBusesChanged && !gVoicesChanged)
+    {
+        return;
+    }
+
+    for(std::vector<Voice>::iterator it = gVoices.begin(); it != gVoices.end(); ++it)
+    {
+        if(gBusesChanged || it->changed)
+        {
+            alSourcef(it->channel, AL_GAIN, it->gain * BusGain(it->bus));
+            it->changed = false;
+        }
+    }
 
-ALCdevice* gDevice = NULL;
-ALCcontext* gContext = NULL;
+    if(gStreamMutex)
+    {
+        SDL_LockMutex(gStreamMutex);
+        for(std::map<int, Stream*>::iterator it = gStreams.begin(); it != gStreams.end(); ++it)
+        {
+            Stream* stream = it->second;
+            if(gBusesChanged || stream->changed)
+            {
+                stream->busGain = BusGain(stream->bus);
+                ApplyStreamGain(stream);
+                stream->changed = false;
+            }
+        }
+        SDL_UnlockMutex(gStreamMutex);
+    }
+    gBusesChanged = false;
+    gVoicesChanged = false;
+}
 
-bool IsSoundPlaying(unsigned int channel)
+void ApplyPositions()
 {
-    int value;
-    alGetSourcei(channel, AL_SOURCE_STATE, &value);
-    return value == AL_PLAYING;
+    if(gListenerChanged)
+    {
+        // Raised off the plane so sounds near the listener pan smoothly
+        // rather than jumping hard left or right.
+        alListener3f(AL_POSITION, gListenerX, gListenerY, gReferenceDistance);
+        gListenerChanged = false;
+    }
+
+    if(!gPositionsChanged)
+    {
+        return;
+    }
+
+    for(std::vector<Voice>::iterator it = gVoices.begin(); it != gVoices.end(); ++it)
+    {
+        if(it->moved)
+        {
+            alSource3f(it->channel, AL_POSITION, it->x, it->y, 0);
+            it->moved = false;
+        }
+    }
+    gPositionsChanged = false;
 }
 
-int FindNextFreeChannel()
+// Flags the manifest can give a sound.
+DDAudio::SoundPolicy ReadSoundPolicy(const Asset& asset)
 {
-    for (std::vector<unsigned int>::iterator i = gChannels.begin(); i != gChannels.end(); ++i)
+    DDAudio::SoundPolicy policy;
+    const std::map<std::string, std::string>& flags = asset.Flags();
+    std::map<std::string, std::string>::const_iterator flag;
+
+    if((flag = flags.find("priority")) != flags.end())
+    {
+        policy.priority = atoi(flag->second.c_str());
+    }
+
+    if((flag = flags.find("bus")) != flags.end())
+    {
+        policy.bus = FindBus(flag->second.c_str());
+    }
+
+    if((flag = flags.find("max_instances")) != flags.end())
+    {
+        policy.maxInstances = atoi(flag->second.c_str());
+    }
+
+    if((flag = flags.find("load")) != flags.end())
+    {
+        policy.onDemand = (flag->second == "ondemand");
+        if(!policy.onDemand && flag->second != "resident")
+        {
+            dsprintf("Sound [%s] has unknown load [%s], using resident.\n",
+                     asset.Name().c_str(), flag->second.c_str());
+        }
+    }
+
+    if((flag = flags.find("steal")) != flags.end())
     {
-        if(!IsSoundPlaying(*i))  // potential issue, if sound just paused!
+        if(flag->second == "oldest")
+        {
+            policy.steal = DDAudio::StealOldest;
+        }
+        else if(flag->second == "quietest")
         {
-            return *i;
+            policy.steal = DDAudio::StealQuietest;
+        }
+        else if(flag->second != "priority")
+        {
+            dsprintf("Sound [%s] has unknown steal [%s], using priority.\n",
+                     asset.Name().c_str(), flag->second.c_str());
         }
     }
-    return -1;
+    return policy;
 }
 
 
-DDAudio::DDAudio()
+DDAudio::DDAudio() :
+    mShareBuffers(true),
+    mSoundBudget(0)
 {
+    // The order matches the SoundPolicy default.
+    gBuses.clear();
+    FindBus("sfx");
+    FindBus("music");
+    FindBus("ui");
+
     gDevice = alcOpenDevice(NULL);
     gContext = alcCreateContext(gDevice, NULL);
     alcMakeContextCurrent(gContext);
+    alDistanceModel(AL_LINEAR_DISTANCE_CLAMPED);
+    gListenerChanged = true;
 
     int error = alGetError();
     if(error != AL_NO_ERROR)
@@ -75,11 +1249,35 @@ DDAudio::DDAudio()
         }
     }
 
+    gStreamChannels.clear();
+    while(gStreamChannels.size() < MAX_STREAMS && gChannels.size() > MAX_STREAMS)
+    {
+        gStreamChannels.push_back(gChannels.back());
+        gChannels.pop_back();
+    }
+
+    FreeAllChannels();
     dsprintf("%d sound channels found.\n", (int)gChannels.size());
 }
 
 DDAudio::~DDAudio()
 {
+    if(gStreamThread)
+    {
+        SDL_LockMutex(gStreamMutex);
+        gStreamThreadStopping = true;
+        SDL_UnlockMutex(gStreamMutex);
+        SDL_WaitThread(gStreamThread, NULL);
+        gStreamThread = NULL;
+    }
+    StopAllStreams();
+    StopDecoding();
+    if(gStreamMutex)
+    {
+        SDL_DestroyMutex(gStreamMutex);
+        gStreamMutex = NULL;
+    }
+
     alcMakeContextCurrent(NULL);
     alcDestroyContext(gContext);
     alcCloseDevice(gDevice);
@@ -95,47 +1293,326 @@ void DDAudio::Reset()
     {
         alSourceStop(*i);
     }
+    FreeAllChannels();
+    StopAllStreams();
+}
+
+void DDAudio::Update()
+{
+    MeasureConsumed();
+    ReclaimChannels();
+    ApplyVolumes();
+    ApplyPositions();
+
+    std::vector<std::string> loaded;
+    DecodeJob* job = NULL;
+    while((job = PopDecoded()) != NULL)
+    {
+        std::map<std::string, SharedSound>::iterator shared = gSharedSounds.find(job->key);
+        if(shared == gSharedSounds.end())
+        {
+            // Every sound using it was destroyed while it decoded.
+        }
+        else if(shared->second.ready)
+        {
+            // Reloaded with the same file while an earlier job was out.
+        }
+        else if(!job->success || job->pcm.empty())
+        {
+            dsprintf("ERROR: Failed to decode sound [%s].\n", job->name.c_str());
+        }
+        else
+        {
+            const char* name = job->name.c_str();
+            SharedSound& sound = shared->second;
+            alGenBuffers(1, &sound.buffer);
+
+            unsigned long long start = DDTime::Microseconds();
+            alBufferData(sound.buffer,
+                         Wave::Format(job->channels, job->bits),
+                         &job->pcm[0],
+                         (ALsizei) job->pcm.size(),
+                         (ALsizei) job->frequency);
+            AssetReport::AddDecode(name, job->decodeMicroseconds);
+            AssetReport::AddUpload(name, DDTime::Microseconds() - start);
+            AssetReport::SetMemory(name, (unsigned int) job->pcm.size());
+            sound.SetBytes((unsigned int) job->pcm.size());
+
+            sound.ready = true;
+            sound.loading = false;
+            for(std::vector<std::string>::iterator it = sound.waiting.begin();
+                it != sound.waiting.end(); ++it)
+            {
+                mSounds.Set(it->c_str(), sound.buffer);
+            }
+            sound.waiting.clear();
+            loaded.push_back(job->key);
+        }
+        delete job;
+    }
+
+    if(!loaded.empty() && mSoundBudget > 0)
+    {
+        TrimSounds(mSoundBudget, &mSounds, loaded);
+    }
+}
+
+void DDAudio::SetPosition(int id, float x, float y)
+{
+    Voice* voice = FindVoice((unsigned int) id);
+    if(voice == NULL)
+    {
+        return;
+    }
+
+    voice->x = x;
+    voice->y = y;
+    if(voice->positional)
+    {
+        voice->moved = true;
+        gPositionsChanged = true;
+        return;
+    }
+
+    // Straight away the first time, so it isn't heard unpanned for a frame.
+    voice->positional = true;
+    alSourcei(voice->channel, AL_SOURCE_RELATIVE, AL_FALSE);
+    alSourcef(voice->channel, AL_REFERENCE_DISTANCE, gReferenceDistance);
+    alSourcef(voice->channel, AL_MAX_DISTANCE, gMaxDistance);
+    alSourcef(voice->channel, AL_ROLLOFF_FACTOR, 1);
+    alSource3f(voice->channel, AL_POSITION, x, y, 0);
+}
+
+void DDAudio::SetListener(float x, float y)
+{
+    if(x != gListenerX || y != gListenerY)
+    {
+        gListenerX = x;
+        gListenerY = y;
+        gListenerChanged = true;
+    }
+}
+
+void DDAudio::SetDistances(float reference, float max)
+{
+    gReferenceDistance = reference;
+    gMaxDistance = max;
+    gListenerChanged = true;
+
+    for(std::vector<Voice>::iterator it = gVoices.begin(); it != gVoices.end(); ++it)
+    {
+        if(it->positional)
+        {
+            alSourcef(it->channel, AL_REFERENCE_DISTANCE, gReferenceDistance);
+            alSourcef(it->channel, AL_MAX_DISTANCE, gMaxDistance);
+        }
+    }
+}
+
+unsigned int DDAudio::VoiceSerial(int id)
+{
+    Voice* voice = FindVoice((unsigned int) id);
+    return voice ? voice->order + 1 : 0;
+}
+
+void DDAudio::SetBusVolume(const char* bus, float volume)
+{
+    gBuses[FindBus(bus)].volume = volume;
+    gBusesChanged = true;
+}
+
+float DDAudio::GetBusVolume(const char* bus)
+{
+    return gBuses[FindBus(bus)].volume;
+}
+
+void DDAudio::Duck(const char* bus, float volume, float seconds)
+{
+    Bus& duckBus = gBuses[FindBus(bus)];
+    duckBus.duckTarget = volume;
+    duckBus.duckRate = (seconds > 0) ? fabsf(volume - duckBus.duck) / seconds : 0;
+}
+
+void DDAudio::SetOutputRefresh(int refresh)
+{
+    if(refresh <= 0 || gDevice == NULL)
+    {
+        return;
+    }
+
+    ALCint current = 0;
+    alcGetIntegerv(gDevice, ALC_REFRESH, 1, &current);
+    if(current == refresh)
+    {
+        return;
+    }
+
+    // Resetting keeps the context, sources and buffers, unlike reopening.
+    LPALCRESETDEVICESOFT resetDevice = NULL;
+    if(alcIsExtensionPresent(gDevice, "ALC_SOFT_HRTF"))
+    {
+        resetDevice = (LPALCRESETDEVICESOFT) alcGetProcAddress(gDevice, "alcResetDeviceSOFT");
+    }
+
+    const ALCint attributes[] = { ALC_REFRESH, refresh, 0 };
+    if(resetDevice == NULL || !resetDevice(gDevice, attributes))
+    {
+        dsprintf("Couldn't set the audio refresh to %d, kept %d.\n", refresh, current);
+        return;
+    }
+
+    alcGetIntegerv(gDevice, ALC_REFRESH, 1, &current);
+    dsprintf("Audio mixing %d times a second, latency %.1fms.\n",
+             current, GetOutputLatency() * 1000);
+}
+
+void DDAudio::SetConversion(bool outputRate, int channels, bool cubic)
+{
+    ALCint frequency = 0;
+    if(outputRate && gDevice != NULL)
+    {
+        alcGetIntegerv(gDevice, ALC_FREQUENCY, 1, &frequency);
+    }
+
+    gConversion.frequency = (unsigned int) std::max(frequency, 0);
+    gConversion.channels = (channels == 1 || channels == 2) ? (unsigned int) channels : 0;
+    gConversion.quality = cubic ? WaveDecoder::CUBIC : WaveDecoder::LINEAR;
+    if(gConversion.frequency != 0 || gConversion.channels != 0)
+    {
+        dsprintf("Sounds converted on load to %uHz, %u channel(s), %s.\n",
+                 gConversion.frequency,
+                 gConversion.channels,
+                 cubic ? "cubic" : "linear");
+    }
+}
+
+float DDAudio::GetOutputLatency()
+{
+    if(gDevice == NULL || gChannels.empty())
+    {
+        return -1;
+    }
+
+    if(alIsExtensionPresent("AL_SOFT_source_latency"))
+    {
+        LPALGETSOURCEDVSOFT getSource =
+            (LPALGETSOURCEDVSOFT) alGetProcAddress("alGetSourcedvSOFT");
+        if(getSource)
+        {
+            // The offset, then the time until the mix is heard.
+            ALdouble values[2] = { 0, 0 };
+            getSource(gChannels[0], AL_SEC_OFFSET_LATENCY_SOFT, values);
+            return (float) values[1];
+        }
+    }
+
+    // Without the extension a mix period is the best guess.
+    ALCint refresh = 0;
+    alcGetIntegerv(gDevice, ALC_REFRESH, 1, &refresh);
+    return (refresh > 0) ? 1.0f / refresh : -1;
 }
 
 bool DDAudio::OnAssetReload(Asset& asset)
 {
-    dsprintf("Being asked to load [%s]\n", asset.Name().c_str());
+    DD_LOG_DEBUG("Being asked to load [%s]\n", asset.Name().c_str());
     if(asset.Type() == Asset::Sound)
     {
+        const char* name = asset.Name().c_str();
+        const char* path = asset.Path().c_str();
+        // Until the new buffer is ready the sound plays from its old one.
+        ReleaseSharedSound(asset.Name(), false);
+        SoundPolicy policy = ReadSoundPolicy(asset);
+        mPolicies.Set(name, policy);
+
+        // Shared by file and when it was changed, so an entry reloading a
+        // changed file doesn't pick up the stale buffer.
+        std::string key = "#" + asset.Name();
+        if(mShareBuffers)
+        {
+            char modified[32];
+            sprintf(modified, "@%ld", (long) AssetStore::GetModifiedTimeStamp(asset));
+            key = asset.Path() + modified;
+        }
+
+        SharedSound& shared = gSharedSounds[key];
+        shared.users++;
+        gSoundKeys[asset.Name()] = key;
+        if(shared.users > 1)
+        {
+            if(shared.ready)
+            {
+                mSounds.Set(name, shared.buffer);
+                return true;
+            }
+
+            shared.waiting.push_back(asset.Name());
+            if(shared.onDemand && !policy.onDemand)
+            {
+                // A resident sound holds the buffer for all of them.
+                shared.onDemand = false;
+                if(!shared.loading)
+                {
+                    QueueSoundLoad(key, shared);
+                }
+            }
+            else if(shared.onDemand)
+            {
+                mSounds.Set(name, -1);
+            }
+            return true;
+        }
+
+        shared.path = asset.Path();
+        shared.name = asset.Name();
+        shared.onDemand = policy.onDemand;
+        if(shared.onDemand)
+        {
+            shared.waiting.push_back(asset.Name());
+            mSounds.Set(name, -1);
+            return true;
+        }
+
+        DecodeJob* job = ReadSoundChunks(key, shared);
+        if(job == NULL)
+        {
+            ReleaseSharedSound(asset.Name(), false);
+            return false;
+        }
+
+        if(WaveDecoder::IsCompressed(job->chunks) || job->conversion.Changes(job->chunks))
+        {
+            shared.waiting.push_back(asset.Name());
+            shared.loading = true;
+            QueueDecode(job);
+            return true;
+        }
+        delete job;
+
         ALuint buffer;
         ALsizei size;
         ALsizei frequency;
         ALenum format;
 
-        bool success = Wave::LoadToOpenALBuffer(asset.Path().c_str(),
+        bool success = Wave::LoadToOpenALBuffer(path,
                                  &buffer, &size, &frequency, &format);
 
         if(!success)
         {
+            ReleaseSharedSound(asset.Name(), false);
             return false;
         }
 
-        mSoundNameId.insert
-        (
-            std::pair<std::string, int>
-            (
-                std::string(asset.Name()),
-                buffer
-            )
-        );
-
+        // A reload replaces the buffer under the same handle. The old
+        // one is left alone, a source may still be playing it.
+        shared.buffer = buffer;
+        shared.SetBytes((unsigned int) size);
+        shared.ready = true;
+        mSounds.Set(name, buffer);
         return true;
     }
     else if(asset.Type() == Asset::Stream)
     {
-        mStreamNameAsset.insert
-        (
-            std::pair<std::string, Asset*>
-            (
-                std::string(asset.Name()),
-                &asset
-            )
-        );
+        mStreams.Set(asset.Name().c_str(), &asset);
         return true;
     }
     else
@@ -150,17 +1627,14 @@ void DDAudio::OnAssetDestroyed(Asset& asset)
 {
     if(asset.Type() == Asset::Sound)
     {
-        std::map<std::string, int>::iterator iter =
-            mSoundNameId.find(asset.Name());
-        ALuint buffer = iter->second;
-        alDeleteBuffers(1, &buffer);
-        mSoundNameId.erase(iter);
+        // The buffer goes with the last sound sharing it.
+        ReleaseSharedSound(asset.Name(), true);
+        mSounds.Erase(asset.Name().c_str());
+        mPolicies.Erase(asset.Name().c_str());
     }
     else if(asset.Type() == Asset::Stream)
     {
-        std::map<std::string, Asset*>::iterator iter =
-            mStreamNameAsset.find(asset.Name());
-        mStreamNameAsset.erase(iter);
+        mStreams.Erase(asset.Name().c_str());
     }
     else
     {
@@ -168,18 +1642,53 @@ void DDAudio::OnAssetDestroyed(Asset& asset)
     }
 }
 
+unsigned int DDAudio::ReleaseCaches()
+{
+    const size_t before = MemoryStats::Current(MemoryStats::MEMORY_SOUNDS);
+    ReclaimChannels();
+    TrimSounds(0, &mSounds, std::vector<std::string>());
+    return (unsigned int) (before - MemoryStats::Current(MemoryStats::MEMORY_SOUNDS));
+}
+
+bool DDAudio::Preload(const char* name)
+{
+    LoadOnDemand(name);
+    return FindSound(name) != -1;
+}
+
 int DDAudio::Play(const char* name, bool loop)
 {
-    dsprintf("Being asked to play [%s] Loop: [%s]\n", name, loop? "true" : "false");
+    DD_LOG_DEBUG("Being asked to play [%s] Loop: [%s]\n", name, loop? "true" : "false");
+
+    gPlayCalled = DDTime::Microseconds();
+    return PlayLoaded(GetSound(name), NameTable::Find(name), loop);
+}
 
-    int buffer = GetSound(name);
+int DDAudio::Play(int handle, bool loop)
+{
+    gPlayCalled = DDTime::Microseconds();
+    int* sound = mSounds.Get((unsigned int) handle);
+    return PlayLoaded(sound ? *sound : -1, (unsigned int) handle, loop);
+}
 
+int DDAudio::PlayLoaded(int buffer, unsigned int handle, bool loop)
+{
+    DD_PROFILE_ZONE("AudioPlay");
+    if(buffer == -1)
+    {
+        if(handle != NameTable::INVALID_ID && LoadOnDemand(NameTable::Name(handle)))
+        {
+            gStats.loadMisses++;
+        }
+        return -1;
+    }
 
-    int channel = FindNextFreeChannel();
-    alSourceStop(channel);
+    SoundPolicy* policy = mPolicies.Get(handle);
+    int channel = FindNextFreeChannel(policy ? *policy : SoundPolicy(), handle);
     if(channel == -1)
     {
         printf("Couldn't find free channel.\n");
+        gStats.dropped++;
         return -1;
     }
 
@@ -187,7 +1696,9 @@ int DDAudio::Play(const char* name, bool loop)
     alSourcei(channel, AL_BUFFER, buffer);
 
     alSourcef(channel, AL_PITCH, 1);
-    alSourcef(channel, AL_GAIN, 1);
+    alSourcef(channel, AL_GAIN, BusGain(policy ? policy->bus : 0));
+    // Unpanned until SetPosition is called.
+    alSourcei(channel, AL_SOURCE_RELATIVE, AL_TRUE);
     alSource3f(channel, AL_POSITION, 0, 0, 0);
     alSource3f(channel, AL_VELOCITY, 0, 0, 0);
     alSourcei(channel, AL_LOOPING, loop);
@@ -197,12 +1708,46 @@ int DDAudio::Play(const char* name, bool loop)
     int error = alGetError();
     if(error != AL_NO_ERROR)
     {
+        // Left stopped, the next reclaim frees it.
+        alSourceStop(channel);
         return -1;
     }
 
+    MarkPlayed(handle);
+    gStats.plays++;
+    gStats.lastStartMicroseconds = DDTime::Microseconds() - gPlayCalled;
     return channel;
 }
 
+void DDAudio::GetStats(Stats* out)
+{
+    assert(out);
+    *out = gStats;
+    out->averageConsumeMicroseconds = gConsumeCount ? gConsumeTotal / gConsumeCount : 0;
+    out->outputLatency = GetOutputLatency();
+
+    if(gStreamMutex)
+    {
+        SDL_LockMutex(gStreamMutex);
+        out->streamUnderruns = gStreamUnderruns;
+        SDL_UnlockMutex(gStreamMutex);
+    }
+}
+
+void DDAudio::ResetStats()
+{
+    gStats = Stats();
+    gConsumeTotal = 0;
+    gConsumeCount = 0;
+
+    if(gStreamMutex)
+    {
+        SDL_LockMutex(gStreamMutex);
+        gStreamUnderruns = 0;
+        SDL_UnlockMutex(gStreamMutex);
+    }
+}
+
 void DDAudio::Stop(int soundId)
 {
     alSourceStop(soundId);
@@ -220,53 +1765,215 @@ void DDAudio::Resume(int soundId)
 
 void DDAudio::SetVolume(int soundId, float volume)
 {
-    alSourcef(soundId, AL_GAIN, volume);
+    Voice* voice = FindVoice((unsigned int) soundId);
+    if(voice)
+    {
+        voice->gain = volume;
+        voice->changed = true;
+        gVoicesChanged = true;
+    }
+}
+
+
+int DDAudio::PlayStream(const char* name, bool loop)
+{
+    DD_LOG_DEBUG("Being asked to play stream [%s] Loop: [%s]\n", name, loop? "true" : "false");
+
+    Asset* asset = GetStream(name);
+    if(asset == NULL)
+    {
+        return -1;
+    }
+
+    if(gStreamMutex == NULL)
+    {
+        gStreamMutex = SDL_CreateMutex();
+    }
+
+    SDL_LockMutex(gStreamMutex);
+    Stream* stream = CreateStream(*asset, loop);
+    if(stream == NULL)
+    {
+        SDL_UnlockMutex(gStreamMutex);
+        return -1;
+    }
+
+    stream->wave = new WaveStream();
+    if(!stream->wave->Open(asset->Path().c_str()))
+    {
+        DestroyStream(stream);
+        SDL_UnlockMutex(gStreamMutex);
+        return -1;
+    }
+    StartStream(stream);
+
+    int id = gNextStreamId++;
+    gStreams[id] = stream;
+    StartStreamThread();
+    SDL_UnlockMutex(gStreamMutex);
+    return id;
 }
 
+bool DDAudio::QueueStream(int id, const char* name, bool loop)
+{
+    Asset* asset = GetStream(name);
+    if(asset == NULL || gStreamMutex == NULL)
+    {
+        return false;
+    }
+
+    SDL_LockMutex(gStreamMutex);
+    Stream* stream = FindStream(id);
+    if(stream)
+    {
+        // The current pass is the last, then the queued track.
+        delete stream->next;
+        stream->next = NULL;
+        stream->nextPrimed.clear();
+        stream->pendingPath = asset->Path();
+        stream->nextLoop = loop;
+        stream->loop = false;
+    }
+    SDL_UnlockMutex(gStreamMutex);
+    return stream != NULL;
+}
 
-int DDAudio::PlayStream(const char* path, bool loop)
+int DDAudio::CrossFadeStream(int id, const char* name, float seconds, bool loop)
 {
-    dsprintf("[%s] not loaded. Streaming not currently supported on windows.\n",
-             path);
-    return -1;
+    Asset* asset = GetStream(name);
+    if(asset == NULL)
+    {
+        return -1;
+    }
+
+    if(gStreamMutex == NULL)
+    {
+        gStreamMutex = SDL_CreateMutex();
+    }
+
+    SDL_LockMutex(gStreamMutex);
+    Stream* stream = CreateStream(*asset, loop);
+    if(stream == NULL)
+    {
+        SDL_UnlockMutex(gStreamMutex);
+        return -1;
+    }
+
+    // Faded from the first samples, which are a little way off yet.
+    const float rate = seconds > 0 ? 1.0f / seconds : 0;
+    stream->pendingPath = asset->Path();
+    stream->fade = rate > 0 ? 0 : 1;
+    stream->fadeRate = rate;
+    ApplyStreamGain(stream);
+
+    Stream* old = FindStream(id);
+    if(old)
+    {
+        old->fadeTarget = 0;
+        old->fadeRate = rate;
+        old->stopWhenFaded = true;
+    }
+
+    int newId = gNextStreamId++;
+    gStreams[newId] = stream;
+    StartStreamThread();
+    SDL_UnlockMutex(gStreamMutex);
+    return newId;
 }
 
-void DDAudio::StopStream(int soundId)
+void DDAudio::StopStream(int id)
 {
-    // Not currently implemented on windows.
+    if(gStreamMutex == NULL)
+    {
+        return;
+    }
+
+    SDL_LockMutex(gStreamMutex);
+    Stream* stream = FindStream(id);
+    if(stream)
+    {
+        DestroyStream(stream);
+        gStreams.erase(id);
+    }
+    SDL_UnlockMutex(gStreamMutex);
 }
 
-void DDAudio::PauseStream(int soundId)
+void DDAudio::PauseStream(int id)
 {
+    if(gStreamMutex == NULL)
+    {
+        return;
+    }
 
+    SDL_LockMutex(gStreamMutex);
+    Stream* stream = FindStream(id);
+    if(stream)
+    {
+        stream->paused = true;
+        alSourcePause(stream->channel);
+    }
+    SDL_UnlockMutex(gStreamMutex);
 }
 
-void DDAudio::ResumeStream(int soundId)
+void DDAudio::ResumeStream(int id)
 {
+    if(gStreamMutex == NULL)
+    {
+        return;
+    }
 
+    SDL_LockMutex(gStreamMutex);
+    Stream* stream = FindStream(id);
+    if(stream)
+    {
+        stream->paused = false;
+        alSourcePlay(stream->channel);
+    }
+    SDL_UnlockMutex(gStreamMutex);
 }
 
-void DDAudio::SetStreamVolume(int soundId, float volume)
+void DDAudio::SetStreamVolume(int id, float volume)
 {
+    if(gStreamMutex == NULL)
+    {
+        return;
+    }
 
+    SDL_LockMutex(gStreamMutex);
+    Stream* stream = FindStream(id);
+    if(stream)
+    {
+        stream->gain = volume;
+        stream->changed = true;
+        gVoicesChanged = true;
+    }
+    SDL_UnlockMutex(gStreamMutex);
 }
 
 int DDAudio::GetSound(const char* name)
 {
-    if(mSoundNameId.find(name) == mSoundNameId.end())
+    int* sound = mSounds.Find(name);
+    if(sound == NULL)
     {
         dsprintf("ERROR: Couldn't find sound [%s]", name);
         return -1;
     }
-    return mSoundNameId.find(name)->second;
+    return *sound;
+}
+
+int DDAudio::FindSound(const char* name)
+{
+    unsigned int id = NameTable::Find(name);
+    return mSounds.Get(id) ? (int) id : -1;
 }
 
 Asset* DDAudio::GetStream(const char* name)
 {
-    if(mStreamNameAsset.find(name) == mStreamNameAsset.end())
+    Asset** stream = mStreams.Find(name);
+    if(stream == NULL)
     {
         dsprintf("ERROR: Couldn't find stream [%s]", name);
         return NULL;
     }
-    return mStreamNameAsset.find(name)->second;
+    return *stream;
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 #define DDFILE_ANDROID_H
 
 #include <string>
+#include <string.h>
+
+class MappedFile;
 
 class DDFile
 {
@@ -11,11 +14,21 @@ private:
     std::string mName;
     char* mBuffer;
     unsigned int mSize;
+    // False when mBuffer points into a mounted DDPack or mMapped.
+    bool mOwnsBuffer;
+    MappedFile* mMapped;
 public:
 
     // Save data may be handled in a special way
     // Depending on the device
-    static void WriteSaveData(const char* name, const char* data);
+    // Writes replace the old save whole or not at all, so a crash part way
+    // through leaves the previous one. Safe to call off the main thread.
+    // Save data is bytes, it may hold NULs.
+    static bool WriteSaveData(const char* name, const char* data, unsigned int size);
+    static bool WriteSaveData(const char* name, const char* data)
+    {
+        return WriteSaveData(name, data, strlen(data));
+    }
     static void ReadSaveData(const char* name, std::string& data);
 
 
@@ -24,6 +37,14 @@ public:
     DDFile(const char* filename);
     ~DDFile();
     bool LoadFileIntoBuffer();
+    // A read only view of the file rather than a copy. Loose files are
+    // memory mapped and pack entries point into the pack, anything else
+    // falls back to LoadFileIntoBuffer. The view lasts until ClearBuffer or
+    // the DDFile is destroyed. Views of loose files shouldn't be kept
+    // around, the file may be rewritten under the mapping.
+    bool LoadFileView();
+    // True if the buffer is a view rather than a copy.
+    bool IsView() const { return mBuffer != NULL && !mOwnsBuffer; }
     void SetBuffer(char* pData, int iSize);
     const char* Buffer() { return mBuffer; }
     unsigned int Size() { return mSize; }
@@ -3,25 +3,68 @@
 #include <stdio.h>
 #include <string.h> // for memcpy
 #include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 #include <iostream>
 #include <fstream>
 
 #include "physfs.h"
 #include "DDLog.h"
+#include "DDPack.h"
+#include "MappedFile.h"
+#include "MemoryStats.h"
+#include "PathCache.h"
+#include "PushedFiles.h"
+#include "RemoteAssets.h"
 
 DDFile* DDFile::OpenFile = NULL;
 
-void DDFile::WriteSaveData(const char* name, const char* data)
+bool DDFile::WriteSaveData(const char* name, const char* data, unsigned int size)
 {
-    std::ofstream outFile;
-    outFile.open(name);
-    outFile << data;
-    outFile.close();
+    // Written beside the save, flushed to the disk, then renamed over it.
+    const std::string temp = std::string(name) + ".tmp";
+    FILE* file = fopen(temp.c_str(), "wb");
+    if(file == NULL)
+    {
+        dsprintf("Can't write save [%s].\n", temp.c_str());
+        return false;
+    }
+
+    bool written = fwrite(data, 1, size, file) == size && fflush(file) == 0;
+#ifdef _WIN32
+    written = written && _commit(_fileno(file)) == 0;
+#else
+    written = written && fsync(fileno(file)) == 0;
+#endif
+    written = fclose(file) == 0 && written;
+
+    if(!written)
+    {
+        dsprintf("Writing save [%s] failed.\n", name);
+        remove(temp.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    if(!MoveFileExA(temp.c_str(), name, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+#else
+    if(rename(temp.c_str(), name) != 0)
+#endif
+    {
+        dsprintf("Replacing save [%s] failed.\n", name);
+        remove(temp.c_str());
+        return false;
+    }
+    return true;
 }
 
 void DDFile::ReadSaveData(const char* name, std::string& data)
 {
-    std::ifstream ifs(name);
+    std::ifstream ifs(name, std::ios::in | std::ios::binary);
     if(ifs.good())
     {
         data.assign
@@ -37,7 +80,7 @@ void DDFile::ReadSaveData(const char* name, std::string& data)
 }
 
 DDFile::DDFile(const char* filename)
-    : mName(filename), mBuffer(NULL), mSize(0)
+    : mName(filename), mBuffer(NULL), mSize(0), mOwnsBuffer(true), mMapped(NULL)
 {
 
 }
@@ -51,18 +94,30 @@ DDFile::~DDFile()
 bool DDFile::FileExists(const char* path)
 {
     //
-    // Try to find files in the dir root,
-    // then try the packages.
+    // Try pushed files and the mounted DDPacks, then find files in the
+    // dir root, then try the PhysFS packages.
     //
+    if(PushedFiles::Exists(path) || DDPack::Exists(path))
+    {
+        return true;
+    }
+
+    // Both probes are cached until the next asset reload.
     struct stat attributes;
 
-    if(stat(path, &attributes) == 0
+    if(PathCache::Stat(path, &attributes)
        && S_ISREG(attributes.st_mode))
     {
         return true;
     }
 
-    return PHYSFS_exists(path);
+    bool archived = false;
+    if(!PathCache::FindArchived(path, &archived))
+    {
+        archived = PHYSFS_exists(path) != 0;
+        PathCache::SetArchived(path, archived);
+    }
+    return archived;
 
 }
 
@@ -72,6 +127,26 @@ bool DDFile::LoadFileIntoBuffer()
     OpenFile = this;
     bool result = false;
     const char* path = mName.c_str();
+
+    const char* packed = NULL;
+    unsigned int packedSize = 0;
+    bool owned = true;
+    if(PushedFiles::Read(path, &packed, &packedSize)
+       || RemoteAssets::Read(path, &packed, &packedSize)
+       || DDPack::Read(path, &packed, &packedSize, &owned))
+    {
+        ClearBuffer();
+        mBuffer = const_cast<char*>(packed);
+        mSize = packedSize;
+        mOwnsBuffer = owned;
+        if(owned)
+        {
+            MemoryStats::Add(MemoryStats::MEMORY_FILES, mSize);
+        }
+        OpenFile = NULL;
+        return true;
+    }
+
     PHYSFS_file* physFile = PHYSFS_openRead(path);
 
 
@@ -86,6 +161,7 @@ bool DDFile::LoadFileIntoBuffer()
 
     mSize = PHYSFS_fileLength(physFile);
     mBuffer = new char[mSize * sizeof(char)];
+    MemoryStats::Add(MemoryStats::MEMORY_FILES, mSize);
     PHYSFS_read(physFile, (void*)mBuffer, 1, mSize);
     PHYSFS_close(physFile);
 
@@ -93,6 +169,32 @@ bool DDFile::LoadFileIntoBuffer()
     return result;
 }
 
+bool DDFile::LoadFileView()
+{
+    const char* path = mName.c_str();
+
+    // Pushes, the asset server and packs win over loose files.
+    if(PushedFiles::Exists(path) || RemoteAssets::IsActive() || DDPack::Exists(path))
+    {
+        return LoadFileIntoBuffer();
+    }
+
+    ClearBuffer();
+    MappedFile* mapped = new MappedFile();
+    if(!mapped->Open(path))
+    {
+        // Not a loose file, or empty, let PhysFS have a go.
+        delete mapped;
+        return LoadFileIntoBuffer();
+    }
+
+    mMapped = mapped;
+    mBuffer = (char*) mapped->Data();
+    mSize = mapped->Size();
+    mOwnsBuffer = false;
+    return true;
+}
+
 // Reads an array of count elements, each one with a size of size bytes,
 // from the stream and stores them in the block of memory specified by ptr.
 // The position indicator of the stream is advanced by the total amount of bytes read.
@@ -128,10 +230,17 @@ void DDFile::ClearBuffer()
 {
     if(mBuffer)
     {
-        delete[] mBuffer;
+        if(mOwnsBuffer)
+        {
+            delete[] mBuffer;
+            MemoryStats::Release(MemoryStats::MEMORY_FILES, mSize);
+        }
         mBuffer = NULL;
         mSize = 0;
     }
+    delete mMapped;
+    mMapped = NULL;
+    mOwnsBuffer = true;
 }
 
 void DDFile::SetBuffer(char* pData, int iSize)
@@ -140,4 +249,5 @@ void DDFile::SetBuffer(char* pData, int iSize)
     mBuffer = new char[iSize];
     memcpy( mBuffer, pData, sizeof(char)*iSize );
     mSize = iSize;
+    MemoryStats::Add(MemoryStats::MEMORY_FILES, mSize);
 }
\ No newline at end of file
@@ -1,6 +1,53 @@
 #ifndef DDLOG_H
 #define DDLOG_H
 
+//
+// Levelled logging.
+//
+// Messages are formatted on the calling thread into LogRing and written
+// out by its flush thread, so logging from a frame costs a vsnprintf and
+// a copy rather than a trip to stdout or logcat.
+//
+// DD_LOG_LEVEL is the lowest level compiled in: 0 debug, 1 info,
+// 2 warning, 3 error. Below it the DD_LOG_* macros vanish along with
+// their arguments.
+//
+//    DD_LOG_DEBUG("Playing [%s]\n", name);
+//
+enum eLogLevel
+{
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARNING,
+    LOG_ERROR
+};
+
+#ifndef DD_LOG_LEVEL
+#define DD_LOG_LEVEL 0
+#endif
+
+extern void ddlog(eLogLevel level, const char* fmt, ...);
+// Info level.
 extern void dsprintf(const char* fmt, ...);
 
+#if DD_LOG_LEVEL <= 0
+#define DD_LOG_DEBUG(...) ddlog(LOG_DEBUG, __VA_ARGS__)
+#else
+#define DD_LOG_DEBUG(...) ((void) 0)
+#endif
+
+#if DD_LOG_LEVEL <= 1
+#define DD_LOG_INFO(...) ddlog(LOG_INFO, __VA_ARGS__)
+#else
+#define DD_LOG_INFO(...) ((void) 0)
+#endif
+
+#if DD_LOG_LEVEL <= 2
+#define DD_LOG_WARNING(...) ddlog(LOG_WARNING, __VA_ARGS__)
+#else
+#define DD_LOG_WARNING(...) ((void) 0)
+#endif
+
+#define DD_LOG_ERROR(...) ddlog(LOG_ERROR, __VA_ARGS__)
+
 #endif
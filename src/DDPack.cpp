@@ -0,0 +1,405 @@
+#include "DDPack.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "DDLog.h"
+#include "reflect/Reflect.h"
+
+std::vector<DDPack*>& DDPack::Mounted()
+{
+    static std::vector<DDPack*> packs;
+    return packs;
+}
+
+DDPack::DDPack(const char* path) :
+    mPath(path),
+    mFile(),
+    mHeader(NULL),
+    mEntries(NULL)
+{
+}
+
+bool DDPack::Mount(const char* path)
+{
+    assert(path);
+    DDPack* pack = new DDPack(path);
+
+    if(!pack->mFile.Open(path))
+    {
+        delete pack;
+        return false;
+    }
+
+    if(!pack->Validate())
+    {
+        dsprintf("Pack [%s] is corrupt or from another version.\n", path);
+        delete pack;
+        return false;
+    }
+
+    dsprintf("Mounted pack [%s] %d entries.\n", path, pack->mHeader->count);
+    Mounted().push_back(pack);
+    return true;
+}
+
+void DDPack::UnmountAll()
+{
+    std::vector<DDPack*>& packs = Mounted();
+    for(std::vector<DDPack*>::iterator it = packs.begin(); it != packs.end(); ++it)
+    {
+        delete (*it);
+    }
+    packs.clear();
+}
+
+bool DDPack::Exists(const char* name)
+{
+    std::vector<DDPack*>& packs = Mounted();
+    for(std::vector<DDPack*>::iterator it = packs.begin(); it != packs.end(); ++it)
+    {
+        if((*it)->Find(name))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DDPack::Locate(const char* name,
+                    unsigned int* outPack,
+                    unsigned int* outOffset,
+                    unsigned int* outStoredSize)
+{
+    assert(outPack);
+    assert(outOffset);
+    assert(outStoredSize);
+
+    std::vector<DDPack*>& packs = Mounted();
+    for(unsigned int i = 0; i < packs.size(); i++)
+    {
+        const Entry* entry = packs[i]->Find(name);
+        if(entry)
+        {
+            *outPack = i;
+            *outOffset = entry->offset;
+            *outStoredSize = entry->storedSize;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DDPack::Prefetch(unsigned int pack, unsigned int offset, unsigned int size)
+{
+    std::vector<DDPack*>& packs = Mounted();
+    if(pack < packs.size())
+    {
+        packs[pack]->mFile.Prefetch(offset, size);
+    }
+}
+
+bool DDPack::Read(const char* name,
+                  const char** outData,
+                  unsigned int* outSize,
+                  bool* outOwned)
+{
+    assert(outData);
+    assert(outSize);
+    assert(outOwned);
+
+    std::vector<DDPack*>& packs = Mounted();
+    for(std::vector<DDPack*>::iterator it = packs.begin(); it != packs.end(); ++it)
+    {
+        const Entry* entry = (*it)->Find(name);
+        if(!entry)
+        {
+            continue;
+        }
+
+        const unsigned char* stored = (*it)->mFile.Data() + entry->offset;
+
+        if(!(entry->flags & FLAG_LZ4))
+        {
+            *outData = (const char*) stored;
+            *outSize = entry->size;
+            *outOwned = false;
+            return true;
+        }
+
+        char* buffer = new char[entry->size];
+        if(!DecodeLZ4(stored, entry->storedSize, (unsigned char*) buffer, entry->size))
+        {
+            dsprintf("Failed to decompress [%s] in pack [%s].\n",
+                     name, (*it)->mPath.c_str());
+            delete[] buffer;
+            return false;
+        }
+
+        *outData = buffer;
+        *outSize = entry->size;
+        *outOwned = true;
+        return true;
+    }
+    return false;
+}
+
+//
+// A block is a run of sequences. Each is a token, literal bytes and then
+// a back reference into the output, the last sequence is literals only.
+//
+bool DDPack::DecodeLZ4(const unsigned char* source,
+                       unsigned int sourceSize,
+                       unsigned char* dest,
+                       unsigned int destSize)
+{
+    const unsigned char* ip = source;
+    const unsigned char* const sourceEnd = source + sourceSize;
+    unsigned char* op = dest;
+    unsigned char* const destEnd = dest + destSize;
+
+    while(ip < sourceEnd)
+    {
+        const unsigned char token = *ip++;
+        unsigned int literals = token >> 4;
+        if(literals == 15)
+        {
+            unsigned char b = 0;
+            do
+            {
+                if(ip >= sourceEnd)
+                {
+                    return false;
+                }
+                b = *ip++;
+                literals += b;
+            } while(b == 255);
+        }
+
+        if(literals > (unsigned int)(sourceEnd - ip) ||
+           literals > (unsigned int)(destEnd - op))
+        {
+            return false;
+        }
+        memcpy(op, ip, literals);
+        op += literals;
+        ip += literals;
+
+        if(ip == sourceEnd)
+        {
+            break;
+        }
+
+        if(sourceEnd - ip < 2)
+        {
+            return false;
+        }
+        const unsigned int offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if(offset == 0 || offset > (unsigned int)(op - dest))
+        {
+            return false;
+        }
+
+        unsigned int matchLength = token & 15;
+        if(matchLength == 15)
+        {
+            unsigned char b = 0;
+            do
+            {
+                if(ip >= sourceEnd)
+                {
+                    return false;
+                }
+                b = *ip++;
+                matchLength += b;
+            } while(b == 255);
+        }
+        matchLength += 4;
+
+        if(matchLength > (unsigned int)(destEnd - op))
+        {
+            return false;
+        }
+
+        // Matches may overlap the bytes they produce, so copy forwards.
+        const unsigned char* match = op - offset;
+        for(unsigned int i = 0; i < matchLength; i++)
+        {
+            *op++ = *match++;
+        }
+    }
+
+    return op == destEnd;
+}
+
+static void PutLZ4Length(std::string* out, unsigned int length)
+{
+    while(length >= 255)
+    {
+        *out += (char) 255;
+        length -= 255;
+    }
+    *out += (char) length;
+}
+
+static void PutLZ4Sequence(std::string* out,
+                           const unsigned char* literals,
+                           unsigned int literalCount,
+                           unsigned int offset,
+                           unsigned int matchLength)
+{
+    const unsigned int tokenLiterals = literalCount < 15 ? literalCount : 15;
+    unsigned int tokenMatch = 0;
+    if(offset != 0)
+    {
+        tokenMatch = matchLength - 4 < 15 ? matchLength - 4 : 15;
+    }
+    *out += (char)((tokenLiterals << 4) | tokenMatch);
+
+    if(literalCount >= 15)
+    {
+        PutLZ4Length(out, literalCount - 15);
+    }
+    out->append((const char*) literals, literalCount);
+
+    if(offset == 0)
+    {
+        return;
+    }
+    *out += (char)(offset & 0xFF);
+    *out += (char)(offset >> 8);
+    if(matchLength - 4 >= 15)
+    {
+        PutLZ4Length(out, matchLength - 4 - 15);
+    }
+}
+
+//
+// The format wants the last five bytes to be literals and no match to
+// start within twelve bytes of the end.
+//
+void DDPack::EncodeLZ4(const unsigned char* source,
+                       unsigned int sourceSize,
+                       std::string* out)
+{
+    const unsigned int HASH_BITS = 12;
+    std::vector<int> table(1 << HASH_BITS, -1);
+
+    unsigned int anchor = 0;
+    unsigned int i = 0;
+    const unsigned int limit = sourceSize > 12 ? sourceSize - 12 : 0;
+    while(i < limit)
+    {
+        unsigned int key = 0;
+        memcpy(&key, source + i, sizeof(key));
+        const unsigned int slot = (key * 2654435761u) >> (32 - HASH_BITS);
+        const int candidate = table[slot];
+        table[slot] = (int) i;
+
+        if(candidate < 0 ||
+           i - candidate > 0xFFFF ||
+           memcmp(source + candidate, source + i, 4) != 0)
+        {
+            i++;
+            continue;
+        }
+
+        unsigned int length = 4;
+        const unsigned int maxLength = sourceSize - 5 - i;
+        while(length < maxLength && source[candidate + length] == source[i + length])
+        {
+            length++;
+        }
+
+        PutLZ4Sequence(out, source + anchor, i - anchor, i - candidate, length);
+        i += length;
+        anchor = i;
+    }
+    PutLZ4Sequence(out, source + anchor, sourceSize - anchor, 0, 0);
+}
+
+//
+// Check every offset up front so lookups and reads can trust the TOC.
+//
+bool DDPack::Validate()
+{
+    const unsigned char* data = mFile.Data();
+    const unsigned int size = mFile.Size();
+    if(size < sizeof(Header))
+    {
+        return false;
+    }
+
+    const Header* header = (const Header*) data;
+    if(memcmp(header->magic, "DDPK", 4) != 0 || header->version != VERSION)
+    {
+        return false;
+    }
+
+    if(header->tocOffset % sizeof(unsigned int) != 0 ||
+       header->tocOffset > size ||
+       header->count > (size - header->tocOffset) / sizeof(Entry))
+    {
+        return false;
+    }
+
+    if(header->namesOffset > size ||
+       header->namesSize > size - header->namesOffset ||
+       header->namesSize == 0 ||
+       data[header->namesOffset + header->namesSize - 1] != '\0')
+    {
+        return false;
+    }
+
+    const Entry* entries = (const Entry*) (data + header->tocOffset);
+    for(unsigned int i = 0; i < header->count; i++)
+    {
+        const Entry& entry = entries[i];
+        if(entry.nameOffset >= header->namesSize ||
+           entry.offset > size ||
+           entry.storedSize > size - entry.offset ||
+           (!(entry.flags & FLAG_LZ4) && entry.storedSize != entry.size) ||
+           (i > 0 && entries[i - 1].hash > entry.hash))
+        {
+            return false;
+        }
+    }
+
+    mHeader = header;
+    mEntries = entries;
+    return true;
+}
+
+const DDPack::Entry* DDPack::Find(const char* name) const
+{
+    const unsigned int hash = Field::HashName(name);
+    const char* names = (const char*) (mFile.Data() + mHeader->namesOffset);
+
+    // Lower bound on the hash, then walk any collisions.
+    unsigned int first = 0;
+    unsigned int count = mHeader->count;
+    while(count > 0)
+    {
+        unsigned int step = count / 2;
+        if(mEntries[first + step].hash < hash)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    for(; first < mHeader->count && mEntries[first].hash == hash; first++)
+    {
+        if(strcmp(names + mEntries[first].nameOffset, name) == 0)
+        {
+            return &mEntries[first];
+        }
+    }
+    return NULL;
+}
\ No newline at end of file
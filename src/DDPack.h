@@ -0,0 +1,95 @@
+#ifndef DDPACK_H
+#define DDPACK_H
+
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+//
+// A read only archive of assets, built by pack_assets.py.
+//
+// The whole file is memory mapped. Uncompressed entries are handed out as
+// pointers straight into the mapping so loading them costs no copy, LZ4
+// compressed entries are decoded into a new buffer.
+//
+// Layout, all values little endian:
+//     Header
+//     Entry[count]       sorted by name hash
+//     names              null terminated, packed
+//     data               each entry starts on a DATA_ALIGNMENT boundary
+//
+class DDPack
+{
+public:
+    static const unsigned int VERSION = 1;
+    static const unsigned int DATA_ALIGNMENT = 16;
+    static const unsigned int FLAG_LZ4 = 1;
+
+    struct Header
+    {
+        char magic[4];              // "DDPK"
+        unsigned int version;
+        unsigned int count;
+        unsigned int tocOffset;
+        unsigned int namesOffset;
+        unsigned int namesSize;
+        unsigned int dataOffset;
+        unsigned int reserved;
+    };
+
+    struct Entry
+    {
+        unsigned int hash;          // Field::HashName of the path
+        unsigned int nameOffset;    // from the start of the names block
+        unsigned int flags;
+        unsigned int offset;        // from the start of the file
+        unsigned int storedSize;    // bytes in the pack
+        unsigned int size;          // bytes once decompressed
+        unsigned int reserved[2];
+    };
+
+    // Packs are searched in the order they're mounted.
+    static bool Mount(const char* path);
+    static void UnmountAll();
+    static bool Exists(const char* name);
+    // Where the entry's stored, for ordering reads. pack is the index in
+    // mount order. False if no pack has it.
+    static bool Locate(const char* name,
+                       unsigned int* outPack,
+                       unsigned int* outOffset,
+                       unsigned int* outStoredSize);
+    static void Prefetch(unsigned int pack, unsigned int offset, unsigned int size);
+
+    // The data is either a pointer into the mapping, which stays valid
+    // until the pack is unmounted, or a new[] buffer the caller must
+    // delete[]. outOwned says which.
+    static bool Read(const char* name,
+                     const char** outData,
+                     unsigned int* outSize,
+                     bool* outOwned);
+
+    // Decodes an LZ4 block. Returns false if the block is malformed or
+    // doesn't decode to exactly destSize bytes.
+    static bool DecodeLZ4(const unsigned char* source,
+                          unsigned int sourceSize,
+                          unsigned char* dest,
+                          unsigned int destSize);
+    // Greedy encoder, the same as pack_assets.py's. Appends the block.
+    static void EncodeLZ4(const unsigned char* source,
+                          unsigned int sourceSize,
+                          std::string* out);
+private:
+    std::string mPath;
+    MappedFile mFile;
+    const Header* mHeader;
+    const Entry* mEntries;
+
+    static std::vector<DDPack*>& Mounted();
+
+    DDPack(const char* path);
+    bool Validate();
+    const Entry* Find(const char* name) const;
+};
+
+#endif
\ No newline at end of file
@@ -2,12 +2,17 @@
 #define DDRESTFUL_H
 
 class HttpPostData;
+class LuaState;
 
 class DDRestful
 {
     public:
         static int Post(const char* uri, HttpPostData* postData,
                      int successRef, int failureRef);
+        // Main thread, once a frame. Calls back for finished posts.
+        static void Update(LuaState* state);
+        // Call before the Lua state is reset, its callbacks are forgotten.
+        static void Reset();
 };
 
 #endif
\ No newline at end of file
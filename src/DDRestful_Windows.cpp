@@ -1,35 +1,76 @@
 #include "DDRestful.h"
 
 #include <assert.h>
+#include <map>
 #include <string>
 
 #include "DDlog.h"
-#include "LuaState.h"
 #include "DinodeckLua.h"
+#include "HttpClient.h"
+#include "HttpPostData.h"
+#include "LuaState.h"
+
+struct Callbacks
+{
+    int successRef;
+    int failureRef;
+};
 
-// TEMP - FOR IMMEDIATE FAILURE
-#include "Dinodeck.h"
-#include "Game.h"
+// Main thread only, by request id.
+static std::map<unsigned int, Callbacks> gCallbacks;
+
+static HttpClient& Client()
+{
+    static HttpClient client;
+    return client;
+}
 
 int DDRestful::Post(const char* uri, HttpPostData* postData,
                    int successRef, int failureRef)
 {
-    dsprintf("Restful currently not supported on windows. %s|%d|%d \n",
-             uri, successRef, failureRef);
-    // if(postData != NULL)
-    // {
-    //     dsprintf("Post data attached.\n");
-    // }
-
-    // int number = StoreCallback(successRef, failureRef);
-
-    // // Needs curl based implementation.
-    // // Windows will need to clear callbacks on reset and cancel async things
-
-    // // NOT IMPLEMENTED, SO FAIL IMMEDIATELY.
-    // std::string msg = "";
-    // DDRestful::OnFailure(Dinodeck::GetInstance()->GetGame()->GetLuaState(), number, msg);
-    // DDRestful::OnFinish(Dinodeck::GetInstance()->GetGame()->GetLuaState(), number);
-    return -1;
+    HttpBody body;
+    std::string contentType("application/x-www-form-urlencoded");
+    if(postData != NULL)
+    {
+        postData->GetBody(&body, &contentType);
+    }
+
+    Callbacks callbacks = { successRef, failureRef };
+    const unsigned int id = Client().Post(uri, body, contentType);
+    gCallbacks[id] = callbacks;
+    return (int) id;
 }
 
+void DDRestful::Update(LuaState* state)
+{
+    HttpClient::Response response;
+    while(Client().PopResponse(&response))
+    {
+        std::map<unsigned int, Callbacks>::iterator it = gCallbacks.find(response.id);
+        if(it == gCallbacks.end())
+        {
+            continue; // posted before a reset
+        }
+
+        const Callbacks callbacks = it->second;
+        gCallbacks.erase(it);
+
+        if(!response.ok)
+        {
+            dsprintf("Http post failed (%d): %s\n",
+                     response.status, response.body.c_str());
+        }
+        state->CallRegisteredFunction(response.ok
+                                          ? callbacks.successRef
+                                          : callbacks.failureRef,
+                                      response.body);
+        luaL_unref(state->State(), LUA_REGISTRYINDEX, callbacks.successRef);
+        luaL_unref(state->State(), LUA_REGISTRYINDEX, callbacks.failureRef);
+    }
+}
+
+void DDRestful::Reset()
+{
+    // The refs went with the old Lua state, replies to them are dropped.
+    gCallbacks.clear();
+}
\ No newline at end of file
@@ -3,12 +3,83 @@
 #include <assert.h>
 #include <cmath>
 #include <ctime>
+#if ANDROID
+#include <time.h>
+#elif __APPLE__
+#include <mach/mach_time.h>
+#else
+#include <windows.h>
+#endif
 
 #include "DinodeckLua.h"
 #include "LuaState.h"
 #include "reflect/Reflect.h"
 
 Reflect DDTime::Meta("Time", DDTime::Bind);
+unsigned long long DDTime::mEpoch = DDTime::Microseconds();
+unsigned long long DDTime::mFrameStart = DDTime::mEpoch;
+unsigned int DDTime::mFrameIndex = 0;
+
+unsigned long long DDTime::Microseconds()
+{
+#if ANDROID
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#elif __APPLE__
+    static mach_timebase_info_data_t timebase = { 0, 0 };
+    if(timebase.denom == 0)
+    {
+        mach_timebase_info(&timebase);
+    }
+    // Ticks scaled by the timebase are nanoseconds.
+    return mach_absolute_time() / 1000 * timebase.numer / timebase.denom;
+#else
+    static LARGE_INTEGER frequency = { { 0, 0 } };
+    if(frequency.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (unsigned long long) (now.QuadPart / frequency.QuadPart) * 1000000
+         + (unsigned long long) (now.QuadPart % frequency.QuadPart) * 1000000
+           / frequency.QuadPart;
+#endif
+}
+
+void DDTime::BeginFrame(unsigned long long microseconds)
+{
+    mFrameStart = microseconds;
+    mFrameIndex++;
+}
+
+//
+// Time.Now()
+// Seconds since start up, to the microsecond. Doesn't jump with the wall
+// clock, so it's for measuring rather than telling the time.
+//
+static int lua_Now(lua_State* state)
+{
+    lua_pushnumber(state, (DDTime::Microseconds() - DDTime::Epoch()) / 1000000.0);
+    return 1;
+}
+
+//
+// Time.FrameStart()
+// Time.Now as the frame began, the same all frame.
+//
+static int lua_FrameStart(lua_State* state)
+{
+    lua_pushnumber(state, (DDTime::FrameStart() - DDTime::Epoch()) / 1000000.0);
+    return 1;
+}
+
+static int lua_FrameIndex(lua_State* state)
+{
+    lua_pushnumber(state, DDTime::FrameIndex());
+    return 1;
+}
 
 static int lua_Difference(lua_State* state)
 {
@@ -171,6 +242,8 @@ static int lua_Get_Time(lua_State* state)
 static const struct luaL_reg luaBinding [] =
 {
     {"Difference", lua_Difference},
+    {"FrameIndex", lua_FrameIndex},
+    {"FrameStart", lua_FrameStart},
     {"GetDate", lua_Get_Date},
     {"GetDay", lua_Get_Day},
     {"GetHour", lua_Get_Hour},
@@ -179,6 +252,7 @@ static const struct luaL_reg luaBinding [] =
     {"GetSecond", lua_Get_Second},
     {"GetTime", lua_Get_Time},
     {"GetYear", lua_Get_Year},
+    {"Now", lua_Now},
     {NULL, NULL}  /* sentinel */
 };
 
@@ -11,5 +11,20 @@ class DDTime
     public: static Reflect Meta;
     public:
         static void Bind(LuaState* state);
+        // From an arbitrary start that doesn't jump with the wall clock,
+        // for timing work within a frame.
+        static unsigned long long Microseconds();
+        // Dinodeck calls this as each frame starts, so scripts can read
+        // when it did and which it is without asking the clock again.
+        static void BeginFrame(unsigned long long microseconds);
+        static unsigned long long FrameStart() { return mFrameStart; }
+        // The first frame is 1, 0 is before any.
+        static unsigned int FrameIndex() { return mFrameIndex; }
+        // Microseconds at start up, what scripts' times count from.
+        static unsigned long long Epoch() { return mEpoch; }
+    private:
+        static unsigned long long mEpoch; // scripts' times count from here
+        static unsigned long long mFrameStart;
+        static unsigned int mFrameIndex;
 };
 #endif
\ No newline at end of file
@@ -1,52 +1,123 @@
 #include "Dinodeck.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <cstdio>
 #include <cmath>
 
+#include "Animation.h"
 #include "Asset.h"
+#include "AssetStore.h"
 #include "DinodeckGL.h"
 #include "DDAudio.h"
 #include "DDFile.h"
 #include "DDLog.h"
+#include "DDTime.h"
+#include "FormatText.h"
 #include "Game.h"
 #include "GraphicsPipeline.h"
 #include "IScreenChangeListener.h"
+#include "JobSystem.h"
+#include "LogRing.h"
+#include "PushedFiles.h"
+#include "RemoteAssets.h"
 #include "LuaState.h"
+#include "MemoryStats.h"
+#include "Mesh.h"
+#include "Metrics.h"
+#include "Renderer.h"
+#include "RenderTarget.h"
+#include "ScriptJobs.h"
+#include "ShaderProgram.h"
+#include "SplashScreen.h"
+#include "StartupTimer.h"
+#include "System.h"
 #include "TextureManager.h"
+#include "Tilemap.h"
+#include "Trace.h"
 #include "FrameBuffer.h"
+#include "FrameCapture.h"
+#include "GPUTimer.h"
+#include "QuadIndexBuffer.h"
+#include "VertexStream.h"
+#include "Zones.h"
+#include "input/Touch.h"
 
 
-class FTTextureFont;
+class Font;
 Dinodeck* Dinodeck::Instance = NULL;
 
+#if ANDROID
+static const char* JitPlatformSetting = "jit_android";
+#elif __APPLE__
+static const char* JitPlatformSetting = "jit_mac";
+#else
+static const char* JitPlatformSetting = "jit_windows";
+#endif
+
 Dinodeck::Dinodeck(const std::string& name)
     :   mName(name),
         mManifestAssetStore(),
         mSettings(),
+        mJobs(NULL),
         mSettingsFile(NULL),
         mGame(NULL),
         mTextureManager(NULL),
         mScreenChangeListener(NULL),
         mDDAudio(NULL),
-        mFrameBuffer(NULL)
+        mAnimations(NULL),
+        mMeshes(NULL),
+        mFrameBuffer(NULL),
+        mFrameCapture(NULL),
+        mVertexStream(NULL),
+        mQuadIndices(NULL),
+        mSceneTimer(NULL),
+        mPresentTimer(NULL),
+        mSplash(NULL),
+        mSplashShown(false),
+        mDisplayQuadBuffer(0),
+        mDisplayQuadDirty(true),
+        mDisplayQuadScale(1.0f),
+        mInputLatency(0),
+        mAverageInputLatency(0),
+        mRedrawFrames(1),
+        mDirtyLeft(0),
+        mDirtyBottom(0),
+        mDirtyRight(0),
+        mDirtyTop(0),
+        mAllDirty(true),
+        mDirtyScale(1.0f),
+        mOffscreen(false)
 {
     Dinodeck::Instance = this;
     mSettingsFile = new Asset("settings", Asset::Script, "settings.lua", this);
+    mJobs = new JobSystem();
     mTextureManager = new TextureManager();
+    mTextureManager->SetJobSystem(mJobs);
+    Texture::SetResidency(mTextureManager);
     mGame = new Game(&mSettings, &mManifestAssetStore, mTextureManager);
     mManifestAssetStore.RegisterAssetOwner("scripts", mGame);
     mDDAudio = new DDAudio();
+    mAnimations = new AnimationStore();
+    mMeshes = new MeshStore();
     mFrameBuffer = new FrameBuffer();
+    mFrameCapture = new FrameCapture();
+    mVertexStream = new VertexStream();
+    mQuadIndices = new QuadIndexBuffer();
+    mSceneTimer = new GPUTimer();
+    mPresentTimer = new GPUTimer();
     // You don't require fonts or textures for a game
     mManifestAssetStore.RegisterAssetOwner("textures", mTextureManager, ManifestAssetStore::Optional);
     mManifestAssetStore.RegisterAssetOwner("fonts", &mManifestAssetStore, ManifestAssetStore::Optional);
     mManifestAssetStore.RegisterAssetOwner("sounds", mDDAudio, ManifestAssetStore::Optional);
     mManifestAssetStore.RegisterAssetOwner("soundstreams", mDDAudio, ManifestAssetStore::Optional);
+    mManifestAssetStore.RegisterAssetOwner("animations", mAnimations, ManifestAssetStore::Optional);
+    mManifestAssetStore.RegisterAssetOwner("meshes", mMeshes, ManifestAssetStore::Optional);
 }
 
 Dinodeck::~Dinodeck()
 {
+    HideSplash();
     if(mGame)
     {
         delete mGame;
@@ -54,6 +125,7 @@ Dinodeck::~Dinodeck()
 
     if(mTextureManager)
     {
+        Texture::SetResidency(NULL);
         delete mTextureManager;
     }
 
@@ -62,10 +134,202 @@ Dinodeck::~Dinodeck()
         delete mDDAudio;
     }
 
+    if(mAnimations)
+    {
+        delete mAnimations;
+    }
+
+    if(mMeshes)
+    {
+        delete mMeshes;
+    }
+
     if(mFrameBuffer)
     {
         delete mFrameBuffer;
     }
+
+    if(mFrameCapture)
+    {
+        delete mFrameCapture;
+    }
+
+    if(mVertexStream)
+    {
+        delete mVertexStream;
+    }
+
+    if(mQuadIndices)
+    {
+        delete mQuadIndices;
+    }
+
+    if(mSceneTimer)
+    {
+        delete mSceneTimer;
+    }
+
+    if(mPresentTimer)
+    {
+        delete mPresentTimer;
+    }
+
+    if(mDisplayQuadBuffer != 0)
+    {
+        glDeleteBuffers(1, &mDisplayQuadBuffer);
+    }
+
+    // Last, everything above may have jobs in flight.
+    delete mJobs;
+}
+
+double Dinodeck::SceneGPUTime() const
+{
+    return mSceneTimer->LastMs();
+}
+
+double Dinodeck::PresentGPUTime() const
+{
+    return mPresentTimer->LastMs();
+}
+
+//
+// When the view is the display size there's nothing to scale, so the
+// scene is drawn straight into the window. Dynamic resolution and the
+// overdraw view always need the frame buffer.
+//
+bool Dinodeck::DrawsDirect() const
+{
+    return IsViewDisplaySize() && !mOffscreen && !mResolution.IsEnabled()
+        && !IsShowingOverdraw();
+}
+
+int Dinodeck::WindowSamples() const
+{
+    return DrawsDirect() ? mSettings.msaaSamples : 0;
+}
+
+int Dinodeck::FrameSamples() const
+{
+    return DrawsDirect() ? 0 : mSettings.msaaSamples;
+}
+
+void Dinodeck::SetShowOverdraw(bool value)
+{
+    GraphicsPipeline::SetDrawOverdraw(value);
+    MarkAllDirty();
+}
+
+bool Dinodeck::IsShowingOverdraw() const
+{
+    return GraphicsPipeline::IsDrawingOverdraw();
+}
+
+void Dinodeck::RequestRedraw(int frames)
+{
+    mRedrawFrames = std::max(mRedrawFrames, frames);
+}
+
+void Dinodeck::MarkDirty(int x, int y, int width, int height)
+{
+    RequestRedraw(1);
+    if(width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    if(mDirtyRight <= mDirtyLeft)
+    {
+        mDirtyLeft = x;
+        mDirtyBottom = y;
+        mDirtyRight = x + width;
+        mDirtyTop = y + height;
+        return;
+    }
+
+    mDirtyLeft = std::min(mDirtyLeft, x);
+    mDirtyBottom = std::min(mDirtyBottom, y);
+    mDirtyRight = std::max(mDirtyRight, x + width);
+    mDirtyTop = std::max(mDirtyTop, y + height);
+}
+
+void Dinodeck::MarkAllDirty()
+{
+    RequestRedraw(1);
+    mAllDirty = true;
+}
+
+//
+// Drawn straight to the window there's no kept frame, and the overdraw
+// map and frame hud have to be drawn whole to mean anything.
+//
+bool Dinodeck::DrawsPartial() const
+{
+    return mSettings.partialRedraw
+        && !DrawsDirect()
+        && !IsShowingOverdraw()
+        && !mFrameHud.IsVisible();
+}
+
+//
+// Everything's redrawn inside the bounds of the marked rects, so two
+// far apart redraw what's between them too. Still better than a
+// scissor each, which would mean drawing the scene once per rect.
+//
+void Dinodeck::BeginPartialFrame()
+{
+    if(mDirtyScale != mResolution.Scale() || !mGame->IsReady())
+    {
+        mAllDirty = true;
+    }
+
+    if(mAllDirty)
+    {
+        GraphicsPipeline::SetFrameClip(NULL);
+    }
+    else
+    {
+        // Nothing marked leaves an empty clip, the frame runs but the
+        // GPU draws nothing.
+        ClipRect clip = { mDirtyLeft,
+                          mDirtyBottom,
+                          std::max(0, mDirtyRight - mDirtyLeft),
+                          std::max(0, mDirtyTop - mDirtyBottom) };
+        GraphicsPipeline::SetFrameClip(&clip);
+    }
+
+    mAllDirty = false;
+    mDirtyScale = mResolution.Scale();
+    mDirtyLeft = 0;
+    mDirtyBottom = 0;
+    mDirtyRight = 0;
+    mDirtyTop = 0;
+}
+
+//
+// Background work only moves on in Update, so frames keep coming while
+// there's any, even when nothing has asked for them.
+//
+bool Dinodeck::WantsFrame()
+{
+    if(!mSettings.redrawOnRequest || mRedrawFrames > 0)
+    {
+        return true;
+    }
+
+    return mTextureManager->IsLoadingAny()
+        || mManifestAssetStore.PendingPreloads() > 0
+        || mGame->GetScheduler()->Count() > 0
+        || mGame->GetScriptJobs()->Pending() > 0;
+}
+
+void Dinodeck::SetInputLatency(double milliseconds)
+{
+    mInputLatency = milliseconds;
+    // Smoothed over about ten frames.
+    mAverageInputLatency = mAverageInputLatency == 0
+        ? milliseconds
+        : mAverageInputLatency * 0.9 + milliseconds * 0.1;
 }
 
 Dinodeck* Dinodeck::GetInstance()
@@ -103,11 +367,111 @@ bool Dinodeck::ReadInSettingsFile(const char* path)
     mSettings.height = luaState.GetInt("height", mSettings.height);
     mSettings.displayWidth = luaState.GetInt("display_width", mSettings.width);
     mSettings.displayHeight = luaState.GetInt("display_height", mSettings.height);
+    mDisplayQuadDirty = true;
     mSettings.mainScript = luaState.GetString("main_script", "main.lua");
     mSettings.onUpdate = luaState.GetString("on_update", "update()");
+    mSettings.onFixedUpdate = luaState.GetString("on_fixed_update", "fixed_update()");
+    mSettings.fixedUpdateRate = std::max(luaState.GetInt("fixed_update_rate", 0), 0);
+    mSettings.maxFixedSteps = std::max(luaState.GetInt("max_fixed_steps", mSettings.maxFixedSteps), 1);
+    mSettings.frameRate = std::max(luaState.GetInt("frame_rate", 60), 0);
+    mSettings.vsync = luaState.GetBoolean("vsync", false);
+    mSettings.lowLatency = luaState.GetBoolean("low_latency", false);
+    mSettings.redrawOnRequest = luaState.GetBoolean("redraw_on_request", false);
+    mSettings.partialRedraw = luaState.GetBoolean("partial_redraw", false);
+    mSettings.dynamicResolution = luaState.GetBoolean("dynamic_resolution", false);
+    mSettings.minResolutionPercent = luaState.GetInt("min_resolution_percent",
+                                                     mSettings.minResolutionPercent);
+    mSettings.resolutionTargetMs = luaState.GetInt("resolution_target_ms",
+                                                   mSettings.resolutionTargetMs);
+    mResolution.Configure(mSettings.dynamicResolution,
+                          mSettings.minResolutionPercent,
+                          mSettings.resolutionTargetMs);
+    mSettings.overdrawHeatmap = luaState.GetBoolean("overdraw_heatmap", false);
+    mSettings.msaaSamples = std::max(luaState.GetInt("msaa_samples", 0), 0);
+    SetShowOverdraw(mSettings.overdrawHeatmap);
     mSettings.manifestPath = luaState.GetString("manifest", "");
+    mSettings.splash = luaState.GetString("splash", "");
+    mSettings.splashBar = luaState.GetBoolean("splash_bar", false);
     mSettings.webserver = luaState.GetBoolean("webserver", false);
     mSettings.orientation = luaState.GetString("orientation", "portrait");
+    mSettings.streamVertices = luaState.GetBoolean("stream_vertices", true);
+    mVertexStream->SetEnabled(mSettings.streamVertices);
+    mQuadIndices->SetEnabled(mSettings.streamVertices);
+    mSettings.recordFrames = luaState.GetBoolean("record_frames", true);
+    GraphicsPipeline::SetRecordFrames(mSettings.recordFrames);
+    mSettings.useShaders = luaState.GetBoolean("use_shaders", true);
+    GraphicsPipeline::SetUseShaders(mSettings.useShaders);
+    mSettings.textureSlots = luaState.GetInt("texture_slots", 1);
+    GraphicsPipeline::SetTextureSlots(std::max(mSettings.textureSlots, 1));
+    // Workers start with the first settings read, a reload keeps them.
+    mSettings.jobThreads = luaState.GetInt("job_threads", 0);
+    mJobs->Start(std::max(mSettings.jobThreads, 0));
+    mSettings.asyncTextures = luaState.GetBoolean("async_textures", false);
+    mTextureManager->SetAsync(mSettings.asyncTextures);
+    mSettings.textureThreads = luaState.GetInt("texture_threads", 2);
+    mTextureManager->SetDecodeThreads(std::max(mSettings.textureThreads, 1));
+    mSettings.textureUploadMs = luaState.GetInt("texture_upload_ms", 4);
+    mTextureManager->SetUploadBudget(mSettings.textureUploadMs);
+    mSettings.textureStreamKB = luaState.GetInt("texture_stream_kb", 512);
+    mTextureManager->SetStreamBytesPerFrame(std::max(mSettings.textureStreamKB, 0) * 1024);
+    mSettings.textureBudgetKB = luaState.GetInt("texture_budget_kb", 0);
+    mTextureManager->SetBudget(std::max(mSettings.textureBudgetKB, 0) * 1024);
+    mSettings.textureCacheKB = luaState.GetInt("texture_cache_kb", 0);
+    mTextureManager->SetCacheBudget(std::max(mSettings.textureCacheKB, 0) * 1024);
+    mSettings.premultipliedAlpha = luaState.GetBoolean("premultiplied_alpha", false);
+    Texture::SetPremultiply(mSettings.premultipliedAlpha);
+    mSettings.trimTransparent = luaState.GetBoolean("trim_transparent", true);
+    Texture::SetTrimTransparent(mSettings.trimTransparent);
+
+    std::string gcMode = luaState.GetString("gc_mode", "full");
+    if(!LuaState::ParseGCMode(gcMode, &mSettings.gcMode))
+    {
+        dsprintf("Unknown gc_mode [%s], use full, incremental or manual.\n",
+                 gcMode.c_str());
+        mSettings.gcMode = LuaState::GC_FULL;
+    }
+    mSettings.gcStepMicroseconds = std::max(luaState.GetInt("gc_step_us",
+                                                            LuaState::DEFAULT_GC_STEP_MICROSECONDS),
+                                            0);
+    mSettings.bytecodeCache = luaState.GetBoolean("bytecode_cache", true);
+    mSettings.bytecodeCacheDir = luaState.GetString("bytecode_cache_dir", "");
+    mSettings.fastReset = luaState.GetBoolean("fast_reset", true);
+    mSettings.schedulerBudgetMicroseconds = std::max(luaState.GetInt("scheduler_budget_us",
+                                                                     Scheduler::DEFAULT_BUDGET_MICROSECONDS),
+                                                     0);
+    mSettings.hotReload = luaState.GetBoolean("hot_reload", true);
+    mSettings.jit = luaState.GetBoolean(JitPlatformSetting, luaState.GetBoolean("jit", true));
+    mSettings.jitLog = luaState.GetBoolean("jit_log", false);
+    mSettings.jitHotloop = std::max(luaState.GetInt("jit_hotloop", 0), 0);
+    mSettings.jitMaxMcodeKb = std::max(luaState.GetInt("jit_maxmcode", 0), 0);
+    mSettings.contentHashing = luaState.GetBoolean("content_hashing", true);
+    AssetStore::ContentHashingFlag(mSettings.contentHashing);
+    mSettings.contentHashFile = luaState.GetString("content_hash_file", "");
+    AssetStore::SetHashFile(mSettings.contentHashFile);
+    mSettings.preloadBudgetUs = luaState.GetInt("preload_budget_us", mSettings.preloadBudgetUs);
+    mSettings.manifestCacheFile = luaState.GetString("manifest_cache_file", "");
+    mManifestAssetStore.SetCacheFile(mSettings.manifestCacheFile);
+    mSettings.assetServer = luaState.GetString("asset_server", "");
+    mSettings.assetCacheDir = luaState.GetString("asset_cache_dir", "");
+    RemoteAssets::Configure(mSettings.assetServer, mSettings.assetCacheDir);
+    mSettings.shareSoundBuffers = luaState.GetBoolean("share_sound_buffers", true);
+    mDDAudio->SetShareBuffers(mSettings.shareSoundBuffers);
+    mSettings.soundBudgetKb = luaState.GetInt("sound_budget_kb", mSettings.soundBudgetKb);
+    mDDAudio->SetSoundBudget((unsigned int) std::max(mSettings.soundBudgetKb, 0) * 1024);
+    mSettings.audioRefresh = luaState.GetInt("audio_refresh", mSettings.audioRefresh);
+    mDDAudio->SetOutputRefresh(mSettings.audioRefresh);
+    mSettings.soundResample = luaState.GetString("sound_resample", mSettings.soundResample.c_str());
+    mSettings.soundChannels = luaState.GetInt("sound_channels", mSettings.soundChannels);
+    mDDAudio->SetConversion(mSettings.soundResample != "off",
+                            mSettings.soundChannels,
+                            mSettings.soundResample == "cubic");
+    mSettings.httpBatchMs = std::max(luaState.GetInt("http_batch_ms", mSettings.httpBatchMs), 0);
+    mSettings.httpBatchMax = std::max(luaState.GetInt("http_batch_max", mSettings.httpBatchMax), 1);
+    mSettings.httpOutboxFile = luaState.GetString("http_outbox_file", "http_outbox");
+    mSettings.scoreCacheSeconds = std::max(luaState.GetInt("score_cache_seconds", mSettings.scoreCacheSeconds), 0);
+    mSettings.scoreCacheFile = luaState.GetString("score_cache_file", "score_cache");
+    mSettings.logFile = luaState.GetString("log_file", "");
+    LogRing::SetFile(mSettings.logFile.c_str());
 
     // Display Width and Height must be equal or greater
     // than width and height
@@ -147,6 +511,7 @@ bool Dinodeck::OnAssetReload(Asset& asset)
         mGame->Break();
         return false;
     }
+    StartupTimer::Mark("settings");
 
     if(!DDFile::FileExists(mSettings.manifestPath.c_str()))
     {
@@ -163,6 +528,8 @@ bool Dinodeck::OnAssetReload(Asset& asset)
     }
 
     ResetRenderWindow(mSettings.width, mSettings.height);
+    StartupTimer::Mark("window");
+    ShowSplash();
 
     if(!mManifestAssetStore.Reload(mSettings.manifestPath))
     {
@@ -170,6 +537,7 @@ bool Dinodeck::OnAssetReload(Asset& asset)
         mGame->Break();
         return false;
     }
+    StartupTimer::Mark("manifest");
 
     return true;
 }
@@ -182,7 +550,10 @@ void Dinodeck::OnAssetDestroyed(Asset& asset)
 bool Dinodeck::ForceReload()
 {
     assert(mSettingsFile);
+    MarkAllDirty();
     mGame->ResetReloadCount();
+    // A reset goes back to what's on disk.
+    PushedFiles::Clear();
 
     bool resetSuccess = true;
 
@@ -198,7 +569,7 @@ bool Dinodeck::ForceReload()
             // Update the timestamp
             time_t lastModified = AssetStore::GetModifiedTimeStamp(*mSettingsFile);
             mSettingsFile->SetTimeLastModified(lastModified);
-            mFrameBuffer->Reset(ViewWidth(), ViewHeight());
+            mFrameBuffer->Reset(ViewWidth(), ViewHeight(), false, true, FrameSamples());
         }
     }
     else
@@ -211,6 +582,7 @@ bool Dinodeck::ForceReload()
     if(!resetSuccess)
     {
         dsprintf("Reset failed.\n");
+        HideSplash();
         mGame->Break();
         return false;
     }
@@ -225,7 +597,78 @@ bool Dinodeck::ForceReload()
         // Then reload it now.
         mGame->Reset();
     }
+    StartupTimer::Mark("main_script");
+    HideSplash();
+
+    return true;
+}
+
+//
+// Up before the manifest loads, so a cold start has something on screen
+// from its first frames.
+//
+void Dinodeck::ShowSplash()
+{
+    // A reload keeps the game on screen instead.
+    if(mSplashShown || (mSettings.splash.empty() && !mSettings.splashBar))
+    {
+        return;
+    }
+    mSplashShown = true;
+
+    mSplash = new SplashScreen(DisplayWidth(),
+                               DisplayHeight(),
+                               mSettings.clearRed,
+                               mSettings.clearGreen,
+                               mSettings.clearBlue,
+                               mSettings.splashBar,
+                               mScreenChangeListener);
+    if(!mSettings.splash.empty())
+    {
+        mSplash->Load(mSettings.splash.c_str());
+    }
+    mSplash->Show(0);
+    AssetStore::SetProgressListener(mSplash);
+    StartupTimer::Mark("splash");
+}
+
+void Dinodeck::HideSplash()
+{
+    if(mSplash == NULL)
+    {
+        return;
+    }
+    AssetStore::SetProgressListener(NULL);
+    delete mSplash;
+    mSplash = NULL;
+}
+
+bool Dinodeck::ReloadAsset(const char* name, const std::string& data)
+{
+    Asset* asset = mManifestAssetStore.GetAssetByName(name);
+    if(asset == NULL)
+    {
+        dsprintf("Can't reload [%s], it's not in the manifest.\n", name);
+        return false;
+    }
+
+    MarkAllDirty();
+    mGame->ResetReloadCount();
+    if(!data.empty())
+    {
+        PushedFiles::Set(asset->Path(), data);
+    }
 
+    if(!mManifestAssetStore.ReloadAsset(name))
+    {
+        dsprintf("Reloading [%s] failed.\n", name);
+        return false;
+    }
+
+    if(mGame->GetReloadCount() > 0)
+    {
+        mGame->Reset();
+    }
     return true;
 }
 
@@ -234,57 +677,204 @@ bool Dinodeck::ForceReload()
 //              * Capped to 1/60 on Windows
 void Dinodeck::Update(double deltaTime)
 {
-    mFrameBuffer->Enable(); // draw scene to texture
+    DD_PROFILE_ZONE("Frame");
+    const unsigned long long frameStart = DDTime::Microseconds();
+    DDTime::BeginFrame(frameStart);
+    if(mRedrawFrames > 0)
+    {
+        mRedrawFrames--;
+    }
 
-    glClearColor(mSettings.clearRed,
-                 mSettings.clearGreen,
-                 mSettings.clearBlue, 0);
+    const bool direct = DrawsDirect();
+    const bool partial = DrawsPartial();
+
+    if(!direct)
+    {
+        mFrameBuffer->Enable(); // draw scene to texture
+    }
+
+    if(IsShowingOverdraw())
+    {
+        glClearColor(0, 0, 0, 0); // no fills
+    }
+    else
+    {
+        glClearColor(mSettings.clearRed,
+                     mSettings.clearGreen,
+                     mSettings.clearBlue, 0);
+    }
     SetModelViewMatrix(ViewWidth(), ViewHeight());
+    // The projection still covers the whole view, so the game's
+    // coordinates don't change with the resolution.
+    glViewport(0, 0, SceneWidth(), SceneHeight());
+    GraphicsPipeline::SetViewScale(mResolution.Scale());
+    mTextureManager->NewFrame();
+    mTextureManager->UploadDecoded();
+    mManifestAssetStore.UpdatePreloads((unsigned int) mSettings.preloadBudgetUs);
+    mDDAudio->Update();
+
+    if(partial)
+    {
+        // Before the game's clear, so that's scissored too.
+        BeginPartialFrame();
+    }
+    else
+    {
+        // What's kept is whatever this frame draws, hud and all.
+        mAllDirty = true;
+    }
 
+    mSceneTimer->Begin();
     mGame->Update(deltaTime);
-    mFrameBuffer->Disable(); // back to drawing to main window
+    mSceneTimer->End();
+
+    // Touches are applied after the game's update, it sees them next frame.
+    if(mGame->GetTouch()->EventCount() > 0)
+    {
+        RequestRedraw(1);
+    }
+
+    if(partial)
+    {
+        // Resolving and presenting take the whole frame.
+        GraphicsPipeline::SetFrameClip(NULL);
+    }
+
+    if(!direct)
+    {
+        mFrameBuffer->Resolve(SceneWidth(), SceneHeight());
+    }
+
+    if(IsShowingOverdraw())
+    {
+        mOverdrawMap.Measure(SceneWidth(), SceneHeight(), mFrameBuffer->TextureId());
+    }
+
+    if(!direct)
+    {
+        mFrameBuffer->Disable(); // back to drawing to main window
+    }
+
+    if(!direct && !mOffscreen)
+    {
+        const unsigned long long presentStart = DDTime::Microseconds();
+        mPresentTimer->Begin();
+        PresentFrame();
+        mPresentTimer->End();
+        mFrameHud.AddSplit(FrameHud::SPLIT_PRESENT,
+                           (DDTime::Microseconds() - presentStart) / 1000.0);
+        Trace::Record("present", presentStart, DDTime::Microseconds());
+    }
+
+    if(direct || !mOffscreen)
+    {
+        // The window holds the finished frame until the swap.
+        mFrameCapture->Update(DisplayWidth(), DisplayHeight());
+    }
+    Trace::Record("frame", frameStart, DDTime::Microseconds());
+    mFrameHud.EndFrame();
+    // Without GPU timers the busy part of the frame stands in, a GPU
+    // that's behind shows up as waits in the swap.
+    double gpuMs = SceneGPUTime();
+    if(gpuMs < 0)
+    {
+        gpuMs = mFrameHud.LastFrameTime() - mFrameHud.LastSplit(FrameHud::SPLIT_SLEEP);
+    }
+    mResolution.Update(gpuMs);
+    SampleMemory();
+    Metrics::Publish(this, mFrameHud.LastFrameTime());
+}
+
+void Dinodeck::SampleMemory()
+{
+    unsigned int fontBytes = mManifestAssetStore.GlyphAtlasBytes();
+    if(mGame && mGame->GetSystemFont())
+    {
+        fontBytes += FormatText::GlyphAtlasBytes(mGame->GetSystemFont());
+    }
+    MemoryStats::Set(MemoryStats::MEMORY_FONTS, fontBytes, fontBytes);
+
+    if(mGame && mGame->GetLuaState())
+    {
+        LuaAllocator::Stats heap = mGame->GetLuaState()->LastFrameHeap();
+        MemoryStats::Set(MemoryStats::MEMORY_LUA, heap.bytes, heap.peakBytes);
+    }
+}
+
+//
+// Scales the scene texture up to the window.
+//
+void Dinodeck::PresentFrame()
+{
+    if(mFrameBuffer->BlitToWindow(SceneWidth(), SceneHeight(),
+                                  DisplayWidth(), DisplayHeight()))
+    {
+        return;
+    }
+
+    if(mDisplayQuadScale != mResolution.Scale())
+    {
+        mDisplayQuadDirty = true;
+    }
 
     glClearColor(0,  0,  0, 0);
     SetModelViewMatrix(DisplayWidth(), DisplayHeight());
+    glClear(GL_COLOR_BUFFER_BIT);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, mFrameBuffer->TextureId());
+    DrawDisplayQuad();
+    glDisable(GL_TEXTURE_2D);
+}
 
+void Dinodeck::DrawDisplayQuad()
+{
+    if(mDisplayQuadDirty)
     {
-        glClear(GL_COLOR_BUFFER_BIT);
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, mFrameBuffer->TextureId());
-
-        // This doesn't need doing each frame...
         CreateDisplayQuad();
+    }
 
-        const unsigned int POSITION_SIZE = 3; // no w
-        const unsigned int COLOUR_SIZE = 4;
-        const unsigned int TEXCOORD_SIZE = 2;
+    const unsigned int POSITION_SIZE = 3; // no w
+    const unsigned int COLOUR_SIZE = 4;
+    const unsigned int TEXCOORD_SIZE = 2;
 
-        glVertexPointer(POSITION_SIZE, GL_FLOAT, sizeof(Vertex), mVertexBuffer);
-        glEnableClientState(GL_VERTEX_ARRAY);
+    // From the buffer the pointers are offsets into it.
+    const char* start = (const char*) mVertexBuffer;
+    const char* base = start;
+    if(mDisplayQuadBuffer != 0)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, mDisplayQuadBuffer);
+        base = NULL;
+    }
 
-        glColorPointer(COLOUR_SIZE, GL_FLOAT, sizeof(Vertex), &mVertexBuffer[0].r);
-        glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(POSITION_SIZE, GL_FLOAT, sizeof(Vertex),
+                    base + ((const char*) &mVertexBuffer[0].x - start));
+    glEnableClientState(GL_VERTEX_ARRAY);
 
-        glTexCoordPointer(TEXCOORD_SIZE, GL_FLOAT, sizeof(Vertex), &mVertexBuffer[0].u);
-        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glColorPointer(COLOUR_SIZE, GL_FLOAT, sizeof(Vertex),
+                   base + ((const char*) &mVertexBuffer[0].r - start));
+    glEnableClientState(GL_COLOR_ARRAY);
 
+    glTexCoordPointer(TEXCOORD_SIZE, GL_FLOAT, sizeof(Vertex),
+                      base + ((const char*) &mVertexBuffer[0].u - start));
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 
-        glPushMatrix();
-        {
-            glDrawArrays(GL_TRIANGLES, 0, DISPLAY_QUAD_VERTS);
-        }
-        glPopMatrix();
+    glPushMatrix();
+    {
+        glDrawArrays(GL_TRIANGLES, 0, DISPLAY_QUAD_VERTS);
+    }
+    glPopMatrix();
 
-        //
-        // Disable the various pointers
-        //
-        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-        glDisableClientState(GL_COLOR_ARRAY);
-        glDisableClientState(GL_VERTEX_ARRAY);
+    //
+    // Disable the various pointers
+    //
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
 
-        glDisable(GL_TEXTURE_2D);
+    if(mDisplayQuadBuffer != 0)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
-
 }
 
 bool Dinodeck::IsRunning() const
@@ -310,10 +900,14 @@ void Dinodeck::SetModelViewMatrix(float width, float height)
 void Dinodeck::ResetRenderWindow(unsigned int width, unsigned int height)
 {
     dsprintf("Resetting render window %d %d\n", width, height );
+    MarkAllDirty();
     mSettings.width = width;
     mSettings.height = height;
 
-    mFrameBuffer->Reset(ViewWidth(), ViewHeight());
+    mFrameBuffer->Reset(ViewWidth(), ViewHeight(), false, true, FrameSamples());
+    // Buffers survive a resize, a new context goes through
+    // OpenGLContextReset first.
+    mDisplayQuadDirty = true;
     // A nice slate greyish clear colour
     glClearColor(mSettings.clearRed,
              mSettings.clearGreen,
@@ -325,17 +919,81 @@ void Dinodeck::ResetRenderWindow(unsigned int width, unsigned int height)
     glEnable(GL_BLEND);
 }
 
+ReleasedCaches Dinodeck::ReleaseCaches()
+{
+    ReleasedCaches released;
+    released.textures = mTextureManager->ReleaseCache();
+    for(std::vector<Renderer*>::iterator it = Renderer::mRenderers.begin();
+        it != Renderer::mRenderers.end(); ++it)
+    {
+        released.layouts += (*it)->Graphics()->ReleaseLayoutCache();
+    }
+    released.sounds = mDDAudio->ReleaseCaches();
+
+    if(mGame)
+    {
+        // Twice, objects with finalizers are only freed by the second.
+        LuaState* lua = mGame->GetLuaState();
+        const unsigned int before = lua->HeapKB();
+        lua->CollectGarbage();
+        lua->CollectGarbage();
+        const unsigned int after = lua->HeapKB();
+        released.lua = (before > after) ? (before - after) * 1024 : 0;
+    }
+
+    dsprintf("Released %u KB of caches: textures %u, layouts %u, sounds %u, lua %u.\n",
+             released.Total() / 1024,
+             released.textures / 1024,
+             released.layouts / 1024,
+             released.sounds / 1024,
+             released.lua / 1024);
+    return released;
+}
+
+void Dinodeck::OnLowMemory(int level)
+{
+    dsprintf("Low memory, trim level %d.\n", level);
+    if(mGame == NULL)
+    {
+        return;
+    }
+    System::OnLowMemory(mGame->GetLuaState(), level, ReleaseCaches());
+}
+
 void Dinodeck::OpenGLContextReset()
 {
+    MarkAllDirty();
     mManifestAssetStore.SetAsNotLoaded(Asset::Texture);
     mManifestAssetStore.SetAsNotLoaded(Asset::Font); // Font also uses textures.
+    mTextureManager->ForgetTextures(); // the ids are meaningless now
+    mTextureManager->ResetAtlas();
+    mTextureManager->ResetStreams();
     // Reset the system font too.
     mGame->ResetSystemFont();
     mGame->InvalidateRendererFonts();
+    mGame->ResetRendererStaticLayers();
+    Tilemap::ResetAll();
+    ShaderProgram::ResetAll();
+    RenderTarget::ResetAll();
+    mVertexStream->Reset();
+    mQuadIndices->Reset();
+    mMeshes->Reset();
+    mFrameCapture->Reset();
+    mDisplayQuadBuffer = 0; // went with the context
+    mSceneTimer->Reset();
+    mPresentTimer->Reset();
+    mDisplayQuadDirty = true;
+    GraphicsPipeline::GLState().Invalidate();
+    mFrameBuffer->Forget();
     mFrameBuffer->Reset(ViewWidth(),
-                        ViewHeight());
+                        ViewHeight(),
+                        false, true, FrameSamples());
 }
 
+//
+// Fills the quad and uploads it, only needed when the display size or
+// the context changes.
+//
 void Dinodeck::CreateDisplayQuad()
 {
     // Fill it up
@@ -344,18 +1002,22 @@ void Dinodeck::CreateDisplayQuad()
     colour.SetBroadcast(1.0f);
     const float halfWidth = floor(((float)DisplayWidth())/2.0f);
     const float halfHeight = floor(((float)DisplayHeight())/2.0f);
+    // Only the corner of the frame buffer the scene was drawn into.
+    mDisplayQuadScale = mResolution.Scale();
+    const float u = (float) SceneWidth() / ViewWidth();
+    const float v = (float) SceneHeight() / ViewHeight();
 
     // TL
     mVertexBuffer[0] = Vertex(
         Vector(-halfWidth, 0 + halfHeight, 0.f, 1),
         colour,
-        0, 1);
+        0, v);
 
     // TR
     mVertexBuffer[1] = Vertex(
         Vector(halfWidth, 0 + halfHeight, 0, 1),
         colour,
-        1, 1);
+        u, v);
 
     // BL
     mVertexBuffer[2] = Vertex(
@@ -367,17 +1029,33 @@ void Dinodeck::CreateDisplayQuad()
     mVertexBuffer[3] = Vertex(
         Vector(halfWidth, 0 + halfHeight, 0, 1),
         colour,
-        1, 1);
+        u, v);
 
     // BR
     mVertexBuffer[4] = Vertex(
         Vector(halfWidth, 0 - halfHeight, 0, 1),
         colour,
-        1, 0);
+        u, 0);
 
     // BL
     mVertexBuffer[5] = Vertex(
         Vector(-halfWidth, 0 - halfHeight, 0, 1),
         colour,
         0, 0);
+
+    mDisplayQuadDirty = false;
+
+    if(mDisplayQuadBuffer == 0)
+    {
+        glGenBuffers(1, &mDisplayQuadBuffer);
+    }
+
+    if(mDisplayQuadBuffer == 0)
+    {
+        return; // draws from client memory
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, mDisplayQuadBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(mVertexBuffer), mVertexBuffer, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
\ No newline at end of file
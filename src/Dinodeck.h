@@ -3,20 +3,45 @@
 #include <string>
 
 #include "AssetStore.h"
+#include "DynamicResolution.h"
+#include "FrameHud.h"
 #include "IAssetOwner.h"
 #include "ManifestAssetStore.h"
+#include "OverdrawMap.h"
 #include "Settings.h"
 #include "Vertex.h"
 
 // Dinodeck is the kernel of the engine and should have limited dependancies.
 // It assumes access to OpenGL
 
+class AnimationStore;
+class MeshStore;
 class Asset;
 class Game;
 class TextureManager;
 class IScreenChangeListener;
 class DDAudio;
 class FrameBuffer;
+class FrameCapture;
+class GPUTimer;
+class VertexStream;
+class QuadIndexBuffer;
+class JobSystem;
+class SplashScreen;
+
+//
+// Bytes freed by Dinodeck::ReleaseCaches, by what held them.
+//
+struct ReleasedCaches
+{
+    unsigned int textures; // decoded pixels kept for a lost context
+    unsigned int layouts; // text layouts, roughly
+    unsigned int sounds; // ondemand sounds that weren't playing
+    unsigned int lua; // by a full collection
+
+    ReleasedCaches() : textures(0), layouts(0), sounds(0), lua(0) {}
+    unsigned int Total() const { return textures + layouts + sounds + lua; }
+};
 
 class Dinodeck : IAssetOwner
 {
@@ -24,14 +49,42 @@ private:
     std::string mName; // name of the game / project
     ManifestAssetStore mManifestAssetStore;
     Settings mSettings;
+    JobSystem* mJobs;
     Asset* mSettingsFile;
     Game* mGame;
     TextureManager* mTextureManager;
     IScreenChangeListener* mScreenChangeListener;
     DDAudio* mDDAudio;
+    AnimationStore* mAnimations;
+    MeshStore* mMeshes;
     FrameBuffer* mFrameBuffer;
+    FrameCapture* mFrameCapture;
+    VertexStream* mVertexStream;
+    QuadIndexBuffer* mQuadIndices;
+    GPUTimer* mSceneTimer;
+    GPUTimer* mPresentTimer;
+    SplashScreen* mSplash; // up until the main script has run
+    bool mSplashShown; // once, on the cold start
     static const int DISPLAY_QUAD_VERTS = 6;
     Vertex mVertexBuffer[DISPLAY_QUAD_VERTS];
+    unsigned int mDisplayQuadBuffer; // GL buffer id, 0 draws from mVertexBuffer
+    bool mDisplayQuadDirty; // rebuilt on the next present
+    float mDisplayQuadScale; // of the frame buffer the quad's uvs cover
+    double mInputLatency; // milliseconds, last frame
+    double mAverageInputLatency;
+    int mRedrawFrames; // still to draw, for redraw_on_request
+    // For partial_redraw, the bounds of what's been marked for the next
+    // frame in view pixels. Empty when right isn't past left.
+    int mDirtyLeft;
+    int mDirtyBottom;
+    int mDirtyRight;
+    int mDirtyTop;
+    bool mAllDirty; // the next frame is drawn whole
+    float mDirtyScale; // resolution the kept frame was drawn at
+    bool mOffscreen; // scene only drawn into the frame buffer
+    FrameHud mFrameHud;
+    DynamicResolution mResolution;
+    OverdrawMap mOverdrawMap;
     static Dinodeck* Instance;
 
 public:
@@ -47,17 +100,65 @@ public:
     unsigned int ViewWidth() const { return mSettings.width; }
     unsigned int DisplayWidth() const { return mSettings.displayWidth; }
     unsigned int DisplayHeight() const { return mSettings.displayHeight; }
+    // What the scene is drawn at this frame, the view size unless
+    // dynamic_resolution has lowered it.
+    unsigned int SceneWidth() const { return mResolution.Scaled(ViewWidth()); }
+    unsigned int SceneHeight() const { return mResolution.Scaled(ViewHeight()); }
+    float ResolutionScale() const { return mResolution.Scale(); }
     bool ForceReload();
+    // Swaps in one asset, from data if it's not empty or else from its
+    // file. The game only resets if the asset owner asks it to.
+    bool ReloadAsset(const char* name, const std::string& data);
     void ResetRenderWindow(unsigned int width, unsigned int height);
     void SetName(const std::string& value) { mName = value; }
     void Update(double deltaTime);
     Game* GetGame() { return mGame; }
     const Settings& GetSettings() { return mSettings; }
     DDAudio* GetAudio() { return mDDAudio; }
+    AnimationStore* GetAnimations() { return mAnimations; }
+    MeshStore* GetMeshes() { return mMeshes; }
+    VertexStream* GetVertexStream() { return mVertexStream; }
+    QuadIndexBuffer* GetQuadIndices() { return mQuadIndices; }
+    JobSystem* GetJobs() { return mJobs; }
+    FrameHud* GetFrameHud() { return &mFrameHud; }
+    FrameCapture* GetFrameCapture() { return mFrameCapture; }
+    // Used by --bench, frames are drawn but never reach the window.
+    void SetOffscreen(bool value) { mOffscreen = value; }
+    bool IsOffscreen() const { return mOffscreen; }
+    // Multisampling goes on whichever the scene is drawn into, the
+    // window when it's drawn straight there or else the frame buffer.
+    int WindowSamples() const;
+    // Debug view, frames show how many times each pixel was drawn.
+    void SetShowOverdraw(bool value);
+    bool IsShowingOverdraw() const;
+    const OverdrawMap& GetOverdrawMap() const { return mOverdrawMap; }
+
+    // GPU milliseconds for drawing the game and for scaling it to the
+    // window, from a few frames ago. -1 when they can't be measured.
+    double SceneGPUTime() const;
+    double PresentGPUTime() const;
+    // Milliseconds from reading input to the frame being swapped, set by
+    // the platform loop. The display's own delay isn't counted.
+    void SetInputLatency(double milliseconds);
+
+    // With the redraw_on_request setting, the platform loop only calls
+    // Update while WantsFrame is true and otherwise sleeps until input.
+    // Input and reloads ask for a frame themselves.
+    void RequestRedraw(int frames);
+    bool WantsFrame();
+    // With the partial_redraw setting, the frame buffer is kept between
+    // frames and each frame only clears and draws inside the bounds of
+    // what was marked during the one before. Rects are in view pixels
+    // from the bottom left, as Renderer:Clip, and both also ask for a
+    // frame. Anything that loses the kept frame marks it all.
+    void MarkDirty(int x, int y, int width, int height);
+    void MarkAllDirty();
+    double InputLatency() const { return mInputLatency; }
+    double AverageInputLatency() const { return mAverageInputLatency; }
     bool ReadInSettingsFile(const char* name);
 
     // Font as specified to be default in the manifest. Can be NULL
-    FTTextureFont* GetDefaultFont() { return mManifestAssetStore.GetFont("font"); }
+    Font* GetDefaultFont() { return mManifestAssetStore.GetFont("font"); }
 
     void SetScreenChangeListener(IScreenChangeListener* scl)
     {
@@ -69,12 +170,37 @@ public:
     // Called when the context gets reset.
     void OpenGLContextReset();
 
+    // Drops everything that's rebuilt when next needed and collects the
+    // Lua heap, so the OS has less reason to kill the game. Call on the
+    // thread with the GL context, GC finalizers may free textures.
+    ReleasedCaches ReleaseCaches();
+    // The OS is short of memory, level is the Android trim level. Releases
+    // the caches, then calls the script's System.OnLowMemory handler.
+    void OnLowMemory(int level);
+
     // Callback to reload the manifest
     virtual void OnAssetDestroyed(Asset& asset);
     virtual bool OnAssetReload(Asset& asset);
 private:
     void SetModelViewMatrix(float width, float height);
+    bool DrawsDirect() const;
+    int FrameSamples() const;
+    bool IsViewDisplaySize() const
+    {
+        return mSettings.width == mSettings.displayWidth
+            && mSettings.height == mSettings.displayHeight;
+    }
+    void PresentFrame();
+    bool DrawsPartial() const;
+    // Scissors the frame to what was marked and starts collecting for
+    // the next one.
+    void BeginPartialFrame();
+    // Reads the memory MemoryStats can't count as it's made, once a frame.
+    void SampleMemory();
     void CreateDisplayQuad();
+    void DrawDisplayQuad();
+    void ShowSplash();
+    void HideSplash();
 };
 
 #endif
@@ -3,15 +3,29 @@
 #include <GLES/gl.h>
 #include <GLES/glext.h>
 
+// GLES 1.1 has no stream usage hint, dynamic is the closest.
+#define GL_STREAM_DRAW GL_DYNAMIC_DRAW
+
 #elif __APPLE__
 
 #include <OpenGL/gl.h>
 #define glOrthof glOrtho
+#define glDepthRangef glDepthRange
+
+// GLSL programs, GLES1 only has fixed function.
+#define DINODECK_SHADERS 1
 #else
 
 #include "GLee.h"
 #include <gl/gl.h>
 
 #define glOrthof glOrtho
+#define glDepthRangef glDepthRange
 #define GL_CLAMP_TO_EDGE 0x812F
+#define DINODECK_SHADERS 1
+// GL_TIME_ELAPSED queries, through EXT_timer_query.
+#define DINODECK_GPU_TIMERS 1
+// Texture uploads and frame captures through pixel buffer objects,
+// ARB_pixel_buffer_object.
+#define DINODECK_PBO_UPLOADS 1
 #endif
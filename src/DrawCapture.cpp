@@ -0,0 +1,300 @@
+#include "DrawCapture.h"
+
+#include <algorithm>
+#include <map>
+#include <stdio.h>
+
+#include "Dinodeck.h"
+#include "DinodeckLua.h"
+#include "DDLog.h"
+#include "DDTime.h"
+#include "Game.h"
+#include "GraphicsPipeline.h"
+#include "LuaState.h"
+#include "util/Json.h"
+
+bool DrawCapture::mRequested = false;
+bool DrawCapture::mCapturing = false;
+unsigned int DrawCapture::mReplays = 0;
+unsigned int DrawCapture::mFrameCount = 0;
+unsigned int DrawCapture::mFrame = 0;
+std::vector<DrawCapture::Batch> DrawCapture::mBatches;
+CommandList DrawCapture::mCommands;
+bool DrawCapture::mScissored = false;
+int DrawCapture::mScissorX = 0;
+int DrawCapture::mScissorY = 0;
+int DrawCapture::mScissorWidth = 0;
+int DrawCapture::mScissorHeight = 0;
+unsigned int DrawCapture::mReplayCount = 0;
+double DrawCapture::mReplayMs = 0;
+
+static const char* DepthPassStr[] = { "off", "opaque", "translucent" };
+
+//
+// The innermost Lua line on the game's stack. Flushes at the end of the
+// frame, after the script has returned, have none.
+//
+static std::string CallSite()
+{
+    Game* game = Dinodeck::GetInstance()->GetGame();
+    if(game == NULL || game->GetLuaState() == NULL)
+    {
+        return "";
+    }
+
+    lua_State* state = game->GetLuaState()->State();
+    lua_Debug info;
+    for(int level = 0; lua_getstack(state, level, &info); level++)
+    {
+        lua_getinfo(state, "Sl", &info);
+        if(info.currentline > 0)
+        {
+            char site[LUA_IDSIZE + 16];
+            snprintf(site, sizeof(site), "%s:%d", info.short_src, info.currentline);
+            return site;
+        }
+    }
+    return "";
+}
+
+void DrawCapture::BeginFrame()
+{
+    mFrameCount++;
+    mCapturing = false; // a frame that never reached EndFrame, like the error screen
+
+    if(!mRequested)
+    {
+        return;
+    }
+
+    mRequested = false;
+    mCapturing = true;
+    mFrame = mFrameCount;
+    mBatches.clear();
+    mCommands.Clear();
+    mScissored = false;
+}
+
+void DrawCapture::EndFrame()
+{
+    if(mCapturing)
+    {
+        mCapturing = false;
+        dsprintf("Captured frame %u, %u batches.\n", mFrame, (unsigned int) mBatches.size());
+    }
+
+    if(mReplays > 0)
+    {
+        Replay();
+    }
+}
+
+//
+// Draws over the frame just drawn, so that frame shows the replays.
+// glFinish either side puts the GPU's time in the measurement.
+//
+void DrawCapture::Replay()
+{
+    const unsigned int count = mReplays;
+    mReplays = 0;
+    if(mCommands.IsEmpty())
+    {
+        dsprintf("Nothing captured to replay.\n");
+        return;
+    }
+
+    glFinish();
+    const unsigned long long start = DDTime::Microseconds();
+    for(unsigned int i = 0; i < count; i++)
+    {
+        GraphicsPipeline::SubmitCommands(mCommands);
+    }
+    glFinish();
+
+    mReplayCount = count;
+    mReplayMs = (DDTime::Microseconds() - start) / 1000.0;
+    dsprintf("Replayed frame %u %u times, %.3fms each.\n", mFrame, count, mReplayMs / count);
+}
+
+void DrawCapture::RecordBatch(const PackedVertex* verts,
+                              unsigned int count,
+                              int reason,
+                              GLenum drawMode,
+                              GLuint textureId,
+                              bool alphaTest,
+                              int blend,
+                              const UVBase& uvBase,
+                              int depthPass,
+                              float depth,
+                              ShaderProgram* shader,
+                              const Vector& camPosition,
+                              const Vector& camScale,
+                              float rotation,
+                              bool deferredSubmit,
+                              const TextureSlots* slots,
+                              const unsigned char* vertSlots)
+{
+    Batch batch;
+    batch.reason = reason;
+    batch.drawMode = drawMode;
+    batch.verts = count;
+    batch.textureId = textureId;
+    batch.textureSlots = slots == NULL ? 0 : slots->count;
+    batch.blend = blend;
+    batch.alphaTest = alphaTest;
+    batch.depthPass = depthPass;
+    batch.scissored = mScissored;
+    batch.scissorX = mScissorX;
+    batch.scissorY = mScissorY;
+    batch.scissorWidth = mScissorWidth;
+    batch.scissorHeight = mScissorHeight;
+    batch.camX = (float) camPosition.x;
+    batch.camY = (float) camPosition.y;
+    batch.scaleX = (float) camScale.x;
+    batch.scaleY = (float) camScale.y;
+    batch.rotation = rotation;
+    batch.deferredSubmit = deferredSubmit;
+    batch.callSite = CallSite();
+    mBatches.push_back(batch);
+
+    mCommands.AppendDraw(verts, count, drawMode, textureId, alphaTest, blend,
+                         uvBase, depthPass, depth, shader, camPosition, camScale, rotation,
+                         slots, vertSlots);
+}
+
+void DrawCapture::RecordScissor(int x, int y, int width, int height)
+{
+    mScissored = true;
+    mScissorX = x;
+    mScissorY = y;
+    mScissorWidth = width;
+    mScissorHeight = height;
+    mCommands.AppendScissor(x, y, width, height);
+}
+
+void DrawCapture::RecordScissorOff()
+{
+    mScissored = false;
+    mCommands.AppendScissorOff();
+}
+
+void DrawCapture::RecordDepthClear()
+{
+    mCommands.AppendDepthClear();
+}
+
+struct CallSiteCost
+{
+    std::string site;
+    unsigned int batches;
+    unsigned int verts;
+    CallSiteCost() : batches(0), verts(0) {}
+};
+
+static bool MoreBatches(const CallSiteCost& a, const CallSiteCost& b)
+{
+    return a.batches > b.batches;
+}
+
+std::string DrawCapture::Json()
+{
+    char numbers[256];
+    unsigned int totalVerts = 0;
+    std::map<std::string, CallSiteCost> sites;
+    std::string batches;
+
+    for(std::vector<Batch>::const_iterator it = mBatches.begin(); it != mBatches.end(); ++it)
+    {
+        // Premultiplied batches share a GL blend with the mode they're made from.
+        const bool premultiplied = it->blend >= BLEND_COUNT;
+        const int blend = it->blend == MULTIPLY_PREMULTIPLIED ? MULTIPLY
+                        : it->blend == SCREEN_PREMULTIPLIED ? SCREEN
+                        : premultiplied ? BLEND
+                        : it->blend;
+
+        if(it != mBatches.begin())
+        {
+            batches += ",";
+        }
+        batches += "{\"reason\":";
+        AppendJsonString(&batches, GraphicsPipeline::FlushReasonStr[it->reason]);
+        batches += ",\"blend\":";
+        AppendJsonString(&batches, GraphicsPipeline::BlendStr[blend]);
+        sprintf(numbers,
+                ",\"mode\":\"%s\",\"verts\":%u,\"texture\":%u,\"textureSlots\":%u,"
+                "\"premultiplied\":%s,\"alphaTest\":%s,\"depthPass\":\"%s\",",
+                it->drawMode == GL_LINES ? "lines"
+                : it->drawMode == QUADS ? "quads"
+                : "triangles",
+                it->verts,
+                (unsigned int) it->textureId,
+                it->textureSlots,
+                premultiplied ? "true" : "false",
+                it->alphaTest ? "true" : "false",
+                DepthPassStr[it->depthPass]);
+        batches += numbers;
+
+        if(it->scissored)
+        {
+            sprintf(numbers, "\"scissor\":[%d,%d,%d,%d],",
+                    it->scissorX, it->scissorY, it->scissorWidth, it->scissorHeight);
+        }
+        else
+        {
+            sprintf(numbers, "\"scissor\":null,");
+        }
+        batches += numbers;
+
+        sprintf(numbers,
+                "\"camera\":{\"x\":%g,\"y\":%g,\"scaleX\":%g,\"scaleY\":%g,\"rotation\":%g},"
+                "\"deferredSubmit\":%s,\"callSite\":",
+                it->camX, it->camY, it->scaleX, it->scaleY, it->rotation,
+                it->deferredSubmit ? "true" : "false");
+        batches += numbers;
+        AppendJsonString(&batches, it->callSite);
+        batches += "}";
+
+        CallSiteCost& site = sites[it->callSite];
+        site.site = it->callSite;
+        site.batches++;
+        site.verts += it->verts;
+        totalVerts += it->verts;
+    }
+
+    std::vector<CallSiteCost> sorted;
+    for(std::map<std::string, CallSiteCost>::const_iterator it = sites.begin(); it != sites.end(); ++it)
+    {
+        sorted.push_back(it->second);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), MoreBatches);
+
+    sprintf(numbers, "{\"frame\":%u,\"drawCalls\":%u,\"verts\":%u,\"batches\":[",
+            mFrame, (unsigned int) mBatches.size(), totalVerts);
+    std::string out(numbers);
+    out += batches;
+    out += "],\"callSites\":[";
+    for(std::vector<CallSiteCost>::const_iterator it = sorted.begin(); it != sorted.end(); ++it)
+    {
+        if(it != sorted.begin())
+        {
+            out += ",";
+        }
+        out += "{\"callSite\":";
+        AppendJsonString(&out, it->site);
+        sprintf(numbers, ",\"batches\":%u,\"verts\":%u}", it->batches, it->verts);
+        out += numbers;
+    }
+    out += "],\"replay\":";
+
+    if(mReplayCount > 0)
+    {
+        sprintf(numbers, "{\"count\":%u,\"totalMs\":%.3f,\"averageMs\":%.3f}}",
+                mReplayCount, mReplayMs, mReplayMs / mReplayCount);
+        out += numbers;
+    }
+    else
+    {
+        out += "null}";
+    }
+    return out;
+}
\ No newline at end of file
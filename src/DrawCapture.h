@@ -0,0 +1,98 @@
+#ifndef DRAWCAPTURE_H
+#define DRAWCAPTURE_H
+
+#include <string>
+#include <vector>
+
+#include "CommandList.h"
+#include "DinodeckGL.h"
+
+class ShaderProgram;
+class Vector;
+struct PackedVertex;
+
+//
+// Lists one frame's batches for the /drawcalls/ web page.
+//
+// Once requested, every batch the next frame flushes is recorded with its
+// state, why it was flushed and the Lua line that was running when it
+// was, so a frame that batches badly shows exactly where. The batches'
+// verts are kept in a CommandList and can be drawn again on a later
+// frame, timed on their own.
+//
+// Outside a capture recording is a flag check.
+//
+class DrawCapture
+{
+public:
+    struct Batch
+    {
+        int reason; // an eFlushReason
+        GLenum drawMode;
+        unsigned int verts;
+        GLuint textureId; // 0 for untextured
+        unsigned int textureSlots; // textures bound, 0 unless it mixes them
+        int blend; // an eBlendMode, what GL draws it with
+        bool alphaTest;
+        int depthPass; // an eDepthPass
+        bool scissored;
+        int scissorX, scissorY, scissorWidth, scissorHeight;
+        float camX, camY;
+        float scaleX, scaleY;
+        float rotation;
+        bool deferredSubmit; // record_frames, drawn in SubmitFrame
+        std::string callSite; // file:line, empty if no script was running
+    };
+
+    static const unsigned int DEFAULT_REPLAYS = 100;
+
+    // The next frame is captured, replacing the last capture.
+    static void Request() { mRequested = true; }
+    // At the end of the next frame the capture is drawn count times.
+    static void RequestReplay(unsigned int count = DEFAULT_REPLAYS) { mReplays = count; }
+    static bool IsCapturing() { return mCapturing; }
+
+    // Main thread, GraphicsPipeline::NewFrame and after SubmitFrame.
+    static void BeginFrame();
+    static void EndFrame();
+
+    static void RecordBatch(const PackedVertex* verts,
+                            unsigned int count,
+                            int reason,
+                            GLenum drawMode,
+                            GLuint textureId,
+                            bool alphaTest,
+                            int blend,
+                            const UVBase& uvBase,
+                            int depthPass,
+                            float depth,
+                            ShaderProgram* shader,
+                            const Vector& camPosition,
+                            const Vector& camScale,
+                            float rotation,
+                            bool deferredSubmit,
+                            const TextureSlots* slots = NULL,
+                            const unsigned char* vertSlots = NULL);
+    // In view pixels, like CommandList's.
+    static void RecordScissor(int x, int y, int width, int height);
+    static void RecordScissorOff();
+    static void RecordDepthClear();
+
+    // { frame, batches: [...], callSites: [...], replay }
+    static std::string Json();
+private:
+    static bool mRequested;
+    static bool mCapturing;
+    static unsigned int mReplays; // requested, 0 for none
+    static unsigned int mFrameCount;
+    static unsigned int mFrame; // captured, 0 before the first
+    static std::vector<Batch> mBatches;
+    static CommandList mCommands;
+    static bool mScissored;
+    static int mScissorX, mScissorY, mScissorWidth, mScissorHeight;
+    static unsigned int mReplayCount; // of the last replay
+    static double mReplayMs;
+    static void Replay();
+};
+
+#endif
\ No newline at end of file
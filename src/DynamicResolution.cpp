@@ -0,0 +1,60 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+
+#include "DDLog.h"
+
+void DynamicResolution::Configure(bool enabled, int minPercent, double targetMs)
+{
+    mEnabled = enabled;
+    mMinPercent = std::min(std::max(minPercent, STEP_PERCENT), 100);
+    mTargetMs = std::max(targetMs, 1.0);
+    mPercent = 100;
+    mOverFrames = 0;
+    mUnderFrames = 0;
+}
+
+void DynamicResolution::Update(double frameMs)
+{
+    if(!mEnabled || frameMs < 0)
+    {
+        return;
+    }
+
+    // Fill cost goes with the pixel count, so a step up from just under
+    // the target would be right back over it.
+    const double headroom = mTargetMs * 0.75;
+
+    if(frameMs > mTargetMs)
+    {
+        mUnderFrames = 0;
+        mOverFrames++;
+        if(mOverFrames >= FRAMES_TO_DROP && mPercent > mMinPercent)
+        {
+            mPercent = std::max(mPercent - STEP_PERCENT, mMinPercent);
+            mOverFrames = 0;
+            dsprintf("Resolution down to %d%%, frame took %.2fms.\n", mPercent, frameMs);
+        }
+    }
+    else if(frameMs < headroom)
+    {
+        mOverFrames = 0;
+        mUnderFrames++;
+        if(mUnderFrames >= FRAMES_TO_RAISE && mPercent < 100)
+        {
+            mPercent = std::min(mPercent + STEP_PERCENT, 100);
+            mUnderFrames = 0;
+            dsprintf("Resolution up to %d%%.\n", mPercent);
+        }
+    }
+    else
+    {
+        mOverFrames = 0;
+        mUnderFrames = 0;
+    }
+}
+
+unsigned int DynamicResolution::Scaled(unsigned int size) const
+{
+    return std::max((size * mPercent + 50) / 100, 1u);
+}
\ No newline at end of file
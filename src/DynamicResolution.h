@@ -0,0 +1,44 @@
+#ifndef DYNAMICRESOLUTION_H
+#define DYNAMICRESOLUTION_H
+
+//
+// Picks how much of the view's resolution the scene is drawn at, from how
+// long frames take on the GPU. The scale moves in steps, down after a few
+// frames over the target and up only after many well under it, so it
+// doesn't flip back and forth between two sizes.
+//
+class DynamicResolution
+{
+    bool mEnabled;
+    int mMinPercent;
+    double mTargetMs;
+    int mPercent; // of the view's width and height
+    int mOverFrames; // in a row over the target
+    int mUnderFrames; // in a row with room to spare
+public:
+    static const int STEP_PERCENT = 10;
+    static const int FRAMES_TO_DROP = 4;
+    static const int FRAMES_TO_RAISE = 60;
+
+    DynamicResolution() :
+        mEnabled(false),
+        mMinPercent(50),
+        mTargetMs(14),
+        mPercent(100),
+        mOverFrames(0),
+        mUnderFrames(0)
+        {}
+
+    // Turning it off goes back to full resolution.
+    void Configure(bool enabled, int minPercent, double targetMs);
+    bool IsEnabled() const { return mEnabled; }
+
+    // Call once a frame. Negative times, from a GPU that can't be timed
+    // yet, are ignored.
+    void Update(double frameMs);
+    float Scale() const { return mPercent / 100.0f; }
+    // Scaled and rounded, at least 1.
+    unsigned int Scaled(unsigned int size) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,303 @@
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <map>
+#include <string.h>
+#if ANDROID
+#elif __APPLE__
+#elif __linux__
+#include <errno.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+#include "DDLog.h"
+
+std::string FileWatcher::Normalize(const std::string& path)
+{
+    std::string out(path);
+    std::replace(out.begin(), out.end(), '\\', '/');
+    if(out.find('/') == std::string::npos)
+    {
+        out = "./" + out;
+    }
+    return out;
+}
+
+std::string FileWatcher::Directory(const std::string& normalized)
+{
+    return normalized.substr(0, normalized.find_last_of('/'));
+}
+
+bool FileWatcher::IsWatched(const std::string& path) const
+{
+    return mWatched.find(Normalize(path)) != mWatched.end();
+}
+
+bool FileWatcher::IsDirty(const std::string& path) const
+{
+    return mDirty.find(Normalize(path)) != mDirty.end();
+}
+
+void FileWatcher::ClearDirty(const std::string& path)
+{
+    mDirty.erase(Normalize(path));
+}
+
+void FileWatcher::OnChanged(const std::string& directory, const std::string& name)
+{
+    std::string path = directory + "/" + name;
+    std::replace(path.begin(), path.end(), '\\', '/');
+    if(mWatched.find(path) != mWatched.end())
+    {
+        mDirty.insert(path);
+    }
+}
+
+void FileWatcher::OnOverflow()
+{
+    // Events were dropped, so anything might have changed.
+    dsprintf("File watcher overflowed, reloading every watched file.\n");
+    mDirty.insert(mWatched.begin(), mWatched.end());
+}
+
+#if ANDROID || __APPLE__
+
+// Android assets live in the apk, there's nothing to watch. Mac polls
+// timestamps until it has an FSEvents version.
+struct FileWatcher::Platform {};
+
+FileWatcher::FileWatcher() : mPlatform(NULL) {}
+FileWatcher::~FileWatcher() {}
+bool FileWatcher::Watch(const std::string& path) { return false; }
+void FileWatcher::Poll() {}
+
+#elif __linux__
+
+struct FileWatcher::Platform
+{
+    int fd;
+    std::map<int, std::string> directories; // by watch descriptor
+};
+
+FileWatcher::FileWatcher() :
+    mPlatform(new Platform())
+{
+    mPlatform->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(mPlatform->fd < 0)
+    {
+        dsprintf("inotify unavailable, polling asset timestamps.\n");
+    }
+}
+
+FileWatcher::~FileWatcher()
+{
+    if(mPlatform->fd >= 0)
+    {
+        close(mPlatform->fd);
+    }
+    delete mPlatform;
+}
+
+bool FileWatcher::Watch(const std::string& path)
+{
+    if(mPlatform->fd < 0)
+    {
+        return false;
+    }
+
+    std::string normalized = Normalize(path);
+    std::string directory = Directory(normalized);
+    // Watching a directory twice hands back the same descriptor.
+    int watch = inotify_add_watch(mPlatform->fd, directory.c_str(),
+                                  IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO
+                                  | IN_CREATE | IN_DELETE);
+    if(watch < 0)
+    {
+        return false;
+    }
+
+    mPlatform->directories[watch] = directory;
+    mWatched.insert(normalized);
+    return true;
+}
+
+void FileWatcher::Poll()
+{
+    if(mPlatform->fd < 0)
+    {
+        return;
+    }
+
+    char buffer[16 * 1024] __attribute__((aligned(__alignof__(inotify_event))));
+    for(;;)
+    {
+        ssize_t size = read(mPlatform->fd, buffer, sizeof(buffer));
+        if(size <= 0)
+        {
+            break; // EAGAIN, nothing more queued
+        }
+
+        for(char* at = buffer; at < buffer + size;)
+        {
+            const inotify_event* event = (const inotify_event*) at;
+            if(event->mask & IN_Q_OVERFLOW)
+            {
+                OnOverflow();
+            }
+            else if(event->len > 0)
+            {
+                std::map<int, std::string>::iterator directory =
+                    mPlatform->directories.find(event->wd);
+                if(directory != mPlatform->directories.end())
+                {
+                    OnChanged(directory->second, event->name);
+                }
+            }
+            at += sizeof(inotify_event) + event->len;
+        }
+    }
+}
+
+#else
+
+struct WatchedDirectory
+{
+    std::string path;
+    HANDLE handle;
+    OVERLAPPED overlapped;
+    DWORD buffer[16 * 1024 / sizeof(DWORD)]; // DWORD aligned, as required
+};
+
+struct FileWatcher::Platform
+{
+    std::map<std::string, WatchedDirectory*> directories;
+};
+
+static bool IssueRead(WatchedDirectory* directory)
+{
+    memset(&directory->overlapped, 0, sizeof(OVERLAPPED));
+    return ReadDirectoryChangesW
+    (
+        directory->handle,
+        directory->buffer,
+        sizeof(directory->buffer),
+        FALSE, // not subdirectories, each is watched itself
+        FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE,
+        NULL,
+        &directory->overlapped,
+        NULL
+    ) != 0;
+}
+
+FileWatcher::FileWatcher() :
+    mPlatform(new Platform())
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+    for(std::map<std::string, WatchedDirectory*>::iterator it = mPlatform->directories.begin();
+        it != mPlatform->directories.end(); ++it)
+    {
+        // Wait out the cancel, the read writes into the buffer until then.
+        WatchedDirectory* directory = it->second;
+        DWORD bytes = 0;
+        CancelIo(directory->handle);
+        GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, TRUE);
+        CloseHandle(directory->handle);
+        delete directory;
+    }
+    delete mPlatform;
+}
+
+bool FileWatcher::Watch(const std::string& path)
+{
+    std::string normalized = Normalize(path);
+    std::string name = Directory(normalized);
+
+    if(mPlatform->directories.find(name) == mPlatform->directories.end())
+    {
+        HANDLE handle = CreateFileA
+        (
+            name.c_str(),
+            FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL,
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+            NULL
+        );
+
+        if(handle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        WatchedDirectory* directory = new WatchedDirectory();
+        directory->path = name;
+        directory->handle = handle;
+        if(!IssueRead(directory))
+        {
+            CloseHandle(handle);
+            delete directory;
+            return false;
+        }
+        mPlatform->directories[name] = directory;
+    }
+
+    mWatched.insert(normalized);
+    return true;
+}
+
+void FileWatcher::Poll()
+{
+    for(std::map<std::string, WatchedDirectory*>::iterator it = mPlatform->directories.begin();
+        it != mPlatform->directories.end(); ++it)
+    {
+        WatchedDirectory* directory = it->second;
+        DWORD bytes = 0;
+        if(!GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, FALSE))
+        {
+            if(GetLastError() != ERROR_IO_INCOMPLETE)
+            {
+                OnOverflow();
+                IssueRead(directory);
+            }
+            continue;
+        }
+
+        if(bytes == 0)
+        {
+            // More changed than fit in the buffer.
+            OnOverflow();
+        }
+        else
+        {
+            const char* at = (const char*) directory->buffer;
+            for(;;)
+            {
+                const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*) at;
+                char name[MAX_PATH * 4];
+                int length = WideCharToMultiByte(CP_UTF8, 0,
+                                                 info->FileName,
+                                                 info->FileNameLength / sizeof(WCHAR),
+                                                 name, sizeof(name) - 1,
+                                                 NULL, NULL);
+                name[length] = '\0';
+                OnChanged(directory->path, name);
+
+                if(info->NextEntryOffset == 0)
+                {
+                    break;
+                }
+                at += info->NextEntryOffset;
+            }
+        }
+        IssueRead(directory);
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <set>
+#include <string>
+
+//
+// Tells the asset store which files changed, from change events the OS
+// sends for their directories, so a reload doesn't stat every asset.
+// Uses ReadDirectoryChangesW on Windows and inotify on Linux. Elsewhere,
+// or when a directory can't be watched (packaged data), Watch returns
+// false and the file's timestamp is polled as before.
+//
+class FileWatcher
+{
+    struct Platform;
+    Platform* mPlatform;
+    std::set<std::string> mWatched;
+    std::set<std::string> mDirty;
+
+    // Same form as the paths events are built from, dir/name.
+    static std::string Normalize(const std::string& path);
+    static std::string Directory(const std::string& normalized);
+    void OnChanged(const std::string& directory, const std::string& name);
+    void OnOverflow();
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    bool Watch(const std::string& path);
+    bool IsWatched(const std::string& path) const;
+
+    // Picks up the changes since the last call.
+    void Poll();
+    bool IsDirty(const std::string& path) const;
+    void ClearDirty(const std::string& path);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,127 @@
+#ifndef FLOAT4_H
+#define FLOAT4_H
+
+//
+// Four floats worked on at once, for batch kernels on the render path.
+// SSE on x86, NEON where the compiler targets it, plain floats otherwise.
+//
+// Vector and Matrix stay doubles, they're what Lua sees. Code that
+// converts to floats for GL anyway can do its sums in these.
+//
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define DD_FLOAT4_SSE 1
+    #include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    #define DD_FLOAT4_NEON 1
+    #include <arm_neon.h>
+#endif
+
+class Float4
+{
+public:
+#if DD_FLOAT4_SSE
+    __m128 mValue;
+    Float4(__m128 value) : mValue(value) {}
+#elif DD_FLOAT4_NEON
+    float32x4_t mValue;
+    Float4(float32x4_t value) : mValue(value) {}
+#else
+    float mValue[4];
+#endif
+
+    Float4() {}
+    Float4(float x, float y, float z, float w)
+    {
+#if DD_FLOAT4_SSE
+        mValue = _mm_setr_ps(x, y, z, w);
+#elif DD_FLOAT4_NEON
+        const float values[4] = { x, y, z, w };
+        mValue = vld1q_f32(values);
+#else
+        mValue[0] = x;
+        mValue[1] = y;
+        mValue[2] = z;
+        mValue[3] = w;
+#endif
+    }
+
+    static Float4 Broadcast(float value)
+    {
+#if DD_FLOAT4_SSE
+        return Float4(_mm_set1_ps(value));
+#elif DD_FLOAT4_NEON
+        return Float4(vdupq_n_f32(value));
+#else
+        return Float4(value, value, value, value);
+#endif
+    }
+
+    // out needn't be aligned.
+    void Store(float* out) const
+    {
+#if DD_FLOAT4_SSE
+        _mm_storeu_ps(out, mValue);
+#elif DD_FLOAT4_NEON
+        vst1q_f32(out, mValue);
+#else
+        out[0] = mValue[0];
+        out[1] = mValue[1];
+        out[2] = mValue[2];
+        out[3] = mValue[3];
+#endif
+    }
+
+    Float4 operator +(const Float4& right) const
+    {
+#if DD_FLOAT4_SSE
+        return Float4(_mm_add_ps(mValue, right.mValue));
+#elif DD_FLOAT4_NEON
+        return Float4(vaddq_f32(mValue, right.mValue));
+#else
+        return Float4(mValue[0] + right.mValue[0],
+                      mValue[1] + right.mValue[1],
+                      mValue[2] + right.mValue[2],
+                      mValue[3] + right.mValue[3]);
+#endif
+    }
+
+    Float4 operator -(const Float4& right) const
+    {
+#if DD_FLOAT4_SSE
+        return Float4(_mm_sub_ps(mValue, right.mValue));
+#elif DD_FLOAT4_NEON
+        return Float4(vsubq_f32(mValue, right.mValue));
+#else
+        return Float4(mValue[0] - right.mValue[0],
+                      mValue[1] - right.mValue[1],
+                      mValue[2] - right.mValue[2],
+                      mValue[3] - right.mValue[3]);
+#endif
+    }
+
+    Float4 operator *(const Float4& right) const
+    {
+#if DD_FLOAT4_SSE
+        return Float4(_mm_mul_ps(mValue, right.mValue));
+#elif DD_FLOAT4_NEON
+        return Float4(vmulq_f32(mValue, right.mValue));
+#else
+        return Float4(mValue[0] * right.mValue[0],
+                      mValue[1] * right.mValue[1],
+                      mValue[2] * right.mValue[2],
+                      mValue[3] * right.mValue[3]);
+#endif
+    }
+
+    // add + left * right
+    static Float4 MultiplyAdd(const Float4& add, const Float4& left, const Float4& right)
+    {
+#if DD_FLOAT4_NEON
+        return Float4(vmlaq_f32(add.mValue, left.mValue, right.mValue));
+#else
+        return add + left * right;
+#endif
+    }
+};
+
+#endif
\ No newline at end of file
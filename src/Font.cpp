@@ -0,0 +1,15 @@
+#include "Font.h"
+
+#include "BakedFont.h"
+
+#ifdef ANDROID
+#include <FTGL/ftgles.h>
+#else
+#include <FTGL/ftgl.h>
+#endif
+
+Font::~Font()
+{
+    delete mFreeType;
+    delete mBaked;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include <stddef.h>
+
+class BakedFont;
+class FTTextureFont;
+
+//
+// A font text is laid out with. Either a TTF that FTGL rasterizes glyph
+// by glyph as they're first used, or a BakedFont made offline. FormatText
+// works with both, the rest of the engine only passes Fonts around.
+// The Font owns whichever it holds.
+//
+class Font
+{
+    FTTextureFont* mFreeType;
+    BakedFont* mBaked;
+public:
+    explicit Font(FTTextureFont* font) : mFreeType(font), mBaked(NULL) {}
+    explicit Font(BakedFont* font) : mFreeType(NULL), mBaked(font) {}
+    ~Font();
+
+    // NULL if the font is baked.
+    FTTextureFont* FreeType() const { return mFreeType; }
+    // NULL if the font is FreeType's.
+    const BakedFont* Baked() const { return mBaked; }
+};
+
+#endif
\ No newline at end of file
@@ -1,10 +1,16 @@
 #include "FormatText.h"
+#include <algorithm>
 #include <assert.h>
 #include <cmath>
+#include <string.h>
 
 #include "DinodeckGL.h"
+#include "GraphicsPipeline.h"
 #include "Vector.h"
 #include "DDLog.h"
+#include "BakedFont.h"
+#include "Font.h"
+#include "UTF8.h"
 
 
 // TEMP
@@ -22,62 +28,436 @@
 #include "FTGL/../FTVector.h"
 
 
-float FormatText::GetKern(FTTextureFont* font, int current, int next)
+//
+// Adds the quad FTTextureGlyph::Render would have drawn.
+//
+static void AddGlyph(TextLayout* layout,
+                     FTTextureGlyphImpl* glyph,
+                     float x, float y)
 {
-    FTTextureFontImpl* impl = (FTTextureFontImpl*) font->GetImpl();
+    float width = glyph->GetWidth();
+    float height = glyph->GetHeight();
+
+    if(width == 0 || height == 0)
+    {
+        return; // White space
+    }
+
+    // Distance field glyphs have a margin around the bitmap.
+    float margin = glyph->GetMargin();
+    FTPoint corner = glyph->GetCorner();
+    FTPoint uvTopLeft = glyph->GetUV(0);
+    FTPoint uvBottomRight = glyph->GetUV(1);
+    width += margin * 2;
+    height += margin * 2;
+
+    LayoutGlyph layoutGlyph;
+    layoutGlyph.penX = x;
+    layoutGlyph.penY = y;
+    layoutGlyph.left = corner.Xf() - margin;
+    layoutGlyph.top = corner.Yf() + margin;
+    layoutGlyph.right = layoutGlyph.left + width;
+    layoutGlyph.bottom = layoutGlyph.top - height;
+    layoutGlyph.u0 = uvTopLeft.Xf();
+    layoutGlyph.v0 = uvTopLeft.Yf();
+    layoutGlyph.u1 = uvBottomRight.Xf();
+    layoutGlyph.v1 = uvBottomRight.Yf();
+    layoutGlyph.textureId = glyph->GetTextureId();
+    layoutGlyph.distanceField = margin > 0;
+    layout->push_back(layoutGlyph);
+}
+
+void FormatText::PushLayout(GraphicsPipeline* pipeline,
+                            const TextLayout& layout,
+                            float x,
+                            float y,
+                            const Vector& colour,
+                            unsigned int count)
+{
+    assert(pipeline);
+
+    TextLayout::const_iterator end = layout.begin() + std::min(count, (unsigned int) layout.size());
+    for(TextLayout::const_iterator it = layout.begin(); it != end; ++it)
+    {
+        // Glyph corners are whole pixels so rounding the pen is enough.
+        float penX = floor(x + it->penX);
+        float penY = floor(y + it->penY);
+        pipeline->PushGlyph((GLuint) it->textureId,
+                            penX + it->left, penY + it->top,
+                            penX + it->right, penY + it->bottom,
+                            it->u0, it->v0, it->u1, it->v1,
+                            colour,
+                            it->distanceField);
+    }
+}
+
+float FormatText::LayoutRadius(const TextLayout& layout)
+{
+    float furthest = 0;
+    for(TextLayout::const_iterator it = layout.begin(); it != layout.end(); ++it)
+    {
+        float x = std::max(std::abs(it->penX + it->left),
+                           std::abs(it->penX + it->right));
+        float y = std::max(std::abs(it->penY + it->top),
+                           std::abs(it->penY + it->bottom));
+        furthest = std::max(furthest, x * x + y * y);
+    }
+    return sqrt(furthest);
+}
+
+//
+// Distance field glyphs are stored at a quarter of the face size and
+// stay sharp when scaled up, so one face size serves every ScaleText.
+//
+void FormatText::MakeDistanceField(Font* font)
+{
+    assert(font);
+    if(font->Baked())
+    {
+        return;
+    }
+    FTTextureFontImpl* impl = (FTTextureFontImpl*) font->FreeType()->GetImpl();
+    impl->SetDistanceField(DISTANCE_FIELD_SCALE, DISTANCE_FIELD_SPREAD);
+}
+
+//
+// Rasterizing a glyph the first time it's drawn causes a hitch, so fonts
+// can load the characters they'll need up front.
+//
+void FormatText::PrewarmGlyphs(Font* font, const char* charset)
+{
+    assert(font);
+    assert(charset);
+    if(font->Baked())
+    {
+        return;
+    }
+    FTTextureFontImpl* impl = (FTTextureFontImpl*) font->FreeType()->GetImpl();
+
+    if(strcmp(charset, "ascii") == 0)
+    {
+        for(unsigned int c = 32; c < 127; c++)
+        {
+            LoadGlyph(font, impl, c);
+        }
+        return;
+    }
+
+    for(int i = 0; charset[i] != '\0';)
+    {
+        LoadGlyph(font, impl, UTF8::Decode(charset, &i));
+    }
+}
+
+std::vector<Font*> FormatText::mDirtyFonts;
+
+bool FormatText::LoadGlyph(Font* font, FTTextureFontImpl* impl, unsigned int charCode)
+{
+    bool had = impl->HasDirtyGlyphs();
+    bool loaded = impl->CheckGlyph(charCode);
+    if(!had && impl->HasDirtyGlyphs())
+    {
+        mDirtyFonts.push_back(font);
+    }
+    return loaded;
+}
+
+unsigned int FormatText::UploadGlyphs()
+{
+    unsigned int bytes = 0;
+    for(std::vector<Font*>::iterator it = mDirtyFonts.begin(); it != mDirtyFonts.end(); ++it)
+    {
+        FTTextureFontImpl* impl = (FTTextureFontImpl*) (*it)->FreeType()->GetImpl();
+        bytes += impl->UploadDirtyGlyphs();
+    }
+    mDirtyFonts.clear();
+    return bytes;
+}
+
+void FormatText::GetGlyphAtlasStats(Font* font, GlyphAtlasStats* outStats)
+{
+    assert(font);
+    assert(outStats);
+
+    const BakedFont* baked = font->Baked();
+    if(baked)
+    {
+        outStats->glyphs = baked->GlyphCount();
+        outStats->pages = baked->TextureId() != 0 ? 1 : 0;
+        outStats->pageWidth = baked->TextureWidth();
+        outStats->pageHeight = baked->TextureHeight();
+        outStats->occupancy = 1;
+        return;
+    }
+
+    FTTextureFontImpl* impl = (FTTextureFontImpl*) font->FreeType()->GetImpl();
+
+    outStats->glyphs = impl->GetGlyphsLoaded();
+    outStats->pages = impl->GetTextureCount();
+    outStats->pageWidth = impl->GetTextureWidth();
+    outStats->pageHeight = impl->GetTextureHeight();
+    outStats->occupancy = 0;
+
+    if(outStats->pages == 0 || outStats->pageHeight == 0)
+    {
+        return;
+    }
+
+    // Glyphs are filled in row by row, so every page but the last is full.
+    float lastPageUsed = std::min(impl->GetGlyphRowY() + impl->GetCellHeight(),
+                                  outStats->pageHeight);
+    float used = ((outStats->pages - 1) * outStats->pageHeight) + lastPageUsed;
+    outStats->occupancy = used / (float)(outStats->pages * outStats->pageHeight);
+}
+
+unsigned int FormatText::GlyphAtlasBytes(Font* font)
+{
+    GlyphAtlasStats stats;
+    GetGlyphAtlasStats(font, &stats);
+    // FTGL's and baked glyph textures are GL_ALPHA, a byte a texel.
+    return stats.pages * stats.pageWidth * stats.pageHeight;
+}
+
+//
+// Layout asks for the same advances over and over, so for the first 256
+// character codes they're read from FTGL once and kept in flat tables.
+// A character's row is filled in the first time the character is used.
+//
+struct FormatText::FontMetrics
+{
+    static const int SIZE = 256;
+    signed char state[SIZE]; // 0 not loaded yet, 1 has a glyph, -1 doesn't
+    float width[SIZE];
+    float* advance[SIZE]; // advance[current][next], kerning included
+
+    FontMetrics()
+    {
+        memset(state, 0, sizeof(state));
+        memset(width, 0, sizeof(width));
+        memset(advance, 0, sizeof(advance));
+    }
+
+    ~FontMetrics()
+    {
+        for(int i = 0; i < SIZE; i++)
+        {
+            delete [] advance[i];
+        }
+    }
+};
+
+std::map<Font*, FormatText::FontMetrics*> FormatText::mFontMetrics;
+
+FormatText::FontMetrics* FormatText::GetMetrics(Font* font)
+{
+    std::map<Font*, FontMetrics*>::iterator
+        it = mFontMetrics.find(font);
+    if(it != mFontMetrics.end())
+    {
+        return it->second;
+    }
+
+    FontMetrics* metrics = new FontMetrics();
+    mFontMetrics[font] = metrics;
+    return metrics;
+}
+
+bool FormatText::LoadMetrics(Font* font, FontMetrics* metrics, int c)
+{
+    if(metrics->state[c] != 0)
+    {
+        return metrics->state[c] > 0;
+    }
+
+    if(!GlyphWidth(font, c, &metrics->width[c]))
+    {
+        metrics->state[c] = -1;
+        return false;
+    }
+
+    // Only the current glyph needs to be loaded to get the advance.
+    float* row = new float[FontMetrics::SIZE];
+    for(int next = 0; next < FontMetrics::SIZE; next++)
+    {
+        row[next] = GlyphAdvance(font, c, next);
+    }
+    metrics->advance[c] = row;
+    metrics->state[c] = 1;
+    return true;
+}
+
+bool FormatText::GlyphWidth(Font* font, int c, float* outWidth)
+{
+    const BakedFont* baked = font->Baked();
+    if(baked)
+    {
+        const BakedFont::Glyph* glyph = baked->Find(c);
+        if(glyph == NULL)
+        {
+            return false;
+        }
+        *outWidth = glyph->width;
+        return true;
+    }
+
+    FTTextureFontImpl* impl = (FTTextureFontImpl*) font->FreeType()->GetImpl();
     FTGlyphContainer* glyphList = impl->GetGlyphList();
+    FTCharmap* charMap = glyphList->GetCharmap();
+    FTVector<FTGlyph*>* glyphVector = glyphList->GetGlyphVector();
+    unsigned int charCode = (unsigned int) c;
 
-    // CheckGlyph also loads the data into a cache
-    // so it needs to be called here.
-    if(!impl->CheckGlyph(current) || !impl->CheckGlyph(next))
+    // This isn't just a check! It's lazy loader
+    if(!LoadGlyph(font, impl, charCode))
     {
-        return 0;
+        return false;
     }
 
-    return glyphList->Advance(current, next);
+    unsigned int index = charMap->GlyphListIndex(charCode);
+    FTTextureGlyphImpl* glyph = (FTTextureGlyphImpl*) (*glyphVector)[index]->GetImpl();
+    *outWidth = glyph->GetWidth();
+    return true;
 }
 
-float FormatText::CharPixelWidth(FTTextureFont* font, int c)
+// Only the current glyph needs to be loaded.
+float FormatText::GlyphAdvance(Font* font, int current, int next)
 {
-    FTTextureFontImpl* impl = (FTTextureFontImpl*) font->GetImpl();
+    const BakedFont* baked = font->Baked();
+    if(baked)
+    {
+        return baked->Advance(current, next);
+    }
+
+    FTTextureFontImpl* impl = (FTTextureFontImpl*) font->FreeType()->GetImpl();
+    return impl->GetGlyphList()->Advance(current, next);
+}
+
+bool FormatText::AddCharacter(TextLayout* layout, Font* font, int c, float x, float y)
+{
+    const BakedFont* baked = font->Baked();
+    if(baked)
+    {
+        // A character the font wasn't baked with is skipped.
+        const BakedFont::Glyph* glyph = baked->Find(c);
+        if(glyph == NULL || glyph->left == glyph->right || glyph->top == glyph->bottom)
+        {
+            return true;
+        }
+
+        LayoutGlyph layoutGlyph;
+        layoutGlyph.penX = x;
+        layoutGlyph.penY = y;
+        layoutGlyph.left = glyph->left;
+        layoutGlyph.top = glyph->top;
+        layoutGlyph.right = glyph->right;
+        layoutGlyph.bottom = glyph->bottom;
+        layoutGlyph.u0 = glyph->u0;
+        layoutGlyph.v0 = glyph->v0;
+        layoutGlyph.u1 = glyph->u1;
+        layoutGlyph.v1 = glyph->v1;
+        layoutGlyph.textureId = baked->TextureId();
+        layoutGlyph.distanceField = baked->IsDistanceField();
+        layout->push_back(layoutGlyph);
+        return true;
+    }
+
+    FTTextureFontImpl* impl = (FTTextureFontImpl*) font->FreeType()->GetImpl();
     FTGlyphContainer* glyphList = impl->GetGlyphList();
     FTCharmap* charMap = glyphList->GetCharmap();
     FTVector<FTGlyph*>* glyphVector = glyphList->GetGlyphVector();
     unsigned int charCode = (unsigned int) c;
 
     // This isn't just a check! It's lazy loader
-    if(!impl->CheckGlyph(charCode))
+    if(!LoadGlyph(font, impl, charCode))
     {
-        return 0;
+        return false;
     }
 
     unsigned int index = charMap->GlyphListIndex(charCode);
     FTTextureGlyphImpl* glyph = (FTTextureGlyphImpl*) (*glyphVector)[index]->GetImpl();
+    AddGlyph(layout, glyph, x, y);
+    return true;
+}
+
+void FormatText::ForgetFont(Font* font)
+{
+    mDirtyFonts.erase(std::remove(mDirtyFonts.begin(), mDirtyFonts.end(), font),
+                      mDirtyFonts.end());
 
-    return glyph->GetWidth();
+    std::map<Font*, FontMetrics*>::iterator
+        it = mFontMetrics.find(font);
+    if(it != mFontMetrics.end())
+    {
+        delete it->second;
+        mFontMetrics.erase(it);
+    }
 }
 
-float FormatText::GetFaceMaxHeight(FTTextureFont* font)
+float FormatText::GetKern(Font* font, int current, int next)
 {
-    FTTextureFontImpl* impl = (FTTextureFontImpl*) font->GetImpl();
+    if(current >= 0 && current < FontMetrics::SIZE &&
+       next >= 0 && next < FontMetrics::SIZE)
+    {
+        FontMetrics* metrics = GetMetrics(font);
+        if(!LoadMetrics(font, metrics, current) ||
+           !LoadMetrics(font, metrics, next))
+        {
+            return 0;
+        }
+        return metrics->advance[current][next];
+    }
+
+    // Both glyphs are loaded, as the tables above do.
+    float ignore = 0;
+    if(!GlyphWidth(font, current, &ignore) || !GlyphWidth(font, next, &ignore))
+    {
+        return 0;
+    }
+
+    return GlyphAdvance(font, current, next);
+}
+
+float FormatText::CharPixelWidth(Font* font, int c)
+{
+    if(c >= 0 && c < FontMetrics::SIZE)
+    {
+        FontMetrics* metrics = GetMetrics(font);
+        if(!LoadMetrics(font, metrics, c))
+        {
+            return 0;
+        }
+        return metrics->width[c];
+    }
+
+    float width = 0;
+    GlyphWidth(font, c, &width);
+    return width;
+}
+
+float FormatText::GetFaceMaxHeight(Font* font)
+{
+    if(font->Baked())
+    {
+        return font->Baked()->LineHeight();
+    }
+    FTTextureFontImpl* impl = (FTTextureFontImpl*) font->FreeType()->GetImpl();
     return impl->GetMaxHeight();
 }
 
 
-float FormatText::MeasureTextWidth(FTTextureFont* font, const char* text)
+float FormatText::MeasureTextWidth(Font* font, const char* text)
 {
     float width = 0;
     int prevC = -1;
-    for (int i = 0; text[i] != '\0'; i++)
+    for (int i = 0; text[i] != '\0';)
     {
-        int c = text[i];
+        int c = UTF8::Decode(text, &i);
         if(prevC != -1)
         {
             float kern = FormatText::GetKern(font, prevC, c);
             width += kern;
         }
 
-        if(text[i + 1] == '\0')
+        if(text[i] == '\0')
         {
             width += FormatText::CharPixelWidth(font, c);
 
@@ -97,165 +477,123 @@ float FormatText::MeasureTextWidth(FTTextureFont* font, const char* text)
     return width;//     return width
 }
 
-void FormatText::RenderLine(FTTextureFont* font,
+void FormatText::RenderLine(TextLayout* layout,
+                Font* font,
                 float x, float y,
                 const char* text,
                 int start, int finish)
 {
     assert((start == 0 && finish == 0) || start < finish);
-
-    FTTextureFontImpl* impl = (FTTextureFontImpl*) font->GetImpl();
-    FTGlyphContainer* glyphList = impl->GetGlyphList();
-    FTCharmap* charMap = glyphList->GetCharmap();
-    FTVector<FTGlyph*>* glyphVector = glyphList->GetGlyphVector();
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_TEXTURE_2D);
-
-#ifndef ANDROID
-    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT);
-    FTTextureGlyphImpl::ResetActiveTexture();
-#endif
-
-#ifdef ANDROID
-    impl->PreRender();
-#endif
+    assert(layout);
 
     int prevC = -1;
-    for(int i = start; i < finish; i++)
+    for(int i = start; i < finish;)
     {
-        int c = text[i];
+        int c = UTF8::Decode(text, &i);
 
         if(prevC != -1)
         {
             x += GetKern(font, prevC, c);
         }
 
-        { // Actually do the render.
-            unsigned int charCode = (unsigned int) c;
-
-            // This isn't just a check! It's lazy loader
-            if(!impl->CheckGlyph(charCode))
-            {
-                return;
-            }
-
-            unsigned int index = charMap->GlyphListIndex(charCode);
-
-            //FTTextureGlyphImpl::ResetActiveTexture();
-            (*glyphVector)[index]->Render(FTPoint(x, y), FTGL::RENDER_ALL);
+        if(!AddCharacter(layout, font, c, x, y))
+        {
+            return;
         }
 
         prevC = c;
     }
 
-#ifndef ANDROID
-    glPopAttrib();
-#endif
-
-#ifdef ANDROID
-    impl->PostRender();
-#endif
-
     return;
 }
 
-int FormatText::CountLines
+//
+// Each line starts where the last finished, so every character is
+// measured once, apart from a word that didn't fit being measured again
+// at the start of the next line.
+//
+void FormatText::BreakLines
 (
-    FTTextureFont* font,
+    Font* font,
     const char* text,
     float maxwidth,
-    float* outMaxLineWidth
+    TextLines* outLines
 )
 {
-    assert(outMaxLineWidth);
-    int lineCount = 0;
+    assert(outLines);
+    outLines->clear();
     int lineEnd = 0;
-    (*outMaxLineWidth) = -1;
     do
     {
-        int outStart = 0;
-        float outPixelWidth = 0;
+        TextLine line;
         NextLine(font, text, lineEnd, maxwidth,
-                    &outStart,
-                    &lineEnd,
-                    &outPixelWidth);
-
-        (*outMaxLineWidth) = std::max((*outMaxLineWidth), outPixelWidth);
-
-        lineCount++;
+                    &line.start,
+                    &line.finish,
+                    &line.pixelWidth);
+        lineEnd = line.finish;
+        outLines->push_back(line);
     } while (text[lineEnd] != '\0');
-    return lineCount;
 }
 
-void FormatText::PushTextWrapped(
-        FTTextureFont* font,
-        float x,
-        float y,
+void FormatText::LayoutTextWrapped(
+        Font* font,
         const char* text,
-        const Vector& colour,
+        const TextLines& lines,
         AlignX::Enum alignX,
         AlignY::Enum alignY,
-        float maxwidth)
+        TextLayout* outLayout)
 {
-    float ignore = -1;
+    assert(outLayout);
+    float x = 0;
+    float y = 0;
     float yOffset = 0;
     if(alignY == AlignY::Bottom)
     {
-        float lines = (float) CountLines(font, text, maxwidth, &ignore)  - 1;
-        yOffset = ((float)lines) * FormatText::GetFaceMaxHeight(font);
+        float lineCount = (float) lines.size() - 1;
+        yOffset = lineCount * FormatText::GetFaceMaxHeight(font);
     }
     else if(alignY == AlignY::Center)
     {
-        float lines = (float) CountLines(font, text, maxwidth, &ignore)  - 1;
-        lines *= 0.5;
+        float lineCount = (float) lines.size() - 1;
+        lineCount *= 0.5;
         float lineHeight = FormatText::GetFaceMaxHeight(font);
-        yOffset = (lines *  lineHeight) - lineHeight*0.25;
+        yOffset = (lineCount *  lineHeight) - lineHeight*0.25;
     }
     else
     {
         yOffset = -GetFaceMaxHeight(font) * 0.75;
     }
 
-    int lineEnd = 0;
-    do
+    for(TextLines::const_iterator line = lines.begin(); line != lines.end(); ++line)
     {
-        int outStart = 0;
-        float outPixelWidth = 0;
-        //dsprintf("\tNextline cursor[%d] char[%c]\n", lineEnd, text[lineEnd]);
-        NextLine(font, text, lineEnd, maxwidth,
-                    &outStart,
-                    &lineEnd,
-                    &outPixelWidth);
-        //dsprintf("Output: outStart[%d] outFinish[%d], outPixelWidth[%f]\n",
-        //     outStart, lineEnd, outPixelWidth);
         float xPos = x;
         if(alignX == AlignX::Right)
         {
-            xPos -= outPixelWidth;
+            xPos -= line->pixelWidth;
         }
         else if(alignX == AlignX::Center)
         {
-            xPos -= outPixelWidth / 2;
+            xPos -= line->pixelWidth / 2;
         }
 
-        RenderLine(font, xPos, y + yOffset, text, outStart, lineEnd);
+        RenderLine(outLayout, font, xPos, y + yOffset, text, line->start, line->finish);
         y = y - GetFaceMaxHeight(font);
-    } while (text[lineEnd] != '\0');
+    }
 
     return;
 }
 
 
-void FormatText::PushText(FTTextureFont* font,
-                        float x,
-                        float y,
-                        const char* text,
-                        const Vector& colour,
-                        AlignX::Enum alignX,
-                        AlignY::Enum alignY)
+void FormatText::LayoutText(Font* font,
+                            const char* text,
+                            AlignX::Enum alignX,
+                            AlignY::Enum alignY,
+                            TextLayout* outLayout)
 {
+    assert(outLayout);
+    float x = 0;
+    float y = 0;
+
     // Apply X alignment local x = self:ApplyAlignX(x, text)
     {
 
@@ -288,66 +626,26 @@ void FormatText::PushText(FTTextureFont* font,
     }
 
 
-    FTTextureFontImpl* impl = (FTTextureFontImpl*) font->GetImpl();
-    FTGlyphContainer* glyphList = impl->GetGlyphList();
-    FTCharmap* charMap = glyphList->GetCharmap();
-    FTVector<FTGlyph*>* glyphVector = glyphList->GetGlyphVector();
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_TEXTURE_2D);
-
-#ifndef ANDROID
-    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT);
-    FTTextureGlyphImpl::ResetActiveTexture();
-#endif
-
-
-#ifdef ANDROID
-    impl->PreRender();
-#endif
-
-
     int prevC = -1; // local prevC = nil
-    for (int i = 0; text[i] != '\0'; i++)
+    for (int i = 0; text[i] != '\0';)
     {
-        int c = text[i];
+        int c = UTF8::Decode(text, &i);
 
         if(prevC != -1)
         {
             x += FormatText::GetKern(font, prevC, c);
         }
 
-        { // Actually do the render
-            unsigned int charCode = (unsigned int) c;
-
-            // This isn't just a check! It's lazy loader
-            if(!impl->CheckGlyph(charCode))
-            {
-                return;
-            }
-
-            unsigned int index = charMap->GlyphListIndex(charCode);
-
-
-
-            (*glyphVector)[index]->Render(FTPoint(x, y), FTGL::RENDER_ALL);
+        if(!AddCharacter(outLayout, font, c, x, y))
+        {
+            return;
         }
 
         prevC = c;
     }
-
-#ifndef ANDROID
-    glPopAttrib();
-#endif
-
-#ifdef ANDROID
-    impl->PostRender();
-#endif
-
 }
 
-void FormatText::MeasureText(FTTextureFont* font, const char* text, float maxwidth, Vector* sizeOut)
+void FormatText::MeasureText(Font* font, const char* text, float maxwidth, Vector* sizeOut)
 {
     if(maxwidth < 1)
     {
@@ -358,20 +656,33 @@ void FormatText::MeasureText(FTTextureFont* font, const char* text, float maxwid
     }
     else
     {
-        float outLongestLine = -1;
-        float lines = (float) CountLines(font, text, maxwidth, &outLongestLine);
-        float width = outLongestLine;
-        if(lines == 1)
-        {
-            width = MeasureTextWidth(font, text);
-        }
-        float height = lines * FormatText::GetFaceMaxHeight(font);
-        sizeOut->SetXyzw(width, height, 0, 0);
+        TextLines lines;
+        BreakLines(font, text, maxwidth, &lines);
+        MeasureLines(font, text, lines, sizeOut);
         return;
     }
 }
 
-bool FormatText::IsWhiteSpace(char c)
+void FormatText::MeasureLines(Font* font,
+                              const char* text,
+                              const TextLines& lines,
+                              Vector* sizeOut)
+{
+    float width = -1;
+    for(TextLines::const_iterator line = lines.begin(); line != lines.end(); ++line)
+    {
+        width = std::max(width, line->pixelWidth);
+    }
+
+    if(lines.size() == 1)
+    {
+        width = MeasureTextWidth(font, text);
+    }
+    float height = lines.size() * FormatText::GetFaceMaxHeight(font);
+    sizeOut->SetXyzw(width, height, 0, 0);
+}
+
+bool FormatText::IsWhiteSpace(int c)
 {
     if(c == ' ' || c == '\t')
     {
@@ -381,7 +692,7 @@ bool FormatText::IsWhiteSpace(char c)
 }
 
 // Returns the cursor position in the text
-void FormatText::NextLine(FTTextureFont* font,
+void FormatText::NextLine(Font* font,
                           const char* text,
                           unsigned int cursor,
                           float maxwidth,
@@ -419,9 +730,11 @@ void FormatText::NextLine(FTTextureFont* font,
     float pixelWidth = 0;
     float pixelWidthStart = 0;
 
-    for (int i = cursor; text[i] != '\0'; i++)
+    // i is the byte the character starts at, next the one after it.
+    for (int i = cursor; text[i] != '\0';)
     {
-        int c = text[i];
+        int next = i;
+        int c = UTF8::Decode(text, &next);
 
         if(IsWhiteSpace(c))
         {
@@ -451,7 +764,8 @@ void FormatText::NextLine(FTTextureFont* font,
         }
 
         prevC = c;
-        finish++;
+        finish = (unsigned int) next;
+        i = next;
     }
 
 
@@ -1,47 +1,155 @@
 #ifndef FORMATTEXT_H
 #define FORMATTEXT_H
 
+#include <map>
+#include <vector>
+
 #include "DDTextAlign.h"
 
-class FTTextureFont;
+class Font;
+class FTTextureFontImpl;
+class GraphicsPipeline;
 class Vector;
 
+//
+// How full a font's glyph textures are.
+//
+struct GlyphAtlasStats
+{
+    int glyphs;         // rasterized so far
+    int pages;          // glyph textures
+    int pageWidth;
+    int pageHeight;
+    float occupancy;    // 0-1, rows of the pages in use
+};
+
+//
+// A glyph quad placed by the text layout, relative to where the text is
+// drawn. The quad is offset from the rounded down pen position, in the
+// same way FTTextureGlyph::Render places it.
+//
+struct LayoutGlyph
+{
+    float penX;
+    float penY;
+    float left;
+    float top;
+    float right;
+    float bottom;
+    float u0;
+    float v0;
+    float u1;
+    float v1;
+    unsigned int textureId;
+    bool distanceField;
+};
+
+typedef std::vector<LayoutGlyph> TextLayout;
+
+//
+// A line of wrapped text. Start and finish are byte offsets into it,
+// finish is one past the line's last character.
+//
+struct TextLine
+{
+    int start;
+    int finish;
+    float pixelWidth;
+};
+
+typedef std::vector<TextLine> TextLines;
+
 class FormatText
 {
+    // Advances and widths for the ASCII and Latin-1 character codes.
+    struct FontMetrics;
+    static std::map<Font*, FontMetrics*> mFontMetrics;
+    static FontMetrics* GetMetrics(Font* font);
+    static bool LoadMetrics(Font* font, FontMetrics* metrics, int c);
+    // Uncached, straight from FTGL or the baked font.
+    static bool GlyphWidth(Font* font, int c, float* outWidth);
+    static float GlyphAdvance(Font* font, int current, int next);
+    // False if FTGL couldn't load the glyph, layout stops there.
+    static bool AddCharacter(TextLayout* layout, Font* font, int c, float x, float y);
+    // FTGL fonts with glyphs loaded but not yet in their textures.
+    static std::vector<Font*> mDirtyFonts;
+    static bool LoadGlyph(Font* font, FTTextureFontImpl* impl, unsigned int charCode);
 public:
-    static float GetKern(FTTextureFont* font, int current, int next);
-    static float CharPixelWidth(FTTextureFont* font, int c);
-    static float GetFaceMaxHeight(FTTextureFont* font);
+    static const int DISTANCE_FIELD_SCALE = 4;  // face pixels per texel
+    static const int DISTANCE_FIELD_SPREAD = 2; // in texels
+
+    // Call before any glyphs are loaded, i.e. before PrewarmGlyphs.
+    // Baked fonts are distance fields if they were baked as one.
+    static void MakeDistanceField(Font* font);
+    // Charset of "ascii" is short hand for the printable ascii characters.
+    // Baked fonts have every glyph they'll ever have already.
+    static void PrewarmGlyphs(Font* font, const char* charset);
+    static void GetGlyphAtlasStats(Font* font, GlyphAtlasStats* outStats);
+    // GL memory of the font's glyph textures.
+    static unsigned int GlyphAtlasBytes(Font* font);
+    // Copies glyphs loaded since the last call into their textures, only
+    // the regions that changed. Call before drawing text. Binds textures.
+    // Returns the bytes uploaded.
+    static unsigned int UploadGlyphs();
+
+    // Call before a font is destroyed.
+    static void ForgetFont(Font* font);
+
+    static float GetKern(Font* font, int current, int next);
+    static float CharPixelWidth(Font* font, int c);
+    static float GetFaceMaxHeight(Font* font);
 
-    // Still using FTGL pipeline, probably be nicer in grahpics pipeline.
-    static void PushText
+    // Glyphs are read from FTGL's textures and placed relative to the
+    // origin, so the layout can be kept and drawn anywhere.
+    static void LayoutText
     (
-        FTTextureFont* font,
-        float x,
-        float y,
+        Font* font,
         const char* text,
-        const Vector& colour,
         AlignX::Enum alignX,
-        AlignY::Enum alignY
+        AlignY::Enum alignY,
+        TextLayout* outLayout
+    );
+
+    // Breaks the whole text into lines in one walk. Layout and measuring
+    // of wrapped text both start from the lines, so they can be kept.
+    static void BreakLines
+    (
+        Font* font,
+        const char* text,
+        float maxwidth,
+        TextLines* outLines
+    );
+
+    static void LayoutTextWrapped
+    (
+        Font* font,
+        const char* text,
+        const TextLines& lines,
+        AlignX::Enum alignX,
+        AlignY::Enum alignY,
+        TextLayout* outLayout
     );
 
-    static void PushTextWrapped
+    // Pushed to the pipeline as quads, so text batches with everything else.
+    // Only the first count glyphs are pushed, all of them by default.
+    static void PushLayout
     (
-        FTTextureFont* font,
+        GraphicsPipeline* pipeline,
+        const TextLayout& layout,
         float x,
         float y,
-        const char* text,
         const Vector& colour,
-        AlignX::Enum alignX,
-        AlignY::Enum alignY,
-        float maxwidth
+        unsigned int count = 0xFFFFFFFF
     );
 
-    static bool IsWhiteSpace(char c);
+    // Distance from the origin to the furthest glyph corner, font space.
+    static float LayoutRadius(const TextLayout& layout);
+
+    static bool IsWhiteSpace(int c); // a code point
 
     static void NextLine
     (
-        FTTextureFont* font,
+        Font* font,
         const char* text,
         unsigned int cursor,
         float maxwidth,
@@ -52,7 +160,8 @@ public:
 
     static void RenderLine
     (
-        FTTextureFont* font,
+        TextLayout* layout,
+        Font* font,
         float x, float y,
         const char* text,
         int start, int finish
@@ -60,23 +169,24 @@ public:
 
     static float MeasureTextWidth
     (
-        FTTextureFont* font,
+        Font* font,
         const char* text
     );
 
-    static int CountLines
+    static void MeasureText
     (
-        FTTextureFont* font,
+        Font* font,
         const char* text,
         float maxwidth,
-        float* outMaxLineWidth
+        Vector* sizeOut
     );
 
-    static void MeasureText
+    // The size of text already broken into lines.
+    static void MeasureLines
     (
-        FTTextureFont* font,
+        Font* font,
         const char* text,
-        float maxwidth,
+        const TextLines& lines,
         Vector* sizeOut
     );
 };
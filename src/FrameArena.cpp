@@ -0,0 +1,60 @@
+#include "FrameArena.h"
+
+#include "DDLog.h"
+
+char* FrameArena::mBlock = NULL;
+size_t FrameArena::mSize = 0;
+size_t FrameArena::mUsed = 0;
+size_t FrameArena::mHighWater = 0;
+std::vector<char*> FrameArena::mSpills;
+size_t FrameArena::mSpilledBytes = 0;
+
+void* FrameArena::Allocate(size_t bytes)
+{
+    bytes = (bytes + ALIGNMENT - 1) & ~((size_t) ALIGNMENT - 1);
+
+    if(mBlock == NULL)
+    {
+        mSize = DEFAULT_BYTES;
+        mBlock = new char[mSize];
+    }
+
+    if(mUsed + bytes <= mSize)
+    {
+        void* memory = mBlock + mUsed;
+        mUsed += bytes;
+        return memory;
+    }
+
+    // new[] is aligned for anything, so spills don't need rounding.
+    char* spill = new char[bytes];
+    mSpills.push_back(spill);
+    mSpilledBytes += bytes;
+    return spill;
+}
+
+void FrameArena::Reset()
+{
+    const size_t frameBytes = mUsed + mSpilledBytes;
+    if(frameBytes > mHighWater)
+    {
+        mHighWater = frameBytes;
+    }
+
+    if(!mSpills.empty())
+    {
+        for(unsigned int i = 0; i < mSpills.size(); i++)
+        {
+            delete[] mSpills[i];
+        }
+        mSpills.clear();
+
+        // Room for this frame twice over.
+        delete[] mBlock;
+        mSize = frameBytes * 2;
+        mBlock = new char[mSize];
+        dsprintf("Frame arena grown to %ukb.\n", (unsigned int) (mSize / 1024));
+    }
+    mUsed = 0;
+    mSpilledBytes = 0;
+}
\ No newline at end of file
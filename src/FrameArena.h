@@ -0,0 +1,83 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <new>
+#include <stddef.h>
+#include <vector>
+
+//
+// Memory for the main thread's temporaries that only live within a
+// frame. Allocating bumps a pointer and freeing does nothing, everything
+// is let go at once when Main resets the arena at the top of the frame.
+//
+// A frame that doesn't fit spills into extra blocks. On the next reset
+// they're freed and the arena grows to hold the whole frame, so after the
+// first few frames it's one block and no malloc.
+//
+// Containers use it through FrameAllocator. Never keep one past the
+// frame it was made in.
+//
+//    FrameVector<float>::Type points;
+//    ReadPoints(state, 2, &points);
+//
+class FrameArena
+{
+public:
+    static const unsigned int DEFAULT_BYTES = 64 * 1024;
+    static const unsigned int ALIGNMENT = 16;
+
+    static void* Allocate(size_t bytes);
+    static void Reset();
+    static size_t Capacity() { return mSize; }
+    // Most used by a single frame.
+    static size_t HighWater() { return mHighWater; }
+private:
+    static char* mBlock;
+    static size_t mSize;
+    static size_t mUsed;
+    static size_t mHighWater;
+    static std::vector<char*> mSpills;
+    static size_t mSpilledBytes;
+};
+
+template<class T>
+class FrameAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template<class U> struct rebind { typedef FrameAllocator<U> other; };
+
+    FrameAllocator() {}
+    template<class U> FrameAllocator(const FrameAllocator<U>&) {}
+
+    pointer address(reference value) const { return &value; }
+    const_pointer address(const_reference value) const { return &value; }
+    pointer allocate(size_type count, const void* = 0)
+    {
+        return (pointer) FrameArena::Allocate(count * sizeof(T));
+    }
+    void deallocate(pointer, size_type) {}
+    size_type max_size() const { return ((size_type) -1) / sizeof(T); }
+    void construct(pointer p, const T& value) { new ((void*) p) T(value); }
+    void destroy(pointer p) { p->~T(); }
+};
+
+template<class T, class U>
+bool operator==(const FrameAllocator<T>&, const FrameAllocator<U>&) { return true; }
+template<class T, class U>
+bool operator!=(const FrameAllocator<T>&, const FrameAllocator<U>&) { return false; }
+
+template<class T>
+struct FrameVector
+{
+    typedef std::vector<T, FrameAllocator<T> > Type;
+};
+
+#endif
\ No newline at end of file
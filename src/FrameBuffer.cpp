@@ -1,5 +1,6 @@
 #include "FrameBuffer.h"
 
+#include <algorithm>
 #include <assert.h>
 
 #include "DinodeckGL.h"
@@ -9,6 +10,8 @@ const unsigned int NUM_BUFFERS = 1;
 
 void FrameBuffer::DestroyBuffer()
 {
+	DestroyMultisampled();
+
 	// Only reset the id, if it exists
 	if(mBufferId != 0)
 	{
@@ -21,9 +24,116 @@ void FrameBuffer::DestroyBuffer()
 		glDeleteTextures(NUM_BUFFERS, &mTextureId);
 		mTextureId = 0;
 	}
+
+	if(mDepthId != 0)
+	{
+		glDeleteRenderbuffers(NUM_BUFFERS, &mDepthId);
+		mDepthId = 0;
+	}
 }
 
-void FrameBuffer::Reset(unsigned width, unsigned height)
+void FrameBuffer::Forget()
+{
+	mBufferId = 0;
+	mTextureId = 0;
+	mDepthId = 0;
+	mResolveId = 0;
+	mColourId = 0;
+}
+
+void FrameBuffer::DestroyMultisampled()
+{
+	if(mResolveId == 0)
+	{
+		return;
+	}
+
+	// The texture's buffer goes back to being the one drawn into.
+	glDeleteFramebuffers(NUM_BUFFERS, &mBufferId);
+	glDeleteRenderbuffers(NUM_BUFFERS, &mColourId);
+	mBufferId = mResolveId;
+	mResolveId = 0;
+	mColourId = 0;
+	if(mDepthId != 0)
+	{
+		glDeleteRenderbuffers(NUM_BUFFERS, &mDepthId);
+		mDepthId = 0;
+	}
+}
+
+void FrameBuffer::AttachDepth(unsigned width, unsigned height, int samples)
+{
+	glGenRenderbuffers(NUM_BUFFERS, &mDepthId);
+	glBindRenderbuffer(GL_RENDERBUFFER, mDepthId);
+#if !(ANDROID || __APPLE__)
+	if(samples > 0)
+	{
+		glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples,
+		                                 GL_DEPTH_COMPONENT16, width, height);
+	}
+	else
+#endif
+	{
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, width, height);
+	}
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER,
+	                          GL_DEPTH_ATTACHMENT,
+	                          GL_RENDERBUFFER,
+	                          mDepthId);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+}
+
+//
+// Moves drawing to a multisampled colour buffer, the texture's buffer
+// becomes what it resolves into. Leaves the new buffer bound.
+//
+bool FrameBuffer::CreateMultisampled(unsigned width, unsigned height, bool alpha,
+                                     int* samples)
+{
+#if ANDROID || __APPLE__
+	// GLES1 and the legacy Apple headers have no multisampled buffers.
+	return false;
+#else
+	if(!(GLEE_VERSION_3_0 || GLEE_ARB_framebuffer_object))
+	{
+		return false;
+	}
+
+	GLint maxSamples = 0;
+	glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+	*samples = std::min(*samples, (int) maxSamples);
+	if(*samples <= 0)
+	{
+		return false;
+	}
+
+	mResolveId = mBufferId;
+	glGenFramebuffers(NUM_BUFFERS, &mBufferId);
+	glBindFramebuffer(GL_FRAMEBUFFER, mBufferId);
+
+	glGenRenderbuffers(NUM_BUFFERS, &mColourId);
+	glBindRenderbuffer(GL_RENDERBUFFER, mColourId);
+	glRenderbufferStorageMultisample(GL_RENDERBUFFER, *samples,
+	                                 alpha ? GL_RGBA8 : GL_RGB8, width, height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER,
+	                          GL_COLOR_ATTACHMENT0,
+	                          GL_RENDERBUFFER,
+	                          mColourId);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		dsprintf("%d samples unavailable, drawing without multisampling.\n", *samples);
+		DestroyMultisampled();
+		glBindFramebuffer(GL_FRAMEBUFFER, mBufferId);
+		return false;
+	}
+	return true;
+#endif
+}
+
+void FrameBuffer::Reset(unsigned width, unsigned height, bool alpha, bool depth,
+                        int samples)
 {
 	//dsprintf("FrameBuffer Reset: width [%d] height: [%d]\n",
 	//         width, height);
@@ -40,11 +150,12 @@ void FrameBuffer::Reset(unsigned width, unsigned height)
 	 	glBindTexture(GL_TEXTURE_2D, mTextureId);
 
 		const int LEVEL_OF_DETAIL = 0;
+		const GLenum format = alpha ? GL_RGBA : GL_RGB;
 		glTexImage2D(GL_TEXTURE_2D,
 					 LEVEL_OF_DETAIL,
-					 GL_RGB,
+					 format,
 					 width, height,
-					 0, GL_RGB, GL_UNSIGNED_BYTE, 0);
+					 0, format, GL_UNSIGNED_BYTE, 0);
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -58,6 +169,14 @@ void FrameBuffer::Reset(unsigned width, unsigned height)
 						GL_TEXTURE_2D,
 	                    mTextureId, 0);
 
+	// Depth goes with whichever buffer is drawn into.
+	const bool multisampled = samples > 0
+	                          && CreateMultisampled(width, height, alpha, &samples);
+	if(depth)
+	{
+		AttachDepth(width, height, multisampled ? samples : 0);
+	}
+
 	// 4. Set list of draw buffers (not really sure what this is!)
 	GLenum DrawBuffers[1] = {GL_COLOR_ATTACHMENT0};
 	glDrawBuffers(1, DrawBuffers); // "1" is the size of DrawBuffers
@@ -84,3 +203,44 @@ void FrameBuffer::Disable()
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+bool FrameBuffer::BlitToWindow(unsigned srcWidth, unsigned srcHeight,
+                               unsigned dstWidth, unsigned dstHeight)
+{
+#if ANDROID || __APPLE__
+	// GLES1 and the legacy Apple headers have no blit.
+	return false;
+#else
+	if(mBufferId == 0 || !(GLEE_VERSION_3_0 || GLEE_ARB_framebuffer_object))
+	{
+		return false;
+	}
+
+	// Multisampled buffers can't be scaled from, they're resolved first.
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, mResolveId != 0 ? mResolveId : mBufferId);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	// Nearest to match the texture's filtering on the quad.
+	glBlitFramebuffer(0, 0, srcWidth, srcHeight,
+	                  0, 0, dstWidth, dstHeight,
+	                  GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	Disable();
+	return true;
+#endif
+}
+
+void FrameBuffer::Resolve(unsigned width, unsigned height)
+{
+#if !(ANDROID || __APPLE__)
+	if(mResolveId == 0)
+	{
+		return;
+	}
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, mBufferId);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mResolveId);
+	glBlitFramebuffer(0, 0, width, height,
+	                  0, 0, width, height,
+	                  GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, mResolveId);
+#endif
+}
+
@@ -7,19 +7,49 @@ class FrameBuffer
 {
 	GLuint mBufferId;
 	GLuint mTextureId;
+	GLuint mDepthId; // render buffer, 0 without depth
+	// When multisampled, mBufferId draws into mColourId and Resolve
+	// copies it into the texture's buffer.
+	GLuint mResolveId;
+	GLuint mColourId;
 public:
 	FrameBuffer() :
 		mBufferId(0),
-		mTextureId(0)
+		mTextureId(0),
+		mDepthId(0),
+		mResolveId(0),
+		mColourId(0)
 		{}
 	~FrameBuffer() { DestroyBuffer(); }
-	void Reset(unsigned width, unsigned height);
+	// With alpha the texture is RGBA, for targets drawn over other things.
+	// With depth a 16 bit depth buffer is attached, for the opaque pass.
+	// Samples above 0 multisample where the GL can, up to its limit.
+	void Reset(unsigned width, unsigned height, bool alpha = false, bool depth = false,
+	           int samples = 0);
+	bool IsMultisampled() const { return mResolveId != 0; }
+	// Drops the ids without deleting them, they went with the context.
+	// Call when the OpenGL context has been lost, before Reset.
+	void Forget();
+
+	// Averages the samples drawn so far into the texture and leaves its
+	// buffer bound, so it can be read. Nothing happens unless multisampled.
+	void Resolve(unsigned width, unsigned height);
 
 	void Enable();
 	void Disable();
+
+	// Copies the buffer into the window, scaling it to fit.
+	// False if the GL can't blit, the caller draws a textured quad instead.
+	bool BlitToWindow(unsigned srcWidth, unsigned srcHeight,
+	                  unsigned dstWidth, unsigned dstHeight);
 	int TextureId() const { return mTextureId; }
 private:
 	void DestroyBuffer();
+	// On the bound buffer.
+	void AttachDepth(unsigned width, unsigned height, int samples);
+	// Samples are lowered to what the GL allows.
+	bool CreateMultisampled(unsigned width, unsigned height, bool alpha, int* samples);
+	void DestroyMultisampled();
 };
 
 #endif
@@ -0,0 +1,567 @@
+#include "FrameCapture.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "DDLog.h"
+#include "DDTime.h"
+#include "zlib.h"
+#include "Zones.h"
+
+static void PutU32(unsigned char* out, unsigned int value)
+{
+    out[0] = (unsigned char) (value >> 24);
+    out[1] = (unsigned char) (value >> 16);
+    out[2] = (unsigned char) (value >> 8);
+    out[3] = (unsigned char) value;
+}
+
+static bool WriteChunk(FILE* file, const char* type, const unsigned char* data, unsigned int length)
+{
+    unsigned char header[8];
+    PutU32(header, length);
+    memcpy(header + 4, type, 4);
+
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, header + 4, 4);
+    if(length > 0)
+    {
+        crc = crc32(crc, data, length);
+    }
+    unsigned char footer[4];
+    PutU32(footer, (unsigned int) crc);
+
+    return fwrite(header, 1, 8, file) == 8
+        && (length == 0 || fwrite(data, 1, length, file) == length)
+        && fwrite(footer, 1, 4, file) == 4;
+}
+
+// RGBA, last row first, to RGB first row first.
+static void FlipRow(const unsigned char* rgba, unsigned int width, unsigned int height,
+                    unsigned int row, unsigned char* rgb)
+{
+    const unsigned char* source = rgba + (height - 1 - row) * width * 4;
+    for(unsigned int x = 0; x < width; x++)
+    {
+        rgb[0] = source[0];
+        rgb[1] = source[1];
+        rgb[2] = source[2];
+        rgb += 3;
+        source += 4;
+    }
+}
+
+static bool WritePng(const char* path, const unsigned char* rgba,
+                     unsigned int width, unsigned int height)
+{
+    // Each row starts with its filter, 0 leaves it as it is.
+    const unsigned int rowBytes = width * 3 + 1;
+    std::vector<unsigned char> rows(rowBytes * height);
+    for(unsigned int y = 0; y < height; y++)
+    {
+        rows[y * rowBytes] = 0;
+        FlipRow(rgba, width, height, y, &rows[y * rowBytes + 1]);
+    }
+
+    uLongf compressedBytes = compressBound(rows.size());
+    std::vector<unsigned char> compressed(compressedBytes);
+    if(compress2(&compressed[0], &compressedBytes, &rows[0], rows.size(), Z_DEFAULT_COMPRESSION) != Z_OK)
+    {
+        return false;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if(!file)
+    {
+        return false;
+    }
+
+    static const unsigned char signature[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+    unsigned char header[13];
+    PutU32(header, width);
+    PutU32(header + 4, height);
+    header[8] = 8;  // bits per channel
+    header[9] = 2;  // RGB
+    header[10] = 0; // deflate
+    header[11] = 0; // filtered per row
+    header[12] = 0; // not interlaced
+
+    bool ok = fwrite(signature, 1, 8, file) == 8
+           && WriteChunk(file, "IHDR", header, sizeof(header))
+           && WriteChunk(file, "IDAT", &compressed[0], (unsigned int) compressedBytes)
+           && WriteChunk(file, "IEND", NULL, 0);
+    ok = (fclose(file) == 0) && ok;
+    return ok;
+}
+
+static bool WriteRaw(FILE* file, const unsigned char* rgba,
+                     unsigned int width, unsigned int height)
+{
+    std::vector<unsigned char> row(width * 3);
+    for(unsigned int y = 0; y < height; y++)
+    {
+        FlipRow(rgba, width, height, y, &row[0]);
+        if(fwrite(&row[0], 1, row.size(), file) != row.size())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+FrameCapture::FrameCapture() :
+    mFrameCount(0),
+    mRecordFile(NULL),
+    mRecordWidth(0),
+    mRecordHeight(0),
+    mRecordFrames(0),
+    mRecordDropped(0),
+    mRecordStart(0),
+    mRecording(false),
+    mTrace(Trace::AddThread("capture")),
+    mStopping(false)
+{
+    for(unsigned int i = 0; i < PIXEL_BUFFERS; i++)
+    {
+        mSlots[i].buffer = 0;
+        mSlots[i].bytes = 0;
+        mSlots[i].pending = false;
+        mSlots[i].readFrame = 0;
+        mSlots[i].width = 0;
+        mSlots[i].height = 0;
+        mSlots[i].record = false;
+    }
+
+    if(!mThread.Start(&FrameCapture::CaptureMain, this))
+    {
+        // Queue falls back to writing there and then.
+        dsprintf("Frame capture thread failed to start.\n");
+        mStopping = true;
+    }
+}
+
+FrameCapture::~FrameCapture()
+{
+    // Frames still in the pixel buffers are lost, the GL may be gone.
+    StopRecording();
+    if(mRecordFile)
+    {
+        QueueEnd();
+    }
+
+    {
+        ScopedLock lock(mMutex);
+        mStopping = true;
+        mWake.Signal();
+    }
+    mThread.Join();
+    DestroyBuffers();
+}
+
+void FrameCapture::CaptureMain(void* capture)
+{
+    static_cast<FrameCapture*>(capture)->Run();
+}
+
+void FrameCapture::Run()
+{
+    mMutex.Lock();
+    for(;;)
+    {
+        while(mQueue.empty() && !mStopping)
+        {
+            mWake.Wait(mMutex);
+        }
+
+        // Whatever's queued when stopping is still written.
+        if(mQueue.empty())
+        {
+            break;
+        }
+
+        // Pushes only go on the back, so the front stays put unlocked.
+        Frame& frame = mQueue.front();
+        mMutex.Unlock();
+        const unsigned long long start = DDTime::Microseconds();
+        Write(frame);
+        Trace::Record(mTrace, "capture", start, DDTime::Microseconds());
+        mMutex.Lock();
+
+        if(mSpare.size() < PIXEL_BUFFERS && !frame.pixels.empty())
+        {
+            mSpare.push_back(std::vector<unsigned char>());
+            mSpare.back().swap(frame.pixels);
+        }
+        mQueue.pop_front();
+    }
+    mMutex.Unlock();
+}
+
+void FrameCapture::Write(Frame& frame)
+{
+    if(frame.end)
+    {
+        fclose(frame.file);
+    }
+    else if(frame.file)
+    {
+        // A short write shows up as a short file, the recording carries on.
+        WriteRaw(frame.file, &frame.pixels[0], frame.width, frame.height);
+    }
+    else if(WritePng(frame.path.c_str(), &frame.pixels[0], frame.width, frame.height))
+    {
+        dsprintf("Captured [%s]\n", frame.path.c_str());
+    }
+    else
+    {
+        dsprintf("Capture [%s] wasn't written.\n", frame.path.c_str());
+    }
+}
+
+void FrameCapture::CaptureFrame(const std::string& path)
+{
+    mStills.push_back(path);
+}
+
+bool FrameCapture::StartRecording(const std::string& path)
+{
+    if(mRecording || mRecordFile)
+    {
+        return false;
+    }
+
+    mRecordFile = fopen(path.c_str(), "wb");
+    if(!mRecordFile)
+    {
+        dsprintf("Can't record to [%s].\n", path.c_str());
+        return false;
+    }
+
+    // The size is fixed by the first frame.
+    mRecordPath = path;
+    mRecordWidth = 0;
+    mRecordHeight = 0;
+    mRecordFrames = 0;
+    mRecordDropped = 0;
+    mRecordStart = DDTime::Microseconds();
+    mRecording = true;
+    return true;
+}
+
+void FrameCapture::StopRecording()
+{
+    if(!mRecording)
+    {
+        return;
+    }
+
+    mRecording = false;
+    if(!HasPendingRecording())
+    {
+        QueueEnd();
+    }
+}
+
+bool FrameCapture::HasPendingRecording() const
+{
+    for(unsigned int i = 0; i < PIXEL_BUFFERS; i++)
+    {
+        if(mSlots[i].pending && mSlots[i].record)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FrameCapture::Update(unsigned int width, unsigned int height)
+{
+    if(width == 0 || height == 0)
+    {
+        return;
+    }
+    DD_PROFILE_ZONE("capture");
+    mFrameCount++;
+
+    // Only map what the GPU should be finished with.
+    for(unsigned int i = 0; i < PIXEL_BUFFERS; i++)
+    {
+        Slot& slot = mSlots[i];
+        if(slot.pending && mFrameCount - slot.readFrame >= READBACK_LATENCY)
+        {
+            Map(slot);
+        }
+    }
+
+    if(!mRecording && mRecordFile && !HasPendingRecording())
+    {
+        QueueEnd();
+    }
+
+    if(mRecording && mRecordWidth == 0)
+    {
+        mRecordWidth = width;
+        mRecordHeight = height;
+    }
+
+    bool record = mRecording;
+    if(record && (width != mRecordWidth || height != mRecordHeight))
+    {
+        // Raw frames can't change size, wait for the window to go back.
+        mRecordDropped++;
+        record = false;
+    }
+
+    if(!record && mStills.empty())
+    {
+        return;
+    }
+
+    Slot* slot = NULL;
+    Slot* oldest = NULL;
+    for(unsigned int i = 0; i < PIXEL_BUFFERS && !slot; i++)
+    {
+        if(!mSlots[i].pending)
+        {
+            slot = &mSlots[i];
+        }
+        else if(!oldest || mSlots[i].readFrame < oldest->readFrame)
+        {
+            oldest = &mSlots[i];
+        }
+    }
+
+    if(!slot)
+    {
+        Map(*oldest);
+        slot = oldest;
+    }
+
+    slot->record = record;
+    if(!mStills.empty())
+    {
+        slot->path = mStills.front();
+        mStills.pop_front();
+    }
+    Read(*slot, width, height);
+}
+
+bool FrameCapture::UsePixelBuffers()
+{
+#if DINODECK_PBO_UPLOADS
+    if(!(GLEE_VERSION_2_1 || GLEE_ARB_pixel_buffer_object))
+    {
+        return false;
+    }
+
+    if(mSlots[0].buffer == 0)
+    {
+        for(unsigned int i = 0; i < PIXEL_BUFFERS; i++)
+        {
+            glGenBuffers(1, &mSlots[i].buffer);
+            mSlots[i].bytes = 0;
+        }
+    }
+    return mSlots[PIXEL_BUFFERS - 1].buffer != 0;
+#else
+    return false;
+#endif
+}
+
+void FrameCapture::Read(Slot& slot, unsigned int width, unsigned int height)
+{
+    const unsigned int bytes = width * height * 4;
+    slot.width = width;
+    slot.height = height;
+
+#if DINODECK_PBO_UPLOADS
+    if(UsePixelBuffers())
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        if(slot.bytes != bytes)
+        {
+            glBufferData(GL_PIXEL_PACK_BUFFER, bytes, NULL, GL_STREAM_READ);
+            slot.bytes = bytes;
+        }
+        // Returns once it's queued, the copy happens when the GPU gets to it.
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot.pending = true;
+        slot.readFrame = mFrameCount;
+        return;
+    }
+#endif
+
+    std::vector<unsigned char> pixels;
+    TakeSpare(&pixels);
+    pixels.resize(bytes);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+    Deliver(slot, pixels);
+}
+
+void FrameCapture::Map(Slot& slot)
+{
+    assert(slot.pending);
+#if DINODECK_PBO_UPLOADS
+    std::vector<unsigned char> pixels;
+    TakeSpare(&pixels);
+    pixels.resize(slot.width * slot.height * 4);
+
+    bool mapped = false;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const void* source = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if(source != NULL)
+    {
+        memcpy(&pixels[0], source, pixels.size());
+        mapped = (glUnmapBuffer(GL_PIXEL_PACK_BUFFER) == GL_TRUE);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if(!mapped)
+    {
+        pixels.clear();
+    }
+    Deliver(slot, pixels);
+#endif
+}
+
+void FrameCapture::Deliver(Slot& slot, std::vector<unsigned char>& pixels)
+{
+    if(pixels.empty())
+    {
+        dsprintf("Frame capture read back failed.\n");
+        if(slot.record)
+        {
+            mRecordDropped++;
+        }
+    }
+    else
+    {
+        if(!slot.path.empty())
+        {
+            std::vector<unsigned char> still;
+            if(slot.record)
+            {
+                still = pixels; // the recording keeps the original
+            }
+            else
+            {
+                still.swap(pixels);
+            }
+            Queue(still, slot.width, slot.height, slot.path, NULL);
+        }
+
+        if(slot.record && mRecordFile)
+        {
+            if(Queue(pixels, slot.width, slot.height, "", mRecordFile))
+            {
+                mRecordFrames++;
+            }
+            else
+            {
+                mRecordDropped++;
+            }
+        }
+    }
+
+    slot.pending = false;
+    slot.record = false;
+    slot.path.clear();
+}
+
+void FrameCapture::TakeSpare(std::vector<unsigned char>* pixels)
+{
+    ScopedLock lock(mMutex);
+    if(!mSpare.empty())
+    {
+        pixels->swap(mSpare.back());
+        mSpare.pop_back();
+    }
+}
+
+bool FrameCapture::Queue(std::vector<unsigned char>& pixels,
+                         unsigned int width,
+                         unsigned int height,
+                         const std::string& path,
+                         FILE* file)
+{
+    ScopedLock lock(mMutex);
+    if(file && mQueue.size() >= MAX_QUEUED)
+    {
+        return false;
+    }
+
+    mQueue.push_back(Frame());
+    Frame& frame = mQueue.back();
+    frame.pixels.swap(pixels);
+    frame.width = width;
+    frame.height = height;
+    frame.path = path;
+    frame.file = file;
+    frame.end = false;
+
+    if(mStopping)
+    {
+        Write(frame);
+        mQueue.pop_back();
+        return true;
+    }
+    mWake.Signal();
+    return true;
+}
+
+void FrameCapture::QueueEnd()
+{
+    assert(mRecordFile);
+    const double seconds = (DDTime::Microseconds() - mRecordStart) / 1000000.0;
+    dsprintf("Recorded [%s], %u frames of %ux%u over %.1fs, %u dropped.\n",
+             mRecordPath.c_str(), mRecordFrames, mRecordWidth, mRecordHeight,
+             seconds, mRecordDropped);
+    if(mRecordFrames > 0 && seconds > 0)
+    {
+        dsprintf("\tffmpeg -f rawvideo -pixel_format rgb24 -video_size %ux%u"
+                 " -framerate %.2f -i %s out.mp4\n",
+                 mRecordWidth, mRecordHeight, mRecordFrames / seconds, mRecordPath.c_str());
+    }
+
+    ScopedLock lock(mMutex);
+    Frame end;
+    end.width = 0;
+    end.height = 0;
+    end.file = mRecordFile;
+    end.end = true;
+    mRecordFile = NULL;
+
+    if(mStopping)
+    {
+        Write(end);
+        return;
+    }
+    mQueue.push_back(end);
+    mWake.Signal();
+}
+
+void FrameCapture::DestroyBuffers(bool live)
+{
+    for(unsigned int i = 0; i < PIXEL_BUFFERS; i++)
+    {
+        if(live && mSlots[i].buffer != 0)
+        {
+            glDeleteBuffers(1, &mSlots[i].buffer);
+        }
+        mSlots[i].buffer = 0;
+        mSlots[i].bytes = 0;
+        mSlots[i].pending = false;
+        mSlots[i].record = false;
+        mSlots[i].path.clear();
+    }
+}
+
+void FrameCapture::Reset()
+{
+    DestroyBuffers(false);
+    if(!mRecording && mRecordFile)
+    {
+        QueueEnd();
+    }
+}
\ No newline at end of file
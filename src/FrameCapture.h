@@ -0,0 +1,117 @@
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <stdio.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "DinodeckGL.h"
+#include "Threading.h"
+#include "Trace.h"
+
+//
+// Screenshots and recordings of the window.
+//
+// Each captured frame is read into one of a ring of pixel buffer objects
+// and only mapped READBACK_LATENCY frames later, once the GPU is done
+// with it, so reading it back doesn't stall the pipeline. Frames are
+// encoded and written on the capture thread. Stills are PNGs and
+// recordings are raw RGB24 frames, top row first, for ffmpeg's rawvideo.
+//
+// Without pixel buffer objects frames are read straight away, which
+// waits for the GPU to finish the frame.
+//
+class FrameCapture
+{
+public:
+    static const unsigned int PIXEL_BUFFERS = 3;
+    static const unsigned int READBACK_LATENCY = 2; // frames
+    static const unsigned int MAX_QUEUED = 8; // frames, recordings drop past it
+private:
+    struct Frame
+    {
+        std::vector<unsigned char> pixels; // RGBA, bottom row first
+        unsigned int width;
+        unsigned int height;
+        std::string path; // of a still
+        FILE* file; // of the recording, for its frames
+        bool end; // closes the recording's file, no pixels
+    };
+
+    struct Slot
+    {
+        GLuint buffer;
+        unsigned int bytes; // allocated for the buffer
+        bool pending; // read into, not yet mapped
+        unsigned int readFrame;
+        unsigned int width;
+        unsigned int height;
+        std::string path; // of a still, or empty
+        bool record; // also a frame of the recording
+    };
+
+    Slot mSlots[PIXEL_BUFFERS];
+    unsigned int mFrameCount;
+    std::deque<std::string> mStills; // waiting for a frame
+
+    // Only the main thread touches these.
+    FILE* mRecordFile; // written and closed by the capture thread
+    std::string mRecordPath;
+    unsigned int mRecordWidth;
+    unsigned int mRecordHeight;
+    unsigned int mRecordFrames;
+    unsigned int mRecordDropped;
+    unsigned long long mRecordStart;
+    bool mRecording;
+
+    Mutex mMutex;
+    Condition mWake;
+    std::deque<Frame> mQueue; // front is being written
+    std::vector<std::vector<unsigned char> > mSpare; // pixel storage to reuse
+    Thread mThread;
+    Trace::Ring* mTrace;
+    bool mStopping;
+
+    static void CaptureMain(void* capture);
+    void Run();
+    void Write(Frame& frame);
+    bool UsePixelBuffers();
+    void Read(Slot& slot, unsigned int width, unsigned int height);
+    void Map(Slot& slot);
+    // Hands the slot's pixels on and frees it.
+    void Deliver(Slot& slot, std::vector<unsigned char>& pixels);
+    // Takes the pixels. False if it's a recording's frame and the queue is full.
+    bool Queue(std::vector<unsigned char>& pixels,
+               unsigned int width,
+               unsigned int height,
+               const std::string& path,
+               FILE* file);
+    void QueueEnd();
+    // Deleted only while live is true, a lost context's names are forgotten.
+    void DestroyBuffers(bool live = true);
+    void TakeSpare(std::vector<unsigned char>* pixels);
+    bool HasPendingRecording() const;
+public:
+    FrameCapture();
+    // Writes out what's been captured.
+    ~FrameCapture();
+
+    // The next frame drawn is written to path as a PNG.
+    void CaptureFrame(const std::string& path);
+    // False if a recording is running or the file can't be opened.
+    bool StartRecording(const std::string& path);
+    void StopRecording();
+    bool IsRecording() const { return mRecording; }
+
+    // Main thread, after the frame's drawn into the window and before
+    // the swap. Reads back the bottom left width x height.
+    void Update(unsigned int width, unsigned int height);
+    // The buffers went with the old OpenGL context, frames in them are lost.
+    void Reset();
+private:
+    FrameCapture(const FrameCapture&);
+    FrameCapture& operator=(const FrameCapture&);
+};
+
+#endif
\ No newline at end of file
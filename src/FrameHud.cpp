@@ -0,0 +1,120 @@
+#include "FrameHud.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+#include "DDTime.h"
+#include "GraphicsPipeline.h"
+#include "Vector.h"
+#include "Zones.h"
+
+const char* FrameHud::SplitStr[SPLIT_COUNT] =
+{
+    "events",
+    "update",
+    "gc",
+    "flush",
+    "present",
+    "sleep"
+};
+
+FrameHud::FrameHud() :
+    mVisible(false),
+    mCursor(0),
+    mLastFrameEnd(0)
+{
+    std::fill(mSplits, mSplits + SPLIT_COUNT, 0.0);
+    std::fill(mLastSplits, mLastSplits + SPLIT_COUNT, 0.0);
+    std::fill(mHistory, mHistory + HISTORY, 0.0);
+}
+
+void FrameHud::EndFrame()
+{
+    unsigned long long now = DDTime::Microseconds();
+    if(mLastFrameEnd != 0)
+    {
+        mHistory[mCursor] = (now - mLastFrameEnd) / 1000.0;
+        mCursor = (mCursor + 1) % HISTORY;
+    }
+    mLastFrameEnd = now;
+
+    std::copy(mSplits, mSplits + SPLIT_COUNT, mLastSplits);
+    std::fill(mSplits, mSplits + SPLIT_COUNT, 0.0);
+}
+
+double FrameHud::LastFrameTime() const
+{
+    return mHistory[(mCursor + HISTORY - 1) % HISTORY];
+}
+
+void FrameHud::Render(GraphicsPipeline* graphics,
+                      Font* font,
+                      float viewWidth,
+                      float viewHeight,
+                      unsigned int luaKB)
+{
+    if(!mVisible)
+    {
+        return;
+    }
+
+    const float PADDING = 5;
+    const float BAR_WIDTH = 2;
+    const float GRAPH_HEIGHT = 60;
+    const double GRAPH_MS = 33.3; // the top of the graph, two 60Hz frames
+    const float left = -viewWidth / 2 + PADDING;
+    const float top = viewHeight / 2 - PADDING;
+    const float graphBottom = top - GRAPH_HEIGHT;
+    const float graphRight = left + HISTORY * BAR_WIDTH;
+
+    Vector background(0, 0, 0, 0.6f);
+    Vector bar(0.4f, 0.8f, 0.4f, 1);
+    Vector slowBar(0.9f, 0.3f, 0.2f, 1);
+    Vector target(1, 1, 1, 0.5f);
+    Vector text(0.839f, 0.839f, 0.839f, 1);
+
+    // Zones are listed three to a line under the splits.
+    const float LINE_HEIGHT = 36;
+    const unsigned int zones = Zones::ZoneCount();
+    const float zoneRows = (float) ((zones + 2) / 3);
+    graphics->PushRectangle(graphBottom - 110 - zoneRows * LINE_HEIGHT,
+                            left - PADDING, top + PADDING,
+                            graphRight + PADDING, background);
+
+    // Oldest on the left.
+    for(unsigned int i = 0; i < HISTORY; i++)
+    {
+        double ms = mHistory[(mCursor + i) % HISTORY];
+        float height = (float) (std::min(ms, GRAPH_MS) / GRAPH_MS) * GRAPH_HEIGHT;
+        float x = left + i * BAR_WIDTH;
+        graphics->PushRectangle(graphBottom, x, graphBottom + height,
+                                x + BAR_WIDTH, ms > 17.0 ? slowBar : bar);
+    }
+
+    const float targetY = graphBottom + (float) (16.7 / GRAPH_MS) * GRAPH_HEIGHT;
+    graphics->PushLine(left, targetY, graphRight, targetY, target);
+
+    const DrawStats& stats = GraphicsPipeline::LastFrameStats();
+    char line[1024];
+    int length = snprintf(line, sizeof(line),
+                          "frame %.2fms  draws %u  verts %u  lua %ukb\n",
+                          LastFrameTime(), stats.drawCalls, stats.verts, luaKB);
+    for(int i = 0; i < SPLIT_COUNT && length < (int) sizeof(line); i++)
+    {
+        length += snprintf(line + length, sizeof(line) - length,
+                           "%s %.2f%s", SplitStr[i], mLastSplits[i],
+                           i % 3 == 2 ? "\n" : "  ");
+    }
+    for(unsigned int i = 0; i < zones && length < (int) sizeof(line); i++)
+    {
+        length += snprintf(line + length, sizeof(line) - length,
+                           "%s %.2f%s", Zones::ZoneName(i), Zones::LastFrameMs(i),
+                           i % 3 == 2 ? "\n" : "  ");
+    }
+
+    graphics->SetFont(font);
+    graphics->SetTextAlignX(AlignX::Left);
+    graphics->SetTextAlignY(AlignY::Top);
+    graphics->SetFontScale(0.25, 0.25);
+    graphics->PushText(left, graphBottom - PADDING, line, text, (int) viewWidth);
+}
\ No newline at end of file
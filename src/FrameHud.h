@@ -0,0 +1,56 @@
+#ifndef FRAMEHUD_H
+#define FRAMEHUD_H
+
+class GraphicsPipeline;
+class Font;
+
+//
+// Frame times and where they went, drawn over the game. F3 on desktop or
+// System.ShowFrameHud from a script. Splits are CPU milliseconds and add
+// up over the frame, the graph is the last HISTORY frame times.
+//
+class FrameHud
+{
+public:
+    enum eSplit
+    {
+        SPLIT_EVENTS,
+        SPLIT_UPDATE,   // on_update, fixed updates and scheduler tasks
+        SPLIT_GC,
+        SPLIT_FLUSH,    // batches drawn and the frame's GL work submitted
+        SPLIT_PRESENT,  // scaling the scene up to the window
+        SPLIT_SLEEP,    // frame pacing
+        SPLIT_COUNT
+    };
+    static const unsigned int HISTORY = 120;
+private:
+    static const char* SplitStr[SPLIT_COUNT];
+    bool mVisible;
+    double mSplits[SPLIT_COUNT]; // this frame
+    double mLastSplits[SPLIT_COUNT];
+    double mHistory[HISTORY];
+    unsigned int mCursor; // next history slot
+    unsigned long long mLastFrameEnd;
+public:
+    FrameHud();
+
+    void SetVisible(bool value) { mVisible = value; }
+    bool IsVisible() const { return mVisible; }
+    void Toggle() { mVisible = !mVisible; }
+
+    void AddSplit(eSplit split, double milliseconds) { mSplits[split] += milliseconds; }
+    // Call once a frame, after everything's been added.
+    void EndFrame();
+    double LastFrameTime() const;
+    // Splits of the frame EndFrame was last called for.
+    double LastSplit(eSplit split) const { return mLastSplits[split]; }
+    static const char* SplitName(eSplit split) { return SplitStr[split]; }
+
+    void Render(GraphicsPipeline* graphics,
+                Font* font,
+                float viewWidth,
+                float viewHeight,
+                unsigned int luaKB);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "FramePacer.h"
+
+#include "DDTime.h"
+#include "SDL/SDL_timer.h"
+
+void FramePacer::SetFrameRate(int framesPerSecond)
+{
+    unsigned long long period = 0;
+    if(framesPerSecond > 0)
+    {
+        period = 1000000 / (unsigned long long) framesPerSecond;
+    }
+
+    if(period != mPeriod)
+    {
+        mPeriod = period;
+        mNextFrame = 0;
+    }
+}
+
+void FramePacer::Wait()
+{
+    if(mPeriod == 0)
+    {
+        return;
+    }
+
+    unsigned long long now = DDTime::Microseconds();
+
+    // Start again rather than rush to catch up after a long frame.
+    if(mNextFrame == 0 || now > mNextFrame + mPeriod)
+    {
+        mNextFrame = now + mPeriod;
+        return;
+    }
+
+    while(now + SPIN_MICROSECONDS < mNextFrame)
+    {
+        SDL_Delay((Uint32) ((mNextFrame - now - SPIN_MICROSECONDS) / 1000));
+        now = DDTime::Microseconds();
+    }
+
+    while(now < mNextFrame)
+    {
+        now = DDTime::Microseconds();
+    }
+
+    mNextFrame += mPeriod;
+}
\ No newline at end of file
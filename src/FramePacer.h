@@ -0,0 +1,26 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+//
+// Holds the main loop to a frame rate. Each deadline is a whole period
+// after the last one, so the rate doesn't drift with rounding. It sleeps
+// until close to the deadline and spins the rest, sleeps can overshoot
+// by a millisecond or more.
+//
+class FramePacer
+{
+    unsigned long long mPeriod; // microseconds, 0 is unpaced
+    unsigned long long mNextFrame;
+public:
+    // Left to spin rather than sleep.
+    static const unsigned long long SPIN_MICROSECONDS = 2000;
+
+    FramePacer() : mPeriod(0), mNextFrame(0) {}
+
+    // 0 or less leaves frames unpaced, for vsync to hold them.
+    void SetFrameRate(int framesPerSecond);
+    // Returns once the next frame is due.
+    void Wait();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "GLStateCache.h"
+
+#include <assert.h>
+
+GLStateCache::eCap GLStateCache::CapIndex(GLenum cap)
+{
+    switch(cap)
+    {
+        case GL_TEXTURE_2D: return CAP_TEXTURE_2D;
+        case GL_ALPHA_TEST: return CAP_ALPHA_TEST;
+        case GL_SCISSOR_TEST: return CAP_SCISSOR_TEST;
+        case GL_DEPTH_TEST: return CAP_DEPTH_TEST;
+        case GL_BLEND: return CAP_BLEND;
+        case GL_VERTEX_ARRAY: return CAP_VERTEX_ARRAY;
+        case GL_COLOR_ARRAY: return CAP_COLOR_ARRAY;
+        case GL_TEXTURE_COORD_ARRAY: return CAP_TEXTURE_COORD_ARRAY;
+    }
+    assert(!"Cap isn't cached");
+    return CAP_COUNT;
+}
+
+// Returns true if the GL call needs to be made.
+bool GLStateCache::SetCap(GLenum cap, int value)
+{
+    eCap index = CapIndex(cap);
+    if(index == CAP_COUNT)
+    {
+        mIssued++;
+        return true;
+    }
+
+    if(mCaps[index] == value)
+    {
+        mSkipped++;
+        return false;
+    }
+
+    mCaps[index] = value;
+    mIssued++;
+    return true;
+}
+
+void GLStateCache::Enable(GLenum cap)
+{
+    if(SetCap(cap, ON))
+    {
+        glEnable(cap);
+    }
+}
+
+void GLStateCache::Disable(GLenum cap)
+{
+    if(SetCap(cap, OFF))
+    {
+        glDisable(cap);
+    }
+}
+
+void GLStateCache::EnableClientState(GLenum array)
+{
+    if(SetCap(array, ON))
+    {
+        glEnableClientState(array);
+    }
+}
+
+void GLStateCache::DisableClientState(GLenum array)
+{
+    if(SetCap(array, OFF))
+    {
+        glDisableClientState(array);
+    }
+}
+
+void GLStateCache::BindTexture(GLuint id)
+{
+    if(mTextureKnown && mTexture == id)
+    {
+        mSkipped++;
+        return;
+    }
+
+    mTextureKnown = true;
+    mTexture = id;
+    mIssued++;
+    mTextureBinds++;
+    glBindTexture(GL_TEXTURE_2D, id);
+}
+
+void GLStateCache::BlendFunc(GLenum src, GLenum dst)
+{
+    if(mBlendKnown && mBlendSrc == src && mBlendDst == dst)
+    {
+        mSkipped++;
+        return;
+    }
+
+    mBlendKnown = true;
+    mBlendSrc = src;
+    mBlendDst = dst;
+    mIssued++;
+    glBlendFunc(src, dst);
+}
+
+void GLStateCache::Invalidate()
+{
+    for(int i = 0; i < CAP_COUNT; i++)
+    {
+        mCaps[i] = UNKNOWN;
+    }
+    mTextureKnown = false;
+    mTexture = 0;
+    mBlendKnown = false;
+    mBlendSrc = 0;
+    mBlendDst = 0;
+}
+
+void GLStateCache::NewFrame()
+{
+    Invalidate();
+    mLastFrameIssued = mIssued;
+    mLastFrameSkipped = mSkipped;
+    mLastFrameTextureBinds = mTextureBinds;
+    mIssued = 0;
+    mSkipped = 0;
+    mTextureBinds = 0;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef GLSTATECACHE_H
+#define GLSTATECACHE_H
+
+#include "DinodeckGL.h"
+
+//
+// Remembers the GL state the 2D pipeline has set so repeated requests
+// for the same state don't reach the driver.
+// State is unknown until first set, and after Invalidate. Anything that
+// changes GL state behind the cache's back must invalidate it.
+//
+class GLStateCache
+{
+    enum
+    {
+        UNKNOWN = -1,
+        OFF = 0,
+        ON = 1
+    };
+
+    enum eCap
+    {
+        CAP_TEXTURE_2D,
+        CAP_ALPHA_TEST,
+        CAP_SCISSOR_TEST,
+        CAP_DEPTH_TEST,
+        CAP_BLEND,
+        CAP_VERTEX_ARRAY,
+        CAP_COLOR_ARRAY,
+        CAP_TEXTURE_COORD_ARRAY,
+        CAP_COUNT
+    };
+
+    int mCaps[CAP_COUNT];
+    bool mTextureKnown;
+    GLuint mTexture;
+    bool mBlendKnown;
+    GLenum mBlendSrc;
+    GLenum mBlendDst;
+    unsigned int mIssued;
+    unsigned int mSkipped;
+    unsigned int mTextureBinds;
+    unsigned int mLastFrameIssued;
+    unsigned int mLastFrameSkipped;
+    unsigned int mLastFrameTextureBinds;
+
+    static eCap CapIndex(GLenum cap);
+    bool SetCap(GLenum cap, int value);
+public:
+    GLStateCache() :
+        mIssued(0),
+        mSkipped(0),
+        mTextureBinds(0),
+        mLastFrameIssued(0),
+        mLastFrameSkipped(0),
+        mLastFrameTextureBinds(0)
+        { Invalidate(); }
+
+    // Supports GL_TEXTURE_2D, GL_ALPHA_TEST, GL_SCISSOR_TEST,
+    // GL_DEPTH_TEST and GL_BLEND.
+    void Enable(GLenum cap);
+    void Disable(GLenum cap);
+    void EnableClientState(GLenum array);
+    void DisableClientState(GLenum array);
+    void BindTexture(GLuint id);
+    void BlendFunc(GLenum src, GLenum dst);
+
+    void Invalidate();
+    void InvalidateTexture() { mTextureKnown = false; }
+
+    // Call once at the start of each frame, it forgets all state as other
+    // code draws between frames.
+    void NewFrame();
+    unsigned int LastFrameIssued() const { return mLastFrameIssued; }
+    unsigned int LastFrameSkipped() const { return mLastFrameSkipped; }
+    unsigned int LastFrameTextureBinds() const { return mLastFrameTextureBinds; }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "GPUTimer.h"
+
+#include "DinodeckGL.h"
+
+bool GPUTimer::IsSupported()
+{
+#if DINODECK_GPU_TIMERS
+    return GLEE_EXT_timer_query;
+#else
+    return false; // GLES1 has no queries
+#endif
+}
+
+GPUTimer::GPUTimer() :
+    mNext(0),
+    mCreated(false),
+    mRunning(false),
+    mLastMs(-1)
+{
+    for(int i = 0; i < QUERY_COUNT; i++)
+    {
+        mQueries[i] = 0;
+        mPending[i] = false;
+    }
+}
+
+GPUTimer::~GPUTimer()
+{
+#if DINODECK_GPU_TIMERS
+    if(mCreated)
+    {
+        glDeleteQueries(QUERY_COUNT, mQueries);
+    }
+#endif
+}
+
+void GPUTimer::Reset()
+{
+    for(int i = 0; i < QUERY_COUNT; i++)
+    {
+        mQueries[i] = 0;
+        mPending[i] = false;
+    }
+    mNext = 0;
+    mCreated = false;
+    mRunning = false;
+}
+
+void GPUTimer::Begin()
+{
+#if DINODECK_GPU_TIMERS
+    if(!IsSupported())
+    {
+        return;
+    }
+
+    if(!mCreated)
+    {
+        glGenQueries(QUERY_COUNT, mQueries);
+        mCreated = true;
+    }
+
+    Collect();
+
+    if(mPending[mNext])
+    {
+        return; // the GPU is too far behind, skip a frame
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED_EXT, mQueries[mNext]);
+    mRunning = true;
+#endif
+}
+
+void GPUTimer::End()
+{
+#if DINODECK_GPU_TIMERS
+    if(!mRunning)
+    {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED_EXT);
+    mPending[mNext] = true;
+    mNext = (mNext + 1) % QUERY_COUNT;
+    mRunning = false;
+#endif
+}
+
+//
+// Reads finished queries oldest first, so the last read is the newest.
+//
+void GPUTimer::Collect()
+{
+#if DINODECK_GPU_TIMERS
+    for(int i = 0; i < QUERY_COUNT; i++)
+    {
+        int index = (mNext + i) % QUERY_COUNT;
+        if(!mPending[index])
+        {
+            continue;
+        }
+
+        GLuint available = 0;
+        glGetQueryObjectuiv(mQueries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(!available)
+        {
+            break; // later queries won't be done either
+        }
+
+        GLuint nanoseconds = 0;
+        glGetQueryObjectuiv(mQueries[index], GL_QUERY_RESULT, &nanoseconds);
+        mLastMs = nanoseconds / 1000000.0;
+        mPending[index] = false;
+    }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef GPUTIMER_H
+#define GPUTIMER_H
+
+#include "DinodeckGL.h"
+
+//
+// Measures how long the GPU spends on the work issued between Begin and
+// End, with GL_TIME_ELAPSED queries. Results are read a few frames late
+// so nothing waits on the GPU. Timers can't be nested.
+//
+class GPUTimer
+{
+    static const int QUERY_COUNT = 4;
+    GLuint mQueries[QUERY_COUNT];
+    bool mPending[QUERY_COUNT]; // ended but the result's not been read
+    int mNext;
+    bool mCreated;
+    bool mRunning;
+    double mLastMs;
+public:
+    static bool IsSupported();
+
+    GPUTimer();
+    ~GPUTimer();
+
+    void Begin();
+    void End();
+
+    // Most recent result in milliseconds, -1 until there is one.
+    double LastMs() const { return mLastMs; }
+
+    // Forget the queries, they're recreated on next use.
+    // Call when the OpenGL context has been lost.
+    void Reset();
+private:
+    void Collect();
+};
+
+#endif
\ No newline at end of file
@@ -2,25 +2,49 @@
 
 #include <ctime>
 #include <assert.h>
+#include <math.h>
 
 #include "../bin/default_font.h"
+#include "Animation.h"
 #include "Asset.h"
+#include "AssetReport.h"
+#include "AssetStore.h"
 #include "Dinodeck.h"
 #include "DinodeckLua.h"
 #include "DDAudio.h"
 #include "DDLog.h"
+#include "DDRestful.h"
+#include "DDTime.h"
+#include "DrawCapture.h"
+#include "Font.h"
+#include "FormatText.h"
+#include "FrameHud.h"
 #include "GraphicsPipeline.h"
+#include "HotReload.h"
+#include "HttpBatcher.h"
+#include "SaveWriter.h"
 #include "IAssetOwner.h"
+#include "input/Gamepad.h"
 #include "input/Keyboard.h"
 #include "input/Mouse.h"
 #include "input/Touch.h"
+#include "JitMonitor.h"
 #include "LuaState.h"
+#include "Profiler.h"
 #include "ManifestAssetStore.h"
 #include "Renderer.h"
+#include "Scheduler.h"
+#include "scoreloop/ScoreCache.h"
+#include "ScriptJobs.h"
 #include "Settings.h"
-//#include "System.h"
+#include "ShaderProgram.h"
+#include "Sound.h"
+#include "TextLayoutCache.h"
+#include "System.h"
 #include "TextureManager.h"
+#include "Trace.h"
 #include "Vector.h"
+#include "Zones.h"
 
 
 // Would rather unify this
@@ -32,36 +56,96 @@
 
 
 
+const RegistryKey Game::Key("Game");
+
 Game::Game(Settings* settings,
            ManifestAssetStore* assetStore,
            TextureManager* textureManager) :
     mReloadCount(0),
     mLuaState(NULL),
+    mUpdateRef(LUA_NOREF),
+    mFixedUpdateRef(LUA_NOREF),
+    mScheduler(NULL),
+    mScriptJobs(NULL),
+    mHttpBatcher(NULL),
+    mScoreCache(NULL),
+    mSaveWriter(NULL),
+    mProfiler(NULL),
+    mJitMonitor(NULL),
     mReady(false),
     mSettings(settings),
     mAssetStore(assetStore),
     mDebugGraphics(NULL),
     mTextureManager(textureManager),
     mDeltaTime(0),
+    mFixedTime(0),
+    mFrameAlpha(1),
     mExit(false),
     mSystemFont(NULL),
     mTouch(NULL),
     mMouse(NULL),
-    mKeyboard(NULL)
+    mKeyboard(NULL),
+    mGamepad(NULL)
 {
     mLuaState = new LuaState("Game");
-    mLuaState->InjectIntoRegistry("Game", (void*) this);
+    mLuaState->InjectIntoRegistry(Game::Key.Name(), (void*) this);
     Game::Bind(mLuaState);
 
+    mScheduler = new Scheduler();
+    mScriptJobs = new ScriptJobs(Dinodeck::GetInstance()->GetJobs());
+    mHttpBatcher = new HttpBatcher();
+    mScoreCache = new ScoreCache();
+    mSaveWriter = new SaveWriter();
+    mProfiler = new Profiler();
+    mJitMonitor = new JitMonitor();
     mTouch = new Touch();
     mMouse = new Mouse();
     mKeyboard = new Keyboard();
+    mGamepad = new Gamepad();
 
     // The system font is created on by being reset when OpenGL context is made.
 }
 
 Game::~Game()
 {
+    if(mScriptJobs)
+    {
+        delete mScriptJobs; // waits for jobs in flight
+        mScriptJobs = NULL;
+    }
+
+    if(mHttpBatcher)
+    {
+        mHttpBatcher->Flush(); // into the outbox for next run
+        delete mHttpBatcher;
+        mHttpBatcher = NULL;
+    }
+
+    if(mScoreCache)
+    {
+        delete mScoreCache;
+        mScoreCache = NULL;
+    }
+
+    if(mSaveWriter)
+    {
+        delete mSaveWriter; // finishes queued saves
+        mSaveWriter = NULL;
+    }
+
+    if(mProfiler)
+    {
+        mProfiler->Stop(); // while the hooked state is still about
+        delete mProfiler;
+        mProfiler = NULL;
+    }
+
+    if(mJitMonitor)
+    {
+        delete mJitMonitor;
+        mJitMonitor = NULL;
+    }
+
     if(mLuaState)
     {
         delete mLuaState;
@@ -74,6 +158,12 @@ Game::~Game()
         mDebugGraphics = NULL;
     }
 
+    if(mScheduler)
+    {
+        delete mScheduler;
+        mScheduler = NULL;
+    }
+
     if(mTouch)
     {
         delete mTouch;
@@ -92,16 +182,50 @@ Game::~Game()
         mKeyboard = NULL;
     }
 
+    if(mGamepad)
+    {
+        delete mGamepad;
+        mGamepad = NULL;
+    }
+
     if(mSystemFont)
     {
+        FormatText::ForgetFont(mSystemFont);
         delete mSystemFont;
         mSystemFont = NULL;
+        TextLayoutCache::OnFontsChanged();
     }
 }
 
 bool Game::OnAssetReload(Asset& asset)
 {
-    mReloadCount++;
+    // Nothing in the live state came from a script it hasn't run, so that
+    // changing doesn't cost a reset. It's read fresh when it's run.
+    if(mReady && !DependsOn(asset.Name()))
+    {
+        return true;
+    }
+
+    // A changed script that's already been run is patched into the live
+    // state. Anything else, or anything already forcing a reset, resets.
+    bool hotReload = mSettings->hotReload
+        && mReady
+        && mReloadCount == 0
+        && AssetStore::IsCleverReloading()
+        && asset.IsLoaded();
+
+    if(!hotReload)
+    {
+        mReloadCount++;
+        return true;
+    }
+
+    dsprintf("Hot reloading [%s]\n", asset.Name().c_str());
+    if(!HotReload::Run(mLuaState, asset.Path().c_str()))
+    {
+        dsprintf("Press F2 to reload.\n");
+        Break();
+    }
     return true;
 }
 
@@ -128,7 +252,12 @@ int Game::RunScriptAsset(const char* name)
     }
 
     // This will call lua_error if things go wrong.
-    bool success = mLuaState->DoFile(scriptAsset->Path().c_str());
+    bool success = false;
+    {
+        AssetReportScope scope(*scriptAsset);
+        success = mLuaState->DoFile(scriptAsset->Path().c_str());
+    }
+    mScriptsRun.insert(name);
 
     if(false == success)
     {
@@ -142,8 +271,11 @@ int Game::RunScriptAsset(const char* name)
 
 void Game::OnAssetDestroyed(Asset& asset)
 {
-    // If you remove a script, that means we'll need to reload.
-    mReloadCount++;
+    // If you remove a script that's been run, that means we'll need to reload.
+    if(!mReady || DependsOn(asset.Name()))
+    {
+        mReloadCount++;
+    }
 }
 
 
@@ -156,8 +288,41 @@ void Game::Reset()
         delete mDebugGraphics;
         mDebugGraphics = NULL;
     }
-    mLuaState->Reset();
-    Game::Bind(mLuaState);
+    // The registry goes with the old state.
+    mUpdateRef = LUA_NOREF;
+    mFixedUpdateRef = LUA_NOREF;
+    mFixedTime = 0;
+    mFrameAlpha = 1;
+    mScriptsRun.clear();
+    mLoadedRefs.clear();
+    Sound::Reset();
+    System::Reset();
+    mProfiler->Stop();
+    mScheduler->Reset();
+    mScriptJobs->Reset();
+    DDRestful::Reset();
+    mSaveWriter->Reset();
+    mHttpBatcher->Reset();
+    mHttpBatcher->Configure(mSettings->httpBatchMs,
+                            mSettings->httpBatchMax,
+                            mSettings->httpOutboxFile);
+    mScoreCache->Reset();
+    mScoreCache->Configure(mSettings->scoreCacheSeconds,
+                           mSettings->scoreCacheFile);
+    mScheduler->SetBudget(mSettings->schedulerBudgetMicroseconds);
+    if(!mSettings->fastReset || !mLuaState->Restore())
+    {
+        mLuaState->Reset();
+        Game::Bind(mLuaState);
+        mLuaState->MarkPristine();
+    }
+
+    BytecodeCache& bytecode = mLuaState->GetBytecodeCache();
+    bytecode.SetEnabled(mSettings->bytecodeCache);
+    bytecode.SetDirectory(mSettings->bytecodeCacheDir);
+    bytecode.ResetCounts();
+    mJitMonitor->Attach(mLuaState->State(), *mSettings);
+    mProfiler->SetJitEnabled(mJitMonitor->IsEnabled());
     //mGraphicsPipeline->Reset();
     Dinodeck::GetInstance()->GetAudio()->Reset();
 
@@ -177,6 +342,7 @@ void Game::Reset()
     printf("Calling main_script %s at %s\n", mainScriptName, mainScript->Path().c_str());
 
     bool mainFileParsed = mLuaState->DoFile(mainScript->Path().c_str());
+    mScriptsRun.insert(mainScriptName);
 
     if(false == mainFileParsed)
     {
@@ -185,6 +351,35 @@ void Game::Reset()
         return;
     }
 
+    // Compiled once here rather than parsed from a string every frame.
+    mUpdateRef = mLuaState->RegisterChunk("on_update", mSettings->onUpdate.c_str());
+
+    if(mUpdateRef == LUA_NOREF)
+    {
+        dsprintf("Failed parsing on_update [%s].\n", mSettings->onUpdate.c_str());
+        Break();
+        return;
+    }
+
+    if(mSettings->fixedUpdateRate > 0)
+    {
+        mFixedUpdateRef = mLuaState->RegisterChunk("on_fixed_update",
+                                                   mSettings->onFixedUpdate.c_str());
+        if(mFixedUpdateRef == LUA_NOREF)
+        {
+            dsprintf("Failed parsing on_fixed_update [%s].\n",
+                     mSettings->onFixedUpdate.c_str());
+            Break();
+            return;
+        }
+    }
+
+    if(bytecode.IsEnabled())
+    {
+        dsprintf("Scripts: %u from bytecode cache, %u compiled.\n",
+                 bytecode.Hits(), bytecode.Compiles());
+    }
+
     if(mReady)
     {
         dsprintf("Reload success:\n");
@@ -231,16 +426,24 @@ void Game::RenderError()
         lightGrey,
         mSettings->width
     );
+    mDebugGraphics->Flush();
+    GraphicsPipeline::SubmitFrame();
 }
 
 void Game::Update(double deltaTime)
 {
+    DD_PROFILE_ZONE("GameUpdate");
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     mDeltaTime = deltaTime;
+    Animation::Advance(deltaTime);
+
+    // Other code draws between frames, so forget what GL state was set.
+    GraphicsPipeline::NewFrame();
 
     if(!mReady)
     {
         RenderError();
+        mKeyboard->Update(); // or the frame's events pile up until a reload
         return;
     }
 
@@ -250,14 +453,55 @@ void Game::Update(double deltaTime)
         (*it)->Graphics()->OnNewFrame();
     }
 
-    bool result = mLuaState->DoString("update()");
+    FrameHud* hud = Dinodeck::GetInstance()->GetFrameHud();
+    unsigned long long splitStart = DDTime::Microseconds();
+
+    mProfiler->BeginFrame();
+    bool result = RunFixedUpdates(deltaTime)
+        && mUpdateRef != LUA_NOREF
+        && mLuaState->CallRegisteredFunction(mUpdateRef, mFrameAlpha);
+
+    if(result)
+    {
+        result = mScheduler->Run(mLuaState->State(), this, deltaTime);
+    }
+
+    if(result)
+    {
+        result = mScriptJobs->Update(mLuaState);
+    }
+
+    DDRestful::Update(mLuaState);
+    mHttpBatcher->Update(mLuaState);
+    mScoreCache->Update(mLuaState);
+    mSaveWriter->Update(mLuaState);
+
+    if(result && !mLoadedRefs.empty() && !mTextureManager->IsLoadingAny())
+    {
+        result = CallLoadedCallbacks();
+    }
+
+    Sound::Update(mLuaState->State());
+    hud->AddSplit(FrameHud::SPLIT_UPDATE, (DDTime::Microseconds() - splitStart) / 1000.0);
+    Trace::Record("update", splitStart, DDTime::Microseconds());
+    splitStart = DDTime::Microseconds();
 
     // This should be in the render function?
-    for(std::vector<Renderer*>::iterator it = Renderer::mRenderers.begin();
-        it != Renderer::mRenderers.end(); ++it)
     {
-        (*it)->Graphics()->Flush();
+        ProfileZone zone(NULL, "Flush");
+        for(std::vector<Renderer*>::iterator it = Renderer::mRenderers.begin();
+            it != Renderer::mRenderers.end(); ++it)
+        {
+            (*it)->Graphics()->Flush();
+        }
     }
+    GraphicsPipeline::FinishTarget(); // in case the script didn't
+    RenderFrameHud(hud);
+    GraphicsPipeline::SubmitFrame();
+    DrawCapture::EndFrame();
+    hud->AddSplit(FrameHud::SPLIT_FLUSH, (DDTime::Microseconds() - splitStart) / 1000.0);
+    Trace::Record("flush", splitStart, DDTime::Microseconds());
+    ShaderProgram::CollectReleased();
 
     if(!result)
     {
@@ -265,8 +509,15 @@ void Game::Update(double deltaTime)
         Break();
     }
 
-    // Force a full collect each frame
-    mLuaState->CollectGarbage();
+    Vector::ResetScratch(mLuaState->State());
+
+    // A full collect each frame unless settings say otherwise.
+    mLuaState->SetGCMode(mSettings->gcMode, mSettings->gcStepMicroseconds);
+    splitStart = DDTime::Microseconds();
+    mLuaState->FrameGarbage();
+    hud->AddSplit(FrameHud::SPLIT_GC, mLuaState->LastGCMs());
+    Trace::Record("gc", splitStart, DDTime::Microseconds());
+    mProfiler->EndFrame();
 
     //
     // Update Input
@@ -276,29 +527,108 @@ void Game::Update(double deltaTime)
     mKeyboard->Update();
 }
 
+// Drawn over the game through the debug pipeline, like the error text.
+void Game::RenderFrameHud(FrameHud* hud)
+{
+    if(!hud->IsVisible())
+    {
+        return;
+    }
+
+    if(NULL == mDebugGraphics)
+    {
+        mDebugGraphics = new GraphicsPipeline();
+    }
+    mDebugGraphics->OnNewFrame();
+    hud->Render(mDebugGraphics,
+                mSystemFont,
+                (float) mSettings->width,
+                (float) mSettings->height,
+                mLuaState->HeapKB());
+    mDebugGraphics->Flush();
+}
+
+//
+// Runs on_fixed_update once for each fixed step the frame's time covers,
+// keeping what's left over for the next frame. After max_fixed_steps the
+// rest is dropped, so a slow frame can't make the next one slower still.
+// GetDeltaTime gives the step while they run.
+//
+bool Game::RunFixedUpdates(double deltaTime)
+{
+    mFrameAlpha = 1;
+    if(mFixedUpdateRef == LUA_NOREF)
+    {
+        return true;
+    }
+
+    const double step = 1.0 / mSettings->fixedUpdateRate;
+    mFixedTime += deltaTime;
+
+    bool result = true;
+    int steps = 0;
+    mDeltaTime = step;
+    while(result && mFixedTime >= step)
+    {
+        if(steps == mSettings->maxFixedSteps)
+        {
+            mFixedTime = fmod(mFixedTime, step);
+            break;
+        }
+        result = mLuaState->CallRegisteredFunction(mFixedUpdateRef);
+        mFixedTime -= step;
+        steps++;
+    }
+    mDeltaTime = deltaTime;
+    mFrameAlpha = mFixedTime / step;
+    return result;
+}
+
 std::string Game::GetLastError() const
 {
     return mLuaState->GetLastError();
 }
 
-FTTextureFont* Game::GetFont(const char* name)
+Font* Game::GetFont(const char* name)
 {
     return mAssetStore->GetFont(name);
 }
 
+bool Game::CallLoadedCallbacks()
+{
+    // Callbacks may register more, they wait for the next load.
+    std::vector<int> refs;
+    refs.swap(mLoadedRefs);
+
+    bool result = true;
+    lua_State* state = mLuaState->State();
+    for(std::vector<int>::iterator it = refs.begin(); it != refs.end(); ++it)
+    {
+        if(result)
+        {
+            result = mLuaState->CallRegisteredFunction(*it);
+        }
+        luaL_unref(state, LUA_REGISTRYINDEX, *it);
+    }
+    return result;
+}
+
 void Game::ResetSystemFont()
 {
     if(NULL != mSystemFont)
     {
+        FormatText::ForgetFont(mSystemFont);
         delete mSystemFont;
         mSystemFont = NULL;
+        TextLayoutCache::OnFontsChanged();
     }
-    mSystemFont = new FTTextureFont
+    FTTextureFont* freeType = new FTTextureFont
     (
         default_font,
         default_font_len
     );
-    mSystemFont->FaceSize(72.0f);
+    freeType->FaceSize(72.0f);
+    mSystemFont = new Font(freeType);
 }
 
 void Game::InvalidateRendererFonts()
@@ -310,6 +640,15 @@ void Game::InvalidateRendererFonts()
     }
 }
 
+void Game::ResetRendererStaticLayers()
+{
+    for(std::vector<Renderer*>::iterator it = Renderer::mRenderers.begin();
+        it != Renderer::mRenderers.end(); ++it)
+    {
+        (*it)->Graphics()->ResetStatic();
+    }
+}
+
 int lua_load_library(lua_State* state)
 {
     if(1 != lua_gettop(state) || !lua_isstring(state,  -1))
@@ -333,13 +672,57 @@ int lua_load_library(lua_State* state)
     return 0;
 }
 
+//
+// The globals' __index. A library is bound the first time a script names
+// it, so those never used cost nothing. LoadLibrary still works.
+// Upvalue 1 holds every name already tried, so a global that's read
+// while undefined only goes through Reflect the first time.
+//
+static int lua_bind_on_first_use(lua_State* state)
+{
+    if(lua_type(state, 2) != LUA_TSTRING)
+    {
+        return 0;
+    }
+
+    lua_pushvalue(state, 2);
+    lua_rawget(state, lua_upvalueindex(1));
+    const bool tried = lua_toboolean(state, -1);
+    lua_pop(state, 1);
+    if(tried)
+    {
+        return 0;
+    }
+    lua_pushvalue(state, 2);
+    lua_pushboolean(state, 1);
+    lua_rawset(state, lua_upvalueindex(1));
+
+    const char* name = lua_tostring(state, 2);
+    if(Reflect::Find(name) == NULL
+       || !Reflect::Bind(name, LuaState::GetWrapper(state)))
+    {
+        return 0;
+    }
+
+    lua_pushvalue(state, 2);
+    lua_rawget(state, 1);
+    return 1;
+}
+
 static int lua_get_delta_time(lua_State* state)
 {
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     lua_pushnumber(state, game->GetDeltaTime());
     return 1;
 }
 
+static int lua_get_frame_alpha(lua_State* state)
+{
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    lua_pushnumber(state, game->GetFrameAlpha());
+    return 1;
+}
+
 static int lua_get_time(lua_State* state)
 {
     lua_pushnumber(state, time(0));
@@ -352,5 +735,13 @@ void Game::Bind(LuaState* state)
     lua_State* s = state->State();
     lua_register(s, "LoadLibrary", lua_load_library);
     lua_register(s, "GetDeltaTime", lua_get_delta_time);
+    lua_register(s, "GetFrameAlpha", lua_get_frame_alpha);
     lua_register(s, "GetTime", lua_get_time); // seconds since epoch
+
+    // A strict.lua style metatable replaces this, then LoadLibrary is needed.
+    lua_newtable(s);
+    lua_newtable(s); // names tried
+    lua_pushcclosure(s, lua_bind_on_first_use, 1);
+    lua_setfield(s, -2, "__index");
+    lua_setmetatable(s, LUA_GLOBALSINDEX);
 }
\ No newline at end of file
@@ -1,21 +1,33 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <set>
 #include <string>
+#include <vector>
 
 #include "IAssetOwner.h"
 class Asset;
 class LuaState;
+class RegistryKey;
+class Profiler;
+class JitMonitor;
+class Scheduler;
+class ScriptJobs;
 struct Settings;
 class ManifestAssetStore;
 class GraphicsPipeline;
+class HttpBatcher;
+class ScoreCache;
+class SaveWriter;
 class TextureManager;
-class FTTextureFont;
+class Font;
 
 // Can these be generalised?
 class Touch;
 class Mouse;
 class Keyboard;
+class Gamepad;
+class FrameHud;
 
 //
 // Responsible for calling the Lua update script.
@@ -25,20 +37,37 @@ class Game : public IAssetOwner
     // used as counter to determine if the lua state should be reloaded.
     unsigned int        mReloadCount;
     LuaState*           mLuaState;
+    int                 mUpdateRef; // compiled settings.on_update, in the registry
+    int                 mFixedUpdateRef; // settings.on_fixed_update, if fixed_update_rate is set
+    std::set<std::string> mScriptsRun; // main script and by Asset.Run, since the last reset
+    std::vector<int>    mLoadedRefs; // Asset.OnLoaded callbacks, in the registry
+    Scheduler*          mScheduler;
+    ScriptJobs*         mScriptJobs;
+    HttpBatcher*        mHttpBatcher;
+    ScoreCache*         mScoreCache;
+    SaveWriter*         mSaveWriter;
+    Profiler*           mProfiler;
+    JitMonitor*         mJitMonitor;
     bool                mReady;
     Settings*           mSettings;
     ManifestAssetStore* mAssetStore;
     GraphicsPipeline*   mDebugGraphics;
     TextureManager*     mTextureManager;
     double              mDeltaTime;
+    double              mFixedTime; // not yet stepped by on_fixed_update
+    double              mFrameAlpha; // how far between the last fixed step and the next
     bool                mExit;
-    FTTextureFont*      mSystemFont; // Better in graphics pipeline?
+    Font*      mSystemFont; // Better in graphics pipeline?
 
     Touch*              mTouch; // This feels like somekind of module system would be better.
     Mouse*              mMouse;
     Keyboard*           mKeyboard;
+    Gamepad*            mGamepad;
 
     void RenderError();
+    bool CallLoadedCallbacks();
+    bool RunFixedUpdates(double deltaTime);
+    void RenderFrameHud(FrameHud* hud);
 public:
 
     Game(Settings* settings,
@@ -46,6 +75,8 @@ public:
          TextureManager* mTextureManager);
     ~Game();
 
+    // The game is injected into its Lua state under this key.
+    static const RegistryKey Key;
     static void Bind(LuaState* state);
     // Callbacks for Assets
     virtual bool OnAssetReload(Asset& asset);
@@ -54,27 +85,46 @@ public:
     void ResetReloadCount() { mReloadCount = 0; }
     unsigned int GetReloadCount() { return mReloadCount; }
     int RunScriptAsset(const char* name);
+    // Called, then unref'd, once nothing is loading in the background.
+    void AddLoadedCallback(int ref) { mLoadedRefs.push_back(ref); }
     double GetDeltaTime() const { return mDeltaTime; }
+    // 0 to 1, for drawing between fixed steps. Always 1 without them.
+    double GetFrameAlpha() const { return mFrameAlpha; }
 
     // Reloads the lua state.
     void Reset();
     // Reset the system font
     void ResetSystemFont();
     void InvalidateRendererFonts();
+    // True if the state has run the script since the last reset.
+    bool DependsOn(const std::string& script) const
+    {
+        return mScriptsRun.find(script) != mScriptsRun.end();
+    }
+    void ResetRendererStaticLayers();
     void Update(double deltaTime);
     void Break() { mReady = false; }
 
     TextureManager* Textures() { return mTextureManager; }
+    ManifestAssetStore* GetAssetStore() { return mAssetStore; }
+    Scheduler* GetScheduler() { return mScheduler; }
+    ScriptJobs* GetScriptJobs() { return mScriptJobs; }
+    HttpBatcher* GetHttpBatcher() { return mHttpBatcher; }
+    ScoreCache* GetScoreCache() { return mScoreCache; }
+    SaveWriter* GetSaveWriter() { return mSaveWriter; }
+    Profiler* GetProfiler() { return mProfiler; }
+    JitMonitor* GetJitMonitor() { return mJitMonitor; }
     Settings* GetSettings() { return mSettings; }
 
     Touch* GetTouch() { return mTouch; }
     Mouse* GetMouse() { return mMouse; }
     Keyboard* GetKeyboard() { return mKeyboard; }
+    Gamepad* GetGamepad() { return mGamepad; }
     LuaState* GetLuaState() { return mLuaState; }
     std::string GetLastError() const;
 
-    FTTextureFont* GetSystemFont() { return mSystemFont; }
-    FTTextureFont* GetFont(const char* name);
+    Font* GetSystemFont() { return mSystemFont; }
+    Font* GetFont(const char* name);
 
     // Functions to allow the game to be exited from the script
     bool IsRunning() const { return (mExit == false); }
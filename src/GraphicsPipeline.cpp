@@ -1,16 +1,39 @@
 #include "GraphicsPipeline.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <cmath>
+#include <sstream>
+#include <string.h>
 
+#include "Animation.h"
+#include "DDAudio.h"
 #include "Dinodeck.h"   // Used to get the default font.
 #include "Game.h" // Used to get system font, could be store statically in gp
 #include "DinodeckGL.h"
 #include "DDLog.h"
-#include "Matrix.h"
+#include "DDMath.h"
+#include "DrawCapture.h"
+#include "Float4.h"
 #include "Sprite.h"
+#include "SpriteRecord.h"
 #include "Texture.h"
+#include "TextRun.h"
+#include "TextureManager.h"
 #include "FormatText.h"
+#include "JobSystem.h"
+#include "LuaState.h"
+#include "Mesh.h"
+#include "OverdrawMap.h"
+#include "ParticleEmitter.h"
+#include "QuadIndexBuffer.h"
+#include "RenderTarget.h"
+#include "ShaderProgram.h"
+#include "StaticLayer.h"
+#include "Tilemap.h"
+#include "Transform2D.h"
+#include "VertexStream.h"
+#include "Zones.h"
 
 // TEMP
 #ifdef ANDROID
@@ -21,65 +44,1866 @@
 
 const double PI = 3.141592;
 
+GLStateCache GraphicsPipeline::mGLState;
+CommandList GraphicsPipeline::mFrameCommands;
+bool GraphicsPipeline::mRecordFrames = true;
+bool GraphicsPipeline::mUseShaders = true;
+ShaderProgram* GraphicsPipeline::mDefaultShader = NULL;
+ShaderProgram* GraphicsPipeline::mActiveShader = NULL;
+const PackedVertex* GraphicsPipeline::mDrawBase = NULL;
+UVBase GraphicsPipeline::mDrawUVBase;
+ShaderProgram* GraphicsPipeline::mSlotShader = NULL;
+unsigned int GraphicsPipeline::mTextureSlots = 1;
+RenderTarget* GraphicsPipeline::mTarget = NULL;
+float GraphicsPipeline::mViewScale = 1.0f;
+ClipRect GraphicsPipeline::mFrameClip = { 0, 0, 0, 0 };
+bool GraphicsPipeline::mFrameClipped = false;
+bool GraphicsPipeline::mDrawOverdraw = false;
+bool GraphicsPipeline::mDepthMasked = false;
+DrawStats GraphicsPipeline::mStats;
+DrawStats GraphicsPipeline::mLastFrameStats;
+std::map<float, std::vector<float> > GraphicsPipeline::mUnitCircles;
+
 const char* GraphicsPipeline::BlendStr[BLEND_COUNT] =
 {
     "BLEND_BLEND",
     "BLEND_ADDITIVE",
+    "BLEND_MULTIPLY",
+    "BLEND_SCREEN",
+};
+
+// What baked batches are drawn with, their verts have already been moved.
+static const Vector BakedCameraPosition(0, 0, 0, 0);
+static const Vector BakedCameraScale(1, 1, 1, 1);
+
+//
+// Rotate(Scale(p) + position), as PushCamera has GL do with no offset.
+//
+struct CameraTransform
+{
+    float c;
+    float s;
+    float sx;
+    float sy;
+    float px;
+    float py;
+
+    CameraTransform(const Vector& position, const Vector& scale, float rotation)
+    {
+        float radians = DegreeToRadian(rotation);
+        c = cos(radians);
+        s = sin(radians);
+        sx = (float) scale.x;
+        sy = (float) scale.y;
+        px = (float) position.x;
+        py = (float) position.y;
+    }
+
+    void Apply(float* x, float* y) const
+    {
+        float qx = *x * sx + px;
+        float qy = *y * sy + py;
+        *x = c * qx - s * qy;
+        *y = s * qx + c * qy;
+    }
+};
+
+const char* GraphicsPipeline::FlushReasonStr[FLUSH_REASON_COUNT] =
+{
+    "other",
+    "texture",
+    "mode",
+    "capacity",
+    "text",
 };
 
-void GraphicsPipeline::Flush()
+const char* GraphicsPipeline::SpritePathStr[SPRITE_PATH_COUNT] =
+{
+    "translate",
+    "scale",
+    "affine",
+};
+
+//
+// The float's top 24 bits, flipped so they order as unsigned ints do.
+//
+static unsigned int DepthBits(float depth)
+{
+    unsigned int bits = 0;
+    memcpy(&bits, &depth, sizeof(bits));
+    bits = (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+    return bits >> 8;
+}
+
+static unsigned long long MakeSortKey(unsigned int layer,
+                                      unsigned int depth,
+                                      eBlendMode blend,
+                                      eDrawMode drawMode,
+                                      GLuint textureId)
+{
+    unsigned long long key = layer & 0xFFFF;
+    key = (key << 24) | (depth & 0xFFFFFF);
+    key = (key << 4) | (blend & 0xF);
+    key = (key << 1) | (drawMode == TRIANGLES ? 0 : 1);
+    key = (key << 19) | (textureId & 0x7FFFF);
+    return key;
+}
+
+//
+// Least significant byte first radix sort on the sort key, which keeps
+// equal keys in submission order. Bytes every key shares, usually the
+// layer's and blend's, are skipped.
+//
+static void RadixSort(std::vector<DrawCommand>& commands,
+                      std::vector<DrawCommand>& scratch)
+{
+    const unsigned int count = commands.size();
+    scratch.resize(count);
+    DrawCommand* from = &commands[0];
+    DrawCommand* to = &scratch[0];
+
+    for(unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        unsigned int offsets[256] = { 0 };
+        for(unsigned int i = 0; i < count; i++)
+        {
+            offsets[(from[i].sortKey >> shift) & 0xFF]++;
+        }
+
+        if(offsets[(from[0].sortKey >> shift) & 0xFF] == count)
+        {
+            continue;
+        }
+
+        unsigned int total = 0;
+        for(unsigned int i = 0; i < 256; i++)
+        {
+            unsigned int bucket = offsets[i];
+            offsets[i] = total;
+            total += bucket;
+        }
+
+        for(unsigned int i = 0; i < count; i++)
+        {
+            to[offsets[(from[i].sortKey >> shift) & 0xFF]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+
+    if(from != &commands[0])
+    {
+        commands.swap(scratch);
+    }
+}
+
+void GraphicsPipeline::Flush(eFlushReason reason)
+{
+    DD_PROFILE_ZONE("Flush");
+    FlushQueue();
+    FlushBatch(reason);
+}
+
+void GraphicsPipeline::NewFrame()
+{
+    DrawCapture::BeginFrame();
+    mGLState.NewFrame();
+    mLastFrameStats = mStats;
+    mStats.Clear();
+}
+
+void GraphicsPipeline::DrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    mStats.drawCalls++;
+    mStats.verts += count;
+    assert(mode != QUADS);
+    if(mDrawOverdraw)
+    {
+        BeginOverdraw();
+        glDrawArrays(mode, first, count);
+        EndOverdraw();
+        return;
+    }
+    glDrawArrays(mode, first, count);
+}
+
+//
+// Neither GL 2 nor GLES 1.1 can offset indices by a base vertex, so the
+// pointers are moved to each run of quads and put back after.
+//
+void GraphicsPipeline::DrawQuads(GLint first, GLsizei count, const unsigned char* slots)
+{
+    assert(count % 4 == 0);
+    QuadIndexBuffer* indices = Dinodeck::GetInstance()->GetQuadIndices();
+    const GLsizei maxVerts = QuadIndexBuffer::MAX_QUADS * 4;
+
+    for(GLsizei done = 0; done < count; done += maxVerts)
+    {
+        const GLsizei verts = std::min(count - done, maxVerts);
+        const GLsizei quads = verts / 4;
+        SetVertexPointers(mDrawBase, first + done);
+        if(slots != NULL)
+        {
+            SetSlotPointer(slots + done);
+        }
+
+        mStats.drawCalls++;
+        mStats.verts += verts;
+        const GLvoid* offset = indices->Bind(quads);
+        if(mDrawOverdraw)
+        {
+            BeginOverdraw();
+        }
+        glDrawElements(GL_TRIANGLES, quads * QuadIndexBuffer::INDICES_PER_QUAD,
+                       GL_UNSIGNED_SHORT, offset);
+        if(mDrawOverdraw)
+        {
+            EndOverdraw();
+        }
+    }
+
+    // FTGL draws from client indices.
+    indices->Unbind();
+    SetVertexPointers(mDrawBase, 0);
+#if DINODECK_SHADERS
+    if(slots != NULL)
+    {
+        glDisableVertexAttribArray(ShaderProgram::SLOT_ATTRIB);
+    }
+#endif
+}
+
+//
+// Swaps the vertex colours for a constant and adds it, so each fill
+// raises the frame buffer by the same step. The next draw's state is
+// applied as usual, EndOverdraw puts the colours back.
+//
+void GraphicsPipeline::BeginOverdraw()
+{
+    const float step = OverdrawMap::LAYER_VALUE / 255.0f;
+    mGLState.Enable(GL_BLEND); // the opaque pass turns it off
+    mGLState.BlendFunc(GL_ONE, GL_ONE);
+    ApplyDrawState(0, false);
+
+#if DINODECK_SHADERS
+    if(mActiveShader != NULL)
+    {
+        glDisableVertexAttribArray(1);
+        glVertexAttrib4f(1, step, step, step, 1.0f);
+        return;
+    }
+#endif
+
+    mGLState.DisableClientState(GL_COLOR_ARRAY);
+    glColor4f(step, step, step, 1.0f);
+}
+
+void GraphicsPipeline::EndOverdraw()
+{
+#if DINODECK_SHADERS
+    if(mActiveShader != NULL)
+    {
+        glEnableVertexAttribArray(1);
+        return;
+    }
+#endif
+
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    mGLState.EnableClientState(GL_COLOR_ARRAY);
+}
+
+//
+// Name value lines for the webserver.
+//
+std::string GraphicsPipeline::StatsReport()
+{
+    const DrawStats& stats = mLastFrameStats;
+    Dinodeck* dinodeck = Dinodeck::GetInstance();
+    std::stringstream report;
+    report << "draw_calls " << stats.drawCalls << "\n";
+    report << "verts " << stats.verts << "\n";
+    report << "texture_binds " << mGLState.LastFrameTextureBinds() << "\n";
+    report << "glyph_upload_bytes " << stats.glyphUploadBytes << "\n";
+    report << "merged_batches " << stats.mergedBatches << "\n";
+    if(mDrawOverdraw)
+    {
+        const OverdrawMap& overdraw = dinodeck->GetOverdrawMap();
+        report << "overdraw_average " << overdraw.Average() << "\n";
+        report << "overdraw_max " << overdraw.Max() << "\n";
+    }
+    for(int i = 0; i < FLUSH_REASON_COUNT; i++)
+    {
+        report << "flush_" << FlushReasonStr[i] << " " << stats.flushes[i] << "\n";
+    }
+    for(int i = 0; i < SPRITE_PATH_COUNT; i++)
+    {
+        report << "sprites_" << SpritePathStr[i] << " " << stats.spritePaths[i] << "\n";
+    }
+    report << "scene_gpu_ms " << dinodeck->SceneGPUTime() << "\n";
+    report << "present_gpu_ms " << dinodeck->PresentGPUTime() << "\n";
+    report << "input_latency_ms " << dinodeck->InputLatency() << "\n";
+    report << "input_latency_average_ms " << dinodeck->AverageInputLatency() << "\n";
+
+    LuaState* lua = dinodeck->GetGame()->GetLuaState();
+    report << "gc_ms " << lua->LastGCMs() << "\n";
+    report << "lua_kb " << lua->HeapKB() << "\n";
+    LuaAllocator::Stats heap = lua->LastFrameHeap();
+    report << "lua_peak_kb " << heap.peakBytes / 1024 << "\n";
+    report << "lua_allocs " << heap.allocations << "\n";
+
+    TextureManager* textures = dinodeck->GetGame()->Textures();
+    report << "texture_kb " << textures->ResidentBytes() / 1024 << "\n";
+    report << "texture_budget_kb " << textures->Budget() / 1024 << "\n";
+    report << "texture_evictions " << textures->Evictions() << "\n";
+    report << "texture_cache_kb " << textures->CachedBytes() / 1024 << "\n";
+
+    DDAudio::Stats audio;
+    dinodeck->GetAudio()->GetStats(&audio);
+    report << "audio_plays " << audio.plays << "\n";
+    report << "audio_dropped " << audio.dropped << "\n";
+    report << "audio_steals " << audio.steals << "\n";
+    report << "audio_stream_underruns " << audio.streamUnderruns << "\n";
+    report << "audio_last_start_ms " << audio.lastStartMicroseconds / 1000.0 << "\n";
+    report << "audio_average_consume_ms " << audio.averageConsumeMicroseconds / 1000.0 << "\n";
+    report << "audio_max_consume_ms " << audio.maxConsumeMicroseconds / 1000.0 << "\n";
+    report << "audio_output_latency_ms "
+           << (audio.outputLatency < 0 ? -1 : audio.outputLatency * 1000.0) << "\n";
+    return report.str();
+}
+
+void GraphicsPipeline::SetDeferred(bool value)
+{
+    if(mDeferred == value)
+    {
+        return;
+    }
+
+    Flush();
+    mDeferred = value;
+}
+
+void GraphicsPipeline::FlushQueue()
+{
+    if(mCommands.empty())
+    {
+        return;
+    }
+
+    RadixSort(mCommands, mSortScratch);
+
+    // What's batched already was pushed with the current camera. Queued
+    // verts were moved as they were recorded, so they're left alone.
+    BakeCamera();
+    mPushingBaked = mBakeCamera;
+    // Targets and static layers may have no depth buffer.
+    if(!mOpaquePass || mTarget != NULL || mRecording != NULL
+       || !FlushQueueOpaqueFirst())
+    {
+        for(std::vector<DrawCommand>::const_iterator it = mCommands.begin();
+            it != mCommands.end();
+            ++it)
+        {
+            ApplyBlend(it->blend);
+            BatchQuad(&mQueuedVerts[it->firstVert], it->textureId,
+                      it->alphaTest, it->premultiplied);
+        }
+    }
+    BakeCamera();
+    mPushingBaked = false;
+
+    mCommands.clear();
+    mQueuedVerts.clear();
+
+    // Anything drawn immediately after should use the last requested blend.
+    ApplyBlend(mQueueBlend);
+}
+
+//
+// The sorted queue is split into groups, back to front: each run of
+// translucent commands, and each run of opaque ones that batch together.
+// A group's depth lies between the groups either side of it, so a
+// translucent sprite is only hidden by opaque ones sorted after it.
+//
+bool GraphicsPipeline::FlushQueueOpaqueFirst()
+{
+    // Every group needs its own value in a 16 bit depth buffer.
+    static const unsigned int MAX_DEPTH_GROUPS = 16384;
+
+    mDepthGroups.resize(mCommands.size());
+    unsigned int group = 0;
+    for(unsigned int i = 0; i < mCommands.size(); i++)
+    {
+        const DrawCommand& command = mCommands[i];
+        if(i > 0)
+        {
+            const DrawCommand& previous = mCommands[i - 1];
+            if(command.opaque != previous.opaque
+               || (command.opaque
+                   && (command.textureId != previous.textureId
+                       || command.premultiplied != previous.premultiplied)))
+            {
+                group++;
+            }
+        }
+        mDepthGroups[i] = group;
+    }
+
+    const unsigned int groupCount = group + 1;
+    if(groupCount > MAX_DEPTH_GROUPS)
+    {
+        return false;
+    }
+
+    // Depth left by an earlier queue would hide what's drawn over it since.
+    FlushBatch();
+    ClearDepth();
+
+    // Group 0 is at the back, the furthest away.
+    const float step = 1.0f / (groupCount + 1);
+    for(int i = (int) mCommands.size() - 1; i >= 0; i--)
+    {
+        const DrawCommand& command = mCommands[i];
+        if(!command.opaque)
+        {
+            continue;
+        }
+        UseBatchDepth(DEPTH_PASS_OPAQUE, 1.0f - (mDepthGroups[i] + 1) * step);
+        ApplyBlend(command.blend);
+        BatchQuad(&mQueuedVerts[command.firstVert], command.textureId,
+                  false, command.premultiplied);
+    }
+
+    for(unsigned int i = 0; i < mCommands.size(); i++)
+    {
+        const DrawCommand& command = mCommands[i];
+        if(command.opaque)
+        {
+            continue;
+        }
+        UseBatchDepth(DEPTH_PASS_TRANSLUCENT, 1.0f - (mDepthGroups[i] + 1) * step);
+        ApplyBlend(command.blend);
+        BatchQuad(&mQueuedVerts[command.firstVert], command.textureId,
+                  command.alphaTest, command.premultiplied);
+    }
+
+    UseBatchDepth(DEPTH_PASS_OFF, 0);
+    return true;
+}
+
+void GraphicsPipeline::SetOpaquePass(bool value)
+{
+    if(mOpaquePass == value)
+    {
+        return;
+    }
+
+    // What's queued was recorded without knowing.
+    Flush();
+    mOpaquePass = value;
+}
+
+void GraphicsPipeline::UseBatchDepth(eDepthPass pass, float depth)
+{
+    if(mBatchDepthPass == pass && mBatchDepth == depth)
+    {
+        return;
+    }
+
+    FlushBatch();
+    mBatchDepthPass = pass;
+    mBatchDepth = depth;
+}
+
+void GraphicsPipeline::ApplyDepthPass(eDepthPass pass, float depth)
+{
+    if(pass == DEPTH_PASS_OFF)
+    {
+        mGLState.Disable(GL_DEPTH_TEST);
+        mGLState.Enable(GL_BLEND);
+        if(mDepthMasked)
+        {
+            glDepthMask(GL_TRUE);
+            mDepthMasked = false;
+        }
+        return;
+    }
+
+    // Every vert is at z 0, so the range puts the whole draw at depth.
+    mGLState.Enable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glDepthRangef(depth, depth);
+
+    if(pass == DEPTH_PASS_OPAQUE)
+    {
+        mGLState.Disable(GL_BLEND);
+        glDepthMask(GL_TRUE);
+        mDepthMasked = false;
+    }
+    else
+    {
+        mGLState.Enable(GL_BLEND);
+        glDepthMask(GL_FALSE);
+        mDepthMasked = true;
+    }
+}
+
+void GraphicsPipeline::ClearDepth()
+{
+    if(DrawCapture::IsCapturing())
+    {
+        DrawCapture::RecordDepthClear();
+    }
+
+    if(mRecordFrames)
+    {
+        mFrameCommands.AppendDepthClear();
+        return;
+    }
+
+    ApplyDepthPass(DEPTH_PASS_OFF, 0);
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void GraphicsPipeline::RecordQuad(const Vertex* verts, GLuint textureId,
+                                  bool alphaTest, bool premultiplied, bool opaque)
+{
+    // Cut to the clip they were pushed in, they're drawn after it's gone.
+    Vertex clipped[6];
+    if(!mClips.empty())
+    {
+        std::copy(verts, verts + 6, clipped);
+        if(!ClipQuad(clipped))
+        {
+            return;
+        }
+        verts = clipped;
+    }
+
+    // Sorted by the blend they're drawn with, so premultiplied normal and
+    // additive sprites end up in the same batch.
+    // The mean of the six verts is the quad's centre.
+    float depth = 0;
+    if(mDepthSort == DEPTH_SORT_Y)
+    {
+        float y = 0;
+        for(int i = 0; i < 6; i++)
+        {
+            y += verts[i].y;
+        }
+        depth = -y / 6;
+    }
+    else if(mDepthSort == DEPTH_SORT_Z)
+    {
+        depth = verts[0].z;
+    }
+
+    DrawCommand command;
+    command.sortKey = MakeSortKey(mLayer,
+                                  mDepthSort == DEPTH_SORT_NONE ? 0 : DepthBits(depth),
+                                  BatchBlend(mQueueBlend, premultiplied),
+                                  TRIANGLES, textureId);
+    command.firstVert = mQueuedVerts.size();
+    command.textureId = textureId;
+    command.blend = mQueueBlend;
+    command.alphaTest = alphaTest;
+    command.premultiplied = premultiplied;
+    // Anything it doesn't fully cover shows through, so it can't hide it.
+    command.opaque = opaque && mOpaquePass && !alphaTest && mQueueBlend == BLEND;
+    for(int i = 0; i < 6 && command.opaque; i++)
+    {
+        command.opaque = verts[i].a >= 1.0f;
+    }
+    mCommands.push_back(command);
+    mQueuedVerts.insert(mQueuedVerts.end(), verts, verts + 6);
+
+    // Moved now, the camera may change before the queue's drawn.
+    if(mBakeCamera && mRecording == NULL)
+    {
+        const CameraTransform camera(mCamPosition, mCamScale, mRotateAngle);
+        for(std::vector<Vertex>::iterator it = mQueuedVerts.end() - 6;
+            it != mQueuedVerts.end();
+            ++it)
+        {
+            camera.Apply(&it->x, &it->y);
+        }
+    }
+}
+
+//
+// Appends a quad to the batch, flushing first if the texture
+// or draw mode changes. Texture id 0 draws untextured.
+// Atlased textures and glyphs share GL textures, so compare ids.
+//
+void GraphicsPipeline::PushQuad(const Vertex* verts, GLuint textureId,
+                                bool alphaTest, bool premultiplied)
+{
+    if(mClips.empty())
+    {
+        BatchQuad(verts, textureId, alphaTest, premultiplied);
+        return;
+    }
+
+    Vertex clipped[6];
+    std::copy(verts, verts + 6, clipped);
+    if(ClipQuad(clipped))
+    {
+        BatchQuad(clipped, textureId, alphaTest, premultiplied);
+    }
+}
+
+//
+// PushQuad for verts that have already been clipped.
+//
+void GraphicsPipeline::BatchQuad(const Vertex* verts, GLuint textureId,
+                                 bool alphaTest, bool premultiplied)
+{
+    // TL, TR, BL, BR of the six when indexed.
+    static const unsigned int QuadCorners[4] = { 0, 1, 2, 4 };
+
+    // Uvs past what packs as they are, repeating or scrolling, batch
+    // relative to a base of their own.
+    float minU = verts[0].u;
+    float maxU = verts[0].u;
+    float minV = verts[0].v;
+    float maxV = verts[0].v;
+    for(unsigned int i = 1; i < 6; i++)
+    {
+        minU = std::min(minU, verts[i].u);
+        maxU = std::max(maxU, verts[i].u);
+        minV = std::min(minV, verts[i].v);
+        maxV = std::max(maxV, verts[i].v);
+    }
+    UVBase uvBase;
+    if(!UVBase::Fit(minU, maxU, minV, maxV, &uvBase))
+    {
+        static bool logged = false;
+        if(!logged)
+        {
+            dsprintf("Texture coords from (%f, %f) to (%f, %f) span too far to draw, "
+                     "they're clamped.\n", minU, minV, maxU, maxV);
+            logged = true;
+        }
+    }
+    const unsigned int numVerts = PrepareQuad(textureId, alphaTest, premultiplied, uvBase);
+
+    // Texture state is set when the batch is flushed.
+    for(unsigned int i = 0; i < numVerts; i++)
+    {
+        Vertex vertex = verts[numVerts == 4 ? QuadCorners[i] : i];
+        BatchColour(&vertex.r, &vertex.g, &vertex.b, &vertex.a);
+        PackedVertex& packed = mVertexBuffer[mVertCount];
+        packed = PackedVertex(vertex);
+        if(!uvBase.IsDefault())
+        {
+            packed.u = PackedVertex::PackUV(vertex.u, uvBase.u, uvBase.shift);
+            packed.v = PackedVertex::PackUV(vertex.v, uvBase.v, uvBase.shift);
+        }
+        mVertCount++;
+    }
+}
+
+//
+// Flushes if the quad can't join the batch, leaving room for its verts
+// at mVertCount. Returns how many, four for indexed QUADS or six for
+// TRIANGLES, which static layers are recorded as.
+//
+unsigned int GraphicsPipeline::PrepareQuad(GLuint textureId, bool alphaTest, bool premultiplied,
+                                           const UVBase& uvBase)
+{
+    const eDrawMode quadMode = mRecording == NULL ? QUADS : TRIANGLES;
+    const unsigned int numVerts = quadMode == QUADS ? 4 : 6;
+    bool needToFlush = ReserveVerts(numVerts);
+
+    // With slots the quad joins any batch with room for its texture.
+    const bool slotted = UseTextureSlots();
+    const GLuint batchTexture = slotted ? SLOT_BATCH : textureId;
+    const bool slotsFull = slotted
+                           && textureId != 0
+                           && mSlots.Find(textureId) < 0
+                           && mSlots.count >= mTextureSlots;
+
+    if(needToFlush
+       || mDrawMode != quadMode
+       || mTextureId != batchTexture
+       || mAlphaTest != alphaTest
+       || mUVBase != uvBase
+       || slotsFull)
+    {
+        eFlushReason reason = FLUSH_TEXTURE;
+        if(needToFlush)
+        {
+            reason = FLUSH_CAPACITY;
+        }
+        else if(mDrawMode != quadMode)
+        {
+            reason = FLUSH_MODE;
+        }
+        else if(mAlphaTest != alphaTest)
+        {
+            reason = FLUSH_TEXT;
+        }
+        FlushBatch(reason);
+        mTextureId = batchTexture;
+        mAlphaTest = alphaTest;
+        mDrawMode = quadMode;
+        mUVBase = uvBase;
+    }
+    UseBatchBlend(BatchBlend(mBlendMode, premultiplied));
+
+    if(!slotted)
+    {
+        return numVerts;
+    }
+
+    // After the blend, which can flush and empty the slots.
+    if(mVertexSlots.size() < mVertexBuffer.size())
+    {
+        mVertexSlots.resize(mVertexBuffer.size());
+    }
+
+    unsigned char slot = TextureSlots::UNTEXTURED;
+    if(textureId != 0)
+    {
+        slot = (unsigned char) mSlots.Add(textureId, mTextureSlots);
+    }
+    std::fill(mVertexSlots.begin() + mVertCount,
+              mVertexSlots.begin() + mVertCount + numVerts,
+              slot);
+    return numVerts;
+}
+
+void GraphicsPipeline::SetTextureSlots(unsigned int count)
+{
+    const unsigned int maxSlots = TextureSlots::MAX_SLOTS;
+    count = std::max(1u, std::min(count, maxSlots));
+    if(count == mTextureSlots)
+    {
+        return;
+    }
+
+    // Built again for the new count when next batched with.
+    mTextureSlots = count;
+    if(mSlotShader != NULL)
+    {
+        mSlotShader->Release();
+        mSlotShader = NULL;
+    }
+}
+
+bool GraphicsPipeline::UseTextureSlots() const
+{
+    if(mTextureSlots <= 1
+       || !mUseShaders
+       || mDrawOverdraw
+       || mRecording != NULL
+       || CurrentShader() != NULL)
+    {
+        return false;
+    }
+
+    if(mSlotShader != NULL)
+    {
+        return true;
+    }
+
+#if DINODECK_SHADERS
+    if(ShaderProgram::IsSupported())
+    {
+        GLint units = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &units);
+        if(units < (GLint) mTextureSlots)
+        {
+            mTextureSlots = std::max(units, 1);
+        }
+    }
+#endif
+
+    if(mTextureSlots <= 1)
+    {
+        return false;
+    }
+
+    mSlotShader = new ShaderProgram(ShaderProgram::SlotFragmentSource(mTextureSlots).c_str());
+    if(!mSlotShader->Build())
+    {
+        dsprintf("Texture slots unavailable, batching by texture. %s\n",
+                 mSlotShader->GetLastError().c_str());
+        mSlotShader->Release();
+        mSlotShader = NULL;
+        mTextureSlots = 1;
+        return false;
+    }
+    return true;
+}
+
+//
+// Binds the rest of the slots' textures, ApplyDrawState binds the first.
+// The cache only tracks unit 0 so that's left active. DrawQuads points
+// the slot attribute at each vert's slot.
+//
+void GraphicsPipeline::BindTextureSlots(const TextureSlots& slots)
+{
+#if DINODECK_SHADERS
+    for(unsigned int i = 1; i < slots.count; i++)
+    {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, slots.ids[i]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+#endif
+}
+
+//
+// Base is the first vert in client memory, or NULL when the verts are in
+// the bound buffer and the pointers are offsets into it.
+// With a shader, the verts go to its attributes and the colours are
+// normalized by GL, otherwise the fixed function client arrays are used.
+//
+void GraphicsPipeline::BeginDraw(const PackedVertex* base, ShaderProgram* shader)
+{
+    mActiveShader = NULL;
+    if(mUseShaders)
+    {
+        mActiveShader = UseShader(shader);
+    }
+
+    mDrawBase = base;
+    SetVertexPointers(base, 0);
+
+    mDrawUVBase = UVBase();
+    if(mActiveShader != NULL)
+    {
+        mActiveShader->SetUVBase(mDrawUVBase.Scale(), 0, 0);
+        return;
+    }
+
+    // Turn the fixed point texture coords back into 0-1.
+    glMatrixMode(GL_TEXTURE);
+    glPushMatrix();
+    glLoadIdentity();
+    glScalef(1.0f / PackedVertex::UV_ONE, 1.0f / PackedVertex::UV_ONE, 1.0f);
+    glMatrixMode(GL_MODELVIEW);
+}
+
+//
+// Points the shader's attributes, or the client arrays, at vert first on
+// from base.
+//
+void GraphicsPipeline::SetVertexPointers(const PackedVertex* base, GLint first)
+{
+    const PackedVertex layout;
+    const char* offset = (const char*) base + first * sizeof(PackedVertex);
+    const char* start = (const char*) &layout;
+    const char* position = offset + ((const char*) &layout.x - start);
+    const char* colour = offset + ((const char*) &layout.r - start);
+    const char* texcoord = offset + ((const char*) &layout.u - start);
+
+#if DINODECK_SHADERS
+    if(mActiveShader != NULL)
+    {
+        glVertexAttribPointer(0, POSITION_SIZE, GL_FLOAT, GL_FALSE,
+                              sizeof(PackedVertex), position);
+        glVertexAttribPointer(1, COLOUR_SIZE, GL_UNSIGNED_BYTE, GL_TRUE,
+                              sizeof(PackedVertex), colour);
+        glVertexAttribPointer(2, TEXCOORD_SIZE, GL_SHORT, GL_FALSE,
+                              sizeof(PackedVertex), texcoord);
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+        glEnableVertexAttribArray(2);
+        return;
+    }
+#endif
+
+    glVertexPointer(POSITION_SIZE, GL_FLOAT, sizeof(PackedVertex), position);
+    mGLState.EnableClientState(GL_VERTEX_ARRAY);
+
+    glColorPointer(COLOUR_SIZE, GL_UNSIGNED_BYTE, sizeof(PackedVertex), colour);
+    mGLState.EnableClientState(GL_COLOR_ARRAY);
+
+    glTexCoordPointer(TEXCOORD_SIZE, GL_SHORT, sizeof(PackedVertex), texcoord);
+    mGLState.EnableClientState(GL_TEXTURE_COORD_ARRAY);
+}
+
+//
+// Packed uvs are scaled and moved back to the coords they stand for, by
+// the texture matrix without a shader.
+//
+void GraphicsPipeline::ApplyUVBase(const UVBase& base)
+{
+    if(mActiveShader != NULL)
+    {
+        mActiveShader->SetUVBase(base.Scale(), base.u, base.v);
+        return;
+    }
+
+    if(base == mDrawUVBase)
+    {
+        return;
+    }
+    mDrawUVBase = base;
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glTranslatef(base.u, base.v, 0.0f);
+    glScalef(base.Scale(), base.Scale(), 1.0f);
+    glMatrixMode(GL_MODELVIEW);
+}
+
+//
+// The slots are in client memory alongside the streamed verts, so the
+// stream's bound again after.
+//
+void GraphicsPipeline::SetSlotPointer(const unsigned char* slots)
+{
+#if DINODECK_SHADERS
+    if(mActiveShader == NULL)
+    {
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glVertexAttribPointer(ShaderProgram::SLOT_ATTRIB, 1, GL_UNSIGNED_BYTE, GL_FALSE,
+                          1, slots);
+    glEnableVertexAttribArray(ShaderProgram::SLOT_ATTRIB);
+    Dinodeck::GetInstance()->GetVertexStream()->Bind();
+#endif
+}
+
+void GraphicsPipeline::EndDraw()
+{
+#if DINODECK_SHADERS
+    if(mActiveShader != NULL)
+    {
+        // The display quad and FTGL use fixed function.
+        glDisableVertexAttribArray(0);
+        glDisableVertexAttribArray(1);
+        glDisableVertexAttribArray(2);
+        glDisableVertexAttribArray(ShaderProgram::SLOT_ATTRIB);
+        ShaderProgram::UseNone();
+        mActiveShader = NULL;
+        return;
+    }
+#endif
+
+    glMatrixMode(GL_TEXTURE);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+//
+// Falls back to the default shader if a script's shader won't build, and
+// to fixed function if the default won't.
+//
+ShaderProgram* GraphicsPipeline::UseShader(ShaderProgram* shader)
+{
+    if(shader != NULL && shader->Use())
+    {
+        return shader;
+    }
+
+    if(mDefaultShader == NULL)
+    {
+        mDefaultShader = new ShaderProgram(ShaderProgram::DefaultFragmentSource);
+    }
+
+    if(mDefaultShader->Use())
+    {
+        return mDefaultShader;
+    }
+
+    dsprintf("Shaders unavailable, using fixed function. %s\n",
+             mDefaultShader->GetLastError().c_str());
+    mUseShaders = false;
+    return NULL;
+}
+
+//
+// Same as FlushBatch's camera, the offset moves the verts before the camera
+// scale is applied.
+//
+void GraphicsPipeline::PushCamera(const Vector& position,
+                                  const Vector& scale,
+                                  float rotation,
+                                  float offsetX,
+                                  float offsetY)
+{
+    if(mActiveShader != NULL)
+    {
+        // Rotate(Scale(p + offset) + position), then into clip space.
+        float toClipX = 0;
+        float toClipY = 0;
+        ViewSize(&toClipX, &toClipY);
+        toClipX = 2.0f / toClipX;
+        toClipY = 2.0f / toClipY;
+        float radians = DegreeToRadian(rotation);
+        float c = cos(radians);
+        float s = sin(radians);
+        float sx = (float) scale.x;
+        float sy = (float) scale.y;
+        float qx = sx * offsetX + (float) position.x;
+        float qy = sy * offsetY + (float) position.y;
+
+        const float linear[4] =
+        {
+            c * sx * toClipX, -s * sy * toClipX,
+            s * sx * toClipY, c * sy * toClipY
+        };
+        mActiveShader->SetTransform(linear,
+                                    (c * qx - s * qy) * toClipX,
+                                    (s * qx + c * qy) * toClipY);
+        return;
+    }
+
+    glPushMatrix();
+    glRotatef(rotation, 0.f, 0.f, 1.f);
+    glTranslatef(position.x, position.y, position.z);
+    glScalef(scale.x, scale.y, scale.z);
+    if(offsetX != 0 || offsetY != 0)
+    {
+        glTranslatef(offsetX, offsetY, 0.f);
+    }
+}
+
+void GraphicsPipeline::PopCamera()
+{
+    if(mActiveShader == NULL)
+    {
+        glPopMatrix();
+    }
+}
+
+void GraphicsPipeline::PushShader(ShaderProgram* shader)
+{
+    assert(shader);
+    Flush();
+    mShaderStack.push_back(shader);
+}
+
+void GraphicsPipeline::PopShader()
+{
+    if(mShaderStack.empty())
+    {
+        return;
+    }
+
+    Flush();
+    mShaderStack.pop_back();
+}
+
+void GraphicsPipeline::BeginTarget(RenderTarget* target)
+{
+    assert(target);
+    if(mTarget != NULL)
+    {
+        EndTarget();
+    }
+
+    // Everything so far belongs to the screen.
+    Flush();
+    SubmitFrame();
+    mTarget = target;
+    if(mFrameClipped)
+    {
+        ApplyScissor(NULL); // or the target's clear is cut to it
+    }
+    mTarget->Begin();
+}
+
+void GraphicsPipeline::EndTarget()
+{
+    if(mTarget == NULL)
+    {
+        return;
+    }
+
+    Flush();
+    FinishTarget();
+}
+
+void GraphicsPipeline::FinishTarget()
+{
+    if(mTarget == NULL)
+    {
+        return;
+    }
+
+    SubmitFrame();
+    mTarget->End();
+    mTarget = NULL;
+    if(mFrameClipped)
+    {
+        ApplyScissor(NULL);
+    }
+}
+
+void GraphicsPipeline::ViewSize(float* width, float* height)
+{
+    if(mTarget != NULL)
+    {
+        *width = (float) mTarget->GetWidth();
+        *height = (float) mTarget->GetHeight();
+        return;
+    }
+
+    Dinodeck* dinodeck = Dinodeck::GetInstance();
+    *width = (float) dinodeck->ViewWidth();
+    *height = (float) dinodeck->ViewHeight();
+}
+
+//
+// Draws everything recorded this frame, uploading all of its verts at
+// once. Called after the script's update, and before anything that
+// draws straight from its own buffers.
+//
+void GraphicsPipeline::SubmitFrame()
+{
+    SubmitCommands(mFrameCommands);
+    mFrameCommands.Clear();
+}
+
+void GraphicsPipeline::SubmitCommands(const CommandList& list)
+{
+    if(list.IsEmpty())
+    {
+        return;
+    }
+
+    VertexStream* stream = Dinodeck::GetInstance()->GetVertexStream();
+    int first = 0;
+    if(list.VertCount() > 0)
+    {
+        first = stream->Upload(list.Verts(), list.VertCount());
+    }
+
+    const PackedVertex* base = NULL;
+    if(first < 0)
+    {
+        first = 0;
+        base = list.Verts();
+    }
+
+    ShaderProgram* shader = NULL;
+    BeginDraw(base, shader);
+
+    const std::vector<CommandList::Command>& commands = list.Commands();
+    for(std::vector<CommandList::Command>::const_iterator it = commands.begin();
+        it != commands.end();
+        ++it)
+    {
+        if(it->type == CommandList::SCISSOR)
+        {
+            ClipRect clip = { it->x, it->y, it->width, it->height };
+            ApplyScissor(&clip);
+            continue;
+        }
+
+        if(it->type == CommandList::SCISSOR_OFF)
+        {
+            ApplyScissor(NULL);
+            continue;
+        }
+
+        if(it->type == CommandList::DEPTH_CLEAR)
+        {
+            ApplyDepthPass(DEPTH_PASS_OFF, 0);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            continue;
+        }
+
+        const bool slotted = it->slots.count > 0 && mSlotShader != NULL;
+        ShaderProgram* drawShader = slotted ? mSlotShader : it->shader;
+        if(mUseShaders && drawShader != shader)
+        {
+            // Attribute pointers are shared by all programs.
+            shader = drawShader;
+            mActiveShader = UseShader(shader);
+        }
+
+        SetGLBlend((eBlendMode) it->blend);
+        ApplyDepthPass((eDepthPass) it->depthPass, it->depth);
+        ApplyDrawState(it->textureId, it->alphaTest);
+        ApplyUVBase(it->uvBase);
+        const unsigned char* slots = NULL;
+        if(slotted && mActiveShader == mSlotShader)
+        {
+            BindTextureSlots(it->slots);
+            slots = list.VertSlots() + it->firstVert;
+        }
+
+        PushCamera(Vector(it->camX, it->camY, it->camZ, 0),
+                   Vector(it->scaleX, it->scaleY, it->scaleZ, 0),
+                   it->rotation, 0, 0);
+        if(it->drawMode == QUADS)
+        {
+            DrawQuads(first + it->firstVert, it->vertCount, slots);
+        }
+        else
+        {
+            DrawArrays(it->drawMode, first + it->firstVert, it->vertCount);
+        }
+        PopCamera();
+    }
+
+    EndDraw();
+    ApplyDepthPass(DEPTH_PASS_OFF, 0);
+    stream->Unbind();
+}
+
+void GraphicsPipeline::SetRecordFrames(bool value)
+{
+    if(!value)
+    {
+        SubmitFrame();
+    }
+    mRecordFrames = value;
+}
+
+void GraphicsPipeline::ApplyDrawState(GLuint textureId, bool alphaTest)
+{
+    if(mActiveShader != NULL)
+    {
+        if(textureId != 0)
+        {
+            mGLState.BindTexture(textureId);
+        }
+        mGLState.Disable(GL_ALPHA_TEST);
+        mActiveShader->SetDrawState(textureId != 0, alphaTest);
+        return;
+    }
+
+    // Needs a test
+    if(textureId == 0)
+    {
+        mGLState.Disable(GL_TEXTURE_2D);
+    }
+    else
+    {
+        mGLState.Enable(GL_TEXTURE_2D);
+        // FTGL binds its own textures when it lazily loads glyphs, text
+        // layout invalidates the cached binding when that might happen.
+        mGLState.BindTexture(textureId);
+    }
+
+    // Distance fields store 0.5 on the glyph outline.
+    if(alphaTest)
+    {
+        mGLState.Enable(GL_ALPHA_TEST);
+        glAlphaFunc(GL_GEQUAL, 0.5f);
+    }
+    else
+    {
+        mGLState.Disable(GL_ALPHA_TEST);
+    }
+}
+
+void GraphicsPipeline::FlushBatch(eFlushReason reason)
+{
+
+    if(mVertCount == 0)
+    {
+        return; // Nothing to flush.
+    }
+
+    mStats.flushes[reason]++;
+
+    // A batch of only untextured quads needs no slots.
+    const TextureSlots slots = mSlots;
+    mSlots = TextureSlots();
+    const bool slotted = mTextureId == SLOT_BATCH && slots.count > 0;
+    const GLuint textureId = !slotted ? (mTextureId == SLOT_BATCH ? 0 : mTextureId)
+                                      : slots.ids[0];
+    const TextureSlots* batchSlots = slotted ? &slots : NULL;
+    const unsigned char* vertSlots = slotted ? &mVertexSlots[0] : NULL;
+    assert(!slotted || mDrawMode == QUADS);
+
+    // Recorded layers are drawn with the camera, so they're never baked.
+    BakeCamera();
+    const bool baked = mBakeCamera && mRecording == NULL;
+    const Vector& camPosition = baked ? BakedCameraPosition : mCamPosition;
+    const Vector& camScale = baked ? BakedCameraScale : mCamScale;
+    const float camRotation = baked ? 0 : mRotateAngle;
+
+    // Glyphs laid out since the last batch go up together, before
+    // anything can draw them.
+    unsigned int glyphBytes = FormatText::UploadGlyphs();
+    if(glyphBytes > 0)
+    {
+        mStats.glyphUploadBytes += glyphBytes;
+        mGLState.InvalidateTexture();
+    }
+
+    if(DrawCapture::IsCapturing() && mRecording == NULL)
+    {
+        DrawCapture::RecordBatch(&mVertexBuffer[0], mVertCount, reason,
+                                 mDrawMode, textureId, mAlphaTest, mBatchBlend,
+                                 mUVBase, mBatchDepthPass, mBatchDepth, CurrentShader(),
+                                 camPosition, camScale, camRotation, mRecordFrames,
+                                 batchSlots, vertSlots);
+    }
+
+    if(mRecording != NULL)
+    {
+        mRecording->Append(&mVertexBuffer[0], mVertCount,
+                           mDrawMode, textureId, mAlphaTest, mBatchBlend, mUVBase);
+        mVertCount = 0;
+        mBakedVertCount = 0;
+        return;
+    }
+
+    if(mRecordFrames)
+    {
+        if(mFrameCommands.AppendDraw(&mVertexBuffer[0], mVertCount,
+                                     mDrawMode, textureId, mAlphaTest, mBatchBlend,
+                                     mUVBase, mBatchDepthPass, mBatchDepth,
+                                     CurrentShader(),
+                                     camPosition, camScale, camRotation,
+                                     batchSlots, vertSlots))
+        {
+            mStats.mergedBatches++;
+        }
+        mVertCount = 0;
+        mBakedVertCount = 0;
+        return;
+    }
+
+    // When streaming, the pointers are offsets into the bound buffer.
+    VertexStream* stream = Dinodeck::GetInstance()->GetVertexStream();
+    int first = stream->Upload(&mVertexBuffer[0], mVertCount);
+    const PackedVertex* base = NULL;
+    if(first < 0)
+    {
+        first = 0;
+        base = &mVertexBuffer[0];
+    }
+
+    BeginDraw(base, slotted ? mSlotShader : CurrentShader());
+    SetGLBlend(mBatchBlend);
+    ApplyDepthPass(mBatchDepthPass, mBatchDepth);
+    ApplyDrawState(textureId, mAlphaTest);
+    ApplyUVBase(mUVBase);
+    if(slotted && mActiveShader == mSlotShader)
+    {
+        BindTextureSlots(slots);
+    }
+    else
+    {
+        vertSlots = NULL;
+    }
+
+    //
+    // Send off the draw commands
+    //
+    PushCamera(camPosition, camScale, camRotation, 0, 0);
+    if(mDrawMode == QUADS)
+    {
+        DrawQuads(first, mVertCount, vertSlots);
+    }
+    else
+    {
+        DrawArrays(mDrawMode, first, mVertCount);
+    }
+    PopCamera();
+    EndDraw();
+    // Other code draws without asking for depth.
+    ApplyDepthPass(DEPTH_PASS_OFF, 0);
+
+    // The client arrays stay enabled for the next batch, other code that
+    // draws sets its own pointers.
+    stream->Unbind();
+
+    //
+    // Reset the vert array
+    //
+    mVertCount = 0;
+    mBakedVertCount = 0;
+}
+
+void GraphicsPipeline::BakeCamera()
+{
+    // Verts from the queue were moved when they were recorded.
+    if(mBakeCamera && mRecording == NULL && !mPushingBaked
+       && mBakedVertCount < mVertCount)
+    {
+        const CameraTransform camera(mCamPosition, mCamScale, mRotateAngle);
+        for(unsigned int i = mBakedVertCount; i < mVertCount; i++)
+        {
+            camera.Apply(&mVertexBuffer[i].x, &mVertexBuffer[i].y);
+        }
+    }
+    mBakedVertCount = mVertCount;
+}
+
+void GraphicsPipeline::SetCameraBaked(bool value)
+{
+    if(mBakeCamera == value)
+    {
+        return;
+    }
+
+    // What's been pushed is drawn the way it was pushed.
+    Flush();
+    mBakeCamera = value;
+}
+
+void GraphicsPipeline::BeginStatic(int handle)
+{
+    EndStatic();
+
+    if(handle <= 0)
+    {
+        handle = mNextStaticHandle++;
+    }
+
+    StaticLayer*& layer = mStaticLayers[handle];
+    if(layer == NULL)
+    {
+        layer = new StaticLayer();
+    }
+    layer->Clear();
+
+    // Verts already pushed belong to the frame, not the layer.
+    Flush();
+    mRecording = layer;
+    mRecordingHandle = handle;
+}
+
+int GraphicsPipeline::EndStatic()
+{
+    if(mRecording == NULL)
+    {
+        return 0;
+    }
+
+    Flush();
+    mRecording->Upload();
+    mRecording = NULL;
+    return mRecordingHandle;
+}
+
+bool GraphicsPipeline::DrawStatic(int handle)
+{
+    std::map<int, StaticLayer*>::iterator it = mStaticLayers.find(handle);
+
+    // Layers aren't recorded into each other.
+    if(it == mStaticLayers.end() || it->second == mRecording)
+    {
+        return false;
+    }
+
+    StaticLayer* layer = it->second;
+    if(layer->IsLost())
+    {
+        return false;
+    }
+
+    if(layer->VertCount() == 0)
+    {
+        return true;
+    }
+
+    // Keep the order with what was pushed before.
+    ScissorUnclipped();
+    Flush();
+    SubmitFrame();
+    DrawLayer(layer, 0, 0);
+    return true;
+}
+
+//
+// Draws each range of a layer with the camera, the batch must already be
+// flushed. The offset moves the layer in world space.
+//
+void GraphicsPipeline::DrawLayer(StaticLayer* layer, float offsetX, float offsetY, GLuint textureId)
+{
+    BeginDraw(layer->Bind(), CurrentShader());
+    PushCamera(mCamPosition, mCamScale, mRotateAngle, offsetX, offsetY);
+
+    const std::vector<StaticLayer::Range>& ranges = layer->Ranges();
+    for(std::vector<StaticLayer::Range>::const_iterator range = ranges.begin();
+        range != ranges.end();
+        ++range)
+    {
+        SetGLBlend((eBlendMode) range->blend);
+        ApplyDrawState(range->textureId != 0 ? range->textureId : textureId,
+                       range->alphaTest);
+        ApplyUVBase(range->uvBase);
+        DrawArrays(range->drawMode, range->firstVert, range->vertCount);
+    }
+
+    PopCamera();
+    EndDraw();
+    layer->Unbind();
+}
+
+//
+// Meshes keep the order with what was pushed before, like static layers.
+//
+bool GraphicsPipeline::DrawMesh(Mesh* mesh, float x, float y)
+{
+    assert(mesh);
+
+    if(mesh->VertCount() == 0 || mRecording != NULL)
+    {
+        return false;
+    }
+
+    // Looked up each draw, the texture can be destroyed and made again.
+    Texture* texture = NULL;
+    GLuint textureId = 0;
+    if(!mesh->TextureName().empty())
+    {
+        TextureManager* textures = Texture::Residency();
+        texture = textures ? textures->GetTexture(mesh->TextureName().c_str()) : NULL;
+        if(texture == NULL)
+        {
+            return false;
+        }
+        texture->MarkUsed();
+        textureId = texture->GetId();
+    }
+
+    if(IsOffScreen(x + mesh->CentreX(), y + mesh->CentreY(), mesh->Radius()))
+    {
+        return true;
+    }
+
+    ScissorUnclipped();
+    Flush();
+    SubmitFrame();
+    DrawLayer(mesh->Prepare(texture), x, y, textureId);
+    return true;
+}
+
+//
+// Particles are written straight into the batch as square quads centred
+// on each particle. Like lines they act as barriers for deferred commands.
+//
+void GraphicsPipeline::PushParticles(const ParticleEmitter& emitter)
+{
+    const unsigned int count = emitter.Count();
+    if(count == 0)
+    {
+        return;
+    }
+
+    Texture* texture = emitter.GetTexture();
+    if(texture != NULL)
+    {
+        texture->MarkUsed();
+    }
+    GLuint textureId = (texture == NULL) ? 0 : texture->GetId();
+
+    ScissorUnclipped();
+    if(!mCommands.empty())
+    {
+        Flush();
+    }
+
+    // Static layers are recorded as triangles, like PrepareQuad's quads.
+    const eDrawMode quadMode = mRecording == NULL ? QUADS : TRIANGLES;
+    const unsigned int numVerts = quadMode == QUADS ? 4 : 6;
+    if(mDrawMode != quadMode || mTextureId != textureId || mAlphaTest
+       || !mUVBase.IsDefault())
+    {
+        FlushBatch(mDrawMode != quadMode ? FLUSH_MODE
+                   : mAlphaTest ? FLUSH_TEXT
+                   : FLUSH_TEXTURE);
+        mDrawMode = quadMode;
+        mTextureId = textureId;
+        mAlphaTest = false;
+        mUVBase = UVBase();
+    }
+    UseBatchBlend(BatchBlend(mBlendMode, texture != NULL
+                                         ? texture->IsPremultiplied()
+                                         : Texture::Premultiplies()));
+
+    const short u0 = PackedVertex::PackUV(texture ? texture->MapU(0) : 0);
+    const short v0 = PackedVertex::PackUV(texture ? texture->MapV(0) : 0);
+    const short u1 = PackedVertex::PackUV(texture ? texture->MapU(1) : 1);
+    const short v1 = PackedVertex::PackUV(texture ? texture->MapV(1) : 1);
+
+    const Vector& start = emitter.StartColour();
+    const Vector& end = emitter.EndColour();
+    const float startSize = emitter.StartSize();
+    const float sizeChange = emitter.EndSize() - startSize;
+    const float* x = emitter.X();
+    const float* y = emitter.Y();
+    const float* age = emitter.Age();
+
+    for(unsigned int i = 0; i < count; i++)
+    {
+        if(ReserveVerts(numVerts))
+        {
+            FlushBatch(FLUSH_CAPACITY);
+        }
+
+        const float t = age[i];
+        const float half = (startSize + sizeChange * t) * 0.5f;
+        const float left = x[i] - half;
+        const float right = x[i] + half;
+        const float top = y[i] + half;
+        const float bottom = y[i] - half;
+
+        float r = (float) (start.x + (end.x - start.x) * t);
+        float g = (float) (start.y + (end.y - start.y) * t);
+        float b = (float) (start.z + (end.z - start.z) * t);
+        float a = (float) (start.w + (end.w - start.w) * t);
+        BatchColour(&r, &g, &b, &a);
+
+        PackedVertex* quad = &mVertexBuffer[mVertCount];
+        PackedVertex& tl = quad[0];
+        tl.r = PackedVertex::PackColour(r);
+        tl.g = PackedVertex::PackColour(g);
+        tl.b = PackedVertex::PackColour(b);
+        tl.a = PackedVertex::PackColour(a);
+        tl.x = left;
+        tl.y = top;
+        tl.u = u0;
+        tl.v = v0;
+
+        // TL, TR, BL, BR as sprites are
+        quad[1] = tl;
+        quad[1].x = right;
+        quad[1].u = u1;
+
+        quad[2] = tl;
+        quad[2].y = bottom;
+        quad[2].v = v1;
+
+        quad[3] = quad[2];
+        quad[3].x = right;
+        quad[3].u = u1;
+
+        if(numVerts == 6)
+        {
+            QuadToTriangles(quad);
+        }
+        mVertCount += numVerts;
+    }
+}
+
+void GraphicsPipeline::PushTilemap(Tilemap* tilemap)
+{
+    assert(tilemap);
+
+    // Chunks already keep their own buffers and their verts aren't kept
+    // on the CPU to copy, so tilemaps aren't baked into static layers.
+    if(mRecording != NULL)
+    {
+        return;
+    }
+
+    // Chunks are drawn straight from their buffers, after anything
+    // recorded before them.
+    ScissorUnclipped();
+    Flush();
+    SubmitFrame();
+
+    for(unsigned int i = 0; i < tilemap->ChunkCount(); i++)
+    {
+        float left, top, right, bottom;
+        tilemap->ChunkBounds(i, &left, &top, &right, &bottom);
+        float halfWidth = (right - left) * 0.5f;
+        float halfHeight = (top - bottom) * 0.5f;
+        if(IsOffScreen(left + halfWidth,
+                       bottom + halfHeight,
+                       sqrt(halfWidth * halfWidth + halfHeight * halfHeight)))
+        {
+            continue;
+        }
+
+        // Only visible chunks are rebuilt.
+        StaticLayer* layer = tilemap->GetChunk(i);
+        if(layer->VertCount() == 0)
+        {
+            continue;
+        }
+
+        // Chunk verts are relative to the map's top left corner.
+        DrawLayer(layer, tilemap->GetPosition().x, tilemap->GetPosition().y);
+    }
+}
+
+void GraphicsPipeline::FreeStatic(int handle)
+{
+    std::map<int, StaticLayer*>::iterator it = mStaticLayers.find(handle);
+    if(it == mStaticLayers.end())
+    {
+        return;
+    }
+
+    // Anything still waiting to be flushed would have gone into it.
+    if(it->second == mRecording)
+    {
+        mCommands.clear();
+        mQueuedVerts.clear();
+        mVertCount = 0;
+        mBakedVertCount = 0;
+        mRecording = NULL;
+    }
+    delete it->second;
+    mStaticLayers.erase(it);
+}
+
+void GraphicsPipeline::ResetStatic()
+{
+    for(std::map<int, StaticLayer*>::iterator it = mStaticLayers.begin();
+        it != mStaticLayers.end();
+        ++it)
+    {
+        it->second->Reset();
+    }
+}
+
+GraphicsPipeline::~GraphicsPipeline()
+{
+    for(std::map<int, StaticLayer*>::iterator it = mStaticLayers.begin();
+        it != mStaticLayers.end();
+        ++it)
+    {
+        delete it->second;
+    }
+}
+
+void GraphicsPipeline::SetBatchSize(unsigned int verts)
+{
+    // The largest single primitive is a sprite or rect.
+    verts = std::max(verts, 6u);
+
+    if(verts < mVertCount)
+    {
+        FlushBatch();
+    }
+    mBatchSize = verts;
+    if(!mVertexBuffer.empty())
+    {
+        mVertexBuffer.resize(verts);
+    }
+}
+
+//
+// Grows the batch if a single primitive won't fit, otherwise returns true
+// if the queued verts need to be flushed to make room.
+//
+bool GraphicsPipeline::ReserveVerts(unsigned int numVerts)
 {
-
-    if(mVertCount == 0)
+    // Renderers that are made but never drawn with don't hold a batch.
+    if(mVertexBuffer.empty())
     {
-        return; // Nothing to flush.
+        mVertexBuffer.resize(mBatchSize);
     }
 
-    // Needs a test
-    if(mTexture == NULL)
+    if(numVerts > mVertexBuffer.size())
     {
-        glDisable(GL_TEXTURE_2D);
+        FlushBatch();
+        mVertexBuffer.resize(numVerts);
+        mBatchSize = numVerts;
+        return false;
     }
-    else
+
+    if(mVertCount + numVerts > mVertexBuffer.size())
     {
-        glEnable(GL_TEXTURE_2D);
+        mCapacityFlushCount++;
+        return true;
     }
+    return false;
+}
 
-    glVertexPointer(POSITION_SIZE, GL_FLOAT, sizeof(Vertex), mVertexBuffer);
-    glEnableClientState(GL_VERTEX_ARRAY);
-
-    glColorPointer(COLOUR_SIZE, GL_FLOAT, sizeof(Vertex), &mVertexBuffer[0].r);
-    glEnableClientState(GL_COLOR_ARRAY);
+//
+// Points around a unit circle for a segment count, so circles drawn
+// every frame don't call cos and sin per segment.
+//
+const std::vector<float>& GraphicsPipeline::UnitCircle(float segments)
+{
+    std::map<float, std::vector<float> >::iterator
+        it = mUnitCircles.find(segments);
+    if(it != mUnitCircles.end())
+    {
+        return it->second;
+    }
 
-    glTexCoordPointer(TEXCOORD_SIZE, GL_FLOAT, sizeof(Vertex), &mVertexBuffer[0].u);
-    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    // Animated segment counts shouldn't grow the cache forever.
+    if(mUnitCircles.size() >= MAX_UNIT_CIRCLES)
+    {
+        mUnitCircles.clear();
+    }
 
-    //
-    // Send off the draw commands
-    //
-    glPushMatrix();
+    std::vector<float>& points = mUnitCircles[segments];
+    for (int i = 0; i < segments; i++)
     {
-        glRotatef(mRotateAngle, 0.f, 0.f, 1.f);
-        glTranslatef(mCamPosition.x, mCamPosition.y, mCamPosition.z);
-        glScalef(mCamScale.x, mCamScale.y, mCamScale.z);
+        float angle = i * ((2 * PI) / segments);
+        points.push_back(cos(angle));
+        points.push_back(sin(angle));
+    }
+    return points;
+}
 
+//
+// Lines are drawn as separate segments, so they batch with each other.
+// They still act as barriers for deferred commands.
+//
+void GraphicsPipeline::ReserveLines(unsigned int numVerts)
+{
+    ScissorUnclipped();
+    bool needToFlush = ReserveVerts(numVerts);
 
-        glDrawArrays(mDrawMode, 0, mVertCount);
+    if(needToFlush || mDrawMode != LINES || !mCommands.empty())
+    {
+        Flush(needToFlush ? FLUSH_CAPACITY
+              : mDrawMode != LINES ? FLUSH_MODE
+              : FLUSH_OTHER);
+        mDrawMode = LINES;
+        mTextureId = 0;
+        mAlphaTest = false;
+        mUVBase = UVBase();
     }
-    glPopMatrix();
+    UseBatchBlend(BatchBlend(mBlendMode, Texture::Premultiplies()));
+}
 
-    //
-    // Disable the various pointers
-    //
-    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-    glDisableClientState(GL_COLOR_ARRAY);
-    glDisableClientState(GL_VERTEX_ARRAY);
+//
+// Bounding circle test against the view, cheap enough to do for every
+// primitive before any verts are made. The camera is applied as in
+// FlushBatch, scale then translate then rotate about the view centre.
+//
+bool GraphicsPipeline::IsOffScreen(float x, float y, float radius)
+{
+    if(IsOutsideView(x, y, radius))
+    {
+        mCulledCount++;
+        return true;
+    }
+    return false;
+}
 
+bool GraphicsPipeline::IsOutsideView(float x, float y, float radius) const
+{
+    // The camera a static layer is drawn with isn't known yet.
+    if(!mCulling || mRecording != NULL)
+    {
+        return false;
+    }
 
-    //
-    // Reset the vert array
-    //
-    mVertCount = 0;
+    float halfWidth = 0;
+    float halfHeight = 0;
+    ViewSize(&halfWidth, &halfHeight);
+    halfWidth *= 0.5f;
+    halfHeight *= 0.5f;
+    float cx = x * mCamScale.x + mCamPosition.x;
+    float cy = y * mCamScale.y + mCamPosition.y;
+    float r = radius * std::max(std::abs(mCamScale.x), std::abs(mCamScale.y));
+    bool offScreen = false;
+
+    if(mRotateAngle == 0)
+    {
+        offScreen = std::abs(cx) > halfWidth + r
+                 || std::abs(cy) > halfHeight + r;
+    }
+    else
+    {
+        // Rotating about the centre doesn't change the distance from it,
+        // so test against the circle around the view instead.
+        float reach = sqrt(halfWidth * halfWidth + halfHeight * halfHeight) + r;
+        offScreen = (cx * cx + cy * cy) > (reach * reach);
+    }
+    return offScreen;
 }
 
 void GraphicsPipeline::PushCircle(float x,
@@ -88,52 +1912,327 @@ void GraphicsPipeline::PushCircle(float x,
                                   float segments,
                                   const Vector& colour)
 {
+    const std::vector<float>& points = UnitCircle(segments);
+    unsigned int numPoints = points.size() / 2;
 
-    unsigned int numVerts = (2 * segments) + 2;
-    assert(numVerts < BUFFER_SIZE_IN_VERTS);
-    bool needToFlush = mVertCount + numVerts >= BUFFER_SIZE_IN_VERTS;
-
-    if(needToFlush || mDrawMode != LINES)
+    if(numPoints == 0 || IsOffScreen(x, y, std::abs(radius)))
     {
-        Flush();
-        mDrawMode = LINES;
+        return;
     }
 
+    ReserveLines(numPoints * 2);
+    const Vector batchColour = BatchColour(colour);
 
-    float prevXPos = 0;
-    float prevYPos = 0;
+    float prevXPos = radius * points[0] + x;
+    float prevYPos = radius * points[1] + y;
 
-    for (int i = 0; i < segments; i++)
+    // The last segment joins back up with the first point.
+    for (unsigned int i = 1; i <= numPoints; i++)
     {
-        float angle = i * ((2 * PI) / segments);
-        float xpos = radius * cos(angle) + x;
-        float ypos = radius * sin(angle) + y;
+        unsigned int point = (i % numPoints) * 2;
+        float xpos = radius * points[point] + x;
+        float ypos = radius * points[point + 1] + y;
 
-        if (i > 0)
-        {
-            mVertexBuffer[mVertCount] = Vertex(prevXPos, prevYPos, 0.f, colour);
-            mVertCount++;
-            mVertexBuffer[mVertCount] = Vertex(xpos, ypos, 0.f, colour);
-            mVertCount++;
-        }
+        mVertexBuffer[mVertCount] = PackedVertex(Vertex(prevXPos, prevYPos, 0.f, batchColour));
+        mVertCount++;
+        mVertexBuffer[mVertCount] = PackedVertex(Vertex(xpos, ypos, 0.f, batchColour));
+        mVertCount++;
 
         prevXPos = xpos;
         prevYPos = ypos;
     }
+}
+
+//
+// Triangles other than rects, untextured but for PushVertices'. The
+// deferred queue only holds quads, so like lines these act as barriers for
+// deferred commands.
+//
+void GraphicsPipeline::ReserveTriangles(unsigned int numVerts)
+{
+    ReserveTriangles(numVerts, 0, Texture::Premultiplies());
+}
 
-    // Join up last segment
-    float angle = 0;
-    float xpos = radius * cos(angle) + x;
-    float ypos = radius * sin(angle) + y;
+void GraphicsPipeline::ReserveTriangles(unsigned int numVerts,
+                                        GLuint textureId,
+                                        bool premultiplied)
+{
+    ScissorUnclipped();
+    bool needToFlush = ReserveVerts(numVerts);
+
+    if(needToFlush
+       || mDrawMode != TRIANGLES
+       || mTextureId != textureId
+       || mAlphaTest
+       || !mUVBase.IsDefault()
+       || !mCommands.empty())
+    {
+        eFlushReason reason = FLUSH_OTHER;
+        if(needToFlush)
+        {
+            reason = FLUSH_CAPACITY;
+        }
+        else if(mDrawMode != TRIANGLES)
+        {
+            reason = FLUSH_MODE;
+        }
+        else if(mAlphaTest)
+        {
+            reason = FLUSH_TEXT;
+        }
+        else if(mTextureId != textureId)
+        {
+            reason = FLUSH_TEXTURE;
+        }
+        Flush(reason);
+        mDrawMode = TRIANGLES;
+        mTextureId = textureId;
+        mAlphaTest = false;
+        mUVBase = UVBase();
+    }
+    UseBatchBlend(BatchBlend(mBlendMode, premultiplied));
+}
 
-    mVertexBuffer[mVertCount] = Vertex(prevXPos, prevYPos, 0.f, colour);
+void GraphicsPipeline::PushTriangle(float x1, float y1,
+                                    float x2, float y2,
+                                    float x3, float y3,
+                                    const Vector& colour)
+{
+    const Vector batchColour = BatchColour(colour);
+    mVertexBuffer[mVertCount] = PackedVertex(Vertex(x1, y1, 0.f, batchColour));
+    mVertCount++;
+    mVertexBuffer[mVertCount] = PackedVertex(Vertex(x2, y2, 0.f, batchColour));
     mVertCount++;
-    mVertexBuffer[mVertCount] = Vertex(xpos, ypos, 0.f, colour);
+    mVertexBuffer[mVertCount] = PackedVertex(Vertex(x3, y3, 0.f, batchColour));
     mVertCount++;
+}
 
-    // I don't think I should need this but I'm getting connections between
-    // circles. Something to look into.
-    Flush();
+void GraphicsPipeline::PushFilledCircle(float x,
+                                        float y,
+                                        float radius,
+                                        float segments,
+                                        const Vector& colour)
+{
+    const std::vector<float>& points = UnitCircle(segments);
+    unsigned int numPoints = points.size() / 2;
+
+    if(numPoints < 3 || IsOffScreen(x, y, std::abs(radius)))
+    {
+        return;
+    }
+
+    ReserveTriangles(numPoints * 3);
+
+    for (unsigned int i = 0; i < numPoints; i++)
+    {
+        unsigned int point = i * 2;
+        unsigned int next = ((i + 1) % numPoints) * 2;
+        PushTriangle(x, y,
+                     radius * points[point] + x, radius * points[point + 1] + y,
+                     radius * points[next] + x, radius * points[next + 1] + y,
+                     colour);
+    }
+}
+
+void GraphicsPipeline::PushPolygon(const float* points,
+                                   unsigned int numPoints,
+                                   const Vector& colour)
+{
+    assert(points);
+
+    if(numPoints < 3)
+    {
+        return;
+    }
+
+    ReserveTriangles((numPoints - 2) * 3);
+
+    // A fan from the first point
+    for (unsigned int i = 1; i < numPoints - 1; i++)
+    {
+        PushTriangle(points[0], points[1],
+                     points[i * 2], points[i * 2 + 1],
+                     points[i * 2 + 2], points[i * 2 + 3],
+                     colour);
+    }
+}
+
+//
+// Triangles go in as runs that fit the batch. Quads go in as sprites do,
+// so they're sorted, clipped and share batches with them.
+//
+void GraphicsPipeline::PushVertices(const PackedVertex* verts,
+                                    unsigned int count,
+                                    Texture* texture,
+                                    eDrawMode mode)
+{
+    assert(verts);
+    assert(mode == TRIANGLES || mode == QUADS);
+
+    const unsigned int primitive = mode == QUADS ? 4 : 3;
+    count -= count % primitive;
+    if(count == 0)
+    {
+        return;
+    }
+
+    GLuint textureId = 0;
+    bool premultiplied = Texture::Premultiplies();
+    if(texture != NULL)
+    {
+        texture->MarkUsed();
+        textureId = texture->GetId();
+        premultiplied = texture->IsPremultiplied();
+    }
+
+    if(mode == QUADS)
+    {
+        for(unsigned int i = 0; i < count; i += 4)
+        {
+            PushPackedQuad(&verts[i], texture, textureId, premultiplied);
+        }
+        return;
+    }
+
+    const unsigned int run = std::max(mBatchSize / 3, 1u) * 3;
+    for(unsigned int first = 0; first < count; first += run)
+    {
+        const unsigned int runVerts = std::min(run, count - first);
+        ReserveTriangles(runVerts, textureId, premultiplied);
+        CopyVerts(&verts[first], runVerts, texture, &mVertexBuffer[mVertCount]);
+        mVertCount += runVerts;
+    }
+}
+
+void GraphicsPipeline::CopyVerts(const PackedVertex* verts,
+                                 unsigned int count,
+                                 const Texture* texture,
+                                 PackedVertex* out) const
+{
+    std::copy(verts, verts + count, out);
+
+    if(texture != NULL)
+    {
+        const float u0 = texture->MapU(0);
+        const float v0 = texture->MapV(0);
+        const float u1 = texture->MapU(1);
+        const float v1 = texture->MapV(1);
+        if(u0 != 0 || v0 != 0 || u1 != 1 || v1 != 1)
+        {
+            const float toUV = 1.0f / PackedVertex::UV_ONE;
+            for(unsigned int i = 0; i < count; i++)
+            {
+                out[i].u = PackedVertex::PackUV(u0 + out[i].u * toUV * (u1 - u0));
+                out[i].v = PackedVertex::PackUV(v0 + out[i].v * toUV * (v1 - v0));
+            }
+        }
+    }
+
+    if(mBatchBlend < BLEND_PREMULTIPLIED)
+    {
+        return;
+    }
+
+    for(unsigned int i = 0; i < count; i++)
+    {
+        float r = out[i].r / 255.0f;
+        float g = out[i].g / 255.0f;
+        float b = out[i].b / 255.0f;
+        float a = out[i].a / 255.0f;
+        BatchColour(&r, &g, &b, &a);
+        out[i].r = PackedVertex::PackColour(r);
+        out[i].g = PackedVertex::PackColour(g);
+        out[i].b = PackedVertex::PackColour(b);
+        out[i].a = PackedVertex::PackColour(a);
+    }
+}
+
+void GraphicsPipeline::PushPackedQuad(const PackedVertex* quad,
+                                      const Texture* texture,
+                                      GLuint textureId,
+                                      bool premultiplied)
+{
+    if(!mDeferred && mClips.empty())
+    {
+        const unsigned int numVerts = PrepareQuad(textureId, false, premultiplied);
+        PackedVertex* out = &mVertexBuffer[mVertCount];
+        CopyVerts(quad, 4, texture, out);
+        if(numVerts == 6)
+        {
+            QuadToTriangles(out);
+        }
+        mVertCount += numVerts;
+        return;
+    }
+
+    // The deferred queue and clipping work on Vertex, as two triangles
+    // TL TR BL TR BR BL.
+    static const unsigned int corners[6] = { 0, 1, 2, 1, 3, 2 };
+    const float toUV = 1.0f / PackedVertex::UV_ONE;
+    Vertex verts[6];
+    for(unsigned int i = 0; i < 6; i++)
+    {
+        const PackedVertex& corner = quad[corners[i]];
+        float u = corner.u * toUV;
+        float v = corner.v * toUV;
+        if(texture != NULL)
+        {
+            u = texture->MapU(u);
+            v = texture->MapV(v);
+        }
+        verts[i] = Vertex(corner.x, corner.y, 0,
+                          corner.r / 255.0f, corner.g / 255.0f,
+                          corner.b / 255.0f, corner.a / 255.0f,
+                          u, v);
+    }
+
+    if(mDeferred)
+    {
+        RecordQuad(verts, textureId, false, premultiplied);
+    }
+    else
+    {
+        PushQuad(verts, textureId, false, premultiplied);
+    }
+}
+
+void GraphicsPipeline::PushLines(const float* points,
+                                 unsigned int numPoints,
+                                 float width,
+                                 const Vector& colour)
+{
+    assert(points);
+
+    if(numPoints < 2)
+    {
+        return;
+    }
+
+    ReserveTriangles((numPoints - 1) * 6);
+    float halfWidth = width / 2;
+
+    for (unsigned int i = 0; i < numPoints - 1; i++)
+    {
+        float x1 = points[i * 2];
+        float y1 = points[i * 2 + 1];
+        float x2 = points[i * 2 + 2];
+        float y2 = points[i * 2 + 3];
+
+        float dx = x2 - x1;
+        float dy = y2 - y1;
+        float length = sqrt(dx * dx + dy * dy);
+        if(length == 0)
+        {
+            continue;
+        }
+
+        // Perpendicular to the segment, half the width long
+        float nx = (-dy / length) * halfWidth;
+        float ny = (dx / length) * halfWidth;
+
+        PushTriangle(x1 + nx, y1 + ny, x2 + nx, y2 + ny, x1 - nx, y1 - ny, colour);
+        PushTriangle(x2 + nx, y2 + ny, x2 - nx, y2 - ny, x1 - nx, y1 - ny, colour);
+    }
 }
 
 void GraphicsPipeline::PushRectangle(float bottom,
@@ -142,18 +2241,16 @@ void GraphicsPipeline::PushRectangle(float bottom,
                                      float right,
                                      const Vector& colour)
 {
-    unsigned int numVerts = 6; // Two triangles
-    assert(numVerts < BUFFER_SIZE_IN_VERTS);
-    bool needToFlush = mVertCount + numVerts >= BUFFER_SIZE_IN_VERTS;
-
-    if(needToFlush || mDrawMode != TRIANGLES || mTexture != NULL)
+    float halfWidth = std::abs(right - left) * 0.5f;
+    float halfHeight = std::abs(top - bottom) * 0.5f;
+    if(IsOffScreen((left + right) * 0.5f,
+                   (top + bottom) * 0.5f,
+                   sqrt(halfWidth * halfWidth + halfHeight * halfHeight)))
     {
-        Flush();
-        mDrawMode = TRIANGLES;
+        return;
     }
 
-    glDisable( GL_TEXTURE_2D );
-    mTexture = NULL;
+    Vertex quad[6];
 
     /*
         1. TL
@@ -162,12 +2259,9 @@ void GraphicsPipeline::PushRectangle(float bottom,
          |    \
         3. BL--2.BR
     */
-    mVertexBuffer[mVertCount] = Vertex(left, top, 0.f, colour);
-    mVertCount++;
-    mVertexBuffer[mVertCount] = Vertex(right, bottom, 0.f, colour);
-    mVertCount++;
-    mVertexBuffer[mVertCount] = Vertex(left, bottom, 0.f, colour);
-    mVertCount++;
+    quad[0] = Vertex(left, top, 0.f, colour);
+    quad[1] = Vertex(right, bottom, 0.f, colour);
+    quad[2] = Vertex(left, bottom, 0.f, colour);
 
     /* My ASCII art is terrible.
           1.TL----2. TR
@@ -176,127 +2270,793 @@ void GraphicsPipeline::PushRectangle(float bottom,
                 \  |
                 3. BR
     */
-    mVertexBuffer[mVertCount] = Vertex(left, top, 0.f, colour);
-    mVertCount++;
-    mVertexBuffer[mVertCount] = Vertex(right, top, 0.f, colour);
-    mVertCount++;
-    mVertexBuffer[mVertCount] = Vertex(right, bottom, 0.f, colour);
-    mVertCount++;
+    quad[3] = Vertex(left, top, 0.f, colour);
+    quad[4] = Vertex(right, top, 0.f, colour);
+    quad[5] = Vertex(right, bottom, 0.f, colour);
+
+    if(mDeferred)
+    {
+        RecordQuad(quad, 0, false, Texture::Premultiplies());
+    }
+    else
+    {
+        PushQuad(quad, 0, false, Texture::Premultiplies());
+    }
 }
 
+void GraphicsPipeline::PushNineSlice(const Texture* texture,
+                                     float left,
+                                     float bottom,
+                                     float right,
+                                     float top,
+                                     const float* borders,
+                                     const Vector& colour)
+{
+    assert(texture);
+    assert(borders);
+
+    float halfWidth = std::abs(right - left) * 0.5f;
+    float halfHeight = std::abs(top - bottom) * 0.5f;
+    if(IsOffScreen((left + right) * 0.5f,
+                   (top + bottom) * 0.5f,
+                   sqrt(halfWidth * halfWidth + halfHeight * halfHeight)))
+    {
+        return;
+    }
+
+    const float width = (float) texture->GetWidth();
+    const float height = (float) texture->GetHeight();
+    if(width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    float borderLeft = std::max(borders[0], 0.0f);
+    float borderBottom = std::max(borders[1], 0.0f);
+    float borderRight = std::max(borders[2], 0.0f);
+    float borderTop = std::max(borders[3], 0.0f);
+    const float across = std::abs(right - left);
+    const float up = std::abs(top - bottom);
+    if(borderLeft + borderRight > across)
+    {
+        const float shrink = across / (borderLeft + borderRight);
+        borderLeft *= shrink;
+        borderRight *= shrink;
+    }
+    if(borderBottom + borderTop > up)
+    {
+        const float shrink = up / (borderBottom + borderTop);
+        borderBottom *= shrink;
+        borderTop *= shrink;
+    }
+
+    // Lines between the slices, left to right and bottom to top. Rows of
+    // the texture run top down, so v falls as y rises.
+    const float xs[4] = { left, left + borderLeft, right - borderRight, right };
+    const float ys[4] = { bottom, bottom + borderBottom, top - borderTop, top };
+    const float us[4] =
+    {
+        texture->MapU(0),
+        texture->MapU(std::min(borders[0] / width, 1.0f)),
+        texture->MapU(std::max(1 - borders[2] / width, 0.0f)),
+        texture->MapU(1)
+    };
+    const float vs[4] =
+    {
+        texture->MapV(1),
+        texture->MapV(std::max(1 - borders[1] / height, 0.0f)),
+        texture->MapV(std::min(borders[3] / height, 1.0f)),
+        texture->MapV(0)
+    };
+
+    const GLuint textureId = texture->GetId();
+    const bool premultiplied = texture->IsPremultiplied();
+    for(int row = 0; row < 3; row++)
+    {
+        for(int column = 0; column < 3; column++)
+        {
+            const float x0 = xs[column];
+            const float x1 = xs[column + 1];
+            const float y0 = ys[row];
+            const float y1 = ys[row + 1];
+            if(x0 == x1 || y0 == y1)
+            {
+                continue; // a border of 0
+            }
+
+            const float u0 = us[column];
+            const float u1 = us[column + 1];
+            const float v0 = vs[row];
+            const float v1 = vs[row + 1];
+
+            // TL, TR, BL, TR, BR, BL as sprites are.
+            Vertex quad[6];
+            quad[0] = Vertex(x0, y1, 0.f, colour, u0, v1);
+            quad[1] = Vertex(x1, y1, 0.f, colour, u1, v1);
+            quad[2] = Vertex(x0, y0, 0.f, colour, u0, v0);
+            quad[3] = quad[1];
+            quad[4] = Vertex(x1, y0, 0.f, colour, u1, v0);
+            quad[5] = quad[2];
+
+            if(mDeferred)
+            {
+                RecordQuad(quad, textureId, false, premultiplied);
+            }
+            else
+            {
+                PushQuad(quad, textureId, false, premultiplied);
+            }
+        }
+    }
+}
+
 void GraphicsPipeline::PushLine(float x1,
                                 float y1,
                                 float x2,
                                 float y2,
                                 const Vector& colour)
 {
-    unsigned int numVerts = 2;
-    assert(numVerts < BUFFER_SIZE_IN_VERTS);
-    bool needToFlush = mVertCount + numVerts >= BUFFER_SIZE_IN_VERTS;
+    ReserveLines(2);
+    const Vector batchColour = BatchColour(colour);
+    mVertexBuffer[mVertCount] = PackedVertex(Vertex(x1, y1, 0.f, batchColour));
+    mVertCount++;
+    mVertexBuffer[mVertCount] = PackedVertex(Vertex(x2, y2, 0.f, batchColour));
+    mVertCount++;
+}
+
+void GraphicsPipeline::PushSprite(const Sprite* sprite)
+{
+    SpriteRecord record(*sprite);
+    PushSprite(&record);
+}
+
+void GraphicsPipeline::PushSprite(const Sprite* sprite, const Transform2D& world)
+{
+    SpriteRecord record(*sprite);
+    PushSprite(&record, world);
+}
+
+void GraphicsPipeline::PushSprite(const SpriteRecord* sprite)
+{
+    if(sprite->animation != NULL)
+    {
+        // Drawn as a copy showing the current frame.
+        SpriteRecord frame(*sprite);
+        Animation::Apply(&frame);
+        frame.animation = NULL;
+        PushSprite(&frame);
+        return;
+    }
+
+    Texture* texture = Texture::Resolve(sprite->texture);
+
+    if(texture == NULL)
+    {
+        printf("Early out sprite has no texture.\n");
+        return;
+    }
+    texture->MarkUsed();
+
+    float wx = 0;
+    float wy = 0;
+    float hx = 0;
+    float hy = 0;
+    float radius = 0;
+    eSpritePath path = SpriteExtents(sprite, texture, &wx, &wy, &hx, &hy, &radius);
+    if(IsOffScreen(sprite->x, sprite->y, radius))
+    {
+        return;
+    }
+
+    EmitSprite(sprite, texture, path, wx, wy, hx, hy, sprite->x, sprite->y, sprite->z);
+}
+
+//
+// The sprite's half width and half height offsets, see EmitSprite, and
+// how far its corners can be from its centre.
+//
+eSpritePath GraphicsPipeline::SpriteExtents(const SpriteRecord* sprite,
+                                            const Texture* texture,
+                                            float* wx, float* wy,
+                                            float* hx, float* hy,
+                                            float* radius)
+{
+    float halfWidth = 0;
+    float halfHeight = 0;
+    SpriteHalfSize(sprite, texture, &halfWidth, &halfHeight);
+
+    // Most sprites aren't rotated or scaled, so they skip the trig and
+    // only offset the centre.
+    if(sprite->rotation == 0)
+    {
+        eSpritePath path = SPRITE_PATH_TRANSLATE;
+        if(sprite->scaleX != 1 || sprite->scaleY != 1)
+        {
+            path = SPRITE_PATH_SCALE;
+            halfWidth *= sprite->scaleX;
+            halfHeight *= sprite->scaleY;
+        }
+
+        *wx = halfWidth;
+        *wy = 0;
+        *hx = 0;
+        *hy = halfHeight;
+        *radius = std::abs(halfWidth) + std::abs(halfHeight);
+        return path;
+    }
+
+    // The rotation below only scales one of each corner's terms, so bound
+    // it by the larger of the scales and 1.
+    float reach = std::max(std::max(std::abs(sprite->scaleX),
+                                    std::abs(sprite->scaleY)),
+                           1.f);
+    *radius = (halfWidth + halfHeight) * reach;
+
+    // The same transform as a Matrix rotated about z, translated and
+    // with its diagonal scaled, worked out for just the four corners.
+    float radians = DegreeToRadian(sprite->rotation);
+    float c = std::cos(radians);
+    float s = std::sin(radians);
+    float m00 = c * sprite->scaleX;
+    float m01 = -s;
+    float m10 = s;
+    float m11 = c * sprite->scaleY;
+    *wx = m00 * halfWidth;
+    *wy = m10 * halfWidth;
+    *hx = m01 * halfHeight;
+    *hy = m11 * halfHeight;
+    return SPRITE_PATH_AFFINE;
+}
+
+//
+// Shared by a PushSprites call's workers. Each sprite gets four verts in
+// quads and a result in results.
+//
+struct GraphicsPipeline::SpriteBuild
+{
+    const GraphicsPipeline* pipeline;
+    const SpriteRecord* sprites;
+    Texture* const* textures; // NULL ones are pushed on the main thread
+    PackedVertex* quads;
+    unsigned char* results;
+};
+
+void GraphicsPipeline::BuildSprites(void* data, unsigned int begin, unsigned int end)
+{
+    const SpriteBuild* build = (const SpriteBuild*) data;
+    const GraphicsPipeline* pipeline = build->pipeline;
+
+    for(unsigned int i = begin; i < end; i++)
+    {
+        const Texture* texture = build->textures[i];
+        if(texture == NULL)
+        {
+            continue;
+        }
+
+        const SpriteRecord* sprite = &build->sprites[i];
+        float wx = 0;
+        float wy = 0;
+        float hx = 0;
+        float hy = 0;
+        float radius = 0;
+        eSpritePath path = SpriteExtents(sprite, texture, &wx, &wy, &hx, &hy, &radius);
+        if(pipeline->IsOutsideView(sprite->x, sprite->y, radius))
+        {
+            build->results[i] = SPRITE_CULLED;
+            continue;
+        }
+
+        float tx = sprite->x;
+        float ty = sprite->y;
+        float uvs[4];
+        if(!MapSprite(sprite, texture, uvs, &wx, &wy, &hx, &hy, &tx, &ty))
+        {
+            build->results[i] = SPRITE_EMPTY;
+            continue;
+        }
+
+        if(!PackedUVs(uvs))
+        {
+            build->results[i] = SPRITE_UNPACKED;
+            continue;
+        }
+
+        PackSprite(sprite, path, uvs, wx, wy, hx, hy, tx, ty,
+                   pipeline->mBlendMode, texture->IsPremultiplied(),
+                   &build->quads[i * 4]);
+        build->results[i] = (unsigned char) path;
+    }
+}
+
+//
+// Big runs of sprites have their verts worked out on the job system,
+// into scratch space as which are culled isn't known until they're done.
+// The main thread then batches them in order, a copy a sprite. Textures
+// are resolved, and the batch changed, only on the main thread.
+//
+void GraphicsPipeline::PushSprites(const SpriteRecord* sprites, unsigned int count)
+{
+    JobSystem* jobs = Dinodeck::GetInstance()->GetJobs();
+    if(count < PARALLEL_SPRITES
+       || jobs->WorkerCount() == 0
+       || mDeferred
+       || !mClips.empty())
+    {
+        for(unsigned int i = 0; i < count; i++)
+        {
+            PushSprite(&sprites[i]);
+        }
+        return;
+    }
+
+    mSpriteTextures.resize(count);
+    for(unsigned int i = 0; i < count; i++)
+    {
+        Texture* texture = NULL;
+        if(sprites[i].animation == NULL)
+        {
+            texture = Texture::Resolve(sprites[i].texture);
+        }
+        if(texture != NULL)
+        {
+            texture->MarkUsed();
+        }
+        mSpriteTextures[i] = texture;
+    }
+
+    mSpriteQuads.resize(count * 4);
+    mSpriteResults.resize(count);
+    SpriteBuild build;
+    build.pipeline = this;
+    build.sprites = sprites;
+    build.textures = &mSpriteTextures[0];
+    build.quads = &mSpriteQuads[0];
+    build.results = &mSpriteResults[0];
+    jobs->ParallelFor(count, SPRITE_GRAIN, BuildSprites, &build);
+
+    for(unsigned int i = 0; i < count; i++)
+    {
+        const Texture* texture = mSpriteTextures[i];
+        if(texture == NULL || mSpriteResults[i] == SPRITE_UNPACKED)
+        {
+            // Animated, without a texture or with uvs that need a batch of
+            // their own, as PushSprite would.
+            PushSprite(&sprites[i]);
+            continue;
+        }
+
+        const unsigned char result = mSpriteResults[i];
+        if(result == SPRITE_CULLED)
+        {
+            mCulledCount++;
+            continue;
+        }
+
+        if(result == SPRITE_EMPTY)
+        {
+            continue;
+        }
+        mStats.spritePaths[result]++;
+
+        const unsigned int numVerts =
+            PrepareQuad(texture->GetId(), false, texture->IsPremultiplied());
+        PackedVertex* out = &mVertexBuffer[mVertCount];
+        std::copy(&mSpriteQuads[i * 4], &mSpriteQuads[i * 4] + 4, out);
+        if(numVerts == 6)
+        {
+            QuadToTriangles(out);
+        }
+        mVertCount += numVerts;
+    }
+}
+
+void GraphicsPipeline::PushSprite(const SpriteRecord* sprite, const Transform2D& world)
+{
+    if(sprite->animation != NULL)
+    {
+        SpriteRecord frame(*sprite);
+        Animation::Apply(&frame);
+        frame.animation = NULL;
+        PushSprite(&frame, world);
+        return;
+    }
+
+    Texture* texture = Texture::Resolve(sprite->texture);
+
+    if(texture == NULL)
+    {
+        return;
+    }
+    texture->MarkUsed();
+
+    float halfWidth = 0;
+    float halfHeight = 0;
+    SpriteHalfSize(sprite, texture, &halfWidth, &halfHeight);
+
+    // The sprite's own position, rotation and scale are already in world.
+    const float wx = world.a * halfWidth;
+    const float wy = world.b * halfWidth;
+    const float hx = world.c * halfHeight;
+    const float hy = world.d * halfHeight;
+
+    // No corner is further from the centre than this.
+    if(IsOffScreen(world.tx,
+                   world.ty,
+                   std::abs(wx) + std::abs(wy) + std::abs(hx) + std::abs(hy)))
+    {
+        return;
+    }
+
+    // Groups of UI are mostly only moved.
+    eSpritePath path = SPRITE_PATH_AFFINE;
+    if(wy == 0 && hx == 0)
+    {
+        path = (world.a == 1 && world.d == 1) ? SPRITE_PATH_TRANSLATE : SPRITE_PATH_SCALE;
+    }
+    EmitSprite(sprite, texture, path, wx, wy, hx, hy, world.tx, world.ty, sprite->z);
+}
+
+void GraphicsPipeline::SpriteHalfSize(const SpriteRecord* sprite,
+                                      const Texture* texture,
+                                      float* halfWidth,
+                                      float* halfHeight)
+{
+    float texScaleX = std::abs(sprite->topLeftU - sprite->bottomRightU);
+    float texScaleY = std::abs(sprite->topLeftV - sprite->bottomRightV);
+    *halfWidth =  ((texture->GetWidth()*texScaleX)/2);
+    *halfHeight = ((texture->GetHeight()*texScaleY)/2);
+}
+
+//
+// Cuts the range from -1 to 1 down to where u, running from u0 at -1 to
+// u1 at 1, is inside the trim. False if nothing's left.
+//
+static bool TrimAxis(float u0, float u1, float trim0, float trim1,
+                     float* from, float* to)
+{
+    const float du = u1 - u0;
+    if(du == 0)
+    {
+        return trim0 <= u0 && u0 <= trim1;
+    }
+
+    const float a = (trim0 - u0) / du * 2 - 1;
+    const float b = (trim1 - u0) / du * 2 - 1;
+    *from = std::max(-1.0f, std::min(a, b));
+    *to = std::min(1.0f, std::max(a, b));
+    return *from < *to;
+}
+
+bool GraphicsPipeline::TrimSprite(const Texture* texture,
+                                  float* topLeftU, float* topLeftV,
+                                  float* bottomRightU, float* bottomRightV,
+                                  float* wx, float* wy, float* hx, float* hy,
+                                  float* tx, float* ty)
+{
+    // Repeating uvs would be cut to one copy of the texture.
+    if(std::min(*topLeftU, *bottomRightU) < 0 || std::max(*topLeftU, *bottomRightU) > 1
+       || std::min(*topLeftV, *bottomRightV) < 0 || std::max(*topLeftV, *bottomRightV) > 1)
+    {
+        return true;
+    }
+
+    // Across, -1 is the left edge at topLeftU. Up, -1 is the bottom edge
+    // at bottomRightV.
+    float left = -1;
+    float right = 1;
+    float bottom = -1;
+    float top = 1;
+    if(!TrimAxis(*topLeftU, *bottomRightU, texture->TrimU0(), texture->TrimU1(),
+                 &left, &right)
+       || !TrimAxis(*bottomRightV, *topLeftV, texture->TrimV0(), texture->TrimV1(),
+                    &bottom, &top))
+    {
+        return false;
+    }
+
+    const float du = *bottomRightU - *topLeftU;
+    const float dv = *topLeftV - *bottomRightV;
+    const float u0 = *topLeftU;
+    const float v0 = *bottomRightV;
+    *topLeftU = u0 + (left + 1) / 2 * du;
+    *bottomRightU = u0 + (right + 1) / 2 * du;
+    *bottomRightV = v0 + (bottom + 1) / 2 * dv;
+    *topLeftV = v0 + (top + 1) / 2 * dv;
+
+    // The centre moves to the middle of what's left.
+    const float across = (left + right) / 2;
+    const float up = (bottom + top) / 2;
+    *tx += *wx * across + *hx * up;
+    *ty += *wy * across + *hy * up;
+    *wx *= (right - left) / 2;
+    *wy *= (right - left) / 2;
+    *hx *= (top - bottom) / 2;
+    *hy *= (top - bottom) / 2;
+    return true;
+}
+
+//
+// Sprite uvs are relative to the texture, which may be a region of an
+// atlas page, and trimmed sprites shrink to what's left. uvs are
+// topLeftU, topLeftV, bottomRightU, bottomRightV. False if the trim
+// leaves nothing.
+//
+bool GraphicsPipeline::MapSprite(const SpriteRecord* sprite,
+                                 const Texture* texture,
+                                 float* uvs,
+                                 float* wx, float* wy,
+                                 float* hx, float* hy,
+                                 float* tx, float* ty)
+{
+    float topLeftU = sprite->topLeftU;
+    float topLeftV = sprite->topLeftV;
+    float bottomRightU = sprite->bottomRightU;
+    float bottomRightV = sprite->bottomRightV;
+    if(texture->IsTrimmed()
+       && !TrimSprite(texture, &topLeftU, &topLeftV, &bottomRightU, &bottomRightV,
+                      wx, wy, hx, hy, tx, ty))
+    {
+        return false;
+    }
+
+    uvs[0] = texture->MapU(topLeftU);
+    uvs[1] = texture->MapV(topLeftV);
+    uvs[2] = texture->MapU(bottomRightU);
+    uvs[3] = texture->MapV(bottomRightV);
+    return true;
+}
 
-    if(needToFlush || mDrawMode != LINES)
+//
+// Writes the sprite's corners, TL TR BL BR. They're worked out together
+// and the colour and uvs, shared by every corner, packed once. Touches
+// nothing but out, so workers can call it.
+//
+void GraphicsPipeline::PackSprite(const SpriteRecord* sprite,
+                                  eSpritePath path,
+                                  const float* uvs,
+                                  float wx, float wy,
+                                  float hx, float hy,
+                                  float tx, float ty,
+                                  eBlendMode blend,
+                                  bool premultiplied,
+                                  PackedVertex* out)
+{
+    float xs[4];
+    float ys[4];
+    if(path == SPRITE_PATH_AFFINE)
+    {
+        const Float4 signW(-1, 1, -1, 1);
+        const Float4 signH(1, 1, -1, -1);
+        Float4::MultiplyAdd(Float4::MultiplyAdd(Float4::Broadcast(tx), signW, Float4::Broadcast(wx)),
+                            signH, Float4::Broadcast(hx)).Store(xs);
+        Float4::MultiplyAdd(Float4::MultiplyAdd(Float4::Broadcast(ty), signW, Float4::Broadcast(wy)),
+                            signH, Float4::Broadcast(hy)).Store(ys);
+    }
+    else
     {
-        Flush();
-        mDrawMode = LINES;
+        // Axis aligned, two edges across and two up.
+        xs[0] = xs[2] = tx - wx;
+        xs[1] = xs[3] = tx + wx;
+        ys[0] = ys[1] = ty + hy;
+        ys[2] = ys[3] = ty - hy;
     }
-    mVertexBuffer[mVertCount] = Vertex(x1, y1, 0.f, colour);
-    mVertCount++;
-    mVertexBuffer[mVertCount] = Vertex(x2, y2, 0.f, colour);
-    mVertCount++;
-    Flush();
+
+    float r = sprite->colour[0];
+    float g = sprite->colour[1];
+    float b = sprite->colour[2];
+    float a = sprite->colour[3];
+    BatchColour(blend, BatchBlend(blend, premultiplied), &r, &g, &b, &a);
+
+    PackedVertex corner;
+    corner.r = PackedVertex::PackColour(r);
+    corner.g = PackedVertex::PackColour(g);
+    corner.b = PackedVertex::PackColour(b);
+    corner.a = PackedVertex::PackColour(a);
+    const short u0 = PackedVertex::PackUV(uvs[0]);
+    const short v0 = PackedVertex::PackUV(uvs[1]);
+    const short u1 = PackedVertex::PackUV(uvs[2]);
+    const short v1 = PackedVertex::PackUV(uvs[3]);
+
+    corner.x = xs[0]; corner.y = ys[0]; corner.u = u0; corner.v = v0;
+    out[0] = corner;
+    corner.x = xs[1]; corner.y = ys[1]; corner.u = u1; corner.v = v0;
+    out[1] = corner;
+    corner.x = xs[2]; corner.y = ys[2]; corner.u = u0; corner.v = v1;
+    out[2] = corner;
+    corner.x = xs[3]; corner.y = ys[3]; corner.u = u1; corner.v = v1;
+    out[3] = corner;
 }
 
-void GraphicsPipeline::PushSprite(const Sprite* sprite)
+//
+// True if the sprite's uvs pack without a UVBase, so it can go straight
+// into any batch.
+//
+bool GraphicsPipeline::PackedUVs(const float* uvs)
 {
-    unsigned int numVerts = 6; // two tris of 3 verts
-    assert(numVerts < BUFFER_SIZE_IN_VERTS);
-    bool needToFlush = mVertCount + numVerts >= BUFFER_SIZE_IN_VERTS;
+    return PackedVertex::FitsUV(uvs[0]) && PackedVertex::FitsUV(uvs[1])
+           && PackedVertex::FitsUV(uvs[2]) && PackedVertex::FitsUV(uvs[3]);
+}
 
+//
+// TL TR BL BR, with room for two more, as two triangles TL TR BL TR BR BL.
+//
+void GraphicsPipeline::QuadToTriangles(PackedVertex* quad)
+{
+    quad[4] = quad[3];
+    quad[3] = quad[1];
+    quad[5] = quad[2];
+}
 
-    if(mTexture != sprite->texture)
-    {
-        needToFlush = true;
-    }
+//
+// Pushes the sprite's quad, its corners are the centre t plus or minus
+// the half width offset w and the half height offset h.
+//
+void GraphicsPipeline::EmitSprite(const SpriteRecord* sprite,
+                                  const Texture* texture,
+                                  eSpritePath path,
+                                  float wx, float wy,
+                                  float hx, float hy,
+                                  float tx, float ty, float tz)
+{
+    assert(path == SPRITE_PATH_AFFINE || (wy == 0 && hx == 0));
 
-    if(needToFlush || mDrawMode != TRIANGLES)
+    float uvs[4];
+    if(!MapSprite(sprite, texture, uvs, &wx, &wy, &hx, &hy, &tx, &ty))
     {
-        Flush();
-        mTexture = sprite->texture;
-        mDrawMode = TRIANGLES;
-        glEnable( GL_TEXTURE_2D );
-        glBindTexture(GL_TEXTURE_2D, mTexture->GetId());
+        return;
     }
-    glEnable( GL_TEXTURE_2D );
+    mStats.spritePaths[path]++;
 
-    if(mTexture == NULL)
+    if(!mDeferred && mClips.empty() && PackedUVs(uvs))
     {
-        printf("Early out sprite has no texture.\n");
+        // Straight into the batch.
+        const unsigned int numVerts =
+            PrepareQuad(texture->GetId(), false, texture->IsPremultiplied());
+        PackedVertex* out = &mVertexBuffer[mVertCount];
+        PackSprite(sprite, path, uvs, wx, wy, hx, hy, tx, ty,
+                   mBlendMode, texture->IsPremultiplied(), out);
+        if(numVerts == 6)
+        {
+            QuadToTriangles(out);
+        }
+        mVertCount += numVerts;
         return;
     }
 
-    const Vector& colour = sprite->colour;
-
-    Matrix modelMatrix;
-    modelMatrix.SetRotation(Vector::AxisZ, sprite->rotation);
-    modelMatrix.SetTranslation(sprite->position);
-
-    // Apply the scale, maybe an applyscale function?
-    modelMatrix.mCol0.x *= sprite->scale.x;
-    modelMatrix.mCol1.y *= sprite->scale.y;
-    modelMatrix.mCol2.z *= sprite->scale.z;
-
-
-    float texScaleX = std::abs(sprite->topLeftU - sprite->bottomRightU);
-    float texScaleY = std::abs(sprite->topLeftV - sprite->bottomRightV);
-    float halfWidth =  ((mTexture->GetWidth()*texScaleX)/2);
-    float halfHeight = ((mTexture->GetHeight()*texScaleY)/2);
+    const float topLeftU = uvs[0];
+    const float topLeftV = uvs[1];
+    const float bottomRightU = uvs[2];
+    const float bottomRightV = uvs[3];
+    const Vector colour(sprite->colour[0], sprite->colour[1],
+                        sprite->colour[2], sprite->colour[3]);
+    Vertex quad[6];
 
     // TL
-    mVertexBuffer[mVertCount] = Vertex(modelMatrix*Vector(0 - halfWidth, 0 + halfHeight, 0.f, 1.f),
-                                       colour,
-                                       sprite->topLeftU, sprite->topLeftV);
-    mVertCount++;
-
+    quad[0] = Vertex(tx - wx + hx, ty - wy + hy, tz,
+                     colour,
+                     topLeftU, topLeftV);
 
     // TR
-    mVertexBuffer[mVertCount] = Vertex(modelMatrix*Vector(0 + halfWidth, 0 + halfHeight, 0, 1.f),
-                                       colour,
-                                       sprite->bottomRightU, sprite->topLeftV);
-    mVertCount++;
+    quad[1] = Vertex(tx + wx + hx, ty + wy + hy, tz,
+                     colour,
+                     bottomRightU, topLeftV);
 
     // BL
-    mVertexBuffer[mVertCount] = Vertex(modelMatrix*Vector(0 - halfWidth, 0 - halfHeight, 0, 1),
-                                       colour,
-                                       sprite->topLeftU, sprite->bottomRightV);
-    mVertCount++;
+    quad[2] = Vertex(tx - wx - hx, ty - wy - hy, tz,
+                     colour,
+                     topLeftU, bottomRightV);
 
     // TR
-    mVertexBuffer[mVertCount] = Vertex(modelMatrix*Vector(0 + halfWidth, 0 + halfHeight, 0, 1),
-                                       colour,
-                                       sprite->bottomRightU, sprite->topLeftV);
-    mVertCount++;
+    quad[3] = quad[1];
 
     // BR
-    mVertexBuffer[mVertCount] = Vertex(modelMatrix*Vector(0 + halfWidth, 0 - halfHeight, 0, 1),
-                                       colour,
-                                       sprite->bottomRightU, sprite->bottomRightV);
-    mVertCount++;
+    quad[4] = Vertex(tx + wx - hx, ty + wy - hy, tz,
+                     colour,
+                     bottomRightU, bottomRightV);
 
     // BL
-    mVertexBuffer[mVertCount] = Vertex(modelMatrix*Vector(0 - halfWidth, 0 - halfHeight, 0, 1),
-                                       colour,
-                                       sprite->topLeftU, sprite->bottomRightV);
-    mVertCount++;
+    quad[5] = quad[2];
+
+    if(mDeferred)
+    {
+        RecordQuad(quad, texture->GetId(), false, texture->IsPremultiplied(),
+                   sprite->opaque || texture->IsOpaque());
+    }
+    else
+    {
+        PushQuad(quad, texture->GetId(), false, texture->IsPremultiplied());
+    }
 }
 
 
 
 
+//
+// The entry's wrapped lines, broken the first time they're asked for.
+//
+static const TextLines& CachedLines(TextLayoutCache::Entry* entry,
+                                    Font* font,
+                                    const char* text,
+                                    float maxwidth)
+{
+    if(!entry->hasLines)
+    {
+        FormatText::BreakLines(font, text, maxwidth, &entry->lines);
+        entry->hasLines = true;
+    }
+    return entry->lines;
+}
+
 void GraphicsPipeline::PushText(float x,
                                 float y,
                                 const char* text,
                                 const Vector& colour,
                                 int width)
+{
+    DD_PROFILE_ZONE("PushText");
+    if(!PrepareText())
+    {
+        return;
+    }
+
+    TextLayoutCache::Entry* entry = FindLayout(text, width);
+
+    // Rotated text turns about the world origin rather than its own, so
+    // only unrotated text is culled. The extra pixel covers pen rounding.
+    if(mTextRotation == 0 &&
+       IsOffScreen(x, y, (entry->radius + 1) *
+                   std::max(std::abs(mFontScaleX), std::abs(mFontScaleY))))
+    {
+        return;
+    }
+
+    FormatText::PushLayout(this, entry->layout, x/mFontScaleX, y/mFontScaleY, colour);
+}
+
+void GraphicsPipeline::PushTextRun(float x,
+                                   float y,
+                                   TextRun* run,
+                                   unsigned int count,
+                                   const Vector& colour)
+{
+    assert(run);
+    if(!PrepareText())
+    {
+        return;
+    }
+
+    int width = (int) run->Width(); // as PushText truncates it
+    float maxwidth = WrapWidth(width);
+    if(!run->hasLayout ||
+       run->font != mFont ||
+       run->maxwidth != maxwidth ||
+       run->alignX != mAlignX ||
+       run->alignY != mAlignY ||
+       run->fontGeneration != TextLayoutCache::FontsChangedCount())
+    {
+        TextLayoutCache::Entry* entry = FindLayout(run->Text().c_str(), width);
+        run->layout = entry->layout;
+        run->radius = entry->radius;
+        run->font = mFont;
+        run->maxwidth = maxwidth;
+        run->alignX = mAlignX;
+        run->alignY = mAlignY;
+        run->fontGeneration = TextLayoutCache::FontsChangedCount();
+        run->hasLayout = true;
+    }
+
+    if(mTextRotation == 0 &&
+       IsOffScreen(x, y, (run->radius + 1) *
+                   std::max(std::abs(mFontScaleX), std::abs(mFontScaleY))))
+    {
+        return;
+    }
+
+    FormatText::PushLayout(this, run->layout, x/mFontScaleX, y/mFontScaleY, colour, count);
+}
+
+bool GraphicsPipeline::PrepareText()
 {
     if(!mFont)
     {
@@ -305,42 +3065,109 @@ void GraphicsPipeline::PushText(float x,
 
     if(!mFont || mFontScaleX == 0 || mFontScaleY == 0)
     {
-        return;
+        return false;
     }
 
-    Flush();    // No text batching at the moment!
-                // Can probably be fixed by looking into FTGL's internals
-    mTexture = NULL;
-    glPushMatrix();
+    // Glyphs are batched like sprites, the camera is applied on Flush.
+    float radians = mTextRotation * (PI / 180.0);
+    mTextCos = cos(radians);
+    mTextSin = sin(radians);
+    return true;
+}
+
+//
+// The layout cache's maxwidth for a width in pixels, 0 doesn't wrap.
+// Drawing and measuring both go through this, so they share entries.
+//
+float GraphicsPipeline::WrapWidth(float width) const
+{
+    int pixels = (int) width;
+    return (pixels < 1) ? 0 : pixels/mFontScaleX;
+}
+
+TextLayoutCache::Entry* GraphicsPipeline::FindLayout(const char* text, int width)
+{
+    float maxwidth = WrapWidth(width);
+    TextLayoutCache::Entry* entry =
+        mLayoutCache.Find(mFont, text, maxwidth, mAlignX, mAlignY);
+
+    if(!entry->hasLayout)
     {
+        // Layout may load glyphs, FTGL binds their textures.
+        mGLState.InvalidateTexture();
 
-        glRotatef(mRotateAngle, 0.f, 0.f, 1.f);
-        glTranslatef(mCamPosition.x, mCamPosition.y, mCamPosition.z);
-        glScalef(mCamScale.x, mCamScale.y, mCamScale.z);
-        glPushMatrix();
+        if(maxwidth == 0)
         {
-            //glTranslatef(x, y, 0);
-            glScalef(mFontScaleX, mFontScaleY, 1);
-            glRotatef(mTextRotation, 0, 0, 1);
-            glColor4f(colour.x, colour.y, colour.z, colour.w);
-
-            if(width < 1)
-            {
-                FormatText::PushText(mFont, x/mFontScaleX, y/mFontScaleY, text, colour, mAlignX, mAlignY);
-            }
-            else
-            {
-                FormatText::PushTextWrapped(mFont, x/mFontScaleX, y/mFontScaleY, text, colour, mAlignX, mAlignY, width/mFontScaleX);
-            }
+            FormatText::LayoutText(mFont, text, mAlignX, mAlignY, &entry->layout);
         }
-        glPopMatrix();
+        else
+        {
+            FormatText::LayoutTextWrapped(mFont, text,
+                                          CachedLines(entry, mFont, text, maxwidth),
+                                          mAlignX, mAlignY, &entry->layout);
+        }
+        entry->radius = FormatText::LayoutRadius(entry->layout);
+        entry->hasLayout = true;
+    }
+    return entry;
+}
+
+void GraphicsPipeline::PushGlyph(GLuint textureId,
+                                 float left, float top, float right, float bottom,
+                                 float u0, float v0, float u1, float v1,
+                                 const Vector& colour,
+                                 bool distanceField)
+{
+    // TL, TR, BL, BR
+    const float cornerX[4] = { left, right, left, right };
+    const float cornerY[4] = { top, top, bottom, bottom };
+    float outX[4];
+    float outY[4];
+
+    // Same as glScalef(fontScale) then glRotatef(textRotation).
+    for(int i = 0; i < 4; i++)
+    {
+        outX[i] = (mTextCos * cornerX[i] - mTextSin * cornerY[i]) * mFontScaleX;
+        outY[i] = (mTextSin * cornerX[i] + mTextCos * cornerY[i]) * mFontScaleY;
+    }
+
+    Vertex quad[6];
+    quad[0] = Vertex(outX[0], outY[0], 0.f, colour, u0, v0); // TL
+    quad[1] = Vertex(outX[1], outY[1], 0.f, colour, u1, v0); // TR
+    quad[2] = Vertex(outX[2], outY[2], 0.f, colour, u0, v1); // BL
+    quad[3] = quad[1];                                       // TR
+    quad[4] = Vertex(outX[3], outY[3], 0.f, colour, u1, v1); // BR
+    quad[5] = quad[2];                                       // BL
+
+    if(mDeferred)
+    {
+        // Glyph textures are alpha only, so they're always blended straight.
+        RecordQuad(quad, textureId, distanceField, false);
+    }
+    else
+    {
+        PushQuad(quad, textureId, distanceField, false);
     }
-    glPopMatrix();
 }
 
 
-void GraphicsPipeline::MeasureText(const char* text, float width, Vector* outSize) const
+void GraphicsPipeline::MeasureText(const char* text, float width, Vector* outSize)
 {
+    // Shares entries with PushText, menus measure then draw the same string.
+    float maxwidth = WrapWidth(width);
+    TextLayoutCache::Entry* entry =
+        mLayoutCache.Find(mFont, text, maxwidth, mAlignX, mAlignY);
+
+    if(entry->hasSize)
+    {
+        outSize->SetXyzw(entry->size.x * mFontScaleX,
+                         entry->size.y * mFontScaleY,
+                         0, 0);
+        return;
+    }
+
+    mGLState.InvalidateTexture(); // measuring may load glyphs
+
     // Not quite sure about the matrix stuff
     glPushMatrix();
     {
@@ -349,7 +3176,18 @@ void GraphicsPipeline::MeasureText(const char* text, float width, Vector* outSiz
         {
             //glTranslatef(x, y, 0);
             glScalef(mFontScaleX, mFontScaleY, 1);
-            FormatText::MeasureText(mFont, text, width/mFontScaleX, outSize);
+            if(maxwidth == 0)
+            {
+                FormatText::MeasureText(mFont, text, maxwidth, outSize);
+            }
+            else
+            {
+                FormatText::MeasureLines(mFont, text,
+                                         CachedLines(entry, mFont, text, maxwidth),
+                                         outSize);
+            }
+            entry->size.SetXyzw(*outSize);
+            entry->hasSize = true;
             outSize->x *=  mFontScaleX;
             outSize->y *=  mFontScaleY;
         }
@@ -373,7 +3211,7 @@ bool GraphicsPipeline::SetFont(const char* name)
     mFontName = name;
     bool success = true;
     Dinodeck* dinodeck = Dinodeck::GetInstance();
-    FTTextureFont* font = dinodeck->GetGame()->GetFont(name);
+    Font* font = dinodeck->GetGame()->GetFont(name);
     if(NULL == font)
     {
         font = dinodeck->GetGame()->GetSystemFont();
@@ -386,25 +3224,110 @@ bool GraphicsPipeline::SetFont(const char* name)
 
 void GraphicsPipeline::SetBlend(eBlendMode blend)
 {
-    if(mBlendMode == blend)
+    mQueueBlend = blend;
+
+    // Deferred commands carry their own blend, it's applied when drawn.
+    if(!mDeferred)
+    {
+        ApplyBlend(blend);
+    }
+}
+
+void GraphicsPipeline::ApplyBlend(eBlendMode blend)
+{
+    // The batch only flushes when the next verts pushed are drawn with a
+    // different GL blend.
+    mBlendMode = blend;
+}
+
+eBlendMode GraphicsPipeline::BatchBlend(eBlendMode blend, bool premultiplied)
+{
+    if(!premultiplied)
+    {
+        return blend;
+    }
+
+    switch(blend)
+    {
+    case MULTIPLY: return MULTIPLY_PREMULTIPLIED;
+    case SCREEN: return SCREEN_PREMULTIPLIED;
+    default: return BLEND_PREMULTIPLIED;
+    }
+}
+
+void GraphicsPipeline::UseBatchBlend(eBlendMode batchBlend)
+{
+    if(mBatchBlend == batchBlend)
     {
         return;
     }
 
-    Flush();
+    // The batch is drawn, or recorded, with the blend it was pushed with.
+    FlushBatch();
+    mBatchBlend = batchBlend;
+}
+
+void GraphicsPipeline::BatchColour(float* r, float* g, float* b, float* a) const
+{
+    BatchColour(mBlendMode, mBatchBlend, r, g, b, a);
+}
 
-    if(blend == BLEND)
+void GraphicsPipeline::BatchColour(eBlendMode blend, eBlendMode batchBlend,
+                                   float* r, float* g, float* b, float* a)
+{
+    if(batchBlend < BLEND_PREMULTIPLIED)
     {
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        mBlendMode = blend;
+        return;
     }
-    else if(blend == ADDITIVE)
+
+    *r *= *a;
+    *g *= *a;
+    *b *= *a;
+    if(blend == ADDITIVE)
     {
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE); // I think? :D
-        mBlendMode = blend;
+        *a = 0;
     }
+}
 
+Vector GraphicsPipeline::BatchColour(const Vector& colour) const
+{
+    float r = (float) colour.x;
+    float g = (float) colour.y;
+    float b = (float) colour.z;
+    float a = (float) colour.w;
+    BatchColour(&r, &g, &b, &a);
+    return Vector(r, g, b, a);
+}
 
+void GraphicsPipeline::SetGLBlend(eBlendMode blend)
+{
+    switch(blend)
+    {
+    case BLEND:
+        mGLState.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        break;
+    case ADDITIVE:
+        mGLState.BlendFunc(GL_SRC_ALPHA, GL_ONE); // I think? :D
+        break;
+    // Straight colours leave alpha out of multiply and screen.
+    case MULTIPLY:
+        mGLState.BlendFunc(GL_DST_COLOR, GL_ZERO);
+        break;
+    case SCREEN:
+        mGLState.BlendFunc(GL_ONE_MINUS_DST_COLOR, GL_ONE);
+        break;
+    case BLEND_PREMULTIPLIED:
+        mGLState.BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        break;
+    case MULTIPLY_PREMULTIPLIED:
+        mGLState.BlendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA);
+        break;
+    case SCREEN_PREMULTIPLIED:
+        mGLState.BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
+        break;
+    default:
+        break;
+    }
 }
 
 void GraphicsPipeline::Reset()
@@ -416,10 +3339,11 @@ void GraphicsPipeline::Reset()
     mFontScaleX = 0.25;
     mFontScaleY = 0.25;
     mTextRotation = 0;
+    BakeCamera();
     mCamPosition.SetXyzw(0, 0, 0, 0);
 
     Dinodeck* dinodeck = Dinodeck::GetInstance();
-    FTTextureFont* font = dinodeck->GetDefaultFont();
+    Font* font = dinodeck->GetDefaultFont();
     if(NULL == font)
     {
         font = dinodeck->GetGame()->GetSystemFont();
@@ -428,28 +3352,288 @@ void GraphicsPipeline::Reset()
     SetFont(font);
 
     // Clear scissor
-    glDisable(GL_SCISSOR_TEST);
+    ApplyScissor(NULL);
     mScissorRefCount = 0;
+    mClips.clear();
+    mScissorOn = false;
 }
 
 void GraphicsPipeline::PushScissor(int x, int y, int width, int height)
 {
-    Flush();
-    mScissorRefCount++;
-    if(mScissorRefCount == 1)
+    ClipRect clip = { x, y, width, height };
+
+    if(mClipOnCPU)
     {
-        glEnable(GL_SCISSOR_TEST);
+        if(!mClips.empty())
+        {
+            const ClipRect& outer = mClips.back();
+            int right = std::min(x + width, outer.x + outer.width);
+            int top = std::min(y + height, outer.y + outer.height);
+            clip.x = std::max(x, outer.x);
+            clip.y = std::max(y, outer.y);
+            clip.width = std::max(0, right - clip.x);
+            clip.height = std::max(0, top - clip.y);
+        }
+        UnscissorClips();
+        mClips.push_back(clip);
+        return;
     }
-    glScissor(x, y, width, height);
+
+    Flush();
+    mScissorRefCount++;
+    SetGLScissor(&clip);
 }
 
 void GraphicsPipeline::PopScissor()
 {
+    if(mClipOnCPU)
+    {
+        assert(!mClips.empty());
+        UnscissorClips();
+        mClips.pop_back();
+        return;
+    }
+
     Flush();
     mScissorRefCount--;
     assert(mScissorRefCount >= 0);
-    if(mScissorRefCount == 0)
+    if(mScissorRefCount != 0)
+    {
+        return;
+    }
+    SetGLScissor(NULL);
+}
+
+void GraphicsPipeline::SetClipOnCPU(bool value)
+{
+    assert(!IsClipping());
+    mClipOnCPU = value;
+}
+
+void GraphicsPipeline::SetGLScissor(const ClipRect* clip)
+{
+    if(DrawCapture::IsCapturing())
+    {
+        if(clip == NULL)
+        {
+            DrawCapture::RecordScissorOff();
+        }
+        else
+        {
+            DrawCapture::RecordScissor(clip->x, clip->y, clip->width, clip->height);
+        }
+    }
+
+    if(mRecordFrames)
+    {
+        if(clip == NULL)
+        {
+            mFrameCommands.AppendScissorOff();
+        }
+        else
+        {
+            mFrameCommands.AppendScissor(clip->x, clip->y, clip->width, clip->height);
+        }
+        return;
+    }
+
+    ApplyScissor(clip);
+}
+
+void GraphicsPipeline::SetFrameClip(const ClipRect* clip)
+{
+    mFrameClipped = clip != NULL;
+    if(clip != NULL)
+    {
+        mFrameClip = *clip;
+    }
+    ApplyScissor(NULL);
+}
+
+//
+// Targets aren't the kept frame, so they're never cut to the frame clip.
+//
+void GraphicsPipeline::ApplyScissor(const ClipRect* clip)
+{
+    if(!mFrameClipped || mTarget != NULL)
+    {
+        if(clip == NULL)
+        {
+            mGLState.Disable(GL_SCISSOR_TEST);
+            return;
+        }
+        mGLState.Enable(GL_SCISSOR_TEST);
+        Scissor(clip->x, clip->y, clip->width, clip->height);
+        return;
+    }
+
+    ClipRect inside = mFrameClip;
+    if(clip != NULL)
+    {
+        int right = std::min(clip->x + clip->width, inside.x + inside.width);
+        int top = std::min(clip->y + clip->height, inside.y + inside.height);
+        inside.x = std::max(clip->x, inside.x);
+        inside.y = std::max(clip->y, inside.y);
+        inside.width = std::max(0, right - inside.x);
+        inside.height = std::max(0, top - inside.y);
+    }
+    mGLState.Enable(GL_SCISSOR_TEST);
+    Scissor(inside.x, inside.y, inside.width, inside.height);
+}
+
+void GraphicsPipeline::Scissor(int x, int y, int width, int height)
+{
+    if(mTarget != NULL || mViewScale == 1.0f)
+    {
+        glScissor(x, y, width, height);
+        return;
+    }
+
+    // Scale the edges rather than the size so neighbouring clips still meet.
+    int left = (int) floor(x * mViewScale + 0.5f);
+    int bottom = (int) floor(y * mViewScale + 0.5f);
+    int right = (int) floor((x + width) * mViewScale + 0.5f);
+    int top = (int) floor((y + height) * mViewScale + 0.5f);
+    glScissor(left, bottom, right - left, top - bottom);
+}
+
+//
+// Anything the CPU can't clip is about to be pushed. The GL scissor is
+// left on until the clip changes, what's clipped on the CPU is inside it
+// anyway. Static layers are recorded unclipped.
+//
+void GraphicsPipeline::ScissorUnclipped()
+{
+    if(mClips.empty() || mScissorOn || mRecording != NULL)
+    {
+        return;
+    }
+
+    Flush();
+    SetGLScissor(&mClips.back());
+    mScissorOn = true;
+}
+
+void GraphicsPipeline::UnscissorClips()
+{
+    if(!mScissorOn)
+    {
+        return;
+    }
+
+    Flush();
+    SetGLScissor(NULL);
+    mScissorOn = false;
+}
+
+// What moves with a quad's edges when it's clipped.
+static float Vertex::* const ClippedAttributes[] =
+{
+    &Vertex::r, &Vertex::g, &Vertex::b, &Vertex::a, &Vertex::u, &Vertex::v
+};
+static const int CLIPPED_ATTRIBUTE_COUNT = 6;
+
+//
+// The clip is taken back through the camera into world space, where the
+// verts are. Attributes are affine across an axis aligned quad, so each
+// is moved along its gradient as the corners are pulled in.
+//
+bool GraphicsPipeline::ClipQuad(Vertex* verts)
+{
+    if(mRecording != NULL)
+    {
+        return true;
+    }
+
+    // Rotated, a clip isn't axis aligned in world space.
+    if(mRotateAngle != 0 || mCamScale.x == 0 || mCamScale.y == 0)
+    {
+        ScissorUnclipped();
+        return true;
+    }
+
+    float viewWidth = 0;
+    float viewHeight = 0;
+    ViewSize(&viewWidth, &viewHeight);
+    const ClipRect& clip = mClips.back();
+    const float x0 = (clip.x - viewWidth * 0.5f - (float) mCamPosition.x) / (float) mCamScale.x;
+    const float x1 = (clip.x + clip.width - viewWidth * 0.5f - (float) mCamPosition.x) / (float) mCamScale.x;
+    const float y0 = (clip.y - viewHeight * 0.5f - (float) mCamPosition.y) / (float) mCamScale.y;
+    const float y1 = (clip.y + clip.height - viewHeight * 0.5f - (float) mCamPosition.y) / (float) mCamScale.y;
+    const float left = std::min(x0, x1);
+    const float right = std::max(x0, x1);
+    const float bottom = std::min(y0, y1);
+    const float top = std::max(y0, y1);
+
+    float minX = verts[0].x;
+    float maxX = minX;
+    float minY = verts[0].y;
+    float maxY = minY;
+    for(int i = 1; i < 6; i++)
+    {
+        minX = std::min(minX, verts[i].x);
+        maxX = std::max(maxX, verts[i].x);
+        minY = std::min(minY, verts[i].y);
+        maxY = std::max(maxY, verts[i].y);
+    }
+
+    if(minX >= left && maxX <= right && minY >= bottom && maxY <= top)
+    {
+        return true; // the common case, nothing to cut
+    }
+
+    if(maxX <= left || minX >= right || maxY <= bottom || minY >= top
+       || minX == maxX || minY == maxY)
+    {
+        return false;
+    }
+
+    // Every vert has to be a corner, otherwise it's rotated.
+    int corner00 = -1;
+    int corner10 = -1;
+    int corner01 = -1;
+    for(int i = 0; i < 6; i++)
+    {
+        const bool atMinX = verts[i].x == minX;
+        const bool atMinY = verts[i].y == minY;
+        if(!(atMinX || verts[i].x == maxX) || !(atMinY || verts[i].y == maxY))
+        {
+            ScissorUnclipped();
+            return true;
+        }
+
+        if(atMinX && atMinY) { corner00 = i; }
+        else if(!atMinX && atMinY) { corner10 = i; }
+        else if(atMinX && !atMinY) { corner01 = i; }
+    }
+
+    if(corner00 < 0 || corner10 < 0 || corner01 < 0)
     {
-        glDisable(GL_SCISSOR_TEST);
+        ScissorUnclipped();
+        return true;
+    }
+
+    float gradientX[CLIPPED_ATTRIBUTE_COUNT];
+    float gradientY[CLIPPED_ATTRIBUTE_COUNT];
+    for(int k = 0; k < CLIPPED_ATTRIBUTE_COUNT; k++)
+    {
+        const float origin = verts[corner00].*ClippedAttributes[k];
+        gradientX[k] = (verts[corner10].*ClippedAttributes[k] - origin) / (maxX - minX);
+        gradientY[k] = (verts[corner01].*ClippedAttributes[k] - origin) / (maxY - minY);
+    }
+
+    for(int i = 0; i < 6; i++)
+    {
+        Vertex& vertex = verts[i];
+        const float x = std::min(std::max(vertex.x, left), right);
+        const float y = std::min(std::max(vertex.y, bottom), top);
+        for(int k = 0; k < CLIPPED_ATTRIBUTE_COUNT; k++)
+        {
+            vertex.*ClippedAttributes[k] += gradientX[k] * (x - vertex.x)
+                                          + gradientY[k] * (y - vertex.y);
+        }
+        vertex.x = x;
+        vertex.y = y;
     }
+    return true;
 }
\ No newline at end of file
@@ -1,34 +1,154 @@
 #ifndef GRAPHICSPIPELINE_H
 #define GRAPHICSPIPELINE_H
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "DinodeckGL.h"
 #include "Vector.h"
 #include "DDTextAlign.h"
+#include "CommandList.h"
+#include "GLStateCache.h"
+#include "TextLayoutCache.h"
 #include "Vertex.h"
 
 class Sprite;
+class TextRun;
+struct SpriteRecord;
 class Texture;
-class FTTextureFont;
+class Font;
+class Mesh;
+class ParticleEmitter;
+class RenderTarget;
+class ShaderProgram;
+class StaticLayer;
+class Tilemap;
+struct Transform2D;
 
 
 
 enum eDrawMode
 {
     TRIANGLES = GL_TRIANGLES,
-    LINES = GL_LINE_STRIP,
+    LINES = GL_LINES,
+    // Four verts a quad, TL TR BL BR, drawn as indexed triangles. GL_QUADS's
+    // value, but never passed to GL.
+    QUADS = 0x0007,
+};
+
+// How deferred quads are ordered within a layer.
+enum eDepthSort
+{
+    DEPTH_SORT_NONE, // submission order
+    DEPTH_SORT_Y,    // higher on screen drawn first, for top down games
+    DEPTH_SORT_Z,    // lower z drawn first, sprites use their position's z
+    DEPTH_SORT_COUNT
+};
+
+// How a batch uses the depth buffer, see SetOpaquePass.
+enum eDepthPass
+{
+    DEPTH_PASS_OFF,
+    DEPTH_PASS_OPAQUE,      // unblended, tests and writes depth
+    DEPTH_PASS_TRANSLUCENT  // blended, tests depth without writing it
 };
 
 enum eBlendMode
 {
     BLEND,
     ADDITIVE,
-    BLEND_COUNT
+    MULTIPLY,
+    SCREEN,
+    BLEND_COUNT,
+    // What batches of premultiplied colours are drawn with, these aren't
+    // set from Lua. BLEND and ADDITIVE share one.
+    BLEND_PREMULTIPLIED = BLEND_COUNT,
+    MULTIPLY_PREMULTIPLIED,
+    SCREEN_PREMULTIPLIED
+};
+
+// Why a batch was drawn before it was full.
+enum eFlushReason
+{
+    FLUSH_OTHER, // camera, blend, clipping or an explicit Flush
+    FLUSH_TEXTURE,
+    FLUSH_MODE, // lines and triangles
+    FLUSH_CAPACITY,
+    FLUSH_TEXT, // in or out of alpha tested text
+    FLUSH_REASON_COUNT
+};
+
+// How a sprite's corners are worked out, the cheapest its transform allows.
+enum eSpritePath
+{
+    SPRITE_PATH_TRANSLATE, // unrotated and unscaled
+    SPRITE_PATH_SCALE,     // unrotated
+    SPRITE_PATH_AFFINE,
+    SPRITE_PATH_COUNT
+};
+
+//
+// GL work done by every pipeline in a frame.
+//
+struct DrawStats
+{
+    unsigned int drawCalls;
+    unsigned int verts;
+    unsigned int flushes[FLUSH_REASON_COUNT]; // batches with verts in
+    unsigned int glyphUploadBytes; // new glyphs copied into font textures
+    unsigned int mergedBatches; // recorded batches that joined the draw before
+    unsigned int spritePaths[SPRITE_PATH_COUNT]; // sprites pushed down each
+
+    DrawStats() { Clear(); }
+    void Clear()
+    {
+        drawCalls = 0;
+        verts = 0;
+        glyphUploadBytes = 0;
+        mergedBatches = 0;
+        for(int i = 0; i < FLUSH_REASON_COUNT; i++)
+        {
+            flushes[i] = 0;
+        }
+        for(int i = 0; i < SPRITE_PATH_COUNT; i++)
+        {
+            spritePaths[i] = 0;
+        }
+    }
+};
+
+//
+// A sprite, rect or glyph recorded in deferred mode.
+// Sort key, high to low: layer 16 bits, depth 24, blend 4, draw mode 1,
+// texture id 19. Only batching depends on the texture bits, so ids past
+// 19 bits sharing a key just draw in submission order.
+//
+struct DrawCommand
+{
+    unsigned long long sortKey;
+    // Into the queued verts, six as two triangles. The batch takes four
+    // of them, TL TR BL BR, when it's QUADS and all six for TRIANGLES.
+    unsigned int firstVert;
+    GLuint textureId;
+    eBlendMode blend;
+    bool alphaTest;
+    bool premultiplied;
+    bool opaque; // drawn in the opaque pass, when it's on
+};
+
+// A clip region in view pixels, from the bottom left.
+struct ClipRect
+{
+    int x;
+    int y;
+    int width;
+    int height;
 };
 
 class GraphicsPipeline
 {
-    static const unsigned int BUFFER_SIZE_IN_VERTS = 1024;
-    static const unsigned int POSITION_SIZE = 3; // no w
+    static const unsigned int POSITION_SIZE = 2; // the batch is 2D
     static const unsigned int COLOUR_SIZE = 4;
     static const unsigned int TEXCOORD_SIZE = 2;
 
@@ -36,40 +156,198 @@ class GraphicsPipeline
     static const char* AlignYStr[AlignY::Count];
 
     eDrawMode mDrawMode;
-    Vertex mVertexBuffer[BUFFER_SIZE_IN_VERTS];
+    std::vector<PackedVertex> mVertexBuffer; // empty until first drawn with
+    unsigned int mBatchSize; // in verts
     unsigned int mVertCount;
-    Texture* mTexture;
-    FTTextureFont* mFont;
+    unsigned int mCapacityFlushCount; // flushes forced by a full batch
+    GLuint mTextureId; // bound for the current batch, 0 for untextured
+    TextureSlots mSlots; // when mTextureId is SLOT_BATCH
+    UVBase mUVBase; // what the batch's packed uvs are relative to
+    std::vector<unsigned char> mVertexSlots; // each batch vert's slot
+    std::vector<Texture*> mSpriteTextures; // PushSprites' scratch
+    std::vector<PackedVertex> mSpriteQuads;
+    std::vector<unsigned char> mSpriteResults;
+    bool mAlphaTest; // current batch is distance field text
+    Font* mFont;
     double mFontScaleX;
     double mFontScaleY;
     double mTextRotation;
+    float mTextCos; // text rotation cached while text is pushed
+    float mTextSin;
     AlignX::Enum mAlignX;
     AlignY::Enum mAlignY;
+    TextLayoutCache mLayoutCache;
     Vector mCamPosition;
     Vector mCamScale;
     float mRotateAngle;
-    eBlendMode mBlendMode;
+    bool mBakeCamera; // the camera's applied to verts, not by GL
+    unsigned int mBakedVertCount; // batch verts already moved by it
+    bool mPushingBaked; // queued verts being batched were moved as recorded
+    eBlendMode mBlendMode; // blend verts are pushed with
+    eBlendMode mBatchBlend; // blend the batch is drawn with in GL
+    eBlendMode mQueueBlend; // blend new deferred commands are recorded with
+    bool mDeferred;
+    eDepthSort mDepthSort;
+    bool mOpaquePass;
+    eDepthPass mBatchDepthPass; // what the batch is drawn with
+    float mBatchDepth;
+    std::vector<unsigned int> mDepthGroups; // per queued command, back to front
+    unsigned int mLayer;
+    std::vector<DrawCommand> mCommands;
+    std::vector<DrawCommand> mSortScratch; // radix sort's second buffer
+    std::vector<Vertex> mQueuedVerts;
     int mScissorRefCount;
+    bool mClipOnCPU;
+    std::vector<ClipRect> mClips; // CPU clipping's regions, innermost last
+    bool mScissorOn; // GL scissoring what the CPU couldn't clip
     std::string mFontName;
+    bool mCulling;
+    unsigned int mCulledCount; // this frame
+    unsigned int mCulledLastFrame;
+    std::map<int, StaticLayer*> mStaticLayers;
+    int mNextStaticHandle;
+    StaticLayer* mRecording; // batches flush into this instead of drawing
+    int mRecordingHandle;
+
+    // GL state is shared, so the cache is shared by all pipelines.
+    static GLStateCache mGLState;
+
+    // Shared so draws from different pipelines keep their order.
+    static CommandList mFrameCommands;
+    static bool mRecordFrames;
+
+    // Programmable path, NULL shaders mean the default.
+    static bool mUseShaders;
+    static ShaderProgram* mDefaultShader;
+    static ShaderProgram* mActiveShader; // bound between BeginDraw and EndDraw
+    static const PackedVertex* mDrawBase; // what BeginDraw pointed at
+    static UVBase mDrawUVBase; // the texture matrix's, without a shader
+    // The default shader with several samplers, for batches that mix
+    // textures. Textures per batch, 1 turns it off.
+    static ShaderProgram* mSlotShader;
+    static unsigned int mTextureSlots;
+    std::vector<ShaderProgram*> mShaderStack;
+
+    // The GL frame buffer binding is shared, so the target is too.
+    static RenderTarget* mTarget;
+    // How much of the view the scene is drawn at, see DynamicResolution.
+    static float mViewScale;
+    // Scissors on the screen are kept inside this, see SetFrameClip.
+    static ClipRect mFrameClip;
+    static bool mFrameClipped;
+    static bool mDrawOverdraw;
+    static bool mDepthMasked; // depth writes off, clears need them on
+
+    static DrawStats mStats; // this frame
+    static DrawStats mLastFrameStats;
+
+    // cos, sin pairs keyed on segment count
+    static const unsigned int MAX_UNIT_CIRCLES = 32;
+    static std::map<float, std::vector<float> > mUnitCircles;
+    static const std::vector<float>& UnitCircle(float segments);
 public:
     static const char* BlendStr[BLEND_COUNT];
+    static const char* FlushReasonStr[FLUSH_REASON_COUNT];
+    static const char* SpritePathStr[SPRITE_PATH_COUNT];
+    static const unsigned int DEFAULT_BATCH_SIZE_IN_VERTS = 1024;
+    // mTextureId while a batch mixes textures. Nothing else that batches
+    // uses it, so they all flush.
+    static const GLuint SLOT_BATCH = 0xFFFFFFFF;
+    // Runs of this many sprites or more are built on the job system.
+    static const unsigned int PARALLEL_SPRITES = 2048;
+    static const unsigned int SPRITE_GRAIN = 512;
+
+    static GLStateCache& GLState() { return mGLState; }
 
-    GraphicsPipeline()
+    // Call once at the start of each frame, before anything is drawn.
+    static void NewFrame();
+    static const DrawStats& LastFrameStats() { return mLastFrameStats; }
+    static std::string StatsReport();
+
+    // When recording, batches and clipping are kept in a command list
+    // during the frame and SubmitFrame does all the GL work at its end.
+    static void SetRecordFrames(bool value);
+    static bool IsRecordingFrames() { return mRecordFrames; }
+    static void SubmitFrame();
+    // Does the GL work for a list recorded like the frame's, leaving it as it is.
+    static void SubmitCommands(const CommandList& list);
+    // The scene is drawn into the bottom left of the view at this scale,
+    // so scissors on the screen are scaled to match. Targets aren't.
+    static void SetViewScale(float scale) { mViewScale = scale; }
+    // Everything drawn to the screen is scissored to the clip, clips
+    // inside it are intersected with it. NULL lets the whole view be
+    // drawn again. Dinodeck sets it around a partial_redraw frame.
+    static void SetFrameClip(const ClipRect* clip);
+    // Every draw adds the same grey, untextured, whatever it was going to
+    // look like, for OverdrawMap to count.
+    static void SetDrawOverdraw(bool value) { mDrawOverdraw = value; }
+    static bool IsDrawingOverdraw() { return mDrawOverdraw; }
+    // Drops what's been recorded this frame without drawing it.
+    static void DiscardFrame() { mFrameCommands.Clear(); }
+
+    // Draws go through GLSL programs when the GL supports them and fall
+    // back to fixed function when it doesn't. Scripts can push their own
+    // fragment shaders, see ShaderProgram.
+    static void SetUseShaders(bool value) { mUseShaders = value; }
+    static bool IsUsingShaders() { return mUseShaders; }
+    // With shaders, sprites using up to count textures share a batch, each
+    // vert picking its texture. Custom shaders, static layers and the
+    // overdraw map keep a texture per batch.
+    static void SetTextureSlots(unsigned int count);
+    static unsigned int GetTextureSlots() { return mTextureSlots; }
+    void PushShader(ShaderProgram* shader);
+    void PopShader();
+
+    // Draws from any pipeline go into the target until EndTarget, sized
+    // and culled to it. Both flush and submit what's been recorded.
+    void BeginTarget(RenderTarget* target);
+    void EndTarget();
+
+    // Ends a target left open, once every pipeline has been flushed.
+    static void FinishTarget();
+
+    GraphicsPipeline(unsigned int batchSize = DEFAULT_BATCH_SIZE_IN_VERTS)
         : mDrawMode(TRIANGLES),
+          mVertexBuffer(),
+          mBatchSize(0),
           mVertCount(0),
-          mTexture(NULL),
+          mCapacityFlushCount(0),
+          mTextureId(0),
+          mAlphaTest(false),
           mFont(NULL),
           mFontScaleX(0.25),
           mFontScaleY(0.25),
           mTextRotation(0),
+          mTextCos(1),
+          mTextSin(0),
           mAlignX(AlignX::Left),
           mAlignY(AlignY::Top),
           mCamPosition(),
           mCamScale(1,1,1,1),
           mRotateAngle(0),
+          mBakeCamera(false),
+          mBakedVertCount(0),
+          mPushingBaked(false),
           mBlendMode(BLEND),
-          mScissorRefCount(0)
-           { Reset(); }
+          mBatchBlend(BLEND),
+          mQueueBlend(BLEND),
+          mDeferred(false),
+          mDepthSort(DEPTH_SORT_NONE),
+          mOpaquePass(false),
+          mBatchDepthPass(DEPTH_PASS_OFF),
+          mBatchDepth(0),
+          mLayer(0),
+          mScissorRefCount(0),
+          mClipOnCPU(false),
+          mScissorOn(false),
+          mCulling(true),
+          mCulledCount(0),
+          mCulledLastFrame(0),
+          mNextStaticHandle(1),
+          mRecording(NULL),
+          mRecordingHandle(0)
+           { SetBatchSize(batchSize); Reset(); }
+    ~GraphicsPipeline();
 
 
     double GetFontScaleX() const { return mFontScaleX; }
@@ -77,27 +355,111 @@ public:
     void SetFontScale(double x, double y) { mFontScaleX = x; mFontScaleY = y; }
     void SetTextRotation(double value) { mTextRotation = value; }
     double GetTextRotation() const { return mTextRotation; }
-    void SetFont(FTTextureFont* font) { mFont = font; }
-    FTTextureFont* GetFont() { return mFont; }
-    void MeasureText(const char* text, float width, Vector* outSize) const;
+    void SetFont(Font* font) { mFont = font; }
+    Font* GetFont() { return mFont; }
+    void MeasureText(const char* text, float width, Vector* outSize);
     void SetTextAlignX(AlignX::Enum align);
     void SetTextAlignY(AlignY::Enum align);
     const Vector& CameraPosition() { return mCamPosition; }
-    void SetCameraPosition(const Vector& pos) { Flush(); mCamPosition.SetXyzw(pos); }
-    void SetCameraPosition(float x, float y) { Flush(); mCamPosition.SetXyzw(x, y, 0, 0); }
+    void SetCameraPosition(const Vector& pos) { MoveCamera(); mCamPosition.SetXyzw(pos); }
+    void SetCameraPosition(float x, float y) { MoveCamera(); mCamPosition.SetXyzw(x, y, 0, 0); }
     const Vector& CameraScale() { return mCamScale; }
-    void SetCameraScale(const Vector& pos) { mCamScale.SetXyzw(pos); }
-    void SetCameraScale(float sx, float sy) { mCamScale.SetXyzw(sx, sy, 1, 0); }
+    void SetCameraScale(const Vector& pos) { BakeCamera(); mCamScale.SetXyzw(pos); }
+    void SetCameraScale(float sx, float sy) { BakeCamera(); mCamScale.SetXyzw(sx, sy, 1, 0); }
     float CameraRotation() const { return mRotateAngle; }
-    void SetCameraRotation(float value) { mRotateAngle = value; }
+    void SetCameraRotation(float value) { BakeCamera(); mRotateAngle = value; }
+    // With the camera baked, verts are moved by it as they're batched
+    // rather than by GL when drawn, so camera changes don't split batches
+    // and deferred quads drawn with different cameras still sort together.
+    // Parallax layers then share draws. Static layers are recorded in
+    // world space either way and drawn with the camera.
+    void SetCameraBaked(bool value);
+    bool IsCameraBaked() const { return mBakeCamera; }
     void Reset(); // This resets some of the font state info.
-    void OnNewFrame() { mTexture = NULL; }
+    void OnNewFrame()
+    {
+        mTextureId = 0;
+        mSlots = TextureSlots();
+        mCulledLastFrame = mCulledCount;
+        mCulledCount = 0;
+        mShaderStack.clear(); // pushed shaders last a frame
+    }
     bool SetFont(const char* name);
     void ClearCachedFont() { mFont = NULL; }
+    // Drops the cached font if it's the one going, it's found by name again
+    // on the next draw.
+    void ForgetFont(const std::string& name, Font* font)
+    {
+        if(mFont == font || mFontName == name)
+        {
+            mFont = NULL;
+        }
+    }
 
     void SetBlend(eBlendMode blend);
+    // What verts pushed with the blend are drawn with, premultiplied
+    // BLEND and ADDITIVE share a GL blend so they can share a batch.
+    static eBlendMode BatchBlend(eBlendMode blend, bool premultiplied);
+    // A colour pushed with blend as it goes into a batchBlend batch.
+    static void BatchColour(eBlendMode blend, eBlendMode batchBlend,
+                            float* r, float* g, float* b, float* a);
+
+    // Batch size is in verts, 6 per sprite.
+    // Shrinking below the verts already queued flushes them first.
+    unsigned int BatchSize() const { return mBatchSize; }
+    void SetBatchSize(unsigned int verts);
+    unsigned int CapacityFlushCount() const { return mCapacityFlushCount; }
+    const TextLayoutCache& LayoutCache() const { return mLayoutCache; }
+    // Empties the layout cache, returns about how many bytes it held.
+    unsigned int ReleaseLayoutCache()
+    {
+        unsigned int bytes = mLayoutCache.Bytes();
+        mLayoutCache.Clear();
+        return bytes;
+    }
+
+    // Sprites, rects, circles and unrotated text entirely outside the
+    // view are dropped before their verts are made.
+    void SetCulling(bool value) { mCulling = value; }
+    bool IsCulling() const { return mCulling; }
+    unsigned int CulledLastFrame() const { return mCulledLastFrame; }
+
+    // In deferred mode sprites, rects and text are queued and drawn sorted
+    // by layer, depth, blend and texture on the next Flush. Lines, circles,
+    // camera moves and clipping still Flush, so they act as barriers.
+    void SetDeferred(bool value);
+    bool IsDeferred() const { return mDeferred; }
+    void SetLayer(unsigned int layer) { mLayer = layer; }
+    unsigned int Layer() const { return mLayer; }
+    // Within a layer deferred quads can be ordered by depth before blend
+    // and texture, replacing a sort in script.
+    void SetDepthSort(eDepthSort value) { mDepthSort = value; }
+    eDepthSort DepthSort() const { return mDepthSort; }
+    // Deferred sprites that fully cover what they're drawn over, with an
+    // opaque texture or flagged opaque, normal blend and full alpha, are
+    // drawn first, front to back with depth testing and no blending, so
+    // what they hide is never filled. Everything else follows back to
+    // front, tested against them. Only when drawing to the screen.
+    void SetOpaquePass(bool value);
+    bool IsOpaquePass() const { return mOpaquePass; }
+
+    void Flush(eFlushReason reason = FLUSH_OTHER);
+
+    // Everything pushed between BeginStatic and EndStatic is kept in a GPU
+    // buffer instead of drawn, DrawStatic replays it with the current
+    // camera. Passing an existing handle to BeginStatic rebuilds it.
+    // After the GL context is lost DrawStatic returns false until the
+    // layer is recorded again.
+    void BeginStatic(int handle = 0);
+    int EndStatic(); // returns the handle, 0 if nothing was being recorded
+    bool DrawStatic(int handle);
+    void FreeStatic(int handle);
+    void ResetStatic(); // call when the GL context is lost
+    // Drawn from the mesh's own buffer with the current camera, moved by
+    // x and y. False if it's empty or its texture isn't loaded. Meshes
+    // aren't recorded into static layers.
+    bool DrawMesh(Mesh* mesh, float x, float y);
 
-    void Flush();
     void PushCircle(float x,
                     float y,
                     float radius,
@@ -108,22 +470,228 @@ public:
                        float top,
                        float right,
                        const Vector& colour);
+    // Nine quads, the corners keep their size in texture pixels, the
+    // edges stretch along and the centre both ways. Borders left, bottom,
+    // right, top. They shrink together if the rect is too small for them.
+    void PushNineSlice(const Texture* texture,
+                       float left,
+                       float bottom,
+                       float right,
+                       float top,
+                       const float* borders,
+                       const Vector& colour);
     void PushLine(float x1,
                   float y1,
                   float x2,
                   float y2,
                   const Vector& colour);
 
+    // Points are x, y pairs.
+    // Polygons are filled as a fan from the first point, so they should
+    // be convex. Lines join each point to the next, width pixels thick.
+    void PushFilledCircle(float x,
+                          float y,
+                          float radius,
+                          float segments,
+                          const Vector& colour);
+    void PushPolygon(const float* points,
+                     unsigned int numPoints,
+                     const Vector& colour);
+    void PushLines(const float* points,
+                   unsigned int numPoints,
+                   float width,
+                   const Vector& colour);
+
+    // A Sprite is drawn through its SpriteRecord.
     void PushSprite(const Sprite* sprite);
+    void PushSprite(const SpriteRecord* sprite);
+    // The sprite's position, rotation and scale give way to world's,
+    // its z is kept.
+    void PushSprite(const Sprite* sprite, const Transform2D& world);
+    void PushSprite(const SpriteRecord* sprite, const Transform2D& world);
+    // As PushSprite for each, big runs build their verts in parallel.
+    void PushSprites(const SpriteRecord* sprites, unsigned int count);
+    // Verts straight into the batch, whole triangles or, for QUADS, quads
+    // of TL TR BL BR. Uvs are for the whole texture, which may be NULL.
+    // Anything past the last whole primitive is left out.
+    void PushVertices(const PackedVertex* verts,
+                      unsigned int count,
+                      Texture* texture,
+                      eDrawMode mode);
+
+    // Draws the map's chunks that are in view. Flushes first, like lines.
+    void PushTilemap(Tilemap* tilemap);
+    void PushParticles(const ParticleEmitter& emitter);
 
     void PushText(float x,
                   float y,
                   const char* text,
                   const Vector& colour,
                   int width);
+    // The run's first count glyphs, laid out again only if the font,
+    // alignment or scale changed since it was last drawn.
+    void PushTextRun(float x,
+                     float y,
+                     TextRun* run,
+                     unsigned int count,
+                     const Vector& colour);
+
+    // A glyph quad in font space, top left to bottom right.
+    // The font scale and text rotation are applied here.
+    // Distance field glyphs are alpha tested at the outline.
+    void PushGlyph(GLuint textureId,
+                   float left, float top, float right, float bottom,
+                   float u0, float v0, float u1, float v1,
+                   const Vector& colour,
+                   bool distanceField);
 
     void PushScissor(int x, int y, int width, int height);
     void PopScissor();
+    // Clipping on the CPU cuts axis aligned sprites, rects and text to
+    // the clip, moving their uvs with their edges, so clips don't split
+    // batches. Nested clips are intersected. Anything else drawn inside a
+    // clip, like lines, particles or rotated sprites, is scissored by GL
+    // as before. Can't be changed inside a clip.
+    void SetClipOnCPU(bool value);
+    bool IsClippingOnCPU() const { return mClipOnCPU; }
+    bool IsClipping() const { return mScissorRefCount > 0 || !mClips.empty(); }
+private:
+    static void SetGLScissor(const ClipRect* clip); // NULL turns it off
+    // Turns the GL scissor on for the clip, inside the frame clip. NULL
+    // leaves just the frame clip, if there is one.
+    static void ApplyScissor(const ClipRect* clip);
+    static void Scissor(int x, int y, int width, int height);
+    // False if nothing of the quad is left. Quads it can't cut are
+    // scissored instead.
+    bool ClipQuad(Vertex* verts);
+    // Turns the GL scissor on for what can't be clipped on the CPU.
+    void ScissorUnclipped();
+    void UnscissorClips();
+    void BatchQuad(const Vertex* verts, GLuint textureId,
+                   bool alphaTest, bool premultiplied);
+    bool IsOffScreen(float x, float y, float radius);
+    // As IsOffScreen without counting the cull, safe from workers.
+    bool IsOutsideView(float x, float y, float radius) const;
+    bool PrepareText(); // false if there's no font to draw with
+    float WrapWidth(float width) const;
+    TextLayoutCache::Entry* FindLayout(const char* text, int width);
+    bool ReserveVerts(unsigned int numVerts);
+    void ReserveLines(unsigned int numVerts);
+    void ReserveTriangles(unsigned int numVerts);
+    void ReserveTriangles(unsigned int numVerts, GLuint textureId, bool premultiplied);
+    // Copies verts into the batch with their uvs moved into the texture's
+    // region and their colours as the batch takes them.
+    void CopyVerts(const PackedVertex* verts,
+                   unsigned int count,
+                   const Texture* texture,
+                   PackedVertex* out) const;
+    void PushPackedQuad(const PackedVertex* quad, const Texture* texture,
+                        GLuint textureId, bool premultiplied);
+    void PushTriangle(float x1, float y1,
+                      float x2, float y2,
+                      float x3, float y3,
+                      const Vector& colour);
+    void FlushBatch(eFlushReason reason = FLUSH_OTHER);
+    // Moves the verts batched since the camera last changed by it, when
+    // it's baked. Call before the camera changes.
+    void BakeCamera();
+    // Camera moves draw what's been pushed unless the camera is baked.
+    void MoveCamera() { if(mBakeCamera) { BakeCamera(); } else { Flush(); } }
+    static void DrawArrays(GLenum mode, GLint first, GLsizei count);
+    // Slots, if there are any, are vert first's and on.
+    static void DrawQuads(GLint first, GLsizei count, const unsigned char* slots);
+    static void BeginOverdraw();
+    static void EndOverdraw();
+    static void BeginDraw(const PackedVertex* base, ShaderProgram* shader);
+    static void SetVertexPointers(const PackedVertex* base, GLint first);
+    static void SetSlotPointer(const unsigned char* slots);
+    // For the draws after, BeginDraw sets the default.
+    static void ApplyUVBase(const UVBase& base);
+    static void EndDraw();
+    static ShaderProgram* UseShader(ShaderProgram* shader);
+    // False when quads should batch by texture.
+    bool UseTextureSlots() const;
+    static void BindTextureSlots(const TextureSlots& slots);
+    static void PushCamera(const Vector& position,
+                           const Vector& scale,
+                           float rotation,
+                           float offsetX,
+                           float offsetY);
+    static void PopCamera();
+    static void ViewSize(float* width, float* height);
+    static void SetGLBlend(eBlendMode blend);
+    // Flushes if the batch is drawn with a different blend.
+    void UseBatchBlend(eBlendMode batchBlend);
+    // Flushes if the batch uses depth differently.
+    void UseBatchDepth(eDepthPass pass, float depth);
+    static void ApplyDepthPass(eDepthPass pass, float depth);
+    static void ClearDepth();
+    // The colour as it goes into the batch. Premultiplied, and with no
+    // alpha for additive, so it doesn't cover what's behind.
+    Vector BatchColour(const Vector& colour) const;
+    void BatchColour(float* r, float* g, float* b, float* a) const;
+    static void ApplyDrawState(GLuint textureId, bool alphaTest);
+    ShaderProgram* CurrentShader() const
+    {
+        return mShaderStack.empty() ? NULL : mShaderStack.back();
+    }
+    // Ranges recorded untextured are drawn with textureId.
+    void DrawLayer(StaticLayer* layer, float offsetX, float offsetY, GLuint textureId = 0);
+    void FlushQueue();
+    // Returns false, drawing nothing, if there are too many depth groups.
+    bool FlushQueueOpaqueFirst();
+    void ApplyBlend(eBlendMode blend);
+    void PushQuad(const Vertex* verts, GLuint textureId,
+                  bool alphaTest, bool premultiplied);
+    unsigned int PrepareQuad(GLuint textureId, bool alphaTest, bool premultiplied,
+                             const UVBase& uvBase = UVBase());
+    // The texture is the sprite's, resolved once by the caller.
+    static void SpriteHalfSize(const SpriteRecord* sprite, const Texture* texture,
+                               float* halfWidth, float* halfHeight);
+    // Shrinks the quad and its uvs, relative to the texture, to the
+    // texture's trim. False if none of the sprite is left.
+    static bool TrimSprite(const Texture* texture,
+                           float* topLeftU, float* topLeftV,
+                           float* bottomRightU, float* bottomRightV,
+                           float* wx, float* wy, float* hx, float* hy,
+                           float* tx, float* ty);
+    static eSpritePath SpriteExtents(const SpriteRecord* sprite,
+                                     const Texture* texture,
+                                     float* wx, float* wy,
+                                     float* hx, float* hy,
+                                     float* radius);
+    static bool MapSprite(const SpriteRecord* sprite,
+                          const Texture* texture,
+                          float* uvs,
+                          float* wx, float* wy,
+                          float* hx, float* hy,
+                          float* tx, float* ty);
+    static void PackSprite(const SpriteRecord* sprite,
+                           eSpritePath path,
+                           const float* uvs,
+                           float wx, float wy,
+                           float hx, float hy,
+                           float tx, float ty,
+                           eBlendMode blend,
+                           bool premultiplied,
+                           PackedVertex* out);
+    static bool PackedUVs(const float* uvs);
+    static void QuadToTriangles(PackedVertex* quad);
+    // PushSprites' per sprite results, other than an eSpritePath.
+    static const unsigned char SPRITE_CULLED = 0xFF;
+    static const unsigned char SPRITE_EMPTY = 0xFE;
+    static const unsigned char SPRITE_UNPACKED = 0xFD; // uvs need a UVBase
+    struct SpriteBuild;
+    static void BuildSprites(void* data, unsigned int begin, unsigned int end);
+    // wy and hx are 0 unless the path's SPRITE_PATH_AFFINE.
+    void EmitSprite(const SpriteRecord* sprite,
+                    const Texture* texture,
+                    eSpritePath path,
+                    float wx, float wy,
+                    float hx, float hy,
+                    float tx, float ty, float tz);
+    void RecordQuad(const Vertex* verts, GLuint textureId,
+                    bool alphaTest, bool premultiplied, bool opaque = false);
 };
 
 #endif
\ No newline at end of file
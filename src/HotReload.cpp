@@ -0,0 +1,151 @@
+#include "HotReload.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "DinodeckLua.h"
+#include "DDLog.h"
+#include "LuaState.h"
+
+// Returns Snapshot, which copies the globals before the script runs, and
+// Patch, which takes that copy and merges the changes after.
+static const char* PATCH_SOURCE =
+    "local function Snapshot()\n"
+    "    local before = {}\n"
+    "    for k, v in pairs(_G) do\n"
+    "        before[k] = v\n"
+    "    end\n"
+    "    return before\n"
+    "end\n"
+    "\n"
+    "-- Pairs each rebuilt table with the one it replaces.\n"
+    "local function Match(old, new, map)\n"
+    "    if map[new] then\n"
+    "        return\n"
+    "    end\n"
+    "    map[new] = old\n"
+    "    for k, v in pairs(new) do\n"
+    "        local o = rawget(old, k)\n"
+    "        if type(o) == \"table\" and type(v) == \"table\" and o ~= v then\n"
+    "            Match(o, v, map)\n"
+    "        end\n"
+    "    end\n"
+    "end\n"
+    "\n"
+    "-- Points upvalues at the old tables, \"local M = Module\" for instance.\n"
+    "local function Rebind(f, map, done)\n"
+    "    if done[f] then\n"
+    "        return\n"
+    "    end\n"
+    "    done[f] = true\n"
+    "    local i = 1\n"
+    "    while true do\n"
+    "        local name, value = debug.getupvalue(f, i)\n"
+    "        if name == nil then\n"
+    "            break\n"
+    "        end\n"
+    "        if type(value) == \"table\" and map[value] then\n"
+    "            debug.setupvalue(f, i, map[value])\n"
+    "        elseif type(value) == \"function\" then\n"
+    "            Rebind(value, map, done)\n"
+    "        end\n"
+    "        i = i + 1\n"
+    "    end\n"
+    "end\n"
+    "\n"
+    "local function Copy(old, new, map, done)\n"
+    "    if done[new] then\n"
+    "        return\n"
+    "    end\n"
+    "    done[new] = true\n"
+    "    for k, v in pairs(new) do\n"
+    "        local o = rawget(old, k)\n"
+    "        if map[v] then\n"
+    "            rawset(old, k, map[v])\n"
+    "            Copy(map[v], v, map, done)\n"
+    "        elseif type(o) == \"userdata\" and type(v) == \"userdata\" then\n"
+    "            -- Keep the live object, the new one is collected.\n"
+    "        else\n"
+    "            if type(v) == \"function\" then\n"
+    "                Rebind(v, map, done)\n"
+    "            end\n"
+    "            rawset(old, k, v)\n"
+    "        end\n"
+    "    end\n"
+    "    local meta = getmetatable(new)\n"
+    "    if type(meta) == \"table\" then\n"
+    "        setmetatable(old, map[meta] or meta)\n"
+    "    end\n"
+    "end\n"
+    "\n"
+    "local function Patch(before)\n"
+    "    local map = {}\n"
+    "    for k, v in pairs(_G) do\n"
+    "        local o = before[k]\n"
+    "        if type(o) == \"table\" and type(v) == \"table\" and o ~= v then\n"
+    "            Match(o, v, map)\n"
+    "        end\n"
+    "    end\n"
+    "\n"
+    "    local done = {}\n"
+    "    local changed = {}\n"
+    "    for k, v in pairs(_G) do\n"
+    "        if before[k] ~= v then\n"
+    "            changed[k] = v\n"
+    "        end\n"
+    "    end\n"
+    "\n"
+    "    for k, v in pairs(changed) do\n"
+    "        local o = before[k]\n"
+    "        if map[v] then\n"
+    "            rawset(_G, k, map[v])\n"
+    "            Copy(map[v], v, map, done)\n"
+    "        elseif type(o) == \"userdata\" and type(v) == \"userdata\" then\n"
+    "            rawset(_G, k, o)\n"
+    "        elseif type(v) == \"function\" then\n"
+    "            Rebind(v, map, done)\n"
+    "        elseif type(v) == \"table\" then\n"
+    "            Copy(v, v, map, done)\n"
+    "        end\n"
+    "    end\n"
+    "end\n"
+    "\n"
+    "return Snapshot, Patch\n";
+
+bool HotReload::Run(LuaState* state, const char* path)
+{
+    assert(state);
+    lua_State* luaState = state->State();
+    int top = lua_gettop(luaState);
+
+    if(luaL_loadbuffer(luaState, PATCH_SOURCE, strlen(PATCH_SOURCE), "=HotReload")
+       || lua_pcall(luaState, 0, 2, 0))
+    {
+        dsprintf("[HotReload] %s\n", lua_tostring(luaState, -1));
+        lua_settop(luaState, top);
+        return false;
+    }
+
+    const int snapshot = top + 1;
+    const int patch = top + 2;
+    lua_pushvalue(luaState, snapshot);
+    lua_call(luaState, 0, 1);
+    const int before = top + 3;
+
+    bool success = state->DoFile(path);
+    lua_settop(luaState, before); // whatever the script returned
+
+    if(success)
+    {
+        lua_pushvalue(luaState, patch);
+        lua_pushvalue(luaState, before);
+        if(lua_pcall(luaState, 1, 0, 0))
+        {
+            dsprintf("[HotReload] %s: %s\n", path, lua_tostring(luaState, -1));
+            success = false;
+        }
+    }
+
+    lua_settop(luaState, top);
+    return success;
+}
\ No newline at end of file
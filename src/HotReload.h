@@ -0,0 +1,23 @@
+#ifndef HOTRELOAD_H
+#define HOTRELOAD_H
+
+class LuaState;
+
+//
+// Runs a changed script again in the live Lua state, rather than resetting
+// the state and starting the game over.
+//
+// Tables the script rebuilds are merged into the ones they replace, so
+// metatables, instances and other references keep working and pick up the
+// new functions. New values overwrite old ones, except userdata such as
+// textures and renderers, which are kept. Tables are matched by key from
+// the globals down.
+//
+class HotReload
+{
+public:
+    // False if the script failed, the state may be half patched.
+    static bool Run(LuaState* state, const char* path);
+};
+
+#endif
\ No newline at end of file
@@ -1,8 +1,12 @@
 #include "Http.h"
 
+#include <assert.h>
+
 #include "DinodeckLua.h"
 #include "DDLog.h"
 #include "DDRestful.h"
+#include "Game.h"
+#include "HttpBatcher.h"
 #include "HttpPostData.h"
 #include "LuaState.h"
 #include "reflect/Reflect.h"
@@ -22,7 +26,7 @@ static int lua_Http_Post(lua_State* state)
 
     // HttpPost Data is optional
     HttpPostData* httpPostData = NULL;
-    if(lua_isuserdata(state, 2) && LuaState::IsType(state, 2, "HttpPostData"))
+    if(LuaState::IsType<HttpPostData>(state, 2))
     {
         httpPostData = reinterpret_cast<HttpPostData*>(lua_touserdata(state, 2));
     }
@@ -58,9 +62,45 @@ static int lua_Http_Post(lua_State* state)
     return 0;
 }
 
+static HttpBatcher* GetHttpBatcher(lua_State* state)
+{
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    assert(game);
+    return game->GetHttpBatcher();
+}
+
+// Http.Queue(uri, postData)
+// Sent later with other events for the same uri, see HttpBatcher.
+static int lua_Http_Queue(lua_State* state)
+{
+    if(!lua_isstring(state, 1))
+    {
+        return luaL_typerror(state, 1, "string");
+    }
+
+    if(!LuaState::IsType<HttpPostData>(state, 2))
+    {
+        return luaL_typerror(state, 2, "HttpPostData");
+    }
+    HttpPostData* httpPostData = reinterpret_cast<HttpPostData*>(lua_touserdata(state, 2));
+
+    GetHttpBatcher(state)->Queue(lua_tostring(state, 1), *httpPostData);
+    return 0;
+}
+
+// Http.Flush()
+// Sends queued events now rather than at the end of their window.
+static int lua_Http_Flush(lua_State* state)
+{
+    GetHttpBatcher(state)->Flush();
+    return 0;
+}
+
 static const struct luaL_reg luaBinding [] =
 {
     {"Post", lua_Http_Post},
+    {"Queue", lua_Http_Queue},
+    {"Flush", lua_Http_Flush},
     {NULL, NULL}  /* sentinel */
 };
 
@@ -0,0 +1,259 @@
+#include "HttpBatcher.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "DDFile.h"
+#include "DDLog.h"
+#include "DDRestful.h"
+#include "DDTime.h"
+#include "DinodeckLua.h"
+#include "HttpPostData.h"
+#include "LuaState.h"
+
+static const char* OUTBOX_MAGIC = "DDHB1\n";
+
+HttpBatcher::HttpBatcher() :
+    mWindowMs(10000),
+    mMaxEvents(50),
+    mOutboxFile(""),
+    mLoaded(false),
+    mSending(false),
+    mSendId(0),
+    mBackoffMs(MIN_BACKOFF_MS),
+    mNextAttempt(0)
+{
+}
+
+void HttpBatcher::Configure(unsigned int windowMs,
+                            unsigned int maxEvents,
+                            const std::string& outboxFile)
+{
+    mWindowMs = windowMs;
+    mMaxEvents = std::max(maxEvents, 1u);
+    if(outboxFile != mOutboxFile)
+    {
+        mOutboxFile = outboxFile;
+        mLoaded = false;
+    }
+}
+
+void HttpBatcher::Queue(const std::string& uri, const HttpPostData& data)
+{
+    Open& open = mOpen[uri];
+    if(open.count == 0)
+    {
+        open.events.clear();
+        open.opened = DDTime::Microseconds();
+    }
+    else
+    {
+        open.events.push_back('\n');
+    }
+    open.events += data.Encode();
+    open.count++;
+
+    if(open.count >= mMaxEvents)
+    {
+        Close(uri);
+    }
+}
+
+void HttpBatcher::Flush()
+{
+    while(!mOpen.empty())
+    {
+        Close(mOpen.begin()->first);
+    }
+    // Worth trying now even if the last send failed.
+    mNextAttempt = 0;
+}
+
+void HttpBatcher::Close(const std::string& uri)
+{
+    std::map<std::string, Open>::iterator it = mOpen.find(uri);
+    assert(it != mOpen.end());
+
+    Batch batch;
+    batch.uri = uri;
+    batch.events.swap(it->second.events);
+    mOpen.erase(it);
+
+    Load(); // so the saved batches go ahead of this one
+    mOutbox.push_back(batch);
+    while(mOutbox.size() > MAX_OUTBOX)
+    {
+        // Never the one in flight, its reply pops the front.
+        mOutbox.erase(mOutbox.begin() + (mSending ? 1 : 0));
+    }
+    Save();
+}
+
+void HttpBatcher::Update(LuaState* state)
+{
+    Load();
+
+    const unsigned long long now = DDTime::Microseconds();
+    for(std::map<std::string, Open>::iterator it = mOpen.begin(); it != mOpen.end();)
+    {
+        const std::string uri = it->first;
+        const bool due = now - it->second.opened >= mWindowMs * 1000ULL;
+        ++it; // Close erases
+        if(due)
+        {
+            Close(uri);
+        }
+    }
+
+    if(!mSending && !mOutbox.empty() && now >= mNextAttempt)
+    {
+        Send(state);
+    }
+}
+
+void HttpBatcher::Reset()
+{
+    // The callbacks went with the state, the reply is never coming.
+    mSending = false;
+    mSendId++;
+}
+
+void HttpBatcher::Send(LuaState* state)
+{
+    lua_State* lua = state->State();
+    const Batch& batch = mOutbox.front();
+    mSending = true;
+    mSendId++;
+
+    lua_pushlightuserdata(lua, this);
+    lua_pushinteger(lua, mSendId);
+    lua_pushcclosure(lua, &HttpBatcher::lua_OnSuccess, 2);
+    int successRef = luaL_ref(lua, LUA_REGISTRYINDEX);
+    lua_pushlightuserdata(lua, this);
+    lua_pushinteger(lua, mSendId);
+    lua_pushcclosure(lua, &HttpBatcher::lua_OnFailure, 2);
+    int failureRef = luaL_ref(lua, LUA_REGISTRYINDEX);
+
+    HttpPostData data;
+    data.AddValue("events", batch.events.c_str());
+    DDRestful::Post(batch.uri.c_str(), &data, successRef, failureRef);
+}
+
+void HttpBatcher::OnSent(unsigned int id, bool success)
+{
+    if(!mSending || id != mSendId)
+    {
+        return; // from before a reset
+    }
+    mSending = false;
+
+    if(!success)
+    {
+        mNextAttempt = DDTime::Microseconds() + mBackoffMs * 1000ULL;
+        dsprintf("Batched post to [%s] failed, trying again in %ds.\n",
+                 mOutbox.front().uri.c_str(), mBackoffMs / 1000);
+        mBackoffMs = std::min(mBackoffMs * 2, MAX_BACKOFF_MS);
+        return;
+    }
+
+    mBackoffMs = MIN_BACKOFF_MS;
+    mNextAttempt = 0;
+    mOutbox.pop_front();
+    Save();
+}
+
+int HttpBatcher::lua_OnSuccess(lua_State* state)
+{
+    HttpBatcher* batcher = (HttpBatcher*) lua_touserdata(state, lua_upvalueindex(1));
+    batcher->OnSent((unsigned int) lua_tointeger(state, lua_upvalueindex(2)), true);
+    return 0;
+}
+
+int HttpBatcher::lua_OnFailure(lua_State* state)
+{
+    HttpBatcher* batcher = (HttpBatcher*) lua_touserdata(state, lua_upvalueindex(1));
+    batcher->OnSent((unsigned int) lua_tointeger(state, lua_upvalueindex(2)), false);
+    return 0;
+}
+
+//
+// The outbox is the magic line then, for each batch:
+//     <uri length> <events length>\n<uri><events>
+//
+void HttpBatcher::Load()
+{
+    if(mLoaded)
+    {
+        return;
+    }
+    mLoaded = true;
+
+    if(mOutboxFile.empty())
+    {
+        return;
+    }
+
+    std::string data;
+    DDFile::ReadSaveData(mOutboxFile.c_str(), data);
+    const std::string magic(OUTBOX_MAGIC);
+    if(data.compare(0, magic.size(), magic) != 0)
+    {
+        return;
+    }
+
+    std::deque<Batch> saved;
+    size_t at = magic.size();
+    while(at < data.size())
+    {
+        unsigned int uriLength = 0;
+        unsigned int eventsLength = 0;
+        int read = 0;
+        if(sscanf(data.c_str() + at, "%u %u\n%n", &uriLength, &eventsLength, &read) != 2
+           || read == 0
+           || at + read + uriLength + eventsLength > data.size())
+        {
+            dsprintf("Http outbox [%s] is damaged, the rest is dropped.\n",
+                     mOutboxFile.c_str());
+            break;
+        }
+        at += read;
+
+        Batch batch;
+        batch.uri = data.substr(at, uriLength);
+        at += uriLength;
+        batch.events = data.substr(at, eventsLength);
+        at += eventsLength;
+        saved.push_back(batch);
+    }
+
+    if(!saved.empty())
+    {
+        dsprintf("Http outbox has %d unsent batches.\n", (int) saved.size());
+    }
+    // Anything closed before the load came later, but the batch in flight
+    // has to stay at the front for its reply.
+    mOutbox.insert(mOutbox.begin() + (mSending ? 1 : 0), saved.begin(), saved.end());
+}
+
+void HttpBatcher::Save()
+{
+    if(mOutboxFile.empty())
+    {
+        return;
+    }
+
+    std::string data(OUTBOX_MAGIC);
+    char lengths[32];
+    for(std::deque<Batch>::const_iterator it = mOutbox.begin(); it != mOutbox.end(); ++it)
+    {
+        snprintf(lengths, sizeof(lengths), "%u %u\n",
+                 (unsigned int) it->uri.size(),
+                 (unsigned int) it->events.size());
+        data += lengths;
+        data += it->uri;
+        data += it->events;
+    }
+    DDFile::WriteSaveData(mOutboxFile.c_str(), data.c_str());
+}
\ No newline at end of file
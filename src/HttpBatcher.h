@@ -0,0 +1,83 @@
+#ifndef HTTPBATCHER_H
+#define HTTPBATCHER_H
+
+#include <deque>
+#include <map>
+#include <string>
+
+class HttpPostData;
+class LuaState;
+struct lua_State;
+
+//
+// Coalesces fire and forget posts, such as analytics events, so the radio
+// wakes once a window rather than once an event.
+//
+// Http.Queue(uri, postData) holds the event with others for the same uri.
+// When the window is up, or the batch is full, they go in one post with a
+// single "events" field of the url encoded events, a line each.
+//
+// Batches are sent one at a time. A failed one stays at the front of the
+// outbox and is tried again after a delay that doubles up to MAX_BACKOFF.
+// The outbox is kept in save data, so batches sent while offline go out
+// on a later run.
+//
+class HttpBatcher
+{
+public:
+    static const unsigned int MIN_BACKOFF_MS = 2000;
+    static const unsigned int MAX_BACKOFF_MS = 5 * 60 * 1000;
+    static const unsigned int MAX_OUTBOX = 64; // batches, the oldest go past it
+
+    HttpBatcher();
+
+    // windowMs of 0 sends each event on the next update. An empty outbox
+    // file keeps the outbox in memory only.
+    void Configure(unsigned int windowMs,
+                   unsigned int maxEvents,
+                   const std::string& outboxFile);
+    void Queue(const std::string& uri, const HttpPostData& data);
+    // Ends every window now, say when the game's paused.
+    void Flush();
+    // Main thread, once a frame.
+    void Update(LuaState* state);
+    // The Lua state is going, a batch in flight will be sent again.
+    void Reset();
+
+    unsigned int Outboxed() const { return mOutbox.size(); }
+private:
+    struct Open
+    {
+        std::string events;
+        unsigned int count;
+        unsigned long long opened;
+        Open() : count(0), opened(0) {}
+    };
+
+    struct Batch
+    {
+        std::string uri;
+        std::string events;
+    };
+
+    std::map<std::string, Open> mOpen; // by uri
+    std::deque<Batch> mOutbox;
+    unsigned int mWindowMs;
+    unsigned int mMaxEvents;
+    std::string mOutboxFile;
+    bool mLoaded;
+    bool mSending;
+    unsigned int mSendId; // matches replies to the batch in flight
+    unsigned int mBackoffMs;
+    unsigned long long mNextAttempt;
+
+    void Close(const std::string& uri);
+    void Load();
+    void Save();
+    void Send(LuaState* state);
+    void OnSent(unsigned int id, bool success);
+    static int lua_OnSuccess(lua_State* state);
+    static int lua_OnFailure(lua_State* state);
+};
+
+#endif
\ No newline at end of file
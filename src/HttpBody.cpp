@@ -0,0 +1,171 @@
+#include "HttpBody.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include "DDFile.h"
+
+HttpBody::HttpBody(const HttpBody& body)
+{
+    *this = body;
+}
+
+HttpBody& HttpBody::operator=(const HttpBody& body)
+{
+    if(this == &body)
+    {
+        return *this;
+    }
+
+    Clear();
+    mSegments = body.mSegments;
+    for(std::vector<Segment>::iterator it = mSegments.begin(); it != mSegments.end(); ++it)
+    {
+        // Copies open their own views.
+        it->file = NULL;
+        if(it->buffer)
+        {
+            it->buffer->AddRef();
+        }
+    }
+    return *this;
+}
+
+HttpBody::~HttpBody()
+{
+    Clear();
+}
+
+void HttpBody::Clear()
+{
+    Close();
+    for(std::vector<Segment>::iterator it = mSegments.begin(); it != mSegments.end(); ++it)
+    {
+        if(it->buffer)
+        {
+            it->buffer->Release();
+        }
+    }
+    mSegments.clear();
+}
+
+void HttpBody::AddText(const std::string& text)
+{
+    // Runs of text are one segment.
+    if(!mSegments.empty()
+       && mSegments.back().path.empty()
+       && mSegments.back().buffer == NULL)
+    {
+        mSegments.back().text += text;
+        return;
+    }
+
+    Segment segment;
+    segment.text = text;
+    segment.buffer = NULL;
+    segment.file = NULL;
+    mSegments.push_back(segment);
+}
+
+void HttpBody::AddFile(const std::string& path)
+{
+    Segment segment;
+    segment.path = path;
+    segment.buffer = NULL;
+    segment.file = NULL;
+    mSegments.push_back(segment);
+}
+
+void HttpBody::AddBuffer(SharedBuffer* buffer)
+{
+    assert(buffer);
+    buffer->AddRef();
+    Segment segment;
+    segment.buffer = buffer;
+    segment.file = NULL;
+    mSegments.push_back(segment);
+}
+
+bool HttpBody::Open(std::string* outMissing)
+{
+    for(std::vector<Segment>::iterator it = mSegments.begin(); it != mSegments.end(); ++it)
+    {
+        if(it->path.empty() || it->file)
+        {
+            continue;
+        }
+
+        it->file = new DDFile(it->path.c_str());
+        // An empty file has no buffer either, tell it apart by existing.
+        if(!it->file->LoadFileView() && !DDFile::FileExists(it->path.c_str()))
+        {
+            *outMissing = it->path;
+            Close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void HttpBody::Close()
+{
+    for(std::vector<Segment>::iterator it = mSegments.begin(); it != mSegments.end(); ++it)
+    {
+        delete it->file;
+        it->file = NULL;
+    }
+}
+
+unsigned long long HttpBody::Size() const
+{
+    unsigned long long size = 0;
+    for(std::vector<Segment>::const_iterator it = mSegments.begin(); it != mSegments.end(); ++it)
+    {
+        if(it->buffer)
+        {
+            size += it->buffer->Data().size();
+        }
+        else if(!it->path.empty())
+        {
+            assert(it->file); // not opened
+            size += it->file->Size();
+        }
+        else
+        {
+            size += it->text.size();
+        }
+    }
+    return size;
+}
+
+bool HttpBody::Write(WriteFunction write, void* context) const
+{
+    for(std::vector<Segment>::const_iterator it = mSegments.begin(); it != mSegments.end(); ++it)
+    {
+        const char* data = it->text.data();
+        unsigned int size = it->text.size();
+        if(it->buffer)
+        {
+            const std::vector<unsigned char>& bytes = it->buffer->Data();
+            data = bytes.empty() ? NULL : (const char*) &bytes[0];
+            size = bytes.size();
+        }
+        else if(!it->path.empty())
+        {
+            assert(it->file); // not opened
+            data = it->file->Buffer();
+            size = it->file->Size();
+        }
+
+        for(unsigned int sent = 0; sent < size;)
+        {
+            const unsigned int chunk = std::min(size - sent, (unsigned int) CHUNK_SIZE);
+            if(!write(context, data + sent, chunk))
+            {
+                return false;
+            }
+            sent += chunk;
+        }
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef HTTPBODY_H
+#define HTTPBODY_H
+
+#include <string>
+#include <vector>
+
+class DDFile;
+
+//
+// Bytes shared between a post and the requests made from it, so handing
+// a large buffer to the http thread doesn't copy it. Any thread may
+// Release, the last one deletes it.
+//
+class SharedBuffer
+{
+    volatile int mRefs;
+    std::vector<unsigned char> mData;
+    SharedBuffer() : mRefs(1) {}
+    SharedBuffer(const SharedBuffer&);
+    SharedBuffer& operator=(const SharedBuffer&);
+public:
+    static SharedBuffer* Create() { return new SharedBuffer(); }
+    void AddRef() { __sync_add_and_fetch(&mRefs, 1); }
+    void Release()
+    {
+        if(__sync_sub_and_fetch(&mRefs, 1) == 0)
+        {
+            delete this;
+        }
+    }
+    // Another holder may still be reading it. Only ever counts down while
+    // the caller holds it, so false stays false.
+    bool IsShared() const { return mRefs > 1; }
+    // Fill in before it's shared.
+    std::vector<unsigned char>& Data() { return mData; }
+    const std::vector<unsigned char>& Data() const { return mData; }
+};
+
+//
+// A request body in pieces: text, shared buffers and files. Files aren't
+// read until the body is opened on the thread sending it, and then they're
+// viewed through DDFile rather than copied, so big uploads never sit in
+// memory whole.
+//
+class HttpBody
+{
+public:
+    typedef bool (*WriteFunction)(void* context, const char* data, unsigned int size);
+private:
+    struct Segment
+    {
+        std::string text;
+        std::string path;
+        SharedBuffer* buffer;
+        DDFile* file; // while open
+    };
+    std::vector<Segment> mSegments;
+public:
+    static const unsigned int CHUNK_SIZE = 64 * 1024;
+
+    HttpBody() {}
+    HttpBody(const HttpBody& body);
+    HttpBody& operator=(const HttpBody& body);
+    ~HttpBody();
+
+    void AddText(const std::string& text);
+    void AddFile(const std::string& path);
+    void AddBuffer(SharedBuffer* buffer); // adds a reference
+
+    // Views the files. False if one couldn't be read, the path's in
+    // outMissing.
+    bool Open(std::string* outMissing);
+    void Close();
+    // Once open.
+    unsigned long long Size() const;
+    // Hands the body over in order, in pieces of up to CHUNK_SIZE. Stops
+    // and returns false if write does.
+    bool Write(WriteFunction write, void* context) const;
+private:
+    void Clear();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,771 @@
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "HttpClient.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zlib.h"
+
+#include "DDLog.h"
+#include "DDTime.h"
+
+#ifdef _WIN32
+#define CloseSocket closesocket
+#define SHUT_RDWR SD_BOTH
+#else
+#define CloseSocket close
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // SO_NOSIGPIPE covers it on the mac
+#endif
+
+static const int NO_SOCKET = -1;
+static const unsigned int READ_CHUNK = 16 * 1024;
+
+static bool ParseUri(const std::string& uri,
+                     std::string* host,
+                     int* port,
+                     std::string* path)
+{
+    static const std::string scheme("http://");
+    if(uri.compare(0, scheme.size(), scheme) != 0)
+    {
+        return false;
+    }
+
+    const size_t hostStart = scheme.size();
+    size_t pathStart = uri.find('/', hostStart);
+    if(pathStart == std::string::npos)
+    {
+        pathStart = uri.size();
+    }
+
+    std::string authority = uri.substr(hostStart, pathStart - hostStart);
+    *port = 80;
+    const size_t colon = authority.find(':');
+    if(colon != std::string::npos)
+    {
+        *port = atoi(authority.c_str() + colon + 1);
+        authority.erase(colon);
+    }
+
+    *host = authority;
+    *path = pathStart < uri.size() ? uri.substr(pathStart) : "/";
+    return !host->empty() && *port > 0;
+}
+
+static bool SendAll(int socket, const char* data, size_t size)
+{
+    size_t sent = 0;
+    while(sent < size)
+    {
+        int result = send(socket, data + sent, size - sent, MSG_NOSIGNAL);
+        if(result <= 0)
+        {
+            return false;
+        }
+        sent += result;
+    }
+    return true;
+}
+
+//
+// Gathers small writes, headers and form fields, into one send and passes
+// big ones straight through.
+//
+struct Sender
+{
+    int socket;
+    std::string staged;
+
+    bool Flush()
+    {
+        const bool sent = SendAll(socket, staged.data(), staged.size());
+        staged.clear();
+        return sent;
+    }
+
+    static bool Write(void* context, const char* data, unsigned int size)
+    {
+        Sender* sender = static_cast<Sender*>(context);
+        if(sender->staged.size() + size <= HttpBody::CHUNK_SIZE)
+        {
+            sender->staged.append(data, size);
+            return true;
+        }
+        return sender->Flush() && SendAll(sender->socket, data, size);
+    }
+};
+
+// False on an error or the server closing.
+static bool Receive(int socket, std::string* pending)
+{
+    char buffer[READ_CHUNK];
+    int result = recv(socket, buffer, sizeof(buffer), 0);
+    if(result <= 0)
+    {
+        return false;
+    }
+    pending->append(buffer, result);
+    return true;
+}
+
+static bool Gunzip(const std::string& in, std::string* out)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // 16 asks for the gzip header rather than raw zlib.
+    if(inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+    {
+        return false;
+    }
+
+    stream.next_in = (Bytef*) in.data();
+    stream.avail_in = in.size();
+
+    char buffer[READ_CHUNK];
+    int result = Z_OK;
+    out->clear();
+    while(result == Z_OK)
+    {
+        stream.next_out = (Bytef*) buffer;
+        stream.avail_out = sizeof(buffer);
+        result = inflate(&stream, Z_NO_FLUSH);
+        out->append(buffer, sizeof(buffer) - stream.avail_out);
+    }
+    inflateEnd(&stream);
+    return result == Z_STREAM_END;
+}
+
+static void StartSockets()
+{
+#ifdef _WIN32
+    static bool started = false;
+    if(!started)
+    {
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+        started = true;
+    }
+#endif
+}
+
+static std::string Lower(std::string value)
+{
+    for(size_t i = 0; i < value.size(); i++)
+    {
+        if(value[i] >= 'A' && value[i] <= 'Z')
+        {
+            value[i] = value[i] - 'A' + 'a';
+        }
+    }
+    return value;
+}
+
+HttpClient::HttpClient() :
+    mActiveSocket(NO_SOCKET),
+    mNextId(0),
+    mStarted(false),
+    mStopping(false)
+{
+}
+
+HttpClient::~HttpClient()
+{
+    if(mStarted)
+    {
+        mMutex.Lock();
+        mStopping = true;
+        mQueue.clear();
+        if(mActiveSocket != NO_SOCKET)
+        {
+            shutdown(mActiveSocket, SHUT_RDWR);
+        }
+        mWake.Broadcast();
+        mMutex.Unlock();
+        mThread.Join();
+    }
+
+    for(unsigned int i = 0; i < mIdle.size(); i++)
+    {
+        CloseSocket(mIdle[i]->socket);
+        delete mIdle[i];
+    }
+}
+
+unsigned int HttpClient::Post(const std::string& uri,
+                              const HttpBody& body,
+                              const std::string& contentType)
+{
+    ScopedLock lock(mMutex);
+    Request request;
+    request.id = mNextId++;
+    request.body = body;
+    request.contentType = contentType;
+    request.attempts = 0;
+
+    if(!ParseUri(uri, &request.host, &request.port, &request.path))
+    {
+        Response response;
+        response.id = request.id;
+        response.ok = false;
+        response.status = 0;
+        response.body = "Only http:// addresses are supported: " + uri;
+        mResponses.push_back(response);
+        return request.id;
+    }
+
+    if(!mStarted)
+    {
+        StartSockets();
+        mStarted = mThread.Start(&HttpClient::WorkerMain, this);
+        if(!mStarted)
+        {
+            dsprintf("Http thread failed to start.\n");
+        }
+    }
+
+    mQueue.push_back(request);
+    mWake.Signal();
+    return request.id;
+}
+
+bool HttpClient::PopResponse(Response* out)
+{
+    ScopedLock lock(mMutex);
+    if(mResponses.empty())
+    {
+        return false;
+    }
+    *out = mResponses.front();
+    mResponses.pop_front();
+    return true;
+}
+
+bool HttpClient::Get(const std::string& uri, const std::string& headers, Response* out)
+{
+    out->id = 0;
+    out->ok = false;
+    out->status = 0;
+    out->etag.clear();
+
+    std::string host;
+    int port = 0;
+    std::string path;
+    if(!ParseUri(uri, &host, &port, &path))
+    {
+        out->body = "Only http:// addresses are supported: " + uri;
+        return false;
+    }
+
+    StartSockets();
+    char hostLine[256];
+    snprintf(hostLine, sizeof(hostLine), "Host: %s:%d\r\n", host.c_str(), port);
+    const std::string request = "GET " + path + " HTTP/1.1\r\n"
+        + hostLine
+        + "Accept-Encoding: gzip\r\n"
+        + "Connection: keep-alive\r\n"
+        + "User-Agent: dinodeck\r\n"
+        + headers
+        + "\r\n";
+
+    // As Run, a kept connection the server dropped gets one more go.
+    for(unsigned int attempt = 0; attempt < 2; attempt++)
+    {
+        bool reused = false;
+        Connection* connection = Acquire(host, port, &reused);
+        if(connection == NULL)
+        {
+            out->body = "Couldn't connect to " + host;
+            return false;
+        }
+
+        bool keepAlive = false;
+        bool gotBytes = false;
+        if(SendAll(connection->socket, request.data(), request.size())
+           && ReadResponse(connection, out, &keepAlive, &gotBytes))
+        {
+            if(keepAlive)
+            {
+                Release(connection);
+            }
+            else
+            {
+                CloseSocket(connection->socket);
+                delete connection;
+            }
+            return true;
+        }
+
+        CloseSocket(connection->socket);
+        delete connection;
+        if(!reused || gotBytes)
+        {
+            break;
+        }
+    }
+
+    out->body = "No reply from " + host;
+    return false;
+}
+
+void HttpClient::Finish(const Response& response)
+{
+    ScopedLock lock(mMutex);
+    mResponses.push_back(response);
+}
+
+void HttpClient::Fail(const Request& request, const std::string& reason)
+{
+    Response response;
+    response.id = request.id;
+    response.ok = false;
+    response.status = 0;
+    response.body = reason;
+    Finish(response);
+}
+
+//
+// The oldest request and any others queued for the same host, in order.
+//
+bool HttpClient::TakeBatch(std::vector<Request>* out)
+{
+    ScopedLock lock(mMutex);
+    while(mQueue.empty() && !mStopping)
+    {
+        mWake.Wait(mMutex);
+    }
+
+    if(mStopping)
+    {
+        return false;
+    }
+
+    out->clear();
+    const Request& first = mQueue.front();
+    const std::string host = first.host;
+    const int port = first.port;
+    for(std::deque<Request>::iterator it = mQueue.begin();
+        it != mQueue.end() && out->size() < PIPELINE_DEPTH;)
+    {
+        if(it->host == host && it->port == port)
+        {
+            out->push_back(*it);
+            it = mQueue.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return true;
+}
+
+void HttpClient::WorkerMain(void* data)
+{
+    HttpClient* client = static_cast<HttpClient*>(data);
+    std::vector<Request> batch;
+    while(client->TakeBatch(&batch))
+    {
+        client->Run(batch);
+    }
+}
+
+HttpClient::Connection* HttpClient::Acquire(const std::string& host,
+                                            int port,
+                                            bool* outReused)
+{
+    char portString[16];
+    snprintf(portString, sizeof(portString), "%d", port);
+    const std::string key = host + ":" + portString;
+    const unsigned long long now = DDTime::Microseconds();
+
+    Connection* found = NULL;
+    for(unsigned int i = 0; i < mIdle.size();)
+    {
+        Connection* connection = mIdle[i];
+        if(now - connection->lastUsed > IDLE_SECONDS * 1000000ULL)
+        {
+            CloseSocket(connection->socket);
+            delete connection;
+            mIdle.erase(mIdle.begin() + i);
+            continue;
+        }
+
+        if(found == NULL && connection->key == key)
+        {
+            found = connection;
+            mIdle.erase(mIdle.begin() + i);
+            continue;
+        }
+        i++;
+    }
+
+    *outReused = found != NULL;
+    if(found)
+    {
+        return found;
+    }
+
+    hostent* entry = gethostbyname(host.c_str());
+    if(entry == NULL || entry->h_addrtype != AF_INET)
+    {
+        return NULL;
+    }
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((unsigned short) port);
+    memcpy(&address.sin_addr, entry->h_addr_list[0], entry->h_length);
+
+    int s = (int) socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if(s == NO_SOCKET)
+    {
+        return NULL;
+    }
+
+#ifdef _WIN32
+    DWORD timeout = TIMEOUT_SECONDS * 1000;
+#else
+    timeval timeout;
+    timeout.tv_sec = TIMEOUT_SECONDS;
+    timeout.tv_usec = 0;
+#endif
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char*) &timeout, sizeof(timeout));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, (const char*) &timeout, sizeof(timeout));
+    // Pipelined requests go out together, don't hold them back.
+    int on = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*) &on, sizeof(on));
+#ifdef SO_NOSIGPIPE
+    setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, (const char*) &on, sizeof(on));
+#endif
+
+    if(connect(s, (sockaddr*) &address, sizeof(address)) != 0)
+    {
+        CloseSocket(s);
+        return NULL;
+    }
+
+    Connection* connection = new Connection();
+    connection->key = key;
+    connection->socket = s;
+    connection->lastUsed = now;
+    return connection;
+}
+
+void HttpClient::Release(Connection* connection)
+{
+    connection->lastUsed = DDTime::Microseconds();
+    mIdle.push_back(connection);
+}
+
+void HttpClient::Run(std::vector<Request>& batch)
+{
+    assert(!batch.empty());
+    bool reused = false;
+    Connection* connection = Acquire(batch[0].host, batch[0].port, &reused);
+    if(connection == NULL)
+    {
+        for(unsigned int i = 0; i < batch.size(); i++)
+        {
+            Fail(batch[i], "Couldn't connect to " + batch[i].host);
+        }
+        return;
+    }
+
+    mMutex.Lock();
+    mActiveSocket = connection->socket;
+    mMutex.Unlock();
+
+    // Files are read as they go out. One that's gone fails its request. It
+    // isn't sent, so the batch is rebuilt without it.
+    for(unsigned int i = 0; i < batch.size();)
+    {
+        std::string missing;
+        if(!batch[i].body.Open(&missing))
+        {
+            Fail(batch[i], "Couldn't read " + missing);
+            batch.erase(batch.begin() + i);
+            continue;
+        }
+        i++;
+    }
+
+    if(batch.empty())
+    {
+        mMutex.Lock();
+        mActiveSocket = NO_SOCKET;
+        mMutex.Unlock();
+        Release(connection);
+        return;
+    }
+
+    Sender sender;
+    sender.socket = connection->socket;
+    bool sent = true;
+    for(unsigned int i = 0; i < batch.size() && sent; i++)
+    {
+        const Request& request = batch[i];
+        char header[512];
+        snprintf(header, sizeof(header),
+                 "POST %s HTTP/1.1\r\n"
+                 "Host: %s:%d\r\n"
+                 "Content-Type: %s\r\n"
+                 "Content-Length: %llu\r\n"
+                 "Accept-Encoding: gzip\r\n"
+                 "Connection: keep-alive\r\n"
+                 "User-Agent: dinodeck\r\n"
+                 "\r\n",
+                 request.path.c_str(),
+                 request.host.c_str(),
+                 request.port,
+                 request.contentType.c_str(),
+                 request.body.Size());
+        sent = Sender::Write(&sender, header, strlen(header))
+            && request.body.Write(&Sender::Write, &sender);
+    }
+    sent = sent && sender.Flush();
+
+    for(unsigned int i = 0; i < batch.size(); i++)
+    {
+        batch[i].body.Close();
+    }
+
+    bool keepAlive = sent;
+    unsigned int answered = 0;
+    bool gotBytes = false;
+    while(keepAlive && answered < batch.size())
+    {
+        gotBytes = false;
+        Response response;
+        response.id = batch[answered].id;
+        if(!ReadResponse(connection, &response, &keepAlive, &gotBytes))
+        {
+            break;
+        }
+        Finish(response);
+        answered++;
+    }
+
+    mMutex.Lock();
+    mActiveSocket = NO_SOCKET;
+    const bool stopping = mStopping;
+    mMutex.Unlock();
+
+    if(keepAlive && answered == batch.size())
+    {
+        Release(connection);
+        return;
+    }
+
+    CloseSocket(connection->socket);
+    delete connection;
+
+    if(stopping)
+    {
+        return;
+    }
+
+    // Whatever the server didn't answer goes again or fails. A request
+    // the server closed on without replying to is safe to send again.
+    const bool retry = (reused || answered > 0) && !gotBytes;
+    ScopedLock lock(mMutex);
+    for(unsigned int i = batch.size(); i > answered; i--)
+    {
+        Request& request = batch[i - 1];
+        if(retry && request.attempts == 0)
+        {
+            request.attempts++;
+            mQueue.push_front(request);
+        }
+        else
+        {
+            Response response;
+            response.id = request.id;
+            response.ok = false;
+            response.status = 0;
+            response.body = "No reply from " + request.host;
+            mResponses.push_back(response);
+        }
+    }
+}
+
+//
+// Reads one reply off the connection. outGotBytes is set once any part of
+// a reply has come in.
+//
+bool HttpClient::ReadResponse(Connection* connection,
+                              Response* out,
+                              bool* outKeepAlive,
+                              bool* outGotBytes)
+{
+    std::string& pending = connection->pending;
+    size_t headerEnd = std::string::npos;
+    while((headerEnd = pending.find("\r\n\r\n")) == std::string::npos)
+    {
+        if(!Receive(connection->socket, &pending))
+        {
+            return false;
+        }
+        *outGotBytes = true;
+    }
+    *outGotBytes = true;
+
+    const std::string header = pending.substr(0, headerEnd);
+    pending.erase(0, headerEnd + 4);
+
+    int major = 1, minor = 0;
+    out->status = 0;
+    if(sscanf(header.c_str(), "HTTP/%d.%d %d", &major, &minor, &out->status) != 3)
+    {
+        return false;
+    }
+
+    long contentLength = -1;
+    bool chunked = false;
+    bool gzipped = false;
+    out->etag.clear();
+    *outKeepAlive = major > 1 || (major == 1 && minor >= 1);
+
+    size_t lineStart = header.find("\r\n");
+    while(lineStart != std::string::npos)
+    {
+        lineStart += 2;
+        size_t lineEnd = header.find("\r\n", lineStart);
+        const std::string line = header.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd;
+
+        const size_t colon = line.find(':');
+        if(colon == std::string::npos)
+        {
+            continue;
+        }
+        const std::string name = Lower(line.substr(0, colon));
+        size_t valueStart = line.find_first_not_of(' ', colon + 1);
+        const std::string value = valueStart == std::string::npos
+            ? std::string()
+            : Lower(line.substr(valueStart));
+
+        if(name == "content-length")
+        {
+            contentLength = atol(value.c_str());
+        }
+        else if(name == "transfer-encoding")
+        {
+            chunked = value.find("chunked") != std::string::npos;
+        }
+        else if(name == "content-encoding")
+        {
+            gzipped = value.find("gzip") != std::string::npos;
+        }
+        else if(name == "connection")
+        {
+            *outKeepAlive = value.find("close") == std::string::npos;
+        }
+        else if(name == "etag" && valueStart != std::string::npos)
+        {
+            out->etag = line.substr(valueStart);
+        }
+    }
+
+    // Whatever the headers say, these never have a body.
+    if(out->status == 204 || out->status == 304)
+    {
+        chunked = false;
+        contentLength = 0;
+    }
+
+    std::string body;
+    if(chunked)
+    {
+        for(;;)
+        {
+            size_t sizeEnd;
+            while((sizeEnd = pending.find("\r\n")) == std::string::npos)
+            {
+                if(!Receive(connection->socket, &pending))
+                {
+                    return false;
+                }
+            }
+            const unsigned long size = strtoul(pending.c_str(), NULL, 16);
+            pending.erase(0, sizeEnd + 2);
+
+            if(size == 0)
+            {
+                // Skip any trailers up to the blank line.
+                size_t trailerEnd;
+                while((trailerEnd = pending.find("\r\n")) != 0)
+                {
+                    if(trailerEnd != std::string::npos)
+                    {
+                        pending.erase(0, trailerEnd + 2);
+                    }
+                    else if(!Receive(connection->socket, &pending))
+                    {
+                        return false;
+                    }
+                }
+                pending.erase(0, 2);
+                break;
+            }
+
+            while(pending.size() < size + 2)
+            {
+                if(!Receive(connection->socket, &pending))
+                {
+                    return false;
+                }
+            }
+            body.append(pending, 0, size);
+            pending.erase(0, size + 2);
+        }
+    }
+    else if(contentLength >= 0)
+    {
+        while(pending.size() < (size_t) contentLength)
+        {
+            if(!Receive(connection->socket, &pending))
+            {
+                return false;
+            }
+        }
+        body = pending.substr(0, contentLength);
+        pending.erase(0, contentLength);
+    }
+    else
+    {
+        // The body runs until the server closes.
+        while(Receive(connection->socket, &pending)) {}
+        body.swap(pending);
+        *outKeepAlive = false;
+    }
+
+    if(gzipped && !Gunzip(body, &out->body))
+    {
+        out->ok = false;
+        out->body = "Couldn't decompress the reply";
+        return true;
+    }
+    else if(!gzipped)
+    {
+        out->body.swap(body);
+    }
+
+    out->ok = out->status >= 200 && out->status < 300;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef HTTPCLIENT_H
+#define HTTPCLIENT_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "HttpBody.h"
+#include "Threading.h"
+
+//
+// Posts from a background thread so a slow server never holds up a frame.
+//
+// Connections are kept alive and reused for the same host, and up to
+// PIPELINE_DEPTH requests are written before their responses are read.
+// A request that fails on a reused connection before any reply comes back
+// is retried once on a new one, the server may have dropped it while idle.
+// Responses can be gzipped. Bodies are streamed to the socket from the
+// files and buffers they're made of, see HttpBody.
+//
+// Plain http only, there's no TLS library in the build.
+//
+class HttpClient
+{
+public:
+    static const unsigned int PIPELINE_DEPTH = 4;
+    static const unsigned int IDLE_SECONDS = 30;    // before a kept connection is closed
+    static const unsigned int TIMEOUT_SECONDS = 15; // for any one read or write
+
+    struct Response
+    {
+        unsigned int id;
+        bool ok;        // a 2xx reply
+        int status;     // 0 if no reply came back
+        std::string body; // or what went wrong
+        std::string etag; // as the server sent it, quotes and all
+    };
+
+    HttpClient();
+    ~HttpClient(); // abandons anything still queued
+
+    // Any thread. The response comes back under the returned id.
+    unsigned int Post(const std::string& uri,
+                      const HttpBody& body,
+                      const std::string& contentType);
+    // False when nothing's finished.
+    bool PopResponse(Response* out);
+    // Blocks on the calling thread, on its own kept connection. headers
+    // are extra lines, each ending in \r\n. False if no reply came back.
+    // Don't mix with Post on the same client or call from two threads.
+    bool Get(const std::string& uri, const std::string& headers, Response* out);
+private:
+    struct Request
+    {
+        unsigned int id;
+        std::string host;
+        int port;
+        std::string path;
+        HttpBody body;
+        std::string contentType;
+        unsigned int attempts;
+    };
+
+    struct Connection
+    {
+        std::string key; // host:port
+        int socket;
+        unsigned long long lastUsed;
+        std::string pending; // read but not yet parsed
+    };
+
+    Mutex mMutex;
+    Condition mWake;
+    std::deque<Request> mQueue;
+    std::deque<Response> mResponses;
+    std::vector<Connection*> mIdle; // worker thread only
+    int mActiveSocket; // shut down to stop the worker mid read
+    unsigned int mNextId;
+    bool mStarted;
+    bool mStopping;
+    Thread mThread;
+
+    static void WorkerMain(void* client);
+    void Run(std::vector<Request>& batch);
+    bool TakeBatch(std::vector<Request>* out);
+    Connection* Acquire(const std::string& host, int port, bool* outReused);
+    void Release(Connection* connection);
+    void Fail(const Request& request, const std::string& reason);
+    void Finish(const Response& response);
+    bool ReadResponse(Connection* connection,
+                      Response* out,
+                      bool* outKeepAlive,
+                      bool* outGotBytes);
+
+    HttpClient(const HttpClient&);
+    HttpClient& operator=(const HttpClient&);
+};
+
+#endif
\ No newline at end of file
@@ -1,13 +1,21 @@
 #include "HttpPostData.h"
 
+#include <algorithm>
 #include <map>
+#include <stdio.h>
 #include <string>
 
+#include "ByteBuffer.h"
 #include "DinodeckLua.h"
+#include "DDTime.h"
+#include "HttpBody.h"
 #include "LuaState.h"
 #include "reflect/Reflect.h"
+#include "RenderTarget.h"
 #include "DDLog.h"
 
+static const unsigned int TGA_HEADER_SIZE = 18;
+
 Reflect HttpPostData::Meta("HttpPostData", HttpPostData::Bind);
 
 int lua_HttpPostData_Create(lua_State* state)
@@ -72,38 +80,189 @@ int lua_HttpPostData_AddValue(lua_State* state)
 }
 
 
+// post:AddFile(key, path, [mimeType])
+// The file's read as the post is sent, not now.
+int lua_HttpPostData_AddFile(lua_State* state)
+{
+    HttpPostData* httpPostData = LuaState::GetFuncParam<HttpPostData>(state, 1);
+    if(NULL == httpPostData)
+    {
+        return 0;
+    }
+
+    const char* key = luaL_checkstring(state, 2);
+    const char* path = luaL_checkstring(state, 3);
+    const char* mimeType = luaL_optstring(state, 4, "application/octet-stream");
+    httpPostData->AddFile(key, path, mimeType);
+    return 0;
+}
+
+// post:AddRenderTarget(key, target, [filename])
+// Reads the target back now and attaches it as a TGA image.
+int lua_HttpPostData_AddRenderTarget(lua_State* state)
+{
+    HttpPostData* httpPostData = LuaState::GetFuncParam<HttpPostData>(state, 1);
+    if(NULL == httpPostData)
+    {
+        return 0;
+    }
+
+    const char* key = luaL_checkstring(state, 2);
+    RenderTarget* target = LuaState::GetFuncParam<RenderTarget>(state, 3);
+    if(NULL == target)
+    {
+        return luaL_typerror(state, 3, "RenderTarget");
+    }
+    const char* filename = luaL_optstring(state, 4, "capture.tga");
+
+    const int width = target->GetWidth();
+    const int height = target->GetHeight();
+    SharedBuffer* buffer = SharedBuffer::Create();
+    std::vector<unsigned char>& data = buffer->Data();
+    data.resize(TGA_HEADER_SIZE + width * height * 4);
+
+    // Uncompressed 32 bit with the origin bottom left, as GL reads it.
+    unsigned char* header = &data[0];
+    header[2] = 2;
+    header[12] = width & 0xFF;
+    header[13] = (width >> 8) & 0xFF;
+    header[14] = height & 0xFF;
+    header[15] = (height >> 8) & 0xFF;
+    header[16] = 32;
+    header[17] = 8;
+
+    unsigned char* pixels = &data[TGA_HEADER_SIZE];
+    target->ReadPixels(pixels);
+    for(int i = 0; i < width * height; i++)
+    {
+        // RGBA to TGA's BGRA.
+        std::swap(pixels[i * 4], pixels[i * 4 + 2]);
+    }
+
+    httpPostData->AddBuffer(key, filename, "image/x-tga", buffer);
+    buffer->Release();
+    return 0;
+}
+
+// post:AddBuffer(key, buffer, [filename], [mimeType])
+// Sends the ByteBuffer's bytes as they are now, without copying them.
+int lua_HttpPostData_AddBuffer(lua_State* state)
+{
+    HttpPostData* httpPostData = LuaState::GetFuncParam<HttpPostData>(state, 1);
+    if(NULL == httpPostData)
+    {
+        return 0;
+    }
+
+    const char* key = luaL_checkstring(state, 2);
+    ByteBuffer* buffer = LuaState::GetFuncParam<ByteBuffer>(state, 3);
+    if(NULL == buffer)
+    {
+        return 0;
+    }
+    const char* filename = luaL_optstring(state, 4, "data.bin");
+    const char* mimeType = luaL_optstring(state, 5, "application/octet-stream");
+
+    SharedBuffer* shared = buffer->Share();
+    httpPostData->AddBuffer(key, filename, mimeType, shared);
+    shared->Release();
+    return 0;
+}
+
 static const struct luaL_reg luaBinding [] = {
   {"Create", lua_HttpPostData_Create},
   {"__gc", lua_HttpPostData_gc},
   {"AddValue", lua_HttpPostData_AddValue},
+  {"AddFile", lua_HttpPostData_AddFile},
+  {"AddRenderTarget", lua_HttpPostData_AddRenderTarget},
+  {"AddBuffer", lua_HttpPostData_AddBuffer},
   {NULL, NULL}  /* sentinel */
 };
 
-HttpPostData::HttpPostData(ContentType contentType)
+HttpPostData::HttpPostData(ContentType contentType) :
+    mContentType(contentType)
+{
+}
+
+HttpPostData::HttpPostData(const HttpPostData& httpPostData) :
+    mContentType(Application)
 {
+    *this = httpPostData;
 }
 
-HttpPostData::HttpPostData(const HttpPostData& httpPostData)
+HttpPostData::HttpPostData() :
+    mContentType(Application)
+{
+}
+
+HttpPostData::~HttpPostData()
 {
-    for(std::map<std::string, std::string>::const_iterator it = httpPostData.mValueMap.begin(); it != httpPostData.mValueMap.end(); ++it)
+    ReleaseParts();
+}
+
+HttpPostData& HttpPostData::operator=(const HttpPostData& httpPostData)
+{
+    if(this == &httpPostData)
     {
-        mValueMap.insert
-        (
-            std::pair<std::string, std::string>
-            (
-                it->first,
-                it->second
-            )
-        );
+        return *this;
+    }
+
+    ReleaseParts();
+    mValueMap = httpPostData.mValueMap;
+    mContentType = httpPostData.mContentType;
+    mParts = httpPostData.mParts;
+    for(std::vector<Part>::iterator it = mParts.begin(); it != mParts.end(); ++it)
+    {
+        if(it->buffer)
+        {
+            it->buffer->AddRef();
+        }
+    }
+    return *this;
+}
+
+void HttpPostData::ReleaseParts()
+{
+    for(std::vector<Part>::iterator it = mParts.begin(); it != mParts.end(); ++it)
+    {
+        if(it->buffer)
+        {
+            it->buffer->Release();
+        }
     }
+    mParts.clear();
 }
 
-HttpPostData::HttpPostData()
+void HttpPostData::AddFile(const char* key, const char* path, const char* mimeType)
 {
+    Part part;
+    part.key = key;
+    part.path = path;
+    part.mimeType = mimeType;
+    part.buffer = NULL;
+
+    // Just the name, servers don't want the directories.
+    part.filename = path;
+    const size_t slash = part.filename.find_last_of("/\\");
+    if(slash != std::string::npos)
+    {
+        part.filename.erase(0, slash + 1);
+    }
+    mParts.push_back(part);
 }
 
-HttpPostData::~HttpPostData()
+void HttpPostData::AddBuffer(const char* key,
+                             const char* filename,
+                             const char* mimeType,
+                             SharedBuffer* buffer)
 {
+    buffer->AddRef();
+    Part part;
+    part.key = key;
+    part.filename = filename;
+    part.mimeType = mimeType;
+    part.buffer = buffer;
+    mParts.push_back(part);
 }
 
 bool HttpPostData::AddValue(const char* key, const char* value)
@@ -119,6 +278,90 @@ bool HttpPostData::AddValue(const char* key, const char* value)
     return true;
 }
 
+static std::string UrlEncode(const std::string& value)
+{
+    static const char* hex = "0123456789ABCDEF";
+    std::string out;
+    for(size_t i = 0; i < value.size(); i++)
+    {
+        const unsigned char c = (unsigned char) value[i];
+        if((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+           || c == '-' || c == '_' || c == '.' || c == '~')
+        {
+            out.push_back(c);
+        }
+        else if(c == ' ')
+        {
+            out.push_back('+');
+        }
+        else
+        {
+            out.push_back('%');
+            out.push_back(hex[c >> 4]);
+            out.push_back(hex[c & 15]);
+        }
+    }
+    return out;
+}
+
+std::string HttpPostData::Encode() const
+{
+    std::string out;
+    for(std::map<std::string, std::string>::const_iterator it = mValueMap.begin();
+        it != mValueMap.end(); ++it)
+    {
+        if(!out.empty())
+        {
+            out.push_back('&');
+        }
+        out += UrlEncode(it->first) + "=" + UrlEncode(it->second);
+    }
+    return out;
+}
+
+void HttpPostData::GetBody(HttpBody* out, std::string* outContentType) const
+{
+    if(!IsMultipart())
+    {
+        out->AddText(Encode());
+        *outContentType = "application/x-www-form-urlencoded";
+        return;
+    }
+
+    char boundary[48];
+    snprintf(boundary, sizeof(boundary), "dinodeck-%llx", DDTime::Microseconds());
+    const std::string dashes = std::string("--") + boundary;
+    *outContentType = std::string("multipart/form-data; boundary=") + boundary;
+
+    for(std::map<std::string, std::string>::const_iterator it = mValueMap.begin();
+        it != mValueMap.end(); ++it)
+    {
+        out->AddText(dashes + "\r\n"
+                     "Content-Disposition: form-data; name=\"" + it->first + "\"\r\n"
+                     "\r\n"
+                     + it->second + "\r\n");
+    }
+
+    for(std::vector<Part>::const_iterator it = mParts.begin(); it != mParts.end(); ++it)
+    {
+        out->AddText(dashes + "\r\n"
+                     "Content-Disposition: form-data; name=\"" + it->key
+                     + "\"; filename=\"" + it->filename + "\"\r\n"
+                     "Content-Type: " + it->mimeType + "\r\n"
+                     "\r\n");
+        if(it->buffer)
+        {
+            out->AddBuffer(it->buffer);
+        }
+        else
+        {
+            out->AddFile(it->path);
+        }
+        out->AddText("\r\n");
+    }
+    out->AddText(dashes + "--\r\n");
+}
+
 void HttpPostData::Bind(LuaState* state)
 {
     state->Bind
@@ -3,10 +3,13 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include "reflect/Reflect.h"
 
+class HttpBody;
 class LuaState;
+class SharedBuffer;
 
 class HttpPostData
 {
@@ -14,6 +17,17 @@ class HttpPostData
     public: static Reflect Meta;
     std::map<std::string, std::string> mValueMap;
     public:
+        // File and buffer parts, sent as multipart/form-data without being
+        // copied into the post.
+        struct Part
+        {
+            std::string key;
+            std::string filename;
+            std::string mimeType;
+            std::string path;       // streamed from the file when it's sent
+            SharedBuffer* buffer;   // or sent from this
+        };
+
         enum ContentType
         {
             //http://www.brandonchecketts.com/archives/array-versus-string-in-curlopt_postfields
@@ -26,8 +40,25 @@ class HttpPostData
         HttpPostData(const HttpPostData& httpPostData);
         HttpPostData();
         ~HttpPostData();
+        HttpPostData& operator=(const HttpPostData& httpPostData);
         bool AddValue(const char* key, const char* value);
         const std::map<std::string, std::string>& GetValues() const { return mValueMap; };
+        void AddFile(const char* key, const char* path, const char* mimeType);
+        // Adds a reference to the buffer.
+        void AddBuffer(const char* key,
+                       const char* filename,
+                       const char* mimeType,
+                       SharedBuffer* buffer);
+        const std::vector<Part>& GetParts() const { return mParts; }
+        bool IsMultipart() const { return mContentType == Multipart || !mParts.empty(); }
+        // As application/x-www-form-urlencoded, key=value&key=value
+        std::string Encode() const;
+        // The whole body and its content type, multipart if IsMultipart.
+        void GetBody(HttpBody* out, std::string* outContentType) const;
+    private:
+        ContentType mContentType;
+        std::vector<Part> mParts;
+        void ReleaseParts();
 };
 
 #endif
\ No newline at end of file
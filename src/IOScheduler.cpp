@@ -0,0 +1,96 @@
+#include "IOScheduler.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include "DDPack.h"
+
+bool IOScheduler::ReadsEarlier(const Read& a, const Read& b)
+{
+    if(a.packed != b.packed)
+    {
+        return a.packed;
+    }
+    if(!a.packed)
+    {
+        return false; // stable, as added
+    }
+    if(a.pack != b.pack)
+    {
+        return a.pack < b.pack;
+    }
+    return a.offset < b.offset;
+}
+
+void IOScheduler::Add(const char* path)
+{
+    assert(path);
+    Read read;
+    read.index = mReads.size();
+    read.pack = 0;
+    read.offset = 0;
+    read.size = 0;
+    read.run = 0;
+    read.packed = DDPack::Locate(path, &read.pack, &read.offset, &read.size);
+    mReads.push_back(read);
+}
+
+void IOScheduler::Plan()
+{
+    std::stable_sort(mReads.begin(), mReads.end(), ReadsEarlier);
+    mRuns.clear();
+    mPrefetched = 0;
+
+    const unsigned int gap = RUN_GAP;
+    const unsigned int maxRun = MAX_RUN_BYTES;
+    for(std::vector<Read>::iterator it = mReads.begin(); it != mReads.end(); ++it)
+    {
+        if(!it->packed)
+        {
+            break; // the rest aren't either
+        }
+
+        if(!mRuns.empty())
+        {
+            Run& last = mRuns.back();
+            const unsigned int end = last.offset + last.size;
+            if(last.pack == it->pack
+               && it->offset <= end + gap
+               && it->offset + it->size - last.offset <= maxRun)
+            {
+                if(it->offset + it->size > end)
+                {
+                    last.size = it->offset + it->size - last.offset;
+                }
+                it->run = mRuns.size() - 1;
+                continue;
+            }
+        }
+
+        Run run;
+        run.pack = it->pack;
+        run.offset = it->offset;
+        run.size = it->size;
+        it->run = mRuns.size();
+        mRuns.push_back(run);
+    }
+}
+
+unsigned int IOScheduler::Next(unsigned int position)
+{
+    assert(position < mReads.size());
+    const Read& read = mReads[position];
+
+    if(read.packed)
+    {
+        const unsigned int ahead = RUNS_AHEAD;
+        const unsigned int wanted = std::min((unsigned int) mRuns.size(),
+                                             read.run + 1 + ahead);
+        for(; mPrefetched < wanted; mPrefetched++)
+        {
+            const Run& run = mRuns[mPrefetched];
+            DDPack::Prefetch(run.pack, run.offset, run.size);
+        }
+    }
+    return read.index;
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef IOSCHEDULER_H
+#define IOSCHEDULER_H
+
+#include <vector>
+
+//
+// Orders a batch of file reads by where they're stored in the mounted
+// packs. A reload then walks each pack front to back, instead of seeking
+// around it in manifest name order. Entries close together are coalesced
+// into runs. The OS is asked to read the next few runs in while the
+// current one is being loaded.
+//
+// Files that aren't in a pack keep the order they were added in, after
+// the packed ones.
+//
+class IOScheduler
+{
+public:
+    // Entries this close are read as one run, the gap read through.
+    static const unsigned int RUN_GAP = 64 * 1024;
+    static const unsigned int MAX_RUN_BYTES = 8 * 1024 * 1024;
+    // Runs prefetched ahead of the one being read.
+    static const unsigned int RUNS_AHEAD = 4;
+private:
+    struct Read
+    {
+        unsigned int index; // in the order added
+        bool packed;
+        unsigned int pack;
+        unsigned int offset;
+        unsigned int size;
+        unsigned int run;
+    };
+    struct Run
+    {
+        unsigned int pack;
+        unsigned int offset;
+        unsigned int size;
+    };
+    std::vector<Read> mReads;
+    std::vector<Run> mRuns;
+    unsigned int mPrefetched; // runs asked for so far
+    static bool ReadsEarlier(const Read& a, const Read& b);
+public:
+    IOScheduler() : mPrefetched(0) {}
+
+    void Add(const char* path);
+    // Call once everything's added, before Next.
+    void Plan();
+    unsigned int Count() const { return mReads.size(); }
+    unsigned int Runs() const { return mRuns.size(); }
+    // The Add index of the read to do position'th. Keeps the runs after
+    // it coming in.
+    unsigned int Next(unsigned int position);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef IRELOADPROGRESS_H
+#define IRELOADPROGRESS_H
+
+class IReloadProgress
+{
+public:
+    // Called as each asset in a reload is loaded.
+    virtual void OnReloadProgress(unsigned int done, unsigned int total) = 0;
+    virtual ~IReloadProgress() {};
+};
+
+#endif
\ No newline at end of file
@@ -5,6 +5,8 @@ class IScreenChangeListener
 {
 public:
     virtual void OnChange(int width, int height) = 0;
+    // Shows what's been drawn to the window, outside the frame loop.
+    virtual void OnPresent() {}
     virtual ~IScreenChangeListener() {};
 };
 
@@ -0,0 +1,187 @@
+#include "ImageDecoder.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "soil.h"
+
+static const unsigned int QOI_HEADER_SIZE = 14;
+static const unsigned int QOI_END_SIZE = 8;
+// Larger is more likely a broken header than an image.
+static const unsigned int QOI_MAX_PIXELS = 400000000;
+
+enum eQoiOp
+{
+    QOI_OP_INDEX = 0x00,
+    QOI_OP_DIFF = 0x40,
+    QOI_OP_LUMA = 0x80,
+    QOI_OP_RUN = 0xc0,
+    QOI_OP_RGB = 0xfe,
+    QOI_OP_RGBA = 0xff,
+    QOI_MASK = 0xc0
+};
+
+static unsigned int ReadBigEndian(const unsigned char* data)
+{
+    return (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
+
+unsigned char* ImageDecoder::Decode(const unsigned char* file,
+                                    unsigned int size,
+                                    int* width,
+                                    int* height,
+                                    int* channels,
+                                    int forceChannels)
+{
+    assert(file);
+    if(IsQoi(file, size))
+    {
+        return DecodeQoi(file, size, width, height, channels, forceChannels);
+    }
+    return SOIL_load_image_from_memory(file, size, width, height, channels, forceChannels);
+}
+
+bool ImageDecoder::IsQoi(const unsigned char* file, unsigned int size)
+{
+    return size >= QOI_HEADER_SIZE + QOI_END_SIZE && memcmp(file, "qoif", 4) == 0;
+}
+
+bool ImageDecoder::PeekQoiSize(const unsigned char* file, unsigned int size, int* width, int* height)
+{
+    if(!IsQoi(file, size))
+    {
+        return false;
+    }
+    *width = (int) ReadBigEndian(file + 4);
+    *height = (int) ReadBigEndian(file + 8);
+    return true;
+}
+
+//
+// The format is at qoiformat.org. Pixels are written out as they're
+// decoded, converted to the channels asked for on the way.
+//
+unsigned char* ImageDecoder::DecodeQoi(const unsigned char* file,
+                                       unsigned int size,
+                                       int* width,
+                                       int* height,
+                                       int* channels,
+                                       int forceChannels)
+{
+    const unsigned int w = ReadBigEndian(file + 4);
+    const unsigned int h = ReadBigEndian(file + 8);
+    const int fileChannels = file[12];
+    if(w == 0 || h == 0
+       || w > QOI_MAX_PIXELS / h
+       || (fileChannels != 3 && fileChannels != 4)
+       || forceChannels < 0 || forceChannels > 4)
+    {
+        return NULL;
+    }
+
+    const int outChannels = forceChannels ? forceChannels : fileChannels;
+    const unsigned int pixels = w * h;
+    unsigned char* out = (unsigned char*) malloc((size_t) pixels * outChannels);
+    if(out == NULL)
+    {
+        return NULL;
+    }
+
+    unsigned char index[64][4];
+    memset(index, 0, sizeof(index));
+    unsigned char px[4] = { 0, 0, 0, 255 };
+
+    // An op reads at most four bytes past its first, the end marker keeps
+    // that inside the file.
+    const unsigned int end = size - QOI_END_SIZE;
+    unsigned int p = QOI_HEADER_SIZE;
+    unsigned int run = 0;
+    unsigned char* dest = out;
+    for(unsigned int i = 0; i < pixels; i++)
+    {
+        if(run > 0)
+        {
+            run--;
+        }
+        else if(p < end)
+        {
+            const unsigned char op = file[p++];
+            if(op == QOI_OP_RGB)
+            {
+                px[0] = file[p];
+                px[1] = file[p + 1];
+                px[2] = file[p + 2];
+                p += 3;
+            }
+            else if(op == QOI_OP_RGBA)
+            {
+                memcpy(px, file + p, 4);
+                p += 4;
+            }
+            else if((op & QOI_MASK) == QOI_OP_INDEX)
+            {
+                memcpy(px, index[op], 4);
+            }
+            else if((op & QOI_MASK) == QOI_OP_DIFF)
+            {
+                px[0] += ((op >> 4) & 0x03) - 2;
+                px[1] += ((op >> 2) & 0x03) - 2;
+                px[2] += (op & 0x03) - 2;
+            }
+            else if((op & QOI_MASK) == QOI_OP_LUMA)
+            {
+                const unsigned char next = file[p++];
+                const int green = (op & 0x3f) - 32;
+                px[0] += green - 8 + ((next >> 4) & 0x0f);
+                px[1] += green;
+                px[2] += green - 8 + (next & 0x0f);
+            }
+            else
+            {
+                run = op & 0x3f; // QOI_OP_RUN, this pixel and run more
+            }
+            memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64], px, 4);
+        }
+        else
+        {
+            break;
+        }
+
+        if(outChannels >= 3)
+        {
+            dest[0] = px[0];
+            dest[1] = px[1];
+            dest[2] = px[2];
+            if(outChannels == 4)
+            {
+                dest[3] = px[3];
+            }
+        }
+        else
+        {
+            // The same weights as SOIL's luminance.
+            dest[0] = (unsigned char)((px[0] * 77 + px[1] * 150 + px[2] * 29) >> 8);
+            if(outChannels == 2)
+            {
+                dest[1] = px[3];
+            }
+        }
+        dest += outChannels;
+    }
+
+    if(dest != out + (size_t) pixels * outChannels)
+    {
+        // Truncated.
+        free(out);
+        return NULL;
+    }
+
+    *width = (int) w;
+    *height = (int) h;
+    if(channels)
+    {
+        *channels = fileChannels;
+    }
+    return out;
+}
\ No newline at end of file
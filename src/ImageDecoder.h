@@ -0,0 +1,35 @@
+#ifndef IMAGEDECODER_H
+#define IMAGEDECODER_H
+
+//
+// Decodes image files to 8 bit pixels. QOI files are decoded here, in a
+// single pass several times quicker than a PNG's inflate and unfilter,
+// everything else goes to SOIL. Safe on any thread.
+// Point a texture's manifest path at a .qoi file to use it.
+//
+class ImageDecoder
+{
+public:
+    // Pixels are malloc'ed as SOIL's are, free either with
+    // SOIL_free_image_data. forceChannels is 0 to keep the file's or 1 to 4.
+    // NULL on failure.
+    static unsigned char* Decode(const unsigned char* file,
+                                 unsigned int size,
+                                 int* width,
+                                 int* height,
+                                 int* channels,
+                                 int forceChannels);
+
+    static bool IsQoi(const unsigned char* file, unsigned int size);
+    // Width and height from a QOI header, without decoding it.
+    static bool PeekQoiSize(const unsigned char* file, unsigned int size, int* width, int* height);
+private:
+    static unsigned char* DecodeQoi(const unsigned char* file,
+                                    unsigned int size,
+                                    int* width,
+                                    int* height,
+                                    int* channels,
+                                    int forceChannels);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,264 @@
+#include "InputRecord.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "DDLog.h"
+#include "Game.h"
+#include "input/Keyboard.h"
+#include "input/Mouse.h"
+
+static const char MAGIC[4] = { 'D', 'D', 'I', 'R' };
+
+InputRecord::InputRecord() :
+    mMode(MODE_NONE),
+    mFile(NULL),
+    mFrame(0),
+    mEvents(),
+    mEventCount(0),
+    mMouseX(0),
+    mMouseY(0),
+    mMouseButtons(0)
+{
+}
+
+bool InputRecord::StartRecording(const char* path)
+{
+    assert(path);
+    Stop();
+    mFile = fopen(path, "wb");
+
+    if(!mFile)
+    {
+        dsprintf("Couldn't open [%s] to record input.\n", path);
+        return false;
+    }
+
+    unsigned int version = VERSION;
+    fwrite(MAGIC, sizeof(MAGIC), 1, mFile);
+    fwrite(&version, sizeof(version), 1, mFile);
+    mMode = MODE_RECORD;
+    mFrame = 0;
+    ClearFrame();
+    dsprintf("Recording input to [%s].\n", path);
+    return true;
+}
+
+bool InputRecord::StartReplay(const char* path)
+{
+    assert(path);
+    Stop();
+    mFile = fopen(path, "rb");
+
+    if(!mFile)
+    {
+        dsprintf("Couldn't open input recording [%s].\n", path);
+        return false;
+    }
+
+    char magic[4];
+    unsigned int version = 0;
+    if(fread(magic, sizeof(magic), 1, mFile) != 1
+       || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0
+       || fread(&version, sizeof(version), 1, mFile) != 1
+       || version != VERSION)
+    {
+        dsprintf("[%s] isn't a version %u input recording.\n", path, VERSION);
+        fclose(mFile);
+        mFile = NULL;
+        return false;
+    }
+
+    mMode = MODE_REPLAY;
+    mFrame = 0;
+    dsprintf("Replaying input from [%s].\n", path);
+    return true;
+}
+
+void InputRecord::Stop()
+{
+    if(mFile)
+    {
+        fclose(mFile);
+        mFile = NULL;
+
+        if(mMode == MODE_RECORD)
+        {
+            dsprintf("Recorded %u frames of input.\n", mFrame);
+        }
+    }
+    mMode = MODE_NONE;
+}
+
+void InputRecord::ClearFrame()
+{
+    mEvents.clear();
+    mEventCount = 0;
+}
+
+void InputRecord::AddEvent(eEvent type, const void* data, size_t size)
+{
+    if(mMode != MODE_RECORD || mEventCount == 0xFFFF)
+    {
+        return;
+    }
+
+    const unsigned char* bytes = (const unsigned char*) data;
+    mEvents.push_back((unsigned char) type);
+    mEvents.insert(mEvents.end(), bytes, bytes + size);
+    mEventCount++;
+}
+
+void InputRecord::OnKeyDown(int key)
+{
+    short value = (short) key;
+    AddEvent(EVENT_KEY_DOWN, &value, sizeof(value));
+}
+
+void InputRecord::OnKeyUp(int key)
+{
+    short value = (short) key;
+    AddEvent(EVENT_KEY_UP, &value, sizeof(value));
+}
+
+void InputRecord::OnTouch(const TouchMessage& message)
+{
+    unsigned char data[2 + sizeof(float) * 2];
+    data[0] = (unsigned char) message.mState;
+    data[1] = (unsigned char) message.mId;
+    memcpy(&data[2], &message.mX, sizeof(float));
+    memcpy(&data[2 + sizeof(float)], &message.mY, sizeof(float));
+    AddEvent(EVENT_TOUCH, data, sizeof(data));
+}
+
+void InputRecord::OnMouse(float x,
+                          float y,
+                          bool leftDown,
+                          bool middleDown,
+                          bool rightDown)
+{
+    mMouseX = x;
+    mMouseY = y;
+    mMouseButtons = (leftDown ? 1 : 0)
+                  | (middleDown ? 2 : 0)
+                  | (rightDown ? 4 : 0);
+}
+
+void InputRecord::Write(const void* data, size_t size)
+{
+    if(size > 0 && fwrite(data, size, 1, mFile) != 1)
+    {
+        dsprintf("Failed writing input recording, stopping.\n");
+        Stop();
+    }
+}
+
+void InputRecord::EndFrame(double deltaTime)
+{
+    if(mMode != MODE_RECORD)
+    {
+        return;
+    }
+
+    float dt = (float) deltaTime;
+    Write(&dt, sizeof(dt));
+    Write(&mMouseX, sizeof(mMouseX));
+    Write(&mMouseY, sizeof(mMouseY));
+    Write(&mMouseButtons, sizeof(mMouseButtons));
+    Write(&mEventCount, sizeof(mEventCount));
+    if(!mEvents.empty())
+    {
+        Write(&mEvents[0], mEvents.size());
+    }
+
+    if(mMode == MODE_RECORD)
+    {
+        mFrame++;
+    }
+    ClearFrame();
+}
+
+bool InputRecord::ReplayFrame(Game* game, double* deltaTime)
+{
+    assert(game);
+    assert(deltaTime);
+
+    if(mMode != MODE_REPLAY)
+    {
+        return false;
+    }
+
+    float dt = 0;
+    float mouseX = 0;
+    float mouseY = 0;
+    unsigned char buttons = 0;
+    unsigned short count = 0;
+
+    if(fread(&dt, sizeof(dt), 1, mFile) != 1
+       || fread(&mouseX, sizeof(mouseX), 1, mFile) != 1
+       || fread(&mouseY, sizeof(mouseY), 1, mFile) != 1
+       || fread(&buttons, sizeof(buttons), 1, mFile) != 1
+       || fread(&count, sizeof(count), 1, mFile) != 1)
+    {
+        dsprintf("Input replay finished after %u frames.\n", mFrame);
+        Stop();
+        return false;
+    }
+
+    // Keys first, the same order the live loop sends them in.
+    for(unsigned short i = 0; i < count; i++)
+    {
+        unsigned char type = 0;
+        bool ok = fread(&type, sizeof(type), 1, mFile) == 1;
+
+        if(ok && (type == EVENT_KEY_DOWN || type == EVENT_KEY_UP))
+        {
+            short key = 0;
+            ok = fread(&key, sizeof(key), 1, mFile) == 1;
+            if(ok && type == EVENT_KEY_DOWN)
+            {
+                game->GetKeyboard()->OnKeyDownEvent(key);
+            }
+            else if(ok)
+            {
+                game->GetKeyboard()->OnKeyUpEvent(key);
+            }
+        }
+        else if(ok && type == EVENT_TOUCH)
+        {
+            unsigned char state = 0;
+            unsigned char id = 0;
+            TouchMessage message;
+            ok = fread(&state, sizeof(state), 1, mFile) == 1
+                 && fread(&id, sizeof(id), 1, mFile) == 1
+                 && fread(&message.mX, sizeof(float), 1, mFile) == 1
+                 && fread(&message.mY, sizeof(float), 1, mFile) == 1;
+            message.mState = (TouchEvent::Enum) state;
+            message.mId = id;
+            if(ok)
+            {
+                game->GetTouch()->OnTouchEvent(message);
+            }
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if(!ok)
+        {
+            dsprintf("Input recording is corrupt at frame %u.\n", mFrame);
+            Stop();
+            return false;
+        }
+    }
+
+    game->GetMouse()->OnMouseEvent(mouseX,
+                                   mouseY,
+                                   (buttons & 1) != 0,
+                                   (buttons & 2) != 0,
+                                   (buttons & 4) != 0);
+    *deltaTime = dt;
+    mFrame++;
+    return true;
+}
\ No newline at end of file
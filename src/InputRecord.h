@@ -0,0 +1,73 @@
+#ifndef INPUTRECORD_H
+#define INPUTRECORD_H
+
+#include <stdio.h>
+#include <vector>
+
+#include "input/Touch.h"
+
+class Game;
+
+//
+// Records a session's input and frame times to a file and plays it back,
+// so the same gameplay can be profiled run after run. --record and
+// --replay on desktop.
+//
+// The file is a header then one record a frame:
+//     float delta time, float mouse x, float mouse y, u8 mouse buttons,
+//     u16 event count, then events of u8 type and its payload.
+// Values are written in the machine's byte order.
+//
+class InputRecord
+{
+public:
+    enum eMode
+    {
+        MODE_NONE,
+        MODE_RECORD,
+        MODE_REPLAY
+    };
+    enum eEvent
+    {
+        EVENT_KEY_DOWN, // s16 key
+        EVENT_KEY_UP,   // s16 key
+        EVENT_TOUCH     // u8 state, u8 pointer id, float x, float y
+    };
+    static const unsigned int VERSION = 2;
+private:
+    eMode mMode;
+    FILE* mFile;
+    unsigned int mFrame;
+    std::vector<unsigned char> mEvents; // this frame's, while recording
+    unsigned short mEventCount;
+    float mMouseX;
+    float mMouseY;
+    unsigned char mMouseButtons;
+public:
+    InputRecord();
+    ~InputRecord() { Stop(); }
+
+    bool StartRecording(const char* path);
+    bool StartReplay(const char* path);
+    void Stop();
+    bool IsRecording() const { return mMode == MODE_RECORD; }
+    bool IsReplaying() const { return mMode == MODE_REPLAY; }
+
+    // Recording, call as the input's sent to the game.
+    void OnKeyDown(int key);
+    void OnKeyUp(int key);
+    void OnTouch(const TouchMessage& message);
+    void OnMouse(float x, float y, bool leftDown, bool middleDown, bool rightDown);
+    // Writes out everything since the last call.
+    void EndFrame(double deltaTime);
+
+    // Sends the next frame's input to the game and gives back the delta
+    // time it was recorded with. Returns false once the recording's over.
+    bool ReplayFrame(Game* game, double* deltaTime);
+private:
+    void Write(const void* data, size_t size);
+    void AddEvent(eEvent type, const void* data, size_t size);
+    void ClearFrame();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,314 @@
+#include "JitMonitor.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "DinodeckLua.h"
+#include "DDLog.h"
+#include "Settings.h"
+
+extern "C"
+{
+#include "luajit.h"
+}
+
+static const char* FUNC_INFO_KEY = "dinodeck.jit.funcinfo";
+
+#if LUAJIT_VERSION_NUM >= 20000
+// LuaJIT's own messages, by the number an abort gives.
+static const char* const TraceErrors[] =
+{
+#define TREDEF(name, msg) msg,
+#include "lj_traceerr.h"
+#undef TREDEF
+};
+static const int TRACE_ERROR_COUNT = sizeof(TraceErrors) / sizeof(TraceErrors[0]);
+#else
+static const char* const* TraceErrors = NULL;
+static const int TRACE_ERROR_COUNT = 0;
+#endif
+
+JitMonitor::JitMonitor() :
+    mEnabled(true),
+    mLog(false),
+    mStarted(0),
+    mCompiled(0),
+    mAborted(0)
+{
+}
+
+void JitMonitor::Attach(lua_State* state, const Settings& settings)
+{
+    assert(state);
+    mEnabled = settings.jit;
+    mLog = settings.jitLog;
+
+    // Traces from before are no good with new options.
+    luaJIT_setmode(state, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_FLUSH);
+    luaJIT_setmode(state, 0, LUAJIT_MODE_ENGINE | (mEnabled ? LUAJIT_MODE_ON : LUAJIT_MODE_OFF));
+    if(!mEnabled)
+    {
+        return;
+    }
+
+    const int top = lua_gettop(state);
+    lua_getglobal(state, "jit");
+    if(!lua_istable(state, -1))
+    {
+        lua_settop(state, top);
+        return;
+    }
+    const int jit = lua_gettop(state);
+
+    // jit.opt.start("hotloop=56", "maxmcode=512")
+    lua_getfield(state, jit, "opt");
+    if(lua_istable(state, -1))
+    {
+        lua_getfield(state, -1, "start");
+        int options = 0;
+        if(settings.jitHotloop > 0)
+        {
+            lua_pushfstring(state, "hotloop=%d", settings.jitHotloop);
+            options++;
+        }
+        if(settings.jitMaxMcodeKb > 0)
+        {
+            lua_pushfstring(state, "maxmcode=%d", settings.jitMaxMcodeKb);
+            options++;
+        }
+        if(options > 0 && lua_pcall(state, options, 0, 0) != 0)
+        {
+            dsprintf("JIT options not set: %s\n", lua_tostring(state, -1));
+        }
+    }
+    lua_settop(state, jit);
+
+    lua_getfield(state, jit, "attach");
+    if(!lua_isfunction(state, -1))
+    {
+        dsprintf("%s has no trace events, JIT aborts aren't counted.\n", LUAJIT_VERSION);
+        lua_settop(state, top);
+        return;
+    }
+
+    // For where traces are, as jit.v reports them.
+    lua_getglobal(state, "require");
+    lua_pushstring(state, "jit.util");
+    if(lua_pcall(state, 1, 1, 0) == 0 && lua_istable(state, -1))
+    {
+        lua_getfield(state, -1, "funcinfo");
+        lua_setfield(state, LUA_REGISTRYINDEX, FUNC_INFO_KEY);
+    }
+    lua_settop(state, jit + 1);
+
+    // An event has one handler, this replaces the last state's.
+    lua_pushlightuserdata(state, this);
+    lua_pushcclosure(state, JitMonitor::OnTrace, 1);
+    lua_pushstring(state, "trace");
+    if(lua_pcall(state, 2, 0, 0) != 0)
+    {
+        dsprintf("Couldn't watch JIT traces: %s\n", lua_tostring(state, -1));
+    }
+    lua_settop(state, top);
+}
+
+//
+// jit.attach's trace event: what, trace number, function, then for an
+// abort the bytecode position, the error and its detail.
+//
+int JitMonitor::OnTrace(lua_State* state)
+{
+    JitMonitor* monitor = (JitMonitor*) lua_touserdata(state, lua_upvalueindex(1));
+    const char* what = lua_tostring(state, 1);
+    if(monitor == NULL || what == NULL)
+    {
+        return 0;
+    }
+
+    const int trace = (int) lua_tointeger(state, 2);
+    if(strcmp(what, "start") == 0)
+    {
+        monitor->mStarted++;
+        // "stop" only carries the trace number.
+        monitor->mRecording = monitor->mLog ? Location(state, 3, 4) : std::string();
+    }
+    else if(strcmp(what, "stop") == 0)
+    {
+        monitor->mCompiled++;
+        if(monitor->mLog)
+        {
+            dsprintf("[JIT] trace %d compiled at %s\n", trace, monitor->mRecording.c_str());
+        }
+    }
+    else if(strcmp(what, "abort") == 0)
+    {
+        monitor->mAborted++;
+        const std::string location = Location(state, 3, 4);
+        const std::string reason = Reason(state, 5, 6);
+        monitor->mAborts[location + "\t" + reason]++;
+        if(monitor->mLog)
+        {
+            dsprintf("[JIT] trace %d aborted at %s: %s\n", trace, location.c_str(), reason.c_str());
+        }
+    }
+    else if(strcmp(what, "flush") == 0 && monitor->mLog)
+    {
+        dsprintf("[JIT] traces flushed\n");
+    }
+    return 0;
+}
+
+// "file.lua:12" from jit.util.funcinfo, pc 0 for where the function starts.
+std::string JitMonitor::Location(lua_State* state, int func, int pc)
+{
+    std::string location("?");
+    if(lua_iscfunction(state, func))
+    {
+        return NameFunction(state, func);
+    }
+
+    const int top = lua_gettop(state);
+    lua_getfield(state, LUA_REGISTRYINDEX, FUNC_INFO_KEY);
+    if(lua_isfunction(state, -1))
+    {
+        lua_pushvalue(state, func);
+        if(pc > 0)
+        {
+            lua_pushvalue(state, pc);
+        }
+        else
+        {
+            lua_pushnil(state);
+        }
+
+        if(lua_pcall(state, 2, 1, 0) == 0 && lua_istable(state, -1))
+        {
+            lua_getfield(state, -1, "loc");
+            if(lua_isstring(state, -1))
+            {
+                location = lua_tostring(state, -1);
+            }
+        }
+    }
+    lua_settop(state, top);
+    return location;
+}
+
+std::string JitMonitor::Reason(lua_State* state, int error, int info)
+{
+    if(!lua_isnumber(state, error))
+    {
+        const char* message = lua_tostring(state, error);
+        return message ? message : "?";
+    }
+
+    const int number = (int) lua_tointeger(state, error);
+    if(number < 0 || number >= TRACE_ERROR_COUNT)
+    {
+        char buffer[32];
+        sprintf(buffer, "trace error %d", number);
+        return buffer;
+    }
+
+    // The messages have one %d, %s or %p for the detail.
+    std::string detail;
+    if(lua_isfunction(state, info))
+    {
+        detail = lua_iscfunction(state, info) ? NameFunction(state, info) : Location(state, info, 0);
+    }
+    else if(lua_isstring(state, info))
+    {
+        detail = lua_tostring(state, info);
+    }
+
+    std::string message(TraceErrors[number]);
+    const std::string::size_type conversion = message.find('%');
+    if(conversion != std::string::npos)
+    {
+        message.replace(conversion, 2, detail);
+    }
+    return message;
+}
+
+//
+// Engine bindings are found by looking through the globals and the
+// libraries in them, "Sprite.SetPosition". Aborts are rare enough for it.
+//
+std::string JitMonitor::NameFunction(lua_State* state, int index)
+{
+    std::string name("C function");
+    const int top = lua_gettop(state);
+    lua_pushvalue(state, LUA_GLOBALSINDEX);
+    lua_pushnil(state);
+    while(lua_next(state, -2) != 0)
+    {
+        if(lua_type(state, -2) == LUA_TSTRING)
+        {
+            const char* global = lua_tostring(state, -2);
+            if(lua_rawequal(state, -1, index))
+            {
+                name = global;
+                break;
+            }
+
+            if(lua_istable(state, -1) && strcmp(global, "_G") != 0)
+            {
+                bool found = false;
+                lua_pushnil(state);
+                while(lua_next(state, -2) != 0)
+                {
+                    if(lua_type(state, -2) == LUA_TSTRING && lua_rawequal(state, -1, index))
+                    {
+                        name = std::string(global) + "." + lua_tostring(state, -2);
+                        found = true;
+                        break;
+                    }
+                    lua_pop(state, 1);
+                }
+                if(found)
+                {
+                    break;
+                }
+            }
+        }
+        lua_pop(state, 1);
+    }
+    lua_settop(state, top);
+    return name;
+}
+
+static bool MoreAborts(const std::pair<std::string, unsigned int>& a,
+                       const std::pair<std::string, unsigned int>& b)
+{
+    return a.second > b.second;
+}
+
+std::string JitMonitor::Report() const
+{
+    std::ostringstream out;
+    out << "jit " << (mEnabled ? "on" : "off")
+        << ", traces started " << mStarted
+        << ", compiled " << mCompiled
+        << ", aborted " << mAborted << "\n";
+
+    std::vector<std::pair<std::string, unsigned int> > aborts(mAborts.begin(), mAborts.end());
+    std::stable_sort(aborts.begin(), aborts.end(), MoreAborts);
+    for(std::vector<std::pair<std::string, unsigned int> >::iterator it = aborts.begin();
+        it != aborts.end(); ++it)
+    {
+        out << it->second << "\t" << it->first << "\n";
+    }
+    return out.str();
+}
+
+void JitMonitor::Clear()
+{
+    mStarted = 0;
+    mCompiled = 0;
+    mAborted = 0;
+    mAborts.clear();
+}
\ No newline at end of file
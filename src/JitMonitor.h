@@ -0,0 +1,52 @@
+#ifndef JITMONITOR_H
+#define JITMONITOR_H
+
+#include <map>
+#include <string>
+
+struct lua_State;
+struct Settings;
+
+//
+// Applies the settings' JIT options to the game's state and watches its
+// trace events, the way jit.v does. Aborted traces fall back to the
+// interpreter without a word, so each is counted by where it aborted and
+// why, and the summary is served at /jit/. An abort at a C function call
+// names the binding, "NYI: C function Sprite.SetPosition".
+//
+// Trace events need LuaJIT 2, with 1.x only the JIT mode is set.
+//
+class JitMonitor
+{
+public:
+    JitMonitor();
+
+    // Call with each new or restored state.
+    void Attach(lua_State* state, const Settings& settings);
+    bool IsEnabled() const { return mEnabled; }
+
+    // Each trace compiled or aborted goes to the log as well.
+    void SetLogging(bool value) { mLog = value; }
+    bool IsLogging() const { return mLog; }
+
+    // Trace counts, then the aborts, most frequent first.
+    std::string Report() const;
+    void Clear();
+private:
+    typedef std::map<std::string, unsigned int> AbortMap; // "location\treason"
+
+    bool mEnabled;
+    bool mLog;
+    unsigned int mStarted;
+    unsigned int mCompiled;
+    unsigned int mAborted;
+    AbortMap mAborts;
+    std::string mRecording; // where the trace being recorded started
+
+    static int OnTrace(lua_State* state);
+    static std::string Location(lua_State* state, int func, int pc);
+    static std::string Reason(lua_State* state, int error, int info);
+    static std::string NameFunction(lua_State* state, int index);
+};
+
+#endif
\ No newline at end of file
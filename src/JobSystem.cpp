@@ -0,0 +1,304 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include "DDLog.h"
+#include "DDTime.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+int JobGroup::Pending()
+{
+    ScopedLock lock(mMutex);
+    return mPending;
+}
+
+void JobGroup::Add()
+{
+    ScopedLock lock(mMutex);
+    mPending++;
+}
+
+void JobGroup::Finish()
+{
+    ScopedLock lock(mMutex);
+    mPending--;
+    if(mPending == 0)
+    {
+        mDone.Broadcast();
+    }
+}
+
+struct RangeJob : public Job
+{
+    JobSystem::RangeFunction function;
+    void* data;
+    unsigned int begin;
+    unsigned int end;
+
+    virtual void Run() { function(data, begin, end); }
+};
+
+JobSystem::JobSystem() :
+    mWorkers(),
+    mQueued(0),
+    mNextQueue(0),
+    mStopping(false)
+{
+}
+
+JobSystem::~JobSystem()
+{
+    mSleepMutex.Lock();
+    mStopping = true;
+    mWake.Broadcast();
+    mSleepMutex.Unlock();
+
+    for(unsigned int i = 0; i < mWorkers.size(); i++)
+    {
+        mWorkers[i]->thread.Join();
+    }
+
+    for(unsigned int i = 0; i < mWorkers.size(); i++)
+    {
+        Worker* worker = mWorkers[i];
+        for(std::deque<Entry>::iterator it = worker->queue.begin();
+            it != worker->queue.end(); ++it)
+        {
+            delete it->job;
+        }
+        delete worker;
+    }
+}
+
+unsigned int JobSystem::CoreCount()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    long cores = info.dwNumberOfProcessors;
+#else
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return cores > 0 ? (unsigned int) cores : 1;
+}
+
+void JobSystem::Start(unsigned int threads)
+{
+    if(!mWorkers.empty())
+    {
+        return;
+    }
+
+    if(threads == 0)
+    {
+        threads = CoreCount() - 1;
+    }
+
+    for(unsigned int i = 0; i < threads; i++)
+    {
+        Worker* worker = new Worker();
+        worker->system = this;
+        worker->index = mWorkers.size();
+        worker->trace = Trace::AddThread("worker");
+        // Pushed first so the new thread sees every queue.
+        mWorkers.push_back(worker);
+
+        if(!worker->thread.Start(&JobSystem::WorkerMain, worker))
+        {
+            mWorkers.pop_back();
+            delete worker;
+            break;
+        }
+    }
+    dsprintf("Job system running %d workers.\n", (int) mWorkers.size());
+}
+
+void JobSystem::Submit(Job* job, JobGroup* group)
+{
+    assert(job);
+    Entry entry;
+    entry.job = job;
+    entry.group = group;
+
+    if(group)
+    {
+        group->Add();
+    }
+
+    if(mWorkers.empty())
+    {
+        Run(entry, Trace::Main());
+        return;
+    }
+
+    mSleepMutex.Lock();
+    Worker* worker = mWorkers[mNextQueue];
+    mNextQueue = (mNextQueue + 1) % mWorkers.size();
+    mSleepMutex.Unlock();
+
+    worker->mutex.Lock();
+    worker->queue.push_back(entry);
+    worker->mutex.Unlock();
+
+    mSleepMutex.Lock();
+    mQueued++;
+    mWake.Signal();
+    mSleepMutex.Unlock();
+}
+
+void JobSystem::Run(const Entry& entry, Trace::Ring* trace)
+{
+    const unsigned long long start = Trace::IsCapturing() ? DDTime::Microseconds() : 0;
+    entry.job->Run();
+    delete entry.job;
+    if(start != 0)
+    {
+        Trace::Record(trace, "job", start, DDTime::Microseconds());
+    }
+
+    if(entry.group)
+    {
+        entry.group->Finish();
+    }
+}
+
+//
+// Takes the newest job from the home queue, or steals the oldest from
+// another. False if every queue is empty, or has none of the group's.
+//
+bool JobSystem::TryRun(unsigned int home, Trace::Ring* trace, const JobGroup* group)
+{
+    const unsigned int count = mWorkers.size();
+    for(unsigned int i = 0; i < count; i++)
+    {
+        Worker* worker = mWorkers[(home + i) % count];
+        Entry entry;
+        bool found = false;
+
+        worker->mutex.Lock();
+        if(group != NULL)
+        {
+            // The group's newest from home, its oldest from the others.
+            std::deque<Entry>& queue = worker->queue;
+            for(unsigned int j = 0; j < queue.size() && !found; j++)
+            {
+                const unsigned int at = i == 0 ? queue.size() - 1 - j : j;
+                if(queue[at].group == group)
+                {
+                    entry = queue[at];
+                    queue.erase(queue.begin() + at);
+                    found = true;
+                }
+            }
+        }
+        else if(!worker->queue.empty())
+        {
+            if(i == 0)
+            {
+                entry = worker->queue.back();
+                worker->queue.pop_back();
+            }
+            else
+            {
+                entry = worker->queue.front();
+                worker->queue.pop_front();
+            }
+            found = true;
+        }
+        worker->mutex.Unlock();
+
+        if(found)
+        {
+            mSleepMutex.Lock();
+            mQueued--;
+            mSleepMutex.Unlock();
+            Run(entry, trace);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::WorkerMain(void* data)
+{
+    Worker* worker = static_cast<Worker*>(data);
+    JobSystem* system = worker->system;
+
+    for(;;)
+    {
+        if(system->TryRun(worker->index, worker->trace))
+        {
+            continue;
+        }
+
+        ScopedLock lock(system->mSleepMutex);
+        while(system->mQueued <= 0 && !system->mStopping)
+        {
+            system->mWake.Wait(system->mSleepMutex);
+        }
+
+        if(system->mStopping)
+        {
+            return;
+        }
+    }
+}
+
+void JobSystem::Wait(JobGroup& group)
+{
+    while(group.Pending() > 0)
+    {
+        // Only the group's own, anything else could be a long job like a
+        // texture decode or a worker script.
+        if(TryRun(0, Trace::Main(), &group))
+        {
+            continue;
+        }
+
+        // Everything left of the group is running elsewhere.
+        ScopedLock lock(group.mMutex);
+        if(group.mPending > 0)
+        {
+            group.mDone.Wait(group.mMutex);
+        }
+    }
+}
+
+void JobSystem::ParallelFor(unsigned int count,
+                            unsigned int grain,
+                            RangeFunction function,
+                            void* data)
+{
+    assert(function);
+    grain = std::max(grain, 1u);
+
+    if(mWorkers.empty() || count <= grain)
+    {
+        function(data, 0, count);
+        return;
+    }
+
+    // A chunk per thread, unless that'd be smaller than the grain.
+    const unsigned int threads = mWorkers.size() + 1;
+    const unsigned int chunk = std::max(grain, (count + threads - 1) / threads);
+
+    JobGroup group;
+    for(unsigned int begin = chunk; begin < count; begin += chunk)
+    {
+        RangeJob* job = new RangeJob();
+        job->function = function;
+        job->data = data;
+        job->begin = begin;
+        job->end = std::min(begin + chunk, count);
+        Submit(job, &group);
+    }
+
+    function(data, 0, std::min(chunk, count));
+    Wait(group);
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <deque>
+#include <vector>
+
+#include "Threading.h"
+#include "Trace.h"
+
+//
+// Work to run on a worker thread. Jobs mustn't touch GL or Lua, they
+// hand results back for the main thread to pick up.
+//
+class Job
+{
+public:
+    virtual ~Job() {}
+    virtual void Run() = 0;
+};
+
+//
+// Counts a set of submitted jobs so they can be waited on together.
+//
+class JobGroup
+{
+    friend class JobSystem;
+    Mutex mMutex;
+    Condition mDone;
+    int mPending;
+public:
+    JobGroup() : mPending(0) {}
+    int Pending();
+private:
+    void Add();
+    void Finish();
+    JobGroup(const JobGroup&);
+    JobGroup& operator=(const JobGroup&);
+};
+
+//
+// A pool of worker threads, one per core less the main thread's.
+// Each worker has its own queue, takes its newest job first and steals
+// the oldest from the others when it's out. Waiting on a group runs the
+// group's queued jobs on the waiting thread rather than sleeping, other
+// jobs are left to the workers so a wait never runs longer than its own.
+//
+// With no workers, a single core, jobs run as they're submitted.
+//
+class JobSystem
+{
+public:
+    typedef void (*RangeFunction)(void* data, unsigned int begin, unsigned int end);
+private:
+    struct Entry
+    {
+        Job* job;
+        JobGroup* group;
+    };
+    struct Worker
+    {
+        JobSystem* system;
+        unsigned int index;
+        Mutex mutex;
+        std::deque<Entry> queue;
+        Thread thread;
+        Trace::Ring* trace;
+    };
+
+    std::vector<Worker*> mWorkers;
+    Mutex mSleepMutex;
+    Condition mWake;
+    int mQueued; // across all queues, may dip below 0 while a push lands
+    unsigned int mNextQueue; // round robin for submits
+    bool mStopping;
+
+    // The main thread passes its own trace ring. With a group only its
+    // jobs are taken.
+    bool TryRun(unsigned int home, Trace::Ring* trace, const JobGroup* group = NULL);
+    void Run(const Entry& entry, Trace::Ring* trace);
+    static void WorkerMain(void* worker);
+public:
+    JobSystem();
+    ~JobSystem(); // waits for running jobs, drops queued ones
+
+    // 0 picks from the core count. Only the first call has any effect.
+    void Start(unsigned int threads);
+    unsigned int WorkerCount() const { return mWorkers.size(); }
+    static unsigned int CoreCount();
+
+    // The system owns the job and deletes it once it's run.
+    void Submit(Job* job, JobGroup* group = NULL);
+    void Wait(JobGroup& group);
+
+    // Calls function over [0, count) in chunks of at least grain,
+    // returning once they're all done. The caller runs a chunk too.
+    void ParallelFor(unsigned int count,
+                     unsigned int grain,
+                     RangeFunction function,
+                     void* data);
+private:
+    JobSystem(const JobSystem&);
+    JobSystem& operator=(const JobSystem&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include "LogRing.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#include "DDLog.h"
+#include "Threading.h"
+
+namespace
+{
+    struct Slot
+    {
+        volatile unsigned int sequence; // position + 1 once published, first slots only
+        unsigned short length;          // of the whole message
+        unsigned char level;
+        unsigned char count;            // slots the message spans
+        char text[LogRing::SLOT_TEXT];
+    };
+
+    const unsigned int SLOT_MASK = LogRing::SLOT_COUNT - 1;
+
+    Slot gSlots[LogRing::SLOT_COUNT];
+    volatile unsigned int gHead = 0; // claimed by writers
+    volatile unsigned int gTail = 0; // written by the flush thread
+    volatile unsigned int gDropped = 0;
+    unsigned int gReported = 0;      // drops already written out
+    volatile bool gRunning = false;
+    volatile bool gStopping = false;
+
+    Thread gThread;
+    Mutex gWakeMutex;
+    Condition gWake;
+    Mutex gOutputMutex; // one writer to the sink and file at a time
+    FILE* gFile = NULL;
+    std::string gFilePath;
+}
+
+// Callers hold gOutputMutex.
+static void Output(eLogLevel level, const char* text, unsigned int length)
+{
+    ddlog_sink(level, text);
+    if(gFile)
+    {
+        fwrite(text, 1, length, gFile);
+    }
+}
+
+static void ReportDropped()
+{
+    const unsigned int dropped = gDropped;
+    if(dropped != gReported)
+    {
+        char text[64];
+        const int length = snprintf(text, sizeof(text),
+                                    "[%u log messages dropped]\n", dropped - gReported);
+        Output(LOG_WARNING, text, (unsigned int) length);
+        gReported = dropped;
+    }
+}
+
+static void Drain()
+{
+    const unsigned int slotText = LogRing::SLOT_TEXT;
+    char message[LogRing::MESSAGE_LENGTH];
+    ScopedLock lock(gOutputMutex);
+
+    for(;;)
+    {
+        const unsigned int tail = gTail;
+        const Slot& first = gSlots[tail & SLOT_MASK];
+        if(first.sequence != tail + 1)
+        {
+            break;
+        }
+        __sync_synchronize(); // read the message the sequence was stamped for
+
+        const unsigned int length = first.length;
+        const unsigned int count = first.count;
+        const eLogLevel level = (eLogLevel) first.level;
+        for(unsigned int i = 0; i < count; i++)
+        {
+            const unsigned int offset = i * slotText;
+            memcpy(message + offset,
+                   gSlots[(tail + i) & SLOT_MASK].text,
+                   std::min(length - offset, slotText));
+        }
+        message[length] = '\0';
+
+        __sync_synchronize(); // done reading before the slots are reused
+        gTail = tail + count;
+        Output(level, message, length);
+    }
+
+    ReportDropped();
+    if(gFile)
+    {
+        fflush(gFile);
+    }
+}
+
+static void FlushMain(void*)
+{
+    gWakeMutex.Lock();
+    while(!gStopping)
+    {
+        gWake.Wait(gWakeMutex, LogRing::FLUSH_MS);
+        gWakeMutex.Unlock();
+        Drain();
+        gWakeMutex.Lock();
+    }
+    gWakeMutex.Unlock();
+}
+
+bool LogRing::Start()
+{
+    if(gRunning)
+    {
+        return true;
+    }
+
+    gStopping = false;
+    gRunning = true;
+    if(!gThread.Start(&FlushMain, NULL))
+    {
+        gRunning = false;
+        dsprintf("Log flush thread failed to start.\n");
+        return false;
+    }
+    return true;
+}
+
+void LogRing::Stop()
+{
+    if(!gRunning)
+    {
+        return;
+    }
+
+    // New messages go straight out from here on.
+    gRunning = false;
+    {
+        ScopedLock lock(gWakeMutex);
+        gStopping = true;
+        gWake.Signal();
+    }
+    gThread.Join();
+    // Anything published while the thread was finishing up.
+    Drain();
+}
+
+void LogRing::SetFile(const char* path)
+{
+    const std::string newPath(path ? path : "");
+    ScopedLock lock(gOutputMutex);
+    if(newPath == gFilePath)
+    {
+        return;
+    }
+
+    if(gFile)
+    {
+        fclose(gFile);
+        gFile = NULL;
+    }
+    gFilePath = newPath;
+    if(!gFilePath.empty())
+    {
+        gFile = fopen(gFilePath.c_str(), "w");
+    }
+}
+
+void LogRing::Write(eLogLevel level, const char* fmt, va_list args)
+{
+    const unsigned int slotText = SLOT_TEXT;
+    char message[MESSAGE_LENGTH];
+    int formatted = vsnprintf(message, sizeof(message), fmt, args);
+    if(formatted <= 0)
+    {
+        return;
+    }
+    const unsigned int length = std::min((unsigned int) formatted, MESSAGE_LENGTH - 1);
+
+    if(!gRunning)
+    {
+        ScopedLock lock(gOutputMutex);
+        Output(level, message, length);
+        return;
+    }
+
+    const unsigned int count = (length + slotText - 1) / slotText;
+    unsigned int head;
+    for(;;)
+    {
+        head = gHead;
+        if(head + count - gTail > SLOT_COUNT)
+        {
+            __sync_add_and_fetch(&gDropped, 1);
+            return;
+        }
+        if(__sync_bool_compare_and_swap(&gHead, head, head + count))
+        {
+            break;
+        }
+    }
+
+    for(unsigned int i = 0; i < count; i++)
+    {
+        const unsigned int offset = i * slotText;
+        memcpy(gSlots[(head + i) & SLOT_MASK].text,
+               message + offset,
+               std::min(length - offset, slotText));
+    }
+
+    Slot& first = gSlots[head & SLOT_MASK];
+    first.length = (unsigned short) length;
+    first.level = (unsigned char) level;
+    first.count = (unsigned char) count;
+    __sync_synchronize(); // the message lands before the reader sees it
+    first.sequence = head + 1;
+
+    if(level == LOG_ERROR)
+    {
+        // Don't leave errors sitting in the ring if something's about to fall over.
+        gWake.Signal();
+    }
+}
+
+unsigned int LogRing::Dropped()
+{
+    return gDropped;
+}
+
+void ddlog(eLogLevel level, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    LogRing::Write(level, fmt, args);
+    va_end(args);
+}
+
+void dsprintf(const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    LogRing::Write(LOG_INFO, fmt, args);
+    va_end(args);
+}
\ No newline at end of file
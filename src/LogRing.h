@@ -0,0 +1,41 @@
+#ifndef LOGRING_H
+#define LOGRING_H
+
+#include <stdarg.h>
+
+#include "DDLog.h"
+
+//
+// The queue between ddlog and the platform's log output.
+//
+// Any thread may write. A writer formats on its own stack, claims enough
+// consecutive slots with a compare and swap on the head, copies the text
+// in and publishes it by stamping the first slot's sequence. The flush
+// thread is the only reader. When the ring is full messages are dropped
+// and counted rather than making the writer wait.
+//
+// Before Start and after Stop messages are written out there and then.
+//
+class LogRing
+{
+public:
+    static const unsigned int SLOT_COUNT = 4096; // power of two
+    static const unsigned int SLOT_TEXT = 120;
+    static const unsigned int MESSAGE_LENGTH = 4096; // longer is cut short
+    static const unsigned int FLUSH_MS = 20;
+
+    // False if the flush thread couldn't start, writes stay synchronous.
+    static bool Start();
+    // Writes out whatever's queued and joins the flush thread.
+    static void Stop();
+    // Messages are also copied to this file. NULL or "" stops copying.
+    static void SetFile(const char* path);
+    static void Write(eLogLevel level, const char* fmt, va_list args);
+    static unsigned int Dropped();
+};
+
+// Platform output, DDLog_Windows.cpp or DDLog_Android.cpp.
+// Only ever called by one thread at a time.
+extern void ddlog_sink(eLogLevel level, const char* text);
+
+#endif
\ No newline at end of file
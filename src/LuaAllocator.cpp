@@ -0,0 +1,180 @@
+#include "LuaAllocator.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+LuaAllocator::LuaAllocator() :
+    mSlabs(),
+    mSlabCursor(NULL),
+    mSlabEnd(NULL),
+    mBytes(0),
+    mFrame(),
+    mLastFrame()
+{
+    for(unsigned int i = 0; i < CLASS_COUNT; i++)
+    {
+        mFree[i] = NULL;
+    }
+}
+
+LuaAllocator::~LuaAllocator()
+{
+    Clear();
+}
+
+void LuaAllocator::Clear()
+{
+    for(std::vector<char*>::iterator it = mSlabs.begin(); it != mSlabs.end(); ++it)
+    {
+        free(*it);
+    }
+    mSlabs.clear();
+    mSlabCursor = NULL;
+    mSlabEnd = NULL;
+
+    for(unsigned int i = 0; i < CLASS_COUNT; i++)
+    {
+        mFree[i] = NULL;
+    }
+    mBytes = 0;
+    mFrame = Stats();
+}
+
+void LuaAllocator::EndFrame()
+{
+    mFrame.bytes = mBytes;
+    mLastFrame = mFrame;
+    mFrame.allocations = 0;
+    mFrame.peakBytes = mBytes;
+}
+
+int LuaAllocator::SizeClass(size_t size)
+{
+    for(unsigned int i = 0; i < CLASS_COUNT; i++)
+    {
+        if(size <= ClassSize(i))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+//
+// Takes a block from the end of the current slab, starting a new slab
+// if there isn't room. What's left of the old slab is wasted, at most
+// 127 bytes.
+//
+void* LuaAllocator::Carve(int sizeClass)
+{
+    const size_t size = ClassSize(sizeClass);
+    if(mSlabCursor == NULL || mSlabCursor + size > mSlabEnd)
+    {
+        char* slab = (char*) malloc(SLAB_BYTES);
+        if(slab == NULL)
+        {
+            return NULL;
+        }
+        mSlabs.push_back(slab);
+        mSlabCursor = slab;
+        mSlabEnd = slab + SLAB_BYTES;
+    }
+
+    void* block = mSlabCursor;
+    mSlabCursor += size;
+    return block;
+}
+
+void* LuaAllocator::Allocate(size_t size)
+{
+    int sizeClass = SizeClass(size);
+    if(sizeClass < 0)
+    {
+        return malloc(size);
+    }
+
+    FreeBlock* block = mFree[sizeClass];
+    if(block)
+    {
+        mFree[sizeClass] = block->next;
+        return block;
+    }
+    return Carve(sizeClass);
+}
+
+void LuaAllocator::Free(void* ptr, size_t size)
+{
+    int sizeClass = SizeClass(size);
+    if(sizeClass < 0)
+    {
+        free(ptr);
+        return;
+    }
+
+    FreeBlock* block = (FreeBlock*) ptr;
+    block->next = mFree[sizeClass];
+    mFree[sizeClass] = block;
+}
+
+void* LuaAllocator::Resize(void* ptr, size_t osize, size_t nsize)
+{
+    int oldClass = SizeClass(osize);
+    int newClass = SizeClass(nsize);
+
+    if(oldClass < 0 && newClass < 0)
+    {
+        return realloc(ptr, nsize);
+    }
+
+    if(oldClass == newClass)
+    {
+        return ptr;
+    }
+
+    void* block = Allocate(nsize);
+    if(block == NULL)
+    {
+        // Lua keeps the old block when a resize fails.
+        return NULL;
+    }
+    memcpy(block, ptr, std::min(osize, nsize));
+    Free(ptr, osize);
+    return block;
+}
+
+void* LuaAllocator::Alloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+    LuaAllocator* allocator = (LuaAllocator*) ud;
+    assert(allocator);
+
+    if(nsize == 0)
+    {
+        if(ptr)
+        {
+            allocator->Free(ptr, osize);
+            allocator->mBytes -= osize;
+        }
+        return NULL;
+    }
+
+    void* block = NULL;
+    if(ptr == NULL)
+    {
+        block = allocator->Allocate(nsize);
+        allocator->mFrame.allocations++;
+        osize = 0;
+    }
+    else
+    {
+        block = allocator->Resize(ptr, osize, nsize);
+    }
+
+    if(block)
+    {
+        allocator->mBytes = allocator->mBytes - osize + nsize;
+        allocator->mFrame.peakBytes = std::max(allocator->mFrame.peakBytes, allocator->mBytes);
+    }
+    return block;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef LUAALLOCATOR_H
+#define LUAALLOCATOR_H
+
+#include <stddef.h>
+#include <vector>
+
+//
+// A lua_Alloc for the small, short lived blocks scripts churn through:
+// Vector userdata, strings, temporary tables. Blocks of up to 128 bytes
+// come from free lists per size class, carved out of large slabs, bigger
+// blocks go to realloc. Slabs are only given back when the state closes.
+//
+// Also counts the heap so it can be reported per frame.
+//
+class LuaAllocator
+{
+public:
+    struct Stats
+    {
+        size_t bytes;             // in use at the end of the frame
+        size_t peakBytes;         // most in use during the frame
+        unsigned int allocations; // new blocks during the frame
+        Stats() : bytes(0), peakBytes(0), allocations(0) {}
+    };
+
+    static const unsigned int SLAB_BYTES = 64 * 1024;
+    static const unsigned int CLASS_COUNT = 4; // 16, 32, 64, 128 bytes
+
+    LuaAllocator();
+    ~LuaAllocator();
+
+    // The lua_Alloc, ud is the LuaAllocator.
+    static void* Alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+    // Call once the state using the allocator has been closed.
+    void Clear();
+    // Starts counting a new frame, the finished one is kept as LastFrame.
+    void EndFrame();
+    const Stats& LastFrame() const { return mLastFrame; }
+    size_t Bytes() const { return mBytes; }
+    size_t SlabBytes() const { return mSlabs.size() * SLAB_BYTES; }
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    FreeBlock* mFree[CLASS_COUNT];
+    std::vector<char*> mSlabs;
+    char* mSlabCursor;
+    char* mSlabEnd;
+    size_t mBytes;
+    Stats mFrame;
+    Stats mLastFrame;
+
+    // Index into mFree, or -1 if the block's too big for a class.
+    static int SizeClass(size_t size);
+    static size_t ClassSize(int sizeClass) { return 16 << sizeClass; }
+    void* Allocate(size_t size);
+    void Free(void* ptr, size_t size);
+    void* Resize(void* ptr, size_t osize, size_t nsize);
+    void* Carve(int sizeClass);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,358 @@
+#ifndef LUABIND_H
+#define LUABIND_H
+
+#include <string>
+
+#include "DinodeckLua.h"
+#include "LuaState.h"
+
+//
+// Generates the lua_CFunction for a method from its signature.
+//
+//     {"SetRotation", LUA_BIND_METHOD(Sprite::SetRotation)},
+//
+// Argument 1 is the object, the rest are the method's arguments in order.
+// Each is checked once, reflected types through the registry's metatable
+// key, and a mismatch raises the usual "bad argument" error. Numbers,
+// booleans and strings are returned, reflected types aren't, bind those
+// by hand. Methods of up to four arguments, and not overloaded, as the
+// method must be named unambiguously.
+//
+#define LUA_BIND_METHOD(method) LuaBind::Deduce(&method).Bind<&method>()
+
+namespace LuaBind
+{
+    template <class T> struct Decay { typedef T Type; };
+    template <class T> struct Decay<const T> { typedef T Type; };
+    template <class T> struct Decay<T&> { typedef T Type; };
+    template <class T> struct Decay<const T&> { typedef T Type; };
+
+    // Reflected types, held as a pointer into the userdata.
+    template <class T> struct Arg
+    {
+        typedef T* Storage;
+        static bool Get(lua_State* state, int index, Storage* out)
+        {
+            *out = LuaState::GetFuncParam<T>(state, index);
+            return *out != NULL;
+        }
+        static T& Pass(Storage value) { return *value; }
+    };
+
+    template <class T> struct NumberArg
+    {
+        typedef T Storage;
+        static bool Get(lua_State* state, int index, Storage* out)
+        {
+            if(!lua_isnumber(state, index))
+            {
+                luaL_typerror(state, index, "number");
+                return false;
+            }
+            *out = (T) lua_tonumber(state, index);
+            return true;
+        }
+        static T Pass(Storage value) { return value; }
+    };
+
+    template <> struct Arg<double> : NumberArg<double> {};
+    template <> struct Arg<float> : NumberArg<float> {};
+    template <> struct Arg<int> : NumberArg<int> {};
+    template <> struct Arg<unsigned int> : NumberArg<unsigned int> {};
+
+    template <> struct Arg<bool>
+    {
+        typedef bool Storage;
+        static bool Get(lua_State* state, int index, Storage* out)
+        {
+            if(!lua_isboolean(state, index))
+            {
+                luaL_typerror(state, index, "boolean");
+                return false;
+            }
+            *out = lua_toboolean(state, index) != 0;
+            return true;
+        }
+        static bool Pass(Storage value) { return value; }
+    };
+
+    template <> struct Arg<const char*>
+    {
+        typedef const char* Storage;
+        static bool Get(lua_State* state, int index, Storage* out)
+        {
+            *out = LuaState::GetParam(state, index);
+            return *out != NULL;
+        }
+        static const char* Pass(Storage value) { return value; }
+    };
+
+    template <> struct Arg<std::string> : Arg<const char*> {};
+
+    inline void Push(lua_State* state, double value) { lua_pushnumber(state, value); }
+    inline void Push(lua_State* state, float value) { lua_pushnumber(state, value); }
+    inline void Push(lua_State* state, int value) { lua_pushinteger(state, value); }
+    inline void Push(lua_State* state, unsigned int value) { lua_pushinteger(state, value); }
+    inline void Push(lua_State* state, bool value) { lua_pushboolean(state, value); }
+    inline void Push(lua_State* state, const char* value) { lua_pushstring(state, value); }
+    inline void Push(lua_State* state, const std::string& value)
+    {
+        lua_pushlstring(state, value.c_str(), value.size());
+    }
+
+    // P is the method pointer type, so const methods share these.
+    template <class C, class R, class P> struct Method0
+    {
+        template <P M> static int Call(lua_State* state)
+        {
+            C* self = LuaState::GetFuncParam<C>(state, 1);
+            if(self == NULL)
+            {
+                return 0;
+            }
+            Push(state, (self->*M)());
+            return 1;
+        }
+        template <P M> lua_CFunction Bind() const { return &Call<M>; }
+    };
+
+    template <class C, class P> struct Method0<C, void, P>
+    {
+        template <P M> static int Call(lua_State* state)
+        {
+            C* self = LuaState::GetFuncParam<C>(state, 1);
+            if(self == NULL)
+            {
+                return 0;
+            }
+            (self->*M)();
+            return 0;
+        }
+        template <P M> lua_CFunction Bind() const { return &Call<M>; }
+    };
+
+    template <class C, class R, class A1, class P> struct Method1
+    {
+        typedef Arg<typename Decay<A1>::Type> Arg1;
+        template <P M> static int Call(lua_State* state)
+        {
+            C* self = LuaState::GetFuncParam<C>(state, 1);
+            typename Arg1::Storage a1;
+            if(self == NULL || !Arg1::Get(state, 2, &a1))
+            {
+                return 0;
+            }
+            Push(state, (self->*M)(Arg1::Pass(a1)));
+            return 1;
+        }
+        template <P M> lua_CFunction Bind() const { return &Call<M>; }
+    };
+
+    template <class C, class A1, class P> struct Method1<C, void, A1, P>
+    {
+        typedef Arg<typename Decay<A1>::Type> Arg1;
+        template <P M> static int Call(lua_State* state)
+        {
+            C* self = LuaState::GetFuncParam<C>(state, 1);
+            typename Arg1::Storage a1;
+            if(self == NULL || !Arg1::Get(state, 2, &a1))
+            {
+                return 0;
+            }
+            (self->*M)(Arg1::Pass(a1));
+            return 0;
+        }
+        template <P M> lua_CFunction Bind() const { return &Call<M>; }
+    };
+
+    template <class C, class R, class A1, class A2, class P> struct Method2
+    {
+        typedef Arg<typename Decay<A1>::Type> Arg1;
+        typedef Arg<typename Decay<A2>::Type> Arg2;
+        template <P M> static int Call(lua_State* state)
+        {
+            C* self = LuaState::GetFuncParam<C>(state, 1);
+            typename Arg1::Storage a1;
+            typename Arg2::Storage a2;
+            if(self == NULL
+               || !Arg1::Get(state, 2, &a1)
+               || !Arg2::Get(state, 3, &a2))
+            {
+                return 0;
+            }
+            Push(state, (self->*M)(Arg1::Pass(a1), Arg2::Pass(a2)));
+            return 1;
+        }
+        template <P M> lua_CFunction Bind() const { return &Call<M>; }
+    };
+
+    template <class C, class A1, class A2, class P> struct Method2<C, void, A1, A2, P>
+    {
+        typedef Arg<typename Decay<A1>::Type> Arg1;
+        typedef Arg<typename Decay<A2>::Type> Arg2;
+        template <P M> static int Call(lua_State* state)
+        {
+            C* self = LuaState::GetFuncParam<C>(state, 1);
+            typename Arg1::Storage a1;
+            typename Arg2::Storage a2;
+            if(self == NULL
+               || !Arg1::Get(state, 2, &a1)
+               || !Arg2::Get(state, 3, &a2))
+            {
+                return 0;
+            }
+            (self->*M)(Arg1::Pass(a1), Arg2::Pass(a2));
+            return 0;
+        }
+        template <P M> lua_CFunction Bind() const { return &Call<M>; }
+    };
+
+    template <class C, class R, class A1, class A2, class A3, class P> struct Method3
+    {
+        typedef Arg<typename Decay<A1>::Type> Arg1;
+        typedef Arg<typename Decay<A2>::Type> Arg2;
+        typedef Arg<typename Decay<A3>::Type> Arg3;
+        template <P M> static int Call(lua_State* state)
+        {
+            C* self = LuaState::GetFuncParam<C>(state, 1);
+            typename Arg1::Storage a1;
+            typename Arg2::Storage a2;
+            typename Arg3::Storage a3;
+            if(self == NULL
+               || !Arg1::Get(state, 2, &a1)
+               || !Arg2::Get(state, 3, &a2)
+               || !Arg3::Get(state, 4, &a3))
+            {
+                return 0;
+            }
+            Push(state, (self->*M)(Arg1::Pass(a1), Arg2::Pass(a2), Arg3::Pass(a3)));
+            return 1;
+        }
+        template <P M> lua_CFunction Bind() const { return &Call<M>; }
+    };
+
+    template <class C, class A1, class A2, class A3, class P> struct Method3<C, void, A1, A2, A3, P>
+    {
+        typedef Arg<typename Decay<A1>::Type> Arg1;
+        typedef Arg<typename Decay<A2>::Type> Arg2;
+        typedef Arg<typename Decay<A3>::Type> Arg3;
+        template <P M> static int Call(lua_State* state)
+        {
+            C* self = LuaState::GetFuncParam<C>(state, 1);
+            typename Arg1::Storage a1;
+            typename Arg2::Storage a2;
+            typename Arg3::Storage a3;
+            if(self == NULL
+               || !Arg1::Get(state, 2, &a1)
+               || !Arg2::Get(state, 3, &a2)
+               || !Arg3::Get(state, 4, &a3))
+            {
+                return 0;
+            }
+            (self->*M)(Arg1::Pass(a1), Arg2::Pass(a2), Arg3::Pass(a3));
+            return 0;
+        }
+        template <P M> lua_CFunction Bind() const { return &Call<M>; }
+    };
+
+    template <class C, class R, class A1, class A2, class A3, class A4, class P> struct Method4
+    {
+        typedef Arg<typename Decay<A1>::Type> Arg1;
+        typedef Arg<typename Decay<A2>::Type> Arg2;
+        typedef Arg<typename Decay<A3>::Type> Arg3;
+        typedef Arg<typename Decay<A4>::Type> Arg4;
+        template <P M> static int Call(lua_State* state)
+        {
+            C* self = LuaState::GetFuncParam<C>(state, 1);
+            typename Arg1::Storage a1;
+            typename Arg2::Storage a2;
+            typename Arg3::Storage a3;
+            typename Arg4::Storage a4;
+            if(self == NULL
+               || !Arg1::Get(state, 2, &a1)
+               || !Arg2::Get(state, 3, &a2)
+               || !Arg3::Get(state, 4, &a3)
+               || !Arg4::Get(state, 5, &a4))
+            {
+                return 0;
+            }
+            Push(state, (self->*M)(Arg1::Pass(a1), Arg2::Pass(a2),
+                                   Arg3::Pass(a3), Arg4::Pass(a4)));
+            return 1;
+        }
+        template <P M> lua_CFunction Bind() const { return &Call<M>; }
+    };
+
+    template <class C, class A1, class A2, class A3, class A4, class P>
+    struct Method4<C, void, A1, A2, A3, A4, P>
+    {
+        typedef Arg<typename Decay<A1>::Type> Arg1;
+        typedef Arg<typename Decay<A2>::Type> Arg2;
+        typedef Arg<typename Decay<A3>::Type> Arg3;
+        typedef Arg<typename Decay<A4>::Type> Arg4;
+        template <P M> static int Call(lua_State* state)
+        {
+            C* self = LuaState::GetFuncParam<C>(state, 1);
+            typename Arg1::Storage a1;
+            typename Arg2::Storage a2;
+            typename Arg3::Storage a3;
+            typename Arg4::Storage a4;
+            if(self == NULL
+               || !Arg1::Get(state, 2, &a1)
+               || !Arg2::Get(state, 3, &a2)
+               || !Arg3::Get(state, 4, &a3)
+               || !Arg4::Get(state, 5, &a4))
+            {
+                return 0;
+            }
+            (self->*M)(Arg1::Pass(a1), Arg2::Pass(a2),
+                       Arg3::Pass(a3), Arg4::Pass(a4));
+            return 0;
+        }
+        template <P M> lua_CFunction Bind() const { return &Call<M>; }
+    };
+
+    // Only the types are used, the pointer is given again to Bind.
+    template <class C, class R>
+    Method0<C, R, R (C::*)()> Deduce(R (C::*)())
+    { return Method0<C, R, R (C::*)()>(); }
+
+    template <class C, class R>
+    Method0<C, R, R (C::*)() const> Deduce(R (C::*)() const)
+    { return Method0<C, R, R (C::*)() const>(); }
+
+    template <class C, class R, class A1>
+    Method1<C, R, A1, R (C::*)(A1)> Deduce(R (C::*)(A1))
+    { return Method1<C, R, A1, R (C::*)(A1)>(); }
+
+    template <class C, class R, class A1>
+    Method1<C, R, A1, R (C::*)(A1) const> Deduce(R (C::*)(A1) const)
+    { return Method1<C, R, A1, R (C::*)(A1) const>(); }
+
+    template <class C, class R, class A1, class A2>
+    Method2<C, R, A1, A2, R (C::*)(A1, A2)> Deduce(R (C::*)(A1, A2))
+    { return Method2<C, R, A1, A2, R (C::*)(A1, A2)>(); }
+
+    template <class C, class R, class A1, class A2>
+    Method2<C, R, A1, A2, R (C::*)(A1, A2) const> Deduce(R (C::*)(A1, A2) const)
+    { return Method2<C, R, A1, A2, R (C::*)(A1, A2) const>(); }
+
+    template <class C, class R, class A1, class A2, class A3>
+    Method3<C, R, A1, A2, A3, R (C::*)(A1, A2, A3)> Deduce(R (C::*)(A1, A2, A3))
+    { return Method3<C, R, A1, A2, A3, R (C::*)(A1, A2, A3)>(); }
+
+    template <class C, class R, class A1, class A2, class A3>
+    Method3<C, R, A1, A2, A3, R (C::*)(A1, A2, A3) const> Deduce(R (C::*)(A1, A2, A3) const)
+    { return Method3<C, R, A1, A2, A3, R (C::*)(A1, A2, A3) const>(); }
+
+    template <class C, class R, class A1, class A2, class A3, class A4>
+    Method4<C, R, A1, A2, A3, A4, R (C::*)(A1, A2, A3, A4)> Deduce(R (C::*)(A1, A2, A3, A4))
+    { return Method4<C, R, A1, A2, A3, A4, R (C::*)(A1, A2, A3, A4)>(); }
+
+    template <class C, class R, class A1, class A2, class A3, class A4>
+    Method4<C, R, A1, A2, A3, A4, R (C::*)(A1, A2, A3, A4) const>
+    Deduce(R (C::*)(A1, A2, A3, A4) const)
+    { return Method4<C, R, A1, A2, A3, A4, R (C::*)(A1, A2, A3, A4) const>(); }
+}
+
+#endif
@@ -0,0 +1,426 @@
+#include "LuaFFI.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "DinodeckLua.h"
+#include "DDLog.h"
+#include "LuaState.h"
+#include "Matrix.h"
+#include "Sprite.h"
+#include "Vector.h"
+
+static const char* VIEWS_KEY = "LuaFFI.Views";
+
+// Called with the C++ sizes of Vector, Matrix and Sprite.
+// Returns a table of view constructors by type name, or nil.
+static const char* VIEWS_SOURCE =
+    "local vectorSize, matrixSize, spriteSize = ...\n"
+    "local found, ffi = pcall(require, \"ffi\")\n"
+    "if not found then\n"
+    "    return nil\n"
+    "end\n"
+    "\n"
+    "ffi.cdef[[\n"
+    "typedef struct { double x, y, z, w; } dd_vector;\n"
+    "typedef struct { dd_vector col[4]; } dd_matrix;\n"
+    "typedef struct\n"
+    "{\n"
+    "    unsigned int textureIndex, textureGeneration;\n"
+    "    dd_vector colour;\n"
+    "    dd_vector position;\n"
+    "    dd_vector scale;\n"
+    "    double topLeftU, topLeftV, bottomRightU, bottomRightV;\n"
+    "    double rotation;\n"
+    "    const void* animation;\n"
+    "    double animationTime, animationStart, animationSpeed;\n"
+    "    bool opaque;\n"
+    "} dd_sprite;\n"
+    "]]\n"
+    "\n"
+    "if ffi.sizeof(\"dd_vector\") ~= vectorSize\n"
+    "or ffi.sizeof(\"dd_matrix\") ~= matrixSize\n"
+    "or ffi.sizeof(\"dd_sprite\") ~= spriteSize then\n"
+    "    return nil\n"
+    "end\n"
+    "\n"
+    "local cast = ffi.cast\n"
+    "local sqrt, cos, sin, rad = math.sqrt, math.cos, math.sin, math.rad\n"
+    "local vectorPtr = ffi.typeof(\"dd_vector*\")\n"
+    "local matrixPtr = ffi.typeof(\"dd_matrix*\")\n"
+    "local spritePtr = ffi.typeof(\"dd_sprite*\")\n"
+    "local vectorType = ffi.typeof(\"dd_vector\")\n"
+    "local matrixType = ffi.typeof(\"dd_matrix\")\n"
+    "\n"
+    "-- Userdata Vectors are accepted anywhere a view is.\n"
+    "local function xyzw(v)\n"
+    "    if type(v) == \"number\" then\n"
+    "        return v, v, v, v\n"
+    "    end\n"
+    "    if type(v) == \"userdata\" then\n"
+    "        v = cast(vectorPtr, v)\n"
+    "    end\n"
+    "    return v.x, v.y, v.z, v.w\n"
+    "end\n"
+    "\n"
+    "local function asMatrix(m)\n"
+    "    if type(m) == \"userdata\" then\n"
+    "        return cast(matrixPtr, m)\n"
+    "    end\n"
+    "    return m\n"
+    "end\n"
+    "\n"
+    "local Vector = {}\n"
+    "\n"
+    "function Vector:X() return self.x end\n"
+    "function Vector:Y() return self.y end\n"
+    "function Vector:Z() return self.z end\n"
+    "function Vector:W() return self.w end\n"
+    "function Vector:SetX(x) self.x = x end\n"
+    "function Vector:SetY(y) self.y = y end\n"
+    "function Vector:SetZ(z) self.z = z end\n"
+    "function Vector:SetW(w) self.w = w end\n"
+    "\n"
+    "function Vector:SetXyzw(x, y, z, w)\n"
+    "    self.x = x\n"
+    "    if y then self.y = y end\n"
+    "    if z then self.z = z end\n"
+    "    if w then self.w = w end\n"
+    "end\n"
+    "\n"
+    "function Vector:SetBroadcast(n)\n"
+    "    self.x, self.y, self.z, self.w = n, n, n, n\n"
+    "end\n"
+    "\n"
+    "function Vector:Copy(from)\n"
+    "    self.x, self.y, self.z, self.w = xyzw(from)\n"
+    "end\n"
+    "\n"
+    "function Vector:Add(left, right)\n"
+    "    local lx, ly, lz, lw = xyzw(left)\n"
+    "    local rx, ry, rz, rw = xyzw(right)\n"
+    "    self.x, self.y, self.z, self.w = lx + rx, ly + ry, lz + rz, lw + rw\n"
+    "    return self\n"
+    "end\n"
+    "\n"
+    "function Vector:Subtract(left, right)\n"
+    "    local lx, ly, lz, lw = xyzw(left)\n"
+    "    local rx, ry, rz, rw = xyzw(right)\n"
+    "    self.x, self.y, self.z, self.w = lx - rx, ly - ry, lz - rz, lw - rw\n"
+    "    return self\n"
+    "end\n"
+    "\n"
+    "function Vector:Multiply(left, right)\n"
+    "    local lx, ly, lz, lw = xyzw(left)\n"
+    "    local rx, ry, rz, rw = xyzw(right)\n"
+    "    self.x, self.y, self.z, self.w = lx * rx, ly * ry, lz * rz, lw * rw\n"
+    "    return self\n"
+    "end\n"
+    "\n"
+    "function Vector:Divide(left, right)\n"
+    "    local lx, ly, lz, lw = xyzw(left)\n"
+    "    local rx, ry, rz, rw = xyzw(right)\n"
+    "    if rx == 0 or ry == 0 or rz == 0 or rw == 0 then\n"
+    "        error(\"Divide by zero.\", 2)\n"
+    "    end\n"
+    "    self.x, self.y, self.z, self.w = lx / rx, ly / ry, lz / rz, lw / rw\n"
+    "    return self\n"
+    "end\n"
+    "\n"
+    "function Vector:MultiplyAdd(left, right, add)\n"
+    "    local lx, ly, lz, lw = xyzw(left)\n"
+    "    local rx, ry, rz, rw = xyzw(right)\n"
+    "    local ax, ay, az, aw = xyzw(add)\n"
+    "    self.x = lx * rx + ax\n"
+    "    self.y = ly * ry + ay\n"
+    "    self.z = lz * rz + az\n"
+    "    self.w = lw * rw + aw\n"
+    "    return self\n"
+    "end\n"
+    "\n"
+    "function Vector:AddInPlace(v) return Vector.Add(self, self, v) end\n"
+    "function Vector:SubtractInPlace(v) return Vector.Subtract(self, self, v) end\n"
+    "function Vector:MultiplyInPlace(v) return Vector.Multiply(self, self, v) end\n"
+    "function Vector:DivideInPlace(v) return Vector.Divide(self, self, v) end\n"
+    "\n"
+    "function Vector:NegateInPlace()\n"
+    "    self.x, self.y, self.z, self.w = -self.x, -self.y, -self.z, -self.w\n"
+    "    return self\n"
+    "end\n"
+    "\n"
+    "function Vector:Length2()\n"
+    "    return sqrt(self.x * self.x + self.y * self.y)\n"
+    "end\n"
+    "\n"
+    "function Vector:Length3()\n"
+    "    return sqrt(self.x * self.x + self.y * self.y + self.z * self.z)\n"
+    "end\n"
+    "\n"
+    "function Vector:Length4()\n"
+    "    return sqrt(self.x * self.x + self.y * self.y + self.z * self.z + self.w * self.w)\n"
+    "end\n"
+    "\n"
+    "function Vector:Normalize2()\n"
+    "    local length = Vector.Length2(self)\n"
+    "    self.x, self.y = self.x / length, self.y / length\n"
+    "end\n"
+    "\n"
+    "function Vector:Normalize3()\n"
+    "    local length = Vector.Length3(self)\n"
+    "    self.x, self.y, self.z = self.x / length, self.y / length, self.z / length\n"
+    "end\n"
+    "\n"
+    "function Vector:Normalize4()\n"
+    "    local length = Vector.Length4(self)\n"
+    "    self.x, self.y = self.x / length, self.y / length\n"
+    "    self.z, self.w = self.z / length, self.w / length\n"
+    "end\n"
+    "\n"
+    "function Vector:Dot2(v)\n"
+    "    local x, y = xyzw(v)\n"
+    "    return self.x * x + self.y * y\n"
+    "end\n"
+    "\n"
+    "function Vector:Dot3(v)\n"
+    "    local x, y, z = xyzw(v)\n"
+    "    return self.x * x + self.y * y + self.z * z\n"
+    "end\n"
+    "\n"
+    "function Vector:Dot4(v)\n"
+    "    local x, y, z, w = xyzw(v)\n"
+    "    return self.x * x + self.y * y + self.z * z + self.w * w\n"
+    "end\n"
+    "\n"
+    "function Vector:Cross(left, right)\n"
+    "    local lx, ly, lz = xyzw(left)\n"
+    "    local rx, ry, rz = xyzw(right)\n"
+    "    self.x = ly * rz - lz * ry\n"
+    "    self.y = lz * rx - lx * rz\n"
+    "    self.z = lx * ry - ly * rx\n"
+    "end\n"
+    "\n"
+    "ffi.metatype(vectorType,\n"
+    "{\n"
+    "    __index = Vector,\n"
+    "    __tostring = function(v)\n"
+    "        return string.format(\"%g, %g, %g, %g\", v.x, v.y, v.z, v.w)\n"
+    "    end\n"
+    "})\n"
+    "\n"
+    "local Matrix = {}\n"
+    "\n"
+    "function Matrix:SetColumn(index, x, y, z, w)\n"
+    "    if index < 1 or index > 4 then\n"
+    "        error(\"column index should be 1-4\", 2)\n"
+    "    end\n"
+    "    local column = self.col[index - 1]\n"
+    "    if type(x) == \"number\" then\n"
+    "        column.x, column.y, column.z, column.w = x, y or 0, z or 0, w or 0\n"
+    "    else\n"
+    "        column.x, column.y, column.z, column.w = xyzw(x)\n"
+    "    end\n"
+    "end\n"
+    "\n"
+    "function Matrix:SetTranslate(v)\n"
+    "    local column = self.col[3]\n"
+    "    column.x, column.y, column.z = xyzw(v)\n"
+    "    column.w = 1\n"
+    "end\n"
+    "\n"
+    "function Matrix:SetScale(v)\n"
+    "    local x, y, z = xyzw(v)\n"
+    "    self.col[0].x = x\n"
+    "    self.col[1].y = y\n"
+    "    self.col[2].z = z\n"
+    "    self.col[3].w = 1\n"
+    "end\n"
+    "\n"
+    "function Matrix:SetRotation(axis, angle)\n"
+    "    local x, y, z = xyzw(axis)\n"
+    "    local c = cos(rad(angle))\n"
+    "    local s = sin(rad(angle))\n"
+    "    local col0, col1, col2 = self.col[0], self.col[1], self.col[2]\n"
+    "    col0.x, col0.y, col0.z = x * x * (1 - c) + c, x * y * (1 - c) + z * s, x * z * (1 - c) - y * s\n"
+    "    col1.x, col1.y, col1.z = x * y * (1 - c) - z * s, y * y * (1 - c) + c, y * z * (1 - c) + x * s\n"
+    "    col2.x, col2.y, col2.z = x * z * (1 - c) + y * s, y * z * (1 - c) - x * s, z * z * (1 - c) + c\n"
+    "end\n"
+    "\n"
+    "-- destination = left * right, either side may be a number.\n"
+    "-- Works through a copy because destination may be left or right.\n"
+    "function Matrix:Multiply(left, right)\n"
+    "    if type(left) == \"number\" then\n"
+    "        left, right = right, left\n"
+    "    end\n"
+    "    left = asMatrix(left)\n"
+    "    if type(right) == \"number\" then\n"
+    "        for i = 0, 3 do\n"
+    "            local from, to = left.col[i], self.col[i]\n"
+    "            to.x, to.y, to.z, to.w = from.x * right, from.y * right, from.z * right, from.w * right\n"
+    "        end\n"
+    "        return\n"
+    "    end\n"
+    "    right = asMatrix(right)\n"
+    "    local l = matrixType(left[0])\n"
+    "    local r = matrixType(right[0])\n"
+    "    for i = 0, 3 do\n"
+    "        local rc, to = r.col[i], self.col[i]\n"
+    "        local c0, c1, c2, c3 = l.col[0], l.col[1], l.col[2], l.col[3]\n"
+    "        to.x = c0.x * rc.x + c1.x * rc.y + c2.x * rc.z + c3.x * rc.w\n"
+    "        to.y = c0.y * rc.x + c1.y * rc.y + c2.y * rc.z + c3.y * rc.w\n"
+    "        to.z = c0.z * rc.x + c1.z * rc.y + c2.z * rc.z + c3.z * rc.w\n"
+    "        to.w = c0.w * rc.x + c1.w * rc.y + c2.w * rc.z + c3.w * rc.w\n"
+    "    end\n"
+    "end\n"
+    "\n"
+    "ffi.metatype(matrixType, { __index = Matrix })\n"
+    "\n"
+    "local Sprite = {}\n"
+    "\n"
+    "-- Without an out vector this returns a view of the sprite's own position.\n"
+    "function Sprite:GetPosition(out)\n"
+    "    if out == nil then\n"
+    "        return self.position\n"
+    "    end\n"
+    "    Vector.Copy(type(out) == \"userdata\" and cast(vectorPtr, out) or out, self.position)\n"
+    "end\n"
+    "\n"
+    "function Sprite:SetPosition(x, y)\n"
+    "    local position = self.position\n"
+    "    if type(x) == \"number\" then\n"
+    "        position.x = x\n"
+    "        if y then position.y = y end\n"
+    "    else\n"
+    "        Vector.Copy(position, x)\n"
+    "    end\n"
+    "end\n"
+    "\n"
+    "function Sprite:GetScale(out)\n"
+    "    if out == nil then\n"
+    "        return self.scale\n"
+    "    end\n"
+    "    Vector.Copy(type(out) == \"userdata\" and cast(vectorPtr, out) or out, self.scale)\n"
+    "end\n"
+    "\n"
+    "function Sprite:SetScale(x, y)\n"
+    "    if type(x) == \"number\" then\n"
+    "        self.scale.x, self.scale.y = x, y or 0\n"
+    "    else\n"
+    "        Vector.Copy(self.scale, x)\n"
+    "    end\n"
+    "end\n"
+    "\n"
+    "function Sprite:GetColor(out)\n"
+    "    if out == nil then\n"
+    "        return self.colour\n"
+    "    end\n"
+    "    Vector.Copy(type(out) == \"userdata\" and cast(vectorPtr, out) or out, self.colour)\n"
+    "end\n"
+    "\n"
+    "function Sprite:SetColor(v)\n"
+    "    Vector.Copy(self.colour, v)\n"
+    "end\n"
+    "\n"
+    "function Sprite:SetUVs(topLeftU, topLeftV, bottomRightU, bottomRightV)\n"
+    "    self.topLeftU, self.topLeftV = topLeftU, topLeftV\n"
+    "    self.bottomRightU, self.bottomRightV = bottomRightU, bottomRightV\n"
+    "end\n"
+    "\n"
+    "function Sprite:GetRotation() return self.rotation end\n"
+    "function Sprite:SetRotation(degrees) self.rotation = degrees end\n"
+    "function Sprite:IsOpaque() return self.opaque end\n"
+    "function Sprite:SetOpaque(value) self.opaque = value end\n"
+    "\n"
+    "ffi.metatype(\"dd_sprite\", { __index = Sprite })\n"
+    "\n"
+    "return\n"
+    "{\n"
+    "    Vector = function(v) return cast(vectorPtr, v) end,\n"
+    "    Matrix = function(m) return cast(matrixPtr, m) end,\n"
+    "    Sprite = function(s) return cast(spritePtr, s) end,\n"
+    "}\n";
+
+static int lua_identity_view(lua_State* state)
+{
+    lua_settop(state, 1);
+    return 1;
+}
+
+//
+// Leaves the table of views, or false, on the stack.
+//
+static void PushViews(lua_State* state)
+{
+    lua_getfield(state, LUA_REGISTRYINDEX, VIEWS_KEY);
+    if(!lua_isnil(state, -1))
+    {
+        return;
+    }
+    lua_pop(state, 1);
+
+    bool loaded = luaL_loadbuffer(state, VIEWS_SOURCE, strlen(VIEWS_SOURCE), "LuaFFI") == 0;
+    if(loaded)
+    {
+        lua_pushinteger(state, sizeof(Vector));
+        lua_pushinteger(state, sizeof(Matrix));
+        lua_pushinteger(state, sizeof(Sprite));
+        loaded = lua_pcall(state, 3, 1, 0) == 0;
+    }
+
+    // Naming Sprite can bind it on first use, which loads the views itself.
+    lua_getfield(state, LUA_REGISTRYINDEX, VIEWS_KEY);
+    if(!lua_isnil(state, -1))
+    {
+        lua_remove(state, -2);
+        return;
+    }
+    lua_pop(state, 1);
+
+    if(!loaded)
+    {
+        dsprintf("FFI views failed to load: %s\n", lua_tostring(state, -1));
+        lua_pop(state, 1);
+        lua_pushnil(state);
+    }
+
+    if(lua_isnil(state, -1))
+    {
+        lua_pop(state, 1);
+        lua_pushboolean(state, 0);
+    }
+
+    lua_pushvalue(state, -1);
+    lua_setfield(state, LUA_REGISTRYINDEX, VIEWS_KEY);
+}
+
+void LuaFFI::BindView(LuaState* luaState, const char* typeName)
+{
+    assert(typeName);
+    lua_State* state = luaState->State();
+
+    lua_getglobal(state, typeName);
+    if(!lua_istable(state, -1))
+    {
+        lua_pop(state, 1);
+        return;
+    }
+
+    PushViews(state); // type, views
+    bool found = false;
+    if(lua_istable(state, -1))
+    {
+        lua_getfield(state, -1, typeName);
+        found = lua_isfunction(state, -1);
+        if(!found)
+        {
+            lua_pop(state, 1);
+        }
+    }
+
+    if(!found)
+    {
+        lua_pushcfunction(state, lua_identity_view);
+    }
+
+    lua_setfield(state, -3, "View");
+    lua_pop(state, 2); // views, type
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef LUAFFI_H
+#define LUAFFI_H
+
+class LuaState;
+
+//
+// LuaJIT FFI views over the Vector, Matrix and Sprite userdata.
+// Type.View(object) returns a cdata pointer onto the object's memory with
+// the same methods as the C bindings, written in Lua so the JIT can trace
+// through them. The pointer doesn't keep the object alive, hold on to the
+// userdata for as long as the view is used.
+//
+// Without the FFI, or if the struct layouts don't match the C++ classes,
+// View returns the object itself and the C bindings are used as before.
+//
+class LuaFFI
+{
+public:
+    static void BindView(LuaState* state, const char* typeName);
+};
+
+#endif
\ No newline at end of file
@@ -2,17 +2,112 @@
 #include <assert.h>
 #include <string.h>
 
+#include "AssetReport.h"
 #include "DinodeckLua.h"
 #include "DDFile.h"
 #include "DDLog.h"
+#include "DDTime.h"
+#include "reflect/Reflect.h"
+#include "Zones.h"
 
 
 
+static const RegistryKey WRAPPER_KEY("this");
+static const char* PRISTINE_KEY = "LuaState.Pristine";
+
+static int AbsIndex(lua_State* state, int index)
+{
+    if(index < 0 && index > LUA_REGISTRYINDEX)
+    {
+        return lua_gettop(state) + index + 1;
+    }
+    return index;
+}
+
+//
+// Leaves a shallow copy of the table at index on the stack.
+//
+static void PushCopy(lua_State* state, int index)
+{
+    index = AbsIndex(state, index);
+    lua_newtable(state);
+    lua_pushnil(state);
+    while(lua_next(state, index) != 0)
+    {
+        lua_pushvalue(state, -2);   // copy, key, value, key
+        lua_insert(state, -2);      // copy, key, key, value
+        lua_rawset(state, -4);
+    }
+}
+
+//
+// Makes the table at index hold what the copy did. If numbersOnly, keys
+// that aren't numbers are left alone, that's how the registry's refs are
+// rewound without losing its metatables.
+//
+static void RestoreTable(lua_State* state, int index, int copyIndex, bool numbersOnly)
+{
+    index = AbsIndex(state, index);
+    copyIndex = AbsIndex(state, copyIndex);
+
+    // Clearing fields that exist is allowed mid traversal.
+    lua_pushnil(state);
+    while(lua_next(state, index) != 0)
+    {
+        lua_pop(state, 1);
+        if(numbersOnly && lua_type(state, -1) != LUA_TNUMBER)
+        {
+            continue;
+        }
+        lua_pushvalue(state, -1);
+        lua_rawget(state, copyIndex);
+        if(lua_isnil(state, -1))
+        {
+            lua_pushvalue(state, -2);
+            lua_pushnil(state);
+            lua_rawset(state, index);
+        }
+        lua_pop(state, 1);
+    }
+
+    lua_pushnil(state);
+    while(lua_next(state, copyIndex) != 0)
+    {
+        if(numbersOnly && lua_type(state, -2) != LUA_TNUMBER)
+        {
+            lua_pop(state, 1);
+            continue;
+        }
+        lua_pushvalue(state, -2);
+        lua_insert(state, -2);
+        lua_rawset(state, index);
+    }
+}
+
+RegistryKey::RegistryKey(const char* name) :
+    mName(name)
+{
+    RegistryKey::All().push_back(this);
+}
+
+std::vector<const RegistryKey*>& RegistryKey::All()
+{
+   static std::vector<const RegistryKey*>* keys = new std::vector<const RegistryKey*>();
+   return *keys;
+}
+
 LuaState::LuaState(const char* name) :
     mName(name),
-    mLuaState(NULL)
+    mLuaState(NULL),
+    mAllocator(),
+    mUsingAllocator(false),
+    mBytecodeCache(),
+    mGCMode(GC_FULL),
+    mGCStepMicroseconds(DEFAULT_GC_STEP_MICROSECONDS),
+    mLastGCMs(0),
+    mHasPristine(false),
+    mBound()
 {
-    // lua_newstate( MemHandler, NULL ); <- can use this to get some mem stats
     Reset();
 }
 
@@ -25,7 +120,7 @@ LuaState::~LuaState()
 
 LuaState* LuaState::GetWrapper(lua_State* luaState)
 {
-    LuaState* out = static_cast<LuaState*>(LuaState::GetFromRegistry(luaState, "this"));
+    LuaState* out = static_cast<LuaState*>(LuaState::GetFromRegistry(luaState, WRAPPER_KEY));
     assert(luaState);
     return out;
 }
@@ -79,6 +174,12 @@ void LuaState::OnError()
     return;
 }
 
+int LuaState::LuaPanic(lua_State* luaState)
+{
+    dsprintf("PANIC: unprotected error in call to Lua API (%s)\n", lua_tostring(luaState, -1));
+    return 0;
+}
+
 lua_State* LuaState::State() const
 {
 	return mLuaState;
@@ -91,6 +192,7 @@ unsigned int LuaState::ItemsInStack()
 
 bool LuaState::DoString(const char* str)
 {
+	DD_PROFILE_ZONE("DoString");
 	// Does this leave the stack messy in case or error (probaby doesn't matter!)
 	lua_pushcfunction(mLuaState, LuaState::LuaError);
 	int fail = luaL_loadstring(mLuaState, str);
@@ -123,12 +225,12 @@ bool LuaState::DoBuffer(const char* name, const char* buffer, unsigned int size)
 
     // This is pushed for the pcall below. (Doesn't do syntax errors)
     lua_pushcfunction(mLuaState, LuaState::LuaError);
-    int fail = luaL_loadbuffer
+    int fail = mBytecodeCache.Load
     (
         mLuaState,
+        name,
         buffer,
-        size,
-        name
+        size
     );
 
     if(fail)
@@ -151,9 +253,16 @@ bool LuaState::DoBuffer(const char* name, const char* buffer, unsigned int size)
 
 bool LuaState::DoFile(const char* path)
 {
+    unsigned long long start = DDTime::Microseconds();
     DDFile file(path);
-    file.LoadFileIntoBuffer();
-    return DoBuffer(path, file.Buffer(), file.Size());
+    file.LoadFileView();
+    unsigned long long read = DDTime::Microseconds();
+    AssetReport::AddRead(AssetReport::Current(), file.Size(), read - start);
+
+    // Compiling and running the chunk counts as its decode.
+    bool result = DoBuffer(path, file.Buffer(), file.Size());
+    AssetReport::AddDecode(AssetReport::Current(), DDTime::Microseconds() - read);
+    return result;
 }
 
 std::string LuaState::GetString(const char* key, const char* defaultStr)
@@ -189,7 +298,28 @@ void LuaState::Reset()
         lua_close(mLuaState);
         mLuaState = NULL;
     }
-    mLuaState = lua_open();
+    mAllocator.Clear();
+    mHasPristine = false;
+    mBound.clear();
+
+    // 64 bit LuaJIT needs its own allocator to keep GC objects in the
+    // low 2GB, it refuses any other.
+    mUsingAllocator = false;
+    if(sizeof(void*) == 4)
+    {
+        mLuaState = lua_newstate(LuaAllocator::Alloc, &mAllocator);
+        mUsingAllocator = mLuaState != NULL;
+    }
+
+    if(mUsingAllocator)
+    {
+        // luaL_newstate would have set this
+        lua_atpanic(mLuaState, LuaState::LuaPanic);
+    }
+    else
+    {
+        mLuaState = lua_open();
+    }
     luaL_openlibs(mLuaState);
     // Push object instance pointer in the lua state
     // So for static functions (used by Lua) we can retrieve this object associated with a lua state
@@ -203,6 +333,141 @@ void LuaState::Reset()
     {
         _InjectIntoRegistry((*iter).first.c_str(), (*iter).second);
     }
+    ApplyGCMode();
+}
+
+void LuaState::MarkPristine()
+{
+    int top = lua_gettop(mLuaState);
+    lua_newtable(mLuaState);
+    int pristine = lua_gettop(mLuaState);
+
+    PushCopy(mLuaState, LUA_GLOBALSINDEX);
+    lua_setfield(mLuaState, pristine, "globals");
+    PushCopy(mLuaState, LUA_REGISTRYINDEX);
+    lua_setfield(mLuaState, pristine, "registry");
+    if(lua_getmetatable(mLuaState, LUA_GLOBALSINDEX))
+    {
+        lua_setfield(mLuaState, pristine, "globalsMeta");
+    }
+
+    // Scripts add to string, math, package.loaded and the like, so their
+    // tables are rewound too.
+    lua_newtable(mLuaState);
+    int tables = lua_gettop(mLuaState);
+    lua_pushnil(mLuaState);
+    while(lua_next(mLuaState, LUA_GLOBALSINDEX) != 0)
+    {
+        if(lua_istable(mLuaState, -1) && !lua_rawequal(mLuaState, -1, LUA_GLOBALSINDEX))
+        {
+            PushCopy(mLuaState, -1);
+            lua_rawset(mLuaState, tables);
+        }
+        else
+        {
+            lua_pop(mLuaState, 1);
+        }
+    }
+
+    lua_getfield(mLuaState, LUA_REGISTRYINDEX, "_LOADED");
+    if(lua_istable(mLuaState, -1))
+    {
+        PushCopy(mLuaState, -1);
+        lua_rawset(mLuaState, tables);
+    }
+    else
+    {
+        lua_pop(mLuaState, 1);
+    }
+    lua_setfield(mLuaState, pristine, "tables");
+
+    lua_setfield(mLuaState, LUA_REGISTRYINDEX, PRISTINE_KEY);
+    lua_settop(mLuaState, top);
+    mHasPristine = true;
+}
+
+bool LuaState::Restore()
+{
+    if(!mHasPristine)
+    {
+        return false;
+    }
+
+    lua_settop(mLuaState, 0);
+    lua_getfield(mLuaState, LUA_REGISTRYINDEX, PRISTINE_KEY);
+    const int pristine = 1;
+
+    lua_getfield(mLuaState, pristine, "globals");
+    RestoreTable(mLuaState, LUA_GLOBALSINDEX, -1, false);
+    lua_getfield(mLuaState, pristine, "globalsMeta"); // nil clears it
+    lua_setmetatable(mLuaState, LUA_GLOBALSINDEX);
+
+    // Only refs are undone, named metatables and caches stay bound.
+    lua_getfield(mLuaState, pristine, "registry");
+    RestoreTable(mLuaState, LUA_REGISTRYINDEX, -1, true);
+
+    lua_getfield(mLuaState, pristine, "tables");
+    lua_pushnil(mLuaState);
+    while(lua_next(mLuaState, -2) != 0)
+    {
+        RestoreTable(mLuaState, -2, -1, false);
+        lua_pop(mLuaState, 1);
+    }
+    lua_settop(mLuaState, 0);
+
+    // Twice, so what the first pass finalized is freed too.
+    lua_gc(mLuaState, LUA_GCCOLLECT, 0);
+    lua_gc(mLuaState, LUA_GCCOLLECT, 0);
+    ApplyGCMode();
+    return true;
+}
+
+bool LuaState::IsBound(const Reflect* reflect) const
+{
+    for(std::vector<const Reflect*>::const_iterator it = mBound.begin();
+        it != mBound.end();
+        ++it)
+    {
+        if(*it == reflect)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LuaState::MarkBound(const Reflect* reflect)
+{
+    assert(reflect);
+    mBound.push_back(reflect);
+    if(!mHasPristine)
+    {
+        return;
+    }
+
+    int top = lua_gettop(mLuaState);
+    lua_getglobal(mLuaState, reflect->Name().c_str());
+    if(lua_isnil(mLuaState, -1))
+    {
+        lua_settop(mLuaState, top);
+        return;
+    }
+    int library = lua_gettop(mLuaState);
+
+    lua_getfield(mLuaState, LUA_REGISTRYINDEX, PRISTINE_KEY);
+    int pristine = lua_gettop(mLuaState);
+    lua_getfield(mLuaState, pristine, "globals");
+    lua_pushvalue(mLuaState, library);
+    lua_setfield(mLuaState, -2, reflect->Name().c_str());
+
+    if(lua_istable(mLuaState, library))
+    {
+        lua_getfield(mLuaState, pristine, "tables");
+        lua_pushvalue(mLuaState, library);
+        PushCopy(mLuaState, library);
+        lua_rawset(mLuaState, -3);
+    }
+    lua_settop(mLuaState, top);
 }
 
 void LuaState::CollectGarbage()
@@ -210,11 +475,100 @@ void LuaState::CollectGarbage()
     lua_gc(mLuaState, LUA_GCCOLLECT, 0);
 }
 
+bool LuaState::ParseGCMode(const std::string& name, eGCMode* mode)
+{
+    if(name == "full")
+    {
+        *mode = GC_FULL;
+    }
+    else if(name == "incremental")
+    {
+        *mode = GC_INCREMENTAL;
+    }
+    else if(name == "manual")
+    {
+        *mode = GC_MANUAL;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+void LuaState::SetGCMode(eGCMode mode, unsigned int stepMicroseconds)
+{
+    mGCStepMicroseconds = stepMicroseconds;
+    if(mGCMode == mode)
+    {
+        return;
+    }
+    mGCMode = mode;
+    ApplyGCMode();
+}
+
+void LuaState::ApplyGCMode()
+{
+    // Lua's own collector, paced by allocation, runs in every mode but
+    // manual. The frame steps only add to it.
+    lua_gc(mLuaState, mGCMode == GC_MANUAL ? LUA_GCSTOP : LUA_GCRESTART, 0);
+}
+
+void LuaState::FrameGarbage()
+{
+    const unsigned long long start = DDTime::Microseconds();
+
+    if(mGCMode == GC_FULL)
+    {
+        CollectGarbage();
+    }
+    else if(mGCMode == GC_INCREMENTAL)
+    {
+        // Basic steps until the budget's spent or the cycle finishes, so
+        // a large heap is collected over several frames.
+        while(DDTime::Microseconds() - start < mGCStepMicroseconds)
+        {
+            if(lua_gc(mLuaState, LUA_GCSTEP, 0) == 1)
+            {
+                break;
+            }
+        }
+    }
+
+    mLastGCMs = (DDTime::Microseconds() - start) / 1000.0;
+    mAllocator.EndFrame();
+}
+
+LuaAllocator::Stats LuaState::LastFrameHeap()
+{
+    if(mUsingAllocator)
+    {
+        return mAllocator.LastFrame();
+    }
+
+    LuaAllocator::Stats stats;
+    stats.bytes = lua_gc(mLuaState, LUA_GCCOUNT, 0) * 1024
+                + lua_gc(mLuaState, LUA_GCCOUNTB, 0);
+    stats.peakBytes = stats.bytes;
+    return stats;
+}
+
 void LuaState::_InjectIntoRegistry(const char* key, void* object)
 {
     lua_pushlstring(mLuaState, key, strlen(key));
     lua_pushlightuserdata(mLuaState, object);       /* push value */
     lua_settable(mLuaState, LUA_REGISTRYINDEX);     /* registry[key] = value */
+
+    std::vector<const RegistryKey*>& keys = RegistryKey::All();
+    for(std::vector<const RegistryKey*>::iterator it = keys.begin(); it != keys.end(); ++it)
+    {
+        if(strcmp((*it)->Name(), key) == 0)
+        {
+            lua_pushlightuserdata(mLuaState, (void*) *it);
+            lua_pushlightuserdata(mLuaState, object);
+            lua_rawset(mLuaState, LUA_REGISTRYINDEX);
+        }
+    }
 }
 
 void LuaState::InjectIntoRegistry(const char* key, void* object)
@@ -239,11 +593,30 @@ void* LuaState::GetFromRegistry(lua_State* state, const char* key)
     return object;
 }
 
+void* LuaState::GetFromRegistry(lua_State* state, const RegistryKey& key)
+{
+    lua_pushlightuserdata(state, (void*) &key);
+    lua_rawget(state, LUA_REGISTRYINDEX);
+    void* object = lua_touserdata(state, -1);
+    lua_pop(state, 1);
+    return object;
+}
+
 void LuaState::Bind(const std::string& name, const luaL_Reg* luaBinding)
 {
     const char* id = name.c_str();
     lua_newtable(mLuaState);
     luaL_newmetatable(mLuaState, id);
+
+    // Also keep the metatable under a lightuserdata key for IsType.
+    Reflect* reflect = Reflect::Find(id);
+    if(reflect != NULL)
+    {
+        lua_pushlightuserdata(mLuaState, (void*) reflect);
+        lua_pushvalue(mLuaState, -2);
+        lua_rawset(mLuaState, LUA_REGISTRYINDEX);
+    }
+
     luaL_register(mLuaState, NULL, luaBinding);
     lua_pushliteral(mLuaState, "__index");
     lua_pushvalue(mLuaState, -2);
@@ -278,24 +651,70 @@ bool LuaState::IsType(lua_State* state, int arg, const char* type_name)
         lua_getfield(state, LUA_REGISTRYINDEX, type_name);
 
         // Do metatables match?
-        if(lua_rawequal(state, -1, -2))
-        {
-            // Remove metatables
-            lua_pop(state, 2);
-            return true;
-        }
+        bool match = lua_rawequal(state, -1, -2);
+        lua_pop(state, 2); // Remove metatables
+        return match;
     }
     return false;
 }
 
-void LuaState::CallRegisteredFunction(int index)
+bool LuaState::IsType(lua_State* state, int arg, const Reflect& meta)
+{
+    if(NULL == lua_touserdata(state, arg) || !lua_getmetatable(state, arg))
+    {
+        return false;
+    }
+
+    lua_pushlightuserdata(state, (void*) &meta);
+    lua_rawget(state, LUA_REGISTRYINDEX);
+    bool match = lua_rawequal(state, -1, -2);
+    lua_pop(state, 2);
+    return match;
+}
+
+int LuaState::RegisterChunk(const char* name, const char* source)
+{
+    int top = lua_gettop(mLuaState);
+    if(luaL_loadbuffer(mLuaState, source, strlen(source), name) != 0)
+    {
+        OnError();
+        lua_settop(mLuaState, top);
+        return LUA_NOREF;
+    }
+    return luaL_ref(mLuaState, LUA_REGISTRYINDEX);
+}
+
+bool LuaState::CallRegisteredFunction(int index)
+{
+    lua_pushcfunction(mLuaState, LuaState::LuaError);
+    lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, index);
+    bool result = lua_pcall(mLuaState, 0, 0, -2) == 0;
+    lua_pop(mLuaState, 1); // remove error function
+    return result;
+}
+
+bool LuaState::CallRegisteredFunction(int index, double arg)
 {
     lua_pushcfunction(mLuaState, LuaState::LuaError);
     lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, index);
-    lua_pcall(mLuaState, 0, 0, -2);
+    lua_pushnumber(mLuaState, arg);
+    bool result = lua_pcall(mLuaState, 1, 0, -3) == 0;
     lua_pop(mLuaState, 1); // remove error function
+    return result;
 }
 
+bool LuaState::CallRegisteredFunctionWithTop(int index)
+{
+    // The error function and the function go under the argument.
+    lua_pushcfunction(mLuaState, LuaState::LuaError);
+    lua_insert(mLuaState, -2);
+    lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, index);
+    lua_insert(mLuaState, -2);
+    bool result = lua_pcall(mLuaState, 1, 0, -3) == 0;
+    lua_pop(mLuaState, 1); // remove error function
+    return result;
+}
+
 void LuaState::CallRegisteredFunction(int index, std::string& data)
 {
     lua_pushcfunction(mLuaState, LuaState::LuaError);
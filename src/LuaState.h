@@ -5,32 +5,76 @@
 #include <vector>
 
 #include "DinodeckLua.h"
+#include "BytecodeCache.h"
+#include "LuaAllocator.h"
+
+class Reflect;
+
+//
+// A registry entry looked up by the key's address, a lightuserdata,
+// rather than by pushing and hashing its name. Declare one statically
+// per injected name and anything injected under that name is stored
+// under the key too.
+//
+class RegistryKey
+{
+    const char* mName;
+public:
+    explicit RegistryKey(const char* name);
+    const char* Name() const { return mName; }
+    static std::vector<const RegistryKey*>& All();
+};
 
 class LuaState
 {
+public:
+    enum eGCMode
+    {
+        GC_FULL,        // a full collect each frame
+        GC_INCREMENTAL, // steps each frame for up to a time budget
+        GC_MANUAL,      // stopped, scripts call collectgarbage themselves
+    };
 private:
 	const char* mName;
 	lua_State* mLuaState;
+    LuaAllocator mAllocator;
+    bool mUsingAllocator; // false where the state needs Lua's own allocator
+    BytecodeCache mBytecodeCache; // outlives Reset, that's where it pays
+    eGCMode mGCMode;
+    unsigned int mGCStepMicroseconds;
+    double mLastGCMs;
+    void ApplyGCMode();
 	std::vector<std::pair<std::string, void*> > mInjections;
+    bool mHasPristine;
+    std::vector<const Reflect*> mBound; // libraries bound since Reset
     std::string mLastError;
     std::string mLastErrorCallstack;
 
 	// Lua static C style callback to be routed to LuaState's instance OnError function
 	static int LuaError(lua_State* luaState);
+    static int LuaPanic(lua_State* luaState);
 
 	void OnError();
 	// Doesn't try and cache the injection
 	void _InjectIntoRegistry(const char* key, void* value);
 public:
+    static const unsigned int DEFAULT_GC_STEP_MICROSECONDS = 1000;
+
 	// Get lua_State's wrapper instance of class LuaState
 	static LuaState* GetWrapper(lua_State* luaState);
 	static void* GetFromRegistry(lua_State* state, const char* key);
+	static void* GetFromRegistry(lua_State* state, const RegistryKey& key);
 	template <class T>
 	static T* GetFuncParam(lua_State* state, int argNumber);
 	template <class T>
 	static T** GetFuncParamPtr(lua_State* state, int argNumber);
 	static const char* GetParam(lua_State* state, int argNumber);
     static bool IsType(lua_State* state, int arg, const char* tname);
+    // Compares against the metatable cached under the Reflect's address
+    // when the type was bound, so there's no string lookup.
+    static bool IsType(lua_State* state, int arg, const Reflect& meta);
+    template <class T>
+    static bool IsType(lua_State* state, int arg) { return IsType(state, arg, T::Meta); }
 
 
 	LuaState(const char* name);
@@ -40,6 +84,7 @@ public:
 	bool DoString(const char* str);
 	bool DoFile(const char* filepath);
 	bool DoBuffer(const char* name, const char* buffer, unsigned int size);
+    BytecodeCache& GetBytecodeCache() { return mBytecodeCache; }
 
 	// Not sure about this approach.
 	int GetInt(const char* key, int defaultInt);
@@ -49,8 +94,25 @@ public:
 	unsigned int ItemsInStack();
 	void Bind(const std::string& name, const luaL_Reg* luaBinding);
 	void CollectGarbage();
+    // full, incremental or manual, see eGCMode. False for anything else.
+    static bool ParseGCMode(const std::string& name, eGCMode* mode);
+    void SetGCMode(eGCMode mode, unsigned int stepMicroseconds);
+    // Collects as the GC mode says, call once a frame.
+    void FrameGarbage();
+    double LastGCMs() const { return mLastGCMs; }
+    unsigned int HeapKB() { return lua_gc(mLuaState, LUA_GCCOUNT, 0); }
+    // Heap use over the last frame. Only bytes are known without the
+    // pooled allocator.
+    LuaAllocator::Stats LastFrameHeap();
 	void InjectIntoRegistry(const char* key, void* value);
-    void CallRegisteredFunction(int index);
+    // Compiles the source into a function kept in the registry, so it can
+    // be called without being parsed again. LUA_NOREF on a syntax error.
+    int RegisterChunk(const char* name, const char* source);
+    bool CallRegisteredFunction(int index);
+    // The chunk gets the number as its ... argument.
+    bool CallRegisteredFunction(int index, double arg);
+    // Pops the value on top of the stack and passes it as the argument.
+    bool CallRegisteredFunctionWithTop(int index);
     void CallRegisteredFunction(int index, std::string& data);
 
 	void* GetFromRegistry(const char* key)
@@ -58,6 +120,17 @@ public:
 		return GetFromRegistry(mLuaState, key);
 	}
 	void Reset();
+    // Remembers the globals, the registry's refs and the standard
+    // libraries' tables as they are now, so Restore can return to them.
+    void MarkPristine();
+    bool HasPristine() const { return mHasPristine; }
+    // Back to the pristine state without closing it, keeping the libraries
+    // bound since. Much cheaper than Reset and binding everything again.
+    // False, and nothing done, if MarkPristine hasn't been called.
+    bool Restore();
+    bool IsBound(const Reflect* reflect) const;
+    // The library's global is kept, and rewound, by Restore.
+    void MarkBound(const Reflect* reflect);
 
     const std::string& GetLastError() const { return mLastError; }
     const std::string& GetLastErrorCallstack() const { return mLastErrorCallstack; }
@@ -68,7 +141,7 @@ public:
 template <class T>
 T* LuaState::GetFuncParam(lua_State* state, int argNumber)
 {
-    if(!lua_isuserdata(state, argNumber) || !luaL_checkudata (state, argNumber,  T::Meta.Name().c_str()))
+    if(!IsType(state, argNumber, T::Meta))
     {
         luaL_typerror(state, argNumber, T::Meta.Name().c_str());
         return NULL;
@@ -80,7 +153,7 @@ T* LuaState::GetFuncParam(lua_State* state, int argNumber)
 template <class T>
 T** LuaState::GetFuncParamPtr(lua_State* state, int argNumber)
 {
-    if(!lua_isuserdata(state, argNumber) || !luaL_checkudata (state, argNumber,  T::Meta.Name().c_str()))
+    if(!IsType(state, argNumber, T::Meta))
     {
         luaL_typerror(state, argNumber, T::Meta.Name().c_str());
         return NULL;
@@ -1,32 +1,51 @@
 #include "Main.h"
 #include <stdio.h>
+#include <algorithm>
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include "AssetReport.h"
 #include "Dinodeck.h"
 #include "DinodeckGL.h"
 #include "DDLog.h"
+#include "DDTime.h"
+#include "DrawCapture.h"
+#include "FrameArena.h"
 #include "Game.h"
+#include "LogRing.h"
+#include "GraphicsPipeline.h"
+#include "input/Gamepad.h"
 #include "input/Keyboard.h"
 #include "input/Mouse.h"
+#include "JitMonitor.h"
+#include "DDPack.h"
 #include "physfs.h"
+#include "Profiler.h"
 #include "SDL/SDL.h"
 #include "Settings.h"
+#include "StartupTimer.h"
 #include "Webserver.h"
 #include "LuaState.h"
+#include "Metrics.h"
+#include "MicroBench.h"
 #include "util/Lerp.h"
+#include "Zones.h"
 
 Main::Main() :
   mSurface(0),
   mRunning(true),
   mDinodeck(NULL),
   mWebServer(NULL),
-  mDoWebServerReset(false),
-  mDoLuaExecute(false),
-  mLuaToExecute()
+  mOffscreen(false),
+  mMicroBench(false),
+  mExitAfterStartup(false),
+  mWebCommands()
 {
     mDinodeck = new Dinodeck("Dinodeck");
     mDinodeck->SetScreenChangeListener(this);
+    StartupTimer::Mark("engine");
 }
 
 Main::~Main()
@@ -41,6 +60,9 @@ Main::~Main()
 
 void Main::OnEvent(SDL_Event* event)
 {
+    // Anything that comes in might change what's on screen.
+    mDinodeck->RequestRedraw(1);
+
     switch(event->type)
     {
         case SDL_QUIT:
@@ -55,20 +77,42 @@ void Main::OnEvent(SDL_Event* event)
                 Reset();
             }
 
+            if(event->key.keysym.sym == SDLK_F3)
+            {
+                mDinodeck->GetFrameHud()->Toggle();
+            }
+
+            if(event->key.keysym.sym == SDLK_F4)
+            {
+                mDinodeck->SetShowOverdraw(!mDinodeck->IsShowingOverdraw());
+            }
+
+            if(mInputRecord.IsReplaying())
+            {
+                break;
+            }
+
             Game* game = mDinodeck->GetGame();
             assert(game);
             Keyboard* keyboard = game->GetKeyboard();
             assert(keyboard);
             keyboard->OnKeyDownEvent(event->key.keysym.sym);
+            mInputRecord.OnKeyDown(event->key.keysym.sym);
         } break;
 
         case SDL_KEYUP:
         {
+            if(mInputRecord.IsReplaying())
+            {
+                break;
+            }
+
             Game* game = mDinodeck->GetGame();
             assert(game);
             Keyboard* keyboard = game->GetKeyboard();
             assert(keyboard);
             keyboard->OnKeyUpEvent(event->key.keysym.sym);
+            mInputRecord.OnKeyUp(event->key.keysym.sym);
         } break;
 
     }
@@ -82,6 +126,13 @@ bool Main::ResetRenderWindow()
     unsigned int width = mDinodeck->DisplayWidth();
     unsigned int height = mDinodeck->DisplayHeight();
 
+    // Only read when the video mode is set.
+    const bool vsync = mDinodeck->GetSettings().vsync && !mBenchmark.IsRunning();
+    SDL_GL_SetAttribute(SDL_GL_SWAP_CONTROL, vsync ? 1 : 0);
+    const int samples = mDinodeck->WindowSamples();
+    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, samples > 0 ? 1 : 0);
+    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, samples);
+
     // SDL handles this surface memory, so it can be called multiple times without issue.
     mSurface = SDL_SetVideoMode(
         width,
@@ -98,6 +149,14 @@ bool Main::ResetRenderWindow()
     // Textures may need reloading, mark them as not loaded.
     mDinodeck->OpenGLContextReset();
 
+    int swapControl = 0;
+    if(vsync
+       && (SDL_GL_GetAttribute(SDL_GL_SWAP_CONTROL, &swapControl) != 0
+           || swapControl != 1))
+    {
+        dsprintf("Vsync isn't available, only frame_rate paces frames.\n");
+    }
+
     SDL_WarpMouse(width/2, mDinodeck->DisplayHeight()/2);
     return true;
 }
@@ -124,6 +183,11 @@ void Main::OnOpenGLContextCreated()
 
 void Main::HandleInput()
 {
+    if(mInputRecord.IsReplaying())
+    {
+        return;
+    }
+
     int mouseX;
     int mouseY;
     int mouseState = SDL_GetMouseState(&mouseX, &mouseY);
@@ -147,7 +211,69 @@ void Main::HandleInput()
     assert(game);
     Mouse* mouse = game->GetMouse();
     assert(mouse);
-    mouse->OnMouseEvent(mouseX, mouseY, leftDown, middleDown, rightDown);
+    mouse->OnMouseEvent(mouseX, mouseY, leftDown, middleDown, rightDown);
+    mInputRecord.OnMouse(mouseX, mouseY, leftDown, middleDown, rightDown);
+}
+
+void Main::SetBenchmark(unsigned int frames, bool offscreen)
+{
+    mBenchmark.Start(frames);
+    mOffscreen = offscreen;
+    mDinodeck->SetOffscreen(offscreen);
+}
+
+void Main::OpenGamepads()
+{
+    const int count = std::min(SDL_NumJoysticks(), (int) Gamepad::MAX_PADS);
+    Gamepad* gamepad = mDinodeck->GetGame()->GetGamepad();
+
+    for(int i = 0; i < count; i++)
+    {
+        SDL_Joystick* joystick = SDL_JoystickOpen(i);
+        if(joystick == NULL)
+        {
+            continue;
+        }
+
+        gamepad->Connect(mJoysticks.size(),
+                         SDL_JoystickName(i),
+                         SDL_JoystickNumAxes(joystick),
+                         SDL_JoystickNumButtons(joystick));
+        dsprintf("Gamepad [%s] connected.\n", SDL_JoystickName(i));
+        mJoysticks.push_back(joystick);
+    }
+}
+
+//
+// One update for all the pads then a copy of every axis and button, so
+// the scripts' reads don't go back to SDL.
+//
+void Main::PollGamepads()
+{
+    if(mJoysticks.empty() || mInputRecord.IsReplaying())
+    {
+        return;
+    }
+
+    SDL_JoystickUpdate();
+    Gamepad* gamepad = mDinodeck->GetGame()->GetGamepad();
+
+    for(unsigned int i = 0; i < mJoysticks.size(); i++)
+    {
+        SDL_Joystick* joystick = mJoysticks[i];
+        const Gamepad::Pad& pad = gamepad->GetPad(i);
+
+        for(unsigned int axis = 0; axis < pad.axisCount; axis++)
+        {
+            Sint16 value = SDL_JoystickGetAxis(joystick, axis);
+            gamepad->SetAxis(i, axis, value / 32767.0f);
+        }
+
+        for(unsigned int button = 0; button < pad.buttonCount; button++)
+        {
+            gamepad->SetButton(i, button, SDL_JoystickGetButton(joystick, button) != 0);
+        }
+    }
 }
 
 bool Main::Reset()
@@ -174,63 +300,110 @@ void Main::Execute()
 
     SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE,      16);
     SDL_GL_SetAttribute(SDL_GL_BUFFER_SIZE,     32);
-
-    SDL_GL_SetAttribute(SDL_GL_ACCUM_RED_SIZE,  	8);
-    SDL_GL_SetAttribute(SDL_GL_ACCUM_GREEN_SIZE,    8);
-    SDL_GL_SetAttribute(SDL_GL_ACCUM_BLUE_SIZE, 	8);
-    SDL_GL_SetAttribute(SDL_GL_ACCUM_ALPHA_SIZE,    8);
-
-    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS,  1);
-    SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES,  2);
+    StartupTimer::Mark("video");
 
     OnOpenGLContextCreated();
+    OpenGamepads();
+
+    if(mMicroBench)
+    {
+        MicroBench::Run();
+        mRunning = false;
+    }
 
-    unsigned int thisTime = 0;
-    unsigned int lastTime = 0;
-    unsigned int framesPerSecond = 60;
-    unsigned int millisecondsPerFrame = 1000 / framesPerSecond;
-    unsigned int fpsTicks = 0;
+    unsigned long long lastTime = DDTime::Microseconds();
 
     SDL_Event event;
 
     while(mRunning)
     {
-        // Calculate delta time
-        fpsTicks = SDL_GetTicks();
-        thisTime = SDL_GetTicks(); // returns in milliseconds
-        double deltaTime = static_cast<double>((thisTime - lastTime)) / 1000.f; // convert to seconds
+        Zones::EndFrame();
+        FrameArena::Reset();
+
+        // Wait out the rest of the frame before reading input rather than
+        // before the swap, so input is shown as soon as it's drawn.
+        FrameHud* hud = mDinodeck->GetFrameHud();
+        unsigned long long splitStart = DDTime::Microseconds();
+        const bool bench = mBenchmark.IsRunning();
+        mPacer.SetFrameRate(bench ? 0 : mDinodeck->GetSettings().frameRate);
+        mPacer.Wait();
+        hud->AddSplit(FrameHud::SPLIT_SLEEP, (DDTime::Microseconds() - splitStart) / 1000.0);
+
+        if(!bench && !mDinodeck->WantsFrame())
+        {
+            // Nothing to draw, sleep until there's input. The time asleep
+            // isn't passed on to the next update.
+            if(SDL_WaitEvent(&event))
+            {
+                OnEvent(&event);
+            }
+            lastTime = DDTime::Microseconds();
+            continue;
+        }
+
+        unsigned long long thisTime = DDTime::Microseconds();
+        double deltaTime = (thisTime - lastTime) / 1000000.0; // convert to seconds
         lastTime = thisTime;
 
         while(SDL_PollEvent(&event))
         {
             OnEvent(&event);
         }
+        HandleInput();
+        PollGamepads();
 
-
-        // This could be an actoin queue of types.
-        if(mDoWebServerReset)
+        if(mInputRecord.IsReplaying())
         {
-            mDoWebServerReset = false;
-            Reset();
+            // Recorded frame times replace the clock so every run steps
+            // the game the same way.
+            if(!mInputRecord.ReplayFrame(mDinodeck->GetGame(), &deltaTime))
+            {
+                mRunning = false;
+                continue;
+            }
         }
+        mInputRecord.EndFrame(deltaTime);
+        hud->AddSplit(FrameHud::SPLIT_EVENTS, (DDTime::Microseconds() - thisTime) / 1000.0);
 
-        if(mDoLuaExecute)
+        RunWebCommands();
+        mDinodeck->Update(deltaTime);
         {
-            // oh no law of demeter :(
-            mDinodeck->GetGame()->GetLuaState()->DoString(mLuaToExecute.c_str());
-            mDoLuaExecute = false;
-            mLuaToExecute = "";
+            DD_PROFILE_ZONE("Swap");
+            if(!mOffscreen)
+            {
+                SDL_GL_SwapBuffers();
+            }
+
+            // Otherwise the driver may be a few frames behind what's read.
+            // Benchmarks wait too so the GPU's share lands in the frame it's from.
+            if(mDinodeck->GetSettings().lowLatency || bench)
+            {
+                glFinish();
+            }
         }
+        mDinodeck->SetInputLatency((DDTime::Microseconds() - thisTime) / 1000.0);
 
-        HandleInput();
-        mDinodeck->Update(deltaTime);
+        if(StartupTimer::IsRunning())
+        {
+            // The swap is only queued until the GL's done with the frame.
+            glFinish();
+            StartupTimer::End();
+            if(mExitAfterStartup)
+            {
+                mRunning = false;
+            }
+        }
 
-        fpsTicks = SDL_GetTicks() - fpsTicks;
-        if (fpsTicks < millisecondsPerFrame)
+        if(bench)
         {
-            SDL_Delay(millisecondsPerFrame - fpsTicks);
+            mBenchmark.AddFrame((DDTime::Microseconds() - thisTime) / 1000.0,
+                                *mDinodeck->GetFrameHud(),
+                                GraphicsPipeline::LastFrameStats().drawCalls);
+            if(mBenchmark.IsDone())
+            {
+                mRunning = false;
+            }
         }
-        SDL_GL_SwapBuffers();
 
         if(mRunning)
         {
@@ -238,6 +411,21 @@ void Main::Execute()
         }
     }
 
+    mInputRecord.Stop();
+    // Nothing's left to answer requests, don't keep the webserver waiting.
+    mWebCommands.Close();
+
+    for(unsigned int i = 0; i < mJoysticks.size(); i++)
+    {
+        SDL_JoystickClose(mJoysticks[i]);
+    }
+    mJoysticks.clear();
+
+    if(mBenchmark.IsRunning())
+    {
+        mBenchmark.PrintReport();
+    }
+
     SDL_Quit();
 
 	return;
@@ -249,26 +437,122 @@ void Main::OnChange(int width, int height)
     ResetRenderWindow();
 }
 
+void Main::OnPresent()
+{
+    if(!mOffscreen)
+    {
+        SDL_GL_SwapBuffers();
+    }
+    // So the window manager doesn't think a long load has hung.
+    SDL_PumpEvents();
+}
+
 std::string Main::OnWebRequest(const std::string& uri, const std::string& postdata)
 {
-    // THIS IS BROKEN!
-    // This all on a seperate thread and therefore dangerous
-    // Everything should be locked correctly - which it currently isn't!
-    // (Needs a nice cross platform threading library.)
+    // Published each frame for any thread, no need to wait for the loop.
+    if(uri == "/metrics/")
+    {
+        return Metrics::Json();
+    }
+    else if(uri == "/metrics/prometheus/")
+    {
+        return Metrics::Prometheus();
+    }
+
+    // Wakes the loop if it's idle, the command runs next frame.
+    SDL_Event wake;
+    wake.type = SDL_USEREVENT;
+    SDL_PushEvent(&wake);
+
+    return mWebCommands.Send(uri, postdata);
+}
+
+void Main::RunWebCommands()
+{
+    // Everything that came in since last frame, in order.
+    WebCommandQueue::Command* command = NULL;
+    while((command = mWebCommands.Pop()) != NULL)
+    {
+        command->Answer(RunWebCommand(command->uri, command->postdata));
+        mWebCommands.Done(command);
+    }
+}
+
+std::string Main::RunWebCommand(const std::string& uri, const std::string& postdata)
+{
+    static const std::string reloadAsset("/reload/asset/");
 
     if(uri == "/reset/")
     {
-        mDoWebServerReset = true;
+        Reset();
+    }
+    else if(uri.compare(0, reloadAsset.size(), reloadAsset) == 0)
+    {
+        // /reload/asset/<name>, the post body is the new file if there is one.
+        const std::string name = uri.substr(reloadAsset.size());
+        return mDinodeck->ReloadAsset(name.c_str(), postdata) ? "ok" : "failed";
     }
     else if(uri == "/lasterror/")
     {
        return mDinodeck->GetGame()->GetLastError();
     }
+    else if(uri == "/stats/")
+    {
+        return GraphicsPipeline::StatsReport();
+    }
+    else if(uri == "/profile/start/")
+    {
+        Game* game = mDinodeck->GetGame();
+        game->GetProfiler()->Start(game->GetLuaState()->State(),
+                                   Profiler::DEFAULT_INTERVAL);
+    }
+    else if(uri == "/profile/stop/")
+    {
+        mDinodeck->GetGame()->GetProfiler()->Stop();
+    }
+    else if(uri == "/jit/")
+    {
+        // Trace aborts by where and why, most frequent first.
+        return mDinodeck->GetGame()->GetJitMonitor()->Report();
+    }
+    else if(uri == "/jit/clear/")
+    {
+        mDinodeck->GetGame()->GetJitMonitor()->Clear();
+    }
+    else if(uri == "/jit/log/")
+    {
+        JitMonitor* jit = mDinodeck->GetGame()->GetJitMonitor();
+        jit->SetLogging(!jit->IsLogging());
+        return jit->IsLogging() ? "on" : "off";
+    }
+    else if(uri == "/profile/")
+    {
+        // Collapsed stacks from the last stopped session.
+        return mDinodeck->GetGame()->GetProfiler()->LastReport();
+    }
+    else if(uri == "/drawcalls/capture/")
+    {
+        DrawCapture::Request();
+    }
+    else if(uri == "/drawcalls/replay/")
+    {
+        // Timed at the end of the next frame, read back from /drawcalls/.
+        DrawCapture::RequestReplay();
+    }
+    else if(uri == "/drawcalls/")
+    {
+        // The last captured frame's batches and where they came from.
+        return DrawCapture::Json();
+    }
+    else if(uri == "/assets/")
+    {
+        // Per asset load costs as of the last reload, costliest first.
+        return AssetReport::LastJson();
+    }
     else if(uri == "/execute/")
     {
-        // probably need to queue up and execute later
-        mDoLuaExecute = true;
-        mLuaToExecute = postdata;
+        // oh no law of demeter :(
+        mDinodeck->GetGame()->GetLuaState()->DoString(postdata.c_str());
     }
 
     return std::string("");
@@ -276,13 +560,101 @@ std::string Main::OnWebRequest(const std::string& uri, const std::string& postda
 
 int main(int argc, char *argv[])
 {
+    StartupTimer::Begin();
+    LogRing::Start();
+
+    // --bench N [--offscreen] [--record file | --replay file]
+    // [--bench-compare file [--bench-tolerance fraction]]
+    // [--microbench [--microbench-baseline file]] [--startup-exit]
+    // Regressions against either baseline make the exit code 1.
+    unsigned int benchFrames = 0;
+    const char* benchBaseline = NULL;
+    double benchTolerance = Benchmark::DEFAULT_TOLERANCE;
+    bool offscreen = false;
+    bool microBench = false;
+    bool exitAfterStartup = false;
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--bench") == 0 && i + 1 < argc)
+        {
+            benchFrames = (unsigned int) atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--bench-compare") == 0 && i + 1 < argc)
+        {
+            benchBaseline = argv[++i];
+        }
+        else if(strcmp(argv[i], "--bench-tolerance") == 0 && i + 1 < argc)
+        {
+            benchTolerance = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--offscreen") == 0)
+        {
+            offscreen = true;
+        }
+        else if(strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            recordPath = argv[++i];
+        }
+        else if(strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+        {
+            replayPath = argv[++i];
+        }
+        else if(strcmp(argv[i], "--microbench") == 0)
+        {
+            microBench = true;
+        }
+        else if(strcmp(argv[i], "--microbench-baseline") == 0 && i + 1 < argc)
+        {
+            MicroBench::LoadBaseline(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--startup-exit") == 0)
+        {
+            exitAfterStartup = true;
+        }
+    }
+
     PHYSFS_init(argv[0]);
     PHYSFS_addToSearchPath(PHYSFS_getBaseDir(), 1);
     PHYSFS_addToSearchPath("data.7z", 1);
+    DDPack::Mount("data.ddpak");
+    StartupTimer::Mark("filesystem");
 
     // 'mainInstance', to avoid a #define clash from SDL
     // under mac for 'main'
-	Main mainInstance;
-	mainInstance.Execute();
-	return 0;
+    // Scoped so fonts still reading from a pack are gone before it's unmapped.
+    int result = 0;
+    {
+        Main mainInstance;
+        if(benchFrames > 0)
+        {
+            mainInstance.SetBenchmark(benchFrames, offscreen);
+        }
+        Benchmark& bench = mainInstance.GetBenchmark();
+        bench.SetTolerance(benchTolerance);
+        if(benchBaseline && !bench.LoadBaseline(benchBaseline))
+        {
+            result = 1; // nothing to gate against
+        }
+        mainInstance.SetMicroBench(microBench);
+        mainInstance.SetExitAfterStartup(exitAfterStartup);
+
+        if(replayPath)
+        {
+            mainInstance.ReplayInput(replayPath);
+        }
+        else if(recordPath)
+        {
+            mainInstance.RecordInput(recordPath);
+        }
+        mainInstance.Execute();
+        if(bench.Regressions() > 0 || MicroBench::Regressions() > 0)
+        {
+            result = 1;
+        }
+    }
+    DDPack::UnmountAll();
+    LogRing::Stop();
+	return result;
 }
@@ -2,12 +2,18 @@
 #define MAIN_H
 
 #include <string>
+#include <vector>
 
+#include "Benchmark.h"
+#include "FramePacer.h"
+#include "InputRecord.h"
+#include "WebCommandQueue.h"
 #include "IScreenChangeListener.h"
 #include "IWebServerCallback.h"
 
 class	Dinodeck;
 struct	SDL_Surface;
+struct  _SDL_Joystick;
 union	SDL_Event;
 class   WebServer;
 
@@ -18,22 +24,42 @@ class Main : IScreenChangeListener, IWebServerCallback
 	bool           mRunning;
 	Dinodeck*      mDinodeck;
 	WebServer*     mWebServer;
+    FramePacer     mPacer;
+    Benchmark      mBenchmark;
+    bool           mOffscreen;
+    bool           mMicroBench;
+    bool           mExitAfterStartup; // for timing start up, see startup_bench.py
+    InputRecord    mInputRecord;
+    std::vector<_SDL_Joystick*> mJoysticks; // opened at start up, SDL 1.2 has no hot plugging
 
-    // Needs to be abstracted into some action queue.
-    bool mDoWebServerReset;
-    bool mDoLuaExecute;
-    std::string mLuaToExecute;
+    WebCommandQueue mWebCommands; // from the webserver's threads
 
 	bool ResetRenderWindow();
  	void OnOpenGLContextCreated();
     void OnEvent(SDL_Event* event);
     void HandleInput();
+    void OpenGamepads();
+    void PollGamepads();
+    void RunWebCommands();
+    std::string RunWebCommand(const std::string& uri, const std::string& postdata);
  public:
 	bool Reset();
 	void Execute();
+    // Run this many frames flat out, then print the timings and quit.
+    // Offscreen frames are drawn to the frame buffer and never swapped.
+    void SetBenchmark(unsigned int frames, bool offscreen);
+    Benchmark& GetBenchmark() { return mBenchmark; }
+    // Runs MicroBench once the engine's up instead of the game.
+    void SetMicroBench(bool value) { mMicroBench = value; }
+    // Quits once the first frame is up and the start up times printed.
+    void SetExitAfterStartup(bool value) { mExitAfterStartup = value; }
+    bool RecordInput(const char* path) { return mInputRecord.StartRecording(path); }
+    // Live input is ignored while a recording plays back.
+    bool ReplayInput(const char* path) { return mInputRecord.StartReplay(path); }
  	void OnChange(int width, int height);
+    void OnPresent();
 
-    // Warning, this occurs outside the main thread!
+    // Called on the webserver's threads, waits for the main loop to run it.
     std::string OnWebRequest(const std::string& uri, const std::string& postdata);
 	Main();
 	~Main();
@@ -3,13 +3,25 @@
 #include <assert.h>
 #include <list>
 #include <map>
+#include <stdio.h>
+#include <string.h>
 #include <string>
+#include <vector>
 
 #include "Asset.h"
+#include "AssetReport.h"
+#include "BakedFont.h"
 #include "DinodeckLua.h"
 #include "DDFile.h"
 #include "DDLog.h"
+#include "DDTime.h"
+#include "Font.h"
+#include "FormatText.h"
 #include "LuaState.h"
+#include "GraphicsPipeline.h"
+#include "Renderer.h"
+#include "TextLayoutCache.h"
+#include "XXHash.h"
 
 
 // TEMP
@@ -52,11 +64,14 @@ void ManifestAssetStore::Clear()
 
         if(asset.mFont)
         {
+            FormatText::ForgetFont(asset.mFont);
             delete asset.mFont;
             asset.mFont = NULL;
         }
     }
     mFontStore.clear();
+    mFontIndex.Clear();
+    TextLayoutCache::OnFontsChanged();
 }
 
 
@@ -166,7 +181,7 @@ bool ManifestAssetStore::LoadLuaTableToAssetDefs(lua_State* state,
     return true;
 }
 
-// Takes tables like this
+// Takes tables parsed from the manifest like this
 // scripts =
 // {
 //     ['main.lua'] =
@@ -176,7 +191,8 @@ bool ManifestAssetStore::LoadLuaTableToAssetDefs(lua_State* state,
 //     ... etc
 // }
 // And updates the in memory asset store intelligently.
-bool ManifestAssetStore::LoadAssetSubTable(lua_State* state, const char* tableName, const char* path)
+bool ManifestAssetStore::LoadAssetSubTable(const char* tableName,
+                                           std::map<std::string, AssetDef>& assetDefs)
 {
     // No longer an assert, I don't want the user to be able to crash Dancing Squid
     if(mAssetOwnerMap.find( std::string(tableName) ) == mAssetOwnerMap.end())
@@ -186,21 +202,11 @@ bool ManifestAssetStore::LoadAssetSubTable(lua_State* state, const char* tableNa
     }
     IAssetOwner* assetOwner = mAssetOwnerMap.find( std::string(tableName) )->second.owner;
 
-    std::map<std::string, ManifestAssetStore::AssetDef> scriptAssets;
-    bool isLoaded = false;
-    isLoaded = LoadLuaTableToAssetDefs(state, tableName, scriptAssets);
-    if(!isLoaded)
-    {
-        dsprintf("Failed to parse [%s].\n", path);
-        dsprintf("[%s]\n", lua_tostring(state, -1));
-        return false;
-    }
-
     // Go through - has the path changed? Unload, update path
     // Are there any additional resources add them
     for(std::map<std::string, ManifestAssetStore::AssetDef>::iterator
-        iter = scriptAssets.begin();
-        iter != scriptAssets.end();
+        iter = assetDefs.begin();
+        iter != assetDefs.end();
         ++iter)
     {
         ManifestAssetStore::AssetDef& assetDef = iter->second;
@@ -221,20 +227,213 @@ bool ManifestAssetStore::LoadAssetSubTable(lua_State* state, const char* tableNa
         // As path is a flag
         if(asset->Path() != assetDef.path || !AreAssetFlagsEqual(assetDef.flags, asset->Flags()))
         {
-            mAssetStore.Remove(assetName);
-            Asset* newAsset = mAssetStore.Add(assetDef.name.c_str(), assetDef.type, assetDef.path.c_str(), assetDef.flags, assetOwner);
-            newAsset->Touch(true);
+            // Reloaded over the old one rather than destroyed and added,
+            // which would reset the game and drop texture handles.
+            mAssetStore.Redefine(*asset, assetDef.path.c_str(), assetDef.flags);
         }
-        else
+        // It's added, the name is the same, mark it as touched.
+        asset->Touch(true);
+    }
+    return true;
+}
+
+//
+// Modify the store of assets
+// 1. Removing ones that the manifest on longer specifies
+// 2. Add ones that are brand new
+// 3. Telling ones to be reloading if the path has changed.
+//
+bool ManifestAssetStore::LoadAssetTables(AssetTables& tables)
+{
+    mAssetStore.ResetTouchFlag();
+
+    for(AssetTables::iterator iter = tables.begin(); iter != tables.end(); ++iter)
+    {
+        if(!LoadAssetSubTable(iter->first.c_str(), iter->second))
         {
-            // It's added, the name is the same, mark it as touched.
-            asset->Touch(true);
+            return false;
+        }
+    }
+
+    RemoveAssetsNotInManifest();
+
+    return mAssetStore.Reload();
+}
+
+//
+// The cache is binary, native endian, only ever read by the machine that
+// wrote it.
+// "DDMC" version hash manifestPath tableCount
+//     tableName defCount
+//         defName flagCount
+//             key value
+// Strings are a u32 length then the characters.
+//
+static const char MANIFEST_CACHE_MAGIC[4] = { 'D', 'D', 'M', 'C' };
+static const unsigned int MANIFEST_CACHE_VERSION = 1;
+
+static void WriteU32(FILE* file, unsigned int value)
+{
+    fwrite(&value, sizeof(value), 1, file);
+}
+
+static void WriteString(FILE* file, const std::string& value)
+{
+    WriteU32(file, (unsigned int) value.size());
+    fwrite(value.data(), 1, value.size(), file);
+}
+
+struct CacheReader
+{
+    const std::vector<char>& data;
+    size_t cursor;
+    bool failed;
+
+    CacheReader(const std::vector<char>& data) :
+        data(data), cursor(0), failed(false) {}
+
+    unsigned int U32()
+    {
+        unsigned int value = 0;
+        if(failed || data.size() - cursor < sizeof(value))
+        {
+            failed = true;
+            return 0;
+        }
+        memcpy(&value, &data[cursor], sizeof(value));
+        cursor += sizeof(value);
+        return value;
+    }
+
+    std::string String()
+    {
+        unsigned int size = U32();
+        if(failed || data.size() - cursor < size)
+        {
+            failed = true;
+            return std::string();
+        }
+        std::string value(data.begin() + cursor, data.begin() + cursor + size);
+        cursor += size;
+        return value;
+    }
+};
+
+bool ManifestAssetStore::ReadCache(const char* path, unsigned int hash, AssetTables* tables)
+{
+    assert(tables);
+    FILE* file = fopen(mCacheFile.c_str(), "rb");
+    if(file == NULL)
+    {
+        return false;
+    }
+
+    std::vector<char> data;
+    char chunk[4096];
+    size_t read = 0;
+    while((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    fclose(file);
+
+    if(data.size() < sizeof(MANIFEST_CACHE_MAGIC)
+       || memcmp(&data[0], MANIFEST_CACHE_MAGIC, sizeof(MANIFEST_CACHE_MAGIC)) != 0)
+    {
+        return false;
+    }
+
+    CacheReader reader(data);
+    reader.cursor = sizeof(MANIFEST_CACHE_MAGIC);
+    if(reader.U32() != MANIFEST_CACHE_VERSION
+       || reader.U32() != hash
+       || reader.String() != path)
+    {
+        return false;
+    }
+
+    unsigned int tableCount = reader.U32();
+    for(unsigned int i = 0; i < tableCount && !reader.failed; i++)
+    {
+        std::string tableName = reader.String();
+        if(mAssetOwnerMap.find(tableName) == mAssetOwnerMap.end())
+        {
+            // Written by a build with different asset owners.
+            tables->clear();
+            return false;
         }
+        Asset::eAssetType assetType = Asset::StringToAssetType(tableName.c_str());
+        std::map<std::string, AssetDef>& assetDefs = (*tables)[tableName];
+
+        unsigned int defCount = reader.U32();
+        for(unsigned int j = 0; j < defCount && !reader.failed; j++)
+        {
+            std::string name = reader.String();
+            std::map<std::string, std::string> flags;
+            unsigned int flagCount = reader.U32();
+            for(unsigned int k = 0; k < flagCount && !reader.failed; k++)
+            {
+                std::string key = reader.String();
+                flags[key] = reader.String();
+            }
+
+            assetDefs.insert(std::pair<std::string, AssetDef>
+            (
+                name,
+                AssetDef(assetType, name.c_str(), flags["path"].c_str(), flags)
+            ));
+        }
+    }
+
+    if(reader.failed || reader.cursor != data.size())
+    {
+        dsprintf("Manifest cache [%s] is corrupt, ignoring it.\n", mCacheFile.c_str());
+        tables->clear();
+        return false;
     }
     return true;
 }
 
+void ManifestAssetStore::WriteCache(const char* path, unsigned int hash, const AssetTables& tables)
+{
+    FILE* file = fopen(mCacheFile.c_str(), "wb");
+    if(file == NULL)
+    {
+        dsprintf("Failed to write manifest cache [%s].\n", mCacheFile.c_str());
+        return;
+    }
 
+    fwrite(MANIFEST_CACHE_MAGIC, 1, sizeof(MANIFEST_CACHE_MAGIC), file);
+    WriteU32(file, MANIFEST_CACHE_VERSION);
+    WriteU32(file, hash);
+    WriteString(file, path);
+    WriteU32(file, (unsigned int) tables.size());
+
+    for(AssetTables::const_iterator table = tables.begin(); table != tables.end(); ++table)
+    {
+        WriteString(file, table->first);
+        WriteU32(file, (unsigned int) table->second.size());
+
+        for(std::map<std::string, AssetDef>::const_iterator
+            def = table->second.begin();
+            def != table->second.end();
+            ++def)
+        {
+            WriteString(file, def->first);
+            WriteU32(file, (unsigned int) def->second.flags.size());
+
+            for(std::map<std::string, std::string>::const_iterator
+                flag = def->second.flags.begin();
+                flag != def->second.flags.end();
+                ++flag)
+            {
+                WriteString(file, flag->first);
+                WriteString(file, flag->second);
+            }
+        }
+    }
+    fclose(file);
+}
 
 bool ManifestAssetStore::Reload()
 {
@@ -254,7 +453,7 @@ bool ManifestAssetStore::Reload(std::string manifestPath)
        !AssetStore::IsOutOfDate(*mManifest))    // Has the file timestamp changed?
     {
         // Manifest file hasn't changed. Reload manifest children.
-        dsprintf("[%s] SKIPPED.\n", manifestPath.c_str());
+        DD_LOG_DEBUG("[%s] SKIPPED.\n", manifestPath.c_str());
         return mAssetStore.Reload();
     }
     else
@@ -274,6 +473,27 @@ bool ManifestAssetStore::Reload(std::string manifestPath)
             AssetStore::GetModifiedTimeStamp(*mManifest)
         );
 
+        // The parse depends only on the manifest's text, so if that's
+        // unchanged the last parse can be used without starting Lua.
+        bool useCache = false;
+        unsigned int hash = 0;
+        if(!mCacheFile.empty())
+        {
+            DDFile manifestFile(path);
+            if(manifestFile.LoadFileView())
+            {
+                hash = XXHash::Hash32(manifestFile.Buffer(), manifestFile.Size());
+                useCache = true;
+            }
+        }
+
+        AssetTables tables;
+        if(useCache && ReadCache(path, hash, &tables))
+        {
+            dsprintf("[%s] parse read from cache.\n", path);
+            return LoadAssetTables(tables);
+        }
+
         // OK the manifest has changed, this effects ALL the assets
         // some might no longer be refernced and need removing
         // Some might be new and need adding, so first thing is to
@@ -308,39 +528,41 @@ bool ManifestAssetStore::Reload(std::string manifestPath)
             return false;
         }
 
+        // Iterate through asset owners map
+        for(std::map<std::string, AssetOwner>::iterator
+            iter = mAssetOwnerMap.begin();
+            iter != mAssetOwnerMap.end();
+            ++iter)
         {
-            //
-            // Modify the store of assets
-            // 1. Removing ones that the manifest on longer specifies
-            // 2. Add ones that are brand new
-            // 3. Telling ones to be reloading if the path has changed.
-            //
-            mAssetStore.ResetTouchFlag();
-
-            // Iterate through asset owners map
-            for(std::map<std::string, AssetOwner>::iterator
-                iter = mAssetOwnerMap.begin();
-                iter != mAssetOwnerMap.end();
-                ++iter)
+            AssetOwner& assetOwner = iter->second;
+
+            std::map<std::string, AssetDef> assetDefs;
+            bool success = LoadLuaTableToAssetDefs(state, assetOwner.id, assetDefs);
+            if(!success)
             {
-                AssetOwner& assetOwner = iter->second;
-
-                bool success = LoadAssetSubTable(state, assetOwner.id, path);
-                if(assetOwner.flags == ManifestAssetStore::Required
-                   && !success)
-                {
-                    dsprintf("Failed to reload [%s]\n", iter->first.c_str());
-                    lua_close(state);
-                    return false;
-                }
+                dsprintf("Failed to parse [%s].\n", path);
+                dsprintf("[%s]\n", lua_tostring(state, -1));
             }
 
-            RemoveAssetsNotInManifest();
+            if(assetOwner.flags == ManifestAssetStore::Required
+               && !success)
+            {
+                dsprintf("Failed to reload [%s]\n", iter->first.c_str());
+                lua_close(state);
+                return false;
+            }
+            else if(success)
+            {
+                tables[assetOwner.id] = assetDefs;
+            }
+        }
 
-            return mAssetStore.Reload();
+        if(useCache)
+        {
+            WriteCache(path, hash, tables);
         }
-        mManifest->SetIsLoaded(true);
-        return true;
+
+        return LoadAssetTables(tables);
     }
 }
 
@@ -356,18 +578,55 @@ bool ManifestAssetStore::OnAssetReload(Asset& asset)
     {
         // No error checking!! Fix this.
 
+        const char* name = asset.Name().c_str();
+        unsigned long long start = DDTime::Microseconds();
         DDFile* fontFile = new DDFile(asset.Path().c_str());
         fontFile->LoadFileIntoBuffer();
-        FTTextureFont* font = new FTTextureFont((const unsigned char*)fontFile->Buffer(), (size_t) fontFile->Size());
-        font->FaceSize(72.0f);
+        unsigned long long read = DDTime::Microseconds();
+        AssetReport::AddRead(name, fontFile->Size(), read - start);
+
+        if(IsBakedFont(asset.Path()))
+        {
+            return LoadBakedFont(asset, fontFile, read);
+        }
+
+        FTTextureFont* freeType = new FTTextureFont((const unsigned char*)fontFile->Buffer(), (size_t) fontFile->Size());
+        freeType->FaceSize(72.0f);
+        Font* font = new Font(freeType);
+        // FTGL reads from the file for the font's lifetime.
+        AssetReport::SetMemory(name, fontFile->Size());
 
         dsprintf("Adding font [%s]->[%s]\n",
                 asset.Name().c_str(), asset.Path().c_str());
-        mFontStore.insert(std::pair<std::string, FontAsset>
-        (
-            asset.Name(),
-            FontAsset(fontFile, font)
-        ));
+
+        std::map<std::string, std::string>::const_iterator
+            sdf = asset.Flags().find("sdf");
+        if(sdf != asset.Flags().end() && sdf->second == "true")
+        {
+            FormatText::MakeDistanceField(font);
+        }
+        AssetReport::AddDecode(name, DDTime::Microseconds() - read);
+
+        std::map<std::string, std::string>::const_iterator
+            charset = asset.Flags().find("charset");
+        if(charset != asset.Flags().end())
+        {
+            unsigned long long prewarm = DDTime::Microseconds();
+            FormatText::PrewarmGlyphs(font, charset->second.c_str());
+            FormatText::UploadGlyphs();
+            AssetReport::AddUpload(name, DDTime::Microseconds() - prewarm);
+
+            GlyphAtlasStats stats;
+            FormatText::GetGlyphAtlasStats(font, &stats);
+            dsprintf("Font [%s] prewarmed %d glyphs, %d page(s) of %dx%d, %d%% full.\n",
+                     asset.Name().c_str(),
+                     stats.glyphs,
+                     stats.pages,
+                     stats.pageWidth,
+                     stats.pageHeight,
+                     (int)(stats.occupancy * 100));
+        }
+        StoreFont(asset.Name(), FontAsset(fontFile, font));
         return true;
     }
     return false;
@@ -380,15 +639,49 @@ void ManifestAssetStore::OnAssetDestroyed(Asset& asset)
         std::map<std::string, FontAsset>::iterator iter = mFontStore.find(std::string(asset.Name()));
         if(iter != mFontStore.end())
         {
-            delete iter->second.mFont;
-            iter->second.mFont = NULL;
-            delete iter->second.mFontFile;
-            iter->second.mFontFile = NULL;
+            ReleaseFont(asset.Name(), iter->second);
             mFontStore.erase(iter);
+            mFontIndex.Erase(asset.Name().c_str());
         }
     }
 }
 
+//
+// A reloaded font replaces the one under its name. Only renderers that
+// resolved that font let go of it, the rest keep theirs.
+//
+void ManifestAssetStore::StoreFont(const std::string& name, const FontAsset& font)
+{
+    std::map<std::string, FontAsset>::iterator iter = mFontStore.find(name);
+    if(iter != mFontStore.end())
+    {
+        ReleaseFont(name, iter->second);
+        iter->second = font;
+    }
+    else
+    {
+        iter = mFontStore.insert(std::pair<std::string, FontAsset>(name, font)).first;
+    }
+    mFontIndex.Set(name.c_str(), iter->second.mFont);
+}
+
+void ManifestAssetStore::ReleaseFont(const std::string& name, FontAsset& font)
+{
+    for(std::vector<Renderer*>::iterator it = Renderer::mRenderers.begin();
+        it != Renderer::mRenderers.end(); ++it)
+    {
+        (*it)->Graphics()->ForgetFont(name, font.mFont);
+    }
+
+    FormatText::ForgetFont(font.mFont);
+    delete font.mFont;
+    font.mFont = NULL;
+    delete font.mFontFile;
+    font.mFontFile = NULL;
+    // Cached layouts are keyed by the font's address, which may be reused.
+    TextLayoutCache::OnFontsChanged();
+}
+
 // Used when loading assets from the manifest
 void ManifestAssetStore::RegisterAssetOwner(const char* name, IAssetOwner* callback)
 {
@@ -407,12 +700,59 @@ void ManifestAssetStore::RegisterAssetOwner(const char* name,
                                         );
 }
 
-FTTextureFont* ManifestAssetStore::GetFont(const char* name)
+//
+// Fonts baked offline by bake_font.py are .ddfont files.
+//
+bool ManifestAssetStore::IsBakedFont(const std::string& path)
+{
+    static const char* extension = ".ddfont";
+    const size_t length = strlen(extension);
+    return path.size() >= length &&
+           path.compare(path.size() - length, length, extension) == 0;
+}
+
+//
+// The glyphs are uploaded and the metrics copied out, so unlike a TTF
+// the file isn't kept.
+//
+bool ManifestAssetStore::LoadBakedFont(Asset& asset, DDFile* fontFile, unsigned long long read)
+{
+    const char* name = asset.Name().c_str();
+    BakedFont* baked = new BakedFont();
+    bool loaded = baked->Load(name,
+                              (const unsigned char*) fontFile->Buffer(),
+                              fontFile->Size());
+    delete fontFile;
+
+    if(!loaded)
+    {
+        delete baked;
+        return false;
+    }
+    AssetReport::AddUpload(name, DDTime::Microseconds() - read);
+    AssetReport::SetMemory(name, baked->TextureWidth() * baked->TextureHeight());
+
+    dsprintf("Adding baked font [%s]->[%s], %u glyphs.\n",
+             name, asset.Path().c_str(), baked->GlyphCount());
+
+    StoreFont(asset.Name(), FontAsset(NULL, new Font(baked)));
+    return true;
+}
+
+Font* ManifestAssetStore::GetFont(const char* name)
+{
+    Font** font = mFontIndex.Find(name);
+    return font ? *font : NULL;
+}
+
+unsigned int ManifestAssetStore::GlyphAtlasBytes()
 {
-    std::map<std::string, FontAsset>::iterator iter = mFontStore.find(std::string(name));
-    if(iter == mFontStore.end())
+    unsigned int bytes = 0;
+    for(std::map<std::string, FontAsset>::iterator it = mFontStore.begin();
+        it != mFontStore.end();
+        ++it)
     {
-        return NULL;
+        bytes += FormatText::GlyphAtlasBytes(it->second.mFont);
     }
-    return (iter->second).mFont;
+    return bytes;
 }
\ No newline at end of file
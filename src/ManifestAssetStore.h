@@ -10,7 +10,7 @@
 
 class Asset;
 class DDFile;
-class FTTextureFont;
+class Font;
 struct lua_State;
 
 //
@@ -57,20 +57,32 @@ private:
 
     struct FontAsset
     {
-        FTTextureFont*  mFont;
+        Font*           mFont;
         DDFile*         mFontFile; // The file data needs to be kept in memory!
-        FontAsset(DDFile* fontFile, FTTextureFont* font) :
+        FontAsset(DDFile* fontFile, Font* font) :
             mFont(font), mFontFile(fontFile) {}
     };
     // Who handles what by default
     // [.lua] -> Dindeck etc
     std::map<std::string, AssetOwner> mAssetOwnerMap;
     std::map<std::string, FontAsset> mFontStore;
+    NameIndex<Font*> mFontIndex;
+    std::string mCacheFile;
+
+    // Asset defs by table name e.g. "textures"
+    typedef std::map<std::string, std::map<std::string, AssetDef> > AssetTables;
 
     bool LoadLuaTableToAssetDefs(lua_State* state,
                                  const char* tableName,
                                  std::map<std::string, ManifestAssetStore::AssetDef>& destination);
-    bool LoadAssetSubTable(lua_State* state, const char* tableName, const char* path);
+    bool LoadAssetSubTable(const char* tableName, std::map<std::string, AssetDef>& assetDefs);
+    bool LoadAssetTables(AssetTables& tables);
+    bool ReadCache(const char* path, unsigned int hash, AssetTables* tables);
+    void WriteCache(const char* path, unsigned int hash, const AssetTables& tables);
+    static bool IsBakedFont(const std::string& path);
+    bool LoadBakedFont(Asset& asset, DDFile* fontFile, unsigned long long read);
+    void StoreFont(const std::string& name, const FontAsset& font);
+    void ReleaseFont(const std::string& name, FontAsset& font);
     bool LoadAssetDef(lua_State* state,
                       std::map<std::string, ManifestAssetStore::AssetDef>& destination,
                       Asset::eAssetType assetType);
@@ -96,15 +108,28 @@ public:
     }
 
     bool Reload(std::string manifest); // Copy string is on purpose
+    // The parsed manifest is kept here, keyed by its hash, so an unchanged
+    // manifest loads without running Lua. Empty turns the cache off.
+    void SetCacheFile(const std::string& path) { mCacheFile = path; }
     bool Reload();
+    bool ReloadAsset(const char* name) { return mAssetStore.ReloadAsset(name); }
     void Clear();
 
     // Used when loading assets from the manifest
     void RegisterAssetOwner(const char* name, IAssetOwner* callback);
     void RegisterAssetOwner(const char* name, IAssetOwner* callback, eOwnerFlags flags);
 
-    FTTextureFont* GetFont(const char* name);
+    Font* GetFont(const char* name);
+    // Summed over every loaded font, see FormatText::GlyphAtlasBytes.
+    unsigned int GlyphAtlasBytes();
     void    SetAsNotLoaded(Asset::eAssetType type) { mAssetStore.SetAsNotLoaded(type); }
+
+    // Asset groups, see AssetStore
+    bool    Preload(const char* group, int priority) { return mAssetStore.Preload(group, priority); }
+    void    Unload(const char* group) { mAssetStore.Unload(group); }
+    void    GetGroup(const char* group, std::vector<Asset*>* out) { mAssetStore.GetGroup(group, out); }
+    void    UpdatePreloads(unsigned int budgetMicroseconds) { mAssetStore.UpdatePreloads(budgetMicroseconds); }
+    unsigned int PendingPreloads() const { return mAssetStore.PendingPreloads(); }
 };
 
 #endif
\ No newline at end of file
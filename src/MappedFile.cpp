@@ -0,0 +1,166 @@
+#include "MappedFile.h"
+
+#include <assert.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "DDLog.h"
+
+MappedFile::MappedFile() :
+    mData(NULL),
+    mSize(0)
+#ifdef _WIN32
+    ,mFile(INVALID_HANDLE_VALUE),
+    mMapping(NULL)
+#endif
+{
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const char* path)
+{
+    assert(path);
+    Close();
+
+    mFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(mFile == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    mSize = GetFileSize((HANDLE) mFile, NULL);
+    if(mSize > 0)
+    {
+        mMapping = CreateFileMappingA((HANDLE) mFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+
+    if(mMapping != NULL)
+    {
+        mData = (const unsigned char*) MapViewOfFile((HANDLE) mMapping,
+                                                     FILE_MAP_READ, 0, 0, 0);
+    }
+
+    if(mData == NULL)
+    {
+        if(mSize > 0)
+        {
+            dsprintf("Failed to map [%s].\n", path);
+        }
+        Close();
+        return false;
+    }
+    return true;
+}
+
+// PrefetchVirtualMemory is Windows 8 on, looked up so older ones still run.
+typedef struct
+{
+    void* address;
+    SIZE_T size;
+} PrefetchRange;
+typedef BOOL (WINAPI *PrefetchFunction)(HANDLE, ULONG_PTR, PrefetchRange*, ULONG);
+
+void MappedFile::Prefetch(unsigned int offset, unsigned int size) const
+{
+    static PrefetchFunction prefetch = (PrefetchFunction)
+        GetProcAddress(GetModuleHandleA("kernel32.dll"), "PrefetchVirtualMemory");
+    if(mData == NULL || prefetch == NULL || offset >= mSize)
+    {
+        return;
+    }
+
+    PrefetchRange range;
+    range.address = (void*) (mData + offset);
+    range.size = size < mSize - offset ? size : mSize - offset;
+    prefetch(GetCurrentProcess(), 1, &range, 0);
+}
+
+void MappedFile::Close()
+{
+    if(mData)
+    {
+        UnmapViewOfFile(mData);
+    }
+    if(mMapping)
+    {
+        CloseHandle((HANDLE) mMapping);
+    }
+    if(mFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle((HANDLE) mFile);
+    }
+    mData = NULL;
+    mMapping = NULL;
+    mFile = INVALID_HANDLE_VALUE;
+    mSize = 0;
+}
+
+#else
+
+bool MappedFile::Open(const char* path)
+{
+    assert(path);
+    Close();
+
+    int fd = open(path, O_RDONLY);
+    if(fd < 0)
+    {
+        return false;
+    }
+
+    struct stat s;
+    if(fstat(fd, &s) != 0 || !S_ISREG(s.st_mode) || s.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(NULL, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive.
+    close(fd);
+
+    if(data == MAP_FAILED)
+    {
+        dsprintf("Failed to map [%s].\n", path);
+        return false;
+    }
+
+    mData = (const unsigned char*) data;
+    mSize = (unsigned int) s.st_size;
+    return true;
+}
+
+void MappedFile::Prefetch(unsigned int offset, unsigned int size) const
+{
+    if(mData == NULL || offset >= mSize)
+    {
+        return;
+    }
+
+    // madvise wants a page aligned start.
+    const unsigned long page = (unsigned long) sysconf(_SC_PAGESIZE);
+    const unsigned int start = offset - (unsigned int) (offset % page);
+    const unsigned int end = size < mSize - offset ? offset + size : mSize;
+    madvise((void*) (mData + start), end - start, MADV_WILLNEED);
+}
+
+void MappedFile::Close()
+{
+    if(mData)
+    {
+        munmap((void*) mData, mSize);
+    }
+    mData = NULL;
+    mSize = 0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+//
+// A whole file mapped read only into memory.
+// The data stays valid until Close or the MappedFile is destroyed.
+//
+class MappedFile
+{
+    const unsigned char* mData;
+    unsigned int mSize;
+#ifdef _WIN32
+    void* mFile;
+    void* mMapping;
+#elif ANDROID
+    void* mAsset; // an AAsset from the APK
+#endif
+public:
+    MappedFile();
+    ~MappedFile() { Close(); }
+
+    // Fails quietly if the file is missing or empty, empty files can't be
+    // mapped.
+    bool Open(const char* path);
+    void Close();
+    const unsigned char* Data() const { return mData; }
+    unsigned int Size() const { return mSize; }
+    // Asks the OS to start reading the range in, without waiting for it.
+    // Does nothing where there's no way to ask.
+    void Prefetch(unsigned int offset, unsigned int size) const;
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+#endif
\ No newline at end of file
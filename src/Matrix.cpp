@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include <cmath>
+#include <stdio.h>
 
 #include "reflect/Reflect.h"
 #include "Vector"
@@ -9,6 +10,7 @@
 #include "LuaState.h"
 #include "DinodeckGL.h"
 #include "DDMath.h"
+#include "LuaFFI.h"
 
 
 Reflect Matrix::Meta("Matrix", Matrix::Bind);
@@ -213,13 +215,14 @@ void Matrix::SetColumns(
 
 std::string Matrix::ToString() const
 {
-    std::stringstream ss;
-    ss <<
-        mCol0.x << "\t" << mCol1.x  << "\t" << mCol2.x  << "\t" << mCol3.x  << "\n" <<
-        mCol0.y << "\t" << mCol1.y  << "\t" << mCol2.y  << "\t" << mCol3.y  << "\n" <<
-        mCol0.z << "\t" << mCol1.z  << "\t" << mCol2.z  << "\t" << mCol3.z  << "\n" <<
-        mCol0.w << "\t" << mCol1.w  << "\t" << mCol2.w  << "\t" << mCol3.w  << "\n";
-    return ss.str();
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer),
+             "%g\t%g\t%g\t%g\n%g\t%g\t%g\t%g\n%g\t%g\t%g\t%g\n%g\t%g\t%g\t%g\n",
+             mCol0.x, mCol1.x, mCol2.x, mCol3.x,
+             mCol0.y, mCol1.y, mCol2.y, mCol3.y,
+             mCol0.z, mCol1.z, mCol2.z, mCol3.z,
+             mCol0.w, mCol1.w, mCol2.w, mCol3.w);
+    return buffer;
 }
 
 void Matrix::SetColumn(int index, float x, float y, float z, float w)
@@ -271,7 +274,7 @@ void Matrix::SetColumn(int index, const Vector& column)
 int lua_Matrix_Create(lua_State * state)
 {
     // If there's inheritance I think this may causes problems
-    if(lua_isuserdata(state, 1) && luaL_checkudata(state, 1, "Matrix"))
+    if(LuaState::IsType<Matrix>(state, 1))
     {
         Matrix* matrix = (Matrix*)lua_touserdata(state, 1);
         if(matrix == NULL)
@@ -280,7 +283,7 @@ int lua_Matrix_Create(lua_State * state)
         }
         new (lua_newuserdata(state, sizeof(Matrix))) Matrix(*matrix);
     }
-    else if(lua_isuserdata(state, 1) && luaL_checkudata (state, 1, "Vector"))
+    else if(LuaState::IsType<Vector>(state, 1))
     {
         Vector* row0 = LuaState::GetFuncParam<Vector>(state, 1);
         Vector* row1 = LuaState::GetFuncParam<Vector>(state, 2);
@@ -328,14 +331,14 @@ int lua_Matrix_tostring(lua_State* state)
 
 static int lua_Matrix_multiply_operator(lua_State* state)
 {
-    if(!LuaState::IsType(state, 1, "Matrix"))
+    if(!LuaState::IsType<Matrix>(state, 1))
     {
         return luaL_typerror(state, 1, "Matrix expected.");
     }
 
     Matrix* lhs = static_cast<Matrix*>(lua_touserdata(state, 1));
 
-    if(LuaState::IsType(state, 2, "Vector"))
+    if(LuaState::IsType<Vector>(state, 2))
     {
         Vector* rhs = static_cast<Vector*>(lua_touserdata(state, 2));
         Vector* destination = new (lua_newuserdata(state, sizeof(Vector))) Vector();
@@ -343,7 +346,7 @@ static int lua_Matrix_multiply_operator(lua_State* state)
         lua_setmetatable(state, -2);
         Matrix::Multiply(*destination, *lhs, *rhs);
     }
-    else if(LuaState::IsType(state, 2, "Matrix"))
+    else if(LuaState::IsType<Matrix>(state, 2))
     {
         Matrix* rhs = static_cast<Matrix*>(lua_touserdata(state, 2));
         Matrix* destination = new (lua_newuserdata(state, sizeof(Matrix))) Matrix();
@@ -388,7 +391,7 @@ static int lua_Matrix_SetColumn(lua_State* state)
         matrix->SetColumn(columnIndex, x, y, z, w);
         return 0;
     }
-    else if(lua_isuserdata(state, 3) && LuaState::IsType(state, 3, "Vector"))
+    else if(LuaState::IsType<Vector>(state, 3))
     {
         Vector* vec = LuaState::GetFuncParam<Vector>(state, 3);
         matrix->SetColumn(columnIndex, *vec);
@@ -409,7 +412,7 @@ static int lua_Matrix_SetRotation(lua_State* state)
     }
 
     Vector* axis = NULL;
-    if(lua_isuserdata(state, 2) && luaL_checkudata(state, 2, "Vector"))
+    if(LuaState::IsType<Vector>(state, 2))
     {
        axis = LuaState::GetFuncParam<Vector>(state, 2);
        assert(axis);
@@ -437,7 +440,7 @@ static int lua_Matrix_SetScale(lua_State* state)
         return 0;
     }
 
-    if(lua_isuserdata(state, 2) && luaL_checkudata(state, 2, "Vector"))
+    if(LuaState::IsType<Vector>(state, 2))
     {
        Vector* vector = LuaState::GetFuncParam<Vector>(state, 2);
        assert(vector);
@@ -463,7 +466,7 @@ static int lua_Matrix_SetTranslate(lua_State* state)
         return 0;
     }
 
-    if(lua_isuserdata(state, 2) && luaL_checkudata (state, 2, "Vector"))
+    if(LuaState::IsType<Vector>(state, 2))
     {
        Vector* vector = LuaState::GetFuncParam<Vector>(state, 2);
        assert(vector);
@@ -494,7 +497,7 @@ static int lua_Matrix_Multiply(lua_State* state)
     {
         // scalar matrix multiplication is commutative, so order doesn't matter
         // here - and we can just use on function.
-        if(LuaState::IsType(state, 2, Matrix::Meta.Name().c_str()))
+        if(LuaState::IsType<Matrix>(state, 2))
         {
             // m * s
             Matrix::Multiply
@@ -504,7 +507,7 @@ static int lua_Matrix_Multiply(lua_State* state)
                 static_cast<double>(lua_tonumber(state, 3))
             );
         }
-        else if(LuaState::IsType(state, 3, Matrix::Meta.Name().c_str()))
+        else if(LuaState::IsType<Matrix>(state, 3))
         {
             // s * m
             Matrix::Multiply
@@ -520,8 +523,8 @@ static int lua_Matrix_Multiply(lua_State* state)
         }
 
     }
-    else if(LuaState::IsType(state, 2, Matrix::Meta.Name().c_str()) &&
-            LuaState::IsType(state, 3, Matrix::Meta.Name().c_str()))
+    else if(LuaState::IsType<Matrix>(state, 2) &&
+            LuaState::IsType<Matrix>(state, 3))
     {
         // Assume both matrices
         Matrix::Multiply
@@ -535,7 +538,7 @@ static int lua_Matrix_Multiply(lua_State* state)
     {
         // Return correct parameter error.
         // First param can be a number of Matrix but not a Vector.
-        if(!lua_isnumber(state, 2) || !LuaState::IsType(state, 2, Matrix::Meta.Name().c_str()))
+        if(!lua_isnumber(state, 2) || !LuaState::IsType<Matrix>(state, 2))
         {
             return luaL_typerror(state, 2, "number or Matrix");
         }
@@ -566,6 +569,7 @@ void Matrix::Bind(LuaState* state)
         Matrix::Meta.Name(),
         luaBinding
     );
+    LuaFFI::BindView(state, Matrix::Meta.Name().c_str());
 }
 
 
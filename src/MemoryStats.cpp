@@ -0,0 +1,44 @@
+#include "MemoryStats.h"
+
+const char* MemoryStats::TagStr[MEMORY_TAG_COUNT] =
+{
+    "textures",
+    "sounds",
+    "fonts",
+    "lua",
+    "vertices",
+    "files",
+};
+
+volatile size_t MemoryStats::mCurrent[MEMORY_TAG_COUNT];
+volatile size_t MemoryStats::mPeak[MEMORY_TAG_COUNT];
+
+void MemoryStats::RaisePeak(eTag tag, size_t bytes)
+{
+    size_t peak = mPeak[tag];
+    while(bytes > peak)
+    {
+        size_t seen = __sync_val_compare_and_swap(&mPeak[tag], peak, bytes);
+        if(seen == peak)
+        {
+            return;
+        }
+        peak = seen;
+    }
+}
+
+void MemoryStats::Add(eTag tag, size_t bytes)
+{
+    RaisePeak(tag, __sync_add_and_fetch(&mCurrent[tag], bytes));
+}
+
+void MemoryStats::Release(eTag tag, size_t bytes)
+{
+    __sync_sub_and_fetch(&mCurrent[tag], bytes);
+}
+
+void MemoryStats::Set(eTag tag, size_t bytes, size_t peakBytes)
+{
+    mCurrent[tag] = bytes;
+    RaisePeak(tag, peakBytes > bytes ? peakBytes : bytes);
+}
\ No newline at end of file
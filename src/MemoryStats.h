@@ -0,0 +1,39 @@
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <stddef.h>
+
+//
+// Where the engine's memory goes, current and peak bytes per subsystem.
+//
+// Most tags are counted where the memory is made and freed, from any
+// thread. Fonts' glyph textures belong to FTGL and the Lua heap to its
+// allocator, so those are read off once a frame with Set instead.
+//
+class MemoryStats
+{
+public:
+    enum eTag
+    {
+        MEMORY_TEXTURES, // GL textures and atlas pages
+        MEMORY_SOUNDS,   // decoded sound and stream buffers
+        MEMORY_FONTS,    // glyph textures, the font files count as files
+        MEMORY_LUA,      // the game's heap
+        MEMORY_VERTICES, // GL vertex buffers
+        MEMORY_FILES,    // DDFile buffers, not views
+        MEMORY_TAG_COUNT
+    };
+    static const char* TagStr[MEMORY_TAG_COUNT];
+
+    static void Add(eTag tag, size_t bytes);
+    static void Release(eTag tag, size_t bytes);
+    static void Set(eTag tag, size_t bytes, size_t peakBytes);
+    static size_t Current(eTag tag) { return mCurrent[tag]; }
+    static size_t Peak(eTag tag) { return mPeak[tag]; }
+private:
+    static volatile size_t mCurrent[MEMORY_TAG_COUNT];
+    static volatile size_t mPeak[MEMORY_TAG_COUNT];
+    static void RaisePeak(eTag tag, size_t bytes);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "Mesh.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+#include <string.h>
+
+#include "Asset.h"
+#include "DDFile.h"
+#include "DDLog.h"
+#include "DinodeckGL.h"
+#include "GraphicsPipeline.h"
+#include "Texture.h"
+
+// Matches eBlendMode's order.
+static const char* blendNames[] = { "blend", "additive", "multiply", "screen" };
+
+bool Mesh::Read(const char* data,
+                unsigned int size,
+                const std::map<std::string, std::string>& flags,
+                std::string* outError)
+{
+    assert(outError);
+    Clear();
+
+    const unsigned int count = size / sizeof(PackedVertex);
+    if(data == NULL
+       || count == 0
+       || size % sizeof(PackedVertex) != 0
+       || count % 3 != 0)
+    {
+        *outError = "expected whole triangles of 16 byte verts";
+        return false;
+    }
+
+    std::map<std::string, std::string>::const_iterator it = flags.find("blend");
+    if(it != flags.end())
+    {
+        mBlend = -1;
+        for(int i = 0; i < BLEND_COUNT; i++)
+        {
+            if(it->second == blendNames[i])
+            {
+                mBlend = i;
+            }
+        }
+
+        if(mBlend < 0)
+        {
+            mBlend = BLEND;
+            *outError = "blend must be blend, additive, multiply or screen";
+            return false;
+        }
+    }
+
+    it = flags.find("texture");
+    if(it != flags.end())
+    {
+        mTexture = it->second;
+    }
+
+    // Copied rather than cast, the data needn't be aligned.
+    mVerts.resize(count);
+    memcpy(&mVerts[0], data, count * sizeof(PackedVertex));
+
+    float left = mVerts[0].x;
+    float right = left;
+    float bottom = mVerts[0].y;
+    float top = bottom;
+    for(unsigned int i = 1; i < count; i++)
+    {
+        left = std::min(left, mVerts[i].x);
+        right = std::max(right, mVerts[i].x);
+        bottom = std::min(bottom, mVerts[i].y);
+        top = std::max(top, mVerts[i].y);
+    }
+    mCentreX = (left + right) * 0.5f;
+    mCentreY = (bottom + top) * 0.5f;
+    const float halfWidth = (right - left) * 0.5f;
+    const float halfHeight = (top - bottom) * 0.5f;
+    mRadius = sqrt(halfWidth * halfWidth + halfHeight * halfHeight);
+    return true;
+}
+
+void Mesh::Clear()
+{
+    mVerts.clear();
+    mTexture.clear();
+    mBlend = BLEND;
+    mLayer.Clear();
+    mCentreX = 0;
+    mCentreY = 0;
+    mRadius = 0;
+}
+
+StaticLayer* Mesh::Prepare(const Texture* texture)
+{
+    float region[4] = { 0, 0, 1, 1 };
+    bool premultiplied = Texture::Premultiplies();
+    if(texture != NULL)
+    {
+        region[0] = texture->MapU(0);
+        region[1] = texture->MapV(0);
+        region[2] = texture->MapU(1);
+        region[3] = texture->MapV(1);
+        premultiplied = texture->IsPremultiplied();
+    }
+
+    if(mLayer.VertCount() > 0
+       && premultiplied == mPremultiplied
+       && memcmp(region, mRegion, sizeof(region)) == 0)
+    {
+        return &mLayer;
+    }
+
+    const eBlendMode blend = (eBlendMode) mBlend;
+    const eBlendMode batchBlend = GraphicsPipeline::BatchBlend(blend, premultiplied);
+    const float toUV = 1.0f / PackedVertex::UV_ONE;
+    std::vector<PackedVertex> baked(mVerts);
+    for(unsigned int i = 0; i < baked.size(); i++)
+    {
+        PackedVertex& vert = baked[i];
+        vert.u = PackedVertex::PackUV(region[0] + vert.u * toUV * (region[2] - region[0]));
+        vert.v = PackedVertex::PackUV(region[1] + vert.v * toUV * (region[3] - region[1]));
+
+        if(batchBlend >= BLEND_PREMULTIPLIED)
+        {
+            float r = vert.r / 255.0f;
+            float g = vert.g / 255.0f;
+            float b = vert.b / 255.0f;
+            float a = vert.a / 255.0f;
+            GraphicsPipeline::BatchColour(blend, batchBlend, &r, &g, &b, &a);
+            vert.r = PackedVertex::PackColour(r);
+            vert.g = PackedVertex::PackColour(g);
+            vert.b = PackedVertex::PackColour(b);
+            vert.a = PackedVertex::PackColour(a);
+        }
+    }
+
+    // The texture's bound when it's drawn, its id can change under the layer.
+    mLayer.Clear();
+    mLayer.Append(&baked[0], baked.size(), GL_TRIANGLES, 0, false, batchBlend);
+    mLayer.Upload();
+    memcpy(mRegion, region, sizeof(region));
+    mPremultiplied = premultiplied;
+    return &mLayer;
+}
+
+MeshStore::~MeshStore()
+{
+    for(unsigned int i = 0; i < mMeshes.size(); i++)
+    {
+        delete mMeshes[i];
+    }
+}
+
+Mesh* MeshStore::Find(const char* name)
+{
+    Mesh** mesh = mIndex.Find(name);
+    return mesh ? *mesh : NULL;
+}
+
+void MeshStore::Reset()
+{
+    for(unsigned int i = 0; i < mMeshes.size(); i++)
+    {
+        mMeshes[i]->Reset();
+    }
+}
+
+bool MeshStore::OnAssetReload(Asset& asset)
+{
+    DDFile file(asset.Path().c_str());
+    if(!file.LoadFileView())
+    {
+        dsprintf("Mesh [%s]: couldn't read [%s].\n", asset.Name().c_str(), asset.Path().c_str());
+        return false;
+    }
+
+    Mesh* mesh = Find(asset.Name().c_str());
+    if(mesh == NULL)
+    {
+        mesh = new Mesh();
+        mMeshes.push_back(mesh);
+        mIndex.Set(asset.Name().c_str(), mesh);
+    }
+
+    std::string error;
+    if(!mesh->Read(file.Buffer(), file.Size(), asset.Flags(), &error))
+    {
+        dsprintf("Mesh [%s]: %s.\n", asset.Name().c_str(), error.c_str());
+        return false;
+    }
+    return true;
+}
+
+void MeshStore::OnAssetDestroyed(Asset& asset)
+{
+    Mesh* mesh = Find(asset.Name().c_str());
+    if(mesh)
+    {
+        mesh->Clear();
+    }
+}
\ No newline at end of file
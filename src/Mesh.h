@@ -0,0 +1,89 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "IAssetOwner.h"
+#include "NameTable.h"
+#include "StaticLayer.h"
+#include "Vertex.h"
+
+class Texture;
+
+//
+// Triangles loaded from a file and kept in a GPU buffer, for trails,
+// deformed sprites and UI shapes that would otherwise be many primitives
+// pushed from Lua. Renderer:DrawMesh draws one in a single call, moved by
+// an offset and the camera.
+//
+// The file is PackedVertex's 16 bytes a vert, three verts to a triangle,
+// the layout Renderer:DrawVertices takes in a ByteBuffer. Uvs are for the
+// whole texture. The manifest's meshes table takes:
+//
+//  texture     the texture's name, drawn untextured if not given
+//  blend       "blend", "additive", "multiply" or "screen", "blend" if not
+//              given. The colours are baked for it.
+//
+// The loaded verts are kept, the buffer is made from them when the mesh
+// is first drawn, once the texture's region is known, and again if that
+// region changes or the GL context is lost.
+//
+class Mesh
+{
+public:
+    Mesh() : mBlend(0), mPremultiplied(false), mCentreX(0), mCentreY(0), mRadius(0) {}
+
+    // False, and left empty, if the data isn't whole triangles or the
+    // keys don't make sense.
+    bool Read(const char* data,
+              unsigned int size,
+              const std::map<std::string, std::string>& flags,
+              std::string* outError);
+    void Clear();
+
+    unsigned int VertCount() const { return mVerts.size(); }
+    const std::string& TextureName() const { return mTexture; }
+    // Bounding circle of the verts, before any offset.
+    float CentreX() const { return mCentreX; }
+    float CentreY() const { return mCentreY; }
+    float Radius() const { return mRadius; }
+
+    // The layer to draw, uploaded for the texture first if it hasn't been.
+    StaticLayer* Prepare(const Texture* texture);
+    // Call when the OpenGL context has been lost.
+    void Reset() { mLayer.Reset(); }
+private:
+    std::vector<PackedVertex> mVerts; // as read, uvs for the whole texture
+    std::string mTexture;
+    int mBlend; // an eBlendMode
+    StaticLayer mLayer;
+    // What the layer was baked for.
+    float mRegion[4];
+    bool mPremultiplied;
+    float mCentreX;
+    float mCentreY;
+    float mRadius;
+};
+
+//
+// Owns every mesh by name. Like animations they're kept while the store
+// is alive, one removed from the manifest is just left empty.
+//
+class MeshStore : public IAssetOwner
+{
+    NameIndex<Mesh*> mIndex;
+    std::vector<Mesh*> mMeshes;
+public:
+    ~MeshStore();
+    Mesh* Find(const char* name);
+    // Call when the OpenGL context has been lost, meshes upload again
+    // when they're next drawn.
+    void Reset();
+
+    virtual bool OnAssetReload(Asset& asset);
+    virtual void OnAssetDestroyed(Asset& asset);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include "Metrics.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Asset.h"
+#include "DDAudio.h"
+#include "Dinodeck.h"
+#include "Game.h"
+#include "GraphicsPipeline.h"
+#include "LuaState.h"
+#include "TextureManager.h"
+
+const double Metrics::BucketLimitMs[HISTOGRAM_BUCKETS - 1] =
+{
+    4, 8.4, 16.7, 25, 33.4, 50, 100
+};
+
+static Metrics::Snapshot gSnapshot;
+static volatile unsigned int gSequence = 0;
+// Main thread only, copied into the snapshot.
+static Metrics::Snapshot gTotals;
+
+void Metrics::Publish(Dinodeck* dinodeck, double frameMs)
+{
+    Snapshot& s = gTotals;
+
+    s.frames++;
+    s.frameMs = frameMs;
+    s.frameSumMs += frameMs;
+    unsigned int bucket = 0;
+    while(bucket < HISTOGRAM_BUCKETS - 1 && frameMs > BucketLimitMs[bucket])
+    {
+        bucket++;
+    }
+    s.frameBuckets[bucket]++;
+
+    const DrawStats& draws = GraphicsPipeline::LastFrameStats();
+    s.drawCalls = draws.drawCalls;
+    s.verts = draws.verts;
+    s.textureBinds = GraphicsPipeline::GLState().LastFrameTextureBinds();
+    s.glyphUploadBytes = draws.glyphUploadBytes;
+    s.sceneGPUMs = dinodeck->SceneGPUTime();
+    s.presentGPUMs = dinodeck->PresentGPUTime();
+
+    LuaState* lua = dinodeck->GetGame()->GetLuaState();
+    s.luaKB = lua->HeapKB();
+    s.gcMs = lua->LastGCMs();
+    s.gcSumMs += s.gcMs;
+
+    TextureManager* textures = dinodeck->GetGame()->Textures();
+    s.textureKB = textures->ResidentBytes() / 1024;
+    s.textureCacheKB = textures->CachedBytes() / 1024;
+    s.textureEvictions = textures->Evictions();
+
+    DDAudio::Stats audio;
+    dinodeck->GetAudio()->GetStats(&audio);
+    const AssetReport::Totals* assets = AssetReport::LastTotals();
+    s.audioKB = (assets[Asset::Sound].memoryBytes
+                + assets[Asset::Stream].memoryBytes) / 1024;
+    s.audioPlays = audio.plays;
+    s.audioDropped = audio.dropped;
+    s.audioUnderruns = audio.streamUnderruns;
+    memcpy(s.assets, assets, sizeof(s.assets));
+
+    for(unsigned int i = 0; i < MemoryStats::MEMORY_TAG_COUNT; i++)
+    {
+        MemoryStats::eTag tag = (MemoryStats::eTag) i;
+        s.memoryKB[i] = MemoryStats::Current(tag) / 1024;
+        s.memoryPeakKB[i] = MemoryStats::Peak(tag) / 1024;
+    }
+
+    s.zoneCount = Zones::ZoneCount();
+    for(unsigned int i = 0; i < s.zoneCount; i++)
+    {
+        s.zoneNames[i] = Zones::ZoneName(i);
+        s.zoneMs[i] = Zones::LastFrameMs(i);
+    }
+
+    gSequence = gSequence + 1; // odd, being written
+    __sync_synchronize();
+    gSnapshot = s;
+    __sync_synchronize();
+    gSequence = gSequence + 1;
+}
+
+void Metrics::Read(Snapshot* out)
+{
+    for(;;)
+    {
+        const unsigned int before = gSequence;
+        __sync_synchronize();
+        *out = gSnapshot;
+        __sync_synchronize();
+        if((before & 1) == 0 && before == gSequence)
+        {
+            return;
+        }
+    }
+}
+
+std::string Metrics::Json()
+{
+    Snapshot s;
+    Read(&s);
+    std::string out;
+    char line[256];
+
+    sprintf(line, "{\"frames\":%llu,\"frame_ms\":%.3f,\"frame_sum_ms\":%.3f,\"frame_histogram\":[",
+            s.frames, s.frameMs, s.frameSumMs);
+    out += line;
+    for(unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        if(i < HISTOGRAM_BUCKETS - 1)
+        {
+            sprintf(line, "%s{\"le\":%g,\"count\":%llu}",
+                    i == 0 ? "" : ",", BucketLimitMs[i], s.frameBuckets[i]);
+        }
+        else
+        {
+            sprintf(line, ",{\"le\":null,\"count\":%llu}", s.frameBuckets[i]);
+        }
+        out += line;
+    }
+
+    sprintf(line, "],\"draw_calls\":%u,\"verts\":%u,\"texture_binds\":%u,"
+            "\"glyph_upload_bytes\":%u,"
+            "\"scene_gpu_ms\":%.3f,\"present_gpu_ms\":%.3f,",
+            s.drawCalls, s.verts, s.textureBinds, s.glyphUploadBytes,
+            s.sceneGPUMs, s.presentGPUMs);
+    out += line;
+    sprintf(line, "\"lua_kb\":%u,\"gc_ms\":%.3f,\"gc_sum_ms\":%.3f,",
+            s.luaKB, s.gcMs, s.gcSumMs);
+    out += line;
+    sprintf(line, "\"texture_kb\":%u,\"texture_cache_kb\":%u,\"texture_evictions\":%u,",
+            s.textureKB, s.textureCacheKB, s.textureEvictions);
+    out += line;
+    sprintf(line, "\"audio_kb\":%u,\"audio_plays\":%u,\"audio_dropped\":%u,"
+            "\"audio_stream_underruns\":%u,\"assets\":{",
+            s.audioKB, s.audioPlays, s.audioDropped, s.audioUnderruns);
+    out += line;
+
+    bool first = true;
+    for(unsigned int i = 0; i < AssetReport::TYPE_COUNT; i++)
+    {
+        if(Asset::TypeToStr[i][0] == '\0')
+        {
+            continue;
+        }
+        const AssetReport::Totals& t = s.assets[i];
+        sprintf(line, "%s\"%s\":{\"count\":%u,\"loads\":%u,\"load_ms\":%.3f,\"memory_kb\":%u}",
+                first ? "" : ",", Asset::TypeToStr[i],
+                t.assets, t.loads, t.loadMicroseconds / 1000.0, t.memoryBytes / 1024);
+        out += line;
+        first = false;
+    }
+
+    out += "},\"memory\":{";
+    for(unsigned int i = 0; i < MemoryStats::MEMORY_TAG_COUNT; i++)
+    {
+        sprintf(line, "%s\"%s\":{\"current_kb\":%u,\"peak_kb\":%u}",
+                i == 0 ? "" : ",", MemoryStats::TagStr[i],
+                s.memoryKB[i], s.memoryPeakKB[i]);
+        out += line;
+    }
+
+    out += "},\"zones_ms\":{";
+    for(unsigned int i = 0; i < s.zoneCount; i++)
+    {
+        sprintf(line, "%s\"%s\":%.3f", i == 0 ? "" : ",", s.zoneNames[i], s.zoneMs[i]);
+        out += line;
+    }
+    out += "}}";
+    return out;
+}
+
+std::string Metrics::Prometheus()
+{
+    Snapshot s;
+    Read(&s);
+    std::string out;
+    char line[256];
+
+    out += "# TYPE dinodeck_frame_ms histogram\n";
+    unsigned long long cumulative = 0;
+    for(unsigned int i = 0; i < HISTOGRAM_BUCKETS - 1; i++)
+    {
+        cumulative += s.frameBuckets[i];
+        sprintf(line, "dinodeck_frame_ms_bucket{le=\"%g\"} %llu\n", BucketLimitMs[i], cumulative);
+        out += line;
+    }
+    sprintf(line, "dinodeck_frame_ms_bucket{le=\"+Inf\"} %llu\n", s.frames);
+    out += line;
+    sprintf(line, "dinodeck_frame_ms_sum %.3f\ndinodeck_frame_ms_count %llu\n",
+            s.frameSumMs, s.frames);
+    out += line;
+
+    sprintf(line,
+            "# TYPE dinodeck_gc_ms_total counter\n"
+            "dinodeck_gc_ms_total %.3f\n", s.gcSumMs);
+    out += line;
+
+    struct Gauge { const char* name; double value; };
+    const Gauge gauges[] =
+    {
+        { "dinodeck_last_frame_ms", s.frameMs },
+        { "dinodeck_draw_calls", (double) s.drawCalls },
+        { "dinodeck_verts", (double) s.verts },
+        { "dinodeck_texture_binds", (double) s.textureBinds },
+        { "dinodeck_glyph_upload_bytes", (double) s.glyphUploadBytes },
+        { "dinodeck_scene_gpu_ms", s.sceneGPUMs },
+        { "dinodeck_present_gpu_ms", s.presentGPUMs },
+        { "dinodeck_lua_kb", (double) s.luaKB },
+        { "dinodeck_gc_ms", s.gcMs },
+        { "dinodeck_texture_kb", (double) s.textureKB },
+        { "dinodeck_texture_cache_kb", (double) s.textureCacheKB },
+        { "dinodeck_texture_evictions", (double) s.textureEvictions },
+        { "dinodeck_audio_kb", (double) s.audioKB },
+        { "dinodeck_audio_plays", (double) s.audioPlays },
+        { "dinodeck_audio_dropped", (double) s.audioDropped },
+        { "dinodeck_audio_stream_underruns", (double) s.audioUnderruns },
+    };
+    for(unsigned int i = 0; i < sizeof(gauges) / sizeof(gauges[0]); i++)
+    {
+        sprintf(line, "# TYPE %s gauge\n%s %g\n", gauges[i].name, gauges[i].name, gauges[i].value);
+        out += line;
+    }
+
+    const char* assetGauges[] =
+    {
+        "dinodeck_assets", "dinodeck_asset_loads", "dinodeck_asset_load_ms", "dinodeck_asset_memory_kb"
+    };
+    for(unsigned int g = 0; g < 4; g++)
+    {
+        sprintf(line, "# TYPE %s gauge\n", assetGauges[g]);
+        out += line;
+        for(unsigned int i = 0; i < AssetReport::TYPE_COUNT; i++)
+        {
+            if(Asset::TypeToStr[i][0] == '\0')
+            {
+                continue;
+            }
+            const AssetReport::Totals& t = s.assets[i];
+            double value = g == 0 ? t.assets
+                         : g == 1 ? t.loads
+                         : g == 2 ? t.loadMicroseconds / 1000.0
+                         : t.memoryBytes / 1024;
+            sprintf(line, "%s{type=\"%s\"} %g\n", assetGauges[g], Asset::TypeToStr[i], value);
+            out += line;
+        }
+    }
+
+    out += "# TYPE dinodeck_memory_kb gauge\n";
+    for(unsigned int i = 0; i < MemoryStats::MEMORY_TAG_COUNT; i++)
+    {
+        sprintf(line, "dinodeck_memory_kb{tag=\"%s\"} %u\n", MemoryStats::TagStr[i], s.memoryKB[i]);
+        out += line;
+    }
+    out += "# TYPE dinodeck_memory_peak_kb gauge\n";
+    for(unsigned int i = 0; i < MemoryStats::MEMORY_TAG_COUNT; i++)
+    {
+        sprintf(line, "dinodeck_memory_peak_kb{tag=\"%s\"} %u\n", MemoryStats::TagStr[i], s.memoryPeakKB[i]);
+        out += line;
+    }
+    out += "# TYPE dinodeck_zone_ms gauge\n";
+    for(unsigned int i = 0; i < s.zoneCount; i++)
+    {
+        sprintf(line, "dinodeck_zone_ms{zone=\"%s\"} %.3f\n", s.zoneNames[i], s.zoneMs[i]);
+        out += line;
+    }
+    return out;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <string>
+
+#include "AssetReport.h"
+#include "MemoryStats.h"
+#include "Zones.h"
+
+class Dinodeck;
+
+//
+// Engine numbers for dashboards, served on /metrics/ as JSON and on
+// /metrics/prometheus/ as Prometheus text.
+//
+// The main thread publishes a snapshot once a frame and the webserver
+// threads copy it out without locking: the sequence number is odd while
+// it's being written, so a reader that sees it change tries again.
+//
+class Metrics
+{
+public:
+    static const unsigned int HISTOGRAM_BUCKETS = 8;
+    // Bucket upper bounds, the last bucket has none.
+    static const double BucketLimitMs[HISTOGRAM_BUCKETS - 1];
+
+    struct Snapshot
+    {
+        unsigned long long frames;
+        double frameMs;
+        double frameSumMs;
+        unsigned long long frameBuckets[HISTOGRAM_BUCKETS]; // not cumulative
+        unsigned int drawCalls;
+        unsigned int verts;
+        unsigned int textureBinds;
+        unsigned int glyphUploadBytes;
+        double sceneGPUMs;
+        double presentGPUMs;
+        unsigned int luaKB;
+        double gcMs;
+        double gcSumMs;
+        unsigned int textureKB;
+        unsigned int textureCacheKB;
+        unsigned int textureEvictions;
+        unsigned int audioKB;
+        unsigned int audioPlays;
+        unsigned int audioDropped;
+        unsigned int audioUnderruns;
+        AssetReport::Totals assets[AssetReport::TYPE_COUNT];
+        unsigned int memoryKB[MemoryStats::MEMORY_TAG_COUNT];
+        unsigned int memoryPeakKB[MemoryStats::MEMORY_TAG_COUNT];
+        unsigned int zoneCount;
+        const char* zoneNames[Zones::MAX_ZONES];
+        double zoneMs[Zones::MAX_ZONES]; // over the last frame
+    };
+
+    // Main thread, at the end of each frame.
+    static void Publish(Dinodeck* dinodeck, double frameMs);
+
+    // Any thread.
+    static void Read(Snapshot* out);
+    static std::string Json();
+    static std::string Prometheus();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,404 @@
+#include "MicroBench.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+#include "DDLog.h"
+#include "DDTime.h"
+#include "Dinodeck.h"
+#include "FormatText.h"
+#include "Game.h"
+#include "GraphicsPipeline.h"
+#include "LuaState.h"
+#include "Matrix.h"
+#include "Sprite.h"
+#include "SpriteRecord.h"
+#include "Texture.h"
+#include "TextureManager.h"
+#include "Vector.h"
+
+volatile unsigned long long MicroBench::mAllocations = 0;
+bool MicroBench::mCountingAllocations = false;
+std::map<std::string, double> MicroBench::mBaseline;
+unsigned int MicroBench::mRegressions = 0;
+const double MicroBench::REGRESSION_TOLERANCE = 0.1;
+
+// Results are folded into this so the work can't be optimised away.
+static volatile double sink = 0;
+
+static const unsigned int INPUT_COUNT = 64; // a power of two
+// Filled in by Run, Matrix's constructor reads the axis vectors so
+// these can't be built during static initialisation.
+static std::vector<Vector> inputVectors;
+static std::vector<Matrix> inputMatrices;
+
+static GraphicsPipeline* pipeline = NULL;
+static Texture* spriteTexture = NULL;
+static TextureHandle spriteTextureHandle;
+static const unsigned int SPRITE_COUNT = 256; // a power of two
+static std::vector<Sprite> sprites;
+static std::vector<SpriteRecord> spriteRecords;
+
+static const char* paragraphs[] =
+{
+    "The old lighthouse keeper climbed the spiral stairs every evening, "
+    "counting each of the two hundred and twelve steps out loud, as his "
+    "father had before him.",
+    "Press the action button to talk. Some people will only speak to you "
+    "once, so listen carefully; others will repeat themselves until you "
+    "give them what they want.",
+    "Short line.",
+    "Supercalifragilisticexpialidocious words that are longer than the "
+    "wrap width still have to go somewhere.",
+};
+static const unsigned int PARAGRAPH_COUNT = sizeof(paragraphs) / sizeof(paragraphs[0]);
+static const float WRAP_WIDTH = 256;
+
+// Texture.Find needs something to find, the cases see it as
+// MicroBenchTexture.
+static const char* LUA_TEXTURE = "_microbench";
+
+//
+// Each case makes n calls to one binding. The empty loop is there so its
+// share can be taken off the others.
+//
+static const char* LUA_CASES =
+    "LoadLibrary('Renderer')\n"
+    "LoadLibrary('Sprite')\n"
+    "LoadLibrary('Texture')\n"
+    "LoadLibrary('Vector')\n"
+    "local renderer = Renderer.Create()\n"
+    "local texture = Texture.Find(MicroBenchTexture)\n"
+    "local sprite = Sprite.Create()\n"
+    "sprite:SetTexture(texture)\n"
+    "MicroBenchCases =\n"
+    "{\n"
+    "    { 'lua_loop', function(n) for i = 1, n do end end },\n"
+    "    { 'lua_renderer_draw_sprite', function(n)\n"
+    "        for i = 1, n do renderer:DrawSprite(sprite) end end },\n"
+    "    { 'lua_vector_create', function(n)\n"
+    "        for i = 1, n do Vector.Create(i, 2, 3, 4) end end },\n"
+    "    { 'lua_sprite_set_position', function(n)\n"
+    "        for i = 1, n do sprite:SetPosition(i, 2) end end },\n"
+    "    { 'lua_texture_find', function(n)\n"
+    "        for i = 1, n do Texture.Find(MicroBenchTexture) end end },\n"
+    "}\n";
+
+static void BenchVectorAdd(unsigned int ops)
+{
+    Vector result;
+    for(unsigned int i = 0; i < ops; i++)
+    {
+        Vector::Add(result, result, inputVectors[i & (INPUT_COUNT - 1)]);
+    }
+    sink += result.x;
+}
+
+static void BenchVectorMultiply(unsigned int ops)
+{
+    Vector result(1, 1, 1, 1);
+    for(unsigned int i = 0; i < ops; i++)
+    {
+        Vector::Multiply(result, result, inputVectors[i & (INPUT_COUNT - 1)]);
+    }
+    sink += result.x;
+}
+
+static void BenchVectorNormalize(unsigned int ops)
+{
+    double total = 0;
+    for(unsigned int i = 0; i < ops; i++)
+    {
+        Vector v(inputVectors[i & (INPUT_COUNT - 1)]);
+        v.Normalize3();
+        total += v.x;
+    }
+    sink += total;
+}
+
+static void BenchMatrixMultiply(unsigned int ops)
+{
+    Matrix result;
+    for(unsigned int i = 0; i < ops; i++)
+    {
+        Matrix::Multiply(result,
+                         inputMatrices[i & (INPUT_COUNT - 1)],
+                         inputMatrices[(i + 1) & (INPUT_COUNT - 1)]);
+    }
+    sink += (result * Vector::AxisX).x;
+}
+
+// Batches are recorded into the frame's command list, which is dropped
+// rather than submitted, so only the verts are made.
+static void BenchPushSprite(unsigned int ops)
+{
+    for(unsigned int i = 0; i < ops; i++)
+    {
+        pipeline->PushSprite(&sprites[i & (SPRITE_COUNT - 1)]);
+    }
+    pipeline->Flush();
+    GraphicsPipeline::DiscardFrame();
+}
+
+// The SpriteBatch path, the same sprites already in their compact form.
+static void BenchPushSpriteRecord(unsigned int ops)
+{
+    for(unsigned int i = 0; i < ops; i++)
+    {
+        pipeline->PushSprite(&spriteRecords[i & (SPRITE_COUNT - 1)]);
+    }
+    pipeline->Flush();
+    GraphicsPipeline::DiscardFrame();
+}
+
+static void BenchMeasureText(unsigned int ops)
+{
+    Font* font = pipeline->GetFont();
+    Vector size;
+    for(unsigned int i = 0; i < ops; i++)
+    {
+        FormatText::MeasureText(font, paragraphs[i % PARAGRAPH_COUNT], WRAP_WIDTH, &size);
+    }
+    sink += size.x;
+}
+
+// One op is a paragraph broken into lines.
+static void BenchNextLine(unsigned int ops)
+{
+    Font* font = pipeline->GetFont();
+    float total = 0;
+    for(unsigned int i = 0; i < ops; i++)
+    {
+        const char* text = paragraphs[i % PARAGRAPH_COUNT];
+        int lineEnd = 0;
+        do
+        {
+            int start = 0;
+            float width = 0;
+            FormatText::NextLine(font, text, lineEnd, WRAP_WIDTH, &start, &lineEnd, &width);
+            total += width;
+        } while(text[lineEnd] != '\0');
+    }
+    sink += total;
+}
+
+void MicroBench::Measure(const char* name, void (*run)(unsigned int ops), unsigned int ops)
+{
+    run(ops); // warm the caches and anything loaded lazily
+
+    unsigned long long best = 0;
+    unsigned long long allocations = 0;
+    for(unsigned int i = 0; i < ROUNDS; i++)
+    {
+        unsigned long long startAllocations = mAllocations;
+        unsigned long long start = DDTime::Microseconds();
+        run(ops);
+        unsigned long long took = DDTime::Microseconds() - start;
+        if(i == 0 || took < best)
+        {
+            best = took;
+            allocations = mAllocations - startAllocations;
+        }
+    }
+
+    Report(name, "ns_per_op", (best * 1000.0) / ops);
+    if(mCountingAllocations)
+    {
+        Report(name, "allocs_per_op", (double) allocations / ops);
+    }
+}
+
+static double LuaHeapBytes(lua_State* state)
+{
+    return lua_gc(state, LUA_GCCOUNT, 0) * 1024.0 + lua_gc(state, LUA_GCCOUNTB, 0);
+}
+
+//
+// Timed with the collector running, as it would be in a game, then once
+// more with it stopped so everything the calls allocate is still in the
+// heap to be counted.
+//
+void MicroBench::MeasureLua(LuaState* state, const char* name, int functionRef, unsigned int calls)
+{
+    lua_State* luaState = state->State();
+    if(!state->CallRegisteredFunction(functionRef, LUA_CHUNK))
+    {
+        dsprintf("MicroBench: %s failed.\n", name);
+        return;
+    }
+
+    unsigned long long best = 0;
+    for(unsigned int i = 0; i < ROUNDS; i++)
+    {
+        unsigned long long start = DDTime::Microseconds();
+        for(unsigned int done = 0; done < calls; done += LUA_CHUNK)
+        {
+            state->CallRegisteredFunction(functionRef, LUA_CHUNK);
+            // Drawing only records, keep the recording from growing.
+            GraphicsPipeline::DiscardFrame();
+        }
+        unsigned long long took = DDTime::Microseconds() - start;
+        if(i == 0 || took < best)
+        {
+            best = took;
+        }
+    }
+
+    lua_gc(luaState, LUA_GCCOLLECT, 0);
+    lua_gc(luaState, LUA_GCSTOP, 0);
+    const double before = LuaHeapBytes(luaState);
+    state->CallRegisteredFunction(functionRef, LUA_CHUNK);
+    const double after = LuaHeapBytes(luaState);
+    lua_gc(luaState, LUA_GCRESTART, 0);
+    lua_gc(luaState, LUA_GCCOLLECT, 0);
+    GraphicsPipeline::DiscardFrame();
+
+    Report(name, "ns_per_call", (best * 1000.0) / calls);
+    Report(name, "lua_bytes_per_call", std::max(0.0, after - before) / LUA_CHUNK);
+}
+
+//
+// The cases run in a state of their own, so nothing the game's scripts
+// have set up is in the way.
+//
+void MicroBench::RunLua()
+{
+    Game* game = Dinodeck::GetInstance()->GetGame();
+    game->Textures()->AddPlaceholder(LUA_TEXTURE, 32, 32);
+
+    LuaState state("MicroBench");
+    state.InjectIntoRegistry(Game::Key.Name(), (void*) game);
+    Game::Bind(&state);
+    lua_State* luaState = state.State();
+    lua_pushstring(luaState, LUA_TEXTURE);
+    lua_setglobal(luaState, "MicroBenchTexture");
+    if(!state.DoString(LUA_CASES))
+    {
+        dsprintf("MicroBench: Lua cases failed to load.\n");
+        return;
+    }
+
+    lua_getglobal(luaState, "MicroBenchCases");
+    const int count = (int) lua_objlen(luaState, -1);
+    for(int i = 1; i <= count; i++)
+    {
+        lua_rawgeti(luaState, -1, i);
+        lua_rawgeti(luaState, -1, 1);
+        std::string name = lua_tostring(luaState, -1);
+        lua_pop(luaState, 1);
+        lua_rawgeti(luaState, -1, 2);
+        int functionRef = luaL_ref(luaState, LUA_REGISTRYINDEX);
+        lua_pop(luaState, 1); // the case
+
+        MeasureLua(&state, name.c_str(), functionRef, 1000000);
+        luaL_unref(luaState, LUA_REGISTRYINDEX, functionRef);
+    }
+    lua_pop(luaState, 1); // the cases
+}
+
+bool MicroBench::LoadBaseline(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if(file == NULL)
+    {
+        dsprintf("MicroBench: Couldn't open baseline [%s]\n", path);
+        return false;
+    }
+
+    // Anything that isn't a name value pair is skipped.
+    char line[256];
+    while(fgets(line, sizeof(line), file))
+    {
+        char name[128];
+        double value = 0;
+        if(sscanf(line, "%127s %lf", name, &value) == 2)
+        {
+            mBaseline[name] = value;
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+void MicroBench::Report(const char* name, const char* unit, double value)
+{
+    char key[128];
+    snprintf(key, sizeof(key), "bench_%s_%s", name, unit);
+    printf("%s %.3f\n", key, value);
+
+    std::map<std::string, double>::const_iterator it = mBaseline.find(key);
+    if(it == mBaseline.end())
+    {
+        return;
+    }
+
+    // An allocation where there were none is always a regression.
+    const double baseline = it->second;
+    if(value > baseline * (1 + REGRESSION_TOLERANCE) && value - baseline > 0.0005)
+    {
+        printf("regressed_%s %.3f\n", key, baseline);
+        mRegressions++;
+    }
+}
+
+void MicroBench::Run()
+{
+    inputVectors.resize(INPUT_COUNT);
+    inputMatrices.resize(INPUT_COUNT);
+    for(unsigned int i = 0; i < INPUT_COUNT; i++)
+    {
+        // Varied but never zero length and never growing without bound.
+        double t = i + 1;
+        inputVectors[i].SetXyzw(1 + 0.001 * t, 1 - 0.0005 * t, 0.5 + 0.01 * t, 1);
+        inputMatrices[i].SetRotation(Vector::AxisZ, (float) t);
+    }
+
+    pipeline = new GraphicsPipeline();
+    spriteTexture = new Texture();
+    spriteTexture->SetPlaceholderSize(32, 32);
+    TextureManager* textures = Dinodeck::GetInstance()->GetGame()->Textures();
+    spriteTextureHandle = textures->AddExternal(spriteTexture);
+    sprites.resize(SPRITE_COUNT);
+    for(unsigned int i = 0; i < SPRITE_COUNT; i++)
+    {
+        // Near the centre so none are culled, every 4th rotated.
+        sprites[i].SetTexture(spriteTextureHandle);
+        sprites[i].SetPosition((double) (i % 16), (double) (i / 16));
+        sprites[i].SetRotation((i % 4) == 0 ? (double) i : 0);
+    }
+    spriteRecords.resize(SPRITE_COUNT);
+    for(unsigned int i = 0; i < SPRITE_COUNT; i++)
+    {
+        spriteRecords[i].Init(sprites[i]);
+    }
+
+    // Either way nothing recorded here is drawn.
+    const bool recording = GraphicsPipeline::IsRecordingFrames();
+    GraphicsPipeline::SetRecordFrames(true);
+
+    Measure("vector_add", BenchVectorAdd, 1000000);
+    Measure("vector_multiply", BenchVectorMultiply, 1000000);
+    Measure("vector_normalize", BenchVectorNormalize, 1000000);
+    Measure("matrix_multiply", BenchMatrixMultiply, 1000000);
+    Measure("push_sprite", BenchPushSprite, 100000);
+    Measure("push_sprite_record", BenchPushSpriteRecord, 100000);
+    Measure("measure_text", BenchMeasureText, 10000);
+    Measure("next_line", BenchNextLine, 10000);
+    RunLua();
+    if(!mBaseline.empty())
+    {
+        printf("bench_regressions %u\n", mRegressions);
+    }
+    fflush(stdout);
+
+    GraphicsPipeline::SetRecordFrames(recording);
+    delete pipeline;
+    pipeline = NULL;
+    textures->RemoveExternal(spriteTextureHandle);
+    delete spriteTexture;
+    spriteTexture = NULL;
+    sprites.clear();
+    inputVectors.clear();
+    inputMatrices.clear();
+}
\ No newline at end of file
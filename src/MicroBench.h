@@ -0,0 +1,49 @@
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <map>
+#include <string>
+
+class LuaState;
+
+//
+// For --microbench, times the engine's hot inner loops in isolation,
+// vector and matrix maths, sprite vertex generation, text measuring and
+// single calls into the Lua bindings. Prints ns/op and allocations/op,
+// one name value pair a line like Benchmark.
+//
+// Allocations are only counted in builds that link MicroBenchAlloc.cpp,
+// see the Makefile's microbench target.
+//
+class MicroBench
+{
+    static volatile unsigned long long mAllocations;
+    static bool mCountingAllocations;
+    static std::map<std::string, double> mBaseline;
+    static unsigned int mRegressions;
+public:
+    static const unsigned int ROUNDS = 5; // the fastest is reported
+    static const unsigned int LUA_CHUNK = 10000; // calls per call into a Lua case
+    // Slower than the baseline by more than this fraction is reported.
+    static const double REGRESSION_TOLERANCE;
+
+    // Called from the replaced operator new.
+    static void CountAllocation() { __sync_add_and_fetch(&mAllocations, 1); }
+    static void SetCountingAllocations(bool value) { mCountingAllocations = value; }
+    static unsigned long long Allocations() { return mAllocations; }
+
+    // A previous run's output, each result is checked against it.
+    static bool LoadBaseline(const char* path);
+
+    // Needs the engine up, the pipeline takes its font from it. Nothing
+    // is drawn.
+    static void Run();
+    static unsigned int Regressions() { return mRegressions; }
+private:
+    static void Measure(const char* name, void (*run)(unsigned int ops), unsigned int ops);
+    static void RunLua();
+    static void MeasureLua(LuaState* state, const char* name, int functionRef, unsigned int calls);
+    static void Report(const char* name, const char* unit, double value);
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "MicroBench.h"
+
+#include <new>
+#include <stdlib.h>
+
+//
+// Only linked into dinodeck_microbench. Every thread's allocations are
+// counted, the job system's workers are idle while the bench runs.
+//
+
+struct CountAllocations
+{
+    CountAllocations() { MicroBench::SetCountingAllocations(true); }
+};
+static CountAllocations countAllocations;
+
+// Dynamic exception specs are gone from C++17, the compiler's default.
+#if __cplusplus < 201103L
+#define THROWS_BAD_ALLOC throw(std::bad_alloc)
+#define NO_THROW throw()
+#else
+#define THROWS_BAD_ALLOC
+#define NO_THROW noexcept
+#endif
+
+void* operator new(size_t size) THROWS_BAD_ALLOC
+{
+    MicroBench::CountAllocation();
+    void* memory = malloc(size == 0 ? 1 : size);
+    if(memory == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](size_t size) THROWS_BAD_ALLOC
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) NO_THROW
+{
+    free(memory);
+}
+
+void operator delete[](void* memory) NO_THROW
+{
+    free(memory);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void* memory, size_t) NO_THROW
+{
+    free(memory);
+}
+
+void operator delete[](void* memory, size_t) NO_THROW
+{
+    free(memory);
+}
+#endif
\ No newline at end of file
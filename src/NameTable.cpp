@@ -0,0 +1,107 @@
+#include "NameTable.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "reflect/Reflect.h"
+
+static const unsigned int INITIAL_SLOTS = 256;
+
+std::vector<std::string>& NameTable::Names()
+{
+    static std::vector<std::string> names;
+    return names;
+}
+
+std::vector<unsigned int>& NameTable::Hashes()
+{
+    static std::vector<unsigned int> hashes;
+    return hashes;
+}
+
+std::vector<unsigned int>& NameTable::Slots()
+{
+    static std::vector<unsigned int> slots(INITIAL_SLOTS, 0);
+    return slots;
+}
+
+//
+// The slot holding the name, or the empty slot it would go in.
+// Linear probing, the table is a power of two and never more than half full.
+//
+unsigned int NameTable::Probe(const char* name, unsigned int hash)
+{
+    std::vector<unsigned int>& slots = Slots();
+    const unsigned int mask = slots.size() - 1;
+    unsigned int slot = hash & mask;
+
+    for(;;)
+    {
+        unsigned int entry = slots[slot];
+        if(entry == 0)
+        {
+            return slot;
+        }
+
+        unsigned int id = entry - 1;
+        if(Hashes()[id] == hash && strcmp(Names()[id].c_str(), name) == 0)
+        {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+void NameTable::Grow()
+{
+    std::vector<unsigned int>& slots = Slots();
+    std::vector<unsigned int> grown(slots.size() * 2, 0);
+    const unsigned int mask = grown.size() - 1;
+
+    for(unsigned int id = 0; id < Names().size(); id++)
+    {
+        unsigned int slot = Hashes()[id] & mask;
+        while(grown[slot] != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        grown[slot] = id + 1;
+    }
+    slots.swap(grown);
+}
+
+unsigned int NameTable::Intern(const char* name)
+{
+    assert(name);
+    unsigned int hash = Field::HashName(name);
+    unsigned int slot = Probe(name, hash);
+
+    if(Slots()[slot] != 0)
+    {
+        return Slots()[slot] - 1;
+    }
+
+    unsigned int id = Names().size();
+    Names().push_back(name);
+    Hashes().push_back(hash);
+    Slots()[slot] = id + 1;
+
+    if(Names().size() * 2 > Slots().size())
+    {
+        Grow();
+    }
+    return id;
+}
+
+unsigned int NameTable::Find(const char* name)
+{
+    assert(name);
+    unsigned int entry = Slots()[Probe(name, Field::HashName(name))];
+    return entry == 0 ? INVALID_ID : entry - 1;
+}
+
+const std::string& NameTable::Name(unsigned int id)
+{
+    assert(id < Names().size());
+    return Names()[id];
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef NAMETABLE_H
+#define NAMETABLE_H
+
+#include <string>
+#include <vector>
+
+//
+// Interns asset names as small integer ids. Looking up a name hashes it
+// and probes a flat table, with no std::string built. Ids are never
+// reused, so a registry can index a plain array by them and scripts can
+// hold them as handles that survive reloads.
+//
+class NameTable
+{
+public:
+    static const unsigned int INVALID_ID = 0xFFFFFFFF;
+
+    static unsigned int Intern(const char* name);
+    // INVALID_ID if the name has never been interned.
+    static unsigned int Find(const char* name);
+    static const std::string& Name(unsigned int id);
+private:
+    static std::vector<std::string>& Names();
+    static std::vector<unsigned int>& Hashes();
+    static std::vector<unsigned int>& Slots(); // id + 1, 0 is empty
+    static unsigned int Probe(const char* name, unsigned int hash);
+    static void Grow();
+};
+
+//
+// Values by interned name id, a NULL Get means it isn't there.
+//
+template <class T>
+class NameIndex
+{
+    std::vector<T> mValues;
+    std::vector<bool> mUsed;
+public:
+    T* Get(unsigned int id)
+    {
+        return (id < mUsed.size() && mUsed[id]) ? &mValues[id] : NULL;
+    }
+
+    T* Find(const char* name) { return Get(NameTable::Find(name)); }
+
+    void Set(const char* name, const T& value)
+    {
+        unsigned int id = NameTable::Intern(name);
+        if(id >= mUsed.size())
+        {
+            mValues.resize(id + 1);
+            mUsed.resize(id + 1, false);
+        }
+        mValues[id] = value;
+        mUsed[id] = true;
+    }
+
+    void Erase(const char* name)
+    {
+        unsigned int id = NameTable::Find(name);
+        if(id < mUsed.size())
+        {
+            mUsed[id] = false;
+            mValues[id] = T();
+        }
+    }
+
+    void Clear()
+    {
+        mValues.clear();
+        mUsed.clear();
+    }
+};
+
+#endif
\ No newline at end of file
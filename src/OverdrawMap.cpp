@@ -0,0 +1,59 @@
+#include "OverdrawMap.h"
+
+#include <algorithm>
+
+#include "DinodeckGL.h"
+
+// Black for untouched, then blue, cyan, green, yellow, orange and red for
+// six or more fills.
+static const unsigned int HEAT_COUNT = 7;
+static const unsigned char HeatColours[HEAT_COUNT][3] =
+{
+    {   0,   0,   0 },
+    {   0,   0, 200 },
+    {   0, 180, 200 },
+    {   0, 200,   0 },
+    { 230, 230,   0 },
+    { 255, 130,   0 },
+    { 255,   0,   0 },
+};
+
+void OverdrawMap::Measure(unsigned int width, unsigned int height, GLuint texture)
+{
+    const unsigned int pixelCount = width * height;
+    if(pixelCount == 0)
+    {
+        return;
+    }
+
+    // RGBA is the read back every GL supports.
+    mPixels.resize(pixelCount * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &mPixels[0]);
+
+    unsigned long long total = 0;
+    mMax = 0;
+    for(unsigned int i = 0; i < pixelCount; i++)
+    {
+        // Round, blending may land a step either side.
+        unsigned int fills = (mPixels[i * 4] + LAYER_VALUE / 2) / LAYER_VALUE;
+        total += fills;
+        mMax = std::max(mMax, fills);
+
+        const unsigned char* heat = HeatColours[std::min(fills, HEAT_COUNT - 1)];
+        // Packed down to RGB in place, the texture has no alpha.
+        mPixels[i * 3] = heat[0];
+        mPixels[i * 3 + 1] = heat[1];
+        mPixels[i * 3 + 2] = heat[2];
+    }
+    mAverage = (double) total / pixelCount;
+
+    GLint previous = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height,
+                    GL_RGB, GL_UNSIGNED_BYTE, &mPixels[0]);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, (GLuint) previous);
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef OVERDRAWMAP_H
+#define OVERDRAWMAP_H
+
+#include <vector>
+
+#include "DinodeckGL.h"
+
+//
+// Turns a frame drawn in the pipeline's overdraw mode into a heatmap.
+// In that mode every fragment adds LAYER_VALUE to the frame buffer, so a
+// pixel's red says how many times it was filled. Measure reads the frame
+// back, averages it and writes false colours over it, so the present
+// shows the heatmap whichever way it scales. It's a debug view, the read
+// back stalls the GPU.
+//
+class OverdrawMap
+{
+    std::vector<unsigned char> mPixels;
+    double mAverage;
+    unsigned int mMax;
+public:
+    // Fills past 255 / LAYER_VALUE saturate.
+    static const unsigned int LAYER_VALUE = 8;
+
+    OverdrawMap() :
+        mAverage(0),
+        mMax(0)
+        {}
+
+    // Reads the bottom left width x height of the bound frame buffer and
+    // replaces it in texture, the buffer's colour attachment.
+    void Measure(unsigned int width, unsigned int height, GLuint texture);
+
+    // Fills per pixel, of the last frame measured.
+    double Average() const { return mAverage; }
+    unsigned int Max() const { return mMax; }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,499 @@
+#include "ParticleEmitter.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+
+#include "DinodeckLua.h"
+#include "DDMath.h"
+#include "Dinodeck.h"
+#include "Game.h"
+#include "JobSystem.h"
+#include "LuaState.h"
+#include "Texture.h"
+
+Reflect ParticleEmitter::Meta("ParticleEmitter", ParticleEmitter::Bind);
+
+static const unsigned int DEFAULT_CAPACITY = 1024;
+
+static int lua_ParticleEmitter_Create(lua_State* state)
+{
+    int capacity = luaL_optinteger(state, 1, DEFAULT_CAPACITY);
+    capacity = std::max(1, capacity);
+
+    new (lua_newuserdata(state, sizeof(ParticleEmitter))) ParticleEmitter(capacity);
+    luaL_getmetatable(state, "ParticleEmitter");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_ParticleEmitter_gc(lua_State* state)
+{
+    ParticleEmitter* emitter = (ParticleEmitter*)lua_touserdata(state, 1);
+    assert(emitter);
+    emitter->~ParticleEmitter();
+    return 0;
+}
+
+static int lua_ParticleEmitter_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "ParticleEmitter");
+    return 1;
+}
+
+static int lua_ParticleEmitter_Update(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    // Defaults to the frame's delta time.
+    double deltaTime = luaL_optnumber(state, 2,
+        Dinodeck::GetInstance()->GetGame()->GetDeltaTime());
+    emitter->Update((float) deltaTime);
+    return 0;
+}
+
+static int lua_ParticleEmitter_Emit(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    int count = luaL_checkinteger(state, 2);
+    emitter->Emit((unsigned int) std::max(0, count));
+    return 0;
+}
+
+static int lua_ParticleEmitter_Clear(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    emitter->Clear();
+    return 0;
+}
+
+static int lua_ParticleEmitter_GetCount(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    lua_pushnumber(state, emitter->Count());
+    return 1;
+}
+
+static int lua_ParticleEmitter_SetTexture(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    // nil draws untextured squares
+    if(lua_isnil(state, 2))
+    {
+        emitter->SetTexture(TextureHandle());
+        return 0;
+    }
+
+    TextureHandle* texture = Texture::GetFuncParamHandle(state, 2);
+    if (texture == NULL)
+    {
+        return 0;
+    }
+    emitter->SetTexture(*texture);
+    return 0;
+}
+
+static int lua_ParticleEmitter_SetPosition(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    if(lua_isnumber(state, 2))
+    {
+        float x = (float) luaL_optnumber(state, 2, emitter->PositionX());
+        float y = (float) luaL_optnumber(state, 3, emitter->PositionY());
+        emitter->SetPosition(x, y);
+    }
+    else if(LuaState::IsType<Vector>(state, 2))
+    {
+        Vector* vector = (Vector*)lua_touserdata(state, 2);
+        emitter->SetPosition((float) vector->x, (float) vector->y);
+    }
+    else
+    {
+        return luaL_typerror(state, 2, "Vector or number");
+    }
+    return 0;
+}
+
+static int lua_ParticleEmitter_GetPosition(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    lua_pushnumber(state, emitter->PositionX());
+    lua_pushnumber(state, emitter->PositionY());
+    return 2;
+}
+
+static int lua_ParticleEmitter_SetRate(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    emitter->SetRate((float) luaL_checknumber(state, 2));
+    return 0;
+}
+
+static int lua_ParticleEmitter_SetLifetime(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    float min = (float) luaL_checknumber(state, 2);
+    float max = (float) luaL_optnumber(state, 3, min);
+    emitter->SetLifetime(min, max);
+    return 0;
+}
+
+static int lua_ParticleEmitter_SetSpeed(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    float min = (float) luaL_checknumber(state, 2);
+    float max = (float) luaL_optnumber(state, 3, min);
+    emitter->SetSpeed(min, max);
+    return 0;
+}
+
+static int lua_ParticleEmitter_SetDirection(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    // In degrees, spread is either side of the direction.
+    float direction = (float) luaL_checknumber(state, 2);
+    float spread = (float) luaL_optnumber(state, 3, 0);
+    emitter->SetDirection(direction, spread);
+    return 0;
+}
+
+static int lua_ParticleEmitter_SetGravity(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    float x = (float) luaL_checknumber(state, 2);
+    float y = (float) luaL_checknumber(state, 3);
+    emitter->SetGravity(x, y);
+    return 0;
+}
+
+static int lua_ParticleEmitter_SetColors(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    if(!LuaState::IsType<Vector>(state, 2))
+    {
+        return luaL_typerror(state, 2, "Vector");
+    }
+    Vector* start = (Vector*)lua_touserdata(state, 2);
+
+    // The end colour is optional, particles keep the start colour.
+    Vector* end = start;
+    if (LuaState::IsType<Vector>(state, 3))
+    {
+        end = (Vector*)lua_touserdata(state, 3);
+    }
+
+    emitter->SetColours(*start, *end);
+    return 0;
+}
+
+static int lua_ParticleEmitter_SetSizes(lua_State* state)
+{
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 1);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    float start = (float) luaL_checknumber(state, 2);
+    float end = (float) luaL_optnumber(state, 3, start);
+    emitter->SetSizes(start, end);
+    return 0;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_ParticleEmitter_Create},
+  {"__gc", lua_ParticleEmitter_gc},
+  {"__tostring", lua_ParticleEmitter_tostring},
+  {"Update", lua_ParticleEmitter_Update},
+  {"Emit", lua_ParticleEmitter_Emit},
+  {"Clear", lua_ParticleEmitter_Clear},
+  {"GetCount", lua_ParticleEmitter_GetCount},
+  {"SetTexture", lua_ParticleEmitter_SetTexture},
+  {"SetPosition", lua_ParticleEmitter_SetPosition},
+  {"GetPosition", lua_ParticleEmitter_GetPosition},
+  {"SetRate", lua_ParticleEmitter_SetRate},
+  {"SetLifetime", lua_ParticleEmitter_SetLifetime},
+  {"SetSpeed", lua_ParticleEmitter_SetSpeed},
+  {"SetDirection", lua_ParticleEmitter_SetDirection},
+  {"SetGravity", lua_ParticleEmitter_SetGravity},
+  {"SetColors", lua_ParticleEmitter_SetColors},
+  {"SetSizes", lua_ParticleEmitter_SetSizes},
+  {NULL, NULL}  /* sentinel */
+};
+
+void ParticleEmitter::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        ParticleEmitter::Meta.Name(),
+        luaBinding
+    );
+}
+
+ParticleEmitter::ParticleEmitter(unsigned int capacity) :
+    mCount(0),
+    mX(capacity),
+    mY(capacity),
+    mVelocityX(capacity),
+    mVelocityY(capacity),
+    mAge(capacity),
+    mAgeRate(capacity),
+    mTexture(),
+    mPositionX(0),
+    mPositionY(0),
+    mRate(0),
+    mEmitRemainder(0),
+    mLifetimeMin(1),
+    mLifetimeMax(1),
+    mSpeedMin(0),
+    mSpeedMax(0),
+    mDirection(0),
+    mSpread(0),
+    mGravityX(0),
+    mGravityY(0),
+    mStartColour(1, 1, 1, 1),
+    mEndColour(1, 1, 1, 1),
+    mStartSize(4),
+    mEndSize(4),
+    mRandomState(0x9E3779B9)
+{
+    assert(capacity > 0);
+}
+
+Texture* ParticleEmitter::GetTexture() const
+{
+    return Texture::Resolve(mTexture);
+}
+
+void ParticleEmitter::SetRate(float perSecond)
+{
+    mRate = std::max(perSecond, 0.0f);
+}
+
+void ParticleEmitter::SetLifetime(float min, float max)
+{
+    // A lifetime of 0 would never age.
+    const float shortest = 0.001f;
+    mLifetimeMin = std::max(min, shortest);
+    mLifetimeMax = std::max(max, mLifetimeMin);
+}
+
+void ParticleEmitter::SetDirection(float degrees, float spread)
+{
+    mDirection = DegreeToRadian(degrees);
+    mSpread = DegreeToRadian(spread);
+}
+
+void ParticleEmitter::SetColours(const Vector& start, const Vector& end)
+{
+    mStartColour.SetXyzw(start);
+    mEndColour.SetXyzw(end);
+}
+
+//
+// Xorshift, cheaper than rand() and each emitter gets its own sequence.
+//
+float ParticleEmitter::Random(float min, float max)
+{
+    mRandomState ^= mRandomState << 13;
+    mRandomState ^= mRandomState >> 17;
+    mRandomState ^= mRandomState << 5;
+    float unit = (mRandomState & 0xFFFFFF) / (float) 0x1000000;
+    return min + (max - min) * unit;
+}
+
+void ParticleEmitter::Emit(unsigned int count)
+{
+    count = std::min(count, Capacity() - mCount);
+
+    for(unsigned int i = mCount; i < mCount + count; i++)
+    {
+        float angle = mDirection + Random(-mSpread, mSpread);
+        float speed = Random(mSpeedMin, mSpeedMax);
+        mX[i] = mPositionX;
+        mY[i] = mPositionY;
+        mVelocityX[i] = cos(angle) * speed;
+        mVelocityY[i] = sin(angle) * speed;
+        mAge[i] = 0;
+        mAgeRate[i] = 1.0f / Random(mLifetimeMin, mLifetimeMax);
+    }
+    mCount += count;
+}
+
+//
+// The attribute arrays and how far to move them, for one update.
+//
+struct ParticleStep
+{
+    float* x;
+    float* y;
+    float* velocityX;
+    float* velocityY;
+    float* age;
+    const float* ageRate;
+    float gravityX;
+    float gravityY;
+    float deltaTime;
+};
+
+// Below this many particles it isn't worth waking workers.
+static const unsigned int PARALLEL_GRAIN = 4096;
+
+static void StepParticles(void* data, unsigned int begin, unsigned int end)
+{
+    const ParticleStep& step = *static_cast<ParticleStep*>(data);
+    float* x = step.x;
+    float* y = step.y;
+    float* velocityX = step.velocityX;
+    float* velocityY = step.velocityY;
+    float* age = step.age;
+    const float* ageRate = step.ageRate;
+    const float gravityX = step.gravityX;
+    const float gravityY = step.gravityY;
+    const float deltaTime = step.deltaTime;
+
+    // One attribute per loop, no branches, so each vectorizes.
+    for(unsigned int i = begin; i < end; i++)
+    {
+        velocityX[i] += gravityX;
+    }
+
+    for(unsigned int i = begin; i < end; i++)
+    {
+        velocityY[i] += gravityY;
+    }
+
+    for(unsigned int i = begin; i < end; i++)
+    {
+        x[i] += velocityX[i] * deltaTime;
+    }
+
+    for(unsigned int i = begin; i < end; i++)
+    {
+        y[i] += velocityY[i] * deltaTime;
+    }
+
+    for(unsigned int i = begin; i < end; i++)
+    {
+        age[i] += ageRate[i] * deltaTime;
+    }
+}
+
+void ParticleEmitter::Update(float deltaTime)
+{
+    if(deltaTime <= 0)
+    {
+        return;
+    }
+
+    float* x = &mX[0];
+    float* y = &mY[0];
+    float* velocityX = &mVelocityX[0];
+    float* velocityY = &mVelocityY[0];
+    float* age = &mAge[0];
+
+    ParticleStep step;
+    step.x = x;
+    step.y = y;
+    step.velocityX = velocityX;
+    step.velocityY = velocityY;
+    step.age = age;
+    step.ageRate = &mAgeRate[0];
+    step.gravityX = mGravityX * deltaTime;
+    step.gravityY = mGravityY * deltaTime;
+    step.deltaTime = deltaTime;
+
+    // Big emitters are split across the job system's workers.
+    Dinodeck::GetInstance()->GetJobs()->ParallelFor(mCount,
+                                                    PARALLEL_GRAIN,
+                                                    StepParticles,
+                                                    &step);
+
+    // Dead particles are replaced by the last live particle.
+    unsigned int i = 0;
+    while(i < mCount)
+    {
+        if(age[i] < 1.0f)
+        {
+            i++;
+            continue;
+        }
+
+        mCount--;
+        x[i] = x[mCount];
+        y[i] = y[mCount];
+        velocityX[i] = velocityX[mCount];
+        velocityY[i] = velocityY[mCount];
+        age[i] = age[mCount];
+        mAgeRate[i] = mAgeRate[mCount];
+    }
+
+    mEmitRemainder += mRate * deltaTime;
+    unsigned int emit = (unsigned int) mEmitRemainder;
+    mEmitRemainder -= emit;
+    Emit(emit);
+}
\ No newline at end of file
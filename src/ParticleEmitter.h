@@ -0,0 +1,94 @@
+#ifndef PARTICLEEMITTER_H
+#define PARTICLEEMITTER_H
+
+#include <vector>
+
+#include "reflect/Reflect.h"
+#include "TextureHandle.h"
+#include "Vector.h"
+
+class LuaState;
+class Texture;
+
+//
+// Particles simulated and drawn natively, so Lua only sets parameters
+// and thousands of particles don't live on the GC heap.
+//
+// Particles are stored as separate arrays per attribute and updated
+// in one pass per attribute, loops simple enough for the compiler to
+// vectorize. Age runs from 0 at birth to 1 at death, colour and size are
+// blended from their start to end values over it.
+//
+class ParticleEmitter
+{
+    public: static Reflect Meta;
+    public:
+        static void Bind(LuaState* state);
+
+        ParticleEmitter(unsigned int capacity);
+
+        // Moves the live particles on, removes the dead and emits at
+        // the emitter's rate.
+        void Update(float deltaTime);
+
+        // Emits as many of count as there's room for.
+        void Emit(unsigned int count);
+        void Clear() { mCount = 0; }
+        unsigned int Count() const { return mCount; }
+        unsigned int Capacity() const { return mX.size(); }
+
+        void SetTexture(TextureHandle texture) { mTexture = texture; }
+        // NULL if untextured or the texture's been destroyed.
+        Texture* GetTexture() const;
+        void SetPosition(float x, float y) { mPositionX = x; mPositionY = y; }
+        float PositionX() const { return mPositionX; }
+        float PositionY() const { return mPositionY; }
+        void SetRate(float perSecond);
+        void SetLifetime(float min, float max);
+        void SetSpeed(float min, float max) { mSpeedMin = min; mSpeedMax = max; }
+        void SetDirection(float degrees, float spread);
+        void SetGravity(float x, float y) { mGravityX = x; mGravityY = y; }
+        void SetColours(const Vector& start, const Vector& end);
+        void SetSizes(float start, float end) { mStartSize = start; mEndSize = end; }
+
+        // Per particle arrays, Count() long.
+        const float* X() const { return &mX[0]; }
+        const float* Y() const { return &mY[0]; }
+        const float* Age() const { return &mAge[0]; }
+
+        const Vector& StartColour() const { return mStartColour; }
+        const Vector& EndColour() const { return mEndColour; }
+        float StartSize() const { return mStartSize; }
+        float EndSize() const { return mEndSize; }
+    private:
+        unsigned int mCount;
+        std::vector<float> mX;
+        std::vector<float> mY;
+        std::vector<float> mVelocityX;
+        std::vector<float> mVelocityY;
+        std::vector<float> mAge;
+        std::vector<float> mAgeRate; // 1 / lifetime
+
+        TextureHandle mTexture; // null draws untextured squares
+        float mPositionX;
+        float mPositionY;
+        float mRate; // particles a second
+        float mEmitRemainder; // part particles carried between updates
+        float mLifetimeMin;
+        float mLifetimeMax;
+        float mSpeedMin;
+        float mSpeedMax;
+        float mDirection; // radians
+        float mSpread; // radians, either side of the direction
+        float mGravityX;
+        float mGravityY;
+        Vector mStartColour;
+        Vector mEndColour;
+        float mStartSize;
+        float mEndSize;
+        unsigned int mRandomState;
+
+        float Random(float min, float max);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "PathCache.h"
+
+#include <map>
+#include <string.h>
+
+#include "FileWatcher.h"
+#include "Threading.h"
+
+namespace
+{
+    struct PathEntry
+    {
+        bool statted;
+        bool found;
+        struct stat info;
+        bool archiveKnown;
+        bool archived;
+
+        PathEntry() :
+            statted(false),
+            found(false),
+            archiveKnown(false),
+            archived(false) {}
+    };
+}
+
+// Sounds and texture decodes resolve files off the main thread.
+static Mutex& PathsMutex()
+{
+    static Mutex mutex;
+    return mutex;
+}
+
+static std::map<std::string, PathEntry>& Paths()
+{
+    static std::map<std::string, PathEntry> paths;
+    return paths;
+}
+
+bool PathCache::Stat(const char* path, struct stat* out)
+{
+    {
+        ScopedLock lock(PathsMutex());
+        std::map<std::string, PathEntry>::const_iterator it = Paths().find(path);
+        if(it != Paths().end() && it->second.statted)
+        {
+            *out = it->second.info;
+            return it->second.found;
+        }
+    }
+
+    // Probed unlocked, two threads asking at once both stat the file.
+    struct stat info;
+    const bool found = stat(path, &info) == 0;
+    if(!found)
+    {
+        memset(&info, 0, sizeof(info));
+    }
+
+    ScopedLock lock(PathsMutex());
+    PathEntry& entry = Paths()[path];
+    entry.statted = true;
+    entry.found = found;
+    entry.info = info;
+    *out = info;
+    return found;
+}
+
+bool PathCache::FindArchived(const char* path, bool* outArchived)
+{
+    ScopedLock lock(PathsMutex());
+    std::map<std::string, PathEntry>::const_iterator it = Paths().find(path);
+    if(it == Paths().end() || !it->second.archiveKnown)
+    {
+        return false;
+    }
+    *outArchived = it->second.archived;
+    return true;
+}
+
+void PathCache::SetArchived(const char* path, bool archived)
+{
+    ScopedLock lock(PathsMutex());
+    PathEntry& entry = Paths()[path];
+    entry.archiveKnown = true;
+    entry.archived = archived;
+}
+
+void PathCache::BeginReload(const FileWatcher& watcher)
+{
+    ScopedLock lock(PathsMutex());
+    std::map<std::string, PathEntry>& paths = Paths();
+    std::map<std::string, PathEntry>::iterator it = paths.begin();
+    while(it != paths.end())
+    {
+        if(watcher.IsWatched(it->first) && !watcher.IsDirty(it->first))
+        {
+            ++it;
+        }
+        else
+        {
+            paths.erase(it++);
+        }
+    }
+}
\ No newline at end of file
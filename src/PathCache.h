@@ -0,0 +1,29 @@
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include <string>
+#include <sys/stat.h>
+
+class FileWatcher;
+
+//
+// What the filesystem said about each path, so that an asset reload
+// probes each file once. Without it, each asset is stat'ed by the store.
+// The loader then checks the same path again with stat and PhysFS.
+//
+// Entries last until the next reload. That drops everything, except
+// watched files that have no change event since.
+//
+class PathCache
+{
+public:
+    // Any thread. A cached stat, false if the path isn't on disk.
+    static bool Stat(const char* path, struct stat* out);
+    // Any thread. False if it's not known whether PhysFS has the path.
+    static bool FindArchived(const char* path, bool* outArchived);
+    static void SetArchived(const char* path, bool archived);
+
+    static void BeginReload(const FileWatcher& watcher);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,476 @@
+#include "PathGrid.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "DinodeckLua.h"
+#include "Game.h"
+#include "LuaState.h"
+#include "ScriptJobs.h"
+
+Reflect PathGrid::Meta("PathGrid", PathGrid::Bind);
+
+PathGrid::Data::Data(int width, int height) :
+    mRefs(1),
+    mWidth(width),
+    mHeight(height),
+    mCosts(width * height, 1),
+    mRegions(),
+    mMinCost(1),
+    mPrepared(false),
+    mScratchMutex(),
+    mScratch()
+{
+}
+
+PathGrid::Data::~Data()
+{
+    for(unsigned int i = 0; i < mScratch.size(); i++)
+    {
+        delete mScratch[i];
+    }
+}
+
+PathGrid::Data* PathGrid::Data::Create(int width, int height)
+{
+    assert(width > 0 && height > 0);
+    return new Data(width, height);
+}
+
+PathGrid::Data* PathGrid::Data::Clone() const
+{
+    Data* data = new Data(mWidth, mHeight);
+    data->mCosts = mCosts;
+    data->mRegions = mRegions;
+    data->mMinCost = mMinCost;
+    data->mPrepared = mPrepared;
+    return data;
+}
+
+void PathGrid::Data::SetCost(int cell, float cost)
+{
+    assert(!IsShared());
+    if(mCosts[cell] != cost)
+    {
+        mCosts[cell] = cost;
+        mPrepared = false;
+    }
+}
+
+void PathGrid::Data::Prepare()
+{
+    if(mPrepared)
+    {
+        return;
+    }
+
+    const int cells = mWidth * mHeight;
+    mMinCost = 0;
+    for(int i = 0; i < cells; i++)
+    {
+        if(mCosts[i] > 0 && (mMinCost == 0 || mCosts[i] < mMinCost))
+        {
+            mMinCost = mCosts[i];
+        }
+    }
+
+    // Flood fill each region in turn.
+    mRegions.assign(cells, 0);
+    std::vector<int> stack;
+    int region = 0;
+    for(int i = 0; i < cells; i++)
+    {
+        if(mCosts[i] <= 0 || mRegions[i] != 0)
+        {
+            continue;
+        }
+
+        region++;
+        mRegions[i] = region;
+        stack.push_back(i);
+        while(!stack.empty())
+        {
+            const int cell = stack.back();
+            stack.pop_back();
+            const int x = cell % mWidth;
+            const int y = cell / mWidth;
+            const int neighbours[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+            for(int n = 0; n < 4; n++)
+            {
+                const int nx = x + neighbours[n][0];
+                const int ny = y + neighbours[n][1];
+                if(nx < 0 || ny < 0 || nx >= mWidth || ny >= mHeight)
+                {
+                    continue;
+                }
+                const int next = ny * mWidth + nx;
+                if(mCosts[next] > 0 && mRegions[next] == 0)
+                {
+                    mRegions[next] = region;
+                    stack.push_back(next);
+                }
+            }
+        }
+    }
+    mPrepared = true;
+}
+
+bool PathGrid::Data::IsReachable(int start, int end) const
+{
+    assert(mPrepared);
+    return mRegions[start] != 0 && mRegions[start] == mRegions[end];
+}
+
+float PathGrid::Data::Estimate(int cell, int end) const
+{
+    const int dx = abs((cell % mWidth) - (end % mWidth));
+    const int dy = abs((cell / mWidth) - (end / mWidth));
+    return (dx + dy) * mMinCost;
+}
+
+// Heap order, cheapest estimate first. On a tie the cell furthest along
+// goes first, which saves opening cells across open ground.
+bool PathGrid::Data::Later(const Open& a, const Open& b)
+{
+    if(a.estimate != b.estimate)
+    {
+        return a.estimate > b.estimate;
+    }
+    return a.cost < b.cost;
+}
+
+bool PathGrid::Data::Search(int start, int end, std::vector<int>* path)
+{
+    assert(path);
+    if(!IsReachable(start, end))
+    {
+        return false;
+    }
+
+    const int cells = mWidth * mHeight;
+    Scratch* scratch = NULL;
+    {
+        ScopedLock lock(mScratchMutex);
+        if(!mScratch.empty())
+        {
+            scratch = mScratch.back();
+            mScratch.pop_back();
+        }
+    }
+    if(scratch == NULL)
+    {
+        scratch = new Scratch();
+        scratch->cost.resize(cells);
+        scratch->from.resize(cells);
+        scratch->stamp.resize(cells, 0);
+        scratch->search = 0;
+    }
+
+    scratch->search++;
+    if(scratch->search == 0)
+    {
+        // Wrapped, old stamps could match again.
+        std::fill(scratch->stamp.begin(), scratch->stamp.end(), 0);
+        scratch->search = 1;
+    }
+    const unsigned int search = scratch->search;
+    std::vector<float>& cost = scratch->cost;
+    std::vector<int>& from = scratch->from;
+    std::vector<unsigned int>& stamp = scratch->stamp;
+    std::vector<Open>& open = scratch->open;
+    open.clear();
+
+    stamp[start] = search;
+    cost[start] = 0;
+    from[start] = -1;
+    Open first = { Estimate(start, end), 0, start };
+    open.push_back(first);
+
+    bool found = false;
+    while(!open.empty())
+    {
+        std::pop_heap(open.begin(), open.end(), Later);
+        const Open current = open.back();
+        open.pop_back();
+
+        if(current.cell == end)
+        {
+            found = true;
+            break;
+        }
+
+        // Already reached more cheaply.
+        if(current.cost > cost[current.cell])
+        {
+            continue;
+        }
+
+        const int x = current.cell % mWidth;
+        const int y = current.cell / mWidth;
+        const int neighbours[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+        for(int i = 0; i < 4; i++)
+        {
+            const int nx = x + neighbours[i][0];
+            const int ny = y + neighbours[i][1];
+            if(nx < 0 || ny < 0 || nx >= mWidth || ny >= mHeight)
+            {
+                continue;
+            }
+
+            const int next = ny * mWidth + nx;
+            if(mCosts[next] <= 0)
+            {
+                continue;
+            }
+
+            const float nextCost = current.cost + mCosts[next];
+            if(stamp[next] != search || nextCost < cost[next])
+            {
+                stamp[next] = search;
+                cost[next] = nextCost;
+                from[next] = current.cell;
+                Open entry = { nextCost + Estimate(next, end), nextCost, next };
+                open.push_back(entry);
+                std::push_heap(open.begin(), open.end(), Later);
+            }
+        }
+    }
+
+    if(found)
+    {
+        path->clear();
+        for(int cell = end; cell != -1; cell = from[cell])
+        {
+            // Back in 1 based script coordinates, reversed below.
+            path->push_back(cell / mWidth + 1);
+            path->push_back(cell % mWidth + 1);
+        }
+        std::reverse(path->begin(), path->end());
+    }
+
+    {
+        ScopedLock lock(mScratchMutex);
+        mScratch.push_back(scratch);
+    }
+    return found;
+}
+
+PathGrid::PathGrid(int width, int height) :
+    mData(Data::Create(width, height))
+{
+}
+
+PathGrid::~PathGrid()
+{
+    mData->Release();
+}
+
+PathGrid::Data* PathGrid::EditData()
+{
+    if(mData->IsShared())
+    {
+        Data* copy = mData->Clone();
+        mData->Release();
+        mData = copy;
+    }
+    return mData;
+}
+
+//
+// Lua binding. Coordinates start at 1.
+//
+
+static int CheckCell(lua_State* state, const PathGrid::Data* data, int index)
+{
+    const int x = luaL_checkinteger(state, index);
+    const int y = luaL_checkinteger(state, index + 1);
+    if(x < 1 || y < 1 || x > data->Width() || y > data->Height())
+    {
+        luaL_argerror(state, index, "cell isn't in the grid");
+    }
+    return (y - 1) * data->Width() + (x - 1);
+}
+
+// Fills the grid from a table of width * height costs, row by row.
+static void SetCosts(lua_State* state, PathGrid::Data* data, int index)
+{
+    luaL_checktype(state, index, LUA_TTABLE);
+    const int cells = data->Width() * data->Height();
+    if((int) lua_objlen(state, index) < cells)
+    {
+        luaL_error(state, "PathGrid: costs has fewer than %d cells.", cells);
+    }
+
+    for(int i = 0; i < cells; i++)
+    {
+        lua_rawgeti(state, index, i + 1);
+        data->SetCost(i, (float) lua_tonumber(state, -1));
+        lua_pop(state, 1);
+    }
+}
+
+// PathGrid.Create(width, height, [costs])
+// Without costs every cell costs 1.
+static int lua_PathGrid_Create(lua_State* state)
+{
+    const int width = luaL_checkinteger(state, 1);
+    const int height = luaL_checkinteger(state, 2);
+    if(width <= 0 || height <= 0
+       || (unsigned int) width * height > ScriptJobs::MAX_GRID_CELLS)
+    {
+        return luaL_error(state, "PathGrid: grid must be between 1 and %d cells.",
+                          (int) ScriptJobs::MAX_GRID_CELLS);
+    }
+
+    PathGrid* grid = new (lua_newuserdata(state, sizeof(PathGrid))) PathGrid(width, height);
+    luaL_getmetatable(state, "PathGrid");
+    lua_setmetatable(state, -2);
+
+    if(!lua_isnoneornil(state, 3))
+    {
+        SetCosts(state, grid->EditData(), 3);
+    }
+    return 1;
+}
+
+static int lua_PathGrid_gc(lua_State* state)
+{
+    PathGrid* grid = (PathGrid*)lua_touserdata(state, 1);
+    assert(grid);
+    grid->~PathGrid();
+    return 0;
+}
+
+static int lua_PathGrid_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "PathGrid");
+    return 1;
+}
+
+// grid:SetCost(x, y, cost), 0 or less is a wall.
+static int lua_PathGrid_SetCost(lua_State* state)
+{
+    PathGrid* grid = LuaState::GetFuncParam<PathGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    const int cell = CheckCell(state, grid->GetData(), 2);
+    const float cost = (float) luaL_checknumber(state, 4);
+    if(grid->GetData()->GetCost(cell) != cost)
+    {
+        grid->EditData()->SetCost(cell, cost);
+    }
+    return 0;
+}
+
+static int lua_PathGrid_GetCost(lua_State* state)
+{
+    PathGrid* grid = LuaState::GetFuncParam<PathGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    const int cell = CheckCell(state, grid->GetData(), 2);
+    lua_pushnumber(state, grid->GetData()->GetCost(cell));
+    return 1;
+}
+
+// grid:SetCosts(costs), width * height costs row by row.
+static int lua_PathGrid_SetCosts(lua_State* state)
+{
+    PathGrid* grid = LuaState::GetFuncParam<PathGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    SetCosts(state, grid->EditData(), 2);
+    return 0;
+}
+
+static int lua_PathGrid_GetSize(lua_State* state)
+{
+    PathGrid* grid = LuaState::GetFuncParam<PathGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    lua_pushinteger(state, grid->GetData()->Width());
+    lua_pushinteger(state, grid->GetData()->Height());
+    return 2;
+}
+
+// grid:IsReachable(startX, startY, endX, endY)
+static int lua_PathGrid_IsReachable(lua_State* state)
+{
+    PathGrid* grid = LuaState::GetFuncParam<PathGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    PathGrid::Data* data = grid->GetData();
+    const int start = CheckCell(state, data, 2);
+    const int end = CheckCell(state, data, 4);
+    if(!data->IsPrepared())
+    {
+        data = grid->EditData();
+        data->Prepare();
+    }
+    lua_pushboolean(state, data->IsReachable(start, end));
+    return 1;
+}
+
+// grid:FindPath(startX, startY, endX, endY, callback)
+// The callback gets { x1, y1, x2, y2, ... } from start to end, or nil if
+// there's no way through. Returns the job id, as Jobs.FindPath does.
+static int lua_PathGrid_FindPath(lua_State* state)
+{
+    PathGrid* grid = LuaState::GetFuncParam<PathGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    PathGrid::Data* data = grid->GetData();
+    const int start = CheckCell(state, data, 2);
+    const int end = CheckCell(state, data, 4);
+    luaL_checktype(state, 6, LUA_TFUNCTION);
+
+    if(!data->IsPrepared())
+    {
+        data = grid->EditData();
+        data->Prepare();
+    }
+
+    lua_pushvalue(state, 6);
+    int callbackRef = luaL_ref(state, LUA_REGISTRYINDEX);
+
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    assert(game);
+    data->AddRef();
+    unsigned int id = game->GetScriptJobs()->FindPath(data, start, end, callbackRef);
+    lua_pushinteger(state, id);
+    return 1;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_PathGrid_Create},
+  {"__gc", lua_PathGrid_gc},
+  {"__tostring", lua_PathGrid_tostring},
+  {"SetCost", lua_PathGrid_SetCost},
+  {"GetCost", lua_PathGrid_GetCost},
+  {"SetCosts", lua_PathGrid_SetCosts},
+  {"GetSize", lua_PathGrid_GetSize},
+  {"IsReachable", lua_PathGrid_IsReachable},
+  {"FindPath", lua_PathGrid_FindPath},
+  {NULL, NULL}  /* sentinel */
+};
+
+void PathGrid::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        PathGrid::Meta.Name(),
+        luaBinding
+    );
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#ifndef PATHGRID_H
+#define PATHGRID_H
+
+#include <vector>
+
+#include "reflect/Reflect.h"
+#include "Threading.h"
+
+class LuaState;
+struct lua_State;
+
+//
+// A tile grid for path finding that scripts fill once and search many
+// times. Searches run on the job system and call back through ScriptJobs.
+//
+// Cells cost 0 or less are walls. Cells joined four way are grouped into
+// regions up front, so asking for a path that can't exist is answered
+// without searching the map.
+//
+class PathGrid
+{
+    public: static Reflect Meta;
+    public:
+        //
+        // The costs and the regions worked out from them. Searches in
+        // flight hold a reference and only read it, edits made while it's
+        // shared go to a copy. Any thread may Release, the last one
+        // deletes it.
+        //
+        class Data
+        {
+            struct Open
+            {
+                float estimate; // total through this cell
+                float cost;     // to reach it
+                int cell;
+            };
+            // Search state, reused between searches so they don't
+            // allocate once warm. Cells are only valid when stamped with
+            // the current search.
+            struct Scratch
+            {
+                std::vector<float> cost;
+                std::vector<int> from;
+                std::vector<unsigned int> stamp;
+                std::vector<Open> open;
+                unsigned int search;
+            };
+            static bool Later(const Open& a, const Open& b);
+
+            volatile int mRefs;
+            int mWidth;
+            int mHeight;
+            std::vector<float> mCosts;
+            std::vector<int> mRegions; // 0 for walls
+            float mMinCost;
+            bool mPrepared;
+            Mutex mScratchMutex;
+            std::vector<Scratch*> mScratch;
+
+            Data(int width, int height);
+            ~Data();
+            Data(const Data&);
+            Data& operator=(const Data&);
+
+            float Estimate(int cell, int end) const;
+        public:
+            // Every cell costs 1.
+            static Data* Create(int width, int height);
+            Data* Clone() const;
+            void AddRef() { __sync_add_and_fetch(&mRefs, 1); }
+            void Release()
+            {
+                if(__sync_sub_and_fetch(&mRefs, 1) == 0)
+                {
+                    delete this;
+                }
+            }
+            // Only the main thread adds references, so this is safe there.
+            bool IsShared() const { return mRefs > 1; }
+
+            int Width() const { return mWidth; }
+            int Height() const { return mHeight; }
+            float GetCost(int cell) const { return mCosts[cell]; }
+            void SetCost(int cell, float cost);
+
+            // Works out the regions. Call before sharing, Search needs it.
+            void Prepare();
+            bool IsPrepared() const { return mPrepared; }
+            bool IsReachable(int start, int end) const;
+            // A* four way, with the manhattan distance at the cheapest
+            // cost so the path found is the cheapest. The path is 1 based
+            // x, y pairs from start to end. Any number of threads may
+            // search at once.
+            bool Search(int start, int end, std::vector<int>* path);
+        };
+
+        static void Bind(LuaState* state);
+
+        PathGrid(int width, int height);
+        ~PathGrid();
+
+        Data* GetData() { return mData; }
+        // Copies the data first if a search is using it.
+        Data* EditData();
+    private:
+        Data* mData;
+
+        PathGrid(const PathGrid&);
+        PathGrid& operator=(const PathGrid&);
+};
+
+#endif
\ No newline at end of file
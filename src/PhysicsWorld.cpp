@@ -0,0 +1,1152 @@
+#include "PhysicsWorld.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+
+#include "DinodeckLua.h"
+#include "Game.h"
+#include "LuaState.h"
+#include "Sprite.h"
+
+Reflect PhysicsWorld::Meta("PhysicsWorld", PhysicsWorld::Bind);
+
+// Overlap allowed before positions are pushed apart, it keeps resting
+// contacts from jittering in and out of touch.
+static const float SLOP = 0.01f;
+// How much of the remaining overlap each step removes.
+static const float CORRECTION = 0.8f;
+
+PhysicsWorld::Body::Body() :
+    shape(SHAPE_CIRCLE),
+    type(BODY_DYNAMIC),
+    x(0), y(0),
+    lastX(0), lastY(0),
+    vx(0), vy(0),
+    fx(0), fy(0),
+    radius(0),
+    halfWidth(0), halfHeight(0),
+    pointCount(0),
+    invMass(1),
+    restitution(0),
+    friction(0.2f),
+    gravityScale(1),
+    sprite(NULL),
+    spriteRef(LUA_NOREF),
+    alive(true)
+{
+}
+
+PhysicsWorld::PhysicsWorld(float gravityX, float gravityY, float cellSize) :
+    mGrid(cellSize, SpatialGrid::DEFAULT_BUCKETS),
+    mGravityX(gravityX),
+    mGravityY(gravityY),
+    mRestingSpeed(0),
+    mCount(0)
+{
+}
+
+unsigned int PhysicsWorld::Add(const Body& body)
+{
+    unsigned int index;
+    if(mFree.empty())
+    {
+        index = mBodies.size();
+        mBodies.push_back(body);
+    }
+    else
+    {
+        index = mFree.back();
+        mFree.pop_back();
+        mBodies[index] = body;
+    }
+
+    Body& added = mBodies[index];
+    added.alive = true;
+    added.lastX = added.x;
+    added.lastY = added.y;
+    if(added.type != BODY_DYNAMIC)
+    {
+        added.invMass = 0;
+    }
+    mCount++;
+    return index;
+}
+
+void PhysicsWorld::Remove(unsigned int body)
+{
+    if(!IsBody(body))
+    {
+        return;
+    }
+    mBodies[body] = Body();
+    mBodies[body].alive = false;
+    mFree.push_back(body);
+    mCount--;
+}
+
+bool PhysicsWorld::IsBody(unsigned int body) const
+{
+    return body < mBodies.size() && mBodies[body].alive;
+}
+
+bool PhysicsWorld::SetPolygon(Body* body, const float* points, unsigned int count)
+{
+    assert(body);
+    assert(points);
+    if(count < 3 || count > MAX_POLYGON_POINTS)
+    {
+        return false;
+    }
+
+    // Twice the signed area, negative when the points run clockwise.
+    float area = 0;
+    for(unsigned int i = 0; i < count; i++)
+    {
+        const unsigned int j = (i + 1) % count;
+        area += points[i * 2] * points[j * 2 + 1] - points[j * 2] * points[i * 2 + 1];
+    }
+    if(!(area != 0))
+    {
+        return false;
+    }
+
+    float ordered[MAX_POLYGON_POINTS * 2];
+    for(unsigned int i = 0; i < count; i++)
+    {
+        const unsigned int from = area > 0 ? i : count - 1 - i;
+        ordered[i * 2] = points[from * 2];
+        ordered[i * 2 + 1] = points[from * 2 + 1];
+    }
+
+    // Convex if every point is on or inside every edge, which also turns
+    // away shapes that wind round twice.
+    for(unsigned int i = 0; i < count; i++)
+    {
+        const unsigned int j = (i + 1) % count;
+        const float ex = ordered[j * 2] - ordered[i * 2];
+        const float ey = ordered[j * 2 + 1] - ordered[i * 2 + 1];
+        if(ex == 0 && ey == 0)
+        {
+            return false;
+        }
+        for(unsigned int k = 0; k < count; k++)
+        {
+            const float px = ordered[k * 2] - ordered[i * 2];
+            const float py = ordered[k * 2 + 1] - ordered[i * 2 + 1];
+            if(ex * py - ey * px < 0)
+            {
+                return false;
+            }
+        }
+    }
+
+    body->shape = SHAPE_POLYGON;
+    body->pointCount = count;
+    body->halfWidth = 0;
+    body->halfHeight = 0;
+    for(unsigned int i = 0; i < count; i++)
+    {
+        body->points[i * 2] = ordered[i * 2];
+        body->points[i * 2 + 1] = ordered[i * 2 + 1];
+        body->halfWidth = std::max(body->halfWidth, fabsf(ordered[i * 2]));
+        body->halfHeight = std::max(body->halfHeight, fabsf(ordered[i * 2 + 1]));
+    }
+    return true;
+}
+
+void PhysicsWorld::GetBox(const Body& body, SpatialGrid::Box* box) const
+{
+    float halfWidth = body.radius;
+    float halfHeight = body.radius;
+    if(body.shape != SHAPE_CIRCLE)
+    {
+        halfWidth = body.halfWidth;
+        halfHeight = body.halfHeight;
+    }
+    box->minX = body.x - halfWidth;
+    box->minY = body.y - halfHeight;
+    box->maxX = body.x + halfWidth;
+    box->maxY = body.y + halfHeight;
+}
+
+static float Clamp(float value, float low, float high)
+{
+    return std::max(low, std::min(value, high));
+}
+
+static float Sign(float value)
+{
+    return value < 0 ? -1.0f : 1.0f;
+}
+
+// The normal points from the box to the circle.
+static bool CollideBoxCircle(const PhysicsWorld::Body& box,
+                             const PhysicsWorld::Body& circle,
+                             float* nx, float* ny, float* penetration)
+{
+    const float dx = circle.x - box.x;
+    const float dy = circle.y - box.y;
+    const float closestX = Clamp(dx, -box.halfWidth, box.halfWidth);
+    const float closestY = Clamp(dy, -box.halfHeight, box.halfHeight);
+
+    if(closestX == dx && closestY == dy)
+    {
+        // The centre is inside the box, leave by the nearest side.
+        const float overlapX = box.halfWidth - fabsf(dx);
+        const float overlapY = box.halfHeight - fabsf(dy);
+        if(overlapX < overlapY)
+        {
+            *nx = Sign(dx);
+            *ny = 0;
+            *penetration = overlapX + circle.radius;
+        }
+        else
+        {
+            *nx = 0;
+            *ny = Sign(dy);
+            *penetration = overlapY + circle.radius;
+        }
+        return true;
+    }
+
+    const float ox = dx - closestX;
+    const float oy = dy - closestY;
+    const float distanceSq = ox * ox + oy * oy;
+    if(distanceSq > circle.radius * circle.radius)
+    {
+        return false;
+    }
+    const float distance = sqrtf(distanceSq);
+    *nx = ox / distance;
+    *ny = oy / distance;
+    *penetration = circle.radius - distance;
+    return true;
+}
+
+// A box or polygon's corners in world space, counter clockwise.
+// Returns how many there are.
+static unsigned int WorldPoints(const PhysicsWorld::Body& body, float* out)
+{
+    if(body.shape == PhysicsWorld::SHAPE_BOX)
+    {
+        const float corners[8] =
+        {
+            -body.halfWidth, -body.halfHeight,
+            body.halfWidth, -body.halfHeight,
+            body.halfWidth, body.halfHeight,
+            -body.halfWidth, body.halfHeight
+        };
+        for(unsigned int i = 0; i < 4; i++)
+        {
+            out[i * 2] = body.x + corners[i * 2];
+            out[i * 2 + 1] = body.y + corners[i * 2 + 1];
+        }
+        return 4;
+    }
+
+    assert(body.shape == PhysicsWorld::SHAPE_POLYGON);
+    for(unsigned int i = 0; i < body.pointCount; i++)
+    {
+        out[i * 2] = body.x + body.points[i * 2];
+        out[i * 2 + 1] = body.y + body.points[i * 2 + 1];
+    }
+    return body.pointCount;
+}
+
+// The outward normal of the edge from point i to the next.
+static void EdgeNormal(const float* points, unsigned int count, unsigned int i,
+                       float* nx, float* ny)
+{
+    const unsigned int j = (i + 1) % count;
+    const float ex = points[j * 2] - points[i * 2];
+    const float ey = points[j * 2 + 1] - points[i * 2 + 1];
+    const float length = sqrtf(ex * ex + ey * ey);
+    *nx = ey / length;
+    *ny = -ex / length;
+}
+
+// The furthest apart the polygons are along any of a's edge normals,
+// negative if they overlap along all of them.
+static float MaxSeparation(const float* a, unsigned int countA,
+                           const float* b, unsigned int countB,
+                           float* nx, float* ny)
+{
+    float best = -FLT_MAX;
+    for(unsigned int i = 0; i < countA; i++)
+    {
+        float edgeX = 0;
+        float edgeY = 0;
+        EdgeNormal(a, countA, i, &edgeX, &edgeY);
+
+        // The deepest of b's points past the edge.
+        float separation = FLT_MAX;
+        for(unsigned int j = 0; j < countB; j++)
+        {
+            separation = std::min(separation,
+                                  edgeX * (b[j * 2] - a[i * 2])
+                                  + edgeY * (b[j * 2 + 1] - a[i * 2 + 1]));
+        }
+
+        if(separation > best)
+        {
+            best = separation;
+            *nx = edgeX;
+            *ny = edgeY;
+        }
+    }
+    return best;
+}
+
+// Separating axes, the edge normals of both. The normal points from a
+// to b.
+static bool CollidePolygons(const PhysicsWorld::Body& a,
+                            const PhysicsWorld::Body& b,
+                            float* nx, float* ny, float* penetration)
+{
+    float pointsA[PhysicsWorld::MAX_POLYGON_POINTS * 2];
+    float pointsB[PhysicsWorld::MAX_POLYGON_POINTS * 2];
+    const unsigned int countA = WorldPoints(a, pointsA);
+    const unsigned int countB = WorldPoints(b, pointsB);
+
+    float axNx = 0;
+    float axNy = 0;
+    const float separationA = MaxSeparation(pointsA, countA, pointsB, countB, &axNx, &axNy);
+    if(separationA > 0)
+    {
+        return false;
+    }
+
+    float bxNx = 0;
+    float bxNy = 0;
+    const float separationB = MaxSeparation(pointsB, countB, pointsA, countA, &bxNx, &bxNy);
+    if(separationB > 0)
+    {
+        return false;
+    }
+
+    // The shallowest way out, b's normals point back at a.
+    if(separationB > separationA)
+    {
+        *nx = -bxNx;
+        *ny = -bxNy;
+        *penetration = -separationB;
+    }
+    else
+    {
+        *nx = axNx;
+        *ny = axNy;
+        *penetration = -separationA;
+    }
+    return true;
+}
+
+// The normal points from the polygon, or box, to the circle.
+static bool CollidePolygonCircle(const PhysicsWorld::Body& polygon,
+                                 const PhysicsWorld::Body& circle,
+                                 float* nx, float* ny, float* penetration)
+{
+    float points[PhysicsWorld::MAX_POLYGON_POINTS * 2];
+    const unsigned int count = WorldPoints(polygon, points);
+
+    // The edge the centre is furthest out past.
+    unsigned int edge = 0;
+    float separation = -FLT_MAX;
+    float edgeX = 0;
+    float edgeY = 0;
+    for(unsigned int i = 0; i < count; i++)
+    {
+        float normalX = 0;
+        float normalY = 0;
+        EdgeNormal(points, count, i, &normalX, &normalY);
+        const float distance = normalX * (circle.x - points[i * 2])
+                             + normalY * (circle.y - points[i * 2 + 1]);
+        if(distance > separation)
+        {
+            separation = distance;
+            edge = i;
+            edgeX = normalX;
+            edgeY = normalY;
+        }
+    }
+
+    if(separation > circle.radius)
+    {
+        return false;
+    }
+
+    // The centre is inside, leave by that edge.
+    if(separation <= 0)
+    {
+        *nx = edgeX;
+        *ny = edgeY;
+        *penetration = circle.radius - separation;
+        return true;
+    }
+
+    // Outside, the nearest point is on the edge or one of its ends.
+    const unsigned int next = (edge + 1) % count;
+    const float x1 = points[edge * 2];
+    const float y1 = points[edge * 2 + 1];
+    const float x2 = points[next * 2];
+    const float y2 = points[next * 2 + 1];
+    float cornerX = 0;
+    float cornerY = 0;
+    if((circle.x - x1) * (x2 - x1) + (circle.y - y1) * (y2 - y1) <= 0)
+    {
+        cornerX = x1;
+        cornerY = y1;
+    }
+    else if((circle.x - x2) * (x1 - x2) + (circle.y - y2) * (y1 - y2) <= 0)
+    {
+        cornerX = x2;
+        cornerY = y2;
+    }
+    else
+    {
+        *nx = edgeX;
+        *ny = edgeY;
+        *penetration = circle.radius - separation;
+        return true;
+    }
+
+    const float ox = circle.x - cornerX;
+    const float oy = circle.y - cornerY;
+    const float distanceSq = ox * ox + oy * oy;
+    if(distanceSq > circle.radius * circle.radius)
+    {
+        return false;
+    }
+    const float distance = sqrtf(distanceSq);
+    *nx = ox / distance;
+    *ny = oy / distance;
+    *penetration = circle.radius - distance;
+    return true;
+}
+
+bool PhysicsWorld::Collide(unsigned int a, unsigned int b, Contact* contact) const
+{
+    const Body& bodyA = mBodies[a];
+    const Body& bodyB = mBodies[b];
+    float nx = 0;
+    float ny = 0;
+    float penetration = 0;
+
+    if(bodyA.shape == SHAPE_CIRCLE && bodyB.shape == SHAPE_CIRCLE)
+    {
+        const float dx = bodyB.x - bodyA.x;
+        const float dy = bodyB.y - bodyA.y;
+        const float radii = bodyA.radius + bodyB.radius;
+        const float distanceSq = dx * dx + dy * dy;
+        if(distanceSq > radii * radii)
+        {
+            return false;
+        }
+        const float distance = sqrtf(distanceSq);
+        if(distance > 0)
+        {
+            nx = dx / distance;
+            ny = dy / distance;
+        }
+        else
+        {
+            // Exactly on top of each other, any direction will do.
+            nx = 0;
+            ny = 1;
+        }
+        penetration = radii - distance;
+    }
+    else if(bodyA.shape == SHAPE_BOX && bodyB.shape == SHAPE_BOX)
+    {
+        const float dx = bodyB.x - bodyA.x;
+        const float dy = bodyB.y - bodyA.y;
+        const float overlapX = bodyA.halfWidth + bodyB.halfWidth - fabsf(dx);
+        const float overlapY = bodyA.halfHeight + bodyB.halfHeight - fabsf(dy);
+        if(overlapX < 0 || overlapY < 0)
+        {
+            return false;
+        }
+        if(overlapX < overlapY)
+        {
+            nx = Sign(dx);
+            penetration = overlapX;
+        }
+        else
+        {
+            ny = Sign(dy);
+            penetration = overlapY;
+        }
+    }
+    else if(bodyA.shape == SHAPE_POLYGON || bodyB.shape == SHAPE_POLYGON)
+    {
+        if(bodyB.shape == SHAPE_CIRCLE)
+        {
+            if(!CollidePolygonCircle(bodyA, bodyB, &nx, &ny, &penetration))
+            {
+                return false;
+            }
+        }
+        else if(bodyA.shape == SHAPE_CIRCLE)
+        {
+            if(!CollidePolygonCircle(bodyB, bodyA, &nx, &ny, &penetration))
+            {
+                return false;
+            }
+            nx = -nx;
+            ny = -ny;
+        }
+        else if(!CollidePolygons(bodyA, bodyB, &nx, &ny, &penetration))
+        {
+            return false;
+        }
+    }
+    else if(bodyA.shape == SHAPE_BOX)
+    {
+        if(!CollideBoxCircle(bodyA, bodyB, &nx, &ny, &penetration))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        if(!CollideBoxCircle(bodyB, bodyA, &nx, &ny, &penetration))
+        {
+            return false;
+        }
+        nx = -nx;
+        ny = -ny;
+    }
+
+    contact->a = a;
+    contact->b = b;
+    contact->nx = nx;
+    contact->ny = ny;
+    contact->penetration = penetration;
+    contact->normalImpulse = 0;
+    contact->tangentImpulse = 0;
+
+    // Only bounce off things coming in fast, resting bodies would
+    // otherwise hop from the gravity gained each step.
+    const float approach = (bodyB.vx - bodyA.vx) * nx + (bodyB.vy - bodyA.vy) * ny;
+    const float restitution = std::max(bodyA.restitution, bodyB.restitution);
+    contact->bounce = approach < -mRestingSpeed ? -restitution * approach : 0;
+    return true;
+}
+
+void PhysicsWorld::SolveVelocities()
+{
+    for(unsigned int iteration = 0; iteration < ITERATIONS; iteration++)
+    {
+        for(unsigned int i = 0; i < mContacts.size(); i++)
+        {
+            Contact& contact = mContacts[i];
+            Body& a = mBodies[contact.a];
+            Body& b = mBodies[contact.b];
+            const float invMassSum = a.invMass + b.invMass;
+
+            // Normal impulses only ever push apart, clamping the total
+            // rather than each iteration's share lets later iterations
+            // take back some of what earlier ones added.
+            float rvx = b.vx - a.vx;
+            float rvy = b.vy - a.vy;
+            const float normalSpeed = rvx * contact.nx + rvy * contact.ny;
+            const float lambda = (contact.bounce - normalSpeed) / invMassSum;
+            const float normalImpulse = std::max(contact.normalImpulse + lambda, 0.0f);
+            const float applied = normalImpulse - contact.normalImpulse;
+            contact.normalImpulse = normalImpulse;
+
+            a.vx -= applied * contact.nx * a.invMass;
+            a.vy -= applied * contact.ny * a.invMass;
+            b.vx += applied * contact.nx * b.invMass;
+            b.vy += applied * contact.ny * b.invMass;
+
+            // Friction, limited by how hard the bodies press together.
+            const float tx = -contact.ny;
+            const float ty = contact.nx;
+            rvx = b.vx - a.vx;
+            rvy = b.vy - a.vy;
+            const float tangentSpeed = rvx * tx + rvy * ty;
+            const float friction = sqrtf(a.friction * b.friction);
+            const float maxFriction = friction * contact.normalImpulse;
+            const float tangentImpulse = Clamp(contact.tangentImpulse - tangentSpeed / invMassSum,
+                                               -maxFriction, maxFriction);
+            const float appliedTangent = tangentImpulse - contact.tangentImpulse;
+            contact.tangentImpulse = tangentImpulse;
+
+            a.vx -= appliedTangent * tx * a.invMass;
+            a.vy -= appliedTangent * ty * a.invMass;
+            b.vx += appliedTangent * tx * b.invMass;
+            b.vy += appliedTangent * ty * b.invMass;
+        }
+    }
+}
+
+void PhysicsWorld::CorrectPositions()
+{
+    // The overlap is measured again each pass, bodies have moved since
+    // the contacts were found and pushing one apart can press it into
+    // another.
+    for(unsigned int iteration = 0; iteration < ITERATIONS; iteration++)
+    {
+        for(unsigned int i = 0; i < mContacts.size(); i++)
+        {
+            Contact contact;
+            if(!Collide(mContacts[i].a, mContacts[i].b, &contact))
+            {
+                continue;
+            }
+            Body& a = mBodies[contact.a];
+            Body& b = mBodies[contact.b];
+            const float invMassSum = a.invMass + b.invMass;
+            const float push = std::max(contact.penetration - SLOP, 0.0f)
+                             * CORRECTION / invMassSum;
+            a.x -= push * contact.nx * a.invMass;
+            a.y -= push * contact.ny * a.invMass;
+            b.x += push * contact.nx * b.invMass;
+            b.y += push * contact.ny * b.invMass;
+        }
+    }
+}
+
+void PhysicsWorld::Step(float dt)
+{
+    if(!(dt > 0))
+    {
+        return;
+    }
+
+    mRestingSpeed = 2 * sqrtf(mGravityX * mGravityX + mGravityY * mGravityY) * dt;
+
+    for(unsigned int i = 0; i < mBodies.size(); i++)
+    {
+        Body& body = mBodies[i];
+        body.lastX = body.x;
+        body.lastY = body.y;
+        if(!body.alive || body.type != BODY_DYNAMIC)
+        {
+            continue;
+        }
+        body.vx += (mGravityX * body.gravityScale + body.fx * body.invMass) * dt;
+        body.vy += (mGravityY * body.gravityScale + body.fy * body.invMass) * dt;
+        body.fx = 0;
+        body.fy = 0;
+    }
+
+    // Broadphase, the grid is rebuilt each step as everything may move.
+    mGrid.Clear();
+    for(unsigned int i = 0; i < mBodies.size(); i++)
+    {
+        if(mBodies[i].alive)
+        {
+            SpatialGrid::Box box;
+            GetBox(mBodies[i], &box);
+            mGrid.Insert(i, box);
+        }
+    }
+    mPairs.clear();
+    mGrid.QueryPairs(&mPairs);
+
+    mContacts.clear();
+    mContactPairs.clear();
+    for(unsigned int i = 0; i + 1 < mPairs.size(); i += 2)
+    {
+        const unsigned int a = mPairs[i];
+        const unsigned int b = mPairs[i + 1];
+        if(mBodies[a].invMass == 0 && mBodies[b].invMass == 0)
+        {
+            continue;
+        }
+        Contact contact;
+        if(Collide(a, b, &contact))
+        {
+            mContacts.push_back(contact);
+            mContactPairs.push_back(a);
+            mContactPairs.push_back(b);
+        }
+    }
+
+    SolveVelocities();
+
+    for(unsigned int i = 0; i < mBodies.size(); i++)
+    {
+        Body& body = mBodies[i];
+        if(!body.alive || body.type == BODY_STATIC)
+        {
+            continue;
+        }
+        body.x += body.vx * dt;
+        body.y += body.vy * dt;
+    }
+
+    CorrectPositions();
+    SyncSprites(1);
+}
+
+void PhysicsWorld::SyncSprites(float alpha)
+{
+    const float from = 1 - alpha;
+    for(unsigned int i = 0; i < mBodies.size(); i++)
+    {
+        const Body& body = mBodies[i];
+        if(!body.alive || body.sprite == NULL)
+        {
+            continue;
+        }
+        body.sprite->SetPosition(body.lastX * from + body.x * alpha,
+                                 body.lastY * from + body.y * alpha);
+    }
+}
+
+//
+// Lua binding. Bodies are referred to by ids starting at 1.
+//
+
+static unsigned int CheckBody(lua_State* state, PhysicsWorld* world, int index)
+{
+    const unsigned int body = (unsigned int) luaL_checkinteger(state, index) - 1;
+    if(!world->IsBody(body))
+    {
+        luaL_argerror(state, index, "not a body in this world");
+    }
+    return body;
+}
+
+static PhysicsWorld::eBodyType CheckBodyType(lua_State* state, int index)
+{
+    static const char* names[] = { "dynamic", "static", "kinematic", NULL };
+    return (PhysicsWorld::eBodyType) luaL_checkoption(state, index, "dynamic", names);
+}
+
+static void ReleaseSprite(lua_State* state, PhysicsWorld::Body& body)
+{
+    if(body.spriteRef != LUA_NOREF)
+    {
+        luaL_unref(state, LUA_REGISTRYINDEX, body.spriteRef);
+        body.spriteRef = LUA_NOREF;
+    }
+    body.sprite = NULL;
+}
+
+// PhysicsWorld.Create([gravityX], [gravityY], [cellSize])
+static int lua_PhysicsWorld_Create(lua_State* state)
+{
+    const double gravityX = luaL_optnumber(state, 1, 0);
+    const double gravityY = luaL_optnumber(state, 2, 0);
+    const double cellSize = luaL_optnumber(state, 3, 64);
+    if(!(cellSize > 0))
+    {
+        return luaL_argerror(state, 3, "cell size must be above 0");
+    }
+
+    new (lua_newuserdata(state, sizeof(PhysicsWorld))) PhysicsWorld((float) gravityX,
+                                                                    (float) gravityY,
+                                                                    (float) cellSize);
+    luaL_getmetatable(state, "PhysicsWorld");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_PhysicsWorld_gc(lua_State* state)
+{
+    PhysicsWorld* world = (PhysicsWorld*)lua_touserdata(state, 1);
+    assert(world);
+    for(unsigned int i = 0; i < world->Capacity(); i++)
+    {
+        ReleaseSprite(state, world->GetBody(i));
+    }
+    world->~PhysicsWorld();
+    return 0;
+}
+
+static int lua_PhysicsWorld_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "PhysicsWorld");
+    return 1;
+}
+
+// world:AddCircle(x, y, radius, [type]) returns the body id
+static int lua_PhysicsWorld_AddCircle(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    PhysicsWorld::Body body;
+    body.shape = PhysicsWorld::SHAPE_CIRCLE;
+    body.x = (float) luaL_checknumber(state, 2);
+    body.y = (float) luaL_checknumber(state, 3);
+    body.radius = (float) luaL_checknumber(state, 4);
+    body.type = CheckBodyType(state, 5);
+    lua_pushinteger(state, world->Add(body) + 1);
+    return 1;
+}
+
+// world:AddBox(x, y, width, height, [type]) returns the body id
+// x and y are the centre of the box.
+static int lua_PhysicsWorld_AddBox(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    PhysicsWorld::Body body;
+    body.shape = PhysicsWorld::SHAPE_BOX;
+    body.x = (float) luaL_checknumber(state, 2);
+    body.y = (float) luaL_checknumber(state, 3);
+    body.halfWidth = (float) luaL_checknumber(state, 4) * 0.5f;
+    body.halfHeight = (float) luaL_checknumber(state, 5) * 0.5f;
+    body.type = CheckBodyType(state, 6);
+    lua_pushinteger(state, world->Add(body) + 1);
+    return 1;
+}
+
+// world:AddPolygon(x, y, points, [type]) returns the body id
+// points is a flat x1, y1, x2, y2... table of at most 8 points relative
+// to x and y, making a convex polygon.
+static int lua_PhysicsWorld_AddPolygon(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    PhysicsWorld::Body body;
+    body.x = (float) luaL_checknumber(state, 2);
+    body.y = (float) luaL_checknumber(state, 3);
+    luaL_checktype(state, 4, LUA_TTABLE);
+    body.type = CheckBodyType(state, 5);
+
+    const unsigned int values = lua_objlen(state, 4);
+    if(values % 2 != 0 || values > PhysicsWorld::MAX_POLYGON_POINTS * 2)
+    {
+        return luaL_argerror(state, 4, "expected x y pairs of up to 8 points");
+    }
+    float points[PhysicsWorld::MAX_POLYGON_POINTS * 2];
+    for(unsigned int i = 0; i < values; i++)
+    {
+        lua_rawgeti(state, 4, i + 1);
+        if(!lua_isnumber(state, -1))
+        {
+            return luaL_argerror(state, 4, "points must be numbers");
+        }
+        points[i] = (float) lua_tonumber(state, -1);
+        lua_pop(state, 1);
+    }
+
+    if(!PhysicsWorld::SetPolygon(&body, points, values / 2))
+    {
+        return luaL_argerror(state, 4, "points must make a convex polygon");
+    }
+    lua_pushinteger(state, world->Add(body) + 1);
+    return 1;
+}
+
+static int lua_PhysicsWorld_Remove(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    const unsigned int body = CheckBody(state, world, 2);
+    ReleaseSprite(state, world->GetBody(body));
+    world->Remove(body);
+    return 0;
+}
+
+static int lua_PhysicsWorld_SetPosition(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    PhysicsWorld::Body& body = world->GetBody(CheckBody(state, world, 2));
+    body.x = (float) luaL_checknumber(state, 3);
+    body.y = (float) luaL_checknumber(state, 4);
+    // A teleport, don't interpolate across it.
+    body.lastX = body.x;
+    body.lastY = body.y;
+    return 0;
+}
+
+static int lua_PhysicsWorld_GetPosition(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    const PhysicsWorld::Body& body = world->GetBody(CheckBody(state, world, 2));
+    lua_pushnumber(state, body.x);
+    lua_pushnumber(state, body.y);
+    return 2;
+}
+
+static int lua_PhysicsWorld_SetVelocity(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    PhysicsWorld::Body& body = world->GetBody(CheckBody(state, world, 2));
+    body.vx = (float) luaL_checknumber(state, 3);
+    body.vy = (float) luaL_checknumber(state, 4);
+    return 0;
+}
+
+static int lua_PhysicsWorld_GetVelocity(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    const PhysicsWorld::Body& body = world->GetBody(CheckBody(state, world, 2));
+    lua_pushnumber(state, body.vx);
+    lua_pushnumber(state, body.vy);
+    return 2;
+}
+
+// world:ApplyImpulse(id, x, y) changes the velocity straight away.
+static int lua_PhysicsWorld_ApplyImpulse(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    PhysicsWorld::Body& body = world->GetBody(CheckBody(state, world, 2));
+    body.vx += (float) luaL_checknumber(state, 3) * body.invMass;
+    body.vy += (float) luaL_checknumber(state, 4) * body.invMass;
+    return 0;
+}
+
+// world:ApplyForce(id, x, y) acts over the next step.
+static int lua_PhysicsWorld_ApplyForce(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    PhysicsWorld::Body& body = world->GetBody(CheckBody(state, world, 2));
+    body.fx += (float) luaL_checknumber(state, 3);
+    body.fy += (float) luaL_checknumber(state, 4);
+    return 0;
+}
+
+// world:SetMass(id, mass), only dynamic bodies have mass.
+static int lua_PhysicsWorld_SetMass(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    PhysicsWorld::Body& body = world->GetBody(CheckBody(state, world, 2));
+    const double mass = luaL_checknumber(state, 3);
+    if(!(mass > 0))
+    {
+        return luaL_argerror(state, 3, "mass must be above 0");
+    }
+    if(body.type == PhysicsWorld::BODY_DYNAMIC)
+    {
+        body.invMass = (float) (1.0 / mass);
+    }
+    return 0;
+}
+
+static int lua_PhysicsWorld_SetRestitution(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    PhysicsWorld::Body& body = world->GetBody(CheckBody(state, world, 2));
+    body.restitution = std::max(0.0f, (float) luaL_checknumber(state, 3));
+    return 0;
+}
+
+static int lua_PhysicsWorld_SetFriction(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    PhysicsWorld::Body& body = world->GetBody(CheckBody(state, world, 2));
+    body.friction = std::max(0.0f, (float) luaL_checknumber(state, 3));
+    return 0;
+}
+
+static int lua_PhysicsWorld_SetGravityScale(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    PhysicsWorld::Body& body = world->GetBody(CheckBody(state, world, 2));
+    body.gravityScale = (float) luaL_checknumber(state, 3);
+    return 0;
+}
+
+static int lua_PhysicsWorld_SetGravity(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    world->SetGravity((float) luaL_checknumber(state, 2),
+                      (float) luaL_checknumber(state, 3));
+    return 0;
+}
+
+// world:BindSprite(id, sprite) moves the sprite with the body.
+// Pass nil to unbind. The world keeps the sprite alive while it's bound.
+static int lua_PhysicsWorld_BindSprite(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    PhysicsWorld::Body& body = world->GetBody(CheckBody(state, world, 2));
+    ReleaseSprite(state, body);
+
+    if(lua_isnoneornil(state, 3))
+    {
+        return 0;
+    }
+
+    Sprite* sprite = LuaState::GetFuncParam<Sprite>(state, 3);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+    lua_pushvalue(state, 3);
+    body.spriteRef = luaL_ref(state, LUA_REGISTRYINDEX);
+    body.sprite = sprite;
+    sprite->SetPosition(body.x, body.y);
+    return 0;
+}
+
+// world:Step([dt]), dt defaults to the game's delta time, which is the
+// fixed step inside on_fixed_update.
+static int lua_PhysicsWorld_Step(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+
+    double dt = 0;
+    if(lua_isnoneornil(state, 2))
+    {
+        Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+        dt = game->GetDeltaTime();
+    }
+    else
+    {
+        dt = luaL_checknumber(state, 2);
+    }
+    world->Step((float) dt);
+    return 0;
+}
+
+// world:SyncSprites([alpha]), alpha defaults to the game's frame alpha so
+// calling it from on_update smooths sprites between fixed steps.
+static int lua_PhysicsWorld_SyncSprites(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+
+    double alpha = 1;
+    if(lua_isnoneornil(state, 2))
+    {
+        Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+        alpha = game->GetFrameAlpha();
+    }
+    else
+    {
+        alpha = luaL_checknumber(state, 2);
+    }
+    world->SyncSprites((float) std::max(0.0, std::min(alpha, 1.0)));
+    return 0;
+}
+
+// world:GetContacts([out]) returns a flat a1, b1, a2, b2... list of the
+// bodies touching in the last step, count
+static int lua_PhysicsWorld_GetContacts(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    const std::vector<unsigned int>& contacts = world->Contacts();
+    std::vector<int> ids(contacts.size());
+    for(unsigned int i = 0; i < contacts.size(); i++)
+    {
+        ids[i] = contacts[i] + 1;
+    }
+    return SpatialGrid::PushIds(state, 2, ids);
+}
+
+static int lua_PhysicsWorld_GetCount(lua_State* state)
+{
+    PhysicsWorld* world = LuaState::GetFuncParam<PhysicsWorld>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    lua_pushinteger(state, world->Count());
+    return 1;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_PhysicsWorld_Create},
+  {"__gc", lua_PhysicsWorld_gc},
+  {"__tostring", lua_PhysicsWorld_tostring},
+  {"AddCircle", lua_PhysicsWorld_AddCircle},
+  {"AddBox", lua_PhysicsWorld_AddBox},
+  {"AddPolygon", lua_PhysicsWorld_AddPolygon},
+  {"Remove", lua_PhysicsWorld_Remove},
+  {"SetPosition", lua_PhysicsWorld_SetPosition},
+  {"GetPosition", lua_PhysicsWorld_GetPosition},
+  {"SetVelocity", lua_PhysicsWorld_SetVelocity},
+  {"GetVelocity", lua_PhysicsWorld_GetVelocity},
+  {"ApplyImpulse", lua_PhysicsWorld_ApplyImpulse},
+  {"ApplyForce", lua_PhysicsWorld_ApplyForce},
+  {"SetMass", lua_PhysicsWorld_SetMass},
+  {"SetRestitution", lua_PhysicsWorld_SetRestitution},
+  {"SetFriction", lua_PhysicsWorld_SetFriction},
+  {"SetGravityScale", lua_PhysicsWorld_SetGravityScale},
+  {"SetGravity", lua_PhysicsWorld_SetGravity},
+  {"BindSprite", lua_PhysicsWorld_BindSprite},
+  {"Step", lua_PhysicsWorld_Step},
+  {"SyncSprites", lua_PhysicsWorld_SyncSprites},
+  {"GetContacts", lua_PhysicsWorld_GetContacts},
+  {"GetCount", lua_PhysicsWorld_GetCount},
+  {NULL, NULL}  /* sentinel */
+};
+
+void PhysicsWorld::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        PhysicsWorld::Meta.Name(),
+        luaBinding
+    );
+}
\ No newline at end of file
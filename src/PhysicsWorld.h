@@ -0,0 +1,123 @@
+#ifndef PHYSICSWORLD_H
+#define PHYSICSWORLD_H
+
+#include <vector>
+
+#include "reflect/Reflect.h"
+#include "SpatialGrid.h"
+
+class LuaState;
+class Sprite;
+struct lua_State;
+
+//
+// A small 2D rigid body world of circles, axis aligned boxes and convex
+// polygons. Bodies don't rotate, which covers platformers and top down
+// games, so slopes and ramps are polygons placed at the angle they need.
+//
+// Step it from on_fixed_update. Velocities are integrated, contacts found
+// through a SpatialGrid and solved with sequential impulses, then
+// positions are moved and pushed apart where they still overlap.
+//
+// A body can be bound to a Sprite, whose position is set after each step
+// or, for smooth motion between steps, by SyncSprites with the frame's
+// alpha.
+//
+class PhysicsWorld
+{
+    public: static Reflect Meta;
+    public:
+        enum eShape
+        {
+            SHAPE_CIRCLE,
+            SHAPE_BOX,
+            SHAPE_POLYGON
+        };
+
+        enum eBodyType
+        {
+            BODY_DYNAMIC,
+            BODY_STATIC,   // never moves
+            BODY_KINEMATIC // moves by its velocity, isn't pushed
+        };
+
+        static const unsigned int NONE = 0xFFFFFFFF;
+        static const unsigned int ITERATIONS = 8;
+        static const unsigned int MAX_POLYGON_POINTS = 8;
+
+        struct Body
+        {
+            eShape shape;
+            eBodyType type;
+            float x, y;
+            float lastX, lastY; // before the last step
+            float vx, vy;
+            float fx, fy; // forces until the next step
+            float radius; // circles
+            float halfWidth, halfHeight; // boxes, and polygons' bounds
+            // Polygons, x y pairs counter clockwise about x, y.
+            float points[MAX_POLYGON_POINTS * 2];
+            unsigned int pointCount;
+            float invMass;
+            float restitution;
+            float friction;
+            float gravityScale;
+            Sprite* sprite;
+            int spriteRef;
+            bool alive;
+            Body();
+        };
+
+        static void Bind(LuaState* state);
+
+        // Makes the body a polygon of count x y pairs about its position.
+        // Either winding is taken. False if they aren't a convex polygon
+        // of 3 to MAX_POLYGON_POINTS points.
+        static bool SetPolygon(Body* body, const float* points, unsigned int count);
+
+        PhysicsWorld(float gravityX, float gravityY, float cellSize);
+
+        unsigned int Add(const Body& body);
+        // The sprite ref, if any, is the caller's to let go.
+        void Remove(unsigned int body);
+        bool IsBody(unsigned int body) const;
+        Body& GetBody(unsigned int body) { return mBodies[body]; }
+        unsigned int Count() const { return mCount; }
+        unsigned int Capacity() const { return mBodies.size(); }
+        void SetGravity(float x, float y) { mGravityX = x; mGravityY = y; }
+
+        void Step(float dt);
+        // alpha 1 puts sprites where their bodies are now, 0 where they
+        // were before the last step.
+        void SyncSprites(float alpha);
+        // Body index pairs, two a contact, touching in the last step.
+        const std::vector<unsigned int>& Contacts() const { return mContactPairs; }
+    private:
+        struct Contact
+        {
+            unsigned int a, b;
+            float nx, ny; // from a to b
+            float penetration;
+            float bounce; // target separating speed
+            float normalImpulse;
+            float tangentImpulse;
+        };
+
+        std::vector<Body> mBodies;
+        std::vector<unsigned int> mFree;
+        std::vector<Contact> mContacts;
+        std::vector<unsigned int> mContactPairs;
+        std::vector<int> mPairs;
+        SpatialGrid mGrid;
+        float mGravityX;
+        float mGravityY;
+        float mRestingSpeed; // approaches slower than this don't bounce
+        unsigned int mCount;
+
+        void GetBox(const Body& body, SpatialGrid::Box* box) const;
+        bool Collide(unsigned int a, unsigned int b, Contact* contact) const;
+        void SolveVelocities();
+        void CorrectPositions();
+};
+
+#endif
\ No newline at end of file
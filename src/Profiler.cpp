@@ -0,0 +1,327 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <sstream>
+#include <stdio.h>
+#include <vector>
+
+#include "DinodeckLua.h"
+#include "DDLog.h"
+#include "DDTime.h"
+#include "Game.h"
+#include "LuaState.h"
+
+extern "C"
+{
+#include "luajit.h"
+}
+
+Reflect Profiler::Meta("Profiler", Profiler::Bind);
+Profiler* Profiler::mActive = NULL;
+
+static const int MAX_STACK_DEPTH = 64;
+
+static Profiler* GetProfiler(lua_State* state)
+{
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    assert(game);
+    return game->GetProfiler();
+}
+
+// Profiler.Start([interval]) restarts the session if one is running.
+static int lua_Profiler_Start(lua_State* state)
+{
+    int interval = luaL_optinteger(state, 1, Profiler::DEFAULT_INTERVAL);
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    // Not the calling thread, a coroutine may be collected before Stop.
+    game->GetProfiler()->Start(game->GetLuaState()->State(), interval);
+    return 0;
+}
+
+static int lua_Profiler_Stop(lua_State* state)
+{
+    GetProfiler(state)->Stop();
+    return 0;
+}
+
+static int lua_Profiler_IsRunning(lua_State* state)
+{
+    lua_pushboolean(state, GetProfiler(state)->IsRunning());
+    return 1;
+}
+
+static int lua_Profiler_Clear(lua_State* state)
+{
+    GetProfiler(state)->Clear();
+    return 0;
+}
+
+// Profiler.Report([worstFrame]) returns the collapsed stacks
+static int lua_Profiler_Report(lua_State* state)
+{
+    bool worstFrame = lua_toboolean(state, 1);
+    std::string report = GetProfiler(state)->Report(worstFrame);
+    lua_pushlstring(state, report.c_str(), report.size());
+    return 1;
+}
+
+// Profiler.Dump(path, [worstFrame]) writes the report for flamegraph.pl
+static int lua_Profiler_Dump(lua_State* state)
+{
+    const char* path = luaL_checkstring(state, 1);
+    bool worstFrame = lua_toboolean(state, 2);
+    std::string report = GetProfiler(state)->Report(worstFrame);
+
+    FILE* file = fopen(path, "wb");
+    if(file == NULL)
+    {
+        dsprintf("Profiler: couldn't write [%s]\n", path);
+        lua_pushboolean(state, false);
+        return 1;
+    }
+    bool success = fwrite(report.c_str(), 1, report.size(), file) == report.size();
+    fclose(file);
+    lua_pushboolean(state, success);
+    return 1;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Start", lua_Profiler_Start},
+  {"Stop", lua_Profiler_Stop},
+  {"IsRunning", lua_Profiler_IsRunning},
+  {"Clear", lua_Profiler_Clear},
+  {"Report", lua_Profiler_Report},
+  {"Dump", lua_Profiler_Dump},
+  {NULL, NULL}  /* sentinel */
+};
+
+void Profiler::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        Profiler::Meta.Name(),
+        luaBinding
+    );
+}
+
+Profiler::Profiler() :
+    mState(NULL),
+    mJitEnabled(true),
+    mSession(),
+    mFrame(),
+    mWorstFrame(),
+    mFrameTime(0),
+    mWorstFrameTime(0),
+    mLastSample(0),
+    mZoneTime(0),
+    mFrames(0),
+    mLastReport()
+{
+}
+
+Profiler::~Profiler()
+{
+    // The Lua state, and its hook, are expected to be gone by now.
+    if(mActive == this)
+    {
+        mActive = NULL;
+    }
+}
+
+void Profiler::Start(lua_State* state, int interval)
+{
+    assert(state);
+    Stop();
+    Clear();
+    mState = state;
+    mActive = this;
+    mLastSample = DDTime::Microseconds();
+
+    // Hooks don't fire in compiled traces, so run interpreted while
+    // profiling. Relative costs hold up well enough to find the hot spots.
+    luaJIT_setmode(state, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_FLUSH);
+    luaJIT_setmode(state, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_OFF);
+    lua_sethook(state, Profiler::Hook, LUA_MASKCOUNT, std::max(interval, 1));
+    dsprintf("Profiler started, sampling every %d instructions.\n", std::max(interval, 1));
+}
+
+void Profiler::Stop()
+{
+    if(!IsRunning())
+    {
+        return;
+    }
+
+    lua_sethook(mState, NULL, 0, 0);
+    luaJIT_setmode(mState, 0, LUAJIT_MODE_ENGINE | (mJitEnabled ? LUAJIT_MODE_ON : LUAJIT_MODE_OFF));
+    mState = NULL;
+    if(mActive == this)
+    {
+        mActive = NULL;
+    }
+    mLastReport = Report(false);
+    dsprintf("Profiler stopped after %u frames.\n", mFrames);
+}
+
+void Profiler::Clear()
+{
+    mSession.clear();
+    mFrame.clear();
+    mWorstFrame.clear();
+    mFrameTime = 0;
+    mWorstFrameTime = 0;
+    mZoneTime = 0;
+    mFrames = 0;
+}
+
+void Profiler::BeginFrame()
+{
+    // Time between frames isn't the script's.
+    mLastSample = DDTime::Microseconds();
+    mZoneTime = 0;
+}
+
+void Profiler::EndFrame()
+{
+    if(!IsRunning())
+    {
+        return;
+    }
+
+    mFrames++;
+    if(mFrameTime > mWorstFrameTime)
+    {
+        mWorstFrame.swap(mFrame);
+        mWorstFrameTime = mFrameTime;
+    }
+    mFrame.clear();
+    mFrameTime = 0;
+}
+
+std::string Profiler::Report(bool worstFrame) const
+{
+    const StackMap& stacks = worstFrame ? mWorstFrame : mSession;
+    std::stringstream report;
+    for(StackMap::const_iterator it = stacks.begin(); it != stacks.end(); ++it)
+    {
+        report << it->first << " " << it->second << "\n";
+    }
+    return report.str();
+}
+
+void Profiler::Hook(lua_State* state, lua_Debug* debug)
+{
+    if(mActive && debug->event == LUA_HOOKCOUNT)
+    {
+        mActive->Sample(state);
+    }
+}
+
+void Profiler::Sample(lua_State* state)
+{
+    unsigned long long now = DDTime::Microseconds();
+    unsigned long long elapsed = now - mLastSample;
+    // Zones already accounted for their part.
+    elapsed -= std::min(elapsed, mZoneTime);
+    mZoneTime = 0;
+    mLastSample = now;
+
+    if(elapsed == 0)
+    {
+        return;
+    }
+
+    std::string stack;
+    StackString(state, 0, &stack);
+    Add(stack, elapsed);
+}
+
+void Profiler::AddZone(lua_State* state, const char* name, unsigned long long microseconds)
+{
+    mZoneTime += microseconds;
+
+    std::string stack;
+    if(state)
+    {
+        // Level 0 is the binding that opened the zone.
+        StackString(state, 1, &stack);
+    }
+
+    if(stack.empty())
+    {
+        stack = "engine";
+    }
+    stack += ";";
+    stack += name;
+    Add(stack, microseconds);
+}
+
+void Profiler::Add(const std::string& stack, unsigned long long microseconds)
+{
+    mSession[stack] += microseconds;
+    mFrame[stack] += microseconds;
+    mFrameTime += microseconds;
+}
+
+//
+// Outermost function first, as "name@source:line" joined by ';'.
+//
+void Profiler::StackString(lua_State* state, int level, std::string* out)
+{
+    std::vector<std::string> frames;
+    lua_Debug debug;
+
+    while(frames.size() < (unsigned int) MAX_STACK_DEPTH
+          && lua_getstack(state, level++, &debug))
+    {
+        lua_getinfo(state, "Sn", &debug);
+
+        std::stringstream frame;
+        if(debug.name)
+        {
+            frame << debug.name;
+        }
+        else
+        {
+            frame << (debug.what[0] == 'm' ? "main" : "?");
+        }
+
+        if(debug.what[0] != 'C')
+        {
+            frame << "@" << debug.short_src << ":" << debug.linedefined;
+        }
+
+        std::string name = frame.str();
+        // Both split the collapsed format.
+        std::replace(name.begin(), name.end(), ' ', '_');
+        std::replace(name.begin(), name.end(), ';', '_');
+        frames.push_back(name);
+    }
+
+    out->clear();
+    for(std::vector<std::string>::reverse_iterator it = frames.rbegin(); it != frames.rend(); ++it)
+    {
+        if(!out->empty())
+        {
+            *out += ";";
+        }
+        *out += *it;
+    }
+}
+
+ProfileZone::ProfileZone(lua_State* state, const char* name) :
+    mState(state),
+    mName(name),
+    mStart(Profiler::mActive ? DDTime::Microseconds() : 0)
+{
+}
+
+ProfileZone::~ProfileZone()
+{
+    // Lost if a script error unwinds past it.
+    if(Profiler::mActive && mStart != 0)
+    {
+        Profiler::mActive->AddZone(mState, mName, DDTime::Microseconds() - mStart);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <map>
+#include <string>
+
+#include "reflect/Reflect.h"
+
+class LuaState;
+struct lua_State;
+
+//
+// Samples the Lua stack every so many VM instructions and weights each
+// sample by the time since the last one. Stacks are kept for the whole
+// session and for its slowest frame, and written out as collapsed stacks
+// ("main;update;DrawMap 1200", in microseconds) for flamegraph.pl.
+//
+// LuaJIT only calls hooks from the interpreter, so the JIT is off while
+// profiling and scripts run slower than usual.
+//
+class Profiler
+{
+    public: static Reflect Meta;
+    public:
+        static void Bind(LuaState* state);
+        static const int DEFAULT_INTERVAL = 1000; // in VM instructions
+
+        // The running profiler, if any, for ProfileZone.
+        static Profiler* mActive;
+
+        Profiler();
+        ~Profiler();
+
+        void Start(lua_State* state, int interval);
+        void Stop();
+        bool IsRunning() const { return mState != NULL; }
+        // Whether Stop turns the JIT back on, settings.lua may have it off.
+        void SetJitEnabled(bool value) { mJitEnabled = value; }
+        void Clear();
+
+        // Call around each frame.
+        void BeginFrame();
+        void EndFrame();
+
+        // Collapsed stacks, of the slowest frame or of everything.
+        std::string Report(bool worstFrame) const;
+        // The report as it was at the last Stop. Read by the webserver.
+        const std::string& LastReport() const { return mLastReport; }
+
+        // Engine time spent in a zone, under the Lua stack that called it.
+        void AddZone(lua_State* state, const char* name, unsigned long long microseconds);
+    private:
+        typedef std::map<std::string, unsigned long long> StackMap;
+
+        lua_State* mState;
+        bool mJitEnabled;
+        StackMap mSession;
+        StackMap mFrame;
+        StackMap mWorstFrame;
+        unsigned long long mFrameTime; // sampled, this frame
+        unsigned long long mWorstFrameTime;
+        unsigned long long mLastSample;
+        unsigned long long mZoneTime; // since the last sample
+        unsigned int mFrames;
+        std::string mLastReport;
+
+        static void Hook(lua_State* state, struct lua_Debug* debug);
+        void Sample(lua_State* state);
+        void Add(const std::string& stack, unsigned long long microseconds);
+        static void StackString(lua_State* state, int level, std::string* out);
+};
+
+//
+// Times a block of engine code for the profiler, costs nothing when it
+// isn't running.
+//
+//    ProfileZone zone(state, "DrawSprite");
+//
+class ProfileZone
+{
+    lua_State* mState;
+    const char* mName;
+    unsigned long long mStart;
+public:
+    ProfileZone(lua_State* state, const char* name);
+    ~ProfileZone();
+};
+
+#endif
\ No newline at end of file
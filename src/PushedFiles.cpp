@@ -0,0 +1,58 @@
+#include "PushedFiles.h"
+
+#include <map>
+#include <string.h>
+
+#include "Threading.h"
+
+// Texture decodes read files on the job system's workers.
+static Mutex& FilesMutex()
+{
+    static Mutex mutex;
+    return mutex;
+}
+
+static std::map<std::string, std::string>& Files()
+{
+    static std::map<std::string, std::string> files;
+    return files;
+}
+
+void PushedFiles::Set(const std::string& path, const std::string& data)
+{
+    ScopedLock lock(FilesMutex());
+    Files()[path] = data;
+}
+
+bool PushedFiles::Exists(const char* path)
+{
+    ScopedLock lock(FilesMutex());
+    return !Files().empty() && Files().find(path) != Files().end();
+}
+
+bool PushedFiles::Read(const char* path, const char** outData, unsigned int* outSize)
+{
+    ScopedLock lock(FilesMutex());
+    if(Files().empty())
+    {
+        return false;
+    }
+
+    std::map<std::string, std::string>::const_iterator it = Files().find(path);
+    if(it == Files().end())
+    {
+        return false;
+    }
+
+    char* data = new char[it->second.size()];
+    memcpy(data, it->second.data(), it->second.size());
+    *outData = data;
+    *outSize = it->second.size();
+    return true;
+}
+
+void PushedFiles::Clear()
+{
+    ScopedLock lock(FilesMutex());
+    Files().clear();
+}
\ No newline at end of file
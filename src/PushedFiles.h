@@ -0,0 +1,23 @@
+#ifndef PUSHEDFILES_H
+#define PUSHEDFILES_H
+
+#include <string>
+
+//
+// File contents sent over the webserver by an editor. They shadow the
+// packs and loose files under the same path, so an asset can be swapped
+// without anything being written to disk.
+//
+// Pushes last until Clear, which a full reset calls.
+//
+class PushedFiles
+{
+public:
+    static void Set(const std::string& path, const std::string& data);
+    static bool Exists(const char* path);
+    // Any thread. The data is a new[] copy the caller must delete[].
+    static bool Read(const char* path, const char** outData, unsigned int* outSize);
+    static void Clear();
+};
+
+#endif
\ No newline at end of file
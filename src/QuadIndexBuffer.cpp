@@ -0,0 +1,105 @@
+#include "QuadIndexBuffer.h"
+
+#include <assert.h>
+
+#include "DinodeckGL.h"
+#include "DDLog.h"
+#include "MemoryStats.h"
+
+void QuadIndexBuffer::Reset()
+{
+    // Not deleted, the name belongs to the new context now.
+    ForgetBuffer();
+}
+
+void QuadIndexBuffer::SetEnabled(bool value)
+{
+    if(!value)
+    {
+        DestroyBuffer();
+    }
+    mEnabled = value;
+}
+
+void QuadIndexBuffer::DestroyBuffer()
+{
+    if(mBufferId != 0)
+    {
+        glDeleteBuffers(1, &mBufferId);
+        ForgetBuffer();
+    }
+}
+
+void QuadIndexBuffer::ForgetBuffer()
+{
+    if(mBufferId != 0)
+    {
+        mBufferId = 0;
+        MemoryStats::Release(MemoryStats::MEMORY_VERTICES,
+                             mIndices.size() * sizeof(unsigned short));
+    }
+}
+
+bool QuadIndexBuffer::CreateBuffer()
+{
+    DestroyBuffer();
+    glGenBuffers(1, &mBufferId);
+
+    if(mBufferId == 0)
+    {
+        dsprintf("Quad index buffer unavailable, using client indices.\n");
+        mEnabled = false;
+        return false;
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 mIndices.size() * sizeof(unsigned short),
+                 &mIndices[0],
+                 GL_STATIC_DRAW);
+    MemoryStats::Add(MemoryStats::MEMORY_VERTICES, mIndices.size() * sizeof(unsigned short));
+    return true;
+}
+
+const GLvoid* QuadIndexBuffer::Bind(unsigned int quads)
+{
+    assert(quads > 0 && quads <= MAX_QUADS);
+
+    if(quads > mQuads)
+    {
+        // Doubled so a growing batch doesn't rebuild every frame.
+        unsigned int count = mQuads == 0 ? 256 : mQuads;
+        while(count < quads)
+        {
+            count *= 2;
+        }
+        mQuads = count < MAX_QUADS ? count : MAX_QUADS;
+
+        // Before the resize, the memory stats count the old size.
+        DestroyBuffer();
+        mIndices.resize(mQuads * INDICES_PER_QUAD);
+        for(unsigned int i = 0; i < mQuads; i++)
+        {
+            const unsigned short first = (unsigned short) (i * 4);
+            unsigned short* quad = &mIndices[i * INDICES_PER_QUAD];
+            quad[0] = first;
+            quad[1] = first + 1;
+            quad[2] = first + 2;
+            quad[3] = first + 1;
+            quad[4] = first + 3;
+            quad[5] = first + 2;
+        }
+    }
+
+    if(mEnabled && (mBufferId != 0 || CreateBuffer()))
+    {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
+        return NULL;
+    }
+    return &mIndices[0];
+}
+
+void QuadIndexBuffer::Unbind()
+{
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef QUADINDEXBUFFER_H
+#define QUADINDEXBUFFER_H
+
+#include <vector>
+
+#include "DinodeckGL.h"
+
+//
+// Indices for batches of quads, 0 1 2 1 3 2 then on by four, so a quad
+// is four verts, TL TR BL BR, rather than six. Built once for the most
+// quads drawn so far and reused by every draw. Neither GL 2 nor GLES 1.1
+// has a base vertex, so draws move their pointers to the first quad.
+//
+class QuadIndexBuffer
+{
+    GLuint mBufferId;
+    unsigned int mQuads; // built for
+    std::vector<unsigned short> mIndices; // drawn from when there's no buffer
+    bool mEnabled;
+public:
+    // The most an unsigned short can index, GLES 1.1 has no 32 bit indices.
+    static const unsigned int MAX_QUADS = 65536 / 4;
+    static const unsigned int INDICES_PER_QUAD = 6;
+
+    QuadIndexBuffer() :
+        mBufferId(0),
+        mQuads(0),
+        mIndices(),
+        mEnabled(true)
+        {}
+    ~QuadIndexBuffer() { DestroyBuffer(); }
+
+    // Forget the GPU buffer, it's recreated on next use.
+    // Call when the OpenGL context has been lost.
+    void Reset();
+    // Off, indices come from client memory.
+    void SetEnabled(bool value);
+
+    // Makes indices for at least quads quads current and returns what to
+    // pass glDrawElements for them. quads must be at most MAX_QUADS.
+    const GLvoid* Bind(unsigned int quads);
+    void Unbind();
+private:
+    bool CreateBuffer();
+    void DestroyBuffer();
+    void ForgetBuffer();
+};
+
+#endif
\ No newline at end of file
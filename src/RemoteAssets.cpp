@@ -0,0 +1,284 @@
+#include "RemoteAssets.h"
+
+#include <map>
+#include <stdio.h>
+#include <string.h>
+
+#include "DDLog.h"
+#include "DDTime.h"
+#include "HttpClient.h"
+#include "Threading.h"
+#include "XXHash.h"
+
+struct RemoteState
+{
+    std::string url; // without a trailing slash
+    std::string directory;
+    std::map<std::string, unsigned int> hashes; // path to its copy's
+    std::map<unsigned int, std::string> copies; // when there's no directory
+    unsigned long long offlineUntil; // microseconds, no requests before
+    HttpClient client;
+    RemoteState() : offlineUntil(0) {}
+};
+
+// A connect to a machine that's gone can take seconds, don't wait on
+// one for every file.
+static const unsigned long long RETRY_MICROSECONDS = 5000000ULL;
+
+// Texture decodes read files on the job system's workers.
+static Mutex& RemoteMutex()
+{
+    static Mutex mutex;
+    return mutex;
+}
+
+static RemoteState& State()
+{
+    static RemoteState state;
+    return state;
+}
+
+static std::string CopyPath(const RemoteState& state, unsigned int hash)
+{
+    char file[16];
+    sprintf(file, "%08x", hash);
+    return state.directory + "/" + file;
+}
+
+static std::string EncodePath(const std::string& path)
+{
+    static const char* hex = "0123456789ABCDEF";
+    std::string encoded;
+    for(size_t i = 0; i < path.size(); i++)
+    {
+        const unsigned char c = (unsigned char) path[i];
+        if((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+           || c == '/' || c == '-' || c == '_' || c == '.' || c == '~')
+        {
+            encoded += (char) c;
+            continue;
+        }
+        encoded += '%';
+        encoded += hex[c >> 4];
+        encoded += hex[c & 15];
+    }
+    return encoded;
+}
+
+//
+// The index is a line for each copy written, "hash path", the last line
+// for a path wins.
+//
+static void ReadIndex(RemoteState& state)
+{
+    FILE* file = fopen((state.directory + "/index").c_str(), "rb");
+    if(file == NULL)
+    {
+        return;
+    }
+
+    char line[1024];
+    while(fgets(line, sizeof(line), file) != NULL)
+    {
+        unsigned int hash = 0;
+        char path[1024];
+        if(sscanf(line, "%x %1023[^\r\n]", &hash, path) == 2)
+        {
+            state.hashes[path] = hash;
+        }
+    }
+    fclose(file);
+}
+
+static bool ReadCopy(const RemoteState& state, unsigned int hash, std::string* out)
+{
+    if(state.directory.empty())
+    {
+        std::map<unsigned int, std::string>::const_iterator it = state.copies.find(hash);
+        if(it == state.copies.end())
+        {
+            return false;
+        }
+        *out = it->second;
+        return true;
+    }
+
+    FILE* file = fopen(CopyPath(state, hash).c_str(), "rb");
+    if(file == NULL)
+    {
+        return false;
+    }
+
+    out->clear();
+    char buffer[4096];
+    size_t read = 0;
+    while((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        out->append(buffer, read);
+    }
+    fclose(file);
+
+    // A write cut short, or something else in the directory.
+    return XXHash::Hash32(out->data(), out->size()) == hash;
+}
+
+static void WriteCopy(RemoteState& state,
+                      const std::string& path,
+                      unsigned int hash,
+                      const std::string& data)
+{
+    std::map<std::string, unsigned int>::iterator it = state.hashes.find(path);
+    const bool replaced = it != state.hashes.end() && it->second != hash;
+    const unsigned int old = replaced ? it->second : 0;
+    state.hashes[path] = hash;
+
+    if(state.directory.empty())
+    {
+        state.copies[hash] = data;
+        if(!replaced)
+        {
+            return;
+        }
+
+        // Copies are shared by paths with the same contents.
+        for(it = state.hashes.begin(); it != state.hashes.end(); ++it)
+        {
+            if(it->second == old)
+            {
+                return;
+            }
+        }
+        state.copies.erase(old);
+        return;
+    }
+
+    FILE* file = fopen(CopyPath(state, hash).c_str(), "wb");
+    if(file == NULL)
+    {
+        dsprintf("Couldn't cache [%s] in [%s].\n", path.c_str(), state.directory.c_str());
+        return;
+    }
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+
+    FILE* index = fopen((state.directory + "/index").c_str(), "ab");
+    if(index != NULL)
+    {
+        fprintf(index, "%08x %s\n", hash, path.c_str());
+        fclose(index);
+    }
+}
+
+static bool Copy(const std::string& data, const char** outData, unsigned int* outSize)
+{
+    char* copy = new char[data.size()];
+    memcpy(copy, data.data(), data.size());
+    *outData = copy;
+    *outSize = data.size();
+    return true;
+}
+
+void RemoteAssets::Configure(const std::string& url, const std::string& directory)
+{
+    ScopedLock lock(RemoteMutex());
+    RemoteState& state = State();
+    std::string trimmed = url;
+    while(!trimmed.empty() && trimmed[trimmed.size() - 1] == '/')
+    {
+        trimmed.erase(trimmed.size() - 1);
+    }
+
+    if(trimmed == state.url && directory == state.directory)
+    {
+        return;
+    }
+
+    state.url = trimmed;
+    state.directory = directory;
+    state.hashes.clear();
+    state.copies.clear();
+    state.offlineUntil = 0;
+    if(state.url.empty())
+    {
+        return;
+    }
+
+    if(!state.directory.empty())
+    {
+        ReadIndex(state);
+    }
+    dsprintf("Assets from [%s], %u cached.\n", state.url.c_str(), (unsigned int) state.hashes.size());
+}
+
+bool RemoteAssets::IsActive()
+{
+    ScopedLock lock(RemoteMutex());
+    return !State().url.empty();
+}
+
+bool RemoteAssets::Read(const char* path, const char** outData, unsigned int* outSize)
+{
+    ScopedLock lock(RemoteMutex());
+    RemoteState& state = State();
+    if(state.url.empty())
+    {
+        return false;
+    }
+
+    std::string data;
+    bool held = false;
+    unsigned int hash = 0;
+    std::map<std::string, unsigned int>::const_iterator it = state.hashes.find(path);
+    if(it != state.hashes.end())
+    {
+        hash = it->second;
+        held = ReadCopy(state, hash, &data);
+    }
+
+    std::string headers;
+    if(held)
+    {
+        char line[64];
+        sprintf(line, "If-None-Match: \"%08x\"\r\n", hash);
+        headers = line;
+    }
+
+    HttpClient::Response response;
+    if(DDTime::Microseconds() < state.offlineUntil)
+    {
+        // Offline, the last copy will do.
+        return held && Copy(data, outData, outSize);
+    }
+
+    if(!state.client.Get(state.url + "/" + EncodePath(path), headers, &response))
+    {
+        dsprintf("Asset server: %s\n", response.body.c_str());
+        state.offlineUntil = DDTime::Microseconds() + RETRY_MICROSECONDS;
+    }
+    else if(response.status == 404)
+    {
+        return false;
+    }
+    else if(response.ok)
+    {
+        const unsigned int fetched = XXHash::Hash32(response.body.data(), response.body.size());
+        unsigned int sent = fetched;
+        sscanf(response.etag.c_str(), "\"%x\"", &sent);
+        if(sent == fetched)
+        {
+            WriteCopy(state, path, fetched, response.body);
+            data.swap(response.body);
+            held = true;
+        }
+        else
+        {
+            dsprintf("[%s] from the asset server doesn't match its hash.\n", path);
+        }
+    }
+    else if(response.status != 304)
+    {
+        dsprintf("Asset server gave %d for [%s].\n", response.status, path);
+    }
+
+    return held && Copy(data, outData, outSize);
+}
\ No newline at end of file
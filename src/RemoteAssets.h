@@ -0,0 +1,31 @@
+#ifndef REMOTEASSETS_H
+#define REMOTEASSETS_H
+
+#include <string>
+
+//
+// Fetches assets over http from asset_server.py on a dev machine, so a
+// device can run what's being edited without it being copied into the
+// APK.
+//
+// Each read asks the server for the path along with the hash of the copy
+// already held, and only a changed file comes back. Copies are kept
+// under the XXHash of their contents, checked on the way in and out, in
+// memory or with a directory set on disk where they last between runs.
+// When the server can't be reached the last copy is used. Paths the
+// server doesn't have are left to the usual files.
+//
+// Any thread, reads go one at a time.
+//
+class RemoteAssets
+{
+public:
+    // An empty url turns it off. An empty directory keeps copies in
+    // memory only, it has to exist already.
+    static void Configure(const std::string& url, const std::string& directory);
+    static bool IsActive();
+    // Same contract as PushedFiles::Read.
+    static bool Read(const char* path, const char** outData, unsigned int* outSize);
+};
+
+#endif
\ No newline at end of file
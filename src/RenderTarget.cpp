@@ -0,0 +1,206 @@
+#include "RenderTarget.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include "DinodeckGL.h"
+#include "DinodeckLua.h"
+#include "LuaState.h"
+#include "TextureManager.h"
+
+Reflect RenderTarget::Meta("RenderTarget", RenderTarget::Bind);
+std::vector<RenderTarget*> RenderTarget::mTargets;
+
+static int lua_RenderTarget_Create(lua_State* state)
+{
+    int width = luaL_checkinteger(state, 1);
+    int height = luaL_checkinteger(state, 2);
+
+    if(width < 1 || height < 1)
+    {
+        return luaL_argerror(state, 1, "size must be at least 1.\n");
+    }
+
+    RenderTarget* target = new (lua_newuserdata(state, sizeof(RenderTarget)))
+        RenderTarget(width, height);
+    RenderTarget::mTargets.push_back(target);
+    luaL_getmetatable(state, "RenderTarget");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_RenderTarget_gc(lua_State* state)
+{
+    RenderTarget* target = (RenderTarget*)lua_touserdata(state, 1);
+    assert(target);
+
+    std::vector<RenderTarget*>::iterator it =
+        std::find(RenderTarget::mTargets.begin(), RenderTarget::mTargets.end(), target);
+    if(it != RenderTarget::mTargets.end())
+    {
+        RenderTarget::mTargets.erase(it);
+    }
+
+    target->~RenderTarget();
+    return 0;
+}
+
+static int lua_RenderTarget_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "RenderTarget");
+    return 1;
+}
+
+static int lua_RenderTarget_GetTexture(lua_State* state)
+{
+    RenderTarget* target = LuaState::GetFuncParam<RenderTarget>(state, 1);
+    if(target == NULL)
+    {
+        return 0;
+    }
+
+    Texture::PushHandle(state, target->GetTextureHandle());
+    return 1;
+}
+
+static int lua_RenderTarget_GetSize(lua_State* state)
+{
+    RenderTarget* target = LuaState::GetFuncParam<RenderTarget>(state, 1);
+    if(target == NULL)
+    {
+        return 0;
+    }
+
+    lua_pushinteger(state, target->GetWidth());
+    lua_pushinteger(state, target->GetHeight());
+    return 2;
+}
+
+static int lua_RenderTarget_IsLost(lua_State* state)
+{
+    RenderTarget* target = LuaState::GetFuncParam<RenderTarget>(state, 1);
+    if(target == NULL)
+    {
+        return 0;
+    }
+
+    lua_pushboolean(state, target->IsLost());
+    return 1;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_RenderTarget_Create},
+  {"__gc", lua_RenderTarget_gc},
+  {"__tostring", lua_RenderTarget_tostring},
+  {"GetTexture", lua_RenderTarget_GetTexture},
+  {"GetSize", lua_RenderTarget_GetSize},
+  {"IsLost", lua_RenderTarget_IsLost},
+  {NULL, NULL}  /* sentinel */
+};
+
+void RenderTarget::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        RenderTarget::Meta.Name(),
+        luaBinding
+    );
+}
+
+void RenderTarget::ResetAll()
+{
+    for(std::vector<RenderTarget*>::iterator it = mTargets.begin();
+        it != mTargets.end(); ++it)
+    {
+        // The old names may already belong to the new context's textures.
+        (*it)->mFrameBuffer.Forget();
+        (*it)->Create();
+        (*it)->mLost = true;
+    }
+}
+
+RenderTarget::RenderTarget(int width, int height) :
+    mWidth(width),
+    mHeight(height),
+    mFrameBuffer(),
+    mTexture(),
+    mLost(false),
+    mPreviousBuffer(0)
+{
+    mPreviousViewport[0] = 0;
+    mPreviousViewport[1] = 0;
+    mPreviousViewport[2] = 0;
+    mPreviousViewport[3] = 0;
+    Create();
+
+    TextureManager* textures = Texture::Residency();
+    if(textures != NULL)
+    {
+        mTextureHandle = textures->AddExternal(&mTexture);
+    }
+}
+
+RenderTarget::~RenderTarget()
+{
+    TextureManager* textures = Texture::Residency();
+    if(textures != NULL)
+    {
+        textures->RemoveExternal(mTextureHandle);
+    }
+}
+
+void RenderTarget::Create()
+{
+    mFrameBuffer.Reset(mWidth, mHeight, true);
+    mTexture.SetRenderTarget(mFrameBuffer.TextureId(), mWidth, mHeight);
+}
+
+void RenderTarget::Begin()
+{
+    // Could be the window or the scene's frame buffer.
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &mPreviousBuffer);
+    glGetIntegerv(GL_VIEWPORT, mPreviousViewport);
+
+    mFrameBuffer.Enable();
+    glViewport(0, 0, mWidth, mHeight);
+
+    // Same projection as the view, sized to the target.
+    float hWidth = mWidth / 2.0f;
+    float hHeight = mHeight / 2.0f;
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrthof(-hWidth, hWidth, -hHeight, hHeight, 0.0, 0.1);
+    glMatrixMode(GL_MODELVIEW);
+
+    GLfloat clearColour[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColour);
+    glClearColor(0, 0, 0, 0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(clearColour[0], clearColour[1], clearColour[2], clearColour[3]);
+    mLost = false;
+}
+
+void RenderTarget::ReadPixels(unsigned char* out)
+{
+    assert(out);
+    GLint previous = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+    mFrameBuffer.Enable();
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, mWidth, mHeight, GL_RGBA, GL_UNSIGNED_BYTE, out);
+    glBindFramebuffer(GL_FRAMEBUFFER, previous);
+}
+
+void RenderTarget::End()
+{
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+
+    glViewport(mPreviousViewport[0],
+               mPreviousViewport[1],
+               mPreviousViewport[2],
+               mPreviousViewport[3]);
+    glBindFramebuffer(GL_FRAMEBUFFER, mPreviousBuffer);
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef RENDERTARGET_H
+#define RENDERTARGET_H
+
+#include <vector>
+
+#include "DinodeckGL.h"
+#include "FrameBuffer.h"
+#include "reflect/Reflect.h"
+#include "Texture.h"
+
+class LuaState;
+
+//
+// An off screen texture a renderer can draw into, for caching things that
+// rarely change, like a minimap or a text box, and drawing them back as a
+// single sprite.
+//
+// The texture is owned by the target. It's registered with the texture
+// manager, so sprites still using it after the target's collected draw
+// nothing. Its contents go with the GL context, after which IsLost is
+// true until it's drawn into again.
+//
+class RenderTarget
+{
+    public: static Reflect Meta;
+    public:
+        static std::vector<RenderTarget*> mTargets;
+
+        static void Bind(LuaState* state);
+
+        // Recreates each target's frame buffer, each one is lost.
+        // Call when the OpenGL context has been lost.
+        static void ResetAll();
+
+        RenderTarget(int width, int height);
+        ~RenderTarget();
+
+        // Draws go into the target until End, with the origin at its
+        // centre. Begin clears it.
+        void Begin();
+        void End();
+
+        int GetWidth() const { return mWidth; }
+        int GetHeight() const { return mHeight; }
+        Texture* GetTexture() { return &mTexture; }
+        TextureHandle GetTextureHandle() const { return mTextureHandle; }
+        bool IsLost() const { return mLost; }
+        // Copies width * height RGBA pixels out, bottom row first. Only
+        // draws that have been flushed are in them.
+        void ReadPixels(unsigned char* out);
+    private:
+        int mWidth;
+        int mHeight;
+        FrameBuffer mFrameBuffer;
+        Texture mTexture;
+        TextureHandle mTextureHandle;
+        bool mLost;
+        GLint mPreviousBuffer; // restored by End
+        GLint mPreviousViewport[4];
+
+        void Create();
+
+        // Owns GL objects.
+        RenderTarget(const RenderTarget&);
+        RenderTarget& operator=(const RenderTarget&);
+};
+
+#endif
\ No newline at end of file
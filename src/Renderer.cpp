@@ -4,16 +4,31 @@
 #include <assert.h>
 #include <cmath>
 #include <string>
+#include <string.h>
 //#include <FTGL/ftgl.h>
 
+#include "Dinodeck.h"
 #include "DinodeckGL.h"
+#include "ByteBuffer.h"
 #include "DDLog.h"
 #include "FormatText.h"
+#include "FrameArena.h"
 #include "Game.h"
 #include "GraphicsPipeline.h"
 #include "LuaState.h"
+#include "Mesh.h"
+#include "ParticleEmitter.h"
+#include "Profiler.h"
+#include "RenderTarget.h"
+#include "Scene.h"
+#include "ShaderProgram.h"
 #include "Sprite.h"
+#include "SpriteBatch.h"
+#include "TextRun.h"
 #include "Texture.h"
+#include "Tilemap.h"
+#include "VectorArray.h"
+#include "World.h"
 #include "Vector"
 
 std::vector<Renderer*> Renderer::mRenderers;
@@ -40,8 +55,13 @@ const char* Renderer::AlignYStr[AlignY::Count] =
 
 static int lua_Create(lua_State* state)
 {
+    // Optional batch size, in verts.
+    int batchSize = luaL_optinteger(state, 1,
+        GraphicsPipeline::DEFAULT_BATCH_SIZE_IN_VERTS);
+    batchSize = std::max(0, batchSize);
+
     // Instance new lets the constructor be called on a block of data
-    Renderer * r = new (lua_newuserdata(state, sizeof(Renderer))) Renderer();
+    Renderer * r = new (lua_newuserdata(state, sizeof(Renderer))) Renderer(batchSize);
 
     // Should this really be static?
     Renderer::mRenderers.push_back(r);
@@ -63,10 +83,149 @@ static int lua_DrawSprite(lua_State* state)
     {
         return luaL_typerror(state, 2, "Sprite");
     }
+    ProfileZone zone(state, "Renderer.DrawSprite");
     renderer->DrawSprite(*sprite);
     return 0;
 }
 
+//
+// renderer:DrawSprites(sprites, [first], [count])
+// sprites is a SpriteBatch or an array of Sprites. Draws count sprites
+// from first, by default all of them.
+//
+static int lua_DrawSprites(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    int length = 0;
+    SpriteBatch* batch = NULL;
+    if(LuaState::IsType<SpriteBatch>(state, 2))
+    {
+        batch = (SpriteBatch*)lua_touserdata(state, 2);
+        length = (int) batch->Count();
+    }
+    else if(lua_istable(state, 2))
+    {
+        length = (int) lua_objlen(state, 2);
+    }
+    else
+    {
+        return luaL_typerror(state, 2, "SpriteBatch or table");
+    }
+
+    int first = std::max(1, (int) luaL_optinteger(state, 3, 1));
+    int last = length;
+    if(!lua_isnoneornil(state, 4))
+    {
+        last = std::min(length, first + (int) luaL_checkinteger(state, 4) - 1);
+    }
+
+    if(last < first)
+    {
+        return 0;
+    }
+
+    ProfileZone zone(state, "Renderer.DrawSprites");
+    if(batch)
+    {
+        renderer->DrawSprites(batch->Sprites() + (first - 1), last - first + 1);
+        return 0;
+    }
+
+    for(int i = first; i <= last; i++)
+    {
+        lua_rawgeti(state, 2, i);
+        if(!LuaState::IsType<Sprite>(state, -1))
+        {
+            return luaL_error(state, "DrawSprites: element %d is not a Sprite.", i);
+        }
+        renderer->DrawSprite(*(Sprite*)lua_touserdata(state, -1));
+        lua_pop(state, 1);
+    }
+    return 0;
+}
+
+static int lua_DrawTilemap(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    Tilemap* tilemap = LuaState::GetFuncParam<Tilemap>(state, 2);
+    if(tilemap == NULL)
+    {
+        return 0;
+    }
+
+    ProfileZone zone(state, "Renderer.DrawTilemap");
+    renderer->DrawTilemap(*tilemap);
+    return 0;
+}
+
+static int lua_DrawScene(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    Scene* scene = LuaState::GetFuncParam<Scene>(state, 2);
+    if(scene == NULL)
+    {
+        return 0;
+    }
+
+    ProfileZone zone(state, "Renderer.DrawScene");
+    renderer->DrawScene(*scene);
+    return 0;
+}
+
+// renderer:DrawWorld(world) draws the world's entities with sprites.
+static int lua_DrawWorld(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    World* world = LuaState::GetFuncParam<World>(state, 2);
+    if(world == NULL)
+    {
+        return 0;
+    }
+
+    ProfileZone zone(state, "Renderer.DrawWorld");
+    renderer->DrawWorld(*world);
+    return 0;
+}
+
+static int lua_DrawParticles(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    ParticleEmitter* emitter = LuaState::GetFuncParam<ParticleEmitter>(state, 2);
+    if(emitter == NULL)
+    {
+        return 0;
+    }
+
+    ProfileZone zone(state, "Renderer.DrawParticles");
+    renderer->DrawParticles(*emitter);
+    return 0;
+}
+
 
 static int lua_DrawText2d(lua_State* state)
 {
@@ -75,13 +234,13 @@ static int lua_DrawText2d(lua_State* state)
     DefaultColor.SetXyzw(1,1,1,1);
 
     Renderer* renderer = (Renderer*)lua_touserdata(state, 1);
-    if (renderer == NULL or !luaL_checkudata(state, 1, "Renderer"))
+    if (renderer == NULL or !LuaState::IsType<Renderer>(state, 1))
     {
         return luaL_typerror(state, 1, "Renderer");
     }
     Vector* position = &DefaultPosition;
     int paramIndex = 3;
-    if (lua_isuserdata(state, 2) && LuaState::IsType(state, 2, "Vector"))
+    if (LuaState::IsType<Vector>(state, 2))
     {
         position = (Vector*)lua_touserdata(state, 2);
     }
@@ -103,7 +262,7 @@ static int lua_DrawText2d(lua_State* state)
 
     paramIndex++;
     Vector* color = &DefaultColor;
-    if(lua_isuserdata(state, paramIndex) && luaL_checkudata(state, paramIndex, "Vector"))
+    if(LuaState::IsType<Vector>(state, paramIndex))
     {
         color = (Vector*)lua_touserdata(state, paramIndex);
     }
@@ -111,6 +270,7 @@ static int lua_DrawText2d(lua_State* state)
     paramIndex++;
     float width = (float) luaL_optnumber(state, paramIndex, -1);
 
+    ProfileZone zone(state, "Renderer.DrawText2d");
     GraphicsPipeline* gp = renderer->Graphics();
     gp->PushText
     (
@@ -123,11 +283,268 @@ static int lua_DrawText2d(lua_State* state)
     return 0;
 }
 
+static const unsigned int FORMAT_BUFFER_SIZE = 1024;
+
+//
+// printf style formatting of the arguments from index on into out. The
+// values are read where they lie, numbers never become Lua strings.
+// Supports %d %i %u %x %X %o %c %f %e %g %s and %%, with flags, width and
+// precision. Returns the index after the last argument used.
+//
+static int FormatArguments(lua_State* state,
+                           const char* format,
+                           int index,
+                           char* out,
+                           unsigned int size)
+{
+    assert(size > 0);
+    unsigned int length = 0;
+    const char* c = format;
+    while(*c != '\0' && length + 1 < size)
+    {
+        if(*c != '%')
+        {
+            out[length++] = *c++;
+            continue;
+        }
+
+        if(c[1] == '%')
+        {
+            out[length++] = '%';
+            c += 2;
+            continue;
+        }
+
+        // Room for the conversion, a length modifier and the terminator.
+        char spec[16];
+        unsigned int specLength = 0;
+        spec[specLength++] = *c++;
+        while(*c != '\0'
+              && strchr("-+ #0123456789.", *c) != NULL
+              && specLength < sizeof(spec) - 3)
+        {
+            spec[specLength++] = *c++;
+        }
+
+        const char conversion = *c;
+        if(conversion == '\0')
+        {
+            return luaL_error(state, "DrawTextf: format ends in a %%.");
+        }
+        c++;
+
+        const unsigned int room = size - length;
+        int written = 0;
+        switch(conversion)
+        {
+            case 'd':
+            case 'i':
+            case 'c':
+            {
+                spec[specLength++] = (conversion == 'c') ? 'c' : 'l';
+                if(conversion != 'c')
+                {
+                    spec[specLength++] = conversion;
+                }
+                spec[specLength] = '\0';
+                long value = (long) luaL_checknumber(state, index++);
+                written = (conversion == 'c')
+                        ? snprintf(out + length, room, spec, (int) value)
+                        : snprintf(out + length, room, spec, value);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+            {
+                spec[specLength++] = 'l';
+                spec[specLength++] = conversion;
+                spec[specLength] = '\0';
+                unsigned long value = (unsigned long) (long) luaL_checknumber(state, index++);
+                written = snprintf(out + length, room, spec, value);
+                break;
+            }
+            case 'f':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            {
+                spec[specLength++] = conversion;
+                spec[specLength] = '\0';
+                written = snprintf(out + length, room, spec, (double) luaL_checknumber(state, index++));
+                break;
+            }
+            case 's':
+            {
+                spec[specLength++] = 's';
+                spec[specLength] = '\0';
+
+                // lua_tolstring would turn a number into a string in place.
+                char number[32];
+                const char* str = NULL;
+                int type = lua_type(state, index);
+                if(type == LUA_TSTRING)
+                {
+                    str = lua_tostring(state, index);
+                }
+                else if(type == LUA_TNUMBER)
+                {
+                    snprintf(number, sizeof(number), "%.14g", lua_tonumber(state, index));
+                    str = number;
+                }
+                else if(type == LUA_TBOOLEAN)
+                {
+                    str = lua_toboolean(state, index) ? "true" : "false";
+                }
+                else if(type == LUA_TNIL)
+                {
+                    str = "nil";
+                }
+                else
+                {
+                    return luaL_typerror(state, index, "string");
+                }
+                index++;
+                written = snprintf(out + length, room, spec, str);
+                break;
+            }
+            default:
+            {
+                return luaL_error(state, "DrawTextf: %%%c isn't supported.", conversion);
+            }
+        }
+
+        // snprintf returns what it would have written had there been room.
+        if(written > 0)
+        {
+            length += std::min((unsigned int) written, room - 1);
+        }
+    }
+    out[length] = '\0';
+    return index;
+}
+
+//
+// renderer:DrawTextf(x, y, format, ...)
+// Position is also taken as a Vector. The values are formatted as printf
+// does, straight into frame memory, so HUD text that changes every frame
+// makes no Lua strings. A Vector after the values is the colour.
+//
+static int lua_DrawTextf(lua_State* state)
+{
+    static Vector DefaultColor(1, 1, 1, 1);
+
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    double x = 0;
+    double y = 0;
+    int paramIndex = 3;
+    if(LuaState::IsType<Vector>(state, 2))
+    {
+        Vector* position = (Vector*)lua_touserdata(state, 2);
+        x = position->x;
+        y = position->y;
+    }
+    else if(lua_isnumber(state, 2) && lua_isnumber(state, 3))
+    {
+        x = lua_tonumber(state, 2);
+        y = lua_tonumber(state, 3);
+        paramIndex = 4;
+    }
+    else
+    {
+        return luaL_typerror(state, 2, "Vector");
+    }
+
+    if(lua_type(state, paramIndex) != LUA_TSTRING)
+    {
+        return luaL_typerror(state, paramIndex, "string");
+    }
+    const char* format = lua_tostring(state, paramIndex);
+
+    char* text = (char*) FrameArena::Allocate(FORMAT_BUFFER_SIZE);
+    paramIndex = FormatArguments(state, format, paramIndex + 1, text, FORMAT_BUFFER_SIZE);
+
+    Vector* colour = &DefaultColor;
+    if(LuaState::IsType<Vector>(state, paramIndex))
+    {
+        colour = (Vector*)lua_touserdata(state, paramIndex);
+    }
+
+    ProfileZone zone(state, "Renderer.DrawTextf");
+    renderer->Graphics()->PushText((float) x, (float) y, text, *colour, -1);
+    return 0;
+}
+
+//
+// renderer:DrawTextRun(x, y, run, [count], [colour])
+// Position is also taken as a Vector. Draws the run's first count glyphs,
+// all of them by default, and returns how many glyphs the run has.
+//
+static int lua_DrawTextRun(lua_State* state)
+{
+    static Vector DefaultColor(1, 1, 1, 1);
+
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    double x = 0;
+    double y = 0;
+    int paramIndex = 3;
+    if(LuaState::IsType<Vector>(state, 2))
+    {
+        Vector* position = (Vector*)lua_touserdata(state, 2);
+        x = position->x;
+        y = position->y;
+    }
+    else if(lua_isnumber(state, 2) && lua_isnumber(state, 3))
+    {
+        x = lua_tonumber(state, 2);
+        y = lua_tonumber(state, 3);
+        paramIndex = 4;
+    }
+    else
+    {
+        return luaL_typerror(state, 2, "Vector");
+    }
+
+    TextRun* run = LuaState::GetFuncParam<TextRun>(state, paramIndex);
+    if(run == NULL)
+    {
+        return 0;
+    }
+
+    unsigned int count = 0xFFFFFFFF;
+    if(!lua_isnoneornil(state, paramIndex + 1))
+    {
+        count = (unsigned int) std::max(0, (int) luaL_checkinteger(state, paramIndex + 1));
+    }
+
+    Vector* color = &DefaultColor;
+    if(LuaState::IsType<Vector>(state, paramIndex + 2))
+    {
+        color = (Vector*)lua_touserdata(state, paramIndex + 2);
+    }
+
+    ProfileZone zone(state, "Renderer.DrawTextRun");
+    renderer->Graphics()->PushTextRun((float) x, (float) y, run, count, *color);
+    lua_pushinteger(state, run->GlyphCount());
+    return 1;
+}
 
 static int lua_DrawCircle2d(lua_State* state)
 {
     Renderer* renderer = (Renderer*)lua_touserdata(state, 1);
-    if (renderer == NULL or !luaL_checkudata(state, 1, "Renderer"))
+    if (renderer == NULL or !LuaState::IsType<Renderer>(state, 1))
     {
         return luaL_typerror(state, 1, "Renderer");
     }
@@ -144,13 +561,13 @@ static int lua_DrawCircle2d(lua_State* state)
 
         Vector* color = &RGBA;
 
-        if (lua_isuserdata(state, 6) and luaL_checkudata (state, 6, "Vector"))
+        if (LuaState::IsType<Vector>(state, 6))
         {
             color = LuaState::GetFuncParam<Vector>(state, 6);
         }
         renderer->DrawCircle2d(x, y, radius, segments, (*color));
     }
-    else if(LuaState::IsType(state, 2, "Vector"))
+    else if(LuaState::IsType<Vector>(state, 2))
     {
         Vector* vector = LuaState::GetFuncParam<Vector>(state, 2);
 
@@ -163,7 +580,7 @@ static int lua_DrawCircle2d(lua_State* state)
 
         Vector* color = &RGBA;
 
-        if (lua_isuserdata(state, 5) and luaL_checkudata (state, 5, "Vector"))
+        if (LuaState::IsType<Vector>(state, 5))
         {
             color = LuaState::GetFuncParam<Vector>(state, 5);
         }
@@ -178,82 +595,404 @@ static int lua_DrawCircle2d(lua_State* state)
 }
 
 
-static int lua_DrawRect2d(lua_State* state)
+static int lua_DrawFilledCircle2d(lua_State* state)
 {
-    Renderer* renderer = (Renderer*)lua_touserdata(state, 1);
-    if (renderer == NULL or !luaL_checkudata (state, 1, "Renderer"))
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
     {
-        return luaL_typerror(state, 1, "Renderer");
+        return 0;
     }
+    static Vector RGBA;
+    RGBA.SetXyzw(1,1,1,1);
+    int defaultSegments = 16;
 
-    static Vector DefaultBottomLeft;
-    static Vector DefaultTopRight;
-    Vector* bottomLeftVector = &DefaultBottomLeft;
-    Vector* topRightVector = &DefaultTopRight;
-
-    // Going to ignore texture
-
-    int colorPosition = 4;
-    if (lua_isuserdata(state, 2) and luaL_checkudata (state, 2, "Vector"))
+    double x = 0;
+    double y = 0;
+    int radiusParam = 4;
+    if(lua_isnumber(state, 2))
     {
-        bottomLeftVector = (Vector*)lua_touserdata(state, 2);
-        topRightVector = (Vector*)lua_touserdata(state, 3);
-        if (topRightVector == NULL or !luaL_checkudata (state, 3, "Vector"))
+        x = luaL_checknumber(state, 2);
+        y = luaL_checknumber(state, 3);
+    }
+    else if(LuaState::IsType<Vector>(state, 2))
+    {
+        Vector* vector = LuaState::GetFuncParam<Vector>(state, 2);
+        if(NULL == vector)
         {
-            return luaL_typerror(state, 3, "Vector");
+            return luaL_typerror(state, 2, "number or Vector");
         }
+        x = vector->x;
+        y = vector->y;
+        radiusParam = 3;
     }
     else
     {
-        // Numbers
-        double left = luaL_checknumber(state, 2);
-        double bottom = luaL_checknumber(state, 3);
-        double right = luaL_checknumber(state, 4);
-        double top = luaL_checknumber(state, 5);
-        colorPosition = 6;
-        DefaultBottomLeft.SetXyzw(left, bottom, 0, 0);
-        DefaultTopRight.SetXyzw(right, top, 0, 0);
+        return luaL_typerror(state, 2, "number or Vector");
     }
 
-    Vector defaultColour;
-    Vector* colour = (Vector*) lua_touserdata(state, colorPosition);
-    if(colour == NULL)
+    double radius = luaL_checknumber(state, radiusParam);
+    int segments = luaL_optnumber(state, radiusParam + 1, defaultSegments);
+
+    Vector* color = &RGBA;
+    int colourParam = radiusParam + 2;
+    if (LuaState::IsType<Vector>(state, colourParam))
     {
-         if(!luaL_checkudata (state, colorPosition, "Vector"))
-         {
-            return luaL_typerror(state, colorPosition, "Vector");
-         }
-         colour = &defaultColour;
+        color = LuaState::GetFuncParam<Vector>(state, colourParam);
     }
-
-    renderer->DrawRect2d(*bottomLeftVector, *topRightVector, *colour);
+    renderer->DrawFilledCircle2d(x, y, radius, segments, (*color));
     return 0;
 }
 
-
-int lua_gc(lua_State* state)
+//
+// Reads a Lua array of points, either Vectors or flat x, y numbers,
+// as x, y pairs.
+//
+static bool ReadPoints(lua_State* state, int index, FrameVector<float>::Type* outPoints)
 {
-    Renderer* renderer = (Renderer*)lua_touserdata(state, 1);
-    assert(renderer);
+    if(!lua_istable(state, index))
+    {
+        return false;
+    }
 
-    // Iterate through all renders
-    // This could be sped up but it's probably not going to be a bottleneck?
-    for(std::vector<Renderer*>::reverse_iterator riter = Renderer::mRenderers.rbegin(); riter < Renderer::mRenderers.rend(); ++riter )
+    int count = lua_objlen(state, index);
+    outPoints->reserve(count * 2);
+    for(int i = 1; i <= count; i++)
     {
-        if(renderer == (*riter))
+        // IsType can leave the metatables on the stack, so restore the top.
+        int top = lua_gettop(state);
+        lua_rawgeti(state, index, i);
+        int point = top + 1;
+        if(lua_isnumber(state, point))
         {
-            Renderer::mRenderers.erase((riter+1).base()); // oh stl
-            return 0;
+            outPoints->push_back((float) lua_tonumber(state, point));
+        }
+        else if(LuaState::IsType<Vector>(state, point))
+        {
+            Vector* vector = LuaState::GetFuncParam<Vector>(state, point);
+            outPoints->push_back((float) vector->x);
+            outPoints->push_back((float) vector->y);
+        }
+        else
+        {
+            lua_settop(state, top);
+            return false;
         }
+        lua_settop(state, top);
     }
-    assert(!"ERROR: Failed to find renderer pointer to clear up. Something has gone wrong.\n");
-    // I thought I might need this
-    // if renderers need calling from the minigame
-    // like they queue up all their render calls
-    // and run then at the end of each frame
-    // But perhaps not right now.
-    return 0;
-}
+
+    // A flat list with an odd count has a dangling x
+    if(outPoints->size() % 2 != 0)
+    {
+        outPoints->pop_back();
+    }
+    return true;
+}
+
+static int lua_DrawPolygon2d(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+    static Vector RGBA;
+    RGBA.SetXyzw(1,1,1,1);
+
+    FrameVector<float>::Type points;
+    if(!ReadPoints(state, 2, &points))
+    {
+        return luaL_typerror(state, 2, "table of Vectors or numbers");
+    }
+
+    Vector* color = &RGBA;
+    if (LuaState::IsType<Vector>(state, 3))
+    {
+        color = LuaState::GetFuncParam<Vector>(state, 3);
+    }
+    if(!points.empty())
+    {
+        renderer->DrawPolygon2d(&points[0], points.size() / 2, (*color));
+    }
+    return 0;
+}
+
+static int lua_DrawLines2d(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+    static Vector RGBA;
+    RGBA.SetXyzw(1,1,1,1);
+
+    FrameVector<float>::Type points;
+    if(!ReadPoints(state, 2, &points))
+    {
+        return luaL_typerror(state, 2, "table of Vectors or numbers");
+    }
+
+    double width = luaL_optnumber(state, 3, 1);
+
+    Vector* color = &RGBA;
+    if (LuaState::IsType<Vector>(state, 4))
+    {
+        color = LuaState::GetFuncParam<Vector>(state, 4);
+    }
+    if(!points.empty())
+    {
+        renderer->DrawLines2d(&points[0], points.size() / 2, width, (*color));
+    }
+    return 0;
+}
+
+static int lua_DrawRect2d(lua_State* state)
+{
+    Renderer* renderer = (Renderer*)lua_touserdata(state, 1);
+    if (renderer == NULL or !LuaState::IsType<Renderer>(state, 1))
+    {
+        return luaL_typerror(state, 1, "Renderer");
+    }
+
+    static Vector DefaultBottomLeft;
+    static Vector DefaultTopRight;
+    Vector* bottomLeftVector = &DefaultBottomLeft;
+    Vector* topRightVector = &DefaultTopRight;
+
+    // Going to ignore texture
+
+    int colorPosition = 4;
+    if (LuaState::IsType<Vector>(state, 2))
+    {
+        bottomLeftVector = (Vector*)lua_touserdata(state, 2);
+        topRightVector = (Vector*)lua_touserdata(state, 3);
+        if (topRightVector == NULL or !LuaState::IsType<Vector>(state, 3))
+        {
+            return luaL_typerror(state, 3, "Vector");
+        }
+    }
+    else
+    {
+        // Numbers
+        double left = luaL_checknumber(state, 2);
+        double bottom = luaL_checknumber(state, 3);
+        double right = luaL_checknumber(state, 4);
+        double top = luaL_checknumber(state, 5);
+        colorPosition = 6;
+        DefaultBottomLeft.SetXyzw(left, bottom, 0, 0);
+        DefaultTopRight.SetXyzw(right, top, 0, 0);
+    }
+
+    Vector defaultColour;
+    Vector* colour = (Vector*) lua_touserdata(state, colorPosition);
+    if(colour == NULL)
+    {
+         if(!LuaState::IsType<Vector>(state, colorPosition))
+         {
+            return luaL_typerror(state, colorPosition, "Vector");
+         }
+         colour = &defaultColour;
+    }
+
+    renderer->DrawRect2d(*bottomLeftVector, *topRightVector, *colour);
+    return 0;
+}
+
+//
+// renderer:DrawNineSlice(texture, rect, borders, [colour])
+// rect is a Vector of left, bottom, right and top. borders is a Vector of
+// the left, bottom, right and top border widths in texture pixels.
+//
+static int lua_DrawNineSlice(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    TextureHandle* handle = Texture::GetFuncParamHandle(state, 2);
+    if(handle == NULL)
+    {
+        return 0;
+    }
+
+    Vector* rect = LuaState::GetFuncParam<Vector>(state, 3);
+    if(rect == NULL)
+    {
+        return 0;
+    }
+
+    Vector* borders = LuaState::GetFuncParam<Vector>(state, 4);
+    if(borders == NULL)
+    {
+        return 0;
+    }
+
+    Vector defaultColour(1, 1, 1, 1);
+    Vector* colour = &defaultColour;
+    if(!lua_isnoneornil(state, 5))
+    {
+        colour = LuaState::GetFuncParam<Vector>(state, 5);
+        if(colour == NULL)
+        {
+            return 0;
+        }
+    }
+
+    // Destroyed or not yet loaded, like sprites it draws nothing.
+    Texture* texture = Texture::Resolve(*handle);
+    if(texture == NULL)
+    {
+        return 0;
+    }
+
+    ProfileZone zone(state, "Renderer.DrawNineSlice");
+    renderer->DrawNineSlice(texture, *rect, *borders, *colour);
+    return 0;
+}
+
+static const char* drawModeNames[] = { "triangles", "quads", NULL };
+
+//
+// renderer:DrawVertices(texture, verts, [count], ["triangles" | "quads"])
+// texture may be nil for untextured verts. verts is a ByteBuffer of 16
+// byte packed verts, x and y floats, r g b a bytes then u and v shorts in
+// 1/8192ths, or a VectorArray of x, y, u, v drawn white. Quads are TL TR
+// BL BR. count is in verts, all of them by default.
+//
+static int lua_DrawVertices(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    Texture* texture = NULL;
+    if(!lua_isnil(state, 2))
+    {
+        TextureHandle* handle = Texture::GetFuncParamHandle(state, 2);
+        if(handle == NULL)
+        {
+            return 0;
+        }
+
+        // Destroyed or not yet loaded, like sprites it draws nothing.
+        texture = Texture::Resolve(*handle);
+        if(texture == NULL)
+        {
+            return 0;
+        }
+    }
+
+    const int mode = luaL_checkoption(state, 5, "triangles", drawModeNames);
+    const eDrawMode drawMode = mode == 1 ? QUADS : TRIANGLES;
+
+    if(LuaState::IsType<ByteBuffer>(state, 3))
+    {
+        ByteBuffer* buffer = (ByteBuffer*)lua_touserdata(state, 3);
+        const unsigned int available = buffer->Size() / sizeof(PackedVertex);
+        const unsigned int count = std::min(available,
+            (unsigned int) std::max(0, (int) luaL_optinteger(state, 4, available)));
+        if(count == 0)
+        {
+            return 0;
+        }
+
+        ProfileZone zone(state, "Renderer.DrawVertices");
+        const PackedVertex* verts = (const PackedVertex*) buffer->Data();
+
+        // Views into a pack or a mapping may not be float aligned.
+        FrameVector<PackedVertex>::Type aligned;
+        if((size_t) verts % sizeof(float) != 0)
+        {
+            aligned.resize(count);
+            memcpy(&aligned[0], verts, count * sizeof(PackedVertex));
+            verts = &aligned[0];
+        }
+        renderer->Graphics()->PushVertices(verts, count, texture, drawMode);
+        return 0;
+    }
+
+    if(LuaState::IsType<VectorArray>(state, 3))
+    {
+        VectorArray* array = (VectorArray*)lua_touserdata(state, 3);
+        const unsigned int count = std::min(array->Count(),
+            (unsigned int) std::max(0, (int) luaL_optinteger(state, 4, array->Count())));
+        if(count == 0)
+        {
+            return 0;
+        }
+
+        ProfileZone zone(state, "Renderer.DrawVertices");
+        FrameVector<PackedVertex>::Type verts(count);
+        for(unsigned int i = 0; i < count; i++)
+        {
+            verts[i].x = array->X(i);
+            verts[i].y = array->Y(i);
+            verts[i].u = PackedVertex::PackUV(array->Z(i));
+            verts[i].v = PackedVertex::PackUV(array->W(i));
+        }
+        renderer->Graphics()->PushVertices(&verts[0], count, texture, drawMode);
+        return 0;
+    }
+
+    return luaL_typerror(state, 3, "ByteBuffer or VectorArray");
+}
+
+//
+// renderer:DrawMesh(name, [x], [y])
+// Draws a mesh from the manifest's meshes table, moved by x and y. Returns
+// false if there's no such mesh or it has nothing to draw yet.
+//
+static int lua_DrawMesh(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    const char* name = luaL_checkstring(state, 2);
+    const float x = (float) luaL_optnumber(state, 3, 0);
+    const float y = (float) luaL_optnumber(state, 4, 0);
+
+    Mesh* mesh = Dinodeck::GetInstance()->GetMeshes()->Find(name);
+    if(mesh == NULL)
+    {
+        lua_pushboolean(state, false);
+        return 1;
+    }
+
+    ProfileZone zone(state, "Renderer.DrawMesh");
+    lua_pushboolean(state, renderer->Graphics()->DrawMesh(mesh, x, y));
+    return 1;
+}
+
+int lua_gc(lua_State* state)
+{
+    Renderer* renderer = (Renderer*)lua_touserdata(state, 1);
+    assert(renderer);
+
+    // Iterate through all renders
+    // This could be sped up but it's probably not going to be a bottleneck?
+    for(std::vector<Renderer*>::reverse_iterator riter = Renderer::mRenderers.rbegin(); riter < Renderer::mRenderers.rend(); ++riter )
+    {
+        if(renderer == (*riter))
+        {
+            Renderer::mRenderers.erase((riter+1).base()); // oh stl
+            return 0;
+        }
+    }
+    assert(!"ERROR: Failed to find renderer pointer to clear up. Something has gone wrong.\n");
+    // I thought I might need this
+    // if renderers need calling from the minigame
+    // like they queue up all their render calls
+    // and run then at the end of each frame
+    // But perhaps not right now.
+    return 0;
+}
 
 
 static int lua_ScaleText(lua_State* state)
@@ -328,10 +1067,9 @@ static int lua_AlignText(lua_State* state)
     if(lua_isstring(state, 2))
     {
         const char* alignStr = lua_tostring(state, 2);
-        std::string align = std::string(alignStr);
         for(int i = 0; i < AlignX::Count; i++)
         {
-            if(align == Renderer::AlignXStr[i])
+            if(strcmp(alignStr, Renderer::AlignXStr[i]) == 0)
             {
                 renderer->Graphics()->SetTextAlignX((AlignX::Enum)i);
             }
@@ -342,10 +1080,9 @@ static int lua_AlignText(lua_State* state)
     if(lua_isstring(state, 3))
     {
         const char* alignStr = lua_tostring(state, 3);
-        std::string align = std::string(alignStr);
         for(int i = 0; i < AlignY::Count; i++)
         {
-            if(align == Renderer::AlignYStr[i])
+            if(strcmp(alignStr, Renderer::AlignYStr[i]) == 0)
             {
                 renderer->Graphics()->SetTextAlignY((AlignY::Enum)i);
             }
@@ -369,10 +1106,9 @@ static int lua_AlignTextX(lua_State* state)
         return 0;
     }
 
-    std::string align = std::string(alignStr);
     for(int i = 0; i < AlignX::Count; i++)
     {
-        if(align == Renderer::AlignXStr[i])
+        if(strcmp(alignStr, Renderer::AlignXStr[i]) == 0)
         {
             renderer->Graphics()->SetTextAlignX((AlignX::Enum)i);
         }
@@ -394,10 +1130,9 @@ static int lua_AlignTextY(lua_State* state)
         return 0;
     }
 
-    std::string align = std::string(alignStr);
     for(int i = 0; i < AlignY::Count; i++)
     {
-        if(align == Renderer::AlignYStr[i])
+        if(strcmp(alignStr, Renderer::AlignYStr[i]) == 0)
         {
             renderer->Graphics()->SetTextAlignY((AlignY::Enum)i);
         }
@@ -445,7 +1180,7 @@ static int lua_NextLine(lua_State* state)
     //dsprintf("NextLine(\"%s\", %d, %f)\n", text, cursor, maxwidth);
 
     // Rest are outs
-    FTTextureFont* font = gp->GetFont();
+    Font* font = gp->GetFont();
 
     int outStart = 0;
     int outFinish = 0;
@@ -461,6 +1196,7 @@ static int lua_NextLine(lua_State* state)
         &outFinish,
         &outPixelWidth
     );
+    GraphicsPipeline::GLState().InvalidateTexture(); // may load glyphs
 
     lua_pushnumber(state, outStart + 1);
     lua_pushnumber(state, outFinish + 1);
@@ -487,7 +1223,7 @@ static int lua_MeasureText(lua_State* state)
     Vector* vector = NULL;
     int returnValues = 0;
     int widthParam = 3;
-    if (lua_isuserdata(state, 3) && LuaState::IsType(state, 3, "Vector"))
+    if (LuaState::IsType<Vector>(state, 3))
     {
         vector = (Vector*)lua_touserdata(state, 3);
         widthParam = 4;
@@ -515,96 +1251,479 @@ static int lua_MeasureText(lua_State* state)
 }
 
 
-static int lua_SetTextRotation(lua_State* state)
+static int lua_SetTextRotation(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+    GraphicsPipeline* gp = renderer->Graphics();
+    if(!lua_isnumber(state, 2))
+    {
+        luaL_typerror(state, 2, "number");
+    }
+    double rot = lua_tonumber(state, 2);
+    gp->SetTextRotation(rot);
+    return 0;
+}
+
+
+static int lua_GetTextRotation(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+    GraphicsPipeline* gp = renderer->Graphics();
+    lua_pushnumber(state, gp->GetTextRotation());
+    return 1;
+}
+
+
+static int lua_DrawLine2d(lua_State* state)
+{
+    static Vector DefaultStart;
+    static Vector DefaultEnd;
+    static Vector DefaultColor;
+    DefaultColor.SetXyzw(1, 1, 1, 1);
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    int colourParam = 6;
+    Vector* start = &DefaultStart;
+    Vector* end = &DefaultEnd;
+    if(lua_isnumber(state, 2))
+    {
+        double x1 = luaL_checknumber(state, 2);
+        double y1 = luaL_checknumber(state, 3);
+        double x2 = luaL_checknumber(state, 4);
+        double y2 = luaL_checknumber(state, 5);
+        DefaultStart.SetX(x1);
+        DefaultStart.SetY(y1);
+        DefaultEnd.SetX(x2);
+        DefaultEnd.SetY(y2);
+        colourParam = 6;
+    }
+    else if (LuaState::IsType<Vector>(state, 2))
+    {
+        start = LuaState::GetFuncParam<Vector>(state, 2);
+        if(start == NULL)
+        {
+            return 0;
+        }
+        end = LuaState::GetFuncParam<Vector>(state, 3);
+        if(end == NULL)
+        {
+            return 0;
+        }
+        colourParam = 4;
+    }
+    else
+    {
+        return luaL_typerror(state, 2, "Vector or number");
+    }
+
+    Vector* color = &DefaultColor;
+    if(LuaState::IsType<Vector>(state, colourParam))
+    {
+        color = LuaState::GetFuncParam<Vector>(state, colourParam);
+    }
+
+    renderer->DrawLine2d(*start, *end, *color);
+
+    return 0;
+}
+
+
+static int lua_Translate(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    if(LuaState::IsType<Vector>(state, 2))
+    {
+        Vector* position = LuaState::GetFuncParam<Vector>(state, 2);
+        renderer->Graphics()->SetCameraPosition(*position);
+    }
+    else if(lua_isnumber(state, 2))
+    {
+        const Vector& pos = renderer->Graphics()->CameraPosition();
+        float transX = lua_tonumber(state, 2);
+        float transY = luaL_optnumber(state, 3, pos.y);
+        renderer->Graphics()->SetCameraPosition(transX, transY);
+    }
+    else
+    {
+        return luaL_typerror(state, 2, "Vector or number");
+    }
+    return 0;
+}
+
+
+static int lua_GetTranslate(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    const Vector& pos = renderer->Graphics()->CameraPosition();
+    Vector* vector = new (lua_newuserdata(state, sizeof(Vector))) Vector();
+    assert(vector != NULL);
+    luaL_getmetatable(state, "Vector");
+    lua_setmetatable(state, -2);
+    vector->SetXyzw(pos);
+    return 1;
+}
+
+
+static int lua_SetFont(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    if(!lua_isstring(state,  2))
+    {
+        return luaL_typerror(state, 2, "string");
+    }
+
+    const char* fontname = lua_tostring(state, 2);
+
+    if(!renderer->Graphics()->SetFont(fontname))
+    {
+        return luaL_error(state, "Font: \"%s\" does not exist.", fontname);
+    }
+
+    return 0;
+}
+
+
+static int lua_SetBlend(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    if(!lua_isnumber(state,  2))
+    {
+        return luaL_typerror(state, 2, "number");
+    }
+
+    int blendNum = lua_tonumber(state, 2);
+
+    if(blendNum < 0 or blendNum >= BLEND_COUNT)
+    {
+        return luaL_error(state, "Invalid blend mode.");
+    }
+
+    eBlendMode blendMode = (eBlendMode) blendNum;
+    renderer->Graphics()->SetBlend(blendMode);
+    return 0;
+}
+
+
+static int lua_Scale(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    if(LuaState::IsType<Vector>(state, 2))
+    {
+        Vector* position = LuaState::GetFuncParam<Vector>(state, 2);
+        renderer->Graphics()->SetCameraScale(*position);
+    }
+    else if(lua_isnumber(state, 2))
+    {
+        const Vector& scale = renderer->Graphics()->CameraScale();
+         float scaleX = lua_tonumber(state, 2);
+         float scaleY = luaL_optnumber(state, 3, scale.y);
+         renderer->Graphics()->SetCameraScale(scaleX, scaleY);
+    }
+    else
+    {
+        return luaL_typerror(state, 2, "Vector or number");
+    }
+    return 0;
+}
+
+
+static int lua_GetScale(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    const Vector& pos = renderer->Graphics()->CameraScale();
+    Vector* vector = new (lua_newuserdata(state, sizeof(Vector))) Vector();
+    assert(vector != NULL);
+    luaL_getmetatable(state, "Vector");
+    lua_setmetatable(state, -2);
+    vector->SetXyzw(pos);
+
+    return 1;
+}
+static int lua_Rotate(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+    float rot = luaL_optnumber(state, 2, renderer->Graphics()->CameraRotation());
+    renderer->Graphics()->SetCameraRotation(rot);
+    return 0;
+}
+
+
+static int lua_GetRotate(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    float rot = renderer->Graphics()->CameraRotation();
+    lua_pushnumber(state, rot);
+    return 1;
+}
+
+static int lua_GetKern(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    const char* currentStr = luaL_optstring(state, 2, "\0");
+    const char* nextStr = luaL_optstring(state, 3, "\0");
+
+    if(std::string(currentStr) == "" or std::string(nextStr) == "")
+    {
+        return 0;
+    }
+
+    float kern = FormatText::GetKern(renderer->Graphics()->GetFont(),
+    (int) currentStr[0],
+    (int) nextStr[0]);
+    GraphicsPipeline::GLState().InvalidateTexture(); // may load glyphs
+    lua_pushnumber(state, kern);
+    return 1;
+}
+
+static int lua_Clip(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    // Expecting an x, y, w, h
+    if(!lua_isnumber(state,  2)) { return luaL_typerror(state, 2, "number"); }
+    if(!lua_isnumber(state,  3)) { return luaL_typerror(state, 3, "number"); }
+    if(!lua_isnumber(state,  4)) { return luaL_typerror(state, 4, "number"); }
+    if(!lua_isnumber(state,  5)) { return luaL_typerror(state, 5, "number"); }
+
+    int x = (int)lua_tonumber(state, 2);
+    int y = (int)lua_tonumber(state, 3);
+    int w = std::max(0, (int)lua_tonumber(state, 4));
+    int h = std::max(0, (int)lua_tonumber(state, 5));
+
+    if(!lua_isfunction(state, 6))
+    {
+        return luaL_typerror(state, 6, "function");
+    }
+
+    renderer->Graphics()->PushScissor(x, y, w, h);
+    {
+        // Call the function, not sure what happens if it errors.
+        lua_call (state, 0, 0);
+    }
+    renderer->Graphics()->PopScissor();
+
+    return 0;
+}
+
+static int lua_SetBatchSize(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    if(!lua_isnumber(state, 2))
+    {
+        return luaL_typerror(state, 2, "number");
+    }
+
+    int batchSize = std::max(0, (int)lua_tonumber(state, 2));
+    renderer->Graphics()->SetBatchSize(batchSize);
+    return 0;
+}
+
+static int lua_GetBatchSize(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    lua_pushnumber(state, renderer->Graphics()->BatchSize());
+    return 1;
+}
+
+// Number of times a full batch has forced a flush since creation.
+// If this climbs every frame, the batch size is too small for the scene.
+static int lua_GetCapacityFlushes(lua_State* state)
 {
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
     {
         return 0;
     }
-    GraphicsPipeline* gp = renderer->Graphics();
-    if(!lua_isnumber(state, 2))
+
+    lua_pushnumber(state, renderer->Graphics()->CapacityFlushCount());
+    return 1;
+}
+
+// Returns glyphs rasterized, glyph pages and the fraction of those pages
+// in use, for the current font.
+static int lua_GetGlyphAtlasStats(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL || renderer->Graphics()->GetFont() == NULL)
     {
-        luaL_typerror(state, 2, "number");
+        return 0;
     }
-    double rot = lua_tonumber(state, 2);
-    gp->SetTextRotation(rot);
-    return 0;
-}
 
+    GlyphAtlasStats stats;
+    FormatText::GetGlyphAtlasStats(renderer->Graphics()->GetFont(), &stats);
+    lua_pushnumber(state, stats.glyphs);
+    lua_pushnumber(state, stats.pages);
+    lua_pushnumber(state, stats.occupancy);
+    return 3;
+}
 
-static int lua_GetTextRotation(lua_State* state)
+// Returns cache hits, misses and strings cached for text layout,
+// hits and misses are totals since the renderer was created.
+static int lua_GetTextCacheStats(lua_State* state)
 {
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
     {
         return 0;
     }
-    GraphicsPipeline* gp = renderer->Graphics();
-    lua_pushnumber(state, gp->GetTextRotation());
-    return 1;
-}
 
+    const TextLayoutCache& cache = renderer->Graphics()->LayoutCache();
+    lua_pushnumber(state, cache.Hits());
+    lua_pushnumber(state, cache.Misses());
+    lua_pushnumber(state, cache.Size());
+    return 3;
+}
 
-static int lua_DrawLine2d(lua_State* state)
+// Returns the GL state calls made and skipped by the cache last frame.
+static int lua_GetGLStateStats(lua_State* state)
 {
-    static Vector DefaultStart;
-    static Vector DefaultEnd;
-    static Vector DefaultColor;
-    DefaultColor.SetXyzw(1, 1, 1, 1);
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
     {
         return 0;
     }
 
-    int colourParam = 6;
-    Vector* start = &DefaultStart;
-    Vector* end = &DefaultEnd;
-    if(lua_isnumber(state, 2))
+    const GLStateCache& cache = GraphicsPipeline::GLState();
+    lua_pushnumber(state, cache.LastFrameIssued());
+    lua_pushnumber(state, cache.LastFrameSkipped());
+    return 2;
+}
+
+// Returns draw calls, verts and texture binds last frame, and the GPU
+// milliseconds spent on the scene and on scaling it to the window, -1 if
+// they can't be measured. Counts are for every renderer.
+static int lua_GetStats(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
     {
-        double x1 = luaL_checknumber(state, 2);
-        double y1 = luaL_checknumber(state, 3);
-        double x2 = luaL_checknumber(state, 4);
-        double y2 = luaL_checknumber(state, 5);
-        DefaultStart.SetX(x1);
-        DefaultStart.SetY(y1);
-        DefaultEnd.SetX(x2);
-        DefaultEnd.SetY(y2);
-        colourParam = 6;
+        return 0;
     }
-    else if (lua_isuserdata(state, 2) and luaL_checkudata (state, 2, "Vector"))
+
+    const DrawStats& stats = GraphicsPipeline::LastFrameStats();
+    Dinodeck* dinodeck = Dinodeck::GetInstance();
+    lua_pushnumber(state, stats.drawCalls);
+    lua_pushnumber(state, stats.verts);
+    lua_pushnumber(state, GraphicsPipeline::GLState().LastFrameTextureBinds());
+    lua_pushnumber(state, dinodeck->SceneGPUTime());
+    lua_pushnumber(state, dinodeck->PresentGPUTime());
+    return 5;
+}
+
+// Returns batches flushed last frame for a texture change, a draw mode
+// change, a full batch, text and anything else.
+static int lua_GetFlushStats(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
     {
-        start = LuaState::GetFuncParam<Vector>(state, 2);
-        if(start == NULL)
-        {
-            return 0;
-        }
-        end = LuaState::GetFuncParam<Vector>(state, 3);
-        if(end == NULL)
-        {
-            return 0;
-        }
-        colourParam = 4;
+        return 0;
     }
-    else
+
+    const DrawStats& stats = GraphicsPipeline::LastFrameStats();
+    lua_pushnumber(state, stats.flushes[FLUSH_TEXTURE]);
+    lua_pushnumber(state, stats.flushes[FLUSH_MODE]);
+    lua_pushnumber(state, stats.flushes[FLUSH_CAPACITY]);
+    lua_pushnumber(state, stats.flushes[FLUSH_TEXT]);
+    lua_pushnumber(state, stats.flushes[FLUSH_OTHER]);
+    return 5;
+}
+
+static int lua_SetDeferred(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
     {
-        return luaL_typerror(state, 2, "Vector or number");
+        return 0;
     }
 
-    Vector* color = &DefaultColor;
-    if(lua_isuserdata(state, colourParam) and luaL_checkudata (state, colourParam, "Vector"))
+    if(!lua_isboolean(state, 2))
     {
-        color = LuaState::GetFuncParam<Vector>(state, colourParam);
+        return luaL_typerror(state, 2, "boolean");
     }
 
-    renderer->DrawLine2d(*start, *end, *color);
-
+    renderer->Graphics()->SetDeferred(lua_toboolean(state, 2));
     return 0;
 }
 
+static const char* depthSortNames[] = { "none", "y", "z", NULL };
 
-static int lua_Translate(lua_State* state)
+//
+// renderer:SetDepthSort("none" | "y" | "z")
+// Orders deferred quads in each layer by their centre's y, higher first,
+// or by z, lower first. None keeps submission order.
+//
+static int lua_SetDepthSort(lua_State* state)
 {
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
@@ -612,27 +1731,12 @@ static int lua_Translate(lua_State* state)
         return 0;
     }
 
-    if(lua_isuserdata(state, 2) and luaL_checkudata (state, 2, "Vector"))
-    {
-        Vector* position = LuaState::GetFuncParam<Vector>(state, 2);
-        renderer->Graphics()->SetCameraPosition(*position);
-    }
-    else if(lua_isnumber(state, 2))
-    {
-        const Vector& pos = renderer->Graphics()->CameraPosition();
-        float transX = lua_tonumber(state, 2);
-        float transY = luaL_optnumber(state, 3, pos.y);
-        renderer->Graphics()->SetCameraPosition(transX, transY);
-    }
-    else
-    {
-        return luaL_typerror(state, 2, "Vector or number");
-    }
+    const int mode = luaL_checkoption(state, 2, NULL, depthSortNames);
+    renderer->Graphics()->SetDepthSort((eDepthSort) mode);
     return 0;
 }
 
-
-static int lua_GetTranslate(lua_State* state)
+static int lua_GetDepthSort(lua_State* state)
 {
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
@@ -640,17 +1744,11 @@ static int lua_GetTranslate(lua_State* state)
         return 0;
     }
 
-    const Vector& pos = renderer->Graphics()->CameraPosition();
-    Vector* vector = new (lua_newuserdata(state, sizeof(Vector))) Vector();
-    assert(vector != NULL);
-    luaL_getmetatable(state, "Vector");
-    lua_setmetatable(state, -2);
-    vector->SetXyzw(pos);
+    lua_pushstring(state, depthSortNames[renderer->Graphics()->DepthSort()]);
     return 1;
 }
 
-
-static int lua_SetFont(lua_State* state)
+static int lua_SetCulling(lua_State* state)
 {
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
@@ -658,23 +1756,87 @@ static int lua_SetFont(lua_State* state)
         return 0;
     }
 
-    if(!lua_isstring(state,  2))
-    {
-        return luaL_typerror(state, 2, "string");
-    }
-
-    const char* fontname = lua_tostring(state, 2);
-
-    if(!renderer->Graphics()->SetFont(fontname))
+    if(!lua_isboolean(state, 2))
     {
-        return luaL_error(state, "Font: \"%s\" does not exist.", fontname);
+        return luaL_typerror(state, 2, "boolean");
     }
 
+    renderer->Graphics()->SetCulling(lua_toboolean(state, 2));
     return 0;
 }
 
-
-static int lua_SetBlend(lua_State* state)
+//
+// renderer:SetCameraBaked(true)
+// Applies the camera to verts as they're batched, so scenes that move it
+// between layers don't draw each layer separately.
+//
+static int lua_SetCameraBaked(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    if(!lua_isboolean(state, 2))
+    {
+        return luaL_typerror(state, 2, "boolean");
+    }
+
+    renderer->Graphics()->SetCameraBaked(lua_toboolean(state, 2));
+    return 0;
+}
+
+//
+// renderer:SetCPUClipping(true)
+// Clips sprites, rects and text inside renderer:Clip on the CPU, so
+// clipped panels share batches. Errors inside a clip.
+//
+static int lua_SetCPUClipping(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    if(!lua_isboolean(state, 2))
+    {
+        return luaL_typerror(state, 2, "boolean");
+    }
+
+    if(renderer->Graphics()->IsClipping())
+    {
+        return luaL_error(state, "Clipping can't be changed inside a clip.");
+    }
+
+    renderer->Graphics()->SetClipOnCPU(lua_toboolean(state, 2));
+    return 0;
+}
+
+//
+// renderer:SetOpaquePass(true)
+// In deferred mode, opaque sprites are drawn front to back first and
+// hide what's behind them from the depth test. See Sprite:SetOpaque.
+//
+static int lua_SetOpaquePass(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    if(!lua_isboolean(state, 2))
+    {
+        return luaL_typerror(state, 2, "boolean");
+    }
+
+    renderer->Graphics()->SetOpaquePass(lua_toboolean(state, 2) != 0);
+    return 0;
+}
+
+static int lua_PushShader(lua_State* state)
 {
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
@@ -682,25 +1844,29 @@ static int lua_SetBlend(lua_State* state)
         return 0;
     }
 
-    if(!lua_isnumber(state,  2))
+    ShaderProgram** shader = LuaState::GetFuncParamPtr<ShaderProgram>(state, 2);
+    if(shader == NULL)
     {
-        return luaL_typerror(state, 2, "number");
+        return 0;
     }
 
-    int blendNum = lua_tonumber(state, 2);
+    renderer->Graphics()->PushShader(*shader);
+    return 0;
+}
 
-    if(blendNum < 0 or blendNum >= BLEND_COUNT)
+static int lua_PopShader(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
     {
-        return luaL_error(state, "Invalid blend mode.");
+        return 0;
     }
 
-    eBlendMode blendMode = (eBlendMode) blendNum;
-    renderer->Graphics()->SetBlend(blendMode);
+    renderer->Graphics()->PopShader();
     return 0;
 }
 
-
-static int lua_Scale(lua_State* state)
+static int lua_BeginTarget(lua_State* state)
 {
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
@@ -708,27 +1874,29 @@ static int lua_Scale(lua_State* state)
         return 0;
     }
 
-    if(lua_isuserdata(state, 2) and luaL_checkudata (state, 2, "Vector"))
-    {
-        Vector* position = LuaState::GetFuncParam<Vector>(state, 2);
-        renderer->Graphics()->SetCameraScale(*position);
-    }
-    else if(lua_isnumber(state, 2))
+    RenderTarget* target = LuaState::GetFuncParam<RenderTarget>(state, 2);
+    if(target == NULL)
     {
-        const Vector& scale = renderer->Graphics()->CameraScale();
-         float scaleX = lua_tonumber(state, 2);
-         float scaleY = luaL_optnumber(state, 3, scale.y);
-         renderer->Graphics()->SetCameraScale(scaleX, scaleY);
+        return 0;
     }
-    else
+
+    renderer->Graphics()->BeginTarget(target);
+    return 0;
+}
+
+static int lua_EndTarget(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
     {
-        return luaL_typerror(state, 2, "Vector or number");
+        return 0;
     }
+
+    renderer->Graphics()->EndTarget();
     return 0;
 }
 
-
-static int lua_GetScale(lua_State* state)
+static int lua_GetCulledCount(lua_State* state)
 {
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
@@ -736,29 +1904,30 @@ static int lua_GetScale(lua_State* state)
         return 0;
     }
 
-    const Vector& pos = renderer->Graphics()->CameraScale();
-    Vector* vector = new (lua_newuserdata(state, sizeof(Vector))) Vector();
-    assert(vector != NULL);
-    luaL_getmetatable(state, "Vector");
-    lua_setmetatable(state, -2);
-    vector->SetXyzw(pos);
-
+    lua_pushnumber(state, renderer->Graphics()->CulledLastFrame());
     return 1;
 }
-static int lua_Rotate(lua_State* state)
+
+static int lua_BeginStatic(lua_State* state)
 {
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
     {
         return 0;
     }
-    float rot = luaL_optnumber(state, 2, renderer->Graphics()->CameraRotation());
-    renderer->Graphics()->SetCameraRotation(rot);
+
+    // Passing a handle rebuilds that layer.
+    int handle = 0;
+    if(lua_isnumber(state, 2))
+    {
+        handle = (int) lua_tonumber(state, 2);
+    }
+
+    renderer->Graphics()->BeginStatic(handle);
     return 0;
 }
 
-
-static int lua_GetRotate(lua_State* state)
+static int lua_EndStatic(lua_State* state)
 {
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
@@ -766,12 +1935,11 @@ static int lua_GetRotate(lua_State* state)
         return 0;
     }
 
-    float rot = renderer->Graphics()->CameraRotation();
-    lua_pushnumber(state, rot);
+    lua_pushnumber(state, renderer->Graphics()->EndStatic());
     return 1;
 }
 
-static int lua_GetKern(lua_State* state)
+static int lua_DrawStatic(lua_State* state)
 {
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
@@ -779,22 +1947,19 @@ static int lua_GetKern(lua_State* state)
         return 0;
     }
 
-    const char* currentStr = luaL_optstring(state, 2, "\0");
-    const char* nextStr = luaL_optstring(state, 3, "\0");
-
-    if(std::string(currentStr) == "" or std::string(nextStr) == "")
+    if(!lua_isnumber(state, 2))
     {
-        return 0;
+        return luaL_typerror(state, 2, "number");
     }
 
-    float kern = FormatText::GetKern(renderer->Graphics()->GetFont(),
-    (int) currentStr[0],
-    (int) nextStr[0]);
-    lua_pushnumber(state, kern);
+    // False means the layer needs recording again.
+    int handle = (int) lua_tonumber(state, 2);
+    ProfileZone zone(state, "Renderer.DrawStatic");
+    lua_pushboolean(state, renderer->Graphics()->DrawStatic(handle));
     return 1;
 }
 
-static int lua_Clip(lua_State* state)
+static int lua_FreeStatic(lua_State* state)
 {
     Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
     if(renderer == NULL)
@@ -802,32 +1967,47 @@ static int lua_Clip(lua_State* state)
         return 0;
     }
 
-    // Expecting an x, y, w, h
-    if(!lua_isnumber(state,  2)) { return luaL_typerror(state, 2, "number"); }
-    if(!lua_isnumber(state,  3)) { return luaL_typerror(state, 3, "number"); }
-    if(!lua_isnumber(state,  4)) { return luaL_typerror(state, 4, "number"); }
-    if(!lua_isnumber(state,  5)) { return luaL_typerror(state, 5, "number"); }
+    if(!lua_isnumber(state, 2))
+    {
+        return luaL_typerror(state, 2, "number");
+    }
 
-    int x = (int)lua_tonumber(state, 2);
-    int y = (int)lua_tonumber(state, 3);
-    int w = std::max(0, (int)lua_tonumber(state, 4));
-    int h = std::max(0, (int)lua_tonumber(state, 5));
+    renderer->Graphics()->FreeStatic((int) lua_tonumber(state, 2));
+    return 0;
+}
 
-    if(!lua_isfunction(state, 6))
+static int lua_SetLayer(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
     {
-        return luaL_typerror(state, 6, "function");
+        return 0;
     }
 
-    renderer->Graphics()->PushScissor(x, y, w, h);
+    if(!lua_isnumber(state, 2))
     {
-        // Call the function, not sure what happens if it errors.
-        lua_call (state, 0, 0);
+        return luaL_typerror(state, 2, "number");
     }
-    renderer->Graphics()->PopScissor();
 
+    // Layers are 16 bit in the sort key.
+    int layer = (int)lua_tonumber(state, 2);
+    layer = std::max(0, std::min(layer, 0xFFFF));
+    renderer->Graphics()->SetLayer(layer);
     return 0;
 }
 
+static int lua_GetLayer(lua_State* state)
+{
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return 0;
+    }
+
+    lua_pushnumber(state, renderer->Graphics()->Layer());
+    return 1;
+}
+
 static const struct luaL_reg luaBinding [] =
 {
     {"__gc", lua_gc},
@@ -844,8 +2024,21 @@ static const struct luaL_reg luaBinding [] =
     {"DrawCircle2d", lua_DrawCircle2d},
     {"DrawLine2d", lua_DrawLine2d},
     {"DrawRect2d", lua_DrawRect2d},
+    {"DrawNineSlice", lua_DrawNineSlice},
+    {"DrawVertices", lua_DrawVertices},
+    {"DrawMesh", lua_DrawMesh},
+    {"DrawFilledCircle2d", lua_DrawFilledCircle2d},
+    {"DrawPolygon2d", lua_DrawPolygon2d},
+    {"DrawLines2d", lua_DrawLines2d},
     {"DrawSprite", lua_DrawSprite},
+    {"DrawSprites", lua_DrawSprites},
+    {"DrawTilemap", lua_DrawTilemap},
+    {"DrawScene", lua_DrawScene},
+    {"DrawWorld", lua_DrawWorld},
+    {"DrawParticles", lua_DrawParticles},
     {"DrawText2d", lua_DrawText2d},
+    {"DrawTextRun", lua_DrawTextRun},
+    {"DrawTextf", lua_DrawTextf},
     {"GetTextRotation", lua_GetTextRotation},
     {"MeasureText", lua_MeasureText},
     {"NextLine", lua_NextLine},
@@ -857,6 +2050,32 @@ static const struct luaL_reg luaBinding [] =
     {"SetBlend", lua_SetBlend},
     {"GetKern", lua_GetKern},
     {"Clip", lua_Clip},
+    {"SetBatchSize", lua_SetBatchSize},
+    {"GetBatchSize", lua_GetBatchSize},
+    {"GetCapacityFlushes", lua_GetCapacityFlushes},
+    {"SetDeferred", lua_SetDeferred},
+    {"SetDepthSort", lua_SetDepthSort},
+    {"GetDepthSort", lua_GetDepthSort},
+    {"GetGlyphAtlasStats", lua_GetGlyphAtlasStats},
+    {"GetTextCacheStats", lua_GetTextCacheStats},
+    {"GetGLStateStats", lua_GetGLStateStats},
+    {"GetStats", lua_GetStats},
+    {"GetFlushStats", lua_GetFlushStats},
+    {"SetCulling", lua_SetCulling},
+    {"GetCulledCount", lua_GetCulledCount},
+    {"SetCameraBaked", lua_SetCameraBaked},
+    {"SetCPUClipping", lua_SetCPUClipping},
+    {"SetOpaquePass", lua_SetOpaquePass},
+    {"BeginStatic", lua_BeginStatic},
+    {"EndStatic", lua_EndStatic},
+    {"DrawStatic", lua_DrawStatic},
+    {"FreeStatic", lua_FreeStatic},
+    {"PushShader", lua_PushShader},
+    {"PopShader", lua_PopShader},
+    {"BeginTarget", lua_BeginTarget},
+    {"EndTarget", lua_EndTarget},
+    {"SetLayer", lua_SetLayer},
+    {"GetLayer", lua_GetLayer},
     {NULL, NULL}  /* sentinel */
 };
 
@@ -877,9 +2096,9 @@ void Renderer::Bind(LuaState* state)
 }
 
 
-Renderer::Renderer()
+Renderer::Renderer(unsigned int batchSize)
 {
-    mGraphics = new GraphicsPipeline();
+    mGraphics = new GraphicsPipeline(batchSize);
 }
 
 
@@ -912,6 +2131,23 @@ void Renderer::DrawRect2d(const Vector& bottomLeft, const Vector& topRight,
     );
 }
 
+void Renderer::DrawNineSlice(Texture* texture,
+                             const Vector& rect,
+                             const Vector& borders,
+                             const Vector& colour)
+{
+    const float border[4] =
+    {
+        (float) borders.x, (float) borders.y,
+        (float) borders.z, (float) borders.w
+    };
+    mGraphics->PushNineSlice(texture,
+                             (float) rect.x, (float) rect.y,
+                             (float) rect.z, (float) rect.w,
+                             border, colour);
+    texture->MarkUsed();
+}
+
 
 void Renderer::DrawLine2d(const Vector& start, const Vector& end,
                           const Vector& colour)
@@ -927,6 +2163,27 @@ void Renderer::DrawLine2d(const Vector& start, const Vector& end,
 }
 
 
+void Renderer::DrawFilledCircle2d(double x, double y, double radius, int segments,
+                                  const Vector& rgba)
+{
+    mGraphics->PushFilledCircle(x, y, radius, segments, rgba);
+}
+
+
+void Renderer::DrawPolygon2d(const float* points, unsigned int count,
+                             const Vector& colour)
+{
+    mGraphics->PushPolygon(points, count, colour);
+}
+
+
+void Renderer::DrawLines2d(const float* points, unsigned int count, double width,
+                           const Vector& colour)
+{
+    mGraphics->PushLines(points, count, width, colour);
+}
+
+
 void Renderer::DrawSprite(const Sprite& sprite)
 {
     mGraphics->PushSprite
@@ -934,3 +2191,28 @@ void Renderer::DrawSprite(const Sprite& sprite)
         &sprite
     );
 }
+
+void Renderer::DrawSprites(const SpriteRecord* sprites, unsigned int count)
+{
+    mGraphics->PushSprites(sprites, count);
+}
+
+void Renderer::DrawTilemap(Tilemap& tilemap)
+{
+    mGraphics->PushTilemap(&tilemap);
+}
+
+void Renderer::DrawScene(Scene& scene)
+{
+    scene.Draw(mGraphics);
+}
+
+void Renderer::DrawWorld(World& world)
+{
+    world.Draw(mGraphics);
+}
+
+void Renderer::DrawParticles(const ParticleEmitter& emitter)
+{
+    mGraphics->PushParticles(emitter);
+}
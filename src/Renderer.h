@@ -11,6 +11,12 @@
 
 struct lua_State;
 class Sprite;
+struct SpriteRecord;
+class Texture;
+class Tilemap;
+class Scene;
+class World;
+class ParticleEmitter;
 class GraphicsPipeline;
 
 
@@ -27,14 +33,30 @@ class Renderer
         static std::vector<Renderer*> mRenderers;
 
         void DrawSprite(const Sprite&);
+        void DrawSprites(const SpriteRecord* sprites, unsigned int count);
+        void DrawTilemap(Tilemap&);
+        void DrawScene(Scene&);
+        void DrawWorld(World&);
+        void DrawParticles(const ParticleEmitter&);
         void DrawRect2d(const Vector& bottomLeft,
                         const Vector& topRight,
                         const Vector& colour);
+        void DrawNineSlice(Texture* texture,
+                           const Vector& rect,
+                           const Vector& borders,
+                           const Vector& colour);
         void DrawCircle2d(double x, double y, double radius, int segments,
                           const Vector& rgba);
         void DrawLine2d(const Vector& start, const Vector& end,
                         const Vector& colour);
-        Renderer();
+        void DrawFilledCircle2d(double x, double y, double radius, int segments,
+                                const Vector& rgba);
+        // count x, y pairs
+        void DrawPolygon2d(const float* points, unsigned int count,
+                           const Vector& colour);
+        void DrawLines2d(const float* points, unsigned int count, double width,
+                         const Vector& colour);
+        Renderer(unsigned int batchSize);
         ~Renderer();
         GraphicsPipeline* Graphics() { return mGraphics; }
     private:
@@ -1,12 +1,63 @@
 #include "SaveGame.h"
 
+#include "ByteBuffer.h"
 #include "DinodeckLua.h"
+#include "HttpBody.h"
 #include "LuaState.h"
 #include "DDLog.h"
 #include "DDFile.h"
+#include "Game.h"
+#include "SaveWriter.h"
+#include "TableCodec.h"
 
 Reflect SaveGame::Meta("SaveGame", SaveGame::Bind);
 
+static SaveWriter* GetWriter(lua_State* state)
+{
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    return game->GetSaveWriter();
+}
+
+static void ReadSave(lua_State* state, const SaveGame* saveGame, std::string* out)
+{
+    // A save still being written is read back as it will be.
+    if(!GetWriter(state)->Pending(saveGame->Name(), out))
+    {
+        DDFile::ReadSaveData(saveGame->Name().c_str(), *out);
+    }
+}
+
+static void WriteSave(lua_State* state,
+                      const SaveGame* saveGame,
+                      const std::string& data,
+                      bool async,
+                      int callbackRef)
+{
+    SaveWriter* writer = GetWriter(state);
+
+    // Queued behind any pending write so it isn't overwritten by it.
+    if(async || writer->IsWriting(saveGame->Name()))
+    {
+        writer->Write(saveGame->Name(), data, callbackRef);
+    }
+    else
+    {
+        DDFile::WriteSaveData(saveGame->Name().c_str(), data.data(), data.size());
+    }
+}
+
+// Refs the optional callback at index, LUA_NOREF if there isn't one.
+static int RefCallback(lua_State* state, int index)
+{
+    if(lua_isnoneornil(state, index))
+    {
+        return LUA_NOREF;
+    }
+    luaL_checktype(state, index, LUA_TFUNCTION);
+    lua_pushvalue(state, index);
+    return luaL_ref(state, LUA_REGISTRYINDEX);
+}
+
 static int lua_SaveGame_Read(lua_State* state)
 {
     SaveGame* saveGame = LuaState::GetFuncParam<SaveGame>(state, 1);
@@ -16,8 +67,8 @@ static int lua_SaveGame_Read(lua_State* state)
         return 0;
     }
     std::string out("");
-    DDFile::ReadSaveData(saveGame->Name().c_str(), out);
-    lua_pushstring(state, out.c_str());
+    ReadSave(state, saveGame, &out);
+    lua_pushlstring(state, out.data(), out.size());
     return 1;
 }
 
@@ -30,18 +81,151 @@ static int lua_SaveGame_Write(lua_State* state)
         return 0;
     }
 
-    const char* data = luaL_checklstring(state, 2, NULL);
+    size_t length = 0;
+    const char* data = luaL_checklstring(state, 2, &length);
 
     if(NULL == data)
     {
         return 0;
     }
 
-    DDFile::WriteSaveData(saveGame->Name().c_str(), data);
+    WriteSave(state, saveGame, std::string(data, length), false, LUA_NOREF);
+    return 0;
+}
+
+static int lua_SaveGame_WriteAsync(lua_State* state)
+{
+    SaveGame* saveGame = LuaState::GetFuncParam<SaveGame>(state, 1);
+
+    if(NULL == saveGame)
+    {
+        return 0;
+    }
+
+    size_t length = 0;
+    const char* data = luaL_checklstring(state, 2, &length);
+
+    if(NULL == data)
+    {
+        return 0;
+    }
 
+    const int callbackRef = RefCallback(state, 3);
+    WriteSave(state, saveGame, std::string(data, length), true, callbackRef);
     return 0;
 }
 
+static int lua_SaveGame_WriteTable(lua_State* state)
+{
+    SaveGame* saveGame = LuaState::GetFuncParam<SaveGame>(state, 1);
+
+    if(NULL == saveGame)
+    {
+        return 0;
+    }
+
+    luaL_checktype(state, 2, LUA_TTABLE);
+
+    std::string data;
+    std::string error;
+    if(!TableCodec::Encode(state, 2, true, &data, &error))
+    {
+        return luaL_error(state, "%s: %s", saveGame->ToString().c_str(), error.c_str());
+    }
+
+    // With a callback the write goes on the save thread, as WriteAsync.
+    const int callbackRef = RefCallback(state, 3);
+    WriteSave(state, saveGame, data, callbackRef != LUA_NOREF, callbackRef);
+    return 0;
+}
+
+static int lua_SaveGame_ReadTable(lua_State* state)
+{
+    SaveGame* saveGame = LuaState::GetFuncParam<SaveGame>(state, 1);
+
+    if(NULL == saveGame)
+    {
+        return 0;
+    }
+
+    std::string data;
+    ReadSave(state, saveGame, &data);
+
+    if(data.empty())
+    {
+        lua_pushnil(state);
+        return 1;
+    }
+
+    std::string error;
+    if(!TableCodec::Decode(state, data, &error))
+    {
+        lua_pushnil(state);
+        lua_pushstring(state, error.c_str());
+        return 2;
+    }
+    return 1;
+}
+
+static int lua_SaveGame_ReadBuffer(lua_State* state)
+{
+    SaveGame* saveGame = LuaState::GetFuncParam<SaveGame>(state, 1);
+
+    if(NULL == saveGame)
+    {
+        return 0;
+    }
+
+    std::string data;
+    ReadSave(state, saveGame, &data);
+
+    SharedBuffer* buffer = SharedBuffer::Create();
+    buffer->Data().assign(data.begin(), data.end());
+    ByteBuffer::Push(state, buffer);
+    return 1;
+}
+
+static int lua_SaveGame_WriteBuffer(lua_State* state)
+{
+    SaveGame* saveGame = LuaState::GetFuncParam<SaveGame>(state, 1);
+    ByteBuffer* buffer = LuaState::GetFuncParam<ByteBuffer>(state, 2);
+
+    if(NULL == saveGame || NULL == buffer)
+    {
+        return 0;
+    }
+
+    const int callbackRef = RefCallback(state, 3);
+    SaveWriter* writer = GetWriter(state);
+    if(callbackRef != LUA_NOREF || writer->IsWriting(saveGame->Name()))
+    {
+        // The writer holds the bytes, later writes to the buffer copy them.
+        SharedBuffer* shared = buffer->Share();
+        writer->Write(saveGame->Name(), shared, callbackRef);
+        shared->Release();
+    }
+    else
+    {
+        DDFile::WriteSaveData(saveGame->Name().c_str(),
+                              (const char*) buffer->Data(),
+                              buffer->Size());
+    }
+    return 0;
+}
+
+static int lua_SaveGame_IsSaving(lua_State* state)
+{
+    SaveGame* saveGame = LuaState::GetFuncParam<SaveGame>(state, 1);
+
+    if(NULL == saveGame)
+    {
+        return 0;
+    }
+
+    lua_pushboolean(state, GetWriter(state)->IsWriting(saveGame->Name()));
+    return 1;
+}
+
 static int lua_LoadData_Create(lua_State* state)
 {
     const char* name = luaL_checklstring(state, 1, NULL);
@@ -94,6 +278,22 @@ static const struct luaL_reg luaBinding [] =
     {"Read", lua_SaveGame_Read},
     // Writes out all data
     {"Write", lua_SaveGame_Write},
+    // Writes out all data on a background thread, then calls
+    // callback(ok) if one's given.
+    {"WriteAsync", lua_SaveGame_WriteAsync},
+    // True while a WriteAsync to this save hasn't landed.
+    {"IsSaving", lua_SaveGame_IsSaving},
+    // Writes a table of booleans, numbers, strings and tables in a compact
+    // binary form. Given a callback it's written as WriteAsync.
+    {"WriteTable", lua_SaveGame_WriteTable},
+    // Reads back a WriteTable save. Nil if there's no save, or nil and an
+    // error if it isn't one.
+    {"ReadTable", lua_SaveGame_ReadTable},
+    // Reads in all data as a ByteBuffer, empty if there's no save.
+    {"ReadBuffer", lua_SaveGame_ReadBuffer},
+    // Writes out a ByteBuffer without copying it into a string. Given a
+    // callback it's written as WriteAsync.
+    {"WriteBuffer", lua_SaveGame_WriteBuffer},
     // Create with a filename. Filename uses file if it exists or makes it.
     {"Create", lua_LoadData_Create},
     {NULL, NULL}  /* sentinel */
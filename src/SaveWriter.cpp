@@ -0,0 +1,199 @@
+#include "SaveWriter.h"
+
+#include <assert.h>
+
+#include "DinodeckLua.h"
+#include "DDFile.h"
+#include "DDLog.h"
+#include "DDTime.h"
+#include "HttpBody.h"
+#include "LuaState.h"
+
+SaveWriter::SaveWriter() :
+    mTrace(Trace::AddThread("save")),
+    mGeneration(0),
+    mStopping(false)
+{
+    if(!mThread.Start(&SaveWriter::WriterMain, this))
+    {
+        // Write falls back to writing there and then.
+        dsprintf("Save writer thread failed to start.\n");
+        mStopping = true;
+    }
+}
+
+SaveWriter::~SaveWriter()
+{
+    {
+        ScopedLock lock(mMutex);
+        mStopping = true;
+        mWake.Signal();
+    }
+    mThread.Join();
+}
+
+bool SaveWriter::WriteEntry(const Entry& entry)
+{
+    if(entry.buffer)
+    {
+        const std::vector<unsigned char>& bytes = entry.buffer->Data();
+        return DDFile::WriteSaveData(entry.name.c_str(),
+                                     bytes.empty() ? "" : (const char*) &bytes[0],
+                                     bytes.size());
+    }
+    return DDFile::WriteSaveData(entry.name.c_str(), entry.data.data(), entry.data.size());
+}
+
+void SaveWriter::ClearEntry(Entry* entry)
+{
+    entry->data.clear();
+    if(entry->buffer)
+    {
+        entry->buffer->Release();
+        entry->buffer = NULL;
+    }
+}
+
+void SaveWriter::WriterMain(void* writer)
+{
+    static_cast<SaveWriter*>(writer)->Run();
+}
+
+void SaveWriter::Run()
+{
+    mMutex.Lock();
+    for(;;)
+    {
+        while(mQueue.empty() && !mStopping)
+        {
+            mWake.Wait(mMutex);
+        }
+
+        // Whatever's queued when stopping is still written.
+        if(mQueue.empty())
+        {
+            break;
+        }
+
+        // Pushes only go on the back, so the front stays put unlocked.
+        Entry& entry = mQueue.front();
+        mMutex.Unlock();
+        const unsigned long long start = DDTime::Microseconds();
+        const bool ok = WriteEntry(entry);
+        Trace::Record(mTrace, "save", start, DDTime::Microseconds());
+        mMutex.Lock();
+
+        entry.ok = ok;
+        ClearEntry(&entry);
+        mDone.push_back(entry);
+        mQueue.pop_front();
+    }
+    mMutex.Unlock();
+}
+
+void SaveWriter::Write(const std::string& name, const std::string& data, int callbackRef)
+{
+    Entry entry;
+    entry.name = name;
+    entry.data = data;
+    entry.buffer = NULL;
+    entry.callbackRef = callbackRef;
+    entry.ok = false;
+    Queue(entry);
+}
+
+void SaveWriter::Write(const std::string& name, SharedBuffer* buffer, int callbackRef)
+{
+    assert(buffer);
+    buffer->AddRef();
+
+    Entry entry;
+    entry.name = name;
+    entry.buffer = buffer;
+    entry.callbackRef = callbackRef;
+    entry.ok = false;
+    Queue(entry);
+}
+
+void SaveWriter::Queue(Entry& entry)
+{
+    ScopedLock lock(mMutex);
+    entry.generation = mGeneration;
+
+    if(mStopping)
+    {
+        entry.ok = WriteEntry(entry);
+        ClearEntry(&entry);
+        mDone.push_back(entry);
+        return;
+    }
+
+    mQueue.push_back(entry);
+    mWake.Signal();
+}
+
+bool SaveWriter::IsWriting()
+{
+    ScopedLock lock(mMutex);
+    return !mQueue.empty();
+}
+
+bool SaveWriter::IsWriting(const std::string& name)
+{
+    return Pending(name, NULL);
+}
+
+bool SaveWriter::Pending(const std::string& name, std::string* data)
+{
+    ScopedLock lock(mMutex);
+    for(std::deque<Entry>::reverse_iterator it = mQueue.rbegin(); it != mQueue.rend(); ++it)
+    {
+        if(it->name == name)
+        {
+            if(data && it->buffer)
+            {
+                const std::vector<unsigned char>& bytes = it->buffer->Data();
+                data->assign(bytes.begin(), bytes.end());
+            }
+            else if(data)
+            {
+                // The front's data is only cleared once it's off the queue.
+                *data = it->data;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void SaveWriter::Update(LuaState* state)
+{
+    std::deque<Entry> done;
+    {
+        ScopedLock lock(mMutex);
+        done.swap(mDone);
+    }
+
+    for(std::deque<Entry>::iterator it = done.begin(); it != done.end(); ++it)
+    {
+        if(!it->ok)
+        {
+            dsprintf("Save [%s] wasn't written.\n", it->name.c_str());
+        }
+
+        if(it->callbackRef == LUA_NOREF || it->generation != mGeneration)
+        {
+            continue; // no callback, or it went with an old Lua state
+        }
+
+        lua_pushboolean(state->State(), it->ok);
+        state->CallRegisteredFunctionWithTop(it->callbackRef);
+        luaL_unref(state->State(), LUA_REGISTRYINDEX, it->callbackRef);
+    }
+}
+
+void SaveWriter::Reset()
+{
+    ScopedLock lock(mMutex);
+    mGeneration++;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef SAVEWRITER_H
+#define SAVEWRITER_H
+
+#include <deque>
+#include <string>
+
+#include "Threading.h"
+#include "Trace.h"
+
+class LuaState;
+class SharedBuffer;
+
+//
+// Writes save data on its own thread so a big save doesn't stall a frame.
+//
+// Writes go out in the order they're made, each through DDFile so the old
+// save is only replaced once the new one is wholly on disk. Until a write
+// lands reads of that save see the queued data.
+//
+// A callback ref is called with true or false from Update once its write
+// is done.
+//
+class SaveWriter
+{
+    struct Entry
+    {
+        std::string name;
+        std::string data;
+        SharedBuffer* buffer; // written instead of data if there is one
+        int callbackRef;
+        unsigned int generation;
+        bool ok;
+    };
+
+    Mutex mMutex;
+    Condition mWake;
+    std::deque<Entry> mQueue; // front is being written
+    std::deque<Entry> mDone;
+    Thread mThread;
+    Trace::Ring* mTrace;
+    unsigned int mGeneration; // bumped on reset, older callbacks are dropped
+    bool mStopping;
+
+    static void WriterMain(void* writer);
+    void Run();
+    void Queue(Entry& entry);
+    static bool WriteEntry(const Entry& entry);
+    static void ClearEntry(Entry* entry);
+public:
+    SaveWriter();
+    // Waits for the queued writes to finish.
+    ~SaveWriter();
+
+    // callbackRef may be LUA_NOREF.
+    void Write(const std::string& name, const std::string& data, int callbackRef);
+    // Takes a reference to the buffer until it's written.
+    void Write(const std::string& name, SharedBuffer* buffer, int callbackRef);
+    bool IsWriting();
+    bool IsWriting(const std::string& name);
+    // The newest queued data for the save, if there's a write pending.
+    bool Pending(const std::string& name, std::string* data);
+    // Main thread, once a frame.
+    void Update(LuaState* state);
+    // The Lua state is going, writes still land but their callbacks don't.
+    void Reset();
+private:
+    SaveWriter(const SaveWriter&);
+    SaveWriter& operator=(const SaveWriter&);
+};
+
+#endif
\ No newline at end of file
@@ -1 +1,590 @@
-#include "Scene.h"
\ No newline at end of file
+#include "Scene.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include "DinodeckLua.h"
+#include "GraphicsPipeline.h"
+#include "LuaState.h"
+#include "Texture.h"
+#include "Vector.h"
+
+Reflect Scene::Meta("Scene", Scene::Bind);
+
+Scene::Node::Node() :
+    parent(Scene::NONE),
+    firstChild(Scene::NONE),
+    nextSibling(Scene::NONE),
+    layer(0),
+    alive(false),
+    visible(true),
+    worldVisible(true),
+    dirty(true)
+{
+}
+
+Scene::Scene() :
+    mCount(0),
+    mDirty(false),
+    mOrderDirty(false)
+{
+}
+
+bool Scene::IsNode(unsigned int node) const
+{
+    return node < mNodes.size() && mNodes[node].alive;
+}
+
+unsigned int Scene::Add(unsigned int parent)
+{
+    unsigned int node = mNodes.size();
+    if(mFree.empty())
+    {
+        mNodes.push_back(Node());
+    }
+    else
+    {
+        node = mFree.back();
+        mFree.pop_back();
+        mNodes[node] = Node();
+    }
+
+    mNodes[node].alive = true;
+    Link(node, IsNode(parent) ? parent : NONE);
+    mCount++;
+    mDirty = true;
+    mOrderDirty = true;
+    return node;
+}
+
+void Scene::Remove(unsigned int node)
+{
+    assert(IsNode(node));
+    Unlink(node);
+
+    mStack.clear();
+    mStack.push_back(node);
+    while(!mStack.empty())
+    {
+        const unsigned int current = mStack.back();
+        mStack.pop_back();
+        for(unsigned int child = mNodes[current].firstChild;
+            child != NONE;
+            child = mNodes[child].nextSibling)
+        {
+            mStack.push_back(child);
+        }
+
+        mNodes[current] = Node();
+        mFree.push_back(current);
+        mCount--;
+    }
+    mOrderDirty = true;
+}
+
+bool Scene::SetParent(unsigned int node, unsigned int parent)
+{
+    assert(IsNode(node));
+    if(!IsNode(parent))
+    {
+        parent = NONE;
+    }
+
+    for(unsigned int up = parent; up != NONE; up = mNodes[up].parent)
+    {
+        if(up == node)
+        {
+            return false;
+        }
+    }
+
+    Unlink(node);
+    Link(node, parent);
+    MarkDirty(node);
+    return true;
+}
+
+void Scene::Link(unsigned int node, unsigned int parent)
+{
+    mNodes[node].parent = parent;
+    if(parent != NONE)
+    {
+        mNodes[node].nextSibling = mNodes[parent].firstChild;
+        mNodes[parent].firstChild = node;
+    }
+}
+
+void Scene::Unlink(unsigned int node)
+{
+    const unsigned int parent = mNodes[node].parent;
+    if(parent != NONE)
+    {
+        unsigned int* link = &mNodes[parent].firstChild;
+        while(*link != node)
+        {
+            assert(*link != NONE);
+            link = &mNodes[*link].nextSibling;
+        }
+        *link = mNodes[node].nextSibling;
+    }
+    mNodes[node].parent = NONE;
+    mNodes[node].nextSibling = NONE;
+}
+
+void Scene::MarkDirty(unsigned int node)
+{
+    mNodes[node].dirty = true;
+    mDirty = true;
+}
+
+void Scene::SetTexture(unsigned int node, TextureHandle texture)
+{
+    Sprite& sprite = mNodes[node].sprite;
+    if(sprite.texture.IsNull() != texture.IsNull())
+    {
+        mOrderDirty = true;
+    }
+    sprite.SetTexture(texture);
+}
+
+void Scene::SetLayer(unsigned int node, int layer)
+{
+    if(mNodes[node].layer != layer)
+    {
+        mNodes[node].layer = layer;
+        mOrderDirty = true;
+    }
+}
+
+void Scene::SetVisible(unsigned int node, bool visible)
+{
+    if(mNodes[node].visible != visible)
+    {
+        mNodes[node].visible = visible;
+        MarkDirty(node);
+    }
+}
+
+const Transform2D& Scene::GetWorld(unsigned int node)
+{
+    UpdateWorld();
+    return mNodes[node].world;
+}
+
+//
+// Walks down from the roots. A node that changed is worked out from its
+// parent and marks its children, so the change carries down the subtree
+// and nothing else is recomputed.
+//
+void Scene::UpdateWorld()
+{
+    if(!mDirty)
+    {
+        return;
+    }
+
+    mStack.clear();
+    for(unsigned int i = 0; i < mNodes.size(); i++)
+    {
+        if(mNodes[i].alive && mNodes[i].parent == NONE)
+        {
+            mStack.push_back(i);
+        }
+    }
+
+    while(!mStack.empty())
+    {
+        Node& node = mNodes[mStack.back()];
+        mStack.pop_back();
+
+        if(node.dirty)
+        {
+            const Sprite& sprite = node.sprite;
+            Transform2D local;
+            local.Set((float) sprite.position.x,
+                      (float) sprite.position.y,
+                      (float) sprite.rotation,
+                      (float) sprite.scale.x,
+                      (float) sprite.scale.y);
+
+            if(node.parent == NONE)
+            {
+                node.world = local;
+                node.worldVisible = node.visible;
+            }
+            else
+            {
+                const Node& parent = mNodes[node.parent];
+                Transform2D::Multiply(node.world, parent.world, local);
+                node.worldVisible = node.visible && parent.worldVisible;
+            }
+            node.dirty = false;
+
+            for(unsigned int child = node.firstChild;
+                child != NONE;
+                child = mNodes[child].nextSibling)
+            {
+                mNodes[child].dirty = true;
+            }
+        }
+
+        for(unsigned int child = node.firstChild;
+            child != NONE;
+            child = mNodes[child].nextSibling)
+        {
+            mStack.push_back(child);
+        }
+    }
+    mDirty = false;
+}
+
+namespace
+{
+    struct ByLayer
+    {
+        const std::vector<int>* layers;
+        bool operator()(unsigned int left, unsigned int right) const
+        {
+            return (*layers)[left] < (*layers)[right];
+        }
+    };
+}
+
+void Scene::SortDrawOrder()
+{
+    std::vector<int> layers(mNodes.size(), 0);
+    mDrawOrder.clear();
+    for(unsigned int i = 0; i < mNodes.size(); i++)
+    {
+        if(mNodes[i].alive && !mNodes[i].sprite.texture.IsNull())
+        {
+            layers[i] = mNodes[i].layer;
+            mDrawOrder.push_back(i);
+        }
+    }
+
+    // Stable so nodes in a layer keep their index order.
+    ByLayer byLayer;
+    byLayer.layers = &layers;
+    std::stable_sort(mDrawOrder.begin(), mDrawOrder.end(), byLayer);
+    mOrderDirty = false;
+}
+
+void Scene::Draw(GraphicsPipeline* graphics)
+{
+    UpdateWorld();
+    if(mOrderDirty)
+    {
+        SortDrawOrder();
+    }
+
+    for(std::vector<unsigned int>::const_iterator it = mDrawOrder.begin();
+        it != mDrawOrder.end();
+        ++it)
+    {
+        const Node& node = mNodes[*it];
+        if(node.worldVisible)
+        {
+            graphics->PushSprite(&node.sprite, node.world);
+        }
+    }
+}
+
+//
+// Gets the scene and the node at the 1 based index in argument 2.
+// Returns NONE, after raising the error, if either is missing.
+//
+static unsigned int GetNode(lua_State* state, Scene** scene)
+{
+    *scene = LuaState::GetFuncParam<Scene>(state, 1);
+    if(*scene == NULL)
+    {
+        return Scene::NONE;
+    }
+
+    int index = luaL_checkinteger(state, 2);
+    if(!(*scene)->IsNode(index - 1))
+    {
+        luaL_argerror(state, 2, "not a node in this scene");
+        return Scene::NONE;
+    }
+    return index - 1;
+}
+
+// 0 or nil means no parent.
+static unsigned int GetParent(lua_State* state, Scene* scene, int index)
+{
+    int parent = luaL_optinteger(state, index, 0);
+    if(parent == 0)
+    {
+        return Scene::NONE;
+    }
+
+    if(!scene->IsNode(parent - 1))
+    {
+        luaL_argerror(state, index, "not a node in this scene");
+        return Scene::NONE;
+    }
+    return parent - 1;
+}
+
+static int lua_Scene_Create(lua_State* state)
+{
+    new (lua_newuserdata(state, sizeof(Scene))) Scene();
+    luaL_getmetatable(state, "Scene");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_Scene_gc(lua_State* state)
+{
+    Scene* scene = (Scene*)lua_touserdata(state, 1);
+    assert(scene);
+    scene->~Scene();
+    return 0;
+}
+
+static int lua_Scene_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "Scene");
+    return 1;
+}
+
+static int lua_Scene_GetCount(lua_State* state)
+{
+    Scene* scene = LuaState::GetFuncParam<Scene>(state, 1);
+    if(scene == NULL)
+    {
+        return 0;
+    }
+    lua_pushinteger(state, scene->Count());
+    return 1;
+}
+
+// scene:Add([parent]) returns the new node
+static int lua_Scene_Add(lua_State* state)
+{
+    Scene* scene = LuaState::GetFuncParam<Scene>(state, 1);
+    if(scene == NULL)
+    {
+        return 0;
+    }
+    unsigned int parent = GetParent(state, scene, 2);
+    lua_pushinteger(state, scene->Add(parent) + 1);
+    return 1;
+}
+
+static int lua_Scene_Remove(lua_State* state)
+{
+    Scene* scene = NULL;
+    unsigned int node = GetNode(state, &scene);
+    if(node == Scene::NONE)
+    {
+        return 0;
+    }
+    scene->Remove(node);
+    return 0;
+}
+
+// scene:SetParent(node, [parent])
+static int lua_Scene_SetParent(lua_State* state)
+{
+    Scene* scene = NULL;
+    unsigned int node = GetNode(state, &scene);
+    if(node == Scene::NONE)
+    {
+        return 0;
+    }
+
+    unsigned int parent = GetParent(state, scene, 3);
+    if(!scene->SetParent(node, parent))
+    {
+        return luaL_argerror(state, 3, "parent is under the node");
+    }
+    return 0;
+}
+
+static int lua_Scene_SetPosition(lua_State* state)
+{
+    Scene* scene = NULL;
+    unsigned int node = GetNode(state, &scene);
+    if(node == Scene::NONE)
+    {
+        return 0;
+    }
+
+    Sprite& sprite = scene->GetSprite(node);
+    if(lua_isnumber(state, 3))
+    {
+        double x = luaL_optnumber(state, 3, sprite.GetPosition().x);
+        double y = luaL_optnumber(state, 4, sprite.GetPosition().y);
+        sprite.SetPosition(x, y);
+    }
+    else if(LuaState::IsType<Vector>(state, 3))
+    {
+        sprite.SetPosition(*(Vector*)lua_touserdata(state, 3));
+    }
+    else
+    {
+        return luaL_typerror(state, 3, "Vector or number");
+    }
+    scene->MarkDirty(node);
+    return 0;
+}
+
+static int lua_Scene_SetRotation(lua_State* state)
+{
+    Scene* scene = NULL;
+    unsigned int node = GetNode(state, &scene);
+    if(node == Scene::NONE)
+    {
+        return 0;
+    }
+    scene->GetSprite(node).SetRotation(luaL_checknumber(state, 3));
+    scene->MarkDirty(node);
+    return 0;
+}
+
+static int lua_Scene_SetScale(lua_State* state)
+{
+    Scene* scene = NULL;
+    unsigned int node = GetNode(state, &scene);
+    if(node == Scene::NONE)
+    {
+        return 0;
+    }
+
+    Sprite& sprite = scene->GetSprite(node);
+    sprite.scale.x = luaL_checknumber(state, 3);
+    sprite.scale.y = luaL_optnumber(state, 4, sprite.scale.x);
+    scene->MarkDirty(node);
+    return 0;
+}
+
+static int lua_Scene_SetTexture(lua_State* state)
+{
+    Scene* scene = NULL;
+    unsigned int node = GetNode(state, &scene);
+    if(node == Scene::NONE)
+    {
+        return 0;
+    }
+
+    TextureHandle texture;
+    if(!lua_isnoneornil(state, 3))
+    {
+        TextureHandle* param = Texture::GetFuncParamHandle(state, 3);
+        if(param == NULL)
+        {
+            return 0;
+        }
+        texture = *param;
+    }
+    scene->SetTexture(node, texture);
+    return 0;
+}
+
+static int lua_Scene_SetUVs(lua_State* state)
+{
+    Scene* scene = NULL;
+    unsigned int node = GetNode(state, &scene);
+    if(node == Scene::NONE)
+    {
+        return 0;
+    }
+
+    scene->GetSprite(node).SetUVs
+    (
+        luaL_checknumber(state, 3),
+        luaL_checknumber(state, 4),
+        luaL_checknumber(state, 5),
+        luaL_checknumber(state, 6)
+    );
+    return 0;
+}
+
+static int lua_Scene_SetColor(lua_State* state)
+{
+    Scene* scene = NULL;
+    unsigned int node = GetNode(state, &scene);
+    if(node == Scene::NONE)
+    {
+        return 0;
+    }
+
+    Vector* colour = LuaState::GetFuncParam<Vector>(state, 3);
+    if(colour == NULL)
+    {
+        return 0;
+    }
+    scene->GetSprite(node).colour.SetXyzw(*colour);
+    return 0;
+}
+
+static int lua_Scene_SetLayer(lua_State* state)
+{
+    Scene* scene = NULL;
+    unsigned int node = GetNode(state, &scene);
+    if(node == Scene::NONE)
+    {
+        return 0;
+    }
+    scene->SetLayer(node, luaL_checkinteger(state, 3));
+    return 0;
+}
+
+static int lua_Scene_SetVisible(lua_State* state)
+{
+    Scene* scene = NULL;
+    unsigned int node = GetNode(state, &scene);
+    if(node == Scene::NONE)
+    {
+        return 0;
+    }
+    scene->SetVisible(node, lua_toboolean(state, 3) != 0);
+    return 0;
+}
+
+// scene:GetWorldPosition(node) returns x, y
+static int lua_Scene_GetWorldPosition(lua_State* state)
+{
+    Scene* scene = NULL;
+    unsigned int node = GetNode(state, &scene);
+    if(node == Scene::NONE)
+    {
+        return 0;
+    }
+    const Transform2D& world = scene->GetWorld(node);
+    lua_pushnumber(state, world.tx);
+    lua_pushnumber(state, world.ty);
+    return 2;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_Scene_Create},
+  {"__gc", lua_Scene_gc},
+  {"__tostring", lua_Scene_tostring},
+  {"GetCount", lua_Scene_GetCount},
+  {"Add", lua_Scene_Add},
+  {"Remove", lua_Scene_Remove},
+  {"SetParent", lua_Scene_SetParent},
+  {"SetPosition", lua_Scene_SetPosition},
+  {"SetRotation", lua_Scene_SetRotation},
+  {"SetScale", lua_Scene_SetScale},
+  {"SetTexture", lua_Scene_SetTexture},
+  {"SetUVs", lua_Scene_SetUVs},
+  {"SetColor", lua_Scene_SetColor},
+  {"SetLayer", lua_Scene_SetLayer},
+  {"SetVisible", lua_Scene_SetVisible},
+  {"GetWorldPosition", lua_Scene_GetWorldPosition},
+  {NULL, NULL}  /* sentinel */
+};
+
+void Scene::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        Scene::Meta.Name(),
+        luaBinding
+    );
+}
\ No newline at end of file
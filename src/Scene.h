@@ -1,9 +1,86 @@
 #ifndef SCENE_H
 #define SCENE_H
 
+#include <vector>
+
+#include "reflect/Reflect.h"
+#include "Sprite.h"
+#include "Transform2D.h"
+
+class GraphicsPipeline;
+class LuaState;
+
+//
+// A hierarchy of sprites, each placed relative to its parent.
+//
+// A node's sprite holds its local position, rotation and scale. World
+// transforms are kept and only worked out again for nodes that, or whose
+// parents, changed, so a still scene costs one flag check to update.
+// Nodes without a texture are just for grouping.
+//
+// Nodes are drawn in layer order, then in the order they were added.
+// Hiding a node hides everything under it.
+//
 class Scene
 {
-public:
+    public: static Reflect Meta;
+    public:
+        static const unsigned int NONE = 0xFFFFFFFF;
+
+        static void Bind(LuaState* state);
+
+        Scene();
+
+        // Returns the new node's index, parent may be NONE.
+        unsigned int Add(unsigned int parent);
+        // Removes the node and everything under it, their indices are
+        // handed out again.
+        void Remove(unsigned int node);
+        // False if the parent is the node or under it.
+        bool SetParent(unsigned int node, unsigned int parent);
+        bool IsNode(unsigned int node) const;
+        unsigned int Capacity() const { return mNodes.size(); }
+        unsigned int Count() const { return mCount; }
+
+        // Changing the sprite's position, rotation or scale needs a
+        // MarkDirty, so call it after writing through GetSprite,
+        // the setters below do.
+        Sprite& GetSprite(unsigned int node) { return mNodes[node].sprite; }
+        void MarkDirty(unsigned int node);
+        void SetTexture(unsigned int node, TextureHandle texture);
+        void SetLayer(unsigned int node, int layer);
+        void SetVisible(unsigned int node, bool visible);
+
+        const Transform2D& GetWorld(unsigned int node);
+        void Draw(GraphicsPipeline* graphics);
+    private:
+        struct Node
+        {
+            Sprite sprite;
+            Transform2D world;
+            unsigned int parent;
+            unsigned int firstChild;
+            unsigned int nextSibling;
+            int layer;
+            bool alive;
+            bool visible;
+            bool worldVisible;
+            bool dirty;
+            Node();
+        };
+
+        std::vector<Node> mNodes;
+        std::vector<unsigned int> mFree;
+        std::vector<unsigned int> mDrawOrder; // drawable nodes by layer
+        std::vector<unsigned int> mStack;
+        unsigned int mCount;
+        bool mDirty; // some node's world is out of date
+        bool mOrderDirty;
+
+        void Link(unsigned int node, unsigned int parent);
+        void Unlink(unsigned int node);
+        void UpdateWorld();
+        void SortDrawOrder();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,382 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include "Asset.h"
+#include "DinodeckLua.h"
+#include "DDLog.h"
+#include "DDTime.h"
+#include "Game.h"
+#include "LuaState.h"
+#include "ManifestAssetStore.h"
+#include "TextureManager.h"
+
+Reflect Scheduler::Meta("Scheduler", Scheduler::Bind);
+
+static Scheduler* GetScheduler(lua_State* state)
+{
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    assert(game);
+    return game->GetScheduler();
+}
+
+// Scheduler.Start(function, [priority]) returns the task id
+static int lua_Scheduler_Start(lua_State* state)
+{
+    if(!lua_isfunction(state, 1))
+    {
+        return luaL_typerror(state, 1, "function");
+    }
+    int priority = luaL_optinteger(state, 2, 0);
+    lua_pushinteger(state, GetScheduler(state)->Start(state, 1, priority));
+    return 1;
+}
+
+static int lua_Scheduler_Stop(lua_State* state)
+{
+    unsigned int id = (unsigned int) luaL_checkinteger(state, 1);
+    lua_pushboolean(state, GetScheduler(state)->Stop(state, id));
+    return 1;
+}
+
+static int lua_Scheduler_IsRunning(lua_State* state)
+{
+    unsigned int id = (unsigned int) luaL_checkinteger(state, 1);
+    lua_pushboolean(state, GetScheduler(state)->IsRunning(id));
+    return 1;
+}
+
+static int lua_Scheduler_GetCount(lua_State* state)
+{
+    lua_pushinteger(state, GetScheduler(state)->Count());
+    return 1;
+}
+
+static int lua_Scheduler_SetBudget(lua_State* state)
+{
+    double ms = luaL_checknumber(state, 1);
+    GetScheduler(state)->SetBudget((unsigned int) (std::max(ms, 0.0) * 1000));
+    return 0;
+}
+
+static int lua_Scheduler_GetBudget(lua_State* state)
+{
+    lua_pushnumber(state, GetScheduler(state)->Budget() / 1000.0);
+    return 1;
+}
+
+// Scheduler.Yield() gives up the rest of this turn, the task may be
+// resumed again this frame if there's time.
+static int lua_Scheduler_Yield(lua_State* state)
+{
+    return lua_yield(state, 0);
+}
+
+static int lua_Scheduler_WaitSeconds(lua_State* state)
+{
+    double seconds = luaL_checknumber(state, 1);
+    if(!GetScheduler(state)->WaitSeconds(state, seconds))
+    {
+        return luaL_error(state, "WaitSeconds: only a scheduled task can wait.");
+    }
+    return lua_yield(state, 0);
+}
+
+static int lua_Scheduler_WaitFrames(lua_State* state)
+{
+    int frames = luaL_optinteger(state, 1, 1);
+    if(!GetScheduler(state)->WaitFrames(state, frames))
+    {
+        return luaL_error(state, "WaitFrames: only a scheduled task can wait.");
+    }
+    return lua_yield(state, 0);
+}
+
+// Scheduler.WaitForAsset(name, [timeout]) waits until the asset, a
+// texture decoding in the background for instance, can be used.
+static int lua_Scheduler_WaitForAsset(lua_State* state)
+{
+    const char* name = luaL_checkstring(state, 1);
+    double timeout = luaL_optnumber(state, 2, -1);
+
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    if(!game->GetAssetStore()->AssetExists(name))
+    {
+        return luaL_error(state, "WaitForAsset: asset [%s] does not exist.", name);
+    }
+
+    if(!game->GetScheduler()->WaitForAsset(state, name, timeout))
+    {
+        return luaL_error(state, "WaitForAsset: only a scheduled task can wait.");
+    }
+    return lua_yield(state, 0);
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Start", lua_Scheduler_Start},
+  {"Stop", lua_Scheduler_Stop},
+  {"IsRunning", lua_Scheduler_IsRunning},
+  {"GetCount", lua_Scheduler_GetCount},
+  {"SetBudget", lua_Scheduler_SetBudget},
+  {"GetBudget", lua_Scheduler_GetBudget},
+  {"Yield", lua_Scheduler_Yield},
+  {"WaitSeconds", lua_Scheduler_WaitSeconds},
+  {"WaitFrames", lua_Scheduler_WaitFrames},
+  {"WaitForAsset", lua_Scheduler_WaitForAsset},
+  {NULL, NULL}  /* sentinel */
+};
+
+void Scheduler::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        Scheduler::Meta.Name(),
+        luaBinding
+    );
+}
+
+Scheduler::Scheduler() :
+    mTasks(),
+    mStarted(),
+    mRunning(false),
+    mNextId(1),
+    mBudgetMicroseconds(DEFAULT_BUDGET_MICROSECONDS),
+    mTime(0)
+{
+}
+
+unsigned int Scheduler::Start(lua_State* state, int functionIndex, int priority)
+{
+    Task task;
+    task.id = mNextId++;
+    task.priority = priority;
+    task.thread = lua_newthread(state);
+    task.ref = luaL_ref(state, LUA_REGISTRYINDEX);
+    task.wakeTime = 0;
+    task.waitFrames = 0;
+    task.assetDeadline = -1;
+    task.done = false;
+
+    lua_pushvalue(state, functionIndex);
+    lua_xmove(state, task.thread, 1);
+
+    // The running task may hold a pointer into mTasks.
+    if(mRunning)
+    {
+        mStarted.push_back(task);
+    }
+    else
+    {
+        Insert(task);
+    }
+    return task.id;
+}
+
+void Scheduler::Insert(const Task& task)
+{
+    // After the last task of the same priority.
+    std::vector<Task>::iterator it = mTasks.begin();
+    while(it != mTasks.end() && it->priority >= task.priority)
+    {
+        ++it;
+    }
+    mTasks.insert(it, task);
+}
+
+bool Scheduler::Stop(lua_State* state, unsigned int id)
+{
+    // Tasks are let go of at the end of a run. A task stopping itself
+    // carries on until it yields.
+    for(std::vector<Task>::iterator it = mTasks.begin(); it != mTasks.end(); ++it)
+    {
+        if(it->id == id && !it->done)
+        {
+            it->done = true;
+            return true;
+        }
+    }
+
+    for(std::vector<Task>::iterator it = mStarted.begin(); it != mStarted.end(); ++it)
+    {
+        if(it->id == id && !it->done)
+        {
+            it->done = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Scheduler::IsRunning(unsigned int id) const
+{
+    for(std::vector<Task>::const_iterator it = mTasks.begin(); it != mTasks.end(); ++it)
+    {
+        if(it->id == id)
+        {
+            return !it->done;
+        }
+    }
+
+    for(std::vector<Task>::const_iterator it = mStarted.begin(); it != mStarted.end(); ++it)
+    {
+        if(it->id == id)
+        {
+            return !it->done;
+        }
+    }
+    return false;
+}
+
+Scheduler::Task* Scheduler::FindTask(lua_State* thread)
+{
+    for(std::vector<Task>::iterator it = mTasks.begin(); it != mTasks.end(); ++it)
+    {
+        if(it->thread == thread && !it->done)
+        {
+            return &(*it);
+        }
+    }
+    return NULL;
+}
+
+bool Scheduler::WaitSeconds(lua_State* thread, double seconds)
+{
+    Task* task = FindTask(thread);
+    if(task == NULL)
+    {
+        return false;
+    }
+    task->wakeTime = mTime + seconds;
+    return true;
+}
+
+bool Scheduler::WaitFrames(lua_State* thread, int frames)
+{
+    Task* task = FindTask(thread);
+    if(task == NULL)
+    {
+        return false;
+    }
+    task->waitFrames = std::max(frames, 0);
+    return true;
+}
+
+bool Scheduler::WaitForAsset(lua_State* thread, const char* name, double timeout)
+{
+    Task* task = FindTask(thread);
+    if(task == NULL)
+    {
+        return false;
+    }
+    task->waitAsset = name;
+    task->assetDeadline = timeout < 0 ? -1 : mTime + timeout;
+    return true;
+}
+
+bool Scheduler::IsReady(Task& task, Game* game)
+{
+    if(task.done || task.waitFrames > 0 || task.wakeTime > mTime)
+    {
+        return false;
+    }
+
+    if(!task.waitAsset.empty())
+    {
+        bool timedOut = task.assetDeadline >= 0 && mTime >= task.assetDeadline;
+        if(!timedOut && game->Textures()->IsLoading(task.waitAsset.c_str()))
+        {
+            return false;
+        }
+        task.waitAsset.clear();
+    }
+    return true;
+}
+
+bool Scheduler::Resume(lua_State* state, Task& task)
+{
+    int result = lua_resume(task.thread, 0);
+
+    if(result == LUA_YIELD)
+    {
+        return true;
+    }
+
+    if(result != 0)
+    {
+        luaL_traceback(state, task.thread, lua_tostring(task.thread, -1), 0);
+        dsprintf("\n[Scheduler] Task %u failed: %s\n", task.id, lua_tostring(state, -1));
+        lua_pop(state, 1);
+    }
+
+    task.done = true;
+    return result == 0;
+}
+
+bool Scheduler::Run(lua_State* state, Game* game, double deltaTime)
+{
+    mTime += deltaTime;
+    for(std::vector<Task>::iterator it = mTasks.begin(); it != mTasks.end(); ++it)
+    {
+        it->waitFrames = std::max(it->waitFrames - 1, 0);
+    }
+
+    const unsigned long long start = DDTime::Microseconds();
+    bool success = true;
+    bool resumed = true;
+    bool first = true;
+    mRunning = true;
+
+    while(resumed && success)
+    {
+        resumed = false;
+        for(unsigned int i = 0; i < mTasks.size(); i++)
+        {
+            if(!first && DDTime::Microseconds() - start >= mBudgetMicroseconds)
+            {
+                break;
+            }
+
+            if(!IsReady(mTasks[i], game))
+            {
+                continue;
+            }
+
+            first = false;
+            resumed = true;
+            if(!Resume(state, mTasks[i]))
+            {
+                success = false;
+                break;
+            }
+        }
+
+        if(DDTime::Microseconds() - start >= mBudgetMicroseconds)
+        {
+            break;
+        }
+    }
+
+    mRunning = false;
+
+    // Tasks started during the run wait for the next frame.
+    for(std::vector<Task>::iterator it = mStarted.begin(); it != mStarted.end(); ++it)
+    {
+        Insert(*it);
+    }
+    mStarted.clear();
+
+    for(std::vector<Task>::iterator it = mTasks.begin(); it != mTasks.end();)
+    {
+        if(it->done)
+        {
+            luaL_unref(state, LUA_REGISTRYINDEX, it->ref);
+            it = mTasks.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return success;
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <string>
+#include <vector>
+
+#include "reflect/Reflect.h"
+
+class LuaState;
+class Game;
+struct lua_State;
+
+//
+// Runs script coroutines after update() until the frame's budget is
+// spent. Tasks are resumed highest priority first and round and round
+// while there's time, so long jobs soak up what headroom there is. A task
+// can wait on seconds, frames or an asset loading before it's resumed.
+//
+class Scheduler
+{
+    public: static Reflect Meta;
+    public:
+        static void Bind(LuaState* state);
+        static const unsigned int DEFAULT_BUDGET_MICROSECONDS = 2000;
+
+        Scheduler();
+
+        unsigned int Start(lua_State* state, int functionIndex, int priority);
+        bool Stop(lua_State* state, unsigned int id);
+        bool IsRunning(unsigned int id) const;
+        unsigned int Count() const { return mTasks.size(); }
+
+        void SetBudget(unsigned int microseconds) { mBudgetMicroseconds = microseconds; }
+        unsigned int Budget() const { return mBudgetMicroseconds; }
+
+        // For the task running on thread. False if it isn't a task.
+        bool WaitSeconds(lua_State* thread, double seconds);
+        bool WaitFrames(lua_State* thread, int frames);
+        bool WaitForAsset(lua_State* thread, const char* name, double timeout);
+
+        // Resumes tasks for up to the budget, at least one if any is ready.
+        // Returns false if a task raised an error.
+        bool Run(lua_State* state, Game* game, double deltaTime);
+
+        // The tasks went with the Lua state.
+        void Reset() { mTasks.clear(); mStarted.clear(); }
+    private:
+        struct Task
+        {
+            unsigned int id;
+            int priority;
+            int ref; // keeps the thread alive in the registry
+            lua_State* thread;
+            double wakeTime;
+            int waitFrames;
+            std::string waitAsset;
+            double assetDeadline;
+            bool done;
+        };
+
+        std::vector<Task> mTasks; // highest priority first, then oldest
+        std::vector<Task> mStarted; // during a run, added after it
+        bool mRunning;
+        unsigned int mNextId;
+        unsigned int mBudgetMicroseconds;
+        double mTime; // game time, in seconds
+
+        Task* FindTask(lua_State* thread);
+        void Insert(const Task& task);
+        bool IsReady(Task& task, Game* game);
+        bool Resume(lua_State* state, Task& task);
+};
+
+#endif
\ No newline at end of file
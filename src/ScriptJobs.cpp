@@ -0,0 +1,407 @@
+#include "ScriptJobs.h"
+
+#include <assert.h>
+
+#include "Asset.h"
+#include "ByteBuffer.h"
+#include "DDFile.h"
+#include "DDLog.h"
+#include "DinodeckLua.h"
+#include "Game.h"
+#include "LuaState.h"
+#include "ManifestAssetStore.h"
+#include "VectorArray.h"
+
+Reflect ScriptJobs::Meta("Jobs", ScriptJobs::Bind);
+
+static ScriptJobs* GetScriptJobs(lua_State* state)
+{
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    assert(game);
+    return game->GetScriptJobs();
+}
+
+//
+// Searches a grid on a worker. Grids from Jobs.FindPath are the job's own
+// and worked out here, a PathGrid's are ready before they're shared.
+//
+class ScriptJobs::PathJob : public Job
+{
+    ScriptJobs* mOwner;
+    Result mResult;
+    PathGrid::Data* mGrid;
+    int mStart;
+    int mEnd;
+public:
+    PathJob(ScriptJobs* owner,
+            const Result& result,
+            PathGrid::Data* grid,
+            int start,
+            int end) :
+        mOwner(owner),
+        mResult(result),
+        mGrid(grid),
+        mStart(start),
+        mEnd(end)
+    {
+    }
+
+    virtual ~PathJob()
+    {
+        mGrid->Release();
+    }
+
+    virtual void Run()
+    {
+        if(!mGrid->IsPrepared())
+        {
+            mGrid->Prepare();
+        }
+        mResult.found = mGrid->Search(mStart, mEnd, &mResult.path);
+        mOwner->Finish(mResult);
+    }
+};
+
+//
+// Runs a script in a worker state. The message and the result are copies,
+// the script can't reach the game's state.
+//
+class ScriptJobs::ScriptJob : public Job
+{
+    ScriptJobs* mOwner;
+    Result mResult;
+    const std::string mName;
+    const std::string mSource;
+    ScriptMessage mInput;
+public:
+    ScriptJob(ScriptJobs* owner,
+              const Result& result,
+              const std::string& name,
+              const std::string& source,
+              const ScriptMessage& input) :
+        mOwner(owner),
+        mResult(result),
+        mName(name),
+        mSource(source),
+        mInput(input)
+    {
+    }
+
+    virtual void Run()
+    {
+        LuaState* worker = mOwner->TakeState();
+        lua_State* state = worker->State();
+
+        if(luaL_loadbuffer(state, mSource.data(), mSource.size(), mName.c_str()) != 0)
+        {
+            mResult.error = lua_tostring(state, -1);
+        }
+        else
+        {
+            mInput.Push(state);
+            if(lua_pcall(state, 1, 1, 0) != 0)
+            {
+                mResult.error = lua_tostring(state, -1);
+            }
+            else if(!mResult.message.Write(state, -1, &mResult.error))
+            {
+                mResult.error = "returned a value that can't be sent, " + mResult.error;
+            }
+        }
+
+        worker->Restore();
+        mOwner->ReturnState(worker);
+        mOwner->Finish(mResult);
+    }
+};
+
+// Jobs.FindPath(grid, width, height, startX, startY, endX, endY, callback)
+// The grid is width * height costs, row by row, and 0 is a wall.
+// Coordinates start at 1. The callback gets { x1, y1, x2, y2, ... } from
+// start to end, or nil if there's no way through. Returns the job id.
+static int lua_Jobs_FindPath(lua_State* state)
+{
+    luaL_checktype(state, 1, LUA_TTABLE);
+    const int width = luaL_checkinteger(state, 2);
+    const int height = luaL_checkinteger(state, 3);
+    const int startX = luaL_checkinteger(state, 4);
+    const int startY = luaL_checkinteger(state, 5);
+    const int endX = luaL_checkinteger(state, 6);
+    const int endY = luaL_checkinteger(state, 7);
+    luaL_checktype(state, 8, LUA_TFUNCTION);
+
+    if(width <= 0 || height <= 0
+       || (unsigned int) width * height > ScriptJobs::MAX_GRID_CELLS)
+    {
+        return luaL_error(state, "FindPath: grid must be between 1 and %d cells.",
+                          (int) ScriptJobs::MAX_GRID_CELLS);
+    }
+
+    if(startX < 1 || startY < 1 || startX > width || startY > height
+       || endX < 1 || endY < 1 || endX > width || endY > height)
+    {
+        return luaL_error(state, "FindPath: start and end must be in the grid.");
+    }
+
+    const int cells = width * height;
+    if((int) lua_objlen(state, 1) < cells)
+    {
+        return luaL_error(state, "FindPath: grid has fewer than %d cells.", cells);
+    }
+
+    // Copied now, the job mustn't touch the table. A PathGrid keeps its
+    // copy between searches.
+    PathGrid::Data* grid = PathGrid::Data::Create(width, height);
+    for(int i = 0; i < cells; i++)
+    {
+        lua_rawgeti(state, 1, i + 1);
+        grid->SetCost(i, (float) lua_tonumber(state, -1));
+        lua_pop(state, 1);
+    }
+
+    lua_pushvalue(state, 8);
+    int callbackRef = luaL_ref(state, LUA_REGISTRYINDEX);
+
+    unsigned int id = GetScriptJobs(state)->FindPath(grid,
+                                                     (startY - 1) * width + startX - 1,
+                                                     (endY - 1) * width + endX - 1,
+                                                     callbackRef);
+    lua_pushinteger(state, id);
+    return 1;
+}
+
+// Jobs.RunScript(scriptName, message, callback)
+// The script asset runs in a worker state, getting a copy of the message
+// as its ... . The callback gets a copy of what it returns, or nil if it
+// raised an error. Messages are nil, booleans, numbers, strings,
+// ByteBuffers, VectorArrays and tables of those. Returns the job id.
+static int lua_Jobs_RunScript(lua_State* state)
+{
+    const char* name = luaL_checkstring(state, 1);
+    luaL_checktype(state, 3, LUA_TFUNCTION);
+
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    assert(game);
+    ManifestAssetStore* store = game->GetAssetStore();
+    if(!store->AssetExists(name))
+    {
+        return luaL_error(state, "RunScript: no asset [%s].", name);
+    }
+
+    ScriptMessage message;
+    std::string error;
+    if(!message.Write(state, 2, &error))
+    {
+        return luaL_error(state, "RunScript: %s.", error.c_str());
+    }
+
+    lua_pushvalue(state, 3);
+    int callbackRef = luaL_ref(state, LUA_REGISTRYINDEX);
+
+    unsigned int id = GetScriptJobs(state)->RunScript(store->GetAssetByName(name)->Path(),
+                                                      message,
+                                                      callbackRef);
+    if(id == 0)
+    {
+        luaL_unref(state, LUA_REGISTRYINDEX, callbackRef);
+        return luaL_error(state, "RunScript: couldn't read [%s].", name);
+    }
+    lua_pushinteger(state, id);
+    return 1;
+}
+
+static int lua_Jobs_GetPending(lua_State* state)
+{
+    lua_pushinteger(state, GetScriptJobs(state)->Pending());
+    return 1;
+}
+
+static int lua_Jobs_GetWorkerCount(lua_State* state)
+{
+    lua_pushinteger(state, GetScriptJobs(state)->Jobs()->WorkerCount());
+    return 1;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"FindPath", lua_Jobs_FindPath},
+  {"RunScript", lua_Jobs_RunScript},
+  {"GetPending", lua_Jobs_GetPending},
+  {"GetWorkerCount", lua_Jobs_GetWorkerCount},
+  {NULL, NULL}  /* sentinel */
+};
+
+void ScriptJobs::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        ScriptJobs::Meta.Name(),
+        luaBinding
+    );
+}
+
+ScriptJobs::ScriptJobs(JobSystem* jobs) :
+    mJobs(jobs),
+    mGroup(),
+    mMutex(),
+    mFinished(),
+    mIdleStates(),
+    mSources(),
+    mNextId(1)
+{
+    assert(jobs);
+}
+
+ScriptJobs::~ScriptJobs()
+{
+    mJobs->Wait(mGroup);
+    DeleteIdleStates();
+}
+
+unsigned int ScriptJobs::FindPath(PathGrid::Data* grid,
+                                  int start,
+                                  int end,
+                                  int callbackRef)
+{
+    Result result;
+    result.id = mNextId++;
+    result.callbackRef = callbackRef;
+    result.found = false;
+    result.script = false;
+
+    mJobs->Submit(new PathJob(this, result, grid, start, end), &mGroup);
+    return result.id;
+}
+
+unsigned int ScriptJobs::RunScript(const std::string& path,
+                                   const ScriptMessage& message,
+                                   int callbackRef)
+{
+    std::map<std::string, std::string>::iterator source = mSources.find(path);
+    if(source == mSources.end())
+    {
+        DDFile file(path.c_str());
+        if(!file.LoadFileIntoBuffer())
+        {
+            return 0;
+        }
+        source = mSources.insert(std::make_pair(path,
+                                                std::string(file.Buffer(), file.Size()))).first;
+    }
+
+    Result result;
+    result.id = mNextId++;
+    result.callbackRef = callbackRef;
+    result.found = false;
+    result.script = true;
+
+    mJobs->Submit(new ScriptJob(this, result, path, source->second, message), &mGroup);
+    return result.id;
+}
+
+LuaState* ScriptJobs::TakeState()
+{
+    {
+        ScopedLock lock(mMutex);
+        if(!mIdleStates.empty())
+        {
+            LuaState* state = mIdleStates.back();
+            mIdleStates.pop_back();
+            return state;
+        }
+    }
+
+    LuaState* state = new LuaState("Worker");
+    Reflect::Bind(ByteBuffer::Meta.Name(), state);
+    Reflect::Bind(VectorArray::Meta.Name(), state);
+    state->MarkPristine();
+    return state;
+}
+
+void ScriptJobs::ReturnState(LuaState* state)
+{
+    ScopedLock lock(mMutex);
+    mIdleStates.push_back(state);
+}
+
+void ScriptJobs::DeleteIdleStates()
+{
+    ScopedLock lock(mMutex);
+    for(std::vector<LuaState*>::iterator it = mIdleStates.begin(); it != mIdleStates.end(); ++it)
+    {
+        delete *it;
+    }
+    mIdleStates.clear();
+}
+
+void ScriptJobs::Finish(const Result& result)
+{
+    ScopedLock lock(mMutex);
+    mFinished.push_back(result);
+}
+
+unsigned int ScriptJobs::Pending()
+{
+    unsigned int finished = 0;
+    {
+        ScopedLock lock(mMutex);
+        finished = mFinished.size();
+    }
+    return mGroup.Pending() + finished;
+}
+
+bool ScriptJobs::Update(LuaState* luaState)
+{
+    lua_State* state = luaState->State();
+    std::vector<Result> finished;
+    {
+        ScopedLock lock(mMutex);
+        finished.swap(mFinished);
+    }
+
+    bool result = true;
+    for(std::vector<Result>::iterator it = finished.begin(); it != finished.end(); ++it)
+    {
+        if(result)
+        {
+            if(it->script)
+            {
+                if(it->error.empty())
+                {
+                    it->message.Push(state);
+                }
+                else
+                {
+                    dsprintf("[Jobs] RunScript: %s\n", it->error.c_str());
+                    lua_pushnil(state);
+                }
+            }
+            else if(it->found)
+            {
+                lua_createtable(state, it->path.size(), 0);
+                for(unsigned int i = 0; i < it->path.size(); i++)
+                {
+                    lua_pushinteger(state, it->path[i]);
+                    lua_rawseti(state, -2, i + 1);
+                }
+            }
+            else
+            {
+                lua_pushnil(state);
+            }
+
+            result = luaState->CallRegisteredFunctionWithTop(it->callbackRef);
+        }
+        luaL_unref(state, LUA_REGISTRYINDEX, it->callbackRef);
+    }
+    return result;
+}
+
+void ScriptJobs::Reset()
+{
+    mJobs->Wait(mGroup);
+    // Scripts may have changed with the reload.
+    mSources.clear();
+    DeleteIdleStates();
+    ScopedLock lock(mMutex);
+    mFinished.clear();
+}
\ No newline at end of file
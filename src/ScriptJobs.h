@@ -0,0 +1,86 @@
+#ifndef SCRIPTJOBS_H
+#define SCRIPTJOBS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+#include "PathGrid.h"
+#include "reflect/Reflect.h"
+#include "ScriptMessage.h"
+
+class LuaState;
+struct lua_State;
+
+//
+// The Jobs library. The game's Lua state is the main thread's, so scripts
+// hand over plain data, either for a native job or for a script run in a
+// worker state of its own, and get the result in a callback at the end of
+// a later update.
+//
+// Worker states only have the standard libraries, ByteBuffer and
+// VectorArray. Each is rewound after its script runs, so nothing carries
+// over between runs, and kept for the next.
+//
+class ScriptJobs
+{
+    public: static Reflect Meta;
+    public:
+        static void Bind(LuaState* state);
+        static const unsigned int MAX_GRID_CELLS = 1024 * 1024;
+
+        ScriptJobs(JobSystem* jobs);
+        ~ScriptJobs(); // waits for jobs in flight
+
+        // Takes over a reference to the grid. The path is x, y pairs from
+        // start to end.
+        unsigned int FindPath(PathGrid::Data* grid,
+                              int start,
+                              int end,
+                              int callbackRef);
+        // Runs the script with the message as its ... and calls back with
+        // what it returns. 0 if the script couldn't be read.
+        unsigned int RunScript(const std::string& path,
+                               const ScriptMessage& message,
+                               int callbackRef);
+
+        // Calls back finished jobs. False if a callback raised an error.
+        bool Update(LuaState* state);
+        // Waits for jobs in flight and drops every result, for when the
+        // Lua state, and the callbacks with it, is about to go.
+        void Reset();
+        unsigned int Pending();
+        JobSystem* Jobs() { return mJobs; }
+    private:
+        struct Result
+        {
+            unsigned int id;
+            int callbackRef;
+            bool found;
+            std::vector<int> path;
+            bool script;
+            ScriptMessage message; // what the script returned
+            std::string error;
+        };
+        class PathJob;
+        class ScriptJob;
+
+        JobSystem* mJobs;
+        JobGroup mGroup;
+        Mutex mMutex;
+        std::vector<Result> mFinished;
+        std::vector<LuaState*> mIdleStates;
+        std::map<std::string, std::string> mSources; // by path, until Reset
+        unsigned int mNextId;
+
+        void Finish(const Result& result);
+        LuaState* TakeState();
+        void ReturnState(LuaState* state);
+        void DeleteIdleStates();
+
+        ScriptJobs(const ScriptJobs&);
+        ScriptJobs& operator=(const ScriptJobs&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "ScriptMessage.h"
+
+#include <assert.h>
+#include <string.h>
+#include <new>
+
+#include "ByteBuffer.h"
+#include "DinodeckLua.h"
+#include "HttpBody.h"
+#include "LuaState.h"
+#include "VectorArray.h"
+
+bool ScriptMessage::Write(lua_State* state, int index, std::string* error)
+{
+    assert(error);
+    if(index < 0 && index > LUA_REGISTRYINDEX)
+    {
+        index = lua_gettop(state) + index + 1;
+    }
+    mData.clear();
+    return WriteValue(state, index, 0, error);
+}
+
+void ScriptMessage::Append(const void* data, unsigned int size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    mData.insert(mData.end(), bytes, bytes + size);
+}
+
+void ScriptMessage::AppendTag(eTag tag)
+{
+    mData.push_back((char) tag);
+}
+
+bool ScriptMessage::WriteValue(lua_State* state,
+                               int index,
+                               unsigned int depth,
+                               std::string* error)
+{
+    switch(lua_type(state, index))
+    {
+        case LUA_TNONE:
+        case LUA_TNIL:
+        {
+            AppendTag(TAG_NIL);
+            return true;
+        }
+        case LUA_TBOOLEAN:
+        {
+            AppendTag(lua_toboolean(state, index) ? TAG_TRUE : TAG_FALSE);
+            return true;
+        }
+        case LUA_TNUMBER:
+        {
+            double number = lua_tonumber(state, index);
+            AppendTag(TAG_NUMBER);
+            Append(&number, sizeof(number));
+            return true;
+        }
+        case LUA_TSTRING:
+        {
+            size_t length = 0;
+            const char* str = lua_tolstring(state, index, &length);
+            unsigned int size = (unsigned int) length;
+            AppendTag(TAG_STRING);
+            Append(&size, sizeof(size));
+            Append(str, size);
+            return true;
+        }
+        case LUA_TUSERDATA:
+        {
+            if(LuaState::IsType<ByteBuffer>(state, index))
+            {
+                const ByteBuffer* buffer = (const ByteBuffer*) lua_touserdata(state, index);
+                unsigned int size = buffer->Size();
+                AppendTag(TAG_BYTE_BUFFER);
+                Append(&size, sizeof(size));
+                Append(buffer->Data(), size);
+                return true;
+            }
+
+            if(!LuaState::IsType<VectorArray>(state, index))
+            {
+                *error = "only ByteBuffer and VectorArray userdata can be sent";
+                return false;
+            }
+
+            const VectorArray* array = (const VectorArray*) lua_touserdata(state, index);
+            unsigned int count = array->Count();
+            AppendTag(TAG_VECTOR_ARRAY);
+            Append(&count, sizeof(count));
+            for(unsigned int i = 0; i < count; i++)
+            {
+                float xyzw[4] = { array->X(i), array->Y(i), array->Z(i), array->W(i) };
+                Append(xyzw, sizeof(xyzw));
+            }
+            return true;
+        }
+        case LUA_TTABLE:
+        {
+            if(depth >= MAX_DEPTH)
+            {
+                *error = "tables are nested too deep, or refer to themselves";
+                return false;
+            }
+
+            AppendTag(TAG_TABLE);
+            lua_pushnil(state);
+            while(lua_next(state, index) != 0)
+            {
+                int key = lua_gettop(state) - 1;
+                int keyType = lua_type(state, key);
+                if(keyType != LUA_TNUMBER
+                   && keyType != LUA_TSTRING
+                   && keyType != LUA_TBOOLEAN)
+                {
+                    *error = "table keys must be numbers, strings or booleans";
+                    lua_pop(state, 2);
+                    return false;
+                }
+
+                if(!WriteValue(state, key, depth + 1, error)
+                   || !WriteValue(state, key + 1, depth + 1, error))
+                {
+                    lua_pop(state, 2);
+                    return false;
+                }
+                lua_pop(state, 1);
+            }
+            AppendTag(TAG_END);
+            return true;
+        }
+        default:
+        {
+            *error = std::string(luaL_typename(state, index)) + " values can't be sent";
+            return false;
+        }
+    }
+}
+
+void ScriptMessage::Read(unsigned int offset, void* out, unsigned int size) const
+{
+    assert(offset + size <= mData.size());
+    memcpy(out, &mData[offset], size);
+}
+
+void ScriptMessage::Push(lua_State* state) const
+{
+    if(mData.empty())
+    {
+        lua_pushnil(state);
+        return;
+    }
+    PushValue(state, 0);
+}
+
+unsigned int ScriptMessage::PushValue(lua_State* state, unsigned int offset) const
+{
+    assert(offset < mData.size());
+    const eTag tag = (eTag) mData[offset++];
+    switch(tag)
+    {
+        case TAG_NIL:
+        {
+            lua_pushnil(state);
+            return offset;
+        }
+        case TAG_FALSE:
+        case TAG_TRUE:
+        {
+            lua_pushboolean(state, tag == TAG_TRUE);
+            return offset;
+        }
+        case TAG_NUMBER:
+        {
+            double number = 0;
+            Read(offset, &number, sizeof(number));
+            lua_pushnumber(state, number);
+            return offset + sizeof(number);
+        }
+        case TAG_STRING:
+        {
+            unsigned int size = 0;
+            Read(offset, &size, sizeof(size));
+            offset += sizeof(size);
+            lua_pushlstring(state, size > 0 ? &mData[offset] : "", size);
+            return offset + size;
+        }
+        case TAG_VECTOR_ARRAY:
+        {
+            unsigned int count = 0;
+            Read(offset, &count, sizeof(count));
+            offset += sizeof(count);
+
+            VectorArray* array =
+                new (lua_newuserdata(state, sizeof(VectorArray))) VectorArray(count);
+            for(unsigned int i = 0; i < count; i++)
+            {
+                float xyzw[4];
+                Read(offset, xyzw, sizeof(xyzw));
+                offset += sizeof(xyzw);
+                array->Set(i, xyzw[0], xyzw[1], xyzw[2], xyzw[3]);
+            }
+
+            luaL_getmetatable(state, VectorArray::Meta.Name().c_str());
+            if(lua_isnil(state, -1))
+            {
+                lua_pop(state, 1);
+                Reflect::Bind(VectorArray::Meta.Name(), LuaState::GetWrapper(state));
+                luaL_getmetatable(state, VectorArray::Meta.Name().c_str());
+            }
+            lua_setmetatable(state, -2);
+            return offset;
+        }
+        case TAG_BYTE_BUFFER:
+        {
+            unsigned int size = 0;
+            Read(offset, &size, sizeof(size));
+            offset += sizeof(size);
+
+            SharedBuffer* buffer = SharedBuffer::Create();
+            if(size > 0)
+            {
+                buffer->Data().resize(size);
+                Read(offset, &buffer->Data()[0], size);
+            }
+            ByteBuffer::Push(state, buffer);
+            return offset + size;
+        }
+        case TAG_TABLE:
+        {
+            lua_newtable(state);
+            while((eTag) mData[offset] != TAG_END)
+            {
+                offset = PushValue(state, offset);
+                offset = PushValue(state, offset);
+                lua_rawset(state, -3);
+            }
+            return offset + 1;
+        }
+        default:
+        {
+            assert(false);
+            lua_pushnil(state);
+            return mData.size();
+        }
+    }
+}
\ No newline at end of file
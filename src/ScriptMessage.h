@@ -0,0 +1,52 @@
+#ifndef SCRIPTMESSAGE_H
+#define SCRIPTMESSAGE_H
+
+#include <string>
+#include <vector>
+
+struct lua_State;
+
+//
+// A Lua value copied out of one state to be pushed into another, how
+// scripts on worker states and the game's state swap data. Nil, booleans,
+// numbers, strings, ByteBuffers, VectorArrays and tables of those copy. Functions, other userdata and tables that refer back to
+// themselves don't.
+//
+class ScriptMessage
+{
+public:
+    static const unsigned int MAX_DEPTH = 32;
+
+    ScriptMessage() : mData() {}
+
+    // Replaces the message with the value at index. False, and the reason
+    // in error, if the value can't be copied.
+    bool Write(lua_State* state, int index, std::string* error);
+    // ByteBuffer and VectorArray are bound in the state if they aren't yet.
+    void Push(lua_State* state) const;
+    unsigned int Size() const { return mData.size(); }
+    void Clear() { mData.clear(); }
+private:
+    enum eTag
+    {
+        TAG_NIL,
+        TAG_FALSE,
+        TAG_TRUE,
+        TAG_NUMBER,
+        TAG_STRING,
+        TAG_TABLE,
+        TAG_VECTOR_ARRAY,
+        TAG_BYTE_BUFFER,
+        TAG_END, // closes a table
+    };
+    std::vector<char> mData;
+
+    bool WriteValue(lua_State* state, int index, unsigned int depth, std::string* error);
+    void Append(const void* data, unsigned int size);
+    void AppendTag(eTag tag);
+    // Returns the offset after the value.
+    unsigned int PushValue(lua_State* state, unsigned int offset) const;
+    void Read(unsigned int offset, void* out, unsigned int size) const;
+};
+
+#endif
\ No newline at end of file
@@ -3,6 +3,9 @@
 
 #include <string>
 
+#include "LuaState.h"
+#include "Scheduler.h"
+
 struct Settings
 {
     std::string name;
@@ -16,6 +19,8 @@ struct Settings
     int displayHeight;
 
     // clear color
+    std::string splash; // image shown as a cold start loads, empty is none
+    bool splashBar; // a bar under it follows the manifest load
     float clearRed;
     float clearGreen;
     float clearBlue;
@@ -23,8 +28,62 @@ struct Settings
     std::string manifestPath;
     std::string mainScript;
     std::string onUpdate;
+    std::string onFixedUpdate;
     bool webserver;
     std::string orientation; // portrait or landscape, android only.
+    bool streamVertices; // batches go through a VBO ring rather than client arrays
+    bool recordFrames; // GL work is done after update rather than during it
+    bool useShaders; // GLSL where supported, otherwise fixed function
+    int textureSlots; // textures a shader batch can mix, 1 batches by texture
+    int jobThreads; // job system workers, 0 is one a core less the main thread
+    bool asyncTextures; // decode textures on the job system
+    int textureThreads; // most textures decoding at once
+    int textureUploadMs; // main thread time a frame for uploading them
+    int textureStreamKB; // bigger textures are uploaded over several frames
+    int textureBudgetKB; // least recently used textures are evicted past it, 0 is no limit
+    int textureCacheKB; // decoded pixels kept for context loss, 0 keeps none
+    bool premultipliedAlpha; // textures converted at load, normal and additive batch together
+    bool trimTransparent; // sprites skip their textures' fully transparent borders
+    LuaState::eGCMode gcMode;
+    int gcStepMicroseconds; // per frame, for incremental collection
+    bool bytecodeCache; // unchanged scripts aren't parsed again on reload
+    std::string bytecodeCacheDir; // where to keep it between runs, empty is memory only
+    bool fastReset; // reloads rewind the Lua state rather than rebuild it
+    int schedulerBudgetMicroseconds; // per frame, for Scheduler tasks
+    bool hotReload; // changed scripts are patched into the running game
+    bool jit; // LuaJIT compiles hot code, jit_android etc. override it per platform
+    bool jitLog; // compiled and aborted traces go to the log
+    int jitHotloop; // iterations before a loop is compiled, 0 is LuaJIT's default
+    int jitMaxMcodeKb; // machine code the JIT may use, 0 is LuaJIT's default
+    bool contentHashing; // touched files with the same content aren't reloaded
+    std::string contentHashFile; // the hashes kept between runs, empty is memory only
+    int preloadBudgetUs; // time each frame spends loading preloaded groups
+    std::string manifestCacheFile; // the last manifest parse, empty is no cache
+    std::string assetServer; // http url of asset_server.py, empty reads files as usual
+    std::string assetCacheDir; // keeps the asset server's files between runs, empty is memory only
+    bool shareSoundBuffers; // sounds with the same file play from one buffer
+    int soundBudgetKb; // ondemand sounds are unloaded past it, 0 is no limit
+    int audioRefresh; // mixes a second, 0 is the driver's default
+    std::string soundResample; // "off", or "linear" or "cubic" to the output rate on load
+    int soundChannels; // sounds are mixed to 1 or 2 channels on load, 0 keeps theirs
+    int httpBatchMs; // Http.Queue events wait this long to go out together
+    int httpBatchMax; // events in a batch before it goes regardless
+    std::string httpOutboxFile; // save data for unsent batches, empty is memory only
+    int scoreCacheSeconds; // a cached leaderboard is refreshed once it's this old
+    std::string scoreCacheFile; // save data for unsent scores and leaderboards, empty is memory only
+    std::string logFile; // the log is also copied here, empty is off
+    int fixedUpdateRate; // on_fixed_update steps a second, 0 is off
+    int maxFixedSteps; // a frame, time past them is dropped
+    int frameRate; // the desktop loop is held to, 0 leaves it to vsync
+    bool vsync; // swaps wait for the display, where the driver allows
+    bool lowLatency; // waits for the GPU after each swap so the driver can't queue frames
+    bool redrawOnRequest; // frames are only drawn for input, System.RequestRedraw and loading
+    bool partialRedraw; // only what System.MarkDirty marked is drawn again, the rest is kept
+    bool dynamicResolution; // the scene is drawn smaller when the GPU falls behind
+    int minResolutionPercent; // of the view's size, the smallest it goes
+    int resolutionTargetMs; // frames taking longer than this lower the resolution
+    bool overdrawHeatmap; // frames are drawn as a heatmap of fills per pixel
+    int msaaSamples; // multisampling the scene, 0 is off
 
     Settings() :
         name("CGGameLoop"),
@@ -32,14 +91,70 @@ struct Settings
         height(360),
         displayWidth(640),
         displayHeight(360),
+        splash(""),
+        splashBar(false),
         clearRed(0.164f),
         clearGreen(0.164f),
         clearBlue(0.164f),
         manifestPath("manifest.lua"),
         mainScript("main.lua"),
         onUpdate("update()"),
+        onFixedUpdate("fixed_update()"),
         webserver(false),
-        orientation("portrait") {}
+        orientation("portrait"),
+        streamVertices(true),
+        recordFrames(true),
+        useShaders(true),
+        textureSlots(1),
+        jobThreads(0),
+        asyncTextures(false),
+        textureThreads(2),
+        textureUploadMs(4),
+        textureStreamKB(512),
+        textureBudgetKB(0),
+        textureCacheKB(0),
+        premultipliedAlpha(false),
+        trimTransparent(true),
+        gcMode(LuaState::GC_FULL),
+        gcStepMicroseconds(LuaState::DEFAULT_GC_STEP_MICROSECONDS),
+        bytecodeCache(true),
+        bytecodeCacheDir(""),
+        fastReset(true),
+        schedulerBudgetMicroseconds(Scheduler::DEFAULT_BUDGET_MICROSECONDS),
+        hotReload(true),
+        jit(true),
+        jitLog(false),
+        jitHotloop(0),
+        jitMaxMcodeKb(0),
+        contentHashing(true),
+        contentHashFile(""),
+        preloadBudgetUs(4000),
+        manifestCacheFile(""),
+        assetServer(""),
+        assetCacheDir(""),
+        shareSoundBuffers(true),
+        soundBudgetKb(0),
+        audioRefresh(0),
+        soundResample("off"),
+        soundChannels(0),
+        httpBatchMs(10000),
+        httpBatchMax(50),
+        httpOutboxFile("http_outbox"),
+        scoreCacheSeconds(300),
+        scoreCacheFile("score_cache"),
+        logFile(""),
+        fixedUpdateRate(0),
+        maxFixedSteps(5),
+        frameRate(60),
+        vsync(false),
+        lowLatency(false),
+        redrawOnRequest(false),
+        partialRedraw(false),
+        dynamicResolution(false),
+        minResolutionPercent(50),
+        resolutionTargetMs(14),
+        overdrawHeatmap(false),
+        msaaSamples(0) {}
 };
 
 #endif
@@ -0,0 +1,469 @@
+#include "ShaderProgram.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <stdio.h>
+
+#include "DinodeckGL.h"
+#include "DinodeckLua.h"
+#include "DDLog.h"
+#include "LuaState.h"
+#include "Vertex.h"
+
+Reflect ShaderProgram::Meta("Shader", ShaderProgram::Bind);
+std::vector<ShaderProgram*> ShaderProgram::mPrograms;
+std::vector<ShaderProgram*> ShaderProgram::mReleased;
+
+// Attribute locations are bound before linking, so every program takes
+// the same vertex pointers.
+enum
+{
+    POSITION_ATTRIB = 0,
+    COLOUR_ATTRIB = 1,
+    TEXCOORD_ATTRIB = 2
+};
+
+static const char* VertexSource =
+    "attribute vec2 aPosition;\n"
+    "attribute vec4 aColour;\n"
+    "attribute vec2 aTexCoord;\n"
+    "attribute float aSlot;\n"
+    "uniform vec4 uTransform;\n"
+    "uniform vec2 uOffset;\n"
+    "uniform vec3 uUVBase;\n"
+    "varying vec4 vColour;\n"
+    "varying vec2 vTexCoord;\n"
+    "varying float vSlot;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = vec4(uTransform.x * aPosition.x + uTransform.y * aPosition.y + uOffset.x,\n"
+    "                       uTransform.z * aPosition.x + uTransform.w * aPosition.y + uOffset.y,\n"
+    "                       0.0, 1.0);\n"
+    "    vColour = aColour;\n"
+    "    vTexCoord = aTexCoord * uUVBase.x + uUVBase.yz;\n"
+    "    vSlot = aSlot;\n"
+    "}\n";
+
+const char* ShaderProgram::DefaultFragmentSource =
+    "uniform sampler2D uTexture;\n"
+    "uniform float uTextured;\n"
+    "uniform float uAlphaTest;\n"
+    "varying vec4 vColour;\n"
+    "varying vec2 vTexCoord;\n"
+    "void main()\n"
+    "{\n"
+    "    vec4 colour = vColour * mix(vec4(1.0), texture2D(uTexture, vTexCoord), uTextured);\n"
+    "    if(uAlphaTest > 0.5 && colour.a < 0.5)\n"
+    "    {\n"
+    "        discard;\n"
+    "    }\n"
+    "    gl_FragColor = colour;\n"
+    "}\n";
+
+std::string ShaderProgram::SlotFragmentSource(unsigned int slots)
+{
+    assert(slots >= 1 && slots <= MAX_TEXTURE_SLOTS);
+
+    // A chain of ifs rather than a sampler array, GLSL 1.10 can't index
+    // samplers with a varying.
+    std::string source;
+    char line[128];
+    for(unsigned int i = 0; i < slots; i++)
+    {
+        sprintf(line, "uniform sampler2D uTexture%u;\n", i);
+        source += line;
+    }
+    source +=
+        "uniform float uAlphaTest;\n"
+        "varying vec4 vColour;\n"
+        "varying vec2 vTexCoord;\n"
+        "varying float vSlot;\n"
+        "void main()\n"
+        "{\n"
+        "    vec4 texel = vec4(1.0);\n";
+    for(unsigned int i = 0; i < slots; i++)
+    {
+        sprintf(line, "    %sif(vSlot < %u.5) texel = texture2D(uTexture%u, vTexCoord);\n",
+                i == 0 ? "" : "else ", i, i);
+        source += line;
+    }
+    source +=
+        "    vec4 colour = vColour * texel;\n"
+        "    if(uAlphaTest > 0.5 && colour.a < 0.5)\n"
+        "    {\n"
+        "        discard;\n"
+        "    }\n"
+        "    gl_FragColor = colour;\n"
+        "}\n";
+    return source;
+}
+
+static int lua_Shader_Create(lua_State* state)
+{
+    if(!lua_isstring(state, 1))
+    {
+        return luaL_typerror(state, 1, "string");
+    }
+
+    ShaderProgram* program = new ShaderProgram(lua_tostring(state, 1));
+
+    // Report mistakes to the script now rather than drawing nothing later.
+    if(ShaderProgram::IsSupported() && !program->Build())
+    {
+        std::string error = program->GetLastError();
+        program->Release();
+        return luaL_error(state, "Shader failed to build:\n%s", error.c_str());
+    }
+
+    ShaderProgram** pi = (ShaderProgram**)lua_newuserdata(state, sizeof(ShaderProgram*));
+    (*pi) = program;
+    luaL_getmetatable(state, "Shader");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_Shader_gc(lua_State* state)
+{
+    ShaderProgram** program = (ShaderProgram**)lua_touserdata(state, 1);
+    assert(program);
+    (*program)->Release();
+    return 0;
+}
+
+static int lua_Shader_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "Shader");
+    return 1;
+}
+
+static int lua_Shader_SetUniform(lua_State* state)
+{
+    ShaderProgram** program = LuaState::GetFuncParamPtr<ShaderProgram>(state, 1);
+    if(program == NULL)
+    {
+        return 0;
+    }
+
+    if(!lua_isstring(state, 2))
+    {
+        return luaL_typerror(state, 2, "string");
+    }
+
+    // One to four numbers, for float to vec4 uniforms.
+    float values[4] = { 0, 0, 0, 0 };
+    int count = 0;
+    while(count < 4 && lua_isnumber(state, 3 + count))
+    {
+        values[count] = (float) lua_tonumber(state, 3 + count);
+        count++;
+    }
+
+    if(count == 0)
+    {
+        return luaL_typerror(state, 3, "number");
+    }
+
+    (*program)->SetUniform(lua_tostring(state, 2), count, values);
+    return 0;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_Shader_Create},
+  {"__gc", lua_Shader_gc},
+  {"__tostring", lua_Shader_tostring},
+  {"SetUniform", lua_Shader_SetUniform},
+  {NULL, NULL}  /* sentinel */
+};
+
+void ShaderProgram::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        ShaderProgram::Meta.Name(),
+        luaBinding
+    );
+}
+
+bool ShaderProgram::IsSupported()
+{
+#if !DINODECK_SHADERS
+    return false;
+#elif __APPLE__
+    return true;
+#else
+    return GLEE_VERSION_2_0;
+#endif
+}
+
+void ShaderProgram::ResetAll()
+{
+    for(std::vector<ShaderProgram*>::iterator it = mPrograms.begin();
+        it != mPrograms.end(); ++it)
+    {
+        // The ids went with the context.
+        (*it)->mProgram = 0;
+        (*it)->mBroken = false;
+    }
+}
+
+void ShaderProgram::CollectReleased()
+{
+    for(std::vector<ShaderProgram*>::iterator it = mReleased.begin();
+        it != mReleased.end(); ++it)
+    {
+        delete (*it);
+    }
+    mReleased.clear();
+}
+
+ShaderProgram::ShaderProgram(const char* fragmentSource) :
+    mFragmentSource(fragmentSource),
+    mLastError(),
+    mProgram(0),
+    mBroken(false),
+    mTransformLocation(-1),
+    mOffsetLocation(-1),
+    mTexturedLocation(-1),
+    mAlphaTestLocation(-1),
+    mUVBaseLocation(-1),
+    mTextured(-1),
+    mAlphaTest(-1)
+{
+    mUVBase[0] = -1;
+    mUVBase[1] = mUVBase[2] = 0;
+    assert(fragmentSource);
+    mPrograms.push_back(this);
+}
+
+ShaderProgram::~ShaderProgram()
+{
+    Destroy();
+    std::vector<ShaderProgram*>::iterator it =
+        std::find(mPrograms.begin(), mPrograms.end(), this);
+    if(it != mPrograms.end())
+    {
+        mPrograms.erase(it);
+    }
+}
+
+void ShaderProgram::Release()
+{
+    mReleased.push_back(this);
+}
+
+void ShaderProgram::Destroy()
+{
+#if DINODECK_SHADERS
+    if(mProgram != 0)
+    {
+        glDeleteProgram(mProgram);
+        mProgram = 0;
+    }
+#endif
+}
+
+#if DINODECK_SHADERS
+static GLuint CompileShader(GLenum type, const char* source, std::string* outError)
+{
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+
+    GLint compiled = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if(!compiled)
+    {
+        char log[1024] = "";
+        glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+        *outError = log;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+#endif
+
+bool ShaderProgram::Build()
+{
+    Destroy();
+    mTextured = -1;
+    mAlphaTest = -1;
+    mUVBase[0] = -1;
+    for(std::map<std::string, Uniform>::iterator it = mUniforms.begin();
+        it != mUniforms.end(); ++it)
+    {
+        it->second.location = -2;
+    }
+
+#if DINODECK_SHADERS
+    if(!IsSupported())
+    {
+        mLastError = "Shaders need OpenGL 2.0.";
+        mBroken = true;
+        return false;
+    }
+
+    GLuint vertex = CompileShader(GL_VERTEX_SHADER, VertexSource, &mLastError);
+    GLuint fragment = CompileShader(GL_FRAGMENT_SHADER, mFragmentSource.c_str(), &mLastError);
+
+    if(vertex == 0 || fragment == 0)
+    {
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        mBroken = true;
+        return false;
+    }
+
+    mProgram = glCreateProgram();
+    glAttachShader(mProgram, vertex);
+    glAttachShader(mProgram, fragment);
+    glBindAttribLocation(mProgram, POSITION_ATTRIB, "aPosition");
+    glBindAttribLocation(mProgram, COLOUR_ATTRIB, "aColour");
+    glBindAttribLocation(mProgram, TEXCOORD_ATTRIB, "aTexCoord");
+    glBindAttribLocation(mProgram, SLOT_ATTRIB, "aSlot");
+    glLinkProgram(mProgram);
+
+    // The program keeps them until it's deleted.
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+
+    GLint linked = 0;
+    glGetProgramiv(mProgram, GL_LINK_STATUS, &linked);
+    if(!linked)
+    {
+        char log[1024] = "";
+        glGetProgramInfoLog(mProgram, sizeof(log), NULL, log);
+        mLastError = log;
+        Destroy();
+        mBroken = true;
+        return false;
+    }
+
+    mTransformLocation = glGetUniformLocation(mProgram, "uTransform");
+    mOffsetLocation = glGetUniformLocation(mProgram, "uOffset");
+    mTexturedLocation = glGetUniformLocation(mProgram, "uTextured");
+    mAlphaTestLocation = glGetUniformLocation(mProgram, "uAlphaTest");
+    mUVBaseLocation = glGetUniformLocation(mProgram, "uUVBase");
+
+    glUseProgram(mProgram);
+    glUniform1i(glGetUniformLocation(mProgram, "uTexture"), 0);
+    for(unsigned int i = 0; i < MAX_TEXTURE_SLOTS; i++)
+    {
+        char name[16];
+        sprintf(name, "uTexture%u", i);
+        glUniform1i(glGetUniformLocation(mProgram, name), i);
+    }
+    SetUVBase(1.0f / PackedVertex::UV_ONE, 0, 0);
+    glUseProgram(0);
+
+    mBroken = false;
+    return true;
+#else
+    mLastError = "Shaders aren't available on this platform.";
+    mBroken = true;
+    return false;
+#endif
+}
+
+bool ShaderProgram::Use()
+{
+#if DINODECK_SHADERS
+    if(mProgram == 0 && (mBroken || !Build()))
+    {
+        return false;
+    }
+
+    glUseProgram(mProgram);
+    ApplyUniforms();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ShaderProgram::UseNone()
+{
+#if DINODECK_SHADERS
+    glUseProgram(0);
+#endif
+}
+
+void ShaderProgram::SetTransform(const float* linear, float offsetX, float offsetY)
+{
+#if DINODECK_SHADERS
+    glUniform4f(mTransformLocation, linear[0], linear[1], linear[2], linear[3]);
+    glUniform2f(mOffsetLocation, offsetX, offsetY);
+#endif
+}
+
+void ShaderProgram::SetDrawState(bool textured, bool alphaTest)
+{
+#if DINODECK_SHADERS
+    float texturedValue = textured ? 1.0f : 0.0f;
+    float alphaTestValue = alphaTest ? 1.0f : 0.0f;
+
+    if(mTextured != texturedValue)
+    {
+        glUniform1f(mTexturedLocation, texturedValue);
+        mTextured = texturedValue;
+    }
+
+    if(mAlphaTest != alphaTestValue)
+    {
+        glUniform1f(mAlphaTestLocation, alphaTestValue);
+        mAlphaTest = alphaTestValue;
+    }
+#endif
+}
+
+void ShaderProgram::SetUVBase(float scale, float u, float v)
+{
+#if DINODECK_SHADERS
+    if(mUVBase[0] != scale || mUVBase[1] != u || mUVBase[2] != v)
+    {
+        glUniform3f(mUVBaseLocation, scale, u, v);
+        mUVBase[0] = scale;
+        mUVBase[1] = u;
+        mUVBase[2] = v;
+    }
+#endif
+}
+
+void ShaderProgram::SetUniform(const std::string& name, int count, const float* values)
+{
+    assert(count >= 1 && count <= 4);
+    std::map<std::string, Uniform>::iterator it = mUniforms.find(name);
+    if(it == mUniforms.end())
+    {
+        it = mUniforms.insert(std::make_pair(name, Uniform())).first;
+        it->second.location = -2;
+    }
+
+    Uniform& uniform = it->second;
+    uniform.count = count;
+    std::copy(values, values + count, uniform.values);
+}
+
+void ShaderProgram::ApplyUniforms()
+{
+#if DINODECK_SHADERS
+    for(std::map<std::string, Uniform>::iterator it = mUniforms.begin();
+        it != mUniforms.end(); ++it)
+    {
+        GLint& location = it->second.location;
+        if(location == -2)
+        {
+            location = glGetUniformLocation(mProgram, it->first.c_str());
+        }
+
+        const float* v = it->second.values;
+        switch(it->second.count)
+        {
+            case 1: glUniform1f(location, v[0]); break;
+            case 2: glUniform2f(location, v[0], v[1]); break;
+            case 3: glUniform3f(location, v[0], v[1], v[2]); break;
+            case 4: glUniform4f(location, v[0], v[1], v[2], v[3]); break;
+        }
+    }
+#endif
+}
\ No newline at end of file
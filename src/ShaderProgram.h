@@ -0,0 +1,107 @@
+#ifndef SHADERPROGRAM_H
+#define SHADERPROGRAM_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "DinodeckGL.h"
+#include "reflect/Reflect.h"
+
+class LuaState;
+
+//
+// A GLSL program for the pipeline's programmable path. Every program
+// shares the pipeline's vertex shader, scripts supply fragment shaders.
+// These get:
+//
+//   varying vec4 vColour;
+//   varying vec2 vTexCoord;
+//   uniform sampler2D uTexture;
+//   uniform float uTextured;  // 0 when drawing untextured
+//   uniform float uAlphaTest; // 1 for distance field text
+//
+// Programs made from SlotFragmentSource instead sample uTexture0 to
+// uTextureN-1, picked per vertex by vSlot, so one batch can mix textures.
+// Slot 255 is untextured.
+//
+// The camera is passed as a uniform so nothing touches the matrix stack.
+// Programs build when first used and again after the GL context is lost,
+// so the source is kept.
+//
+class ShaderProgram
+{
+    public: static Reflect Meta;
+    public:
+        static const char* DefaultFragmentSource;
+        static const unsigned int SLOT_ATTRIB = 3;
+        static const unsigned int MAX_TEXTURE_SLOTS = 8;
+
+        static std::string SlotFragmentSource(unsigned int slots);
+
+        static void Bind(LuaState* state);
+        static bool IsSupported();
+
+        // Forget every program id, they rebuild when next used.
+        // Call when the OpenGL context has been lost.
+        static void ResetAll();
+
+        // Programs Lua has collected may still be in the frame's commands,
+        // so they're deleted here once the frame is drawn.
+        static void CollectReleased();
+
+        ShaderProgram(const char* fragmentSource);
+        ~ShaderProgram();
+        void Release();
+
+        // Builds if needed and makes this the current program.
+        // False if it failed to build.
+        bool Use();
+        static void UseNone();
+
+        // Clip space x, y = linear * position + offset.
+        // linear is the 2x2 matrix row by row.
+        void SetTransform(const float* linear, float offsetX, float offsetY);
+        void SetDrawState(bool textured, bool alphaTest);
+        // Texture coords are packed * scale + (u, v).
+        void SetUVBase(float scale, float u, float v);
+
+        // Values are kept and applied whenever the program is used.
+        void SetUniform(const std::string& name, int count, const float* values);
+
+        bool Build();
+        const std::string& GetLastError() const { return mLastError; }
+    private:
+        struct Uniform
+        {
+            GLint location; // -2 until looked up in the built program
+            int count;
+            float values[4];
+        };
+
+        std::string mFragmentSource;
+        std::string mLastError;
+        GLuint mProgram;
+        bool mBroken; // don't retry a failed build every draw
+        GLint mTransformLocation;
+        GLint mOffsetLocation;
+        GLint mTexturedLocation;
+        GLint mAlphaTestLocation;
+        GLint mUVBaseLocation;
+        float mTextured; // last values set, -1 is unknown
+        float mAlphaTest;
+        float mUVBase[3]; // scale, u, v, a scale of -1 is unknown
+        std::map<std::string, Uniform> mUniforms;
+
+        static std::vector<ShaderProgram*> mPrograms;
+        static std::vector<ShaderProgram*> mReleased;
+
+        void Destroy();
+        void ApplyUniforms();
+
+        // Owns a GL program.
+        ShaderProgram(const ShaderProgram&);
+        ShaderProgram& operator=(const ShaderProgram&);
+};
+
+#endif
\ No newline at end of file
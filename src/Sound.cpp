@@ -1,25 +1,127 @@
 #include "Sound.h"
 
 #include <assert.h>
+#include <map>
 
 #include "DinodeckLua.h"
 #include "Dinodeck.h"
+#include "GraphicsPipeline.h"
 #include "LuaState.h"
 #include "DDLog.h"
+#include "Renderer.h"
+#include "Sprite.h"
+#include "Vector.h"
 
 Reflect Sound::Meta("Sound", Sound::Bind);
 
 //
-// number f(string name, bool loop = false)
+// A sound following a sprite. The registry reference keeps the sprite
+// alive, the serial notices the voice being reused by another sound.
+//
+struct Attachment
+{
+    Sprite* sprite;
+    int ref;
+    unsigned int serial;
+};
+
+static std::map<int, Attachment>& Attachments()
+{
+    static std::map<int, Attachment> attachments;
+    return attachments;
+}
+
+static Renderer* gListenRenderer = NULL;
+static int gListenRef = LUA_NOREF;
+
+static void Detach(lua_State* state, int soundId)
+{
+    std::map<int, Attachment>::iterator it = Attachments().find(soundId);
+    if(it != Attachments().end())
+    {
+        luaL_unref(state, LUA_REGISTRYINDEX, it->second.ref);
+        Attachments().erase(it);
+    }
+}
+
+void Sound::Update(lua_State* state)
+{
+    DDAudio* audio = Dinodeck::GetInstance()->GetAudio();
+
+    std::map<int, Attachment>::iterator it = Attachments().begin();
+    while(it != Attachments().end())
+    {
+        if(audio->VoiceSerial(it->first) != it->second.serial)
+        {
+            luaL_unref(state, LUA_REGISTRYINDEX, it->second.ref);
+            Attachments().erase(it++);
+            continue;
+        }
+
+        const Vector& position = it->second.sprite->GetPosition();
+        audio->SetPosition(it->first, (float) position.x, (float) position.y);
+        ++it;
+    }
+
+    if(gListenRenderer)
+    {
+        // The world point in the middle of the screen.
+        GraphicsPipeline* graphics = gListenRenderer->Graphics();
+        const Vector& position = graphics->CameraPosition();
+        const Vector& scale = graphics->CameraScale();
+        const float x = (scale.x == 0) ? 0 : (float)(-position.x / scale.x);
+        const float y = (scale.y == 0) ? 0 : (float)(-position.y / scale.y);
+        audio->SetListener(x, y);
+    }
+}
+
+void Sound::Reset()
+{
+    Attachments().clear();
+    gListenRenderer = NULL;
+    gListenRef = LUA_NOREF;
+}
+
+//
+// number f(string name)
+// Returns a handle to pass to Play instead of the name, or nil.
+//
+static int lua_Sound_Find(lua_State* state)
+{
+    const char* soundName = luaL_checkstring(state, 1);
+    int handle = Dinodeck::GetInstance()->GetAudio()->FindSound(soundName);
+    if(handle == -1)
+    {
+        lua_pushnil(state);
+        return 1;
+    }
+    lua_pushinteger(state, handle);
+    return 1;
+}
+
+//
+// bool f(string name)
+// Starts an ondemand sound loading, so it's ready to play in a frame or
+// two. Played before then it's skipped. False if there's no such sound.
+//
+static int lua_Sound_Preload(lua_State* state)
+{
+    const char* soundName = luaL_checkstring(state, 1);
+    lua_pushboolean(state, Dinodeck::GetInstance()->GetAudio()->Preload(soundName));
+    return 1;
+}
+
+//
+// number f(string name | handle, bool loop = false)
 // Returns an id for the sound being played.
 //
 static int lua_Sound_Play(lua_State* state)
 {
+    // lua_isstring is true of numbers as well.
     if(!lua_isstring(state, 1))
     {
-        return luaL_typerror(state, 1, "string");
+        return luaL_typerror(state, 1, "string or handle");
     }
-    const char* soundName = lua_tostring(state, 1);
 
     bool looping = false;
     if(lua_isboolean(state, 2))
@@ -28,7 +130,15 @@ static int lua_Sound_Play(lua_State* state)
     }
 
     Dinodeck* dd = Dinodeck::GetInstance();
-    int soundId = dd->GetAudio()->Play(soundName, looping);
+    int soundId = -1;
+    if(lua_type(state, 1) == LUA_TNUMBER)
+    {
+        soundId = dd->GetAudio()->Play((int) lua_tointeger(state, 1), looping);
+    }
+    else
+    {
+        soundId = dd->GetAudio()->Play(lua_tostring(state, 1), looping);
+    }
 
     lua_pushnumber(state, soundId);
 
@@ -94,15 +204,228 @@ static int lua_Sound_SetVolume(lua_State* state)
     return 0;
 }
 
+//
+// f(string bus, number volume)
+//
+static int lua_Sound_SetBusVolume(lua_State* state)
+{
+    const char* bus = luaL_checkstring(state, 1);
+    float volume = (float) luaL_checknumber(state, 2);
+    Dinodeck::GetInstance()->GetAudio()->SetBusVolume(bus, volume);
+    return 0;
+}
+
+//
+// number f(string bus)
+//
+static int lua_Sound_GetBusVolume(lua_State* state)
+{
+    const char* bus = luaL_checkstring(state, 1);
+    lua_pushnumber(state, Dinodeck::GetInstance()->GetAudio()->GetBusVolume(bus));
+    return 1;
+}
+
+//
+// f(string bus, number volume, number seconds = 0)
+// Fades the bus to the volume e.g. music under dialogue, 1 restores it.
+//
+static int lua_Sound_Duck(lua_State* state)
+{
+    const char* bus = luaL_checkstring(state, 1);
+    float volume = (float) luaL_checknumber(state, 2);
+    float seconds = (float) luaL_optnumber(state, 3, 0);
+    Dinodeck::GetInstance()->GetAudio()->Duck(bus, volume, seconds);
+    return 0;
+}
+
+//
+// number f()
+// Seconds from playing a sound to hearing it, -1 if unknown.
+//
+static int lua_Sound_GetLatency(lua_State* state)
+{
+    lua_pushnumber(state, Dinodeck::GetInstance()->GetAudio()->GetOutputLatency());
+    return 1;
+}
+
+//
+// f(number id, number x, number y | Vector position)
+//
+static int lua_Sound_SetPosition(lua_State* state)
+{
+    int soundId = luaL_checkint(state, 1);
+    float x = 0;
+    float y = 0;
+    if(LuaState::IsType<Vector>(state, 2))
+    {
+        Vector* position = LuaState::GetFuncParam<Vector>(state, 2);
+        x = (float) position->x;
+        y = (float) position->y;
+    }
+    else
+    {
+        x = (float) luaL_checknumber(state, 2);
+        y = (float) luaL_checknumber(state, 3);
+    }
+
+    Detach(state, soundId);
+    Dinodeck::GetInstance()->GetAudio()->SetPosition(soundId, x, y);
+    return 0;
+}
+
+//
+// f(number id, Sprite sprite)
+// The sound follows the sprite until it stops.
+//
+static int lua_Sound_Attach(lua_State* state)
+{
+    int soundId = luaL_checkint(state, 1);
+    Sprite* sprite = LuaState::GetFuncParam<Sprite>(state, 2);
+    if(sprite == NULL)
+    {
+        return luaL_typerror(state, 2, "Sprite");
+    }
+
+    DDAudio* audio = Dinodeck::GetInstance()->GetAudio();
+    unsigned int serial = audio->VoiceSerial(soundId);
+    Detach(state, soundId);
+    if(serial == 0)
+    {
+        return 0; // already finished
+    }
+
+    lua_pushvalue(state, 2);
+    Attachment attachment;
+    attachment.sprite = sprite;
+    attachment.ref = luaL_ref(state, LUA_REGISTRYINDEX);
+    attachment.serial = serial;
+    Attachments()[soundId] = attachment;
+
+    const Vector& position = sprite->GetPosition();
+    audio->SetPosition(soundId, (float) position.x, (float) position.y);
+    return 0;
+}
+
+static int lua_Sound_Detach(lua_State* state)
+{
+    Detach(state, luaL_checkint(state, 1));
+    return 0;
+}
+
+//
+// f(number x, number y)
+// Stops following a renderer's camera.
+//
+static int lua_Sound_SetListener(lua_State* state)
+{
+    float x = (float) luaL_checknumber(state, 1);
+    float y = (float) luaL_checknumber(state, 2);
+    luaL_unref(state, LUA_REGISTRYINDEX, gListenRef);
+    gListenRef = LUA_NOREF;
+    gListenRenderer = NULL;
+    Dinodeck::GetInstance()->GetAudio()->SetListener(x, y);
+    return 0;
+}
+
+//
+// f(Renderer renderer | nil)
+// The listener follows the middle of the renderer's view.
+//
+static int lua_Sound_ListenTo(lua_State* state)
+{
+    luaL_unref(state, LUA_REGISTRYINDEX, gListenRef);
+    gListenRef = LUA_NOREF;
+    gListenRenderer = NULL;
+
+    if(lua_isnoneornil(state, 1))
+    {
+        return 0;
+    }
+
+    Renderer* renderer = LuaState::GetFuncParam<Renderer>(state, 1);
+    if(renderer == NULL)
+    {
+        return luaL_typerror(state, 1, "Renderer");
+    }
+
+    lua_pushvalue(state, 1);
+    gListenRef = luaL_ref(state, LUA_REGISTRYINDEX);
+    gListenRenderer = renderer;
+    return 0;
+}
+
+//
+// f(number reference, number max)
+// Positional sounds are full volume within reference of the listener and
+// fade out to silent at max.
+//
+static int lua_Sound_SetDistances(lua_State* state)
+{
+    float reference = (float) luaL_checknumber(state, 1);
+    float max = (float) luaL_checknumber(state, 2);
+    Dinodeck::GetInstance()->GetAudio()->SetDistances(reference, max);
+    return 0;
+}
+
+static void SetField(lua_State* state, const char* name, double value)
+{
+    lua_pushnumber(state, value);
+    lua_setfield(state, -2, name);
+}
+
+//
+// table f()
+// Counts since the last ResetStats and play timings in milliseconds.
+//
+static int lua_Sound_Stats(lua_State* state)
+{
+    DDAudio::Stats stats;
+    Dinodeck::GetInstance()->GetAudio()->GetStats(&stats);
+
+    lua_newtable(state);
+    SetField(state, "plays", stats.plays);
+    SetField(state, "dropped", stats.dropped);
+    SetField(state, "steals", stats.steals);
+    SetField(state, "stream_underruns", stats.streamUnderruns);
+    SetField(state, "load_misses", stats.loadMisses);
+    SetField(state, "unloads", stats.unloads);
+    SetField(state, "last_start_ms", stats.lastStartMicroseconds / 1000.0);
+    SetField(state, "last_consume_ms", stats.lastConsumeMicroseconds / 1000.0);
+    SetField(state, "average_consume_ms", stats.averageConsumeMicroseconds / 1000.0);
+    SetField(state, "max_consume_ms", stats.maxConsumeMicroseconds / 1000.0);
+    SetField(state, "output_latency_ms",
+             stats.outputLatency < 0 ? -1 : stats.outputLatency * 1000.0);
+    return 1;
+}
+
+static int lua_Sound_ResetStats(lua_State* state)
+{
+    Dinodeck::GetInstance()->GetAudio()->ResetStats();
+    return 0;
+}
 
 static const struct luaL_reg luaBinding [] =
 {
  // {"Create", Vector::lua_Vector_Create},
+    {"Find", lua_Sound_Find},
+    {"Preload", lua_Sound_Preload},
     {"Play", lua_Sound_Play},
     {"Stop", lua_Sound_Stop},
     {"Pause", lua_Sound_Pause},
     {"Resume", lua_Sound_Resume},
     {"SetVolume", lua_Sound_SetVolume},
+    {"SetBusVolume", lua_Sound_SetBusVolume},
+    {"GetBusVolume", lua_Sound_GetBusVolume},
+    {"Duck", lua_Sound_Duck},
+    {"GetLatency", lua_Sound_GetLatency},
+    {"SetPosition", lua_Sound_SetPosition},
+    {"Attach", lua_Sound_Attach},
+    {"Detach", lua_Sound_Detach},
+    {"SetListener", lua_Sound_SetListener},
+    {"ListenTo", lua_Sound_ListenTo},
+    {"SetDistances", lua_Sound_SetDistances},
+    {"Stats", lua_Sound_Stats},
+    {"ResetStats", lua_Sound_ResetStats},
     {NULL, NULL}  /* sentinel */
 };
 
@@ -9,6 +9,7 @@
 #include "DDAudio.h"
 
 class LuaState;
+struct lua_State;
 
 class Sound
 {
@@ -17,6 +18,11 @@ private:
     static DDAudio Audio;
 public:
     static void Bind(LuaState* state);
+    // Moves sounds attached to sprites and the listener following a
+    // renderer's camera, once a frame after the game's update.
+    static void Update(lua_State* state);
+    // Forgets attachments, their Lua references go with the state.
+    static void Reset();
 };
 
 #endif
@@ -29,6 +29,37 @@ int lua_SoundStream_Play(lua_State* state)
     return 1;
 }
 
+//
+// SoundStream.Queue(id, name, [loop])
+// name plays on, under the same id, once the stream's track is done.
+//
+int lua_SoundStream_Queue(lua_State* state)
+{
+    int streamId = luaL_checkint(state, 1);
+    const char* soundName = luaL_checkstring(state, 2);
+    bool looping = lua_toboolean(state, 3);
+
+    Dinodeck* dd = Dinodeck::GetInstance();
+    lua_pushboolean(state, dd->GetAudio()->QueueStream(streamId, soundName, looping));
+    return 1;
+}
+
+//
+// SoundStream.CrossFade(id, name, seconds, [loop])
+// Fades the stream out and name in, returns name's stream id.
+//
+int lua_SoundStream_CrossFade(lua_State* state)
+{
+    int streamId = luaL_checkint(state, 1);
+    const char* soundName = luaL_checkstring(state, 2);
+    float seconds = (float) luaL_checknumber(state, 3);
+    bool looping = lua_toboolean(state, 4);
+
+    Dinodeck* dd = Dinodeck::GetInstance();
+    lua_pushnumber(state, dd->GetAudio()->CrossFadeStream(streamId, soundName, seconds, looping));
+    return 1;
+}
+
 int lua_SoundStream_Stop(lua_State* state)
 {
     if(!lua_isnumber(state, 1))
@@ -93,6 +124,8 @@ static const struct luaL_reg luaBinding [] =
  // {"Create", Vector::lua_Vector_Create},
     {"Play", lua_SoundStream_Play},
     {"Stop", lua_SoundStream_Stop},
+    {"Queue", lua_SoundStream_Queue},
+    {"CrossFade", lua_SoundStream_CrossFade},
     {"Pause", lua_SoundStream_Pause},
     {"Resume", lua_SoundStream_Resume},
     {"SetVolume", lua_SoundStream_SetVolume},
@@ -0,0 +1,485 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
+
+#include "DinodeckLua.h"
+#include "LuaState.h"
+
+Reflect SpatialGrid::Meta("SpatialGrid", SpatialGrid::Bind);
+
+static bool Overlaps(const SpatialGrid::Box& a, const SpatialGrid::Box& b)
+{
+    return a.minX <= b.maxX && b.minX <= a.maxX
+        && a.minY <= b.maxY && b.minY <= a.maxY;
+}
+
+SpatialGrid::SpatialGrid(float cellSize, unsigned int buckets) :
+    mCellSize(cellSize),
+    mStamp(0)
+{
+    unsigned int size = 1;
+    while(size < buckets)
+    {
+        size *= 2;
+    }
+    mMask = size - 1;
+    mBuckets.resize(size);
+}
+
+int SpatialGrid::Cell(float value) const
+{
+    // Clamped so far away boxes don't overflow into the wrong cells.
+    const float cell = floorf(value / mCellSize);
+    return (int) std::max(-1.0e9f, std::min(cell, 1.0e9f));
+}
+
+unsigned int SpatialGrid::Bucket(int cellX, int cellY) const
+{
+    return (((unsigned int) cellX * 73856093u) ^ ((unsigned int) cellY * 19349663u)) & mMask;
+}
+
+void SpatialGrid::Link(unsigned int index)
+{
+    Entry& entry = mEntries[index];
+    entry.cellX0 = Cell(entry.box.minX);
+    entry.cellY0 = Cell(entry.box.minY);
+    entry.cellX1 = Cell(entry.box.maxX);
+    entry.cellY1 = Cell(entry.box.maxY);
+
+    const double cells = ((double) entry.cellX1 - entry.cellX0 + 1)
+                       * ((double) entry.cellY1 - entry.cellY0 + 1);
+    entry.oversized = cells > MAX_CELLS;
+    if(entry.oversized)
+    {
+        mOversized.push_back(index);
+        return;
+    }
+
+    for(int y = entry.cellY0; y <= entry.cellY1; y++)
+    {
+        for(int x = entry.cellX0; x <= entry.cellX1; x++)
+        {
+            std::vector<unsigned int>& bucket = mBuckets[Bucket(x, y)];
+            // Cells hashing together would add it twice.
+            if(std::find(bucket.begin(), bucket.end(), index) == bucket.end())
+            {
+                bucket.push_back(index);
+            }
+        }
+    }
+}
+
+static void EraseFrom(std::vector<unsigned int>& list, unsigned int value)
+{
+    std::vector<unsigned int>::iterator it = std::find(list.begin(), list.end(), value);
+    if(it != list.end())
+    {
+        *it = list.back();
+        list.pop_back();
+    }
+}
+
+void SpatialGrid::Unlink(unsigned int index)
+{
+    const Entry& entry = mEntries[index];
+    if(entry.oversized)
+    {
+        EraseFrom(mOversized, index);
+        return;
+    }
+
+    for(int y = entry.cellY0; y <= entry.cellY1; y++)
+    {
+        for(int x = entry.cellX0; x <= entry.cellX1; x++)
+        {
+            EraseFrom(mBuckets[Bucket(x, y)], index);
+        }
+    }
+}
+
+void SpatialGrid::Insert(int id, const Box& box)
+{
+    std::map<int, unsigned int>::iterator it = mIds.find(id);
+    unsigned int index = 0;
+    if(it != mIds.end())
+    {
+        index = it->second;
+        Unlink(index);
+    }
+    else
+    {
+        if(mFree.empty())
+        {
+            index = mEntries.size();
+            mEntries.push_back(Entry());
+        }
+        else
+        {
+            index = mFree.back();
+            mFree.pop_back();
+        }
+        mIds[id] = index;
+        mEntries[index].stamp = mStamp;
+    }
+
+    Entry& entry = mEntries[index];
+    entry.id = id;
+    entry.box.minX = std::min(box.minX, box.maxX);
+    entry.box.maxX = std::max(box.minX, box.maxX);
+    entry.box.minY = std::min(box.minY, box.maxY);
+    entry.box.maxY = std::max(box.minY, box.maxY);
+    Link(index);
+}
+
+void SpatialGrid::Remove(int id)
+{
+    std::map<int, unsigned int>::iterator it = mIds.find(id);
+    if(it == mIds.end())
+    {
+        return;
+    }
+    Unlink(it->second);
+    mFree.push_back(it->second);
+    mIds.erase(it);
+}
+
+void SpatialGrid::Clear()
+{
+    for(unsigned int i = 0; i < mBuckets.size(); i++)
+    {
+        mBuckets[i].clear();
+    }
+    mEntries.clear();
+    mFree.clear();
+    mOversized.clear();
+    mIds.clear();
+}
+
+void SpatialGrid::Gather(const Box& box)
+{
+    mFound.clear();
+    mStamp++;
+    if(mStamp == 0)
+    {
+        // Wrapped, old stamps could match again.
+        for(unsigned int i = 0; i < mEntries.size(); i++)
+        {
+            mEntries[i].stamp = 0;
+        }
+        mStamp = 1;
+    }
+
+    for(unsigned int i = 0; i < mOversized.size(); i++)
+    {
+        mEntries[mOversized[i]].stamp = mStamp;
+        mFound.push_back(mOversized[i]);
+    }
+
+    const int x0 = Cell(box.minX);
+    const int y0 = Cell(box.minY);
+    const int x1 = Cell(box.maxX);
+    const int y1 = Cell(box.maxY);
+    const double cells = ((double) x1 - x0 + 1) * ((double) y1 - y0 + 1);
+
+    if(cells > mBuckets.size())
+    {
+        // Bigger than the table, every entry is a candidate.
+        for(std::map<int, unsigned int>::iterator it = mIds.begin(); it != mIds.end(); ++it)
+        {
+            Entry& entry = mEntries[it->second];
+            if(entry.stamp != mStamp)
+            {
+                entry.stamp = mStamp;
+                mFound.push_back(it->second);
+            }
+        }
+        return;
+    }
+
+    for(int y = y0; y <= y1; y++)
+    {
+        for(int x = x0; x <= x1; x++)
+        {
+            const std::vector<unsigned int>& bucket = mBuckets[Bucket(x, y)];
+            for(unsigned int i = 0; i < bucket.size(); i++)
+            {
+                Entry& entry = mEntries[bucket[i]];
+                if(entry.stamp != mStamp)
+                {
+                    entry.stamp = mStamp;
+                    mFound.push_back(bucket[i]);
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::QueryRect(const Box& box, std::vector<int>* out)
+{
+    Gather(box);
+    for(unsigned int i = 0; i < mFound.size(); i++)
+    {
+        const Entry& entry = mEntries[mFound[i]];
+        if(Overlaps(entry.box, box))
+        {
+            out->push_back(entry.id);
+        }
+    }
+}
+
+void SpatialGrid::QueryCircle(float x, float y, float radius, std::vector<int>* out)
+{
+    Box bounds = { x - radius, y - radius, x + radius, y + radius };
+    Gather(bounds);
+    const float radius2 = radius * radius;
+    for(unsigned int i = 0; i < mFound.size(); i++)
+    {
+        const Entry& entry = mEntries[mFound[i]];
+        // Distance to the nearest point of the box.
+        const float dx = x - std::max(entry.box.minX, std::min(x, entry.box.maxX));
+        const float dy = y - std::max(entry.box.minY, std::min(y, entry.box.maxY));
+        if(dx * dx + dy * dy <= radius2)
+        {
+            out->push_back(entry.id);
+        }
+    }
+}
+
+void SpatialGrid::QueryPairs(std::vector<int>* out)
+{
+    // Each entry looks at its neighbours with higher indices, so every
+    // pair comes up once.
+    for(std::map<int, unsigned int>::iterator it = mIds.begin(); it != mIds.end(); ++it)
+    {
+        const unsigned int index = it->second;
+        const Box box = mEntries[index].box;
+        Gather(box);
+        for(unsigned int i = 0; i < mFound.size(); i++)
+        {
+            const unsigned int other = mFound[i];
+            if(other > index && Overlaps(mEntries[other].box, box))
+            {
+                out->push_back(mEntries[index].id);
+                out->push_back(mEntries[other].id);
+            }
+        }
+    }
+}
+
+//
+// Results go in the table at index, if there is one, so scripts can reuse
+// a table a frame.
+//
+int SpatialGrid::PushIds(lua_State* state, int index, const std::vector<int>& ids)
+{
+    if(lua_istable(state, index))
+    {
+        lua_pushvalue(state, index);
+    }
+    else
+    {
+        lua_createtable(state, ids.size(), 0);
+    }
+
+    for(unsigned int i = 0; i < ids.size(); i++)
+    {
+        lua_pushinteger(state, ids[i]);
+        lua_rawseti(state, -2, i + 1);
+    }
+
+    // Clear what's left from the last time the table was used.
+    for(int i = ids.size() + 1; ; i++)
+    {
+        lua_rawgeti(state, -1, i);
+        const bool present = !lua_isnil(state, -1);
+        lua_pop(state, 1);
+        if(!present)
+        {
+            break;
+        }
+        lua_pushnil(state);
+        lua_rawseti(state, -2, i);
+    }
+
+    lua_pushinteger(state, ids.size());
+    return 2;
+}
+
+static SpatialGrid::Box CheckBox(lua_State* state, int index)
+{
+    SpatialGrid::Box box;
+    box.minX = (float) luaL_checknumber(state, index);
+    box.minY = (float) luaL_checknumber(state, index + 1);
+    box.maxX = (float) luaL_checknumber(state, index + 2);
+    box.maxY = (float) luaL_checknumber(state, index + 3);
+    return box;
+}
+
+// SpatialGrid.Create(cellSize, [buckets])
+static int lua_SpatialGrid_Create(lua_State* state)
+{
+    double cellSize = luaL_checknumber(state, 1);
+    if(!(cellSize > 0))
+    {
+        return luaL_argerror(state, 1, "cell size must be above 0");
+    }
+    int buckets = luaL_optinteger(state, 2, SpatialGrid::DEFAULT_BUCKETS);
+    buckets = std::max(1, std::min(buckets, 1 << 20));
+
+    new (lua_newuserdata(state, sizeof(SpatialGrid))) SpatialGrid((float) cellSize, buckets);
+    luaL_getmetatable(state, "SpatialGrid");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_SpatialGrid_gc(lua_State* state)
+{
+    SpatialGrid* grid = (SpatialGrid*)lua_touserdata(state, 1);
+    assert(grid);
+    grid->~SpatialGrid();
+    return 0;
+}
+
+static int lua_SpatialGrid_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "SpatialGrid");
+    return 1;
+}
+
+// grid:Insert(id, minX, minY, maxX, maxY)
+static int lua_SpatialGrid_Insert(lua_State* state)
+{
+    SpatialGrid* grid = LuaState::GetFuncParam<SpatialGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    grid->Insert(luaL_checkinteger(state, 2), CheckBox(state, 3));
+    return 0;
+}
+
+static int lua_SpatialGrid_Remove(lua_State* state)
+{
+    SpatialGrid* grid = LuaState::GetFuncParam<SpatialGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    grid->Remove(luaL_checkinteger(state, 2));
+    return 0;
+}
+
+static int lua_SpatialGrid_Clear(lua_State* state)
+{
+    SpatialGrid* grid = LuaState::GetFuncParam<SpatialGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    grid->Clear();
+    return 0;
+}
+
+static int lua_SpatialGrid_GetCount(lua_State* state)
+{
+    SpatialGrid* grid = LuaState::GetFuncParam<SpatialGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    lua_pushinteger(state, grid->Count());
+    return 1;
+}
+
+// Results are copied into Lua straight away, so the queries share one
+// vector rather than allocating each call.
+static std::vector<int>& QueryResults()
+{
+    static std::vector<int> ids;
+    ids.clear();
+    return ids;
+}
+
+// grid:QueryRect(minX, minY, maxX, maxY, [out]) returns ids, count
+static int lua_SpatialGrid_QueryRect(lua_State* state)
+{
+    SpatialGrid* grid = LuaState::GetFuncParam<SpatialGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    std::vector<int>& ids = QueryResults();
+    grid->QueryRect(CheckBox(state, 2), &ids);
+    return SpatialGrid::PushIds(state, 6, ids);
+}
+
+// grid:QueryCircle(x, y, radius, [out]) returns ids, count
+static int lua_SpatialGrid_QueryCircle(lua_State* state)
+{
+    SpatialGrid* grid = LuaState::GetFuncParam<SpatialGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    std::vector<int>& ids = QueryResults();
+    grid->QueryCircle((float) luaL_checknumber(state, 2),
+                      (float) luaL_checknumber(state, 3),
+                      (float) luaL_checknumber(state, 4),
+                      &ids);
+    return SpatialGrid::PushIds(state, 5, ids);
+}
+
+// grid:QueryPoint(x, y, [out]) returns ids, count
+static int lua_SpatialGrid_QueryPoint(lua_State* state)
+{
+    SpatialGrid* grid = LuaState::GetFuncParam<SpatialGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    const float x = (float) luaL_checknumber(state, 2);
+    const float y = (float) luaL_checknumber(state, 3);
+    SpatialGrid::Box point = { x, y, x, y };
+    std::vector<int>& ids = QueryResults();
+    grid->QueryRect(point, &ids);
+    return SpatialGrid::PushIds(state, 4, ids);
+}
+
+// grid:QueryPairs([out]) returns a flat a1, b1, a2, b2... list, count
+static int lua_SpatialGrid_QueryPairs(lua_State* state)
+{
+    SpatialGrid* grid = LuaState::GetFuncParam<SpatialGrid>(state, 1);
+    if(grid == NULL)
+    {
+        return 0;
+    }
+    std::vector<int>& ids = QueryResults();
+    grid->QueryPairs(&ids);
+    return SpatialGrid::PushIds(state, 2, ids);
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_SpatialGrid_Create},
+  {"__gc", lua_SpatialGrid_gc},
+  {"__tostring", lua_SpatialGrid_tostring},
+  {"Insert", lua_SpatialGrid_Insert},
+  {"Remove", lua_SpatialGrid_Remove},
+  {"Clear", lua_SpatialGrid_Clear},
+  {"GetCount", lua_SpatialGrid_GetCount},
+  {"QueryRect", lua_SpatialGrid_QueryRect},
+  {"QueryCircle", lua_SpatialGrid_QueryCircle},
+  {"QueryPoint", lua_SpatialGrid_QueryPoint},
+  {"QueryPairs", lua_SpatialGrid_QueryPairs},
+  {NULL, NULL}  /* sentinel */
+};
+
+void SpatialGrid::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        SpatialGrid::Meta.Name(),
+        luaBinding
+    );
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <map>
+#include <vector>
+
+#include "reflect/Reflect.h"
+
+class LuaState;
+struct lua_State;
+
+//
+// A broadphase for collision and picking. Scripts put ids in with their
+// bounding boxes and ask which overlap a rect, circle or point, or which
+// pairs overlap each other.
+//
+// Space is cut into square cells, hashed into a fixed number of buckets,
+// so the grid is unbounded and its memory doesn't grow with the world.
+// Boxes covering more than MAX_CELLS cells are kept to one side and
+// checked by every query.
+//
+// Anything fast moving is cheapest cleared and put back in each frame.
+//
+class SpatialGrid
+{
+    public: static Reflect Meta;
+    public:
+        static const unsigned int DEFAULT_BUCKETS = 4096; // power of two
+        static const unsigned int MAX_CELLS = 64;
+
+        struct Box
+        {
+            float minX, minY, maxX, maxY;
+        };
+
+        static void Bind(LuaState* state);
+        // Puts the ids in the table at index, or a new one if there isn't
+        // one there, clearing any left over from before. Pushes the table
+        // and the count.
+        static int PushIds(lua_State* state, int index, const std::vector<int>& ids);
+
+        SpatialGrid(float cellSize, unsigned int buckets);
+
+        // Inserting an id that's already in moves it.
+        void Insert(int id, const Box& box);
+        void Remove(int id);
+        void Clear();
+        unsigned int Count() const { return mIds.size(); }
+
+        // Appends the ids whose boxes touch the shape, each once.
+        void QueryRect(const Box& box, std::vector<int>* out);
+        void QueryCircle(float x, float y, float radius, std::vector<int>* out);
+        // Appends id pairs, two ints a pair, each overlapping pair once.
+        void QueryPairs(std::vector<int>* out);
+    private:
+        struct Entry
+        {
+            int id;
+            Box box;
+            int cellX0, cellY0, cellX1, cellY1;
+            bool oversized;
+            unsigned int stamp; // last query that saw it
+        };
+
+        float mCellSize;
+        unsigned int mMask;
+        std::vector< std::vector<unsigned int> > mBuckets; // of entries
+        std::vector<Entry> mEntries;
+        std::vector<unsigned int> mFree;
+        std::vector<unsigned int> mOversized;
+        std::map<int, unsigned int> mIds;
+        std::vector<unsigned int> mFound;
+        unsigned int mStamp;
+
+        int Cell(float value) const;
+        unsigned int Bucket(int cellX, int cellY) const;
+        void Link(unsigned int entry);
+        void Unlink(unsigned int entry);
+        // Fills mFound with the entries whose boxes may touch box.
+        void Gather(const Box& box);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "SplashScreen.h"
+
+#include <algorithm>
+
+#include "DDLog.h"
+#include "DDTime.h"
+#include "IScreenChangeListener.h"
+#include "soil.h"
+#include "Texture.h"
+
+static const float BAR_HEIGHT = 6;
+static const float BAR_MARGIN = 24;
+
+SplashScreen::SplashScreen(int displayWidth,
+                           int displayHeight,
+                           float red, float green, float blue,
+                           bool bar,
+                           IScreenChangeListener* presenter) :
+    mTexture(0),
+    mImageWidth(0),
+    mImageHeight(0),
+    mDisplayWidth(displayWidth),
+    mDisplayHeight(displayHeight),
+    mBar(bar),
+    mPresenter(presenter),
+    mLastPresent(0)
+{
+    mClear[0] = red;
+    mClear[1] = green;
+    mClear[2] = blue;
+}
+
+SplashScreen::~SplashScreen()
+{
+    if(mTexture != 0)
+    {
+        glDeleteTextures(1, &mTexture);
+    }
+}
+
+bool SplashScreen::Load(const char* path)
+{
+    int channels = 0;
+    unsigned char* pixels = Texture::LoadPixels(path,
+                                                &mImageWidth,
+                                                &mImageHeight,
+                                                &channels,
+                                                SOIL_LOAD_RGBA);
+    if(pixels == NULL)
+    {
+        dsprintf("Splash [%s] couldn't be read.\n", path);
+        return false;
+    }
+
+    glGenTextures(1, &mTexture);
+    glBindTexture(GL_TEXTURE_2D, mTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mImageWidth, mImageHeight, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    SOIL_free_image_data(pixels);
+    return true;
+}
+
+void SplashScreen::DrawQuad(float x, float y, float width, float height, bool textured)
+{
+    const GLfloat positions[] =
+    {
+        x, y,
+        x + width, y,
+        x, y + height,
+        x + width, y + height
+    };
+    // The image's first row is its top.
+    const GLfloat texcoords[] =
+    {
+        0, 1,
+        1, 1,
+        0, 0,
+        1, 0
+    };
+
+    glVertexPointer(2, GL_FLOAT, 0, positions);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    if(textured)
+    {
+        glTexCoordPointer(2, GL_FLOAT, 0, texcoords);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    }
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+void SplashScreen::Show(float progress)
+{
+    const float width = (float) mDisplayWidth;
+    const float height = (float) mDisplayHeight;
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glViewport(0, 0, mDisplayWidth, mDisplayHeight);
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrthof(0, width, 0, height, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    glClearColor(mClear[0], mClear[1], mClear[2], 0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    if(mTexture != 0 && mImageWidth > 0 && mImageHeight > 0)
+    {
+        // Fit, never cropped.
+        const float scale = std::min(width / mImageWidth, height / mImageHeight);
+        const float w = mImageWidth * scale;
+        const float h = mImageHeight * scale;
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, mTexture);
+        glColor4f(1, 1, 1, 1);
+        DrawQuad((width - w) / 2, (height - h) / 2, w, h, true);
+        glDisable(GL_TEXTURE_2D);
+    }
+
+    if(mBar)
+    {
+        progress = std::max(0.0f, std::min(progress, 1.0f));
+        const float barWidth = width - BAR_MARGIN * 2;
+        glColor4f(1, 1, 1, 0.25f);
+        DrawQuad(BAR_MARGIN, BAR_MARGIN, barWidth, BAR_HEIGHT, false);
+        glColor4f(1, 1, 1, 1);
+        DrawQuad(BAR_MARGIN, BAR_MARGIN, barWidth * progress, BAR_HEIGHT, false);
+    }
+
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+
+    if(mPresenter)
+    {
+        mPresenter->OnPresent();
+    }
+    mLastPresent = DDTime::Microseconds();
+}
+
+void SplashScreen::OnReloadProgress(unsigned int done, unsigned int total)
+{
+    const unsigned long long now = DDTime::Microseconds();
+    if(!mBar || total == 0 || now - mLastPresent < PRESENT_MICROSECONDS)
+    {
+        return;
+    }
+    Show((float) done / total);
+}
\ No newline at end of file
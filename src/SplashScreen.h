@@ -0,0 +1,48 @@
+#ifndef SPLASHSCREEN_H
+#define SPLASHSCREEN_H
+
+#include "DinodeckGL.h"
+#include "IReloadProgress.h"
+
+class IScreenChangeListener;
+
+//
+// Drawn straight to the window on a cold start, before the manifest
+// loads, so the first frames aren't black. The image is fit to the window
+// over the clear colour, the bar along the bottom follows the manifest
+// load. Presented through the screen change listener, a platform without
+// one shows it on its first frame.
+//
+class SplashScreen : public IReloadProgress
+{
+    GLuint mTexture;
+    int mImageWidth;
+    int mImageHeight;
+    int mDisplayWidth;
+    int mDisplayHeight;
+    float mClear[3];
+    bool mBar;
+    IScreenChangeListener* mPresenter;
+    unsigned long long mLastPresent;
+
+    void DrawQuad(float x, float y, float width, float height, bool textured);
+public:
+    // A redraw while loading waits at least this long after the last.
+    static const unsigned int PRESENT_MICROSECONDS = 33000;
+
+    SplashScreen(int displayWidth,
+                 int displayHeight,
+                 float red, float green, float blue,
+                 bool bar,
+                 IScreenChangeListener* presenter);
+    ~SplashScreen();
+
+    // False, with a log line, if the image can't be read. The bar still shows.
+    bool Load(const char* path);
+    // Draws and presents it now.
+    void Show(float progress);
+
+    virtual void OnReloadProgress(unsigned int done, unsigned int total);
+};
+
+#endif
\ No newline at end of file
@@ -3,8 +3,12 @@
 #include <string>
 #include <assert.h>
 
+#include "Animation.h"
+#include "Dinodeck.h"
 #include "DinodeckGL.h"
 #include "DinodeckLua.h"
+#include "LuaBind.h"
+#include "LuaFFI.h"
 #include "LuaState.h"
 #include "Texture.h"
 
@@ -38,7 +42,7 @@ int lua_Sprite_GetPosition(lua_State* state)
     Vector* vector = NULL;
     if(lua_isuserdata(state, 2))
     {
-        if(luaL_checkudata (state, 2, "Vector"))
+        if(LuaState::IsType<Vector>(state, 2))
         {
             vector = (Vector*)lua_touserdata(state, 2);
         }
@@ -88,14 +92,14 @@ int lua_Sprite_SetPosition(lua_State* state)
 int lua_Sprite_SetTexture(lua_State* state)
 {
     Sprite* sprite = (Sprite*)lua_touserdata(state, 1);
-    if (sprite == NULL && !luaL_checkudata (state, 1, "Sprite"))
+    if (sprite == NULL || !LuaState::IsType<Sprite>(state, 1))
     {
         return luaL_typerror(state, 1, "Sprite");
     }
-    Texture** texture = (Texture**)lua_touserdata(state, 2);
-    if (texture == NULL && !luaL_checkudata (state, 2, "Texture"))
+    TextureHandle* texture = Texture::GetFuncParamHandle(state, 2);
+    if (texture == NULL)
     {
-        return luaL_typerror(state, 2, "Texture");
+        return 0;
     }
     sprite->SetTexture(*texture);
     return 0;
@@ -108,19 +112,14 @@ int lua_Sprite_GetTexture(lua_State* state)
     {
         return luaL_typerror(state, 1, "Sprite");
     }
-    Texture* texture = sprite->texture;
-    if(texture == NULL)
+    if(sprite->texture.IsNull())
     {
         lua_pushnil(state);
         return 1;
     }
     else
     {
-        // Mainly repeated code, should be a call to texture
-        Texture **pi = (Texture **)lua_newuserdata(state, sizeof(Texture*));
-        (*pi) = texture;
-        luaL_getmetatable(state, "Texture");
-        lua_setmetatable(state, -2);
+        Texture::PushHandle(state, sprite->texture);
         return 1;
     }
 }
@@ -133,7 +132,7 @@ int lua_Sprite_SetScale(lua_State* state)
         return luaL_typerror(state, 1, "Sprite");
     }
 
-    if(lua_isuserdata(state, 2) && luaL_checkudata (state, 2, "Vector"))
+    if(LuaState::IsType<Vector>(state, 2))
     {
         Vector* vector = (Vector*)lua_touserdata(state, 2);
         assert(vector);
@@ -165,7 +164,7 @@ int lua_Sprite_GetScale(lua_State* state)
 
     if(lua_isuserdata(state, 2))
     {
-        if(!luaL_checkudata (state, 2, "Vector"))
+        if(!LuaState::IsType<Vector>(state, 2))
         {
             return luaL_typerror(state, 2, "Vector");
         }
@@ -193,7 +192,7 @@ int lua_Sprite_SetColour(lua_State* state)
         return luaL_typerror(state, 1, "Sprite");
     }
 
-    if(!lua_isuserdata(state, 2) || !luaL_checkudata (state, 2, "Vector"))
+    if(!LuaState::IsType<Vector>(state, 2))
     {
         return luaL_typerror(state, 1, "Vector");
     }
@@ -213,7 +212,7 @@ int lua_Sprite_GetColour(lua_State* state)
 
     if(lua_isuserdata(state, 2))
     {
-        if(!luaL_checkudata (state, 2, "Vector"))
+        if(!LuaState::IsType<Vector>(state, 2))
         {
             return luaL_typerror(state, 2, "Vector");
         }
@@ -259,33 +258,75 @@ int lua_Sprite_SetUvs(lua_State* state)
     return 0;
 }
 
-static int lua_Sprite_SetRotation(lua_State* state)
+static int lua_Sprite_SetOpaque(lua_State* state)
+{
+    Sprite* sprite = LuaState::GetFuncParam<Sprite>(state, 1);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+    if(!lua_isboolean(state, 2))
+    {
+        return luaL_typerror(state, 2, "boolean");
+    }
+
+    sprite->opaque = lua_toboolean(state, 2) != 0;
+    return 0;
+}
+
+static int lua_Sprite_IsOpaque(lua_State* state)
+{
+    Sprite* sprite = LuaState::GetFuncParam<Sprite>(state, 1);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+    lua_pushboolean(state, sprite->opaque);
+    return 1;
+}
+
+// sprite:SetAnimation(name, [speed]) plays the animation from its first
+// frame, nil stops it.
+static int lua_Sprite_SetAnimation(lua_State* state)
 {
     Sprite* sprite = LuaState::GetFuncParam<Sprite>(state, 1);
     if(sprite == NULL)
     {
         return 0;
     }
-    if(!lua_isnumber(state, 2))
-    {
 
-        return luaL_typerror(state, 2, "number");
+    if(lua_isnoneornil(state, 2))
+    {
+        sprite->SetAnimation(NULL, 1);
+        return 0;
     }
 
-    double rotation = lua_tonumber(state, 2);
-    sprite->SetRotation(rotation);
+    const char* name = luaL_checkstring(state, 2);
+    const Animation* animation = Dinodeck::GetInstance()->GetAnimations()->Find(name);
+    if(animation == NULL)
+    {
+        return luaL_error(state, "No animation [%s].", name);
+    }
+    sprite->SetAnimation(animation, luaL_optnumber(state, 3, 1));
+    // Shows the first frame even if it's read before it's drawn.
+    Animation::Apply(sprite);
     return 0;
 }
 
-static int lua_Sprite_GetRotation(lua_State* state)
+// sprite:GetAnimationFrame() returns the frame showing, from 1, and
+// whether an animation that doesn't loop has finished.
+static int lua_Sprite_GetAnimationFrame(lua_State* state)
 {
     Sprite* sprite = LuaState::GetFuncParam<Sprite>(state, 1);
-    if(sprite == NULL)
+    if(sprite == NULL || sprite->animation == NULL)
     {
         return 0;
     }
-    lua_pushnumber(state, sprite->GetRotation());
-    return 1;
+    bool finished = false;
+    const unsigned int frame = sprite->animation->FrameAt(sprite->AnimationTime(), &finished);
+    lua_pushinteger(state, frame + 1);
+    lua_pushboolean(state, finished);
+    return 2;
 }
 
 static const struct luaL_reg luaBinding [] = {
@@ -300,8 +341,13 @@ static const struct luaL_reg luaBinding [] = {
   {"SetColor", lua_Sprite_SetColour},
   {"GetColor", lua_Sprite_GetColour},
   {"SetUVs", lua_Sprite_SetUvs},
-  {"SetRotation", lua_Sprite_SetRotation},
-  {"GetRotation", lua_Sprite_GetRotation},
+  {"SetRotation", LUA_BIND_METHOD(Sprite::SetRotation)},
+  {"GetRotation", LUA_BIND_METHOD(Sprite::GetRotation)},
+  {"SetOpaque", lua_Sprite_SetOpaque},
+  {"IsOpaque", lua_Sprite_IsOpaque},
+  {"SetAnimation", lua_Sprite_SetAnimation},
+  {"SetAnimationSpeed", LUA_BIND_METHOD(Sprite::SetAnimationSpeed)},
+  {"GetAnimationFrame", lua_Sprite_GetAnimationFrame},
   {NULL, NULL}  /* sentinel */
 };
 
@@ -312,11 +358,12 @@ void Sprite::Bind(LuaState* state)
         Sprite::Meta.Name(),
         luaBinding
     );
+    LuaFFI::BindView(state, Sprite::Meta.Name().c_str());
 }
 
 void Sprite::Init()
 {
-    texture = NULL;
+    texture = TextureHandle();
     scale.x = 1;
     scale.y = 1;
     colour.SetXyzw(1, 1, 1, 1);
@@ -325,6 +372,11 @@ void Sprite::Init()
     bottomRightU = 1;
     bottomRightV = 1;
     rotation = 0;
+    animation = NULL;
+    animationTime = 0;
+    animationStart = 0;
+    animationSpeed = 1;
+    opaque = false;
 }
 
 void Sprite::Init(const Sprite& sprite)
@@ -338,6 +390,32 @@ void Sprite::Init(const Sprite& sprite)
     bottomRightU = sprite.bottomRightU;
     bottomRightV = sprite.bottomRightV;
     rotation = sprite.rotation;
+    animation = sprite.animation;
+    animationTime = sprite.animationTime;
+    animationStart = sprite.animationStart;
+    animationSpeed = sprite.animationSpeed;
+    opaque = sprite.opaque;
+}
+
+void Sprite::SetAnimation(const Animation* value, double speed)
+{
+    animation = value;
+    animationTime = 0;
+    animationStart = Animation::Clock();
+    animationSpeed = speed;
+}
+
+void Sprite::SetAnimationSpeed(double speed)
+{
+    // Carries on from the same point.
+    animationTime = AnimationTime();
+    animationStart = Animation::Clock();
+    animationSpeed = speed;
+}
+
+double Sprite::AnimationTime() const
+{
+    return animationTime + (Animation::Clock() - animationStart) * animationSpeed;
 }
 
 void Sprite::SetPosition(const Vector& value)
@@ -354,7 +432,7 @@ void Sprite::SetPosition(double x, double y)
     position.y = y;
 }
 
-void Sprite::SetTexture(Texture* texture)
+void Sprite::SetTexture(TextureHandle texture)
 {
     this->texture = texture;
 }
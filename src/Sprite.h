@@ -2,16 +2,17 @@
 #define SPRITE_H
 
 #include "reflect/Reflect.h"
+#include "TextureHandle.h"
 #include "Vector.h"
 
+class Animation;
 class LuaState;
-class Texture;
 
 class Sprite
 {
     public: static Reflect Meta;
     public:
-        Texture* texture;
+        TextureHandle texture;
         Vector colour;
         Vector position;
         Vector scale;
@@ -23,6 +24,18 @@ class Sprite
 
         double rotation; // degrees
 
+        // Picks the uvs when drawn, if set. Time into the animation is
+        // animationTime plus the clock since animationStart at
+        // animationSpeed.
+        const Animation* animation;
+        double animationTime;
+        double animationStart;
+        double animationSpeed;
+
+        // Drawn in the renderer's opaque pass even if its texture has
+        // transparent pixels, where they're drawn solid.
+        bool opaque;
+
         static void Bind(LuaState* state);
         Sprite() { Init(); }
         void Init();
@@ -30,10 +43,15 @@ class Sprite
         void SetPosition(const Vector&);
         void SetPosition(double x, double y);
         const Vector& GetPosition() const { return position; };
-        void SetTexture(Texture*);
+        void SetTexture(TextureHandle);
         void SetUVs(double topLeftU, double topLeftV, double bottomRightU, double bottomRightV);
         double GetRotation() const { return rotation; }
         void SetRotation(double value) { rotation = value; }
+        // NULL stops the animation, leaving the uvs on the last frame drawn.
+        void SetAnimation(const Animation* value, double speed);
+        // 0 pauses, 1 is normal speed.
+        void SetAnimationSpeed(double speed);
+        double AnimationTime() const;
 };
 
 #endif
\ No newline at end of file
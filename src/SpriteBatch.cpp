@@ -0,0 +1,321 @@
+#include "SpriteBatch.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include "DinodeckLua.h"
+#include "LuaState.h"
+#include "Sprite.h"
+#include "Texture.h"
+#include "Vector.h"
+#include "VectorArray.h"
+
+Reflect SpriteBatch::Meta("SpriteBatch", SpriteBatch::Bind);
+
+//
+// Gets the batch and the sprite at the 1 based index in argument 2.
+// Returns NULL, after raising the error, if either is missing.
+//
+static SpriteRecord* GetIndexedSprite(lua_State* state)
+{
+    SpriteBatch* batch = LuaState::GetFuncParam<SpriteBatch>(state, 1);
+    if(batch == NULL)
+    {
+        return NULL;
+    }
+
+    int index = luaL_checkinteger(state, 2);
+    if(index < 1 || index > (int) batch->Count())
+    {
+        luaL_argerror(state, 2, "index out of range");
+        return NULL;
+    }
+    return &batch->At(index - 1);
+}
+
+static void PushVectorCopy(lua_State* state, int outParam, const Vector& value)
+{
+    if(LuaState::IsType<Vector>(state, outParam))
+    {
+        ((Vector*)lua_touserdata(state, outParam))->SetXyzw(value);
+        lua_pushvalue(state, outParam);
+        return;
+    }
+
+    Vector* vector = new (lua_newuserdata(state, sizeof(Vector))) Vector(value);
+    assert(vector);
+    luaL_getmetatable(state, "Vector");
+    lua_setmetatable(state, -2);
+}
+
+static int lua_SpriteBatch_Create(lua_State* state)
+{
+    int count = std::max(0, (int) luaL_optinteger(state, 1, 0));
+    new (lua_newuserdata(state, sizeof(SpriteBatch))) SpriteBatch(count);
+    luaL_getmetatable(state, "SpriteBatch");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_SpriteBatch_gc(lua_State* state)
+{
+    SpriteBatch* batch = (SpriteBatch*)lua_touserdata(state, 1);
+    assert(batch);
+    batch->~SpriteBatch();
+    return 0;
+}
+
+static int lua_SpriteBatch_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "SpriteBatch");
+    return 1;
+}
+
+static int lua_SpriteBatch_GetCount(lua_State* state)
+{
+    SpriteBatch* batch = LuaState::GetFuncParam<SpriteBatch>(state, 1);
+    if(batch == NULL)
+    {
+        return 0;
+    }
+    lua_pushinteger(state, batch->Count());
+    return 1;
+}
+
+static int lua_SpriteBatch_Resize(lua_State* state)
+{
+    SpriteBatch* batch = LuaState::GetFuncParam<SpriteBatch>(state, 1);
+    if(batch == NULL)
+    {
+        return 0;
+    }
+    batch->Resize(std::max(0, (int) luaL_checkinteger(state, 2)));
+    return 0;
+}
+
+// batch:Get(i, [sprite]) copies sprite i out
+static int lua_SpriteBatch_Get(lua_State* state)
+{
+    SpriteRecord* sprite = GetIndexedSprite(state);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+
+    if(LuaState::IsType<Sprite>(state, 3))
+    {
+        sprite->CopyTo((Sprite*)lua_touserdata(state, 3));
+        lua_pushvalue(state, 3);
+        return 1;
+    }
+
+    Sprite* copy = new (lua_newuserdata(state, sizeof(Sprite))) Sprite();
+    sprite->CopyTo(copy);
+    luaL_getmetatable(state, "Sprite");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+// batch:Set(i, sprite) copies the sprite in
+static int lua_SpriteBatch_Set(lua_State* state)
+{
+    SpriteRecord* sprite = GetIndexedSprite(state);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+
+    Sprite* from = LuaState::GetFuncParam<Sprite>(state, 3);
+    if(from == NULL)
+    {
+        return 0;
+    }
+    sprite->Init(*from);
+    return 0;
+}
+
+static int lua_SpriteBatch_SetTexture(lua_State* state)
+{
+    SpriteRecord* sprite = GetIndexedSprite(state);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+
+    TextureHandle* texture = Texture::GetFuncParamHandle(state, 3);
+    if(texture == NULL)
+    {
+        return 0;
+    }
+    sprite->texture = *texture;
+    return 0;
+}
+
+static int lua_SpriteBatch_SetPosition(lua_State* state)
+{
+    SpriteRecord* sprite = GetIndexedSprite(state);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+
+    if(lua_isnumber(state, 3))
+    {
+        sprite->x = (float) luaL_optnumber(state, 3, sprite->x);
+        sprite->y = (float) luaL_optnumber(state, 4, sprite->y);
+    }
+    else if(LuaState::IsType<Vector>(state, 3))
+    {
+        const Vector* position = (Vector*)lua_touserdata(state, 3);
+        sprite->x = (float) position->x;
+        sprite->y = (float) position->y;
+        sprite->z = (float) position->z;
+    }
+    else
+    {
+        return luaL_typerror(state, 3, "Vector or number");
+    }
+    return 0;
+}
+
+//
+// batch:SetPositions(vectorArray, [first])
+// Copies the array's x and y into the positions of the sprites from
+// first, 1 by default, for as many as both have.
+//
+static int lua_SpriteBatch_SetPositions(lua_State* state)
+{
+    SpriteBatch* batch = LuaState::GetFuncParam<SpriteBatch>(state, 1);
+    VectorArray* positions = LuaState::GetFuncParam<VectorArray>(state, 2);
+    if(batch == NULL || positions == NULL)
+    {
+        return 0;
+    }
+
+    int first = std::max(1, (int) luaL_optinteger(state, 3, 1)) - 1;
+    int count = std::min((int) positions->Count(), (int) batch->Count() - first);
+    for(int i = 0; i < count; i++)
+    {
+        SpriteRecord& sprite = batch->At(first + i);
+        sprite.x = (float) positions->X(i);
+        sprite.y = (float) positions->Y(i);
+    }
+    return 0;
+}
+
+static int lua_SpriteBatch_GetPosition(lua_State* state)
+{
+    SpriteRecord* sprite = GetIndexedSprite(state);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+    PushVectorCopy(state, 3, Vector(sprite->x, sprite->y, sprite->z, 0));
+    return 1;
+}
+
+static int lua_SpriteBatch_SetScale(lua_State* state)
+{
+    SpriteRecord* sprite = GetIndexedSprite(state);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+
+    if(lua_isnumber(state, 3))
+    {
+        sprite->scaleX = (float) lua_tonumber(state, 3);
+        sprite->scaleY = (float) luaL_optnumber(state, 4, sprite->scaleX);
+    }
+    else if(LuaState::IsType<Vector>(state, 3))
+    {
+        const Vector* scale = (Vector*)lua_touserdata(state, 3);
+        sprite->scaleX = (float) scale->x;
+        sprite->scaleY = (float) scale->y;
+    }
+    else
+    {
+        return luaL_typerror(state, 3, "Vector or number");
+    }
+    return 0;
+}
+
+static int lua_SpriteBatch_SetColor(lua_State* state)
+{
+    SpriteRecord* sprite = GetIndexedSprite(state);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+
+    Vector* colour = LuaState::GetFuncParam<Vector>(state, 3);
+    if(colour == NULL)
+    {
+        return 0;
+    }
+    sprite->colour[0] = (float) colour->x;
+    sprite->colour[1] = (float) colour->y;
+    sprite->colour[2] = (float) colour->z;
+    sprite->colour[3] = (float) colour->w;
+    return 0;
+}
+
+static int lua_SpriteBatch_SetUVs(lua_State* state)
+{
+    SpriteRecord* sprite = GetIndexedSprite(state);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+
+    sprite->topLeftU = (float) luaL_checknumber(state, 3);
+    sprite->topLeftV = (float) luaL_checknumber(state, 4);
+    sprite->bottomRightU = (float) luaL_checknumber(state, 5);
+    sprite->bottomRightV = (float) luaL_checknumber(state, 6);
+    return 0;
+}
+
+static int lua_SpriteBatch_SetRotation(lua_State* state)
+{
+    SpriteRecord* sprite = GetIndexedSprite(state);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+    sprite->rotation = (float) luaL_checknumber(state, 3);
+    return 0;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_SpriteBatch_Create},
+  {"__gc", lua_SpriteBatch_gc},
+  {"__tostring", lua_SpriteBatch_tostring},
+  {"GetCount", lua_SpriteBatch_GetCount},
+  {"Resize", lua_SpriteBatch_Resize},
+  {"Get", lua_SpriteBatch_Get},
+  {"Set", lua_SpriteBatch_Set},
+  {"SetTexture", lua_SpriteBatch_SetTexture},
+  {"SetPosition", lua_SpriteBatch_SetPosition},
+  {"SetPositions", lua_SpriteBatch_SetPositions},
+  {"GetPosition", lua_SpriteBatch_GetPosition},
+  {"SetScale", lua_SpriteBatch_SetScale},
+  {"SetColor", lua_SpriteBatch_SetColor},
+  {"SetUVs", lua_SpriteBatch_SetUVs},
+  {"SetRotation", lua_SpriteBatch_SetRotation},
+  {NULL, NULL}  /* sentinel */
+};
+
+void SpriteBatch::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        SpriteBatch::Meta.Name(),
+        luaBinding
+    );
+}
+
+void SpriteBatch::Resize(unsigned int count)
+{
+    // New sprites get the Sprite defaults.
+    mSprites.resize(count, SpriteRecord());
+}
\ No newline at end of file
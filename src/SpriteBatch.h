@@ -0,0 +1,35 @@
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include <vector>
+
+#include "reflect/Reflect.h"
+#include "SpriteRecord.h"
+
+class LuaState;
+
+//
+// A contiguous array of sprites owned by C++. Scripts set sprites by
+// index and Renderer:DrawSprites draws a range in one call, instead of
+// a Sprite userdata and a DrawSprite call per sprite.
+// They're kept as SpriteRecords, Get and Set convert to and from Sprite.
+//
+class SpriteBatch
+{
+    public: static Reflect Meta;
+    public:
+        static void Bind(LuaState* state);
+
+        SpriteBatch(unsigned int count) : mSprites(count) {}
+
+        unsigned int Count() const { return mSprites.size(); }
+        void Resize(unsigned int count);
+
+        // Index is 0 based, callers check the range.
+        SpriteRecord& At(unsigned int index) { return mSprites[index]; }
+        const SpriteRecord* Sprites() const { return mSprites.empty() ? NULL : &mSprites[0]; }
+    private:
+        std::vector<SpriteRecord> mSprites;
+};
+
+#endif
\ No newline at end of file
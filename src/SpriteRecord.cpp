@@ -0,0 +1,78 @@
+#include "SpriteRecord.h"
+
+#include "Animation.h"
+#include "Sprite.h"
+
+void SpriteRecord::Init()
+{
+    texture = TextureHandle();
+    animation = NULL;
+    animationStart = 0;
+    colour[0] = 1;
+    colour[1] = 1;
+    colour[2] = 1;
+    colour[3] = 1;
+    x = 0;
+    y = 0;
+    z = 0;
+    scaleX = 1;
+    scaleY = 1;
+    rotation = 0;
+    topLeftU = 0;
+    topLeftV = 0;
+    bottomRightU = 1;
+    bottomRightV = 1;
+    animationTime = 0;
+    animationSpeed = 1;
+    opaque = false;
+}
+
+void SpriteRecord::Init(const Sprite& sprite)
+{
+    texture = sprite.texture;
+    animation = sprite.animation;
+    animationStart = sprite.animationStart;
+    colour[0] = (float) sprite.colour.x;
+    colour[1] = (float) sprite.colour.y;
+    colour[2] = (float) sprite.colour.z;
+    colour[3] = (float) sprite.colour.w;
+    x = (float) sprite.position.x;
+    y = (float) sprite.position.y;
+    z = (float) sprite.position.z;
+    scaleX = (float) sprite.scale.x;
+    scaleY = (float) sprite.scale.y;
+    rotation = (float) sprite.rotation;
+    topLeftU = (float) sprite.topLeftU;
+    topLeftV = (float) sprite.topLeftV;
+    bottomRightU = (float) sprite.bottomRightU;
+    bottomRightV = (float) sprite.bottomRightV;
+    animationTime = (float) sprite.animationTime;
+    animationSpeed = (float) sprite.animationSpeed;
+    opaque = sprite.opaque;
+}
+
+void SpriteRecord::CopyTo(Sprite* sprite) const
+{
+    sprite->texture = texture;
+    sprite->animation = animation;
+    sprite->animationStart = animationStart;
+    sprite->colour.SetXyzw(colour[0], colour[1], colour[2], colour[3]);
+    sprite->position.x = x;
+    sprite->position.y = y;
+    sprite->position.z = z;
+    sprite->scale.x = scaleX;
+    sprite->scale.y = scaleY;
+    sprite->rotation = rotation;
+    sprite->topLeftU = topLeftU;
+    sprite->topLeftV = topLeftV;
+    sprite->bottomRightU = bottomRightU;
+    sprite->bottomRightV = bottomRightV;
+    sprite->animationTime = animationTime;
+    sprite->animationSpeed = animationSpeed;
+    sprite->opaque = opaque;
+}
+
+double SpriteRecord::AnimationTime() const
+{
+    return animationTime + (Animation::Clock() - animationStart) * animationSpeed;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef SPRITERECORD_H
+#define SPRITERECORD_H
+
+#include "TextureHandle.h"
+
+class Animation;
+class Sprite;
+
+//
+// The compact form the engine keeps sprites in when it owns them in
+// bulk. Floats instead of doubles and no padding out to Vectors, half
+// the size of a Sprite, so a batch of them walks twice as many per
+// cache line when it's culled and drawn.
+//
+// The position's and scale's z and w, which drawing doesn't use, aren't
+// kept. animationStart is a clock reading and stays a double.
+//
+struct SpriteRecord
+{
+    TextureHandle texture;
+    const Animation* animation;
+    double animationStart;
+
+    float colour[4];
+    float x;
+    float y;
+    float z;
+    float scaleX;
+    float scaleY;
+    float rotation; // degrees
+
+    float topLeftU;
+    float topLeftV;
+    float bottomRightU;
+    float bottomRightV;
+
+    float animationTime;
+    float animationSpeed;
+    bool opaque;
+
+    SpriteRecord() { Init(); }
+    explicit SpriteRecord(const Sprite& sprite) { Init(sprite); }
+    void Init();
+    void Init(const Sprite& sprite);
+    void CopyTo(Sprite* sprite) const;
+    double AnimationTime() const;
+};
+
+#endif
\ No newline at end of file
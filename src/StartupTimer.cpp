@@ -0,0 +1,67 @@
+#include "StartupTimer.h"
+
+#include "Asset.h"
+#include "AssetReport.h"
+#include "DDLog.h"
+#include "DDTime.h"
+
+unsigned long long StartupTimer::mStart = 0;
+std::vector<StartupTimer::Phase> StartupTimer::mPhases;
+bool StartupTimer::mRunning = false;
+
+void StartupTimer::Begin()
+{
+    mPhases.clear();
+    mStart = DDTime::Microseconds();
+    mRunning = true;
+}
+
+void StartupTimer::Mark(const char* phase)
+{
+    if(!mRunning)
+    {
+        return;
+    }
+
+    Phase mark;
+    mark.name = phase;
+    mark.end = DDTime::Microseconds() - mStart;
+    mPhases.push_back(mark);
+}
+
+double StartupTimer::TotalMilliseconds()
+{
+    return mPhases.empty() ? 0 : mPhases.back().end / 1000.0;
+}
+
+void StartupTimer::End()
+{
+    if(!mRunning)
+    {
+        return;
+    }
+    Mark("first_frame");
+    mRunning = false;
+
+    unsigned long long previous = 0;
+    for(size_t i = 0; i < mPhases.size(); i++)
+    {
+        const Phase& phase = mPhases[i];
+        dsprintf("startup_%s_ms %.3f\n", phase.name, (phase.end - previous) / 1000.0);
+        previous = phase.end;
+    }
+
+    // Already counted in the phases above, background decodes may still
+    // be finishing.
+    const AssetReport::Totals* totals = AssetReport::LastTotals();
+    for(unsigned int type = 0; type < AssetReport::TYPE_COUNT; type++)
+    {
+        if(totals[type].assets > 0)
+        {
+            dsprintf("startup_assets_%s_ms %.3f\n",
+                     Asset::TypeToStr[type],
+                     totals[type].loadMicroseconds / 1000.0);
+        }
+    }
+    dsprintf("startup_total_ms %.3f\n", previous / 1000.0);
+}
\ No newline at end of file
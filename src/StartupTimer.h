@@ -0,0 +1,36 @@
+#ifndef STARTUPTIMER_H
+#define STARTUPTIMER_H
+
+#include <vector>
+
+//
+// Time to first frame, from the top of main to the first swap. Each Mark
+// ends a phase of start up, the one that ran since the previous mark.
+// Once the first frame is up the phases are printed in order as a
+// waterfall, one name value pair a line like Benchmark, with the
+// manifest's share split by asset type from the AssetReport.
+//
+// Nothing's recorded before Begin or after End, so reloads don't add to it.
+//
+class StartupTimer
+{
+    struct Phase
+    {
+        const char* name;
+        unsigned long long end; // microseconds since Begin
+    };
+    static unsigned long long mStart;
+    static std::vector<Phase> mPhases;
+    static bool mRunning;
+public:
+    // Call first thing in main.
+    static void Begin();
+    static void Mark(const char* phase);
+    // Marks the first frame and prints the waterfall.
+    static void End();
+    static bool IsRunning() { return mRunning; }
+    // To the last mark, the first frame once it's up.
+    static double TotalMilliseconds();
+};
+
+#endif
\ No newline at end of file
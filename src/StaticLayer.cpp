@@ -0,0 +1,139 @@
+#include "StaticLayer.h"
+
+#include <assert.h>
+
+#include "DinodeckGL.h"
+#include "DDLog.h"
+#include "MemoryStats.h"
+
+void StaticLayer::DestroyBuffer()
+{
+    if(mBufferId != 0)
+    {
+        glDeleteBuffers(1, &mBufferId);
+        ForgetBuffer();
+    }
+}
+
+void StaticLayer::ForgetBuffer()
+{
+    if(mBufferId != 0)
+    {
+        mBufferId = 0;
+        MemoryStats::Release(MemoryStats::MEMORY_VERTICES, mBufferBytes);
+        mBufferBytes = 0;
+    }
+}
+
+void StaticLayer::Clear()
+{
+    DestroyBuffer();
+    mVerts.clear();
+    mRanges.clear();
+    mVertCount = 0;
+    mLost = false;
+}
+
+void StaticLayer::Append(const PackedVertex* verts,
+                         unsigned int count,
+                         GLenum drawMode,
+                         GLuint textureId,
+                         bool alphaTest,
+                         int blend,
+                         const UVBase& uvBase)
+{
+    assert(verts);
+    assert(mBufferId == 0); // append before uploading
+
+    if(count == 0)
+    {
+        return;
+    }
+
+    mVerts.insert(mVerts.end(), verts, verts + count);
+
+    // Batches split by a full buffer have the same state.
+    if(!mRanges.empty())
+    {
+        Range& last = mRanges.back();
+        if(last.drawMode == drawMode
+           && last.textureId == textureId
+           && last.alphaTest == alphaTest
+           && last.blend == blend
+           && last.uvBase == uvBase)
+        {
+            last.vertCount += count;
+            mVertCount += count;
+            return;
+        }
+    }
+
+    Range range;
+    range.drawMode = drawMode;
+    range.textureId = textureId;
+    range.alphaTest = alphaTest;
+    range.blend = blend;
+    range.uvBase = uvBase;
+    range.firstVert = mVertCount;
+    range.vertCount = count;
+    mRanges.push_back(range);
+    mVertCount += count;
+}
+
+void StaticLayer::Upload()
+{
+    DestroyBuffer();
+
+    if(mVertCount == 0)
+    {
+        return;
+    }
+
+    glGenBuffers(1, &mBufferId);
+
+    if(mBufferId == 0)
+    {
+        dsprintf("Static layer buffer unavailable, using client arrays.\n");
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, mBufferId);
+    glBufferData(GL_ARRAY_BUFFER,
+                 mVertCount * sizeof(PackedVertex),
+                 &mVerts[0],
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    mBufferBytes = mVertCount * sizeof(PackedVertex);
+    MemoryStats::Add(MemoryStats::MEMORY_VERTICES, mBufferBytes);
+
+    // The GPU has its own copy now.
+    std::vector<PackedVertex>().swap(mVerts);
+}
+
+const PackedVertex* StaticLayer::Bind()
+{
+    if(mBufferId == 0)
+    {
+        return mVerts.empty() ? NULL : &mVerts[0];
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, mBufferId);
+    return NULL;
+}
+
+void StaticLayer::Unbind()
+{
+    if(mBufferId != 0)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+void StaticLayer::Reset()
+{
+    // Forgotten before Clear, deleting it could free whatever the new
+    // context has given the same name.
+    ForgetBuffer();
+    Clear();
+    mLost = true;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef STATICLAYER_H
+#define STATICLAYER_H
+
+#include <vector>
+
+#include "DinodeckGL.h"
+#include "Vertex.h"
+
+//
+// Geometry recorded once and kept in a GPU buffer, for tile backgrounds
+// and UI that don't change between frames. The pipeline appends its
+// batches here instead of drawing them while a layer is recorded.
+// Consecutive batches with the same state are merged, so an atlased
+// background replays in a single draw call.
+//
+class StaticLayer
+{
+public:
+    struct Range
+    {
+        GLenum drawMode;
+        GLuint textureId; // 0 for untextured
+        bool alphaTest;
+        int blend; // an eBlendMode
+        UVBase uvBase;
+        unsigned int firstVert;
+        unsigned int vertCount;
+    };
+private:
+    GLuint mBufferId;
+    unsigned int mBufferBytes;
+    std::vector<PackedVertex> mVerts; // only kept if there's no buffer
+    std::vector<Range> mRanges;
+    unsigned int mVertCount;
+    bool mLost;
+
+    void DestroyBuffer();
+    void ForgetBuffer();
+public:
+    StaticLayer() : mBufferId(0), mBufferBytes(0), mVertCount(0), mLost(false) {}
+    ~StaticLayer() { DestroyBuffer(); }
+
+    void Clear();
+    void Append(const PackedVertex* verts,
+                unsigned int count,
+                GLenum drawMode,
+                GLuint textureId,
+                bool alphaTest,
+                int blend,
+                const UVBase& uvBase = UVBase());
+
+    // Moves the recorded verts to the GPU.
+    // If buffers aren't available they stay in client memory.
+    void Upload();
+
+    // Binds the buffer and returns NULL, vertex pointers are offsets into
+    // it. Without a buffer returns the verts in client memory.
+    const PackedVertex* Bind();
+    void Unbind();
+
+    const std::vector<Range>& Ranges() const { return mRanges; }
+    unsigned int VertCount() const { return mVertCount; }
+
+    // The buffer and the texture ids it was recorded with are gone.
+    // Call when the OpenGL context has been lost, the layer stays empty
+    // until it's recorded again.
+    void Reset();
+    bool IsLost() const { return mLost; }
+};
+
+#endif
\ No newline at end of file
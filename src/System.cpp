@@ -9,16 +9,21 @@
 #endif
 
 
+#include "Dinodeck.h"
 #include "DinodeckLua.h"
+#include "FrameCapture.h"
 #include "Game.h"
 #include "reflect/Reflect.h"
 #include "Vector.h"
 #include "LuaState.h"
+#include "MemoryStats.h"
 #include "Settings.h"
 
 
 Reflect System::Meta("System", System::Bind);
 
+static int gLowMemoryRef = LUA_NOREF;
+
 
 static int lua_IsWideScreen(lua_State* state)
 {
@@ -33,7 +38,7 @@ static int lua_GetScreenBottomRight(lua_State* state)
     assert(vector != NULL);
     luaL_getmetatable(state, "Vector");
     lua_setmetatable(state, -2);
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     assert(game);
     int width = game->GetSettings()->width;
     int height = game->GetSettings()->height;
@@ -47,7 +52,7 @@ static int lua_GetScreenTopLeft(lua_State* state)
     assert(vector != NULL);
     luaL_getmetatable(state, "Vector");
     lua_setmetatable(state, -2);
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     assert(game);
     int width = game->GetSettings()->width;
     int height = game->GetSettings()->height;
@@ -57,7 +62,7 @@ static int lua_GetScreenTopLeft(lua_State* state)
 
 static int lua_ScreenWidth(lua_State* state)
 {
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     assert(game);
     lua_pushnumber(state, game->GetSettings()->width);
     return 1;
@@ -65,7 +70,7 @@ static int lua_ScreenWidth(lua_State* state)
 
 static int lua_ScreenHeight(lua_State* state)
 {
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     assert(game);
     lua_pushnumber(state, game->GetSettings()->height);
     return 1;
@@ -96,11 +101,144 @@ static int lua_Version(lua_State* state)
 
 static int lua_Exit(lua_State* state)
 {
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     game->Stop();
     return 0;
 }
 
+static int lua_ShowFrameHud(lua_State* state)
+{
+    bool show = lua_isnoneornil(state, 1) || lua_toboolean(state, 1);
+    Dinodeck::GetInstance()->GetFrameHud()->SetVisible(show);
+    return 0;
+}
+
+static int lua_RequestRedraw(lua_State* state)
+{
+    int frames = luaL_optint(state, 1, 1);
+    Dinodeck::GetInstance()->RequestRedraw(frames);
+    return 0;
+}
+
+//
+// System.MarkDirty(x, y, width, height)
+// With partial_redraw on, the next frame only clears and draws inside
+// the bounds of the rects marked before it. Coordinates are as
+// Renderer:Clip. With no rect the whole frame is redrawn.
+//
+static int lua_MarkDirty(lua_State* state)
+{
+    Dinodeck* dinodeck = Dinodeck::GetInstance();
+    if(lua_isnoneornil(state, 1))
+    {
+        dinodeck->MarkAllDirty();
+        return 0;
+    }
+
+    int x = (int) luaL_checknumber(state, 1);
+    int y = (int) luaL_checknumber(state, 2);
+    int width = (int) luaL_checknumber(state, 3);
+    int height = (int) luaL_checknumber(state, 4);
+    dinodeck->MarkDirty(x, y, width, height);
+    return 0;
+}
+
+//
+// System.CaptureFrame(path)
+// The next frame drawn is written to path as a PNG.
+//
+static int lua_CaptureFrame(lua_State* state)
+{
+    const char* path = luaL_checkstring(state, 1);
+    Dinodeck::GetInstance()->GetFrameCapture()->CaptureFrame(path);
+    return 0;
+}
+
+//
+// System.StartRecording(path)
+// Every frame drawn is appended to path as raw RGB24 until
+// System.StopRecording. False if it can't record.
+//
+static int lua_StartRecording(lua_State* state)
+{
+    const char* path = luaL_checkstring(state, 1);
+    lua_pushboolean(state, Dinodeck::GetInstance()->GetFrameCapture()->StartRecording(path));
+    return 1;
+}
+
+static int lua_StopRecording(lua_State* state)
+{
+    Dinodeck::GetInstance()->GetFrameCapture()->StopRecording();
+    return 0;
+}
+
+static int lua_IsRecording(lua_State* state)
+{
+    lua_pushboolean(state, Dinodeck::GetInstance()->GetFrameCapture()->IsRecording());
+    return 1;
+}
+
+// { textures = { current = bytes, peak = bytes }, ... }
+static int lua_GetMemoryStats(lua_State* state)
+{
+    lua_createtable(state, 0, MemoryStats::MEMORY_TAG_COUNT);
+    for(unsigned int i = 0; i < MemoryStats::MEMORY_TAG_COUNT; i++)
+    {
+        MemoryStats::eTag tag = (MemoryStats::eTag) i;
+        lua_createtable(state, 0, 2);
+        lua_pushnumber(state, (lua_Number) MemoryStats::Current(tag));
+        lua_setfield(state, -2, "current");
+        lua_pushnumber(state, (lua_Number) MemoryStats::Peak(tag));
+        lua_setfield(state, -2, "peak");
+        lua_setfield(state, -2, MemoryStats::TagStr[i]);
+    }
+    return 1;
+}
+
+static void PushReleased(lua_State* state, const ReleasedCaches& released)
+{
+    lua_createtable(state, 0, 5);
+    lua_pushnumber(state, released.textures);
+    lua_setfield(state, -2, "textures");
+    lua_pushnumber(state, released.layouts);
+    lua_setfield(state, -2, "layouts");
+    lua_pushnumber(state, released.sounds);
+    lua_setfield(state, -2, "sounds");
+    lua_pushnumber(state, released.lua);
+    lua_setfield(state, -2, "lua");
+    lua_pushnumber(state, released.Total());
+    lua_setfield(state, -2, "total");
+}
+
+// System.ReleaseCaches()
+// Frees what the engine can rebuild and collects garbage. Returns the
+// bytes freed as { textures, layouts, sounds, lua, total }.
+static int lua_ReleaseCaches(lua_State* state)
+{
+    PushReleased(state, Dinodeck::GetInstance()->ReleaseCaches());
+    return 1;
+}
+
+// System.OnLowMemory(function(released) | nil)
+// Called when the OS is short of memory, after the engine's released its
+// caches. Drop what the game can reload too. Released is as ReleaseCaches
+// gives back, with the Android trim level as level.
+static int lua_OnLowMemory(lua_State* state)
+{
+    luaL_unref(state, LUA_REGISTRYINDEX, gLowMemoryRef);
+    gLowMemoryRef = LUA_NOREF;
+
+    if(lua_isnoneornil(state, 1))
+    {
+        return 0;
+    }
+
+    luaL_checktype(state, 1, LUA_TFUNCTION);
+    lua_pushvalue(state, 1);
+    gLowMemoryRef = luaL_ref(state, LUA_REGISTRYINDEX);
+    return 0;
+}
+
 static const struct luaL_reg luaBinding [] = {
   {"IsWideScreen", lua_IsWideScreen},
   {"ScreenWidth", lua_ScreenWidth},
@@ -110,9 +248,38 @@ static const struct luaL_reg luaBinding [] = {
   {"OpenURL", lua_OpenURL},
   {"Version", lua_Version},
   {"Exit", lua_Exit},
+  {"RequestRedraw", lua_RequestRedraw},
+  {"MarkDirty", lua_MarkDirty},
+  {"ShowFrameHud", lua_ShowFrameHud},
+  {"GetMemoryStats", lua_GetMemoryStats},
+  {"CaptureFrame", lua_CaptureFrame},
+  {"StartRecording", lua_StartRecording},
+  {"StopRecording", lua_StopRecording},
+  {"IsRecording", lua_IsRecording},
+  {"ReleaseCaches", lua_ReleaseCaches},
+  {"OnLowMemory", lua_OnLowMemory},
   {NULL, NULL}  /* sentinel */
 };
 
+void System::OnLowMemory(LuaState* state, int level, const ReleasedCaches& released)
+{
+    if(gLowMemoryRef == LUA_NOREF)
+    {
+        return;
+    }
+
+    lua_State* lua = state->State();
+    PushReleased(lua, released);
+    lua_pushinteger(lua, level);
+    lua_setfield(lua, -2, "level");
+    state->CallRegisteredFunctionWithTop(gLowMemoryRef);
+}
+
+void System::Reset()
+{
+    gLowMemoryRef = LUA_NOREF;
+}
+
 void System::Bind(LuaState* state)
 {
     state->Bind
@@ -4,12 +4,17 @@
 #include "reflect/Reflect.h"
 
 class LuaState;
+struct ReleasedCaches;
 
 class System
 {
     public: static Reflect Meta;
     public:
         static void Bind(LuaState* state);
+        // Calls the System.OnLowMemory handler, if there is one.
+        static void OnLowMemory(LuaState* state, int level, const ReleasedCaches& released);
+        // Forgets the handler, its Lua reference goes with the state.
+        static void Reset();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,464 @@
+#include "TableCodec.h"
+
+#include <map>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include "DinodeckLua.h"
+#include "DDPack.h"
+
+namespace
+{
+    enum Tag
+    {
+        TAG_NIL = 0, // ends a table's pairs
+        TAG_FALSE,
+        TAG_TRUE,
+        TAG_INTEGER,
+        TAG_DOUBLE,
+        TAG_STRING,
+        TAG_STRING_REF,
+        TAG_TABLE
+    };
+
+    const char MAGIC[] = "DDT";
+    const unsigned int HEADER_SIZE = 5; // magic, version, flags
+
+    // Doubles hold integers exactly up to here.
+    const double MAX_EXACT_INTEGER = 9007199254740992.0;
+
+    struct Writer
+    {
+        lua_State* state;
+        std::string out;
+        std::map<std::string, unsigned int> strings;
+        std::vector<const void*> path; // tables being written, to catch cycles
+        std::string error;
+
+        void PutVarint(unsigned long long value)
+        {
+            while(value >= 0x80)
+            {
+                out += (char)((value & 0x7F) | 0x80);
+                value >>= 7;
+            }
+            out += (char) value;
+        }
+
+        void PutString(const char* data, size_t length)
+        {
+            const std::string key(data, length);
+            std::map<std::string, unsigned int>::iterator it = strings.find(key);
+            if(it != strings.end())
+            {
+                out += (char) TAG_STRING_REF;
+                PutVarint(it->second);
+                return;
+            }
+
+            const unsigned int id = strings.size();
+            strings[key] = id;
+            out += (char) TAG_STRING;
+            PutVarint(length);
+            out.append(data, length);
+        }
+
+        void PutNumber(double value)
+        {
+            if(value == floor(value) && fabs(value) <= MAX_EXACT_INTEGER)
+            {
+                const long long integer = (long long) value;
+                out += (char) TAG_INTEGER;
+                PutVarint(((unsigned long long) integer << 1) ^ (unsigned long long)(integer >> 63));
+                return;
+            }
+
+            unsigned char bytes[8];
+            unsigned long long bits = 0;
+            memcpy(&bits, &value, sizeof(bits));
+            for(int i = 0; i < 8; i++)
+            {
+                bytes[i] = (unsigned char)(bits >> (i * 8));
+            }
+            out += (char) TAG_DOUBLE;
+            out.append((const char*) bytes, sizeof(bytes));
+        }
+
+        bool PutTable(int index)
+        {
+            const void* table = lua_topointer(state, index);
+            for(size_t i = 0; i < path.size(); i++)
+            {
+                if(path[i] == table)
+                {
+                    error = "table contains itself";
+                    return false;
+                }
+            }
+
+            if(path.size() >= TableCodec::MAX_DEPTH || !lua_checkstack(state, 4))
+            {
+                error = "tables nested too deep";
+                return false;
+            }
+            path.push_back(table);
+
+            // The array part is 1..n up to the first nil.
+            unsigned int count = 0;
+            for(;;)
+            {
+                lua_rawgeti(state, index, count + 1);
+                const bool present = !lua_isnil(state, -1);
+                lua_pop(state, 1);
+                if(!present)
+                {
+                    break;
+                }
+                count++;
+            }
+
+            out += (char) TAG_TABLE;
+            PutVarint(count);
+            for(unsigned int i = 1; i <= count; i++)
+            {
+                lua_rawgeti(state, index, i);
+                const bool ok = Put(lua_gettop(state));
+                lua_pop(state, 1);
+                if(!ok)
+                {
+                    return false;
+                }
+            }
+
+            lua_pushnil(state);
+            while(lua_next(state, index) != 0)
+            {
+                // [key, value]
+                if(lua_type(state, -2) == LUA_TNUMBER)
+                {
+                    const double key = lua_tonumber(state, -2);
+                    if(key >= 1 && key <= count && key == floor(key))
+                    {
+                        lua_pop(state, 1);
+                        continue; // in the array part
+                    }
+                }
+
+                const int top = lua_gettop(state);
+                if(!Put(top - 1) || !Put(top))
+                {
+                    lua_pop(state, 2);
+                    return false;
+                }
+                lua_pop(state, 1);
+            }
+            out += (char) TAG_NIL;
+
+            path.pop_back();
+            return true;
+        }
+
+        bool Put(int index)
+        {
+            switch(lua_type(state, index))
+            {
+                case LUA_TBOOLEAN:
+                {
+                    out += (char)(lua_toboolean(state, index) ? TAG_TRUE : TAG_FALSE);
+                } return true;
+                case LUA_TNUMBER:
+                {
+                    PutNumber(lua_tonumber(state, index));
+                } return true;
+                case LUA_TSTRING:
+                {
+                    size_t length = 0;
+                    const char* data = lua_tolstring(state, index, &length);
+                    PutString(data, length);
+                } return true;
+                case LUA_TTABLE:
+                {
+                    return PutTable(index);
+                }
+                default:
+                {
+                    error = std::string("can't save a ") + luaL_typename(state, index);
+                } return false;
+            }
+        }
+    };
+
+    struct Reader
+    {
+        lua_State* state;
+        const unsigned char* ip;
+        const unsigned char* end;
+        std::vector<std::pair<const char*, size_t> > strings;
+        unsigned int depth;
+
+        bool GetVarint(unsigned long long* value)
+        {
+            *value = 0;
+            for(unsigned int shift = 0; shift < 64; shift += 7)
+            {
+                if(ip >= end)
+                {
+                    return false;
+                }
+                const unsigned char b = *ip++;
+                *value |= (unsigned long long)(b & 0x7F) << shift;
+                if(!(b & 0x80))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Pushes one value, a nil tag pushes nothing and sets isNil.
+        bool Get(bool* isNil)
+        {
+            *isNil = false;
+            if(ip >= end || !lua_checkstack(state, 3))
+            {
+                return false;
+            }
+
+            const unsigned char tag = *ip++;
+            switch(tag)
+            {
+                case TAG_NIL:
+                {
+                    *isNil = true;
+                } return true;
+                case TAG_FALSE:
+                case TAG_TRUE:
+                {
+                    lua_pushboolean(state, tag == TAG_TRUE);
+                } return true;
+                case TAG_INTEGER:
+                {
+                    unsigned long long zigzag = 0;
+                    if(!GetVarint(&zigzag))
+                    {
+                        return false;
+                    }
+                    const long long integer = (long long)(zigzag >> 1) ^ -(long long)(zigzag & 1);
+                    lua_pushnumber(state, (lua_Number) integer);
+                } return true;
+                case TAG_DOUBLE:
+                {
+                    if(end - ip < 8)
+                    {
+                        return false;
+                    }
+                    unsigned long long bits = 0;
+                    for(int i = 0; i < 8; i++)
+                    {
+                        bits |= (unsigned long long) ip[i] << (i * 8);
+                    }
+                    ip += 8;
+                    double value = 0;
+                    memcpy(&value, &bits, sizeof(value));
+                    lua_pushnumber(state, value);
+                } return true;
+                case TAG_STRING:
+                {
+                    unsigned long long length = 0;
+                    if(!GetVarint(&length) || length > (unsigned long long)(end - ip))
+                    {
+                        return false;
+                    }
+                    strings.push_back(std::make_pair((const char*) ip, (size_t) length));
+                    lua_pushlstring(state, (const char*) ip, (size_t) length);
+                    ip += length;
+                } return true;
+                case TAG_STRING_REF:
+                {
+                    unsigned long long id = 0;
+                    if(!GetVarint(&id) || id >= strings.size())
+                    {
+                        return false;
+                    }
+                    lua_pushlstring(state, strings[id].first, strings[id].second);
+                } return true;
+                case TAG_TABLE:
+                {
+                    return GetTable();
+                }
+                default:
+                {
+                } return false;
+            }
+        }
+
+        bool GetTable()
+        {
+            unsigned long long count = 0;
+            if(depth >= TableCodec::MAX_DEPTH ||
+               !GetVarint(&count) ||
+               count > (unsigned long long)(end - ip)) // a byte a value at least
+            {
+                return false;
+            }
+
+            depth++;
+            lua_createtable(state, (int) count, 0);
+            const int table = lua_gettop(state);
+            bool isNil = false;
+            for(unsigned long long i = 1; i <= count; i++)
+            {
+                if(!Get(&isNil) || isNil)
+                {
+                    return false;
+                }
+                lua_rawseti(state, table, (int) i);
+            }
+
+            for(;;)
+            {
+                if(!Get(&isNil))
+                {
+                    return false;
+                }
+                if(isNil)
+                {
+                    break;
+                }
+                // Lua throws on a NaN key.
+                if(lua_type(state, -1) == LUA_TNUMBER &&
+                   lua_tonumber(state, -1) != lua_tonumber(state, -1))
+                {
+                    return false;
+                }
+                if(!Get(&isNil) || isNil)
+                {
+                    return false;
+                }
+                lua_rawset(state, table);
+            }
+            depth--;
+            return true;
+        }
+    };
+}
+
+bool TableCodec::Encode(lua_State* state,
+                        int index,
+                        bool compress,
+                        std::string* out,
+                        std::string* error)
+{
+    if(index < 0)
+    {
+        index = lua_gettop(state) + index + 1;
+    }
+
+    Writer writer;
+    writer.state = state;
+    const int top = lua_gettop(state);
+    if(!writer.Put(index))
+    {
+        lua_settop(state, top);
+        *error = writer.error;
+        return false;
+    }
+
+    out->assign(MAGIC, 3);
+    *out += (char) VERSION;
+
+    std::string packed;
+    if(compress && writer.out.size() >= COMPRESS_THRESHOLD)
+    {
+        DDPack::EncodeLZ4((const unsigned char*) writer.out.data(),
+                          writer.out.size(),
+                          &packed);
+    }
+
+    if(!packed.empty() && packed.size() < writer.out.size())
+    {
+        *out += (char) FLAG_LZ4;
+        Writer header;
+        header.PutVarint(writer.out.size());
+        *out += header.out;
+        *out += packed;
+    }
+    else
+    {
+        *out += (char) 0;
+        *out += writer.out;
+    }
+    return true;
+}
+
+bool TableCodec::IsEncoded(const std::string& data)
+{
+    return data.size() >= HEADER_SIZE && data.compare(0, 3, MAGIC) == 0;
+}
+
+bool TableCodec::Decode(lua_State* state,
+                        const std::string& data,
+                        std::string* error)
+{
+    if(!IsEncoded(data))
+    {
+        *error = "not an encoded table";
+        return false;
+    }
+
+    if((unsigned char) data[3] != VERSION)
+    {
+        *error = "unknown table version";
+        return false;
+    }
+
+    const unsigned char flags = (unsigned char) data[4];
+    const unsigned char* body = (const unsigned char*) data.data() + HEADER_SIZE;
+    const unsigned char* end = (const unsigned char*) data.data() + data.size();
+
+    std::vector<unsigned char> unpacked;
+    if(flags & FLAG_LZ4)
+    {
+        Reader sizeReader;
+        sizeReader.ip = body;
+        sizeReader.end = end;
+        unsigned long long size = 0;
+        // LZ4 expands at most 255 times.
+        if(!sizeReader.GetVarint(&size) ||
+           size / 255 > (unsigned long long)(end - sizeReader.ip))
+        {
+            *error = "corrupt table";
+            return false;
+        }
+
+        unpacked.resize((size_t) size);
+        if(size == 0 ||
+           !DDPack::DecodeLZ4(sizeReader.ip,
+                              end - sizeReader.ip,
+                              &unpacked[0],
+                              (unsigned int) size))
+        {
+            *error = "corrupt table";
+            return false;
+        }
+        body = &unpacked[0];
+        end = body + unpacked.size();
+    }
+
+    Reader reader;
+    reader.state = state;
+    reader.ip = body;
+    reader.end = end;
+    reader.depth = 0;
+
+    const int top = lua_gettop(state);
+    bool isNil = false;
+    if(!reader.Get(&isNil) || isNil || reader.ip != end)
+    {
+        lua_settop(state, top);
+        *error = "corrupt table";
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
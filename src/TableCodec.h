@@ -0,0 +1,45 @@
+#ifndef TABLECODEC_H
+#define TABLECODEC_H
+
+#include <string>
+
+struct lua_State;
+
+//
+// A compact binary form for Lua tables of plain data, used by
+// SaveGame:WriteTable and SaveGame:ReadTable.
+//
+//     "DDT" version flags [raw size if FLAG_LZ4] value
+//
+// Each value is a tag byte then its payload. Whole numbers are zigzag
+// varints, other numbers are little endian doubles. A string is stored
+// once, later uses are an index into the strings seen so far. A table is
+// its array part's count and values, then key, value pairs up to a nil.
+//
+// Only booleans, numbers, strings and tables can be encoded. Tables that
+// contain themselves are an error, shared ones are written out again.
+//
+class TableCodec
+{
+public:
+    static const unsigned int VERSION = 1;
+    static const unsigned int FLAG_LZ4 = 1;
+    static const unsigned int MAX_DEPTH = 128;
+    // Smaller bodies aren't worth compressing.
+    static const unsigned int COMPRESS_THRESHOLD = 256;
+
+    // Encodes the value at index. On failure returns false and says why.
+    static bool Encode(lua_State* state,
+                       int index,
+                       bool compress,
+                       std::string* out,
+                       std::string* error);
+    // Pushes the decoded value. On failure pushes nothing and says why.
+    static bool Decode(lua_State* state,
+                       const std::string& data,
+                       std::string* error);
+    // Cheap check for data made by Encode, rather than a text save.
+    static bool IsEncoded(const std::string& data);
+};
+
+#endif
\ No newline at end of file
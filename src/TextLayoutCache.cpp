@@ -0,0 +1,104 @@
+#include "TextLayoutCache.h"
+
+#include <assert.h>
+#include <string.h>
+
+unsigned int TextLayoutCache::mFontsChangedCount = 0;
+
+bool TextLayoutCache::Key::operator<(const Key& other) const
+{
+    // Cheap fields first, the text is only compared when the hashes and
+    // lengths match.
+    if(hash != other.hash) return hash < other.hash;
+    if(length != other.length) return length < other.length;
+    if(font != other.font) return font < other.font;
+    if(maxwidth != other.maxwidth) return maxwidth < other.maxwidth;
+    if(alignX != other.alignX) return alignX < other.alignX;
+    if(alignY != other.alignY) return alignY < other.alignY;
+    return memcmp(text, other.text, length) < 0;
+}
+
+// FNV-1a
+unsigned int TextLayoutCache::HashString(const char* text, unsigned int* outLength)
+{
+    unsigned int hash = 2166136261u;
+    unsigned int i = 0;
+    for(; text[i] != '\0'; i++)
+    {
+        hash ^= (unsigned char) text[i];
+        hash *= 16777619u;
+    }
+    *outLength = i;
+    return hash;
+}
+
+TextLayoutCache::Entry* TextLayoutCache::Find(Font* font,
+                                              const char* text,
+                                              float maxwidth,
+                                              AlignX::Enum alignX,
+                                              AlignY::Enum alignY)
+{
+    assert(text);
+
+    if(mFontGeneration != mFontsChangedCount)
+    {
+        Clear();
+        mFontGeneration = mFontsChangedCount;
+    }
+
+    Key key;
+    key.font = font;
+    key.maxwidth = maxwidth;
+    key.alignX = alignX;
+    key.alignY = alignY;
+    key.hash = HashString(text, &key.length);
+    key.text = text;
+
+    std::map<Key, EntryList::iterator>::iterator found = mLookup.find(key);
+    if(found != mLookup.end())
+    {
+        mHits++;
+        // Move to the front, splice keeps the iterator valid.
+        mEntries.splice(mEntries.begin(), mEntries, found->second);
+        return &mEntries.front();
+    }
+
+    mMisses++;
+
+    if(mLookup.size() >= mCapacity)
+    {
+        mLookup.erase(mEntries.back().key);
+        mEntries.pop_back();
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.hasLines = false;
+    entry.hasLayout = false;
+    entry.radius = 0;
+    entry.hasSize = false;
+    mEntries.push_front(entry);
+    Entry& added = mEntries.front();
+    added.text.assign(text, key.length);
+    added.key.text = added.text.c_str();
+    mLookup[added.key] = mEntries.begin();
+    return &added;
+}
+
+void TextLayoutCache::Clear()
+{
+    mLookup.clear();
+    mEntries.clear();
+}
+
+unsigned int TextLayoutCache::Bytes() const
+{
+    unsigned int bytes = 0;
+    for(EntryList::const_iterator it = mEntries.begin(); it != mEntries.end(); ++it)
+    {
+        bytes += sizeof(Entry) + it->text.capacity()
+                 + it->lines.capacity() * sizeof(TextLine)
+                 + it->layout.capacity() * sizeof(LayoutGlyph);
+    }
+    return bytes;
+}
\ No newline at end of file
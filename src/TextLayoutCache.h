@@ -0,0 +1,92 @@
+#ifndef TEXTLAYOUTCACHE_H
+#define TEXTLAYOUTCACHE_H
+
+#include <list>
+#include <map>
+#include <string>
+
+#include "DDTextAlign.h"
+#include "FormatText.h"
+#include "Vector.h"
+
+class Font;
+
+//
+// Remembers the layout of recently drawn or measured strings, so labels
+// that don't change from frame to frame skip kerning and wrapping.
+// Least recently used strings are dropped once the cache is full.
+//
+class TextLayoutCache
+{
+public:
+    static const unsigned int DEFAULT_CAPACITY = 256;
+
+    struct Key
+    {
+        Font* font;
+        float maxwidth; // in font space, 0 for no wrapping
+        AlignX::Enum alignX;
+        AlignY::Enum alignY;
+        unsigned int hash;
+        unsigned int length;
+        // The entry's copy, or the caller's string while looking one up,
+        // so a hit doesn't allocate.
+        const char* text;
+
+        bool operator<(const Key& other) const;
+    };
+
+    struct Entry
+    {
+        Key key;
+        std::string text;
+        bool hasLines; // wrapped text only, shared by layout and measuring
+        TextLines lines;
+        bool hasLayout;
+        TextLayout layout;
+        float radius; // furthest glyph corner from the origin, font space
+        bool hasSize;
+        Vector size; // in font space
+    };
+private:
+    typedef std::list<Entry> EntryList;
+    EntryList mEntries; // most recently used first
+    std::map<Key, EntryList::iterator> mLookup;
+    unsigned int mCapacity;
+    unsigned int mFontGeneration;
+    unsigned int mHits;
+    unsigned int mMisses;
+
+    static unsigned int mFontsChangedCount;
+
+    // Also counts the string's length.
+    static unsigned int HashString(const char* text, unsigned int* outLength);
+public:
+    TextLayoutCache() :
+        mCapacity(DEFAULT_CAPACITY),
+        mFontGeneration(mFontsChangedCount),
+        mHits(0),
+        mMisses(0)
+        {}
+
+    // Returns the entry for the string, adding an empty one if it's not
+    // cached. The entry is valid until the next Find or Clear.
+    Entry* Find(Font* font,
+                const char* text,
+                float maxwidth,
+                AlignX::Enum alignX,
+                AlignY::Enum alignY);
+    void Clear();
+    unsigned int Size() const { return mLookup.size(); }
+    // About how much memory the entries hold.
+    unsigned int Bytes() const;
+    unsigned int Hits() const { return mHits; }
+    unsigned int Misses() const { return mMisses; }
+
+    // Cached layouts point at glyph textures, call when any font is
+    // destroyed so every cache is emptied on its next use.
+    static void OnFontsChanged() { mFontsChangedCount++; }
+    static unsigned int FontsChangedCount() { return mFontsChangedCount; }
+};
+
+#endif
\ No newline at end of file
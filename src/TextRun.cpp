@@ -0,0 +1,108 @@
+#include "TextRun.h"
+
+#include <assert.h>
+
+#include "DinodeckLua.h"
+#include "LuaState.h"
+
+Reflect TextRun::Meta("TextRun", TextRun::Bind);
+
+// TextRun.Create(text, [width])
+static int lua_TextRun_Create(lua_State* state)
+{
+    const char* text = luaL_checkstring(state, 1);
+    float width = (float) luaL_optnumber(state, 2, -1);
+    new (lua_newuserdata(state, sizeof(TextRun))) TextRun(text, width);
+    luaL_getmetatable(state, "TextRun");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_TextRun_gc(lua_State* state)
+{
+    TextRun* run = (TextRun*)lua_touserdata(state, 1);
+    assert(run);
+    run->~TextRun();
+    return 0;
+}
+
+static int lua_TextRun_tostring(lua_State* state)
+{
+    TextRun* run = (TextRun*)lua_touserdata(state, 1);
+    assert(run);
+    lua_pushfstring(state, "TextRun \"%s\"", run->Text().c_str());
+    return 1;
+}
+
+static int lua_TextRun_SetText(lua_State* state)
+{
+    TextRun* run = LuaState::GetFuncParam<TextRun>(state, 1);
+    if(run == NULL)
+    {
+        return 0;
+    }
+    run->SetText(luaL_checkstring(state, 2));
+    return 0;
+}
+
+static int lua_TextRun_GetText(lua_State* state)
+{
+    TextRun* run = LuaState::GetFuncParam<TextRun>(state, 1);
+    if(run == NULL)
+    {
+        return 0;
+    }
+    lua_pushlstring(state, run->Text().c_str(), run->Text().size());
+    return 1;
+}
+
+// Zero until the run's been drawn once.
+static int lua_TextRun_GetGlyphCount(lua_State* state)
+{
+    TextRun* run = LuaState::GetFuncParam<TextRun>(state, 1);
+    if(run == NULL)
+    {
+        return 0;
+    }
+    lua_pushinteger(state, run->GlyphCount());
+    return 1;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_TextRun_Create},
+  {"__gc", lua_TextRun_gc},
+  {"__tostring", lua_TextRun_tostring},
+  {"SetText", lua_TextRun_SetText},
+  {"GetText", lua_TextRun_GetText},
+  {"GetGlyphCount", lua_TextRun_GetGlyphCount},
+  {NULL, NULL}  /* sentinel */
+};
+
+void TextRun::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        TextRun::Meta.Name(),
+        luaBinding
+    );
+}
+
+TextRun::TextRun(const char* text, float width) :
+    font(NULL),
+    maxwidth(0),
+    alignX(AlignX::Left),
+    alignY(AlignY::Top),
+    fontGeneration(0),
+    hasLayout(false),
+    radius(0),
+    mText(text),
+    mWidth(width)
+{
+}
+
+void TextRun::SetText(const char* text)
+{
+    mText = text;
+    hasLayout = false;
+    layout.clear();
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef TEXTRUN_H
+#define TEXTRUN_H
+
+#include <string>
+
+#include "DDTextAlign.h"
+#include "FormatText.h"
+#include "reflect/Reflect.h"
+
+class Font;
+class LuaState;
+
+//
+// A string laid out once and kept, so Renderer:DrawTextRun can draw its
+// first N glyphs each frame for a typewriter reveal. White space has no
+// glyph, so N counts the visible characters.
+// It's laid out with the font, alignment and scale it's first drawn
+// with, and again if any of them change.
+//
+class TextRun
+{
+    public: static Reflect Meta;
+    public:
+        static void Bind(LuaState* state);
+
+        TextRun(const char* text, float width);
+
+        void SetText(const char* text);
+        const std::string& Text() const { return mText; }
+        float Width() const { return mWidth; } // in pixels, below 1 doesn't wrap
+        unsigned int GlyphCount() const { return layout.size(); }
+
+        // Kept up to date by GraphicsPipeline::PushTextRun.
+        Font* font;
+        float maxwidth; // in font space
+        AlignX::Enum alignX;
+        AlignY::Enum alignY;
+        unsigned int fontGeneration;
+        bool hasLayout;
+        TextLayout layout;
+        float radius;
+    private:
+        std::string mText;
+        float mWidth;
+};
+
+#endif
\ No newline at end of file
@@ -1,28 +1,84 @@
 // Your local header file
 #include "Texture.h"
 
+#include <algorithm>
 #include <assert.h>
-#include <sstream>
+#include <ctype.h>
 #include <stdio.h>
 #include <string.h>
 #include <string>
+#include <vector>
 //#include <windows.h>
 
+#include "AssetReport.h"
+#include "CompressedImage.h"
 #include "DinodeckGL.h"
 #include "DinodeckLua.h"
 #include "DDFile.h"
 #include "DDLog.h"
+#include "DDTime.h"
 #include "Game.h"
+#include "ImageDecoder.h"
 #include "LuaState.h"
+#include "MemoryStats.h"
 #include "reflect/Reflect.h"
 #include "soil.h"
 #include "TextureManager.h"
 
 Reflect Texture::Meta("Texture", Texture::Bind);
+unsigned int Texture::mFrame = 0;
+bool Texture::mPremultiply = false;
+bool Texture::mTrimTransparent = true;
+TextureManager* Texture::mResidency = NULL;
 
 Texture::Texture() :
-    mTextureId(0), mWidth(0), mHeight(0)
+    mTextureId(0), mWidth(0), mHeight(0), mOwnsId(true), mAtlased(false),
+    mU0(0), mV0(0), mU1(1), mV1(1),
+    mBytes(0), mLastUsedFrame(0), mEvicted(false), mPinned(false),
+    mPremultiplied(false),
+    mOpaque(false),
+    mTrimU0(0), mTrimV0(0), mTrimU1(1), mTrimV1(1)
 {
+    mUpload.format = 0;
+    mUpload.storage = TextureSampling::STORE_DECODED;
+    mUpload.width = 0;
+    mUpload.height = 0;
+    mUpload.mipmaps = false;
+}
+
+void Texture::Evict()
+{
+    assert(IsEvictable());
+    glDeleteTextures(1, &mTextureId);
+    Forget();
+}
+
+void Texture::Forget()
+{
+    if(!mOwnsId || mAtlased)
+    {
+        return;
+    }
+    mTextureId = 0;
+    SetBytes(0);
+    mEvicted = true;
+}
+
+void Texture::SetBytes(unsigned int bytes)
+{
+    MemoryStats::Release(MemoryStats::MEMORY_TEXTURES, mBytes);
+    MemoryStats::Add(MemoryStats::MEMORY_TEXTURES, bytes);
+    mBytes = bytes;
+}
+
+void Texture::Restore()
+{
+    // Cleared first, a failed reload shouldn't be retried every draw.
+    mEvicted = false;
+    if(mResidency != NULL)
+    {
+        mResidency->RestoreTexture(this);
+    }
 }
 
 Texture::~Texture()
@@ -31,7 +87,54 @@ Texture::~Texture()
     // Tell opengl to get rid of the texture
     // glDeleteTextures silently ignores 0's and names that do not correspond to
     // existing textures.
-    glDeleteTextures(1, &mTextureId);
+    if(mOwnsId)
+    {
+        glDeleteTextures(1, &mTextureId);
+    }
+    MemoryStats::Release(MemoryStats::MEMORY_TEXTURES, mBytes);
+}
+
+void Texture::SetAtlasRegion(GLuint pageId, int width, int height,
+                             float u0, float v0, float u1, float v1)
+{
+    // A reload into the atlas replaces a texture loaded on its own.
+    if(mOwnsId && mTextureId != 0 && mTextureId != pageId)
+    {
+        glDeleteTextures(1, &mTextureId);
+    }
+    mTextureId = pageId;
+    mOwnsId = false;
+    mAtlased = true;
+    SetBytes(0); // counted with the page
+    mEvicted = false;
+    mPremultiplied = mPremultiply; // done as it was packed
+    mWidth = width;
+    mHeight = height;
+    mU0 = u0;
+    mV0 = v0;
+    mU1 = u1;
+    mV1 = v1;
+}
+
+void Texture::SetRenderTarget(GLuint id, int width, int height)
+{
+    if(mOwnsId && mTextureId != 0 && mTextureId != id)
+    {
+        glDeleteTextures(1, &mTextureId);
+        SetBytes(0);
+    }
+    mTextureId = id;
+    mOwnsId = false;
+    mAtlased = false;
+    // Drawn into with premultiplied blending, so that's what it holds.
+    mPremultiplied = mPremultiply;
+    ClearAlpha();
+    mWidth = width;
+    mHeight = height;
+    mU0 = 0;
+    mV0 = 1;
+    mU1 = 1;
+    mV1 = 0;
 }
 
 static int lua_Texture_tostring(lua_State* state)
@@ -40,34 +143,85 @@ static int lua_Texture_tostring(lua_State* state)
     return 1;
 }
 
+Texture* Texture::Resolve(TextureHandle handle)
+{
+    return mResidency == NULL ? NULL : mResidency->Resolve(handle);
+}
+
+void Texture::PushHandle(lua_State* state, TextureHandle handle)
+{
+    TextureHandle* pushed = (TextureHandle*)lua_newuserdata(state, sizeof(TextureHandle));
+    (*pushed) = handle;
+    luaL_getmetatable(state, "Texture");
+    lua_setmetatable(state, -2);
+}
+
+TextureHandle* Texture::GetFuncParamHandle(lua_State* state, int argNumber)
+{
+    if(!LuaState::IsType<Texture>(state, argNumber))
+    {
+        luaL_typerror(state, argNumber, "Texture");
+        return NULL;
+    }
+    return (TextureHandle*)lua_touserdata(state, argNumber);
+}
+
+// Errors rather than returning NULL, an unloaded texture has no size.
+static Texture* CheckTexture(lua_State* state, int argNumber)
+{
+    TextureHandle* handle = Texture::GetFuncParamHandle(state, argNumber);
+    if(handle == NULL)
+    {
+        return NULL;
+    }
+
+    Texture* texture = Texture::Resolve(*handle);
+    if(texture == NULL)
+    {
+        luaL_error(state, "Texture has been unloaded.");
+    }
+    return texture;
+}
+
 static int lua_Texture_GetHeight(lua_State* state)
 {
-    Texture** texture = (Texture**)lua_touserdata(state, 1);
+    Texture* texture = CheckTexture(state, 1);
     if(texture == NULL)
     {
-        return luaL_typerror(state, 1, "Texture");
+        return 0;
     }
-    lua_pushnumber(state, (*texture)->GetHeight());
+    lua_pushnumber(state, texture->GetHeight());
     return 1;
 }
 
 static int lua_Texture_GetWidth(lua_State* state)
 {
-    Texture** texture = (Texture**)lua_touserdata(state, 1);
+    Texture* texture = CheckTexture(state, 1);
     if(texture == NULL)
     {
-        return luaL_typerror(state, 1, "Texture");
+        return 0;
     }
-    lua_pushnumber(state, (*texture)->GetWidth());
+    lua_pushnumber(state, texture->GetWidth());
+    return 1;
+}
+
+// False once the texture has been destroyed, e.g. dropped from the
+// manifest by a reload. Find it again to get the new one.
+static int lua_Texture_IsValid(lua_State* state)
+{
+    TextureHandle* handle = Texture::GetFuncParamHandle(state, 1);
+    if(handle == NULL)
+    {
+        return 0;
+    }
+    lua_pushboolean(state, Texture::Resolve(*handle) != NULL);
     return 1;
 }
 
 static int lua_Texture_Find(lua_State* state)
 {
     //
-    // Textures are allocated at startup time
-    // Therefore Lua doesn't need to worry about their memory management
-    // Therefore only the texture pointer is passed to lua
+    // Textures are owned by the manager, Lua gets a handle to one.
     // Unlike Vector where lua manages the entire memory block
     //
 
@@ -77,22 +231,19 @@ static int lua_Texture_Find(lua_State* state)
     }
     const char* textureName = lua_tostring(state, 1);
 
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     assert(game);
 
-    Texture* foundTexture = game->Textures()->GetTexture(textureName);
+    TextureHandle handle = game->Textures()->GetHandle(textureName);
+    Texture* foundTexture = game->Textures()->Resolve(handle);
 
     if(!foundTexture)
     {
         return luaL_error(state, "Texture not found [%s]", textureName);
     }
+    foundTexture->MarkUsed();
 
-    Texture **pi = (Texture **)lua_newuserdata(state, sizeof(Texture*));
-    (*pi) = foundTexture;
-
-    luaL_getmetatable(state, "Texture");
-    lua_setmetatable(state, -2);
-
+    Texture::PushHandle(state, handle);
     return 1;
 }
 
@@ -100,6 +251,7 @@ static const struct luaL_reg luaBinding [] = {
   {"__tostring", lua_Texture_tostring},
   {"GetWidth", lua_Texture_GetWidth},
   {"GetHeight", lua_Texture_GetHeight},
+  {"IsValid", lua_Texture_IsValid},
   {"Find", lua_Texture_Find},
   {NULL, NULL}  /* sentinel */
 };
@@ -117,12 +269,423 @@ static const struct luaL_reg luaBinding [] = {
 // }
 
 
-unsigned int CreateTexture(unsigned char* const img, int width, int height, int channels, bool pixelArt)
+static bool HasExtension(const char* name)
+{
+    const char* extensions = (const char*) glGetString(GL_EXTENSIONS);
+    return extensions != NULL && strstr(extensions, name) != NULL;
+}
+
+#if ANDROID
+static bool IsPowerOfTwo(int value)
+{
+    return value > 0 && (value & (value - 1)) == 0;
+}
+#endif
+
+//
+// How a texture's pixels go to the GL once converted to its storage.
+//
+struct StoredFormat
+{
+    GLint internalFormat;
+    GLenum format;
+    GLenum type;
+    int bytesPerPixel;
+};
+
+static StoredFormat StorageFormat(int channels, TextureSampling::Storage storage)
+{
+    StoredFormat stored;
+    stored.type = GL_UNSIGNED_BYTE;
+    switch(storage)
+    {
+    case TextureSampling::STORE_RGBA4444:
+        stored.format = GL_RGBA;
+        stored.type = GL_UNSIGNED_SHORT_4_4_4_4;
+        stored.bytesPerPixel = 2;
+        break;
+    case TextureSampling::STORE_RGB565:
+        stored.format = GL_RGB;
+        stored.type = GL_UNSIGNED_SHORT_5_6_5;
+        stored.bytesPerPixel = 2;
+        break;
+    case TextureSampling::STORE_ALPHA8:
+#if ANDROID
+        stored.format = GL_ALPHA;
+#else
+        stored.format = GL_LUMINANCE; // uploaded into an intensity texture
+#endif
+        stored.bytesPerPixel = 1;
+        break;
+    default:
+        stored.format = Texture::PixelFormat(channels);
+        stored.bytesPerPixel = channels;
+        break;
+    }
+    stored.internalFormat = stored.format;
+
+#if !ANDROID
+    // GLES needs the internal format to match, desktop GLs take them as a
+    // hint and would otherwise keep 8 bits a channel.
+    switch(storage)
+    {
+    case TextureSampling::STORE_RGBA4444: stored.internalFormat = GL_RGBA4; break;
+    case TextureSampling::STORE_RGB565: stored.internalFormat = GL_RGB5; break;
+    case TextureSampling::STORE_ALPHA8: stored.internalFormat = GL_INTENSITY8; break;
+    default: break;
+    }
+#endif
+    return stored;
+}
+
+//
+// Alpha only textures on desktop GLs are intensity, (a, a, a, a) is
+// premultiplied white so shaders tint them with the vertex colour.
+// GLES1 has no intensity format, its GL_ALPHA texels take their colour
+// from the vertex and need straight alpha.
+//
+static bool StoresPremultiplied(const TextureSampling& sampling)
+{
+    if(sampling.storage == TextureSampling::STORE_ALPHA8)
+    {
+#if ANDROID
+        return false;
+#else
+        return true;
+#endif
+    }
+    return Texture::Premultiplies();
+}
+
+// Offsets, in 32nds of a step, for a 4x4 ordered dither.
+static const unsigned char DitherOffsets[4][4] =
+{
+    {  1, 17,  5, 21 },
+    { 25,  9, 29, 13 },
+    {  7, 23,  3, 19 },
+    { 31, 15, 27, 11 }
+};
+
+//
+// Rounds an 8 bit channel down to bits. offset is in 32nds of a step,
+// 16 rounds to nearest.
+//
+static unsigned int Quantize(int value, int bits, int offset)
+{
+    const int levels = (1 << bits) - 1;
+    return (unsigned int) std::min((value * levels * 32 + offset * 255) / (255 * 32), levels);
+}
+
+//
+// Converts 8 bit pixels to the texture's storage. Returns what should be
+// uploaded, the image itself if it's stored as decoded.
+//
+static const void* StorePixels(const unsigned char* img, int width, int height,
+                               int channels, const TextureSampling& sampling,
+                               std::vector<unsigned char>* converted)
+{
+    if(sampling.storage == TextureSampling::STORE_DECODED)
+    {
+        return img;
+    }
+
+    const StoredFormat stored = StorageFormat(channels, sampling.storage);
+    converted->resize(width * height * stored.bytesPerPixel);
+    unsigned short* packed = (unsigned short*) &(*converted)[0];
+
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            const int i = y * width + x;
+            const unsigned char* pixel = &img[i * channels];
+            // Luminance is spread to rgb, missing alpha is opaque.
+            const int r = pixel[0];
+            const int g = channels >= 3 ? pixel[1] : r;
+            const int b = channels >= 3 ? pixel[2] : r;
+            const int a = (channels == 2 || channels == 4) ? pixel[channels - 1] : 255;
+            const int offset = sampling.dither ? DitherOffsets[y & 3][x & 3] : 16;
+
+            switch(sampling.storage)
+            {
+            case TextureSampling::STORE_RGBA4444:
+                packed[i] = (unsigned short) ((Quantize(r, 4, offset) << 12)
+                                            | (Quantize(g, 4, offset) << 8)
+                                            | (Quantize(b, 4, offset) << 4)
+                                            | Quantize(a, 4, offset));
+                break;
+            case TextureSampling::STORE_RGB565:
+                packed[i] = (unsigned short) ((Quantize(r, 5, offset) << 11)
+                                            | (Quantize(g, 6, offset) << 5)
+                                            | Quantize(b, 5, offset));
+                break;
+            default:
+                // Images without alpha keep their brightness as coverage.
+                (*converted)[i] = (unsigned char) ((channels == 2 || channels == 4) ? a : r);
+                break;
+            }
+        }
+    }
+    return &(*converted)[0];
+}
+
+//
+// Halves an image with a 2x2 box filter, odd edges repeat the last pixel.
+//
+static void BoxFilter(const unsigned char* src, int width, int height, int channels,
+                      unsigned char* dst, int dstWidth, int dstHeight)
+{
+    for(int y = 0; y < dstHeight; y++)
+    {
+        const int y0 = std::min(y * 2, height - 1);
+        const int y1 = std::min(y * 2 + 1, height - 1);
+        for(int x = 0; x < dstWidth; x++)
+        {
+            const int x0 = std::min(x * 2, width - 1);
+            const int x1 = std::min(x * 2 + 1, width - 1);
+            for(int c = 0; c < channels; c++)
+            {
+                int sum = src[(y0 * width + x0) * channels + c]
+                        + src[(y0 * width + x1) * channels + c]
+                        + src[(y1 * width + x0) * channels + c]
+                        + src[(y1 * width + x1) * channels + c];
+                dst[(y * dstWidth + x) * channels + c] = (unsigned char) ((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+//
+// Fills in the levels below the bound texture's base. GLs without
+// glGenerateMipmap, like GLES1, get them box filtered on the CPU.
+//
+static void BuildMipmaps(const unsigned char* img, int width, int height,
+                         int channels, const TextureSampling& sampling)
+{
+#if !ANDROID && !__APPLE__
+    if(GLEE_VERSION_3_0 || GLEE_ARB_framebuffer_object)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        return;
+    }
+#endif
+
+    const StoredFormat stored = StorageFormat(channels, sampling.storage);
+    std::vector<unsigned char> level;
+    std::vector<unsigned char> previous;
+    std::vector<unsigned char> converted;
+    const unsigned char* source = img;
+    int levelIndex = 0;
+
+    // Small levels of RGB images don't have 4 byte aligned rows.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    while(width > 1 || height > 1)
+    {
+        const int levelWidth = std::max(width / 2, 1);
+        const int levelHeight = std::max(height / 2, 1);
+        level.resize(levelWidth * levelHeight * channels);
+        BoxFilter(source, width, height, channels,
+                  &level[0], levelWidth, levelHeight);
+
+        // Filtered at 8 bits, then converted, so error doesn't build up.
+        levelIndex++;
+        glTexImage2D(GL_TEXTURE_2D, levelIndex, stored.internalFormat,
+                     levelWidth, levelHeight, 0, stored.format, stored.type,
+                     StorePixels(&level[0], levelWidth, levelHeight, channels,
+                                 sampling, &converted));
+
+        previous.swap(level);
+        source = &previous[0];
+        width = levelWidth;
+        height = levelHeight;
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+//
+// Filtering for the bound texture, mipmaps only if its levels are there.
+//
+static void ApplySampling(const TextureSampling& sampling, bool mipmaps)
+{
+    if(sampling.pixelArt)
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                        mipmaps ? GL_NEAREST_MIPMAP_LINEAR : GL_NEAREST);
+    }
+    else
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                        mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    }
+
+#ifdef GL_TEXTURE_MAX_ANISOTROPY_EXT
+    if(sampling.anisotropy > 1 && HasExtension("GL_EXT_texture_filter_anisotropic"))
+    {
+        GLfloat maxAnisotropy = 1;
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+                        std::min(sampling.anisotropy, (float) maxAnisotropy));
+    }
+#endif
+}
+
+//
+// Only images with alpha change, luminance alpha included.
+//
+void Texture::PremultiplyPixels(unsigned char* pixels, int width, int height,
+                                int channels)
+{
+    if(channels != 2 && channels != 4)
+    {
+        return;
+    }
+
+    const int count = width * height;
+    for(int i = 0; i < count; i++)
+    {
+        unsigned char* pixel = &pixels[i * channels];
+        const int alpha = pixel[channels - 1];
+        for(int c = 0; c < channels - 1; c++)
+        {
+            pixel[c] = (unsigned char) ((pixel[c] * alpha + 127) / 255);
+        }
+    }
+}
+
+void Texture::ClearAlpha()
+{
+    mOpaque = false;
+    mTrimU0 = 0;
+    mTrimV0 = 0;
+    mTrimU1 = 1;
+    mTrimV1 = 1;
+}
+
+void Texture::ReadAlpha(const unsigned char* pixels, int width, int height,
+                        int channels)
+{
+    ClearAlpha();
+    if(channels != 2 && channels != 4)
+    {
+        mOpaque = true;
+        return;
+    }
+
+    mOpaque = true;
+    int minX = width;
+    int minY = height;
+    int maxX = -1;
+    int maxY = -1;
+    for(int y = 0; y < height; y++)
+    {
+        const unsigned char* alpha = &pixels[y * width * channels + channels - 1];
+        for(int x = 0; x < width; x++, alpha += channels)
+        {
+            if(*alpha != 255)
+            {
+                mOpaque = false;
+            }
+
+            if(*alpha != 0)
+            {
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+            }
+        }
+    }
+
+    if(!mTrimTransparent || mOpaque)
+    {
+        return;
+    }
+
+    if(maxX < 0)
+    {
+        // Nothing to draw at all.
+        mTrimU1 = 0;
+        mTrimV1 = 0;
+        return;
+    }
+
+    // A pixel more each side keeps the filtered fade out of the trim.
+    const int left = std::max(minX - 1, 0);
+    const int top = std::max(minY - 1, 0);
+    const int right = std::min(maxX + 2, width);
+    const int bottom = std::min(maxY + 2, height);
+
+    // Only worth it when it removes a fair part of the quad, each trimmed
+    // sprite costs more to build.
+    const float kept = (float) ((right - left) * (bottom - top)) / (width * height);
+    if(kept > 0.9f)
+    {
+        return;
+    }
+
+    mTrimU0 = (float) left / width;
+    mTrimV0 = (float) top / height;
+    mTrimU1 = (float) right / width;
+    mTrimV1 = (float) bottom / height;
+}
+
+GLenum Texture::PixelFormat(int channels)
+{
+    switch(channels)
+    {
+    case 1: return GL_LUMINANCE;
+    case 2: return GL_LUMINANCE_ALPHA;
+    case 3: return GL_RGB;
+    default: return GL_RGBA;
+    }
+}
+
+// A mip chain adds about a third.
+static unsigned int PixelBytes(int width, int height, int channels,
+                               const TextureSampling& sampling)
+{
+    const StoredFormat stored = StorageFormat(channels, sampling.storage);
+    unsigned int bytes = width * height * stored.bytesPerPixel;
+    return sampling.mipmaps ? bytes + bytes / 3 : bytes;
+}
+
+//
+// Mipmaps and filtering for the bound texture, once its base level is in.
+//
+static void FinishTexture(const unsigned char* img, int width, int height, int channels,
+                          const TextureSampling& sampling)
+{
+    bool mipmaps = sampling.mipmaps;
+#if ANDROID
+    if(mipmaps && !(IsPowerOfTwo(width) && IsPowerOfTwo(height)))
+    {
+        dsprintf("GLES1 can only mipmap power of two textures, %dx%d isn't.\n",
+                 width, height);
+        mipmaps = false;
+    }
+#endif
+
+    if(mipmaps)
+    {
+        BuildMipmaps(img, width, height, channels, sampling);
+    }
+
+    ApplySampling(sampling, mipmaps);
+}
+
+//
+// An existing id is reused rather than a new one made, in place reuses
+// its storage too.
+//
+unsigned int CreateTexture(const unsigned char* img, int width, int height, int channels,
+                           const TextureSampling& sampling, GLuint existing, bool inPlace)
 {
     /*  variables   */
-    unsigned int tex_id = 0;
-    unsigned int internal_texture_format = 0;
-    unsigned int original_texture_format = 0;
+    unsigned int tex_id = existing;
     unsigned int opengl_texture_type = GL_TEXTURE_2D;
     unsigned int opengl_texture_target = GL_TEXTURE_2D;
 
@@ -134,44 +697,43 @@ unsigned int CreateTexture(unsigned char* const img, int width, int height, int
     if( tex_id )
     {
         /*  and what type am I using as the internal texture format?    */
-        switch( channels )
+        const StoredFormat stored = StorageFormat(channels, sampling.storage);
+
+        // The caller's pixels may be cached, so convert a copy.
+        // Alpha only textures have no colour to multiply.
+        std::vector<unsigned char> premultiplied;
+        if(Texture::Premultiplies() && (channels == 2 || channels == 4)
+           && sampling.storage != TextureSampling::STORE_ALPHA8)
         {
-        case 1:
-            original_texture_format = GL_LUMINANCE;
-            break;
-        case 2:
-            original_texture_format = GL_LUMINANCE_ALPHA;
-            break;
-        case 3:
-            original_texture_format = GL_RGB;
-            break;
-        case 4:
-            original_texture_format = GL_RGBA;
-            break;
+            premultiplied.assign(img, img + width * height * channels);
+            Texture::PremultiplyPixels(&premultiplied[0], width, height, channels);
+            img = &premultiplied[0];
         }
-        internal_texture_format = original_texture_format;
+        std::vector<unsigned char> converted;
+        const void* pixels = StorePixels(img, width, height, channels,
+                                         sampling, &converted);
         /*  bind an OpenGL texture ID   */
         glBindTexture( opengl_texture_type, tex_id );
 
         /*  user want OpenGL to do all the work!    */
-        glTexImage2D(
-            opengl_texture_target, 0,
-            internal_texture_format, width, height, 0,
-            original_texture_format, GL_UNSIGNED_BYTE, img );
-
-        if(pixelArt)
+        // 16 bit and alpha rows needn't be 4 byte aligned.
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        if(inPlace)
         {
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexSubImage2D(
+                opengl_texture_target, 0, 0, 0, width, height,
+                stored.format, stored.type, pixels );
         }
         else
         {
-            /*  instruct OpenGL _NOT_ to use the MIPmaps    */
-            glTexParameteri( opengl_texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-            glTexParameteri( opengl_texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+            glTexImage2D(
+                opengl_texture_target, 0,
+                stored.internalFormat, width, height, 0,
+                stored.format, stored.type, pixels );
         }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        FinishTexture(img, width, height, channels, sampling);
     }
     return tex_id;
 }
@@ -181,37 +743,151 @@ unsigned int CreateTexture(unsigned char* const img, int width, int height, int
 // This means the DDS stuff doesn't work anymore!
 // DDS files should be able to be loaded even on android,
 // so it's worth investigating
-bool Texture::LoadDDSTexture(const char *filename, bool pixelArt)
+//
+// Decodes an image file, the result must be freed with SOIL_free_image_data.
+// Returns NULL on failure.
+//
+unsigned char* Texture::LoadPixels(const char* filename,
+                                   int* width,
+                                   int* height,
+                                   int* channels,
+                                   int forceChannels)
 {
-
-//    dsprintf("LoadDDSTexture('%s')\n", filename);
-
     unsigned char* image = NULL;
-    int channels = 0;
 
     // Load texture for disk
     {
+        unsigned long long start = DDTime::Microseconds();
         DDFile file(filename);
-        file.LoadFileIntoBuffer();
+        file.LoadFileView();
 
         if(NULL == file.Buffer())
         {
             dsprintf("Failed to load [%s]\n", filename);
-            return false;
+            return NULL;
         }
 
-        image = SOIL_load_image_from_memory
+        unsigned long long read = DDTime::Microseconds();
+        AssetReport::AddRead(AssetReport::Current(), file.Size(), read - start);
+
+        image = ImageDecoder::Decode
         (
             (const unsigned char*) file.Buffer(),
             file.Size(),
-            &mWidth, &mHeight, &channels,
-            SOIL_LOAD_AUTO
+            width, height, channels,
+            forceChannels
         );
+        AssetReport::AddDecode(AssetReport::Current(), DDTime::Microseconds() - read);
     }
 
     if(image == NULL)
     {
         dsprintf("Texture failed to load:[%s]\n", filename);
+    }
+    return image;
+}
+
+bool Texture::IsCompressedFile(const char* filename)
+{
+    const char* extension = strrchr(filename, '.');
+    if(extension == NULL)
+    {
+        return false;
+    }
+
+    std::string lower(extension);
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    return lower == ".dds" || lower == ".ktx";
+}
+
+//
+// Uploads the blocks as they are, levels below the base are only used if
+// the file has a full mip chain.
+//
+bool Texture::LoadCompressedTexture(const char* filename, const TextureSampling& sampling)
+{
+    CompressedImage image;
+    if(!image.Load(filename))
+    {
+        return false;
+    }
+
+    if(!CompressedImage::IsFormatSupported(image.Format()))
+    {
+        dsprintf("[%s] format 0x%x isn't supported by this GL.\n",
+                 filename, image.Format());
+        return false;
+    }
+
+    GLuint id = 0;
+    glGenTextures(1, &id);
+    if(id == 0)
+    {
+        return false;
+    }
+
+    const bool mipmaps = sampling.mipmaps && image.HasFullMipChain();
+    if(sampling.mipmaps && !mipmaps)
+    {
+        dsprintf("[%s] has no full mip chain, drawing without mipmaps.\n", filename);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, id);
+    const unsigned int levels = mipmaps ? image.LevelCount() : 1;
+    for(unsigned int i = 0; i < levels; i++)
+    {
+        const CompressedImage::Level& level = image.GetLevel(i);
+        glCompressedTexImage2D(GL_TEXTURE_2D, i, image.Format(),
+                               level.width, level.height, 0,
+                               level.size, image.LevelData(i));
+    }
+    ApplySampling(sampling, mipmaps);
+
+    if(mOwnsId && mTextureId != id)
+    {
+        glDeleteTextures(1, &mTextureId);
+    }
+    mUpload.format = 0;
+
+    unsigned int bytes = 0;
+    for(unsigned int i = 0; i < levels; i++)
+    {
+        bytes += image.GetLevel(i).size;
+    }
+    SetBytes(bytes);
+    mEvicted = false;
+    // Blocks can't be converted here, they're drawn with straight alpha.
+    mPremultiplied = false;
+    ClearAlpha(); // the blocks aren't read
+    mTextureId = id;
+    mWidth = image.Width();
+    mHeight = image.Height();
+    mOwnsId = true;
+    mAtlased = false;
+    mU0 = 0;
+    mV0 = 0;
+    mU1 = 1;
+    mV1 = 1;
+    return true;
+}
+
+bool Texture::LoadDDSTexture(const char *filename, const TextureSampling& sampling)
+{
+    // Compressed files go to the GL as they are if it can take them,
+    // otherwise SOIL decodes DDS files.
+    if(IsCompressedFile(filename)
+       && LoadCompressedTexture(filename, sampling))
+    {
+        return true;
+    }
+
+//    dsprintf("LoadDDSTexture('%s')\n", filename);
+
+    int channels = 0;
+    unsigned char* image = LoadPixels(filename, &mWidth, &mHeight, &channels, SOIL_LOAD_AUTO);
+
+    if(image == NULL)
+    {
         return false;
     }
     // else
@@ -228,18 +904,106 @@ bool Texture::LoadDDSTexture(const char *filename, bool pixelArt)
     //     SOIL_FLAG_MIPMAPS /*| SOIL_FLAG_INVERT_Y*/ | SOIL_FLAG_NTSC_SAFE_RGB //| SOIL_FLAG_COMPRESS_TO_DXT
     // );
 
-    // Android crashes under SOIL_create_OGL_texture
-    // Haven't properly invesitgated why but this stripped down function will
-    // do for now. It's also more efficient as it does copy the image data.
-    GLuint tex_2d = CreateTexture(image, mWidth, mHeight, channels, pixelArt);
+    LoadPixelTexture(image, mWidth, mHeight, channels, sampling);
 
     SOIL_free_image_data
     (
         image
     );
+    return true;
+}
 
+void Texture::LoadPixelTexture(const unsigned char* image, int width, int height,
+                               int channels, const TextureSampling& sampling)
+{
+    assert(image);
+
+    // Android crashes under SOIL_create_OGL_texture
+    // Haven't properly invesitgated why but this stripped down function will
+    // do for now. It's also more efficient as it does copy the image data.
+    unsigned long long start = DDTime::Microseconds();
+    const bool inPlace = CanLoadInPlace(width, height, channels, sampling);
+    GLuint tex_2d = CreateTexture(image, width, height, channels, sampling,
+                                  HasOwnTexture() ? mTextureId : 0, inPlace);
+    AssetReport::AddUpload(AssetReport::Current(), DDTime::Microseconds() - start);
+
+    // Only if there was no name to reuse, or the GL is without a context.
+    if(mOwnsId && mTextureId != tex_2d)
+    {
+        glDeleteTextures(1, &mTextureId);
+    }
+
+    mUpload.format = StorageFormat(channels, sampling.storage).internalFormat;
+    mUpload.storage = sampling.storage;
+    mUpload.width = width;
+    mUpload.height = height;
+    mUpload.mipmaps = sampling.mipmaps;
+
+    SetBytes(PixelBytes(width, height, channels, sampling));
+    AssetReport::SetMemory(AssetReport::Current(), mBytes);
+    mPremultiplied = StoresPremultiplied(sampling);
+    ReadAlpha(image, width, height, channels);
+    mEvicted = false;
     mTextureId = tex_2d;
-    return true;
+    mWidth = width;
+    mHeight = height;
+    mOwnsId = true;
+    mAtlased = false;
+    mU0 = 0;
+    mV0 = 0;
+    mU1 = 1;
+    mV1 = 1;
+}
+
+bool Texture::CanLoadInPlace(int width, int height, int channels,
+                             const TextureSampling& sampling) const
+{
+    return HasOwnTexture()
+        && mUpload.format != 0
+        && mUpload.format == StorageFormat(channels, sampling.storage).internalFormat
+        && mUpload.storage == sampling.storage
+        && mUpload.width == width
+        && mUpload.height == height
+        && mUpload.mipmaps == sampling.mipmaps;
+}
+
+void Texture::AdoptStreamedTexture(GLuint id, const unsigned char* image,
+                                   int width, int height, int channels,
+                                   const TextureSampling& sampling)
+{
+    assert(image);
+    glBindTexture(GL_TEXTURE_2D, id);
+    FinishTexture(image, width, height, channels, sampling);
+
+    if(mOwnsId && mTextureId != id)
+    {
+        glDeleteTextures(1, &mTextureId);
+    }
+
+    mUpload.format = StorageFormat(channels, sampling.storage).internalFormat;
+    mUpload.storage = sampling.storage;
+    mUpload.width = width;
+    mUpload.height = height;
+    mUpload.mipmaps = sampling.mipmaps;
+    SetBytes(PixelBytes(width, height, channels, sampling));
+    mPremultiplied = StoresPremultiplied(sampling);
+    ReadAlpha(image, width, height, channels);
+    mEvicted = false;
+    mTextureId = id;
+    mWidth = width;
+    mHeight = height;
+    mOwnsId = true;
+    mAtlased = false;
+    mU0 = 0;
+    mV0 = 0;
+    mU1 = 1;
+    mV1 = 1;
+}
+
+void Texture::SetPlaceholderSize(int width, int height)
+{
+    mWidth = width;
+    mHeight = height;
 }
 
 
@@ -255,9 +1019,7 @@ void Texture::Bind(LuaState* state)
 
 std::string Texture::ToString() const
 {
-    std::stringstream ss;
-    ss << "Texture ["
-       << GetWidth() << "x"
-       << GetHeight() << "]";
-    return ss.str();
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "Texture [%dx%d]", GetWidth(), GetHeight());
+    return buffer;
 }
\ No newline at end of file
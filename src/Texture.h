@@ -6,12 +6,41 @@
 
 #include "DinodeckGL.h"
 #include "reflect/Reflect.h"
+#include "TextureHandle.h"
 
 class Asset;
 class LuaState;
+class TextureManager;
+struct lua_State;
 
-// Find will return lightuserdata
-// All removing / adding handled here
+//
+// How a loaded texture is sampled and stored, from its manifest flags.
+//
+struct TextureSampling
+{
+    // What the decoded pixels are converted to before upload. 16 bit
+    // formats halve the memory of RGBA, alpha only quarters it.
+    enum Storage
+    {
+        STORE_DECODED, // 8 bits a channel, as the file decoded
+        STORE_RGBA4444,
+        STORE_RGB565, // drops alpha
+        STORE_ALPHA8 // coverage only, tinted by the sprite colour
+    };
+
+    bool pixelArt; // nearest rather than linear
+    bool mipmaps; // trilinear when drawn smaller than it is
+    float anisotropy; // 1 is off, clamped to what the GL supports
+    Storage storage;
+    bool dither; // ordered dither when dropping to 16 bits
+
+    TextureSampling() :
+        pixelArt(false), mipmaps(false), anisotropy(1),
+        storage(STORE_DECODED), dither(false) {}
+};
+
+// Lua's Texture userdata hold a TextureHandle, so scripts can keep them.
+// A texture destroyed since then is reported as unloaded.
 
 class Texture
 {
@@ -20,15 +49,155 @@ class Texture
         GLuint mTextureId;
         int mWidth;
         int mHeight;
+        bool mOwnsId; // false when the id belongs to an atlas page or target
+        bool mAtlased;
+        // Region of the GL texture this texture covers.
+        float mU0;
+        float mV0;
+        float mU1;
+        float mV1;
+        // Residency, the manager evicts textures that haven't been used
+        // recently when over its budget.
+        unsigned int mBytes; // estimated GL memory
+        unsigned int mLastUsedFrame;
+        bool mEvicted;
+        bool mPinned; // never evicted
+        bool mPremultiplied; // colour already multiplied by alpha
+        bool mOpaque; // every pixel's alpha is full, as loaded
+        // 0-1 bounds of the pixels that aren't fully transparent, plus a
+        // pixel for filtering. The whole texture unless trimmed.
+        float mTrimU0;
+        float mTrimV0;
+        float mTrimU1;
+        float mTrimV1;
+        // What the GL texture it owns was made with, so a reload of the
+        // same size and format can go into it in place. 0 format if it's
+        // not from pixels.
+        struct Upload
+        {
+            GLint format;
+            TextureSampling::Storage storage; // GLES needs the same type too
+            int width;
+            int height;
+            bool mipmaps;
+        };
+        Upload mUpload;
+        static unsigned int mFrame;
+        static bool mPremultiply;
+        static bool mTrimTransparent;
+        static TextureManager* mResidency;
+        void Restore();
+        // Keeps the MemoryStats count in step with mBytes.
+        void SetBytes(unsigned int bytes);
+        // Owns a GL texture, copies would delete it twice.
+        Texture(const Texture&);
+        Texture& operator=(const Texture&);
     public:
         static void Bind(LuaState* state);
+        static void PushHandle(lua_State* state, TextureHandle handle);
+        // Raises a type error and returns NULL if it's not a Texture.
+        static TextureHandle* GetFuncParamHandle(lua_State* state, int argNumber);
+        // Through the manager set with SetResidency. NULL if the texture
+        // has been destroyed since the handle was made.
+        static Texture* Resolve(TextureHandle handle);
+        static unsigned char* LoadPixels(const char* filename,
+                                         int* width,
+                                         int* height,
+                                         int* channels,
+                                         int forceChannels);
+        // Textures loaded from pixels after this have their colour
+        // multiplied by alpha, see GraphicsPipeline::BatchBlend.
+        static void SetPremultiply(bool value) { mPremultiply = value; }
+        static bool Premultiplies() { return mPremultiply; }
+        static void PremultiplyPixels(unsigned char* pixels, int width, int height,
+                                      int channels);
+        // Sprites drawn with textures loaded after this skip their fully
+        // transparent borders, see GraphicsPipeline::TrimSprite.
+        static void SetTrimTransparent(bool value) { mTrimTransparent = value; }
+        // True for .dds and .ktx files.
+        static bool IsCompressedFile(const char* filename);
+        // GL_LUMINANCE to GL_RGBA for 1 to 4 channels.
+        static GLenum PixelFormat(int channels);
         Texture();
         ~Texture();
-        bool LoadDDSTexture(const char* filename, bool pixelArt);
+        bool LoadDDSTexture(const char* filename, const TextureSampling& sampling);
+        // A DDS or KTX file uploaded without decoding. False if the file
+        // can't be read or the GL doesn't support its format.
+        bool LoadCompressedTexture(const char* filename, const TextureSampling& sampling);
+        // Uploads decoded pixels into the GL texture this one owns, with
+        // glTexSubImage2D if it's the same size and format as before, so
+        // the GL name never changes on a reload.
+        void LoadPixelTexture(const unsigned char* image, int width, int height,
+                              int channels, const TextureSampling& sampling);
+        bool CanLoadInPlace(int width, int height, int channels,
+                            const TextureSampling& sampling) const;
+        // Has a GL texture of its own, i.e. a reload replaces one in use.
+        bool HasOwnTexture() const { return mOwnsId && !mAtlased && mTextureId != 0; }
+        // Takes over a texture whose base level was streamed in, the
+        // image is needed for mipmaps on GLs that can't generate them.
+        void AdoptStreamedTexture(GLuint id, const unsigned char* image,
+                                  int width, int height, int channels,
+                                  const TextureSampling& sampling);
+        // Size known before the pixels arrive, draws untextured until then.
+        void SetPlaceholderSize(int width, int height);
+        void SetAtlasRegion(GLuint pageId, int width, int height,
+                            float u0, float v0, float u1, float v1);
+        // Wraps a render target's texture. Its rows run bottom up, so v is
+        // flipped to match loaded textures.
+        void SetRenderTarget(GLuint id, int width, int height);
         int GetWidth() const { return mWidth; }
         int GetHeight() const { return mHeight; }
         GLuint GetId() const { return mTextureId; }
+        bool IsAtlased() const { return mAtlased; }
+        bool IsPremultiplied() const { return mPremultiplied; }
+        // Opaque textures can be drawn in the pipeline's opaque pass.
+        // Compressed and render target textures never count as opaque,
+        // or get trimmed.
+        bool IsOpaque() const { return mOpaque; }
+        // Finds if the pixels are opaque and what to trim, from the image
+        // that was just loaded.
+        void ReadAlpha(const unsigned char* pixels, int width, int height, int channels);
+        void ClearAlpha();
+        bool IsTrimmed() const
+        {
+            return mTrimU0 > 0 || mTrimV0 > 0 || mTrimU1 < 1 || mTrimV1 < 1;
+        }
+        float TrimU0() const { return mTrimU0; }
+        float TrimV0() const { return mTrimV0; }
+        float TrimU1() const { return mTrimU1; }
+        float TrimV1() const { return mTrimV1; }
+        // Maps a 0-1 uv in this texture to a uv in the GL texture.
+        float MapU(float u) const { return mU0 + u * (mU1 - mU0); }
+        float MapV(float v) const { return mV0 + v * (mV1 - mV0); }
         std::string ToString() const;
+
+        static void NewFrame() { mFrame++; }
+        static unsigned int Frame() { return mFrame; }
+        // Evicted textures are reloaded through it.
+        static void SetResidency(TextureManager* manager) { mResidency = manager; }
+        static TextureManager* Residency() { return mResidency; }
+        // Call when the texture's drawn, brings it back if it was evicted.
+        void MarkUsed()
+        {
+            mLastUsedFrame = mFrame;
+            if(mEvicted)
+            {
+                Restore();
+            }
+        }
+        // Frees the GL texture but keeps the size, so layout is unchanged.
+        void Evict();
+        // The GL texture went with the context, there's nothing to free.
+        void Forget();
+        bool IsEvicted() const { return mEvicted; }
+        // Only textures with their own GL texture can be evicted.
+        bool IsEvictable() const
+        {
+            return mOwnsId && mTextureId != 0 && !mPinned && !mEvicted;
+        }
+        void SetPinned(bool value) { mPinned = value; }
+        unsigned int Bytes() const { return mBytes; }
+        unsigned int LastUsedFrame() const { return mLastUsedFrame; }
 };
 
 #endif
\ No newline at end of file
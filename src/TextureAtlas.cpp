@@ -0,0 +1,212 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
+
+#include "DinodeckGL.h"
+#include "DDLog.h"
+#include "MemoryStats.h"
+#include "Texture.h"
+
+bool TextureAtlas::CreatePage(Page* page, bool pixelArt)
+{
+    assert(page);
+    glGenTextures(1, &page->id);
+
+    if(page->id == 0)
+    {
+        dsprintf("Failed to create atlas page.\n");
+        return false;
+    }
+
+    page->pixelArt = pixelArt;
+    glBindTexture(GL_TEXTURE_2D, page->id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, PAGE_SIZE, PAGE_SIZE, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    MemoryStats::Add(MemoryStats::MEMORY_TEXTURES, PAGE_BYTES);
+
+    GLint filter = pixelArt ? GL_NEAREST : GL_LINEAR;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    return true;
+}
+
+//
+// Finds room for a padded rect on the page, moving down a shelf if the
+// current one is full.
+//
+bool TextureAtlas::Allocate(Page* page, int width, int height, int* outX, int* outY)
+{
+    if(page->cursorX + width > PAGE_SIZE)
+    {
+        page->cursorX = 0;
+        page->cursorY += page->shelfHeight;
+        page->shelfHeight = 0;
+    }
+
+    if(page->cursorY + height > PAGE_SIZE)
+    {
+        return false;
+    }
+
+    *outX = page->cursorX;
+    *outY = page->cursorY;
+    page->cursorX += width;
+    page->shelfHeight = std::max(page->shelfHeight, height);
+    return true;
+}
+
+void TextureAtlas::Upload(const Page& page,
+                          const unsigned char* rgba,
+                          int width,
+                          int height,
+                          int x,
+                          int y)
+{
+    // Repeat the edge pixels into the padding so filtering at the
+    // border doesn't pick up the neighbouring texture.
+    const int paddedWidth = width + (PADDING * 2);
+    const int paddedHeight = height + (PADDING * 2);
+    std::vector<unsigned char> padded(paddedWidth * paddedHeight * 4);
+
+    for(int py = 0; py < paddedHeight; py++)
+    {
+        int sy = std::min(std::max(py - PADDING, 0), height - 1);
+        for(int px = 0; px < paddedWidth; px++)
+        {
+            int sx = std::min(std::max(px - PADDING, 0), width - 1);
+            memcpy(&padded[(py * paddedWidth + px) * 4],
+                   &rgba[(sy * width + sx) * 4],
+                   4);
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, page.id);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, paddedWidth, paddedHeight,
+                    GL_RGBA, GL_UNSIGNED_BYTE, &padded[0]);
+}
+
+bool TextureAtlas::Insert(const char* group,
+                          const unsigned char* rgba,
+                          int width,
+                          int height,
+                          bool pixelArt,
+                          Texture* texture)
+{
+    assert(group);
+    assert(rgba);
+    assert(texture);
+
+    const int paddedWidth = width + (PADDING * 2);
+    const int paddedHeight = height + (PADDING * 2);
+
+    if(width <= 0 || height <= 0 ||
+       paddedWidth > PAGE_SIZE || paddedHeight > PAGE_SIZE)
+    {
+        return false;
+    }
+
+    std::vector<Page>& pages = mGroups[group];
+    Page* page = NULL;
+    int x = 0;
+    int y = 0;
+
+    for(std::vector<Page>::iterator it = pages.begin(); it != pages.end(); ++it)
+    {
+        if(it->pixelArt == pixelArt &&
+           Allocate(&(*it), paddedWidth, paddedHeight, &x, &y))
+        {
+            page = &(*it);
+            break;
+        }
+    }
+
+    if(page == NULL)
+    {
+        Page newPage;
+        if(!CreatePage(&newPage, pixelArt))
+        {
+            return false;
+        }
+        dsprintf("Atlas [%s] page %d created.\n", group, (int) pages.size());
+        pages.push_back(newPage);
+        page = &pages.back();
+        Allocate(page, paddedWidth, paddedHeight, &x, &y);
+    }
+
+    Upload(*page, rgba, width, height, x, y);
+    page->users++;
+
+    const float size = (float) PAGE_SIZE;
+    texture->SetAtlasRegion(page->id, width, height,
+                            (x + PADDING) / size,
+                            (y + PADDING) / size,
+                            (x + PADDING + width) / size,
+                            (y + PADDING + height) / size);
+    texture->ReadAlpha(rgba, width, height, 4);
+    return true;
+}
+
+void TextureAtlas::Release(const Texture& texture)
+{
+    if(!texture.IsAtlased())
+    {
+        return;
+    }
+
+    for(std::map<std::string, std::vector<Page> >::iterator
+        group = mGroups.begin();
+        group != mGroups.end();
+        ++group)
+    {
+        std::vector<Page>& pages = group->second;
+        for(std::vector<Page>::iterator it = pages.begin(); it != pages.end(); ++it)
+        {
+            if(it->id != texture.GetId())
+            {
+                continue;
+            }
+
+            it->users--;
+            if(it->users <= 0)
+            {
+                glDeleteTextures(1, &it->id);
+                MemoryStats::Release(MemoryStats::MEMORY_TEXTURES, PAGE_BYTES);
+                pages.erase(it);
+            }
+            return;
+        }
+    }
+}
+
+void TextureAtlas::Clear()
+{
+    for(std::map<std::string, std::vector<Page> >::iterator
+        group = mGroups.begin();
+        group != mGroups.end();
+        ++group)
+    {
+        std::vector<Page>& pages = group->second;
+        for(std::vector<Page>::iterator it = pages.begin(); it != pages.end(); ++it)
+        {
+            glDeleteTextures(1, &it->id);
+        }
+    }
+    Reset();
+}
+
+void TextureAtlas::Reset()
+{
+    for(std::map<std::string, std::vector<Page> >::iterator
+        group = mGroups.begin();
+        group != mGroups.end();
+        ++group)
+    {
+        MemoryStats::Release(MemoryStats::MEMORY_TEXTURES,
+                             group->second.size() * PAGE_BYTES);
+    }
+    mGroups.clear();
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "DinodeckGL.h"
+
+class Texture;
+
+//
+// Packs small textures into shared pages so sprites using them can be
+// drawn in a single batch. Textures opt in with an atlas flag in the
+// manifest, the value names the group, e.g. atlas = "ui".
+//
+// Pages are filled with simple shelf packing as textures are loaded.
+// Space isn't reclaimed until every texture on a page is released.
+//
+class TextureAtlas
+{
+public:
+    static const int PAGE_SIZE = 1024;
+    static const int PADDING = 1; // edge pixels are repeated into this
+    static const unsigned int PAGE_BYTES = PAGE_SIZE * PAGE_SIZE * 4;
+private:
+    struct Page
+    {
+        GLuint id;
+        bool pixelArt;
+        int cursorX;
+        int cursorY;
+        int shelfHeight;
+        int users;
+
+        Page() :
+            id(0), pixelArt(false), cursorX(0), cursorY(0),
+            shelfHeight(0), users(0) {}
+    };
+
+    std::map<std::string, std::vector<Page> > mGroups;
+
+    static bool CreatePage(Page* page, bool pixelArt);
+    static bool Allocate(Page* page, int width, int height, int* outX, int* outY);
+    static void Upload(const Page& page,
+                       const unsigned char* rgba,
+                       int width,
+                       int height,
+                       int x,
+                       int y);
+public:
+    ~TextureAtlas() { Clear(); }
+
+    // Copies RGBA pixels into a page of the group and points the texture
+    // at that region. Returns false if the image is too big for a page.
+    bool Insert(const char* group,
+                const unsigned char* rgba,
+                int width,
+                int height,
+                bool pixelArt,
+                Texture* texture);
+
+    // Call before an atlased texture is reloaded or destroyed.
+    void Release(const Texture& texture);
+
+    // Deletes all pages.
+    void Clear();
+
+    // Forgets all pages without deleting them.
+    // Call when the OpenGL context has been lost.
+    void Reset();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef TEXTUREHANDLE_H
+#define TEXTUREHANDLE_H
+
+//
+// Refers to a texture by its slot in the TextureManager. The slot's
+// generation moves on when its texture is destroyed, so a handle kept
+// past that resolves to NULL rather than to freed memory. Generation 0 is
+// never used, a default handle is the null handle.
+//
+struct TextureHandle
+{
+    unsigned int index;
+    unsigned int generation;
+
+    TextureHandle() : index(0), generation(0) {}
+    TextureHandle(unsigned int index, unsigned int generation) :
+        index(index), generation(generation) {}
+
+    bool IsNull() const { return generation == 0; }
+    bool operator==(const TextureHandle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const TextureHandle& other) const { return !(*this == other); }
+};
+
+#endif
\ No newline at end of file
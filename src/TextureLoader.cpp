@@ -0,0 +1,248 @@
+#include "TextureLoader.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <deque>
+#include <string.h>
+#include <vector>
+
+#include "DDFile.h"
+#include "DDLog.h"
+#include "DDTime.h"
+#include "ImageDecoder.h"
+#include "JobSystem.h"
+#include "soil.h"
+
+struct TextureLoader::Job
+{
+    std::string name;
+    unsigned int serial;
+    TextureSampling sampling;
+    std::vector<unsigned char> file;
+    std::string path; // read by the worker if set
+};
+
+struct TextureLoader::Shared
+{
+    Mutex mutex;
+    Condition drained; // a drain job has exited
+    std::deque<TextureLoader::Job*> jobs;
+    std::deque<TextureLoader::Decoded> decoded;
+    unsigned int decoding;
+    unsigned int draining; // drain jobs on the job system
+    bool stopping;
+
+    Shared() : decoding(0), draining(0), stopping(false) {}
+};
+
+//
+// Decodes queued images until there are none left. At most the loader's
+// thread count of these run at once, so decoding can't take the whole pool.
+//
+struct TextureLoader::DrainJob : public ::Job
+{
+    Shared* shared;
+    virtual void Run() { TextureLoader::Work(shared); }
+};
+
+TextureLoader::TextureLoader() :
+    mShared(new Shared()),
+    mJobs(NULL),
+    mThreadCount(DEFAULT_THREADS)
+{
+}
+
+TextureLoader::~TextureLoader()
+{
+    mShared->mutex.Lock();
+    mShared->stopping = true;
+    while(mShared->draining > 0)
+    {
+        mShared->drained.Wait(mShared->mutex);
+    }
+    mShared->mutex.Unlock();
+
+    for(std::deque<Job*>::iterator it = mShared->jobs.begin();
+        it != mShared->jobs.end(); ++it)
+    {
+        delete (*it);
+    }
+
+    for(std::deque<Decoded>::iterator it = mShared->decoded.begin();
+        it != mShared->decoded.end(); ++it)
+    {
+        if(it->pixels != NULL)
+        {
+            SOIL_free_image_data(it->pixels);
+        }
+    }
+    delete mShared;
+}
+
+void TextureLoader::Work(Shared* shared)
+{
+    for(;;)
+    {
+        shared->mutex.Lock();
+        if(shared->jobs.empty() || shared->stopping)
+        {
+            shared->draining--;
+            shared->drained.Broadcast();
+            shared->mutex.Unlock();
+            return;
+        }
+
+        Job* job = shared->jobs.front();
+        shared->jobs.pop_front();
+        shared->decoding++;
+        shared->mutex.Unlock();
+
+        Decoded result;
+        result.name = job->name;
+        result.serial = job->serial;
+        result.sampling = job->sampling;
+        result.width = 0;
+        result.height = 0;
+        result.channels = 0;
+        result.pixels = NULL;
+        result.readBytes = 0;
+        result.readMicroseconds = 0;
+
+        unsigned long long start = DDTime::Microseconds();
+        if(job->path.empty())
+        {
+            result.pixels = ImageDecoder::Decode(&job->file[0],
+                                                 job->file.size(),
+                                                 &result.width,
+                                                 &result.height,
+                                                 &result.channels,
+                                                 SOIL_LOAD_AUTO);
+        }
+        else
+        {
+            DDFile file(job->path.c_str());
+            file.LoadFileView();
+            unsigned long long read = DDTime::Microseconds();
+            result.readBytes = file.Size();
+            result.readMicroseconds = read - start;
+            start = read;
+
+            if(file.Buffer() != NULL)
+            {
+                result.pixels = ImageDecoder::Decode(
+                    (const unsigned char*) file.Buffer(),
+                    file.Size(),
+                    &result.width,
+                    &result.height,
+                    &result.channels,
+                    SOIL_LOAD_AUTO);
+            }
+        }
+        result.decodeMicroseconds = DDTime::Microseconds() - start;
+        delete job;
+
+        shared->mutex.Lock();
+        shared->decoded.push_back(result);
+        shared->decoding--;
+        shared->mutex.Unlock();
+    }
+}
+
+void TextureLoader::Queue(const std::string& name,
+                          unsigned int serial,
+                          const TextureSampling& sampling,
+                          const char* file,
+                          unsigned int size)
+{
+    assert(file);
+    Job* job = new Job();
+    job->name = name;
+    job->serial = serial;
+    job->sampling = sampling;
+    job->file.assign(file, file + size);
+    Push(job);
+}
+
+void TextureLoader::QueuePath(const std::string& name,
+                              unsigned int serial,
+                              const TextureSampling& sampling,
+                              const char* path)
+{
+    assert(path);
+    Job* job = new Job();
+    job->name = name;
+    job->serial = serial;
+    job->sampling = sampling;
+    job->path = path;
+    Push(job);
+}
+
+void TextureLoader::Push(Job* job)
+{
+    assert(mJobs);
+    mShared->mutex.Lock();
+    mShared->jobs.push_back(job);
+    const bool drain = mShared->draining < std::max(mThreadCount, 1u);
+    if(drain)
+    {
+        mShared->draining++;
+    }
+    mShared->mutex.Unlock();
+
+    if(drain)
+    {
+        DrainJob* drainJob = new DrainJob();
+        drainJob->shared = mShared;
+        mJobs->Submit(drainJob);
+    }
+}
+
+bool TextureLoader::PopDecoded(Decoded* out)
+{
+    assert(out);
+    bool popped = false;
+
+    mShared->mutex.Lock();
+    if(!mShared->decoded.empty())
+    {
+        *out = mShared->decoded.front();
+        mShared->decoded.pop_front();
+        popped = true;
+    }
+    mShared->mutex.Unlock();
+    return popped;
+}
+
+unsigned int TextureLoader::Pending()
+{
+    mShared->mutex.Lock();
+    unsigned int pending = mShared->jobs.size()
+                         + mShared->decoding
+                         + mShared->decoded.size();
+    mShared->mutex.Unlock();
+    return pending;
+}
+
+bool TextureLoader::PeekSize(const char* file, unsigned int size, int* width, int* height)
+{
+    static const unsigned char PNG_SIGNATURE[8] =
+    {
+        0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'
+    };
+
+    if(ImageDecoder::PeekQoiSize((const unsigned char*) file, size, width, height))
+    {
+        return true;
+    }
+
+    // The IHDR chunk comes first, its width and height are big endian.
+    if(size < 24 || memcmp(file, PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) != 0)
+    {
+        return false;
+    }
+
+    const unsigned char* header = (const unsigned char*) file + 16;
+    *width = (header[0] << 24) | (header[1] << 16) | (header[2] << 8) | header[3];
+    *height = (header[4] << 24) | (header[5] << 16) | (header[6] << 8) | header[7];
+    return true;
+}
\ No newline at end of file
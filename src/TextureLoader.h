@@ -0,0 +1,81 @@
+#ifndef TEXTURELOADER_H
+#define TEXTURELOADER_H
+
+#include <string>
+
+#include "Texture.h"
+
+class JobSystem;
+
+//
+// Decodes image files on the job system. Files are read on the main
+// thread, which Android's asset loading needs, unless they can be viewed
+// without a copy. The decoded pixels are handed back to the main thread
+// for the GL upload.
+//
+class TextureLoader
+{
+public:
+    struct Decoded
+    {
+        std::string name;
+        unsigned int serial; // so stale results can be dropped
+        TextureSampling sampling;
+        unsigned char* pixels; // free with SOIL_free_image_data, NULL on failure
+        int width;
+        int height;
+        int channels;
+        // Worker time, for the AssetReport.
+        unsigned int readBytes; // 0 if the main thread read the file
+        unsigned long long readMicroseconds;
+        unsigned long long decodeMicroseconds;
+    };
+
+    static const unsigned int DEFAULT_THREADS = 2;
+
+    TextureLoader();
+    ~TextureLoader(); // waits for the workers, drops anything unfinished
+
+    // Must be set before anything's queued.
+    void SetJobSystem(JobSystem* jobs) { mJobs = jobs; }
+    // How many images may decode at once.
+    void SetThreadCount(unsigned int count) { mThreadCount = count; }
+
+    // Copies the file so the caller can free it.
+    void Queue(const std::string& name,
+               unsigned int serial,
+               const TextureSampling& sampling,
+               const char* file,
+               unsigned int size);
+
+    // The worker reads the file as well. Only for files DDFile can map or
+    // find in a pack, a PhysFS or Android read needs the main thread.
+    void QueuePath(const std::string& name,
+                   unsigned int serial,
+                   const TextureSampling& sampling,
+                   const char* path);
+
+    // False if nothing has finished decoding, never waits.
+    bool PopDecoded(Decoded* out);
+
+    // Jobs queued or decoded but not popped.
+    unsigned int Pending();
+
+    // Width and height from a PNG or QOI header, without decoding it.
+    static bool PeekSize(const char* file, unsigned int size, int* width, int* height);
+private:
+    struct Shared; // the queues, shared with the drain jobs
+    struct Job;
+    struct DrainJob;
+    Shared* mShared;
+    JobSystem* mJobs;
+    unsigned int mThreadCount;
+
+    void Push(Job* job);
+    static void Work(Shared* shared);
+
+    TextureLoader(const TextureLoader&);
+    TextureLoader& operator=(const TextureLoader&);
+};
+
+#endif
\ No newline at end of file
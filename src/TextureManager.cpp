@@ -1,13 +1,207 @@
 #include "TextureManager.h"
 
+#include <algorithm>
+#include <assert.h>
+#include <stdlib.h>
+#include <vector>
+
 #include "Asset.h"
+#include "AssetReport.h"
+#include "DDFile.h"
 #include "DDLog.h"
+#include "DDTime.h"
+#include "DinodeckGL.h"
+#include "GraphicsPipeline.h"
+#include "PathCache.h"
+#include "PushedFiles.h"
+#include "soil.h"
+
+#if ANDROID
+static const char* CompressedFlag = "compressed_android";
+#elif __APPLE__
+static const char* CompressedFlag = "compressed_mac";
+#else
+static const char* CompressedFlag = "compressed_windows";
+#endif
+
+static unsigned int NowMs()
+{
+    return (unsigned int) (DDTime::Microseconds() / 1000);
+}
+
+static bool UsedEarlier(const Texture* a, const Texture* b)
+{
+    return a->LastUsedFrame() < b->LastUsedFrame();
+}
+
+static TextureSampling::Storage ParseStorage(const char* name, const std::string& format)
+{
+    if(format == "rgba4444")
+    {
+        return TextureSampling::STORE_RGBA4444;
+    }
+    else if(format == "rgb565")
+    {
+        return TextureSampling::STORE_RGB565;
+    }
+    else if(format == "a8")
+    {
+        return TextureSampling::STORE_ALPHA8;
+    }
+    else if(format != "rgba8888")
+    {
+        dsprintf("Unknown format [%s] for [%s], keeping it as decoded.\n",
+                 format.c_str(), name);
+    }
+    return TextureSampling::STORE_DECODED;
+}
+
+TextureManager::~TextureManager()
+{
+    for(std::vector<Slot>::iterator it = mSlots.begin(); it != mSlots.end(); ++it)
+    {
+        if(it->owned)
+        {
+            delete it->texture;
+        }
+    }
+}
+
+unsigned int TextureManager::CreateSlot(Texture* texture, bool owned)
+{
+    unsigned int index = 0;
+    if(mFreeSlots.empty())
+    {
+        index = mSlots.size();
+        mSlots.push_back(Slot());
+    }
+    else
+    {
+        index = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+
+    Slot& slot = mSlots[index];
+    slot.texture = texture;
+    slot.owned = owned;
+    return index;
+}
+
+void TextureManager::DestroySlot(unsigned int index)
+{
+    Slot& slot = mSlots[index];
+    if(!slot.name.empty())
+    {
+        mSlotsByName.erase(slot.name);
+        mIndex.Erase(slot.name.c_str());
+        slot.name.clear();
+    }
+
+    if(slot.owned)
+    {
+        delete slot.texture;
+    }
+    slot.texture = NULL;
+    slot.owned = false;
+
+    // Handles to the old texture stop resolving.
+    slot.generation++;
+    if(slot.generation == 0)
+    {
+        slot.generation = 1;
+    }
+    mFreeSlots.push_back(index);
+}
+
+Texture& TextureManager::TextureFor(const std::string& name)
+{
+    std::map<std::string, unsigned int>::const_iterator
+        iter = mSlotsByName.find(name);
+    if(iter != mSlotsByName.end())
+    {
+        return *mSlots[iter->second].texture;
+    }
+
+    unsigned int index = CreateSlot(new Texture(), true);
+    mSlots[index].name = name;
+    mSlotsByName[name] = index;
+    return *mSlots[index].texture;
+}
+
+Texture* TextureManager::FindTexture(const std::string& name) const
+{
+    std::map<std::string, unsigned int>::const_iterator
+        iter = mSlotsByName.find(name);
+    return iter == mSlotsByName.end() ? NULL : mSlots[iter->second].texture;
+}
 
+TextureHandle TextureManager::AddExternal(Texture* texture)
+{
+    assert(texture);
+    unsigned int index = CreateSlot(texture, false);
+    return TextureHandle(index, mSlots[index].generation);
+}
+
+void TextureManager::RemoveExternal(TextureHandle handle)
+{
+    if(Resolve(handle) != NULL && !mSlots[handle.index].owned)
+    {
+        DestroySlot(handle.index);
+    }
+}
 
 void TextureManager::ClearTextures()
 {
-    // Clear out the textures from OpenGL
-    LoadedTextures.clear();
+    // Clear out the textures from OpenGL, external ones are left alone.
+    while(!mSlotsByName.empty())
+    {
+        DestroySlot(mSlotsByName.begin()->second);
+    }
+    mIndex.Clear();
+    mSources.clear();
+    mCache.clear();
+    mCachedBytes = 0;
+    mTransientBytes = 0;
+    mRestoreQueue.clear();
+    mLost.clear();
+    mSerials.clear(); // decodes still in flight are dropped when they land
+    mSharedDecodes.clear();
+    mDecodesByPath.clear();
+    mAtlas.Clear();
+}
+
+bool TextureManager::AddToAtlas
+(
+    const char* name,
+    const char* path,
+    const char* group,
+    bool pixelArt
+)
+{
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    unsigned char* image = Texture::LoadPixels(path, &width, &height,
+                                               &channels, SOIL_LOAD_RGBA);
+    if(image == NULL)
+    {
+        return false;
+    }
+
+    if(Texture::Premultiplies())
+    {
+        Texture::PremultiplyPixels(image, width, height, 4);
+    }
+
+    Texture& texture = TextureFor(name);
+    bool isAdded = mAtlas.Insert(group, image, width, height, pixelArt, &texture);
+    SOIL_free_image_data(image);
+
+    if(!isAdded)
+    {
+        dsprintf("[%s] too big for atlas [%s], loading on its own.\n", name, group);
+    }
+    return isAdded;
 }
 
 bool TextureManager::AddTexture
@@ -17,18 +211,46 @@ bool TextureManager::AddTexture
     std::map<std::string, std::string> flags
 )
 {
+    // A reload keeps the texture and its slot, so handles stay good.
+    TextureFor(name);
+
+    // Kept so an evicted texture can be loaded again.
+    Source& source = mSources[name];
+    source.path = path;
+    source.flags = flags;
+
+    //
+    // resident = "true" keeps a texture loaded whatever the budget, for
+    // textures only drawn through static layers.
+    //
+    std::map<std::string, std::string>::iterator
+       iter = flags.find("resident");
+    TextureFor(name).SetPinned(iter != flags.end()
+                                   && iter->second == std::string("true"));
+
+    if(!LoadTexture(name, path, flags))
     {
-        Texture texture;
-        LoadedTextures.insert
-        (
-            std::pair<std::string, Texture>
-            (
-                std::string(name),
-                texture
-            )
-        );
+        DestroySlot(mSlotsByName[name]);
+        mSources.erase(name);
+        return false;
     }
-    bool pixelArt = false;
+    return true;
+}
+
+TextureHandle TextureManager::AddPlaceholder(const char* name, int width, int height)
+{
+    TextureFor(name).SetPlaceholderSize(width, height);
+    return GetHandle(name);
+}
+
+bool TextureManager::LoadTexture
+(
+    const char* name,
+    const char* path,
+    std::map<std::string, std::string>& flags
+)
+{
+    TextureSampling sampling;
 
     //
     // Check for pixel art flag
@@ -38,49 +260,713 @@ bool TextureManager::AddTexture
     if(iter != flags.end())
     {
         dsprintf("Scale flag found for [%s] value [%s].\n", name, iter->second.c_str());
-        pixelArt = (iter->second == std::string("pixelart"));
+        sampling.pixelArt = (iter->second == std::string("pixelart"));
     }
 
-    bool isLoaded = LoadedTextures[name].LoadDDSTexture(path, pixelArt);
+    //
+    // Mipmaps for textures drawn zoomed out, mipmaps = "true".
+    // anisotropy = "4" for example, sharpens them where supported.
+    //
+    iter = flags.find("mipmaps");
+    if(iter != flags.end())
+    {
+        sampling.mipmaps = (iter->second == std::string("true"));
+    }
 
-    if(isLoaded == false)
+    iter = flags.find("anisotropy");
+    if(iter != flags.end())
+    {
+        sampling.anisotropy = (float) atof(iter->second.c_str());
+    }
+
+    //
+    // format = "rgba4444", "rgb565" or "a8" stores the texture in less
+    // memory, fine for most UI and pixel art. dither = "true" hides the
+    // banding of the 16 bit formats. Atlased and compressed textures keep
+    // their own formats.
+    //
+    iter = flags.find("format");
+    if(iter != flags.end())
+    {
+        sampling.storage = ParseStorage(name, iter->second);
+    }
+
+    iter = flags.find("dither");
+    if(iter != flags.end())
+    {
+        sampling.dither = (iter->second == std::string("true"));
+    }
+
+    // A reload replaces any region the texture had in the atlas.
+    mAtlas.Release(TextureFor(name));
+    // and any decode still in flight for it.
+    mSerials.erase(name);
+
+    //
+    // A compressed variant for this platform, compressed_android = "x.ktx"
+    // for example. It's skipped if the GL can't take its format.
+    //
+    iter = flags.find(CompressedFlag);
+    if(iter != flags.end() && !iter->second.empty())
+    {
+        if(TextureFor(name).LoadCompressedTexture(iter->second.c_str(), sampling))
+        {
+            return true;
+        }
+        dsprintf("Using [%s] rather than its compressed variant.\n", path);
+    }
+
+    //
+    // Check for atlas flag, the value is the group to pack into.
+    //
+    iter = flags.find("atlas");
+    if(iter != flags.end() && !iter->second.empty())
+    {
+        // Pages aren't mipmapped, neighbours would bleed into each other.
+        if(AddToAtlas(name, path, iter->second.c_str(), sampling.pixelArt))
+        {
+            return true;
+        }
+    }
+
+    // Pixels kept from an earlier load, or decoded for another texture
+    // of the same file, only need uploading.
+    CachedImage* cached = FindCached(path);
+    if(cached != NULL)
+    {
+        TextureFor(name).LoadPixelTexture(&cached->pixels[0],
+                                              cached->width,
+                                              cached->height,
+                                              cached->channels,
+                                              sampling);
+        CacheImage(name, path, &cached->pixels[0],
+                   cached->width, cached->height, cached->channels);
+        return true;
+    }
+
+    // A changed file is decoded off the main thread whatever the async
+    // setting, the old texture draws until it's uploaded in place.
+    const bool reload = TextureFor(name).HasOwnTexture();
+    if((mAsync || reload) && QueueDecode(name, path, sampling))
+    {
+        return true;
+    }
+
+    if(Texture::IsCompressedFile(path))
+    {
+        return TextureFor(name).LoadDDSTexture(path, sampling);
+    }
+
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    unsigned char* image = Texture::LoadPixels(path, &width, &height,
+                                               &channels, SOIL_LOAD_AUTO);
+    if(image == NULL)
     {
-        LoadedTextures.erase(LoadedTextures.find(name));
         return false;
     }
 
+    TextureFor(name).LoadPixelTexture(image, width, height, channels, sampling);
+    CacheImage(name, path, image, width, height, channels);
+    SOIL_free_image_data(image);
     return true;
 }
 
-Texture* TextureManager::GetTexture(const char* name)
+void TextureManager::SetCacheBudget(unsigned int bytes)
 {
-    if(LoadedTextures.find(name) == LoadedTextures.end())
+    mCacheBudgetBytes = bytes;
+    if(bytes == 0)
+    {
+        mCache.clear();
+        mCachedBytes = 0;
+        mTransientBytes = 0;
+    }
+}
+
+unsigned int TextureManager::ReleaseCache()
+{
+    const unsigned int bytes = mCachedBytes + mTransientBytes;
+    mCache.clear();
+    mCachedBytes = 0;
+    mTransientBytes = 0;
+    return bytes;
+}
+
+void TextureManager::CacheImage
+(
+    const std::string& name,
+    const std::string& path,
+    const unsigned char* pixels,
+    int width,
+    int height,
+    int channels
+)
+{
+    // Already there for another texture of the same file.
+    CachedImage* shared = FindCached(path.c_str());
+    if(shared != NULL)
+    {
+        UncacheImage(name, path);
+        shared->names.insert(name);
+        return;
+    }
+
+    UncacheImage(name);
+    std::map<std::string, CachedImage>::iterator stale = mCache.find(path);
+    if(stale != mCache.end())
+    {
+        EraseCached(stale);
+    }
+
+    // Pushed files aren't on disk, a push wouldn't show as a change.
+    if(PushedFiles::Exists(path.c_str()))
+    {
+        return;
+    }
+
+    // Whatever doesn't fit is decoded again after a context loss.
+    const unsigned int bytes = width * height * channels;
+    const bool kept = mCacheBudgetBytes > 0
+                      && mCachedBytes + bytes <= mCacheBudgetBytes;
+    if(!kept && mTransientBytes + bytes > TRANSIENT_CACHE_BYTES)
+    {
+        return;
+    }
+
+    struct stat s;
+    const bool found = PathCache::Stat(path.c_str(), &s);
+
+    CachedImage& cached = mCache[path];
+    cached.pixels.assign(pixels, pixels + bytes);
+    cached.width = width;
+    cached.height = height;
+    cached.channels = channels;
+    cached.modified = found ? s.st_mtime : 0;
+    cached.size = found ? (long) s.st_size : 0;
+    cached.names.insert(name);
+    cached.transient = !kept;
+    if(kept)
+    {
+        mCachedBytes += bytes;
+    }
+    else
+    {
+        mTransientBytes += bytes;
+    }
+}
+
+void TextureManager::UncacheImage(const std::string& name, const std::string& except)
+{
+    std::map<std::string, CachedImage>::iterator iter = mCache.begin();
+    while(iter != mCache.end())
+    {
+        std::map<std::string, CachedImage>::iterator next = iter;
+        ++next;
+        if(iter->first != except
+           && iter->second.names.erase(name) > 0
+           && iter->second.names.empty()
+           && !iter->second.transient)
+        {
+            EraseCached(iter);
+        }
+        iter = next;
+    }
+}
+
+void TextureManager::EraseCached(std::map<std::string, CachedImage>::iterator iter)
+{
+    if(iter->second.transient)
+    {
+        mTransientBytes -= iter->second.pixels.size();
+    }
+    else
+    {
+        mCachedBytes -= iter->second.pixels.size();
+    }
+    mCache.erase(iter);
+}
+
+TextureManager::CachedImage* TextureManager::FindCached(const char* path)
+{
+    std::map<std::string, CachedImage>::iterator iter = mCache.find(path);
+    if(iter == mCache.end() || PushedFiles::Exists(path))
     {
-        dsprintf("ERROR: Couldn't find texture [%s]", name);
         return NULL;
     }
-    return &LoadedTextures.find(name)->second;
+
+    // Files in packs don't stat, they can't change under a running game.
+    struct stat s;
+    const bool found = PathCache::Stat(path, &s);
+    if(iter->second.modified != (found ? s.st_mtime : 0)
+       || iter->second.size != (found ? (long) s.st_size : 0))
+    {
+        return NULL;
+    }
+    return &iter->second;
+}
+
+//
+// Uploads cached textures lost with the context, in the time left over.
+// Those drawn in the meantime were already restored as they were used.
+//
+void TextureManager::RestoreQueued(unsigned int start)
+{
+    while(!mRestoreQueue.empty()
+          && NowMs() - start < (unsigned int) mUploadBudgetMs)
+    {
+        const std::string name = mRestoreQueue.front();
+        mRestoreQueue.pop_front();
+
+        Texture* texture = FindTexture(name);
+        std::map<std::string, Source>::iterator
+            source = mSources.find(name);
+        if(texture == NULL
+           || source == mSources.end()
+           || !texture->IsEvicted())
+        {
+            continue;
+        }
+
+        if(!LoadTexture(name.c_str(), source->second.path.c_str(), source->second.flags))
+        {
+            dsprintf("Failed to restore texture [%s].\n", name.c_str());
+        }
+    }
+}
+
+void TextureManager::RestoreTexture(Texture* texture)
+{
+    for(std::vector<Slot>::iterator iter = mSlots.begin(); iter != mSlots.end(); ++iter)
+    {
+        if(iter->texture != texture || iter->name.empty())
+        {
+            continue;
+        }
+
+        const std::string name = iter->name; // LoadTexture may add slots
+        std::map<std::string, Source>::iterator
+            source = mSources.find(name);
+        if(source == mSources.end()
+           || !LoadTexture(name.c_str(),
+                           source->second.path.c_str(),
+                           source->second.flags))
+        {
+            dsprintf("Failed to reload evicted texture [%s].\n", name.c_str());
+        }
+
+        // It may be restored mid batch, behind the state cache's back.
+        GraphicsPipeline::GLState().InvalidateTexture();
+        return;
+    }
+}
+
+void TextureManager::NewFrame()
+{
+    Texture::NewFrame();
+
+    // Decodes past the cache budget were only kept for the textures
+    // loaded alongside them.
+    if(mTransientBytes > 0)
+    {
+        std::map<std::string, CachedImage>::iterator iter = mCache.begin();
+        while(iter != mCache.end())
+        {
+            std::map<std::string, CachedImage>::iterator next = iter;
+            ++next;
+            if(iter->second.transient)
+            {
+                EraseCached(iter);
+            }
+            iter = next;
+        }
+    }
+
+    if(mBudgetBytes == 0)
+    {
+        return;
+    }
+
+    unsigned int resident = 0;
+    std::vector<Texture*> candidates;
+    for(std::vector<Slot>::iterator iter = mSlots.begin(); iter != mSlots.end(); ++iter)
+    {
+        if(!iter->owned)
+        {
+            continue;
+        }
+        Texture& texture = *iter->texture;
+        resident += texture.Bytes();
+
+        // Anything drawn last frame is likely drawn again this one.
+        if(texture.IsEvictable()
+           && texture.LastUsedFrame() + 1 < Texture::Frame())
+        {
+            candidates.push_back(&texture);
+        }
+    }
+
+    if(resident <= mBudgetBytes)
+    {
+        return;
+    }
+
+    std::sort(candidates.begin(), candidates.end(), UsedEarlier);
+    for(std::vector<Texture*>::iterator it = candidates.begin();
+        it != candidates.end() && resident > mBudgetBytes; ++it)
+    {
+        resident -= (*it)->Bytes();
+        (*it)->Evict();
+        mEvictions++;
+    }
+
+    if(resident > mBudgetBytes)
+    {
+        dsprintf("Textures in use need %d KB, over the %d KB budget.\n",
+                 (int) (resident / 1024), (int) (mBudgetBytes / 1024));
+    }
+}
+
+void TextureManager::ForgetTextures()
+{
+    for(std::vector<Slot>::iterator iter = mSlots.begin(); iter != mSlots.end(); ++iter)
+    {
+        if(!iter->owned)
+        {
+            continue;
+        }
+        iter->texture->Forget();
+        if(iter->texture->IsEvicted())
+        {
+            mLost.insert(iter->name);
+        }
+    }
+    mRestoreQueue.clear();
+}
+
+unsigned int TextureManager::ResidentBytes() const
+{
+    unsigned int resident = 0;
+    for(std::vector<Slot>::const_iterator iter = mSlots.begin(); iter != mSlots.end(); ++iter)
+    {
+        if(iter->owned)
+        {
+            resident += iter->texture->Bytes();
+        }
+    }
+    return resident;
+}
+
+//
+// Reads the file here, as Android's asset reads aren't thread safe, and
+// leaves the decode to the loader. Files that can be viewed in place are
+// only peeked at and the worker reads them. False if it should load
+// synchronously.
+//
+bool TextureManager::QueueDecode
+(
+    const char* name,
+    const char* path,
+    const TextureSampling& sampling
+)
+{
+    // The same file's already decoding for another texture, this one
+    // is uploaded from those pixels too.
+    struct stat s;
+    const bool found = PathCache::Stat(path, &s);
+    const time_t modified = found ? s.st_mtime : 0;
+    const long size = found ? (long) s.st_size : 0;
+    std::map<std::string, unsigned int>::iterator
+        inFlight = mDecodesByPath.find(path);
+    if(inFlight != mDecodesByPath.end()
+       && mSharedDecodes[inFlight->second].modified == modified
+       && mSharedDecodes[inFlight->second].size == size
+       && !PushedFiles::Exists(path))
+    {
+        SharedDecode& shared = mSharedDecodes[inFlight->second];
+        TextureFor(name).SetPlaceholderSize(shared.width, shared.height);
+        DecodeWaiter waiter;
+        waiter.name = name;
+        waiter.serial = ++mNextSerial;
+        waiter.sampling = sampling;
+        mSerials[name] = waiter.serial;
+        shared.waiters.push_back(waiter);
+        return true;
+    }
+
+    unsigned long long start = DDTime::Microseconds();
+    DDFile file(path);
+    file.LoadFileView();
+
+    if(NULL == file.Buffer())
+    {
+        return false;
+    }
+
+    // Views are read by the worker, it reports them.
+    if(!file.IsView())
+    {
+        AssetReport::AddRead(name, file.Size(), DDTime::Microseconds() - start);
+    }
+
+    // Without the size up front, scripts laying out sprites would see 0x0.
+    int width = 0;
+    int height = 0;
+    if(!TextureLoader::PeekSize(file.Buffer(), file.Size(), &width, &height))
+    {
+        return false;
+    }
+
+    // A reload keeps drawing the old texture until the new one is in.
+    TextureFor(name).SetPlaceholderSize(width, height);
+    unsigned int serial = ++mNextSerial;
+    mSerials[name] = serial;
+    SharedDecode& shared = mSharedDecodes[serial];
+    shared.path = path;
+    shared.modified = modified;
+    shared.size = size;
+    shared.width = width;
+    shared.height = height;
+    mDecodesByPath[path] = serial;
+
+#if !ANDROID
+    if(file.IsView())
+    {
+        mLoader.QueuePath(name, serial, sampling, path);
+        return true;
+    }
+#endif
+
+    mLoader.Queue(name, serial, sampling, file.Buffer(), file.Size());
+    return true;
+}
+
+bool TextureManager::IsCurrent(const std::string& name, unsigned int serial)
+{
+    std::map<std::string, unsigned int>::iterator iter = mSerials.find(name);
+    return iter != mSerials.end()
+        && iter->second == serial
+        && FindTexture(name) != NULL;
+}
+
+void TextureManager::OnDecoded(TextureLoader::Decoded& decoded)
+{
+    const char* name = decoded.name.c_str();
+    AssetReport::AddRead(name, decoded.readBytes, decoded.readMicroseconds);
+    AssetReport::AddDecode(name, decoded.decodeMicroseconds);
+
+    // Textures of the same file that queued while this was decoding.
+    std::string path = mSources[decoded.name].path;
+    std::vector<DecodeWaiter> waiters;
+    std::map<unsigned int, SharedDecode>::iterator
+        shared = mSharedDecodes.find(decoded.serial);
+    if(shared != mSharedDecodes.end())
+    {
+        path = shared->second.path;
+        waiters.swap(shared->second.waiters);
+        mSharedDecodes.erase(shared);
+        std::map<std::string, unsigned int>::iterator
+            inFlight = mDecodesByPath.find(path);
+        if(inFlight != mDecodesByPath.end() && inFlight->second == decoded.serial)
+        {
+            mDecodesByPath.erase(inFlight);
+        }
+    }
+
+    if(decoded.pixels == NULL)
+    {
+        dsprintf("Texture failed to load:[%s]\n", decoded.name.c_str());
+        if(IsCurrent(decoded.name, decoded.serial))
+        {
+            mSerials.erase(decoded.name); // nothing more is coming
+        }
+        for(std::vector<DecodeWaiter>::iterator it = waiters.begin(); it != waiters.end(); ++it)
+        {
+            if(IsCurrent(it->name, it->serial))
+            {
+                dsprintf("Texture failed to load:[%s]\n", it->name.c_str());
+                mSerials.erase(it->name);
+            }
+        }
+        return;
+    }
+
+    for(std::vector<DecodeWaiter>::iterator it = waiters.begin(); it != waiters.end(); ++it)
+    {
+        if(IsCurrent(it->name, it->serial))
+        {
+            CacheImage(it->name, path, decoded.pixels,
+                       decoded.width, decoded.height, decoded.channels);
+            Texture& texture = TextureFor(it->name);
+            texture.LoadPixelTexture(decoded.pixels,
+                                     decoded.width,
+                                     decoded.height,
+                                     decoded.channels,
+                                     it->sampling);
+            AssetReport::SetMemory(it->name.c_str(), texture.Bytes());
+        }
+    }
+
+    if(IsCurrent(decoded.name, decoded.serial))
+    {
+        CacheImage(decoded.name, path, decoded.pixels,
+                   decoded.width, decoded.height, decoded.channels);
+
+        // A reload that fits the texture it's replacing is one upload
+        // rather than a new texture streamed in.
+        Texture& texture = TextureFor(decoded.name);
+        if(!texture.CanLoadInPlace(decoded.width, decoded.height,
+                                   decoded.channels, decoded.sampling)
+           && mStreamer.ShouldStream(decoded))
+        {
+            mStreamer.Begin(decoded); // it frees the pixels when done
+            return;
+        }
+
+        unsigned long long start = DDTime::Microseconds();
+        texture.LoadPixelTexture(decoded.pixels,
+                                 decoded.width,
+                                 decoded.height,
+                                 decoded.channels,
+                                 decoded.sampling);
+        AssetReport::AddUpload(name, DDTime::Microseconds() - start);
+        AssetReport::SetMemory(name, texture.Bytes());
+    }
+    SOIL_free_image_data(decoded.pixels);
+}
+
+void TextureManager::UploadDecoded()
+{
+    const unsigned int start = NowMs();
+
+    // Streams get their share of the frame first, so a big background
+    // can't be starved by a queue of small sprites.
+    if(mStreamer.IsStreaming())
+    {
+        std::vector<TextureStreamer::Stream> finished;
+        mStreamer.Update(&finished);
+
+        for(std::vector<TextureStreamer::Stream>::iterator it = finished.begin();
+            it != finished.end(); ++it)
+        {
+            const TextureLoader::Decoded& image = it->image;
+            if(IsCurrent(image.name, image.serial))
+            {
+                TextureFor(image.name).AdoptStreamedTexture(it->id,
+                                                                image.pixels,
+                                                                image.width,
+                                                                image.height,
+                                                                image.channels,
+                                                                image.sampling);
+            }
+            else
+            {
+                glDeleteTextures(1, &it->id);
+            }
+            SOIL_free_image_data(image.pixels);
+        }
+    }
+
+    // At least one upload a frame, so a slow one can't stall loading.
+    TextureLoader::Decoded decoded;
+    while(mLoader.PopDecoded(&decoded))
+    {
+        OnDecoded(decoded);
+        if(mLoader.Pending() == 0)
+        {
+            AssetReport::Snapshot(); // the webserver's copy
+        }
+
+        if(NowMs() - start >= (unsigned int) mUploadBudgetMs)
+        {
+            break;
+        }
+    }
+
+    RestoreQueued(start);
+}
+
+TextureHandle TextureManager::GetHandle(const char* name)
+{
+    unsigned int* cached = mIndex.Find(name);
+    if(cached)
+    {
+        return TextureHandle(*cached, mSlots[*cached].generation);
+    }
+
+    std::map<std::string, unsigned int>::const_iterator
+        iter = mSlotsByName.find(name);
+    if(iter == mSlotsByName.end())
+    {
+        dsprintf("ERROR: Couldn't find texture [%s]", name);
+        return TextureHandle();
+    }
+    mIndex.Set(name, iter->second);
+    return TextureHandle(iter->second, mSlots[iter->second].generation);
+}
+
+bool TextureManager::IsLoading(const char* name) const
+{
+    const Texture* texture = FindTexture(name);
+    return texture != NULL
+        && texture->GetId() == 0
+        && !texture->IsEvicted()
+        && mSerials.find(name) != mSerials.end();
 }
 
 // IAssetOwner stuff
 bool TextureManager::OnAssetReload(Asset& asset)
 {
+    const std::string& name = asset.Name();
+    if(mLost.erase(name) > 0)
+    {
+        Source& source = mSources[name];
+        source.path = asset.Path();
+        source.flags = asset.Flags();
+
+        // With a budget, textures lost with the context come back as
+        // they're drawn rather than all at once. Cached ones come back as
+        // they're drawn or as time allows, without being decoded again.
+        Texture* texture = FindTexture(name);
+        if(mBudgetBytes > 0
+           || (texture != NULL && !texture->IsEvicted()))
+        {
+            return true; // or it was drawn and restored already
+        }
+
+        if(FindCached(asset.Path().c_str()) != NULL)
+        {
+            mRestoreQueue.push_back(name);
+            return true;
+        }
+    }
+    else
+    {
+        // Changed on disk, the cached pixels are out of date.
+        UncacheImage(name);
+    }
+
     return AddTexture(asset.Name().c_str(), asset.Path().c_str(), asset.Flags());
 }
 
 void TextureManager::OnAssetDestroyed(Asset& asset)
 {
-    std::map<std::string, Texture>::iterator iter = LoadedTextures.find(asset.Name());
-    if(iter == LoadedTextures.end())
+    std::map<std::string, unsigned int>::iterator iter = mSlotsByName.find(asset.Name());
+    if(iter == mSlotsByName.end())
     {
         if(asset.IsLoaded())
         {
-            dsprintf("Asset destroyed [%s]. Asset reported to be loaded, but texture not in LoadedTextures.\n", asset.Name().c_str());
+            dsprintf("Asset destroyed [%s]. Asset reported to be loaded, but texture not in the texture table.\n", asset.Name().c_str());
             dsprintf("Something has gone wrong.\n");
         }
     }
     else
     {
-        LoadedTextures.erase(iter);
+        mAtlas.Release(*mSlots[iter->second].texture);
+        DestroySlot(iter->second);
+        mSerials.erase(asset.Name());
+        mSources.erase(asset.Name());
+        UncacheImage(asset.Name());
+        mLost.erase(asset.Name());
     }
 }
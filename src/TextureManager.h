@@ -1,24 +1,209 @@
 #ifndef TEXTUREMANAGER_H
 #define TEXTUREMANAGER_H
 
+#include <deque>
 #include <string>
 #include <map>
+#include <set>
+#include <time.h>
+#include <vector>
 
 #include "IAssetOwner.h"
+#include "NameTable.h"
 #include "Texture.h"
+#include "TextureAtlas.h"
+#include "TextureHandle.h"
+#include "TextureLoader.h"
+#include "TextureStreamer.h"
 
 
 class Asset;
 
+//
+// Textures live in a dense table of slots. Names are resolved to a
+// TextureHandle once, after that finding a texture is an index and a
+// generation check.
+//
 class TextureManager : public IAssetOwner
 {
 private:
-    std::map<std::string, Texture> LoadedTextures;
+    struct Slot
+    {
+        Texture* texture; // NULL while the slot's free
+        unsigned int generation;
+        bool owned; // false for textures registered with AddExternal
+        std::string name; // empty for external textures
+
+        Slot() : texture(NULL), generation(1), owned(false) {}
+    };
+    struct Source
+    {
+        std::string path;
+        std::map<std::string, std::string> flags;
+    };
+    // Decoded pixels kept on the CPU by path, so a lost context only
+    // needs them uploaded again and textures made from the same file
+    // share one decode. Transient ones are over the cache budget and only
+    // kept for the rest of the frame, for the manifest's other entries.
+    struct CachedImage
+    {
+        std::vector<unsigned char> pixels;
+        int width;
+        int height;
+        int channels;
+        // The file's stat when it was decoded, a change makes it stale.
+        time_t modified;
+        long size;
+        std::set<std::string> names; // textures made from it
+        bool transient;
+    };
+    // A texture waiting on a decode of the same file for another.
+    struct DecodeWaiter
+    {
+        std::string name;
+        unsigned int serial;
+        TextureSampling sampling;
+    };
+    struct SharedDecode
+    {
+        std::string path;
+        time_t modified; // as CachedImage, a later change isn't shared
+        long size;
+        int width;
+        int height;
+        std::vector<DecodeWaiter> waiters;
+    };
+    std::vector<Slot> mSlots;
+    std::vector<unsigned int> mFreeSlots;
+    std::map<std::string, unsigned int> mSlotsByName;
+    NameIndex<unsigned int> mIndex; // GetHandle's cache of mSlotsByName
+    std::map<std::string, Source> mSources;
+    std::map<std::string, CachedImage> mCache; // by path
+    unsigned int mCacheBudgetBytes; // 0 turns the cache off
+    unsigned int mCachedBytes;
+    unsigned int mTransientBytes;
+    // Decodes in flight, by serial and by the path being decoded.
+    std::map<unsigned int, SharedDecode> mSharedDecodes;
+    std::map<std::string, unsigned int> mDecodesByPath;
+    // Cached textures waiting to be uploaded after a context loss.
+    std::deque<std::string> mRestoreQueue;
+    // Lost with the context, as opposed to changed on disk.
+    std::set<std::string> mLost;
+    unsigned int mBudgetBytes; // 0 keeps every texture resident
+    unsigned int mEvictions;
+    TextureAtlas mAtlas;
+    TextureLoader mLoader;
+    TextureStreamer mStreamer;
+    // Bumped each time a texture is queued, older decodes are dropped.
+    std::map<std::string, unsigned int> mSerials;
+    unsigned int mNextSerial;
+    bool mAsync;
+    int mUploadBudgetMs;
+    unsigned int CreateSlot(Texture* texture, bool owned);
+    void DestroySlot(unsigned int index);
+    // The named texture, made if there isn't one.
+    Texture& TextureFor(const std::string& name);
+    // NULL if there's no texture by that name.
+    Texture* FindTexture(const std::string& name) const;
+    bool AddToAtlas(const char* name, const char* path,
+                    const char* group, bool pixelArt);
+    void OnDecoded(TextureLoader::Decoded& decoded);
+    bool IsCurrent(const std::string& name, unsigned int serial);
+    bool LoadTexture(const char* name, const char* path,
+                     std::map<std::string, std::string>& flags);
+    bool QueueDecode(const char* name, const char* path,
+                     const TextureSampling& sampling);
+    void CacheImage(const std::string& name, const std::string& path,
+                    const unsigned char* pixels, int width, int height, int channels);
+    // Drops the name from the cached files but except.
+    void UncacheImage(const std::string& name,
+                      const std::string& except = std::string());
+    void EraseCached(std::map<std::string, CachedImage>::iterator iter);
+    // NULL if the file's not cached or has changed since.
+    CachedImage* FindCached(const char* path);
+    void RestoreQueued(unsigned int start);
 public:
-    Texture* GetTexture(const char* name);
+    static const int DEFAULT_UPLOAD_BUDGET_MS = 4;
+    // Decodes kept to the end of the frame beyond the cache budget.
+    static const unsigned int TRANSIENT_CACHE_BYTES = 32 * 1024 * 1024;
+
+    TextureManager() :
+        mCacheBudgetBytes(0),
+        mCachedBytes(0),
+        mTransientBytes(0),
+        mBudgetBytes(0),
+        mEvictions(0),
+        mNextSerial(0),
+        mAsync(false),
+        mUploadBudgetMs(DEFAULT_UPLOAD_BUDGET_MS) {}
+    ~TextureManager();
+    // The null handle if there's no texture by that name.
+    TextureHandle GetHandle(const char* name);
+    // NULL if the handle's texture has been destroyed since.
+    Texture* Resolve(TextureHandle handle) const
+    {
+        if(handle.index >= mSlots.size())
+        {
+            return NULL;
+        }
+        const Slot& slot = mSlots[handle.index];
+        return slot.generation == handle.generation ? slot.texture : NULL;
+    }
+    Texture* GetTexture(const char* name) { return Resolve(GetHandle(name)); }
+    // A texture owned elsewhere, like a render target's, given a handle
+    // so it can be drawn like any other. Remove it before it's destroyed.
+    TextureHandle AddExternal(Texture* texture);
+    void RemoveExternal(TextureHandle handle);
     bool AddTexture(const char* name, const char* path,
                     std::map<std::string, std::string> flags);
+    // Nothing's uploaded, it draws untextured at this size. For tools
+    // that need a texture to find, like the micro benchmarks.
+    TextureHandle AddPlaceholder(const char* name, int width, int height);
     void ClearTextures();
+    // The atlas pages went with the old OpenGL context.
+    void ResetAtlas() { mAtlas.Reset(); }
+    // As did the textures being streamed in.
+    void ResetStreams() { mStreamer.Reset(); }
+
+    //
+    // Residency. Over the budget, textures that haven't been drawn
+    // recently are evicted and reloaded when they're next used.
+    //
+    void SetBudget(unsigned int bytes) { mBudgetBytes = bytes; }
+    unsigned int Budget() const { return mBudgetBytes; }
+    unsigned int ResidentBytes() const;
+    unsigned int Evictions() const { return mEvictions; }
+    // Call once a frame before drawing.
+    void NewFrame();
+    void RestoreTexture(Texture* texture);
+    // Marks every texture evicted, their GL textures went with the context.
+    void ForgetTextures();
+
+    // Keeps up to this much decoded pixel data, 0 keeps none.
+    void SetCacheBudget(unsigned int bytes);
+    unsigned int CachedBytes() const { return mCachedBytes; }
+    // Drops every decoded image, a lost context decodes them again.
+    // Returns the bytes freed.
+    unsigned int ReleaseCache();
+
+    // Decode textures on worker threads, they draw untextured until
+    // they're uploaded.
+    void SetAsync(bool value) { mAsync = value; }
+    void SetDecodeThreads(unsigned int count) { mLoader.SetThreadCount(count); }
+    void SetJobSystem(JobSystem* jobs) { mLoader.SetJobSystem(jobs); }
+    void SetUploadBudget(int ms) { mUploadBudgetMs = ms; }
+    // Decoded textures bigger than this go up in bands over several
+    // frames, 0 uploads them whole.
+    void SetStreamBytesPerFrame(unsigned int bytes) { mStreamer.SetBytesPerFrame(bytes); }
+    // Uploads decoded textures until the frame's budget is spent.
+    // Call once a frame on the GL thread.
+    void UploadDecoded();
+    unsigned int PendingDecodes() { return mLoader.Pending(); }
+    // True while a background decode hasn't got the texture onto the GPU.
+    // A reload isn't loading, the old texture draws in the meantime.
+    bool IsLoading(const char* name) const;
+    // True while anything is decoding, streaming or waiting to upload.
+    bool IsLoadingAny() { return mLoader.Pending() > 0 || mStreamer.IsStreaming(); }
 
     // IAssetOwner stuff
     virtual bool OnAssetReload(Asset& asset);
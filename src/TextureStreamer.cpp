@@ -0,0 +1,176 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
+
+#include "DDLog.h"
+#include "soil.h"
+#include "Texture.h"
+
+static unsigned int ImageBytes(const TextureLoader::Decoded& image)
+{
+    return image.width * image.height * image.channels;
+}
+
+//
+// Images stored in 16 bit or alpha formats are converted whole, and
+// they're half the size or less once they are, so they're uploaded in one.
+//
+bool TextureStreamer::ShouldStream(const TextureLoader::Decoded& image) const
+{
+    return mBytesPerFrame > 0
+        && image.pixels != NULL
+        && image.sampling.storage == TextureSampling::STORE_DECODED
+        && ImageBytes(image) > mBytesPerFrame;
+}
+
+bool TextureStreamer::UsePixelBuffer()
+{
+#if DINODECK_PBO_UPLOADS
+    if(!(GLEE_VERSION_2_1 || GLEE_ARB_pixel_buffer_object))
+    {
+        return false;
+    }
+
+    if(mPixelBuffer == 0)
+    {
+        glGenBuffers(1, &mPixelBuffer);
+    }
+    return mPixelBuffer != 0;
+#else
+    return false;
+#endif
+}
+
+void TextureStreamer::Begin(const TextureLoader::Decoded& image)
+{
+    assert(image.pixels);
+
+    Stream stream;
+    stream.image = image;
+    stream.nextRow = 0;
+    glGenTextures(1, &stream.id);
+
+    if(stream.id == 0)
+    {
+        dsprintf("Failed to create texture for [%s].\n", image.name.c_str());
+        SOIL_free_image_data(stream.image.pixels);
+        return;
+    }
+
+    if(Texture::Premultiplies())
+    {
+        Texture::PremultiplyPixels(stream.image.pixels, image.width,
+                                   image.height, image.channels);
+    }
+
+    // Storage only, the rows follow over the next frames.
+    const GLenum format = Texture::PixelFormat(image.channels);
+    glBindTexture(GL_TEXTURE_2D, stream.id);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0,
+                 format, GL_UNSIGNED_BYTE, NULL);
+    mStreams.push_back(stream);
+}
+
+void TextureStreamer::UploadRows(Stream& stream, int rows)
+{
+    const TextureLoader::Decoded& image = stream.image;
+    const GLenum format = Texture::PixelFormat(image.channels);
+    const unsigned int rowBytes = image.width * image.channels;
+    const unsigned char* source = image.pixels + stream.nextRow * rowBytes;
+    const void* pixels = source;
+
+    glBindTexture(GL_TEXTURE_2D, stream.id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+#if DINODECK_PBO_UPLOADS
+    bool mapped = false;
+    if(UsePixelBuffer())
+    {
+        // Orphaned each band so the copy never waits on the last upload.
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mPixelBuffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, rows * rowBytes, NULL, GL_STREAM_DRAW);
+        void* destination = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+        if(destination != NULL)
+        {
+            memcpy(destination, source, rows * rowBytes);
+            mapped = (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE);
+        }
+
+        if(mapped)
+        {
+            pixels = NULL; // an offset into the bound buffer
+        }
+        else
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+    }
+#endif
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, stream.nextRow, image.width, rows,
+                    format, GL_UNSIGNED_BYTE, pixels);
+
+#if DINODECK_PBO_UPLOADS
+    if(mapped)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+#endif
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    stream.nextRow += rows;
+}
+
+void TextureStreamer::Update(std::vector<Stream>* finished)
+{
+    assert(finished);
+    unsigned int budget = std::max(mBytesPerFrame, 1u);
+
+    while(!mStreams.empty() && budget > 0)
+    {
+        Stream& stream = mStreams.front();
+        const unsigned int rowBytes = stream.image.width * stream.image.channels;
+        const int rowsLeft = stream.image.height - stream.nextRow;
+
+        // Always at least a row, so a wide image still makes progress.
+        const int rows = std::min(rowsLeft, (int) std::max(budget / rowBytes, 1u));
+        UploadRows(stream, rows);
+        budget -= std::min(budget, rows * rowBytes);
+
+        if(stream.nextRow >= stream.image.height)
+        {
+            finished->push_back(stream);
+            mStreams.pop_front();
+        }
+    }
+}
+
+void TextureStreamer::Clear()
+{
+    for(std::deque<Stream>::iterator it = mStreams.begin(); it != mStreams.end(); ++it)
+    {
+        glDeleteTextures(1, &it->id);
+        SOIL_free_image_data(it->image.pixels);
+    }
+    mStreams.clear();
+
+    if(mPixelBuffer != 0)
+    {
+        glDeleteBuffers(1, &mPixelBuffer);
+        mPixelBuffer = 0;
+    }
+}
+
+void TextureStreamer::Reset()
+{
+    // As Clear, but the old context's names could be live ones in the new
+    // context, so nothing is deleted.
+    for(std::deque<Stream>::iterator it = mStreams.begin(); it != mStreams.end(); ++it)
+    {
+        SOIL_free_image_data(it->image.pixels);
+    }
+    mStreams.clear();
+    mPixelBuffer = 0;
+}
\ No newline at end of file
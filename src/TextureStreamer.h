@@ -0,0 +1,56 @@
+#ifndef TEXTURESTREAMER_H
+#define TEXTURESTREAMER_H
+
+#include <deque>
+#include <vector>
+
+#include "DinodeckGL.h"
+#include "TextureLoader.h"
+
+//
+// Uploads large decoded textures a band of rows at a time, so one big
+// background doesn't stall a frame. Where pixel buffer objects are
+// supported the rows are copied into a mapped PBO and the driver fetches
+// them without blocking glTexSubImage2D.
+//
+class TextureStreamer
+{
+public:
+    struct Stream
+    {
+        TextureLoader::Decoded image; // the streamer owns its pixels
+        GLuint id;
+        int nextRow;
+    };
+private:
+    std::deque<Stream> mStreams;
+    GLuint mPixelBuffer;
+    unsigned int mBytesPerFrame;
+    bool UsePixelBuffer();
+    void UploadRows(Stream& stream, int rows);
+public:
+    static const unsigned int DEFAULT_BYTES_PER_FRAME = 512 * 1024;
+
+    TextureStreamer() : mPixelBuffer(0), mBytesPerFrame(DEFAULT_BYTES_PER_FRAME) {}
+    ~TextureStreamer() { Clear(); }
+
+    // 0 turns streaming off.
+    void SetBytesPerFrame(unsigned int bytes) { mBytesPerFrame = bytes; }
+    // True if the image is too big to upload in one frame's share.
+    bool ShouldStream(const TextureLoader::Decoded& image) const;
+
+    // Takes the pixels, they're freed once the stream finishes.
+    void Begin(const TextureLoader::Decoded& image);
+    // Uploads up to a frame's share of rows. Streams that are complete
+    // are moved into finished, the caller frees their pixels and owns
+    // their texture ids.
+    void Update(std::vector<Stream>* finished);
+    bool IsStreaming() const { return !mStreams.empty(); }
+
+    // Drops streams in progress and their textures.
+    void Clear();
+    // The buffer and textures went with the old OpenGL context.
+    void Reset();
+};
+
+#endif
\ No newline at end of file
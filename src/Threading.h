@@ -0,0 +1,166 @@
+#ifndef THREADING_H
+#define THREADING_H
+
+#include <stddef.h>
+
+#if ANDROID
+#include <pthread.h>
+#include <time.h>
+#else
+#include "SDL/SDL_thread.h"
+#endif
+
+//
+// Thin wrappers over pthreads on Android and SDL elsewhere.
+//
+#if ANDROID
+class Mutex
+{
+    pthread_mutex_t mMutex;
+public:
+    Mutex() { pthread_mutex_init(&mMutex, NULL); }
+    ~Mutex() { pthread_mutex_destroy(&mMutex); }
+    void Lock() { pthread_mutex_lock(&mMutex); }
+    void Unlock() { pthread_mutex_unlock(&mMutex); }
+    pthread_mutex_t* Handle() { return &mMutex; }
+};
+
+class Condition
+{
+    pthread_cond_t mCondition;
+public:
+    Condition() { pthread_cond_init(&mCondition, NULL); }
+    ~Condition() { pthread_cond_destroy(&mCondition); }
+    void Wait(Mutex& mutex) { pthread_cond_wait(&mCondition, mutex.Handle()); }
+    // False if it timed out.
+    bool Wait(Mutex& mutex, unsigned int milliseconds)
+    {
+        timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_sec += milliseconds / 1000;
+        until.tv_nsec += (milliseconds % 1000) * 1000000L;
+        if(until.tv_nsec >= 1000000000L)
+        {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        return pthread_cond_timedwait(&mCondition, mutex.Handle(), &until) == 0;
+    }
+    void Signal() { pthread_cond_signal(&mCondition); }
+    void Broadcast() { pthread_cond_broadcast(&mCondition); }
+};
+
+class Thread
+{
+public:
+    typedef void (*Function)(void* data);
+private:
+    Function mFunction;
+    void* mData;
+    pthread_t mThread;
+    bool mStarted;
+
+    static void* Main(void* thread)
+    {
+        Thread* self = static_cast<Thread*>(thread);
+        self->mFunction(self->mData);
+        return NULL;
+    }
+public:
+    Thread() : mFunction(NULL), mData(NULL), mStarted(false) {}
+
+    bool Start(Function function, void* data)
+    {
+        mFunction = function;
+        mData = data;
+        mStarted = pthread_create(&mThread, NULL, &Thread::Main, this) == 0;
+        return mStarted;
+    }
+
+    void Join()
+    {
+        if(mStarted)
+        {
+            pthread_join(mThread, NULL);
+            mStarted = false;
+        }
+    }
+};
+#else
+class Mutex
+{
+    SDL_mutex* mMutex;
+public:
+    Mutex() : mMutex(SDL_CreateMutex()) {}
+    ~Mutex() { SDL_DestroyMutex(mMutex); }
+    void Lock() { SDL_mutexP(mMutex); }
+    void Unlock() { SDL_mutexV(mMutex); }
+    SDL_mutex* Handle() { return mMutex; }
+};
+
+class Condition
+{
+    SDL_cond* mCondition;
+public:
+    Condition() : mCondition(SDL_CreateCond()) {}
+    ~Condition() { SDL_DestroyCond(mCondition); }
+    void Wait(Mutex& mutex) { SDL_CondWait(mCondition, mutex.Handle()); }
+    // False if it timed out.
+    bool Wait(Mutex& mutex, unsigned int milliseconds)
+    {
+        return SDL_CondWaitTimeout(mCondition, mutex.Handle(), milliseconds) == 0;
+    }
+    void Signal() { SDL_CondSignal(mCondition); }
+    void Broadcast() { SDL_CondBroadcast(mCondition); }
+};
+
+class Thread
+{
+public:
+    typedef void (*Function)(void* data);
+private:
+    Function mFunction;
+    void* mData;
+    SDL_Thread* mThread;
+
+    static int Main(void* thread)
+    {
+        Thread* self = static_cast<Thread*>(thread);
+        self->mFunction(self->mData);
+        return 0;
+    }
+public:
+    Thread() : mFunction(NULL), mData(NULL), mThread(NULL) {}
+
+    bool Start(Function function, void* data)
+    {
+        mFunction = function;
+        mData = data;
+        mThread = SDL_CreateThread(&Thread::Main, this);
+        return mThread != NULL;
+    }
+
+    void Join()
+    {
+        if(mThread)
+        {
+            SDL_WaitThread(mThread, NULL);
+            mThread = NULL;
+        }
+    }
+};
+#endif
+
+// Holds the lock for the scope.
+class ScopedLock
+{
+    Mutex& mMutex;
+public:
+    ScopedLock(Mutex& mutex) : mMutex(mutex) { mMutex.Lock(); }
+    ~ScopedLock() { mMutex.Unlock(); }
+private:
+    ScopedLock(const ScopedLock&);
+    ScopedLock& operator=(const ScopedLock&);
+};
+
+#endif
\ No newline at end of file
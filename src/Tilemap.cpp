@@ -0,0 +1,413 @@
+#include "Tilemap.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include "DinodeckGL.h"
+#include "DinodeckLua.h"
+#include "GraphicsPipeline.h"
+#include "LuaState.h"
+#include "StaticLayer.h"
+#include "Texture.h"
+#include "Vertex.h"
+
+Reflect Tilemap::Meta("Tilemap", Tilemap::Bind);
+std::vector<Tilemap*> Tilemap::mTilemaps;
+
+static int lua_Tilemap_Create(lua_State* state)
+{
+    TextureHandle* texture = Texture::GetFuncParamHandle(state, 1);
+    if (texture == NULL)
+    {
+        return 0;
+    }
+
+    int tileWidth = luaL_checkinteger(state, 2);
+    int tileHeight = luaL_checkinteger(state, 3);
+    int columns = luaL_checkinteger(state, 4);
+    int rows = luaL_checkinteger(state, 5);
+
+    if(tileWidth < 1 || tileHeight < 1)
+    {
+        return luaL_argerror(state, 2, "tile size must be at least 1.\n");
+    }
+
+    if(columns < 0 || rows < 0)
+    {
+        return luaL_argerror(state, 4, "map size can't be negative.\n");
+    }
+
+    Tilemap* tilemap = new (lua_newuserdata(state, sizeof(Tilemap)))
+        Tilemap(*texture, tileWidth, tileHeight, columns, rows);
+    Tilemap::mTilemaps.push_back(tilemap);
+    luaL_getmetatable(state, "Tilemap");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_Tilemap_gc(lua_State* state)
+{
+    Tilemap* tilemap = (Tilemap*)lua_touserdata(state, 1);
+    assert(tilemap);
+
+    std::vector<Tilemap*>::iterator it =
+        std::find(Tilemap::mTilemaps.begin(), Tilemap::mTilemaps.end(), tilemap);
+    if(it != Tilemap::mTilemaps.end())
+    {
+        Tilemap::mTilemaps.erase(it);
+    }
+
+    tilemap->~Tilemap();
+    return 0;
+}
+
+static int lua_Tilemap_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "Tilemap");
+    return 1;
+}
+
+static int lua_Tilemap_SetTile(lua_State* state)
+{
+    Tilemap* tilemap = LuaState::GetFuncParam<Tilemap>(state, 1);
+    if(tilemap == NULL)
+    {
+        return 0;
+    }
+
+    // Columns and rows count from 1 in Lua.
+    int column = luaL_checkinteger(state, 2) - 1;
+    int row = luaL_checkinteger(state, 3) - 1;
+    int tile = luaL_checkinteger(state, 4);
+    tilemap->SetTile(column, row, tile);
+    return 0;
+}
+
+static int lua_Tilemap_GetTile(lua_State* state)
+{
+    Tilemap* tilemap = LuaState::GetFuncParam<Tilemap>(state, 1);
+    if(tilemap == NULL)
+    {
+        return 0;
+    }
+
+    int column = luaL_checkinteger(state, 2) - 1;
+    int row = luaL_checkinteger(state, 3) - 1;
+    lua_pushnumber(state, tilemap->GetTile(column, row));
+    return 1;
+}
+
+//
+// Takes a table of tile indices, row by row from the top left.
+//
+static int lua_Tilemap_SetTiles(lua_State* state)
+{
+    Tilemap* tilemap = LuaState::GetFuncParam<Tilemap>(state, 1);
+    if(tilemap == NULL)
+    {
+        return 0;
+    }
+
+    if(!lua_istable(state, 2))
+    {
+        return luaL_typerror(state, 2, "table");
+    }
+
+    for(int row = 0; row < tilemap->Rows(); row++)
+    {
+        for(int column = 0; column < tilemap->Columns(); column++)
+        {
+            lua_rawgeti(state, 2, row * tilemap->Columns() + column + 1);
+            int tile = lua_isnumber(state, -1) ? (int) lua_tonumber(state, -1) : 0;
+            lua_pop(state, 1);
+            tilemap->SetTile(column, row, tile);
+        }
+    }
+    return 0;
+}
+
+static int lua_Tilemap_SetPosition(lua_State* state)
+{
+    Tilemap* tilemap = LuaState::GetFuncParam<Tilemap>(state, 1);
+    if(tilemap == NULL)
+    {
+        return 0;
+    }
+
+    if(lua_isnumber(state, 2))
+    {
+        double x = (double) luaL_optnumber(state, 2, tilemap->GetPosition().x);
+        double y = (double) luaL_optnumber(state, 3, tilemap->GetPosition().y);
+        tilemap->SetPosition(x, y);
+    }
+    else if(LuaState::IsType<Vector>(state, 2))
+    {
+        Vector* vector = (Vector*)lua_touserdata(state, 2);
+        tilemap->SetPosition(vector->x, vector->y);
+    }
+    else
+    {
+        return luaL_typerror(state, 2, "Vector or number");
+    }
+    return 0;
+}
+
+static int lua_Tilemap_GetPosition(lua_State* state)
+{
+    Tilemap* tilemap = LuaState::GetFuncParam<Tilemap>(state, 1);
+    if(tilemap == NULL)
+    {
+        return 0;
+    }
+
+    Vector* vector = new (lua_newuserdata(state, sizeof(Vector))) Vector();
+    assert(vector != NULL);
+    luaL_getmetatable(state, "Vector");
+    lua_setmetatable(state, -2);
+    vector->SetXyzw(tilemap->GetPosition());
+    return 1;
+}
+
+static int lua_Tilemap_GetSize(lua_State* state)
+{
+    Tilemap* tilemap = LuaState::GetFuncParam<Tilemap>(state, 1);
+    if(tilemap == NULL)
+    {
+        return 0;
+    }
+
+    lua_pushnumber(state, tilemap->Columns());
+    lua_pushnumber(state, tilemap->Rows());
+    return 2;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_Tilemap_Create},
+  {"__gc", lua_Tilemap_gc},
+  {"__tostring", lua_Tilemap_tostring},
+  {"SetTile", lua_Tilemap_SetTile},
+  {"GetTile", lua_Tilemap_GetTile},
+  {"SetTiles", lua_Tilemap_SetTiles},
+  {"SetPosition", lua_Tilemap_SetPosition},
+  {"GetPosition", lua_Tilemap_GetPosition},
+  {"GetSize", lua_Tilemap_GetSize},
+  {NULL, NULL}  /* sentinel */
+};
+
+void Tilemap::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        Tilemap::Meta.Name(),
+        luaBinding
+    );
+}
+
+void Tilemap::ResetAll()
+{
+    for(std::vector<Tilemap*>::iterator it = mTilemaps.begin();
+        it != mTilemaps.end(); ++it)
+    {
+        Tilemap* tilemap = (*it);
+        for(std::vector<Chunk>::iterator chunk = tilemap->mChunks.begin();
+            chunk != tilemap->mChunks.end(); ++chunk)
+        {
+            chunk->layer->Reset();
+            chunk->dirty = true;
+        }
+    }
+}
+
+Tilemap::Tilemap(TextureHandle tileset,
+                 int tileWidth,
+                 int tileHeight,
+                 int columns,
+                 int rows) :
+    mTileset(tileset),
+    mTilesetId(0),
+    mTilesetWidth(0),
+    mTilesetHeight(0),
+    mTileWidth(tileWidth),
+    mTileHeight(tileHeight),
+    mColumns(columns),
+    mRows(rows),
+    mChunkColumns((columns + CHUNK_SIZE - 1) / CHUNK_SIZE),
+    mTiles(columns * rows, 0),
+    mChunks(),
+    mPosition()
+{
+    assert(!tileset.IsNull());
+    int chunkRows = (rows + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    mChunks.resize(mChunkColumns * chunkRows);
+    for(std::vector<Chunk>::iterator it = mChunks.begin(); it != mChunks.end(); ++it)
+    {
+        it->layer = new StaticLayer();
+        it->dirty = true;
+    }
+}
+
+Tilemap::~Tilemap()
+{
+    for(std::vector<Chunk>::iterator it = mChunks.begin(); it != mChunks.end(); ++it)
+    {
+        delete it->layer;
+    }
+}
+
+void Tilemap::SetTile(int column, int row, int tile)
+{
+    if(column < 0 || column >= mColumns || row < 0 || row >= mRows)
+    {
+        return;
+    }
+
+    int& current = mTiles[row * mColumns + column];
+    if(current == tile)
+    {
+        return;
+    }
+
+    current = tile;
+    int chunk = (row / CHUNK_SIZE) * mChunkColumns + (column / CHUNK_SIZE);
+    mChunks[chunk].dirty = true;
+}
+
+int Tilemap::GetTile(int column, int row) const
+{
+    if(column < 0 || column >= mColumns || row < 0 || row >= mRows)
+    {
+        return 0;
+    }
+    return mTiles[row * mColumns + column];
+}
+
+void Tilemap::SetPosition(double x, double y)
+{
+    // Chunks are built relative to the map, so moving it is free.
+    mPosition.SetXyzw(x, y, 0, 0);
+}
+
+void Tilemap::ChunkBounds(unsigned int chunk,
+                          float* left,
+                          float* top,
+                          float* right,
+                          float* bottom) const
+{
+    assert(chunk < mChunks.size());
+    int firstColumn = (chunk % mChunkColumns) * CHUNK_SIZE;
+    int firstRow = (chunk / mChunkColumns) * CHUNK_SIZE;
+    int lastColumn = std::min(firstColumn + CHUNK_SIZE, mColumns);
+    int lastRow = std::min(firstRow + CHUNK_SIZE, mRows);
+
+    // Rows go down the screen from the top left corner.
+    *left = mPosition.x + firstColumn * mTileWidth;
+    *right = mPosition.x + lastColumn * mTileWidth;
+    *top = mPosition.y - firstRow * mTileHeight;
+    *bottom = mPosition.y - lastRow * mTileHeight;
+}
+
+void Tilemap::MarkAllDirty()
+{
+    for(std::vector<Chunk>::iterator it = mChunks.begin(); it != mChunks.end(); ++it)
+    {
+        it->dirty = true;
+    }
+}
+
+StaticLayer* Tilemap::GetChunk(unsigned int chunk)
+{
+    assert(chunk < mChunks.size());
+
+    // A reloaded tileset may have a new id or size, a destroyed one
+    // leaves the map empty.
+    Texture* tileset = Texture::Resolve(mTileset);
+    GLuint id = 0;
+    int width = 0;
+    int height = 0;
+    if(tileset != NULL)
+    {
+        tileset->MarkUsed();
+        id = tileset->GetId();
+        width = tileset->GetWidth();
+        height = tileset->GetHeight();
+    }
+
+    if(id != mTilesetId || width != mTilesetWidth || height != mTilesetHeight)
+    {
+        mTilesetId = id;
+        mTilesetWidth = width;
+        mTilesetHeight = height;
+        MarkAllDirty();
+    }
+
+    if(mChunks[chunk].dirty)
+    {
+        BuildChunk(chunk, tileset);
+    }
+    return mChunks[chunk].layer;
+}
+
+void Tilemap::BuildChunk(unsigned int chunk, const Texture* tileset)
+{
+    StaticLayer* layer = mChunks[chunk].layer;
+    layer->Clear();
+    mChunks[chunk].dirty = false;
+
+    int tilesPerRow = mTilesetWidth / mTileWidth;
+    int tilesPerColumn = mTilesetHeight / mTileHeight;
+    if(tileset == NULL || tilesPerRow == 0 || tilesPerColumn == 0)
+    {
+        return;
+    }
+
+    int firstColumn = (chunk % mChunkColumns) * CHUNK_SIZE;
+    int firstRow = (chunk / mChunkColumns) * CHUNK_SIZE;
+    int lastColumn = std::min(firstColumn + CHUNK_SIZE, mColumns);
+    int lastRow = std::min(firstRow + CHUNK_SIZE, mRows);
+
+    const float uStep = (float) mTileWidth / mTilesetWidth;
+    const float vStep = (float) mTileHeight / mTilesetHeight;
+    const Vector colour(1, 1, 1, 1);
+
+    std::vector<PackedVertex> verts;
+    verts.reserve(CHUNK_SIZE * CHUNK_SIZE * 6);
+
+    for(int row = firstRow; row < lastRow; row++)
+    {
+        for(int column = firstColumn; column < lastColumn; column++)
+        {
+            int index = mTiles[row * mColumns + column] - 1;
+            if(index < 0 || index >= tilesPerRow * tilesPerColumn)
+            {
+                continue; // empty
+            }
+
+            float u0 = tileset->MapU((index % tilesPerRow) * uStep);
+            float v0 = tileset->MapV((index / tilesPerRow) * vStep);
+            float u1 = tileset->MapU(((index % tilesPerRow) + 1) * uStep);
+            float v1 = tileset->MapV(((index / tilesPerRow) + 1) * vStep);
+
+            float left = (float) (column * mTileWidth);
+            float right = (float) ((column + 1) * mTileWidth);
+            float top = (float) -(row * mTileHeight);
+            float bottom = (float) -((row + 1) * mTileHeight);
+
+            // TL, TR, BL, TR, BR, BL as sprites are
+            verts.push_back(PackedVertex(Vertex(left, top, 0.f, colour, u0, v0)));
+            verts.push_back(PackedVertex(Vertex(right, top, 0.f, colour, u1, v0)));
+            verts.push_back(PackedVertex(Vertex(left, bottom, 0.f, colour, u0, v1)));
+            verts.push_back(PackedVertex(Vertex(right, top, 0.f, colour, u1, v0)));
+            verts.push_back(PackedVertex(Vertex(right, bottom, 0.f, colour, u1, v1)));
+            verts.push_back(PackedVertex(Vertex(left, bottom, 0.f, colour, u0, v1)));
+        }
+    }
+
+    if(verts.empty())
+    {
+        return;
+    }
+
+    layer->Append(&verts[0], verts.size(), TRIANGLES, mTilesetId, false,
+                  GraphicsPipeline::BatchBlend(BLEND, tileset->IsPremultiplied()));
+    layer->Upload();
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+#include <vector>
+
+#include "DinodeckGL.h"
+#include "reflect/Reflect.h"
+#include "TextureHandle.h"
+#include "Vector.h"
+
+class LuaState;
+class StaticLayer;
+class Texture;
+
+//
+// A grid of tiles from a single tileset texture, drawn natively rather
+// than as a sprite per tile. The map is split into square chunks, each
+// with its own vertex buffer that's only rebuilt when a tile in it
+// changes. Chunks outside the view are skipped when drawn.
+//
+// Tile 0 is empty, tile 1 is the top left of the tileset, numbered left
+// to right then top to bottom. Position is the map's top left corner.
+//
+class Tilemap
+{
+    public: static Reflect Meta;
+    public:
+        static const int CHUNK_SIZE = 16; // in tiles
+        static std::vector<Tilemap*> mTilemaps;
+
+        static void Bind(LuaState* state);
+
+        // Chunk buffers are forgotten and rebuilt on their next draw.
+        // Call when the OpenGL context has been lost.
+        static void ResetAll();
+
+        Tilemap(TextureHandle tileset,
+                int tileWidth,
+                int tileHeight,
+                int columns,
+                int rows);
+        ~Tilemap();
+
+        int Columns() const { return mColumns; }
+        int Rows() const { return mRows; }
+        int TileWidth() const { return mTileWidth; }
+        int TileHeight() const { return mTileHeight; }
+
+        // Out of range tiles are ignored, empty when read.
+        void SetTile(int column, int row, int tile);
+        int GetTile(int column, int row) const;
+
+        void SetPosition(double x, double y);
+        const Vector& GetPosition() const { return mPosition; }
+
+        unsigned int ChunkCount() const { return mChunks.size(); }
+        void ChunkBounds(unsigned int chunk,
+                         float* left,
+                         float* top,
+                         float* right,
+                         float* bottom) const;
+
+        // Rebuilds the chunk's buffer first if it's out of date.
+        StaticLayer* GetChunk(unsigned int chunk);
+    private:
+        struct Chunk
+        {
+            StaticLayer* layer;
+            bool dirty;
+        };
+
+        TextureHandle mTileset;
+        GLuint mTilesetId; // tileset state the chunks were built with
+        int mTilesetWidth;
+        int mTilesetHeight;
+        int mTileWidth;
+        int mTileHeight;
+        int mColumns;
+        int mRows;
+        int mChunkColumns;
+        std::vector<int> mTiles;
+        std::vector<Chunk> mChunks;
+        Vector mPosition;
+
+        void BuildChunk(unsigned int chunk, const Texture* tileset);
+        void MarkAllDirty();
+
+        // Chunks own GPU buffers.
+        Tilemap(const Tilemap&);
+        Tilemap& operator=(const Tilemap&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "Trace.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "Threading.h"
+
+volatile bool Trace::mCapturing = false;
+
+static Mutex& RingsMutex()
+{
+    static Mutex mutex;
+    return mutex;
+}
+
+static std::vector<Trace::Ring*>& Rings()
+{
+    static std::vector<Trace::Ring*> rings;
+    return rings;
+}
+
+Trace::Ring* Trace::AddThread(const char* name)
+{
+    ScopedLock lock(RingsMutex());
+    Ring* ring = new Ring(Rings().size() + 1, name);
+    Rings().push_back(ring);
+    return ring;
+}
+
+Trace::Ring* Trace::Main()
+{
+    static Ring* ring = AddThread("main");
+    return ring;
+}
+
+bool Trace::Start()
+{
+    Main(); // so it's registered before any reader
+
+    ScopedLock lock(RingsMutex());
+    if(mCapturing)
+    {
+        return false;
+    }
+
+    // Anything left from a previous capture is stale.
+    for(unsigned int i = 0; i < Rings().size(); i++)
+    {
+        Ring* ring = Rings()[i];
+        ring->mTail = ring->mHead;
+        ring->mDropped = 0;
+    }
+    __sync_synchronize();
+    mCapturing = true;
+    return true;
+}
+
+void Trace::Stop()
+{
+    mCapturing = false;
+}
+
+void Trace::Push(Ring* ring,
+                 const char* name,
+                 unsigned long long start,
+                 unsigned long long end)
+{
+    const unsigned int head = ring->mHead;
+    if(head - ring->mTail >= RING_SIZE)
+    {
+        ring->mDropped++;
+        return;
+    }
+
+    Event& event = ring->mEvents[head & (RING_SIZE - 1)];
+    strncpy(event.name, name, NAME_LENGTH - 1);
+    event.name[NAME_LENGTH - 1] = '\0';
+    event.start = start;
+    event.duration = (unsigned int) (end - start);
+    __sync_synchronize(); // event written before the reader can see it
+    ring->mHead = head + 1;
+}
+
+static void AppendEscaped(std::string* out, const char* text)
+{
+    for(; *text; text++)
+    {
+        const unsigned char c = (unsigned char) *text;
+        if(c == '"' || c == '\\')
+        {
+            out->push_back('\\');
+            out->push_back(c);
+        }
+        else if(c >= 0x20)
+        {
+            out->push_back(c);
+        }
+    }
+}
+
+void Trace::WriteThreadNames(std::string* out)
+{
+    ScopedLock lock(RingsMutex());
+    char buffer[64];
+    for(unsigned int i = 0; i < Rings().size(); i++)
+    {
+        Ring* ring = Rings()[i];
+        if(!out->empty())
+        {
+            out->push_back(',');
+        }
+        snprintf(buffer, sizeof(buffer),
+                 "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                 "\"args\":{\"name\":\"",
+                 ring->mId);
+        out->append(buffer);
+        AppendEscaped(out, ring->mName.c_str());
+        out->append("\"}}");
+    }
+}
+
+unsigned int Trace::Drain(std::string* out)
+{
+    ScopedLock lock(RingsMutex());
+    unsigned int written = 0;
+    char buffer[96];
+    for(unsigned int i = 0; i < Rings().size(); i++)
+    {
+        Ring* ring = Rings()[i];
+        const unsigned int head = ring->mHead;
+        __sync_synchronize(); // events read after the head
+        unsigned int tail = ring->mTail;
+        for(; tail != head; tail++)
+        {
+            const Event& event = ring->mEvents[tail & (RING_SIZE - 1)];
+            if(!out->empty())
+            {
+                out->push_back(',');
+            }
+            out->append("{\"name\":\"");
+            AppendEscaped(out, event.name);
+            snprintf(buffer, sizeof(buffer),
+                     "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu,\"dur\":%u}",
+                     ring->mId, event.start, event.duration);
+            out->append(buffer);
+            written++;
+        }
+        __sync_synchronize(); // done reading before the slots are reused
+        ring->mTail = tail;
+    }
+    return written;
+}
+
+unsigned int Trace::Dropped()
+{
+    ScopedLock lock(RingsMutex());
+    unsigned int dropped = 0;
+    for(unsigned int i = 0; i < Rings().size(); i++)
+    {
+        dropped += Rings()[i]->mDropped;
+    }
+    return dropped;
+}
\ No newline at end of file
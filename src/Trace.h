@@ -0,0 +1,93 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+
+//
+// Timeline capture for chrome://tracing and Perfetto.
+//
+// Each thread that records zones owns a ring of events. The owner is the
+// only writer and the streaming thread the only reader, so neither side
+// takes a lock. When a ring is full new events are dropped and counted
+// until the reader catches up.
+//
+// Nothing is recorded unless a capture is running, so zones are a flag
+// check the rest of the time.
+//
+//    unsigned long long start = DDTime::Microseconds();
+//    DoWork();
+//    Trace::Record("work", start, DDTime::Microseconds());
+//
+class Trace
+{
+public:
+    static const unsigned int RING_SIZE = 8192; // power of two
+    static const unsigned int NAME_LENGTH = 24;
+
+    struct Event
+    {
+        char name[NAME_LENGTH];
+        unsigned long long start;
+        unsigned int duration;
+    };
+
+    class Ring
+    {
+        friend class Trace;
+        Event mEvents[RING_SIZE];
+        volatile unsigned int mHead; // written by the owner
+        volatile unsigned int mTail; // written by the reader
+        volatile unsigned int mDropped;
+        unsigned int mId;
+        std::string mName;
+        Ring(unsigned int id, const char* name) :
+            mHead(0), mTail(0), mDropped(0), mId(id), mName(name) {}
+    };
+
+    // Rings live until exit. Call on the thread that will record into it,
+    // or before the thread starts.
+    static Ring* AddThread(const char* name);
+    // The main thread's ring.
+    static Ring* Main();
+
+    static bool IsCapturing() { return mCapturing; }
+    // False if a capture is already running.
+    static bool Start();
+    static void Stop();
+
+    static void Record(const char* name,
+                       unsigned long long start,
+                       unsigned long long end)
+    {
+        if(mCapturing)
+        {
+            Push(Main(), name, start, end);
+        }
+    }
+    static void Record(Ring* ring,
+                       const char* name,
+                       unsigned long long start,
+                       unsigned long long end)
+    {
+        if(mCapturing)
+        {
+            Push(ring, name, start, end);
+        }
+    }
+
+    // Capturing thread only.
+    // Appends the thread names as trace event JSON objects.
+    static void WriteThreadNames(std::string* out);
+    // Empties the rings, appending the events as comma separated trace
+    // event JSON objects. Returns how many were written.
+    static unsigned int Drain(std::string* out);
+    static unsigned int Dropped();
+private:
+    static volatile bool mCapturing;
+    static void Push(Ring* ring,
+                     const char* name,
+                     unsigned long long start,
+                     unsigned long long end);
+};
+
+#endif
\ No newline at end of file
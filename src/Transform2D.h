@@ -0,0 +1,56 @@
+#ifndef TRANSFORM2D_H
+#define TRANSFORM2D_H
+
+#include <cmath>
+
+#include "DDMath.h"
+
+//
+// A 2D affine transform, the top two rows of a 3x3 matrix.
+//     x' = a * x + c * y + tx
+//     y' = b * x + d * y + ty
+//
+struct Transform2D
+{
+    float a, b, c, d;
+    float tx, ty;
+
+    Transform2D()
+        : a(1), b(0), c(0), d(1), tx(0), ty(0) {}
+
+    // Scaled, then rotated (degrees), then moved.
+    void Set(float x, float y, float degrees, float scaleX, float scaleY)
+    {
+        float cs = 1;
+        float sn = 0;
+        if(degrees != 0)
+        {
+            const float radians = DegreeToRadian(degrees);
+            cs = std::cos(radians);
+            sn = std::sin(radians);
+        }
+        a = cs * scaleX;
+        b = sn * scaleX;
+        c = -sn * scaleY;
+        d = cs * scaleY;
+        tx = x;
+        ty = y;
+    }
+
+    // destination may be either argument.
+    static void Multiply(Transform2D& destination,
+                         const Transform2D& parent,
+                         const Transform2D& local)
+    {
+        const Transform2D p = parent;
+        const Transform2D l = local;
+        destination.a = p.a * l.a + p.c * l.b;
+        destination.b = p.b * l.a + p.d * l.b;
+        destination.c = p.a * l.c + p.c * l.d;
+        destination.d = p.b * l.c + p.d * l.d;
+        destination.tx = p.a * l.tx + p.c * l.ty + p.tx;
+        destination.ty = p.b * l.tx + p.d * l.ty + p.ty;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,452 @@
+#include "Tween.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include "DinodeckLua.h"
+#include "Game.h"
+#include "LuaState.h"
+#include "Sprite.h"
+#include "util/Lerp.h"
+
+Reflect Tween::Meta("Tween", Tween::Bind);
+
+//
+// Where each property lives in a sprite, in eProperty order.
+//
+struct PropertyField
+{
+    Vector Sprite::* vector; // NULL for fields on the sprite itself
+    double Vector::* component;
+    double Sprite::* field;
+};
+
+static const PropertyField properties[] =
+{
+    { &Sprite::position, &Vector::x, NULL },
+    { &Sprite::position, &Vector::y, NULL },
+    { NULL, NULL, &Sprite::rotation },
+    { &Sprite::scale, &Vector::x, NULL },
+    { &Sprite::scale, &Vector::y, NULL },
+    { &Sprite::colour, &Vector::x, NULL },
+    { &Sprite::colour, &Vector::y, NULL },
+    { &Sprite::colour, &Vector::z, NULL },
+    { &Sprite::colour, &Vector::w, NULL },
+};
+
+double* Tween::Target(Sprite* sprite, eProperty property)
+{
+    assert(sprite);
+    assert(property >= 0 && property < PROPERTY_COUNT);
+    const PropertyField& field = properties[property];
+    if(field.vector)
+    {
+        return &((sprite->*field.vector).*field.component);
+    }
+    return &(sprite->*field.field);
+}
+
+Tween::Tween() :
+    mTweens(),
+    mNextId(1)
+{
+}
+
+unsigned int Tween::Add(Sprite* sprite,
+                        int spriteRef,
+                        eProperty property,
+                        double to,
+                        float duration,
+                        float delay,
+                        int easing,
+                        int callbackRef)
+{
+    Entry entry;
+    entry.target = Target(sprite, property);
+    entry.from = *entry.target;
+    entry.to = to;
+    entry.elapsed = 0;
+    entry.delay = std::max(delay, 0.0f);
+    entry.duration = std::max(duration, 0.0f);
+    entry.easing = (unsigned char) easing;
+    entry.started = false;
+    entry.id = mNextId++;
+    entry.sprite = sprite;
+    entry.spriteRef = spriteRef;
+    entry.callbackRef = callbackRef;
+    mTweens.push_back(entry);
+    return entry.id;
+}
+
+int Tween::Find(unsigned int id) const
+{
+    for(unsigned int i = 0; i < mTweens.size(); i++)
+    {
+        if(mTweens[i].id == id)
+        {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+void Tween::Remove(unsigned int index, Done* done)
+{
+    done->id = mTweens[index].id;
+    done->spriteRef = mTweens[index].spriteRef;
+    done->callbackRef = mTweens[index].callbackRef;
+    mTweens.erase(mTweens.begin() + index);
+}
+
+bool Tween::Stop(unsigned int id, bool finish, Done* done)
+{
+    const int index = Find(id);
+    if(index < 0)
+    {
+        return false;
+    }
+    if(finish)
+    {
+        *mTweens[index].target = mTweens[index].to;
+    }
+    Remove(index, done);
+    return true;
+}
+
+void Tween::StopSprite(const Sprite* sprite, std::vector<Done>* done)
+{
+    for(unsigned int i = 0; i < mTweens.size();)
+    {
+        if(mTweens[i].sprite == sprite)
+        {
+            Done stopped;
+            Remove(i, &stopped);
+            done->push_back(stopped);
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+void Tween::StopAll(std::vector<Done>* done)
+{
+    for(unsigned int i = 0; i < mTweens.size(); i++)
+    {
+        Done stopped = { mTweens[i].id, mTweens[i].spriteRef, mTweens[i].callbackRef };
+        done->push_back(stopped);
+    }
+    mTweens.clear();
+}
+
+bool Tween::IsActive(unsigned int id) const
+{
+    return Find(id) >= 0;
+}
+
+void Tween::Update(float dt, std::vector<Done>* done)
+{
+    // Finished tweens are dropped as the rest are packed down, keeping
+    // the order so a later tween on the same property still wins.
+    unsigned int kept = 0;
+    for(unsigned int i = 0; i < mTweens.size(); i++)
+    {
+        Entry& entry = mTweens[i];
+        entry.elapsed += dt;
+
+        const float time = entry.elapsed - entry.delay;
+        bool finished = false;
+        if(time >= 0)
+        {
+            if(!entry.started)
+            {
+                entry.from = *entry.target;
+                entry.started = true;
+            }
+
+            float t = 1;
+            if(entry.duration > 0 && time < entry.duration)
+            {
+                t = time / entry.duration;
+            }
+
+            if(t >= 1)
+            {
+                *entry.target = entry.to;
+                finished = true;
+            }
+            else
+            {
+                *entry.target = entry.from
+                              + (entry.to - entry.from) * Easef(entry.easing, t);
+            }
+        }
+
+        if(finished)
+        {
+            Done tween = { entry.id, entry.spriteRef, entry.callbackRef };
+            done->push_back(tween);
+        }
+        else
+        {
+            if(kept != i)
+            {
+                mTweens[kept] = entry;
+            }
+            kept++;
+        }
+    }
+    mTweens.resize(kept);
+}
+
+//
+// Lua binding
+//
+
+// In eEasing order.
+static const char* easingNames[] =
+{
+    "linear",
+    "inQuad",
+    "outQuad",
+    "inOutQuad",
+    "inCubic",
+    "outCubic",
+    "inOutCubic",
+    "inSine",
+    "outSine",
+    "inOutSine",
+    "outBack",
+    "outBounce",
+    NULL
+};
+
+// In eProperty order.
+static const char* propertyNames[] =
+{
+    "x", "y", "rotation", "scaleX", "scaleY", "red", "green", "blue", "alpha", NULL
+};
+
+static void Release(lua_State* state, const Tween::Done& done)
+{
+    luaL_unref(state, LUA_REGISTRYINDEX, done.spriteRef);
+    luaL_unref(state, LUA_REGISTRYINDEX, done.callbackRef);
+}
+
+static void Release(lua_State* state, const std::vector<Tween::Done>& done)
+{
+    for(unsigned int i = 0; i < done.size(); i++)
+    {
+        Release(state, done[i]);
+    }
+}
+
+static int lua_Tween_Create(lua_State* state)
+{
+    new (lua_newuserdata(state, sizeof(Tween))) Tween();
+    luaL_getmetatable(state, "Tween");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_Tween_gc(lua_State* state)
+{
+    Tween* tween = (Tween*)lua_touserdata(state, 1);
+    assert(tween);
+    std::vector<Tween::Done> done;
+    tween->StopAll(&done);
+    Release(state, done);
+    tween->~Tween();
+    return 0;
+}
+
+static int lua_Tween_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "Tween");
+    return 1;
+}
+
+// tweens:Add(sprite, property, to, duration, [easing], [delay], [callback])
+// property is "x", "y", "rotation", "scaleX", "scaleY", "red", "green",
+// "blue" or "alpha". The callback gets the tween id when it finishes.
+// Returns the tween id.
+static int lua_Tween_Add(lua_State* state)
+{
+    Tween* tween = LuaState::GetFuncParam<Tween>(state, 1);
+    if(tween == NULL)
+    {
+        return 0;
+    }
+    Sprite* sprite = LuaState::GetFuncParam<Sprite>(state, 2);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+    const Tween::eProperty property =
+        (Tween::eProperty) luaL_checkoption(state, 3, NULL, propertyNames);
+    const double to = luaL_checknumber(state, 4);
+    const float duration = (float) luaL_checknumber(state, 5);
+    const int easing = luaL_checkoption(state, 6, "linear", easingNames);
+    const float delay = (float) luaL_optnumber(state, 7, 0);
+
+    int callbackRef = LUA_NOREF;
+    if(!lua_isnoneornil(state, 8))
+    {
+        luaL_checktype(state, 8, LUA_TFUNCTION);
+        lua_pushvalue(state, 8);
+        callbackRef = luaL_ref(state, LUA_REGISTRYINDEX);
+    }
+
+    // Keeps the sprite alive while it's being moved.
+    lua_pushvalue(state, 2);
+    int spriteRef = luaL_ref(state, LUA_REGISTRYINDEX);
+
+    lua_pushinteger(state, tween->Add(sprite,
+                                      spriteRef,
+                                      property,
+                                      to,
+                                      duration,
+                                      delay,
+                                      easing,
+                                      callbackRef));
+    return 1;
+}
+
+// tweens:Stop(id, [finish]), finish jumps the property to its end value.
+// The callback isn't called.
+static int lua_Tween_Stop(lua_State* state)
+{
+    Tween* tween = LuaState::GetFuncParam<Tween>(state, 1);
+    if(tween == NULL)
+    {
+        return 0;
+    }
+    Tween::Done done;
+    if(tween->Stop(luaL_checkinteger(state, 2), lua_toboolean(state, 3) != 0, &done))
+    {
+        Release(state, done);
+    }
+    return 0;
+}
+
+// tweens:StopSprite(sprite) stops every tween on the sprite.
+static int lua_Tween_StopSprite(lua_State* state)
+{
+    Tween* tween = LuaState::GetFuncParam<Tween>(state, 1);
+    if(tween == NULL)
+    {
+        return 0;
+    }
+    Sprite* sprite = LuaState::GetFuncParam<Sprite>(state, 2);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+    std::vector<Tween::Done> done;
+    tween->StopSprite(sprite, &done);
+    Release(state, done);
+    return 0;
+}
+
+static int lua_Tween_StopAll(lua_State* state)
+{
+    Tween* tween = LuaState::GetFuncParam<Tween>(state, 1);
+    if(tween == NULL)
+    {
+        return 0;
+    }
+    std::vector<Tween::Done> done;
+    tween->StopAll(&done);
+    Release(state, done);
+    return 0;
+}
+
+static int lua_Tween_IsActive(lua_State* state)
+{
+    Tween* tween = LuaState::GetFuncParam<Tween>(state, 1);
+    if(tween == NULL)
+    {
+        return 0;
+    }
+    lua_pushboolean(state, tween->IsActive(luaL_checkinteger(state, 2)));
+    return 1;
+}
+
+static int lua_Tween_GetCount(lua_State* state)
+{
+    Tween* tween = LuaState::GetFuncParam<Tween>(state, 1);
+    if(tween == NULL)
+    {
+        return 0;
+    }
+    lua_pushinteger(state, tween->Count());
+    return 1;
+}
+
+// tweens:Update([dt]), dt defaults to the game's delta time.
+// Callbacks for finished tweens are called once every tween has moved.
+static int lua_Tween_Update(lua_State* state)
+{
+    Tween* tween = LuaState::GetFuncParam<Tween>(state, 1);
+    if(tween == NULL)
+    {
+        return 0;
+    }
+
+    double dt = 0;
+    if(lua_isnoneornil(state, 2))
+    {
+        Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+        dt = game->GetDeltaTime();
+    }
+    else
+    {
+        dt = luaL_checknumber(state, 2);
+    }
+
+    std::vector<Tween::Done> done;
+    tween->Update((float) dt, &done);
+
+    int error = 0;
+    for(unsigned int i = 0; i < done.size(); i++)
+    {
+        if(error == 0 && done[i].callbackRef != LUA_NOREF)
+        {
+            lua_rawgeti(state, LUA_REGISTRYINDEX, done[i].callbackRef);
+            lua_pushinteger(state, done[i].id);
+            error = lua_pcall(state, 1, 0, 0);
+        }
+        Release(state, done[i]);
+    }
+
+    if(error != 0)
+    {
+        // Raised once everything's been let go.
+        return lua_error(state);
+    }
+    return 0;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_Tween_Create},
+  {"__gc", lua_Tween_gc},
+  {"__tostring", lua_Tween_tostring},
+  {"Add", lua_Tween_Add},
+  {"Stop", lua_Tween_Stop},
+  {"StopSprite", lua_Tween_StopSprite},
+  {"StopAll", lua_Tween_StopAll},
+  {"IsActive", lua_Tween_IsActive},
+  {"GetCount", lua_Tween_GetCount},
+  {"Update", lua_Tween_Update},
+  {NULL, NULL}  /* sentinel */
+};
+
+void Tween::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        Tween::Meta.Name(),
+        luaBinding
+    );
+}
\ No newline at end of file
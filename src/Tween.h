@@ -0,0 +1,93 @@
+#ifndef TWEEN_H
+#define TWEEN_H
+
+#include <vector>
+
+#include "reflect/Reflect.h"
+
+class LuaState;
+class Sprite;
+struct lua_State;
+
+//
+// Tweens sprite properties towards a value over time. Every tween lives
+// in one flat array and a single Update moves them all, so a screen of
+// animated widgets doesn't need a Lua closure each.
+//
+// A tween's start value is taken when it starts moving, after its delay,
+// so tweens on the same property can be chained with delays.
+//
+class Tween
+{
+    public: static Reflect Meta;
+    public:
+        enum eProperty
+        {
+            PROPERTY_X,
+            PROPERTY_Y,
+            PROPERTY_ROTATION,
+            PROPERTY_SCALE_X,
+            PROPERTY_SCALE_Y,
+            PROPERTY_RED,
+            PROPERTY_GREEN,
+            PROPERTY_BLUE,
+            PROPERTY_ALPHA,
+            PROPERTY_COUNT
+        };
+
+        struct Done
+        {
+            unsigned int id;
+            int spriteRef;
+            int callbackRef;
+        };
+
+        static void Bind(LuaState* state);
+        static double* Target(Sprite* sprite, eProperty property);
+
+        Tween();
+
+        unsigned int Add(Sprite* sprite,
+                         int spriteRef,
+                         eProperty property,
+                         double to,
+                         float duration,
+                         float delay,
+                         int easing,
+                         int callbackRef);
+        // The refs go in done for the caller to let go, callbacks aren't
+        // called. With finish the property jumps to its end value.
+        bool Stop(unsigned int id, bool finish, Done* done);
+        void StopSprite(const Sprite* sprite, std::vector<Done>* done);
+        void StopAll(std::vector<Done>* done);
+        bool IsActive(unsigned int id) const;
+        unsigned int Count() const { return mTweens.size(); }
+
+        // Moves every tween on. Those that finish go into done, in the
+        // order they were added.
+        void Update(float dt, std::vector<Done>* done);
+    private:
+        struct Entry
+        {
+            double* target;
+            double from;
+            double to;
+            float elapsed; // including the delay
+            float delay;
+            float duration;
+            unsigned char easing;
+            bool started;
+            unsigned int id;
+            Sprite* sprite;
+            int spriteRef;
+            int callbackRef;
+        };
+
+        std::vector<Entry> mTweens;
+        unsigned int mNextId;
+
+        int Find(unsigned int id) const;
+        void Remove(unsigned int index, Done* done);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+//
+// Text is UTF-8. A byte that doesn't start a valid sequence is read as
+// Latin-1 on its own, so strings saved in the old one byte a character
+// form still draw as they did.
+//
+namespace UTF8
+{
+    // Reads the code point starting at text[*index] and moves the index
+    // past it. ASCII is the first test, it costs what a byte loop does.
+    // text[*index] mustn't be the terminator, which no sequence reads past.
+    inline int Decode(const char* text, int* index)
+    {
+        const unsigned char* bytes = (const unsigned char*) text + *index;
+        const int lead = bytes[0];
+        if(lead < 0x80)
+        {
+            (*index)++;
+            return lead;
+        }
+
+        int length = 0;
+        int codePoint = 0;
+        int smallest = 0; // anything less is an overlong encoding
+        if((lead & 0xE0) == 0xC0)
+        {
+            length = 2;
+            codePoint = lead & 0x1F;
+            smallest = 0x80;
+        }
+        else if((lead & 0xF0) == 0xE0)
+        {
+            length = 3;
+            codePoint = lead & 0x0F;
+            smallest = 0x800;
+        }
+        else if((lead & 0xF8) == 0xF0)
+        {
+            length = 4;
+            codePoint = lead & 0x07;
+            smallest = 0x10000;
+        }
+        else
+        {
+            (*index)++;
+            return lead;
+        }
+
+        for(int i = 1; i < length; i++)
+        {
+            if((bytes[i] & 0xC0) != 0x80)
+            {
+                (*index)++;
+                return lead;
+            }
+            codePoint = (codePoint << 6) | (bytes[i] & 0x3F);
+        }
+
+        if(codePoint < smallest ||
+           codePoint > 0x10FFFF ||
+           (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+        {
+            (*index)++;
+            return lead;
+        }
+
+        *index += length;
+        return codePoint;
+    }
+}
+
+#endif
\ No newline at end of file
@@ -2,16 +2,19 @@
 
 #include <assert.h>
 #include <cmath>
-#include <sstream>
+#include <stdio.h>
 #include <string>
 
 #include "DinodeckLua.h"
+#include "LuaBind.h"
+#include "LuaFFI.h"
 #include "LuaState.h"
 #include "reflect/Reflect.h"
 
 using namespace std;
 
 Reflect Vector::Meta("Vector", Vector::Bind);
+const char* Vector::SCRATCH_POOL = "Vector.Scratch";
 
 Vector Vector::AxisX = Vector(1.0f, 0.0f, 0.0f, 0.0f);
 Vector Vector::AxisY = Vector(0.0f, 1.0f, 0.0f, 0.0f);
@@ -21,7 +24,7 @@ Vector Vector::AxisW = Vector(0.0f, 0.0f, 0.0f, 1.0f);
 int Vector::lua_Vector_Create(lua_State * state)
 {
     // If there's inheritance I think this may causes problems
-    if(lua_isuserdata(state, 1) && luaL_checkudata (state, 1, "Vector"))
+    if(LuaState::IsType<Vector>(state, 1))
     {
         Vector* vector = (Vector*)lua_touserdata(state, 1);
         Vector * pi = new (lua_newuserdata(state, sizeof(Vector))) Vector();
@@ -115,70 +118,6 @@ int lua_Vector_W(lua_State* state)
     return 1;
 }
 
-int lua_Vector_SetX(lua_State* state)
-{
-    Vector* vector = (Vector*)lua_touserdata(state, 1);
-    if (vector == NULL)
-    {
-        return luaL_typerror(state, 1, "Vector");
-    }
-    if(lua_isnumber(state, 2) == false)
-    {
-        return luaL_typerror(state, 2, "number");
-    }
-    lua_Number number = lua_tonumber(state, 2);
-    vector->x = number;
-    return 0;
-}
-
-int lua_Vector_SetY(lua_State* state)
-{
-    Vector* vector = (Vector*)lua_touserdata(state, 1);
-    if (vector == NULL)
-    {
-        return luaL_typerror(state, 1, "Vector");
-    }
-    if(lua_isnumber(state, 2) == false)
-    {
-        return luaL_typerror(state, 2, "number");
-    }
-    lua_Number number = lua_tonumber(state, 2);
-    vector->y = number;
-    return 0;
-}
-
-int lua_Vector_SetZ(lua_State* state)
-{
-    Vector* vector = (Vector*)lua_touserdata(state, 1);
-    if (vector == NULL)
-    {
-        return luaL_typerror(state, 1, "Vector");
-    }
-    if(lua_isnumber(state, 2) == false)
-    {
-        return luaL_typerror(state, 2, "number");
-    }
-    lua_Number number = lua_tonumber(state, 2);
-    vector->z = number;
-    return 0;
-}
-
-int lua_Vector_SetW(lua_State* state)
-{
-    Vector* vector = (Vector*)lua_touserdata(state, 1);
-    if (vector == NULL)
-    {
-        return luaL_typerror(state, 1, "Vector");
-    }
-    if(lua_isnumber(state, 2) == false)
-    {
-        return luaL_typerror(state, 2, "number");
-    }
-    lua_Number number = lua_tonumber(state, 2);
-    vector->w = number;
-    return 0;
-}
-
 int lua_Vector_SetXyzw(lua_State* state)
 {
     Vector* vector = (Vector*)lua_touserdata(state, 1);
@@ -224,7 +163,7 @@ int lua_get_infix_operation_data(lua_State* state, Vector*& leftVector, Vector*&
     leftVector = NULL;
     if(lua_isuserdata(state, 1))
     {
-        if(!luaL_checkudata (state, 1, "Vector"))
+        if(!LuaState::IsType<Vector>(state, 1))
         {
             return luaL_typerror(state, 1, "Vector");
         }
@@ -245,7 +184,7 @@ int lua_get_infix_operation_data(lua_State* state, Vector*& leftVector, Vector*&
     rightVector = NULL;
     if(lua_isuserdata(state, 2))
     {
-        if(!luaL_checkudata (state, 2, "Vector"))
+        if(!LuaState::IsType<Vector>(state, 2))
         {
             return luaL_typerror(state, 2, "Vector");
         }
@@ -270,7 +209,7 @@ int lua_get_binary_operation_data(lua_State* state, Vector*& destination, Vector
     // There are no threads but if there were this would of course, blow up.
     static Vector defaultLeftVector;
     static Vector defaultRightVector;
-    if (!lua_isuserdata(state, 1) || !luaL_checkudata (state, 1, "Vector"))
+    if (!LuaState::IsType<Vector>(state, 1))
     {
         return luaL_typerror(state, 1, "Vector");
     }
@@ -281,7 +220,7 @@ int lua_get_binary_operation_data(lua_State* state, Vector*& destination, Vector
 
     if(lua_isuserdata(state, 2))
     {
-        if(!luaL_checkudata (state, 2, "Vector"))
+        if(!LuaState::IsType<Vector>(state, 2))
         {
             return luaL_typerror(state, 2, "Vector");
         }
@@ -301,7 +240,7 @@ int lua_get_binary_operation_data(lua_State* state, Vector*& destination, Vector
 
     if(lua_isuserdata(state, 3))
     {
-        if(!luaL_checkudata (state, 3, "Vector"))
+        if(!LuaState::IsType<Vector>(state, 3))
         {
             return luaL_typerror(state, 3, "Vector");
         }
@@ -349,7 +288,9 @@ int lua_Vector_Add(lua_State* state)
     assert(rightVector);
     Vector::Add(*destination, *leftVector, *rightVector);
 
-    return 0;
+    // Return the destination so calls can be nested.
+    lua_pushvalue(state, 1);
+    return 1;
 }
 
 int lua_Vector_Subtract(lua_State* state)
@@ -374,7 +315,8 @@ int lua_Vector_Subtract(lua_State* state)
 
     Vector::Subtract(*destination, *leftVector, *rightVector);
 
-    return 0;
+    lua_pushvalue(state, 1);
+    return 1;
 }
 
 int lua_Vector_Multiply(lua_State* state)
@@ -398,7 +340,8 @@ int lua_Vector_Multiply(lua_State* state)
 
     Vector::Multiply(*destination, *leftVector, *rightVector);
 
-    return 0;
+    lua_pushvalue(state, 1);
+    return 1;
 }
 
 int lua_Vector_Divide(lua_State* state)
@@ -430,7 +373,8 @@ int lua_Vector_Divide(lua_State* state)
     }
     Vector::Divide(*destination, *leftVector, *rightVector);
 
-    return 0;
+    lua_pushvalue(state, 1);
+    return 1;
 }
 
 int lua_Vector_MultiplyAdd(lua_State* state)
@@ -457,7 +401,7 @@ int lua_Vector_MultiplyAdd(lua_State* state)
     Vector* addVector = NULL;
     if(lua_isuserdata(state, 4))
     {
-        if(!luaL_checkudata (state, 4, "Vector"))
+        if(!LuaState::IsType<Vector>(state, 4))
         {
             return luaL_typerror(state, 4, "Vector");
         }
@@ -477,23 +421,8 @@ int lua_Vector_MultiplyAdd(lua_State* state)
 
     Vector::MultiplyAdd(*destination, *leftVector, *rightVector, *addVector);
 
-    return 0;
-}
-
-int lua_Vector_SetBroadcast(lua_State* state)
-{
-    Vector* vector = (Vector*)lua_touserdata(state, 1);
-    if (vector == NULL)
-    {
-        return luaL_typerror(state, 1, "Vector");
-    }
-    if(!lua_isnumber(state, 2))
-    {
-        return luaL_typerror(state, 2, "number");
-    }
-    double number = lua_tonumber(state, 2);
-    vector->SetBroadcast(number);
-    return 0;
+    lua_pushvalue(state, 1);
+    return 1;
 }
 
 int lua_Vector_unary_operator(lua_State* state)
@@ -557,54 +486,143 @@ static int lua_Vector_subtract_operator(lua_State* state)
     return lua_infix_op(state, Vector::Subtract);
 }
 
-static int lua_Vector_Copy(lua_State* state)
+//
+// self = self [op] other, returns self.
+// Unlike the metamethods these don't create a new userdata, so there's
+// nothing for the collector to pick up.
+//
+int lua_inplace_op(lua_State* state, void (*opFunctionPointer)(Vector& destination, const Vector& left, const Vector& right))
 {
-    Vector* toVector = LuaState::GetFuncParam<Vector>(state, 1);
-    if(toVector == NULL)
+    if(!LuaState::IsType<Vector>(state, 1))
     {
-        return 0;
+        return luaL_typerror(state, 1, "Vector");
     }
-    Vector* fromVector = LuaState::GetFuncParam<Vector>(state, 2);
-    if(fromVector == NULL)
+
+    Vector* leftVector = NULL;
+    Vector* rightVector = NULL;
+    int result = lua_get_infix_operation_data
+    (
+        state,
+        leftVector,
+        rightVector
+    );
+
+    if(!result)
     {
         return 0;
     }
 
-    toVector->SetXyzw(*fromVector);
-    return 0;
+    (opFunctionPointer)(*leftVector, *leftVector, *rightVector);
+    lua_pushvalue(state, 1);
+    return 1;
+}
+
+static int lua_Vector_AddInPlace(lua_State* state)
+{
+    return lua_inplace_op(state, Vector::Add);
+}
+
+static int lua_Vector_SubtractInPlace(lua_State* state)
+{
+    return lua_inplace_op(state, Vector::Subtract);
+}
+
+static int lua_Vector_MultiplyInPlace(lua_State* state)
+{
+    return lua_inplace_op(state, Vector::Multiply);
+}
+
+static int lua_Vector_DivideInPlace(lua_State* state)
+{
+    if(lua_isnumber(state, 2) && lua_tonumber(state, 2) == 0)
+    {
+        return luaL_error(state, "Divide by zero.");
+    }
+
+    Vector* rightVector = (Vector*)lua_touserdata(state, 2);
+    if(rightVector != NULL
+       && (rightVector->x == 0
+           || rightVector->y == 0
+           || rightVector->z == 0
+           || rightVector->w == 0))
+    {
+        return luaL_error(state, "Divide by zero.");
+    }
+    return lua_inplace_op(state, Vector::Divide);
 }
 
-static int lua_Vector_Length2(lua_State* state)
+static int lua_Vector_NegateInPlace(lua_State* state)
 {
     Vector* vector = LuaState::GetFuncParam<Vector>(state, 1);
     if(vector == NULL)
     {
         return 0;
     }
-    lua_pushnumber(state, vector->Length2());
+    vector->SetXyzw(-vector->x, -vector->y, -vector->z, -vector->w);
+    lua_pushvalue(state, 1);
     return 1;
 }
 
-static int lua_Vector_Length3(lua_State* state)
+//
+// Hands out vectors from a pool kept in the registry. They're only good
+// until the end of the frame, after that the same userdata is handed out
+// again. Use for temporaries: Vector.Add(Vector.Scratch(), a, b)
+//
+static int lua_Vector_Scratch(lua_State* state)
 {
-    Vector* vector = LuaState::GetFuncParam<Vector>(state, 1);
-    if(vector == NULL)
+    lua_getfield(state, LUA_REGISTRYINDEX, Vector::SCRATCH_POOL);
+    if(!lua_istable(state, -1))
     {
-        return 0;
+        lua_pop(state, 1);
+        lua_newtable(state);
+        lua_pushvalue(state, -1);
+        lua_setfield(state, LUA_REGISTRYINDEX, Vector::SCRATCH_POOL);
     }
-    lua_pushnumber(state, vector->Length3());
+
+    lua_getfield(state, -1, "used");
+    int index = (int) lua_tointeger(state, -1) + 1;
+    lua_pop(state, 1);
+    lua_pushinteger(state, index);
+    lua_setfield(state, -2, "used");
+
+    lua_rawgeti(state, -1, index);
+    if(lua_isnil(state, -1))
+    {
+        lua_pop(state, 1);
+        new (lua_newuserdata(state, sizeof(Vector))) Vector();
+        luaL_getmetatable(state, "Vector");
+        lua_setmetatable(state, -2);
+        lua_pushvalue(state, -1);
+        lua_rawseti(state, -3, index);
+    }
+
+    Vector* vector = (Vector*)lua_touserdata(state, -1);
+    vector->SetXyzw
+    (
+        lua_tonumber(state, 1),
+        lua_tonumber(state, 2),
+        lua_tonumber(state, 3),
+        lua_tonumber(state, 4)
+    );
+    lua_remove(state, -2); // pool
     return 1;
 }
 
-static int lua_Vector_Length4(lua_State* state)
+static int lua_Vector_Copy(lua_State* state)
 {
-    Vector* vector = LuaState::GetFuncParam<Vector>(state, 1);
-    if(vector == NULL)
+    Vector* toVector = LuaState::GetFuncParam<Vector>(state, 1);
+    if(toVector == NULL)
     {
         return 0;
     }
-    lua_pushnumber(state, vector->Length4());
-    return 1;
+    Vector* fromVector = LuaState::GetFuncParam<Vector>(state, 2);
+    if(fromVector == NULL)
+    {
+        return 0;
+    }
+
+    toVector->SetXyzw(*fromVector);
+    return 0;
 }
 
 static int lua_Vector_Normalize2(lua_State* state)
@@ -661,54 +679,6 @@ static int lua_Vector_Cross(lua_State* state)
     return 0;
 }
 
-static int lua_Vector_Dot2(lua_State* state)
-{
-    Vector* left = LuaState::GetFuncParam<Vector>(state, 1);
-    if(left == NULL)
-    {
-        return 0;
-    }
-    Vector* right = LuaState::GetFuncParam<Vector>(state, 2);
-    if(right == NULL)
-    {
-        return 0;
-    }
-    lua_pushnumber(state, left->Dot2(*right));
-    return 1;
-}
-
-static int lua_Vector_Dot3(lua_State* state)
-{
-    Vector* left = LuaState::GetFuncParam<Vector>(state, 1);
-    if(left == NULL)
-    {
-        return 0;
-    }
-    Vector* right = LuaState::GetFuncParam<Vector>(state, 2);
-    if(right == NULL)
-    {
-        return 0;
-    }
-    lua_pushnumber(state, left->Dot3(*right));
-    return 1;
-}
-
-static int lua_Vector_Dot4(lua_State* state)
-{
-    Vector* left = LuaState::GetFuncParam<Vector>(state, 1);
-    if(left == NULL)
-    {
-        return 0;
-    }
-    Vector* right = LuaState::GetFuncParam<Vector>(state, 2);
-    if(right == NULL)
-    {
-        return 0;
-    }
-    lua_pushnumber(state, left->Dot4(*right));
-    return 1;
-}
-
 
 static const struct luaL_reg luaBinding [] =
 {
@@ -723,28 +693,34 @@ static const struct luaL_reg luaBinding [] =
     {"Y", lua_Vector_Y},
     {"Z", lua_Vector_Z},
     {"W", lua_Vector_W},
-    {"SetX", lua_Vector_SetX},
-    {"SetY", lua_Vector_SetY},
-    {"SetZ", lua_Vector_SetZ},
-    {"SetW", lua_Vector_SetW},
+    {"SetX", LUA_BIND_METHOD(Vector::SetX)},
+    {"SetY", LUA_BIND_METHOD(Vector::SetY)},
+    {"SetZ", LUA_BIND_METHOD(Vector::SetZ)},
+    {"SetW", LUA_BIND_METHOD(Vector::SetW)},
     {"SetXyzw", lua_Vector_SetXyzw},
     {"Add", lua_Vector_Add},
     {"Multiply", lua_Vector_Multiply},
     {"MultiplyAdd", lua_Vector_MultiplyAdd},
     {"Subtract", lua_Vector_Subtract},
     {"Divide", lua_Vector_Divide},
-    {"SetBroadcast", lua_Vector_SetBroadcast},
+    {"SetBroadcast", LUA_BIND_METHOD(Vector::SetBroadcast)},
+    {"AddInPlace", lua_Vector_AddInPlace},
+    {"SubtractInPlace", lua_Vector_SubtractInPlace},
+    {"MultiplyInPlace", lua_Vector_MultiplyInPlace},
+    {"DivideInPlace", lua_Vector_DivideInPlace},
+    {"NegateInPlace", lua_Vector_NegateInPlace},
+    {"Scratch", lua_Vector_Scratch},
     {"Copy", lua_Vector_Copy},
-    {"Length2", lua_Vector_Length2},
-    {"Length3", lua_Vector_Length3},
-    {"Length4", lua_Vector_Length4},
+    {"Length2", LUA_BIND_METHOD(Vector::Length2)},
+    {"Length3", LUA_BIND_METHOD(Vector::Length3)},
+    {"Length4", LUA_BIND_METHOD(Vector::Length4)},
     {"Normalize2", lua_Vector_Normalize2},
     {"Normalize3", lua_Vector_Normalize3},
     {"Normalize4", lua_Vector_Normalize4},
     {"Cross", lua_Vector_Cross},
-    {"Dot2", lua_Vector_Dot2},
-    {"Dot3", lua_Vector_Dot3},
-    {"Dot4", lua_Vector_Dot4},
+    {"Dot2", LUA_BIND_METHOD(Vector::Dot2)},
+    {"Dot3", LUA_BIND_METHOD(Vector::Dot3)},
+    {"Dot4", LUA_BIND_METHOD(Vector::Dot4)},
     {NULL, NULL}  /* sentinel */
 };
 
@@ -886,6 +862,17 @@ bool Vector::IsNormal3() const
     return Vector::Equal(*this, test, 0.001);
 }
 
+void Vector::ResetScratch(lua_State* state)
+{
+    lua_getfield(state, LUA_REGISTRYINDEX, Vector::SCRATCH_POOL);
+    if(lua_istable(state, -1))
+    {
+        lua_pushinteger(state, 0);
+        lua_setfield(state, -2, "used");
+    }
+    lua_pop(state, 1);
+}
+
 void Vector::Bind(LuaState* state)
 {
     state->Bind
@@ -893,17 +880,15 @@ void Vector::Bind(LuaState* state)
         Vector::Meta.Name(),
         luaBinding
     );
+    LuaFFI::BindView(state, Vector::Meta.Name().c_str());
 }
 
 std::string Vector::ToString() const
 {
-    stringstream ss;
-    ss << "Vector.Create("
-       << x << ", "
-       << y << ", "
-       << z << ", "
-       << w << ")";
-    return ss.str();
+    // %g prints as a stream would, without building one.
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "Vector.Create(%g, %g, %g, %g)", x, y, z, w);
+    return buffer;
 }
 
 Vector Vector::operator *(const Vector& vec) const
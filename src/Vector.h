@@ -13,6 +13,10 @@ class Vector
     public:
         static int lua_Vector_Create(lua_State * state);
         static void Bind(LuaState* state);
+        // Registry key of the pool behind Vector.Scratch()
+        static const char* SCRATCH_POOL;
+        // Scratch vectors handed out this frame can be handed out again.
+        static void ResetScratch(lua_State* state);
         static void Add(Vector& destination, const Vector& left, const Vector& right);
         static void Multiply(Vector& destination, const Vector& left, const Vector& right);
         static void Multiply(Vector& destination, const Vector& left, double right);
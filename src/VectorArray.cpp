@@ -0,0 +1,346 @@
+#include "VectorArray.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+
+#include "DinodeckLua.h"
+#include "LuaState.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+Reflect VectorArray::Meta("VectorArray", VectorArray::Bind);
+
+// GetFuncParam raises the error itself, the NULL never comes back.
+static VectorArray* GetArrayParam(lua_State* state, int index)
+{
+    return LuaState::GetFuncParam<VectorArray>(state, index);
+}
+
+// Checks the 1 based index in argument 2, returns it 0 based.
+static unsigned int CheckIndex(lua_State* state, const VectorArray& array)
+{
+    int index = luaL_checkinteger(state, 2);
+    if(index < 1 || index > (int) array.Count())
+    {
+        luaL_argerror(state, 2, "index out of range");
+    }
+    return (unsigned int) (index - 1);
+}
+
+static int lua_VectorArray_Create(lua_State* state)
+{
+    int count = std::max(0, (int) luaL_optinteger(state, 1, 0));
+    new (lua_newuserdata(state, sizeof(VectorArray))) VectorArray(count);
+    luaL_getmetatable(state, "VectorArray");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_VectorArray_gc(lua_State* state)
+{
+    VectorArray* array = (VectorArray*)lua_touserdata(state, 1);
+    assert(array);
+    array->~VectorArray();
+    return 0;
+}
+
+static int lua_VectorArray_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "VectorArray");
+    return 1;
+}
+
+static int lua_VectorArray_GetCount(lua_State* state)
+{
+    VectorArray* array = GetArrayParam(state, 1);
+    lua_pushinteger(state, array->Count());
+    return 1;
+}
+
+static int lua_VectorArray_Resize(lua_State* state)
+{
+    VectorArray* array = GetArrayParam(state, 1);
+    array->Resize(std::max(0, (int) luaL_checkinteger(state, 2)));
+    return 0;
+}
+
+// array:Get(i) returns x, y, z, w
+static int lua_VectorArray_Get(lua_State* state)
+{
+    VectorArray* array = GetArrayParam(state, 1);
+    unsigned int index = CheckIndex(state, *array);
+    lua_pushnumber(state, array->X(index));
+    lua_pushnumber(state, array->Y(index));
+    lua_pushnumber(state, array->Z(index));
+    lua_pushnumber(state, array->W(index));
+    return 4;
+}
+
+// array:Set(i, vector) or array:Set(i, x, y, [z], [w])
+static int lua_VectorArray_Set(lua_State* state)
+{
+    VectorArray* array = GetArrayParam(state, 1);
+    unsigned int index = CheckIndex(state, *array);
+
+    if(LuaState::IsType<Vector>(state, 3))
+    {
+        Vector* v = (Vector*)lua_touserdata(state, 3);
+        array->Set(index, v->x, v->y, v->z, v->w);
+        return 0;
+    }
+
+    array->Set
+    (
+        index,
+        luaL_checknumber(state, 3),
+        luaL_checknumber(state, 4),
+        luaL_optnumber(state, 5, 0),
+        luaL_optnumber(state, 6, 0)
+    );
+    return 0;
+}
+
+static int lua_VectorArray_Fill(lua_State* state)
+{
+    VectorArray* array = GetArrayParam(state, 1);
+    array->Fill
+    (
+        luaL_checknumber(state, 2),
+        luaL_checknumber(state, 3),
+        luaL_optnumber(state, 4, 0),
+        luaL_optnumber(state, 5, 0)
+    );
+    lua_pushvalue(state, 1);
+    return 1;
+}
+
+// positions:AddScaled(velocities, dt)
+static int lua_VectorArray_AddScaled(lua_State* state)
+{
+    VectorArray* array = GetArrayParam(state, 1);
+    VectorArray* other = GetArrayParam(state, 2);
+    array->AddScaled(*other, luaL_checknumber(state, 3));
+    lua_pushvalue(state, 1);
+    return 1;
+}
+
+static int lua_VectorArray_Clamp(lua_State* state)
+{
+    VectorArray* array = GetArrayParam(state, 1);
+    Vector* min = LuaState::GetFuncParam<Vector>(state, 2);
+    Vector* max = LuaState::GetFuncParam<Vector>(state, 3);
+    if(min == NULL || max == NULL)
+    {
+        return 0;
+    }
+    array->Clamp(*min, *max);
+    lua_pushvalue(state, 1);
+    return 1;
+}
+
+// array:Length2(out) writes the lengths to out's x, and returns out
+static int lua_VectorArray_Length2(lua_State* state)
+{
+    VectorArray* array = GetArrayParam(state, 1);
+    VectorArray* out = GetArrayParam(state, 2);
+    array->Length2(*out);
+    lua_pushvalue(state, 2);
+    return 1;
+}
+
+static int lua_VectorArray_Lerp(lua_State* state)
+{
+    VectorArray* array = GetArrayParam(state, 1);
+    VectorArray* to = GetArrayParam(state, 2);
+    array->Lerp(*to, luaL_checknumber(state, 3));
+    lua_pushvalue(state, 1);
+    return 1;
+}
+
+static int lua_VectorArray_TransformBy(lua_State* state)
+{
+    VectorArray* array = GetArrayParam(state, 1);
+    Matrix* matrix = LuaState::GetFuncParam<Matrix>(state, 2);
+    if(matrix == NULL)
+    {
+        return 0;
+    }
+    array->TransformBy(*matrix);
+    lua_pushvalue(state, 1);
+    return 1;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_VectorArray_Create},
+  {"__gc", lua_VectorArray_gc},
+  {"__tostring", lua_VectorArray_tostring},
+  {"GetCount", lua_VectorArray_GetCount},
+  {"Resize", lua_VectorArray_Resize},
+  {"Get", lua_VectorArray_Get},
+  {"Set", lua_VectorArray_Set},
+  {"Fill", lua_VectorArray_Fill},
+  {"AddScaled", lua_VectorArray_AddScaled},
+  {"Clamp", lua_VectorArray_Clamp},
+  {"Length2", lua_VectorArray_Length2},
+  {"Lerp", lua_VectorArray_Lerp},
+  {"TransformBy", lua_VectorArray_TransformBy},
+  {NULL, NULL}  /* sentinel */
+};
+
+void VectorArray::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        VectorArray::Meta.Name(),
+        luaBinding
+    );
+}
+
+VectorArray::VectorArray(unsigned int count) :
+    mX(count, 0),
+    mY(count, 0),
+    mZ(count, 0),
+    mW(count, 0)
+{
+}
+
+void VectorArray::Resize(unsigned int count)
+{
+    mX.resize(count, 0);
+    mY.resize(count, 0);
+    mZ.resize(count, 0);
+    mW.resize(count, 0);
+}
+
+void VectorArray::Set(unsigned int index, float x, float y, float z, float w)
+{
+    mX[index] = x;
+    mY[index] = y;
+    mZ[index] = z;
+    mW[index] = w;
+}
+
+void VectorArray::Fill(float x, float y, float z, float w)
+{
+    std::fill(mX.begin(), mX.end(), x);
+    std::fill(mY.begin(), mY.end(), y);
+    std::fill(mZ.begin(), mZ.end(), z);
+    std::fill(mW.begin(), mW.end(), w);
+}
+
+//
+// The kernels below run one component at a time over raw pointers, so
+// each loop is a single stream the compiler can turn into SIMD.
+//
+
+static void AddScaledStream(float* out, const float* in, float scale, unsigned int count)
+{
+    for(unsigned int i = 0; i < count; i++)
+    {
+        out[i] += in[i] * scale;
+    }
+}
+
+static void LerpStream(float* out, const float* to, float t, unsigned int count)
+{
+    for(unsigned int i = 0; i < count; i++)
+    {
+        out[i] += (to[i] - out[i]) * t;
+    }
+}
+
+static void ClampStream(float* out, float min, float max, unsigned int count)
+{
+    for(unsigned int i = 0; i < count; i++)
+    {
+        float value = out[i] < min ? min : out[i];
+        out[i] = value > max ? max : value;
+    }
+}
+
+void VectorArray::AddScaled(const VectorArray& other, float scale)
+{
+    const unsigned int count = std::min(Count(), other.Count());
+    if(count == 0)
+    {
+        return;
+    }
+    AddScaledStream(&mX[0], &other.mX[0], scale, count);
+    AddScaledStream(&mY[0], &other.mY[0], scale, count);
+    AddScaledStream(&mZ[0], &other.mZ[0], scale, count);
+    AddScaledStream(&mW[0], &other.mW[0], scale, count);
+}
+
+void VectorArray::Clamp(const Vector& min, const Vector& max)
+{
+    const unsigned int count = Count();
+    if(count == 0)
+    {
+        return;
+    }
+    ClampStream(&mX[0], min.x, max.x, count);
+    ClampStream(&mY[0], min.y, max.y, count);
+    ClampStream(&mZ[0], min.z, max.z, count);
+    ClampStream(&mW[0], min.w, max.w, count);
+}
+
+void VectorArray::Length2(VectorArray& out) const
+{
+    const unsigned int count = std::min(Count(), out.Count());
+    const float* x = count ? &mX[0] : NULL;
+    const float* y = count ? &mY[0] : NULL;
+    float* length = count ? &out.mX[0] : NULL;
+
+    for(unsigned int i = 0; i < count; i++)
+    {
+        length[i] = sqrtf(x[i] * x[i] + y[i] * y[i]);
+    }
+}
+
+void VectorArray::Lerp(const VectorArray& to, float t)
+{
+    const unsigned int count = std::min(Count(), to.Count());
+    if(count == 0)
+    {
+        return;
+    }
+    LerpStream(&mX[0], &to.mX[0], t, count);
+    LerpStream(&mY[0], &to.mY[0], t, count);
+    LerpStream(&mZ[0], &to.mZ[0], t, count);
+    LerpStream(&mW[0], &to.mW[0], t, count);
+}
+
+void VectorArray::TransformBy(const Matrix& matrix)
+{
+    const unsigned int count = Count();
+    if(count == 0)
+    {
+        return;
+    }
+
+    const Vector& c0 = matrix.GetCol0();
+    const Vector& c1 = matrix.GetCol1();
+    const Vector& c2 = matrix.GetCol2();
+    const Vector& c3 = matrix.GetCol3();
+    const float m00 = c0.x, m01 = c1.x, m02 = c2.x, m03 = c3.x;
+    const float m10 = c0.y, m11 = c1.y, m12 = c2.y, m13 = c3.y;
+    const float m20 = c0.z, m21 = c1.z, m22 = c2.z, m23 = c3.z;
+    const float m30 = c0.w, m31 = c1.w, m32 = c2.w, m33 = c3.w;
+
+    float* x = &mX[0];
+    float* y = &mY[0];
+    float* z = &mZ[0];
+    float* w = &mW[0];
+    for(unsigned int i = 0; i < count; i++)
+    {
+        const float vx = x[i];
+        const float vy = y[i];
+        const float vz = z[i];
+        const float vw = w[i];
+        x[i] = m00 * vx + m01 * vy + m02 * vz + m03 * vw;
+        y[i] = m10 * vx + m11 * vy + m12 * vz + m13 * vw;
+        z[i] = m20 * vx + m21 * vy + m22 * vz + m23 * vw;
+        w[i] = m30 * vx + m31 * vy + m32 * vz + m33 * vw;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef VECTORARRAY_H
+#define VECTORARRAY_H
+
+#include <vector>
+
+#include "reflect/Reflect.h"
+
+class LuaState;
+class Matrix;
+class Vector;
+
+//
+// Many vectors stored as one float array per component. The math works
+// on the whole array in a single call, in tight loops over contiguous
+// floats the compiler can vectorise, rather than a metamethod call per
+// Vector userdata.
+//
+// Kernels that take a second array work over the shorter of the two.
+//
+class VectorArray
+{
+    public: static Reflect Meta;
+    public:
+        static void Bind(LuaState* state);
+
+        VectorArray(unsigned int count);
+
+        unsigned int Count() const { return mX.size(); }
+        void Resize(unsigned int count);
+
+        // Index is 0 based, callers check the range.
+        void Set(unsigned int index, float x, float y, float z, float w);
+        void Fill(float x, float y, float z, float w);
+        float X(unsigned int index) const { return mX[index]; }
+        float Y(unsigned int index) const { return mY[index]; }
+        float Z(unsigned int index) const { return mZ[index]; }
+        float W(unsigned int index) const { return mW[index]; }
+
+        // this += other * scale, velocities into positions for instance.
+        void AddScaled(const VectorArray& other, float scale);
+        void Clamp(const Vector& min, const Vector& max);
+        // Stores the 2d length of each vector in out's x, like Vector:Length2.
+        void Length2(VectorArray& out) const;
+        // this += (to - this) * t
+        void Lerp(const VectorArray& to, float t);
+        void TransformBy(const Matrix& matrix);
+    private:
+        std::vector<float> mX;
+        std::vector<float> mY;
+        std::vector<float> mZ;
+        std::vector<float> mW;
+};
+
+#endif
\ No newline at end of file
@@ -1,72 +1,75 @@
 #ifndef VERTEX_H
 #define VERTEX_H
 
+#include <algorithm>
+#include <cmath>
+
 #include "Vector.h"
 
 struct Vertex
 {
     float x, y, z;
-    float r, b, g, a;
+    float r, g, b, a;
     float u, v;
 
     Vertex()
         : x(0), y(0), z(0),
-          r(1), b(1), g(1), a(1),
+          r(1), g(1), b(1), a(1),
           u(0), v(0) {}
 
     Vertex(float x, float y, float z)
         : x(x), y(y), z(z),
-          r(1), b(1), g(1), a(1),
+          r(1), g(1), b(1), a(1),
           u(0), v(0) {}
 
     Vertex(float x, float y, float z,
            float r, float g, float b, float a)
         : x(x), y(y), z(z),
-          r(r), b(b), g(g), a(a),
+          r(r), g(g), b(b), a(a),
           u(0), v(0) {}
 
     Vertex(float x, float y, float z,
            float r, float g, float b, float a,
            float u, float v)
         : x(x), y(y), z(z),
-          r(r), b(b), g(g), a(a),
+          r(r), g(g), b(b), a(a),
           u(u), v(v) {}
 
     Vertex(const Vector& pos)
         : x(pos.x), y(pos.y), z(pos.z),
-          r(1), b(1), g(1), a(1),
+          r(1), g(1), b(1), a(1),
           u(0), v(0) {}
 
     Vertex(const Vector& pos,
            const Vector& col)
         : x(pos.x), y(pos.y), z(pos.z),
-          r(col.x), b(col.y), g(col.z), a(col.w),
+          r(col.x), g(col.y), b(col.z), a(col.w),
           u(0), v(0) {}
 
     Vertex(const Vector& pos,
            const Vector& col,
            float u, float v)
         : x(pos.x), y(pos.y), z(pos.z),
-          r(col.x), b(col.y), g(col.z), a(col.w),
+          r(col.x), g(col.y), b(col.z), a(col.w),
           u(u), v(v) {}
 
     Vertex(const Vector& pos,
            float u, float v)
         : x(pos.x), y(pos.y), z(pos.z),
-          r(1), b(1), g(1), a(1),
+          r(1), g(1), b(1), a(1),
           u(u), v(v) {}
 
     Vertex(float x, float y, float z,
            const Vector& col)
         : x(x), y(y), z(z),
-          r(col.x), b(col.y), g(col.z), a(col.w),
+          r(col.x), g(col.y), b(col.z), a(col.w),
           u(0), v(0) {}
 
     Vertex(float x, float y, float z,
            const Vector& col,
            float u, float v)
         : x(x), y(y), z(z),
-          r(col.x), b(col.y), g(col.z), a(col.w),
+          r(col.x), g(col.y), b(col.z), a(col.w),
           u(u), v(v) {}
 
       void Set(const Vector& pos,
@@ -86,4 +89,112 @@ struct Vertex
           v = v_;
       }
 };
+
+//
+// The 2D batch's vertex as sent to GL, 16 bytes to Vertex's 36.
+// Texture coords are fixed point in 1/UV_ONE steps. GLES1 doesn't
+// normalize them, so they're scaled back with the texture matrix.
+// UV_ONE divides any power of two texture up to 8192 evenly, so texel
+// aligned coords, like atlas regions and glyphs, stay exact. Coords
+// within +/-4 pack as they are, the batch's UVBase covers the rest.
+//
+struct PackedVertex
+{
+    static const int UV_ONE = 8192;
+
+    float x, y;
+    unsigned char r, g, b, a;
+    short u, v;
+
+    PackedVertex()
+        : x(0), y(0),
+          r(255), g(255), b(255), a(255),
+          u(0), v(0) {}
+
+    explicit PackedVertex(const Vertex& vertex)
+        : x(vertex.x), y(vertex.y),
+          r(PackColour(vertex.r)), g(PackColour(vertex.g)),
+          b(PackColour(vertex.b)), a(PackColour(vertex.a)),
+          u(PackUV(vertex.u)), v(PackUV(vertex.v)) {}
+
+    static unsigned char PackColour(float value)
+    {
+        if(value <= 0) return 0;
+        if(value >= 1) return 255;
+        return (unsigned char) (value * 255.0f + 0.5f);
+    }
+
+    static short PackUV(float value)
+    {
+        return PackUV(value, 0, 0);
+    }
+
+    // In steps of 2^shift / UV_ONE from origin, see UVBase.
+    static short PackUV(float value, float origin, int shift)
+    {
+        float fixed = (value - origin) * (UV_ONE >> shift);
+        if(fixed <= -32768.0f) return -32768;
+        if(fixed >= 32767.0f) return 32767;
+        return (short) (fixed < 0 ? fixed - 0.5f : fixed + 0.5f);
+    }
+
+    // True if the coord packs without a UVBase.
+    static bool FitsUV(float value)
+    {
+        return value * UV_ONE > -32768.0f && value * UV_ONE < 32767.0f;
+    }
+};
+
+//
+// What a batch's packed coords are relative to, the coord is
+// u + packed * Scale(). Nearly every batch uses the default, coords
+// within +/-4. Quads past that, like repeating and scrolling textures,
+// batch with a base of their own, a whole number near their middle and
+// the finest step that reaches their corners.
+//
+struct UVBase
+{
+    static const int MAX_SHIFT = 13; // a step of a whole texture
+
+    float u, v;
+    int shift;
+
+    UVBase() : u(0), v(0), shift(0) {}
+
+    float Scale() const { return 1.0f / (PackedVertex::UV_ONE >> shift); }
+    bool IsDefault() const { return u == 0 && v == 0 && shift == 0; }
+
+    bool operator==(const UVBase& other) const
+    {
+        return u == other.u && v == other.v && shift == other.shift;
+    }
+
+    bool operator!=(const UVBase& other) const { return !(*this == other); }
+
+    // The base for coords from minU to maxU and minV to maxV. False if
+    // even the coarsest step can't reach them, they'll be clamped.
+    static bool Fit(float minU, float maxU, float minV, float maxV, UVBase* base)
+    {
+        *base = UVBase();
+        if(PackedVertex::FitsUV(minU) && PackedVertex::FitsUV(maxU)
+           && PackedVertex::FitsUV(minV) && PackedVertex::FitsUV(maxV))
+        {
+            return true;
+        }
+
+        base->u = std::floor((minU + maxU) * 0.5f);
+        base->v = std::floor((minV + maxV) * 0.5f);
+        const float reach = std::max(std::max(maxU - base->u, base->u - minU),
+                                     std::max(maxV - base->v, base->v - minV));
+        while(reach * (PackedVertex::UV_ONE >> base->shift) >= 32767.0f)
+        {
+            if(base->shift == MAX_SHIFT)
+            {
+                return false;
+            }
+            base->shift++;
+        }
+        return true;
+    }
+};
 #endif
@@ -0,0 +1,116 @@
+#include "VertexStream.h"
+
+#include <assert.h>
+
+#include "DinodeckGL.h"
+#include "DDLog.h"
+#include "MemoryStats.h"
+#include "Vertex.h"
+
+void VertexStream::Reset()
+{
+    // The buffer went with the old context and its name may already be
+    // reused by a live one, so it's only forgotten.
+    ForgetBuffer();
+    mCursor = 0;
+}
+
+void VertexStream::SetEnabled(bool value)
+{
+    if(!value)
+    {
+        DestroyBuffer();
+    }
+    mEnabled = value;
+}
+
+void VertexStream::DestroyBuffer()
+{
+    if(mBufferId != 0)
+    {
+        glDeleteBuffers(1, &mBufferId);
+        ForgetBuffer();
+    }
+}
+
+void VertexStream::ForgetBuffer()
+{
+    if(mBufferId != 0)
+    {
+        mBufferId = 0;
+        MemoryStats::Release(MemoryStats::MEMORY_VERTICES, mCapacity * sizeof(PackedVertex));
+    }
+}
+
+bool VertexStream::CreateBuffer(unsigned int capacity)
+{
+    DestroyBuffer();
+    glGenBuffers(1, &mBufferId);
+
+    if(mBufferId == 0)
+    {
+        dsprintf("Vertex streaming unavailable, using client arrays.\n");
+        mEnabled = false;
+        return false;
+    }
+
+    mCapacity = capacity;
+    mCursor = 0;
+    glBindBuffer(GL_ARRAY_BUFFER, mBufferId);
+    glBufferData(GL_ARRAY_BUFFER, mCapacity * sizeof(PackedVertex), NULL, GL_STREAM_DRAW);
+    MemoryStats::Add(MemoryStats::MEMORY_VERTICES, mCapacity * sizeof(PackedVertex));
+    return true;
+}
+
+int VertexStream::Upload(const PackedVertex* verts, unsigned int count)
+{
+    assert(verts);
+
+    if(!mEnabled)
+    {
+        return -1;
+    }
+
+    if(mBufferId == 0 || count > mCapacity)
+    {
+        unsigned int capacity = mCapacity;
+        while(capacity < count)
+        {
+            capacity *= 2;
+        }
+
+        if(!CreateBuffer(capacity))
+        {
+            return -1;
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, mBufferId);
+
+    if(mCursor + count > mCapacity)
+    {
+        // Orphan the old storage rather than waiting for the GPU to finish
+        // with it.
+        glBufferData(GL_ARRAY_BUFFER, mCapacity * sizeof(PackedVertex), NULL, GL_STREAM_DRAW);
+        mCursor = 0;
+    }
+
+    int first = (int) mCursor;
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    mCursor * sizeof(PackedVertex),
+                    count * sizeof(PackedVertex),
+                    verts);
+    mCursor += count;
+    return first;
+}
+
+void VertexStream::Bind()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, mBufferId);
+}
+
+void VertexStream::Unbind()
+{
+    // FTGL and the display quad still use client side arrays.
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,51 @@
+#ifndef VERTEXSTREAM_H
+#define VERTEXSTREAM_H
+
+#include "DinodeckGL.h"
+
+struct PackedVertex;
+
+//
+// A ring of GPU memory that batches are streamed into.
+// Each flush appends its vertices after the previous flush's and draws
+// from that offset. When the ring is full the buffer is orphaned so the
+// driver can hand back fresh memory without waiting on queued draws.
+//
+class VertexStream
+{
+    GLuint mBufferId;
+    unsigned int mCapacity; // in verts
+    unsigned int mCursor;   // next free vert in the ring
+    bool mEnabled;
+public:
+    static const unsigned int DEFAULT_CAPACITY_IN_VERTS = 64 * 1024;
+
+    VertexStream() :
+        mBufferId(0),
+        mCapacity(DEFAULT_CAPACITY_IN_VERTS),
+        mCursor(0),
+        mEnabled(true)
+        {}
+    ~VertexStream() { DestroyBuffer(); }
+
+    // Forget the GPU buffer, it's recreated on next use.
+    // Call when the OpenGL context has been lost.
+    void Reset();
+    void SetEnabled(bool value);
+    bool IsEnabled() const { return mEnabled; }
+
+    // Copies the verts into the ring and leaves the buffer bound.
+    // Returns the index of the first vert to pass to glDrawArrays.
+    // Returns -1 if streaming isn't available, client arrays should be used.
+    int Upload(const PackedVertex* verts, unsigned int count);
+    // Binds the buffer again after an attribute pointer into client
+    // memory has been set.
+    void Bind();
+    void Unbind();
+private:
+    bool CreateBuffer(unsigned int capacity);
+    void DestroyBuffer();
+    void ForgetBuffer();
+};
+
+#endif
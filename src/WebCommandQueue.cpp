@@ -0,0 +1,96 @@
+#include "WebCommandQueue.h"
+
+#include <assert.h>
+
+void WebCommandQueue::Command::Answer(const std::string& reply)
+{
+    ScopedLock lock(mMutex);
+    mReply = reply;
+    mDone = true;
+    mAnswered.Broadcast();
+}
+
+void WebCommandQueue::Command::Release()
+{
+    mMutex.Lock();
+    const bool last = --mRefs == 0;
+    mMutex.Unlock();
+
+    if(last)
+    {
+        delete this;
+    }
+}
+
+WebCommandQueue::WebCommandQueue() :
+    mCommands(),
+    mClosed(false)
+{
+}
+
+WebCommandQueue::~WebCommandQueue()
+{
+    Close();
+}
+
+std::string WebCommandQueue::Send(const std::string& uri,
+                                  const std::string& postdata,
+                                  unsigned int timeoutMilliseconds)
+{
+    Command* command = new Command(uri, postdata);
+
+    mMutex.Lock();
+    if(mClosed)
+    {
+        mMutex.Unlock();
+        delete command;
+        return std::string("");
+    }
+    command->mRefs++; // one for the queue
+    mCommands.push_back(command);
+    mMutex.Unlock();
+
+    std::string reply;
+    command->mMutex.Lock();
+    while(!command->mDone)
+    {
+        if(!command->mAnswered.Wait(command->mMutex, timeoutMilliseconds))
+        {
+            break;
+        }
+    }
+    reply = command->mReply;
+    command->mMutex.Unlock();
+
+    command->Release();
+    return reply;
+}
+
+WebCommandQueue::Command* WebCommandQueue::Pop()
+{
+    ScopedLock lock(mMutex);
+    if(mCommands.empty())
+    {
+        return NULL;
+    }
+
+    Command* command = mCommands.front();
+    mCommands.pop_front();
+    return command;
+}
+
+void WebCommandQueue::Close()
+{
+    std::deque<Command*> left;
+    {
+        ScopedLock lock(mMutex);
+        mClosed = true;
+        left.swap(mCommands);
+    }
+
+    for(std::deque<Command*>::iterator it = left.begin(); it != left.end(); ++it)
+    {
+        (*it)->Answer(std::string(""));
+        (*it)->Release();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef WEBCOMMANDQUEUE_H
+#define WEBCOMMANDQUEUE_H
+
+#include <deque>
+#include <string>
+
+#include "Threading.h"
+
+//
+// Requests from the webserver's threads, run on the main thread.
+// Any number of threads push and block for the reply, the main loop
+// drains the queue once a frame and answers each command in order.
+//
+class WebCommandQueue
+{
+public:
+    // Shared by the two threads, whichever is done with it last deletes it,
+    // so a request that's stopped waiting can still be answered.
+    class Command
+    {
+        friend class WebCommandQueue;
+        Mutex mMutex;
+        Condition mAnswered;
+        int mRefs;
+        bool mDone;
+        std::string mReply;
+    public:
+        const std::string uri;
+        const std::string postdata;
+
+        Command(const std::string& uri, const std::string& postdata) :
+            mRefs(1), mDone(false), uri(uri), postdata(postdata) {}
+
+        // Main thread. Wakes the requesting thread.
+        void Answer(const std::string& reply);
+    private:
+        void Release();
+    };
+
+    static const unsigned int DEFAULT_TIMEOUT_MILLISECONDS = 5000;
+
+    WebCommandQueue();
+    ~WebCommandQueue(); // answers anything left
+
+    // Webserver threads. Waits up to the timeout for the main thread's
+    // reply, an empty reply if it's closed or doesn't answer in time.
+    std::string Send(const std::string& uri,
+                     const std::string& postdata,
+                     unsigned int timeoutMilliseconds = DEFAULT_TIMEOUT_MILLISECONDS);
+
+    // Main thread. Pop, run, Answer then Release each command.
+    Command* Pop();
+    void Done(Command* command) { command->Release(); }
+
+    // Answers everything queued with an empty reply and refuses more.
+    void Close();
+private:
+    Mutex mMutex;
+    std::deque<Command*> mCommands;
+    bool mClosed;
+
+    WebCommandQueue(const WebCommandQueue&);
+    WebCommandQueue& operator=(const WebCommandQueue&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "WebSocket.h"
+
+#include <mongoose.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+static const char* HANDSHAKE_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+enum Opcode
+{
+    OPCODE_TEXT = 0x1,
+    OPCODE_CLOSE = 0x8
+};
+
+static unsigned int Rotate(unsigned int value, unsigned int bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// The handshake is the only user, so it's the plain byte at a time version.
+static void Sha1(const std::string& message, unsigned char digest[20])
+{
+    unsigned int h[5] =
+    {
+        0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
+    };
+
+    std::string data = message;
+    const unsigned long long bits = (unsigned long long) message.size() * 8;
+    data.push_back((char) 0x80);
+    while(data.size() % 64 != 56)
+    {
+        data.push_back('\0');
+    }
+    for(int i = 7; i >= 0; i--)
+    {
+        data.push_back((char) (bits >> (i * 8)));
+    }
+
+    for(size_t chunk = 0; chunk < data.size(); chunk += 64)
+    {
+        unsigned int w[80];
+        for(int i = 0; i < 16; i++)
+        {
+            const unsigned char* p = (const unsigned char*) &data[chunk + i * 4];
+            w[i] = (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+        }
+        for(int i = 16; i < 80; i++)
+        {
+            w[i] = Rotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        unsigned int a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for(int i = 0; i < 80; i++)
+        {
+            unsigned int f, k;
+            if(i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if(i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if(i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else            { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+
+            const unsigned int temp = Rotate(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = Rotate(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    for(int i = 0; i < 20; i++)
+    {
+        digest[i] = (unsigned char) (h[i / 4] >> ((3 - i % 4) * 8));
+    }
+}
+
+static std::string Base64(const unsigned char* data, size_t length)
+{
+    static const char* table =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for(size_t i = 0; i < length; i += 3)
+    {
+        unsigned int n = data[i] << 16;
+        if(i + 1 < length) n |= data[i + 1] << 8;
+        if(i + 2 < length) n |= data[i + 2];
+
+        out.push_back(table[(n >> 18) & 63]);
+        out.push_back(table[(n >> 12) & 63]);
+        out.push_back(i + 1 < length ? table[(n >> 6) & 63] : '=');
+        out.push_back(i + 2 < length ? table[n & 63] : '=');
+    }
+    return out;
+}
+
+static bool SendFrame(mg_connection* conn,
+                      Opcode opcode,
+                      const char* payload,
+                      size_t length)
+{
+    // Server frames are never masked.
+    unsigned char header[10];
+    size_t headerLength = 2;
+    header[0] = 0x80 | opcode; // final fragment
+    if(length < 126)
+    {
+        header[1] = (unsigned char) length;
+    }
+    else if(length <= 0xFFFF)
+    {
+        header[1] = 126;
+        header[2] = (unsigned char) (length >> 8);
+        header[3] = (unsigned char) length;
+        headerLength = 4;
+    }
+    else
+    {
+        header[1] = 127;
+        for(int i = 0; i < 8; i++)
+        {
+            header[2 + i] = (unsigned char) ((unsigned long long) length >> ((7 - i) * 8));
+        }
+        headerLength = 10;
+    }
+
+    if(mg_write(conn, header, headerLength) != (int) headerLength)
+    {
+        return false;
+    }
+    return length == 0 || mg_write(conn, payload, length) == (int) length;
+}
+
+bool WebSocket::IsUpgrade(mg_connection* conn)
+{
+    const char* upgrade = mg_get_header(conn, "Upgrade");
+    return upgrade != NULL && strcasecmp(upgrade, "websocket") == 0;
+}
+
+bool WebSocket::Accept(mg_connection* conn)
+{
+    const char* key = mg_get_header(conn, "Sec-WebSocket-Key");
+    if(key == NULL)
+    {
+        mg_printf(conn, "HTTP/1.1 400 Bad Request\r\n\r\n");
+        return false;
+    }
+
+    unsigned char digest[20];
+    Sha1(std::string(key) + HANDSHAKE_GUID, digest);
+    mg_printf(conn,
+              "HTTP/1.1 101 Switching Protocols\r\n"
+              "Upgrade: websocket\r\n"
+              "Connection: Upgrade\r\n"
+              "Sec-WebSocket-Accept: %s\r\n"
+              "\r\n",
+              Base64(digest, sizeof(digest)).c_str());
+    return true;
+}
+
+bool WebSocket::SendText(mg_connection* conn, const std::string& text)
+{
+    return SendFrame(conn, OPCODE_TEXT, text.data(), text.size());
+}
+
+void WebSocket::Close(mg_connection* conn)
+{
+    // Status 1000, normal closure.
+    const char status[2] = { (char) 0x03, (char) 0xE8 };
+    SendFrame(conn, OPCODE_CLOSE, status, sizeof(status));
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef WEBSOCKET_H
+#define WEBSOCKET_H
+
+#include <string>
+
+struct mg_connection;
+
+//
+// Just enough of RFC 6455 to push messages to a browser over a mongoose
+// connection. Frames from the client aren't read, a failed write is taken
+// as the client having gone.
+//
+class WebSocket
+{
+public:
+    // True if the request asks to upgrade.
+    static bool IsUpgrade(mg_connection* conn);
+    // Sends the handshake reply. False if the request is missing its key.
+    static bool Accept(mg_connection* conn);
+    static bool SendText(mg_connection* conn, const std::string& text);
+    static void Close(mg_connection* conn);
+};
+
+#endif
\ No newline at end of file
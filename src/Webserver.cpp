@@ -7,11 +7,24 @@
 #include <string.h>
 
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "DDLog.h"
+#include "DDTime.h"
 #include "IWebserverCallback.h"
+#include "Trace.h"
+#include "WebSocket.h"
 
 #define MAX_PORT_NUMBER 65535
 
+static const unsigned int TRACE_DEFAULT_SECONDS = 10;
+static const unsigned int TRACE_MAX_SECONDS = 120;
+static const unsigned int TRACE_SEND_INTERVAL_MS = 100;
+
 #if __APPLE__
 int itoa(int value, char *buf, size_t sz)
 {
@@ -19,6 +32,105 @@ int itoa(int value, char *buf, size_t sz)
 }
 #endif
 
+static void SleepMs(unsigned int milliseconds)
+{
+#ifdef _WIN32
+    Sleep(milliseconds);
+#else
+    usleep(milliseconds * 1000);
+#endif
+}
+
+//
+// /trace/?seconds=N captures the engine's zones for N seconds.
+//
+// Upgraded to a WebSocket, every message is a JSON array of trace events
+// as they come in; joined together under "traceEvents" they load into
+// chrome://tracing or Perfetto. A plain GET waits out the capture and
+// replies with the whole trace file.
+//
+static void ServeTrace(mg_connection* conn, const mg_request_info* request_info)
+{
+    unsigned int seconds = TRACE_DEFAULT_SECONDS;
+    if(request_info->query_string)
+    {
+        char value[16];
+        mg_get_var(request_info->query_string,
+                   strlen(request_info->query_string),
+                   "seconds", value, sizeof(value));
+        if(atoi(value) > 0)
+        {
+            seconds = atoi(value);
+        }
+    }
+    if(seconds > TRACE_MAX_SECONDS)
+    {
+        seconds = TRACE_MAX_SECONDS;
+    }
+
+    const bool streaming = WebSocket::IsUpgrade(conn);
+    if(streaming && !WebSocket::Accept(conn))
+    {
+        return;
+    }
+
+    if(!Trace::Start())
+    {
+        const char* busy = "Another trace capture is running.";
+        if(streaming)
+        {
+            WebSocket::SendText(conn, busy);
+            WebSocket::Close(conn);
+        }
+        else
+        {
+            mg_printf(conn, "HTTP/1.1 409 Conflict\r\n\r\n%s", busy);
+        }
+        return;
+    }
+
+    dsprintf("Trace capture started for %u seconds.\n", seconds);
+    std::string events;
+    Trace::WriteThreadNames(&events);
+
+    const unsigned long long end = DDTime::Microseconds()
+                                 + seconds * 1000000ULL;
+    bool connected = true;
+    while(connected && DDTime::Microseconds() < end)
+    {
+        SleepMs(TRACE_SEND_INTERVAL_MS);
+        Trace::Drain(&events);
+        if(streaming && !events.empty())
+        {
+            connected = WebSocket::SendText(conn, "[" + events + "]");
+            events.clear();
+        }
+    }
+
+    Trace::Stop();
+    Trace::Drain(&events);
+    dsprintf("Trace capture finished, %u events dropped.\n", Trace::Dropped());
+
+    if(streaming)
+    {
+        if(connected && !events.empty())
+        {
+            WebSocket::SendText(conn, "[" + events + "]");
+        }
+        WebSocket::Close(conn);
+        return;
+    }
+
+    const std::string body = "{\"traceEvents\":[" + events + "]}";
+    mg_printf(conn,
+              "HTTP/1.1 200 OK\r\n"
+              "Content-Type: application/json\r\n"
+              "Content-Length: %d\r\n"
+              "\r\n",
+              (int) body.length());
+    mg_write(conn, body.data(), body.length());
+}
+
 void* WebServer::callback(enum mg_event event,
                           struct mg_connection* conn,
                           const struct mg_request_info* request_info)
@@ -27,6 +139,14 @@ void* WebServer::callback(enum mg_event event,
     {
         assert(request_info->user_data);
         WebServer* server = static_cast<WebServer*>(request_info->user_data);
+
+        // Runs on this connection's thread until the capture ends.
+        if(!strcmp(request_info->uri, "/trace/"))
+        {
+            ServeTrace(conn, request_info);
+            return (void*)"";
+        }
+
         // Me
         const char* cl = mg_get_header(conn, "Content-Length");
         std::string postdata;
@@ -37,12 +157,20 @@ void* WebServer::callback(enum mg_event event,
             //printf("Content-length:%s\n", cl);
             //printf("Content-length%d\n", conn->content_len);
             size_t buf_len = atoi(cl);
-            char* buffer = (char*) malloc(buf_len + 1);
-            mg_read(conn, buffer, buf_len);
-            buffer[buf_len] = '\0';
-           // printf("%s\n", buffer);
-            postdata = buffer;
-            free(buffer);
+            // Read straight into the string rather than through a copy.
+            // Pushed assets are binary and big enough to arrive in pieces.
+            postdata.resize(buf_len);
+            size_t received = 0;
+            while(received < buf_len)
+            {
+                int read = mg_read(conn, &postdata[received], buf_len - received);
+                if(read <= 0)
+                {
+                    break;
+                }
+                received += read;
+            }
+            postdata.resize(received);
         }
 
         //dsprintf("Webserver message: %s", request_info->uri);
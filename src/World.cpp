@@ -0,0 +1,1006 @@
+#include "World.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
+
+#include "Animation.h"
+#include "Dinodeck.h"
+#include "DinodeckLua.h"
+#include "GraphicsPipeline.h"
+#include "LuaState.h"
+#include "Texture.h"
+#include "Vector.h"
+#include "VectorArray.h"
+
+Reflect World::Meta("World", World::Bind);
+
+// Matches eComponent's bits, lowest first.
+static const char* componentNames[] = { "transform", "velocity", "sprite", "animation", NULL };
+
+World::World() : mCount(0)
+{
+    std::fill(mArchetypes, mArchetypes + ARCHETYPE_COUNT, (Archetype*) NULL);
+}
+
+World::~World()
+{
+    for(unsigned int i = 0; i < ARCHETYPE_COUNT; i++)
+    {
+        delete mArchetypes[i];
+    }
+}
+
+const World::Slot* World::Find(unsigned int entity) const
+{
+    const unsigned int index = entity & INDEX_MASK;
+    if(index >= mSlots.size())
+    {
+        return NULL;
+    }
+
+    const Slot& slot = mSlots[index];
+    if(!slot.alive || slot.generation != (entity >> INDEX_BITS))
+    {
+        return NULL;
+    }
+    return &slot;
+}
+
+World::Archetype& World::Get(unsigned int components)
+{
+    assert(components < ARCHETYPE_COUNT);
+    if(mArchetypes[components] == NULL)
+    {
+        mArchetypes[components] = new Archetype();
+        mArchetypes[components]->components = components;
+    }
+    return *mArchetypes[components];
+}
+
+unsigned int World::AddRow(unsigned int components, unsigned int entity)
+{
+    Archetype& archetype = Get(components);
+    archetype.entities.push_back(entity);
+    if(components & TRANSFORM)
+    {
+        archetype.transforms.push_back(Transform());
+    }
+    if(components & VELOCITY)
+    {
+        archetype.velocities.push_back(Velocity());
+    }
+    if(components & SPRITE)
+    {
+        archetype.sprites.push_back(SpriteRecord());
+    }
+    if(components & ANIMATION)
+    {
+        archetype.playing.push_back(Playing());
+    }
+    return archetype.Count() - 1;
+}
+
+//
+// The archetype's last row moves into the removed one's place, so the
+// arrays stay packed.
+//
+void World::RemoveRow(unsigned int components, unsigned int row)
+{
+    Archetype& archetype = *mArchetypes[components];
+    const unsigned int last = archetype.Count() - 1;
+    assert(row <= last);
+
+    if(row != last)
+    {
+        archetype.entities[row] = archetype.entities[last];
+        mSlots[archetype.entities[row] & INDEX_MASK].row = row;
+        if(components & TRANSFORM)
+        {
+            archetype.transforms[row] = archetype.transforms[last];
+        }
+        if(components & VELOCITY)
+        {
+            archetype.velocities[row] = archetype.velocities[last];
+        }
+        if(components & SPRITE)
+        {
+            archetype.sprites[row] = archetype.sprites[last];
+        }
+        if(components & ANIMATION)
+        {
+            archetype.playing[row] = archetype.playing[last];
+        }
+    }
+
+    archetype.entities.pop_back();
+    if(components & TRANSFORM)
+    {
+        archetype.transforms.pop_back();
+    }
+    if(components & VELOCITY)
+    {
+        archetype.velocities.pop_back();
+    }
+    if(components & SPRITE)
+    {
+        archetype.sprites.pop_back();
+    }
+    if(components & ANIMATION)
+    {
+        archetype.playing.pop_back();
+    }
+}
+
+unsigned int World::Create(unsigned int components)
+{
+    components &= ALL_COMPONENTS;
+
+    unsigned int index = 0;
+    if(!mFree.empty())
+    {
+        index = mFree.back();
+        mFree.pop_back();
+    }
+    else
+    {
+        if(mSlots.size() > INDEX_MASK)
+        {
+            return NONE;
+        }
+        index = mSlots.size();
+        mSlots.push_back(Slot());
+    }
+
+    Slot& slot = mSlots[index];
+    const unsigned int entity = (slot.generation << INDEX_BITS) | index;
+    slot.alive = true;
+    slot.components = components;
+    slot.row = AddRow(components, entity);
+    mCount++;
+    return entity;
+}
+
+void World::Destroy(unsigned int entity)
+{
+    if(Find(entity) == NULL)
+    {
+        return;
+    }
+
+    Slot& slot = mSlots[entity & INDEX_MASK];
+    RemoveRow(slot.components, slot.row);
+    slot.alive = false;
+
+    // Generation 0 is never handed out, so no entity is ever NONE.
+    slot.generation = (slot.generation + 1) & GENERATION_MASK;
+    if(slot.generation == 0)
+    {
+        slot.generation = 1;
+    }
+    mFree.push_back(entity & INDEX_MASK);
+    mCount--;
+}
+
+bool World::IsAlive(unsigned int entity) const
+{
+    return Find(entity) != NULL;
+}
+
+unsigned int World::Components(unsigned int entity) const
+{
+    const Slot* slot = Find(entity);
+    return slot ? slot->components : 0;
+}
+
+void World::SetComponents(unsigned int entity, unsigned int components)
+{
+    components &= ALL_COMPONENTS;
+    if(Find(entity) == NULL || mSlots[entity & INDEX_MASK].components == components)
+    {
+        return;
+    }
+
+    Slot& slot = mSlots[entity & INDEX_MASK];
+    const unsigned int row = AddRow(components, entity);
+
+    // Get may have made the archetype, so both are looked up after it.
+    Archetype& from = *mArchetypes[slot.components];
+    Archetype& to = *mArchetypes[components];
+    const unsigned int kept = slot.components & components;
+    if(kept & TRANSFORM)
+    {
+        to.transforms[row] = from.transforms[slot.row];
+    }
+    if(kept & VELOCITY)
+    {
+        to.velocities[row] = from.velocities[slot.row];
+    }
+    if(kept & SPRITE)
+    {
+        to.sprites[row] = from.sprites[slot.row];
+    }
+    if(kept & ANIMATION)
+    {
+        to.playing[row] = from.playing[slot.row];
+    }
+
+    RemoveRow(slot.components, slot.row);
+    slot.components = components;
+    slot.row = row;
+}
+
+World::Transform* World::GetTransform(unsigned int entity)
+{
+    const Slot* slot = Find(entity);
+    if(slot == NULL || !(slot->components & TRANSFORM))
+    {
+        return NULL;
+    }
+    return &mArchetypes[slot->components]->transforms[slot->row];
+}
+
+World::Velocity* World::GetVelocity(unsigned int entity)
+{
+    const Slot* slot = Find(entity);
+    if(slot == NULL || !(slot->components & VELOCITY))
+    {
+        return NULL;
+    }
+    return &mArchetypes[slot->components]->velocities[slot->row];
+}
+
+SpriteRecord* World::GetSprite(unsigned int entity)
+{
+    const Slot* slot = Find(entity);
+    if(slot == NULL || !(slot->components & SPRITE))
+    {
+        return NULL;
+    }
+    return &mArchetypes[slot->components]->sprites[slot->row];
+}
+
+World::Playing* World::GetPlaying(unsigned int entity)
+{
+    const Slot* slot = Find(entity);
+    if(slot == NULL || !(slot->components & ANIMATION))
+    {
+        return NULL;
+    }
+    return &mArchetypes[slot->components]->playing[slot->row];
+}
+
+unsigned int World::QueryCount(unsigned int query) const
+{
+    unsigned int count = 0;
+    for(unsigned int i = 0; i < ARCHETYPE_COUNT; i++)
+    {
+        if(mArchetypes[i] != NULL && (i & query) == query)
+        {
+            count += mArchetypes[i]->Count();
+        }
+    }
+    return count;
+}
+
+void World::QueryEntities(unsigned int query, std::vector<unsigned int>* out) const
+{
+    assert(out);
+    out->clear();
+    for(unsigned int i = 0; i < ARCHETYPE_COUNT; i++)
+    {
+        if(mArchetypes[i] != NULL && (i & query) == query)
+        {
+            out->insert(out->end(),
+                        mArchetypes[i]->entities.begin(),
+                        mArchetypes[i]->entities.end());
+        }
+    }
+}
+
+void World::Update(double deltaTime)
+{
+    const float dt = (float) deltaTime;
+    for(unsigned int i = 0; i < ARCHETYPE_COUNT; i++)
+    {
+        Archetype* archetype = mArchetypes[i];
+        if(archetype == NULL)
+        {
+            continue;
+        }
+        const unsigned int count = archetype->Count();
+
+        // Movement
+        if((i & (TRANSFORM | VELOCITY)) == (TRANSFORM | VELOCITY))
+        {
+            Transform* transforms = count ? &archetype->transforms[0] : NULL;
+            const Velocity* velocities = count ? &archetype->velocities[0] : NULL;
+            for(unsigned int row = 0; row < count; row++)
+            {
+                transforms[row].x += velocities[row].x * dt;
+                transforms[row].y += velocities[row].y * dt;
+                transforms[row].rotation += velocities[row].spin * dt;
+            }
+        }
+
+        // Animation, the frame's uvs go into the sprite.
+        if((i & (SPRITE | ANIMATION)) == (SPRITE | ANIMATION))
+        {
+            const double clock = Animation::Clock();
+            for(unsigned int row = 0; row < count; row++)
+            {
+                const Playing& playing = archetype->playing[row];
+                if(playing.animation == NULL || playing.animation->FrameCount() == 0)
+                {
+                    continue;
+                }
+
+                bool finished = false;
+                const double time = (clock - playing.start) * playing.speed;
+                const Animation::Frame& frame =
+                    playing.animation->GetFrame(playing.animation->FrameAt(time, &finished));
+                SpriteRecord& sprite = archetype->sprites[row];
+                sprite.topLeftU = (float) frame.topLeftU;
+                sprite.topLeftV = (float) frame.topLeftV;
+                sprite.bottomRightU = (float) frame.bottomRightU;
+                sprite.bottomRightV = (float) frame.bottomRightV;
+            }
+        }
+    }
+}
+
+void World::Draw(GraphicsPipeline* graphics)
+{
+    assert(graphics);
+    for(unsigned int i = 0; i < ARCHETYPE_COUNT; i++)
+    {
+        Archetype* archetype = mArchetypes[i];
+        if(archetype == NULL || !(i & SPRITE) || archetype->Count() == 0)
+        {
+            continue;
+        }
+
+        const unsigned int count = archetype->Count();
+        if(i & TRANSFORM)
+        {
+            for(unsigned int row = 0; row < count; row++)
+            {
+                const Transform& transform = archetype->transforms[row];
+                SpriteRecord& sprite = archetype->sprites[row];
+                sprite.x = transform.x;
+                sprite.y = transform.y;
+                sprite.rotation = transform.rotation;
+                sprite.scaleX = transform.scaleX;
+                sprite.scaleY = transform.scaleY;
+            }
+        }
+        graphics->PushSprites(&archetype->sprites[0], count);
+    }
+}
+
+//
+// Lua binding
+//
+
+// The components named from argument first on.
+static unsigned int CheckComponents(lua_State* state, int first)
+{
+    unsigned int components = 0;
+    const int top = lua_gettop(state);
+    for(int i = first; i <= top; i++)
+    {
+        components |= 1 << luaL_checkoption(state, i, NULL, componentNames);
+    }
+    return components;
+}
+
+//
+// Gets the world and the entity in argument 2. Returns NONE, after
+// raising the error, if either is missing.
+//
+static unsigned int GetEntity(lua_State* state, World** world)
+{
+    *world = LuaState::GetFuncParam<World>(state, 1);
+    if(*world == NULL)
+    {
+        return World::NONE;
+    }
+
+    const unsigned int entity = (unsigned int) luaL_checknumber(state, 2);
+    if(!(*world)->IsAlive(entity))
+    {
+        luaL_argerror(state, 2, "not an entity in this world");
+        return World::NONE;
+    }
+    return entity;
+}
+
+static World::Transform* CheckTransform(lua_State* state)
+{
+    World* world = NULL;
+    const unsigned int entity = GetEntity(state, &world);
+    if(entity == World::NONE)
+    {
+        return NULL;
+    }
+
+    World::Transform* transform = world->GetTransform(entity);
+    if(transform == NULL)
+    {
+        luaL_argerror(state, 2, "entity has no transform");
+    }
+    return transform;
+}
+
+static World::Velocity* CheckVelocity(lua_State* state)
+{
+    World* world = NULL;
+    const unsigned int entity = GetEntity(state, &world);
+    if(entity == World::NONE)
+    {
+        return NULL;
+    }
+
+    World::Velocity* velocity = world->GetVelocity(entity);
+    if(velocity == NULL)
+    {
+        luaL_argerror(state, 2, "entity has no velocity");
+    }
+    return velocity;
+}
+
+static SpriteRecord* CheckSprite(lua_State* state)
+{
+    World* world = NULL;
+    const unsigned int entity = GetEntity(state, &world);
+    if(entity == World::NONE)
+    {
+        return NULL;
+    }
+
+    SpriteRecord* sprite = world->GetSprite(entity);
+    if(sprite == NULL)
+    {
+        luaL_argerror(state, 2, "entity has no sprite");
+    }
+    return sprite;
+}
+
+static int lua_World_Create(lua_State* state)
+{
+    new (lua_newuserdata(state, sizeof(World))) World();
+    luaL_getmetatable(state, "World");
+    lua_setmetatable(state, -2);
+    return 1;
+}
+
+static int lua_World_gc(lua_State* state)
+{
+    World* world = (World*)lua_touserdata(state, 1);
+    assert(world);
+    world->~World();
+    return 0;
+}
+
+static int lua_World_tostring(lua_State* state)
+{
+    lua_pushliteral(state, "World");
+    return 1;
+}
+
+static int lua_World_GetCount(lua_State* state)
+{
+    World* world = LuaState::GetFuncParam<World>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    lua_pushinteger(state, world->Count());
+    return 1;
+}
+
+// world:Spawn("transform", "sprite", ...) returns the new entity
+static int lua_World_Spawn(lua_State* state)
+{
+    World* world = LuaState::GetFuncParam<World>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+
+    const unsigned int entity = world->Create(CheckComponents(state, 2));
+    if(entity == World::NONE)
+    {
+        return luaL_error(state, "World is full.");
+    }
+    lua_pushnumber(state, entity);
+    return 1;
+}
+
+static int lua_World_Destroy(lua_State* state)
+{
+    World* world = LuaState::GetFuncParam<World>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    world->Destroy((unsigned int) luaL_checknumber(state, 2));
+    return 0;
+}
+
+static int lua_World_IsAlive(lua_State* state)
+{
+    World* world = LuaState::GetFuncParam<World>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    lua_pushboolean(state, world->IsAlive((unsigned int) luaL_checknumber(state, 2)));
+    return 1;
+}
+
+// world:AddComponents(entity, "velocity", ...)
+static int lua_World_AddComponents(lua_State* state)
+{
+    World* world = NULL;
+    const unsigned int entity = GetEntity(state, &world);
+    if(entity == World::NONE)
+    {
+        return 0;
+    }
+    world->SetComponents(entity, world->Components(entity) | CheckComponents(state, 3));
+    return 0;
+}
+
+static int lua_World_RemoveComponents(lua_State* state)
+{
+    World* world = NULL;
+    const unsigned int entity = GetEntity(state, &world);
+    if(entity == World::NONE)
+    {
+        return 0;
+    }
+    world->SetComponents(entity, world->Components(entity) & ~CheckComponents(state, 3));
+    return 0;
+}
+
+// world:HasComponents(entity, "sprite", ...) true if it has all of them
+static int lua_World_HasComponents(lua_State* state)
+{
+    World* world = NULL;
+    const unsigned int entity = GetEntity(state, &world);
+    if(entity == World::NONE)
+    {
+        return 0;
+    }
+    const unsigned int components = CheckComponents(state, 3);
+    lua_pushboolean(state, (world->Components(entity) & components) == components);
+    return 1;
+}
+
+static int lua_World_SetPosition(lua_State* state)
+{
+    World::Transform* transform = CheckTransform(state);
+    if(transform == NULL)
+    {
+        return 0;
+    }
+    transform->x = (float) luaL_checknumber(state, 3);
+    transform->y = (float) luaL_checknumber(state, 4);
+    return 0;
+}
+
+// world:GetPosition(entity) returns x, y
+static int lua_World_GetPosition(lua_State* state)
+{
+    World::Transform* transform = CheckTransform(state);
+    if(transform == NULL)
+    {
+        return 0;
+    }
+    lua_pushnumber(state, transform->x);
+    lua_pushnumber(state, transform->y);
+    return 2;
+}
+
+static int lua_World_SetRotation(lua_State* state)
+{
+    World::Transform* transform = CheckTransform(state);
+    if(transform == NULL)
+    {
+        return 0;
+    }
+    transform->rotation = (float) luaL_checknumber(state, 3);
+    return 0;
+}
+
+// world:SetScale(entity, x, [y])
+static int lua_World_SetScale(lua_State* state)
+{
+    World::Transform* transform = CheckTransform(state);
+    if(transform == NULL)
+    {
+        return 0;
+    }
+    transform->scaleX = (float) luaL_checknumber(state, 3);
+    transform->scaleY = (float) luaL_optnumber(state, 4, transform->scaleX);
+    return 0;
+}
+
+// world:SetVelocity(entity, x, y, [spin])
+static int lua_World_SetVelocity(lua_State* state)
+{
+    World::Velocity* velocity = CheckVelocity(state);
+    if(velocity == NULL)
+    {
+        return 0;
+    }
+    velocity->x = (float) luaL_checknumber(state, 3);
+    velocity->y = (float) luaL_checknumber(state, 4);
+    velocity->spin = (float) luaL_optnumber(state, 5, velocity->spin);
+    return 0;
+}
+
+// world:GetVelocity(entity) returns x, y, spin
+static int lua_World_GetVelocity(lua_State* state)
+{
+    World::Velocity* velocity = CheckVelocity(state);
+    if(velocity == NULL)
+    {
+        return 0;
+    }
+    lua_pushnumber(state, velocity->x);
+    lua_pushnumber(state, velocity->y);
+    lua_pushnumber(state, velocity->spin);
+    return 3;
+}
+
+static int lua_World_SetTexture(lua_State* state)
+{
+    SpriteRecord* sprite = CheckSprite(state);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+
+    TextureHandle* texture = Texture::GetFuncParamHandle(state, 3);
+    if(texture == NULL)
+    {
+        return 0;
+    }
+    sprite->texture = *texture;
+    return 0;
+}
+
+static int lua_World_SetColor(lua_State* state)
+{
+    SpriteRecord* sprite = CheckSprite(state);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+
+    Vector* colour = LuaState::GetFuncParam<Vector>(state, 3);
+    if(colour == NULL)
+    {
+        return 0;
+    }
+    sprite->colour[0] = (float) colour->x;
+    sprite->colour[1] = (float) colour->y;
+    sprite->colour[2] = (float) colour->z;
+    sprite->colour[3] = (float) colour->w;
+    return 0;
+}
+
+static int lua_World_SetUVs(lua_State* state)
+{
+    SpriteRecord* sprite = CheckSprite(state);
+    if(sprite == NULL)
+    {
+        return 0;
+    }
+
+    sprite->topLeftU = (float) luaL_checknumber(state, 3);
+    sprite->topLeftV = (float) luaL_checknumber(state, 4);
+    sprite->bottomRightU = (float) luaL_checknumber(state, 5);
+    sprite->bottomRightV = (float) luaL_checknumber(state, 6);
+    return 0;
+}
+
+//
+// world:SetAnimation(entity, name, [speed]) plays the animation from its
+// first frame, nil stops it. The entity needs an animation component.
+//
+static int lua_World_SetAnimation(lua_State* state)
+{
+    World* world = NULL;
+    const unsigned int entity = GetEntity(state, &world);
+    if(entity == World::NONE)
+    {
+        return 0;
+    }
+
+    World::Playing* playing = world->GetPlaying(entity);
+    if(playing == NULL)
+    {
+        return luaL_argerror(state, 2, "entity has no animation");
+    }
+
+    if(lua_isnoneornil(state, 3))
+    {
+        *playing = World::Playing();
+        return 0;
+    }
+
+    const char* name = luaL_checkstring(state, 3);
+    const Animation* animation = Dinodeck::GetInstance()->GetAnimations()->Find(name);
+    if(animation == NULL)
+    {
+        return luaL_error(state, "No animation [%s].", name);
+    }
+    playing->animation = animation;
+    playing->start = Animation::Clock();
+    playing->speed = (float) luaL_optnumber(state, 4, 1);
+    return 0;
+}
+
+// world:Query("transform", "velocity", ...) returns a query for Read,
+// Write and Entities, matching entities with at least those components.
+static int lua_World_Query(lua_State* state)
+{
+    World* world = LuaState::GetFuncParam<World>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    lua_pushinteger(state, CheckComponents(state, 2));
+    return 1;
+}
+
+// What Read and Write move between a query's entities and a VectorArray.
+enum eField
+{
+    FIELD_POSITION, // x, y
+    FIELD_ROTATION, // x
+    FIELD_SCALE,    // x, y
+    FIELD_VELOCITY, // x, y, spin
+    FIELD_COLOUR    // r, g, b, a
+};
+static const char* fieldNames[] = { "position", "rotation", "scale", "velocity", "colour", NULL };
+static const unsigned int fieldComponents[] =
+{
+    World::TRANSFORM,
+    World::TRANSFORM,
+    World::TRANSFORM,
+    World::VELOCITY,
+    World::SPRITE
+};
+
+// Reads the query and field in arguments 2 and 3, false after raising
+// the error if the query doesn't have the field's component.
+static bool CheckField(lua_State* state, unsigned int* query, eField* field)
+{
+    *query = (unsigned int) luaL_checkinteger(state, 2) & World::ALL_COMPONENTS;
+    *field = (eField) luaL_checkoption(state, 3, NULL, fieldNames);
+    if(!(*query & fieldComponents[*field]))
+    {
+        luaL_argerror(state, 3, "the query doesn't have the field's component");
+        return false;
+    }
+    return true;
+}
+
+//
+// world:Read(query, field, vectorArray) resizes the array to the query's
+// entities and fills it with their field, returning how many.
+//
+static int lua_World_Read(lua_State* state)
+{
+    World* world = LuaState::GetFuncParam<World>(state, 1);
+    unsigned int query = 0;
+    eField field = FIELD_POSITION;
+    if(world == NULL || !CheckField(state, &query, &field))
+    {
+        return 0;
+    }
+
+    VectorArray* array = LuaState::GetFuncParam<VectorArray>(state, 4);
+    if(array == NULL)
+    {
+        return 0;
+    }
+
+    array->Resize(world->QueryCount(query));
+    unsigned int index = 0;
+    for(unsigned int i = 0; i < World::ARCHETYPE_COUNT; i++)
+    {
+        World::Archetype* archetype = world->GetArchetype(i);
+        if(archetype == NULL || (i & query) != query)
+        {
+            continue;
+        }
+
+        for(unsigned int row = 0; row < archetype->Count(); row++, index++)
+        {
+            switch(field)
+            {
+            case FIELD_POSITION:
+                array->Set(index, archetype->transforms[row].x, archetype->transforms[row].y, 0, 0);
+                break;
+            case FIELD_ROTATION:
+                array->Set(index, archetype->transforms[row].rotation, 0, 0, 0);
+                break;
+            case FIELD_SCALE:
+                array->Set(index, archetype->transforms[row].scaleX, archetype->transforms[row].scaleY, 0, 0);
+                break;
+            case FIELD_VELOCITY:
+            {
+                const World::Velocity& velocity = archetype->velocities[row];
+                array->Set(index, velocity.x, velocity.y, velocity.spin, 0);
+                break;
+            }
+            case FIELD_COLOUR:
+            {
+                const float* colour = archetype->sprites[row].colour;
+                array->Set(index, colour[0], colour[1], colour[2], colour[3]);
+                break;
+            }
+            }
+        }
+    }
+    lua_pushinteger(state, index);
+    return 1;
+}
+
+//
+// world:Write(query, field, vectorArray) sets the field of the query's
+// entities, in Read's order, for as many as the array has.
+//
+static int lua_World_Write(lua_State* state)
+{
+    World* world = LuaState::GetFuncParam<World>(state, 1);
+    unsigned int query = 0;
+    eField field = FIELD_POSITION;
+    if(world == NULL || !CheckField(state, &query, &field))
+    {
+        return 0;
+    }
+
+    VectorArray* array = LuaState::GetFuncParam<VectorArray>(state, 4);
+    if(array == NULL)
+    {
+        return 0;
+    }
+
+    unsigned int index = 0;
+    for(unsigned int i = 0; i < World::ARCHETYPE_COUNT && index < array->Count(); i++)
+    {
+        World::Archetype* archetype = world->GetArchetype(i);
+        if(archetype == NULL || (i & query) != query)
+        {
+            continue;
+        }
+
+        const unsigned int count = std::min(archetype->Count(), array->Count() - index);
+        for(unsigned int row = 0; row < count; row++, index++)
+        {
+            switch(field)
+            {
+            case FIELD_POSITION:
+                archetype->transforms[row].x = array->X(index);
+                archetype->transforms[row].y = array->Y(index);
+                break;
+            case FIELD_ROTATION:
+                archetype->transforms[row].rotation = array->X(index);
+                break;
+            case FIELD_SCALE:
+                archetype->transforms[row].scaleX = array->X(index);
+                archetype->transforms[row].scaleY = array->Y(index);
+                break;
+            case FIELD_VELOCITY:
+                archetype->velocities[row].x = array->X(index);
+                archetype->velocities[row].y = array->Y(index);
+                archetype->velocities[row].spin = array->Z(index);
+                break;
+            case FIELD_COLOUR:
+            {
+                float* colour = archetype->sprites[row].colour;
+                colour[0] = array->X(index);
+                colour[1] = array->Y(index);
+                colour[2] = array->Z(index);
+                colour[3] = array->W(index);
+                break;
+            }
+            }
+        }
+    }
+    return 0;
+}
+
+// world:Entities(query, [table]) returns the query's entities in Read's
+// order, in the table if one's given.
+static int lua_World_Entities(lua_State* state)
+{
+    World* world = LuaState::GetFuncParam<World>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+
+    const unsigned int query = (unsigned int) luaL_checkinteger(state, 2) & World::ALL_COMPONENTS;
+    std::vector<unsigned int> entities;
+    world->QueryEntities(query, &entities);
+
+    if(lua_istable(state, 3))
+    {
+        lua_pushvalue(state, 3);
+    }
+    else
+    {
+        lua_createtable(state, entities.size(), 0);
+    }
+
+    for(unsigned int i = 0; i < entities.size(); i++)
+    {
+        lua_pushnumber(state, entities[i]);
+        lua_rawseti(state, -2, i + 1);
+    }
+
+    // Trims a reused table that held more.
+    const int length = (int) lua_objlen(state, -1);
+    for(int i = entities.size() + 1; i <= length; i++)
+    {
+        lua_pushnil(state);
+        lua_rawseti(state, -2, i);
+    }
+    return 1;
+}
+
+static int lua_World_Update(lua_State* state)
+{
+    World* world = LuaState::GetFuncParam<World>(state, 1);
+    if(world == NULL)
+    {
+        return 0;
+    }
+    world->Update(luaL_checknumber(state, 2));
+    return 0;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Create", lua_World_Create},
+  {"__gc", lua_World_gc},
+  {"__tostring", lua_World_tostring},
+  {"GetCount", lua_World_GetCount},
+  {"Spawn", lua_World_Spawn},
+  {"Destroy", lua_World_Destroy},
+  {"IsAlive", lua_World_IsAlive},
+  {"AddComponents", lua_World_AddComponents},
+  {"RemoveComponents", lua_World_RemoveComponents},
+  {"HasComponents", lua_World_HasComponents},
+  {"SetPosition", lua_World_SetPosition},
+  {"GetPosition", lua_World_GetPosition},
+  {"SetRotation", lua_World_SetRotation},
+  {"SetScale", lua_World_SetScale},
+  {"SetVelocity", lua_World_SetVelocity},
+  {"GetVelocity", lua_World_GetVelocity},
+  {"SetTexture", lua_World_SetTexture},
+  {"SetColor", lua_World_SetColor},
+  {"SetUVs", lua_World_SetUVs},
+  {"SetAnimation", lua_World_SetAnimation},
+  {"Query", lua_World_Query},
+  {"Read", lua_World_Read},
+  {"Write", lua_World_Write},
+  {"Entities", lua_World_Entities},
+  {"Update", lua_World_Update},
+  {NULL, NULL}  /* sentinel */
+};
+
+void World::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        World::Meta.Name(),
+        luaBinding
+    );
+}
\ No newline at end of file
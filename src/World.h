@@ -0,0 +1,144 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <vector>
+
+#include "reflect/Reflect.h"
+#include "SpriteRecord.h"
+
+class Animation;
+class GraphicsPipeline;
+class LuaState;
+
+//
+// Entities kept as packed component arrays, one set of arrays for each
+// combination of components an entity can have, so the built in systems
+// walk contiguous memory rather than Lua tables of userdata.
+//
+// Movement and animation run in Update, drawing in Draw, all natively.
+// Scripts read and write a query's components in bulk through
+// VectorArrays, matching entities are visited in the same order until an
+// entity is made, removed or has its components changed.
+//
+// Entities are numbers, an index and a generation, so one kept after it's
+// destroyed is never mistaken for the entity that reuses its index.
+//
+class World
+{
+    public: static Reflect Meta;
+    public:
+        enum eComponent
+        {
+            TRANSFORM = 1 << 0,
+            VELOCITY = 1 << 1,
+            SPRITE = 1 << 2,
+            ANIMATION = 1 << 3,
+            COMPONENT_COUNT = 4,
+            ALL_COMPONENTS = (1 << COMPONENT_COUNT) - 1
+        };
+
+        struct Transform
+        {
+            float x;
+            float y;
+            float rotation; // degrees
+            float scaleX;
+            float scaleY;
+            Transform() : x(0), y(0), rotation(0), scaleX(1), scaleY(1) {}
+        };
+
+        struct Velocity
+        {
+            float x;
+            float y;
+            float spin; // degrees a second
+            Velocity() : x(0), y(0), spin(0) {}
+        };
+
+        // Picks the sprite's frame in Update, the sprite itself draws as
+        // an unanimated one.
+        struct Playing
+        {
+            const Animation* animation;
+            double start; // Animation's clock
+            float speed;
+            Playing() : animation(NULL), start(0), speed(1) {}
+        };
+
+        static const unsigned int NONE = 0;
+
+        static void Bind(LuaState* state);
+
+        World();
+        ~World();
+
+        unsigned int Create(unsigned int components);
+        void Destroy(unsigned int entity);
+        bool IsAlive(unsigned int entity) const;
+        unsigned int Count() const { return mCount; }
+        unsigned int Components(unsigned int entity) const;
+        // Moves the entity's components to the arrays for the new set.
+        // Ones it already had are kept, new ones get their defaults.
+        void SetComponents(unsigned int entity, unsigned int components);
+
+        // NULL if the entity doesn't have the component.
+        Transform* GetTransform(unsigned int entity);
+        Velocity* GetVelocity(unsigned int entity);
+        SpriteRecord* GetSprite(unsigned int entity);
+        Playing* GetPlaying(unsigned int entity);
+
+        // Entities with at least the query's components.
+        unsigned int QueryCount(unsigned int query) const;
+        void QueryEntities(unsigned int query, std::vector<unsigned int>* out) const;
+
+        void Update(double deltaTime);
+        // Sprites are drawn at their transform, archetype by archetype.
+        // Within one they're in the order they were made, but a removed
+        // entity's place is taken by the archetype's last.
+        void Draw(GraphicsPipeline* graphics);
+
+        // The packed arrays for one set of components. Arrays of
+        // components not in the set stay empty.
+        struct Archetype
+        {
+            unsigned int components;
+            std::vector<unsigned int> entities;
+            std::vector<Transform> transforms;
+            std::vector<Velocity> velocities;
+            std::vector<SpriteRecord> sprites;
+            std::vector<Playing> playing;
+
+            unsigned int Count() const { return entities.size(); }
+        };
+        static const unsigned int ARCHETYPE_COUNT = ALL_COMPONENTS + 1;
+        // NULL if nothing's been made with the set.
+        Archetype* GetArchetype(unsigned int components) { return mArchetypes[components]; }
+    private:
+        static const unsigned int INDEX_BITS = 20;
+        static const unsigned int INDEX_MASK = (1 << INDEX_BITS) - 1;
+        static const unsigned int GENERATION_MASK = (1 << (32 - INDEX_BITS)) - 1;
+
+        struct Slot
+        {
+            unsigned int generation;
+            unsigned int components;
+            unsigned int row;
+            bool alive;
+            Slot() : generation(1), components(0), row(0), alive(false) {}
+        };
+
+        Archetype* mArchetypes[ARCHETYPE_COUNT];
+        std::vector<Slot> mSlots;
+        std::vector<unsigned int> mFree;
+        unsigned int mCount;
+
+        World(const World&);
+        World& operator=(const World&);
+
+        const Slot* Find(unsigned int entity) const;
+        Archetype& Get(unsigned int components);
+        unsigned int AddRow(unsigned int components, unsigned int entity);
+        void RemoveRow(unsigned int components, unsigned int row);
+};
+
+#endif
\ No newline at end of file
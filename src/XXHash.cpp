@@ -0,0 +1,82 @@
+#include "XXHash.h"
+
+#include <string.h>
+
+static const unsigned int PRIME1 = 2654435761u;
+static const unsigned int PRIME2 = 2246822519u;
+static const unsigned int PRIME3 = 3266489917u;
+static const unsigned int PRIME4 = 668265263u;
+static const unsigned int PRIME5 = 374761393u;
+
+static inline unsigned int Rotl(unsigned int value, int bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// Unaligned, little endian like every platform we ship on.
+static inline unsigned int Read32(const unsigned char* p)
+{
+    unsigned int value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline unsigned int Round(unsigned int acc, unsigned int input)
+{
+    acc += input * PRIME2;
+    acc = Rotl(acc, 13);
+    return acc * PRIME1;
+}
+
+unsigned int XXHash::Hash32(const void* data, unsigned int size, unsigned int seed)
+{
+    const unsigned char* p = (const unsigned char*) data;
+    const unsigned char* const end = p + size;
+    unsigned int hash;
+
+    if(size >= 16)
+    {
+        // Four lanes so the multiplies can overlap.
+        const unsigned char* const limit = end - 16;
+        unsigned int v1 = seed + PRIME1 + PRIME2;
+        unsigned int v2 = seed + PRIME2;
+        unsigned int v3 = seed;
+        unsigned int v4 = seed - PRIME1;
+
+        do
+        {
+            v1 = Round(v1, Read32(p));
+            v2 = Round(v2, Read32(p + 4));
+            v3 = Round(v3, Read32(p + 8));
+            v4 = Round(v4, Read32(p + 12));
+            p += 16;
+        } while(p <= limit);
+
+        hash = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+    }
+    else
+    {
+        hash = seed + PRIME5;
+    }
+
+    hash += size;
+
+    for(; p + 4 <= end; p += 4)
+    {
+        hash += Read32(p) * PRIME3;
+        hash = Rotl(hash, 17) * PRIME4;
+    }
+
+    for(; p < end; p++)
+    {
+        hash += (*p) * PRIME5;
+        hash = Rotl(hash, 11) * PRIME1;
+    }
+
+    hash ^= hash >> 15;
+    hash *= PRIME2;
+    hash ^= hash >> 13;
+    hash *= PRIME3;
+    hash ^= hash >> 16;
+    return hash;
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#ifndef XXHASH_H
+#define XXHASH_H
+
+//
+// 32 bit xxHash. Fast enough to hash whole asset files on reload, and
+// the same value as the reference XXH32 so hashes can be checked with
+// other tools.
+//
+class XXHash
+{
+public:
+    static unsigned int Hash32(const void* data, unsigned int size, unsigned int seed = 0);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "Zones.h"
+
+#include <deque>
+#include <map>
+#include <string.h>
+#include <string>
+
+#include "DinodeckLua.h"
+#include "LuaState.h"
+#include "Threading.h"
+#include "XXHash.h"
+
+Reflect Zones::Meta("Profile", Zones::Bind);
+const char* Zones::mNames[MAX_ZONES];
+volatile unsigned int Zones::mZoneCount = 0;
+unsigned long long Zones::mFrame[MAX_ZONES];
+unsigned long long Zones::mLastFrame[MAX_ZONES];
+
+static Mutex& ZonesMutex()
+{
+    static Mutex mutex;
+    return mutex;
+}
+
+unsigned int Zones::Register(const char* name)
+{
+    ScopedLock lock(ZonesMutex());
+
+    // The same name in two places shares a zone.
+    for(unsigned int i = 0; i < mZoneCount; i++)
+    {
+        if(strcmp(mNames[i], name) == 0)
+        {
+            return i;
+        }
+    }
+
+    if(mZoneCount == MAX_ZONES)
+    {
+        return MAX_ZONES;
+    }
+
+    mNames[mZoneCount] = name;
+    __sync_synchronize(); // the name is written before it's counted
+    mZoneCount = mZoneCount + 1;
+    return mZoneCount - 1;
+}
+
+//
+// Script zones. Names are interned by hash so a Begin costs a hash and a
+// lookup, and the copies outlive the strings Lua passed in.
+//
+struct ScriptZone
+{
+    unsigned int zone;
+    const char* name;
+    unsigned long long start;
+};
+
+struct InternedName
+{
+    std::string name;
+    unsigned int zone;
+};
+
+static const unsigned int MAX_SCRIPT_DEPTH = 32;
+static ScriptZone gScriptZones[MAX_SCRIPT_DEPTH];
+static unsigned int gScriptDepth = 0;
+static std::deque<InternedName> gInterned; // deque so the names don't move
+static std::map<unsigned int, unsigned int> gInternedByHash;
+
+static const InternedName& Intern(const char* name, size_t length)
+{
+    const unsigned int hash = XXHash::Hash32(name, (unsigned int) length);
+    std::map<unsigned int, unsigned int>::iterator it = gInternedByHash.find(hash);
+    if(it != gInternedByHash.end() && gInterned[it->second].name == name)
+    {
+        return gInterned[it->second];
+    }
+
+    // A collision, or new.
+    for(unsigned int i = 0; i < gInterned.size(); i++)
+    {
+        if(gInterned[i].name == name)
+        {
+            return gInterned[i];
+        }
+    }
+
+    InternedName interned;
+    interned.name.assign(name, length);
+    gInterned.push_back(interned);
+    InternedName& added = gInterned.back();
+    added.zone = Zones::Register(added.name.c_str());
+    gInternedByHash[hash] = gInterned.size() - 1;
+    return added;
+}
+
+// Profile.Begin(name)
+static int lua_Begin(lua_State* state)
+{
+    size_t length = 0;
+    const char* name = luaL_checklstring(state, 1, &length);
+#if DINODECK_PROFILE
+    if(gScriptDepth == MAX_SCRIPT_DEPTH)
+    {
+        return luaL_error(state, "Profile zones nested deeper than %d.",
+                          (int) MAX_SCRIPT_DEPTH);
+    }
+
+    const InternedName& interned = Intern(name, length);
+    ScriptZone& zone = gScriptZones[gScriptDepth++];
+    zone.zone = interned.zone;
+    zone.name = interned.name.c_str();
+    zone.start = DDTime::Microseconds();
+#else
+    (void) name;
+#endif
+    return 0;
+}
+
+// Profile.End() closes the last zone begun
+static int lua_End(lua_State* state)
+{
+#if DINODECK_PROFILE
+    if(gScriptDepth == 0)
+    {
+        return luaL_error(state, "Profile.End called without a Profile.Begin.");
+    }
+
+    const ScriptZone& zone = gScriptZones[--gScriptDepth];
+    const unsigned long long end = DDTime::Microseconds();
+    Zones::Add(zone.zone, end - zone.start);
+    Trace::Record(zone.name, zone.start, end);
+#endif
+    return 0;
+}
+
+// Profile.Zone(name, function) calls the function inside a zone and
+// returns what it returns
+static int lua_Zone(lua_State* state)
+{
+    luaL_checkstring(state, 1);
+    luaL_checktype(state, 2, LUA_TFUNCTION);
+
+    lua_settop(state, 2);
+    lua_Begin(state);
+
+    // Not protected, so errors keep their traceback. The zone's dropped
+    // at the end of the frame.
+    lua_pushvalue(state, 2);
+    lua_call(state, 0, LUA_MULTRET);
+    lua_End(state);
+    return lua_gettop(state) - 2;
+}
+
+static const struct luaL_reg luaBinding [] = {
+  {"Begin", lua_Begin},
+  {"End", lua_End},
+  {"Zone", lua_Zone},
+  {NULL, NULL}  /* sentinel */
+};
+
+void Zones::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        Zones::Meta.Name(),
+        luaBinding
+    );
+}
+
+void Zones::EndFrame()
+{
+    gScriptDepth = 0;
+
+    const unsigned int count = mZoneCount;
+    memcpy(mLastFrame, mFrame, count * sizeof(mFrame[0]));
+    memset(mFrame, 0, count * sizeof(mFrame[0]));
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef ZONES_H
+#define ZONES_H
+
+#include "DDTime.h"
+#include "reflect/Reflect.h"
+#include "Trace.h"
+
+class LuaState;
+
+// Release builds pass -DDINODECK_PROFILE=0 and every zone compiles away.
+#ifndef DINODECK_PROFILE
+#define DINODECK_PROFILE 1
+#endif
+
+//
+// Named timers over the engine's hot paths. A zone is timed from where
+// it's declared to the end of its scope:
+//
+//    void GraphicsPipeline::Flush(eFlushReason reason)
+//    {
+//        DD_PROFILE_ZONE("Flush");
+//        ...
+//
+// Main thread zones are summed over the frame for the frame hud and
+// /metrics, and go to the main trace ring during a capture, so all three
+// show the same numbers. Other threads give the ring they trace into,
+// DD_PROFILE_ZONE_ON(ring, "decode"), and are only seen in captures.
+//
+// Scripts mark their own with Profile.Begin(name) and Profile.End(), or
+// Profile.Zone(name, fn), and share the table with the engine's.
+//
+// ProfileZone is different, it charges engine time to the Lua stack
+// that called it and only while the script profiler runs.
+//
+class Zones
+{
+    public: static Reflect Meta;
+public:
+    static void Bind(LuaState* state);
+    static const unsigned int MAX_ZONES = 64;
+
+    // Once per zone, the first time it's entered. Names must outlive the
+    // program, string literals. Returns MAX_ZONES once the table is full.
+    static unsigned int Register(const char* name);
+    static void Add(unsigned int zone, unsigned long long microseconds)
+    {
+        if(zone < MAX_ZONES)
+        {
+            mFrame[zone] += microseconds;
+        }
+    }
+
+    // Main thread, once a frame before any zones are entered.
+    // Script zones still open, left by an error, are dropped.
+    static void EndFrame();
+    static unsigned int ZoneCount() { return mZoneCount; }
+    static const char* ZoneName(unsigned int zone) { return mNames[zone]; }
+    // Summed over the frame EndFrame was last called for.
+    static double LastFrameMs(unsigned int zone) { return mLastFrame[zone] / 1000.0; }
+private:
+    static const char* mNames[MAX_ZONES];
+    static volatile unsigned int mZoneCount;
+    static unsigned long long mFrame[MAX_ZONES];
+    static unsigned long long mLastFrame[MAX_ZONES];
+};
+
+class ZoneTimer
+{
+    unsigned int mZone;
+    const char* mName;
+    Trace::Ring* mRing; // NULL for the main thread
+    unsigned long long mStart;
+public:
+    ZoneTimer(unsigned int zone, const char* name, Trace::Ring* ring) :
+        mZone(zone), mName(name), mRing(ring), mStart(DDTime::Microseconds()) {}
+    ~ZoneTimer()
+    {
+        const unsigned long long end = DDTime::Microseconds();
+        if(mRing == NULL)
+        {
+            Zones::Add(mZone, end - mStart);
+            Trace::Record(mName, mStart, end);
+        }
+        else
+        {
+            Trace::Record(mRing, mName, mStart, end);
+        }
+    }
+};
+
+#define DD_PROFILE_JOIN_(a, b) a##b
+#define DD_PROFILE_JOIN(a, b) DD_PROFILE_JOIN_(a, b)
+
+#if DINODECK_PROFILE
+#define DD_PROFILE_ZONE(name) \
+    static const unsigned int DD_PROFILE_JOIN(ddZoneId, __LINE__) = Zones::Register(name); \
+    ZoneTimer DD_PROFILE_JOIN(ddZoneTimer, __LINE__)(DD_PROFILE_JOIN(ddZoneId, __LINE__), name, NULL)
+#define DD_PROFILE_ZONE_ON(ring, name) \
+    ZoneTimer DD_PROFILE_JOIN(ddZoneTimer, __LINE__)(Zones::MAX_ZONES, name, ring)
+#else
+#define DD_PROFILE_ZONE(name)
+#define DD_PROFILE_ZONE_ON(ring, name)
+#endif
+
+#endif
\ No newline at end of file
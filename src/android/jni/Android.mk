@@ -15,8 +15,8 @@ include $(CLEAR_VARS)
 LOCAL_MODULE := FTGLES
 #LOCAL_CFLAGS := -I$(LOCAL_PATH)/../freetype/include
 
-LOCAL_C_INCLUDES := $(LOCAL_PATH)/ftgles/src \
-$(LOCAL_PATH)/ftgles/src/iGLU-1.0.0/include
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../../lib/ftgles/src \
+$(LOCAL_PATH)/../../../lib/ftgles/src/iGLU-1.0.0/include
 
 LOCAL_SRC_FILES := \
 ../../../lib/ftgles/src/FTBuffer.cpp \
@@ -66,7 +66,7 @@ LOCAL_SRC_FILES := \
 LOCAL_CFLAGS += -DGL_GLEXT_PROTOTYPES -DFTGL_LIBRARY_STATIC
 LOCAL_LDLIBS := -ldl -lGLESv1_CM -lGLESv2 -llog
 LOCAL_EXPORT_C_INCLUDES := $(LOCAL_PATH)/freetype
-LOCAL_EXPORT_C_INCLUDES += $(LOCAL_PATH)/ftgles/src
+LOCAL_EXPORT_C_INCLUDES += $(LOCAL_PATH)/../../../lib/ftgles/src
 
 LOCAL_STATIC_LIBRARIES := freetype
 
@@ -94,45 +94,124 @@ include $(CLEAR_VARS)
 LOCAL_MODULE    := godpatterns
 LOCAL_STATIC_LIBRARIES := lua soil FTGLES
 LOCAL_CFLAGS    := -Werror -DFTGL_LIBRARY_STATIC
+ifeq ($(APP_OPTIM),release)
+LOCAL_CFLAGS    += -DDINODECK_PROFILE=0 -DDD_LOG_LEVEL=1
+endif
 LOCAL_SRC_FILES := \
     DDLog_Android.cpp \
     ../../reflect/Field.cpp \
     ../../reflect/Reflect.cpp \
     ../../GraphicsPipeline.cpp \
+    ../../VertexStream.cpp \
+    ../../World.cpp \
+    ../../Mesh.cpp \
+    ../../QuadIndexBuffer.cpp \
+    ../../ByteBuffer.cpp \
+    ../../BytecodeCache.cpp \
+    ../../LuaAllocator.cpp \
+    ../../Scheduler.cpp \
+    ../../Profiler.cpp \
+    ../../HotReload.cpp \
+    ../../LogRing.cpp \
     ../../LuaState.cpp \
     ../../Game.cpp \
     ../../input/Button.cpp \
     ../../input/Touch.cpp \
     ../../input/Mouse.cpp \
     ../../input/Keyboard.cpp \
+    ../../input/Gamepad.cpp \
     ../../Vector.cpp \
+    ../../VectorArray.cpp \
     ../../Matrix.cpp \
     ../../Sprite.cpp \
+    ../../SpriteBatch.cpp \
+    ../../Scene.cpp \
+    ../../SpatialGrid.cpp \
+    ../../PhysicsWorld.cpp \
+    ../../PathGrid.cpp \
+    ../../Tween.cpp \
+    ../../Animation.cpp \
+    ../../util/Json.cpp \
+    ../../util/Lerp.cpp \
     ../../System.cpp \
+    ../../DrawCapture.cpp \
     ../../Renderer.cpp \
     ../../SaveGame.cpp \
     ../../Texture.cpp \
     ../../TextureManager.cpp \
+    ../../TextureAtlas.cpp \
+    ../../TextLayoutCache.cpp \
+    ../../GLStateCache.cpp \
+    ../../StaticLayer.cpp \
+    ../../Tilemap.cpp \
+    ../../ParticleEmitter.cpp \
+    ../../CommandList.cpp \
+    ../../ShaderProgram.cpp \
+    ../../RenderTarget.cpp \
+    ../../GPUTimer.cpp \
+    ../../CompressedImage.cpp \
+    ../../ImageDecoder.cpp \
+    ../../SplashScreen.cpp \
+    ../../JitMonitor.cpp \
+    ../../TextureLoader.cpp \
+    ../../TextureStreamer.cpp \
+    ../../LuaFFI.cpp \
     ../../Http.cpp \
     ../../HttpPostData.cpp \
+    ../../HttpBody.cpp \
+    ../../HttpClient.cpp \
+    ../../HttpBatcher.cpp \
+    ../../SaveWriter.cpp \
+    ../../TableCodec.cpp \
+    ../../DDPack.cpp \
     ../../DDTime.cpp \
     DDAudio_Android.cpp \
+    OpenSLAudio.cpp \
+    ../../audio/WaveDecoder.cpp \
     ../../DDRestful_Common.cpp \
     DDRestful_Android.cpp \
     ../../Sound.cpp \
     ../../SoundStream.cpp \
     ../../Asset.cpp \
     ../../AssetStore.cpp \
+    ../../NameTable.cpp \
+    ../../XXHash.cpp \
+    ../../AssetReport.cpp \
+    ../../FileWatcher.cpp \
     ../../ManifestAssetStore.cpp \
     ../../Dinodeck.cpp \
+    ../../FrameHud.cpp \
+    ../../FrameCapture.cpp \
+    ../../OverdrawMap.cpp \
+    ../../DynamicResolution.cpp \
+    ../../IOScheduler.cpp \
+    ../../JobSystem.cpp \
+    ../../ScriptJobs.cpp \
+    ../../ScriptMessage.cpp \
+    ../../Metrics.cpp \
+    ../../Trace.cpp \
+    ../../TextRun.cpp \
+    ../../BakedFont.cpp \
+    ../../Font.cpp \
+    ../../SpriteRecord.cpp \
+    ../../FrameArena.cpp \
+    ../../Zones.cpp \
+    ../../MemoryStats.cpp \
+    ../../StartupTimer.cpp \
+    ../../PathCache.cpp \
+    ../../PushedFiles.cpp \
+    ../../RemoteAssets.cpp \
     ../../FormatText.cpp \
     AndroidWrapper.cpp \
     DDFile_Android.cpp \
+    AndroidAssets.cpp \
+    MappedFile_Android.cpp \
     godpatterns_android.cpp \
     DDLuaCallbacks.cpp \
     ../../ScoreLoop/ScoreLoop.cpp \
+    ../../ScoreLoop/ScoreCache.cpp \
 
 
-LOCAL_LDLIBS    := -llog -lGLESv1_CM
+LOCAL_LDLIBS    := -llog -ldl -lGLESv1_CM -lOpenSLES -lz
 
 include $(BUILD_SHARED_LIBRARY)
\ No newline at end of file
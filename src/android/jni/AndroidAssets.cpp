@@ -0,0 +1,97 @@
+#include "AndroidAssets.h"
+
+#include <assert.h>
+#include <dlfcn.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "../../DDLog.h"
+
+// From android/asset_manager.h and asset_manager_jni.h
+struct AAssetManager;
+struct AAsset;
+static const int AASSET_MODE_BUFFER = 3;
+
+typedef AAssetManager* (*FromJavaFunc)(JNIEnv*, jobject);
+typedef AAsset* (*OpenFunc)(AAssetManager*, const char*, int);
+typedef const void* (*GetBufferFunc)(AAsset*);
+typedef off_t (*GetLengthFunc)(AAsset*);
+typedef void (*CloseFunc)(AAsset*);
+
+static jobject JavaAssetManager = NULL;
+static AAssetManager* AssetManager = NULL;
+static OpenFunc AssetOpen = NULL;
+static GetBufferFunc AssetGetBuffer = NULL;
+static GetLengthFunc AssetGetLength = NULL;
+static CloseFunc AssetClose = NULL;
+
+bool AndroidAssets::Init(JNIEnv* env, jobject assetManager)
+{
+    void* library = dlopen("libandroid.so", RTLD_NOW);
+    if(library == NULL)
+    {
+        dsprintf("No libandroid, assets will be read through Java.\n");
+        return false;
+    }
+
+    FromJavaFunc fromJava = (FromJavaFunc) dlsym(library, "AAssetManager_fromJava");
+    AssetOpen = (OpenFunc) dlsym(library, "AAssetManager_open");
+    AssetGetBuffer = (GetBufferFunc) dlsym(library, "AAsset_getBuffer");
+    AssetGetLength = (GetLengthFunc) dlsym(library, "AAsset_getLength");
+    AssetClose = (CloseFunc) dlsym(library, "AAsset_close");
+
+    if(fromJava == NULL || AssetOpen == NULL || AssetGetBuffer == NULL
+       || AssetGetLength == NULL || AssetClose == NULL || assetManager == NULL)
+    {
+        dsprintf("No AAssetManager, assets will be read through Java.\n");
+        return false;
+    }
+
+    // The native manager is only good while the Java one is alive.
+    JavaAssetManager = env->NewGlobalRef(assetManager);
+    AssetManager = fromJava(env, JavaAssetManager);
+    return AssetManager != NULL;
+}
+
+bool AndroidAssets::IsAvailable()
+{
+    return AssetManager != NULL;
+}
+
+void* AndroidAssets::Open(const char* name, const char** outData, unsigned int* outSize)
+{
+    assert(name);
+    assert(outData);
+    assert(outSize);
+
+    if(AssetManager == NULL)
+    {
+        return NULL;
+    }
+
+    AAsset* asset = AssetOpen(AssetManager, name, AASSET_MODE_BUFFER);
+    if(asset == NULL)
+    {
+        return NULL;
+    }
+
+    const void* data = AssetGetBuffer(asset);
+    if(data == NULL)
+    {
+        dsprintf("Failed to get the buffer of asset [%s].\n", name);
+        AssetClose(asset);
+        return NULL;
+    }
+
+    *outData = (const char*) data;
+    *outSize = (unsigned int) AssetGetLength(asset);
+    return asset;
+}
+
+void AndroidAssets::Close(void* asset)
+{
+    if(asset != NULL)
+    {
+        AssetClose((AAsset*) asset);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef ANDROIDASSETS_H
+#define ANDROIDASSETS_H
+
+#include <jni.h>
+
+//
+// Reads assets straight out of the APK with AAssetManager, no calls into
+// Java. AAssetManager needs API 9 and we still support 2.2, so libandroid
+// is opened at runtime. Without it IsAvailable is false and assets are
+// read through Java as before.
+//
+class AndroidAssets
+{
+public:
+    // Call from a thread Java started, the asset manager is held until exit.
+    static bool Init(JNIEnv* env, jobject assetManager);
+    static bool IsAvailable();
+
+    // The whole asset as one buffer. Uncompressed entries point into the
+    // mapped APK, compressed ones are inflated once. The data lasts until
+    // the returned asset is closed. NULL if there's no such asset.
+    static void* Open(const char* name, const char** outData, unsigned int* outSize);
+    static void Close(void* asset);
+};
+
+#endif
\ No newline at end of file
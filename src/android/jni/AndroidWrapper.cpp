@@ -1,6 +1,7 @@
 #include "AndroidWrapper.h"
 
 #include <assert.h>
+#include <pthread.h>
 #include <stdint.h>
 #include "../../DDLog.h"
 #include "../../HttpPostData.h"
@@ -11,684 +12,434 @@ const char* AndroidWrapper::DDActivityPath = "com/godpatterns/dinodeck/DDActivit
 const char* AndroidWrapper::DDAudioPath = "com/godpatterns/dinodeck/DDAudio";
 const char* AndroidWrapper::DDScoreLoopPath = "com/godpatterns/dinodeck/DDScoreLoop";
 
-AndroidWrapper::AndroidWrapper(JavaVM* jVM) :
+AndroidWrapper::AndroidWrapper(JavaVM* jVM, JNIEnv* env) :
     mJavaVM(jVM)
-{}
-
-void AndroidWrapper::Exit()
 {
-    JNIEnv *env;
-    bool isAttached = false;
+    // FindClass only sees the game's classes from a thread Java started,
+    // so everything is looked up here, once.
+    mActivityClass = FindClass(env, DDActivityPath);
+    mAudioClass = FindClass(env, DDAudioPath);
+    mScoreLoopClass = FindClass(env, DDScoreLoopPath);
+
+    mExit = FindMethod(env, mActivityClass, "exit", "()V");
+    mOpenAsset = FindMethod(env, mActivityClass, "open_asset", "(Ljava/lang/String;)Z");
+    mDoesAssetExist = FindMethod(env, mActivityClass, "does_asset_exist", "(Ljava/lang/String;)Z");
+    mWriteSaveData = FindMethod(env, mActivityClass, "write_save_data", "(Ljava/lang/String;[B)Z");
+    mReadSaveData = FindMethod(env, mActivityClass, "read_save_data", "(Ljava/lang/String;)[B");
+    mLoadSound = FindMethod(env, mAudioClass, "load_sound", "(Ljava/lang/String;)I");
+    mPlaySound = FindMethod(env, mAudioClass, "play_sound", "(IZ)I");
+    mStopSound = FindMethod(env, mAudioClass, "stop_sound", "(I)V");
+    mPlayStream = FindMethod(env, mAudioClass, "play_stream", "(Ljava/lang/String;Z)I");
+    mStopStream = FindMethod(env, mAudioClass, "stop_stream", "(I)V");
+    mSetStreamVolume = FindMethod(env, mAudioClass, "set_stream_volume", "(IF)V");
+    mPauseStream = FindMethod(env, mAudioClass, "pause_stream", "(I)V");
+    mResumeStream = FindMethod(env, mAudioClass, "resume_stream", "(I)V");
+    mSetSoundVolume = FindMethod(env, mAudioClass, "set_sound_volume", "(IF)V");
+    mSoundPause = FindMethod(env, mAudioClass, "sound_pause", "(I)V");
+    mSoundResume = FindMethod(env, mAudioClass, "sound_resume", "(I)V");
+    mStartHttpPost = FindMethod(env, mActivityClass, "start_http_post", "(Ljava/lang/String;I)V");
+    mFinishHttpPost = FindMethod(env, mActivityClass, "finish_http_post", "()V");
+    mAddHttpPostData = FindMethod(env, mActivityClass, "add_http_post_data", "(Ljava/lang/String;Ljava/lang/String;)V");
+    mScoreLoopInit = FindMethod(env, mScoreLoopClass, "init", "(Ljava/lang/String;)V");
+    mScoreLoopGetTosState = FindMethod(env, mScoreLoopClass, "get_tos_state", "()Ljava/lang/String;");
+    mScoreLoopIsInitialized = FindMethod(env, mScoreLoopClass, "is_initialized", "()Z");
+    mScoreLoopShowTos = FindMethod(env, mScoreLoopClass, "show_tos", "()V");
+    mScoreLoopPushScore = FindMethod(env, mScoreLoopClass, "push_score", "(DDII)V");
+    mScoreLoopGetLeaderboard = FindMethod(env, mScoreLoopClass, "get_leaderboard", "(II)V");
+}
 
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+jclass AndroidWrapper::FindClass(JNIEnv* env, const char* path)
+{
+    jclass local = env->FindClass(path);
+    if(local == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return /*false*/;
-        }
-        isAttached = true;
+        dsprintf("ERROR: Couldn't find java class [%s]\n", path);
+        env->ExceptionClear();
+        return NULL;
     }
-    assert(env);
 
-    jclass ddActivityClass = env->FindClass(DDActivityPath);
-    jmethodID java_Exit = env->GetStaticMethodID
-    (
-        ddActivityClass,
-        "exit",
-        "()V"
-    );
+    jclass global = (jclass) env->NewGlobalRef(local);
+    env->DeleteLocalRef(local);
+    return global;
+}
 
-    env->CallStaticVoidMethod
-    (
-        ddActivityClass,
-        java_Exit
-    );
+jmethodID AndroidWrapper::FindMethod(JNIEnv* env,
+                                     jclass javaClass,
+                                     const char* name,
+                                     const char* signature)
+{
+    if(javaClass == NULL)
+    {
+        return NULL;
+    }
 
-    if(isAttached)
+    jmethodID method = env->GetStaticMethodID(javaClass, name, signature);
+    if(method == NULL)
     {
-        mJavaVM->DetachCurrentThread();
+        dsprintf("ERROR: Couldn't find java method [%s %s]\n", name, signature);
+        env->ExceptionClear();
     }
+    return method;
 }
 
-bool AndroidWrapper::OpenAsset(const char* name)
+static pthread_key_t AttachedThreadKey;
+static pthread_once_t AttachedThreadKeyOnce = PTHREAD_ONCE_INIT;
+
+static void DetachThread(void* javaVM)
+{
+    ((JavaVM*) javaVM)->DetachCurrentThread();
+}
+
+static void CreateAttachedThreadKey()
 {
-    JNIEnv *env;
-    bool isAttached = false;
+    pthread_key_create(&AttachedThreadKey, DetachThread);
+}
 
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+//
+// Threads Java doesn't know about are attached the first time they call
+// in and stay attached until they exit, rather than paying for an attach
+// and detach on every call. Anything that makes local references on them
+// has to delete them, they're never freed otherwise.
+//
+JNIEnv* AndroidWrapper::GetEnv()
+{
+    JNIEnv* env = NULL;
+    if(mJavaVM->GetEnv((void**)&env, JniVersion) == JNI_OK)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return false;
-        }
-        isAttached = true;
+        return env;
     }
-    assert(env);
 
-    jclass ddActivityClass = env->FindClass(DDActivityPath);
-    jstring jStrPath = env->NewStringUTF(name);
+    if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
+    {
+        return NULL;
+    }
 
-    jmethodID java_OpenAsset = env->GetStaticMethodID
+    pthread_once(&AttachedThreadKeyOnce, CreateAttachedThreadKey);
+    pthread_setspecific(AttachedThreadKey, mJavaVM);
+    return env;
+}
+
+void AndroidWrapper::Exit()
+{
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
+    {
+        return;
+    }
+
+    env->CallStaticVoidMethod
     (
-        ddActivityClass,
-        "open_asset",
-        "(Ljava/lang/String;)Z"
+        mActivityClass,
+        mExit
     );
+}
+
+bool AndroidWrapper::OpenAsset(const char* name)
+{
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
+    {
+        return false;
+    }
+
+    jstring jStrPath = env->NewStringUTF(name);
 
     bool result = env->CallStaticBooleanMethod
     (
-        ddActivityClass,
-        java_OpenAsset,
+        mActivityClass,
+        mOpenAsset,
         jStrPath
     );
     env->DeleteLocalRef(jStrPath);
-
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
-
     return result;
 }
 
 bool AndroidWrapper::DoesAssetExist(const char* name)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return false;
-        }
-        isAttached = true;
+        return false;
     }
-    assert(env);
 
-    jclass ddActivityClass = env->FindClass(DDActivityPath);
     jstring jStrPath = env->NewStringUTF(name);
 
-    jmethodID java_DoesAssetExist = env->GetStaticMethodID
-    (
-        ddActivityClass,
-        "does_asset_exist",
-        "(Ljava/lang/String;)Z"
-    );
-
     bool result = env->CallStaticBooleanMethod
     (
-        ddActivityClass,
-        java_DoesAssetExist,
+        mActivityClass,
+        mDoesAssetExist,
         jStrPath
     );
     env->DeleteLocalRef(jStrPath);
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
-
     return result;
 }
 
-void AndroidWrapper::WriteSaveData(const char* name, const char* data)
+bool AndroidWrapper::WriteSaveData(const char* name, const char* data, unsigned int size)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return /*false*/;
-        }
-        isAttached = true;
+        return false;
     }
-    assert(env);
-
-    jclass ddActivityClass = env->FindClass(DDActivityPath);
-
-    jmethodID java_WriteSaveData = env->GetStaticMethodID
-    (
-        ddActivityClass,
-        "write_save_data",
-        "(Ljava/lang/String;Ljava/lang/String;)V"
-    );
 
     jstring jStrPath = env->NewStringUTF(name);
-    jstring jStrData = env->NewStringUTF(data);
-    env->CallStaticVoidMethod
+    jbyteArray jData = env->NewByteArray(size);
+    if(jData == NULL)
+    {
+        env->ExceptionClear();
+        env->DeleteLocalRef(jStrPath);
+        return false;
+    }
+    env->SetByteArrayRegion(jData, 0, size, (const jbyte*) data);
+
+    bool written = env->CallStaticBooleanMethod
     (
-        ddActivityClass,
-        java_WriteSaveData,
+        mActivityClass,
+        mWriteSaveData,
         jStrPath,
-        jStrData
+        jData
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
+    env->DeleteLocalRef(jStrPath);
+    env->DeleteLocalRef(jData);
+    return written;
 }
 
 void AndroidWrapper::ReadSaveData(const char* name, std::string& data)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return /*false*/;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddActivityClass = env->FindClass(DDActivityPath);
-
-    jmethodID java_ReadSaveData = env->GetStaticMethodID
-    (
-        ddActivityClass,
-        "read_save_data",
-        "(Ljava/lang/String;)Ljava/lang/String;"
-    );
 
     jstring jStrPath = env->NewStringUTF(name);
-    jstring jStrData = (jstring) env->CallStaticObjectMethod
+    jbyteArray jData = (jbyteArray) env->CallStaticObjectMethod
     (
-        ddActivityClass,
-        java_ReadSaveData,
+        mActivityClass,
+        mReadSaveData,
         jStrPath
     );
 
-    const char* result = env->GetStringUTFChars(jStrData, 0);
-    data.assign(result);
-
-    dsprintf("Data: [%s]", result);
-
-    env->ReleaseStringUTFChars(jStrData, result);
-
-    if(isAttached)
+    data.clear();
+    if(jData != NULL)
     {
-        mJavaVM->DetachCurrentThread();
+        const jsize size = env->GetArrayLength(jData);
+        if(size > 0)
+        {
+            data.resize(size);
+            env->GetByteArrayRegion(jData, 0, size, (jbyte*) &data[0]);
+        }
+        env->DeleteLocalRef(jData);
     }
+
+    dsprintf("Read save [%s], %u bytes.\n", name, (unsigned int) data.size());
+    env->DeleteLocalRef(jStrPath);
 }
 
 int AndroidWrapper::LoadSound(const char* path)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return -1;
-        }
-        isAttached = true;
+        return -1;
     }
-    assert(env);
-
-    jclass ddAudioClass = env->FindClass(DDAudioPath);
-
-    jmethodID java_LoadSound = env->GetStaticMethodID
-    (
-        ddAudioClass,
-        "load_sound",
-        "(Ljava/lang/String;)I"
-    );
 
     jstring jStrPath = env->NewStringUTF(path);
     int result = env->CallStaticIntMethod
     (
-        ddAudioClass,
-        java_LoadSound,
+        mAudioClass,
+        mLoadSound,
         jStrPath
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
+    env->DeleteLocalRef(jStrPath);
     return result;
 }
 
 int AndroidWrapper::PlaySound(int id, bool loop)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return -1;
-        }
-        isAttached = true;
+        return -1;
     }
-    assert(env);
-
-    jclass ddAudioClass = env->FindClass(DDAudioPath);
-
-    jmethodID java_PlaySound = env->GetStaticMethodID
-    (
-        ddAudioClass,
-        "play_sound",
-        "(IZ)I"
-    );
 
     int result = env->CallStaticIntMethod
     (
-        ddAudioClass,
-        java_PlaySound,
+        mAudioClass,
+        mPlaySound,
         id,
         loop
     );
-
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
     return result;
 }
 
 void AndroidWrapper::StopSound(int id)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddAudioClass = env->FindClass(DDAudioPath);
-
-    jmethodID java_StopSound = env->GetStaticMethodID
-    (
-        ddAudioClass,
-        "stop_sound",
-        "(I)V"
-    );
 
     env->CallStaticVoidMethod
     (
-        ddAudioClass,
-        java_StopSound,
+        mAudioClass,
+        mStopSound,
         id
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
 }
 
 int AndroidWrapper::PlayStream(const char* path, bool loop)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return false;
-        }
-        isAttached = true;
+        return false;
     }
-    assert(env);
-
-    jclass ddAudioClass = env->FindClass(DDAudioPath);
-
-    jmethodID java_PlayStream = env->GetStaticMethodID
-    (
-        ddAudioClass,
-        "play_stream",
-        "(Ljava/lang/String;Z)I"
-    );
 
     jstring jStrPath = env->NewStringUTF(path);
     int result = env->CallStaticIntMethod
     (
-        ddAudioClass,
-        java_PlayStream,
+        mAudioClass,
+        mPlayStream,
         jStrPath,
         loop
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
+    env->DeleteLocalRef(jStrPath);
     return result;
 }
 
 void AndroidWrapper::StopStream(int id)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddAudioClass = env->FindClass(DDAudioPath);
-
-    jmethodID java_StopStream = env->GetStaticMethodID
-    (
-        ddAudioClass,
-        "stop_stream",
-        "(I)V"
-    );
 
     env->CallStaticVoidMethod
     (
-        ddAudioClass,
-        java_StopStream,
+        mAudioClass,
+        mStopStream,
         id
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
 }
 
 void AndroidWrapper::SetStreamVolume(int id, float volume)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddAudioClass = env->FindClass(DDAudioPath);
-
-    jmethodID java_SetStreamVolume = env->GetStaticMethodID
-    (
-        ddAudioClass,
-        "set_stream_volume",
-        "(IF)V"
-    );
 
     env->CallStaticVoidMethod
     (
-        ddAudioClass,
-        java_SetStreamVolume,
+        mAudioClass,
+        mSetStreamVolume,
         id,
         volume
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
 }
 
 void AndroidWrapper::PauseStream(int id)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddAudioClass = env->FindClass(DDAudioPath);
-
-    jmethodID java_PauseStream = env->GetStaticMethodID
-    (
-        ddAudioClass,
-        "pause_stream",
-        "(I)V"
-    );
 
     env->CallStaticVoidMethod
     (
-        ddAudioClass,
-        java_PauseStream,
+        mAudioClass,
+        mPauseStream,
         id
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
 }
 
 void AndroidWrapper::ResumeStream(int id)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddAudioClass = env->FindClass(DDAudioPath);
-
-    jmethodID java_ResumeStream = env->GetStaticMethodID
-    (
-        ddAudioClass,
-        "resume_stream",
-        "(I)V"
-    );
 
     env->CallStaticVoidMethod
     (
-        ddAudioClass,
-        java_ResumeStream,
+        mAudioClass,
+        mResumeStream,
         id
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
 }
 
 void AndroidWrapper::SetSoundVolume(int id, float volume)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddAudioClass = env->FindClass(DDAudioPath);
-
-    jmethodID java_SetSoundVolume = env->GetStaticMethodID
-    (
-        ddAudioClass,
-        "set_sound_volume",
-        "(IF)V"
-    );
 
     env->CallStaticVoidMethod
     (
-        ddAudioClass,
-        java_SetSoundVolume,
+        mAudioClass,
+        mSetSoundVolume,
         id,
         volume
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
 }
 
 void AndroidWrapper::PauseSound(int id)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddAudioClass = env->FindClass(DDAudioPath);
-
-    jmethodID java_SoundPause = env->GetStaticMethodID
-    (
-        ddAudioClass,
-        "sound_pause",
-        "(I)V"
-    );
 
     env->CallStaticVoidMethod
     (
-        ddAudioClass,
-        java_SoundPause,
+        mAudioClass,
+        mSoundPause,
         id
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
 }
 
 void AndroidWrapper::ResumeSound(int id)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddAudioClass = env->FindClass(DDAudioPath);
-
-    jmethodID java_SoundResume = env->GetStaticMethodID
-    (
-        ddAudioClass,
-        "sound_resume",
-        "(I)V"
-    );
 
     env->CallStaticVoidMethod
     (
-        ddAudioClass,
-        java_SoundResume,
+        mAudioClass,
+        mSoundResume,
         id
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
 }
 
 void AndroidWrapper::HttpPost(const char* uri,
                               HttpPostData* postData,
                               int callbackId)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    dsprintf("Finding http post java functions.\n");
-
-    jclass ddActivityClass = env->FindClass(DDActivityPath);
-    jmethodID java_StartHttpPost = env->GetStaticMethodID
-    (
-        ddActivityClass,
-        "start_http_post",
-        "(Ljava/lang/String;I)V"
-    );
-
-    jmethodID java_FinishHttpPost = env->GetStaticMethodID
-    (
-        ddActivityClass,
-        "finish_http_post",
-        "()V"
-    );
-
-    jmethodID java_AddHttpPostData = env->GetStaticMethodID
-    (
-        ddActivityClass,
-        "add_http_post_data",
-        "(Ljava/lang/String;Ljava/lang/String;)V"
-    );
-
-    dsprintf("Found the functions [%s] [%s] [%s].\n",
-             java_StartHttpPost != NULL? "true":"false",
-             java_FinishHttpPost != NULL? "true":"false",
-             java_AddHttpPostData != NULL? "true":"false");
-
 
     dsprintf("Before call start. Callback id: %d\n", callbackId);
     // Start post (uri, success, failure)
     jstring jStrURI = env->NewStringUTF(uri);
     env->CallStaticVoidMethod
     (
-        ddActivityClass,
-        java_StartHttpPost,
+        mActivityClass,
+        mStartHttpPost,
         jStrURI,
         callbackId
     );
@@ -700,6 +451,11 @@ void AndroidWrapper::HttpPost(const char* uri,
     // Send all data
     if(NULL != postData)
     {
+        if(!postData->GetParts().empty())
+        {
+            dsprintf("File and buffer parts aren't posted on Android yet, only values.\n");
+        }
+
         for(std::map<std::string, std::string>::iterator
             iter = postData->mValueMap.begin();
             iter != postData->mValueMap.end();
@@ -710,8 +466,8 @@ void AndroidWrapper::HttpPost(const char* uri,
 
             env->CallStaticVoidMethod
             (
-                ddActivityClass,
-                java_AddHttpPostData,
+                mActivityClass,
+                mAddHttpPostData,
                 jStrKey,
                 jStrValue
             );
@@ -726,88 +482,46 @@ void AndroidWrapper::HttpPost(const char* uri,
     dsprintf("Before finish.\n");
     env->CallStaticVoidMethod
     (
-        ddActivityClass,
-        java_FinishHttpPost
+        mActivityClass,
+        mFinishHttpPost
     );
     dsprintf("After finish.\n");
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
 }
 
 void AndroidWrapper::ScoreLoopInit(const char* key)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return /*false*/;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddScoreLoopClass = env->FindClass(DDScoreLoopPath);
-
-    jmethodID java_Init = env->GetStaticMethodID
-    (
-        ddScoreLoopClass,
-        "init",
-        "(Ljava/lang/String;)V"
-    );
 
     jstring jStrKey = env->NewStringUTF(key);
 
     env->CallStaticVoidMethod
     (
-        ddScoreLoopClass,
-        java_Init,
+        mScoreLoopClass,
+        mScoreLoopInit,
         jStrKey
     );
 
     env->DeleteLocalRef(jStrKey);
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
 }
 
 std::string AndroidWrapper::ScoreLoopTOSState()
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return "";
-        }
-        isAttached = true;
+        return "";
     }
-    assert(env);
-
-    jclass ddScoreLoopClass = env->FindClass(DDScoreLoopPath);
-
-    jmethodID java_get_tos_state = env->GetStaticMethodID
-    (
-        ddScoreLoopClass,
-        "get_tos_state",
-        "()Ljava/lang/String;"
-    );
 
     dsprintf("Before calling function\n");
 
     jstring jStrData = (jstring) env->CallStaticObjectMethod
     (
-        ddScoreLoopClass,
-        java_get_tos_state
+        mScoreLoopClass,
+        mScoreLoopGetTosState
     );
 
     dsprintf("Before getting result\n");
@@ -820,161 +534,74 @@ std::string AndroidWrapper::ScoreLoopTOSState()
     dsprintf("TOS State:[%s]\n", result);
 
     env->ReleaseStringUTFChars(jStrData, result);
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
-
+    env->DeleteLocalRef(jStrData);
     return output;
 }
 
 bool AndroidWrapper::ScoreLoopIsInitialized()
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return false;
-        }
-        isAttached = true;
+        return false;
     }
-    assert(env);
-
-    jclass ddScoreLoopClass = env->FindClass(DDScoreLoopPath);
-    jmethodID java_is_initialized = env->GetStaticMethodID
-    (
-        ddScoreLoopClass,
-        "is_initialized",
-        "()Z"
-    );
 
     bool result = env->CallStaticBooleanMethod
     (
-        ddScoreLoopClass,
-        java_is_initialized
+        mScoreLoopClass,
+        mScoreLoopIsInitialized
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
-
     return result;
 }
 
 void AndroidWrapper::ScoreLoopShowTOS()
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return /*false*/;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddScoreLoopClass = env->FindClass(DDScoreLoopPath);
-    jmethodID java_show_tos = env->GetStaticMethodID
-    (
-        ddScoreLoopClass,
-        "show_tos",
-        "()V"
-    );
 
     env->CallStaticVoidMethod
     (
-        ddScoreLoopClass,
-        java_show_tos
+        mScoreLoopClass,
+        mScoreLoopShowTos
     );
-
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
-
 }
 
 void AndroidWrapper::ScoreLoopPushScore(double primary, double secondary,
-                                        int callbackId)
+                                        int mode, int callbackId)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return /*false*/;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddScoreLoopClass = env->FindClass(DDScoreLoopPath);
-    jmethodID java_push_score = env->GetStaticMethodID
-    (
-        ddScoreLoopClass,
-        "push_score",
-        "(DDI)V"
-    );
 
     env->CallStaticVoidMethod
     (
-        ddScoreLoopClass,
-        java_push_score,
+        mScoreLoopClass,
+        mScoreLoopPushScore,
         primary,
         secondary,
+        mode,
         callbackId
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
 }
 
 void AndroidWrapper::ScoreLoopGetLeaderboard(int type, int callbackId)
 {
-    JNIEnv *env;
-    bool isAttached = false;
-
-    if(mJavaVM->GetEnv((void**)&env, JniVersion) < 0)
+    JNIEnv* env = GetEnv();
+    if(env == NULL)
     {
-        if(mJavaVM->AttachCurrentThread(&env, NULL) < 0)
-        {
-            return /*false*/;
-        }
-        isAttached = true;
+        return;
     }
-    assert(env);
-
-    jclass ddScoreLoopClass = env->FindClass(DDScoreLoopPath);
-    jmethodID java_get_leaderboard = env->GetStaticMethodID
-    (
-        ddScoreLoopClass,
-        "get_leaderboard",
-        "(II)V"
-    );
 
     env->CallStaticVoidMethod
     (
-        ddScoreLoopClass,
-        java_get_leaderboard,
+        mScoreLoopClass,
+        mScoreLoopGetLeaderboard,
         type,
         callbackId
     );
-
-    if(isAttached)
-    {
-        mJavaVM->DetachCurrentThread();
-    }
 }
\ No newline at end of file
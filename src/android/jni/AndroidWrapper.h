@@ -20,15 +20,53 @@ private:
     static const char* DDAudioPath;
     static const char* DDScoreLoopPath;
     JavaVM* mJavaVM;
+    // Global references, resolved once when the wrapper is made.
+    jclass mActivityClass;
+    jclass mAudioClass;
+    jclass mScoreLoopClass;
+    jmethodID mExit;
+    jmethodID mOpenAsset;
+    jmethodID mDoesAssetExist;
+    jmethodID mWriteSaveData;
+    jmethodID mReadSaveData;
+    jmethodID mStartHttpPost;
+    jmethodID mFinishHttpPost;
+    jmethodID mAddHttpPostData;
+    jmethodID mLoadSound;
+    jmethodID mPlaySound;
+    jmethodID mStopSound;
+    jmethodID mPlayStream;
+    jmethodID mStopStream;
+    jmethodID mSetStreamVolume;
+    jmethodID mPauseStream;
+    jmethodID mResumeStream;
+    jmethodID mSetSoundVolume;
+    jmethodID mSoundPause;
+    jmethodID mSoundResume;
+    jmethodID mScoreLoopInit;
+    jmethodID mScoreLoopGetTosState;
+    jmethodID mScoreLoopIsInitialized;
+    jmethodID mScoreLoopShowTos;
+    jmethodID mScoreLoopPushScore;
+    jmethodID mScoreLoopGetLeaderboard;
+
+    static jclass FindClass(JNIEnv* env, const char* path);
+    static jmethodID FindMethod(JNIEnv* env,
+                                jclass javaClass,
+                                const char* name,
+                                const char* signature);
+    // The calling thread's env, attaching it if Java didn't start it.
+    JNIEnv* GetEnv();
 public:
-    static void CreateInstance(JavaVM* jVM)
+    // Call from a thread Java started, the classes are looked up here.
+    static void CreateInstance(JavaVM* jVM, JNIEnv* env)
     {
         // Never deleted.
-        AndroidWrapper::Instance = new AndroidWrapper(jVM);
+        AndroidWrapper::Instance = new AndroidWrapper(jVM, env);
     };
     static AndroidWrapper* GetInstance() { return AndroidWrapper::Instance; }
 
-    AndroidWrapper(JavaVM* jVM);
+    AndroidWrapper(JavaVM* jVM, JNIEnv* env);
 
 
 
@@ -36,7 +74,7 @@ public:
     void Exit();
     bool OpenAsset(const char* name);
     bool DoesAssetExist(const char* name);
-    void WriteSaveData(const char* name, const char* data);
+    bool WriteSaveData(const char* name, const char* data, unsigned int size);
     void ReadSaveData(const char* name, std::string& data);
     int LoadSound(const char* path);
 
@@ -63,7 +101,7 @@ public:
     std::string ScoreLoopTOSState();
     bool ScoreLoopIsInitialized();
     void ScoreLoopShowTOS();
-    void ScoreLoopPushScore(double primary, double secondary, int callbackId);
+    void ScoreLoopPushScore(double primary, double secondary, int mode, int callbackId);
     void ScoreLoopGetLeaderboard(int type, int callbackId);
 };
 
@@ -3,17 +3,33 @@
 #include <assert.h>
 
 #include "../../Asset.h"
+#include "../../DDFile.h"
 #include "../../DDLog.h"
+#include "../../Zones.h"
 #include "AndroidWrapper.h"
+#include "OpenSLAudio.h"
 
-DDAudio::DDAudio()
-{
+// Sounds play through OpenSL ES when the device has it, otherwise they go
+// through SoundPool on the Java side. Streams always use MediaPlayer.
+static OpenSLAudio* NativeAudio = NULL;
 
+DDAudio::DDAudio() :
+    mShareBuffers(true),
+    mSoundBudget(0)
+{
+    NativeAudio = new OpenSLAudio();
+    if(!NativeAudio->Init())
+    {
+        dsprintf("OpenSL ES unavailable, sounds will use SoundPool.\n");
+        delete NativeAudio;
+        NativeAudio = NULL;
+    }
 }
 
 DDAudio::~DDAudio()
 {
-
+    delete NativeAudio;
+    NativeAudio = NULL;
 }
 
 void DDAudio::Reset()
@@ -21,19 +37,114 @@ void DDAudio::Reset()
     // Does nothing at the moment
 }
 
-int DDAudio::Play(const char* name, bool loop)
+void DDAudio::Update()
 {
-    dsprintf("Being asked to play [%s] Loop: [%s]", name, loop? "true" : "false");
-    AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
+    // SoundPool manages its own voices
+    if(NativeAudio != NULL)
+    {
+        NativeAudio->Update();
+    }
+}
 
+// Buses and output latency aren't implemented on Android yet.
+void DDAudio::SetBusVolume(const char* bus, float volume)
+{
+}
+
+float DDAudio::GetBusVolume(const char* bus)
+{
+    return 1;
+}
+
+void DDAudio::Duck(const char* bus, float volume, float seconds)
+{
+}
+
+void DDAudio::SetOutputRefresh(int refresh)
+{
+}
+
+void DDAudio::SetConversion(bool outputRate, int channels, bool cubic)
+{
+}
+
+float DDAudio::GetOutputLatency()
+{
+    return -1;
+}
+
+// SoundPool only has left and right volumes, positions aren't done yet.
+void DDAudio::SetPosition(int id, float x, float y)
+{
+}
+
+void DDAudio::SetListener(float x, float y)
+{
+}
+
+void DDAudio::SetDistances(float reference, float max)
+{
+}
+
+unsigned int DDAudio::VoiceSerial(int id)
+{
+    return 0;
+}
+
+// SoundPool doesn't report when a sound starts, so there's nothing to
+// measure yet.
+void DDAudio::GetStats(Stats* out)
+{
+    assert(out);
+    *out = Stats();
+}
+
+void DDAudio::ResetStats()
+{
+}
+
+// OpenSL ES and SoundPool sounds are their decoded PCM, they're all kept.
+unsigned int DDAudio::ReleaseCaches()
+{
+    return 0;
+}
+
+// Every sound is loaded with the manifest here, there's nothing to start.
+bool DDAudio::Preload(const char* name)
+{
+    return FindSound(name) != -1;
+}
+
+int DDAudio::Play(const char* name, bool loop)
+{
+    DD_LOG_DEBUG("Being asked to play [%s] Loop: [%s]", name, loop? "true" : "false");
     // Use name to get id
-    int soundId = GetSound(name);
+    return PlayLoaded(GetSound(name), NameTable::Find(name), loop);
+}
 
+int DDAudio::Play(int handle, bool loop)
+{
+    int* sound = mSounds.Get((unsigned int) handle);
+    return PlayLoaded(sound ? *sound : -1, (unsigned int) handle, loop);
+}
+
+// SoundPool steals voices itself and the OpenSL ES path drops the play
+// when its voices are all busy, the manifest's sound policies are desktop
+// only.
+int DDAudio::PlayLoaded(int soundId, unsigned int handle, bool loop)
+{
+    DD_PROFILE_ZONE("AudioPlay");
     if(soundId == -1)
     {
         return -1;
     }
 
+    if(NativeAudio != NULL)
+    {
+        return NativeAudio->Play(soundId, loop);
+    }
+
+    AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
     int output = wrapper->PlaySound(soundId, loop);
     return output;
 }
@@ -41,6 +152,11 @@ int DDAudio::Play(const char* name, bool loop)
 void DDAudio::Stop(int id)
 {
     dsprintf("Stop sound id [%d]", id);
+    if(NativeAudio != NULL)
+    {
+        NativeAudio->Stop(id);
+        return;
+    }
     AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
     wrapper->StopSound(id);
     return;
@@ -48,25 +164,40 @@ void DDAudio::Stop(int id)
 
 void DDAudio::Pause(int id)
 {
+    if(NativeAudio != NULL)
+    {
+        NativeAudio->Pause(id);
+        return;
+    }
     AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
     wrapper->PauseSound(id);
 }
 
 void DDAudio::Resume(int id)
 {
+    if(NativeAudio != NULL)
+    {
+        NativeAudio->Resume(id);
+        return;
+    }
     AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
     wrapper->ResumeSound(id);
 }
 
 void DDAudio::SetVolume(int id, float volume)
 {
+    if(NativeAudio != NULL)
+    {
+        NativeAudio->SetVolume(id, volume);
+        return;
+    }
     AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
     wrapper->SetSoundVolume(id, volume);
 }
 
 int DDAudio::PlayStream(const char* name, bool loop)
 {
-    dsprintf("Being asked to play [%s] Loop: [%s]", name, loop? "true" : "false");
+    DD_LOG_DEBUG("Being asked to play [%s] Loop: [%s]", name, loop? "true" : "false");
     AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
 
     Asset* asset = GetStream(name);
@@ -77,9 +208,25 @@ int DDAudio::PlayStream(const char* name, bool loop)
     return streamId;
 }
 
+//
+// MediaPlayer streams are started and stopped from Java, which has no
+// queue or fades yet. A cross fade is a cut.
+//
+bool DDAudio::QueueStream(int id, const char* name, bool loop)
+{
+    dsprintf("Queued streams aren't supported on Android, [%s] not queued.", name);
+    return false;
+}
+
+int DDAudio::CrossFadeStream(int id, const char* name, float seconds, bool loop)
+{
+    StopStream(id);
+    return PlayStream(name, loop);
+}
+
 void DDAudio::StopStream(int id)
 {
-    dsprintf("Being asked to stop stream [%d]", id);
+    DD_LOG_DEBUG("Being asked to stop stream [%d]", id);
     AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
     wrapper->StopStream(id);
 }
@@ -109,32 +256,36 @@ bool DDAudio::OnAssetReload(Asset& asset)
     // On Android absoluely notning is done to cleverly reload
     // sound files. They'll just keep getting shoved in memory!
     //
-    if(asset.Type() == Asset::Sound)
+    if(asset.Type() == Asset::Sound && NativeAudio != NULL)
+    {
+        const char* name = asset.Name().c_str();
+        DDFile file(asset.Path().c_str());
+        if(!file.LoadFileIntoBuffer())
+        {
+            dsprintf("ERROR: Couldn't read sound [%s]\n", name);
+            return false;
+        }
+
+        int* previous = mSounds.Find(name);
+        int soundId = NativeAudio->Load(name,
+                                        file.Buffer(),
+                                        file.Size(),
+                                        previous ? *previous : -1);
+        mSounds.Set(name, soundId);
+        return soundId != -1;
+    }
+    else if(asset.Type() == Asset::Sound)
     {
         AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
         int soundId = wrapper->LoadSound(asset.Path().c_str());
 
-        mSoundNameId.insert
-        (
-            std::pair<std::string, int>
-            (
-                std::string(asset.Name()),
-                soundId
-            )
-        );
+        mSounds.Set(asset.Name().c_str(), soundId);
 
         dsprintf("Audio loaded: %d", soundId);
     }
     else if(asset.Type() == Asset::Stream)
     {
-        mStreamNameAsset.insert
-        (
-            std::pair<std::string, Asset*>
-            (
-                std::string(asset.Name()),
-                &asset
-            )
-        );
+        mStreams.Set(asset.Name().c_str(), &asset);
         return true;
     }
     else
@@ -147,12 +298,15 @@ void DDAudio::OnAssetDestroyed(Asset& asset)
 {
     if(asset.Type() == Asset::Sound)
     {
+        int* sound = mSounds.Find(asset.Name().c_str());
+        if(NativeAudio != NULL && sound != NULL)
+        {
+            NativeAudio->Unload(*sound);
+        }
     }
     else if(asset.Type() == Asset::Stream)
     {
-        std::map<std::string, Asset*>::iterator iter =
-            mStreamNameAsset.find(asset.Name());
-        mStreamNameAsset.erase(iter);
+        mStreams.Erase(asset.Name().c_str());
     }
     else
     {
@@ -162,20 +316,28 @@ void DDAudio::OnAssetDestroyed(Asset& asset)
 
 int DDAudio::GetSound(const char* name)
 {
-    if(mSoundNameId.find(name) == mSoundNameId.end())
+    int* sound = mSounds.Find(name);
+    if(sound == NULL)
     {
         dsprintf("ERROR: Couldn't find sound [%s]", name);
         return -1;
     }
-    return mSoundNameId.find(name)->second;
+    return *sound;
+}
+
+int DDAudio::FindSound(const char* name)
+{
+    unsigned int id = NameTable::Find(name);
+    return mSounds.Get(id) ? (int) id : -1;
 }
 
 Asset* DDAudio::GetStream(const char* name)
 {
-    if(mStreamNameAsset.find(name) == mStreamNameAsset.end())
+    Asset** stream = mStreams.Find(name);
+    if(stream == NULL)
     {
         dsprintf("ERROR: Couldn't find stream [%s]", name);
         return NULL;
     }
-    return mStreamNameAsset.find(name)->second;
+    return *stream;
 }
\ No newline at end of file
@@ -2,18 +2,24 @@
 
 #include <fstream>
 #include <jni.h>
+#include <string.h>
 #include <unistd.h>
 
+#include "AndroidAssets.h"
 #include "AndroidWrapper.h"
 #include "../../DDLog.h"
+#include "../../MappedFile.h"
+#include "../../MemoryStats.h"
+#include "../../PushedFiles.h"
+#include "../../RemoteAssets.h"
 
 DDFile* DDFile::OpenFile = NULL;
 
 
-void DDFile::WriteSaveData(const char* name, const char* data)
+bool DDFile::WriteSaveData(const char* name, const char* data, unsigned int size)
 {
     AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
-    wrapper->WriteSaveData(name, data);
+    return wrapper->WriteSaveData(name, data, size);
 }
 
 void DDFile::ReadSaveData(const char* name, std::string& data)
@@ -23,7 +29,7 @@ void DDFile::ReadSaveData(const char* name, std::string& data)
 }
 
 DDFile::DDFile(const char* filename)
-    : mName(filename), mBuffer(NULL), mSize(0)
+    : mName(filename), mBuffer(NULL), mSize(0), mOwnsBuffer(true), mMapped(NULL)
 {
 
 }
@@ -40,12 +46,40 @@ bool DDFile::FileExists(const char* path)
 
 //
 // Loads a file from the APK.
-// Calls OpenAsset which talks to Java
+// Read natively when AAssetManager is there, otherwise
+// calls OpenAsset which talks to Java
 // Java calls nativeIFStream which calls
 // SetBuffer
 //
 bool DDFile::LoadFileIntoBuffer()
 {
+    const char* pushed = NULL;
+    unsigned int pushedSize = 0;
+    if(PushedFiles::Read(mName.c_str(), &pushed, &pushedSize)
+       || RemoteAssets::Read(mName.c_str(), &pushed, &pushedSize))
+    {
+        ClearBuffer();
+        mBuffer = const_cast<char*>(pushed);
+        mSize = pushedSize;
+        MemoryStats::Add(MemoryStats::MEMORY_FILES, mSize);
+        return true;
+    }
+
+    if(AndroidAssets::IsAvailable())
+    {
+        const char* data = NULL;
+        unsigned int size = 0;
+        void* asset = AndroidAssets::Open(mName.c_str(), &data, &size);
+        if(asset == NULL)
+        {
+            dsprintf("Failed to open asset: %s", mName.c_str());
+            return false;
+        }
+        SetBuffer((char*) data, size);
+        AndroidAssets::Close(asset);
+        return true;
+    }
+
     OpenFile = this;
     AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
     dsprintf("Opening asset: %s", mName.c_str());
@@ -60,6 +94,29 @@ bool DDFile::LoadFileIntoBuffer()
     return result;
 }
 
+bool DDFile::LoadFileView()
+{
+    if(PushedFiles::Exists(mName.c_str()) || RemoteAssets::IsActive())
+    {
+        return LoadFileIntoBuffer();
+    }
+
+    ClearBuffer();
+    MappedFile* mapped = new MappedFile();
+    if(!mapped->Open(mName.c_str()))
+    {
+        // No AAssetManager or an empty asset, copy it in instead.
+        delete mapped;
+        return LoadFileIntoBuffer();
+    }
+
+    mMapped = mapped;
+    mBuffer = (char*) mapped->Data();
+    mSize = mapped->Size();
+    mOwnsBuffer = false;
+    return true;
+}
+
 void DDFile::SetBuffer(char* pData, int iSize)
 {
     dsprintf("Set buffer called size:%d", iSize);
@@ -67,14 +124,22 @@ void DDFile::SetBuffer(char* pData, int iSize)
     mBuffer = new char[iSize];
     memcpy( mBuffer, pData, sizeof(char)*iSize );
     mSize = iSize;
+    MemoryStats::Add(MemoryStats::MEMORY_FILES, mSize);
 }
 
 void DDFile::ClearBuffer()
 {
     if(mBuffer)
     {
-        delete[] mBuffer;
+        if(mOwnsBuffer)
+        {
+            delete[] mBuffer;
+            MemoryStats::Release(MemoryStats::MEMORY_FILES, mSize);
+        }
         mBuffer = NULL;
         mSize = 0;
     }
+    delete mMapped;
+    mMapped = NULL;
+    mOwnsBuffer = true;
 }
\ No newline at end of file
@@ -1,12 +1,16 @@
 #include "../../DDLog.h"
 #include <android/log.h>
-#include <stdarg.h>
-#include <stdio.h>
 
-void dsprintf(const char* fmt, ...)
+#include "../../LogRing.h"
+
+void ddlog_sink(eLogLevel level, const char* text)
 {
-    va_list args;
-    va_start(args, fmt);
-    __android_log_vprint(ANDROID_LOG_VERBOSE, "DSNDK", fmt, args);
-    va_end(args);
+    static const int priorities[] =
+    {
+        ANDROID_LOG_DEBUG,
+        ANDROID_LOG_INFO,
+        ANDROID_LOG_WARN,
+        ANDROID_LOG_ERROR
+    };
+    __android_log_write(priorities[level], "DSNDK", text);
 }
@@ -15,3 +15,12 @@ int DDRestful::Post(const char* uri, HttpPostData* postData,
     wrapper->HttpPost(uri, postData, callbackId);
     return callbackId;
 }
+
+// Java's replies come back through godpatterns_android.cpp's callback messages.
+void DDRestful::Update(LuaState* state)
+{
+}
+
+void DDRestful::Reset()
+{
+}
@@ -0,0 +1,54 @@
+#include "../../MappedFile.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "AndroidAssets.h"
+
+//
+// Android maps entries of the APK rather than loose files.
+//
+MappedFile::MappedFile() :
+    mData(NULL),
+    mSize(0),
+    mAsset(NULL)
+{
+}
+
+bool MappedFile::Open(const char* path)
+{
+    assert(path);
+    Close();
+
+    const char* data = NULL;
+    unsigned int size = 0;
+    mAsset = AndroidAssets::Open(path, &data, &size);
+    if(mAsset == NULL)
+    {
+        return false;
+    }
+
+    if(size == 0)
+    {
+        Close();
+        return false;
+    }
+
+    mData = (const unsigned char*) data;
+    mSize = size;
+    return true;
+}
+
+// APK entries are read through the asset manager, it does its own read
+// ahead.
+void MappedFile::Prefetch(unsigned int offset, unsigned int size) const
+{
+}
+
+void MappedFile::Close()
+{
+    AndroidAssets::Close(mAsset);
+    mAsset = NULL;
+    mData = NULL;
+    mSize = 0;
+}
\ No newline at end of file
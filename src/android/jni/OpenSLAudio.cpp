@@ -0,0 +1,355 @@
+#include "OpenSLAudio.h"
+
+#include <assert.h>
+#include <math.h>
+
+#include "../../audio/WaveDecoder.h"
+#include "../../DDLog.h"
+#include "../../MemoryStats.h"
+
+OpenSLAudio::OpenSLAudio() :
+    mEngineObject(NULL),
+    mEngine(NULL),
+    mOutputMix(NULL)
+{
+    for(unsigned int i = 0; i < MAX_VOICES; i++)
+    {
+        Voice& voice = mVoices[i];
+        voice.player = NULL;
+        voice.play = NULL;
+        voice.queue = NULL;
+        voice.volume = NULL;
+        voice.channels = 0;
+        voice.frequency = 0;
+        voice.bitsPerSample = 0;
+        voice.sound = -1;
+        voice.data = NULL;
+        voice.size = 0;
+        voice.loop = false;
+        voice.finished = false;
+    }
+}
+
+OpenSLAudio::~OpenSLAudio()
+{
+    for(unsigned int i = 0; i < MAX_VOICES; i++)
+    {
+        DestroyPlayer(&mVoices[i]);
+    }
+
+    if(mOutputMix != NULL)
+    {
+        (*mOutputMix)->Destroy(mOutputMix);
+    }
+
+    if(mEngineObject != NULL)
+    {
+        (*mEngineObject)->Destroy(mEngineObject);
+    }
+
+    for(unsigned int i = 0; i < mSounds.size(); i++)
+    {
+        MemoryStats::Release(MemoryStats::MEMORY_SOUNDS, mSounds[i].pcm.size());
+    }
+}
+
+bool OpenSLAudio::Init()
+{
+    if(slCreateEngine(&mEngineObject, 0, NULL, 0, NULL, NULL) != SL_RESULT_SUCCESS)
+    {
+        mEngineObject = NULL;
+        return false;
+    }
+
+    if((*mEngineObject)->Realize(mEngineObject, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS
+       || (*mEngineObject)->GetInterface(mEngineObject, SL_IID_ENGINE, &mEngine) != SL_RESULT_SUCCESS
+       || (*mEngine)->CreateOutputMix(mEngine, &mOutputMix, 0, NULL, NULL) != SL_RESULT_SUCCESS)
+    {
+        dsprintf("OpenSL ES engine couldn't be created.\n");
+        return false;
+    }
+
+    if((*mOutputMix)->Realize(mOutputMix, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS)
+    {
+        dsprintf("OpenSL ES output mix couldn't be realized.\n");
+        return false;
+    }
+    return true;
+}
+
+int OpenSLAudio::Load(const char* name, const char* file, unsigned int size, int previous)
+{
+    WaveDecoder::Chunks chunks;
+    if(!WaveDecoder::FindChunks(file, size, name, &chunks))
+    {
+        return -1;
+    }
+
+    // Rather than pick between the two, sounds that move in memory stop.
+    if(previous != -1)
+    {
+        Unload(previous);
+    }
+
+    int sound = previous;
+    if(sound == -1)
+    {
+        sound = (int) mSounds.size();
+        mSounds.push_back(PcmSound());
+    }
+
+    PcmSound& pcmSound = mSounds[sound];
+    if(!WaveDecoder::Decode(chunks, &pcmSound.pcm) || pcmSound.pcm.empty())
+    {
+        dsprintf("ERROR: Failed to decode sound [%s].\n", name);
+        pcmSound.pcm.clear();
+        return -1;
+    }
+    MemoryStats::Add(MemoryStats::MEMORY_SOUNDS, pcmSound.pcm.size());
+    pcmSound.channels = chunks.channels;
+    pcmSound.frequency = chunks.frequency;
+    pcmSound.bitsPerSample = WaveDecoder::DecodedBits(chunks);
+    return sound;
+}
+
+void OpenSLAudio::Unload(int sound)
+{
+    if(sound < 0 || sound >= (int) mSounds.size())
+    {
+        return;
+    }
+
+    for(unsigned int i = 0; i < MAX_VOICES; i++)
+    {
+        if(mVoices[i].sound == sound)
+        {
+            StopVoice(&mVoices[i]);
+        }
+    }
+
+    // Keep the slot, handles to it stay good if it's loaded again.
+    MemoryStats::Release(MemoryStats::MEMORY_SOUNDS, mSounds[sound].pcm.size());
+    std::vector<char>().swap(mSounds[sound].pcm);
+}
+
+int OpenSLAudio::Play(int sound, bool loop)
+{
+    if(sound < 0 || sound >= (int) mSounds.size() || mSounds[sound].pcm.empty())
+    {
+        return -1;
+    }
+
+    const PcmSound& pcmSound = mSounds[sound];
+    Voice* voice = FindFreeVoice(pcmSound);
+    if(voice == NULL)
+    {
+        dsprintf("No free voice for sound [%d].\n", sound);
+        return -1;
+    }
+
+    voice->sound = sound;
+    voice->data = &pcmSound.pcm[0];
+    voice->size = (unsigned int) pcmSound.pcm.size();
+    voice->loop = loop;
+    voice->finished = false;
+
+    (*voice->volume)->SetVolumeLevel(voice->volume, 0);
+    (*voice->queue)->Enqueue(voice->queue, voice->data, voice->size);
+    (*voice->play)->SetPlayState(voice->play, SL_PLAYSTATE_PLAYING);
+    return (int) (voice - mVoices);
+}
+
+void OpenSLAudio::Stop(int id)
+{
+    Voice* voice = GetVoice(id);
+    if(voice != NULL)
+    {
+        StopVoice(voice);
+    }
+}
+
+void OpenSLAudio::Pause(int id)
+{
+    Voice* voice = GetVoice(id);
+    if(voice != NULL)
+    {
+        (*voice->play)->SetPlayState(voice->play, SL_PLAYSTATE_PAUSED);
+    }
+}
+
+void OpenSLAudio::Resume(int id)
+{
+    Voice* voice = GetVoice(id);
+    if(voice != NULL)
+    {
+        (*voice->play)->SetPlayState(voice->play, SL_PLAYSTATE_PLAYING);
+    }
+}
+
+void OpenSLAudio::SetVolume(int id, float volume)
+{
+    Voice* voice = GetVoice(id);
+    if(voice == NULL)
+    {
+        return;
+    }
+
+    // OpenSL ES volumes are attenuation in millibels.
+    SLmillibel level = SL_MILLIBEL_MIN;
+    if(volume >= 1)
+    {
+        level = 0;
+    }
+    else if(volume > 0)
+    {
+        level = (SLmillibel) (2000.0f * log10f(volume));
+    }
+    (*voice->volume)->SetVolumeLevel(voice->volume, level);
+}
+
+void OpenSLAudio::Update()
+{
+    for(unsigned int i = 0; i < MAX_VOICES; i++)
+    {
+        Voice& voice = mVoices[i];
+        if(voice.sound != -1 && voice.finished)
+        {
+            StopVoice(&voice);
+        }
+    }
+}
+
+// Called on the OpenSL ES thread when the sound has played through.
+void OpenSLAudio::OnBufferDone(SLAndroidSimpleBufferQueueItf queue, void* context)
+{
+    Voice* voice = (Voice*) context;
+    if(voice->loop)
+    {
+        (*queue)->Enqueue(queue, voice->data, voice->size);
+        return;
+    }
+    voice->finished = true;
+}
+
+OpenSLAudio::Voice* OpenSLAudio::FindFreeVoice(const PcmSound& sound)
+{
+    Voice* unused = NULL;
+    for(unsigned int i = 0; i < MAX_VOICES; i++)
+    {
+        Voice* voice = &mVoices[i];
+        if(voice->sound != -1)
+        {
+            continue;
+        }
+
+        if(voice->player != NULL
+           && voice->channels == sound.channels
+           && voice->frequency == sound.frequency
+           && voice->bitsPerSample == sound.bitsPerSample)
+        {
+            return voice;
+        }
+
+        // Prefer a voice that has no player to one that would be rebuilt.
+        if(unused == NULL || unused->player != NULL)
+        {
+            unused = voice;
+        }
+    }
+
+    if(unused == NULL)
+    {
+        return NULL;
+    }
+
+    DestroyPlayer(unused);
+    return CreatePlayer(unused, sound) ? unused : NULL;
+}
+
+bool OpenSLAudio::CreatePlayer(Voice* voice, const PcmSound& sound)
+{
+    assert(voice->player == NULL);
+
+    SLDataLocator_AndroidSimpleBufferQueue locator =
+    {
+        SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, 1
+    };
+    SLDataFormat_PCM format =
+    {
+        SL_DATAFORMAT_PCM,
+        sound.channels,
+        sound.frequency * 1000, // in milliHertz
+        sound.bitsPerSample,
+        sound.bitsPerSample,
+        sound.channels == 1
+            ? SL_SPEAKER_FRONT_CENTER
+            : SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT,
+        SL_BYTEORDER_LITTLEENDIAN
+    };
+    SLDataSource source = { &locator, &format };
+
+    SLDataLocator_OutputMix outputMix = { SL_DATALOCATOR_OUTPUTMIX, mOutputMix };
+    SLDataSink sink = { &outputMix, NULL };
+
+    const SLInterfaceID ids[] = { SL_IID_ANDROIDSIMPLEBUFFERQUEUE, SL_IID_VOLUME };
+    const SLboolean required[] = { SL_BOOLEAN_TRUE, SL_BOOLEAN_TRUE };
+
+    if((*mEngine)->CreateAudioPlayer(mEngine, &voice->player, &source, &sink,
+                                     2, ids, required) != SL_RESULT_SUCCESS)
+    {
+        dsprintf("ERROR: OpenSL ES player couldn't be created [%d channels, %d Hz].\n",
+                 sound.channels, sound.frequency);
+        voice->player = NULL;
+        return false;
+    }
+
+    if((*voice->player)->Realize(voice->player, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS
+       || (*voice->player)->GetInterface(voice->player, SL_IID_PLAY, &voice->play) != SL_RESULT_SUCCESS
+       || (*voice->player)->GetInterface(voice->player, SL_IID_ANDROIDSIMPLEBUFFERQUEUE, &voice->queue) != SL_RESULT_SUCCESS
+       || (*voice->player)->GetInterface(voice->player, SL_IID_VOLUME, &voice->volume) != SL_RESULT_SUCCESS
+       || (*voice->queue)->RegisterCallback(voice->queue, OnBufferDone, voice) != SL_RESULT_SUCCESS)
+    {
+        dsprintf("ERROR: OpenSL ES player couldn't be realized.\n");
+        DestroyPlayer(voice);
+        return false;
+    }
+
+    voice->channels = sound.channels;
+    voice->frequency = sound.frequency;
+    voice->bitsPerSample = sound.bitsPerSample;
+    return true;
+}
+
+void OpenSLAudio::DestroyPlayer(Voice* voice)
+{
+    if(voice->player != NULL)
+    {
+        (*voice->player)->Destroy(voice->player);
+    }
+    voice->player = NULL;
+    voice->play = NULL;
+    voice->queue = NULL;
+    voice->volume = NULL;
+    voice->sound = -1;
+}
+
+void OpenSLAudio::StopVoice(Voice* voice)
+{
+    // Stop the callback re-queuing before the queue is cleared.
+    voice->loop = false;
+    (*voice->play)->SetPlayState(voice->play, SL_PLAYSTATE_STOPPED);
+    (*voice->queue)->Clear(voice->queue);
+    voice->sound = -1;
+    voice->data = NULL;
+    voice->size = 0;
+    voice->finished = false;
+}
+
+OpenSLAudio::Voice* OpenSLAudio::GetVoice(int id)
+{
+    if(id < 0 || id >= (int) MAX_VOICES || mVoices[id].sound == -1)
+    {
+        return NULL;
+    }
+    return &mVoices[id];
+}
\ No newline at end of file
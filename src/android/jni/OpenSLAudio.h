@@ -0,0 +1,78 @@
+#ifndef OPENSLAUDIO_H
+#define OPENSLAUDIO_H
+
+#include <SLES/OpenSLES.h>
+#include <SLES/OpenSLES_Android.h>
+#include <vector>
+
+//
+// Plays sounds through OpenSL ES rather than SoundPool, so playing one
+// doesn't cross JNI. Sounds are decoded to PCM when they load and kept in
+// memory, a play enqueues that PCM on a free buffer queue player.
+// Players are built for one sample format and kept, a free player is only
+// rebuilt when none of the free ones match the sound.
+//
+class OpenSLAudio
+{
+public:
+    static const unsigned int MAX_VOICES = 16;
+private:
+    struct PcmSound
+    {
+        std::vector<char> pcm;
+        unsigned int channels;
+        unsigned int frequency;
+        unsigned int bitsPerSample;
+    };
+
+    struct Voice
+    {
+        SLObjectItf player;
+        SLPlayItf play;
+        SLAndroidSimpleBufferQueueItf queue;
+        SLVolumeItf volume;
+        unsigned int channels;
+        unsigned int frequency;
+        unsigned int bitsPerSample;
+        int sound; // -1 when the voice is free
+        const char* data;
+        unsigned int size;
+        volatile bool loop;
+        // Set on the OpenSL ES thread, the voice is freed in Update.
+        volatile bool finished;
+    };
+
+    SLObjectItf mEngineObject;
+    SLEngineItf mEngine;
+    SLObjectItf mOutputMix;
+    std::vector<PcmSound> mSounds;
+    Voice mVoices[MAX_VOICES];
+public:
+    OpenSLAudio();
+    ~OpenSLAudio();
+
+    // False if there's no OpenSL ES on the device.
+    bool Init();
+    // Decodes the wave file, replacing the PCM of previous if it's not -1.
+    // Returns the sound to play, -1 if the file couldn't be decoded.
+    int Load(const char* name, const char* file, unsigned int size, int previous);
+    void Unload(int sound);
+
+    // Returns the voice playing the sound, -1 if no voice was free.
+    int Play(int sound, bool loop);
+    void Stop(int id);
+    void Pause(int id);
+    void Resume(int id);
+    void SetVolume(int id, float volume);
+    // Frees the voices of sounds that have finished.
+    void Update();
+private:
+    static void OnBufferDone(SLAndroidSimpleBufferQueueItf queue, void* context);
+    Voice* FindFreeVoice(const PcmSound& sound);
+    bool CreatePlayer(Voice* voice, const PcmSound& sound);
+    void DestroyPlayer(Voice* voice);
+    void StopVoice(Voice* voice);
+    Voice* GetVoice(int id);
+};
+
+#endif
\ No newline at end of file
@@ -14,12 +14,17 @@
 
 
 #include "../../Dinodeck.h"
+#include "../../FrameArena.h"
 #include "../../DDFile.h"
 #include "../../DDLog.h"
 #include "../../DDRestful.h"
 #include "../../Game.h"
+#include "../../LogRing.h"
 #include "../../input/Touch.h"
 #include "../../Settings.h"
+#include "../../StartupTimer.h"
+#include "../../Zones.h"
+#include "AndroidAssets.h"
 #include "AndroidWrapper.h"
 #include "DDLuaCallbacks.h"
 
@@ -56,15 +61,20 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* jvm, void* reserved)
 // ACTIVITY
 //
 JNIEXPORT int JNICALL Java_com_godpatterns_dinodeck_DDActivity_nativeOnCreate(
-        JNIEnv* env, jobject obj)
+        JNIEnv* env, jobject obj, jobject assetManager)
 {
+    StartupTimer::Begin();
+    LogRing::Start(); // never stopped, the process is killed
     dsprintf("Creating Dinodeck Android\n");
     dsprintf("Just a test %d", 108);
     assert(gJavaVM);
-    AndroidWrapper::CreateInstance(gJavaVM);
+    AndroidWrapper::CreateInstance(gJavaVM, env);
+    AndroidAssets::Init(env, assetManager);
     AssetStore::CleverReloadingFlag(false);
     gDinodeck = new Dinodeck("Dinodeck"); // Never deleted
+    StartupTimer::Mark("engine");
     gDinodeck->ReadInSettingsFile("settings.lua");
+    StartupTimer::Mark("settings");
 
     if(gDinodeck->GetSettings().orientation == "portrait")
     {
@@ -145,25 +155,56 @@ JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDActivity_nativeOnCallback
     //DDRestful::OnFinish(gDinodeck->GetGame()->GetLuaState(), callbackId);
 }
 
+// Queued onto the GL thread by onTrimMemory and onLowMemory.
+JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDActivity_nativeOnLowMemory(
+        JNIEnv*, jobject obj, int level)
+{
+    if(gDinodeck)
+    {
+        gDinodeck->OnLowMemory(level);
+    }
+}
+
 //
 // RENDERER
 //
 
+// Set when the next resize has to reload assets, first for the initial load
+// and then after a context has been lost.
+static bool gNeedsReload = true;
+static bool gHadContext = false;
+
+// Called for each new context. The context is kept over a pause where the
+// device allows it, so this normally only runs once.
 JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDRenderer_nativeClear(
     JNIEnv* pJNIEnv, jobject obj)
 {
+    if(gHadContext)
+    {
+        dsprintf("OpenGL context lost, reloading textures.\n");
+        gDinodeck->OpenGLContextReset();
+        gNeedsReload = true;
+    }
+    gHadContext = true;
     glClearColor(0.0, 0.0, 0.0, 0.0f);
 }
 
-JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDRenderer_nativeUpdate(
+// Returns false when the renderer can wait for input before drawing
+// again, see the redraw_on_request setting.
+JNIEXPORT jboolean JNICALL Java_com_godpatterns_dinodeck_DDRenderer_nativeUpdate(
     JNIEnv*, jobject obj, float dt)
 {
+    Zones::EndFrame();
+    FrameArena::Reset();
     gDinodeck->Update(dt);
+    // The Java side swaps after this returns, so the last phase stops
+    // short of the frame being shown.
+    StartupTimer::End();
 
     if(!gDinodeck->IsRunning())
     {
         AndroidWrapper::GetInstance()->Exit();
-        return;
+        return JNI_FALSE;
     }
 
     // This vector should be locked.
@@ -197,14 +238,19 @@ JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDRenderer_nativeUpdate(
         }
     }
     gCallbackMessages.clear();
+    return gDinodeck->WantsFrame() ? JNI_TRUE : JNI_FALSE;
 }
 
 JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDRenderer_nativeResize(
     JNIEnv*, jobject obj, int width, int height, float dpiX, float dpiY)
 {
-    // At the moment this reloads all textures from disk,
-    // might be better to store in ram if it gets slow.
-    gDinodeck->ForceReload();
+    // Only the textures and fonts marked as not loaded come back from
+    // disk, a resize with the context kept reloads nothing.
+    if(gNeedsReload)
+    {
+        gNeedsReload = false;
+        gDinodeck->ForceReload();
+    }
     gDinodeck->ResetRenderWindow(width, height);
 }
 
@@ -212,18 +258,40 @@ JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDRenderer_nativeResize(
 //
 // SURFACE
 //
-JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDGLSurfaceView_nativeOnTouch(
-    JNIEnv*, jobject obj, int event, float x, float y)
+// A whole MotionEvent in one call: count events of event, id, x, y with
+// the historical samples first, oldest to newest.
+JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDGLSurfaceView_nativeOnTouches(
+    JNIEnv* pJNIEnv, jobject obj, jfloatArray data, int count)
 {
-    assert(event >= 1);
-    assert(event <= 3);
+    const int BATCH = 64;
+    const int VALUES_PER_EVENT = 4;
     Game* game = gDinodeck->GetGame();
     Settings* settings = game->GetSettings();
-
-    static TouchMessage touchMessage;
-    touchMessage.mState = (TouchEvent::Enum)event;
-    touchMessage.mX = x - (settings->width/2);
-    touchMessage.mY = y - (settings->height/2);
-
-    game->GetTouch()->OnTouchEvent(touchMessage);
+    const float halfWidth = settings->width/2;
+    const float halfHeight = settings->height/2;
+
+    // Called on the UI thread, Touch queues them for the game thread.
+    jfloat* values = pJNIEnv->GetFloatArrayElements(data, NULL);
+    TouchMessage batch[BATCH];
+    int batched = 0;
+    for(int i = 0; i < count; i++)
+    {
+        const jfloat* event = values + i * VALUES_PER_EVENT;
+        assert(event[0] >= 1 && event[0] <= 3);
+        TouchMessage& touchMessage = batch[batched++];
+        touchMessage.mState = (TouchEvent::Enum)(int)event[0];
+        touchMessage.mId = (int)event[1];
+        touchMessage.mX = event[2] - halfWidth;
+        touchMessage.mY = event[3] - halfHeight;
+
+        if(batched == BATCH)
+        {
+            game->GetTouch()->OnTouchEvents(batch, batched);
+            batched = 0;
+        }
+    }
+    game->GetTouch()->OnTouchEvents(batch, batched);
+    pJNIEnv->ReleaseFloatArrayElements(data, values, JNI_ABORT);
+    // No redraw asked for here, the requestRender after this brings the
+    // frame that applies them and Dinodeck asks for the next from there.
 }
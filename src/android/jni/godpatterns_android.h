@@ -33,6 +33,11 @@ extern "C" {
     JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDActivity_nativeOnCallbackFinish(
         JNIEnv*, jobject obj, int);
 
+    // MEMORY
+
+    JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDActivity_nativeOnLowMemory(
+        JNIEnv*, jobject obj, int);
+
     //
     // RENDERER
     //
@@ -48,8 +53,8 @@ extern "C" {
     //
     // SURFACE
     //
-    JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDGLSurfaceView_nativeOnTouch(
-        JNIEnv*, jobject obj, int event, float x, float y);
+    JNIEXPORT void JNICALL Java_com_godpatterns_dinodeck_DDGLSurfaceView_nativeOnTouches(
+        JNIEnv* pJNIEnv, jobject obj, jfloatArray data, int count);
 
 
 #ifdef __cplusplus
@@ -1,6 +1,7 @@
 package com.godpatterns.dinodeck;
 
 import android.app.Activity;
+import android.content.ComponentCallbacks2;
 import android.content.Context;
 import android.content.pm.ActivityInfo;
 import android.content.res.AssetFileDescriptor;
@@ -17,7 +18,6 @@ import java.io.File;
 import java.io.FileInputStream;
 import java.io.FileOutputStream;
 import java.io.InputStream;
-import java.io.InputStreamReader;
 import java.io.IOException;
 import java.io.OutputStream;
 import java.lang.StringBuilder;
@@ -76,7 +76,7 @@ public class DDActivity extends Activity
         // Make activity statically available for functions
         // talking to C
         mActivity = this;
-        int dsRet = nativeOnCreate();
+        int dsRet = nativeOnCreate(getAssets());
 
         // Alternatively I could have Java SetOrientate function.
         // This seems ok for now.
@@ -182,6 +182,43 @@ public class DDActivity extends Activity
         setRequestedOrientation(mOrientation);
     }
 
+    // Only from API 14, older devices just get onLowMemory.
+    @Override
+    public void onTrimMemory(int level)
+    {
+        super.onTrimMemory(level);
+        if(level >= ComponentCallbacks2.TRIM_MEMORY_RUNNING_LOW)
+        {
+            queueLowMemory(level);
+        }
+    }
+
+    @Override
+    public void onLowMemory()
+    {
+        super.onLowMemory();
+        queueLowMemory(ComponentCallbacks2.TRIM_MEMORY_COMPLETE);
+    }
+
+    // The engine's only touched from the GL thread, its queued events
+    // still run while the view is paused.
+    private void queueLowMemory(final int level)
+    {
+        if(mGLView == null)
+        {
+            Log.v(TAG, "Low memory with no GL view, level " + level);
+            return;
+        }
+
+        mGLView.queueEvent(new Runnable()
+        {
+            public void run()
+            {
+                nativeOnLowMemory(level);
+            }
+        });
+    }
+
     public float deltaTime()
     {
         return mDeltaTime;
@@ -276,34 +313,36 @@ public class DDActivity extends Activity
 
     }
 
-    public static String read_save_data(String name)
+    // Saves are raw bytes, they may not be text.
+    public static byte[] read_save_data(String name)
     {
         Log.v(TAG, "read_save_data called with: [" + name + "]");
 
         File file = mActivity.getFileStreamPath(name);
         if(!file.exists())
         {
-            return "";
+            return new byte[0];
         }
 
         FileInputStream fis = null;
-        InputStreamReader isr = null;
 
         try
         {
-            // I feel like there should be a - ReadAll or something
-            // but I couldn't find it with a little searching.
-            int nbytes = (int) file.length();
-            char[] buffer = new char[nbytes];
+            byte[] buffer = new byte[(int) file.length()];
             fis = mActivity.openFileInput(name);
-            isr = new InputStreamReader(fis);
-            isr.read(buffer);
-            String data = new String(buffer);
+            int read = 0;
+            while(read < buffer.length)
+            {
+                int count = fis.read(buffer, read, buffer.length - read);
+                if(count < 0)
+                {
+                    break;
+                }
+                read += count;
+            }
             fis.close();
-            isr.close();
             fis = null;
-            isr = null;
-            return data;
+            return buffer;
         }
         catch (Exception e)
         {
@@ -318,36 +357,45 @@ public class DDActivity extends Activity
                 {
                     fis.close();
                 }
-
-                if(isr != null)
-                {
-                    isr.close();
-                }
             }
             catch (IOException e)
             {
             }
         }
-        return "";
+        return new byte[0];
     }
 
-    public static void write_save_data(String name, String data)
+    // Written to a temporary file, synced, then renamed over the save, so a
+    // crash part way leaves the old save whole. May be called off the UI
+    // thread.
+    public static boolean write_save_data(String name, byte[] data)
     {
-        Log.v(TAG, "write_save_data called with: [" + name + ", " + data +"]");
+        Log.v(TAG, "write_save_data called with: [" + name + ", " + data.length + " bytes]");
 
         FileOutputStream fos = null;
+        String temp = name + ".tmp";
 
         try
         {
-            fos = mActivity.openFileOutput(name, Context.MODE_PRIVATE);
-            fos.write(data.getBytes());
+            fos = mActivity.openFileOutput(temp, Context.MODE_PRIVATE);
+            fos.write(data);
+            fos.getFD().sync();
             fos.close();
             fos = null;
+
+            File tempFile = mActivity.getFileStreamPath(temp);
+            if(!tempFile.renameTo(mActivity.getFileStreamPath(name)))
+            {
+                Log.v(TAG, "write save data rename fail " + name);
+                return false;
+            }
+            return true;
         }
         catch (Exception e)
         {
             Log.v(TAG, "write save data fail " + name);
             e.printStackTrace();
+            return false;
         }
         finally
         {
@@ -433,11 +481,12 @@ public class DDActivity extends Activity
     }
 
     public static native void nativeIFStream( byte[] buffer, int iSize );
-    public native int nativeOnCreate();
+    public native int nativeOnCreate(AssetManager assets);
 
     public static native void nativeOnCallbackSuccess(int callbackId, String response);
     public static native void nativeOnCallbackFailure(int callbackId, String response);
     public static native void nativeOnCallbackFinish(int callbackId);
+    public static native void nativeOnLowMemory(int level);
 
     static
     {
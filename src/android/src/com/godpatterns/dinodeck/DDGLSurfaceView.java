@@ -3,6 +3,7 @@ package com.godpatterns.dinodeck;
 import android.app.Activity;
 import android.content.Context;
 import android.opengl.GLSurfaceView;
+import android.os.Build;
 import android.util.Log;
 import android.view.MotionEvent;
 import javax.microedition.khronos.egl.EGLConfig;
@@ -13,40 +14,134 @@ class DDGLSurfaceView extends GLSurfaceView
     private static final String TAG = "ddglsurface_view"; // used for logging
     DDRenderer mRenderer;
     DDActivity mActivity;
+    DDVsync mVsync; // null before API 16, frames are paced by the view
+    float[] mTouches = new float[4 * 32]; // event, id, x, y, reused between events
 
     public DDGLSurfaceView(Context context, DDActivity thisActivity)
     {
         super(context);
         mActivity = thisActivity;
-        mRenderer = new DDRenderer(context, thisActivity);
+        mRenderer = new DDRenderer(context, thisActivity, this);
+        if (Build.VERSION.SDK_INT >= 11)
+        {
+            // Textures survive a pause where the driver can keep the
+            // context, otherwise onSurfaceCreated brings them back.
+            setPreserveEGLContextOnPause(true);
+        }
         setRenderer(mRenderer);
-        // if (android.os.Build.VERSION.SDK_INT>=11)
-        // {
-        //     setPreserveEGLContextOnPause(true); //not possible on less than 3.0 (api 11)
-        // }
+
+        if (Build.VERSION.SDK_INT >= 16)
+        {
+            mVsync = new DDVsync(this);
+            setRenderMode(GLSurfaceView.RENDERMODE_WHEN_DIRTY);
+        }
+    }
+
+    public boolean isVsyncPaced()
+    {
+        return mVsync != null;
+    }
+
+    // UI thread, from DDVsync.
+    public void onVsync(long frameTimeNanos)
+    {
+        mRenderer.setVsyncTime(frameTimeNanos);
+        requestRender();
+    }
+
+    // Any thread. Without vsync callbacks the render mode does the same job.
+    public void setContinuous(final boolean continuous)
+    {
+        if (mVsync == null)
+        {
+            setRenderMode(continuous
+                          ? GLSurfaceView.RENDERMODE_CONTINUOUSLY
+                          : GLSurfaceView.RENDERMODE_WHEN_DIRTY);
+            return;
+        }
+
+        mActivity.runOnUiThread(new Runnable() {
+            public void run()
+            {
+                if (continuous)
+                {
+                    mVsync.start();
+                }
+                else
+                {
+                    mVsync.stop();
+                }
+            }
+        });
+    }
+
+    // Packs an event into mTouches, returns the next free event.
+    private int addTouch(int at, int touchEvent, int id, float x, float y)
+    {
+        int needed = (at + 1) * 4;
+        if (needed > mTouches.length)
+        {
+            float[] touches = new float[needed * 2];
+            System.arraycopy(mTouches, 0, touches, 0, mTouches.length);
+            mTouches = touches;
+        }
+        mTouches[at * 4] = touchEvent;
+        mTouches[at * 4 + 1] = id;
+        mTouches[at * 4 + 2] = x;
+        mTouches[at * 4 + 3] = y;
+        return at + 1;
     }
 
     public boolean onTouchEvent(final MotionEvent event)
     {
-        final int action = event.getAction();
+        // Every finger is passed on with its pointer id. The whole event
+        // crosses to native code in one call, moves with the samples
+        // batched since the last event ahead of the current positions.
+        final int action = event.getActionMasked();
+        final int index = event.getActionIndex();
+        int count = 0;
         switch (action)
         {
             case MotionEvent.ACTION_DOWN:
+            case MotionEvent.ACTION_POINTER_DOWN:
             {
-                nativeOnTouch(1, event.getX(), event.getY());
+                count = addTouch(count, 1, event.getPointerId(index),
+                                 event.getX(index), event.getY(index));
                 break;
             }
             case MotionEvent.ACTION_UP:
+            case MotionEvent.ACTION_POINTER_UP:
+            case MotionEvent.ACTION_CANCEL:
             {
-                nativeOnTouch(2, event.getX(), event.getY());
+                count = addTouch(count, 2, event.getPointerId(index),
+                                 event.getX(index), event.getY(index));
                 break;
             }
             case MotionEvent.ACTION_MOVE:
             {
-                nativeOnTouch(3, event.getX(), event.getY());
+                final int pointers = event.getPointerCount();
+                for (int h = 0; h < event.getHistorySize(); h++)
+                {
+                    for (int i = 0; i < pointers; i++)
+                    {
+                        count = addTouch(count, 3, event.getPointerId(i),
+                                         event.getHistoricalX(i, h),
+                                         event.getHistoricalY(i, h));
+                    }
+                }
+                for (int i = 0; i < pointers; i++)
+                {
+                    count = addTouch(count, 3, event.getPointerId(i),
+                                     event.getX(i), event.getY(i));
+                }
                 break;
             }
         }
+        if (count > 0)
+        {
+            nativeOnTouches(mTouches, count);
+        }
+        requestRender();
         return true;
     }
 
@@ -62,12 +157,20 @@ class DDGLSurfaceView extends GLSurfaceView
         {
             mRenderer.gainedFocus();
         }
+        if (mVsync != null)
+        {
+            mVsync.start();
+        }
     }
 
     public void onPause()
     {
+        if (mVsync != null)
+        {
+            mVsync.stop();
+        }
         super.onPause();
     }
 
-    private static native void nativeOnTouch(int touchEvent, float x, float y);
+    private static native void nativeOnTouches(float[] touches, int count);
 }
@@ -1,4 +1,4 @@
-package com.godpattersn.dinodeck;
+package com.godpatterns.dinodeck;
 
 import android.content.Context;
 import android.opengl.GLSurfaceView;
@@ -15,13 +15,22 @@ class DDRenderer implements GLSurfaceView.Renderer
     private int mWidth;
     private int mHeight;
     private boolean mResumeThisFrame;
+    private DDGLSurfaceView mView;
+    private boolean mContinuous;
+    // Set on the UI thread for each vsync, 0 when frames aren't vsync paced.
+    private volatile long mVsyncNanos;
+    private long mLastVsyncNanos;
     public static GL10 mGL;
 
-    public DDRenderer(Context context, DDActivity thisActivity)
+    public DDRenderer(Context context, DDActivity thisActivity, DDGLSurfaceView view)
     {
         this.mContext = context;
         this.mActivity = thisActivity;
         this.mResumeThisFrame = false;
+        this.mView = view;
+        this.mContinuous = true;
+        this.mVsyncNanos = 0;
+        this.mLastVsyncNanos = 0;
     }
 
     public void gainedFocus()
@@ -29,6 +38,29 @@ class DDRenderer implements GLSurfaceView.Renderer
         mResumeThisFrame = true;
     }
 
+    public void setVsyncTime(long frameTimeNanos)
+    {
+        mVsyncNanos = frameTimeNanos;
+    }
+
+    // Seconds between the vsyncs frames started on, so frames move the
+    // same amount each refresh. Input frames between refreshes reuse the
+    // last vsync and so take 0. Frames drawn only for input, and the first
+    // after a pause, are timed by the clock instead.
+    private float frameTime()
+    {
+        long vsync = mVsyncNanos;
+        if (vsync == 0 || !mContinuous || mLastVsyncNanos == 0)
+        {
+            mLastVsyncNanos = mContinuous ? vsync : 0;
+            return mActivity.deltaTime();
+        }
+
+        float dt = (vsync - mLastVsyncNanos) / 1000000000.0f;
+        mLastVsyncNanos = vsync;
+        return dt;
+    }
+
     public void onSurfaceCreated(GL10 gl, EGLConfig config)
     {
         mGL = gl;
@@ -57,10 +89,18 @@ class DDRenderer implements GLSurfaceView.Renderer
         if (mResumeThisFrame)
         {
             mResumeThisFrame = false;
+            mLastVsyncNanos = 0; // the pause isn't a frame's time
             //nativeResume();
         }
 
-        nativeUpdate(mActivity.deltaTime());
+        // When the game doesn't need another frame, only draw again once
+        // requestRender is called for input.
+        boolean continuous = nativeUpdate(frameTime());
+        if (continuous != mContinuous)
+        {
+            mContinuous = continuous;
+            mView.setContinuous(continuous);
+        }
 
         mActivity.runOnUiThread(new Runnable() {
             public void run()
@@ -70,6 +110,6 @@ class DDRenderer implements GLSurfaceView.Renderer
         });
     }
     private native void nativeClear();
-    private native void nativeUpdate(float dt);
+    private native boolean nativeUpdate(float dt);
     private native void nativeResize(int w, int h, float dpiX, float dpiY);
 }
\ No newline at end of file
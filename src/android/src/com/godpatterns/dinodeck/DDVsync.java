@@ -0,0 +1,44 @@
+package com.godpatterns.dinodeck;
+
+import android.view.Choreographer;
+
+// Asks the view for a frame on every vsync, so frames start in step with
+// the display whatever its refresh rate. Choreographer is API 16 and up,
+// the class is only loaded there.
+class DDVsync implements Choreographer.FrameCallback
+{
+    private DDGLSurfaceView mView;
+    private boolean mRunning;
+
+    public DDVsync(DDGLSurfaceView view)
+    {
+        mView = view;
+        mRunning = false;
+    }
+
+    // UI thread only, Choreographer is per looper.
+    public void start()
+    {
+        if (!mRunning)
+        {
+            mRunning = true;
+            Choreographer.getInstance().postFrameCallback(this);
+        }
+    }
+
+    public void stop()
+    {
+        mRunning = false;
+        Choreographer.getInstance().removeFrameCallback(this);
+    }
+
+    public void doFrame(long frameTimeNanos)
+    {
+        if (!mRunning)
+        {
+            return;
+        }
+        mView.onVsync(frameTimeNanos);
+        Choreographer.getInstance().postFrameCallback(this);
+    }
+}
\ No newline at end of file
@@ -106,7 +106,7 @@ class DDScoreLoop
         });
     }
 
-    public static void push_score(final double primary, final double secondary, final int callbackId)
+    public static void push_score(final double primary, final double secondary, final int mode, final int callbackId)
     {
 
         Log.v(TAG, "Entered get_tos_state");
@@ -128,6 +128,7 @@ class DDScoreLoop
                     {
                         // Handle Success
                         mScoreLoop.mDDActivity.nativeOnCallbackSuccess(callbackId, "");
+                        mScoreLoop.mDDActivity.nativeOnCallbackFinish(callbackId);
                     }
 
                     @Override
@@ -135,11 +136,13 @@ class DDScoreLoop
                     {
                         // Handle Failure
                         mScoreLoop.mDDActivity.nativeOnCallbackFailure(callbackId, "");
+                        mScoreLoop.mDDActivity.nativeOnCallbackFinish(callbackId);
                     }
                 };
 
                 final Score score = new Score(primary, null);
-                // score.setMode(gameState.getMode()); // A int to signify the level
+                score.setMinorResult(secondary);
+                score.setMode(mode); // A int to signify the level
 
                 ScoreController scoreController = new ScoreController(scoreControllerObserver);
                 scoreController.submitScore(score);
@@ -196,6 +199,7 @@ class DDScoreLoop
                         builder.append("]");
 
                         mScoreLoop.mDSActivity.nativeOnCallbackSuccess(callbackId, builder.toString());
+                        mScoreLoop.mDSActivity.nativeOnCallbackFinish(callbackId);
                     }
 
                     @Override
@@ -203,6 +207,7 @@ class DDScoreLoop
                     {
                         // Handle Failure
                         mScoreLoop.mDDActivity.nativeOnCallbackFailure(callbackId, "");
+                        mScoreLoop.mDDActivity.nativeOnCallbackFinish(callbackId);
                     }
                 };
 
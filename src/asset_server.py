@@ -0,0 +1,142 @@
+import os
+import struct
+import sys
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import unquote
+#
+# Serve a game's assets to devices running with asset_server set.
+#
+# usage: python asset_server.py <game dir> [port]
+#
+# Put the address in the device's settings.lua, and in the served one
+# too, a reload reads it from here:
+#
+#   asset_server = "http://192.168.1.10:8765"
+#   asset_cache_dir = "/data/data/<package>/files" -- optional
+#
+# Every file goes out with the XXHash of its contents as its ETag. The
+# device sends back the hash of the copy it has and only gets the file
+# again when that's changed.
+#
+
+DEFAULT_PORT = 8765
+MASK = 0xFFFFFFFF
+PRIME1 = 2654435761
+PRIME2 = 2246822519
+PRIME3 = 3266489917
+PRIME4 = 668265263
+PRIME5 = 374761393
+
+def rotl(x, r):
+    return ((x << r) | (x >> (32 - r))) & MASK
+
+def round32(acc, lane):
+    acc = (acc + lane * PRIME2) & MASK
+    return (rotl(acc, 13) * PRIME1) & MASK
+
+def xxh32_python(data, seed=0):
+    # Must match XXHash::Hash32, the reference XXH32.
+    length = len(data)
+    i = 0
+    if length >= 16:
+        v1 = (seed + PRIME1 + PRIME2) & MASK
+        v2 = (seed + PRIME2) & MASK
+        v3 = seed
+        v4 = (seed - PRIME1) & MASK
+        while i <= length - 16:
+            a, b, c, d = struct.unpack_from("<4I", data, i)
+            v1 = round32(v1, a)
+            v2 = round32(v2, b)
+            v3 = round32(v3, c)
+            v4 = round32(v4, d)
+            i += 16
+        h = (rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18)) & MASK
+    else:
+        h = (seed + PRIME5) & MASK
+    h = (h + length) & MASK
+    while i + 4 <= length:
+        h = (h + struct.unpack_from("<I", data, i)[0] * PRIME3) & MASK
+        h = (rotl(h, 17) * PRIME4) & MASK
+        i += 4
+    while i < length:
+        h = (h + data[i] * PRIME5) & MASK
+        h = (rotl(h, 11) * PRIME1) & MASK
+        i += 1
+    h ^= h >> 15
+    h = (h * PRIME2) & MASK
+    h ^= h >> 13
+    h = (h * PRIME3) & MASK
+    h ^= h >> 16
+    return h
+
+try:
+    import xxhash
+    def xxh32(data):
+        return xxhash.xxh32_intdigest(data)
+except ImportError:
+    xxh32 = xxh32_python
+
+class AssetHandler(BaseHTTPRequestHandler):
+    root = "."
+    # path -> (mtime, size, hash), so unchanged files aren't hashed again
+    hashes = {}
+
+    def resolve(self):
+        name = unquote(self.path.split("?", 1)[0]).lstrip("/")
+        path = os.path.realpath(os.path.join(self.root, name))
+        if not path.startswith(self.root + os.sep) or not os.path.isfile(path):
+            return None
+        return path
+
+    def do_GET(self):
+        path = self.resolve()
+        if path is None:
+            self.send_error(404)
+            return
+
+        stat = os.stat(path)
+        known = self.hashes.get(path)
+        data = None
+        if known is None or known[0] != stat.st_mtime or known[1] != stat.st_size:
+            with open(path, "rb") as f:
+                data = f.read()
+            known = (stat.st_mtime, stat.st_size, xxh32(data))
+            self.hashes[path] = known
+
+        etag = '"%08x"' % known[2]
+        if self.headers.get("If-None-Match") == etag:
+            self.send_response(304)
+            self.send_header("ETag", etag)
+            self.end_headers()
+            return
+
+        if data is None:
+            with open(path, "rb") as f:
+                data = f.read()
+        self.send_response(200)
+        self.send_header("ETag", etag)
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+        print("  sent %s %d bytes" % (os.path.relpath(path, self.root), len(data)))
+
+    def log_message(self, format, *args):
+        pass
+
+def main(argv):
+    if len(argv) < 1:
+        print("usage: python asset_server.py <game dir> [port]")
+        return 1
+    AssetHandler.root = os.path.realpath(argv[0])
+    AssetHandler.protocol_version = "HTTP/1.1" # keep connections alive
+    port = int(argv[1]) if len(argv) > 1 else DEFAULT_PORT
+    server = ThreadingHTTPServer(("", port), AssetHandler)
+    print("Serving [%s] on port %d." % (AssetHandler.root, port))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
\ No newline at end of file
@@ -7,8 +7,10 @@
 //typedef unsigned long uint32_t;
 #endif
 
+#include "../AssetReport.h"
 #include "../DDLog.h"
 #include "../DDFile.h"
+#include "../DDTime.h"
 
 
 
@@ -63,7 +65,7 @@ bool Wave::LoadToOpenALBuffer(const char* filename,
     WAVE_Format wave_format;
     RIFF_Header riff_header;
     WAVE_Data wave_data;
-    unsigned char* data;
+    const unsigned char* data;
 
     // Need to implement
 
@@ -77,7 +79,10 @@ bool Wave::LoadToOpenALBuffer(const char* filename,
         return false;
     }
 
-    soundFile.LoadFileIntoBuffer();
+    unsigned long long start = DDTime::Microseconds();
+    soundFile.LoadFileView();
+    AssetReport::AddRead(AssetReport::Current(), soundFile.Size(),
+                         DDTime::Microseconds() - start);
     void* readPtr = (void*)soundFile.Buffer();
 
     // Read in the first chunk into the struct
@@ -114,6 +119,13 @@ bool Wave::LoadToOpenALBuffer(const char* filename,
         return false;
     }
 
+    // Compressed waves go through WaveDecoder instead.
+    if (wave_format.audioFormat != 1)
+    {
+        dsprintf("ERROR: Failed to load. Wave isn't PCM.\n");
+        return false;
+    }
+
     //check for extra parameters;
     if (wave_format.subChunkSize > 16)
     {
@@ -135,15 +147,13 @@ bool Wave::LoadToOpenALBuffer(const char* filename,
         return false;
     }
 
-    //Allocate memory for data
-    data = new unsigned char[wave_data.subChunk2Size];
-
-    // Read in the sound data into the soundData variable
-    if (!soundFile.Read(data, wave_data.subChunk2Size, /*1,*/ readPtr))
+    // The samples go to OpenAL straight from the file view.
+    data = (const unsigned char*) readPtr;
+    const unsigned int consumed = (unsigned int)(data - (const unsigned char*) soundFile.Buffer());
+    if (consumed > soundFile.Size() ||
+        wave_data.subChunk2Size > soundFile.Size() - consumed)
     {
-        dsprintf("ERROR: Failed to read header into struct.\n");
-        delete [] data;
-        data = NULL;
+        dsprintf("ERROR: Failed to load. Data chunk is truncated.\n");
         return false;
     }
 
@@ -185,9 +195,11 @@ bool Wave::LoadToOpenALBuffer(const char* filename,
 
     //now we put our data into the openAL buffer and
     //check for success
-    alBufferData(*buffer, *format, (void*) data, *size, *frequency);
+    start = DDTime::Microseconds();
+    alBufferData(*buffer, *format, (const void*) data, *size, *frequency);
+    AssetReport::AddUpload(AssetReport::Current(), DDTime::Microseconds() - start);
+    AssetReport::SetMemory(AssetReport::Current(), *size);
 
-    delete [] data;
     // errorCheck();
 
     //clean up and return true if successful
@@ -195,3 +207,12 @@ bool Wave::LoadToOpenALBuffer(const char* filename,
 
     return true;
 }
+
+ALenum Wave::Format(unsigned int channels, unsigned int bitsPerSample)
+{
+    if(channels == 1)
+    {
+        return bitsPerSample == 8 ? AL_FORMAT_MONO8 : AL_FORMAT_MONO16;
+    }
+    return bitsPerSample == 8 ? AL_FORMAT_STEREO8 : AL_FORMAT_STEREO16;
+}
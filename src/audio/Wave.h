@@ -12,6 +12,7 @@ public:
                                    ALsizei* size,
                                    ALsizei* frequency,
                                    ALenum* format);
+    static ALenum Format(unsigned int channels, unsigned int bitsPerSample);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,326 @@
+#include "WaveDecoder.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../DDLog.h"
+
+static uint32_t ReadU32(const char* data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static uint16_t ReadU16(const char* data)
+{
+    uint16_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+bool WaveDecoder::FindChunks(const char* file, unsigned int size, const char* name, Chunks* out)
+{
+    assert(file);
+    assert(out);
+    memset(out, 0, sizeof(Chunks));
+
+    if(size < 12 || memcmp(file, "RIFF", 4) != 0 || memcmp(file + 8, "WAVE", 4) != 0)
+    {
+        dsprintf("ERROR: [%s] wave header tag missing.\n", name);
+        return false;
+    }
+
+    // Walk the chunks, anything other than the format and data is skipped.
+    bool hasFormat = false;
+    unsigned int offset = 12;
+    while(offset + 8 <= size)
+    {
+        const char* chunk = file + offset;
+        const uint32_t chunkSize = ReadU32(chunk + 4);
+        offset += 8;
+
+        if(chunkSize > size - offset)
+        {
+            dsprintf("ERROR: [%s] wave chunk is truncated.\n", name);
+            return false;
+        }
+
+        if(memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16)
+        {
+            out->encoding = ReadU16(chunk + 8);
+            out->channels = ReadU16(chunk + 10);
+            out->frequency = ReadU32(chunk + 12);
+            out->blockAlign = ReadU16(chunk + 20);
+            out->bitsPerSample = ReadU16(chunk + 22);
+            if(chunkSize >= 20)
+            {
+                out->samplesPerBlock = ReadU16(chunk + 26);
+            }
+            hasFormat = true;
+        }
+        else if(memcmp(chunk, "data", 4) == 0)
+        {
+            if(!hasFormat)
+            {
+                dsprintf("ERROR: [%s] wave data before fmt.\n", name);
+                return false;
+            }
+            out->data = file + offset;
+            out->dataSize = chunkSize;
+            break;
+        }
+
+        // Chunks are padded to an even size.
+        offset += chunkSize + (chunkSize & 1);
+    }
+
+    if(out->data == NULL)
+    {
+        dsprintf("ERROR: [%s] wave data tag missing.\n", name);
+        return false;
+    }
+
+    if(out->channels < 1 || out->channels > 2 || out->blockAlign == 0)
+    {
+        dsprintf("ERROR: [%s] wave has %d channels, only mono and stereo play.\n",
+                 name, out->channels);
+        return false;
+    }
+
+    if(out->encoding == PCM)
+    {
+        out->dataSize -= out->dataSize % out->blockAlign;
+        return true;
+    }
+
+    if(out->encoding == IMA_ADPCM
+       && out->bitsPerSample == 4
+       && out->blockAlign > 4 * out->channels)
+    {
+        const unsigned int expected =
+            ((out->blockAlign - 4 * out->channels) * 8) / (4 * out->channels) + 1;
+        if(out->samplesPerBlock == 0 || out->samplesPerBlock > expected)
+        {
+            out->samplesPerBlock = expected;
+        }
+        return true;
+    }
+
+    dsprintf("ERROR: [%s] wave encoding [0x%x] isn't supported, use PCM or IMA ADPCM.\n",
+             name, out->encoding);
+    return false;
+}
+
+bool WaveDecoder::Decode(const Chunks& chunks, std::vector<char>* pcm)
+{
+    assert(pcm);
+    pcm->clear();
+
+    if(chunks.encoding == PCM)
+    {
+        pcm->assign(chunks.data, chunks.data + chunks.dataSize);
+        return true;
+    }
+    else if(chunks.encoding == IMA_ADPCM)
+    {
+        DecodeImaAdpcm(chunks, pcm);
+        return true;
+    }
+    return false;
+}
+
+static const int IMA_INDEX_TABLE[16] =
+{
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static const int IMA_STEP_TABLE[89] =
+{
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+struct ImaChannel
+{
+    int predictor;
+    int index;
+
+    int16_t Next(unsigned int nibble)
+    {
+        const int step = IMA_STEP_TABLE[index];
+        int diff = step >> 3;
+        if(nibble & 1) diff += step >> 2;
+        if(nibble & 2) diff += step >> 1;
+        if(nibble & 4) diff += step;
+        if(nibble & 8) diff = -diff;
+
+        predictor += diff;
+        predictor = predictor > 32767 ? 32767 : (predictor < -32768 ? -32768 : predictor);
+        index += IMA_INDEX_TABLE[nibble];
+        index = index > 88 ? 88 : (index < 0 ? 0 : index);
+        return (int16_t) predictor;
+    }
+};
+
+//
+// Each block starts with a 4 byte header per channel, the first sample
+// and step index. Then for each channel in turn 4 bytes of 8 samples,
+// low nibble first.
+//
+void WaveDecoder::DecodeImaAdpcm(const Chunks& chunks, std::vector<char>* pcm)
+{
+    const unsigned int channels = chunks.channels;
+    const unsigned int blocks = (chunks.dataSize + chunks.blockAlign - 1) / chunks.blockAlign;
+    std::vector<int16_t> samples;
+    samples.reserve(blocks * chunks.samplesPerBlock * channels);
+
+    for(unsigned int block = 0; block < blocks; block++)
+    {
+        const char* data = chunks.data + block * chunks.blockAlign;
+        unsigned int blockSize = chunks.dataSize - block * chunks.blockAlign;
+        blockSize = blockSize < chunks.blockAlign ? blockSize : chunks.blockAlign;
+        if(blockSize < 4 * channels)
+        {
+            break;
+        }
+
+        ImaChannel state[2];
+        for(unsigned int c = 0; c < channels; c++)
+        {
+            state[c].predictor = (int16_t) ReadU16(data + c * 4);
+            state[c].index = (unsigned char) data[c * 4 + 2];
+            state[c].index = state[c].index > 88 ? 88 : state[c].index;
+            samples.push_back((int16_t) state[c].predictor);
+        }
+
+        // A short final block only holds the samples it has room for.
+        const unsigned int groups = (blockSize - 4 * channels) / (4 * channels);
+        const char* nibbles = data + 4 * channels;
+        const unsigned int first = samples.size();
+        samples.resize(first + groups * 8 * channels);
+
+        for(unsigned int group = 0; group < groups; group++)
+        {
+            for(unsigned int c = 0; c < channels; c++)
+            {
+                const char* bytes = nibbles + (group * channels + c) * 4;
+                for(unsigned int i = 0; i < 8; i++)
+                {
+                    const unsigned char byte = (unsigned char) bytes[i / 2];
+                    const unsigned int nibble = (i & 1) ? (byte >> 4) : (byte & 0x0f);
+                    samples[first + (group * 8 + i) * channels + c] = state[c].Next(nibble);
+                }
+            }
+        }
+    }
+
+    pcm->resize(samples.size() * sizeof(int16_t));
+    if(!samples.empty())
+    {
+        memcpy(&(*pcm)[0], &samples[0], pcm->size());
+    }
+}
+
+// The source frame's sample, the first and last frames repeat past the ends.
+static float SampleAt(const std::vector<float>& samples,
+                      int frames,
+                      unsigned int channels,
+                      int frame,
+                      unsigned int channel)
+{
+    frame = frame < 0 ? 0 : (frame >= frames ? frames - 1 : frame);
+    return samples[frame * channels + channel];
+}
+
+static float CatmullRom(float a, float b, float c, float d, float t)
+{
+    return b + 0.5f * t * (c - a + t * (2 * a - 5 * b + 4 * c - d + t * (3 * (b - c) + d - a)));
+}
+
+void WaveDecoder::Convert(const Chunks& chunks, const Conversion& to, std::vector<char>* pcm)
+{
+    assert(pcm);
+    const unsigned int bits = DecodedBits(chunks);
+    const unsigned int inChannels = chunks.channels;
+    const unsigned int outChannels = to.channels ? to.channels : inChannels;
+    const unsigned int inRate = chunks.frequency;
+    const unsigned int outRate = to.frequency ? to.frequency : inRate;
+    const unsigned int frameBytes = inChannels * bits / 8;
+    if(frameBytes == 0 || inRate == 0 || pcm->size() < frameBytes)
+    {
+        return;
+    }
+    const int frames = (int)(pcm->size() / frameBytes);
+
+    // Remixed to the output channels first, so only those are resampled.
+    std::vector<float> samples(frames * outChannels);
+    const char* in = &(*pcm)[0];
+    for(int f = 0; f < frames; f++)
+    {
+        float frame[2] = { 0, 0 };
+        for(unsigned int c = 0; c < inChannels && c < 2; c++)
+        {
+            const char* at = in + f * frameBytes + c * (bits / 8);
+            frame[c] = (bits == 8)
+                ? ((int)(unsigned char) *at - 128) / 128.0f
+                : (int16_t) ReadU16(at) / 32768.0f;
+        }
+
+        if(outChannels == 1)
+        {
+            samples[f] = (inChannels == 1) ? frame[0] : (frame[0] + frame[1]) * 0.5f;
+        }
+        else
+        {
+            samples[f * 2] = frame[0];
+            samples[f * 2 + 1] = (inChannels == 1) ? frame[0] : frame[1];
+        }
+    }
+
+    // No low pass, going down a rate can alias. Sounds are normally
+    // brought up to the output rate.
+    const unsigned int outFrames = (unsigned int)
+        (((unsigned long long) frames * outRate + inRate - 1) / inRate);
+    const double step = (double) inRate / outRate;
+    std::vector<int16_t> out(outFrames * outChannels);
+    for(unsigned int i = 0; i < outFrames; i++)
+    {
+        const double position = i * step;
+        const int index = (int) position;
+        const float t = (float)(position - index);
+        for(unsigned int c = 0; c < outChannels; c++)
+        {
+            const float b = SampleAt(samples, frames, outChannels, index, c);
+            const float n = SampleAt(samples, frames, outChannels, index + 1, c);
+            float value = b + (n - b) * t;
+            if(to.quality == CUBIC)
+            {
+                value = CatmullRom(SampleAt(samples, frames, outChannels, index - 1, c),
+                                   b,
+                                   n,
+                                   SampleAt(samples, frames, outChannels, index + 2, c),
+                                   t);
+            }
+
+            int sample = (int)(value * 32768.0f);
+            sample = sample > 32767 ? 32767 : (sample < -32768 ? -32768 : sample);
+            out[i * outChannels + c] = (int16_t) sample;
+        }
+    }
+
+    pcm->resize(out.size() * sizeof(int16_t));
+    if(!out.empty())
+    {
+        memcpy(&(*pcm)[0], &out[0], pcm->size());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef WAVEDECODER_H
+#define WAVEDECODER_H
+
+#include <vector>
+
+//
+// Reads the fmt and data chunks of wave files, and decodes the compressed
+// ones to PCM. Touches no audio API state, so it's safe on any thread and
+// is shared by the OpenAL and OpenSL ES backends.
+//
+class WaveDecoder
+{
+public:
+    enum eEncoding
+    {
+        PCM = 0x0001,
+        IMA_ADPCM = 0x0011
+    };
+
+    enum eQuality
+    {
+        LINEAR,
+        CUBIC
+    };
+
+    struct Chunks
+    {
+        unsigned int encoding;
+        unsigned int channels;
+        unsigned int frequency;
+        unsigned int blockAlign;
+        unsigned int bitsPerSample;
+        unsigned int samplesPerBlock; // compressed only
+        const char* data;
+        unsigned int dataSize;
+    };
+
+    // False, with the reason printed, if it isn't a wave file.
+    static bool FindChunks(const char* file, unsigned int size, const char* name, Chunks* out);
+    static bool IsCompressed(const Chunks& chunks) { return chunks.encoding != PCM; }
+    // Bits per sample of the PCM that Decode gives back.
+    static unsigned int DecodedBits(const Chunks& chunks)
+    {
+        return IsCompressed(chunks) ? 16 : chunks.bitsPerSample;
+    }
+
+    // What Convert makes decoded PCM into, 0 keeps the source's.
+    struct Conversion
+    {
+        unsigned int frequency;
+        unsigned int channels; // 1 or 2
+        eQuality quality;
+
+        Conversion() : frequency(0), channels(0), quality(LINEAR) {}
+        bool Changes(const Chunks& chunks) const
+        {
+            return (frequency != 0 && frequency != chunks.frequency)
+                || (channels != 0 && channels != chunks.channels);
+        }
+    };
+
+    // Decodes to 16 bit PCM.
+    static bool Decode(const Chunks& chunks, std::vector<char>* pcm);
+    // Resamples and remixes what Decode gave back, to 16 bit PCM.
+    static void Convert(const Chunks& chunks, const Conversion& to, std::vector<char>* pcm);
+private:
+    static void DecodeImaAdpcm(const Chunks& chunks, std::vector<char>* pcm);
+};
+
+#endif
\ No newline at end of file
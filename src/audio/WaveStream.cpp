@@ -0,0 +1,90 @@
+#include "WaveStream.h"
+
+#include <string.h>
+
+#include "../DDFile.h"
+#include "../DDLog.h"
+#include "Wave.h"
+#include "WaveDecoder.h"
+
+WaveStream::WaveStream() :
+    mFile(NULL),
+    mData(NULL),
+    mDataSize(0),
+    mCursor(0),
+    mBlockAlign(1),
+    mFormat(0),
+    mFrequency(0)
+{
+}
+
+WaveStream::~WaveStream()
+{
+    Close();
+}
+
+void WaveStream::Close()
+{
+    if(mFile)
+    {
+        delete mFile;
+        mFile = NULL;
+    }
+    mData = NULL;
+    mDataSize = 0;
+    mCursor = 0;
+}
+
+bool WaveStream::Open(const char* path)
+{
+    Close();
+
+    if(!DDFile::FileExists(path))
+    {
+        dsprintf("ERROR: Failed to stream. Couldn't find file [%s].\n", path);
+        return false;
+    }
+
+    mFile = new DDFile(path);
+    if(!mFile->LoadFileView())
+    {
+        dsprintf("ERROR: Failed to stream. Couldn't read [%s].\n", path);
+        Close();
+        return false;
+    }
+
+    WaveDecoder::Chunks chunks;
+    if(!WaveDecoder::FindChunks(mFile->Buffer(), mFile->Size(), path, &chunks))
+    {
+        Close();
+        return false;
+    }
+
+    if(WaveDecoder::IsCompressed(chunks))
+    {
+        dsprintf("ERROR: Failed to stream [%s]. Only PCM waves can stream.\n", path);
+        Close();
+        return false;
+    }
+
+    mData = chunks.data;
+    mDataSize = chunks.dataSize;
+    mCursor = 0;
+    mBlockAlign = chunks.blockAlign;
+    mFormat = Wave::Format(chunks.channels, chunks.bitsPerSample);
+    mFrequency = (ALsizei) chunks.frequency;
+    return true;
+}
+
+unsigned int WaveStream::Read(char* out, unsigned int maxBytes)
+{
+    unsigned int bytes = mDataSize - mCursor;
+    if(bytes > maxBytes)
+    {
+        bytes = maxBytes - (maxBytes % mBlockAlign);
+    }
+
+    memcpy(out, mData + mCursor, bytes);
+    mCursor += bytes;
+    return bytes;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef WAVESTREAM_H
+#define WAVESTREAM_H
+
+#include <AL/al.h>
+
+class DDFile;
+
+//
+// Reads the samples of a PCM wave file a piece at a time, for streaming
+// into a queue of OpenAL buffers. The file is viewed rather than copied,
+// so a mapped file is only paged in as it's played.
+//
+class WaveStream
+{
+    DDFile* mFile;
+    const char* mData;
+    unsigned int mDataSize;
+    unsigned int mCursor;
+    unsigned int mBlockAlign;
+    ALenum mFormat;
+    ALsizei mFrequency;
+public:
+    WaveStream();
+    ~WaveStream();
+
+    bool Open(const char* path);
+    void Close();
+
+    // Copies up to maxBytes of samples, whole frames only.
+    // Returns 0 at the end of the data.
+    unsigned int Read(char* out, unsigned int maxBytes);
+    void Rewind() { mCursor = 0; }
+
+    ALenum Format() const { return mFormat; }
+    ALsizei Frequency() const { return mFrequency; }
+private:
+    WaveStream(const WaveStream&);
+    WaveStream& operator=(const WaveStream&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,188 @@
+import struct
+import sys
+#
+# Bake a TTF into a .ddfont that Dinodeck loads without FreeType.
+#
+# usage: python bake_font.py <font.ttf> <output.ddfont> [--charset file] [--sdf]
+#
+# Needs freetype-py (pip install freetype-py). Glyphs are rasterized at the
+# same 72 pixel size FTGL fonts use, so text lays out the same either way.
+# The charset file is UTF-8 text, every character in it is baked. Without
+# it printable ASCII is baked. --sdf stores a distance field instead of
+# coverage, draw it with the renderer's distance field shader.
+# Point the manifest's font path at the .ddfont to use it.
+#
+
+import freetype
+
+VERSION = 1
+FLAG_DISTANCE_FIELD = 1
+FACE_SIZE = 72
+PADDING = 2
+SDF_SPREAD = 8
+HEADER_FORMAT = "<4sIIfIIII"
+GLYPH_FORMAT = "<I10f"
+KERN_FORMAT = "<IIf"
+
+def distance_field(width, height, alpha):
+    # Brute force but offline, the spread keeps the search small.
+    inside = [alpha[i] >= 128 for i in range(width * height)]
+    out = bytearray(width * height)
+    for y in range(height):
+        for x in range(width):
+            here = inside[y * width + x]
+            best = SDF_SPREAD * SDF_SPREAD
+            for dy in range(-SDF_SPREAD, SDF_SPREAD + 1):
+                sy = y + dy
+                for dx in range(-SDF_SPREAD, SDF_SPREAD + 1):
+                    sx = x + dx
+                    if 0 <= sx < width and 0 <= sy < height:
+                        other = inside[sy * width + sx]
+                    else:
+                        other = False
+                    if other != here:
+                        best = min(best, dx * dx + dy * dy)
+            distance = min(best ** 0.5, SDF_SPREAD) / SDF_SPREAD
+            value = 0.5 + (distance if here else -distance) * 0.5
+            out[y * width + x] = int(max(0.0, min(1.0, value)) * 255)
+    return out
+
+def render_glyphs(face, code_points, sdf):
+    border = SDF_SPREAD if sdf else 0
+    glyphs = []
+    for code_point in code_points:
+        if face.get_char_index(code_point) == 0:
+            continue
+        face.load_char(code_point, freetype.FT_LOAD_RENDER)
+        slot = face.glyph
+        bitmap = slot.bitmap
+        width = bitmap.width + border * 2
+        height = bitmap.rows + border * 2
+        alpha = bytearray(width * height)
+        for row in range(bitmap.rows):
+            start = row * bitmap.pitch
+            line = bitmap.buffer[start:start + bitmap.width]
+            write = (row + border) * width + border
+            alpha[write:write + bitmap.width] = bytearray(line)
+        if sdf and bitmap.width > 0:
+            alpha = distance_field(width, height, alpha)
+        glyphs.append({
+            "code_point": code_point,
+            "advance": slot.advance.x / 64.0,
+            "ink": bitmap.width,
+            "left": slot.bitmap_left - border,
+            "top": slot.bitmap_top + border,
+            "width": width if bitmap.width > 0 else 0,
+            "height": height if bitmap.rows > 0 else 0,
+            "alpha": alpha,
+        })
+    return glyphs
+
+def pack_shelves(glyphs, atlas_width):
+    # Tallest first onto shelves, returns the atlas height needed.
+    x = PADDING
+    y = PADDING
+    shelf = 0
+    for glyph in sorted(glyphs, key=lambda g: -g["height"]):
+        if glyph["width"] == 0:
+            glyph["x"] = glyph["y"] = 0
+            continue
+        if x + glyph["width"] + PADDING > atlas_width:
+            x = PADDING
+            y += shelf + PADDING
+            shelf = 0
+        glyph["x"] = x
+        glyph["y"] = y
+        x += glyph["width"] + PADDING
+        shelf = max(shelf, glyph["height"])
+    return y + shelf + PADDING
+
+def next_power_of_two(value):
+    size = 1
+    while size < value:
+        size *= 2
+    return size
+
+def write_font(output, face, glyphs, sdf):
+    atlas_width = 256
+    while True:
+        atlas_height = next_power_of_two(pack_shelves(glyphs, atlas_width))
+        if atlas_height <= atlas_width:
+            break
+        atlas_width *= 2
+    if atlas_width > 4096:
+        raise ValueError("Glyphs don't fit in a 4096 atlas, bake fewer.")
+
+    atlas = bytearray(atlas_width * atlas_height)
+    for glyph in glyphs:
+        for row in range(glyph["height"]):
+            read = row * glyph["width"]
+            write = (glyph["y"] + row) * atlas_width + glyph["x"]
+            atlas[write:write + glyph["width"]] = glyph["alpha"][read:read + glyph["width"]]
+
+    code_points = [g["code_point"] for g in glyphs]
+    kerns = []
+    if face.has_kerning:
+        indices = [(c, face.get_char_index(c)) for c in code_points]
+        for current, current_index in indices:
+            for following, following_index in indices:
+                kerning = face.get_kerning(current_index, following_index, freetype.FT_KERNING_UNFITTED)
+                if kerning.x != 0:
+                    kerns.append((current, following, kerning.x / 64.0))
+
+    line_height = face.size.height / 64.0
+    flags = FLAG_DISTANCE_FIELD if sdf else 0
+    with open(output, "wb") as f:
+        f.write(struct.pack(HEADER_FORMAT, b"DDBF", VERSION, flags, line_height,
+                            atlas_width, atlas_height, len(glyphs), len(kerns)))
+        for glyph in sorted(glyphs, key=lambda g: g["code_point"]):
+            # Quads are from the pen with y up, v is 0 at the atlas' top row.
+            left = float(glyph["left"])
+            top = float(glyph["top"])
+            f.write(struct.pack(GLYPH_FORMAT,
+                                glyph["code_point"],
+                                glyph["advance"],
+                                float(glyph["ink"]),
+                                left,
+                                top,
+                                left + glyph["width"],
+                                top - glyph["height"],
+                                glyph["x"] / float(atlas_width),
+                                glyph["y"] / float(atlas_height),
+                                (glyph["x"] + glyph["width"]) / float(atlas_width),
+                                (glyph["y"] + glyph["height"]) / float(atlas_height)))
+        for current, following, amount in sorted(kerns):
+            f.write(struct.pack(KERN_FORMAT, current, following, amount))
+        f.write(atlas)
+    print("Baked %d glyphs, %d kerning pairs, %dx%d atlas into %s." %
+          (len(glyphs), len(kerns), atlas_width, atlas_height, output))
+
+def main(argv):
+    sdf = "--sdf" in argv
+    args = [a for a in argv if a != "--sdf"]
+    charset = None
+    if "--charset" in args:
+        index = args.index("--charset")
+        if index + 1 >= len(args):
+            print("--charset needs a file.")
+            return 1
+        with open(args[index + 1], "rb") as f:
+            charset = f.read().decode("utf-8")
+        del args[index:index + 2]
+    if len(args) < 2:
+        print("usage: python bake_font.py <font.ttf> <output.ddfont> [--charset file] [--sdf]")
+        return 1
+
+    if charset is None:
+        code_points = list(range(32, 127))
+    else:
+        code_points = sorted(set(ord(c) for c in charset if c not in "\r\n"))
+
+    face = freetype.Face(args[0])
+    face.set_pixel_sizes(0, FACE_SIZE)
+    glyphs = render_glyphs(face, code_points, sdf)
+    write_font(args[1], face, glyphs, sdf)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
\ No newline at end of file
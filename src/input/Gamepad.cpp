@@ -0,0 +1,149 @@
+#include "Gamepad.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#include "../DinodeckLua.h"
+#include "../Game.h"
+#include "../LuaState.h"
+
+Reflect Gamepad::Meta("Gamepad", Gamepad::Bind);
+
+Gamepad::Gamepad() :
+    mCount(0)
+{
+    for(unsigned int i = 0; i < MAX_PADS; i++)
+    {
+        mPads[i].connected = false;
+        mPads[i].axisCount = 0;
+        mPads[i].buttonCount = 0;
+        std::fill(mPads[i].axes, mPads[i].axes + MAX_AXES, 0.0f);
+    }
+}
+
+void Gamepad::Connect(unsigned int pad,
+                      const char* name,
+                      unsigned int axisCount,
+                      unsigned int buttonCount)
+{
+    assert(pad < MAX_PADS);
+    Pad& p = mPads[pad];
+    p.connected = true;
+    p.name = name ? name : "";
+    p.axisCount = std::min(axisCount, MAX_AXES);
+    p.buttonCount = std::min(buttonCount, MAX_BUTTONS);
+    mCount = std::max(mCount, pad + 1);
+}
+
+void Gamepad::SetAxis(unsigned int pad, unsigned int axis, float value)
+{
+    assert(pad < MAX_PADS);
+    if(axis < mPads[pad].axisCount)
+    {
+        mPads[pad].axes[axis] = std::max(-1.0f, std::min(value, 1.0f));
+    }
+}
+
+void Gamepad::SetButton(unsigned int pad, unsigned int button, bool down)
+{
+    assert(pad < MAX_PADS);
+    if(button < mPads[pad].buttonCount)
+    {
+        mPads[pad].buttons[button].Update(down);
+    }
+}
+
+static Gamepad* GetGamepad(lua_State* state)
+{
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    assert(game);
+    return game->GetGamepad();
+}
+
+static const Gamepad::Pad* CheckPad(lua_State* state, int index)
+{
+    Gamepad* gamepad = GetGamepad(state);
+    int pad = luaL_checkinteger(state, index);
+    if(pad < 1 || pad > (int) gamepad->Count())
+    {
+        luaL_argerror(state, index, "Expected 1 to Gamepad.GetCount()");
+        return NULL;
+    }
+    return &gamepad->GetPad(pad - 1);
+}
+
+static int lua_Gamepad_GetCount(lua_State* state)
+{
+    lua_pushinteger(state, GetGamepad(state)->Count());
+    return 1;
+}
+
+static int lua_Gamepad_GetName(lua_State* state)
+{
+    lua_pushstring(state, CheckPad(state, 1)->name.c_str());
+    return 1;
+}
+
+// Gamepad.GetState(pad, [out]) returns a flat table of the pad's axes,
+// -1 to 1, followed by its buttons: 0 up, 1 held, 2 just pressed and
+// 3 just released. The axis and button counts are returned after it.
+// Pass last frame's table back in to have it refilled.
+static int lua_Gamepad_GetState(lua_State* state)
+{
+    const Gamepad::Pad* pad = CheckPad(state, 1);
+    const int count = pad->axisCount + pad->buttonCount;
+
+    if(lua_istable(state, 2))
+    {
+        lua_settop(state, 2);
+        for(int i = (int) lua_objlen(state, 2); i > count; i--)
+        {
+            lua_pushnil(state);
+            lua_rawseti(state, 2, i);
+        }
+    }
+    else
+    {
+        lua_settop(state, 1);
+        lua_createtable(state, count, 0);
+    }
+
+    int slot = 1;
+    for(unsigned int i = 0; i < pad->axisCount; i++)
+    {
+        lua_pushnumber(state, pad->axes[i]);
+        lua_rawseti(state, -2, slot++);
+    }
+
+    for(unsigned int i = 0; i < pad->buttonCount; i++)
+    {
+        const Button& button = pad->buttons[i];
+        int value = button.mJustPressed ? 2
+                  : button.mJustReleased ? 3
+                  : button.mIsDown ? 1
+                  : 0;
+        lua_pushinteger(state, value);
+        lua_rawseti(state, -2, slot++);
+    }
+
+    lua_pushinteger(state, pad->axisCount);
+    lua_pushinteger(state, pad->buttonCount);
+    return 3;
+}
+
+static const struct luaL_reg luaBinding [] =
+{
+    {"GetCount", lua_Gamepad_GetCount},
+    {"GetName", lua_Gamepad_GetName},
+    {"GetState", lua_Gamepad_GetState},
+    {NULL, NULL}  /* sentinel */
+};
+
+void Gamepad::Bind(LuaState* state)
+{
+    state->Bind
+    (
+        Gamepad::Meta.Name(),
+        luaBinding
+    );
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef GAMEPAD_H
+#define GAMEPAD_H
+
+#include <string>
+
+#include "../reflect/Reflect.h"
+#include "Button.h"
+
+class LuaState;
+
+//
+// A snapshot of every pad's axes and buttons, taken once a frame by the
+// platform, so scripts read it all in one call rather than per button.
+//
+class Gamepad
+{
+    public: static Reflect Meta;
+    public:
+        static const unsigned int MAX_PADS = 4;
+        static const unsigned int MAX_AXES = 8;
+        static const unsigned int MAX_BUTTONS = 32;
+
+        struct Pad
+        {
+            bool connected;
+            std::string name;
+            unsigned int axisCount;
+            unsigned int buttonCount;
+            float axes[MAX_AXES]; // -1 to 1
+            Button buttons[MAX_BUTTONS];
+        };
+
+        static void Bind(LuaState* state);
+        Gamepad();
+
+        // For the platform. Counts past the maximums are clamped.
+        void Connect(unsigned int pad,
+                     const char* name,
+                     unsigned int axisCount,
+                     unsigned int buttonCount);
+        void SetAxis(unsigned int pad, unsigned int axis, float value);
+        // Call for every button every frame, the just pressed and
+        // released flags come from the change.
+        void SetButton(unsigned int pad, unsigned int button, bool down);
+
+        unsigned int Count() const { return mCount; }
+        const Pad& GetPad(unsigned int pad) const { return mPads[pad]; }
+    private:
+        Pad mPads[MAX_PADS];
+        unsigned int mCount; // connected pads are 0 to mCount - 1
+};
+
+#endif
\ No newline at end of file
@@ -16,25 +16,34 @@ Keyboard::Keyboard()
 };
 
 // Should be done once frame
+// Only the keys that changed need their flags cleared.
 void Keyboard::Update()
 {
-    for(int i = 0; i < KEY_LAST; i++ )
+    for(std::vector<int>::iterator it = mDirty.begin(); it != mDirty.end(); ++it)
     {
-        mButton[i].mJustPressed = false;
-        mButton[i].mJustReleased = false;
+        mButton[*it].mJustPressed = false;
+        mButton[*it].mJustReleased = false;
     }
+    mDirty.clear();
+    mEvents.clear();
 }
 
 void Keyboard::OnKeyDownEvent(int key)
 {
-    assert(key < KEY_LAST);
+    assert(key >= 0 && key < KEY_LAST);
     mButton[key].Update(true);
+    mDirty.push_back(key);
+    Event event = { key, true };
+    mEvents.push_back(event);
 }
 
 void Keyboard::OnKeyUpEvent(int key)
 {
-    assert(key < KEY_LAST);
+    assert(key >= 0 && key < KEY_LAST);
     mButton[key].Update(false);
+    mDirty.push_back(key);
+    Event event = { key, false };
+    mEvents.push_back(event);
 }
 
 bool Keyboard::IsButtonHeld(int key) const
@@ -79,11 +88,44 @@ static int lua_Keyboard_Held(lua_State* state)
     return 1;
 }
 
+// Keyboard.GetEvents([out]) returns this frame's key changes in the order
+// they happened, as pairs { key, pressed, key, pressed, ... }. Pass last
+// frame's table back in to have it refilled rather than a new one made.
+static int lua_Keyboard_GetEvents(lua_State* state)
+{
+    const std::vector<Keyboard::Event>& events = gKeyboard->Events();
+    const int count = (int) events.size() * 2;
+
+    if(lua_istable(state, 1))
+    {
+        lua_settop(state, 1);
+        for(int i = (int) lua_objlen(state, 1); i > count; i--)
+        {
+            lua_pushnil(state);
+            lua_rawseti(state, 1, i);
+        }
+    }
+    else
+    {
+        lua_createtable(state, count, 0);
+    }
+
+    for(unsigned int i = 0; i < events.size(); i++)
+    {
+        lua_pushinteger(state, events[i].key);
+        lua_rawseti(state, -2, i * 2 + 1);
+        lua_pushboolean(state, events[i].pressed);
+        lua_rawseti(state, -2, i * 2 + 2);
+    }
+    return 1;
+}
+
 static const struct luaL_reg luaBinding [] =
 {
     {"JustPressed",     lua_Keyboard_JustPressed},
     {"JustReleased",    lua_Keyboard_JustReleased},
-    {"Held",            lua_Keyboard_Held},
+    {"Held",            lua_Keyboard_Held},
+    {"GetEvents",       lua_Keyboard_GetEvents},
     {NULL, NULL}  /* sentinel */
 };
 
@@ -1,6 +1,8 @@
 #ifndef KEYBOARD_H
 #define KEYBOARD_H
 
+#include <vector>
+
 #include "../reflect/Reflect.h"
 #include "Button.h"
 #include "Keys.h"
@@ -12,8 +14,16 @@ class LuaState;
 class Keyboard
 {
     public: static Reflect Meta;
+public:
+    struct Event
+    {
+        int key;
+        bool pressed;
+    };
 private:
     Button mButton[KEY_LAST];
+    std::vector<int> mDirty; // keys changed this frame, reset on Update
+    std::vector<Event> mEvents; // this frame's, in the order they came
 public:
     static void Bind(LuaState* state);
     Keyboard();
@@ -22,7 +32,8 @@ public:
     void OnKeyUpEvent(int key);
     bool IsButtonHeld(int key) const;
     bool IsButtonJustPressed(int key) const;
-    bool IsButtonJustReleased(int key) const;
+    bool IsButtonJustReleased(int key) const;
+    const std::vector<Event>& Events() const { return mEvents; }
 };
 
 #endif
\ No newline at end of file
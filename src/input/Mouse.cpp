@@ -105,7 +105,7 @@ static int lua_Mouse_Held(lua_State* state)
 // Or a new vector will be created and passed back
 static int lua_Mouse_Position(lua_State* state)
 {
-    if(lua_isuserdata(state, 1) && luaL_checkudata (state, 1, "Vector"))
+    if(LuaState::IsType<Vector>(state, 1))
     {
         Vector* vector = (Vector*)lua_touserdata(state, 1);
         if(vector == NULL)
@@ -127,7 +127,7 @@ static int lua_Mouse_Position(lua_State* state)
 
 static int lua_Mouse_PrevPosition(lua_State* state)
 {
-    if(lua_isuserdata(state, 1) && luaL_checkudata (state, 1, "Vector"))
+    if(LuaState::IsType<Vector>(state, 1))
     {
         Vector* vector = (Vector*)lua_touserdata(state, 1);
         if(vector == NULL)
@@ -147,7 +147,7 @@ static int lua_Mouse_PrevPosition(lua_State* state)
 
 static int lua_Mouse_Difference(lua_State* state)
 {
-    if(lua_isuserdata(state, 1) && luaL_checkudata (state, 1, "Vector"))
+    if(LuaState::IsType<Vector>(state, 1))
     {
         Vector* vector = (Vector*)lua_touserdata(state, 1);
         if(vector == NULL)
@@ -8,28 +8,117 @@
 #include "../LuaState.h"
 #include "../reflect/Reflect.h"
 #include "../Vector.h"
+#include "TouchQueue.h"
 
 Reflect Touch::Meta("Touch", Touch::Bind);
 
-void Touch::Update()
+Touch::Touch() :
+    mCount(0),
+    mQueue(new TouchQueue())
+{
+}
+
+Touch::~Touch()
+{
+    delete mQueue;
+}
+
+void Touch::OnTouchEvent(const TouchMessage& msg)
 {
-    if(mTouchMessage)
+    if(!mQueue->Push(msg))
     {
-        mState = mTouchMessage->mState;
-        mX = mTouchMessage->mX;
-        mY = mTouchMessage->mY;
-        mTouchMessage = NULL;
+        dsprintf("Touch queue full, %u events dropped.\n", mQueue->Dropped());
     }
-    else
+}
+
+void Touch::OnTouchEvents(const TouchMessage* messages, unsigned int count)
+{
+    assert(messages || count == 0);
+    if(mQueue->Push(messages, count) < count)
+    {
+        dsprintf("Touch queue full, %u events dropped.\n", mQueue->Dropped());
+    }
+}
+
+Touch::Pointer* Touch::Find(int id)
+{
+    for(unsigned int i = 0; i < mCount; i++)
     {
-        mState = TouchEvent::None;
+        if(mPointers[i].id == id)
+        {
+            return &mPointers[i];
+        }
     }
+    return NULL;
 }
 
+void Touch::Apply(const TouchMessage& message)
+{
+    Pointer* pointer = Find(message.mId);
+
+    if(message.mState == TouchEvent::Pressed)
+    {
+        if(pointer == NULL || !pointer->down)
+        {
+            if(pointer == NULL)
+            {
+                if(mCount == MAX_POINTERS)
+                {
+                    return;
+                }
+                pointer = &mPointers[mCount++];
+                pointer->id = message.mId;
+                pointer->justReleased = false;
+            }
+            pointer->down = true;
+            pointer->justPressed = true;
+        }
+    }
+    else if(pointer == NULL)
+    {
+        // Went down before there was room, or before this Touch existed.
+        return;
+    }
+    else if(message.mState == TouchEvent::Released)
+    {
+        pointer->down = false;
+        pointer->justReleased = true;
+    }
+
+    pointer->x = message.mX;
+    pointer->y = message.mY;
+}
+
+void Touch::Update()
+{
+    // Fingers lifted last frame go, keeping the rest in the order they
+    // went down.
+    unsigned int kept = 0;
+    for(unsigned int i = 0; i < mCount; i++)
+    {
+        if(!mPointers[i].down)
+        {
+            continue;
+        }
+        mPointers[kept] = mPointers[i];
+        mPointers[kept].justPressed = false;
+        mPointers[kept].justReleased = false;
+        kept++;
+    }
+    mCount = kept;
+    mEvents.clear();
+
+    TouchMessage message;
+    while(mQueue->Pop(&message))
+    {
+        Apply(message);
+        mEvents.push_back(message);
+    }
+}
 
 static int lua_Touch_X(lua_State* state)
 {
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     assert(game);
     Touch* touch = game->GetTouch();
     lua_pushnumber(state, touch->X());
@@ -38,7 +127,7 @@ static int lua_Touch_X(lua_State* state)
 
 static int lua_Touch_Y(lua_State* state)
 {
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     assert(game);
     Touch* touch = game->GetTouch();
     lua_pushnumber(state, touch->Y() * -1);
@@ -47,11 +136,11 @@ static int lua_Touch_Y(lua_State* state)
 
 static int lua_Touch_Position(lua_State* state)
 {
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     assert(game);
     Touch* touch = game->GetTouch();
 
-    if(lua_isuserdata(state, 1) && luaL_checkudata (state, 1, "Vector"))
+    if(LuaState::IsType<Vector>(state, 1))
     {
         Vector* vector = (Vector*)lua_touserdata(state, 1);
         if(vector == NULL)
@@ -74,7 +163,7 @@ static int lua_Touch_Position(lua_State* state)
 static int lua_Touch_JustPressed(lua_State* state)
 {
     //dsprintf("In touch just pressed.\n");
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     //dsprintf("Just got game pointer [%s].\n", game?"non-null":"null");
     assert(game);
     Touch* touch = game->GetTouch();
@@ -88,7 +177,7 @@ static int lua_Touch_JustPressed(lua_State* state)
 
 static int lua_Touch_JustReleased(lua_State* state)
 {
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     assert(game);
     Touch* touch = game->GetTouch();
     lua_pushboolean(state, touch->IsReleased());
@@ -97,13 +186,81 @@ static int lua_Touch_JustReleased(lua_State* state)
 
 static int lua_Touch_Held(lua_State* state)
 {
-    Game* game = (Game*) LuaState::GetFromRegistry(state, "Game");
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
     assert(game);
     Touch* touch = game->GetTouch();
     lua_pushboolean(state, touch->IsHeld());
     return 1;
 }
 
+static int lua_Touch_GetCount(lua_State* state)
+{
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    assert(game);
+    lua_pushinteger(state, game->GetTouch()->Count());
+    return 1;
+}
+
+// Touch.GetTouch(index) returns id, x, y, justPressed, justReleased for
+// the index'th finger, 1 to GetCount(), in the order they went down.
+// Released fingers are still there the frame they come up.
+static int lua_Touch_GetTouch(lua_State* state)
+{
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    assert(game);
+    Touch* touch = game->GetTouch();
+    int index = luaL_checkinteger(state, 1);
+
+    if(index < 1 || index > (int) touch->Count())
+    {
+        return luaL_argerror(state, 1, "Expected 1 to Touch.GetCount()");
+    }
+
+    const Touch::Pointer& pointer = touch->GetPointer(index - 1);
+    lua_pushinteger(state, pointer.id);
+    lua_pushnumber(state, pointer.x);
+    lua_pushnumber(state, pointer.y * -1);
+    lua_pushboolean(state, pointer.justPressed);
+    lua_pushboolean(state, pointer.justReleased);
+    return 5;
+}
+
+static int lua_Touch_GetEventCount(lua_State* state)
+{
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    assert(game);
+    lua_pushinteger(state, game->GetTouch()->EventCount());
+    return 1;
+}
+
+// Touch.GetEvent(index) returns "pressed", "released" or "moving", id, x
+// and y for the index'th event this frame, 1 to GetEventCount(), in the
+// order they happened.
+static int lua_Touch_GetEvent(lua_State* state)
+{
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    assert(game);
+    Touch* touch = game->GetTouch();
+    int index = luaL_checkinteger(state, 1);
+
+    if(index < 1 || index > (int) touch->EventCount())
+    {
+        return luaL_argerror(state, 1, "Expected 1 to Touch.GetEventCount()");
+    }
+
+    const TouchMessage& event = touch->GetEvent(index - 1);
+    switch(event.mState)
+    {
+        case TouchEvent::Pressed: lua_pushstring(state, "pressed"); break;
+        case TouchEvent::Released: lua_pushstring(state, "released"); break;
+        default: lua_pushstring(state, "moving"); break;
+    }
+    lua_pushinteger(state, event.mId);
+    lua_pushnumber(state, event.mX);
+    lua_pushnumber(state, event.mY * -1);
+    return 4;
+}
+
 static const struct luaL_reg luaBinding [] =
 {
     {"X", lua_Touch_X},
@@ -112,6 +269,10 @@ static const struct luaL_reg luaBinding [] =
     {"JustPressed", lua_Touch_JustPressed},
     {"JustReleased", lua_Touch_JustReleased},
     {"Held", lua_Touch_Held},
+    {"GetCount", lua_Touch_GetCount},
+    {"GetTouch", lua_Touch_GetTouch},
+    {"GetEventCount", lua_Touch_GetEventCount},
+    {"GetEvent", lua_Touch_GetEvent},
     {NULL, NULL}  /* sentinel */
 };
 
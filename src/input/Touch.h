@@ -1,9 +1,12 @@
 #ifndef TOUCH_H
 #define TOUCH_H
 
+#include <vector>
+
 #include "../reflect/Reflect.h"
 
 class LuaState;
+class TouchQueue;
 
 namespace TouchEvent
 {
@@ -19,34 +22,63 @@ namespace TouchEvent
 struct TouchMessage
 {
     TouchEvent::Enum mState;
+    int mId; // the platform's pointer id, stays the same while it's down
     float mX;
     float mY;
 };
 
-// If we do multitouch, a seperate module is probably best
-// GetNumTouches or something like that? Using a key to get data
-
+//
+// Up to MAX_POINTERS fingers at once. The platform pushes events from
+// its own thread and they're applied in order on Update, so nothing is
+// lost when several arrive between frames.
+//
+// X, Y and the single touch calls follow the first finger down.
+// Every event applied this frame is kept too, for gestures that need
+// the path between frames and not only where the fingers ended up.
+//
 class Touch
 {
 public: static Reflect Meta;
+public:
+    static const unsigned int MAX_POINTERS = 10;
 
+    struct Pointer
+    {
+        int id;
+        float x;
+        float y;
+        bool down;
+        bool justPressed;
+        bool justReleased;
+    };
 private:
-    TouchEvent::Enum mState;
-    float mX;
-    float mY;
-    TouchMessage* mTouchMessage;
+    Pointer mPointers[MAX_POINTERS];
+    unsigned int mCount; // in use, down or released this frame
+    TouchQueue* mQueue;
+    std::vector<TouchMessage> mEvents; // applied this frame, in order
+
+    Pointer* Find(int id);
+    void Apply(const TouchMessage& message);
 public:
     static void Bind(LuaState* state);
 
-    Touch() :
-        mState(TouchEvent::None), mX(0), mY(0), mTouchMessage(NULL) {}
+    Touch();
+    ~Touch();
 
-    float X() const { return mX; }
-    float Y() const { return mY; }
-    void OnTouchEvent(TouchMessage& msg) { mTouchMessage = &msg; }
+    // Thread safe for a single platform thread.
+    void OnTouchEvent(const TouchMessage& msg);
+    void OnTouchEvents(const TouchMessage* messages, unsigned int count);
     void Update();
-    bool IsPressed() { return mState == TouchEvent::Pressed; }
-    bool IsReleased() { return mState == TouchEvent::Released; }
-    bool IsHeld() { return mState == TouchEvent::Moving; }
+
+    unsigned int Count() const { return mCount; }
+    const Pointer& GetPointer(unsigned int index) const { return mPointers[index]; }
+    unsigned int EventCount() const { return mEvents.size(); }
+    const TouchMessage& GetEvent(unsigned int index) const { return mEvents[index]; }
+
+    float X() const { return mCount > 0 ? mPointers[0].x : 0; }
+    float Y() const { return mCount > 0 ? mPointers[0].y : 0; }
+    bool IsPressed() const { return mCount > 0 && mPointers[0].justPressed; }
+    bool IsReleased() const { return mCount > 0 && mPointers[0].justReleased; }
+    bool IsHeld() const { return mCount > 0 && mPointers[0].down && !mPointers[0].justPressed; }
 };
-#endif
+#endif
\ No newline at end of file
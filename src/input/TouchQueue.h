@@ -0,0 +1,79 @@
+#ifndef TOUCHQUEUE_H
+#define TOUCHQUEUE_H
+
+#include "Touch.h"
+
+//
+// Touch events from the platform's UI thread to the game thread.
+// One thread pushes and one pops, so each index is only written by one
+// side and a barrier between the copy and the index write is all the
+// syncing needed.
+//
+class TouchQueue
+{
+public:
+    // A power of two. Android passes on the samples between frames too,
+    // so a fast gesture with a few fingers can add dozens a frame.
+    static const unsigned int CAPACITY = 1024;
+private:
+    TouchMessage mMessages[CAPACITY];
+    volatile unsigned int mHead; // next to pop, written by the consumer
+    volatile unsigned int mTail; // next to push, written by the producer
+    volatile unsigned int mDropped; // producer side, pushes that found it full
+public:
+    TouchQueue() : mHead(0), mTail(0), mDropped(0) {}
+
+    // Producer only. False if the game's fallen CAPACITY events behind.
+    bool Push(const TouchMessage& message)
+    {
+        const unsigned int tail = mTail;
+        if(tail - mHead == CAPACITY)
+        {
+            mDropped = mDropped + 1;
+            return false;
+        }
+        mMessages[tail & (CAPACITY - 1)] = message;
+        __sync_synchronize(); // the message lands before the consumer sees it
+        mTail = tail + 1;
+        return true;
+    }
+
+    // Producer only. Pushes as many as fit and publishes them together,
+    // returns how many went in.
+    unsigned int Push(const TouchMessage* messages, unsigned int count)
+    {
+        const unsigned int tail = mTail;
+        const unsigned int space = CAPACITY - (tail - mHead);
+        const unsigned int pushed = count < space ? count : space;
+        for(unsigned int i = 0; i < pushed; i++)
+        {
+            mMessages[(tail + i) & (CAPACITY - 1)] = messages[i];
+        }
+        __sync_synchronize(); // the messages land before the consumer sees them
+        mTail = tail + pushed;
+        if(pushed < count)
+        {
+            mDropped = mDropped + (count - pushed);
+        }
+        return pushed;
+    }
+
+    // Consumer only.
+    bool Pop(TouchMessage* out)
+    {
+        const unsigned int head = mHead;
+        if(head == mTail)
+        {
+            return false;
+        }
+        __sync_synchronize(); // read the message the tail was published for
+        *out = mMessages[head & (CAPACITY - 1)];
+        __sync_synchronize(); // done reading before the slot's given back
+        mHead = head + 1;
+        return true;
+    }
+
+    unsigned int Dropped() const { return mDropped; }
+};
+
+#endif
\ No newline at end of file
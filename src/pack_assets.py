@@ -0,0 +1,164 @@
+import os
+import re
+import struct
+import sys
+#
+# Pack a game's assets into a single .ddpak file.
+#
+# usage: python pack_assets.py <game dir> [output] [--store]
+#
+# The pack holds settings.lua, the manifest and every path the manifest
+# lists. Dinodeck mounts data.ddpak from the working directory at start up.
+# Entries are LZ4 compressed when it saves space, --store turns that off so
+# every entry can be read straight out of the mapping.
+#
+
+VERSION = 1
+DATA_ALIGNMENT = 16
+FLAG_LZ4 = 1
+HEADER_FORMAT = "<4s7I"
+ENTRY_FORMAT = "<8I"
+
+def hash_name(name):
+    # Must match Field::HashName, 32 bit FNV-1a.
+    h = 2166136261
+    for b in name.encode("utf-8"):
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+def strip_comments(source):
+    source = re.sub(r"--\[\[.*?\]\]", "", source, flags=re.S)
+    return re.sub(r"--[^\n]*", "", source)
+
+def read_string_setting(source, name):
+    match = re.search(r"\b" + name + r"\s*=\s*[\"']([^\"']+)[\"']", strip_comments(source))
+    return match.group(1) if match else None
+
+def manifest_paths(source):
+    return re.findall(r"\bpath\s*=\s*[\"']([^\"']+)[\"']", strip_comments(source))
+
+def lz4_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+def lz4_sequence(out, literals, offset, match_length):
+    token_literals = min(len(literals), 15)
+    token_match = 0 if offset == 0 else min(match_length - 4, 15)
+    out.append((token_literals << 4) | token_match)
+    if len(literals) >= 15:
+        lz4_length(out, len(literals) - 15)
+    out += literals
+    if offset == 0:
+        return
+    out += struct.pack("<H", offset)
+    if match_length - 4 >= 15:
+        lz4_length(out, match_length - 4 - 15)
+
+def lz4_compress(data):
+    # Greedy LZ4 block compressor. The format requires the last five bytes
+    # to be literals and no match to start within twelve bytes of the end.
+    out = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+    limit = len(data) - 12
+    while i < limit:
+        key = data[i:i + 4]
+        candidate = table.get(key)
+        table[key] = i
+        if candidate is None or i - candidate > 0xFFFF:
+            i += 1
+            continue
+        length = 4
+        max_length = len(data) - 5 - i
+        while length < max_length and data[candidate + length] == data[i + length]:
+            length += 1
+        lz4_sequence(out, data[anchor:i], i - candidate, length)
+        i += length
+        anchor = i
+    lz4_sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+def align(value):
+    return (value + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1)
+
+def write_pack(game_dir, names, output, compress):
+    entries = []
+    for name in names:
+        with open(os.path.join(game_dir, name), "rb") as f:
+            data = f.read()
+        stored = data
+        flags = 0
+        if compress and len(data) > 0:
+            packed = lz4_compress(data)
+            # Only worth a decode if it saves an eighth.
+            if len(packed) < len(data) - (len(data) // 8):
+                stored = packed
+                flags = FLAG_LZ4
+        entries.append((hash_name(name), name, flags, data, stored))
+
+    entries.sort(key=lambda e: (e[0], e[1]))
+
+    names_block = bytearray()
+    name_offsets = []
+    for entry in entries:
+        name_offsets.append(len(names_block))
+        names_block += entry[1].encode("utf-8") + b"\0"
+
+    toc_offset = struct.calcsize(HEADER_FORMAT)
+    names_offset = toc_offset + struct.calcsize(ENTRY_FORMAT) * len(entries)
+    data_offset = align(names_offset + len(names_block))
+
+    toc = bytearray()
+    body = bytearray()
+    for entry, name_offset in zip(entries, name_offsets):
+        body += b"\0" * (align(len(body)) - len(body))
+        stored = entry[4]
+        toc += struct.pack(ENTRY_FORMAT, entry[0], name_offset, entry[2],
+                           data_offset + len(body), len(stored), len(entry[3]), 0, 0)
+        body += stored
+
+    header = struct.pack(HEADER_FORMAT, b"DDPK", VERSION, len(entries), toc_offset,
+                         names_offset, len(names_block), data_offset, 0)
+    with open(output, "wb") as f:
+        f.write(header)
+        f.write(toc)
+        f.write(names_block)
+        f.write(b"\0" * (data_offset - names_offset - len(names_block)))
+        f.write(body)
+
+    for entry in entries:
+        tag = "lz4" if entry[2] & FLAG_LZ4 else "raw"
+        print("  [%s] %s %d -> %d" % (tag, entry[1], len(entry[3]), len(entry[4])))
+    print("Packed %d entries into [%s]." % (len(entries), output))
+
+def main(argv):
+    compress = "--store" not in argv
+    args = [a for a in argv if a != "--store"]
+    if len(args) < 1:
+        print("usage: python pack_assets.py <game dir> [output] [--store]")
+        return 1
+    game_dir = args[0]
+    output = args[1] if len(args) > 1 else os.path.join(game_dir, "data.ddpak")
+
+    with open(os.path.join(game_dir, "settings.lua")) as f:
+        manifest = read_string_setting(f.read(), "manifest")
+    if manifest is None:
+        print("No manifest entry in settings.lua.")
+        return 1
+
+    names = ["settings.lua", manifest]
+    with open(os.path.join(game_dir, manifest)) as f:
+        for path in manifest_paths(f.read()):
+            path = path.replace("\\", "/")
+            if path not in names:
+                names.append(path)
+
+    write_pack(game_dir, names, output, compress)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
\ No newline at end of file
@@ -0,0 +1,146 @@
+import struct
+import sys
+import zlib
+#
+# Convert PNG textures to QOI, which Dinodeck decodes several times faster.
+#
+# usage: python png_to_qoi.py <input.png> [output.qoi]
+#
+# Handles 8 bit, non interlaced PNGs, which is what image editors save by
+# default. Point the manifest's texture path at the .qoi to use it.
+#
+
+PNG_SIGNATURE = b"\x89PNG\r\n\x1a\n"
+QOI_END = b"\x00\x00\x00\x00\x00\x00\x00\x01"
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa = abs(p - a)
+    pb = abs(p - b)
+    pc = abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+def read_png(data):
+    if data[:8] != PNG_SIGNATURE:
+        raise ValueError("not a PNG")
+    offset = 8
+    idat = bytearray()
+    palette = None
+    transparency = None
+    while offset < len(data):
+        length, kind = struct.unpack(">I4s", data[offset:offset + 8])
+        chunk = data[offset + 8:offset + 8 + length]
+        offset += 12 + length
+        if kind == b"IHDR":
+            width, height, depth, colour, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif kind == b"PLTE":
+            palette = chunk
+        elif kind == b"tRNS":
+            transparency = chunk
+        elif kind == b"IDAT":
+            idat += chunk
+        elif kind == b"IEND":
+            break
+
+    if depth != 8 or interlace != 0:
+        raise ValueError("only 8 bit, non interlaced PNGs are handled")
+    samples = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[colour]
+
+    raw = zlib.decompress(bytes(idat))
+    stride = width * samples
+    previous = bytearray(stride)
+    rows = []
+    position = 0
+    for _ in range(height):
+        kind = raw[position]
+        row = bytearray(raw[position + 1:position + 1 + stride])
+        position += 1 + stride
+        for i in range(stride):
+            left = row[i - samples] if i >= samples else 0
+            up = previous[i]
+            if kind == 1:
+                row[i] = (row[i] + left) & 0xFF
+            elif kind == 2:
+                row[i] = (row[i] + up) & 0xFF
+            elif kind == 3:
+                row[i] = (row[i] + ((left + up) >> 1)) & 0xFF
+            elif kind == 4:
+                corner = previous[i - samples] if i >= samples else 0
+                row[i] = (row[i] + paeth(left, up, corner)) & 0xFF
+        rows.append(row)
+        previous = row
+
+    pixels = []
+    for row in rows:
+        for x in range(width):
+            s = row[x * samples:(x + 1) * samples]
+            if colour == 0:
+                pixels.append((s[0], s[0], s[0], 255))
+            elif colour == 2:
+                pixels.append((s[0], s[1], s[2], 255))
+            elif colour == 3:
+                alpha = transparency[s[0]] if transparency and s[0] < len(transparency) else 255
+                pixels.append((palette[s[0] * 3], palette[s[0] * 3 + 1], palette[s[0] * 3 + 2], alpha))
+            elif colour == 4:
+                pixels.append((s[0], s[0], s[0], s[1]))
+            else:
+                pixels.append((s[0], s[1], s[2], s[3]))
+
+    has_alpha = colour in (4, 6) or transparency is not None
+    return width, height, (4 if has_alpha else 3), pixels
+
+def encode_qoi(width, height, channels, pixels):
+    out = bytearray(struct.pack(">4sIIBB", b"qoif", width, height, channels, 0))
+    index = [(0, 0, 0, 0)] * 64
+    previous = (0, 0, 0, 255)
+    run = 0
+    for i, px in enumerate(pixels):
+        if px == previous:
+            run += 1
+            if run == 62 or i == len(pixels) - 1:
+                out.append(0xC0 | (run - 1))
+                run = 0
+            continue
+        if run > 0:
+            out.append(0xC0 | (run - 1))
+            run = 0
+
+        slot = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64
+        if index[slot] == px:
+            out.append(slot)
+        elif px[3] == previous[3]:
+            dr = (px[0] - previous[0] + 128) % 256 - 128
+            dg = (px[1] - previous[1] + 128) % 256 - 128
+            db = (px[2] - previous[2] + 128) % 256 - 128
+            if -2 <= dr <= 1 and -2 <= dg <= 1 and -2 <= db <= 1:
+                out.append(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2))
+            elif -32 <= dg <= 31 and -8 <= dr - dg <= 7 and -8 <= db - dg <= 7:
+                out.append(0x80 | (dg + 32))
+                out.append(((dr - dg + 8) << 4) | (db - dg + 8))
+            else:
+                out += bytes((0xFE, px[0], px[1], px[2]))
+        else:
+            out += bytes((0xFF, px[0], px[1], px[2], px[3]))
+        index[slot] = px
+        previous = px
+    out += QOI_END
+    return bytes(out)
+
+def main(argv):
+    if len(argv) < 1:
+        print("usage: python png_to_qoi.py <input.png> [output.qoi]")
+        return 1
+    source = argv[0]
+    output = argv[1] if len(argv) > 1 else source.rsplit(".", 1)[0] + ".qoi"
+    with open(source, "rb") as f:
+        width, height, channels, pixels = read_png(f.read())
+    qoi = encode_qoi(width, height, channels, pixels)
+    with open(output, "wb") as f:
+        f.write(qoi)
+    print("[%s] %dx%d, %d channels -> [%s] %d bytes." % (source, width, height, channels, output, len(qoi)))
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
\ No newline at end of file
@@ -9,17 +9,32 @@
 class Field
 {
 public:
+    // FNV-1a, names are hashed once so lookups compare ints first.
+    static unsigned int HashName(const char* name)
+    {
+        unsigned int hash = 2166136261u;
+        for(; *name; name++)
+        {
+            hash ^= (unsigned char) *name;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
     virtual ~Field() {}
     const char* Name() const { return mName; }
+    unsigned int Hash() const { return mHash; }
     // This could be reflect ... probably!
     virtual std::string ToString(void* instance) const = 0;
     virtual void* GetPtr(void* instance) { return NULL; }
     virtual void SetPtr(void* instance, void* value) {}
 protected:
     Field(const char* name)  :
-        mName(name) {}
+        mName(name),
+        mHash(HashName(name)) {}
 private:
     const char* mName;
+    unsigned int mHash;
 };
 
 
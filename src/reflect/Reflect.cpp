@@ -1,41 +1,63 @@
 #include "Reflect.h"
 
-#include <map>
 #include <string>
 #include "../DDLog.h"
+#include "../LuaState.h"
 
 //
 // This is why we can't have nice things, C++.
 // http://www.parashift.com/c++-faq-lite/ctors.html#faq-10.15
 //
-std::map<std::string, Reflect*>& Reflect::Repo()
+std::vector<Reflect*>& Reflect::Repo()
 {
-   static std::map<std::string, Reflect*>* ans = new std::map<std::string, Reflect*>();
+   static std::vector<Reflect*>* ans = new std::vector<Reflect*>();
    return *ans;
 }
 
 Reflect::Reflect(std::string name, void (*luaBindFunc) (LuaState*))
-    : mName(name), mFields(), mStaticLuaBindFunc(luaBindFunc)
+    : mName(name), mHash(Field::HashName(name.c_str())), mFields(), mStaticLuaBindFunc(luaBindFunc)
 {
 
     // Add the class to the repository so it can be looked up by name.
-    Reflect::Repo().insert
-    (
-        std::pair<std::string, Reflect*>(name, this)
-    );
+    // The first registered wins, as it did with the map.
+    if(Reflect::Find(name.c_str()) == NULL)
+    {
+        Reflect::Repo().push_back(this);
+    }
+}
+
+Reflect* Reflect::Find(const char* name)
+{
+    const unsigned int hash = Field::HashName(name);
+    std::vector<Reflect*>& repo = Reflect::Repo();
+    for(std::vector<Reflect*>::iterator iter = repo.begin(); iter != repo.end(); ++iter)
+    {
+        if((*iter)->mHash == hash && (*iter)->mName == name)
+        {
+            return *iter;
+        }
+    }
+    return NULL;
 }
 
 bool Reflect::Bind(const std::string& name, LuaState* state)
 {
     // Get a pointer to the reflection obj
-    std::map<std::string, Reflect*>::iterator iter = Reflect::Repo().find(name);
+    Reflect* reflect = Reflect::Find(name.c_str());
 
-    if(iter == Reflect::Repo().end())
+    if(reflect == NULL)
     {
         return false;
     }
 
-    iter->second->CallBind(state);
+    // Kept through LuaState::Restore, there's nothing to do again.
+    if(state->IsBound(reflect))
+    {
+        return true;
+    }
+
+    reflect->CallBind(state);
+    state->MarkBound(reflect);
 
     return true;
 }
@@ -2,7 +2,7 @@
 #define REFLECT_H
 
 #include <cstdio>
-#include <map>
+#include <string.h>
 #include <string>
 #include <vector>
 
@@ -20,11 +20,14 @@ class Reflect
 {
 private:
     std::string mName;
+    unsigned int mHash;
     std::vector< Field* > mFields;
     void (*mStaticLuaBindFunc) (LuaState*);
 public:
 
-    static std::map<std::string, Reflect*>& Repo();
+    // A flat table, searched by hash. There are only tens of types.
+    static std::vector<Reflect*>& Repo();
+    static Reflect* Find(const char* name);
 
     Reflect(std::string name, void (*) (LuaState*));
 
@@ -53,9 +56,10 @@ public:
 
     Field* GetField(const char* name) const
     {
+        const unsigned int hash = Field::HashName(name);
         for (std::vector<Field*>::const_iterator iter = mFields.begin(); iter != mFields.end(); ++iter)
         {
-            if((*iter)->Name() == name)
+            if((*iter)->Hash() == hash && strcmp((*iter)->Name(), name) == 0)
             {
                 return (*iter);
             }
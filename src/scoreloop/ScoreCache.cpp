@@ -0,0 +1,445 @@
+#include "ScoreCache.h"
+
+#include <algorithm>
+#include <ctime>
+#include <stdio.h>
+
+#include "../DDFile.h"
+#include "../DDLog.h"
+#include "../DDTime.h"
+#include "../DinodeckLua.h"
+#include "../LuaState.h"
+
+#if ANDROID
+#include "AndroidWrapper.h"
+#include "DDLuaCallbacks.h"
+#endif
+
+static const char* CACHE_MAGIC = "DDSC1\n";
+
+bool ScoreCache::Score::Beats(const Score& score) const
+{
+    return primary > score.primary
+        || (primary == score.primary && secondary > score.secondary);
+}
+
+ScoreCache::ScoreCache() :
+    mTtlSeconds(300),
+    mFile(""),
+    mLoaded(false),
+    mSendingMode(-1),
+    mRequestId(0),
+    mBackoffMs(MIN_BACKOFF_MS),
+    mNextAttempt(0)
+{
+}
+
+void ScoreCache::Configure(unsigned int ttlSeconds, const std::string& file)
+{
+    mTtlSeconds = ttlSeconds;
+    if(file != mFile)
+    {
+        mFile = file;
+        mLoaded = false;
+    }
+}
+
+void ScoreCache::Post(int mode, double primary, double secondary,
+                      int successRef, int failureRef)
+{
+    Load();
+    const Score score(primary, secondary);
+    const Callback callback(successRef, failureRef);
+
+    std::map<int, Queued>::iterator unsent = mUnsent.find(mode);
+    if(unsent == mUnsent.end())
+    {
+        std::map<int, Score>::const_iterator best = mBest.find(mode);
+        if(best != mBest.end() && !score.Beats(best->second))
+        {
+            // The board already has better, nothing to send.
+            mReplies.push_back(Reply(callback, true, ""));
+            return;
+        }
+        unsent = mUnsent.insert(std::make_pair(mode, Queued())).first;
+        unsent->second.score = score;
+    }
+    else if(score.Beats(unsent->second.score))
+    {
+        // One in flight still counts, this goes after it if it's better.
+        unsent->second.score = score;
+    }
+
+    unsent->second.waiting.push_back(callback);
+    // Worth trying now even if the last post failed.
+    mNextAttempt = 0;
+    Save();
+}
+
+void ScoreCache::Fetch(int type, int successRef, int failureRef)
+{
+    Load();
+    Board& board = mBoards[type];
+    const Callback callback(successRef, failureRef);
+    const unsigned long long now = (unsigned long long) time(NULL);
+
+    if(board.fetched == 0)
+    {
+        board.waiting.push_back(callback);
+        board.wanted = true;
+        return;
+    }
+
+    mReplies.push_back(Reply(callback, true, board.blob));
+    if(IsStale(board, now) && now >= board.retryAt)
+    {
+        board.wanted = true;
+    }
+}
+
+bool ScoreCache::IsStale(const Board& board, unsigned long long now) const
+{
+    return board.fetched == 0 || now >= board.fetched + mTtlSeconds;
+}
+
+void ScoreCache::Update(LuaState* state)
+{
+    Load();
+
+    // Swapped out first, a callback may ask again.
+    std::vector<Reply> replies;
+    replies.swap(mReplies);
+    for(std::vector<Reply>::iterator it = replies.begin(); it != replies.end(); ++it)
+    {
+        Call(state, it->callback, it->success, it->response);
+    }
+
+    for(std::map<int, Board>::iterator it = mBoards.begin(); it != mBoards.end(); ++it)
+    {
+        if(it->second.wanted && !it->second.fetching)
+        {
+            Request(state, it->first);
+        }
+    }
+
+    if(mSendingMode == -1
+       && !mUnsent.empty()
+       && DDTime::Microseconds() >= mNextAttempt)
+    {
+        Send(state);
+    }
+}
+
+void ScoreCache::Reset()
+{
+    // The callbacks went with the state, the replies are never coming.
+    mRequestId++;
+    mSendingMode = -1;
+    mReplies.clear();
+    for(std::map<int, Board>::iterator it = mBoards.begin(); it != mBoards.end(); ++it)
+    {
+        it->second.waiting.clear();
+        it->second.wanted = false;
+        it->second.fetching = false;
+    }
+    for(std::map<int, Queued>::iterator it = mUnsent.begin(); it != mUnsent.end(); ++it)
+    {
+        it->second.waiting.clear();
+        it->second.sent.clear();
+    }
+}
+
+void ScoreCache::Call(LuaState* state, const Callback& callback, bool success,
+                      const std::string& response)
+{
+    std::string copy(response);
+    state->CallRegisteredFunction(success ? callback.successRef : callback.failureRef, copy);
+    luaL_unref(state->State(), LUA_REGISTRYINDEX, callback.successRef);
+    luaL_unref(state->State(), LUA_REGISTRYINDEX, callback.failureRef);
+}
+
+int ScoreCache::ReplyRef(lua_State* state, int (*onReply)(lua_State*), int key, bool success)
+{
+    lua_pushlightuserdata(state, this);
+    lua_pushinteger(state, mRequestId);
+    lua_pushinteger(state, key);
+    lua_pushboolean(state, success);
+    lua_pushcclosure(state, onReply, 4);
+    return luaL_ref(state, LUA_REGISTRYINDEX);
+}
+
+void ScoreCache::Send(LuaState* state)
+{
+    Queued& unsent = mUnsent.begin()->second;
+    const int mode = mUnsent.begin()->first;
+    const Score score = unsent.score;
+    mSendingMode = mode;
+    unsent.sending = score;
+    unsent.sent.swap(unsent.waiting);
+
+#if ANDROID
+    AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
+    if(wrapper->ScoreLoopIsInitialized())
+    {
+        lua_State* lua = state->State();
+        int successRef = ReplyRef(lua, &ScoreCache::lua_OnSent, mode, true);
+        int failureRef = ReplyRef(lua, &ScoreCache::lua_OnSent, mode, false);
+        int callbackId = DDLuaCallbacks::StoreCallback(successRef, failureRef);
+        wrapper->ScoreLoopPushScore(score.primary, score.secondary, mode, callbackId);
+        return;
+    }
+#endif
+    OnSent(mRequestId, mode, false, "ScoreLoop isn't initialised.");
+}
+
+void ScoreCache::Request(LuaState* state, int type)
+{
+    Board& board = mBoards[type];
+    board.wanted = false;
+    board.fetching = true;
+
+#if ANDROID
+    AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
+    if(wrapper->ScoreLoopIsInitialized())
+    {
+        lua_State* lua = state->State();
+        int successRef = ReplyRef(lua, &ScoreCache::lua_OnFetched, type, true);
+        int failureRef = ReplyRef(lua, &ScoreCache::lua_OnFetched, type, false);
+        int callbackId = DDLuaCallbacks::StoreCallback(successRef, failureRef);
+        wrapper->ScoreLoopGetLeaderboard(type, callbackId);
+        return;
+    }
+#endif
+    OnFetched(mRequestId, type, false, "ScoreLoop isn't initialised.");
+}
+
+void ScoreCache::OnSent(unsigned int id, int mode, bool success, const std::string& response)
+{
+    if(id != mRequestId || mode != mSendingMode)
+    {
+        return; // from before a reset
+    }
+    mSendingMode = -1;
+
+    std::map<int, Queued>::iterator unsent = mUnsent.find(mode);
+    if(unsent == mUnsent.end())
+    {
+        return;
+    }
+
+    Queued& queued = unsent->second;
+    for(std::vector<Callback>::iterator it = queued.sent.begin(); it != queued.sent.end(); ++it)
+    {
+        mReplies.push_back(Reply(*it, success, response));
+    }
+    queued.sent.clear();
+
+    if(!success)
+    {
+        // The score stays for the next attempt.
+        mNextAttempt = DDTime::Microseconds() + mBackoffMs * 1000ULL;
+        dsprintf("Score post for mode %d failed, trying again in %ds.\n",
+                 mode, mBackoffMs / 1000);
+        mBackoffMs = std::min(mBackoffMs * 2, (unsigned int) MAX_BACKOFF_MS);
+        return;
+    }
+
+    mBackoffMs = MIN_BACKOFF_MS;
+    mNextAttempt = 0;
+    mBest[mode] = queued.sending;
+    if(!queued.score.Beats(queued.sending))
+    {
+        // Anything posted meanwhile was no better.
+        for(std::vector<Callback>::iterator it = queued.waiting.begin(); it != queued.waiting.end(); ++it)
+        {
+            mReplies.push_back(Reply(*it, true, response));
+        }
+        mUnsent.erase(unsent);
+    }
+
+    // Every board may have the new score on it.
+    for(std::map<int, Board>::iterator it = mBoards.begin(); it != mBoards.end(); ++it)
+    {
+        it->second.retryAt = 0;
+        if(it->second.fetched != 0)
+        {
+            it->second.fetched = 1;
+        }
+    }
+    Save();
+}
+
+void ScoreCache::OnFetched(unsigned int id, int type, bool success, const std::string& response)
+{
+    if(id != mRequestId)
+    {
+        return; // from before a reset
+    }
+
+    Board& board = mBoards[type];
+    board.fetching = false;
+    const unsigned long long now = (unsigned long long) time(NULL);
+
+    if(success)
+    {
+        board.blob = response;
+        board.fetched = std::max(now, 1ULL);
+        board.retryAt = 0;
+        Save();
+    }
+    else
+    {
+        board.retryAt = now + REFRESH_RETRY_S;
+    }
+
+    std::vector<Callback> waiting;
+    waiting.swap(board.waiting);
+    for(std::vector<Callback>::iterator it = waiting.begin(); it != waiting.end(); ++it)
+    {
+        mReplies.push_back(Reply(*it, success, response));
+    }
+}
+
+int ScoreCache::lua_OnSent(lua_State* state)
+{
+    ScoreCache* cache = (ScoreCache*) lua_touserdata(state, lua_upvalueindex(1));
+    const char* response = lua_tostring(state, 1);
+    cache->OnSent((unsigned int) lua_tointeger(state, lua_upvalueindex(2)),
+                  (int) lua_tointeger(state, lua_upvalueindex(3)),
+                  lua_toboolean(state, lua_upvalueindex(4)) != 0,
+                  response ? response : "");
+    return 0;
+}
+
+int ScoreCache::lua_OnFetched(lua_State* state)
+{
+    ScoreCache* cache = (ScoreCache*) lua_touserdata(state, lua_upvalueindex(1));
+    const char* response = lua_tostring(state, 1);
+    cache->OnFetched((unsigned int) lua_tointeger(state, lua_upvalueindex(2)),
+                     (int) lua_tointeger(state, lua_upvalueindex(3)),
+                     lua_toboolean(state, lua_upvalueindex(4)) != 0,
+                     response ? response : "");
+    return 0;
+}
+
+//
+// The file is the magic line then a line each for the unsent scores, the
+// best sent scores and the leaderboards:
+//     u <mode> <primary> <secondary>
+//     s <mode> <primary> <secondary>
+//     b <type> <fetched> <blob length>\n<blob>
+//
+void ScoreCache::Load()
+{
+    if(mLoaded)
+    {
+        return;
+    }
+    mLoaded = true;
+
+    if(mFile.empty())
+    {
+        return;
+    }
+
+    std::string data;
+    DDFile::ReadSaveData(mFile.c_str(), data);
+    const std::string magic(CACHE_MAGIC);
+    if(data.compare(0, magic.size(), magic) != 0)
+    {
+        return;
+    }
+
+    size_t at = magic.size();
+    while(at < data.size())
+    {
+        const char* line = data.c_str() + at;
+        int key = 0;
+        double primary = 0;
+        double secondary = 0;
+        unsigned long long fetched = 0;
+        unsigned int length = 0;
+        int read = 0;
+
+        if((line[0] == 'u' || line[0] == 's')
+           && sscanf(line + 1, " %d %lf %lf\n%n", &key, &primary, &secondary, &read) == 3
+           && read > 0)
+        {
+            at += 1 + read;
+            const Score score(primary, secondary);
+            if(line[0] == 's')
+            {
+                mBest[key] = score;
+            }
+            else if(mUnsent.find(key) == mUnsent.end())
+            {
+                // Posts made before the load came later, and win ties.
+                mUnsent[key].score = score;
+            }
+            else if(score.Beats(mUnsent[key].score))
+            {
+                mUnsent[key].score = score;
+            }
+            continue;
+        }
+
+        if(line[0] == 'b'
+           && sscanf(line + 1, " %d %llu %u\n%n", &key, &fetched, &length, &read) == 3
+           && read > 0
+           && at + 1 + read + length <= data.size())
+        {
+            at += 1 + read;
+            Board& board = mBoards[key];
+            if(board.fetched == 0)
+            {
+                board.blob = data.substr(at, length);
+                board.fetched = fetched;
+            }
+            at += length;
+            continue;
+        }
+
+        dsprintf("Score cache [%s] is damaged, the rest is dropped.\n", mFile.c_str());
+        break;
+    }
+
+    if(!mUnsent.empty())
+    {
+        dsprintf("Score cache has %d unsent scores.\n", (int) mUnsent.size());
+    }
+}
+
+void ScoreCache::Save()
+{
+    if(mFile.empty())
+    {
+        return;
+    }
+
+    std::string data(CACHE_MAGIC);
+    char line[96];
+    for(std::map<int, Queued>::const_iterator it = mUnsent.begin(); it != mUnsent.end(); ++it)
+    {
+        snprintf(line, sizeof(line), "u %d %.17g %.17g\n",
+                 it->first, it->second.score.primary, it->second.score.secondary);
+        data += line;
+    }
+    for(std::map<int, Score>::const_iterator it = mBest.begin(); it != mBest.end(); ++it)
+    {
+        snprintf(line, sizeof(line), "s %d %.17g %.17g\n",
+                 it->first, it->second.primary, it->second.secondary);
+        data += line;
+    }
+    for(std::map<int, Board>::const_iterator it = mBoards.begin(); it != mBoards.end(); ++it)
+    {
+        if(it->second.fetched == 0)
+        {
+            continue;
+        }
+        snprintf(line, sizeof(line), "b %d %llu %u\n",
+                 it->first, it->second.fetched, (unsigned int) it->second.blob.size());
+        data += line;
+        data += it->second.blob;
+    }
+    DDFile::WriteSaveData(mFile.c_str(), data.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#ifndef SCORECACHE_H
+#define SCORECACHE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+class LuaState;
+struct lua_State;
+
+//
+// Sits between the ScoreLoop bindings and the service so leaderboard
+// screens don't wait on a round trip.
+//
+// Leaderboards are kept by type. A fresh one is handed back on the next
+// update, a stale one is handed back the same way and refreshed in the
+// background for next time. Only a leaderboard never fetched waits on
+// the network.
+//
+// Scores are coalesced by mode, only the best unsent score for each goes
+// out and one that doesn't beat the best already sent isn't posted at all.
+// Higher is better, the secondary score breaks ties. Posts go one at a
+// time, a failed one is tried again after a delay that doubles up to
+// MAX_BACKOFF. Unsent scores and the leaderboards are kept in save data,
+// so scores posted offline go out on a later run.
+//
+class ScoreCache
+{
+public:
+    static const unsigned int MIN_BACKOFF_MS = 2000;
+    static const unsigned int MAX_BACKOFF_MS = 5 * 60 * 1000;
+    static const unsigned int REFRESH_RETRY_S = 30; // after a failed refresh
+
+    ScoreCache();
+
+    // An empty file keeps everything in memory only.
+    void Configure(unsigned int ttlSeconds, const std::string& file);
+    void Post(int mode, double primary, double secondary,
+              int successRef, int failureRef);
+    void Fetch(int type, int successRef, int failureRef);
+    // Main thread, once a frame.
+    void Update(LuaState* state);
+    // The Lua state is going, with it the callbacks and any reply due.
+    void Reset();
+
+    unsigned int Unsent() const { return mUnsent.size(); }
+private:
+    struct Callback
+    {
+        int successRef;
+        int failureRef;
+        Callback(int success, int failure)
+            : successRef(success), failureRef(failure) {}
+    };
+
+    struct Reply
+    {
+        Callback callback;
+        bool success;
+        std::string response;
+        Reply(const Callback& callback, bool success, const std::string& response)
+            : callback(callback), success(success), response(response) {}
+    };
+
+    struct Score
+    {
+        double primary;
+        double secondary;
+        Score() : primary(0), secondary(0) {}
+        Score(double primary, double secondary)
+            : primary(primary), secondary(secondary) {}
+        bool Beats(const Score& score) const;
+    };
+
+    struct Board
+    {
+        std::string blob;
+        unsigned long long fetched; // time(), 0 never
+        unsigned long long retryAt; // time(), after a failed refresh
+        bool wanted; // fetch on the next update
+        bool fetching;
+        std::vector<Callback> waiting; // for the first fetch
+        Board() : fetched(0), retryAt(0), wanted(false), fetching(false) {}
+    };
+
+    struct Queued
+    {
+        Score score;
+        std::vector<Callback> waiting;
+        Score sending; // the score in flight, if this mode is
+        std::vector<Callback> sent; // waiting on the one in flight
+    };
+
+    std::map<int, Board> mBoards; // by type
+    std::map<int, Queued> mUnsent; // by mode
+    std::map<int, Score> mBest; // sent, by mode
+    std::vector<Reply> mReplies; // called on the next update
+    unsigned int mTtlSeconds;
+    std::string mFile;
+    bool mLoaded;
+    int mSendingMode; // in flight, or -1
+    unsigned int mRequestId; // matches replies with the state that asked
+    unsigned int mBackoffMs;
+    unsigned long long mNextAttempt;
+
+    bool IsStale(const Board& board, unsigned long long now) const;
+    void Load();
+    void Save();
+    void Send(LuaState* state);
+    void Request(LuaState* state, int type);
+    void OnSent(unsigned int id, int mode, bool success, const std::string& response);
+    void OnFetched(unsigned int id, int type, bool success, const std::string& response);
+    int ReplyRef(lua_State* state, int (*onReply)(lua_State*), int key, bool success);
+    void Call(LuaState* state, const Callback& callback, bool success,
+              const std::string& response);
+    static int lua_OnSent(lua_State* state);
+    static int lua_OnFetched(lua_State* state);
+};
+
+#endif
\ No newline at end of file
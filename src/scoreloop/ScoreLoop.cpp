@@ -1,16 +1,18 @@
 #include "ScoreLoop.h"
 
+#include <assert.h>
 #include <map>
 #include <string>
 
 #include "../DinodeckLua.h"
+#include "../Game.h"
 #include "../LuaState.h"
 #include "../reflect/Reflect.h"
 #include "../DDLog.h"
+#include "ScoreCache.h"
 
 #if ANDROID
 #include "AndroidWrapper.h"
-#include "DSLuaCallbacks.h"
 #endif
 
 Reflect ScoreLoop::Meta("ScoreLoop", ScoreLoop::Bind);
@@ -39,40 +41,6 @@ bool ScoreLoop::IsInitialized()
     return false;
 }
 
-void ScoreLoop::PostScore(double primary, double secondary,
-               int onSuccessId, int onFailureId)
-{
-    // Needs going up to Java and some release mechanism for the
-    // success, failure ids (hopefully be able to reuse the http ones.)
-    dsprintf("Calling PostScore(%f, %f, %d, %d)\n", primary, secondary,
-             onSuccessId, onFailureId);
-#if ANDROID
-    int callbackId = DSLuaCallbacks::StoreCallback(onSuccessId, onFailureId);
-    AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
-    wrapper->ScoreLoopPushScore
-    (
-        primary,
-        secondary,
-        callbackId
-    );
-#endif
-}
-
-void ScoreLoop::GetLeaderboard(int type, int onSuccessId, int onFailureId)
-{
-    dsprintf("Calling GetLeaderboard(%d, %d, %d)\n", type, onSuccessId,
-             onFailureId);
-#if ANDROID
-    int callbackId = DDLuaCallbacks::StoreCallback(onSuccessId, onFailureId);
-    AndroidWrapper* wrapper = AndroidWrapper::GetInstance();
-    wrapper->ScoreLoopGetLeaderboard
-    (
-        type,
-        callbackId
-    );
-#endif
-}
-
 std::string ScoreLoop::GetTOSState()
 {
 #if ANDROID
@@ -165,6 +133,13 @@ static int lua_ScoreLoop_ShowTOS(lua_State* state)
     return 0;
 }
 
+static ScoreCache* GetScoreCache(lua_State* state)
+{
+    Game* game = (Game*) LuaState::GetFromRegistry(state, Game::Key);
+    assert(game);
+    return game->GetScoreCache();
+}
+
     // static void stackDump (lua_State *L) {
     //   int i;
     //   int top = lua_gettop(L);
@@ -194,11 +169,14 @@ static int lua_ScoreLoop_ShowTOS(lua_State* state)
     //   dsprintf("\n");  /* end the listing */
     // }
 
+// scoreLoop:SendScore(score, onSuccess, onFailure)
+// score is a number or { primary, secondary, mode }, see ScoreCache.
 static int lua_ScoreLoop_SendScore(lua_State* state)
 {
     // score
     double primaryScore = 0;
     double secondaryScore = 0;
+    int mode = 0;
 
     ScoreLoop* scoreLoop = LuaState::GetFuncParam<ScoreLoop>(state, 1);
     if(NULL == scoreLoop)
@@ -239,6 +217,16 @@ static int lua_ScoreLoop_SendScore(lua_State* state)
         // Otherwise ignore it.
         lua_pop(state, 1);
 
+        // Scores are coalesced by mode, the best of each is posted.
+        lua_pushstring(state, "mode");
+        lua_gettable(state, -2); // [value[table]]
+
+        if(lua_isnumber(state, -1))
+        {
+            mode = (int) lua_tonumber(state, -1);
+        }
+        lua_pop(state, 1);
+
         lua_pop(state, 1); // pop off the table
 
         //dsprintf("Is function at correct place: %s\n", lua_isfunction(state, 3)?"true":"false");
@@ -266,8 +254,9 @@ static int lua_ScoreLoop_SendScore(lua_State* state)
     lua_pushvalue(state, 4);
     int onFailureRef = luaL_ref(state, LUA_REGISTRYINDEX); // [-1, +0, m]
 
-    scoreLoop->PostScore
+    GetScoreCache(state)->Post
     (
+        mode,
         primaryScore,
         secondaryScore,
         onSuccessRef,
@@ -277,6 +266,7 @@ static int lua_ScoreLoop_SendScore(lua_State* state)
     return 0;
 }
 
+// scoreLoop:GetLeaderboard(type, onSuccess, onFailure)
 static int lua_ScoreLoop_GetLeaderboard(lua_State* state)
 {
     ScoreLoop* scoreLoop = LuaState::GetFuncParam<ScoreLoop>(state, 1);
@@ -307,7 +297,8 @@ static int lua_ScoreLoop_GetLeaderboard(lua_State* state)
     lua_pushvalue(state, 4);
     int onFailureRef = luaL_ref(state, LUA_REGISTRYINDEX); // [-1, +0, m]
 
-    scoreLoop->GetLeaderboard
+    // A cached leaderboard comes back on the next update.
+    GetScoreCache(state)->Fetch
     (
         leaderboardType,
         onSuccessRef,
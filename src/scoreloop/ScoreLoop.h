@@ -15,12 +15,9 @@ class ScoreLoop
 
         ScoreLoop(const char* secret);
         ~ScoreLoop();
-        void PostScore(double primary, double secondary,
-                       int onSuccessId, int onFailureId);
         std::string GetTOSState();
         void ShowTOS();
         bool IsInitialized();
-        void GetLeaderboard(int type, int onSuccessId, int onFailureId);
 
 };
 
@@ -0,0 +1,84 @@
+import os
+import subprocess
+import sys
+#
+# Times cold and warm starts of a game.
+#
+# usage: python startup_bench.py <dinodeck binary> [runs]
+#
+# Run from the game's directory. Each run starts dinodeck with
+# --startup-exit, so it quits once the first frame is up, and reads the
+# startup_ lines it prints. Cold runs drop the OS file cache first, which
+# needs root on Linux and sudo for purge on a Mac. Where that isn't
+# possible only warm runs are timed.
+#
+# Prints the median of each phase, prefixed cold_ or warm_, so runs can
+# be compared against a baseline.
+#
+
+def drop_caches():
+    if sys.platform.startswith("linux"):
+        try:
+            subprocess.call(["sync"])
+            with open("/proc/sys/vm/drop_caches", "w") as f:
+                f.write("3\n")
+            return True
+        except (IOError, OSError):
+            return False
+    if sys.platform == "darwin":
+        return subprocess.call(["purge"]) == 0
+    return False
+
+def run_once(binary):
+    output = subprocess.check_output([binary, "--startup-exit"],
+                                     universal_newlines=True)
+    times = {}
+    for line in output.splitlines():
+        parts = line.split()
+        if len(parts) == 2 and parts[0].startswith("startup_"):
+            times[parts[0]] = float(parts[1])
+    return times
+
+def median(values):
+    values = sorted(values)
+    middle = len(values) // 2
+    if len(values) % 2:
+        return values[middle]
+    return (values[middle - 1] + values[middle]) / 2.0
+
+def report(prefix, runs):
+    # Phases in the order the first run printed them.
+    names = []
+    for run in runs:
+        for name in run:
+            if name not in names:
+                names.append(name)
+    for name in names:
+        values = [run[name] for run in runs if name in run]
+        print("%s_%s %.3f" % (prefix, name, median(values)))
+
+def main():
+    if len(sys.argv) < 2:
+        print("usage: python startup_bench.py <dinodeck binary> [runs]")
+        return 1
+    binary = os.path.abspath(sys.argv[1])
+    count = int(sys.argv[2]) if len(sys.argv) > 2 else 5
+
+    cold = []
+    if drop_caches():
+        for i in range(count):
+            drop_caches()
+            cold.append(run_once(binary))
+    else:
+        print("# Can't drop the file cache here, only warm starts are timed.")
+
+    run_once(binary) # so every warm run finds the files cached
+    warm = [run_once(binary) for i in range(count)]
+
+    if cold:
+        report("cold", cold)
+    report("warm", warm)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -26,7 +26,11 @@ manifest =
     --     ['hypnosis_tile_art.png'] =
     --     {
     --         path = "hypnosis_tile_art.png",
-    --         scale = "pixelart"
+    --         scale = "pixelart",
+    --         mipmaps = "true", -- for drawing zoomed out
+    --         compressed_android = "hypnosis_tile_art.ktx", -- ETC1 say
+    --         compressed_windows = "hypnosis_tile_art.dds",
+    --         resident = "true", -- never evicted under texture_budget_kb
     --     },
     -- }
 }
\ No newline at end of file
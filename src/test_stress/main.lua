@@ -0,0 +1,225 @@
+--
+-- Sweeps the draw load up step by step and writes the frame time and
+-- draw calls at each step to a CSV, to show where GraphicsPipeline's
+-- throughput falls off. Run it headless and flat out with
+--
+--     dinodeck --bench 100000 --offscreen
+--
+-- it exits by itself once every sweep is done.
+--
+LoadLibrary("Renderer")
+LoadLibrary("Sprite")
+LoadLibrary("System")
+LoadLibrary("Texture")
+LoadLibrary("Vector")
+
+BACKEND = "default" -- see settings.lua
+OUTPUT = "stress_results.csv"
+WARMUP_FRAMES = 10 -- after each step, the stats lag a frame behind
+MEASURE_FRAMES = 60
+TEXTURE_COUNT = 8
+MAX_SPRITES = 20000
+
+gRenderer = Renderer.Create()
+gWidth = 740
+gHeight = 480
+
+gTextures = {}
+for i = 1, TEXTURE_COUNT do
+    gTextures[i] = Texture.Find("stress_" .. i)
+end
+
+-- The same positions every run.
+math.randomseed(1)
+gSprites = {}
+for i = 1, MAX_SPRITES do
+    local sprite = Sprite.Create()
+    sprite:SetTexture(gTextures[1])
+    sprite:SetPosition(math.random(-gWidth / 2, gWidth / 2),
+                       math.random(-gHeight / 2, gHeight / 2))
+    gSprites[i] = sprite
+end
+
+gColour = Vector.Create(1, 0.5, 0.25, 1)
+gText = "The quick brown fox jumps over the lazy dog 0123456789"
+
+local function DrawSprites(count)
+    for i = 1, count do
+        gRenderer:DrawSprite(gSprites[i])
+    end
+end
+
+--
+-- Each sweep draws a frame for a step value, steps run smallest first.
+--
+gSweeps =
+{
+    {
+        name = "sprites",
+        steps = { 100, 500, 1000, 2000, 5000, 10000, 20000 },
+        draw = DrawSprites,
+    },
+    {
+        -- 2000 sprites, each on a different texture to the last.
+        name = "textures",
+        steps = { 1, 2, 4, 8 },
+        setup = function(textures)
+            for i = 1, MAX_SPRITES do
+                gSprites[i]:SetTexture(gTextures[((i - 1) % textures) + 1])
+            end
+        end,
+        draw = function(textures) DrawSprites(2000) end,
+        finish = function()
+            for i = 1, MAX_SPRITES do
+                gSprites[i]:SetTexture(gTextures[1])
+            end
+        end,
+    },
+    {
+        -- Lines of text.
+        name = "text",
+        steps = { 10, 50, 100, 200, 400 },
+        draw = function(lines)
+            for i = 1, lines do
+                local y = gHeight / 2 - ((i * 12) % gHeight)
+                gRenderer:DrawText2d(-gWidth / 2, y, gText)
+            end
+        end,
+    },
+    {
+        -- Sprites, rects, circles and lines in turn, so the draw mode
+        -- and texture change on every primitive.
+        name = "primitives",
+        steps = { 100, 500, 1000, 2000, 5000 },
+        draw = function(count)
+            for i = 1, count do
+                local sprite = gSprites[i]
+                local kind = i % 4
+                local x = (i * 37) % gWidth - gWidth / 2
+                local y = (i * 53) % gHeight - gHeight / 2
+                if kind == 0 then
+                    gRenderer:DrawSprite(sprite)
+                elseif kind == 1 then
+                    gRenderer:DrawRect2d(x, y, x + 8, y + 8, gColour)
+                elseif kind == 2 then
+                    gRenderer:DrawCircle2d(x, y, 6, 12, gColour)
+                else
+                    gRenderer:DrawLine2d(x, y, x + 10, y + 10, gColour)
+                end
+            end
+        end,
+    },
+    {
+        -- 2000 sprites, the blend mode flips every run of this many.
+        name = "blend_run",
+        steps = { 2000, 500, 100, 10, 1 },
+        draw = function(run)
+            local additive = false
+            gRenderer:SetBlend(BLEND_BLEND)
+            for i = 1, 2000 do
+                if i % run == 0 then
+                    additive = not additive
+                    gRenderer:SetBlend(additive and BLEND_ADDITIVE or BLEND_BLEND)
+                end
+                gRenderer:DrawSprite(gSprites[i])
+            end
+            gRenderer:SetBlend(BLEND_BLEND)
+        end,
+    },
+}
+
+gSweep = 1
+gStep = 1
+gFrame = 0
+gSamples = {}
+gRows = {}
+
+local function Percentile(sorted, fraction)
+    if #sorted == 0 then
+        return 0
+    end
+    return sorted[math.floor(fraction * (#sorted - 1) + 0.5) + 1]
+end
+
+local function FinishStep(sweep, value)
+    local times = {}
+    local total = 0
+    local drawCalls, verts, textureBinds = 0, 0, 0
+    for _, sample in ipairs(gSamples) do
+        table.insert(times, sample.ms)
+        total = total + sample.ms
+        drawCalls = drawCalls + sample.drawCalls
+        verts = verts + sample.verts
+        textureBinds = textureBinds + sample.textureBinds
+    end
+    table.sort(times)
+    local n = #gSamples
+
+    table.insert(gRows, string.format("%s,%s,%d,%d,%.3f,%.3f,%.3f,%.1f,%.1f,%.1f",
+        BACKEND, sweep.name, value, n,
+        total / n, Percentile(times, 0.95), times[n],
+        drawCalls / n, verts / n, textureBinds / n))
+    print(gRows[#gRows])
+end
+
+local function WriteResults()
+    local file = io.open(OUTPUT, "w")
+    if file == nil then
+        print("Couldn't write " .. OUTPUT)
+        return
+    end
+    file:write("backend,sweep,step,frames,mean_ms,p95_ms,max_ms,draw_calls,verts,texture_binds\n")
+    for _, row in ipairs(gRows) do
+        file:write(row, "\n")
+    end
+    file:close()
+    print("Wrote " .. OUTPUT)
+end
+
+function update()
+    local sweep = gSweeps[gSweep]
+    if sweep == nil then
+        return
+    end
+
+    local value = sweep.steps[gStep]
+    if gFrame == 0 and sweep.setup then
+        sweep.setup(value)
+    end
+
+    -- Both describe the frame before this one.
+    if gFrame > WARMUP_FRAMES then
+        local drawCalls, verts, textureBinds = gRenderer:GetStats()
+        table.insert(gSamples,
+        {
+            ms = GetDeltaTime() * 1000,
+            drawCalls = drawCalls,
+            verts = verts,
+            textureBinds = textureBinds,
+        })
+    end
+
+    sweep.draw(value)
+    gFrame = gFrame + 1
+
+    if #gSamples < MEASURE_FRAMES then
+        return
+    end
+
+    FinishStep(sweep, value)
+    gSamples = {}
+    gFrame = 0
+    gStep = gStep + 1
+    if gStep > #sweep.steps then
+        if sweep.finish then
+            sweep.finish()
+        end
+        gSweep = gSweep + 1
+        gStep = 1
+    end
+
+    if gSweeps[gSweep] == nil then
+        WriteResults()
+        System.Exit()
+    end
+end
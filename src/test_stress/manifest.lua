@@ -0,0 +1,25 @@
+--
+-- The same image under several names is several GL textures, for the
+-- texture count sweep.
+--
+manifest =
+{
+    scripts =
+    {
+        ['main.lua'] =
+        {
+            path = "main.lua"
+        },
+    },
+    textures =
+    {
+        ['stress_1'] = { path = "stress.png" },
+        ['stress_2'] = { path = "stress.png" },
+        ['stress_3'] = { path = "stress.png" },
+        ['stress_4'] = { path = "stress.png" },
+        ['stress_5'] = { path = "stress.png" },
+        ['stress_6'] = { path = "stress.png" },
+        ['stress_7'] = { path = "stress.png" },
+        ['stress_8'] = { path = "stress.png" },
+    },
+}
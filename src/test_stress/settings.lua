@@ -0,0 +1,17 @@
+name = "Render Stress"
+width = 740
+height = 480
+
+manifest = "manifest.lua"
+main_script = "main.lua"
+on_update = "update()"
+
+-- Flat out, so frame times are the pipeline's and not the pacer's.
+frame_rate = 0
+vsync = false
+
+-- The backend under test. Change these between runs and set BACKEND in
+-- main.lua to match, so the rows can be told apart.
+stream_vertices = true -- false draws from client arrays
+use_shaders = true
+record_frames = true
@@ -0,0 +1,28 @@
+#include "Json.h"
+
+#include <stdio.h>
+
+void AppendJsonString(std::string* out, const std::string& value)
+{
+    *out += '"';
+    for(std::string::const_iterator it = value.begin(); it != value.end(); ++it)
+    {
+        const unsigned char c = (unsigned char) *it;
+        if(c == '"' || c == '\\')
+        {
+            *out += '\\';
+            *out += (char) c;
+        }
+        else if(c < 0x20)
+        {
+            char escaped[8];
+            sprintf(escaped, "\\u%04x", c);
+            *out += escaped;
+        }
+        else
+        {
+            *out += (char) c;
+        }
+    }
+    *out += '"';
+}
\ No newline at end of file
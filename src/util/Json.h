@@ -0,0 +1,9 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <string>
+
+// Appends value quoted, with quotes, backslashes and control characters escaped.
+void AppendJsonString(std::string* out, const std::string& value);
+
+#endif
\ No newline at end of file
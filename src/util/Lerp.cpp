@@ -1,8 +1,79 @@
 #include "Lerp.h"
 
+#include <math.h>
+
 float Lerpf(float value, float in0, float in1, float out0, float out1)
 {
     float normed = (value - in0) / (in1 - in0);
     float result = out0 + (normed * (out1 - out0));
     return result;
+}
+
+static float OutBounce(float t)
+{
+    const float n = 7.5625f;
+    const float d = 2.75f;
+    if(t < 1 / d)
+    {
+        return n * t * t;
+    }
+    else if(t < 2 / d)
+    {
+        t -= 1.5f / d;
+        return n * t * t + 0.75f;
+    }
+    else if(t < 2.5f / d)
+    {
+        t -= 2.25f / d;
+        return n * t * t + 0.9375f;
+    }
+    t -= 2.625f / d;
+    return n * t * t + 0.984375f;
+}
+
+float Easef(int easing, float t)
+{
+    const float pi = 3.14159265f;
+    switch(easing)
+    {
+        case EASE_IN_QUAD:
+            return t * t;
+        case EASE_OUT_QUAD:
+            return t * (2 - t);
+        case EASE_IN_OUT_QUAD:
+            return t < 0.5f ? 2 * t * t : -1 + (4 - 2 * t) * t;
+        case EASE_IN_CUBIC:
+            return t * t * t;
+        case EASE_OUT_CUBIC:
+        {
+            const float u = t - 1;
+            return u * u * u + 1;
+        }
+        case EASE_IN_OUT_CUBIC:
+        {
+            if(t < 0.5f)
+            {
+                return 4 * t * t * t;
+            }
+            const float u = 2 * t - 2;
+            return 0.5f * u * u * u + 1;
+        }
+        case EASE_IN_SINE:
+            return 1 - cosf(t * pi * 0.5f);
+        case EASE_OUT_SINE:
+            return sinf(t * pi * 0.5f);
+        case EASE_IN_OUT_SINE:
+            return 0.5f * (1 - cosf(t * pi));
+        case EASE_OUT_BACK:
+        {
+            // Overshoots by about 10% before settling.
+            const float s = 1.70158f;
+            const float u = t - 1;
+            return u * u * ((s + 1) * u + s) + 1;
+        }
+        case EASE_OUT_BOUNCE:
+            return OutBounce(t);
+        default:
+            return t;
+    }
 }
\ No newline at end of file
@@ -3,4 +3,24 @@
 
 float Lerpf(float value, float in0, float in1, float out0, float out1);
 
+enum eEasing
+{
+    EASE_LINEAR,
+    EASE_IN_QUAD,
+    EASE_OUT_QUAD,
+    EASE_IN_OUT_QUAD,
+    EASE_IN_CUBIC,
+    EASE_OUT_CUBIC,
+    EASE_IN_OUT_CUBIC,
+    EASE_IN_SINE,
+    EASE_OUT_SINE,
+    EASE_IN_OUT_SINE,
+    EASE_OUT_BACK,
+    EASE_OUT_BOUNCE,
+    EASE_COUNT
+};
+
+// Maps t in [0, 1] through the easing curve. 0 and 1 map to themselves.
+float Easef(int easing, float t);
+
 #endif
\ No newline at end of file